@@ -24,18 +24,31 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <mutex>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include <wx/datetime.h>
+#include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <boost/version.hpp>
 
 #if BOOST_VERSION >= 106800
@@ -65,6 +78,137 @@
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
 
+// The scene graph nodes are named from a shared counter, and the plugins switch the global
+// locale while parsing, so the scene data is read, built and written by one thread at a time
+static std::mutex mutex3D_sceneGraph;
+
+
+/*
+ * The layout of a binary mesh cache file (.3dm), in the byte order of the machine which
+ * wrote it:
+ *    MESH_CACHE_HEADER
+ *    SMATERIAL[m_materialsSize]
+ *    MESH_CACHE_RECORD[m_meshesSize]
+ *    for each mesh: the positions, the normals, the optional texture coordinates and
+ *    colors, and the face indexes
+ * All the items are made of 4 byte words, so the arrays of a mapped file are used in place
+ * by the renderers.  The version must be increased whenever S3D::GetModel() changes the
+ * render data it builds.
+ */
+
+static const char     MESH_CACHE_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', '3', 'D', 'M' };
+static const uint32_t MESH_CACHE_VERSION = 1;
+static const uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+
+
+struct MESH_CACHE_HEADER
+{
+    char     m_magic[8];
+    uint32_t m_version;
+    uint32_t m_byteOrder;
+    uint32_t m_materialsSize;
+    uint32_t m_meshesSize;
+    uint64_t m_fileSize;
+};
+
+
+enum MESH_CACHE_FLAGS
+{
+    MESH_HAS_TEXCOORDS = 1,
+    MESH_HAS_COLORS = 2
+};
+
+
+struct MESH_CACHE_RECORD
+{
+    uint32_t m_vertexSize;
+    uint32_t m_faceIdxSize;
+    uint32_t m_materialIdx;
+    uint32_t m_flags;
+};
+
+
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ) && sizeof( SFVEC2F ) == 2 * sizeof( float )
+                       && sizeof( SMATERIAL ) == 14 * sizeof( float ),
+               "the render data must be made of 4 byte words to be mapped in place" );
+
+
+/// @return the number of bytes of the arrays of a mesh
+static uint64_t meshCacheDataSize( const MESH_CACHE_RECORD& aRecord )
+{
+    uint64_t vertexBytes = 2 * sizeof( SFVEC3F );
+
+    if( aRecord.m_flags & MESH_HAS_TEXCOORDS )
+        vertexBytes += sizeof( SFVEC2F );
+
+    if( aRecord.m_flags & MESH_HAS_COLORS )
+        vertexBytes += sizeof( SFVEC3F );
+
+    return vertexBytes * aRecord.m_vertexSize
+           + uint64_t( aRecord.m_faceIdxSize ) * sizeof( unsigned int );
+}
+
+
+/// Maps a whole file for reading, @return NULL on failure
+static const char* mapCacheFile( const wxString& aFileName, size_t& aSize )
+{
+    const char* data = NULL;
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    LARGE_INTEGER size;
+
+    if( file == INVALID_HANDLE_VALUE )
+        return NULL;
+
+    if( GetFileSizeEx( file, &size ) && size.QuadPart >= (LONGLONG) sizeof( MESH_CACHE_HEADER ) )
+    {
+        HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+        if( mapping )
+        {
+            data = (const char*) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            aSize = size.QuadPart;
+            CloseHandle( mapping );     // the view keeps the mapping
+        }
+    }
+
+    CloseHandle( file );
+#else
+    int         fd = open( aFileName.fn_str(), O_RDONLY );
+    struct stat st;
+
+    if( fd < 0 )
+        return NULL;
+
+    if( fstat( fd, &st ) == 0 && st.st_size >= (off_t) sizeof( MESH_CACHE_HEADER ) )
+    {
+        void* mapped = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+        if( mapped != MAP_FAILED )
+        {
+            data = (const char*) mapped;
+            aSize = st.st_size;
+        }
+    }
+
+    close( fd );
+#endif
+
+    return data;
+}
+
+
+static void unmapCacheFile( const char* aData, size_t aSize )
+{
+#if defined( _WIN32 )
+    UnmapViewOfFile( aData );
+#else
+    munmap( const_cast<char*>( aData ), aSize );
+#endif
+}
+
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
@@ -142,6 +286,18 @@ public:
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+
+    // the binary mesh cache file holding the arrays of the meshes of renderData, if mapped
+    const char*   mappedData;
+    size_t        mappedSize;
+
+    bool          checked;      // set once the entry was filled by S3D_CACHE::checkCache()
+    std::mutex    loadLock;     // held while the entry is loaded or reloaded
+
+    void FreeRenderData();
+
+    ///> @return the bytes of the render data, mapped or allocated
+    size_t RenderDataMemoryUsage() const;
 };
 
 
@@ -149,6 +305,9 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    mappedData = NULL;
+    mappedSize = 0;
+    checked = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -158,8 +317,62 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
+    FreeRenderData();
+}
+
+
+void S3D_CACHE_ENTRY::FreeRenderData()
+{
+    if( NULL == mappedData )
+    {
+        if( NULL != renderData )
+            S3D::Destroy3DModel( &renderData );
+
+        return;
+    }
+
+    // only the meshes and the materials were allocated, the arrays are in the mapped file
     if( NULL != renderData )
-        S3D::Destroy3DModel( &renderData );
+    {
+        delete[] renderData->m_Meshes;
+        delete[] renderData->m_Materials;
+        delete renderData;
+        renderData = NULL;
+    }
+
+    unmapCacheFile( mappedData, mappedSize );
+    mappedData = NULL;
+    mappedSize = 0;
+}
+
+
+size_t S3D_CACHE_ENTRY::RenderDataMemoryUsage() const
+{
+    if( NULL == renderData )
+        return 0;
+
+    size_t bytes = sizeof( S3DMODEL ) + renderData->m_MeshesSize * sizeof( SMESH )
+                   + renderData->m_MaterialsSize * sizeof( SMATERIAL );
+
+    // the arrays of the meshes are in the mapped file, if any
+    if( NULL != mappedData )
+        return bytes + mappedSize;
+
+    for( unsigned int ii = 0; ii < renderData->m_MeshesSize; ii++ )
+    {
+        const SMESH& mesh = renderData->m_Meshes[ii];
+        size_t       vertexSize = 2 * sizeof( SFVEC3F );
+
+        if( mesh.m_Texcoords )
+            vertexSize += sizeof( SFVEC2F );
+
+        if( mesh.m_Color )
+            vertexSize += sizeof( SFVEC3F );
+
+        bytes += mesh.m_VertexSize * vertexSize + mesh.m_FaceIdxSize * sizeof( unsigned int );
+    }
+
+    return bytes;
 }
 
 
@@ -193,12 +406,33 @@ S3D_CACHE::S3D_CACHE()
     m_FNResolver = new FILENAME_RESOLVER;
     m_Plugins = new S3D_PLUGIN_MANAGER;
 
+    // The scene graphs are not accounted for: only the render data is made of flat arrays
+    // which can be measured without walking the graph
+    m_memoryUsage.Set( "3D model cache",
+            [this]()
+            {
+                std::lock_guard<std::mutex> lock( mutex3D_cache );
+                size_t                      bytes = 0;
+
+                for( S3D_CACHE_ENTRY* entry : m_CacheList )
+                {
+                    // skip the entries being loaded
+                    std::unique_lock<std::mutex> entryLock( entry->loadLock, std::try_to_lock );
+
+                    if( entryLock.owns_lock() )
+                        bytes += sizeof( S3D_CACHE_ENTRY ) + entry->RenderDataMemoryUsage();
+                }
+
+                return bytes;
+            } );
+
     return;
 }
 
 
 S3D_CACHE::~S3D_CACHE()
 {
+    m_memoryUsage.Reset();
     FlushCache();
 
     if( m_FNResolver )
@@ -211,7 +445,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -226,57 +461,79 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    // only the entry of the model is locked while it is loaded, so that several models
+    // are loaded concurrently
+    S3D_CACHE_ENTRY*            ep = getCacheEntry( full3Dpath );
+    std::lock_guard<std::mutex> lock( ep->loadLock );
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
 
-    if( mi != m_CacheMap.end() )
-    {
-        wxFileName fname( full3Dpath );
+    // a new entry; search the Filename->Cachename map
+    if( !ep->checked )
+        return checkCache( full3Dpath, ep, aRenderOnly );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+    wxFileName fname( full3Dpath );
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( full3Dpath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
+            {
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
+        }
 
-            if( reload )
+        if( reload )
+        {
+            if( NULL != ep->sceneData )
             {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+                S3D::DestroyNode( ep->sceneData );
+                ep->sceneData = NULL;
+            }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+            ep->FreeRenderData();
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+            if( !aRenderOnly || !loadRenderCache( ep ) )
+            {
+                std::lock_guard<std::mutex> sceneLock( mutex3D_sceneGraph );
+                ep->sceneData = m_Plugins->Load3DModel( full3Dpath, ep->pluginInfo );
             }
         }
+    }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+    // the render data may have been mapped without the scene data
+    if( !aRenderOnly && NULL == ep->sceneData && NULL != ep->renderData )
+        loadSceneData( full3Dpath, ep );
 
-        return mi->second->sceneData;
-    }
+    return ep->sceneData;
+}
+
+
+S3D_CACHE_ENTRY* S3D_CACHE::getCacheEntry( const wxString& aFileName )
+{
+    std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+    mi = m_CacheMap.find( aFileName );
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    if( mi != m_CacheMap.end() )
+        return mi->second;
+
+    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+    m_CacheList.push_back( ep );
+    m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( aFileName, ep ) );
+
+    return ep;
 }
 
 
@@ -286,75 +543,46 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                                   bool aRenderOnly )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
+    wxFileName fname( aFileName );
+    aCacheItem->modTime = fname.GetModificationTime();
+    aCacheItem->checked = true;
 
     unsigned char sha1sum[20];
 
+    // just in case we can't get a hash digest (for example, on access issues)
+    // or we do not have a configured cache file directory, the entry is kept
+    // empty to prevent further attempts at loading the file
     if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
-    {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
         return NULL;
-    }
-
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+    aCacheItem->SetSHA1( sha1sum );
 
-        m_CacheList.pop_back();
-        delete ep;
+    if( aRenderOnly && loadRenderCache( aCacheItem ) )
         return NULL;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return loadSceneData( aFileName, aCacheItem );
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+SCENEGRAPH* S3D_CACHE::loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    std::lock_guard<std::mutex> lock( mutex3D_sceneGraph );
+
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return aCacheItem->sceneData;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 
-    return ep->sceneData;
+    return aCacheItem->sceneData;
 }
 
 
@@ -509,6 +737,217 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadRenderCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    size_t      size = 0;
+    const char* data = mapCacheFile( fname, size );
+
+    if( NULL == data )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot map file '%s'", fname );
+        return false;
+    }
+
+    const MESH_CACHE_HEADER* header = reinterpret_cast<const MESH_CACHE_HEADER*>( data );
+
+    uint64_t offset = sizeof( MESH_CACHE_HEADER )
+                      + uint64_t( header->m_materialsSize ) * sizeof( SMATERIAL )
+                      + uint64_t( header->m_meshesSize ) * sizeof( MESH_CACHE_RECORD );
+
+    bool valid = memcmp( header->m_magic, MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) ) == 0
+                 && header->m_version == MESH_CACHE_VERSION
+                 && header->m_byteOrder == MESH_CACHE_BYTE_ORDER
+                 && header->m_fileSize == size
+                 && header->m_meshesSize > 0
+                 && offset <= size;
+
+    S3DMODEL* model = NULL;
+
+    if( valid )
+    {
+        const SMATERIAL* materials = reinterpret_cast<const SMATERIAL*>(
+                data + sizeof( MESH_CACHE_HEADER ) );
+        const MESH_CACHE_RECORD* records = reinterpret_cast<const MESH_CACHE_RECORD*>(
+                materials + header->m_materialsSize );
+
+        model = new S3DMODEL;
+        model->m_MaterialsSize = header->m_materialsSize;
+        model->m_Materials = new SMATERIAL[header->m_materialsSize];
+        model->m_MeshesSize = header->m_meshesSize;
+        model->m_Meshes = new SMESH[header->m_meshesSize];
+
+        std::copy( materials, materials + header->m_materialsSize, model->m_Materials );
+
+        for( unsigned int i = 0; valid && i < header->m_meshesSize; ++i )
+        {
+            const MESH_CACHE_RECORD& rec = records[i];
+
+            // a truncated or damaged file must not send the renderers out of the arrays
+            if( rec.m_vertexSize == 0 || rec.m_faceIdxSize == 0 || rec.m_faceIdxSize % 3
+                    || rec.m_materialIdx >= header->m_materialsSize
+                    || offset + meshCacheDataSize( rec ) > size )
+            {
+                valid = false;
+                break;
+            }
+
+            SMESH&      mesh = model->m_Meshes[i];
+            const char* p = data + offset;
+
+            mesh.m_VertexSize = rec.m_vertexSize;
+            mesh.m_MaterialIdx = rec.m_materialIdx;
+            mesh.m_FaceIdxSize = rec.m_faceIdxSize;
+
+            mesh.m_Positions = (SFVEC3F*) p;
+            p += rec.m_vertexSize * sizeof( SFVEC3F );
+            mesh.m_Normals = (SFVEC3F*) p;
+            p += rec.m_vertexSize * sizeof( SFVEC3F );
+            mesh.m_Texcoords = NULL;
+            mesh.m_Color = NULL;
+
+            if( rec.m_flags & MESH_HAS_TEXCOORDS )
+            {
+                mesh.m_Texcoords = (SFVEC2F*) p;
+                p += rec.m_vertexSize * sizeof( SFVEC2F );
+            }
+
+            if( rec.m_flags & MESH_HAS_COLORS )
+            {
+                mesh.m_Color = (SFVEC3F*) p;
+                p += rec.m_vertexSize * sizeof( SFVEC3F );
+            }
+
+            mesh.m_FaceIdx = (unsigned int*) p;
+            offset += meshCacheDataSize( rec );
+
+            for( unsigned int j = 0; j < rec.m_faceIdxSize; ++j )
+            {
+                if( mesh.m_FaceIdx[j] >= rec.m_vertexSize )
+                {
+                    valid = false;
+                    break;
+                }
+            }
+        }
+
+        valid = valid && offset == size;
+    }
+
+    if( !valid )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid mesh cache file '%s'", fname );
+
+        if( model )
+        {
+            delete[] model->m_Meshes;
+            delete[] model->m_Materials;
+            delete model;
+        }
+
+        unmapCacheFile( data, size );
+        return false;
+    }
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->renderData = model;
+    aCacheItem->mappedData = data;
+    aCacheItem->mappedSize = size;
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveRenderCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    const S3DMODEL* model = aCacheItem->renderData;
+    wxString        bname = aCacheItem->GetCacheBaseName();
+
+    if( NULL == model || model->m_MeshesSize == 0 || bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    MESH_CACHE_HEADER              header;
+    std::vector<MESH_CACHE_RECORD> records( model->m_MeshesSize );
+
+    memcpy( header.m_magic, MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) );
+    header.m_version = MESH_CACHE_VERSION;
+    header.m_byteOrder = MESH_CACHE_BYTE_ORDER;
+    header.m_materialsSize = model->m_MaterialsSize;
+    header.m_meshesSize = model->m_MeshesSize;
+    header.m_fileSize = sizeof( MESH_CACHE_HEADER )
+                        + uint64_t( model->m_MaterialsSize ) * sizeof( SMATERIAL )
+                        + records.size() * sizeof( MESH_CACHE_RECORD );
+
+    for( unsigned int i = 0; i < model->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = model->m_Meshes[i];
+
+        // the renderers skip the incomplete meshes, the next load builds them again
+        if( !mesh.m_Positions || !mesh.m_Normals || !mesh.m_FaceIdx || mesh.m_VertexSize == 0
+                || mesh.m_FaceIdxSize == 0 || mesh.m_FaceIdxSize % 3 )
+            return false;
+
+        records[i].m_vertexSize = mesh.m_VertexSize;
+        records[i].m_faceIdxSize = mesh.m_FaceIdxSize;
+        records[i].m_materialIdx = mesh.m_MaterialIdx;
+        records[i].m_flags = ( mesh.m_Texcoords ? MESH_HAS_TEXCOORDS : 0 )
+                             | ( mesh.m_Color ? MESH_HAS_COLORS : 0 );
+
+        header.m_fileSize += meshCacheDataSize( records[i] );
+    }
+
+    // Written aside then renamed, so the mapped files of the other instances stay valid
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+    wxString tmpFileName = fname + wxT( ".tmp" );
+    wxFFile  file;
+
+    if( !file.Open( tmpFileName, "wb" ) )
+        return false;
+
+    auto writeBytes = [&file]( const void* aData, size_t aSize ) -> bool
+                 {
+                     return aSize == 0 || file.Write( aData, aSize ) == aSize;
+                 };
+
+    bool ok = writeBytes( &header, sizeof( header ) )
+              && writeBytes( model->m_Materials, model->m_MaterialsSize * sizeof( SMATERIAL ) )
+              && writeBytes( records.data(), records.size() * sizeof( MESH_CACHE_RECORD ) );
+
+    for( unsigned int i = 0; ok && i < model->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = model->m_Meshes[i];
+
+        ok = writeBytes( mesh.m_Positions, mesh.m_VertexSize * sizeof( SFVEC3F ) )
+             && writeBytes( mesh.m_Normals, mesh.m_VertexSize * sizeof( SFVEC3F ) )
+             && ( !mesh.m_Texcoords
+                  || writeBytes( mesh.m_Texcoords, mesh.m_VertexSize * sizeof( SFVEC2F ) ) )
+             && ( !mesh.m_Color
+                  || writeBytes( mesh.m_Color, mesh.m_VertexSize * sizeof( SFVEC3F ) ) )
+             && writeBytes( mesh.m_FaceIdx, mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    ok = file.Close() && ok;
+
+    if( !ok || !wxRenameFile( tmpFileName, fname, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write mesh cache file '%s'", fname );
+        wxRemoveFile( tmpFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -654,6 +1093,8 @@ bool S3D_CACHE::SetProjectDir( const wxString& aProjDir )
 
     if( m_FNResolver->SetProjectDir( aProjDir, &hasChanged ) && hasChanged )
     {
+        std::lock_guard<std::mutex> lock( mutex3D_cache );
+
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -701,6 +1142,8 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters( void ) const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    std::lock_guard<std::mutex> lock( mutex3D_cache );
+
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -732,26 +1175,26 @@ void S3D_CACHE::ClosePlugins( void )
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
-
-    if( !sp )
-        return NULL;
+    load( aModelFileName, &cp, true );
 
+    // the model file could not be found
     if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
-
         return NULL;
-    }
+
+    std::lock_guard<std::mutex> lock( cp->loadLock );
 
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
+    if( !cp->sceneData )
+        return NULL;
+
+    S3DMODEL* mp = S3D::GetModel( cp->sceneData );
     cp->renderData = mp;
 
+    if( mp )
+        saveRenderCache( cp );
+
     return mp;
 }
 
@@ -763,21 +1206,14 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
     if( full3Dpath.empty() || !wxFileName::FileExists( full3Dpath ) )
         return wxEmptyString;
 
-    // check cache if file is already loaded
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
-
-    if( mi != m_CacheMap.end() )
-        return mi->second->GetCacheBaseName();
-
-    // a cache item does not exist; search the Filename->Cachename map
-    S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    S3D_CACHE_ENTRY*            cp = getCacheEntry( full3Dpath );
+    std::lock_guard<std::mutex> lock( cp->loadLock );
 
-    if( NULL != cp )
-        return cp->GetCacheBaseName();
+    // a new entry; search the Filename->Cachename map
+    if( !cp->checked )
+        checkCache( full3Dpath, cp );
 
-    return wxEmptyString;
+    return cp->GetCacheBaseName();
 }
 
 
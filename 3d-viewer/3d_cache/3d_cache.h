@@ -32,6 +32,7 @@
 #include "3d_info.h"
 #include <core/typeinfo.h>
 #include "kicad_string.h"
+#include <memory_usage.h>
 #include <list>
 #include <map>
 #include "plugins/3dapi/c3dmodel.h"
@@ -78,18 +79,26 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
-    /** Find or create cache entry for file name
+    /// the memory of the render data of the models
+    MEMORY_USAGE_PROVIDER m_memoryUsage;
+
+    /** Fill a new cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Searches the cache files for the given filename and retrieves
+     * the cache data; the model file is loaded and cached if the cache
+     * data does not already exist.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the new cache entry of aFileName, locked by the caller
+     * @param[in]   aRenderOnly true to only load the render data, as in load()
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                            bool aRenderOnly = false );
+
+    /// @return the cache entry of a file name (full path), created empty if there is none
+    S3D_CACHE_ENTRY* getCacheEntry( const wxString& aFileName );
 
     /**
      * Function getSHA1
@@ -108,8 +117,24 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // map the render data of a binary mesh cache file, without building the scene data
+    bool loadRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save the render data to a binary mesh cache file
+    bool saveRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    // load the scene data from the cache file, or else from the model file
+    SCENEGRAPH* loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * The real load function (can supply a cache entry pointer to member functions)
+     *
+     * @param aRenderOnly is true if only the render data is needed; the scene data is
+     * then not built when the binary mesh cache of the model is available, and NULL is
+     * returned even though the render data of the cache entry was loaded.
+     */
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderOnly = false );
 
 public:
     S3D_CACHE();
@@ -203,7 +228,12 @@ public:
     /**
      * Function GetModel
      * attempts to load the scene data for a model and to translate it
-     * into an S3D_MODEL structure for display by a renderer
+     * into an S3D_MODEL structure for display by a renderer.  The render data
+     * is saved to a binary mesh cache file, which is memory mapped the next
+     * times without building the scene data.
+     *
+     * Several models may be loaded concurrently from worker threads, as long as
+     * the cache is not flushed nor its project directory changed meanwhile.
      *
      * @param aModelFileName is the full path to the model to be loaded
      * @return is a pointer to the render data or NULL if not available
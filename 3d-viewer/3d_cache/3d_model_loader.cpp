@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include "3d_cache.h"
+#include "3d_model_loader.h"
+
+
+S3D_MODEL_LOADER::S3D_MODEL_LOADER() :
+        m_cache( NULL ),
+        m_takenCount( 0 ),
+        m_loadedCount( 0 )
+{
+}
+
+
+S3D_MODEL_LOADER::~S3D_MODEL_LOADER()
+{
+    Cancel();
+}
+
+
+void S3D_MODEL_LOADER::Start( S3D_CACHE* aCache, const std::vector< wxString >& aFileNames )
+{
+    Cancel();
+
+    m_cache = aCache;
+    m_fileNames = aFileNames;
+
+    std::sort( m_fileNames.begin(), m_fileNames.end() );
+    m_fileNames.erase( std::unique( m_fileNames.begin(), m_fileNames.end() ),
+                       m_fileNames.end() );
+
+    if( !m_cache || m_fileNames.empty() )
+        return;
+
+    m_tasks = std::make_unique<TASK_GROUP>( TASK_PRIORITY::BACKGROUND );
+
+    for( size_t ii = 0; ii < m_fileNames.size(); ++ii )
+        m_tasks->Run( [this, ii]() { loadModel( ii ); } );
+}
+
+
+void S3D_MODEL_LOADER::loadModel( size_t aIndex )
+{
+    const S3DMODEL* model = m_cache->GetModel( m_fileNames[aIndex] );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+    m_loaded.emplace_back( m_fileNames[aIndex], model );
+    m_loadedCount++;
+}
+
+
+void S3D_MODEL_LOADER::Cancel()
+{
+    if( m_tasks )
+        m_tasks->Cancel();
+
+    Wait();
+
+    m_fileNames.clear();
+    m_loaded.clear();
+    m_takenCount = 0;
+    m_loadedCount = 0;
+}
+
+
+void S3D_MODEL_LOADER::Wait()
+{
+    if( m_tasks )
+    {
+        m_tasks->Wait();
+        m_tasks.reset();
+    }
+}
+
+
+bool S3D_MODEL_LOADER::TakeLoaded( std::vector< LOADED_MODEL >& aModels )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        aModels.swap( m_loaded );
+        m_loaded.clear();
+    }
+
+    m_takenCount += aModels.size();
+
+    if( m_takenCount < m_fileNames.size() )
+        return true;
+
+    // all the models arrived, the workers are done
+    Wait();
+    return false;
+}
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_loader.h
+ * loads the render data of the 3D models of a board on worker threads
+ */
+
+#ifndef MODEL_LOADER_3D_H
+#define MODEL_LOADER_3D_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <thread_pool.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+class S3D_CACHE;
+
+
+/**
+ * S3D_MODEL_LOADER
+ *
+ * Loads the render data of a list of 3D models through S3D_CACHE::GetModel(), as background
+ * tasks of the application thread pool, so that a renderer displays the board while its
+ * models are loaded.  Each model is a task, so the interactive tasks do not wait for the
+ * whole load.
+ * The loaded models are taken by the renderer as they arrive, from its own thread.
+ */
+class S3D_MODEL_LOADER
+{
+public:
+    typedef std::pair< wxString, const S3DMODEL* > LOADED_MODEL;
+
+    S3D_MODEL_LOADER();
+    ~S3D_MODEL_LOADER();
+
+    /**
+     * Function Start
+     * cancels the current load, if any, and starts loading the models of
+     * aFileNames; a file name listed several times is loaded once.
+     */
+    void Start( S3D_CACHE* aCache, const std::vector< wxString >& aFileNames );
+
+    /**
+     * Function Cancel
+     * skips the models which are not being loaded yet, and drops
+     * the models which were not taken.
+     */
+    void Cancel();
+
+    /**
+     * Function Wait
+     * returns when all the models were loaded.
+     */
+    void Wait();
+
+    /**
+     * Function TakeLoaded
+     * replaces the content of aModels by the models loaded since the last
+     * call; the model of a file which could not be loaded is NULL.
+     *
+     * @return false once all the models were taken
+     */
+    bool TakeLoaded( std::vector< LOADED_MODEL >& aModels );
+
+    /// @return the number of models to load
+    size_t GetCount() const { return m_fileNames.size(); }
+
+    /// @return the number of models loaded so far
+    size_t GetLoadedCount() const { return m_loadedCount; }
+
+private:
+    void loadModel( size_t aIndex );
+
+    S3D_CACHE*                  m_cache;
+    std::vector< wxString >     m_fileNames;    ///< the unique files to load
+    std::vector< LOADED_MODEL > m_loaded;       ///< loaded and not yet taken, under m_lock
+    size_t                      m_takenCount;   ///< number of models taken
+    std::mutex                  m_lock;
+
+    std::atomic<size_t>         m_loadedCount;
+    std::unique_ptr<TASK_GROUP> m_tasks;
+};
+
+#endif  // MODEL_LOADER_3D_H
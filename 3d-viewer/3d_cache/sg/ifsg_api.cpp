@@ -34,6 +34,7 @@
 #include "3d_cache/sg/sg_appearance.h"
 #include "3d_cache/sg/sg_shape.h"
 #include "3d_cache/sg/sg_helpers.h"
+#include "3d_cache/sg/sg_mesh_pool.h"
 
 
 #ifdef DEBUG
@@ -515,8 +516,12 @@ S3DMODEL* S3D::GetModel( SCENEGRAPH* aNode )
         j = meshes.size();
         SMESH* lmesh = new SMESH[j];
 
+        // identical arrays of the meshes of other models are stored only once
         for( size_t i = 0; i < j; ++i )
+        {
             lmesh[i] = meshes[i];
+            S3D::SHARE_SMESH( lmesh[i] );
+        }
 
         model->m_Meshes = lmesh;
         model->m_MeshesSize = j;
@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "3d_cache/sg/sg_mesh_pool.h"
+
+
+namespace
+{
+
+struct POOL_ENTRY
+{
+    void*       m_data;
+    size_t      m_bytes;
+    uint64_t    m_hash;
+    size_t      m_refs;
+    void      (*m_free)( void* );
+};
+
+
+struct MESH_POOL
+{
+    std::mutex                                      m_lock;
+    std::unordered_multimap< uint64_t, POOL_ENTRY* > m_byHash;
+    std::unordered_map< const void*, POOL_ENTRY* >   m_byData;
+};
+
+
+template< class T >
+void freeArray( void* aArray )
+{
+    delete[] static_cast< T* >( aArray );
+}
+
+
+MESH_POOL& pool()
+{
+    // never destroyed: the models of the caches may be freed after the static destructors
+    static MESH_POOL* s_pool = new MESH_POOL;
+    return *s_pool;
+}
+
+
+/// 64 bit hash of the bytes of an array, mixing 8 bytes at a time
+uint64_t hashBytes( const void* aData, size_t aBytes )
+{
+    const unsigned char* p = static_cast< const unsigned char* >( aData );
+    uint64_t h = 0xcbf29ce484222325ULL ^ aBytes;
+
+    for( ; aBytes >= 8; aBytes -= 8, p += 8 )
+    {
+        uint64_t k;
+        memcpy( &k, p, 8 );
+        h = ( h ^ ( k * 0x9e3779b97f4a7c15ULL ) ) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+
+    for( ; aBytes > 0; --aBytes, ++p )
+        h = ( h ^ *p ) * 0x100000001b3ULL;
+
+    return h ^ ( h >> 29 );
+}
+
+
+/// @return the pooled array identical to aArray, which is then freed, or aArray itself
+template< class T >
+T* shareArray( T* aArray, size_t aCount )
+{
+    if( NULL == aArray || 0 == aCount )
+        return aArray;
+
+    const size_t bytes = aCount * sizeof( T );
+    const uint64_t hash = hashBytes( aArray, bytes );
+    MESH_POOL& mp = pool();
+
+    std::lock_guard< std::mutex > lock( mp.m_lock );
+
+    auto range = mp.m_byHash.equal_range( hash );
+
+    for( auto it = range.first; it != range.second; ++it )
+    {
+        POOL_ENTRY* entry = it->second;
+
+        if( entry->m_bytes == bytes && entry->m_free == &freeArray< T >
+                && 0 == memcmp( entry->m_data, aArray, bytes ) )
+        {
+            ++entry->m_refs;
+            delete[] aArray;
+            return static_cast< T* >( entry->m_data );
+        }
+    }
+
+    POOL_ENTRY* entry = new POOL_ENTRY{ aArray, bytes, hash, 1, &freeArray< T > };
+
+    mp.m_byHash.emplace( hash, entry );
+    mp.m_byData.emplace( aArray, entry );
+
+    return aArray;
+}
+
+}
+
+
+void S3D::SHARE_SMESH( SMESH& aMesh )
+{
+    const size_t nv = aMesh.m_VertexSize;
+
+    aMesh.m_Positions = shareArray( aMesh.m_Positions, nv );
+    aMesh.m_Normals = shareArray( aMesh.m_Normals, nv );
+    aMesh.m_Texcoords = shareArray( aMesh.m_Texcoords, nv );
+    aMesh.m_Color = shareArray( aMesh.m_Color, nv );
+    aMesh.m_FaceIdx = shareArray( aMesh.m_FaceIdx, aMesh.m_FaceIdxSize );
+}
+
+
+bool S3D::RELEASE_SHARED_ARRAY( const void* aArray )
+{
+    if( NULL == aArray )
+        return false;
+
+    MESH_POOL& mp = pool();
+    POOL_ENTRY* entry = NULL;
+
+    {
+        std::lock_guard< std::mutex > lock( mp.m_lock );
+
+        auto it = mp.m_byData.find( aArray );
+
+        if( it == mp.m_byData.end() )
+            return false;
+
+        entry = it->second;
+
+        if( --entry->m_refs > 0 )
+            return true;
+
+        mp.m_byData.erase( it );
+
+        auto range = mp.m_byHash.equal_range( entry->m_hash );
+
+        for( auto jt = range.first; jt != range.second; ++jt )
+        {
+            if( jt->second == entry )
+            {
+                mp.m_byHash.erase( jt );
+                break;
+            }
+        }
+    }
+
+    entry->m_free( entry->m_data );
+    delete entry;
+
+    return true;
+}
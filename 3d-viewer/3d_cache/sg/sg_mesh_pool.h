@@ -0,0 +1,57 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sg_mesh_pool.h
+ * defines the pool which shares the identical arrays of the meshes built from the scene graphs
+ *
+ * Many libraries ship model files which differ in their names, comments or formatting but
+ * describe the same geometry. The arrays of their render meshes are kept once in the pool,
+ * keyed by a hash of their content, and reference counted. A shared array must not be
+ * modified; it is released by FREE_SMESH() like any other array of a mesh.
+ */
+
+#ifndef SG_MESH_POOL_H
+#define SG_MESH_POOL_H
+
+#include "plugins/3dapi/c3dmodel.h"
+
+namespace S3D
+{
+    /**
+     * Function SHARE_SMESH
+     * replaces the arrays of aMesh with identical ones held by the pool, freeing its own
+     * copies, and adds its remaining arrays to the pool. This is thread safe.
+     */
+    void SHARE_SMESH( SMESH& aMesh );
+
+    /**
+     * Function RELEASE_SHARED_ARRAY
+     * drops a reference to an array of the pool and frees it with its last reference
+     *
+     * @return false if aArray is not held by the pool
+     */
+    bool RELEASE_SHARED_ARRAY( const void* aArray );
+}
+
+#endif  // SG_MESH_POOL_H
@@ -29,6 +29,7 @@
 #include <wx/log.h>
 
 #include "3d_cache/sg/sg_node.h"
+#include "3d_cache/sg/sg_mesh_pool.h"
 #include "plugins/3dapi/c3dmodel.h"
 
 static const std::string node_names[S3D::SGTYPE_END + 1] = {
@@ -378,31 +379,41 @@ void S3D::FREE_SMESH( SMESH& aMesh)
 {
     if( NULL != aMesh.m_Positions )
     {
-        delete [] aMesh.m_Positions;
+        if( !RELEASE_SHARED_ARRAY( aMesh.m_Positions ) )
+            delete [] aMesh.m_Positions;
+
         aMesh.m_Positions = NULL;
     }
 
     if( NULL != aMesh.m_Normals )
     {
-        delete [] aMesh.m_Normals;
+        if( !RELEASE_SHARED_ARRAY( aMesh.m_Normals ) )
+            delete [] aMesh.m_Normals;
+
         aMesh.m_Normals = NULL;
     }
 
     if( NULL != aMesh.m_Texcoords )
     {
-        delete [] aMesh.m_Texcoords;
+        if( !RELEASE_SHARED_ARRAY( aMesh.m_Texcoords ) )
+            delete [] aMesh.m_Texcoords;
+
         aMesh.m_Texcoords = NULL;
     }
 
     if( NULL != aMesh.m_Color )
     {
-        delete [] aMesh.m_Color;
+        if( !RELEASE_SHARED_ARRAY( aMesh.m_Color ) )
+            delete [] aMesh.m_Color;
+
         aMesh.m_Color = NULL;
     }
 
     if( NULL != aMesh.m_FaceIdx )
     {
-        delete [] aMesh.m_FaceIdx;
+        if( !RELEASE_SHARED_ARRAY( aMesh.m_FaceIdx ) )
+            delete [] aMesh.m_FaceIdx;
+
         aMesh.m_FaceIdx = NULL;
     }
 
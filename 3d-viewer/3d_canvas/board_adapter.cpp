@@ -46,6 +46,8 @@
  */
 const wxChar *BOARD_ADAPTER::m_logTrace = wxT( "KI_TRACE_EDA_CINFO3D_VISU" );
 
+std::mutex BOARD_ADAPTER::m_textLock;
+
 
 BOARD_ADAPTER::BOARD_ADAPTER() :
         m_board( nullptr ),
@@ -273,16 +275,7 @@ void BOARD_ADAPTER::InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarn
     wxLogTrace( m_logTrace, wxT( "BOARD_ADAPTER::InitSettings" ) );
 
     // Calculates the board bounding box
-    // First, use only the board outlines
-    EDA_RECT bbbox = m_board->ComputeBoundingBox( true );
-
-    // If no outlines, use the board with items
-    if( ( bbbox.GetWidth() == 0 ) && ( bbbox.GetHeight() == 0 ) )
-        bbbox = m_board->ComputeBoundingBox( false );
-
-    // Gives a non null size to avoid issues in zoom / scale calculations
-    if( ( bbbox.GetWidth() == 0 ) && ( bbbox.GetHeight() == 0 ) )
-        bbbox.Inflate( Millimeter2iu( 10 ) );
+    EDA_RECT bbbox = computeBoardBoundingBox();
 
     m_boardSize = bbbox.GetSize();
     m_boardPos  = bbbox.Centre();
@@ -436,7 +429,8 @@ void BOARD_ADAPTER::InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarn
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create layers" ) );
 
-    createLayers( aStatusTextReporter );
+    destroyLayers();
+    createLayers( aStatusTextReporter, LSET::AllLayersMask(), true );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_stopCreateLayersTime = GetRunningMicroSecs();
@@ -451,6 +445,63 @@ void BOARD_ADAPTER::InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarn
 }
 
 
+bool BOARD_ADAPTER::UpdateLayers( const LSET& aLayers, REPORTER* aStatusTextReporter )
+{
+    wxLogTrace( m_logTrace, wxT( "BOARD_ADAPTER::UpdateLayers" ) );
+
+    // The board outline gives the scale and the position of all the 3D coordinates, so the
+    // whole board is built again when it changes
+    if( m_layers_container2D.empty() || aLayers[Edge_Cuts] )
+        return false;
+
+    if( std::max( m_board->GetCopperLayerCount(), 2 ) != (int) m_copperLayersCount )
+        return false;
+
+    const EDA_RECT bbbox = computeBoardBoundingBox();
+
+    if( bbbox.GetSize() != m_boardSize
+            || bbbox.Centre() != wxPoint( m_boardPos.x, -m_boardPos.y ) )
+        return false;
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_startUpdateLayersTime = GetRunningMicroSecs();
+#endif
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Update layers" ) );
+
+    // The holes are made of the vias and the pads of all the copper layers
+    const bool holes = ( aLayers & LSET::AllCuMask() ).any();
+
+    destroyLayers( aLayers, holes );
+    createLayers( aStatusTextReporter, aLayers, holes );
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    printf( "BOARD_ADAPTER::UpdateLayers %d layers: %.3f ms\n", (int) aLayers.count(),
+            (float)( GetRunningMicroSecs() - stats_startUpdateLayersTime ) / 1e3 );
+#endif
+
+    return true;
+}
+
+
+EDA_RECT BOARD_ADAPTER::computeBoardBoundingBox() const
+{
+    // First, use only the board outlines
+    EDA_RECT bbbox = m_board->ComputeBoundingBox( true );
+
+    // If no outlines, use the board with items
+    if( ( bbbox.GetWidth() == 0 ) && ( bbbox.GetHeight() == 0 ) )
+        bbbox = m_board->ComputeBoundingBox( false );
+
+    // Gives a non null size to avoid issues in zoom / scale calculations
+    if( ( bbbox.GetWidth() == 0 ) && ( bbbox.GetHeight() == 0 ) )
+        bbbox.Inflate( Millimeter2iu( 10 ) );
+
+    return bbbox;
+}
+
+
 bool BOARD_ADAPTER::createBoardPolygon()
 {
     m_board_poly.RemoveAllContours();
@@ -26,6 +26,7 @@
 #define BOARD_ADAPTER_H
 
 #include <array>
+#include <mutex>
 #include <vector>
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer2d.h"
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer.h"
@@ -134,6 +135,16 @@ class BOARD_ADAPTER
      */
     void InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter );
 
+    /**
+     * @brief UpdateLayers - Build again only the layers changed by an edit of the board, and
+     * the holes if a copper layer changed.
+     * @param aLayers: the layers of the changed items
+     * @param aStatusTextReporter: the pointer for the status reporter
+     * @return false, with nothing done, if the whole board must be built again by InitSettings
+     * (the board outline or the number of copper layers changed)
+     */
+    bool UpdateLayers( const LSET& aLayers, REPORTER* aStatusTextReporter );
+
     /**
      * @brief BiuTo3Dunits - Board integer units To 3D units
      * @return the conversion factor to transform a position from the board to 3d units
@@ -422,8 +433,38 @@ class BOARD_ADAPTER
      * @return false if the outline could not be created
      */
     bool createBoardPolygon();
-    void createLayers( REPORTER *aStatusTextReporter );
+
+    /// @return the box of the board outlines, or of the items if there is no outline
+    EDA_RECT computeBoardBoundingBox() const;
+
+    /**
+     * Build the items of aLayers, and the holes if aHoles is true, after they were destroyed
+     */
+    void createLayers( REPORTER *aStatusTextReporter, const LSET& aLayers, bool aHoles );
     void destroyLayers();
+    void destroyLayers( const LSET& aLayers, bool aHoles );
+
+    // Tasks of createLayers, each one fills its own containers and polygons
+    void createCopperLayerObjects( PCB_LAYER_ID aLayerId,
+                                   const std::vector< const TRACK *>& aTrackList );
+
+    void createCopperLayerPolys( PCB_LAYER_ID aLayerId,
+                                 const std::vector< const TRACK *>& aTrackList );
+
+    void createViaHoles( const std::vector< const TRACK *>& aTrackList,
+                         const std::vector< PCB_LAYER_ID >& aLayers );
+
+    void createViaHolesPolys( const std::vector< const TRACK *>& aTrackList,
+                              const std::vector< PCB_LAYER_ID >& aLayers );
+
+    void createThroughHolesPolys( const std::vector< const TRACK *>& aTrackList,
+                                  const std::vector< PCB_LAYER_ID >& aLayers );
+
+    void createPadHoles();
+
+    void createTechLayerObjects( PCB_LAYER_ID aLayerId );
+
+    void createTechLayerPolys( PCB_LAYER_ID aLayerId );
 
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
@@ -591,6 +632,11 @@ private:
     /// the radius of the hole
     CBVHCONTAINER2D   m_through_holes_vias_inner;
 
+    /// GRText draws with a shared GAL and its callbacks are given static parameters, so the
+    /// tasks of createLayers, and the adapters rendering other boards at the same time,
+    /// convert their texts one at a time
+    static std::mutex m_textLock;
+
 
     // Layers information
 
@@ -92,6 +92,8 @@ void BOARD_ADAPTER::AddShapeWithClearanceToContainer( const TEXTE_PCB* aText,
     if( aText->IsMirrored() )
         size.x = -size.x;
 
+    std::lock_guard<std::mutex> lock( m_textLock );
+
     s_boardItem    = (const BOARD_ITEM *) &aText;
     s_dstcontainer = aDstContainer;
     s_textWidth    = aText->GetThickness() + ( 2 * aClearanceValue );
@@ -210,6 +212,8 @@ void BOARD_ADAPTER::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMo
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
+    std::lock_guard<std::mutex> lock( m_textLock );
+
     s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
     s_dstcontainer = aDstContainer;
     s_biuTo3Dunits = m_biuTo3Dunits;
@@ -52,53 +52,53 @@
 #include <trigo.h>
 #include <utility>
 #include <vector>
-#include <thread>
 #include <algorithm>
 #include <atomic>
+#include <functional>
+#include <mutex>
 
 #include <profile.h>
+#include <thread_pool.h>
 
-void BOARD_ADAPTER::destroyLayers()
+/**
+ * Deletes the items of a map of layers which are in aLayers
+ */
+template <class MAP>
+static void destroyMapLayers( MAP& aMap, const LSET& aLayers )
 {
-    if( !m_layers_poly.empty() )
-    {
-        for( auto& poly : m_layers_poly )
-            delete poly.second;
-
-        m_layers_poly.clear();
-    }
-
-    if( !m_layers_inner_holes_poly.empty() )
+    for( auto it = aMap.begin(); it != aMap.end(); )
     {
-        for( auto& poly : m_layers_inner_holes_poly )
-            delete poly.second;
-
-        m_layers_inner_holes_poly.clear();
+        if( aLayers[it->first] )
+        {
+            delete it->second;
+            it = aMap.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
     }
+}
 
-    if( !m_layers_outer_holes_poly.empty() )
-    {
-        for( auto& poly : m_layers_outer_holes_poly )
-            delete poly.second;
 
-        m_layers_outer_holes_poly.clear();
-    }
+void BOARD_ADAPTER::destroyLayers()
+{
+    destroyLayers( LSET::AllLayersMask(), true );
+}
 
-    if( !m_layers_container2D.empty() )
-    {
-        for( auto& poly : m_layers_container2D )
-            delete poly.second;
 
-        m_layers_container2D.clear();
-    }
+void BOARD_ADAPTER::destroyLayers( const LSET& aLayers, bool aHoles )
+{
+    destroyMapLayers( m_layers_poly, aLayers );
+    destroyMapLayers( m_layers_container2D, aLayers );
 
-    if( !m_layers_holes2D.empty() )
-    {
-        for( auto& poly : m_layers_holes2D )
-            delete poly.second;
+    if( !aHoles )
+        return;
 
-        m_layers_holes2D.clear();
-    }
+    // The holes depend on the vias and the pads of all the copper layers
+    destroyMapLayers( m_layers_inner_holes_poly, LSET::AllLayersMask() );
+    destroyMapLayers( m_layers_outer_holes_poly, LSET::AllLayersMask() );
+    destroyMapLayers( m_layers_holes2D, LSET::AllLayersMask() );
 
     m_through_holes_inner.Clear();
     m_through_holes_outer.Clear();
@@ -106,25 +106,50 @@ void BOARD_ADAPTER::destroyLayers()
     m_through_holes_vias_inner.Clear();
     m_through_outer_holes_poly_NPTH.RemoveAllContours();
     m_through_outer_holes_poly.RemoveAllContours();
-    //m_through_inner_holes_poly.RemoveAllContours();
+    m_through_inner_holes_poly.RemoveAllContours();
 
     m_through_outer_holes_vias_poly.RemoveAllContours();
     m_through_inner_holes_vias_poly.RemoveAllContours();
 }
 
 
-void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
+/**
+ * Runs the tasks of a stage of createLayers on the shared thread pool, the calling thread
+ * being one of the workers, and returns once they are all done.
+ */
+static void runLayerTasks( const std::vector< std::function<void()> >& aTasks )
 {
-    destroyLayers();
+    std::atomic<size_t> nextTask( 0 );
+
+    auto work = [&nextTask, &aTasks]()
+    {
+        for( size_t i = nextTask++; i < aTasks.size(); i = nextTask++ )
+            aTasks[i]();
+    };
+
+    if( aTasks.size() <= 1 )
+        work();
+    else
+        GetKiCadThreadPool().RunParallel( work, aTasks.size() );
+}
+
 
-    // Build Copper layers
+void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter, const LSET& aLayers,
+                                  bool aHoles )
+{
+    // The board is built by tasks on the shared thread pool, in two stages:
+    // - the items are converted to the 2D objects and the polygons of each layer, with one
+    //   task per layer (copper and tech layers, silkscreen included), per zone, and for the
+    //   vias and the holes of the pads;
+    // - then the polygons are simplified and the BVHs are built, one task per polygon or BVH.
+    // All the containers are created before, so each task only writes to the containers it
+    // owns (or to the locked CBVHCONTAINER2D).
+    // Only the layers of aLayers are built, their previous items must have been destroyed.
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
     // /////////////////////////////////////////////////////////////////////////
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startCopperLayersTime = GetRunningMicroSecs();
-
-    unsigned start_Time = stats_startCopperLayersTime;
+    unsigned stats_startPrepareTime = GetRunningMicroSecs();
 #endif
 
     PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
@@ -137,6 +162,9 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     m_stats_nr_holes                = 0;
     m_stats_hole_med_diameter       = 0;
 
+    const bool buildCopperPolys = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                                  && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
+
     // Prepare track list, convert in a vector. Calc statistic for the holes
     // /////////////////////////////////////////////////////////////////////////
     std::vector< const TRACK *> trackList;
@@ -172,17 +200,37 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     if( m_stats_nr_vias )
         m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T01: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    // Calc statistic for the holes of the pads
+    // /////////////////////////////////////////////////////////////////////////
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            // The bounding radius is cached by the pad at its first use, do it before the
+            // tasks share the pad
+            pad->GetBoundingRadius();
+
+            if( !pad->GetDrillSize().x )    // Not drilled pad like SMD pad
+                continue;
+
+            m_stats_nr_holes++;
+            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+        }
+    }
+
+    if( m_stats_nr_holes )
+        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
     // Prepare copper layers index and containers
+    // The holes are built on all the copper layers, the items only on the layers to build
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
     layer_id.clear();
     layer_id.reserve( m_copperLayersCount );
 
+    std::vector< PCB_LAYER_ID > copper_layer_id;
+
     for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
@@ -195,65 +243,435 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
         layer_id.push_back( curr_layer_id );
 
+        if( !aLayers[curr_layer_id] )
+            continue;
+
+        copper_layer_id.push_back( curr_layer_id );
+
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
         m_layers_container2D[curr_layer_id] = layerContainer;
 
-        if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-                && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+        if( buildCopperPolys )
         {
             SHAPE_POLY_SET* layerPoly    = new SHAPE_POLY_SET;
             m_layers_poly[curr_layer_id] = layerPoly;
         }
     }
 
+    // Prepare the holes containers of the layers with blind or buried vias
+    // /////////////////////////////////////////////////////////////////////////
+    for( const TRACK* track : trackList )
+    {
+        if( !aHoles )
+            break;
+
+        if( track->Type() != PCB_VIA_T
+                || static_cast<const VIA*>( track )->GetViaType() == VIATYPE::THROUGH )
+            continue;
+
+        for( PCB_LAYER_ID curr_layer_id : layer_id )
+        {
+            if( !track->IsOnLayer( curr_layer_id )
+                    || m_layers_holes2D.find( curr_layer_id ) != m_layers_holes2D.end() )
+                continue;
+
+            m_layers_holes2D[curr_layer_id]          = new CBVHCONTAINER2D;
+            m_layers_outer_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
+            m_layers_inner_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
+        }
+    }
+
+    // Prepare tech layers containers
+    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
+    // /////////////////////////////////////////////////////////////////////////
+
+    // draw graphic items, on technical layers
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
+
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
+
+    std::vector< PCB_LAYER_ID > tech_layer_id;
+
+    // User layers are not drawn here, only technical layers
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
+
+        if( !Is3DLayerEnabled( curr_layer_id ) || !aLayers[curr_layer_id] )
+            continue;
+
+        tech_layer_id.push_back( curr_layer_id );
+
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
+        m_layers_poly[curr_layer_id]        = new SHAPE_POLY_SET;
+    }
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T02: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
+    unsigned stats_endPrepareTime = GetRunningMicroSecs();
 #endif
 
+    // Stage 1: convert the board items
+    // /////////////////////////////////////////////////////////////////////////
     if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Create tracks and vias" ) );
+        aStatusTextReporter->Report( _( "Create tracks, vias, pads and zones" ) );
+
+    std::vector< std::function<void()> > tasks;
+
+    // Add zones objects, the longest tasks are queued first
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
+
+            if( !IsCopperLayer( zone->GetLayer() ) || !aLayers[zone->GetLayer()]
+                    || layerContainer == m_layers_container2D.end() )
+                continue;
+
+            tasks.push_back( [this, zone, layerContainer]()
+            {
+                AddSolidAreasShapesToContainer( zone, layerContainer->second, zone->GetLayer() );
+            } );
+        }
+    }
+
+    // Creates outline contours of the copper layers
+    if( buildCopperPolys )
+    {
+        for( PCB_LAYER_ID curr_layer_id : copper_layer_id )
+        {
+            tasks.push_back( [this, curr_layer_id, &trackList]()
+            {
+                createCopperLayerPolys( curr_layer_id, trackList );
+            } );
+        }
+    }
+
+    // Add tracks, pads and graphic items objects of the copper layers
+    for( PCB_LAYER_ID curr_layer_id : copper_layer_id )
+    {
+        tasks.push_back( [this, curr_layer_id, &trackList]()
+        {
+            createCopperLayerObjects( curr_layer_id, trackList );
+        } );
+    }
+
+    // Tech layers (silkscreen included), objects and contours
+    for( PCB_LAYER_ID curr_layer_id : tech_layer_id )
+    {
+        tasks.push_back( [this, curr_layer_id]()
+        {
+            createTechLayerObjects( curr_layer_id );
+        } );
+
+        tasks.push_back( [this, curr_layer_id]()
+        {
+            createTechLayerPolys( curr_layer_id );
+        } );
+    }
+
+    // Vias and holes
+    if( aHoles )
+    {
+        tasks.push_back( [this, &trackList, &layer_id]()
+        {
+            createViaHoles( trackList, layer_id );
+        } );
+
+        tasks.push_back( [this, &trackList, &layer_id]()
+        {
+            createViaHolesPolys( trackList, layer_id );
+        } );
+
+        tasks.push_back( [this]()
+        {
+            createPadHoles();
+        } );
+
+        tasks.push_back( [this, &trackList, &layer_id]()
+        {
+            // Add the contours of the through holes, of the vias then of the pads
+            createThroughHolesPolys( trackList, layer_id );
+        } );
+    }
+
+    runLayerTasks( tasks );
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_endItemsTime = GetRunningMicroSecs();
+#endif
 
-    // Create tracks as objects and add it to container
+    // Stage 2: simplify the polygons and build the BVHs
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Simplifying layers polygons" ) );
+
+    tasks.clear();
+
+    // This will make a union of all added contours
+    for( auto& layerPoly : m_layers_poly )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        if( !aLayers[layerPoly.first] )
+            continue;
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        SHAPE_POLY_SET *poly = layerPoly.second;
+        tasks.push_back( [poly]() { poly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+    }
 
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+    if( aHoles )
+    {
+        for( auto& holesPoly : m_layers_outer_holes_poly )
+        {
+            SHAPE_POLY_SET *poly = holesPoly.second;
+            tasks.push_back( [poly]() { poly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+        }
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        for( auto& holesPoly : m_layers_inner_holes_poly )
         {
-            const TRACK *track = trackList[trackIdx];
+            SHAPE_POLY_SET *poly = holesPoly.second;
+            tasks.push_back( [poly]() { poly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+        }
 
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+        for( SHAPE_POLY_SET *poly : { &m_through_inner_holes_poly,
+                                      &m_through_outer_holes_poly,
+                                      &m_through_outer_holes_poly_NPTH,
+                                      &m_through_outer_holes_vias_poly } )
+        {
+            tasks.push_back( [poly]() { poly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+        }
+
+        //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+
+        // Build BVH for holes and vias
+        tasks.push_back( [this]() { m_through_holes_inner.BuildBVH(); } );
+        tasks.push_back( [this]() { m_through_holes_outer.BuildBVH(); } );
+
+        for( auto& hole : m_layers_holes2D )
+        {
+            CBVHCONTAINER2D *container = hole.second;
+            tasks.push_back( [container]() { container->BuildBVH(); } );
+        }
+    }
 
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
+    // We only need the Solder mask to initialize the BVH
+    // because..?
+    for( PCB_LAYER_ID maskLayer : { B_Mask, F_Mask } )
+    {
+        auto layerContainer = m_layers_container2D.find( maskLayer );
+
+        if( aLayers[maskLayer] && layerContainer != m_layers_container2D.end() )
+        {
+            CBVHCONTAINER2D *container = layerContainer->second;
+            tasks.push_back( [container]() { container->BuildBVH(); } );
         }
     }
 
+    runLayerTasks( tasks );
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
+    unsigned stats_endSimplifyTime = GetRunningMicroSecs();
+
+    printf( "BOARD_ADAPTER::createLayers times (%u threads)\n",
+            GetKiCadThreadPool().GetThreadCount() + 1 );
+    printf( "  Prepare containers:     %.3f ms\n",
+            (float)( stats_endPrepareTime  - stats_startPrepareTime ) / 1e3 );
+    printf( "  Convert items:          %.3f ms\n",
+            (float)( stats_endItemsTime    - stats_endPrepareTime   ) / 1e3 );
+    printf( "  Simplify and BVH:       %.3f ms\n",
+            (float)( stats_endSimplifyTime - stats_endItemsTime     ) / 1e3 );
+    printf( "Statistics:\n" );
+    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
+    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
+    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
+    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
+    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
+    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
+    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
 #endif
+}
 
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+
+void BOARD_ADAPTER::createCopperLayerObjects( PCB_LAYER_ID aLayerId,
+                                              const std::vector< const TRACK *>& aTrackList )
+{
+    wxASSERT( m_layers_container2D.find( aLayerId ) != m_layers_container2D.end() );
+
+    CBVHCONTAINER2D *layerContainer = m_layers_container2D.find( aLayerId )->second;
+
+    // ADD TRACKS
+    for( const TRACK* track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add object item to layer container
+        layerContainer->Add( createNewTrack( track, 0.0f ) );
+    }
+
+    // ADD PADS
+    for( MODULE* module : m_board->Modules() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module,
+                                               layerContainer,
+                                               aLayerId,
+                                               0,
+                                               true );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   aLayerId,
+                                                   0 );
+    }
+
+    // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+        {
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        }
+        break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+        break;
+        }
+    }
+}
+
+
+void BOARD_ADAPTER::createCopperLayerPolys( PCB_LAYER_ID aLayerId,
+                                            const std::vector< const TRACK *>& aTrackList )
+{
+    wxASSERT( m_layers_poly.find( aLayerId ) != m_layers_poly.end() );
+
+    SHAPE_POLY_SET *layerPoly = m_layers_poly.find( aLayerId )->second;
+
+    // ADD TRACKS
+    for( const TRACK* track : aTrackList )
+    {
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add the track contour
+        track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
+    }
+
+    // ADD PADS
+    for( auto module : m_board->Modules() )
+    {
+        // Construct polys
+        // /////////////////////////////////////////////////////////////////////
+
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        transformPadsShapesWithClearanceToPolygon( module->Pads(),
+                                                   aLayerId,
+                                                   *layerPoly,
+                                                   0,
+                                                   true );
+
+        // Micro-wave modules may have items on copper layers
+        {
+            std::lock_guard<std::mutex> lock( m_textLock );
+            module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId, *layerPoly, 0 );
+        }
+
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *layerPoly );
+    }
+
+    // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+    for( BOARD_ITEM* item : m_board->Drawings() )
     {
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
+            break;
+
+        case PCB_TEXT_T:
+        {
+            std::lock_guard<std::mutex> lock( m_textLock );
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
+        }
+            break;
+
+        default:
+            wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+            break;
+        }
+    }
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+    // ADD COPPER ZONES
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            const TRACK *track = trackList[trackIdx];
+            if( zone->GetLayer() == aLayerId )
+                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
+        }
+    }
+}
 
+
+void BOARD_ADAPTER::createViaHoles( const std::vector< const TRACK *>& aTrackList,
+                                    const std::vector< PCB_LAYER_ID >& aLayers )
+{
+    // Create VIAS and THTs objects and add it to holes containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( PCB_LAYER_ID curr_layer_id : aLayers )
+    {
+        for( const TRACK* track : aTrackList )
+        {
             if( !track->IsOnLayer( curr_layer_id ) )
                 continue;
 
@@ -271,31 +689,21 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
                 if( viatype != VIATYPE::THROUGH )
                 {
-
                     // Add hole objects
                     // /////////////////////////////////////////////////////////
 
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
-                    {
-                        // not found, create a new container
-                        layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
-                    }
+                    // The container of the layer was created before the tasks
+                    wxASSERT( m_layers_holes2D.find( curr_layer_id ) != m_layers_holes2D.end() );
+
+                    CBVHCONTAINER2D *layerHoleContainer =
+                            m_layers_holes2D.find( curr_layer_id )->second;
 
                     // Add a hole for this layer
                     layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
                                                                   hole_inner_radius + thickness,
                                                                   *track ) );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
+                else if( curr_layer_id == aLayers[0] ) // it only adds once the THT holes
                 {
                     // Add through hole object
                     // /////////////////////////////////////////////////////////
@@ -319,171 +727,86 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
             }
         }
     }
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Create VIAS and THTs objects and add it to holes containers
+void BOARD_ADAPTER::createViaHolesPolys( const std::vector< const TRACK *>& aTrackList,
+                                         const std::vector< PCB_LAYER_ID >& aLayers )
+{
+    // Add VIA hole contourns of the blind and buried vias
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( PCB_LAYER_ID curr_layer_id : aLayers )
     {
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        for( const TRACK* track : aTrackList )
         {
-            const TRACK *track = trackList[trackIdx];
-
-            if( !track->IsOnLayer( curr_layer_id ) )
+            if( !track->IsOnLayer( curr_layer_id ) || track->Type() != PCB_VIA_T )
                 continue;
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE viatype = via->GetViaType();
-
-                if( viatype != VIATYPE::THROUGH )
-                {
-
-                    // Add VIA hole contourns
-                    // /////////////////////////////////////////////////////////
-
-                    // Add outer holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
-                    {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
-                    }
-
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
-
-                    TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+            const VIA *via = static_cast< const VIA*>( track );
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
-                }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
+            if( via->GetViaType() == VIATYPE::THROUGH )
+                continue;
 
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+            // The contours of the layer were created before the tasks
+            wxASSERT( m_layers_outer_holes_poly.find( curr_layer_id ) !=
+                      m_layers_outer_holes_poly.end() );
+            wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
+                      m_layers_inner_holes_poly.end() );
 
-                    TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
+            // Add outer holes of VIAs
+            SHAPE_POLY_SET *layerOuterHolesPoly =
+                    m_layers_outer_holes_poly.find( curr_layer_id )->second;
+            SHAPE_POLY_SET *layerInnerHolesPoly =
+                    m_layers_inner_holes_poly.find( curr_layer_id )->second;
 
-                    // Add samething for vias only
+            const int holediameter = via->GetDrillValue();
+            const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
 
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+            TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
+                    hole_outer_radius, ARC_HIGH_DEF );
 
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
-                }
-            }
+            TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
+                    holediameter / 2, ARC_HIGH_DEF );
         }
     }
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Creates outline contours of the tracks and add it to the poly of the layer
+void BOARD_ADAPTER::createThroughHolesPolys( const std::vector< const TRACK *>& aTrackList,
+                                             const std::vector< PCB_LAYER_ID >& aLayers )
+{
+    // Add through hole contourns of the vias
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    for( const TRACK* track : aTrackList )
     {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
+        // it only adds once the THT holes
+        if( aLayers.empty() || !track->IsOnLayer( aLayers[0] ) || track->Type() != PCB_VIA_T )
+            continue;
 
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
+        const VIA *via = static_cast< const VIA*>( track );
 
-                // Add the track contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-            }
-        }
-    }
+        if( via->GetViaType() != VIATYPE::THROUGH )
+            continue;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+        const int holediameter = via->GetDrillValue();
+        const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
 
-    // Add holes of modules
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
-        {
-            const wxSize padHole = pad->GetDrillSize();
+        TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
+                hole_outer_radius, ARC_HIGH_DEF );
 
-            if( !padHole.x )    // Not drilled pad like SMD pad
-                continue;
+        TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
+                holediameter / 2, ARC_HIGH_DEF );
 
-            // The hole in the body is inflated by copper thickness,
-            // if not plated, no copper
-            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
-                                GetCopperThicknessBIU() : 0;
+        // Add samething for vias only
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+        TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
+                hole_outer_radius, ARC_HIGH_DEF );
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
-            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
-        }
+        //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
+        //                          via->GetStart(),
+        //                          holediameter / 2,
+        //                          GetNrSegmentsCircle( holediameter ) );
     }
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
     // Add contours of the pad holes (pads can be Circle or Segment holes)
     // /////////////////////////////////////////////////////////////////////////
@@ -511,568 +834,184 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
             }
         }
     }
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add modules PADs objects to containers
+void BOARD_ADAPTER::createPadHoles()
+{
+    // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( MODULE* module : m_board->Modules() )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( MODULE* module : m_board->Modules() )
+        for( D_PAD* pad : module->Pads() )
         {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+            const wxSize padHole = pad->GetDrillSize();
 
-    // Add modules PADs poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+            if( !padHole.x )    // Not drilled pad like SMD pad
+                continue;
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+            // The hole in the body is inflated by copper thickness,
+            // if not plated, no copper
+            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
+                                GetCopperThicknessBIU() : 0;
 
-            // ADD PADS
-            for( auto module : m_board->Modules() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->Pads(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                       *layerPoly,
-                                                                       0 );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
+            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
+            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
         }
     }
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add graphic item on copper layers to object containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+void BOARD_ADAPTER::createTechLayerObjects( PCB_LAYER_ID aLayerId )
+{
+    CBVHCONTAINER2D *layerContainer = m_layers_container2D.find( aLayerId )->second;
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+    // Add drawing objects
+    // /////////////////////////////////////////////////////////////////////
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
+        switch( item->Type() )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
             break;
 
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
             break;
 
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
             break;
 
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
+        default:
             break;
-            }
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Add modules tech layers - objects
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module : m_board->Modules() )
     {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
         {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
+            int     linewidth = g_DrawDefaultLineThickness;
 
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( BOARD_ITEM* item : m_board->Drawings() )
+            for( D_PAD* pad : module->Pads() )
             {
-                if( !item->IsOnLayer( cur_layer_id ) )
+                if( !pad->IsOnLayer( aLayerId ) )
                     continue;
 
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                    break;
-                }
+                buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
             }
         }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) )
-    {
-        if( aStatusTextReporter )
-            aStatusTextReporter->Report( _( "Create zones" ) );
-
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        else
         {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
-                {
-                    const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
-
-                    if( zone == nullptr )
-                        break;
-
-                    auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
-
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second,
-                                                        zone->GetLayer() );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
+            AddPadsShapesWithClearanceToContainer(
+                    module, layerContainer, aLayerId, 0, false );
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
+        AddGraphicsShapesWithClearanceToContainer( module, layerContainer, aLayerId, 0 );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "fill zones T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Draw non copper zones
+    // /////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
     {
-        // ADD COPPER ZONES
         for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            if( zone == nullptr )
-                break;
-
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
 
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second );
+            AddSolidAreasShapesToContainer( zone, layerContainer, aLayerId );
         }
     }
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Simplify layer polygons
-    // /////////////////////////////////////////////////////////////////////////
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
+void BOARD_ADAPTER::createTechLayerPolys( PCB_LAYER_ID aLayerId )
+{
+    SHAPE_POLY_SET *layerPoly = m_layers_poly.find( aLayerId )->second;
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Add drawing contours
+    // /////////////////////////////////////////////////////////////////////
+    for( BOARD_ITEM* item : m_board->Drawings() )
     {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        switch( item->Type() )
         {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
+            break;
 
-    for( PCB_LAYER_ID layer : layer_id )
-    {
-        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
+        case PCB_TEXT_T:
         {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-
-            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
+            std::lock_guard<std::mutex> lock( m_textLock );
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
+        }
+            break;
 
-            polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        default:
+            break;
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-#endif
-    // End Build Copper layers
-
-
-    // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
-#endif
-
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
-    // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startTechLayersTime = GetRunningMicroSecs();
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
-
-    // User layers are not drawn here, only technical layers
-
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
+    // Add modules tech layers - contours
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module : m_board->Modules() )
     {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-            continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        // /////////////////////////////////////////////////////////////////////
-        for( BOARD_ITEM* item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add drawing contours
-        // /////////////////////////////////////////////////////////////////////
-        for( BOARD_ITEM* item : m_board->Drawings() )
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            const int linewidth = g_DrawDefaultLineThickness;
 
-            switch( item->Type() )
+            for( D_PAD* pad : module->Pads() )
             {
-            case PCB_LINE_T:
-                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                break;
-
-            case PCB_TEXT_T:
-                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                break;
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
 
-            default:
-                break;
+                buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
             }
         }
-
-
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
+        else
         {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                int     linewidth = g_DrawDefaultLineThickness;
-
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer(
-                        module, layerContainer, curr_layer_id, 0, false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
+            transformPadsShapesWithClearanceToPolygon(
+                    module->Pads(), aLayerId, *layerPoly, 0, false );
         }
 
-
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
         {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
-
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon(
-                        module->Pads(), curr_layer_id, *layerPoly, 0, false );
-            }
-
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
-
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+            std::lock_guard<std::mutex> lock( m_textLock );
+            module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId, *layerPoly, 0 );
         }
 
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *layerPoly );
+    }
 
-        // Draw non copper zones
-        // /////////////////////////////////////////////////////////////////////
-        if( GetFlag( FL_ZONE ) )
+    // Draw non copper zones
+    // /////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
-            }
-
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
 
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
-            }
+            zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
         }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
-    // End Build Tech layers
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endTechLayersTime = GetRunningMicroSecs();
-#endif
-
-
-    // Build BVH for holes and vias
-    // /////////////////////////////////////////////////////////////////////////
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
-#endif
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
-
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
-
-    if( !m_layers_holes2D.empty() )
-    {
-        for( auto& hole : m_layers_holes2D)
-            hole.second->BuildBVH();
     }
-
-    // We only need the Solder mask to initialize the BVH
-    // because..?
-    if( m_layers_container2D[B_Mask] )
-        m_layers_container2D[B_Mask]->BuildBVH();
-
-    if( m_layers_container2D[F_Mask] )
-        m_layers_container2D[F_Mask]->BuildBVH();
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
-
-    printf( "BOARD_ADAPTER::createLayers times\n" );
-    printf( "  Copper Layers:          %.3f ms\n",
-            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
-    printf( "  Holes BVH creation:     %.3f ms\n",
-            (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
-    printf( "  Tech Layers:            %.3f ms\n",
-            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
-    printf( "Statistics:\n" );
-    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
-    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
-    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
-    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
-    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
-    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
-    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
-#endif
 }
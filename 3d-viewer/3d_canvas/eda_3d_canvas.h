@@ -71,6 +71,12 @@ class EDA_3D_CANVAS : public HIDPI_GL_CANVAS
 
     void ReloadRequest( BOARD *aBoard = NULL, S3D_CACHE *aCachePointer = NULL );
 
+    /**
+     * @brief ReloadLayersRequest - Request the rebuild of only the layers changed by an edit
+     * @param aLayers: the layers of the changed items
+     */
+    void ReloadLayersRequest( const LSET& aLayers );
+
     /**
      * @brief IsReloadRequestPending - Query if there is a pending reload request
      * @return true if it wants to reload, false if there is no reload pending
@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  offscreen_3d_render.cpp
+ */
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <wx/image.h>
+
+#include "offscreen_3d_render.h"
+#include "../3d_rendering/3d_render_raytracing/c3d_render_raytracing.h"
+#include <class_board.h>
+#include <thread_pool.h>
+
+
+OFFSCREEN_3D_RENDER::OFFSCREEN_3D_RENDER( BOARD* aBoard, S3D_CACHE* aCache,
+                                          COLOR_SETTINGS* aColors ) :
+        m_camera( RANGE_SCALE_3D )
+{
+    m_adapter.SetBoard( aBoard );
+    m_adapter.Set3DCacheManager( aCache );
+
+    if( aColors )
+        m_adapter.SetColorSettings( aColors );
+
+    // The defaults of the raytracing settings of the 3D viewer
+    m_adapter.RenderEngineSet( RENDER_ENGINE::RAYTRACING );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, true );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, true );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, true );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, true );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, true );
+    m_adapter.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+
+    if( !aCache )
+    {
+        m_adapter.SetFlag( FL_MODULE_ATTRIBUTES_NORMAL, false );
+        m_adapter.SetFlag( FL_MODULE_ATTRIBUTES_NORMAL_INSERT, false );
+        m_adapter.SetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL, false );
+    }
+
+    m_raytracer = std::make_unique<C3D_RENDER_RAYTRACING>( m_adapter, m_camera );
+    m_raytracer->ReloadRequest();
+}
+
+
+OFFSCREEN_3D_RENDER::~OFFSCREEN_3D_RENDER()
+{
+}
+
+
+bool OFFSCREEN_3D_RENDER::Render( const wxSize& aSize, OFFSCREEN_3D_VIEW aView, float aZoom,
+                                  wxImage& aImage, REPORTER* aReporter )
+{
+    if( aSize.x <= 0 || aSize.y <= 0 )
+        return false;
+
+    // The same rotations as the view commands of the canvas, without their animation
+    m_camera.SetCurWindowSize( aSize );
+    m_camera.Reset();
+
+    switch( aView )
+    {
+    case OFFSCREEN_3D_VIEW::TOP:
+        break;
+
+    case OFFSCREEN_3D_VIEW::BOTTOM:
+        m_camera.RotateY( glm::radians( 179.999f ) );
+        break;
+
+    case OFFSCREEN_3D_VIEW::FRONT:
+        m_camera.RotateX( glm::radians( -90.0f ) );
+        break;
+
+    case OFFSCREEN_3D_VIEW::BACK:
+        m_camera.RotateX( glm::radians( -90.0f ) );
+        m_camera.RotateZ( glm::radians( 179.999f ) );
+        break;
+
+    case OFFSCREEN_3D_VIEW::LEFT:
+        m_camera.RotateZ( glm::radians( 90.0f ) );
+        m_camera.RotateX( glm::radians( -90.0f ) );
+        break;
+
+    case OFFSCREEN_3D_VIEW::RIGHT:
+        m_camera.RotateZ( glm::radians( -90.0f ) );
+        m_camera.RotateX( glm::radians( -90.0f ) );
+        break;
+    }
+
+    if( aZoom > 0.0f && aZoom != 1.0f )
+        m_camera.Zoom( aZoom );
+
+    return m_raytracer->RenderOffscreen( aSize, aImage, aReporter, aReporter );
+}
+
+
+int OFFSCREEN_3D_RENDER::RenderBoards( const std::vector<JOB>& aJobs, S3D_CACHE* aCache,
+                                       const wxSize& aSize, OFFSCREEN_3D_VIEW aView,
+                                       float aZoom, unsigned aParallelism,
+                                       REPORTER* aReporter )
+{
+    if( aJobs.empty() )
+        return 0;
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    // The renders read the settings when they are created, so on this thread
+    std::vector<std::unique_ptr<OFFSCREEN_3D_RENDER>> renders;
+
+    for( const JOB& job : aJobs )
+        renders.push_back( std::make_unique<OFFSCREEN_3D_RENDER>( job.m_board, aCache ) );
+
+    THREAD_POOL&        pool = GetKiCadThreadPool();
+    std::atomic<size_t> next( 0 );
+    std::atomic<int>    written( 0 );
+    std::mutex          reportLock;
+
+    if( aParallelism == 0 )
+        aParallelism = pool.GetThreadCount() + 1;
+
+    auto renderJobs =
+            [&]()
+            {
+                for( size_t i = next++; i < aJobs.size(); i = next++ )
+                {
+                    wxImage image;
+                    bool    ok = renders[i]->Render( aSize, aView, aZoom, image )
+                                 && image.SaveFile( aJobs[i].m_fileName, wxBITMAP_TYPE_PNG );
+
+                    // The layers of the board are not needed anymore
+                    renders[i].reset();
+
+                    if( ok )
+                        written++;
+
+                    if( aReporter )
+                    {
+                        std::lock_guard<std::mutex> lock( reportLock );
+
+                        if( ok )
+                            aReporter->Report( aJobs[i].m_fileName, RPT_SEVERITY_INFO );
+                        else
+                            aReporter->Report( wxString::Format( _( "Cannot write '%s'" ),
+                                                                 aJobs[i].m_fileName ),
+                                               RPT_SEVERITY_ERROR );
+                    }
+                }
+            };
+
+    pool.RunParallel( renderJobs, std::min<size_t>( aParallelism, aJobs.size() ) );
+
+    return written;
+}
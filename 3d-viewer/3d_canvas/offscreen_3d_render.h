@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  offscreen_3d_render.h
+ * @brief renders the 3D view of a board into an image, without a window
+ */
+
+#ifndef OFFSCREEN_3D_RENDER_H
+#define OFFSCREEN_3D_RENDER_H
+
+#include <memory>
+#include <vector>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+#include "board_adapter.h"
+#include "../3d_rendering/ctrack_ball.h"
+
+class BOARD;
+class COLOR_SETTINGS;
+class C3D_RENDER_RAYTRACING;
+class REPORTER;
+class S3D_CACHE;
+class wxImage;
+
+
+/// The point of view of an offscreen render, as the view commands of the 3D viewer
+enum class OFFSCREEN_3D_VIEW
+{
+    TOP,
+    BOTTOM,
+    FRONT,
+    BACK,
+    LEFT,
+    RIGHT
+};
+
+
+/**
+ * OFFSCREEN_3D_RENDER
+ * renders a board with the raytracer into a wxImage, without a window nor a gl context.
+ *
+ * Each instance has its own BOARD_ADAPTER, camera and raytracer, so that several boards can be
+ * rendered at the same time on different threads. They can share one S3D_CACHE, which then
+ * loads each model once for all of them.
+ */
+class OFFSCREEN_3D_RENDER
+{
+public:
+    /**
+     * The adapter is set up as the 3D viewer with its default settings, and its flags and
+     * colors can be changed with GetAdapter() before the first render.
+     * This reads the application settings, so it must be called from the main thread.
+     * @param aCache: the cache of the 3D models, or NULL to render the board without models
+     * @param aColors: the colors of the layers, or NULL for the current color settings
+     */
+    OFFSCREEN_3D_RENDER( BOARD* aBoard, S3D_CACHE* aCache, COLOR_SETTINGS* aColors = NULL );
+
+    ~OFFSCREEN_3D_RENDER();
+
+    BOARD_ADAPTER& GetAdapter() { return m_adapter; }
+
+    /**
+     * Renders the board seen from aView.  The board is built on the first call only.
+     * @param aZoom: the zoom of the camera, 1.0 fits the board in the image
+     * @return false if aSize is empty
+     */
+    bool Render( const wxSize& aSize, OFFSCREEN_3D_VIEW aView, float aZoom, wxImage& aImage,
+                 REPORTER* aReporter = NULL );
+
+    /// A board to render and the file to write its image to, for RenderBoards()
+    struct JOB
+    {
+        BOARD*   m_board;
+        wxString m_fileName;
+    };
+
+    /**
+     * Renders several boards at the same time on the shared thread pool, writing their images
+     * as PNG files.  All the renders share aCache.
+     * @param aParallelism: the number of boards rendered at the same time, 0 for the number
+     *                      of threads of the pool.  Each render uses several threads itself.
+     * @return the number of images written
+     */
+    static int RenderBoards( const std::vector<JOB>& aJobs, S3D_CACHE* aCache,
+                             const wxSize& aSize, OFFSCREEN_3D_VIEW aView, float aZoom,
+                             unsigned aParallelism = 0, REPORTER* aReporter = NULL );
+
+private:
+    BOARD_ADAPTER                          m_adapter;
+    CTRACK_BALL                            m_camera;
+    std::unique_ptr<C3D_RENDER_RAYTRACING> m_raytracer;
+};
+
+#endif // OFFSCREEN_3D_RENDER_H
@@ -337,7 +337,9 @@ CLAYERS_OGL_DISP_LISTS *C3D_RENDER_OGL_LEGACY::generate_holes_display_list(
 void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter )
 {
     m_reloadRequested = false;
+    m_reloadLayers.reset();
 
+    m_3dmodel_loader.Cancel();
     ogl_free_all_display_lists();
 
     COBJECT2D_STATS::Instance().ResetStats();
@@ -350,6 +352,9 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 
     m_boardAdapter.InitSettings( aStatusTextReporter, aWarningTextReporter );
 
+    // The models load while the board is built, and after it is displayed
+    load_3D_models();
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endReloadTime = GetRunningMicroSecs();
 #endif
@@ -436,6 +441,98 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Load OpenGL: holes and vias" ) );
 
+    generate_holes_display_lists();
+
+    // Add layers maps
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
+
+    for( MAP_CONTAINER_2D::const_iterator ii = m_boardAdapter.GetMapLayers().begin();
+         ii != m_boardAdapter.GetMapLayers().end();
+         ++ii )
+    {
+        generate_layer_display_list( ii->first, ii->second );
+    }
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_end_OpenGL_Load_Time = GetRunningMicroSecs();
+
+    printf( "C3D_RENDER_OGL_LEGACY::reload times:\n" );
+    printf( "  Reload board:             %.3f ms\n",
+            (float)( stats_endReloadTime        - stats_startReloadTime        ) / 1000.0f );
+    printf( "  Loading to openGL:        %.3f ms\n",
+            (float)( stats_end_OpenGL_Load_Time - stats_start_OpenGL_Load_Time ) / 1000.0f );
+    COBJECT2D_STATS::Instance().PrintStats();
+#endif
+
+    if( aStatusTextReporter )
+    {
+        // Calculation time in seconds
+        const double calculation_time = (double)( GetRunningMicroSecs() -
+                                                  stats_startReloadTime) / 1e6;
+
+        aStatusTextReporter->Report( wxString::Format( _( "Reload time %.3f s" ),
+                                                       calculation_time ) );
+    }
+}
+
+
+void C3D_RENDER_OGL_LEGACY::reloadLayers( REPORTER* aStatusTextReporter )
+{
+    const LSET layers = m_reloadLayers;
+
+    m_reloadLayers.reset();
+
+    COBJECT2D_STATS::Instance().ResetStats();
+
+    unsigned stats_startReloadTime = GetRunningMicroSecs();
+
+    if( !m_boardAdapter.UpdateLayers( layers, aStatusTextReporter ) )
+    {
+        // The board must be loaded again
+        m_reloadRequested = true;
+        return;
+    }
+
+    // The models follow their footprints, only the missing ones are loaded
+    load_3D_models();
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
+
+    // The holes are built again by the board adapter when a copper layer changes
+    if( ( layers & LSET::AllCuMask() ).any() )
+    {
+        ogl_free_holes_display_lists();
+        generate_holes_display_lists();
+    }
+
+    const MAP_CONTAINER_2D& mapLayers = m_boardAdapter.GetMapLayers();
+
+    for( LSEQ seq = layers.Seq(); seq; ++seq )
+    {
+        ogl_free_layer_display_list( *seq );
+
+        MAP_CONTAINER_2D::const_iterator ii = mapLayers.find( *seq );
+
+        if( ii != mapLayers.end() )
+            generate_layer_display_list( ii->first, ii->second );
+    }
+
+    if( aStatusTextReporter )
+    {
+        const double calculation_time = (double)( GetRunningMicroSecs() -
+                                                  stats_startReloadTime ) / 1e6;
+
+        aStatusTextReporter->Report( wxString::Format( _( "Reload time %.3f s" ),
+                                                       calculation_time ) );
+    }
+}
+
+
+void C3D_RENDER_OGL_LEGACY::generate_holes_display_lists()
+{
     m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
             m_boardAdapter.GetThroughHole_Outer().GetList(),
             m_boardAdapter.GetThroughHole_Outer_poly(),
@@ -520,137 +617,90 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 
     // Generate vertical cylinders of vias and pads (copper)
     generate_3D_Vias_and_Pads();
+}
 
-    // Add layers maps
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
-
-    for( MAP_CONTAINER_2D::const_iterator ii = m_boardAdapter.GetMapLayers().begin();
-         ii != m_boardAdapter.GetMapLayers().end();
-         ++ii )
-    {
-        PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
-
-        if( !m_boardAdapter.Is3DLayerEnabled( layer_id ) )
-            continue;
-
-        const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
-        const LIST_OBJECT2D &listObject2d = container2d->GetList();
-
-        if( listObject2d.size() == 0 )
-            continue;
-
-        float layer_z_bot = 0.0f;
-        float layer_z_top = 0.0f;
-
-        get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
-
-        // Calculate an estimation for the nr of triangles based on the nr of objects
-        unsigned int nrTrianglesEstimation = listObject2d.size() * 8;
 
-        CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
+void C3D_RENDER_OGL_LEGACY::generate_layer_display_list( PCB_LAYER_ID aLayerId,
+                                                         const CBVHCONTAINER2D *aContainer )
+{
+    if( !m_boardAdapter.Is3DLayerEnabled( aLayerId ) )
+        return;
 
-        m_triangles[layer_id] = layerTriangles;
+    const LIST_OBJECT2D &listObject2d = aContainer->GetList();
 
-        // Load the 2D (X,Y axis) component of shapes
-        for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
-             itemOnLayer != listObject2d.end();
-             ++itemOnLayer )
-        {
-            const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
-
-            switch( object2d_A->GetObjectType() )
-            {
-            case OBJECT2D_TYPE::FILLED_CIRCLE:
-                add_object_to_triangle_layer( (const CFILLEDCIRCLE2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+    if( listObject2d.size() == 0 )
+        return;
 
-            case OBJECT2D_TYPE::POLYGON4PT:
-                add_object_to_triangle_layer( (const CPOLYGON4PTS2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+    float layer_z_bot = 0.0f;
+    float layer_z_top = 0.0f;
 
-            case OBJECT2D_TYPE::RING:
-                add_object_to_triangle_layer( (const CRING2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+    get_layer_z_pos( aLayerId, layer_z_top, layer_z_bot );
 
-            case OBJECT2D_TYPE::TRIANGLE:
-                add_object_to_triangle_layer( (const CTRIANGLE2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+    // Calculate an estimation for the nr of triangles based on the nr of objects
+    unsigned int nrTrianglesEstimation = listObject2d.size() * 8;
 
-            case OBJECT2D_TYPE::ROUNDSEG:
-                add_object_to_triangle_layer( (const CROUNDSEGMENT2D *) object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+    CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
 
-            default:
-                wxFAIL_MSG("C3D_RENDER_OGL_LEGACY: Object type is not implemented");
-                break;
-            }
-        }
+    m_triangles[aLayerId] = layerTriangles;
 
-        const MAP_POLY &map_poly = m_boardAdapter.GetPolyMap();
+    // Load the 2D (X,Y axis) component of shapes
+    for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
+         itemOnLayer != listObject2d.end();
+         ++itemOnLayer )
+    {
+        const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
 
-        // Load the vertical (Z axis)  component of shapes
-        if( map_poly.find( layer_id ) != map_poly.end() )
+        switch( object2d_A->GetObjectType() )
         {
-            const SHAPE_POLY_SET *polyList = map_poly.at( layer_id );
-
-            if( polyList->OutlineCount() > 0 )
-                layerTriangles->AddToMiddleContourns( *polyList, layer_z_bot, layer_z_top,
-                                                      m_boardAdapter.BiuTo3Dunits(), false );
+        case OBJECT2D_TYPE::FILLED_CIRCLE:
+            add_object_to_triangle_layer( (const CFILLEDCIRCLE2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::POLYGON4PT:
+            add_object_to_triangle_layer( (const CPOLYGON4PTS2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::RING:
+            add_object_to_triangle_layer( (const CRING2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::TRIANGLE:
+            add_object_to_triangle_layer( (const CTRIANGLE2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::ROUNDSEG:
+            add_object_to_triangle_layer( (const CROUNDSEGMENT2D *) object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        default:
+            wxFAIL_MSG("C3D_RENDER_OGL_LEGACY: Object type is not implemented");
+            break;
         }
+    }
 
-        // Create display list
-        // /////////////////////////////////////////////////////////////////////
-        m_ogl_disp_lists_layers[layer_id] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
-                                                                        m_ogl_circle_texture,
-                                                                        layer_z_bot,
-                                                                        layer_z_top );
-    }// for each layer on map
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_end_OpenGL_Load_Time = GetRunningMicroSecs();
-#endif
-
-    // Load 3D models
-    // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_start_models_Load_Time = GetRunningMicroSecs();
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Loading 3D models" ) );
-
-    load_3D_models( aStatusTextReporter );
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_end_models_Load_Time = GetRunningMicroSecs();
-
-
-    printf( "C3D_RENDER_OGL_LEGACY::reload times:\n" );
-    printf( "  Reload board:             %.3f ms\n",
-            (float)( stats_endReloadTime        - stats_startReloadTime        ) / 1000.0f );
-    printf( "  Loading to openGL:        %.3f ms\n",
-            (float)( stats_end_OpenGL_Load_Time - stats_start_OpenGL_Load_Time ) / 1000.0f );
-    printf( "  Loading 3D models:        %.3f ms\n",
-            (float)( stats_end_models_Load_Time - stats_start_models_Load_Time ) / 1000.0f );
-    COBJECT2D_STATS::Instance().PrintStats();
-#endif
+    const MAP_POLY &map_poly = m_boardAdapter.GetPolyMap();
 
-    if( aStatusTextReporter )
+    // Load the vertical (Z axis)  component of shapes
+    if( map_poly.find( aLayerId ) != map_poly.end() )
     {
-        // Calculation time in seconds
-        const double calculation_time = (double)( GetRunningMicroSecs() -
-                                                  stats_startReloadTime) / 1e6;
+        const SHAPE_POLY_SET *polyList = map_poly.at( aLayerId );
 
-        aStatusTextReporter->Report( wxString::Format( _( "Reload time %.3f s" ),
-                                                       calculation_time ) );
+        if( polyList->OutlineCount() > 0 )
+            layerTriangles->AddToMiddleContourns( *polyList, layer_z_bot, layer_z_top,
+                                                  m_boardAdapter.BiuTo3Dunits(), false );
     }
+
+    // Create display list
+    // /////////////////////////////////////////////////////////////////////////
+    m_ogl_disp_lists_layers[aLayerId] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
+                                                                    m_ogl_circle_texture,
+                                                                    layer_z_bot,
+                                                                    layer_z_top );
 }
 
 
@@ -889,13 +939,17 @@ void C3D_RENDER_OGL_LEGACY::generate_3D_Vias_and_Pads()
 
 
 /*
- * This function will get models from the cache and load it to openGL lists
- * in the form of C_OGL_3DMODEL. So this map of models will work as a local
- * cache for this render. (cache based on C_OGL_3DMODEL with associated
- * openGL lists in GPU memory)
+ * The models are got from the cache by S3D_MODEL_LOADER on worker threads, and loaded
+ * to openGL buffers in the form of C_OGL_3DMODEL as they arrive. So this map of models
+ * will work as a local cache for this render. (cache based on C_OGL_3DMODEL with
+ * associated openGL buffers in GPU memory). The placements of each model on the board
+ * are collected here too, so that each model is drawn at all its placements at once.
  */
-void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
+void C3D_RENDER_OGL_LEGACY::load_3D_models()
 {
+    m_3dmodel_pending.clear();
+    m_3dmodel_instances.clear();
+
     if((!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_NORMAL )) &&
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_NORMAL_INSERT )) &&
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
@@ -904,49 +958,94 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
-        if( !module->Models().empty() )
+        if( module->Models().empty() )
+            continue;
+
+        const glm::mat4 moduleMatrix = get_module_matrix( module );
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
         {
-            // Get the list of model files for this model
-            auto sM = module->Models().begin();
-            auto eM = module->Models().end();
+            if( model.m_Filename.empty() )
+                continue;
 
-            while( sM != eM )
-            {
-                if( !sM->m_Filename.empty() )
-                {
-                    if( aStatusTextReporter )
-                    {
-                        // Display the short filename of the 3D model loaded:
-                        // (the full name is usually too long to be displayed)
-                        wxFileName fn( sM->m_Filename );
-                        wxString msg;
-                        msg.Printf( _( "Loading %s" ), fn.GetFullName() );
-                        aStatusTextReporter->Report( msg );
-                    }
-
-                    // Check if the model is not present in our cache map
-                    // (Not already loaded in memory)
-                    if( m_3dmodel_map.find( sM->m_Filename ) == m_3dmodel_map.end() )
-                    {
-                        // It is not present, try get it from cache
-                        const S3DMODEL *modelPtr =
-                                m_boardAdapter.Get3DCacheManager()->GetModel( sM->m_Filename );
-
-                        // only add it if the return is not NULL
-                        if( modelPtr )
-                        {
-                            C_OGL_3DMODEL* ogl_model =
-                                    new C_OGL_3DMODEL( *modelPtr,
-                                                       m_boardAdapter.MaterialModeGet() );
-
-                            if( ogl_model )
-                                m_3dmodel_map[ sM->m_Filename ] = ogl_model;
-                        }
-                    }
-                }
+            // Check if the model is not present in our cache map
+            // (Not already loaded in memory)
+            if( m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+                m_3dmodel_pending.insert( model.m_Filename );
 
-                ++sM;
-            }
+            glm::mat4 modelMatrix = moduleMatrix;
+
+            modelMatrix = glm::translate( modelMatrix,
+                                          SFVEC3F( model.m_Offset.x,
+                                                   model.m_Offset.y,
+                                                   model.m_Offset.z ) );
+
+            modelMatrix = glm::rotate( modelMatrix,
+                                       (float)-( model.m_Rotation.z / 180.0f ) *
+                                       glm::pi<float>(),
+                                       SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+
+            modelMatrix = glm::rotate( modelMatrix,
+                                       (float)-( model.m_Rotation.y / 180.0f ) *
+                                       glm::pi<float>(),
+                                       SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+
+            modelMatrix = glm::rotate( modelMatrix,
+                                       (float)-( model.m_Rotation.x / 180.0f ) *
+                                       glm::pi<float>(),
+                                       SFVEC3F( 1.0f, 0.0f, 0.0f ) );
+
+            modelMatrix = glm::scale( modelMatrix,
+                                      SFVEC3F( model.m_Scale.x,
+                                               model.m_Scale.y,
+                                               model.m_Scale.z ) );
+
+            MODEL_INSTANCE instance;
+
+            instance.m_transform  = modelMatrix;
+            instance.m_attributes = module->GetAttributes();
+            instance.m_flipped    = module->IsFlipped();
+
+            m_3dmodel_instances[ model.m_Filename ].push_back( instance );
+        }
+    }
+
+    m_3dmodel_loader.Start( m_boardAdapter.Get3DCacheManager(),
+                            std::vector< wxString >( m_3dmodel_pending.begin(),
+                                                     m_3dmodel_pending.end() ) );
+}
+
+
+bool C3D_RENDER_OGL_LEGACY::receive_3D_models( REPORTER *aStatusTextReporter )
+{
+    if( m_3dmodel_pending.empty() )
+        return false;
+
+    std::vector< S3D_MODEL_LOADER::LOADED_MODEL > models;
+    const bool loading = m_3dmodel_loader.TakeLoaded( models );
+
+    for( const S3D_MODEL_LOADER::LOADED_MODEL& model : models )
+    {
+        m_3dmodel_pending.erase( model.first );
+
+        // only add it if the return is not NULL
+        if( model.second )
+        {
+            m_3dmodel_map[ model.first ] = new C_OGL_3DMODEL( *model.second,
+                                                              m_boardAdapter.MaterialModeGet(),
+                                                              &m_3dmodel_buffers );
         }
     }
+
+    if( !loading )
+        m_3dmodel_pending.clear();
+
+    if( aStatusTextReporter && !m_3dmodel_pending.empty() )
+    {
+        aStatusTextReporter->Report( wxString::Format( _( "Loading 3D models %u/%u" ),
+                                                       (unsigned) m_3dmodel_loader.GetLoadedCount(),
+                                                       (unsigned) m_3dmodel_loader.GetCount() ) );
+    }
+
+    return !m_3dmodel_pending.empty();
 }
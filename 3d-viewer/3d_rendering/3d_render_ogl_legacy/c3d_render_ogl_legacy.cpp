@@ -44,6 +44,11 @@
   */
 #define UNITS3D_TO_UNITSPCB (IU_PER_MM)
 
+/**
+  * Height of the box drawn in place of the models of a module until they are loaded (in mm)
+  */
+#define MODEL_PLACEHOLDER_HEIGHT 1.0
+
 C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( BOARD_ADAPTER& aAdapter, CCAMERA& aCamera ) :
         C3D_RENDER_BASE( aAdapter, aCamera )
 {
@@ -76,6 +81,7 @@ C3D_RENDER_OGL_LEGACY::~C3D_RENDER_OGL_LEGACY()
 {
     wxLogTrace( m_logTrace, wxT( "C3D_RENDER_OGL_LEGACY::~C3D_RENDER_OGL_LEGACY" ) );
 
+    m_3dmodel_loader.Cancel();
     ogl_free_all_display_lists();
 
     glDeleteTextures( 1, &m_ogl_circle_texture );
@@ -531,6 +537,14 @@ bool C3D_RENDER_OGL_LEGACY::Redraw(
             return false;
     }
 
+    if( !m_reloadRequested && m_reloadLayers.any() )
+    {
+        std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
+
+        // Requests the whole reload below if the layers cannot be built alone
+        reloadLayers( aStatusTextReporter );
+    }
+
     if( m_reloadRequested )
     {
         std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -556,6 +570,9 @@ bool C3D_RENDER_OGL_LEGACY::Redraw(
         }
     }
 
+    // Redraw again until all the models arrived
+    const bool modelsPending = receive_3D_models( aStatusTextReporter );
+
     // Initial setup
     // /////////////////////////////////////////////////////////////////////////
     glDepthFunc( GL_LESS );
@@ -861,7 +878,7 @@ bool C3D_RENDER_OGL_LEGACY::Redraw(
     // /////////////////////////////////////////////////////////////////////////
     glViewport( 0, 0, m_windowSize.x, m_windowSize.y );
 
-    return false;
+    return modelsPending;
 }
 
 
@@ -949,28 +966,6 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 
     m_ogl_disp_lists_layers.clear();
 
-
-    for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers_holes_outer.begin();
-         ii != m_ogl_disp_lists_layers_holes_outer.end();
-         ++ii )
-    {
-        CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
-        delete pLayerDispList;
-    }
-
-    m_ogl_disp_lists_layers_holes_outer.clear();
-
-
-    for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers_holes_inner.begin();
-         ii != m_ogl_disp_lists_layers_holes_inner.end();
-         ++ii )
-    {
-        CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
-        delete pLayerDispList;
-    }
-
-    m_ogl_disp_lists_layers_holes_inner.clear();
-
     for( MAP_TRIANGLES::const_iterator ii = m_triangles.begin();
          ii != m_triangles.end();
          ++ii )
@@ -991,11 +986,39 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
     }
 
     m_3dmodel_map.clear();
+    m_3dmodel_buffers.clear();
 
 
     delete m_ogl_disp_list_board;
     m_ogl_disp_list_board = 0;
 
+    ogl_free_holes_display_lists();
+}
+
+
+void C3D_RENDER_OGL_LEGACY::ogl_free_holes_display_lists()
+{
+    for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers_holes_outer.begin();
+         ii != m_ogl_disp_lists_layers_holes_outer.end();
+         ++ii )
+    {
+        CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
+        delete pLayerDispList;
+    }
+
+    m_ogl_disp_lists_layers_holes_outer.clear();
+
+
+    for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers_holes_inner.begin();
+         ii != m_ogl_disp_lists_layers_holes_inner.end();
+         ++ii )
+    {
+        CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
+        delete pLayerDispList;
+    }
+
+    m_ogl_disp_lists_layers_holes_inner.clear();
+
     delete m_ogl_disp_list_through_holes_outer_with_npth;
     m_ogl_disp_list_through_holes_outer_with_npth = 0;
 
@@ -1019,6 +1042,26 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 }
 
 
+void C3D_RENDER_OGL_LEGACY::ogl_free_layer_display_list( PCB_LAYER_ID aLayerId )
+{
+    MAP_OGL_DISP_LISTS::iterator dispList = m_ogl_disp_lists_layers.find( aLayerId );
+
+    if( dispList != m_ogl_disp_lists_layers.end() )
+    {
+        delete dispList->second;
+        m_ogl_disp_lists_layers.erase( dispList );
+    }
+
+    MAP_TRIANGLES::iterator triangles = m_triangles.find( aLayerId );
+
+    if( triangles != m_triangles.end() )
+    {
+        delete triangles->second;
+        m_triangles.erase( triangles );
+    }
+}
+
+
 void C3D_RENDER_OGL_LEGACY::render_solder_mask_layer( PCB_LAYER_ID aLayerID,
                                                       float aZPosition,
                                                       bool aIsRenderingOnPreviewMode )
@@ -1079,111 +1122,156 @@ void C3D_RENDER_OGL_LEGACY::render_solder_mask_layer( PCB_LAYER_ID aLayerID,
 void C3D_RENDER_OGL_LEGACY::render_3D_models( bool aRenderTopOrBot,
                                               bool aRenderTransparentOnly )
 {
-    // Go for all modules
-    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    // Draw the bounding boxes of the modules which wait for their models
+    if( !aRenderTransparentOnly && !m_3dmodel_pending.empty() )
     {
-        if( !module->Models().empty() )
-            if( m_boardAdapter.ShouldModuleBeDisplayed((MODULE_ATTR_T) module->GetAttributes() ) )
-                if( ( aRenderTopOrBot && !module->IsFlipped() )
-                        || ( !aRenderTopOrBot && module->IsFlipped() ) )
-                    render_3D_module( module, aRenderTransparentOnly );
+        for( auto module : m_boardAdapter.GetBoard()->Modules() )
+        {
+            if( !module->Models().empty()
+                    && m_boardAdapter.ShouldModuleBeDisplayed(
+                            (MODULE_ATTR_T) module->GetAttributes() )
+                    && ( aRenderTopOrBot != module->IsFlipped() ) )
+            {
+                render_3D_module_placeholder(
+                        module, m_boardAdapter.GetModulesZcoord3DIU( module->IsFlipped() ) );
+            }
+        }
     }
-}
 
+    std::vector< glm::mat4 > instances;
 
-void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
-                                              bool aRenderTransparentOnly )
-{
-    if( !module->Models().empty() )
+    // Each model is drawn at all its placements with the same buffers and materials
+    for( const auto& modelInstances : m_3dmodel_instances )
     {
-        const double zpos = m_boardAdapter.GetModulesZcoord3DIU( module->IsFlipped() );
+        MAP_3DMODEL::const_iterator ii = m_3dmodel_map.find( modelInstances.first );
 
-        glPushMatrix();
+        if( ii == m_3dmodel_map.end() || !ii->second )
+            continue;
 
-        wxPoint pos = module->GetPosition();
+        const C_OGL_3DMODEL *modelPtr = ii->second;
 
-        glTranslatef( pos.x * m_boardAdapter.BiuTo3Dunits(),
-                      -pos.y * m_boardAdapter.BiuTo3Dunits(),
-                       zpos );
+        if( ( !aRenderTransparentOnly && !modelPtr->Have_opaque() ) ||
+            ( aRenderTransparentOnly && !modelPtr->Have_transparent() ) )
+            continue;
 
-        if( module->GetOrientation() )
-            glRotated( (double) module->GetOrientation() / 10.0, 0.0, 0.0, 1.0 );
+        instances.clear();
 
-        if( module->IsFlipped() )
+        for( const MODEL_INSTANCE& instance : modelInstances.second )
         {
-            glRotatef( 180.0f, 0.0f, 1.0f, 0.0f );
-            glRotatef( 180.0f, 0.0f, 0.0f, 1.0f );
+            if( ( aRenderTopOrBot != instance.m_flipped )
+                    && m_boardAdapter.ShouldModuleBeDisplayed(
+                            (MODULE_ATTR_T) instance.m_attributes ) )
+                instances.push_back( instance.m_transform );
         }
 
-        double modelunit_to_3d_units_factor = m_boardAdapter.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
-
-        glScaled( modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor );
+        if( instances.empty() )
+            continue;
 
-        // Get the list of model files for this model
-        auto sM = module->Models().begin();
-        auto eM = module->Models().end();
+        if( aRenderTransparentOnly )
+            modelPtr->Draw_transparent( instances );
+        else
+            modelPtr->Draw_opaque( instances );
 
-        while( sM != eM )
+        if( m_boardAdapter.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
         {
-            if( !sM->m_Filename.empty() )
+            for( const glm::mat4& transform : instances )
             {
-                // Check if the model is present in our cache map
-                if( m_3dmodel_map.find( sM->m_Filename ) != m_3dmodel_map.end() )
-                {
-                    // It is not present, try get it from cache
-                    const C_OGL_3DMODEL *modelPtr = m_3dmodel_map[ sM->m_Filename ];
+                glPushMatrix();
+                glMultMatrixf( glm::value_ptr( transform ) );
 
-                    if( modelPtr )
-                    {
-                        if( ( (!aRenderTransparentOnly) && modelPtr->Have_opaque() ) ||
-                            ( aRenderTransparentOnly && modelPtr->Have_transparent() ) )
-                        {
-                            glPushMatrix();
+                glEnable( GL_BLEND );
+                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-                            glTranslatef( sM->m_Offset.x, sM->m_Offset.y, sM->m_Offset.z );
+                glLineWidth( 1 );
+                modelPtr->Draw_bboxes();
 
-                            glRotatef( -sM->m_Rotation.z, 0.0f, 0.0f, 1.0f );
-                            glRotatef( -sM->m_Rotation.y, 0.0f, 1.0f, 0.0f );
-                            glRotatef( -sM->m_Rotation.x, 1.0f, 0.0f, 0.0f );
+                glDisable( GL_LIGHTING );
 
-                            glScalef( sM->m_Scale.x, sM->m_Scale.y, sM->m_Scale.z );
+                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
 
-                            if( aRenderTransparentOnly )
-                                modelPtr->Draw_transparent();
-                            else
-                                modelPtr->Draw_opaque();
+                glLineWidth( 4 );
+                modelPtr->Draw_bbox();
 
-                            if( m_boardAdapter.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
-                            {
-                                glEnable( GL_BLEND );
-                                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+                glEnable( GL_LIGHTING );
 
-                                glLineWidth( 1 );
-                                modelPtr->Draw_bboxes();
+                glPopMatrix();
+            }
+        }
+    }
+}
 
-                                glDisable( GL_LIGHTING );
 
-                                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
+glm::mat4 C3D_RENDER_OGL_LEGACY::get_module_matrix( const MODULE* aModule ) const
+{
+    const double zpos = m_boardAdapter.GetModulesZcoord3DIU( aModule->IsFlipped() );
 
-                                glLineWidth( 4 );
-                                modelPtr->Draw_bbox();
+    const wxPoint pos = aModule->GetPosition();
 
-                                glEnable( GL_LIGHTING );
-                            }
+    glm::mat4 moduleMatrix = glm::mat4( 1.0f );
 
-                            glPopMatrix();
-                        }
-                    }
-                }
-            }
+    moduleMatrix = glm::translate( moduleMatrix,
+                                   SFVEC3F( pos.x * m_boardAdapter.BiuTo3Dunits(),
+                                            -pos.y * m_boardAdapter.BiuTo3Dunits(),
+                                            zpos ) );
 
-            ++sM;
-        }
+    if( aModule->GetOrientation() )
+    {
+        moduleMatrix = glm::rotate( moduleMatrix,
+                                    ( (float)(aModule->GetOrientation() / 10.0f) / 180.0f ) *
+                                    glm::pi<float>(),
+                                    SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+    }
 
-        glPopMatrix();
+    if( aModule->IsFlipped() )
+    {
+        moduleMatrix = glm::rotate( moduleMatrix,
+                                    glm::pi<float>(),
+                                    SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+
+        moduleMatrix = glm::rotate( moduleMatrix,
+                                    glm::pi<float>(),
+                                    SFVEC3F( 0.0f, 0.0f, 1.0f ) );
     }
+
+    const double modelunit_to_3d_units_factor = m_boardAdapter.BiuTo3Dunits() *
+                                                UNITS3D_TO_UNITSPCB;
+
+    return glm::scale( moduleMatrix,
+                       SFVEC3F( modelunit_to_3d_units_factor,
+                                modelunit_to_3d_units_factor,
+                                modelunit_to_3d_units_factor ) );
+}
+
+
+void C3D_RENDER_OGL_LEGACY::render_3D_module_placeholder( const MODULE* module, float aZpos )
+{
+    bool pending = false;
+
+    for( const MODULE_3D_SETTINGS& model : module->Models() )
+        pending = pending || m_3dmodel_pending.count( model.m_Filename );
+
+    if( !pending )
+        return;
+
+    const EDA_RECT rect = module->GetFootprintRect();
+    const float    biuTo3D = m_boardAdapter.BiuTo3Dunits();
+    float          height = Millimeter2iu( MODEL_PLACEHOLDER_HEIGHT ) * biuTo3D;
+
+    if( module->IsFlipped() )
+        height = -height;
+
+    const CBBOX bbox( SFVEC3F( rect.GetLeft() * biuTo3D, -rect.GetBottom() * biuTo3D, aZpos ),
+                      SFVEC3F( rect.GetRight() * biuTo3D, -rect.GetTop() * biuTo3D,
+                               aZpos + height ) );
+
+    glDisable( GL_LIGHTING );
+
+    glColor4f( 0.5f, 0.5f, 0.5f, 1.0f );
+
+    glLineWidth( 1 );
+    OGL_draw_bbox( bbox );
+
+    glEnable( GL_LIGHTING );
 }
 
 
@@ -43,8 +43,11 @@
 #include "c_ogl_3dmodel.h"
 
 #include "3d_cache/3d_info.h"
+#include "3d_cache/3d_model_loader.h"
 
 #include <map>
+#include <set>
+#include <vector>
 
 
 typedef std::map< PCB_LAYER_ID, CLAYERS_OGL_DISP_LISTS* > MAP_OGL_DISP_LISTS;
@@ -74,9 +77,17 @@ private:
     bool initializeOpenGL();
     void reload( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter );
 
+    /**
+     * @brief reloadLayers - builds again the layers of m_reloadLayers, or requests the
+     * reload of the whole board if they cannot be built alone
+     */
+    void reloadLayers( REPORTER* aStatusTextReporter );
+
     void ogl_set_arrow_material();
 
     void ogl_free_all_display_lists();
+    void ogl_free_holes_display_lists();
+    void ogl_free_layer_display_list( PCB_LAYER_ID aLayerId );
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers;
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers_holes_outer;
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers_holes_inner;
@@ -106,6 +117,21 @@ private:
     CLAYERS_OGL_DISP_LISTS* m_ogl_disp_list_pads_holes;
 
     MAP_3DMODEL m_3dmodel_map;
+    C_OGL_3DMODEL::BUFFER_POOL m_3dmodel_buffers;   ///< buffers of the models with equal geometry
+
+    S3D_MODEL_LOADER     m_3dmodel_loader;      ///< loads the models while the board is shown
+    std::set< wxString > m_3dmodel_pending;     ///< the models not received yet
+
+    /// A placement of a 3D model on the board
+    struct MODEL_INSTANCE
+    {
+        glm::mat4 m_transform;      ///< from the model coordinates to the 3D units
+        int       m_attributes;     ///< attributes of the module
+        bool      m_flipped;        ///< the module is on the bottom side
+    };
+
+    /// The placements of each 3D model, so each model is bound once per redraw
+    std::map< wxString, std::vector< MODEL_INSTANCE > > m_3dmodel_instances;
 
 private:
     CLAYERS_OGL_DISP_LISTS *generate_holes_display_list( const LIST_OBJECT2D &aListHolesObject2d,
@@ -172,7 +198,23 @@ private:
 
     void generate_3D_Vias_and_Pads();
 
-    void load_3D_models( REPORTER *aStatusTextReporter );
+    /// Creates the lists of the through holes, of the holes of each layer and of the vias
+    void generate_holes_display_lists();
+
+    void generate_layer_display_list( PCB_LAYER_ID aLayerId, const CBVHCONTAINER2D *aContainer );
+
+    /**
+     * @brief load_3D_models - starts loading the 3D models of the board on worker threads,
+     * they are displayed by the next redraws as they arrive
+     */
+    void load_3D_models();
+
+    /**
+     * @brief receive_3D_models - creates the openGL lists of the models loaded since the
+     * last redraw
+     * @return true while some models are still being loaded
+     */
+    bool receive_3D_models( REPORTER *aStatusTextReporter );
 
     /**
      * @brief render_3D_models
@@ -182,7 +224,11 @@ private:
      */
     void render_3D_models( bool aRenderTopOrBot, bool aRenderTransparentOnly );
 
-    void render_3D_module( const MODULE* module, bool aRenderTransparentOnly );
+    /// @return the matrix from the model units to the 3D units of the models of aModule
+    glm::mat4 get_module_matrix( const MODULE* aModule ) const;
+
+    /// Draws the bounding box of a module which has some 3D models not loaded yet
+    void render_3D_module_placeholder( const MODULE* module, float aZpos );
 
     void setLight_Front( bool enabled );
     void setLight_Top( bool enabled );
@@ -27,19 +27,81 @@
  * @brief
  */
 
+#include <GL/glew.h>
+
 #include "c_ogl_3dmodel.h"
 #include "ogl_legacy_utils.h"
 #include "../common_ogl/ogl_utils.h"
 #include "../3d_math.h"
 #include <wx/debug.h>
+#include <cstring>
+
+
+struct C_OGL_3DMODEL::BUFFERS
+{
+    BUFFERS( GLuint aVertexBuffer, GLuint aIndexBuffer, size_t aVertexBytes,
+             size_t aIndexBytes ) :
+            m_vertex_buffer( aVertexBuffer ),
+            m_index_buffer( aIndexBuffer ),
+            m_vertex_bytes( aVertexBytes ),
+            m_index_bytes( aIndexBytes )
+    {
+    }
+
+    ~BUFFERS()
+    {
+        glDeleteBuffersARB( 1, &m_vertex_buffer );
+        glDeleteBuffersARB( 1, &m_index_buffer );
+    }
+
+    GLuint  m_vertex_buffer;
+    GLuint  m_index_buffer;
+    size_t  m_vertex_bytes;
+    size_t  m_index_bytes;
+};
+
+
+/// 64 bit hash of the bytes of an array, mixing 8 bytes at a time
+static uint64_t hashBytes( uint64_t aSeed, const void *aData, size_t aBytes )
+{
+    const unsigned char *p = static_cast< const unsigned char * >( aData );
+    uint64_t h = aSeed ^ aBytes;
+
+    for( ; aBytes >= 8; aBytes -= 8, p += 8 )
+    {
+        uint64_t k;
+        memcpy( &k, p, 8 );
+        h = ( h ^ ( k * 0x9e3779b97f4a7c15ULL ) ) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+
+    for( ; aBytes > 0; --aBytes, ++p )
+        h = ( h ^ *p ) * 0x100000001b3ULL;
+
+    return h ^ ( h >> 29 );
+}
+
+
+/// @return true if the content of the bound buffer aTarget is the aBytes of aData
+static bool bufferEquals( GLenum aTarget, const void *aData, size_t aBytes )
+{
+    std::vector< char > content( aBytes );
+
+    glGetBufferSubDataARB( aTarget, 0, aBytes, content.data() );
+
+    return memcmp( content.data(), aData, aBytes ) == 0;
+}
 
 
 C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
-                              MATERIAL_MODE aMaterialMode )
+                              MATERIAL_MODE aMaterialMode,
+                              BUFFER_POOL *aBufferPool )
 {
-    m_ogl_idx_list_meshes = 0;
-    m_ogl_idx_list_opaque = 0;
-    m_ogl_idx_list_transparent = 0;
+    m_material_mode = aMaterialMode;
+    m_vertex_buffer = 0;
+    m_index_buffer = 0;
+    m_have_opaque = false;
+    m_have_transparent = false;
     m_nr_meshes = 0;
     m_meshs_bbox = NULL;
 
@@ -56,302 +118,327 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
 
         m_meshs_bbox = new CBBOX[a3DModel.m_MeshesSize];
 
-        // Generate m_MeshesSize auxiliar lists to render the meshes
-        m_ogl_idx_list_meshes = glGenLists( a3DModel.m_MeshesSize );
-
-        // Render each mesh of the model
+        // Merge all the meshes of the model in the same vertex and index arrays
         // /////////////////////////////////////////////////////////////////////
         for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
         {
-            if( glIsList( m_ogl_idx_list_meshes + mesh_i ) )
-            {
-                const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+            const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
 
-                // Validate the mesh pointers
-                wxASSERT( mesh.m_Positions != NULL );
-                wxASSERT( mesh.m_FaceIdx != NULL );
-                wxASSERT( mesh.m_Normals != NULL );
+            // Validate the mesh pointers
+            wxASSERT( mesh.m_Positions != NULL );
+            wxASSERT( mesh.m_FaceIdx != NULL );
+            wxASSERT( mesh.m_Normals != NULL );
+
+            if( (mesh.m_Positions != NULL) &&
+                (mesh.m_Normals != NULL) &&
+                (mesh.m_FaceIdx != NULL) &&
+                (mesh.m_FaceIdxSize > 0) && (mesh.m_VertexSize > 0) )
+            {
+                // Create the bbox for this mesh
+                // /////////////////////////////////////////////////////////////
+                m_meshs_bbox[mesh_i].Reset();
 
-                if( (mesh.m_Positions != NULL) &&
-                    (mesh.m_Normals != NULL) &&
-                    (mesh.m_FaceIdx != NULL) &&
-                    (mesh.m_FaceIdxSize > 0) && (mesh.m_VertexSize > 0) )
+                for( unsigned int vertex_i = 0;
+                     vertex_i < mesh.m_VertexSize;
+                     ++vertex_i )
                 {
-                    SFVEC4F *pColorRGBA = NULL;
+                    m_meshs_bbox[mesh_i].Union( mesh.m_Positions[vertex_i] );
+                }
 
-                    // Create the bbox for this mesh
-                    // /////////////////////////////////////////////////////////
-                    m_meshs_bbox[mesh_i].Reset();
+                // The meshes without a valid material are not rendered
+                if( mesh.m_MaterialIdx >= a3DModel.m_MaterialsSize )
+                    continue;
 
-                    for( unsigned int vertex_i = 0;
-                         vertex_i < mesh.m_VertexSize;
-                         ++vertex_i )
-                    {
-                        m_meshs_bbox[mesh_i].Union( mesh.m_Positions[vertex_i] );
-                    }
+                MESH oglMesh;
 
-                    // Make sure we start with client state disabled
-                    // /////////////////////////////////////////////////////////
-                    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-                    glDisableClientState( GL_COLOR_ARRAY );
+                oglMesh.m_material      = a3DModel.m_Materials[mesh.m_MaterialIdx];
+                oglMesh.m_firstIndex    = m_indexes.size();
+                oglMesh.m_nrIndexes     = mesh.m_FaceIdxSize;
+                oglMesh.m_hasColors     = mesh.m_Color != NULL;
+                oglMesh.m_isTransparent = oglMesh.m_material.m_Transparency != 0.0f;
 
+                if( oglMesh.m_isTransparent )
+                    m_have_transparent = true;
+                else
+                    m_have_opaque = true;
 
-                    // Enable arrays client states
-                    // /////////////////////////////////////////////////////////
-                    glEnableClientState( GL_VERTEX_ARRAY );
-                    glEnableClientState( GL_NORMAL_ARRAY );
+                // Convert the colors for the material mode
+                // /////////////////////////////////////////////////////////////
+                const float transparency = oglMesh.m_material.m_Transparency;
+                const GLuint firstVertex = m_vertices.size();
 
-                    glVertexPointer( 3, GL_FLOAT, 0, mesh.m_Positions );
-                    glNormalPointer( GL_FLOAT, 0, mesh.m_Normals );
+                for( unsigned int i = 0; i < mesh.m_VertexSize; ++i )
+                {
+                    VERTEX vertex;
+
+                    vertex.m_pos    = mesh.m_Positions[i];
+                    vertex.m_normal = mesh.m_Normals[i];
+                    vertex.m_color  = SFVEC4F( 1.0f );
 
                     if( mesh.m_Color != NULL )
                     {
-                        glEnableClientState( GL_COLOR_ARRAY );
-
-                        float transparency = 0.0f;
-
-                        if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                            transparency = a3DModel.m_Materials[mesh.m_MaterialIdx].m_Transparency;
-
                         if( ( transparency > FLT_EPSILON )
-                                && ( aMaterialMode == MATERIAL_MODE::NORMAL ) )
+                                && ( m_material_mode == MATERIAL_MODE::NORMAL ) )
                         {
-                            // Create a new array of RGBA colors
-                            pColorRGBA = new SFVEC4F[mesh.m_VertexSize];
-
-                            // Copy RGB array and add the Alpha value
-                            for( unsigned int i = 0; i < mesh.m_VertexSize; ++i )
-                                pColorRGBA[i] = SFVEC4F( mesh.m_Color[i],
-                                                         1.0f - transparency );
-
-                            // Load an RGBA array
-                            glColorPointer( 4, GL_FLOAT, 0, pColorRGBA );
+                            vertex.m_color = SFVEC4F( mesh.m_Color[i], 1.0f - transparency );
+                        }
+                        else if( m_material_mode == MATERIAL_MODE::CAD_MODE )
+                        {
+                            vertex.m_color =
+                                    SFVEC4F( MaterialDiffuseToColorCAD( mesh.m_Color[i] ), 1.0f );
                         }
                         else
                         {
-                            switch( aMaterialMode )
-                            {
-                            case MATERIAL_MODE::NORMAL:
-                            case MATERIAL_MODE::DIFFUSE_ONLY:
-                                // load the original RGB color array
-                                glColorPointer( 3, GL_FLOAT, 0, mesh.m_Color );
-                                break;
-                            case MATERIAL_MODE::CAD_MODE:
-                                // Create a new array of RGBA colors
-                                pColorRGBA = new SFVEC4F[mesh.m_VertexSize];
-
-                                // Copy RGB array and add the Alpha value
-                                for( unsigned int i = 0; i < mesh.m_VertexSize; ++i )
-                                {
-                                    pColorRGBA[i] =
-                                            SFVEC4F( MaterialDiffuseToColorCAD( mesh.m_Color[i] ),
-                                                     1.0f );
-                                }
-
-                                // Load an RGBA array
-                                glColorPointer( 4, GL_FLOAT, 0, pColorRGBA );
-                                break;
-                            default:
-                                break;
-                            }
+                            vertex.m_color = SFVEC4F( mesh.m_Color[i], 1.0f );
                         }
                     }
 
-                    if( mesh.m_Texcoords != NULL )
-                    {
-                        glEnableClientState( GL_TEXTURE_COORD_ARRAY );
-                        glTexCoordPointer( 2, GL_FLOAT, 0, mesh.m_Texcoords );
-                    }
+                    m_vertices.push_back( vertex );
+                }
 
-                    // Compile the display list to store triangles
-                    // /////////////////////////////////////////////////////////
-                    glNewList( m_ogl_idx_list_meshes + mesh_i, GL_COMPILE );
+                for( unsigned int i = 0; i < mesh.m_FaceIdxSize; ++i )
+                    m_indexes.push_back( firstVertex + mesh.m_FaceIdx[i] );
 
-                    // Set material properties
-                    // /////////////////////////////////////////////////////////
+                m_meshes.push_back( oglMesh );
+            }
+        }// for each mesh
 
-                    if( mesh.m_Color != NULL )
-                    {
-                        // This enables the use of the Color Pointer information
-                        glEnable( GL_COLOR_MATERIAL );
-                        glColorMaterial( GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE );
-                    }
-                    else
-                    {
-                        glDisable( GL_COLOR_MATERIAL );
-                    }
+        // Upload the arrays, or reuse the buffers of a model with the same content.
+        // Without buffer objects, they are drawn from the client memory.
+        // /////////////////////////////////////////////////////////////////////
+        if( !m_meshes.empty() && GLEW_ARB_vertex_buffer_object )
+        {
+            uint64_t hash = hashBytes( 0xcbf29ce484222325ULL, m_vertices.data(),
+                                       m_vertices.size() * sizeof( VERTEX ) );
+            hash = hashBytes( hash, m_indexes.data(), m_indexes.size() * sizeof( GLuint ) );
 
-                    if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                    {
-                        switch( aMaterialMode )
-                        {
-                        case MATERIAL_MODE::NORMAL:
-                            OGL_SetMaterial( a3DModel.m_Materials[mesh.m_MaterialIdx] );
-                            break;
-                        case MATERIAL_MODE::DIFFUSE_ONLY:
-                            OGL_SetDiffuseOnlyMaterial(
-                                        a3DModel.m_Materials[mesh.m_MaterialIdx].m_Diffuse );
-                            break;
-                        case MATERIAL_MODE::CAD_MODE:
-                            OGL_SetDiffuseOnlyMaterial(
-                                        MaterialDiffuseToColorCAD(
-                                            a3DModel.m_Materials[mesh.m_MaterialIdx].m_Diffuse ) );
-                            break;
-                        default:
-                            break;
-                        }
-                    }
+            if( aBufferPool )
+                m_buffers = findBuffers( *aBufferPool, hash );
 
-                    // Draw mesh
-                    // /////////////////////////////////////////////////////////
-                    glDrawElements( GL_TRIANGLES, mesh.m_FaceIdxSize,
-                                    GL_UNSIGNED_INT, mesh.m_FaceIdx );
+            if( !m_buffers )
+            {
+                m_buffers = createBuffers();
 
-                    glDisable( GL_COLOR_MATERIAL );
+                if( m_buffers && aBufferPool )
+                    aBufferPool->emplace( hash, m_buffers );
+            }
 
-                    glEndList();
+            if( m_buffers )
+            {
+                m_vertex_buffer = m_buffers->m_vertex_buffer;
+                m_index_buffer = m_buffers->m_index_buffer;
 
-                    // Disable arrays client states
-                    // /////////////////////////////////////////////////////////
-                    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-                    glDisableClientState( GL_COLOR_ARRAY );
-                    glDisableClientState( GL_NORMAL_ARRAY );
-                    glDisableClientState( GL_VERTEX_ARRAY );
+                std::vector< VERTEX >().swap( m_vertices );
+                std::vector< GLuint >().swap( m_indexes );
+            }
+        }
+
+        // Create the main bbox
+        // /////////////////////////////////////////////////////////////////////
+        m_model_bbox.Reset();
 
-                    glFlush();
+        for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
+            m_model_bbox.Union( m_meshs_bbox[mesh_i] );
+    }
+}
 
-                    delete [] pColorRGBA;
-                }
-            }
-        }// for each mesh
 
+void C_OGL_3DMODEL::draw( bool aTransparent,
+                          const glm::mat4 *aInstances,
+                          size_t aNrInstances ) const
+{
+    if( !( aTransparent ? m_have_transparent : m_have_opaque ) )
+        return;
 
-        m_ogl_idx_list_opaque = glGenLists( 1 );
+    // Without buffer objects, the offsets are relative to the client memory
+    const char *vertices = NULL;
+    const char *indexes = NULL;
 
-        // Check if the generated list is valid
-        if( glIsList( m_ogl_idx_list_opaque ) )
+    if( m_vertex_buffer )
+    {
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, m_vertex_buffer );
+        glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, m_index_buffer );
+    }
+    else
+    {
+        vertices = (const char *)m_vertices.data();
+        indexes = (const char *)m_indexes.data();
+    }
+
+    // The pointers are set once for all the meshes and instances
+    // /////////////////////////////////////////////////////////////////////////
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+
+    glVertexPointer( 3, GL_FLOAT, sizeof( VERTEX ), vertices );
+    glNormalPointer( GL_FLOAT, sizeof( VERTEX ), vertices + sizeof( SFVEC3F ) );
+    glColorPointer( 4, GL_FLOAT, sizeof( VERTEX ), vertices + 2 * sizeof( SFVEC3F ) );
+
+    if( aTransparent )
+    {
+        glEnable( GL_BLEND );
+        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    }
+
+    for( const MESH &mesh : m_meshes )
+    {
+        if( mesh.m_isTransparent != aTransparent )
+            continue;
+
+        if( mesh.m_hasColors )
+        {
+            // This enables the use of the Color Pointer information
+            glEnableClientState( GL_COLOR_ARRAY );
+            glEnable( GL_COLOR_MATERIAL );
+            glColorMaterial( GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE );
+        }
+        else
         {
-            bool have_opaque_meshes = false;
-            bool have_transparent_meshes = false;
+            glDisableClientState( GL_COLOR_ARRAY );
+            glDisable( GL_COLOR_MATERIAL );
+        }
+
+        setMaterial( mesh );
 
-            // Compile the model display list
-            glNewList( m_ogl_idx_list_opaque, GL_COMPILE );
+        const char *meshIndexes = indexes + mesh.m_firstIndex * sizeof( GLuint );
 
-            // Render each mesh display list (opaque first)
-            // /////////////////////////////////////////////////////////////////
-            for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
+        if( aInstances == NULL )
+        {
+            glDrawElements( GL_TRIANGLES, mesh.m_nrIndexes, GL_UNSIGNED_INT, meshIndexes );
+        }
+        else
+        {
+            for( size_t i = 0; i < aNrInstances; ++i )
             {
-                const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+                glPushMatrix();
+                glMultMatrixf( glm::value_ptr( aInstances[i] ) );
 
-                if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                {
-                    const SMATERIAL &material = a3DModel.m_Materials[mesh.m_MaterialIdx];
+                glDrawElements( GL_TRIANGLES, mesh.m_nrIndexes, GL_UNSIGNED_INT, meshIndexes );
 
-                    if( material.m_Transparency == 0.0f )
-                    {
-                        have_opaque_meshes = true; // Flag that we have at least one opaque mesh
-                        glCallList( m_ogl_idx_list_meshes + mesh_i );
-                    }
-                    else
-                    {
-                        have_transparent_meshes = true; // Flag that we found a transparent mesh
-                    }
-                }
+                glPopMatrix();
             }
+        }
 
-            glEndList();
+        glDisable( GL_COLOR_MATERIAL );
+    }
 
-            if( !have_opaque_meshes )
-            {
-                // If we dont have opaque meshes, we can free the list
-                glDeleteLists( m_ogl_idx_list_opaque, 1 );
-                m_ogl_idx_list_opaque = 0;
-            }
+    if( aTransparent )
+        glDisable( GL_BLEND );
 
-            if( have_transparent_meshes )
-            {
-                m_ogl_idx_list_transparent = glGenLists( 1 );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
 
-                // Check if the generated list is valid
-                if( glIsList( m_ogl_idx_list_transparent ) )
-                {
-                    // Compile the model display list
-                    glNewList( m_ogl_idx_list_transparent, GL_COMPILE );
+    if( m_vertex_buffer )
+    {
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+        glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
+    }
+}
 
-                    glEnable( GL_BLEND );
-                    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-                    // Render each mesh display list
-                    // /////////////////////////////////////////////////////////
-                    for( unsigned mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
-                    {
-                        const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+void C_OGL_3DMODEL::setMaterial( const MESH &aMesh ) const
+{
+    switch( m_material_mode )
+    {
+    case MATERIAL_MODE::NORMAL:
+        OGL_SetMaterial( aMesh.m_material );
+        break;
+    case MATERIAL_MODE::DIFFUSE_ONLY:
+        OGL_SetDiffuseOnlyMaterial( aMesh.m_material.m_Diffuse );
+        break;
+    case MATERIAL_MODE::CAD_MODE:
+        OGL_SetDiffuseOnlyMaterial( MaterialDiffuseToColorCAD( aMesh.m_material.m_Diffuse ) );
+        break;
+    default:
+        break;
+    }
+}
 
-                        if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                        {
-                            const SMATERIAL &material = a3DModel.m_Materials[mesh.m_MaterialIdx];
 
-                            // Render the transparent mesh if it have a transparency value
-                            if( material.m_Transparency != 0.0f )
-                                glCallList( m_ogl_idx_list_meshes + mesh_i );
-                        }
-                    }
+std::shared_ptr< C_OGL_3DMODEL::BUFFERS > C_OGL_3DMODEL::findBuffers( BUFFER_POOL &aPool,
+                                                                      uint64_t aHash ) const
+{
+    const size_t vertexBytes = m_vertices.size() * sizeof( VERTEX );
+    const size_t indexBytes = m_indexes.size() * sizeof( GLuint );
+    std::shared_ptr< BUFFERS > found;
 
-                    glDisable( GL_BLEND );
+    auto range = aPool.equal_range( aHash );
 
-                    glEndList();
-                }
-                else
-                {
-                    m_ogl_idx_list_transparent = 0;
-                }
-            }
-        }
-        else
+    for( auto it = range.first; it != range.second && !found; )
+    {
+        std::shared_ptr< BUFFERS > buffers = it->second.lock();
+
+        // The buffers of the freed models are dropped on the way
+        if( !buffers )
         {
-            m_ogl_idx_list_opaque = 0;
+            it = aPool.erase( it );
+            continue;
         }
 
-        // Create the main bbox
-        // /////////////////////////////////////////////////////////////////////
-        m_model_bbox.Reset();
+        ++it;
 
-        for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
-            m_model_bbox.Union( m_meshs_bbox[mesh_i] );
+        if( buffers->m_vertex_bytes != vertexBytes || buffers->m_index_bytes != indexBytes )
+            continue;
 
-        glFlush();
+        // The hash only selects the candidates, their content is compared on the GPU side
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, buffers->m_vertex_buffer );
+        glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, buffers->m_index_buffer );
+
+        if( bufferEquals( GL_ARRAY_BUFFER_ARB, m_vertices.data(), vertexBytes )
+                && bufferEquals( GL_ELEMENT_ARRAY_BUFFER_ARB, m_indexes.data(), indexBytes ) )
+        {
+            found = buffers;
+        }
+
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+        glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
     }
+
+    return found;
 }
 
 
-void C_OGL_3DMODEL::Draw_opaque() const
+std::shared_ptr< C_OGL_3DMODEL::BUFFERS > C_OGL_3DMODEL::createBuffers() const
 {
-    if( glIsList( m_ogl_idx_list_opaque ) )
-        glCallList( m_ogl_idx_list_opaque );
-}
+    const size_t vertexBytes = m_vertices.size() * sizeof( VERTEX );
+    const size_t indexBytes = m_indexes.size() * sizeof( GLuint );
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
 
+    glGenBuffersARB( 1, &vertexBuffer );
+    glGenBuffersARB( 1, &indexBuffer );
 
-void C_OGL_3DMODEL::Draw_transparent() const
-{
-    if( glIsList( m_ogl_idx_list_transparent ) )
-        glCallList( m_ogl_idx_list_transparent );
+    if( !vertexBuffer || !indexBuffer )
+    {
+        glDeleteBuffersARB( 1, &vertexBuffer );
+        glDeleteBuffersARB( 1, &indexBuffer );
+
+        return std::shared_ptr< BUFFERS >();
+    }
+
+    glBindBufferARB( GL_ARRAY_BUFFER_ARB, vertexBuffer );
+    glBufferDataARB( GL_ARRAY_BUFFER_ARB, vertexBytes, m_vertices.data(), GL_STATIC_DRAW_ARB );
+    glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+
+    glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, indexBuffer );
+    glBufferDataARB( GL_ELEMENT_ARRAY_BUFFER_ARB, indexBytes, m_indexes.data(),
+                     GL_STATIC_DRAW_ARB );
+    glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
+
+    return std::make_shared< BUFFERS >( vertexBuffer, indexBuffer, vertexBytes, indexBytes );
 }
 
 
 C_OGL_3DMODEL::~C_OGL_3DMODEL()
 {
-    if( glIsList( m_ogl_idx_list_opaque ) )
-        glDeleteLists( m_ogl_idx_list_opaque, 1 );
-
-    if( glIsList( m_ogl_idx_list_transparent ) )
-        glDeleteLists( m_ogl_idx_list_transparent, 1 );
-
-    if( glIsList( m_ogl_idx_list_meshes ) )
-        glDeleteLists( m_ogl_idx_list_meshes, m_nr_meshes );
+    // The buffer objects are deleted with their last model
+    m_buffers.reset();
 
-    m_ogl_idx_list_meshes = 0;
-    m_ogl_idx_list_opaque = 0;
-    m_ogl_idx_list_transparent = 0;
+    m_vertex_buffer = 0;
+    m_index_buffer = 0;
 
     delete[] m_meshs_bbox;
     m_meshs_bbox = NULL;
@@ -373,11 +460,11 @@ void C_OGL_3DMODEL::Draw_bboxes() const
 
 bool C_OGL_3DMODEL::Have_opaque() const
 {
-    return glIsList( m_ogl_idx_list_opaque );
+    return m_have_opaque;
 }
 
 
 bool C_OGL_3DMODEL::Have_transparent() const
 {
-    return glIsList( m_ogl_idx_list_transparent );
+    return m_have_transparent;
 }
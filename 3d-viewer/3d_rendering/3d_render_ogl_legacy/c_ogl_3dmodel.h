@@ -34,29 +34,66 @@
 #include "../../common_ogl/openGL_includes.h"
 #include "../3d_render_raytracing/shapes3D/cbbox.h"
 #include "../../3d_enums.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
 
-/// 
+/// A 3D model stored in one vertex buffer and one index buffer of the GPU
 class  C_OGL_3DMODEL
 {
 public:
+    /// The buffer objects of a model, shared by the models with the same vertices and indexes
+    struct BUFFERS;
+
+    /// The buffers of the models of a gl context, keyed by a hash of their content
+    typedef std::multimap< uint64_t, std::weak_ptr< BUFFERS > > BUFFER_POOL;
+
     /**
      * @brief C_OGL_3DMODEL - Load a 3d model. This must be called inside a gl context
      * @param a3DModel: a 3d model data to load.
      * @param aMaterialMode: a mode to render the materials of the model
+     * @param aBufferPool: the buffers of the models already loaded in this gl context, to
+     *                     reuse the ones with the same content instead of uploading them
+     *                     again, or NULL
      */
-    C_OGL_3DMODEL( const S3DMODEL &a3DModel, MATERIAL_MODE aMaterialMode );
+    C_OGL_3DMODEL( const S3DMODEL &a3DModel, MATERIAL_MODE aMaterialMode,
+                   BUFFER_POOL *aBufferPool = NULL );
 
     ~C_OGL_3DMODEL();
 
     /**
      * @brief Draw_opaque - render the model into the current context
      */
-    void Draw_opaque() const;
+    void Draw_opaque() const { draw( false, NULL, 0 ); }
 
     /**
      * @brief Draw_transparent - render the model into the current context
      */
-    void Draw_transparent() const;
+    void Draw_transparent() const { draw( true, NULL, 0 ); }
+
+    /**
+     * @brief Draw_opaque - render one instance of the model for each of aInstances.
+     * The buffers and the material of each mesh are set only once for all instances.
+     * @param aInstances: the matrices of the instances, multiplied with the current
+     *                    modelview matrix
+     */
+    void Draw_opaque( const std::vector< glm::mat4 > &aInstances ) const
+    {
+        if( !aInstances.empty() )
+            draw( false, aInstances.data(), aInstances.size() );
+    }
+
+    /**
+     * @brief Draw_transparent - render one instance of the model for each of aInstances
+     * @param aInstances: the matrices of the instances, multiplied with the current
+     *                    modelview matrix
+     */
+    void Draw_transparent( const std::vector< glm::mat4 > &aInstances ) const
+    {
+        if( !aInstances.empty() )
+            draw( true, aInstances.data(), aInstances.size() );
+    }
 
     /**
      * @brief Have_opaque - return true if have opaque meshs to render
@@ -85,9 +122,53 @@ public:
     const CBBOX &GetBBox() const { return m_model_bbox; }
 
 private:
-    GLuint  m_ogl_idx_list_opaque;      ///< display list for rendering opaque meshes
-    GLuint  m_ogl_idx_list_transparent; ///< display list for rendering transparent meshes
-    GLuint  m_ogl_idx_list_meshes;      ///< display lists for all meshes.
+    /// A vertex of the buffer of the model
+    struct VERTEX
+    {
+        SFVEC3F m_pos;
+        SFVEC3F m_normal;
+        SFVEC4F m_color;    ///< RGBA color for the material mode, if the mesh has colors
+    };
+
+    /// The range of the index buffer of a mesh, with its material
+    struct MESH
+    {
+        SMATERIAL   m_material;
+        size_t      m_firstIndex;
+        GLsizei     m_nrIndexes;
+        bool        m_hasColors;
+        bool        m_isTransparent;
+    };
+
+    /**
+     * @brief draw - render the opaque or the transparent meshes
+     * @param aInstances: model matrices of the instances or NULL to render the model once
+     *                    with the current modelview matrix.
+     * @param aNrInstances: number of matrices of aInstances
+     */
+    void draw( bool aTransparent, const glm::mat4 *aInstances, size_t aNrInstances ) const;
+
+    void setMaterial( const MESH &aMesh ) const;
+
+    /// @return the buffers of aPool with the content of m_vertices and m_indexes, or NULL
+    std::shared_ptr< BUFFERS > findBuffers( BUFFER_POOL &aPool, uint64_t aHash ) const;
+
+    /// @return new buffers with the content of m_vertices and m_indexes, or NULL
+    std::shared_ptr< BUFFERS > createBuffers() const;
+
+    MATERIAL_MODE m_material_mode;
+
+    std::vector< MESH > m_meshes;       ///< meshes to render, in the order of the model
+
+    std::shared_ptr< BUFFERS > m_buffers;   ///< the buffer objects, NULL if not supported
+    GLuint  m_vertex_buffer;            ///< vertex buffer object, 0 if not supported
+    GLuint  m_index_buffer;             ///< index buffer object, 0 if not supported
+    std::vector< VERTEX > m_vertices;   ///< vertices, when there is no vertex buffer
+    std::vector< GLuint > m_indexes;    ///< indexes, when there is no index buffer
+
+    bool    m_have_opaque;
+    bool    m_have_transparent;
+
     unsigned int m_nr_meshes;           ///< number of meshes of this model
 
     CBBOX   m_model_bbox;               ///< global bounding box for this model
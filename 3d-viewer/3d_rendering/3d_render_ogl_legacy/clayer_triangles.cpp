@@ -28,6 +28,8 @@
  */
 
 
+#include <GL/glew.h>
+
 #include "clayer_triangles.h"
 #include <wx/debug.h>   // For the wxASSERT
 #include <mutex>
@@ -329,11 +331,14 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
     m_zBot = aZBot;
     m_zTop = aZTop;
 
-    m_layer_top_segment_ends        = 0;
-    m_layer_top_triangles           = 0;
-    m_layer_middle_contourns_quads  = 0;
-    m_layer_bot_triangles           = 0;
-    m_layer_bot_segment_ends        = 0;
+    m_vertexBuffer      = 0;
+    m_textureSegEnds    = 0;
+
+    for( unsigned int i = 0; i < RANGE_COUNT; ++i )
+    {
+        m_firstVertex[i] = 0;
+        m_vertexCount[i] = 0;
+    }
 
     if( aTextureIndexForSegEnds )
     {
@@ -341,29 +346,40 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
 
         if( glIsTexture( aTextureIndexForSegEnds ) )
         {
-            m_layer_top_segment_ends =
-                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_top_segment_ends,
-                                                  true,
-                                                  aTextureIndexForSegEnds );
-
-            m_layer_bot_segment_ends =
-                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_bot_segment_ends,
-                                                  false,
-                                                  aTextureIndexForSegEnds );
+            m_textureSegEnds = aTextureIndexForSegEnds;
+
+            add_top_or_bot_seg_ends( aLayerTriangles.m_layer_top_segment_ends,
+                                     true,
+                                     TOP_SEGMENT_ENDS );
+
+            add_top_or_bot_seg_ends( aLayerTriangles.m_layer_bot_segment_ends,
+                                     false,
+                                     BOT_SEGMENT_ENDS );
         }
     }
 
-    m_layer_top_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_top_triangles,
-                                                           true );
-
-    m_layer_bot_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_bot_triangles,
-                                                           false );
+    add_top_or_bot_triangles( aLayerTriangles.m_layer_top_triangles, true, TOP_TRIANGLES );
 
+    add_top_or_bot_triangles( aLayerTriangles.m_layer_bot_triangles, false, BOT_TRIANGLES );
 
     if( aLayerTriangles.m_layer_middle_contourns_quads->GetVertexSize() > 0 )
+        add_middle_triangles( aLayerTriangles.m_layer_middle_contourns_quads );
+
+    // Upload all the parts of the layer in a single buffer. Without vertex buffer objects
+    // the vertices are kept here and drawn from the client memory.
+    if( !m_vertices.empty() && GLEW_ARB_vertex_buffer_object )
     {
-        m_layer_middle_contourns_quads =
-                generate_middle_triangles( aLayerTriangles.m_layer_middle_contourns_quads );
+        glGenBuffersARB( 1, &m_vertexBuffer );
+
+        if( m_vertexBuffer )
+        {
+            glBindBufferARB( GL_ARRAY_BUFFER_ARB, m_vertexBuffer );
+            glBufferDataARB( GL_ARRAY_BUFFER_ARB, m_vertices.size() * sizeof( VERTEX ),
+                             m_vertices.data(), GL_STATIC_DRAW_ARB );
+            glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+
+            std::vector< VERTEX >().swap( m_vertices );
+        }
     }
 
     m_draw_it_transparent = false;
@@ -375,26 +391,10 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
 
 CLAYERS_OGL_DISP_LISTS::~CLAYERS_OGL_DISP_LISTS()
 {
-    if( glIsList( m_layer_top_segment_ends ) )
-        glDeleteLists( m_layer_top_segment_ends, 1 );
+    if( m_vertexBuffer )
+        glDeleteBuffersARB( 1, &m_vertexBuffer );
 
-    if( glIsList( m_layer_top_triangles ) )
-        glDeleteLists( m_layer_top_triangles, 1 );
-
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glDeleteLists( m_layer_middle_contourns_quads, 1 );
-
-    if( glIsList( m_layer_bot_triangles ) )
-        glDeleteLists( m_layer_bot_triangles, 1 );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glDeleteLists( m_layer_bot_segment_ends, 1 );
-
-    m_layer_top_segment_ends        = 0;
-    m_layer_top_triangles           = 0;
-    m_layer_middle_contourns_quads  = 0;
-    m_layer_bot_triangles           = 0;
-    m_layer_bot_segment_ends        = 0;
+    m_vertexBuffer = 0;
 }
 
 
@@ -402,14 +402,8 @@ void CLAYERS_OGL_DISP_LISTS::DrawTopAndMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw( rangeBit( MIDDLE_CONTOURNS ) | rangeBit( TOP_TRIANGLES ) |
+          rangeBit( TOP_SEGMENT_ENDS ) );
 
     endTransformation();
 }
@@ -419,14 +413,8 @@ void CLAYERS_OGL_DISP_LISTS::DrawBotAndMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw( rangeBit( MIDDLE_CONTOURNS ) | rangeBit( BOT_TRIANGLES ) |
+          rangeBit( BOT_SEGMENT_ENDS ) );
 
     endTransformation();
 }
@@ -436,11 +424,7 @@ void CLAYERS_OGL_DISP_LISTS::DrawTop() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw( rangeBit( TOP_TRIANGLES ) | rangeBit( TOP_SEGMENT_ENDS ) );
 
     endTransformation();
 }
@@ -450,11 +434,7 @@ void CLAYERS_OGL_DISP_LISTS::DrawBot() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw( rangeBit( BOT_TRIANGLES ) | rangeBit( BOT_SEGMENT_ENDS ) );
 
     endTransformation();
 }
@@ -464,8 +444,7 @@ void CLAYERS_OGL_DISP_LISTS::DrawMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
+    draw( rangeBit( MIDDLE_CONTOURNS ) );
 
     endTransformation();
 }
@@ -475,21 +454,9 @@ void CLAYERS_OGL_DISP_LISTS::DrawAll( bool aDrawMiddle ) const
 {
     beginTransformation();
 
-    if( aDrawMiddle )
-        if( glIsList( m_layer_middle_contourns_quads ) )
-            glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw( ( aDrawMiddle ? rangeBit( MIDDLE_CONTOURNS ) : 0 ) |
+          rangeBit( TOP_TRIANGLES ) | rangeBit( BOT_TRIANGLES ) |
+          rangeBit( TOP_SEGMENT_ENDS ) | rangeBit( BOT_SEGMENT_ENDS ) );
 
     endTransformation();
 }
@@ -636,10 +603,10 @@ void CLAYERS_OGL_DISP_LISTS::SetItIsTransparent( bool aSetTransparent )
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_seg_ends(
+void CLAYERS_OGL_DISP_LISTS::add_top_or_bot_seg_ends(
         const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer,
         bool aIsNormalUp,
-        GLuint aTextureId ) const
+        RANGE aRange )
 {
     wxASSERT( aTriangleContainer != NULL );
 
@@ -651,66 +618,27 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_seg_ends(
     if( (aTriangleContainer->GetVertexSize() > 0) &&
         ((aTriangleContainer->GetVertexSize() % 3) == 0) )
     {
-        GLuint listIdx = glGenLists( 1 );
-
-        if( glIsList( listIdx ) )
-        {
-            // Prepare an array of UV text coordinates
-            SFVEC2F *uvArray = new SFVEC2F[aTriangleContainer->GetVertexSize()];
-
-            for( unsigned int i = 0;
-                 i < aTriangleContainer->GetVertexSize();
-                 i += 3 )
-            {
-                uvArray[i + 0] = SFVEC2F( 1.0f, 0.0f );
-                uvArray[i + 1] = SFVEC2F( 0.0f, 1.0f );
-                uvArray[i + 2] = SFVEC2F( 0.0f, 0.0f );
-            }
-
-            glEnableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-            glTexCoordPointer( 2, GL_FLOAT, 0, uvArray );
-
-            glNewList( listIdx, GL_COMPILE );
-
-            glDisable( GL_COLOR_MATERIAL );
-
-            glEnable( GL_TEXTURE_2D );
-            glBindTexture( GL_TEXTURE_2D, aTextureId );
-
-            setBlendfunction();
-
-            glAlphaFunc( GL_GREATER, 0.2f );
-            glEnable( GL_ALPHA_TEST );
-
-            glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
-
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
-
-            glDisable( GL_TEXTURE_2D );
-            glDisable( GL_ALPHA_TEST );
-            glDisable( GL_BLEND );
+        const SFVEC3F *vertexs = (const SFVEC3F *)aTriangleContainer->GetVertexPointer();
+        const SFVEC3F normal( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
 
-            glEndList();
+        // The UV text coordinates of the texture of the segment ends
+        const SFVEC2F uv[3] = { SFVEC2F( 1.0f, 0.0f ),
+                                SFVEC2F( 0.0f, 1.0f ),
+                                SFVEC2F( 0.0f, 0.0f ) };
 
-            glDisableClientState( GL_VERTEX_ARRAY );
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+        m_firstVertex[aRange] = m_vertices.size();
+        m_vertexCount[aRange] = aTriangleContainer->GetVertexSize();
 
-            delete [] uvArray;
-            return listIdx;
-        }
+        for( unsigned int i = 0; i < aTriangleContainer->GetVertexSize(); ++i )
+            m_vertices.push_back( { vertexs[i], normal, uv[i % 3] } );
     }
-
-    return 0;
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_triangles(
+void CLAYERS_OGL_DISP_LISTS::add_top_or_bot_triangles(
         const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer,
-        bool aIsNormalUp ) const
+        bool aIsNormalUp,
+        RANGE aRange )
 {
     wxASSERT( aTriangleContainer != NULL );
 
@@ -722,39 +650,20 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_triangles(
     if( (aTriangleContainer->GetVertexSize() > 0) &&
         ( (aTriangleContainer->GetVertexSize() % 3) == 0) )
     {
-        const GLuint listIdx = glGenLists( 1 );
-
-        if( glIsList( listIdx ) )
-        {
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-
-            glNewList( listIdx, GL_COMPILE );
-
-            setBlendfunction();
-
-            glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
+        const SFVEC3F *vertexs = (const SFVEC3F *)aTriangleContainer->GetVertexPointer();
+        const SFVEC3F normal( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
 
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
+        m_firstVertex[aRange] = m_vertices.size();
+        m_vertexCount[aRange] = aTriangleContainer->GetVertexSize();
 
-            glDisable( GL_BLEND );
-            glEndList();
-
-            glDisableClientState( GL_VERTEX_ARRAY );
-
-            return listIdx;
-        }
+        for( unsigned int i = 0; i < aTriangleContainer->GetVertexSize(); ++i )
+            m_vertices.push_back( { vertexs[i], normal, SFVEC2F( 0.0f ) } );
     }
-
-    return 0;
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_middle_triangles(
-        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer ) const
+void CLAYERS_OGL_DISP_LISTS::add_middle_triangles(
+        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer )
 {
     wxASSERT( aTriangleContainer != NULL );
 
@@ -773,34 +682,86 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_middle_triangles(
         ( (aTriangleContainer->GetVertexSize() % 6) == 0 ) &&
         ( aTriangleContainer->GetNormalsSize() == aTriangleContainer->GetVertexSize() ) )
     {
-        const GLuint listIdx = glGenLists( 1 );
+        const SFVEC3F *vertexs = (const SFVEC3F *)aTriangleContainer->GetVertexPointer();
+        const SFVEC3F *normals = (const SFVEC3F *)aTriangleContainer->GetNormalsPointer();
+
+        m_firstVertex[MIDDLE_CONTOURNS] = m_vertices.size();
+        m_vertexCount[MIDDLE_CONTOURNS] = aTriangleContainer->GetVertexSize();
+
+        for( unsigned int i = 0; i < aTriangleContainer->GetVertexSize(); ++i )
+            m_vertices.push_back( { vertexs[i], normals[i], SFVEC2F( 0.0f ) } );
+    }
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw( unsigned int aRanges ) const
+{
+    for( unsigned int i = 0; i < RANGE_COUNT; ++i )
+    {
+        if( !m_vertexCount[i] )
+            aRanges &= ~rangeBit( i );
+    }
+
+    if( !aRanges )
+        return;
+
+    // Without a vertex buffer object, the offsets are relative to the client memory
+    const char *base = NULL;
+
+    if( m_vertexBuffer )
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, m_vertexBuffer );
+    else
+        base = (const char *)m_vertices.data();
+
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( VERTEX ), base );
+    glNormalPointer( GL_FLOAT, sizeof( VERTEX ), base + sizeof( SFVEC3F ) );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof( VERTEX ), base + 2 * sizeof( SFVEC3F ) );
+
+    // The order of RANGE is the order of drawing, so the segment ends come last
+    for( unsigned int i = 0; i < RANGE_COUNT; ++i )
+    {
+        if( !( aRanges & rangeBit( i ) ) )
+            continue;
+
+        const bool isSegEnds = ( i == TOP_SEGMENT_ENDS ) || ( i == BOT_SEGMENT_ENDS );
 
-        if( glIsList( listIdx ) )
+        if( isSegEnds )
         {
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glEnableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-            glNormalPointer( GL_FLOAT, 0, aTriangleContainer->GetNormalsPointer() );
+            glEnableClientState( GL_TEXTURE_COORD_ARRAY );
 
-            glNewList( listIdx, GL_COMPILE );
+            glDisable( GL_COLOR_MATERIAL );
 
-            setBlendfunction();
+            glEnable( GL_TEXTURE_2D );
+            glBindTexture( GL_TEXTURE_2D, m_textureSegEnds );
+
+            glAlphaFunc( GL_GREATER, 0.2f );
+            glEnable( GL_ALPHA_TEST );
+        }
 
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
+        setBlendfunction();
 
-            glDisable( GL_BLEND );
-            glEndList();
+        glDrawArrays( GL_TRIANGLES, m_firstVertex[i], m_vertexCount[i] );
 
-            glDisableClientState( GL_VERTEX_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
+        glDisable( GL_BLEND );
 
-            return listIdx;
+        if( isSegEnds )
+        {
+            glDisable( GL_TEXTURE_2D );
+            glDisable( GL_ALPHA_TEST );
+
+            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
         }
     }
 
-    return 0;
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+
+    if( m_vertexBuffer )
+        glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 }
 
 
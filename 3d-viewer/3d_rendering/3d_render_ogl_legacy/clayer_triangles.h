@@ -186,16 +186,17 @@ public:
 
 
 /**
- * @brief The CLAYERS_OGL_DISP_LISTS class stores the openGL display lists to
- * related with a layer
+ * @brief The CLAYERS_OGL_DISP_LISTS class stores the openGL vertices of a layer.
+ * All the parts of the layer are merged in a single vertex buffer object, and each
+ * part is drawn with one glDrawArrays of its range of the buffer.
  */
 class CLAYERS_OGL_DISP_LISTS
 {
 public:
     /**
-     * @brief CLAYERS_OGL_DISP_LISTS - Creates the display lists for a layer
+     * @brief CLAYERS_OGL_DISP_LISTS - Creates the vertex buffer for a layer
      * @param aLayerTriangles: contains the layers array of vertex to render to
-     *                         display lists
+     *                         the vertex buffer
      * @param aTextureIndexForSegEnds: texture index to be used by segment ends.
      *                                 It is a black and white squared texture
      *                                 with a center circle diameter of the size
@@ -207,41 +208,41 @@ public:
                             float aZTop );
 
     /**
-     * @brief ~CLAYERS_OGL_DISP_LISTS - Destroy this class while free the display
-     * lists from GPU mem
+     * @brief ~CLAYERS_OGL_DISP_LISTS - Destroy this class while free the vertex
+     * buffer from GPU mem
      */
     ~CLAYERS_OGL_DISP_LISTS();
 
     /**
-     * @brief DrawTopAndMiddle - This function calls the display lists for the
+     * @brief DrawTopAndMiddle - This function draws the parts of the layer for the
      * top elements and middle contourns
      */
     void DrawTopAndMiddle() const;
 
     /**
-     * @brief DrawBotAndMiddle - This function calls the display lists for the
+     * @brief DrawBotAndMiddle - This function draws the parts of the layer for the
      * botton elements and middle contourns
      */
     void DrawBotAndMiddle() const;
 
     /**
-     * @brief DrawTop - This function calls the display lists for the top elements
+     * @brief DrawTop - This function draws the parts of the layer for the top elements
      */
     void DrawTop() const;
 
     /**
-     * @brief DrawBot - This function calls the display lists for the botton elements
+     * @brief DrawBot - This function draws the parts of the layer for the botton elements
      */
     void DrawBot() const;
 
     /**
-     * @brief DrawMiddle - This function calls the display lists for the middle
+     * @brief DrawMiddle - This function draws the parts of the layer for the middle
      * elements
      */
     void DrawMiddle() const;
 
     /**
-     * @brief DrawAll - This function calls all the display lists
+     * @brief DrawAll - This function draws all the parts of the layer
      */
     void DrawAll( bool aDrawMiddle = true ) const;
 
@@ -267,14 +268,43 @@ public:
     float GetZTop() const { return m_zTop; }
 
 private:
-    GLuint generate_top_or_bot_seg_ends( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
-                                         bool aIsNormalUp,
-                                         GLuint aTextureId ) const;
+    /// The parts of a layer, in their order of drawing
+    enum RANGE
+    {
+        MIDDLE_CONTOURNS = 0,
+        TOP_TRIANGLES,
+        BOT_TRIANGLES,
+        TOP_SEGMENT_ENDS,
+        BOT_SEGMENT_ENDS,
+        RANGE_COUNT
+    };
+
+    /// A vertex of the buffer of the layer
+    struct VERTEX
+    {
+        SFVEC3F m_pos;
+        SFVEC3F m_normal;
+        SFVEC2F m_uv;       ///< texture coordinates, only used by segment ends
+    };
+
+    static unsigned int rangeBit( unsigned int aRange ) { return 1u << aRange; }
+
+    void add_top_or_bot_seg_ends( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
+                                  bool aIsNormalUp,
+                                  RANGE aRange );
+
+    void add_top_or_bot_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
+                                   bool aIsNormalUp,
+                                   RANGE aRange );
+
+    void add_middle_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer );
 
-    GLuint generate_top_or_bot_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
-                                          bool aIsNormalUp ) const;
-
-    GLuint generate_middle_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer ) const;
+    /**
+     * @brief draw - draws the parts of the layer with one call per part, from the
+     * single vertex buffer of the layer
+     * @param aRanges: mask of the rangeBit() of the parts to draw
+     */
+    void draw( unsigned int aRanges ) const;
 
     void beginTransformation() const;
     void endTransformation() const;
@@ -284,11 +314,12 @@ private:
 private:
     float   m_zBot;
     float   m_zTop;
-    GLuint  m_layer_top_segment_ends;
-    GLuint  m_layer_top_triangles;
-    GLuint  m_layer_middle_contourns_quads;
-    GLuint  m_layer_bot_triangles;
-    GLuint  m_layer_bot_segment_ends;
+
+    GLuint  m_vertexBuffer;                 ///< vertex buffer object, 0 if not supported
+    std::vector< VERTEX > m_vertices;       ///< vertices, when there is no vertex buffer
+    GLint   m_firstVertex[RANGE_COUNT];
+    GLsizei m_vertexCount[RANGE_COUNT];     ///< number of vertices of each part, 0 if none
+    GLuint  m_textureSegEnds;
 
     bool    m_haveTransformation;
     float   m_zPositionTransformation;
@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_simd.h"
 #include <wx/debug.h>
 
 
@@ -46,47 +47,34 @@ struct StackNode
 
 
 static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
+                                        const RAYPACKET_SOA &aPacket,
                                         const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
+                                        unsigned int ia )
 {
     float hitT;
 
     if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
+        if( hitT < aPacket.m_tHit[ia] )
             return ia;
 
     if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
         return RAYPACKET_RAYS_PER_PACKET;
 
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
+    const uint64_t hits = RAYPACKET_IntersectBBox( aPacket, aBBox, ia + 1 );
 
-    return RAYPACKET_RAYS_PER_PACKET;
+    return hits ? RAYPACKET_FirstRay( hits ) : RAYPACKET_RAYS_PER_PACKET;
 }
 
 
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
+static inline unsigned int getLastHit( const RAYPACKET_SOA &aPacket,
                                        const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
+                                       unsigned int ia )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+    const uint64_t hits = RAYPACKET_IntersectBBox( aPacket, aBBox, ia + 1 );
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
-
-    return ia + 1;
+    return hits ? RAYPACKET_LastRay( hits ) + 1 : ia + 1;
 }
 
 
@@ -107,13 +95,15 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    RAYPACKET_SOA packet( aRayPacket, aHitInfoPacket );
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        ia = getFirstHit( aRayPacket, packet, curCell->bounds, ia );
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -127,10 +117,7 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = getLastHit( packet, curCell->bounds, ia );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
@@ -138,15 +125,19 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
                     if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
+                        const uint64_t hits = obj->IntersectPacket( packet, ia, ie,
+                                                                    aHitInfoPacket );
+
+                        if( hits )
                         {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                            anyHitted = true;
+                            packet.UpdateHits( hits, aHitInfoPacket );
 
-                            if( hitted )
+                            for( uint64_t todoHits = hits; todoHits; todoHits &= todoHits - 1 )
                             {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
+                                const unsigned int i = RAYPACKET_FirstRay( todoHits );
+
+                                aHitInfoPacket[i].m_hitresult = true;
                                 aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
                             }
                         }
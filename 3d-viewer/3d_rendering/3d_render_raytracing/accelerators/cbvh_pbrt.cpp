@@ -33,6 +33,7 @@
  *  - Code style to match KiCad
  *  - Asserts converted
  *  - Use compare functions/structures for std::partition and std::nth_element
+ *  - Build the subtrees, the Morton codes and the LBVH treelets on several threads
  *
  * The original source code has the following licence:
  *
@@ -70,7 +71,9 @@
 #include "../../../3d_fastmath.h"
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
+#include <array>
 #include <cstdlib>
+#include <thread>
 #include <vector>
 
 #include <stack>
@@ -173,6 +176,57 @@ inline uint32_t EncodeMorton3( const SFVEC3F &v )
 }
 
 
+// Minimum number of items processed by each thread of the parallel parts of the build
+static const size_t PARALLEL_BUILD_MIN_ITEMS = 16384;
+
+
+/**
+ * @return the number of chunks to split aSize items into, one per thread, each chunk having
+ * at least aMinChunk items
+ */
+static size_t ParallelChunkCount( size_t aSize, size_t aMinChunk = PARALLEL_BUILD_MIN_ITEMS )
+{
+    size_t threads = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    return std::max<size_t>( 1, std::min( threads, aSize / aMinChunk ) );
+}
+
+
+/**
+ * @return the number of levels of a binary tree build which can run their two subtrees
+ * on two threads, to use all the hardware threads
+ */
+static int ParallelBuildLevels()
+{
+    int levels = 0;
+
+    for( unsigned int n = std::thread::hardware_concurrency(); n > 1; n >>= 1 )
+        levels++;
+
+    return levels;
+}
+
+
+/**
+ * Calls aFunc( chunk, begin, end ) for each of the aChunks chunks of the range [0, aSize),
+ * on one thread per chunk, and waits for all of them
+ */
+template <typename FUNC>
+static void ParallelChunks( size_t aSize, size_t aChunks, FUNC aFunc )
+{
+    std::vector<std::thread> threads;
+
+    for( size_t chunk = 1; chunk < aChunks; ++chunk )
+        threads.emplace_back( aFunc, chunk, aSize * chunk / aChunks,
+                              aSize * ( chunk + 1 ) / aChunks );
+
+    aFunc( 0, 0, aSize / aChunks );
+
+    for( std::thread& t : threads )
+        t.join();
+}
+
+
 static void RadixSort( std::vector<MortonPrimitive> *v )
 {
     std::vector<MortonPrimitive> tempVector( v->size() );
@@ -183,6 +237,14 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
     wxASSERT( (nBits % bitsPerPass) == 0 );
 
     const int nPasses = nBits / bitsPerPass;
+    const int nBuckets = 1 << bitsPerPass;
+    const int bitMask = (1 << bitsPerPass) - 1;
+
+    // Each chunk of the input is counted and scattered by its own thread. The items of a
+    // bucket are stored chunk after chunk, so the sort stays stable.
+    const size_t nChunks = ParallelChunkCount( v->size() );
+
+    std::vector<std::array<int, nBuckets>> chunkStart( nChunks );
 
     for( int pass = 0; pass < nPasses; ++pass )
     {
@@ -193,35 +255,51 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
         std::vector<MortonPrimitive> &in  = (pass & 1) ? tempVector : *v;
         std::vector<MortonPrimitive> &out = (pass & 1) ? *v : tempVector;
 
-        // Count number of zero bits in array for current radix sort bit
-        const int nBuckets = 1 << bitsPerPass;
-        int bucketCount[nBuckets] = {0};
-        const int bitMask = (1 << bitsPerPass) - 1;
+        // Count number of items of each bucket in each chunk for current radix sort bits
+        ParallelChunks( in.size(), nChunks,
+                        [&]( size_t aChunk, size_t aBegin, size_t aEnd )
+                        {
+                            std::array<int, nBuckets>& bucketCount = chunkStart[aChunk];
 
-        for( uint32_t i = 0; i < in.size(); ++i )
-        {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
+                            bucketCount.fill( 0 );
 
-            wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
+                            for( size_t i = aBegin; i < aEnd; ++i )
+                            {
+                                int bucket = (in[i].mortonCode >> lowBit) & bitMask;
 
-            ++bucketCount[bucket];
-        }
+                                wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
 
-        // Compute starting index in output array for each bucket
-        int startIndex[nBuckets];
-        startIndex[0] = 0;
+                                ++bucketCount[bucket];
+                            }
+                        } );
 
-        for( int i = 1; i < nBuckets; ++i )
-            startIndex[i] = startIndex[i - 1] + bucketCount[i - 1];
+        // Compute starting index in output array for each bucket of each chunk
+        int startIndex = 0;
 
-        // Store sorted values in output array
-        for( uint32_t i = 0; i < in.size(); ++i )
+        for( int bucket = 0; bucket < nBuckets; ++bucket )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-            out[startIndex[bucket]++] = mp;
+            for( size_t chunk = 0; chunk < nChunks; ++chunk )
+            {
+                const int count = chunkStart[chunk][bucket];
+
+                chunkStart[chunk][bucket] = startIndex;
+                startIndex += count;
+            }
         }
+
+        // Store sorted values in output array
+        ParallelChunks( in.size(), nChunks,
+                        [&]( size_t aChunk, size_t aBegin, size_t aEnd )
+                        {
+                            std::array<int, nBuckets>& start = chunkStart[aChunk];
+
+                            for( size_t i = aBegin; i < aEnd; ++i )
+                            {
+                                const MortonPrimitive &mp = in[i];
+                                int bucket = (mp.mortonCode >> lowBit) & bitMask;
+                                out[start[bucket]++] = mp;
+                            }
+                        } );
     }
 
     // Copy final result from _tempVector_, if needed
@@ -267,19 +345,22 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     }
 
     // Build BVH tree for primitives using _primitiveInfo_
-    int totalNodes = 0;
+    std::atomic<int> nodeCount( 0 );
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    // The primitives of each subtree are stored in the range of their _primitiveInfo_,
+    // which lets the subtrees be built in any order
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
-        root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+        root = HLBVHBuild( primitiveInfo, &nodeCount, orderedPrims);
     else
         root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+                               &nodeCount, orderedPrims, m_addresses_pointer_to_mm_free,
+                               ParallelBuildLevels() );
+
+    const int totalNodes = nodeCount;
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -453,8 +534,10 @@ struct BucketInfo
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          std::atomic<int> *totalNodes,
+                                          CONST_VECTOR_OBJECT &orderedPrims,
+                                          std::list<void *> &allocations,
+                                          int threadLevels )
 {
     wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
@@ -468,7 +551,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
     // !TODO: implement an memory Arena
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    allocations.push_back( node );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -489,13 +572,13 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        int firstPrimOffset = start;
 
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -518,7 +601,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+            const int firstPrimOffset = start;
 
             for( int i = start; i < end; ++i )
             {
@@ -531,7 +614,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                 wxASSERT( obj != NULL );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
             node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -686,7 +769,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                        const int firstPrimOffset = start;
 
                         for( int i = start; i < end; ++i )
                         {
@@ -694,7 +777,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
                         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -706,17 +789,57 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
             }
             }
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
+            BVHBuildNode *children[2];
+
+            if( ( threadLevels > 0 ) && ( nPrimitives >= (int)PARALLEL_BUILD_MIN_ITEMS ) )
+            {
+                // The two subtrees work on disjoint ranges of _primitiveInfo_ and
+                // _orderedPrims_, so the first one is built on another thread
+                std::list<void *> childAllocations;
+
+                std::thread child( [&]()
+                                   {
+                                       children[0] = recursiveBuild( primitiveInfo,
+                                                                     start,
+                                                                     mid,
+                                                                     totalNodes,
+                                                                     orderedPrims,
+                                                                     childAllocations,
+                                                                     threadLevels - 1 );
+                                   } );
+
+                children[1] = recursiveBuild( primitiveInfo,
+                                              mid,
+                                              end,
+                                              totalNodes,
+                                              orderedPrims,
+                                              allocations,
+                                              threadLevels - 1 );
+
+                child.join();
+
+                allocations.splice( allocations.end(), childAllocations );
+            }
+            else
+            {
+                children[0] = recursiveBuild( primitiveInfo,
+                                              start,
+                                              mid,
+                                              totalNodes,
+                                              orderedPrims,
+                                              allocations,
+                                              0 );
+
+                children[1] = recursiveBuild( primitiveInfo,
+                                              mid,
+                                              end,
+                                              totalNodes,
+                                              orderedPrims,
+                                              allocations,
+                                              0 );
+            }
+
+            node->InitInterior( dim, children[0], children[1] );
         }
     }
 
@@ -725,7 +848,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
 
 BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
-                                     int *totalNodes,
+                                     std::atomic<int> *totalNodes,
                                      CONST_VECTOR_OBJECT &orderedPrims )
 {
     // Compute bounding box of all primitive centroids
@@ -738,25 +861,31 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     // Compute Morton indices of primitives
     std::vector<MortonPrimitive> mortonPrims( primitiveInfo.size() );
 
-    for( int i = 0; i < (int)primitiveInfo.size(); ++i )
-    {
-        // Initialize _mortonPrims[i]_ for _i_th primitive
-        const int mortonBits  = 10;
-        const int mortonScale = 1 << mortonBits;
+    ParallelChunks( primitiveInfo.size(), ParallelChunkCount( primitiveInfo.size() ),
+                    [&]( size_t aChunk, size_t aBegin, size_t aEnd )
+                    {
+                        for( size_t i = aBegin; i < aEnd; ++i )
+                        {
+                            // Initialize _mortonPrims[i]_ for _i_th primitive
+                            const int mortonBits  = 10;
+                            const int mortonScale = 1 << mortonBits;
 
-        wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
+                            wxASSERT( primitiveInfo[i].primitiveNumber <
+                                      (int)primitiveInfo.size() );
 
-        mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
+                            mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
 
-        const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
+                            const SFVEC3F centroidOffset =
+                                    bounds.Offset( primitiveInfo[i].centroid );
 
-        wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
-        wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
-        wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
+                            wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
+                            wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
+                            wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
 
-        mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
-                                                   SFVEC3F( (float)mortonScale ) );
-    }
+                            mortonPrims[i].mortonCode =
+                                    EncodeMorton3( centroidOffset * SFVEC3F( (float)mortonScale ) );
+                        }
+                    } );
 
     // Radix sort primitive Morton indices
     RadixSort( &mortonPrims );
@@ -807,34 +936,45 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     }
 
     // Create LBVHs for treelets in parallel
-    int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
+    // The primitives of each treelet are stored in the range of their Morton codes
+    std::atomic<int> atomicTotal( 0 );
+    std::atomic<size_t> nextTreelet( 0 );
 
     orderedPrims.resize( m_primitives.size() );
 
-    for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
-    {
-        // Generate _index_th LBVH treelet
-        int nodesCreated = 0;
-        const int firstBit = 29 - 12;
+    const size_t nThreads = std::min( ParallelChunkCount( mortonPrims.size() ),
+                                      treeletsToBuild.size() );
 
-        LBVHTreelet &tr = treeletsToBuild[index];
+    ParallelChunks( treeletsToBuild.size(), nThreads,
+                    [&]( size_t, size_t, size_t )
+                    {
+                        for( size_t index = nextTreelet.fetch_add( 1 );
+                             index < treeletsToBuild.size();
+                             index = nextTreelet.fetch_add( 1 ) )
+                        {
+                            // Generate _index_th LBVH treelet
+                            int nodesCreated = 0;
+                            const int firstBit = 29 - 12;
 
-        wxASSERT( tr.startIndex < (int)mortonPrims.size() );
+                            LBVHTreelet &tr = treeletsToBuild[index];
+                            int orderedPrimsOffset = tr.startIndex;
 
-        tr.buildNodes = emitLBVH( tr.buildNodes,
-                                  primitiveInfo,
-                                  &mortonPrims[tr.startIndex],
-                                  tr.numPrimitives,
-                                  &nodesCreated,
-                                  orderedPrims,
-                                  &orderedPrimsOffset,
-                                  firstBit );
+                            wxASSERT( tr.startIndex < (int)mortonPrims.size() );
 
-        atomicTotal += nodesCreated;
-    }
+                            tr.buildNodes = emitLBVH( tr.buildNodes,
+                                                      primitiveInfo,
+                                                      &mortonPrims[tr.startIndex],
+                                                      tr.numPrimitives,
+                                                      &nodesCreated,
+                                                      orderedPrims,
+                                                      &orderedPrimsOffset,
+                                                      firstBit );
 
-    *totalNodes = atomicTotal;
+                            atomicTotal += nodesCreated;
+                        }
+                    } );
+
+    *totalNodes = atomicTotal.load();
 
     // Initialize _finishedTreelets_ with treelet root node pointers
     std::vector<BVHBuildNode *> finishedTreelets;
@@ -847,7 +987,9 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     return buildUpperSAH( finishedTreelets,
                           0,
                           finishedTreelets.size(),
-                          totalNodes );
+                          totalNodes,
+                          m_addresses_pointer_to_mm_free,
+                          ParallelBuildLevels() );
 }
 
 
@@ -955,7 +1097,9 @@ BVHBuildNode *CBVH_PBRT::emitLBVH(
 BVHBuildNode *CBVH_PBRT::buildUpperSAH(
                                       std::vector<BVHBuildNode *> &treeletRoots,
                                       int start, int end,
-                                      int *totalNodes )
+                                      std::atomic<int> *totalNodes,
+                                      std::list<void *> &allocations,
+                                      int threadLevels )
 {
     wxASSERT( totalNodes != NULL );
     wxASSERT( start < end );
@@ -971,7 +1115,7 @@ BVHBuildNode *CBVH_PBRT::buildUpperSAH(
 
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
 
-    m_addresses_pointer_to_mm_free.push_back( node );
+    allocations.push_back( node );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -1095,9 +1239,35 @@ BVHBuildNode *CBVH_PBRT::buildUpperSAH(
 
     wxASSERT( (mid > start) && (mid < end) );
 
-    node->InitInterior( dim,
-                        buildUpperSAH( treeletRoots, start, mid, totalNodes ),
-                        buildUpperSAH( treeletRoots, mid,   end, totalNodes ) );
+    BVHBuildNode *children[2];
+
+    // A few thousand treelets at most are left to the upper levels, so they are split on
+    // several threads much earlier than the primitives
+    if( ( threadLevels > 0 ) && ( nNodes >= 64 ) )
+    {
+        std::list<void *> childAllocations;
+
+        std::thread child( [&]()
+                           {
+                               children[0] = buildUpperSAH( treeletRoots, start, mid,
+                                                            totalNodes, childAllocations,
+                                                            threadLevels - 1 );
+                           } );
+
+        children[1] = buildUpperSAH( treeletRoots, mid, end, totalNodes, allocations,
+                                     threadLevels - 1 );
+
+        child.join();
+
+        allocations.splice( allocations.end(), childAllocations );
+    }
+    else
+    {
+        children[0] = buildUpperSAH( treeletRoots, start, mid, totalNodes, allocations, 0 );
+        children[1] = buildUpperSAH( treeletRoots, mid,   end, totalNodes, allocations, 0 );
+    }
+
+    node->InitInterior( dim, children[0], children[1] );
 
     return node;
 }
@@ -71,6 +71,7 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include <atomic>
 #include <cstdint>
 #include <list>
 
@@ -123,14 +124,23 @@ public:
 
 private:
 
+    /**
+     * Builds the subtree of the primitives [start, end) of primitiveInfo, storing them in
+     * the same range of orderedPrims
+     * @param allocations receives the nodes allocated for the subtree
+     * @param threadLevels is the number of levels below which the subtrees are built on
+     * several threads
+     */
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  std::atomic<int> *totalNodes,
+                                  CONST_VECTOR_OBJECT &orderedPrims,
+                                  std::list<void *> &allocations,
+                                  int threadLevels );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
-                              int *totalNodes,
+                              std::atomic<int> *totalNodes,
                               CONST_VECTOR_OBJECT &orderedPrims );
 
     //!TODO: after implement memory arena, put const back to this functions
@@ -146,7 +156,9 @@ private:
     BVHBuildNode *buildUpperSAH( std::vector<BVHBuildNode *> &treeletRoots,
                                  int start,
                                  int end,
-                                 int *totalNodes );
+                                 std::atomic<int> *totalNodes,
+                                 std::list<void *> &allocations,
+                                 int threadLevels );
 
     int flattenBVHTree( BVHBuildNode *node,
                         uint32_t *offset );
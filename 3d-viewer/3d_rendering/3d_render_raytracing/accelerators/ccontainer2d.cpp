@@ -28,8 +28,10 @@
  */
 
 #include "ccontainer2d.h"
-#include <vector>
+#include <algorithm>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
 #include <wx/debug.h>
@@ -264,6 +266,13 @@ CBVHCONTAINER2D::~CBVHCONTAINER2D()
 
 #define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
 
+// Minimum number of objects of a node to build its two subtrees on two threads
+#define BVH_CONTAINER2D_PARALLEL_MIN_OBJ 16384
+
+// Maximum number of levels built on several threads: the containers of the layers are
+// already built in parallel, so only a few more threads are used for the largest ones
+#define BVH_CONTAINER2D_PARALLEL_LEVELS 2
+
 
 void CBVHCONTAINER2D::BuildBVH()
 {
@@ -281,14 +290,10 @@ void CBVHCONTAINER2D::BuildBVH()
     m_elements_to_delete.push_back( m_Tree );
     m_Tree->m_BBox = m_bbox;
 
-    for( LIST_OBJECT2D::const_iterator ii = m_objects.begin();
-         ii != m_objects.end();
-         ++ii )
-    {
-        m_Tree->m_LeafList.push_back( static_cast<const COBJECT2D *>(*ii) );
-    }
+    std::vector<const COBJECT2D *> objects( m_objects.begin(), m_objects.end() );
 
-    recursiveBuild_MIDDLE_SPLIT( m_Tree );
+    recursiveBuild_MIDDLE_SPLIT( m_Tree, objects, 0, objects.size(), m_elements_to_delete,
+                                 BVH_CONTAINER2D_PARALLEL_LEVELS );
 }
 
 
@@ -300,90 +305,97 @@ void CBVHCONTAINER2D::BuildBVH()
 // "Creates a binary tree with Top-Down approach.
 //  Fastest BVH building, but least [speed] accuracy."
 
-static bool sortByCentroid_X( const COBJECT2D *a, const COBJECT2D *b )
-{
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
-}
+// The objects are only partitioned around the median of their centroids, instead of sorted:
+// the halves of a node are the same, in linear instead of n log n time.
 
-static bool sortByCentroid_Y( const COBJECT2D *a, const COBJECT2D *b )
+struct CompareCentroid
 {
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
-}
+    explicit CompareCentroid( unsigned int aAxis ) : m_axis( aAxis ) {}
 
-static bool sortByCentroid_Z( const COBJECT2D *a, const COBJECT2D *b )
-{
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
-}
+    bool operator()( const COBJECT2D *a, const COBJECT2D *b ) const
+    {
+        return a->GetCentroid()[m_axis] < b->GetCentroid()[m_axis];
+    }
+
+    unsigned int m_axis;
+};
 
-void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent )
+
+void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent,
+                                                   std::vector<const COBJECT2D *> &aObjects,
+                                                   size_t aStart, size_t aEnd,
+                                                   std::list<BVH_CONTAINER_NODE_2D *> &aAllocations,
+                                                   int aThreadLevels )
 {
     wxASSERT( aNodeParent != NULL );
     wxASSERT( aNodeParent->m_BBox.IsInitialized() == true );
-    wxASSERT( aNodeParent->m_LeafList.size() > 0 );
+    wxASSERT( aStart < aEnd );
+    wxASSERT( aEnd <= aObjects.size() );
 
-    if( aNodeParent->m_LeafList.size() > BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
+    if( ( aEnd - aStart ) > BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
     {
         // Create Leaf Nodes
         BVH_CONTAINER_NODE_2D *leftNode  = new BVH_CONTAINER_NODE_2D;
         BVH_CONTAINER_NODE_2D *rightNode = new BVH_CONTAINER_NODE_2D;
-        m_elements_to_delete.push_back( leftNode );
-        m_elements_to_delete.push_back( rightNode );
+        aAllocations.push_back( leftNode );
+        aAllocations.push_back( rightNode );
 
         leftNode->m_BBox.Reset();
         rightNode->m_BBox.Reset();
-        leftNode->m_LeafList.clear();
-        rightNode->m_LeafList.clear();
 
         // Decide wich axis to split
         const unsigned int axis_to_split = aNodeParent->m_BBox.MaxDimension();
 
         // Divide the objects
-        switch( axis_to_split )
-        {
-            case 0: aNodeParent->m_LeafList.sort( sortByCentroid_X ); break;
-            case 1: aNodeParent->m_LeafList.sort( sortByCentroid_Y ); break;
-            case 2: aNodeParent->m_LeafList.sort( sortByCentroid_Z ); break;
-        }
-
-        unsigned int i = 0;
+        const size_t middle = aStart + ( aEnd - aStart ) / 2;
 
-        for( CONST_LIST_OBJECT2D::const_iterator ii = aNodeParent->m_LeafList.begin();
-             ii != aNodeParent->m_LeafList.end();
-             ++ii )
-        {
-            const COBJECT2D *object = static_cast<const COBJECT2D *>(*ii);
-
-            if( i < (aNodeParent->m_LeafList.size() / 2 ) )
-            {
-                leftNode->m_BBox.Union( object->GetBBox() );
-                leftNode->m_LeafList.push_back( object );
-            }
-            else
-            {
-                rightNode->m_BBox.Union( object->GetBBox() );
-                rightNode->m_LeafList.push_back( object );
-            }
+        std::nth_element( aObjects.begin() + aStart,
+                          aObjects.begin() + middle,
+                          aObjects.begin() + aEnd,
+                          CompareCentroid( axis_to_split ) );
 
-            i++;
-        }
+        for( size_t i = aStart; i < middle; ++i )
+            leftNode->m_BBox.Union( aObjects[i]->GetBBox() );
 
-        wxASSERT( leftNode->m_LeafList.size() > 0 );
-        wxASSERT( rightNode->m_LeafList.size() > 0 );
-        wxASSERT( ( leftNode->m_LeafList.size() + rightNode->m_LeafList.size() ) ==
-                  aNodeParent->m_LeafList.size() );
+        for( size_t i = middle; i < aEnd; ++i )
+            rightNode->m_BBox.Union( aObjects[i]->GetBBox() );
 
         aNodeParent->m_Children[0] = leftNode;
         aNodeParent->m_Children[1] = rightNode;
-        aNodeParent->m_LeafList.clear();
 
-        recursiveBuild_MIDDLE_SPLIT( leftNode );
-        recursiveBuild_MIDDLE_SPLIT( rightNode );
+        if( ( aThreadLevels > 0 ) && ( aEnd - aStart >= BVH_CONTAINER2D_PARALLEL_MIN_OBJ ) )
+        {
+            // The two subtrees work on disjoint ranges of aObjects, so the first one is built
+            // on another thread
+            std::list<BVH_CONTAINER_NODE_2D *> childAllocations;
+
+            std::thread child( [&]()
+                               {
+                                   recursiveBuild_MIDDLE_SPLIT( leftNode, aObjects,
+                                                                aStart, middle,
+                                                                childAllocations,
+                                                                aThreadLevels - 1 );
+                               } );
+
+            recursiveBuild_MIDDLE_SPLIT( rightNode, aObjects, middle, aEnd, aAllocations,
+                                         aThreadLevels - 1 );
+
+            child.join();
+
+            aAllocations.splice( aAllocations.end(), childAllocations );
+        }
+        else
+        {
+            recursiveBuild_MIDDLE_SPLIT( leftNode, aObjects, aStart, middle, aAllocations, 0 );
+            recursiveBuild_MIDDLE_SPLIT( rightNode, aObjects, middle, aEnd, aAllocations, 0 );
+        }
     }
     else
     {
         // It is a Leaf
         aNodeParent->m_Children[0] = NULL;
         aNodeParent->m_Children[1] = NULL;
+        aNodeParent->m_LeafList.assign( aObjects.begin() + aStart, aObjects.begin() + aEnd );
     }
 }
 
@@ -416,12 +428,8 @@ void CBVHCONTAINER2D::recursiveGetListObjectsIntersects( const BVH_CONTAINER_NOD
             wxASSERT( aNode->m_Children[1] == NULL );
 
             // Leaf
-            for( CONST_LIST_OBJECT2D::const_iterator ii = aNode->m_LeafList.begin();
-                 ii != aNode->m_LeafList.end();
-                 ++ii )
+            for( const COBJECT2D *obj : aNode->m_LeafList )
             {
-                const COBJECT2D *obj = static_cast<const COBJECT2D *>(*ii);
-
                 if( obj->Intersects( aBBox ) )
                     aOutList.push_back( obj );
             }
@@ -33,6 +33,7 @@
 #include "../shapes2D/cobject2d.h"
 #include <list>
 #include <mutex>
+#include <vector>
 
 typedef std::list<COBJECT2D *> LIST_OBJECT2D;
 typedef std::list<const COBJECT2D *> CONST_LIST_OBJECT2D;
@@ -93,7 +94,7 @@ struct BVH_CONTAINER_NODE_2D
     BVH_CONTAINER_NODE_2D   *m_Children[2];
 
     /// Store the list of objects if that node is a Leaf
-    CONST_LIST_OBJECT2D     m_LeafList;
+    std::vector<const COBJECT2D *> m_LeafList;
 };
 
 
@@ -111,7 +112,11 @@ private:
     BVH_CONTAINER_NODE_2D   *m_Tree;
 
     void destroy();
-    void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent );
+    void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent,
+                                      std::vector<const COBJECT2D *> &aObjects,
+                                      size_t aStart, size_t aEnd,
+                                      std::list<BVH_CONTAINER_NODE_2D *> &aAllocations,
+                                      int aThreadLevels );
     void recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
                                             const CBBOX2D & aBBox,
                                             CONST_LIST_OBJECT2D &aOutList ) const;
@@ -41,6 +41,7 @@
 #include "accelerators/cbvh_pbrt.h"
 #include "3d_fastmath.h"
 #include "3d_math.h"
+#include "3d_cache/3d_model_loader.h"
 
 #include <class_board.h>
 #include <class_module.h>
@@ -258,7 +259,11 @@ void C3D_RENDER_RAYTRACING::create_3d_object_from( CCONTAINER& aDstContainer,
 
 void C3D_RENDER_RAYTRACING::reload( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter )
 {
+    const LSET reloadLayers = m_reloadLayers;
+    const bool reloadBoard  = m_reloadRequested;
+
     m_reloadRequested = false;
+    m_reloadLayers.reset();
 
     m_model_materials.clear();
 
@@ -271,7 +276,10 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 
     unsigned stats_startReloadTime = GetRunningMicroSecs();
 
-    m_boardAdapter.InitSettings( aStatusTextReporter, aWarningTextReporter );
+    // After an edit, only the 2D layers of the changed items are built again.  The 3D
+    // objects and their BVH are all created again, they are made from all the layers.
+    if( reloadBoard || !m_boardAdapter.UpdateLayers( reloadLayers, aStatusTextReporter ) )
+        m_boardAdapter.InitSettings( aStatusTextReporter, aWarningTextReporter );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endReloadTime = GetRunningMicroSecs();
@@ -1256,6 +1264,27 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // The models are all needed to build the scene, they are loaded on several threads
+    // first and then got back from the cache
+    std::vector< wxString > fileNames;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+        {
+            for( const MODULE_3D_SETTINGS& model : module->Models() )
+            {
+                if( !model.m_Filename.empty() )
+                    fileNames.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    S3D_MODEL_LOADER loader;
+
+    loader.Start( m_boardAdapter.Get3DCacheManager(), fileNames );
+    loader.Wait();
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
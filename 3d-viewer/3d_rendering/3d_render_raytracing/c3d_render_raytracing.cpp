@@ -33,6 +33,7 @@
 #include <chrono>
 #include <climits>
 #include <thread>
+#include <wx/image.h>
 
 #include "c3d_render_raytracing.h"
 #include "mortoncodes.h"
@@ -40,6 +41,7 @@
 #include "3d_fastmath.h"
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
+#include <thread_pool.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
 
 // This should be used in future for the function
@@ -53,6 +55,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     wxLogTrace( m_logTrace, wxT( "C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING" ) );
 
     m_opengl_support_vertex_buffer_object = false;
+    m_offscreen   = false;
     m_pboId       = GL_NONE;
     m_pboDataSize = 0;
     m_accelerator = NULL;
@@ -72,6 +75,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
     m_nrBlocksRenderProgress = 0;
+    m_previewIsUpToDate = false;
 }
 
 
@@ -138,6 +142,9 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
     std::fill( m_blockPositionsWasProcessed.begin(),
                m_blockPositionsWasProcessed.end(),
                0 );
+
+    m_blockContrast.assign( m_blockPositions.size(), 0.0f );
+    m_blocksToRefine.clear();
 }
 
 
@@ -172,7 +179,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
 
     // Reload board if it was requested
     // /////////////////////////////////////////////////////////////////////////
-    if( m_reloadRequested )
+    if( IsReloadRequestPending() )
     {
         if( aStatusTextReporter )
             aStatusTextReporter->Report( _( "Loading..." ) );
@@ -216,9 +223,14 @@ bool C3D_RENDER_RAYTRACING::Redraw(
     const bool was_camera_changed = m_camera.ParametersChanged();
 
     if( requestRedraw || aIsMoving || was_camera_changed )
+    {
         m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an invalid state,
                                                  // so it will restart again latter
 
+        // The preview is drawn below in these cases, otherwise the PBO holds an old view
+        m_previewIsUpToDate = aIsMoving || was_camera_changed;
+    }
+
 
     // This will only render if need, otherwise it will redraw the PBO on the screen again
     if( aIsMoving || was_camera_changed )
@@ -299,6 +311,83 @@ bool C3D_RENDER_RAYTRACING::Redraw(
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderOffscreen( const wxSize &aSize, wxImage &aImage,
+                                             REPORTER* aStatusTextReporter,
+                                             REPORTER* aWarningTextReporter )
+{
+    if( aSize.x <= 0 || aSize.y <= 0 )
+        return false;
+
+    // There is no PBO, the blocks are traced into the client memory
+    m_offscreen = true;
+    m_is_opengl_initialized = true;
+    m_windowSize = aSize;
+
+    if( IsReloadRequestPending() )
+        reload( aStatusTextReporter, aWarningTextReporter );
+
+    if( m_windowSize != m_oldWindowsSize || m_blockPositions.empty() )
+    {
+        m_oldWindowsSize = m_windowSize;
+        initialize_block_positions();
+    }
+
+    m_camera.ParametersChanged();
+
+    if( m_camera_light )
+        m_camera_light->SetDirection( -m_camera.GetDir() );
+
+    std::vector< GLubyte > buffer( m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    // No preview: only the final image is read
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+    m_previewIsUpToDate = true;
+
+    do
+    {
+        render( buffer.data(), aStatusTextReporter );
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    // The traced buffer is centered in the image, over the background gradient. Its rows
+    // are bottom up, as for glDrawPixels.
+    aImage.Create( aSize.x, aSize.y, false );
+
+    unsigned char *rgb = aImage.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const float t = ( aSize.y > 1 ) ? (float) y / (float) ( aSize.y - 1 ) : 0.0f;
+        const CCOLORRGB bg( glm::mix( SFVEC3F( m_boardAdapter.m_BgColorTop ),
+                                      SFVEC3F( m_boardAdapter.m_BgColorBot ), t ) );
+
+        for( int x = 0; x < aSize.x; ++x, rgb += 3 )
+        {
+            rgb[0] = bg.c[0];
+            rgb[1] = bg.c[1];
+            rgb[2] = bg.c[2];
+        }
+    }
+
+    rgb = aImage.GetData();
+
+    for( unsigned int y = 0; y < m_realBufferSize.y; ++y )
+    {
+        const unsigned int imageY = aSize.y - 1 - ( m_yoffset + y );
+        const GLubyte *src = &buffer[y * m_realBufferSize.x * 4];
+        unsigned char *dst = rgb + ( imageY * aSize.x + m_xoffset ) * 3;
+
+        for( unsigned int x = 0; x < m_realBufferSize.x; ++x, src += 4, dst += 3 )
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+        }
+    }
+
+    return true;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -324,6 +413,13 @@ void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextRepor
                 tmp_ptrPBO += 4;                // PBO is RGBA
             }
         }
+        else if( !m_previewIsUpToDate )
+        {
+            // Show the whole view at a low resolution first, the blocks of the render
+            // will replace it
+            render_preview( ptrPBO );
+            m_previewIsUpToDate = true;
+        }
 
         m_BgColorTop_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorTop );
         m_BgColorBot_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorBot );
@@ -332,6 +428,7 @@ void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextRepor
     switch( m_rt_render_state )
     {
     case RT_RENDER_STATE_TRACING:
+    case RT_RENDER_STATE_REFINE:
             rt_render_tracing( ptrPBO, aStatusTextReporter );
         break;
 
@@ -366,65 +463,154 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
 {
     m_isPreview = false;
 
+    // The first pass traces all the blocks with one sample per pixel, the refinement pass
+    // anti-aliases the blocks which have a contrast
+    const bool   isRefining = ( m_rt_render_state == RT_RENDER_STATE_REFINE );
+    const size_t nrBlocks = isRefining ? m_blocksToRefine.size() : m_blockPositions.size();
+
     auto startTime = std::chrono::steady_clock::now();
     bool breakLoop = false;
 
     std::atomic<size_t> numBlocksRendered( 0 );
     std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                        iBlock < m_blockPositions.size() && !breakLoop;
-                        iBlock = currentBlock.fetch_add( 1 ) )
+            GetKiCadThreadPool().GetThreadCount() + 1,
+            nrBlocks );
+    GetKiCadThreadPool().RunParallel(
+            [&]()
             {
-                if( !m_blockPositionsWasProcessed[iBlock] )
+                for( size_t iBlock = currentBlock.fetch_add( 1 );
+                            iBlock < nrBlocks && !breakLoop;
+                            iBlock = currentBlock.fetch_add( 1 ) )
                 {
-                    rt_render_trace_block( ptrPBO, iBlock );
-                    numBlocksRendered++;
-                    m_blockPositionsWasProcessed[iBlock] = 1;
-
-                    // Check if it spend already some time render and request to exit
-                    // to display the progress
-                    if( std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
+                    if( !m_blockPositionsWasProcessed[iBlock] )
+                    {
+                        rt_render_trace_block( ptrPBO,
+                                               isRefining ? m_blocksToRefine[iBlock] : iBlock,
+                                               isRefining );
+                        numBlocksRendered++;
+                        m_blockPositionsWasProcessed[iBlock] = 1;
+
+                        // Check if it spend already some time render and request to exit
+                        // to display the progress
+                        if( std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - startTime ).count() > 150 )
+                            breakLoop = true;
+                    }
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            },
+            parallelThreadCount );
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( wxString::Format( _( "Rendering: %.0f %%" ),
-                                                       (float)(m_nrBlocksRenderProgress * 100) /
-                                                       (float)m_blockPositions.size() ) );
+    if( aStatusTextReporter && nrBlocks > 0 )
+    {
+        const float progress = (float)(m_nrBlocksRenderProgress * 100) / (float)nrBlocks;
 
-    // Check if it finish the rendering and if should continue to a post processing
-    // or mark it as finished
-    if( m_nrBlocksRenderProgress >= m_blockPositions.size() )
+        if( isRefining )
+            aStatusTextReporter->Report( wxString::Format( _( "Rendering: Refining %.0f %%" ),
+                                                           progress ) );
+        else
+            aStatusTextReporter->Report( wxString::Format( _( "Rendering: %.0f %%" ),
+                                                           progress ) );
+    }
+
+    // Check if it finish the rendering and if should continue to a refinement, to a post
+    // processing or mark it as finished
+    if( m_nrBlocksRenderProgress >= nrBlocks )
     {
-        if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+        if( !isRefining && rt_start_refinement() )
+            m_rt_render_state = RT_RENDER_STATE_REFINE;
+        else if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
             m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_SHADE;
         else
             m_rt_render_state = RT_RENDER_STATE_FINISH;
     }
 }
 
+
+/// The blocks of the first pass whose neighbour pixels all differ by less than this are
+/// converged, anti-aliasing them would not change them visibly. The colors are compared by
+/// their square root, which is close to the sRGB encoding.
+#define AA_CONTRAST_THRESHOLD ( 2.0f / 255.0f )
+
+
+bool C3D_RENDER_RAYTRACING::rt_start_refinement()
+{
+    m_blocksToRefine.clear();
+
+    if( !m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+        return false;
+
+    for( size_t iBlock = 0; iBlock < m_blockContrast.size(); ++iBlock )
+    {
+        if( m_blockContrast[iBlock] >= AA_CONTRAST_THRESHOLD )
+            m_blocksToRefine.push_back( iBlock );
+    }
+
+    if( m_blocksToRefine.empty() )
+        return false;
+
+    // Refine the edges and the noisy reflections first
+    std::stable_sort( m_blocksToRefine.begin(), m_blocksToRefine.end(),
+                      [&]( size_t a, size_t b )
+                      {
+                          return m_blockContrast[a] > m_blockContrast[b];
+                      } );
+
+    m_nrBlocksRenderProgress = 0;
+    m_blockPositionsWasProcessed.assign( m_blocksToRefine.size(), 0 );
+
+    return true;
+}
+
+
+/**
+ * @return the largest difference of color between two neighbour pixels of a ray packet,
+ *         or 1.0 if they do not hit the same material
+ */
+static float packetContrast( const HITINFO_PACKET *aHitPacket, const SFVEC3F *aColor )
+{
+    SFVEC3F perceived[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        perceived[i] = glm::sqrt( glm::clamp( aColor[i], SFVEC3F( 0.0f ), SFVEC3F( 1.0f ) ) );
+
+    auto contrast = [&]( unsigned int i, unsigned int j ) -> float
+                    {
+                        const HITINFO_PACKET &a = aHitPacket[i];
+                        const HITINFO_PACKET &b = aHitPacket[j];
+
+                        if( a.m_hitresult != b.m_hitresult )
+                            return 1.0f;
+
+                        if( a.m_hitresult && a.m_HitInfo.pHitObject->GetMaterial()
+                                                  != b.m_HitInfo.pHitObject->GetMaterial() )
+                            return 1.0f;
+
+                        const SFVEC3F delta = glm::abs( perceived[i] - perceived[j] );
+
+                        return glm::max( delta.r, glm::max( delta.g, delta.b ) );
+                    };
+
+    float maxContrast = 0.0f;
+
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+        {
+            if( x + 1 < RAYPACKET_DIM )
+                maxContrast = glm::max( maxContrast, contrast( i, i + 1 ) );
+
+            if( y + 1 < RAYPACKET_DIM )
+                maxContrast = glm::max( maxContrast, contrast( i, i + RAYPACKET_DIM ) );
+        }
+    }
+
+    return maxContrast;
+}
+
 #ifdef USE_SRGB_SPACE
 
 // This should be removed in future when the KiCad support a greater version of
@@ -654,7 +840,8 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 #define DISP_FACTOR 0.075f
 
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
-                                                   signed int iBlock )
+                                                   signed int iBlock,
+                                                   bool aAntiAliasing )
 {
     // Initialize ray packets
     // /////////////////////////////////////////////////////////////////////////
@@ -746,7 +933,11 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                       m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ),
                       hitColor_X0Y0 );
 
-    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+    // The first pass measures the contrast of the block, to know if it needs anti-aliasing
+    if( !aAntiAliasing )
+        m_blockContrast[iBlock] = packetContrast( hitPacket_X0Y0, hitColor_X0Y0 );
+
+    if( aAntiAliasing )
     {
         SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
@@ -917,34 +1108,25 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
             aStatusTextReporter->Report( _("Rendering: Post processing shader") );
 
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        size_t parallelThreadCount = GetKiCadThreadPool().GetThreadCount() + 1;
+        GetKiCadThreadPool().RunParallel(
+                [&]()
                 {
-                    SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
-
-                    for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                    for( size_t y = nextBlock.fetch_add( 1 );
+                                y < m_realBufferSize.y;
+                                y = nextBlock.fetch_add( 1 ) )
                     {
-                        *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
-                        ptr++;
-                    }
-                }
-
-                threadsFinished++;
-            } );
+                        SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                        for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                        {
+                            *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
+                            ptr++;
+                        }
+                    }
+                },
+                parallelThreadCount );
 
         // Set next state
         m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH;
@@ -966,105 +1148,96 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
     {
         // Now blurs the shader result and compute the final color
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        size_t parallelThreadCount = GetKiCadThreadPool().GetThreadCount() + 1;
+        GetKiCadThreadPool().RunParallel(
+                [&]()
                 {
-                    GLubyte *ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
-
-                    const SFVEC3F *ptrShaderY0 =
-                            &m_shaderBuffer[ glm::max((int)y - 2, 0) * m_realBufferSize.x ];
-                    const SFVEC3F *ptrShaderY1 =
-                            &m_shaderBuffer[ glm::max((int)y - 1, 0) * m_realBufferSize.x ];
-                    const SFVEC3F *ptrShaderY2 =
-                            &m_shaderBuffer[ y * m_realBufferSize.x ];
-                    const SFVEC3F *ptrShaderY3 =
-                            &m_shaderBuffer[ glm::min((int)y + 1, (int)(m_realBufferSize.y - 1)) *
-                                             m_realBufferSize.x ];
-                    const SFVEC3F *ptrShaderY4 =
-                            &m_shaderBuffer[ glm::min((int)y + 2, (int)(m_realBufferSize.y - 1)) *
-                                             m_realBufferSize.x ];
-
-                    for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                    for( size_t y = nextBlock.fetch_add( 1 );
+                                y < m_realBufferSize.y;
+                                y = nextBlock.fetch_add( 1 ) )
                     {
-        // This #if should be 1, it is here that can be used for debug proposes during development
-        #if 1
-                        int idx = x > 1 ? -2 : 0;
-                        SFVEC3F bluredShadeColor = ptrShaderY0[idx] * 1.0f / 273.0f +
-                                                   ptrShaderY1[idx] * 4.0f / 273.0f +
-                                                   ptrShaderY2[idx] * 7.0f / 273.0f +
-                                                   ptrShaderY3[idx] * 4.0f / 273.0f +
-                                                   ptrShaderY4[idx] * 1.0f / 273.0f;
-
-                        idx = x > 0 ? -1 : 0;
-                        bluredShadeColor += ptrShaderY0[idx] *  4.0f / 273.0f +
-                                            ptrShaderY1[idx] * 16.0f / 273.0f +
-                                            ptrShaderY2[idx] * 26.0f / 273.0f +
-                                            ptrShaderY3[idx] * 16.0f / 273.0f +
-                                            ptrShaderY4[idx] *  4.0f / 273.0f;
-
-                        bluredShadeColor += (*ptrShaderY0) *  7.0f / 273.0f +
-                                            (*ptrShaderY1) * 26.0f / 273.0f +
-                                            (*ptrShaderY2) * 41.0f / 273.0f +
-                                            (*ptrShaderY3) * 26.0f / 273.0f +
-                                            (*ptrShaderY4) *  7.0f / 273.0f;
-
-                        idx = (x < (int)m_realBufferSize.x - 1) ? 1 : 0;
-                        bluredShadeColor += ptrShaderY0[idx] * 4.0f / 273.0f +
-                                            ptrShaderY1[idx] *16.0f / 273.0f +
-                                            ptrShaderY2[idx] *26.0f / 273.0f +
-                                            ptrShaderY3[idx] *16.0f / 273.0f +
-                                            ptrShaderY4[idx] * 4.0f / 273.0f;
-
-                        idx = (x < (int)m_realBufferSize.x - 2) ? 2 : 0;
-                        bluredShadeColor += ptrShaderY0[idx] * 1.0f / 273.0f +
-                                            ptrShaderY1[idx] * 4.0f / 273.0f +
-                                            ptrShaderY2[idx] * 7.0f / 273.0f +
-                                            ptrShaderY3[idx] * 4.0f / 273.0f +
-                                            ptrShaderY4[idx] * 1.0f / 273.0f;
-
-                        // process next pixel
-                        ++ptrShaderY0;
-                        ++ptrShaderY1;
-                        ++ptrShaderY2;
-                        ++ptrShaderY3;
-                        ++ptrShaderY4;
-
-        #ifdef USE_SRGB_SPACE
-                        const SFVEC3F originColor = convertLinearToSRGB( m_postshader_ssao.GetColorAtNotProtected( SFVEC2I( x,y ) ) );
-        #else
-                        const SFVEC3F originColor = m_postshader_ssao.GetColorAtNotProtected( SFVEC2I( x,y ) );
-        #endif
-
-                        const SFVEC3F shadedColor = m_postshader_ssao.ApplyShadeColor( SFVEC2I( x,y ), originColor, bluredShadeColor );
-        #else
-                        // Debug code
-                        //const SFVEC3F shadedColor =  SFVEC3F( 1.0f ) -
-                        //                             m_shaderBuffer[ y * m_realBufferSize.x + x];
-                        const SFVEC3F shadedColor =  m_shaderBuffer[ y * m_realBufferSize.x + x ];
-        #endif
-
-                        rt_final_color( ptr, shadedColor, false );
-
-                        ptr += 4;
+                        GLubyte *ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
+
+                        const SFVEC3F *ptrShaderY0 =
+                                &m_shaderBuffer[ glm::max((int)y - 2, 0) * m_realBufferSize.x ];
+                        const SFVEC3F *ptrShaderY1 =
+                                &m_shaderBuffer[ glm::max((int)y - 1, 0) * m_realBufferSize.x ];
+                        const SFVEC3F *ptrShaderY2 =
+                                &m_shaderBuffer[ y * m_realBufferSize.x ];
+                        const SFVEC3F *ptrShaderY3 =
+                                &m_shaderBuffer[ glm::min((int)y + 1, (int)(m_realBufferSize.y - 1)) *
+                                                 m_realBufferSize.x ];
+                        const SFVEC3F *ptrShaderY4 =
+                                &m_shaderBuffer[ glm::min((int)y + 2, (int)(m_realBufferSize.y - 1)) *
+                                                 m_realBufferSize.x ];
+
+                        for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                        {
+            // This #if should be 1, it is here that can be used for debug proposes during development
+            #if 1
+                            int idx = x > 1 ? -2 : 0;
+                            SFVEC3F bluredShadeColor = ptrShaderY0[idx] * 1.0f / 273.0f +
+                                                       ptrShaderY1[idx] * 4.0f / 273.0f +
+                                                       ptrShaderY2[idx] * 7.0f / 273.0f +
+                                                       ptrShaderY3[idx] * 4.0f / 273.0f +
+                                                       ptrShaderY4[idx] * 1.0f / 273.0f;
+
+                            idx = x > 0 ? -1 : 0;
+                            bluredShadeColor += ptrShaderY0[idx] *  4.0f / 273.0f +
+                                                ptrShaderY1[idx] * 16.0f / 273.0f +
+                                                ptrShaderY2[idx] * 26.0f / 273.0f +
+                                                ptrShaderY3[idx] * 16.0f / 273.0f +
+                                                ptrShaderY4[idx] *  4.0f / 273.0f;
+
+                            bluredShadeColor += (*ptrShaderY0) *  7.0f / 273.0f +
+                                                (*ptrShaderY1) * 26.0f / 273.0f +
+                                                (*ptrShaderY2) * 41.0f / 273.0f +
+                                                (*ptrShaderY3) * 26.0f / 273.0f +
+                                                (*ptrShaderY4) *  7.0f / 273.0f;
+
+                            idx = (x < (int)m_realBufferSize.x - 1) ? 1 : 0;
+                            bluredShadeColor += ptrShaderY0[idx] * 4.0f / 273.0f +
+                                                ptrShaderY1[idx] *16.0f / 273.0f +
+                                                ptrShaderY2[idx] *26.0f / 273.0f +
+                                                ptrShaderY3[idx] *16.0f / 273.0f +
+                                                ptrShaderY4[idx] * 4.0f / 273.0f;
+
+                            idx = (x < (int)m_realBufferSize.x - 2) ? 2 : 0;
+                            bluredShadeColor += ptrShaderY0[idx] * 1.0f / 273.0f +
+                                                ptrShaderY1[idx] * 4.0f / 273.0f +
+                                                ptrShaderY2[idx] * 7.0f / 273.0f +
+                                                ptrShaderY3[idx] * 4.0f / 273.0f +
+                                                ptrShaderY4[idx] * 1.0f / 273.0f;
+
+                            // process next pixel
+                            ++ptrShaderY0;
+                            ++ptrShaderY1;
+                            ++ptrShaderY2;
+                            ++ptrShaderY3;
+                            ++ptrShaderY4;
+
+            #ifdef USE_SRGB_SPACE
+                            const SFVEC3F originColor = convertLinearToSRGB( m_postshader_ssao.GetColorAtNotProtected( SFVEC2I( x,y ) ) );
+            #else
+                            const SFVEC3F originColor = m_postshader_ssao.GetColorAtNotProtected( SFVEC2I( x,y ) );
+            #endif
+
+                            const SFVEC3F shadedColor = m_postshader_ssao.ApplyShadeColor( SFVEC2I( x,y ), originColor, bluredShadeColor );
+            #else
+                            // Debug code
+                            //const SFVEC3F shadedColor =  SFVEC3F( 1.0f ) -
+                            //                             m_shaderBuffer[ y * m_realBufferSize.x + x];
+                            const SFVEC3F shadedColor =  m_shaderBuffer[ y * m_realBufferSize.x + x ];
+            #endif
+
+                            rt_final_color( ptr, shadedColor, false );
+
+                            ptr += 4;
+                        }
                     }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                },
+                parallelThreadCount );
 
 
         // Debug code
@@ -1081,628 +1254,619 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
     m_isPreview = true;
 
     std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            GetKiCadThreadPool().GetThreadCount() + 1,
             m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = nextBlock.fetch_add( 1 );
-                        iBlock < m_blockPositionsFast.size();
-                        iBlock = nextBlock.fetch_add( 1 ) )
+    GetKiCadThreadPool().RunParallel(
+            [&]()
             {
-                const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
-                const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
-                                                    windowPosUI.y + m_yoffset );
-
-                RAYPACKET blockPacket( m_camera, windowsPos, 4 );
+                for( size_t iBlock = nextBlock.fetch_add( 1 );
+                            iBlock < m_blockPositionsFast.size();
+                            iBlock = nextBlock.fetch_add( 1 ) )
+                {
+                    const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
+                    const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
+                                                        windowPosUI.y + m_yoffset );
 
-                HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
+                    RAYPACKET blockPacket( m_camera, windowsPos, 4 );
 
-                // Initialize hitPacket with a "not hit" information
-                for( HITINFO_PACKET& packet : hitPacket )
-                {
-                    packet.m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
-                    packet.m_HitInfo.m_acc_node_info = 0;
-                    packet.m_hitresult = false;
-                }
+                    HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
 
-                //  Intersect packet block
-                m_accelerator->Intersect( blockPacket, hitPacket );
+                    // Initialize hitPacket with a "not hit" information
+                    for( HITINFO_PACKET& packet : hitPacket )
+                    {
+                        packet.m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                        packet.m_HitInfo.m_acc_node_info = 0;
+                        packet.m_hitresult = false;
+                    }
 
+                    //  Intersect packet block
+                    m_accelerator->Intersect( blockPacket, hitPacket );
 
-                // Calculate background gradient color
-                // /////////////////////////////////////////////////////////////////////
-                SFVEC3F bgColor[RAYPACKET_DIM];
 
-                for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
-                {
-                    const float posYfactor = (float)(windowsPos.y + y * 4.0f) / (float)m_windowSize.y;
+                    // Calculate background gradient color
+                    // /////////////////////////////////////////////////////////////////////
+                    SFVEC3F bgColor[RAYPACKET_DIM];
 
-                    bgColor[y] = (SFVEC3F)m_boardAdapter.m_BgColorTop * SFVEC3F( posYfactor) +
-                                 (SFVEC3F)m_boardAdapter.m_BgColorBot * ( SFVEC3F( 1.0f) - SFVEC3F( posYfactor) );
-                }
+                    for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
+                    {
+                        const float posYfactor = (float)(windowsPos.y + y * 4.0f) / (float)m_windowSize.y;
 
-                CCOLORRGB hitColorShading[RAYPACKET_RAYS_PER_PACKET];
+                        bgColor[y] = (SFVEC3F)m_boardAdapter.m_BgColorTop * SFVEC3F( posYfactor) +
+                                     (SFVEC3F)m_boardAdapter.m_BgColorBot * ( SFVEC3F( 1.0f) - SFVEC3F( posYfactor) );
+                    }
 
-                for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-                {
-                    const SFVEC3F bhColorY = bgColor[i / RAYPACKET_DIM];
+                    CCOLORRGB hitColorShading[RAYPACKET_RAYS_PER_PACKET];
 
-                    if( hitPacket[i].m_hitresult == true )
+                    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
                     {
-                        const SFVEC3F hitColor = shadeHit( bhColorY,
-                                                           blockPacket.m_ray[i],
-                                                           hitPacket[i].m_HitInfo,
-                                                           false,
-                                                           0,
-                                                           false );
-
-                        hitColorShading[i] = CCOLORRGB( hitColor );
+                        const SFVEC3F bhColorY = bgColor[i / RAYPACKET_DIM];
+
+                        if( hitPacket[i].m_hitresult == true )
+                        {
+                            const SFVEC3F hitColor = shadeHit( bhColorY,
+                                                               blockPacket.m_ray[i],
+                                                               hitPacket[i].m_HitInfo,
+                                                               false,
+                                                               0,
+                                                               false );
+
+                            hitColorShading[i] = CCOLORRGB( hitColor );
+                        }
+                        else
+                            hitColorShading[i] = bhColorY;
                     }
-                    else
-                        hitColorShading[i] = bhColorY;
-                }
 
-                CCOLORRGB cLRB_old[(RAYPACKET_DIM - 1)];
+                    CCOLORRGB cLRB_old[(RAYPACKET_DIM - 1)];
 
-                for( unsigned int y = 0; y < (RAYPACKET_DIM - 1); ++y )
-                {
+                    for( unsigned int y = 0; y < (RAYPACKET_DIM - 1); ++y )
+                    {
 
-                    const SFVEC3F     bgColorY = bgColor[y];
-                    const CCOLORRGB   bgColorYRGB = CCOLORRGB( bgColorY );
+                        const SFVEC3F     bgColorY = bgColor[y];
+                        const CCOLORRGB   bgColorYRGB = CCOLORRGB( bgColorY );
 
-                    // This stores cRTB from the last block to be reused next time in a cLTB pixel
-                    CCOLORRGB cRTB_old;
+                        // This stores cRTB from the last block to be reused next time in a cLTB pixel
+                        CCOLORRGB cRTB_old;
 
-                    //RAY       cRTB_ray;
-                    //HITINFO   cRTB_hitInfo;
+                        //RAY       cRTB_ray;
+                        //HITINFO   cRTB_hitInfo;
 
-                    for( unsigned int x = 0; x < (RAYPACKET_DIM - 1); ++x )
-                    {
-                        //      pxl 0  pxl 1  pxl 2  pxl 3  pxl 4
-                        //        x0                          x1  ...
-                        //     .---------------------------.
-                        // y0  | cLT  | cxxx | cLRT | cxxx | cRT  |
-                        //     | cxxx | cLTC | cxxx | cRTC | cxxx |
-                        //     | cLTB | cxxx | cC   | cxxx | cRTB |
-                        //     | cxxx | cLBC | cxxx | cRBC | cxxx |
-                        //     '---------------------------'
-                        // y1  | cLB  | cxxx | cLRB | cxxx | cRB  |
+                        for( unsigned int x = 0; x < (RAYPACKET_DIM - 1); ++x )
+                        {
+                            //      pxl 0  pxl 1  pxl 2  pxl 3  pxl 4
+                            //        x0                          x1  ...
+                            //     .---------------------------.
+                            // y0  | cLT  | cxxx | cLRT | cxxx | cRT  |
+                            //     | cxxx | cLTC | cxxx | cRTC | cxxx |
+                            //     | cLTB | cxxx | cC   | cxxx | cRTB |
+                            //     | cxxx | cLBC | cxxx | cRBC | cxxx |
+                            //     '---------------------------'
+                            // y1  | cLB  | cxxx | cLRB | cxxx | cRB  |
 
-                        const unsigned int iLT = ((x + 0) + RAYPACKET_DIM * (y + 0));
-                        const unsigned int iRT = ((x + 1) + RAYPACKET_DIM * (y + 0));
-                        const unsigned int iLB = ((x + 0) + RAYPACKET_DIM * (y + 1));
-                        const unsigned int iRB = ((x + 1) + RAYPACKET_DIM * (y + 1));
+                            const unsigned int iLT = ((x + 0) + RAYPACKET_DIM * (y + 0));
+                            const unsigned int iRT = ((x + 1) + RAYPACKET_DIM * (y + 0));
+                            const unsigned int iLB = ((x + 0) + RAYPACKET_DIM * (y + 1));
+                            const unsigned int iRB = ((x + 1) + RAYPACKET_DIM * (y + 1));
 
-                        // !TODO: skip when there are no hits
+                            // !TODO: skip when there are no hits
 
 
-                        const CCOLORRGB &cLT = hitColorShading[ iLT ];
-                        const CCOLORRGB &cRT = hitColorShading[ iRT ];
-                        const CCOLORRGB &cLB = hitColorShading[ iLB ];
-                        const CCOLORRGB &cRB = hitColorShading[ iRB ];
+                            const CCOLORRGB &cLT = hitColorShading[ iLT ];
+                            const CCOLORRGB &cRT = hitColorShading[ iRT ];
+                            const CCOLORRGB &cLB = hitColorShading[ iLB ];
+                            const CCOLORRGB &cRB = hitColorShading[ iRB ];
 
-                        // Trace and shade cC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cC = bgColorYRGB;
+                            // Trace and shade cC
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cC = bgColorYRGB;
 
-                        const SFVEC3F &oriLT = blockPacket.m_ray[ iLT ].m_Origin;
-                        const SFVEC3F &oriRB = blockPacket.m_ray[ iRB ].m_Origin;
+                            const SFVEC3F &oriLT = blockPacket.m_ray[ iLT ].m_Origin;
+                            const SFVEC3F &oriRB = blockPacket.m_ray[ iRB ].m_Origin;
 
-                        const SFVEC3F &dirLT = blockPacket.m_ray[ iLT ].m_Dir;
-                        const SFVEC3F &dirRB = blockPacket.m_ray[ iRB ].m_Dir;
+                            const SFVEC3F &dirLT = blockPacket.m_ray[ iLT ].m_Dir;
+                            const SFVEC3F &dirRB = blockPacket.m_ray[ iRB ].m_Dir;
 
-                        SFVEC3F oriC;
-                        SFVEC3F dirC;
+                            SFVEC3F oriC;
+                            SFVEC3F dirC;
 
-                        HITINFO centerHitInfo;
-                        centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                            HITINFO centerHitInfo;
+                            centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
 
-                        bool hittedC = false;
+                            bool hittedC = false;
 
-                        if( (hitPacket[ iLT ].m_hitresult == true) ||
-                            (hitPacket[ iRT ].m_hitresult == true) ||
-                            (hitPacket[ iLB ].m_hitresult == true) ||
-                            (hitPacket[ iRB ].m_hitresult == true) )
-                        {
+                            if( (hitPacket[ iLT ].m_hitresult == true) ||
+                                (hitPacket[ iRT ].m_hitresult == true) ||
+                                (hitPacket[ iLB ].m_hitresult == true) ||
+                                (hitPacket[ iRB ].m_hitresult == true) )
+                            {
 
-                            oriC = ( oriLT + oriRB ) * 0.5f;
-                            dirC = glm::normalize( ( dirLT + dirRB ) * 0.5f );
+                                oriC = ( oriLT + oriRB ) * 0.5f;
+                                dirC = glm::normalize( ( dirLT + dirRB ) * 0.5f );
 
-                            // Trace the center ray
-                            RAY centerRay;
-                            centerRay.Init( oriC, dirC );
-
-                            const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
-
-                            if( nodeLT != 0 )
-                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLT );
-
-                            if( ( nodeRT != 0 ) &&
-                                ( nodeRT != nodeLT ) )
-                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRT );
-
-                            if( ( nodeLB != 0 ) &&
-                                ( nodeLB != nodeLT ) &&
-                                ( nodeLB != nodeRT ) )
-                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLB );
-
-                            if( ( nodeRB != 0 ) &&
-                                ( nodeRB != nodeLB ) &&
-                                ( nodeRB != nodeLT ) &&
-                                ( nodeRB != nodeRT ) )
-                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRB );
-
-                            if( hittedC )
-                                cC = CCOLORRGB( shadeHit( bgColorY, centerRay, centerHitInfo, false, 0, false ) );
-                            else
-                            {
-                                centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
-                                hittedC = m_accelerator->Intersect( centerRay, centerHitInfo );
+                                // Trace the center ray
+                                RAY centerRay;
+                                centerRay.Init( oriC, dirC );
 
-                                if( hittedC )
-                                    cC = CCOLORRGB( shadeHit( bgColorY,
-                                                              centerRay,
-                                                              centerHitInfo,
-                                                              false,
-                                                              0,
-                                                              false ) );
-                            }
-                        }
+                                const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
 
-                        // Trace and shade cLRT
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLRT = bgColorYRGB;
+                                if( nodeLT != 0 )
+                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLT );
 
-                        const SFVEC3F &oriRT = blockPacket.m_ray[ iRT ].m_Origin;
-                        const SFVEC3F &dirRT = blockPacket.m_ray[ iRT ].m_Dir;
+                                if( ( nodeRT != 0 ) &&
+                                    ( nodeRT != nodeLT ) )
+                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRT );
 
-                        if( y == 0 )
-                        {
-                            // Trace the center ray
-                            RAY rayLRT;
-                            rayLRT.Init( ( oriLT + oriRT ) * 0.5f,
-                                            glm::normalize( ( dirLT + dirRT ) * 0.5f ) );
+                                if( ( nodeLB != 0 ) &&
+                                    ( nodeLB != nodeLT ) &&
+                                    ( nodeLB != nodeRT ) )
+                                        hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLB );
 
-                            HITINFO hitInfoLRT;
-                            hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+                                if( ( nodeRB != 0 ) &&
+                                    ( nodeRB != nodeLB ) &&
+                                    ( nodeRB != nodeLT ) &&
+                                    ( nodeRB != nodeRT ) )
+                                        hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRB );
 
-                            if( hitPacket[ iLT ].m_hitresult &&
-                                hitPacket[ iRT ].m_hitresult &&
-                                (hitPacket[ iLT ].m_HitInfo.pHitObject == hitPacket[ iRT ].m_HitInfo.pHitObject) )
-                            {
-                                hitInfoLRT.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
-                                hitInfoLRT.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
-                                                      hitPacket[ iRT ].m_HitInfo.m_tHit ) * 0.5f;
-                                hitInfoLRT.m_HitNormal =
-                                        glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
-                                                          hitPacket[ iRT ].m_HitInfo.m_HitNormal ) * 0.5f );
-
-                                cLRT = CCOLORRGB( shadeHit( bgColorY, rayLRT, hitInfoLRT, false, 0, false ) );
-                                cLRT = BlendColor( cLRT, BlendColor( cLT, cRT) );
-                            }
-                            else
-                            {
-                                if( hitPacket[ iLT ].m_hitresult ||
-                                    hitPacket[ iRT ].m_hitresult )                  // If any hits
+                                if( hittedC )
+                                    cC = CCOLORRGB( shadeHit( bgColorY, centerRay, centerHitInfo, false, 0, false ) );
+                                else
                                 {
-                                    const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                                    const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                                    centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                                    hittedC = m_accelerator->Intersect( centerRay, centerHitInfo );
+
+                                    if( hittedC )
+                                        cC = CCOLORRGB( shadeHit( bgColorY,
+                                                                  centerRay,
+                                                                  centerHitInfo,
+                                                                  false,
+                                                                  0,
+                                                                  false ) );
+                                }
+                            }
 
-                                    bool hittedLRT = false;
+                            // Trace and shade cLRT
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cLRT = bgColorYRGB;
 
-                                    if( nodeLT != 0 )
-                                        hittedLRT |= m_accelerator->Intersect( rayLRT, hitInfoLRT, nodeLT );
+                            const SFVEC3F &oriRT = blockPacket.m_ray[ iRT ].m_Origin;
+                            const SFVEC3F &dirRT = blockPacket.m_ray[ iRT ].m_Dir;
 
-                                    if( ( nodeRT != 0 ) &&
-                                        ( nodeRT != nodeLT ) )
-                                        hittedLRT |= m_accelerator->Intersect( rayLRT,
-                                                                               hitInfoLRT,
-                                                                               nodeRT );
+                            if( y == 0 )
+                            {
+                                // Trace the center ray
+                                RAY rayLRT;
+                                rayLRT.Init( ( oriLT + oriRT ) * 0.5f,
+                                                glm::normalize( ( dirLT + dirRT ) * 0.5f ) );
 
-                                    if( hittedLRT )
-                                        cLRT = CCOLORRGB( shadeHit( bgColorY,
-                                                                    rayLRT,
-                                                                    hitInfoLRT,
-                                                                    false,
-                                                                    0,
-                                                                    false ) );
-                                    else
+                                HITINFO hitInfoLRT;
+                                hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+
+                                if( hitPacket[ iLT ].m_hitresult &&
+                                    hitPacket[ iRT ].m_hitresult &&
+                                    (hitPacket[ iLT ].m_HitInfo.pHitObject == hitPacket[ iRT ].m_HitInfo.pHitObject) )
+                                {
+                                    hitInfoLRT.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                                    hitInfoLRT.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
+                                                          hitPacket[ iRT ].m_HitInfo.m_tHit ) * 0.5f;
+                                    hitInfoLRT.m_HitNormal =
+                                            glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
+                                                              hitPacket[ iRT ].m_HitInfo.m_HitNormal ) * 0.5f );
+
+                                    cLRT = CCOLORRGB( shadeHit( bgColorY, rayLRT, hitInfoLRT, false, 0, false ) );
+                                    cLRT = BlendColor( cLRT, BlendColor( cLT, cRT) );
+                                }
+                                else
+                                {
+                                    if( hitPacket[ iLT ].m_hitresult ||
+                                        hitPacket[ iRT ].m_hitresult )                  // If any hits
                                     {
-                                        hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+                                        const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                                        const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+
+                                        bool hittedLRT = false;
+
+                                        if( nodeLT != 0 )
+                                            hittedLRT |= m_accelerator->Intersect( rayLRT, hitInfoLRT, nodeLT );
 
-                                        if( m_accelerator->Intersect( rayLRT,hitInfoLRT ) )
+                                        if( ( nodeRT != 0 ) &&
+                                            ( nodeRT != nodeLT ) )
+                                            hittedLRT |= m_accelerator->Intersect( rayLRT,
+                                                                                   hitInfoLRT,
+                                                                                   nodeRT );
+
+                                        if( hittedLRT )
                                             cLRT = CCOLORRGB( shadeHit( bgColorY,
                                                                         rayLRT,
                                                                         hitInfoLRT,
                                                                         false,
                                                                         0,
                                                                         false ) );
+                                        else
+                                        {
+                                            hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+
+                                            if( m_accelerator->Intersect( rayLRT,hitInfoLRT ) )
+                                                cLRT = CCOLORRGB( shadeHit( bgColorY,
+                                                                            rayLRT,
+                                                                            hitInfoLRT,
+                                                                            false,
+                                                                            0,
+                                                                            false ) );
+                                        }
                                     }
                                 }
                             }
-                        }
-                        else
-                            cLRT = cLRB_old[x];
+                            else
+                                cLRT = cLRB_old[x];
 
 
-                        // Trace and shade cLTB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLTB = bgColorYRGB;
+                            // Trace and shade cLTB
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cLTB = bgColorYRGB;
 
-                        if( x == 0 )
-                        {
-                            const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
-                            const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
+                            if( x == 0 )
+                            {
+                                const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
+                                const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
 
-                            // Trace the center ray
-                            RAY rayLTB;
-                            rayLTB.Init( ( oriLT + oriLB ) * 0.5f,
-                                            glm::normalize( ( dirLT + dirLB ) * 0.5f ) );
+                                // Trace the center ray
+                                RAY rayLTB;
+                                rayLTB.Init( ( oriLT + oriLB ) * 0.5f,
+                                                glm::normalize( ( dirLT + dirLB ) * 0.5f ) );
 
-                            HITINFO hitInfoLTB;
-                            hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
+                                HITINFO hitInfoLTB;
+                                hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
 
-                            if( hitPacket[ iLT ].m_hitresult &&
-                                hitPacket[ iLB ].m_hitresult &&
-                                ( hitPacket[ iLT ].m_HitInfo.pHitObject ==
-                                  hitPacket[ iLB ].m_HitInfo.pHitObject ) )
-                            {
-                                hitInfoLTB.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
-                                hitInfoLTB.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
-                                                      hitPacket[ iLB ].m_HitInfo.m_tHit ) * 0.5f;
-                                hitInfoLTB.m_HitNormal =
-                                        glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
-                                                          hitPacket[ iLB ].m_HitInfo.m_HitNormal ) * 0.5f );
-                                cLTB = CCOLORRGB( shadeHit( bgColorY, rayLTB, hitInfoLTB, false, 0, false ) );
-                                cLTB = BlendColor( cLTB, BlendColor( cLT, cLB) );
-                            }
-                            else
-                            {
-                                if( hitPacket[ iLT ].m_hitresult ||
-                                    hitPacket[ iLB ].m_hitresult )                  // If any hits
+                                if( hitPacket[ iLT ].m_hitresult &&
+                                    hitPacket[ iLB ].m_hitresult &&
+                                    ( hitPacket[ iLT ].m_HitInfo.pHitObject ==
+                                      hitPacket[ iLB ].m_HitInfo.pHitObject ) )
                                 {
-                                    const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                                    const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
-
-                                    bool hittedLTB = false;
+                                    hitInfoLTB.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                                    hitInfoLTB.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
+                                                          hitPacket[ iLB ].m_HitInfo.m_tHit ) * 0.5f;
+                                    hitInfoLTB.m_HitNormal =
+                                            glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
+                                                              hitPacket[ iLB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                                    cLTB = CCOLORRGB( shadeHit( bgColorY, rayLTB, hitInfoLTB, false, 0, false ) );
+                                    cLTB = BlendColor( cLTB, BlendColor( cLT, cLB) );
+                                }
+                                else
+                                {
+                                    if( hitPacket[ iLT ].m_hitresult ||
+                                        hitPacket[ iLB ].m_hitresult )                  // If any hits
+                                    {
+                                        const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                                        const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
 
-                                    if( nodeLT != 0 )
-                                        hittedLTB |= m_accelerator->Intersect( rayLTB,
-                                                                               hitInfoLTB,
-                                                                               nodeLT );
+                                        bool hittedLTB = false;
 
-                                    if( ( nodeLB != 0 ) &&
-                                        ( nodeLB != nodeLT ) )
-                                        hittedLTB |= m_accelerator->Intersect( rayLTB,
-                                                                               hitInfoLTB,
-                                                                               nodeLB );
+                                        if( nodeLT != 0 )
+                                            hittedLTB |= m_accelerator->Intersect( rayLTB,
+                                                                                   hitInfoLTB,
+                                                                                   nodeLT );
 
-                                    if( hittedLTB )
-                                        cLTB = CCOLORRGB( shadeHit( bgColorY,
-                                                                    rayLTB,
-                                                                    hitInfoLTB,
-                                                                    false,
-                                                                    0,
-                                                                    false ) );
-                                    else
-                                    {
-                                        hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
+                                        if( ( nodeLB != 0 ) &&
+                                            ( nodeLB != nodeLT ) )
+                                            hittedLTB |= m_accelerator->Intersect( rayLTB,
+                                                                                   hitInfoLTB,
+                                                                                   nodeLB );
 
-                                        if( m_accelerator->Intersect( rayLTB, hitInfoLTB ) )
+                                        if( hittedLTB )
                                             cLTB = CCOLORRGB( shadeHit( bgColorY,
                                                                         rayLTB,
                                                                         hitInfoLTB,
                                                                         false,
                                                                         0,
                                                                         false ) );
+                                        else
+                                        {
+                                            hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
+
+                                            if( m_accelerator->Intersect( rayLTB, hitInfoLTB ) )
+                                                cLTB = CCOLORRGB( shadeHit( bgColorY,
+                                                                            rayLTB,
+                                                                            hitInfoLTB,
+                                                                            false,
+                                                                            0,
+                                                                            false ) );
+                                        }
                                     }
                                 }
                             }
-                        }
-                        else
-                            cLTB = cRTB_old;
+                            else
+                                cLTB = cRTB_old;
 
 
-                        // Trace and shade cRTB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRTB = bgColorYRGB;
+                            // Trace and shade cRTB
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cRTB = bgColorYRGB;
 
-                        // Trace the center ray
-                        RAY rayRTB;
-                        rayRTB.Init( ( oriRT + oriRB ) * 0.5f,
-                                        glm::normalize( ( dirRT + dirRB ) * 0.5f ) );
+                            // Trace the center ray
+                            RAY rayRTB;
+                            rayRTB.Init( ( oriRT + oriRB ) * 0.5f,
+                                            glm::normalize( ( dirRT + dirRB ) * 0.5f ) );
 
-                        HITINFO hitInfoRTB;
-                        hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
+                            HITINFO hitInfoRTB;
+                            hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
 
-                        if( hitPacket[ iRT ].m_hitresult &&
-                            hitPacket[ iRB ].m_hitresult &&
-                            ( hitPacket[ iRT ].m_HitInfo.pHitObject ==
-                              hitPacket[ iRB ].m_HitInfo.pHitObject ) )
-                        {
-                            hitInfoRTB.pHitObject = hitPacket[ iRT ].m_HitInfo.pHitObject;
+                            if( hitPacket[ iRT ].m_hitresult &&
+                                hitPacket[ iRB ].m_hitresult &&
+                                ( hitPacket[ iRT ].m_HitInfo.pHitObject ==
+                                  hitPacket[ iRB ].m_HitInfo.pHitObject ) )
+                            {
+                                hitInfoRTB.pHitObject = hitPacket[ iRT ].m_HitInfo.pHitObject;
 
-                            hitInfoRTB.m_tHit = ( hitPacket[ iRT ].m_HitInfo.m_tHit +
-                                                  hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
+                                hitInfoRTB.m_tHit = ( hitPacket[ iRT ].m_HitInfo.m_tHit +
+                                                      hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
 
-                            hitInfoRTB.m_HitNormal =
-                                    glm::normalize( ( hitPacket[ iRT ].m_HitInfo.m_HitNormal +
-                                                      hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                                hitInfoRTB.m_HitNormal =
+                                        glm::normalize( ( hitPacket[ iRT ].m_HitInfo.m_HitNormal +
+                                                          hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
 
-                            cRTB = CCOLORRGB( shadeHit( bgColorY, rayRTB, hitInfoRTB, false, 0, false ) );
-                            cRTB = BlendColor( cRTB, BlendColor( cRT, cRB) );
-                        }
-                        else
-                        {
-                            if( hitPacket[ iRT ].m_hitresult ||
-                                hitPacket[ iRB ].m_hitresult )                  // If any hits
+                                cRTB = CCOLORRGB( shadeHit( bgColorY, rayRTB, hitInfoRTB, false, 0, false ) );
+                                cRTB = BlendColor( cRTB, BlendColor( cRT, cRB) );
+                            }
+                            else
                             {
-                                const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
-                                const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+                                if( hitPacket[ iRT ].m_hitresult ||
+                                    hitPacket[ iRB ].m_hitresult )                  // If any hits
+                                {
+                                    const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                                    const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
 
-                                bool hittedRTB = false;
+                                    bool hittedRTB = false;
 
-                                if( nodeRT != 0 )
-                                    hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRT );
+                                    if( nodeRT != 0 )
+                                        hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRT );
 
-                                if( ( nodeRB != 0 ) &&
-                                    ( nodeRB != nodeRT ) )
-                                    hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRB );
-
-                                if( hittedRTB )
-                                    cRTB = CCOLORRGB( shadeHit( bgColorY,
-                                                                rayRTB,
-                                                                hitInfoRTB,
-                                                                false,
-                                                                0,
-                                                                false) );
-                                else
-                                {
-                                    hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
+                                    if( ( nodeRB != 0 ) &&
+                                        ( nodeRB != nodeRT ) )
+                                        hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRB );
 
-                                    if( m_accelerator->Intersect( rayRTB, hitInfoRTB ) )
+                                    if( hittedRTB )
                                         cRTB = CCOLORRGB( shadeHit( bgColorY,
                                                                     rayRTB,
                                                                     hitInfoRTB,
                                                                     false,
                                                                     0,
-                                                                    false ) );
+                                                                    false) );
+                                    else
+                                    {
+                                        hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
+
+                                        if( m_accelerator->Intersect( rayRTB, hitInfoRTB ) )
+                                            cRTB = CCOLORRGB( shadeHit( bgColorY,
+                                                                        rayRTB,
+                                                                        hitInfoRTB,
+                                                                        false,
+                                                                        0,
+                                                                        false ) );
+                                    }
                                 }
                             }
-                        }
 
-                        cRTB_old = cRTB;
+                            cRTB_old = cRTB;
 
 
-                        // Trace and shade cLRB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLRB = bgColorYRGB;
+                            // Trace and shade cLRB
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cLRB = bgColorYRGB;
 
-                        const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
-                        const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
+                            const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
+                            const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
 
-                        // Trace the center ray
-                        RAY rayLRB;
-                        rayLRB.Init( ( oriLB + oriRB ) * 0.5f,
-                                        glm::normalize( ( dirLB + dirRB ) * 0.5f ) );
+                            // Trace the center ray
+                            RAY rayLRB;
+                            rayLRB.Init( ( oriLB + oriRB ) * 0.5f,
+                                            glm::normalize( ( dirLB + dirRB ) * 0.5f ) );
 
-                        HITINFO hitInfoLRB;
-                        hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
+                            HITINFO hitInfoLRB;
+                            hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
 
-                        if( hitPacket[ iLB ].m_hitresult &&
-                            hitPacket[ iRB ].m_hitresult &&
-                            ( hitPacket[ iLB ].m_HitInfo.pHitObject ==
-                              hitPacket[ iRB ].m_HitInfo.pHitObject ) )
-                        {
-                            hitInfoLRB.pHitObject = hitPacket[ iLB ].m_HitInfo.pHitObject;
+                            if( hitPacket[ iLB ].m_hitresult &&
+                                hitPacket[ iRB ].m_hitresult &&
+                                ( hitPacket[ iLB ].m_HitInfo.pHitObject ==
+                                  hitPacket[ iRB ].m_HitInfo.pHitObject ) )
+                            {
+                                hitInfoLRB.pHitObject = hitPacket[ iLB ].m_HitInfo.pHitObject;
 
-                            hitInfoLRB.m_tHit = ( hitPacket[ iLB ].m_HitInfo.m_tHit +
-                                                  hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
+                                hitInfoLRB.m_tHit = ( hitPacket[ iLB ].m_HitInfo.m_tHit +
+                                                      hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
 
-                            hitInfoLRB.m_HitNormal =
-                                    glm::normalize( ( hitPacket[ iLB ].m_HitInfo.m_HitNormal +
-                                                      hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                                hitInfoLRB.m_HitNormal =
+                                        glm::normalize( ( hitPacket[ iLB ].m_HitInfo.m_HitNormal +
+                                                          hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
 
-                            cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
-                            cLRB = BlendColor( cLRB, BlendColor( cLB, cRB) );
-                        }
-                        else
-                        {
-                            if( hitPacket[ iLB ].m_hitresult ||
-                                hitPacket[ iRB ].m_hitresult )                  // If any hits
+                                cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
+                                cLRB = BlendColor( cLRB, BlendColor( cLB, cRB) );
+                            }
+                            else
                             {
-                                const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
-                                const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+                                if( hitPacket[ iLB ].m_hitresult ||
+                                    hitPacket[ iRB ].m_hitresult )                  // If any hits
+                                {
+                                    const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
+                                    const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
 
-                                bool hittedLRB = false;
+                                    bool hittedLRB = false;
 
-                                if( nodeLB != 0 )
-                                    hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeLB );
+                                    if( nodeLB != 0 )
+                                        hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeLB );
 
-                                if( ( nodeRB != 0 ) &&
-                                    ( nodeRB != nodeLB ) )
-                                    hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeRB );
+                                    if( ( nodeRB != 0 ) &&
+                                        ( nodeRB != nodeLB ) )
+                                        hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeRB );
 
-                                if( hittedLRB )
-                                    cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
-                                else
-                                {
-                                    hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
+                                    if( hittedLRB )
+                                        cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
+                                    else
+                                    {
+                                        hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
 
-                                    if( m_accelerator->Intersect( rayLRB, hitInfoLRB ) )
-                                        cLRB = CCOLORRGB( shadeHit( bgColorY,
-                                                                    rayLRB,
-                                                                    hitInfoLRB,
-                                                                    false,
-                                                                    0,
-                                                                    false ) );
+                                        if( m_accelerator->Intersect( rayLRB, hitInfoLRB ) )
+                                            cLRB = CCOLORRGB( shadeHit( bgColorY,
+                                                                        rayLRB,
+                                                                        hitInfoLRB,
+                                                                        false,
+                                                                        0,
+                                                                        false ) );
+                                    }
                                 }
                             }
-                        }
 
-                        cLRB_old[x] = cLRB;
+                            cLRB_old[x] = cLRB;
 
 
-                        // Trace and shade cLTC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLTC = BlendColor( cLT , cC );
+                            // Trace and shade cLTC
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cLTC = BlendColor( cLT , cC );
 
-                        if( hitPacket[ iLT ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayLTC;
-                            rayLTC.Init( ( oriLT + oriC ) * 0.5f,
-                                         glm::normalize( ( dirLT + dirC ) * 0.5f ) );
+                            if( hitPacket[ iLT ].m_hitresult || hittedC )
+                            {
+                                // Trace the center ray
+                                RAY rayLTC;
+                                rayLTC.Init( ( oriLT + oriC ) * 0.5f,
+                                             glm::normalize( ( dirLT + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoLTC;
-                            hitInfoLTC.m_tHit = std::numeric_limits<float>::infinity();
+                                HITINFO hitInfoLTC;
+                                hitInfoLTC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                                bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayLTC, hitInfoLTC );
-                            else
-                                if( hitPacket[ iLT ].m_hitresult )
-                                    hitted = hitPacket[ iLT ].m_HitInfo.pHitObject->Intersect( rayLTC,
-                                                                                               hitInfoLTC );
+                                if( hittedC )
+                                    hitted = centerHitInfo.pHitObject->Intersect( rayLTC, hitInfoLTC );
+                                else
+                                    if( hitPacket[ iLT ].m_hitresult )
+                                        hitted = hitPacket[ iLT ].m_HitInfo.pHitObject->Intersect( rayLTC,
+                                                                                                   hitInfoLTC );
 
-                            if( hitted )
-                                cLTC = CCOLORRGB( shadeHit( bgColorY, rayLTC, hitInfoLTC, false, 0, false ) );
-                        }
+                                if( hitted )
+                                    cLTC = CCOLORRGB( shadeHit( bgColorY, rayLTC, hitInfoLTC, false, 0, false ) );
+                            }
 
 
-                        // Trace and shade cRTC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRTC = BlendColor( cRT , cC );
+                            // Trace and shade cRTC
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cRTC = BlendColor( cRT , cC );
 
-                        if( hitPacket[ iRT ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayRTC;
-                            rayRTC.Init( ( oriRT + oriC ) * 0.5f,
-                                         glm::normalize( ( dirRT + dirC ) * 0.5f ) );
+                            if( hitPacket[ iRT ].m_hitresult || hittedC )
+                            {
+                                // Trace the center ray
+                                RAY rayRTC;
+                                rayRTC.Init( ( oriRT + oriC ) * 0.5f,
+                                             glm::normalize( ( dirRT + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoRTC;
-                            hitInfoRTC.m_tHit = std::numeric_limits<float>::infinity();
+                                HITINFO hitInfoRTC;
+                                hitInfoRTC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                                bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayRTC, hitInfoRTC );
-                            else
-                                if( hitPacket[ iRT ].m_hitresult )
-                                    hitted = hitPacket[ iRT ].m_HitInfo.pHitObject->Intersect( rayRTC,
-                                                                                               hitInfoRTC );
+                                if( hittedC )
+                                    hitted = centerHitInfo.pHitObject->Intersect( rayRTC, hitInfoRTC );
+                                else
+                                    if( hitPacket[ iRT ].m_hitresult )
+                                        hitted = hitPacket[ iRT ].m_HitInfo.pHitObject->Intersect( rayRTC,
+                                                                                                   hitInfoRTC );
 
-                            if( hitted )
-                                cRTC = CCOLORRGB( shadeHit( bgColorY, rayRTC, hitInfoRTC, false, 0, false ) );
-                        }
+                                if( hitted )
+                                    cRTC = CCOLORRGB( shadeHit( bgColorY, rayRTC, hitInfoRTC, false, 0, false ) );
+                            }
 
 
-                        // Trace and shade cLBC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLBC = BlendColor( cLB , cC );
+                            // Trace and shade cLBC
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cLBC = BlendColor( cLB , cC );
 
-                        if( hitPacket[ iLB ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayLBC;
-                            rayLBC.Init( ( oriLB + oriC ) * 0.5f,
-                                         glm::normalize( ( dirLB + dirC ) * 0.5f ) );
+                            if( hitPacket[ iLB ].m_hitresult || hittedC )
+                            {
+                                // Trace the center ray
+                                RAY rayLBC;
+                                rayLBC.Init( ( oriLB + oriC ) * 0.5f,
+                                             glm::normalize( ( dirLB + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoLBC;
-                            hitInfoLBC.m_tHit = std::numeric_limits<float>::infinity();
+                                HITINFO hitInfoLBC;
+                                hitInfoLBC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                                bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayLBC, hitInfoLBC );
-                            else
-                                if( hitPacket[ iLB ].m_hitresult )
-                                    hitted = hitPacket[ iLB ].m_HitInfo.pHitObject->Intersect( rayLBC,
-                                                                                               hitInfoLBC );
+                                if( hittedC )
+                                    hitted = centerHitInfo.pHitObject->Intersect( rayLBC, hitInfoLBC );
+                                else
+                                    if( hitPacket[ iLB ].m_hitresult )
+                                        hitted = hitPacket[ iLB ].m_HitInfo.pHitObject->Intersect( rayLBC,
+                                                                                                   hitInfoLBC );
 
-                            if( hitted )
-                                cLBC = CCOLORRGB( shadeHit( bgColorY, rayLBC, hitInfoLBC, false, 0, false ) );
-                        }
+                                if( hitted )
+                                    cLBC = CCOLORRGB( shadeHit( bgColorY, rayLBC, hitInfoLBC, false, 0, false ) );
+                            }
 
 
-                        // Trace and shade cRBC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRBC = BlendColor( cRB , cC );
+                            // Trace and shade cRBC
+                            // /////////////////////////////////////////////////////////////
+                            CCOLORRGB cRBC = BlendColor( cRB , cC );
 
-                        if( hitPacket[ iRB ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayRBC;
-                            rayRBC.Init( ( oriRB + oriC ) * 0.5f,
-                                         glm::normalize( ( dirRB + dirC ) * 0.5f ) );
+                            if( hitPacket[ iRB ].m_hitresult || hittedC )
+                            {
+                                // Trace the center ray
+                                RAY rayRBC;
+                                rayRBC.Init( ( oriRB + oriC ) * 0.5f,
+                                             glm::normalize( ( dirRB + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoRBC;
-                            hitInfoRBC.m_tHit = std::numeric_limits<float>::infinity();
+                                HITINFO hitInfoRBC;
+                                hitInfoRBC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                                bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayRBC, hitInfoRBC );
-                            else
-                                if( hitPacket[ iRB ].m_hitresult )
-                                    hitted = hitPacket[ iRB ].m_HitInfo.pHitObject->Intersect( rayRBC,
-                                                                                               hitInfoRBC );
+                                if( hittedC )
+                                    hitted = centerHitInfo.pHitObject->Intersect( rayRBC, hitInfoRBC );
+                                else
+                                    if( hitPacket[ iRB ].m_hitresult )
+                                        hitted = hitPacket[ iRB ].m_HitInfo.pHitObject->Intersect( rayRBC,
+                                                                                                   hitInfoRBC );
 
-                            if( hitted )
-                                cRBC = CCOLORRGB( shadeHit( bgColorY, rayRBC, hitInfoRBC, false, 0, false ) );
-                        }
+                                if( hitted )
+                                    cRBC = CCOLORRGB( shadeHit( bgColorY, rayRBC, hitInfoRBC, false, 0, false ) );
+                            }
 
 
-                        // Set pixel colors
-                        // /////////////////////////////////////////////////////////////
-
-                        GLubyte *ptr = &ptrPBO[ (4 * x + m_blockPositionsFast[iBlock].x +
-                                                 m_realBufferSize.x *
-                                                 (m_blockPositionsFast[iBlock].y + 4 * y)) * 4 ];
-                        SetPixel( ptr +  0, cLT );
-                        SetPixel( ptr +  4, BlendColor( cLT, cLRT, cLTC ) );
-                        SetPixel( ptr +  8, cLRT );
-                        SetPixel( ptr + 12, BlendColor( cLRT, cRT, cRTC ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, BlendColor( cLT , cLTB, cLTC ) );
-                        SetPixel( ptr +  4, BlendColor( cLTC, BlendColor( cLT , cC ) ) );
-                        SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRT, cLTC, cRTC ) ) );
-                        SetPixel( ptr + 12, BlendColor( cRTC, BlendColor( cRT , cC ) ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, cLTB );
-                        SetPixel( ptr +  4, BlendColor( cC, BlendColor( cLTB, cLTC, cLBC ) ) );
-                        SetPixel( ptr +  8, cC );
-                        SetPixel( ptr + 12, BlendColor( cC, BlendColor( cRTB, cRTC, cRBC ) ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, BlendColor( cLB , cLTB, cLBC ) );
-                        SetPixel( ptr +  4, BlendColor( cLBC, BlendColor( cLB , cC ) ) );
-                        SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRB, cLBC, cRBC ) ) );
-                        SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
+                            // Set pixel colors
+                            // /////////////////////////////////////////////////////////////
+
+                            GLubyte *ptr = &ptrPBO[ (4 * x + m_blockPositionsFast[iBlock].x +
+                                                     m_realBufferSize.x *
+                                                     (m_blockPositionsFast[iBlock].y + 4 * y)) * 4 ];
+                            SetPixel( ptr +  0, cLT );
+                            SetPixel( ptr +  4, BlendColor( cLT, cLRT, cLTC ) );
+                            SetPixel( ptr +  8, cLRT );
+                            SetPixel( ptr + 12, BlendColor( cLRT, cRT, cRTC ) );
+
+                            ptr += m_realBufferSize.x * 4;
+                            SetPixel( ptr +  0, BlendColor( cLT , cLTB, cLTC ) );
+                            SetPixel( ptr +  4, BlendColor( cLTC, BlendColor( cLT , cC ) ) );
+                            SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRT, cLTC, cRTC ) ) );
+                            SetPixel( ptr + 12, BlendColor( cRTC, BlendColor( cRT , cC ) ) );
+
+                            ptr += m_realBufferSize.x * 4;
+                            SetPixel( ptr +  0, cLTB );
+                            SetPixel( ptr +  4, BlendColor( cC, BlendColor( cLTB, cLTC, cLBC ) ) );
+                            SetPixel( ptr +  8, cC );
+                            SetPixel( ptr + 12, BlendColor( cC, BlendColor( cRTB, cRTC, cRBC ) ) );
+
+                            ptr += m_realBufferSize.x * 4;
+                            SetPixel( ptr +  0, BlendColor( cLB , cLTB, cLBC ) );
+                            SetPixel( ptr +  4, BlendColor( cLBC, BlendColor( cLB , cC ) ) );
+                            SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRB, cLBC, cRBC ) ) );
+                            SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
+                        }
                     }
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            },
+            parallelThreadCount );
 }
 
 
@@ -2034,7 +2198,7 @@ void C3D_RENDER_RAYTRACING::initializeNewWindowSize()
 
 void C3D_RENDER_RAYTRACING::opengl_init_pbo()
 {
-    if( GLEW_ARB_pixel_buffer_object )
+    if( !m_offscreen && GLEW_ARB_pixel_buffer_object )
     {
         m_opengl_support_vertex_buffer_object = true;
 
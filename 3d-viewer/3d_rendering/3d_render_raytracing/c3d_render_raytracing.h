@@ -41,6 +41,8 @@
 
 #include <map>
 
+class wxImage;
+
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 
@@ -50,6 +52,7 @@ typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
+    RT_RENDER_STATE_REFINE,
     RT_RENDER_STATE_POST_PROCESS_SHADE,
     RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH,
     RT_RENDER_STATE_FINISH,
@@ -68,6 +71,17 @@ public:
     bool Redraw( bool aIsMoving, REPORTER* aStatusTextReporter,
             REPORTER* aWarningTextReporter ) override;
 
+    /**
+     * @brief RenderOffscreen - render the full quality view into client memory, without a
+     * window nor a gl context. It returns once the refinement and the post processing are
+     * done, and the renderer is then only used offscreen.
+     * @param aSize: the size of the image, the camera shall be set to the same size
+     * @param aImage: receives the image
+     * @return false if aSize is empty
+     */
+    bool RenderOffscreen( const wxSize &aSize, wxImage &aImage, REPORTER* aStatusTextReporter,
+                          REPORTER* aWarningTextReporter );
+
     int GetWaitForEditingTimeOut() override;
 
 private:
@@ -79,9 +93,10 @@ private:
 
     void restart_render_state();
     void rt_render_tracing( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
+    bool rt_start_refinement();
     void rt_render_post_process_shade( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
     void rt_render_post_process_blur_finish( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
-    void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock );
+    void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock, bool aAntiAliasing );
     void rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor, bool applyColorSpaceConversion );
 
     void rt_shades_packet( const SFVEC3F *bgColorY,
@@ -134,6 +149,9 @@ private:
     /// Save the number of blocks progress of the render
     size_t m_nrBlocksRenderProgress;
 
+    /// True when the PBO holds a fast preview of the current view
+    bool m_previewIsUpToDate;
+
     CPOSTSHADER_SSAO m_postshader_ssao;
 
     CLIGHTCONTAINER m_lights;
@@ -141,6 +159,7 @@ private:
     CDIRECTIONALLIGHT *m_camera_light;
 
     bool m_opengl_support_vertex_buffer_object;
+    bool m_offscreen;               ///< rendering without gl context, see RenderOffscreen()
     GLuint m_pboId;
     GLuint m_pboDataSize;
 
@@ -168,6 +187,12 @@ private:
     /// this flags if a position was already processed (cleared each new render)
     std::vector< int > m_blockPositionsWasProcessed;
 
+    /// the largest contrast between neighbour pixels of each block, on the first pass
+    std::vector< float > m_blockContrast;
+
+    /// the blocks to anti-alias on the refinement pass, highest contrast first
+    std::vector< size_t > m_blocksToRefine;
+
     /// this encodes the Morton code positions (on fast preview mode)
     std::vector< SFVEC2UI > m_blockPositionsFast;
 
@@ -30,29 +30,40 @@
 
 #include "cfrustum.h"
 
-// !TODO: optimize wih SSE
-//#if(GLM_ARCH != GLM_ARCH_PURE)
-#if 0
-#error not implemented
-#else
-
-
+#include <algorithm>
+#include <cfloat>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define CFRUSTUM_SSE2
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#include <arm_neon.h>
+#define CFRUSTUM_NEON
 #endif
 
+
 void CFRUSTUM::GenerateFrustum( const RAY &topLeft,
                                 const RAY &topRight,
                                 const RAY &bottomLeft,
                                 const RAY &bottomRight )
 {
-    m_point[0] = topLeft.m_Origin;
-    m_point[1] = topRight.m_Origin;
-    m_point[2] = bottomLeft.m_Origin;
-    m_point[3] = topLeft.m_Origin;
-
-    m_normals[0] = glm::cross( topRight.m_Dir,    topLeft.m_Dir );              // TOP
-    m_normals[1] = glm::cross( bottomRight.m_Dir, topRight.m_Dir );             // RIGHT
-    m_normals[2] = glm::cross( bottomLeft.m_Dir,  bottomRight.m_Dir );          // BOTTOM
-    m_normals[3] = glm::cross( topLeft.m_Dir,     bottomLeft.m_Dir );           // LEFT
+    const SFVEC3F point[4] = { topLeft.m_Origin,
+                               topRight.m_Origin,
+                               bottomLeft.m_Origin,
+                               topLeft.m_Origin };
+
+    const SFVEC3F normals[4] = { glm::cross( topRight.m_Dir,    topLeft.m_Dir ),       // TOP
+                                 glm::cross( bottomRight.m_Dir, topRight.m_Dir ),      // RIGHT
+                                 glm::cross( bottomLeft.m_Dir,  bottomRight.m_Dir ),   // BOTTOM
+                                 glm::cross( topLeft.m_Dir,     bottomLeft.m_Dir ) };  // LEFT
+
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+        m_normalX[i] = normals[i].x;
+        m_normalY[i] = normals[i].y;
+        m_normalZ[i] = normals[i].z;
+        m_distance[i] = glm::dot( point[i], normals[i] ) - FLT_EPSILON;
+    }
 }
 
 
@@ -62,42 +73,52 @@ void CFRUSTUM::GenerateFrustum( const RAY &topLeft,
 // by Nathan Slobody and Adam Wright
 // The frustum test is not exllude all the boxes,
 // when a box is behind and if it is intersecting the planes it will not be discardly but should.
+//
+// A box is outside of the frustum when all its corners are on the wrong side of a plane.
+// Instead of testing the eight corners, only the one the farthest along the normal of the
+// plane is, which picks the min or the max of the box on each axis. The four planes are
+// tested at once.
 bool CFRUSTUM::Intersect( const CBBOX &aBBox ) const
 {
-    const SFVEC3F box[8] = { aBBox.Min(),
-                             aBBox.Max(),
-                             SFVEC3F(aBBox.Min().x, aBBox.Min().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Min().x, aBBox.Max().y, aBBox.Min().z),
-                             SFVEC3F(aBBox.Min().x, aBBox.Max().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Min().y, aBBox.Min().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Min().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Max().y, aBBox.Min().z) };
-
-    // test each plane of frustum individually; if the point is on the wrong
-    // side of the plane, the box is outside the frustum and we can exit
-    int out_side = 0;
-
+    const SFVEC3F &bmin = aBBox.Min();
+    const SFVEC3F &bmax = aBBox.Max();
+
+#if defined( CFRUSTUM_SSE2 )
+    const __m128 nx = _mm_load_ps( m_normalX );
+    const __m128 ny = _mm_load_ps( m_normalY );
+    const __m128 nz = _mm_load_ps( m_normalZ );
+
+    const __m128 farthest = _mm_add_ps(
+            _mm_add_ps( _mm_max_ps( _mm_mul_ps( nx, _mm_set1_ps( bmin.x ) ),
+                                    _mm_mul_ps( nx, _mm_set1_ps( bmax.x ) ) ),
+                        _mm_max_ps( _mm_mul_ps( ny, _mm_set1_ps( bmin.y ) ),
+                                    _mm_mul_ps( ny, _mm_set1_ps( bmax.y ) ) ) ),
+            _mm_max_ps( _mm_mul_ps( nz, _mm_set1_ps( bmin.z ) ),
+                        _mm_mul_ps( nz, _mm_set1_ps( bmax.z ) ) ) );
+
+    return _mm_movemask_ps( _mm_cmpgt_ps( farthest, _mm_load_ps( m_distance ) ) ) == 0xF;
+#elif defined( CFRUSTUM_NEON )
+    const float32x4_t nx = vld1q_f32( m_normalX );
+    const float32x4_t ny = vld1q_f32( m_normalY );
+    const float32x4_t nz = vld1q_f32( m_normalZ );
+
+    const float32x4_t farthest = vaddq_f32(
+            vaddq_f32( vmaxq_f32( vmulq_n_f32( nx, bmin.x ), vmulq_n_f32( nx, bmax.x ) ),
+                       vmaxq_f32( vmulq_n_f32( ny, bmin.y ), vmulq_n_f32( ny, bmax.y ) ) ),
+            vmaxq_f32( vmulq_n_f32( nz, bmin.z ), vmulq_n_f32( nz, bmax.z ) ) );
+
+    return vminvq_u32( vcgtq_f32( farthest, vld1q_f32( m_distance ) ) ) != 0;
+#else
     for( unsigned int i = 0; i < 4; ++i )
     {
-        const SFVEC3F &pointPlane  = m_point[i];
-        const SFVEC3F &normalPlane = m_normals[i];
-
-        for( unsigned int j = 0; j < 8; ++j )
-        {
-            const SFVEC3F OP = pointPlane - box[j];
-            const float dot = glm::dot( OP, normalPlane );
+        const float farthest = std::max( m_normalX[i] * bmin.x, m_normalX[i] * bmax.x )
+                               + std::max( m_normalY[i] * bmin.y, m_normalY[i] * bmax.y )
+                               + std::max( m_normalZ[i] * bmin.z, m_normalZ[i] * bmax.z );
 
-            if( dot < FLT_EPSILON )
-            {
-                out_side++;
-
-                break;
-            }
-        }
+        if( !( farthest > m_distance[i] ) )
+            return false;
     }
 
-    if( out_side == 4 )
-        return true;
-
-    return false;
+    return true;
+#endif
 }
@@ -33,11 +33,6 @@
 #include "shapes3D/cbbox.h"
 #include "ray.h"
 
-// !TODO: optimize wih SSE
-//#if(GLM_ARCH != GLM_ARCH_PURE)
-#if 0
-#error not implemented
-#else
 struct CFRUSTUM
 {
 
@@ -62,10 +57,12 @@ public:
     bool Intersect( const CBBOX &aBBox ) const;
 
 private:
-        SFVEC3F m_normals[4];
-        SFVEC3F m_point[4];
+    // The four planes in structure of arrays layout, to be tested together
+    alignas( 16 ) float m_normalX[4];
+    alignas( 16 ) float m_normalY[4];
+    alignas( 16 ) float m_normalZ[4];
+    alignas( 16 ) float m_distance[4];  ///< dot( point, normal ) - FLT_EPSILON
 };
-#endif
 
 
 #endif // _CFRUSTUM_H_
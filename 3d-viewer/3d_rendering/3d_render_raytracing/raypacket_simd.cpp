@@ -0,0 +1,623 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.cpp
+ * @brief Implements the SIMD kernels of the ray packets.
+ *
+ * The box test is the slab test of "An Efficient and Robust Ray-Box Intersection Algorithm"
+ * by Amy Williams et al., with the far distance scaled up as in PBRT so that a ray grazing a
+ * face is not missed. The triangle test is the one of CTRIANGLE::Intersect, done with the
+ * same operations in the same order.
+ */
+
+#include "raypacket_simd.h"
+
+#include <cfloat>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+    #if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+        #define RAYPACKET_SSE2
+    #endif
+
+    #define RAYPACKET_AVX2
+    #include <immintrin.h>
+
+    #if defined( _MSC_VER ) && !defined( __clang__ )
+        #include <intrin.h>
+    #endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+    #define RAYPACKET_NEON
+    #include <arm_neon.h>
+#endif
+
+#if !defined( RAYPACKET_SSE2 ) && !defined( RAYPACKET_NEON )
+    #define RAYPACKET_SCALAR
+#endif
+
+// The AVX2 kernels are built whatever the compiler flags, and only run on a CPU which has it
+#if defined( __GNUC__ ) || defined( __clang__ )
+    #define RAYPACKET_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+    #define RAYPACKET_TARGET_AVX2
+#endif
+
+
+/// Scales up the far distance of the slab test by twice the rounding error bound of its
+/// computation
+static const float FAR_SCALE = 1.0f + 6.0f * FLT_EPSILON;
+
+
+RAYPACKET_SOA::RAYPACKET_SOA( const RAYPACKET &aRayPacket,
+                              const HITINFO_PACKET *aHitInfoPacket )
+{
+    m_Packet = &aRayPacket;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const RAY &ray = aRayPacket.m_ray[i];
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            m_Origin[axis][i] = ray.m_Origin[axis];
+            m_Dir[axis][i]    = ray.m_Dir[axis];
+            m_InvDir[axis][i] = ray.m_InvDir[axis];
+        }
+
+        m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+    }
+}
+
+
+void RAYPACKET_SOA::UpdateHits( uint64_t aMask, const HITINFO_PACKET *aHitInfoPacket )
+{
+    while( aMask )
+    {
+        const unsigned int i = RAYPACKET_FirstRay( aMask );
+
+        m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+        aMask &= aMask - 1;
+    }
+}
+
+
+/*
+ * Scalar kernels, one ray at a time
+ */
+
+#ifdef RAYPACKET_SCALAR
+
+static uint64_t intersectBBoxScalar( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                     unsigned int aFirst )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        float hitT;
+
+        if( aBBox.Intersect( aPacket.m_Packet->m_ray[i], &hitT ) )
+            if( hitT < aPacket.m_tHit[i] )
+                mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+
+static uint64_t intersectTriangleScalar( const RAYPACKET_SOA &aPacket,
+                                         const RAYPACKET_TRIANGLE &aTri,
+                                         unsigned int aFirst, unsigned int aLast,
+                                         float *aT, float *aU, float *aV )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+    {
+        const float dk  = aPacket.m_Dir[aTri.m_k][i];
+        const float dku = aPacket.m_Dir[aTri.m_ku][i];
+        const float dkv = aPacket.m_Dir[aTri.m_kv][i];
+        const float ok  = aPacket.m_Origin[aTri.m_k][i];
+        const float oku = aPacket.m_Origin[aTri.m_ku][i];
+        const float okv = aPacket.m_Origin[aTri.m_kv][i];
+
+        const float lnd = 1.0f / ( dk + aTri.m_nu * dku + aTri.m_nv * dkv );
+        const float t = ( aTri.m_nd - ok - aTri.m_nu * oku - aTri.m_nv * okv ) * lnd;
+
+        if( !( ( aPacket.m_tHit[i] > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = oku + t * dku - aTri.m_au;
+        const float hv = okv + t * dkv - aTri.m_av;
+        const float beta = hv * aTri.m_bnu + hu * aTri.m_bnv;
+        const float gamma = hu * aTri.m_cnu + hv * aTri.m_cnv;
+
+        if( ( beta < 0.0f ) || ( gamma < 0.0f ) || ( ( beta + gamma ) > 1.0f ) )
+            continue;
+
+        const float dot = aPacket.m_Dir[0][i] * aTri.m_n.x + aPacket.m_Dir[1][i] * aTri.m_n.y
+                          + aPacket.m_Dir[2][i] * aTri.m_n.z;
+
+        if( dot > 0.0f )
+            continue;
+
+        aT[i] = t;
+        aU[i] = beta;
+        aV[i] = gamma;
+        mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+#endif // RAYPACKET_SCALAR
+
+
+/*
+ * AVX2 kernels, 8 rays at a time
+ */
+
+#ifdef RAYPACKET_AVX2
+
+RAYPACKET_TARGET_AVX2
+static uint64_t intersectBBoxAVX2( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                   unsigned int aFirst )
+{
+    const __m256 farScale = _mm256_set1_ps( FAR_SCALE );
+    const __m256 bmin[3] = { _mm256_set1_ps( aBBox.Min().x ), _mm256_set1_ps( aBBox.Min().y ),
+                             _mm256_set1_ps( aBBox.Min().z ) };
+    const __m256 bmax[3] = { _mm256_set1_ps( aBBox.Max().x ), _mm256_set1_ps( aBBox.Max().y ),
+                             _mm256_set1_ps( aBBox.Max().z ) };
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+    {
+        __m256 tNear = _mm256_setzero_ps();
+        __m256 tFar = _mm256_load_ps( &aPacket.m_tHit[i] );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m256 org = _mm256_load_ps( &aPacket.m_Origin[axis][i] );
+            const __m256 inv = _mm256_load_ps( &aPacket.m_InvDir[axis][i] );
+            const __m256 t0 = _mm256_mul_ps( _mm256_sub_ps( bmin[axis], org ), inv );
+            const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( bmax[axis], org ), inv );
+
+            // A ray parallel to an axis and in the plane of a face gives a NaN, as 0 * inf.
+            // min and max return their second operand then, so that the NaN never reaches
+            // the interval: such a grazing ray may be missed, but no other one
+            tNear = _mm256_max_ps( _mm256_min_ps( t0, t1 ), tNear );
+            tFar = _mm256_min_ps( _mm256_mul_ps( _mm256_max_ps( t0, t1 ), farScale ), tFar );
+        }
+
+        const int hits = _mm256_movemask_ps( _mm256_cmp_ps( tNear, tFar, _CMP_LE_OQ ) );
+
+        mask |= uint64_t( hits ) << i;
+    }
+
+    return mask & ( ~uint64_t( 0 ) << aFirst );
+}
+
+
+RAYPACKET_TARGET_AVX2
+static uint64_t intersectTriangleAVX2( const RAYPACKET_SOA &aPacket,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       unsigned int aFirst, unsigned int aLast,
+                                       float *aT, float *aU, float *aV )
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    const __m256 nu = _mm256_set1_ps( aTri.m_nu );
+    const __m256 nv = _mm256_set1_ps( aTri.m_nv );
+    const __m256 nd = _mm256_set1_ps( aTri.m_nd );
+    const __m256 au = _mm256_set1_ps( aTri.m_au );
+    const __m256 av = _mm256_set1_ps( aTri.m_av );
+    const __m256 bnu = _mm256_set1_ps( aTri.m_bnu );
+    const __m256 bnv = _mm256_set1_ps( aTri.m_bnv );
+    const __m256 cnu = _mm256_set1_ps( aTri.m_cnu );
+    const __m256 cnv = _mm256_set1_ps( aTri.m_cnv );
+    const __m256 nx = _mm256_set1_ps( aTri.m_n.x );
+    const __m256 ny = _mm256_set1_ps( aTri.m_n.y );
+    const __m256 nz = _mm256_set1_ps( aTri.m_n.z );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aLast; i += 8 )
+    {
+        const __m256 dk  = _mm256_load_ps( &aPacket.m_Dir[aTri.m_k][i] );
+        const __m256 dku = _mm256_load_ps( &aPacket.m_Dir[aTri.m_ku][i] );
+        const __m256 dkv = _mm256_load_ps( &aPacket.m_Dir[aTri.m_kv][i] );
+        const __m256 ok  = _mm256_load_ps( &aPacket.m_Origin[aTri.m_k][i] );
+        const __m256 oku = _mm256_load_ps( &aPacket.m_Origin[aTri.m_ku][i] );
+        const __m256 okv = _mm256_load_ps( &aPacket.m_Origin[aTri.m_kv][i] );
+
+        const __m256 lnd = _mm256_div_ps( one, _mm256_add_ps( _mm256_add_ps( dk,
+                                                              _mm256_mul_ps( nu, dku ) ),
+                                                              _mm256_mul_ps( nv, dkv ) ) );
+        const __m256 t = _mm256_mul_ps( _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, ok ),
+                                                                      _mm256_mul_ps( nu, oku ) ),
+                                                       _mm256_mul_ps( nv, okv ) ),
+                                        lnd );
+
+        __m256 valid = _mm256_and_ps(
+                _mm256_cmp_ps( _mm256_load_ps( &aPacket.m_tHit[i] ), t, _CMP_GT_OQ ),
+                _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( oku, _mm256_mul_ps( t, dku ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( okv, _mm256_mul_ps( t, dkv ) ), av );
+        const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( beta, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( gamma, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), one,
+                                                     _CMP_NGT_UQ ) );
+
+        const __m256 dot = _mm256_add_ps(
+                _mm256_add_ps( _mm256_mul_ps( _mm256_load_ps( &aPacket.m_Dir[0][i] ), nx ),
+                               _mm256_mul_ps( _mm256_load_ps( &aPacket.m_Dir[1][i] ), ny ) ),
+                _mm256_mul_ps( _mm256_load_ps( &aPacket.m_Dir[2][i] ), nz ) );
+
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( dot, zero, _CMP_NGT_UQ ) );
+
+        _mm256_storeu_ps( &aT[i], t );
+        _mm256_storeu_ps( &aU[i], beta );
+        _mm256_storeu_ps( &aV[i], gamma );
+
+        mask |= uint64_t( _mm256_movemask_ps( valid ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+#endif // RAYPACKET_AVX2
+
+
+/*
+ * SSE2 kernels, 4 rays at a time
+ */
+
+#ifdef RAYPACKET_SSE2
+
+static uint64_t intersectBBoxSSE2( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                   unsigned int aFirst )
+{
+    const __m128 farScale = _mm_set1_ps( FAR_SCALE );
+    const __m128 bmin[3] = { _mm_set1_ps( aBBox.Min().x ), _mm_set1_ps( aBBox.Min().y ),
+                             _mm_set1_ps( aBBox.Min().z ) };
+    const __m128 bmax[3] = { _mm_set1_ps( aBBox.Max().x ), _mm_set1_ps( aBBox.Max().y ),
+                             _mm_set1_ps( aBBox.Max().z ) };
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        __m128 tNear = _mm_setzero_ps();
+        __m128 tFar = _mm_load_ps( &aPacket.m_tHit[i] );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m128 org = _mm_load_ps( &aPacket.m_Origin[axis][i] );
+            const __m128 inv = _mm_load_ps( &aPacket.m_InvDir[axis][i] );
+            const __m128 t0 = _mm_mul_ps( _mm_sub_ps( bmin[axis], org ), inv );
+            const __m128 t1 = _mm_mul_ps( _mm_sub_ps( bmax[axis], org ), inv );
+
+            // See intersectBBoxAVX2 for the NaN handling
+            tNear = _mm_max_ps( _mm_min_ps( t0, t1 ), tNear );
+            tFar = _mm_min_ps( _mm_mul_ps( _mm_max_ps( t0, t1 ), farScale ), tFar );
+        }
+
+        mask |= uint64_t( _mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) ) ) << i;
+    }
+
+    return mask & ( ~uint64_t( 0 ) << aFirst );
+}
+
+
+static uint64_t intersectTriangleSSE2( const RAYPACKET_SOA &aPacket,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       unsigned int aFirst, unsigned int aLast,
+                                       float *aT, float *aU, float *aV )
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+    const __m128 nu = _mm_set1_ps( aTri.m_nu );
+    const __m128 nv = _mm_set1_ps( aTri.m_nv );
+    const __m128 nd = _mm_set1_ps( aTri.m_nd );
+    const __m128 au = _mm_set1_ps( aTri.m_au );
+    const __m128 av = _mm_set1_ps( aTri.m_av );
+    const __m128 bnu = _mm_set1_ps( aTri.m_bnu );
+    const __m128 bnv = _mm_set1_ps( aTri.m_bnv );
+    const __m128 cnu = _mm_set1_ps( aTri.m_cnu );
+    const __m128 cnv = _mm_set1_ps( aTri.m_cnv );
+    const __m128 nx = _mm_set1_ps( aTri.m_n.x );
+    const __m128 ny = _mm_set1_ps( aTri.m_n.y );
+    const __m128 nz = _mm_set1_ps( aTri.m_n.z );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const __m128 dk  = _mm_load_ps( &aPacket.m_Dir[aTri.m_k][i] );
+        const __m128 dku = _mm_load_ps( &aPacket.m_Dir[aTri.m_ku][i] );
+        const __m128 dkv = _mm_load_ps( &aPacket.m_Dir[aTri.m_kv][i] );
+        const __m128 ok  = _mm_load_ps( &aPacket.m_Origin[aTri.m_k][i] );
+        const __m128 oku = _mm_load_ps( &aPacket.m_Origin[aTri.m_ku][i] );
+        const __m128 okv = _mm_load_ps( &aPacket.m_Origin[aTri.m_kv][i] );
+
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( dk, _mm_mul_ps( nu, dku ) ),
+                                                        _mm_mul_ps( nv, dkv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, ok ),
+                                                             _mm_mul_ps( nu, oku ) ),
+                                                 _mm_mul_ps( nv, okv ) ),
+                                     lnd );
+
+        __m128 valid = _mm_and_ps( _mm_cmpgt_ps( _mm_load_ps( &aPacket.m_tHit[i] ), t ),
+                                   _mm_cmpgt_ps( t, zero ) );
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( oku, _mm_mul_ps( t, dku ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( okv, _mm_mul_ps( t, dkv ) ), av );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( beta, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( gamma, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( _mm_add_ps( beta, gamma ), one ) );
+
+        const __m128 dot = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( _mm_load_ps( &aPacket.m_Dir[0][i] ), nx ),
+                            _mm_mul_ps( _mm_load_ps( &aPacket.m_Dir[1][i] ), ny ) ),
+                _mm_mul_ps( _mm_load_ps( &aPacket.m_Dir[2][i] ), nz ) );
+
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( dot, zero ) );
+
+        _mm_storeu_ps( &aT[i], t );
+        _mm_storeu_ps( &aU[i], beta );
+        _mm_storeu_ps( &aV[i], gamma );
+
+        mask |= uint64_t( _mm_movemask_ps( valid ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+#endif // RAYPACKET_SSE2
+
+
+/*
+ * NEON kernels, 4 rays at a time
+ */
+
+#ifdef RAYPACKET_NEON
+
+static inline uint64_t neonMovemask( uint32x4_t aLanes )
+{
+    const uint32_t bits[4] = { 1, 2, 4, 8 };
+
+    return vaddvq_u32( vandq_u32( aLanes, vld1q_u32( bits ) ) );
+}
+
+
+static uint64_t intersectBBoxNEON( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                   unsigned int aFirst )
+{
+    const float32x4_t farScale = vdupq_n_f32( FAR_SCALE );
+    const float32x4_t bmin[3] = { vdupq_n_f32( aBBox.Min().x ), vdupq_n_f32( aBBox.Min().y ),
+                                  vdupq_n_f32( aBBox.Min().z ) };
+    const float32x4_t bmax[3] = { vdupq_n_f32( aBBox.Max().x ), vdupq_n_f32( aBBox.Max().y ),
+                                  vdupq_n_f32( aBBox.Max().z ) };
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        float32x4_t tNear = vdupq_n_f32( 0.0f );
+        float32x4_t tFar = vld1q_f32( &aPacket.m_tHit[i] );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const float32x4_t org = vld1q_f32( &aPacket.m_Origin[axis][i] );
+            const float32x4_t inv = vld1q_f32( &aPacket.m_InvDir[axis][i] );
+            const float32x4_t t0 = vmulq_f32( vsubq_f32( bmin[axis], org ), inv );
+            const float32x4_t t1 = vmulq_f32( vsubq_f32( bmax[axis], org ), inv );
+
+            // minnm and maxnm return the number when one of their operands is NaN, see
+            // intersectBBoxAVX2
+            tNear = vmaxnmq_f32( vminnmq_f32( t0, t1 ), tNear );
+            tFar = vminnmq_f32( vmulq_f32( vmaxnmq_f32( t0, t1 ), farScale ), tFar );
+        }
+
+        mask |= neonMovemask( vcleq_f32( tNear, tFar ) ) << i;
+    }
+
+    return mask & ( ~uint64_t( 0 ) << aFirst );
+}
+
+
+static uint64_t intersectTriangleNEON( const RAYPACKET_SOA &aPacket,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       unsigned int aFirst, unsigned int aLast,
+                                       float *aT, float *aU, float *aV )
+{
+    const float32x4_t zero = vdupq_n_f32( 0.0f );
+    const float32x4_t one = vdupq_n_f32( 1.0f );
+    const float32x4_t nu = vdupq_n_f32( aTri.m_nu );
+    const float32x4_t nv = vdupq_n_f32( aTri.m_nv );
+    const float32x4_t nd = vdupq_n_f32( aTri.m_nd );
+    const float32x4_t au = vdupq_n_f32( aTri.m_au );
+    const float32x4_t av = vdupq_n_f32( aTri.m_av );
+    const float32x4_t bnu = vdupq_n_f32( aTri.m_bnu );
+    const float32x4_t bnv = vdupq_n_f32( aTri.m_bnv );
+    const float32x4_t cnu = vdupq_n_f32( aTri.m_cnu );
+    const float32x4_t cnv = vdupq_n_f32( aTri.m_cnv );
+    const float32x4_t nx = vdupq_n_f32( aTri.m_n.x );
+    const float32x4_t ny = vdupq_n_f32( aTri.m_n.y );
+    const float32x4_t nz = vdupq_n_f32( aTri.m_n.z );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const float32x4_t dk  = vld1q_f32( &aPacket.m_Dir[aTri.m_k][i] );
+        const float32x4_t dku = vld1q_f32( &aPacket.m_Dir[aTri.m_ku][i] );
+        const float32x4_t dkv = vld1q_f32( &aPacket.m_Dir[aTri.m_kv][i] );
+        const float32x4_t ok  = vld1q_f32( &aPacket.m_Origin[aTri.m_k][i] );
+        const float32x4_t oku = vld1q_f32( &aPacket.m_Origin[aTri.m_ku][i] );
+        const float32x4_t okv = vld1q_f32( &aPacket.m_Origin[aTri.m_kv][i] );
+
+        const float32x4_t lnd = vdivq_f32( one, vaddq_f32( vaddq_f32( dk, vmulq_f32( nu, dku ) ),
+                                                           vmulq_f32( nv, dkv ) ) );
+        const float32x4_t t = vmulq_f32( vsubq_f32( vsubq_f32( vsubq_f32( nd, ok ),
+                                                               vmulq_f32( nu, oku ) ),
+                                                    vmulq_f32( nv, okv ) ),
+                                         lnd );
+
+        uint32x4_t valid = vandq_u32( vcgtq_f32( vld1q_f32( &aPacket.m_tHit[i] ), t ),
+                                      vcgtq_f32( t, zero ) );
+
+        const float32x4_t hu = vsubq_f32( vaddq_f32( oku, vmulq_f32( t, dku ) ), au );
+        const float32x4_t hv = vsubq_f32( vaddq_f32( okv, vmulq_f32( t, dkv ) ), av );
+        const float32x4_t beta = vaddq_f32( vmulq_f32( hv, bnu ), vmulq_f32( hu, bnv ) );
+        const float32x4_t gamma = vaddq_f32( vmulq_f32( hu, cnu ), vmulq_f32( hv, cnv ) );
+
+        valid = vbicq_u32( valid, vcltq_f32( beta, zero ) );
+        valid = vbicq_u32( valid, vcltq_f32( gamma, zero ) );
+        valid = vbicq_u32( valid, vcgtq_f32( vaddq_f32( beta, gamma ), one ) );
+
+        const float32x4_t dot = vaddq_f32(
+                vaddq_f32( vmulq_f32( vld1q_f32( &aPacket.m_Dir[0][i] ), nx ),
+                           vmulq_f32( vld1q_f32( &aPacket.m_Dir[1][i] ), ny ) ),
+                vmulq_f32( vld1q_f32( &aPacket.m_Dir[2][i] ), nz ) );
+
+        valid = vbicq_u32( valid, vcgtq_f32( dot, zero ) );
+
+        vst1q_f32( &aT[i], t );
+        vst1q_f32( &aU[i], beta );
+        vst1q_f32( &aV[i], gamma );
+
+        mask |= neonMovemask( valid ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+#endif // RAYPACKET_NEON
+
+
+/*
+ * Selection of the kernels
+ */
+
+struct RAYPACKET_KERNELS
+{
+    const char *m_name;
+
+    uint64_t ( *m_intersectBBox )( const RAYPACKET_SOA &, const CBBOX &, unsigned int );
+
+    uint64_t ( *m_intersectTriangle )( const RAYPACKET_SOA &, const RAYPACKET_TRIANGLE &,
+                                       unsigned int, unsigned int, float *, float *, float * );
+};
+
+
+#ifdef RAYPACKET_AVX2
+static bool cpuHasAvx2()
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports( "avx2" );
+#elif defined( _MSC_VER )
+    int info[4];
+
+    __cpuid( info, 0 );
+
+    if( info[0] < 7 )
+        return false;
+
+    // The OS must save the AVX registers on the context switches
+    __cpuid( info, 1 );
+
+    if( !( info[2] & ( 1 << 27 ) ) || ( _xgetbv( 0 ) & 6 ) != 6 )
+        return false;
+
+    __cpuidex( info, 7, 0 );
+
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+
+static RAYPACKET_KERNELS selectKernels()
+{
+#ifdef RAYPACKET_AVX2
+    if( cpuHasAvx2() )
+        return { "AVX2", intersectBBoxAVX2, intersectTriangleAVX2 };
+#endif
+
+#if defined( RAYPACKET_SSE2 )
+    return { "SSE2", intersectBBoxSSE2, intersectTriangleSSE2 };
+#elif defined( RAYPACKET_NEON )
+    return { "NEON", intersectBBoxNEON, intersectTriangleNEON };
+#else
+    return { "scalar", intersectBBoxScalar, intersectTriangleScalar };
+#endif
+}
+
+
+static const RAYPACKET_KERNELS &kernels()
+{
+    static const RAYPACKET_KERNELS s_kernels = selectKernels();
+
+    return s_kernels;
+}
+
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                  unsigned int aFirst )
+{
+    if( aFirst >= RAYPACKET_RAYS_PER_PACKET )
+        return 0;
+
+    return kernels().m_intersectBBox( aPacket, aBBox, aFirst );
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      float *aT, float *aU, float *aV )
+{
+    if( aFirst >= aLast )
+        return 0;
+
+    return kernels().m_intersectTriangle( aPacket, aTriangle, aFirst, aLast, aT, aU, aV );
+}
+
+
+const char *RAYPACKET_SimdName()
+{
+    return kernels().m_name;
+}
@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.h
+ * @brief SIMD kernels which test the rays of a packet several at a time.
+ *
+ * The kernels are 8 rays wide with AVX2 and 4 rays wide with SSE2 or NEON. The widest one
+ * supported by the CPU is selected at run time; without any of them, the rays are tested one
+ * by one with the scalar code.
+ */
+
+#ifndef _RAYPACKET_SIMD_H_
+#define _RAYPACKET_SIMD_H_
+
+#include <cstdint>
+
+#include "raypacket.h"
+#include "hitinfo.h"
+
+
+/// The ray masks of the kernels have one bit per ray of the packet
+static_assert( RAYPACKET_RAYS_PER_PACKET == 64, "a ray mask must hold a packet" );
+
+
+/**
+ * The rays of a packet in structure of arrays layout, with the distance of their current hit
+ */
+struct RAYPACKET_SOA
+{
+    alignas( 32 ) float m_Origin[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_Dir[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_InvDir[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    const RAYPACKET *m_Packet;
+
+    RAYPACKET_SOA( const RAYPACKET &aRayPacket, const HITINFO_PACKET *aHitInfoPacket );
+
+    /// Reloads the distance of the hits of the rays of aMask, after they have changed
+    void UpdateHits( uint64_t aMask, const HITINFO_PACKET *aHitInfoPacket );
+};
+
+
+/**
+ * The projected triangle of CTRIANGLE, as in Ingo Wald's thesis
+ */
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int m_k, m_ku, m_kv;   ///< projection axis and the two other ones
+    float m_nu, m_nv, m_nd;         ///< projected plane
+    float m_au, m_av;               ///< projected first vertex
+    float m_bnu, m_bnv;
+    float m_cnu, m_cnv;
+    SFVEC3F m_n;                    ///< face normal, to cull the back faces
+};
+
+
+/**
+ * @brief RAYPACKET_IntersectBBox - tests the rays aFirst to the last one against a box
+ * @return the mask of the rays which enter aBBox before their current hit
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket, const CBBOX &aBBox,
+                                  unsigned int aFirst );
+
+/**
+ * @brief RAYPACKET_IntersectTriangle - tests the rays aFirst to aLast - 1 against a triangle
+ * @param aT, aU, aV: receive the distance and the barycentric coordinates of the hits
+ * @return the mask of the rays which hit the front face of the triangle before their current hit
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      float *aT, float *aU, float *aV );
+
+/// @return the name of the instruction set used by the kernels
+const char *RAYPACKET_SimdName();
+
+
+/// @return the mask of the rays aFirst to aLast - 1
+inline uint64_t RAYPACKET_RangeMask( unsigned int aFirst, unsigned int aLast )
+{
+    if( aFirst >= aLast )
+        return 0;
+
+    const uint64_t upTo = ( aLast >= RAYPACKET_RAYS_PER_PACKET ) ? ~uint64_t( 0 )
+                                                                  : ( uint64_t( 1 ) << aLast ) - 1;
+
+    return upTo & ( ~uint64_t( 0 ) << aFirst );
+}
+
+
+/// @return the index of the first ray of a non empty mask
+inline unsigned int RAYPACKET_FirstRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctzll( aMask );
+#else
+    unsigned int i = 0;
+
+    while( !( aMask & 1 ) )
+    {
+        aMask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+
+/// @return the index of the last ray of a non empty mask
+inline unsigned int RAYPACKET_LastRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return 63 - __builtin_clzll( aMask );
+#else
+    unsigned int i = 63;
+
+    while( !( aMask >> i ) )
+        --i;
+
+    return i;
+#endif
+}
+
+#endif // _RAYPACKET_SIMD_H_
@@ -31,7 +31,8 @@
 #include <cstdio>
 
 
-COBJECT2D_STATS *COBJECT2D_STATS::s_instance = 0;
+// created before any thread may count the objects
+COBJECT2D_STATS *COBJECT2D_STATS::s_instance = new COBJECT2D_STATS;
 
 
 COBJECT2D::COBJECT2D( OBJECT2D_TYPE aObjType, const BOARD_ITEM &aBoardItem )
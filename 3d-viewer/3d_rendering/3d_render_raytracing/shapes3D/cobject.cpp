@@ -28,11 +28,13 @@
  */
 
 #include "cobject.h"
+#include "../raypacket_simd.h"
 #include <cstdio>
 #include <map>
 
 
-COBJECT3D_STATS *COBJECT3D_STATS::s_instance = 0;
+// created before any thread may count the objects
+COBJECT3D_STATS *COBJECT3D_STATS::s_instance = new COBJECT3D_STATS;
 
 static const CBLINN_PHONG_MATERIAL s_defaultMaterial = CBLINN_PHONG_MATERIAL();
 
@@ -44,6 +46,22 @@ COBJECT::COBJECT( OBJECT3D_TYPE aObjType )
 }
 
 
+uint64_t COBJECT::IntersectPacket( const RAYPACKET_SOA &aPacket,
+                                   unsigned int aFirst, unsigned int aLast,
+                                   HITINFO_PACKET *aHitInfoPacket ) const
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+    {
+        if( Intersect( aPacket.m_Packet->m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+            mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+
 /*
  * Lookup table for OBJECT2D_TYPE printed names
  */
@@ -30,10 +30,15 @@
 #ifndef _COBJECT_H_
 #define _COBJECT_H_
 
+#include <atomic>
+#include <cstdint>
+
 #include "cbbox.h"
 #include "../hitinfo.h"
 #include "../cmaterial.h"
 
+struct RAYPACKET_SOA;
+
 
 enum class OBJECT3D_TYPE
 {
@@ -91,6 +96,19 @@ public:
      */
     virtual bool IntersectP( const RAY &aRay, float aMaxDistance ) const = 0;
 
+    /** Functions IntersectPacket
+     * @brief IntersectPacket - intersects the rays aFirst to aLast - 1 of a packet, by default
+     * one at a time
+     * @param aPacket
+     * @param aFirst
+     * @param aLast
+     * @param aHitInfoPacket - receives the hits of the rays
+     * @return the mask of the rays which intersect the object
+     */
+    virtual uint64_t IntersectPacket( const RAYPACKET_SOA &aPacket,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      HITINFO_PACKET *aHitInfoPacket ) const;
+
     const CBBOX &GetBBox() const { return m_bbox; }
 
     const SFVEC3F &GetCentroid() const { return m_centroid; }
@@ -104,7 +122,8 @@ class COBJECT3D_STATS
 public:
     void ResetStats()
     {
-        memset( m_counter, 0, sizeof( unsigned int ) * static_cast<int>( OBJECT3D_TYPE::MAX ) );
+        for( std::atomic<unsigned int>& counter : m_counter )
+            counter = 0;
     }
 
     unsigned int GetCountOf( OBJECT3D_TYPE aObjType ) const
@@ -134,7 +153,7 @@ private:
     ~COBJECT3D_STATS(){}
 
 private:
-    unsigned int m_counter[static_cast<int>( OBJECT3D_TYPE::MAX )];
+    std::atomic<unsigned int> m_counter[static_cast<int>( OBJECT3D_TYPE::MAX )];
 
     static COBJECT3D_STATS *s_instance;
 };
@@ -32,6 +32,7 @@
 
 
 #include "ctriangle.h"
+#include "../raypacket_simd.h"
 
 
 void CTRIANGLE::pre_calc_const()
@@ -246,21 +247,66 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     if( glm::dot( D, m_n ) > 0.0f )
         return false;
 
-    aHitInfo.m_tHit = t;
-    aHitInfo.m_HitPoint = aRay.at( t );
+    setHit( aRay, t, u, v, aHitInfo );
+
+    return true;
+#undef ku
+#undef kv
+}
+
+
+uint64_t CTRIANGLE::IntersectPacket( const RAYPACKET_SOA &aPacket,
+                                     unsigned int aFirst, unsigned int aLast,
+                                     HITINFO_PACKET *aHitInfoPacket ) const
+{
+    RAYPACKET_TRIANGLE triangle;
+
+    triangle.m_k   = m_k;
+    triangle.m_ku  = s_modulo[m_k + 1];
+    triangle.m_kv  = s_modulo[m_k + 2];
+    triangle.m_nu  = m_nu;
+    triangle.m_nv  = m_nv;
+    triangle.m_nd  = m_nd;
+    triangle.m_au  = m_vertex[0][triangle.m_ku];
+    triangle.m_av  = m_vertex[0][triangle.m_kv];
+    triangle.m_bnu = m_bnu;
+    triangle.m_bnv = m_bnv;
+    triangle.m_cnu = m_cnu;
+    triangle.m_cnv = m_cnv;
+    triangle.m_n   = m_n;
+
+    float t[RAYPACKET_RAYS_PER_PACKET];
+    float u[RAYPACKET_RAYS_PER_PACKET];
+    float v[RAYPACKET_RAYS_PER_PACKET];
+
+    const uint64_t mask = RAYPACKET_IntersectTriangle( aPacket, triangle, aFirst, aLast,
+                                                       t, u, v );
+
+    for( uint64_t hits = mask; hits; hits &= hits - 1 )
+    {
+        const unsigned int i = RAYPACKET_FirstRay( hits );
+
+        setHit( aPacket.m_Packet->m_ray[i], t[i], u[i], v[i], aHitInfoPacket[i].m_HitInfo );
+    }
+
+    return mask;
+}
+
+
+void CTRIANGLE::setHit( const RAY &aRay, float aT, float aU, float aV,
+                        HITINFO &aHitInfo ) const
+{
+    aHitInfo.m_tHit = aT;
+    aHitInfo.m_HitPoint = aRay.at( aT );
 
     // interpolate vertex normals with UVW using Gouraud's shading
-    aHitInfo.m_HitNormal = glm::normalize( (1.0f - u - v) * m_normal[0] +
-                                            u * m_normal[1] +
-                                            v * m_normal[2] );
+    aHitInfo.m_HitNormal = glm::normalize( (1.0f - aU - aV) * m_normal[0] +
+                                            aU * m_normal[1] +
+                                            aV * m_normal[2] );
 
     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
     aHitInfo.pHitObject = this;
-
-    return true;
-#undef ku
-#undef kv
 }
 
 
@@ -66,12 +66,18 @@ public:
     // Imported from COBJECT
     bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
     bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
+    uint64_t IntersectPacket( const RAYPACKET_SOA &aPacket,
+                              unsigned int aFirst, unsigned int aLast,
+                              HITINFO_PACKET *aHitInfoPacket ) const override;
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
 private:
     void pre_calc_const();
 
+    /// Fills aHitInfo with the hit of aRay at the distance aT and barycentric coordinates aU, aV
+    void setHit( const RAY &aRay, float aT, float aU, float aV, HITINFO &aHitInfo ) const;
+
 private:
     SFVEC3F m_normal[3];                // 36
     SFVEC3F m_vertex[3];                // 36
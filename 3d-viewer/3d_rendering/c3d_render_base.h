@@ -75,11 +75,18 @@ public:
      */
     void ReloadRequest() { m_reloadRequested = true; }
 
+    /**
+     * @brief ReloadLayersRequest - Schedule a reload of only the given layers, after an
+     * edit of the board.  The render reloads the whole board if it cannot do it.
+     * @param aLayers: the layers of the changed items
+     */
+    void ReloadLayersRequest( const LSET& aLayers ) { m_reloadLayers |= aLayers; }
+
     /**
      * @brief IsReloadRequestPending - Query if there is a pending reload request
      * @return true if it wants to reload, false if there is no reload pending
      */
-    bool IsReloadRequestPending() const { return m_reloadRequested; }
+    bool IsReloadRequestPending() const { return m_reloadRequested || m_reloadLayers.any(); }
 
     /**
      * @brief GetWaitForEditingTimeOut - Give the interface the time (in ms)
@@ -117,6 +124,9 @@ protected:
     /// !TODO: this must be reviewed in order to flag change types
     bool m_reloadRequested;
 
+    /// the layers to reload, when the whole board is not
+    LSET m_reloadLayers;
+
     /// The window size that this camera is working.
     wxSize m_windowSize;
 
@@ -176,6 +176,13 @@ void EDA_3D_VIEWER::ReloadRequest()
 }
 
 
+void EDA_3D_VIEWER::ReloadLayersRequest( const LSET& aLayers )
+{
+    if( m_canvas )
+        m_canvas->ReloadLayersRequest( aLayers );
+}
+
+
 void EDA_3D_VIEWER::NewDisplay( bool aForceImmediateRedraw )
 {
     ReloadRequest();
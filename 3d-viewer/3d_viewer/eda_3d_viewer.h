@@ -90,6 +90,12 @@ class EDA_3D_VIEWER : public EDA_3D_BOARD_HOLDER, public KIWAY_PLAYER
      */
     void ReloadRequest();
 
+    /**
+     * Request rebuilding only the given layers of the 3D view, after an edit of the board.
+     * Like ReloadRequest(), it is executed when the 3D canvas is refreshed.
+     */
+    void ReloadLayersRequest( const LSET& aLayers );
+
     // !TODO: review this function: it need a way to tell what changed,
     // to only reload/rebuild things that have really changed
     /**
@@ -23,6 +23,7 @@
  */
 
 #include <algorithm>    // std::max
+#include <atomic>
 #include <cerrno>
 #include <cmath>
 #include <cstdio>
@@ -33,6 +34,7 @@
 
 #include <common.h>
 #include <layers_id_colors_and_visibility.h>
+#include <thread_pool.h>
 
 #include <potracelib.h>
 
@@ -270,7 +272,8 @@ void BITMAPCONV_INFO::outputDataEnd()
 }
 
 
-void BITMAPCONV_INFO::outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char* aBrdLayerName )
+void BITMAPCONV_INFO::outputOnePolygon( std::string& aOutput, SHAPE_LINE_CHAIN & aPolygon,
+                                        const char* aBrdLayerName ) const
 {
     // write one polygon to output file.
     // coordinates are expected in target unit.
@@ -289,29 +292,29 @@ void BITMAPCONV_INFO::outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char*
         offsetY = (int)( m_PixmapHeight * m_ScaleY );
         sprintf( strbuf, "newpath\n%d %d moveto\n",
                  startpoint.x, offsetY - startpoint.y );
-        m_Data += strbuf;
+        aOutput += strbuf;
         jj = 0;
         for( ii = 1; ii < aPolygon.PointCount(); ii++ )
         {
             currpoint = aPolygon.CPoint( ii );
             sprintf( strbuf, " %d %d lineto",
                      currpoint.x, offsetY - currpoint.y );
-            m_Data += strbuf;
+            aOutput += strbuf;
 
             if( jj++ > 6 )
             {
                 jj = 0;
-                m_Data += "\n";
+                aOutput += "\n";
             }
         }
 
-        m_Data += "\nclosepath fill\n";
+        aOutput += "\nclosepath fill\n";
         break;
 
     case PCBNEW_KICAD_MOD:
     {
         double width = 0.0;         // outline thickness in mm: no thickness
-        m_Data += "  (fp_poly (pts";
+        aOutput += "  (fp_poly (pts";
 
         jj = 0;
         for( ii = 0; ii < aPolygon.PointCount(); ii++ )
@@ -320,23 +323,23 @@ void BITMAPCONV_INFO::outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char*
             sprintf( strbuf, " (xy %f %f)",
                     ( currpoint.x - offsetX ) / MM2NANOMETER,
                     ( currpoint.y - offsetY ) / MM2NANOMETER );
-            m_Data += strbuf;
+            aOutput += strbuf;
 
             if( jj++ > 6 )
             {
                 jj = 0;
-                m_Data += "\n    ";
+                aOutput += "\n    ";
             }
         }
         // No need to close polygon
-        m_Data += " )";
+        aOutput += " )";
         sprintf( strbuf, "(layer %s) (width  %f)\n  )\n", aBrdLayerName, width );
-        m_Data += strbuf;
+        aOutput += strbuf;
     }
     break;
 
     case KICAD_LOGO:
-        m_Data += "  (pts";
+        aOutput += "  (pts";
         // Internal units = micron, file unit = mm
         jj = 0;
         for( ii = 0; ii < aPolygon.PointCount(); ii++ )
@@ -345,19 +348,19 @@ void BITMAPCONV_INFO::outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char*
             sprintf( strbuf, " (xy %.3f %.3f)",
                     ( currpoint.x - offsetX ) / MM2MICRON,
                     ( currpoint.y - offsetY ) / MM2MICRON );
-            m_Data += strbuf;
+            aOutput += strbuf;
 
             if( jj++ > 4 )
             {
                 jj = 0;
-                m_Data += "\n    ";
+                aOutput += "\n    ";
             }
         }
         // Close polygon
         sprintf( strbuf, " (xy %.3f %.3f) )\n",
                  ( startpoint.x - offsetX ) / MM2MICRON,
                  ( startpoint.y - offsetY ) / MM2MICRON );
-        m_Data += strbuf;
+        aOutput += strbuf;
         break;
 
     case EESCHEMA_FMT:
@@ -366,27 +369,28 @@ void BITMAPCONV_INFO::outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char*
         #define EE_LINE_THICKNESS 1
         sprintf( strbuf, "P %d 0 0 %d",
                  (int) aPolygon.PointCount() + 1, EE_LINE_THICKNESS );
-        m_Data += strbuf;
+        aOutput += strbuf;
         for( ii = 0; ii < aPolygon.PointCount(); ii++ )
         {
             currpoint = aPolygon.CPoint( ii );
             sprintf( strbuf, " %d %d",
                      currpoint.x - offsetX, currpoint.y - offsetY );
-            m_Data += strbuf;
+            aOutput += strbuf;
         }
 
         // Close polygon
         sprintf( strbuf, " %d %d",
                  startpoint.x - offsetX, startpoint.y - offsetY );
-        m_Data += strbuf;
+        aOutput += strbuf;
 
-        m_Data += " F\n";
+        aOutput += " F\n";
         break;
     }
 }
 
 
-void BITMAPCONV_INFO::createOutputData( BMP2CMP_MOD_LAYER aModLayer )
+void BITMAPCONV_INFO::convertPathGroup( potrace_path_t* aFirst, potrace_path_t* aEnd,
+                                        const char* aBrdLayerName, std::string& aOutput ) const
 {
     std::vector <potrace_dpoint_t> cornersBuffer;
 
@@ -398,26 +402,12 @@ void BITMAPCONV_INFO::createOutputData( BMP2CMP_MOD_LAYER aModLayer )
 
     potrace_dpoint_t( *c )[3];
 
-    LOCALE_IO toggle;   // Temporary switch the locale to standard C to r/w floats
-
-    // The layer name has meaning only for .kicad_mod files.
-    // For these files the header creates 2 invisible texts: value and ref
-    // (needed but not usefull) on silk screen layer
-    outputDataHeader( getBoardLayerName( MOD_LYR_FSILKS ) );
-
     bool main_outline = true;
 
     /* draw each as a polygon with no hole.
      * Bezier curves are approximated by a polyline
      */
-    potrace_path_t* paths = m_Paths;    // the list of paths
-
-    if(!m_Paths)
-    {
-        m_errors += "No path in black and white image: no outline created\n";
-    }
-
-    while( paths != NULL )
+    for( potrace_path_t* paths = aFirst; paths != aEnd; paths = paths->next )
     {
         int cnt  = paths->curve.n;
         int* tag = paths->curve.tag;
@@ -465,33 +455,88 @@ void BITMAPCONV_INFO::createOutputData( BMP2CMP_MOD_LAYER aModLayer )
         }
 
         cornersBuffer.clear();
+    }
 
-        /* at the end of a group of a positive path and its negative children, fill.
-         */
-        if( paths->next == NULL || paths->next->sign == '+' )
-        {
-            polyset_areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-            polyset_holes.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-            polyset_areas.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    /* at the end of a group of a positive path and its negative children, fill.
+     */
+    polyset_areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    polyset_holes.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    polyset_areas.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
-            // Ensure there are no self intersecting polygons
-            polyset_areas.NormalizeAreaOutlines();
+    // Ensure there are no self intersecting polygons
+    polyset_areas.NormalizeAreaOutlines();
 
-            // Convert polygon with holes to a unique polygon
-            polyset_areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    // Convert polygon with holes to a unique polygon
+    polyset_areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
-            // Output current resulting polygon(s)
-            for( int ii = 0; ii < polyset_areas.OutlineCount(); ii++ )
+    // Output current resulting polygon(s)
+    for( int ii = 0; ii < polyset_areas.OutlineCount(); ii++ )
+    {
+        SHAPE_LINE_CHAIN& poly = polyset_areas.Outline( ii );
+        outputOnePolygon( aOutput, poly, aBrdLayerName );
+    }
+}
+
+
+void BITMAPCONV_INFO::createOutputData( BMP2CMP_MOD_LAYER aModLayer )
+{
+    LOCALE_IO toggle;   // Temporary switch the locale to standard C to r/w floats
+
+    // The layer name has meaning only for .kicad_mod files.
+    // For these files the header creates 2 invisible texts: value and ref
+    // (needed but not usefull) on silk screen layer
+    outputDataHeader( getBoardLayerName( MOD_LYR_FSILKS ) );
+
+    if(!m_Paths)
+    {
+        m_errors += "No path in black and white image: no outline created\n";
+    }
+
+    // The groups of a positive path and of its negative children (its holes), from potrace.
+    // Each group is filled on its own, so the groups are converted in parallel, each one to
+    // its own buffer, and the buffers are output in the order of the paths.
+    std::vector<potrace_path_t*> groups;
+
+    for( potrace_path_t* paths = m_Paths; paths != NULL; paths = paths->next )
+    {
+        if( groups.empty() || paths->sign == '+' )
+            groups.push_back( paths );
+    }
+
+    std::vector<std::string> groupData( groups.size() );
+    std::atomic<size_t>      nextGroup( 0 );
+    const char*              layerName = getBoardLayerName( aModLayer );
+
+    auto convertGroups =
+            [&]()
             {
-                SHAPE_LINE_CHAIN& poly = polyset_areas.Outline( ii );
-                outputOnePolygon( poly, getBoardLayerName( aModLayer ));
-            }
+                for( size_t ii = nextGroup++; ii < groups.size(); ii = nextGroup++ )
+                {
+                    potrace_path_t* end = ii + 1 < groups.size() ? groups[ii + 1] : NULL;
 
-            polyset_areas.RemoveAllContours();
-            polyset_holes.RemoveAllContours();
-            main_outline = true;
-        }
-        paths = paths->next;
+                    convertPathGroup( groups[ii], end, layerName, groupData[ii] );
+                }
+            };
+
+    size_t parallelism = std::min<size_t>( groups.size(),
+                                           GetKiCadThreadPool().GetThreadCount() + 1 );
+
+    if( parallelism <= 1 )
+        convertGroups();
+    else
+        GetKiCadThreadPool().RunParallel( convertGroups, parallelism );
+
+    size_t dataSize = m_Data.size();
+
+    for( const std::string& data : groupData )
+        dataSize += data.size();
+
+    m_Data.reserve( dataSize );
+
+    for( std::string& data : groupData )
+    {
+        m_Data += data;
+        std::string().swap( data );     // free the buffer as soon as it is output
     }
 
     outputDataEnd();
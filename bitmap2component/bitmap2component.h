@@ -103,10 +103,20 @@ private:
 
     /**
      * Function outputOnePolygon
-     * write one polygon to output file.
+     * write one polygon to aOutput.
      * Polygon coordinates are expected scaled by the polygon extraction function
      */
-    void outputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char* aBrdLayerName );
+    void outputOnePolygon( std::string& aOutput, SHAPE_LINE_CHAIN & aPolygon,
+                           const char* aBrdLayerName ) const;
+
+    /**
+     * Function convertPathGroup
+     * converts a positive path and its holes, the paths from aFirst up to aEnd (excluded),
+     * to polygons written to aOutput.
+     * It only reads the conversion info, so the groups can be converted in parallel.
+     */
+    void convertPathGroup( potrace_path_t* aFirst, potrace_path_t* aEnd,
+                           const char* aBrdLayerName, std::string& aOutput ) const;
 
 };
 
@@ -87,6 +87,128 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Run the DRC tests on several threads.  The markers are merged in a fixed order, so the
+ * results are the same as a sequential run; this can be turned off to ease the debugging
+ * of the tests themselves.
+ */
+static const wxChar ParallelDRC[] = wxT( "ParallelDRC" );
+
+/**
+ * After each change of the board, test again the tracks close to the changed items and
+ * update their markers, instead of waiting for the next full DRC run.
+ */
+static const wxChar IncrementalDRC[] = wxT( "IncrementalDRC" );
+
+/**
+ * Keep the zone fills in a cache file next to the board file, keyed by the inputs of each
+ * fill, so that unchanged zones are not refilled after the board is reopened.
+ */
+static const wxChar ZoneFillCache[] = wxT( "ZoneFillCache" );
+
+/**
+ * Split the knockout subtraction of zones with many knockouts into tiles processed on
+ * several cores.
+ */
+static const wxChar TiledZoneFill[] = wxT( "TiledZoneFill" );
+
+/**
+ * After a board change, merge and split the connectivity clusters around the changed items
+ * instead of searching again all the items of the changed nets.
+ */
+static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
+
+/**
+ * Build the Delaunay triangulations of the ratsnest with a sweep on flat arrays instead of the
+ * ttl library, which allocates a node per edge.
+ */
+static const wxChar SweepRatsnestTriangulation[] = wxT( "SweepRatsnestTriangulation" );
+
+/**
+ * Write a binary snapshot of the board (tracks, zone fills and nets in flat records) next
+ * to the board file on save, and reopen the board from it while the board file is unchanged.
+ */
+static const wxChar BoardSnapshot[] = wxT( "BoardSnapshot" );
+
+/**
+ * List the footprints of a .pretty library from its file names, instead of parsing all its
+ * footprint files when the first footprint is requested.
+ */
+static const wxChar LazyFootprintCache[] = wxT( "LazyFootprintCache" );
+
+/**
+ * Load the symbol libraries of the symbol chooser on the threads of the thread pool, instead
+ * of one after the other.
+ */
+static const wxChar ParallelSymbolLibLoad[] = wxT( "ParallelSymbolLibLoad" );
+
+/**
+ * Keep the timestamps of the footprint library directories, and watch the directories with
+ * the file system watcher of the system to know when they change.  The changes made from
+ * another machine on a network share may not be reported, depending on the system.
+ */
+static const wxChar WatchLibraryDirs[] = wxT( "WatchLibraryDirs" );
+
+/**
+ * When the board is zoomed out, draw all the items of a layer at once from a group holding
+ * the whole layer, instead of one item after the other.  The groups hold a second copy of
+ * the vertices of the board.
+ */
+static const wxChar AggregateZoomedOutLayers[] = wxT( "AggregateZoomedOutLayers" );
+
+/**
+ * When some items of the view are updated, only clear and redraw the area of the screen
+ * they cover, before and after the update.  The rest of the cached layers is reused from the
+ * previous frame.
+ */
+static const wxChar PartialRedraw[] = wxT( "PartialRedraw" );
+
+/**
+ * Split the Cairo canvas in horizontal tiles and draw the items of each noncached layer in
+ * all the tiles at once, one tile per thread.  The painters of the tiles read the board
+ * items concurrently.
+ */
+static const wxChar CairoTiledRendering[] = wxT( "CairoTiledRendering" );
+
+/**
+ * Draw over the canvas the time spent in the last frame by each drawing stage, with the
+ * number of items and groups drawn and the use of the cached vertex storage.
+ */
+static const wxChar ShowFrameStats[] = wxT( "ShowFrameStats" );
+
+/**
+ * Append the same measures as ShowFrameStats to this CSV file, one line per frame.
+ */
+static const wxChar FrameTraceFile[] = wxT( "FrameTraceFile" );
+
+/**
+ * Let the interactive router walk around the obstacles clockwise and counterclockwise at
+ * the same time, and try the possible shoves of a line together, on several threads.
+ * The chosen path does not change, only the latency does.
+ */
+static const wxChar ParallelRouterCandidates[] = wxT( "ParallelRouterCandidates" );
+
+/**
+ * Append the calls made to the interactive router (start, move, fix, abort) to this file,
+ * at the end of each routing or drag operation. The qa_pcbnew_tools pns_replay utility
+ * replays them on the same board to measure the routing latency.
+ */
+static const wxChar RouterEventLog[] = wxT( "RouterEventLog" );
+
+/**
+ * Give each move of the interactive router a shove time budget adapted to the latency of the
+ * previous moves, instead of the fixed shove time limit of the router settings. The moves
+ * which ran out of budget are routed again with a larger one while the cursor is idle, up
+ * to the time limit of the settings.
+ */
+static const wxChar AnytimeRouting[] = wxT( "AnytimeRouting" );
+
+/**
+ * After a board change, rebuild in the 3D viewer only the layers of the changed items (and
+ * the holes when a copper layer changed), instead of the whole board.
+ */
+static const wxChar Incremental3DView[] = wxT( "Incremental3DView" );
+
 } // namespace KEYS
 
 
@@ -168,6 +290,23 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_EnableUsePinFunction = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_parallelDRC = true;
+    m_incrementalDRC = false;
+    m_zoneFillCache = false;
+    m_tiledZoneFill = true;
+    m_incrementalConnectivity = false;
+    m_sweepRatsnestTriangulation = false;
+    m_boardSnapshot = false;
+    m_lazyFootprintCache = false;
+    m_parallelSymbolLibLoad = true;
+    m_watchLibraryDirs = false;
+    m_aggregateZoomedOutLayers = true;
+    m_partialRedraw = true;
+    m_cairoTiledRendering = false;
+    m_showFrameStats = false;
+    m_parallelRouterCandidates = true;
+    m_anytimeRouting = true;
+    m_incremental3DView = true;
 
     loadFromConfigFile();
 }
@@ -214,6 +353,63 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelDRC,
+                                                &m_parallelDRC, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalDRC,
+                                                &m_incrementalDRC, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillCache,
+                                                &m_zoneFillCache, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::TiledZoneFill,
+                                                &m_tiledZoneFill, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalConnectivity,
+                                                &m_incrementalConnectivity, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::SweepRatsnestTriangulation,
+                                                &m_sweepRatsnestTriangulation, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::BoardSnapshot,
+                                                &m_boardSnapshot, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::LazyFootprintCache,
+                                                &m_lazyFootprintCache, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelSymbolLibLoad,
+                                                &m_parallelSymbolLibLoad, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::WatchLibraryDirs,
+                                                &m_watchLibraryDirs, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::AggregateZoomedOutLayers,
+                                                &m_aggregateZoomedOutLayers, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::PartialRedraw,
+                                                &m_partialRedraw, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CairoTiledRendering,
+                                                &m_cairoTiledRendering, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ShowFrameStats,
+                                                &m_showFrameStats, false ) );
+
+    configParams.push_back( new PARAM_CFG_FILENAME( AC_KEYS::FrameTraceFile,
+                                                    &m_frameTraceFile ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelRouterCandidates,
+                                                &m_parallelRouterCandidates, true ) );
+
+    configParams.push_back( new PARAM_CFG_FILENAME( AC_KEYS::RouterEventLog,
+                                                    &m_routerEventLogFile ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::AnytimeRouting,
+                                                &m_anytimeRouting, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::Incremental3DView,
+                                                &m_incremental3DView, true ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( auto param : configParams )
@@ -0,0 +1,169 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <background_file_writer.h>
+#include <thread_pool.h>
+#include <trace_helpers.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/log.h>
+
+#include <algorithm>
+#include <new>
+
+
+BACKGROUND_FILE_WRITER::BACKGROUND_FILE_WRITER() :
+        m_running( false ),
+        m_failed( false )
+{
+}
+
+
+BACKGROUND_FILE_WRITER::~BACKGROUND_FILE_WRITER()
+{
+    Wait();
+}
+
+
+void BACKGROUND_FILE_WRITER::Write( const wxString& aFileName, std::string aContent )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    // Only the last content of a file matters
+    auto sameFile =
+            [&]( const std::pair<wxString, std::string>& aWrite )
+            {
+                return aWrite.first == aFileName;
+            };
+
+    m_queue.erase( std::remove_if( m_queue.begin(), m_queue.end(), sameFile ), m_queue.end() );
+    m_queue.emplace_back( aFileName, std::move( aContent ) );
+
+    if( !m_running )
+    {
+        m_running = true;
+        GetKiCadThreadPool().Submit( [this]() { run(); }, TASK_PRIORITY::BACKGROUND );
+    }
+}
+
+
+bool BACKGROUND_FILE_WRITER::Wait()
+{
+    std::unique_lock<std::mutex> lock( m_lock );
+
+    m_done.wait( lock, [this]() { return !m_running; } );
+
+    bool ok = !m_failed;
+
+    m_failed = false;
+    return ok;
+}
+
+
+bool BACKGROUND_FILE_WRITER::IsBusy() const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    return m_running;
+}
+
+
+void BACKGROUND_FILE_WRITER::run()
+{
+    while( true )
+    {
+        std::pair<wxString, std::string> write;
+
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+
+            if( m_queue.empty() )
+            {
+                m_running = false;
+                m_done.notify_all();
+                return;
+            }
+
+            write = std::move( m_queue.front() );
+            m_queue.pop_front();
+        }
+
+        bool ok = false;
+
+        try
+        {
+            ok = WriteFile( write.first, write.second );
+        }
+        catch( const std::bad_alloc& )
+        {
+        }
+
+        if( !ok )
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            m_failed = true;
+        }
+    }
+}
+
+
+bool BACKGROUND_FILE_WRITER::WriteFile( const wxString& aFileName, const std::string& aContent )
+{
+    wxString tempFileName = aFileName + wxT( ".tmp" );
+    wxString error;
+
+    {
+        // No message box from a background thread: the errors are only traced
+        wxLogNull noLog;
+        wxFFile   file;
+
+        if( !file.Open( tempFileName, wxT( "wb" ) ) )
+        {
+            error = wxT( "Cannot create <" ) + tempFileName + wxT( ">" );
+        }
+        else if( file.Write( aContent.data(), aContent.size() ) != aContent.size()
+                 || !file.Close() )
+        {
+            error = wxT( "Cannot write <" ) + tempFileName + wxT( ">" );
+        }
+        else if( !wxRenameFile( tempFileName, aFileName, true ) )
+        {
+            error = wxT( "Cannot rename <" ) + tempFileName + wxT( ">" );
+        }
+
+        if( !error.IsEmpty() )
+        {
+            file.Close();
+            wxRemoveFile( tempFileName );
+        }
+    }
+
+    if( !error.IsEmpty() )
+    {
+        wxLogTrace( traceAutoSave, wxT( "%s" ), error );
+        return false;
+    }
+
+    return true;
+}
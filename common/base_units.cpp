@@ -34,6 +34,8 @@
  *       depending on the application.
  */
 
+#include <cmath>
+
 #include <base_struct.h>
 #include <base_units.h>
 #include <common.h>
@@ -520,9 +522,99 @@ wxString GetAbbreviatedUnitsLabel( EDA_UNITS aUnit, bool aUseMils, EDA_DATA_TYPE
 }
 
 
-std::string FormatInternalUnits( int aValue )
+/**
+ * @return the number of decimals of the internal units in mm, if IU_PER_MM is a power of ten
+ *         which gives at most 10 significant digits for an int, or -1.
+ */
+static constexpr int iuDecimals()
 {
-    char    buf[50];
+    double scale = 1.0;
+
+    for( int decimals = 0; decimals <= 9; decimals++, scale *= 10.0 )
+    {
+        if( IU_PER_MM == scale )
+            return decimals;
+    }
+
+    return -1;
+}
+
+
+/**
+ * Writes aValue / 10^aDecimals to aBuf without trailing zeros, which is what "%.10g" (or
+ * "%.10f" below 0.0001) prints for this exact decimal number of at most 10 digits, without
+ * going through snprintf() and the C locale.
+ * @return the length of the text, which is not null terminated.
+ */
+static int formatDecimal( char* aBuf, int aValue, int aDecimals )
+{
+    char               digits[16];
+    int                count = 0;
+    int                len = 0;
+    unsigned long long mag = aValue < 0 ? -(long long) aValue : aValue;
+
+    if( aValue == 0 )
+    {
+        aBuf[0] = '0';
+        return 1;
+    }
+
+    while( mag )
+    {
+        digits[count++] = '0' + mag % 10;
+        mag /= 10;
+    }
+
+    if( aValue < 0 )
+        aBuf[len++] = '-';
+
+    // digits[] holds the digits in reverse order; skip the trailing zeros of the fraction
+    int skip = 0;
+
+    while( skip < aDecimals && skip < count && digits[skip] == '0' )
+        skip++;
+
+    if( count <= aDecimals )
+    {
+        aBuf[len++] = '0';
+        aBuf[len++] = '.';
+
+        for( int ii = count; ii < aDecimals; ii++ )
+            aBuf[len++] = '0';
+
+        for( int ii = count - 1; ii >= skip; ii-- )
+            aBuf[len++] = digits[ii];
+
+        return len;
+    }
+
+    for( int ii = count - 1; ii >= aDecimals; ii-- )
+        aBuf[len++] = digits[ii];
+
+    if( skip < aDecimals )
+    {
+        aBuf[len++] = '.';
+
+        for( int ii = aDecimals - 1; ii >= skip; ii-- )
+            aBuf[len++] = digits[ii];
+    }
+
+    return len;
+}
+
+
+#define IU_TEXT_SIZE 20     ///< the maximal length of a formatted int in mm
+
+
+/**
+ * Writes aValue in mm to aBuf, which must hold at least IU_TEXT_SIZE chars.
+ * @return the length of the text, which is not null terminated.
+ */
+static int formatInternalUnits( char* aBuf, int aValue )
+{
+    if( iuDecimals() >= 0 )
+        return formatDecimal( aBuf, aValue, iuDecimals() );
+
     double  engUnits = aValue;
     int     len;
 
@@ -530,21 +622,45 @@ std::string FormatInternalUnits( int aValue )
 
     if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
     {
-        len = snprintf( buf, sizeof(buf), "%.10f", engUnits );
+        len = snprintf( aBuf, IU_TEXT_SIZE, "%.10f", engUnits );
 
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+        while( --len > 0 && aBuf[len] == '0' )
+            aBuf[len] = '\0';
 
-        if( buf[len] == '.' )
-            buf[len] = '\0';
+        if( aBuf[len] == '.' )
+            aBuf[len] = '\0';
         else
             ++len;
     }
     else
     {
-        len = snprintf( buf, sizeof(buf), "%.10g", engUnits );
+        len = snprintf( aBuf, IU_TEXT_SIZE, "%.10g", engUnits );
     }
 
+    return len;
+}
+
+
+/**
+ * Writes the two coordinates aX and aY in mm, separated by a space.
+ */
+static std::string formatInternalUnits( int aX, int aY )
+{
+    char    buf[2 * IU_TEXT_SIZE + 1];
+    int     len = formatInternalUnits( buf, aX );
+
+    buf[len++] = ' ';
+    len += formatInternalUnits( buf + len, aY );
+
+    return std::string( buf, len );
+}
+
+
+std::string FormatInternalUnits( int aValue )
+{
+    char    buf[IU_TEXT_SIZE];
+    int     len = formatInternalUnits( buf, aValue );
+
     return std::string( buf, len );
 }
 
@@ -554,6 +670,11 @@ std::string FormatAngle( double aAngle )
     char temp[50];
     int len;
 
+    // Angles are nearly always a whole number of 0.1 degrees.  -0 is printed as "-0".
+    if( fabs( aAngle ) < 1e9 && aAngle == (int) aAngle
+            && ( aAngle != 0.0 || !std::signbit( aAngle ) ) )
+        return std::string( temp, formatDecimal( temp, (int) aAngle, 1 ) );
+
     len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
 
     return std::string( temp, len );
@@ -562,18 +683,18 @@ std::string FormatAngle( double aAngle )
 
 std::string FormatInternalUnits( const wxPoint& aPoint )
 {
-    return FormatInternalUnits( aPoint.x ) + " " + FormatInternalUnits( aPoint.y );
+    return formatInternalUnits( aPoint.x, aPoint.y );
 }
 
 
 std::string FormatInternalUnits( const VECTOR2I& aPoint )
 {
-    return FormatInternalUnits( aPoint.x ) + " " + FormatInternalUnits( aPoint.y );
+    return formatInternalUnits( aPoint.x, aPoint.y );
 }
 
 
 std::string FormatInternalUnits( const wxSize& aSize )
 {
-    return FormatInternalUnits( aSize.GetWidth() ) + " " + FormatInternalUnits( aSize.GetHeight() );
+    return formatInternalUnits( aSize.GetWidth(), aSize.GetHeight() );
 }
 
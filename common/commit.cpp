@@ -68,6 +68,11 @@ COMMIT& COMMIT::Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType )
 
             assert( parent );
 
+            // Do not copy the parent again for each of its children, as when editing the
+            // texts of the footprints: only the first copy is kept
+            if( m_changedItems.find( parent ) != m_changedItems.end() )
+                return *this;
+
             if( parent )
                 clone = parent->Clone();
 
@@ -189,6 +194,9 @@ void COMMIT::makeEntry( EDA_ITEM* aItem, CHANGE_TYPE aType, EDA_ITEM* aCopy )
 
 COMMIT::COMMIT_LINE* COMMIT::findEntry( EDA_ITEM* aItem )
 {
+    if( m_changedItems.find( aItem ) == m_changedItems.end() )
+        return nullptr;
+
     for( COMMIT_LINE& change : m_changes )
     {
         if( change.m_item == aItem )
@@ -220,6 +228,7 @@ CHANGE_TYPE COMMIT::convert( UNDO_REDO_T aType ) const
     case UR_ROTATED:
     case UR_ROTATED_CLOCKWISE:
     case UR_FLIPPED:
+    case UR_PLACEMENT:
         return CHT_MODIFY;
     }
 }
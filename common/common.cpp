@@ -44,6 +44,9 @@ using KIGFX::COLOR4D;
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The random generator is not thread-safe, and items can be created by worker threads
+static std::mutex randomGeneratorLock;
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator nilGenerator;
@@ -52,8 +55,16 @@ static boost::uuids::nil_generator nilGenerator;
 KIID niluuid( 0 );
 
 
+static boost::uuids::uuid newRandomUuid()
+{
+    std::lock_guard<std::mutex> lock( randomGeneratorLock );
+
+    return randomGenerator();
+}
+
+
 KIID::KIID() :
-        m_uuid( randomGenerator() ),
+        m_uuid( newRandomUuid() ),
         m_cached_timestamp( 0 )
 {
 #if defined(EESCHEMA)
@@ -61,10 +72,15 @@ KIID::KIID() :
     static timestamp_t oldTimeStamp;
     timestamp_t        newTimeStamp = time( NULL );
 
-    if( newTimeStamp <= oldTimeStamp )
-        newTimeStamp = oldTimeStamp + 1;
+    {
+        // The sheet files are loaded by worker threads, and the timestamps must stay unique
+        std::lock_guard<std::mutex> lock( randomGeneratorLock );
 
-    oldTimeStamp = newTimeStamp;
+        if( newTimeStamp <= oldTimeStamp )
+            newTimeStamp = oldTimeStamp + 1;
+
+        oldTimeStamp = newTimeStamp;
+    }
 
     *this = KIID( wxString::Format( "%8.8X", newTimeStamp ) );
 #endif
@@ -109,7 +125,7 @@ KIID::KIID( const wxString& aString ) :
         {
             // Failed to parse string representation; best we can do is assign a new
             // random one.
-            m_uuid = randomGenerator();
+            m_uuid = newRandomUuid();
         }
     }
 }
@@ -216,10 +232,17 @@ void KiAssertFilter( const wxString &file, int line,
 #endif
 #endif
 
-std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
-LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
+unsigned int LOCALE_IO::m_c_count = 0;
+std::mutex   LOCALE_IO::m_lock;
+std::string  LOCALE_IO::m_user_locale;
+wxLocale*    LOCALE_IO::m_wxLocale = nullptr;
+
+
+LOCALE_IO::LOCALE_IO()
 {
-    // use thread safe, atomic operation
+    // another thread must not go on before the locale is switched
+    std::lock_guard<std::mutex> lock( m_lock );
+
     if( m_c_count++ == 0 )
     {
 #if USE_WXLOCALE
@@ -240,7 +263,8 @@ LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
 
 LOCALE_IO::~LOCALE_IO()
 {
-    // use thread safe, atomic operation
+    std::lock_guard<std::mutex> lock( m_lock );
+
     if( --m_c_count == 0 )
     {
         // revert to the user locale
@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <dir_timestamp_cache.h>
+
+#include <advanced_config.h>
+#include <common.h>
+
+#include <wx/evtloop.h>
+#include <wx/filename.h>
+#include <wx/fswatcher.h>
+#include <wx/log.h>
+#include <wx/thread.h>
+
+
+// Reading a file does not change the timestamps, so the access events are not watched
+static const int WATCHED_EVENTS = wxFSW_EVENT_CREATE | wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME
+                                  | wxFSW_EVENT_MODIFY | wxFSW_EVENT_ATTRIB;
+
+
+// The same directory may be given with or without a trailing separator
+static wxString dirKey( const wxString& aDirPath )
+{
+    wxString key = aDirPath;
+
+    while( key.Length() > 1 && wxFileName::IsPathSeparator( key.Last() ) )
+        key.RemoveLast();
+
+    return key;
+}
+
+
+DIR_TIMESTAMP_CACHE::DIR_TIMESTAMP_CACHE()
+{
+    Bind( wxEVT_FSWATCHER, &DIR_TIMESTAMP_CACHE::onFileSystemEvent, this );
+}
+
+
+DIR_TIMESTAMP_CACHE::~DIR_TIMESTAMP_CACHE()
+{
+}
+
+
+long long DIR_TIMESTAMP_CACHE::Timestamp( const wxString& aDirPath, const wxString& aFilespec )
+{
+    wxString dir = dirKey( aDirPath );
+    bool     watched;
+    unsigned generation = 0;
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        DIR_STATE&                  state = m_dirs[dir];
+
+        // Watch before reading the directory, so that no change is missed
+        watched = state.m_watched || watch( dir, state );
+
+        if( watched )
+        {
+            auto it = state.m_timestamps.find( aFilespec );
+
+            if( it != state.m_timestamps.end() )
+                return it->second;
+
+            generation = state.m_generation;
+        }
+    }
+
+    long long timestamp = TimestampDir( aDirPath, aFilespec );
+
+    if( watched )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        DIR_STATE&                  state = m_dirs[dir];
+
+        if( state.m_watched && state.m_generation == generation )
+            state.m_timestamps[aFilespec] = timestamp;
+    }
+
+    return timestamp;
+}
+
+
+bool DIR_TIMESTAMP_CACHE::watch( const wxString& aDir, DIR_STATE& aState )
+{
+    // The watcher delivers its events through the event loop of the main thread
+    if( !wxIsMainThread() || !wxEventLoopBase::GetActive() )
+        return false;
+
+    if( !m_watcher )
+    {
+        m_watcher = std::make_unique<wxFileSystemWatcher>();
+        m_watcher->SetOwner( this );
+    }
+
+    wxFileName fn;
+    fn.AssignDir( aDir );
+
+    // A directory which cannot be watched is just read each time
+    wxLogNull doNotLog;
+
+    if( !m_watcher->Add( fn, WATCHED_EVENTS ) )
+        return false;
+
+    aState.m_watched = true;
+    return true;
+}
+
+
+void DIR_TIMESTAMP_CACHE::invalidate( const wxString& aPath )
+{
+    auto it = m_dirs.find( dirKey( aPath ) );
+
+    if( it != m_dirs.end() )
+    {
+        it->second.m_timestamps.clear();
+        it->second.m_generation++;
+    }
+}
+
+
+void DIR_TIMESTAMP_CACHE::onFileSystemEvent( wxFileSystemWatcherEvent& aEvent )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    int type = aEvent.GetChangeType();
+
+    if( type == wxFSW_EVENT_WARNING || type == wxFSW_EVENT_ERROR )
+    {
+        // Some events may have been lost
+        for( std::pair<const wxString, DIR_STATE>& dir : m_dirs )
+        {
+            dir.second.m_timestamps.clear();
+            dir.second.m_generation++;
+        }
+
+        return;
+    }
+
+    // The event is about a file of a watched directory, or the directory itself
+    invalidate( aEvent.GetPath().GetPath() );
+    invalidate( aEvent.GetPath().GetFullPath() );
+
+    if( type == wxFSW_EVENT_RENAME )
+    {
+        invalidate( aEvent.GetNewPath().GetPath() );
+        invalidate( aEvent.GetNewPath().GetFullPath() );
+    }
+}
+
+
+long long LibraryDirTimestamp( const wxString& aDirPath, const wxString& aFilespec )
+{
+    if( !ADVANCED_CFG::GetCfg().m_watchLibraryDirs )
+        return TimestampDir( aDirPath, aFilespec );
+
+    // Never destroyed: that could only happen after the cleanup of the wx library
+    static DIR_TIMESTAMP_CACHE* cache = new DIR_TIMESTAMP_CACHE();
+
+    return cache->Timestamp( aDirPath, aFilespec );
+}
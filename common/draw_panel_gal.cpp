@@ -40,10 +40,22 @@
 
 #include <tool/tool_dispatcher.h>
 #include <tool/tool_manager.h>
+#include <advanced_config.h>
+
+#include <wx/ffile.h>
 
-#ifdef PROFILE
 #include <profile.h>
-#endif /* PROFILE */
+
+
+struct EDA_DRAW_PANEL_GAL::FRAME_STATS
+{
+    double                 m_totalTime = 0.0;   ///< Whole paint event, in ms
+    double                 m_updateTime = 0.0;  ///< VIEW::UpdateItems(), painting the changed items
+    double                 m_redrawTime = 0.0;  ///< VIEW::Redraw(), querying and drawing the items
+    int                    m_items = 0;         ///< Items drawn by VIEW::Redraw()
+    KIGFX::GAL_FRAME_STATS m_gal;
+    unsigned int           m_frame = 0;         ///< Index of the frame
+};
 
 
 EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
@@ -61,6 +73,7 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_eventDispatcher = NULL;
     m_lostFocus  = false;
     m_stealsFocus = true;
+    m_frameStats.reset( new FRAME_STATS );
 
     m_currentCursor = wxStockCursor( wxCURSOR_ARROW );
 
@@ -161,18 +174,21 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     if( m_drawing )
         return;
 
-#ifdef PROFILE
     PROF_COUNTER totalRealTime;
-#endif /* PROFILE */
+    PROF_COUNTER updateTime;
+    double       redrawTime = 0.0;
+    int          drawnItems = 0;
 
     wxASSERT( m_painter );
 
     m_drawing = true;
     KIGFX::RENDER_SETTINGS* settings = static_cast<KIGFX::RENDER_SETTINGS*>( m_painter->GetSettings() );
+    const ADVANCED_CFG&     cfg = ADVANCED_CFG::GetCfg();
 
     try
     {
         m_view->UpdateItems();
+        updateTime.Stop();
 
         KIGFX::GAL_DRAWING_CONTEXT ctx( m_gal );
 
@@ -180,6 +196,10 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
         m_gal->SetGridColor( settings->GetGridColor() );
         m_gal->SetCursorColor( settings->GetCursorColor() );
 
+        // The statistics are drawn on the overlay, so it has to be redrawn for each frame
+        if( cfg.m_showFrameStats )
+            m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+
         // TODO: find why ClearScreen() must be called here in opengl mode
         // and only if m_view->IsDirty() in Cairo mode to avoid distaly artifacts
         // when moving the mouse cursor
@@ -188,6 +208,8 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 
         if( m_view->IsDirty() )
         {
+            PROF_COUNTER redrawCounter;
+
             if( m_backend != GAL_TYPE_OPENGL &&     // Already called in opengl
                 m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
                 m_gal->ClearScreen();
@@ -199,6 +221,12 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                 m_gal->DrawGrid();
 
             m_view->Redraw();
+
+            redrawTime = redrawCounter.msecs();
+            drawnItems = m_view->GetDrawnItemCount();
+
+            if( cfg.m_showFrameStats )
+                drawFrameStats();
         }
 
         m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
@@ -214,16 +242,97 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                             wxString( err.what() ) );
     }
 
-#ifdef PROFILE
     totalRealTime.Stop();
+
+#ifdef PROFILE
     wxLogTrace( "GAL_PROFILE", "EDA_DRAW_PANEL_GAL::onPaint(): %.1f ms", totalRealTime.msecs() );
 #endif /* PROFILE */
 
+    m_frameStats->m_totalTime = totalRealTime.msecs();
+    m_frameStats->m_updateTime = updateTime.msecs();
+    m_frameStats->m_redrawTime = redrawTime;
+    m_frameStats->m_items = drawnItems;
+    m_frameStats->m_gal = m_gal->GetFrameStats();
+    m_frameStats->m_frame++;
+    m_gal->ResetFrameStats();
+
+    if( !cfg.m_frameTraceFile.IsEmpty() )
+        traceFrameStats();
+
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
 }
 
 
+void EDA_DRAW_PANEL_GAL::drawFrameStats()
+{
+    const FRAME_STATS&            stats = *m_frameStats;
+    const KIGFX::GAL_FRAME_STATS& gal = stats.m_gal;
+
+    wxString lines[2];
+
+    lines[0].Printf( wxT( "Frame %.1f ms: update %.1f, redraw %.1f, upload %.1f, "
+                          "composite %.1f, swap %.1f" ),
+                     stats.m_totalTime, stats.m_updateTime, stats.m_redrawTime,
+                     gal.m_uploadTime, gal.m_compositeTime, gal.m_swapTime );
+    lines[1].Printf( wxT( "%d items, %d groups, cached vertices %u / %u" ),
+                     stats.m_items, gal.m_groups, gal.m_cachedVertices, gal.m_cachedCapacity );
+
+    // The text keeps the same size in pixels, whatever the zoom
+    const double lineHeight = 18.0;
+    const double glyphSize = m_view->ToWorld( 12.0 );
+
+    m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+    m_gal->SetLayerDepth( m_gal->GetMinDepth() );
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_painter->GetSettings()->GetCursorColor() );
+    m_gal->SetLineWidth( m_view->ToWorld( 1.5 ) );
+    m_gal->SetGlyphSize( VECTOR2D( glyphSize, glyphSize ) );
+    m_gal->SetFontBold( false );
+    m_gal->SetFontItalic( false );
+    m_gal->SetTextMirrored( m_gal->IsFlippedX() );
+    m_gal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_LEFT );
+    m_gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_TOP );
+
+    for( int i = 0; i < 2; ++i )
+    {
+        VECTOR2D pos = m_view->ToWorld( VECTOR2D( 10.0, 10.0 + i * lineHeight ) );
+        m_gal->BitmapText( lines[i], pos, 0.0 );
+    }
+}
+
+
+void EDA_DRAW_PANEL_GAL::traceFrameStats()
+{
+    const FRAME_STATS&            stats = *m_frameStats;
+    const KIGFX::GAL_FRAME_STATS& gal = stats.m_gal;
+
+    if( !m_frameTrace )
+    {
+        m_frameTrace.reset( new wxFFile( ADVANCED_CFG::GetCfg().m_frameTraceFile, "a" ) );
+
+        if( m_frameTrace->IsOpened() && m_frameTrace->Length() == 0 )
+        {
+            m_frameTrace->Write( wxT( "time_ms,frame,total_ms,update_ms,redraw_ms,upload_ms,"
+                                      "composite_ms,swap_ms,items,groups,cached_vertices,"
+                                      "cached_capacity\n" ) );
+        }
+    }
+
+    if( !m_frameTrace->IsOpened() )
+        return;
+
+    m_frameTrace->Write( wxString::Format( wxT( "%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%u,%u\n" ),
+                                           wxGetLocalTimeMillis().ToString(), stats.m_frame,
+                                           stats.m_totalTime, stats.m_updateTime,
+                                           stats.m_redrawTime, gal.m_uploadTime,
+                                           gal.m_compositeTime, gal.m_swapTime, stats.m_items,
+                                           gal.m_groups, gal.m_cachedVertices,
+                                           gal.m_cachedCapacity ) );
+}
+
+
 void EDA_DRAW_PANEL_GAL::onSize( wxSizeEvent& aEvent )
 {
     KIGFX::GAL_CONTEXT_LOCKER locker( m_gal );
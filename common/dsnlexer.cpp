@@ -24,10 +24,15 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
-#include <cstdlib>         // bsearch()
+#include <cstdlib>
 #include <cctype>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include <macros.h>
 #include <fctsys.h>
@@ -39,6 +44,185 @@
 #define FMT_CLIPBOARD       _( "clipboard" )
 
 
+//-----<KEYWORD_INDEX>--------------------------------------------------------
+
+uint64_t KEYWORD_INDEX::hash( const char* aText, size_t aLength )
+{
+    // 64 bit FNV-1a, so that two keywords practically never have the same hash
+    uint64_t hash = 14695981039346656037ull;
+
+    for( const char* end = aText + aLength; aText < end; ++aText )
+    {
+        hash ^= (unsigned char) *aText;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+
+size_t KEYWORD_INDEX::slot( uint64_t aHash, uint32_t aSeed ) const
+{
+    // the murmur3 finalizer, which mixes all the bits of the seeded hash
+    uint64_t h = aHash ^ ( aSeed * 0x9E3779B97F4A7C15ull );
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+
+    return h % m_slots.size();
+}
+
+
+KEYWORD_INDEX::KEYWORD_INDEX( const KEYWORD* aKeywords, unsigned aCount )
+{
+    // A keyword appearing twice in a hand written table keeps its last token, as it did
+    // with the former hashtable.
+    std::map<std::string, const KEYWORD*> unique;
+
+    for( const KEYWORD* it = aKeywords; it < aKeywords + aCount; ++it )
+        unique[it->name] = it;
+
+    std::vector<SLOT>     keys;
+    std::vector<uint64_t> hashes;
+
+    for( const auto& entry : unique )
+    {
+        keys.push_back( { entry.second->name, entry.first.size(), entry.second->token } );
+        hashes.push_back( hash( entry.second->name, entry.first.size() ) );
+    }
+
+    if( keys.empty() )
+        return;
+
+    // "Hash, displace and compress": the keywords are put in buckets by their hash, then
+    // the buckets are placed largest first, looking for each one a seed which sends all its
+    // keywords to free slots.  Buckets of a single keyword just take a free slot.
+    const size_t count = keys.size();
+    std::vector<std::vector<size_t>> buckets( count );
+
+    m_slots.assign( count, { nullptr, 0, -1 } );
+
+    for( size_t ii = 0; ii < count; ++ii )
+        buckets[slot( hashes[ii], 0 )].push_back( ii );
+
+    std::vector<size_t> order( count );
+
+    for( size_t ii = 0; ii < count; ++ii )
+        order[ii] = ii;
+
+    std::stable_sort( order.begin(), order.end(),
+            [&]( size_t a, size_t b )
+            {
+                return buckets[a].size() > buckets[b].size();
+            } );
+
+    std::vector<int32_t> displacements( count, 0 );
+    std::vector<bool>    used( count, false );
+    std::vector<size_t>  placed;
+
+    size_t ii = 0;
+
+    for( ; ii < count && buckets[order[ii]].size() > 1; ++ii )
+    {
+        const std::vector<size_t>& bucket = buckets[order[ii]];
+        const uint32_t maxSeed = 1u << 20;
+        uint32_t seed = 1;
+
+        for( ; seed < maxSeed; ++seed )
+        {
+            placed.clear();
+
+            for( size_t key : bucket )
+            {
+                size_t s = slot( hashes[key], seed );
+
+                if( used[s] || std::find( placed.begin(), placed.end(), s ) != placed.end() )
+                    break;
+
+                placed.push_back( s );
+            }
+
+            if( placed.size() == bucket.size() )
+                break;
+        }
+
+        if( seed == maxSeed )
+        {
+            // cannot happen with sane keywords; fall back to the linear search of Find()
+            m_slots = keys;
+            return;
+        }
+
+        for( size_t kk = 0; kk < bucket.size(); ++kk )
+        {
+            used[placed[kk]] = true;
+            m_slots[placed[kk]] = keys[bucket[kk]];
+        }
+
+        displacements[order[ii]] = (int32_t) seed;
+    }
+
+    size_t freeSlot = 0;
+
+    for( ; ii < count && buckets[order[ii]].size() == 1; ++ii )
+    {
+        while( used[freeSlot] )
+            ++freeSlot;
+
+        used[freeSlot] = true;
+        m_slots[freeSlot] = keys[buckets[order[ii]][0]];
+        displacements[order[ii]] = -1 - (int32_t) freeSlot;
+    }
+
+    m_displacements.swap( displacements );
+}
+
+
+int KEYWORD_INDEX::Find( const char* aText, size_t aLength ) const
+{
+    if( m_displacements.empty() )
+    {
+        for( const SLOT& key : m_slots )
+        {
+            if( key.length == aLength && !memcmp( key.name, aText, aLength ) )
+                return key.token;
+        }
+
+        return -1;
+    }
+
+    uint64_t    h = hash( aText, aLength );
+    int32_t     displacement = m_displacements[slot( h, 0 )];
+    const SLOT& key = m_slots[displacement < 0 ? -1 - displacement : slot( h, displacement )];
+
+    if( key.length == aLength && !memcmp( key.name, aText, aLength ) )
+        return key.token;
+
+    return -1;
+}
+
+
+const KEYWORD_INDEX* KEYWORD_INDEX::Get( const KEYWORD* aKeywords, unsigned aCount )
+{
+    typedef std::pair<const KEYWORD*, unsigned> TABLE;
+
+    static std::mutex                                         mutex;
+    static std::map<TABLE, std::unique_ptr<KEYWORD_INDEX>>    indexes;
+
+    std::lock_guard<std::mutex> lock( mutex );
+
+    std::unique_ptr<KEYWORD_INDEX>& index = indexes[TABLE( aKeywords, aCount )];
+
+    if( !index )
+        index.reset( new KEYWORD_INDEX( aKeywords, aCount ) );
+
+    return index.get();
+}
+
+
 //-----<DSNLEXER>-------------------------------------------------------------
 
 void DSNLEXER::init()
@@ -54,22 +238,7 @@ void DSNLEXER::init()
 
     curOffset = 0;
 
-#if 1
-    if( keywordCount > 11 )
-    {
-        // resize the hashtable bucket count
-        keyword_hash.reserve( keywordCount );
-    }
-
-    // fill the specialized "C string" hashtable from keywords[]
-    const KEYWORD*  it  = keywords;
-    const KEYWORD*  end = it + keywordCount;
-
-    for( ; it < end; ++it )
-    {
-        keyword_hash[it->name] = it->token;
-    }
-#endif
+    keywordIndex = KEYWORD_INDEX::Get( keywords, keywordCount );
 }
 
 
@@ -230,42 +399,15 @@ LINE_READER* DSNLEXER::PopReader()
 }
 
 
-#if 0
-static int compare( const void* a1, const void* a2 )
+int DSNLEXER::findToken( const char* aText, size_t aLength )
 {
-    const KEYWORD* k1 = (const KEYWORD*) a1;
-    const KEYWORD* k2 = (const KEYWORD*) a2;
+    int token = keywordIndex->Find( aText, aLength );
 
-    int ret = strcmp( k1->name, k2->name );
-    return ret;
-}
-
-int DSNLEXER::findToken( const std::string& tok )
-{
-    KEYWORD search;
-
-    search.name = tok.c_str();
-
-    const KEYWORD* findings = (const KEYWORD*) bsearch( &search,
-                                   keywords, keywordCount,
-                                   sizeof(KEYWORD), compare );
-    if( findings )
-        return findings->token;
-    else
-        return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
-}
-
-#else
-
-inline int DSNLEXER::findToken( const std::string& tok )
-{
-    KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
-    if( it != keyword_hash.end() )
-        return it->second;
+    if( token >= 0 )
+        return token;
 
     return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
 }
-#endif
 
 
 const char* DSNLEXER::Syntax( int aTok )
@@ -777,11 +919,11 @@ L_read:
     }           // specctraMode
 
     // non-quoted token, read it into curText.
-    curText.clear();
-
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
     if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
     {
@@ -795,7 +937,7 @@ L_read:
         goto exit;
     }
 
-    curTok = findToken( curText );
+    curTok = findToken( cur, head - cur );
 
 exit:   // single point of exit, no returns elsewhere please.
 
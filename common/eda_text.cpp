@@ -85,7 +85,8 @@ EDA_TEXT_VJUSTIFY_T EDA_TEXT::MapVertJustify( int aVertJustify )
 
 EDA_TEXT::EDA_TEXT( const wxString& text ) :
         m_text( text ),
-        m_e( 1<<TE_VISIBLE )
+        m_e( 1<<TE_VISIBLE ),
+        m_segmentsCacheValid( false )
 {
     int sz = Mils2iu( DEFAULT_SIZE_TEXT );
     SetTextSize( wxSize( sz, sz ) );
@@ -97,7 +98,8 @@ EDA_TEXT::EDA_TEXT( const wxString& text ) :
 
 EDA_TEXT::EDA_TEXT( const EDA_TEXT& aText ) :
         m_text( aText.m_text ),
-        m_e( aText.m_e )
+        m_e( aText.m_e ),
+        m_segmentsCacheValid( false )
 {
     m_shown_text = UnescapeString( m_text );
 }
@@ -149,6 +151,8 @@ bool EDA_TEXT::Replace( wxFindReplaceData& aSearchData )
 
 int EDA_TEXT::LenSize( const wxString& aLine, int aThickness, int aMarkupFlags ) const
 {
+    std::lock_guard<std::recursive_mutex> lock( basic_gal_mutex );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetLineWidth( (float) aThickness );
@@ -573,3 +577,35 @@ void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuf
                 &aCornerBuffer );
     }
 }
+
+
+const std::vector<wxPoint>& EDA_TEXT::GetTextShapeSegments() const
+{
+    const TEXT_EFFECTS& e = m_segmentsCacheEffects;
+
+    // The shape depends on the shown text of multiline texts, which can change without
+    // any call to this object (text variables), so it is part of the key
+    wxString text = IsMultilineAllowed() ? GetShownText() : GetText();
+
+    bool valid = m_segmentsCacheValid
+                 && e.bits == m_e.bits
+                 && e.hjustify == m_e.hjustify
+                 && e.vjustify == m_e.vjustify
+                 && e.size == m_e.size
+                 && e.penwidth == m_e.penwidth
+                 && e.angle == m_e.angle
+                 && e.pos == m_e.pos
+                 && m_segmentsCacheText == text;
+
+    if( !valid )
+    {
+        m_segmentsCache.clear();
+        TransformTextShapeToSegmentList( m_segmentsCache );
+
+        m_segmentsCacheEffects = m_e;
+        m_segmentsCacheText = text;
+        m_segmentsCacheValid = true;
+    }
+
+    return m_segmentsCache;
+}
@@ -39,6 +39,9 @@ FOOTPRINT_FILTER::ITERATOR::ITERATOR( FOOTPRINT_FILTER_IT const& aOther )
 FOOTPRINT_FILTER::ITERATOR::ITERATOR( FOOTPRINT_FILTER& aFilter )
         : m_pos( (size_t) -1 ), m_filter( &aFilter )
 {
+    if( m_filter->m_filter_type & FOOTPRINT_FILTER::FILTERING_BY_COMPONENT_FP_FILTER )
+        m_filter->matchFootprintFilters();
+
     increment();
 }
 
@@ -70,7 +73,7 @@ void FOOTPRINT_FILTER_IT::increment()
 
         if( filter_type & FOOTPRINT_FILTER::FILTERING_BY_COMPONENT_FP_FILTER )
         {
-            if( !FootprintFilterMatch( candidate ) )
+            if( !FootprintFilterMatch( m_pos ) )
                 continue;
         }
 
@@ -89,9 +92,11 @@ void FOOTPRINT_FILTER_IT::increment()
             int      matches, position;
             bool     exclude = false;
 
+            searchStr.MakeLower();
+
             for( auto& matcher : m_filter->m_pattern_filters )
             {
-                if( !matcher->Find( searchStr.Lower(), matches, position ) )
+                if( !matcher->Find( searchStr, matches, position ) )
                 {
                     exclude = true;
                     break;
@@ -124,33 +129,13 @@ FOOTPRINT_INFO& FOOTPRINT_FILTER_IT::dereference() const
 }
 
 
-bool FOOTPRINT_FILTER_IT::FootprintFilterMatch( FOOTPRINT_INFO& aItem )
+bool FOOTPRINT_FILTER_IT::FootprintFilterMatch( size_t aPos )
 {
     if( m_filter->m_footprint_filters.empty() )
         return true;
 
-    // The matching is case insensitive
-    wxString name;
-
-    for( auto const& each_filter : m_filter->m_footprint_filters )
-    {
-        name.Empty();
-
-        // If the filter contains a ':' character, include the library name in the pattern
-        if( each_filter->GetPattern().Contains( ":" ) )
-        {
-            name = aItem.GetLibNickname().Lower() + ":";
-        }
-
-        name += aItem.GetFootprintName().Lower();
-
-        if( each_filter->Find( name ) != EDA_PATTERN_NOT_FOUND )
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return aPos < m_filter->m_footprint_filter_matches.size()
+           && m_filter->m_footprint_filter_matches[aPos];
 }
 
 
@@ -168,7 +153,8 @@ FOOTPRINT_FILTER::FOOTPRINT_FILTER( FOOTPRINT_LIST& aList ) : FOOTPRINT_FILTER()
 
 
 FOOTPRINT_FILTER::FOOTPRINT_FILTER()
-        : m_list( nullptr ), m_pin_count( -1 ), m_filter_type( UNFILTERED_FP_LIST )
+        : m_list( nullptr ), m_pin_count( -1 ), m_filter_type( UNFILTERED_FP_LIST ),
+          m_footprint_filters_matched( false )
 {
 }
 
@@ -176,6 +162,7 @@ FOOTPRINT_FILTER::FOOTPRINT_FILTER()
 void FOOTPRINT_FILTER::SetList( FOOTPRINT_LIST& aList )
 {
     m_list = &aList;
+    m_footprint_filters_matched = false;
 }
 
 
@@ -201,15 +188,34 @@ void FOOTPRINT_FILTER::FilterByPinCount( int aPinCount )
 
 void FOOTPRINT_FILTER::FilterByFootprintFilters( const wxArrayString& aFilters )
 {
-    m_footprint_filters.clear();
+    m_footprint_filters = aFilters;
+    m_footprint_filters_matched = false;
 
-    for( const wxString& each_pattern : aFilters )
+    m_filter_type |= FILTERING_BY_COMPONENT_FP_FILTER;
+}
+
+
+void FOOTPRINT_FILTER::matchFootprintFilters()
+{
+    // The list may have been read again since the last match
+    if( m_footprint_filters_matched && m_list
+            && m_footprint_filter_matches.size() == m_list->GetCount() )
     {
-        m_footprint_filters.push_back( std::make_unique<EDA_PATTERN_MATCH_WILDCARD_EXPLICIT>() );
-        m_footprint_filters.back()->SetPattern( each_pattern.Lower() );
+        return;
     }
 
-    m_filter_type |= FILTERING_BY_COMPONENT_FP_FILTER;
+    m_footprint_filter_matches.assign( m_list ? m_list->GetCount() : 0, false );
+
+    if( m_list )
+    {
+        for( const wxString& each_filter : m_footprint_filters )
+        {
+            for( unsigned ii : m_list->GetFilterMatches( each_filter ) )
+                m_footprint_filter_matches[ii] = true;
+        }
+    }
+
+    m_footprint_filters_matched = true;
 }
 
 
@@ -29,6 +29,7 @@
  */
 
 #include <common.h>
+#include <eda_pattern_match.h>
 #include <fctsys.h>
 #include <footprint_info.h>
 #include <fp_lib_table.h>
@@ -74,6 +75,47 @@ FOOTPRINT_INFO* FOOTPRINT_LIST::GetModuleInfo( const wxString& aFootprintName )
 }
 
 
+const std::vector<unsigned>& FOOTPRINT_LIST::GetFilterMatches( const wxString& aFilter )
+{
+    auto it = m_filter_matches.find( aFilter );
+
+    if( it != m_filter_matches.end() )
+        return it->second;
+
+    if( m_filter_names.size() != m_list.size() )
+    {
+        m_filter_names.clear();
+        m_filter_lib_names.clear();
+
+        for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+        {
+            m_filter_names.push_back( fpinfo->GetFootprintName().Lower() );
+            m_filter_lib_names.push_back( fpinfo->GetLibNickname().Lower() + ":"
+                                          + m_filter_names.back() );
+        }
+    }
+
+    // The matching is case insensitive
+    EDA_PATTERN_MATCH_WILDCARD_EXPLICIT matcher;
+    wxString                            pattern = aFilter.Lower();
+    std::vector<unsigned>&              matches = m_filter_matches[aFilter];
+
+    matcher.SetPattern( pattern );
+
+    // If the filter contains a ':' character, include the library name in the pattern
+    const std::vector<wxString>& names = pattern.Contains( ":" ) ? m_filter_lib_names
+                                                                 : m_filter_names;
+
+    for( unsigned ii = 0; ii < names.size(); ii++ )
+    {
+        if( matcher.Find( names[ii] ) != EDA_PATTERN_NOT_FOUND )
+            matches.push_back( ii );
+    }
+
+    return matches;
+}
+
+
 bool FOOTPRINT_INFO::InLibrary( const wxString& aLibrary ) const
 {
     return aLibrary == m_nickname;
@@ -178,6 +220,7 @@ void FOOTPRINT_ASYNC_LOADER::Start(
     aTable->Format( &sof, 0 );
     m_last_table = sof.GetString();
 
+    m_list->clearFilterMatches();
     m_list->StartWorkers( aTable, aNickname, this, aNThreads );
 }
 
@@ -187,6 +230,7 @@ bool FOOTPRINT_ASYNC_LOADER::Join()
     if( m_list )
     {
         bool rv = m_list->JoinWorkers();
+        m_list->clearFilterMatches();
         m_list = nullptr;
         return rv;
     }
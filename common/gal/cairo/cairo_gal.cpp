@@ -35,6 +35,8 @@
 #include <geometry/shape_poly_set.h>
 #include <math/util.h>      // for KiROUND
 #include <bitmap_base.h>
+#include <advanced_config.h>
+#include <profile.h>
 
 #include <limits>
 
@@ -774,6 +776,7 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
     // are executed; nested calling is also possible
 
     storePath();
+    frameStats.m_groups++;
 
     for( GROUP::iterator it = groups[aGroupNumber].begin();
          it != groups[aGroupNumber].end(); ++it )
@@ -934,6 +937,12 @@ void CAIRO_GAL_BASE::resetContext()
     // Compute the world <-> screen transformations
     ComputeWorldScreenMatrix();
 
+    resetCairoState();
+}
+
+
+void CAIRO_GAL_BASE::resetCairoState()
+{
     cairo_matrix_init( &cairoWorldScreenMatrix, worldScreenMatrix.m_data[0][0],
                        worldScreenMatrix.m_data[1][0], worldScreenMatrix.m_data[0][1],
                        worldScreenMatrix.m_data[1][1], worldScreenMatrix.m_data[0][2],
@@ -1190,6 +1199,56 @@ unsigned int CAIRO_GAL_BASE::getNewGroupNumber()
 }
 
 
+CAIRO_TILE_GAL::CAIRO_TILE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
+    CAIRO_GAL_BASE( aDisplayOptions )
+{
+}
+
+
+void CAIRO_TILE_GAL::Begin( const GAL& aParent, cairo_surface_t* aTarget, int aTop, int aHeight,
+                            cairo_antialias_t aAntialias )
+{
+    int stride = cairo_image_surface_get_stride( aTarget );
+
+    // The band shares the pixels of the image
+    surface = cairo_image_surface_create_for_data(
+            cairo_image_surface_get_data( aTarget ) + aTop * stride,
+            cairo_image_surface_get_format( aTarget ),
+            cairo_image_surface_get_width( aTarget ), aHeight, stride );
+    context = cairo_create( surface );
+    currentContext = context;
+    cairo_set_antialias( context, aAntialias );
+
+    // Same view as the parent, shifted up by the first row of the band
+    screenSize = VECTOR2I( cairo_image_surface_get_width( aTarget ), aHeight );
+    lookAtPoint = aParent.GetLookAtPoint();
+    zoomFactor = aParent.GetZoomFactor();
+    rotation = aParent.GetRotation();
+    worldScale = aParent.GetWorldScale();
+    globalFlipX = aParent.IsFlippedX();
+    globalFlipY = aParent.IsFlippedY();
+    depthRange = VECTOR2D( aParent.GetMinDepth(), aParent.GetMaxDepth() );
+
+    worldScreenMatrix = aParent.GetWorldScreenMatrix();
+    worldScreenMatrix.m_data[1][2] -= aTop;
+    screenWorldMatrix = worldScreenMatrix.Inverse();
+
+    resetCairoState();
+}
+
+
+void CAIRO_TILE_GAL::End()
+{
+    Flush();
+
+    cairo_destroy( context );
+    context = nullptr;
+    currentContext = nullptr;
+    cairo_surface_destroy( surface );
+    surface = nullptr;
+}
+
+
 CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
         wxWindow* aParent, wxEvtHandler* aMouseListener,
         wxEvtHandler* aPaintListener, const wxString& aName ) :
@@ -1202,6 +1261,9 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
     validCompositor     = false;
     SetTarget( TARGET_NONCACHED );
 
+    tileCount           = 0;
+    tiledSurface        = nullptr;
+
     parentWindow  = aParent;
     mouseListener = aMouseListener;
     paintListener = aPaintListener;
@@ -1257,12 +1319,19 @@ void CAIRO_GAL::beginDrawing()
 
 void CAIRO_GAL::endDrawing()
 {
+    PROF_COUNTER compositeTime;
+
     CAIRO_GAL_BASE::endDrawing();
 
     // Merge buffers on the screen
     compositor->DrawBuffer( mainBuffer );
     compositor->DrawBuffer( overlayBuffer );
 
+    compositeTime.Stop();
+    frameStats.m_compositeTime += compositeTime.msecs();
+
+    PROF_COUNTER swapTime;
+
     // Now translate the raw context data from the format stored
     // by cairo into a format understood by wxImage.
 
@@ -1289,6 +1358,9 @@ void CAIRO_GAL::endDrawing()
     blitCursor( mdc );
     clientDC.Blit( 0, 0, screenSize.x, screenSize.y, &mdc, 0, 0, wxCOPY );
 
+    swapTime.Stop();
+    frameStats.m_swapTime += swapTime.msecs();
+
     deinitSurface();
 }
 
@@ -1395,6 +1467,65 @@ void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 }
 
 
+int CAIRO_GAL::BeginTiledDrawing( int aMaxTiles )
+{
+    if( !ADVANCED_CFG::GetCfg().m_cairoTiledRendering || !isInitialized || !validCompositor
+            || currentTarget == TARGET_OVERLAY )
+        return 0;
+
+    int count = std::min( aMaxTiles, screenSize.y / MIN_TILE_HEIGHT );
+
+    if( count < 2 )
+        return 0;
+
+    // The pending drawings are below the drawings of the tiles
+    storePath();
+
+    tiledSurface = cairo_get_target( currentContext );
+    cairo_surface_flush( tiledSurface );
+
+    while( (int) tiles.size() < count )
+        tiles.emplace_back( new CAIRO_TILE_GAL( options ) );
+
+    for( int i = 0; i < count; ++i )
+    {
+        int top = screenSize.y * i / count;
+        int bottom = screenSize.y * ( i + 1 ) / count;
+
+        tiles[i]->Begin( *this, tiledSurface, top, bottom - top,
+                         cairo_get_antialias( currentContext ) );
+    }
+
+    tileCount = count;
+
+    return tileCount;
+}
+
+
+GAL* CAIRO_GAL::GetTile( int aIndex )
+{
+    wxASSERT( aIndex >= 0 && aIndex < tileCount );
+
+    return tiles[aIndex].get();
+}
+
+
+void CAIRO_GAL::EndTiledDrawing()
+{
+    if( !tileCount )
+        return;
+
+    for( int i = 0; i < tileCount; ++i )
+        tiles[i]->End();
+
+    // The pixels were written through other surfaces
+    cairo_surface_mark_dirty( tiledSurface );
+
+    tileCount = 0;
+    tiledSurface = nullptr;
+}
+
+
 void CAIRO_GAL::initSurface()
 {
     if( isInitialized )
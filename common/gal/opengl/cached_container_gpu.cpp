@@ -37,8 +37,17 @@
 
 using namespace KIGFX;
 
+#ifdef GL_ARB_buffer_storage
+///> The vertices are read back by defragment(), and the writes are seen by the GPU without
+///> explicit flushes
+static const GLbitfield PERSISTENT_MAP_FLAGS = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT
+                                               | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+#endif
+
+
 CACHED_CONTAINER_GPU::CACHED_CONTAINER_GPU( unsigned int aSize ) :
-    CACHED_CONTAINER( aSize ), m_isMapped( false ), m_glBufferHandle( -1 )
+    CACHED_CONTAINER( aSize ), m_isMapped( false ), m_glBufferHandle( -1 ),
+    m_usePersistentMap( false ), m_persistentMapping( NULL ), m_drawFence( 0 )
 {
     m_useCopyBuffer = GLEW_ARB_copy_buffer;
 
@@ -51,10 +60,36 @@ CACHED_CONTAINER_GPU::CACHED_CONTAINER_GPU( unsigned int aSize ) :
         m_useCopyBuffer = false;
     }
 
-    
+
+    // A persistent mapping spares the map and unmap of the whole buffer around each update,
+    // and the defragmentation is done by the GPU without unmapping the buffer
+#ifdef GL_ARB_buffer_storage
+    m_usePersistentMap = m_useCopyBuffer && GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+#endif
+
     glGenBuffers( 1, &m_glBufferHandle );
     glBindBuffer( GL_ARRAY_BUFFER, m_glBufferHandle );
-    glBufferData( GL_ARRAY_BUFFER, m_currentSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
+
+    if( m_usePersistentMap )
+    {
+        m_persistentMapping = allocatePersistent( GL_ARRAY_BUFFER, m_currentSize );
+
+        if( !m_persistentMapping )
+        {
+            wxLogDebug( "Persistent buffer mapping failed, using glMapBuffer()\n" );
+            m_usePersistentMap = false;
+
+            // The storage of a buffer cannot be changed once allocated
+            glBindBuffer( GL_ARRAY_BUFFER, 0 );
+            glDeleteBuffers( 1, &m_glBufferHandle );
+            glGenBuffers( 1, &m_glBufferHandle );
+            glBindBuffer( GL_ARRAY_BUFFER, m_glBufferHandle );
+        }
+    }
+
+    if( !m_usePersistentMap )
+        glBufferData( GL_ARRAY_BUFFER, m_currentSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
+
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     checkGlError( "allocating video memory for cached container" );
 }
@@ -65,6 +100,12 @@ CACHED_CONTAINER_GPU::~CACHED_CONTAINER_GPU()
     if( m_isMapped )
         Unmap();
 
+#ifdef GL_ARB_buffer_storage
+    if( m_drawFence )
+        glDeleteSync( m_drawFence );
+#endif
+
+    // Deleting the buffer releases its persistent mapping
     glDeleteBuffers( 1, &m_glBufferHandle );
 }
 
@@ -74,6 +115,16 @@ void CACHED_CONTAINER_GPU::Map()
     wxCHECK( !IsMapped(), /*void*/ );
 
     glBindBuffer( GL_ARRAY_BUFFER, m_glBufferHandle );
+
+    if( m_usePersistentMap )
+    {
+        // glMapBuffer() waits for the GPU as well, but also for the other buffers
+        waitDrawFence();
+        m_vertices = m_persistentMapping;
+        m_isMapped = true;
+        return;
+    }
+
     m_vertices = static_cast<VERTEX*>( glMapBuffer( GL_ARRAY_BUFFER, GL_READ_WRITE ) );
 
     if( checkGlError( "mapping vertices buffer" ) == GL_NO_ERROR )
@@ -85,8 +136,13 @@ void CACHED_CONTAINER_GPU::Unmap()
 {
     wxCHECK( IsMapped(), /*void*/ );
 
-    glUnmapBuffer( GL_ARRAY_BUFFER );
-    checkGlError( "unmapping vertices buffer" );
+    // The persistent mapping is coherent, so the GPU sees the writes without unmapping it
+    if( !m_usePersistentMap )
+    {
+        glUnmapBuffer( GL_ARRAY_BUFFER );
+        checkGlError( "unmapping vertices buffer" );
+    }
+
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     m_vertices = NULL;
     checkGlError( "unbinding vertices buffer" );
@@ -95,6 +151,66 @@ void CACHED_CONTAINER_GPU::Unmap()
 }
 
 
+void CACHED_CONTAINER_GPU::DrawingFinished()
+{
+#ifdef GL_ARB_buffer_storage
+    if( !m_usePersistentMap )
+        return;
+
+    if( m_drawFence )
+        glDeleteSync( m_drawFence );
+
+    m_drawFence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+#endif
+}
+
+
+VERTEX* CACHED_CONTAINER_GPU::allocatePersistent( GLenum aTarget, unsigned int aSize )
+{
+#ifdef GL_ARB_buffer_storage
+    glBufferStorage( aTarget, aSize * VERTEX_SIZE, NULL, PERSISTENT_MAP_FLAGS );
+
+    if( checkGlError( "allocating persistent vertices buffer" ) != GL_NO_ERROR )
+        return NULL;
+
+    VERTEX* mapping = static_cast<VERTEX*>( glMapBufferRange( aTarget, 0, aSize * VERTEX_SIZE,
+                                                              PERSISTENT_MAP_FLAGS ) );
+
+    if( checkGlError( "mapping persistent vertices buffer" ) != GL_NO_ERROR )
+        return NULL;
+
+    return mapping;
+#else
+    return NULL;
+#endif
+}
+
+
+void CACHED_CONTAINER_GPU::waitDrawFence()
+{
+#ifdef GL_ARB_buffer_storage
+    if( !m_drawFence )
+        return;
+
+    // Flushes the commands the first time, so that the fence is eventually signaled
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+
+    while( true )
+    {
+        GLenum status = glClientWaitSync( m_drawFence, flags, 100000000 );    // 100 ms
+
+        if( status != GL_TIMEOUT_EXPIRED )
+            break;
+
+        flags = 0;
+    }
+
+    glDeleteSync( m_drawFence );
+    m_drawFence = 0;
+#endif
+}
+
+
 bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
 {
     if( !m_useCopyBuffer )
@@ -113,10 +229,12 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     PROF_COUNTER totalTime;
 #endif /* __WXDEBUG__ */
 
-    GLuint newBuffer;
+    GLuint  newBuffer;
+    VERTEX* newMapping = NULL;
 
-    // glCopyBufferSubData requires a buffer to be unmapped
-    glUnmapBuffer( GL_ARRAY_BUFFER );
+    // glCopyBufferSubData requires a buffer to be unmapped, unless its mapping is persistent
+    if( !m_usePersistentMap )
+        glUnmapBuffer( GL_ARRAY_BUFFER );
 
     // Create a new destination buffer
     glGenBuffers( 1, &newBuffer );
@@ -129,7 +247,23 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     wxASSERT( eaBuffer == 0 );
 #endif /* __WXDEBUG__ */
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, newBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
+
+    if( m_usePersistentMap )
+    {
+        newMapping = allocatePersistent( GL_ELEMENT_ARRAY_BUFFER, aNewSize );
+
+        if( !newMapping )
+        {
+            glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+            glDeleteBuffers( 1, &newBuffer );
+            return false;
+        }
+    }
+    else
+    {
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
+    }
+
     checkGlError( "creating buffer during defragmentation" );
 
     ITEMS::iterator it, it_end;
@@ -175,6 +309,20 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
 
     // Switch to the new vertex buffer
     m_glBufferHandle = newBuffer;
+
+#ifdef GL_ARB_buffer_storage
+    if( m_usePersistentMap )
+    {
+        // The vertices may be modified as soon as the buffer is mapped again, so the copies
+        // have to be done first
+        if( m_drawFence )
+            glDeleteSync( m_drawFence );
+
+        m_drawFence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+        m_persistentMapping = newMapping;
+    }
+#endif
+
     Map();
     checkGlError( "switching buffers during defragmentation" );
 
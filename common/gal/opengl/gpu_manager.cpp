@@ -73,21 +73,13 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
 
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
-    GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    GPU_MANAGER( aContainer ), m_indicesSize( 0 )
 {
-    // Allocate the biggest possible buffer for indices
-    resizeIndices( aContainer->GetSize() );
 }
 
 
 GPU_CACHED_MANAGER::~GPU_CACHED_MANAGER()
 {
-    if( m_buffersInitialized )
-    {
-        glBindBuffer( GL_ARRAY_BUFFER, 0 );
-        glDeleteBuffers( 1, &m_indicesBuffer );
-    }
 }
 
 
@@ -95,20 +87,10 @@ void GPU_CACHED_MANAGER::BeginDrawing()
 {
     wxASSERT( !m_isDrawing );
 
-    if( !m_buffersInitialized )
-    {
-        glGenBuffers( 1, &m_indicesBuffer );
-        checkGlError( "generating vertices buffer" );
-        m_buffersInitialized = true;
-    }
-
-    if( m_container->IsDirty() )
-        resizeIndices( m_container->GetSize() );
-
     // Number of vertices to be drawn in the EndDrawing()
     m_indicesSize = 0;
-    // Set the indices pointer to the beginning of the indices-to-draw buffer
-    m_indicesPtr = m_indices.get();
+    m_rangeFirsts.clear();
+    m_rangeCounts.clear();
 
     m_isDrawing = true;
 }
@@ -118,8 +100,21 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 {
     wxASSERT( m_isDrawing );
 
-    // Copy indices of items that should be drawn to GPU memory
-    for( unsigned int i = aOffset; i < aOffset + aSize; *m_indicesPtr++ = i++ );
+    if( aSize == 0 )
+        return;
+
+    // The vertices are drawn from the vertex buffer itself, so an item costs a range instead
+    // of an index per vertex to upload
+    if( !m_rangeFirsts.empty()
+            && (unsigned int) ( m_rangeFirsts.back() + m_rangeCounts.back() ) == aOffset )
+    {
+        m_rangeCounts.back() += aSize;
+    }
+    else
+    {
+        m_rangeFirsts.push_back( aOffset );
+        m_rangeCounts.push_back( aSize );
+    }
 
     m_indicesSize += aSize;
 }
@@ -129,7 +124,8 @@ void GPU_CACHED_MANAGER::DrawAll()
 {
     wxASSERT( m_isDrawing );
 
-    for( unsigned int i = 0; i < m_indicesSize; *m_indicesPtr++ = i++ );
+    m_rangeFirsts.assign( 1, 0 );
+    m_rangeCounts.assign( 1, m_container->GetSize() );
 
     m_indicesSize = m_container->GetSize();
 }
@@ -176,18 +172,15 @@ void GPU_CACHED_MANAGER::EndDrawing()
                                VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
     }
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
-
-    glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    glMultiDrawArrays( GL_TRIANGLES, m_rangeFirsts.data(), m_rangeCounts.data(),
+                       m_rangeFirsts.size() );
 
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
 #endif /* __WXDEBUG__ */
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+    cached->DrawingFinished();
     cached->ClearDirty();
 
     // Deactivate vertex array
@@ -210,16 +203,6 @@ void GPU_CACHED_MANAGER::EndDrawing()
 }
 
 
-void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
-{
-    if( aNewSize > m_indicesCapacity )
-    {
-        m_indicesCapacity = aNewSize;
-        m_indices.reset( new GLuint[m_indicesCapacity] );
-    }
-}
-
-
 // Noncached manager
 GPU_NONCACHED_MANAGER::GPU_NONCACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer )
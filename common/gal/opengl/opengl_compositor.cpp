@@ -33,7 +33,9 @@
 
 #include <gal/color4d.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <memory>
 #include <stdexcept>
 
@@ -42,7 +44,8 @@ using namespace KIGFX;
 OPENGL_COMPOSITOR::OPENGL_COMPOSITOR() :
     m_initialized( false ), m_curBuffer( 0 ),
     m_mainFbo( 0 ), m_depthBuffer( 0 ), m_curFbo( DIRECT_RENDERING ),
-    m_currentAntialiasingMode( OPENGL_ANTIALIASING_MODE::NONE )
+    m_currentAntialiasingMode( OPENGL_ANTIALIASING_MODE::NONE ),
+    m_useClipArea( false )
 {
     m_antialiasing = std::make_unique<ANTIALIASING_NONE>( this );
 }
@@ -285,14 +288,62 @@ void OPENGL_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
 
         glViewport( 0, 0,
                     m_buffers[m_curBuffer].dimensions.x, m_buffers[m_curBuffer].dimensions.y );
+
+        if( m_useClipArea )
+            applyClipArea( m_buffers[m_curBuffer].dimensions );
     }
     else
     {
         glViewport( 0, 0, GetScreenSize().x, GetScreenSize().y );
+
+        if( m_useClipArea )
+            applyClipArea( GetScreenSize() );
     }
 }
 
 
+void OPENGL_COMPOSITOR::SetClipArea( const BOX2I& aArea )
+{
+    m_clipArea = aArea;
+    m_clipArea.Normalize();
+    m_useClipArea = true;
+
+    if( m_curFbo != DIRECT_RENDERING )
+        applyClipArea( m_buffers[m_curBuffer].dimensions );
+    else
+        applyClipArea( GetScreenSize() );
+
+    glEnable( GL_SCISSOR_TEST );
+}
+
+
+void OPENGL_COMPOSITOR::ResetClipArea()
+{
+    m_useClipArea = false;
+    glDisable( GL_SCISSOR_TEST );
+}
+
+
+void OPENGL_COMPOSITOR::applyClipArea( const VECTOR2U& aDimensions )
+{
+    if( m_width == 0 || m_height == 0 )
+        return;
+
+    double scaleX = (double) aDimensions.x / m_width;
+    double scaleY = (double) aDimensions.y / m_height;
+
+    // Round outwards, so that no pixel touched by the area is left out
+    int left   = (int) std::floor( m_clipArea.GetLeft() * scaleX );
+    int right  = (int) std::ceil( m_clipArea.GetRight() * scaleX );
+    int top    = (int) std::floor( m_clipArea.GetTop() * scaleY );
+    int bottom = (int) std::ceil( m_clipArea.GetBottom() * scaleY );
+
+    // OpenGL window coordinates have their origin in the bottom left corner
+    glScissor( left, (int) aDimensions.y - bottom, std::max( 0, right - left ),
+               std::max( 0, bottom - top ) );
+}
+
+
 void OPENGL_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 {
     assert( m_initialized );
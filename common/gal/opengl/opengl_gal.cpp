@@ -32,6 +32,7 @@
 #define GL_SILENCE_DEPRECATION 1
 #endif
 
+#include <advanced_config.h>
 #include <gal/opengl/opengl_gal.h>
 #include <gal/opengl/utils.h>
 #include <gal/definitions.h>
@@ -244,6 +245,7 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
     isBitmapFontInitialized  = false;
     isInitialized            = false;
     isGrouping               = false;
+    isRedrawAreaSet          = false;
     groupCounter             = 0;
 
     // Connecting the event handlers
@@ -304,6 +306,8 @@ OPENGL_GAL::~OPENGL_GAL()
 
     delete compositor;
 
+    containersMemory.Reset();
+
     if( isInitialized )
     {
         delete cachedManager;
@@ -528,11 +532,18 @@ void OPENGL_GAL::endDrawing()
     PROF_COUNTER totalRealTime( "OPENGL_GAL::endDrawing()", true );
 #endif /* __WXDEBUG__ */
 
+    PROF_COUNTER compositeTime;
+
     // Cached & non-cached containers are rendered to the same buffer
     compositor->SetBuffer( mainBuffer );
     nonCachedManager->EndDrawing();
     cachedManager->EndDrawing();
 
+    // The redraw area only applies to the main buffer; the overlay and the composition of the
+    // buffers cover the whole screen
+    compositor->ResetClipArea();
+    isRedrawAreaSet = false;
+
     // Overlay container is rendered to a different buffer
     compositor->SetBuffer( overlayBuffer );
     overlayManager->EndDrawing();
@@ -546,8 +557,18 @@ void OPENGL_GAL::endDrawing()
     compositor->Present();
     blitCursor();
 
+    compositeTime.Stop();
+    frameStats.m_compositeTime += compositeTime.msecs();
+
+    PROF_COUNTER swapTime;
+
     SwapBuffers();
 
+    swapTime.Stop();
+    frameStats.m_swapTime += swapTime.msecs();
+    frameStats.m_cachedVertices = cachedManager->GetUsedSize();
+    frameStats.m_cachedCapacity = cachedManager->GetSize();
+
 #ifdef __WXDEBUG__
     totalRealTime.Stop();
     wxLogTrace( "GAL_PROFILE", wxT( "OPENGL_GAL::endDrawing(): %.1f ms" ), totalRealTime.msecs() );
@@ -600,7 +621,13 @@ void OPENGL_GAL::endUpdate()
     if( !isInitialized )
         return;
 
+    // The vertices are uploaded when the container is unmapped
+    PROF_COUNTER uploadTime;
+
     cachedManager->Unmap();
+
+    uploadTime.Stop();
+    frameStats.m_uploadTime += uploadTime.msecs();
 }
 
 
@@ -1512,7 +1539,10 @@ void OPENGL_GAL::EndGroup()
 void OPENGL_GAL::DrawGroup( int aGroupNumber )
 {
     if( groups[aGroupNumber] )
+    {
         cachedManager->DrawItem( *groups[aGroupNumber] );
+        frameStats.m_groups++;
+    }
 }
 
 
@@ -1597,15 +1627,48 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
 
 
     if( aTarget != TARGET_OVERLAY )
+    {
         compositor->ClearBuffer( m_clearColor );
+    }
+    else if( isRedrawAreaSet )
+    {
+        // The overlay is always redrawn entirely
+        compositor->ResetClipArea();
+        compositor->ClearBuffer( COLOR4D::BLACK );
+        compositor->SetClipArea( redrawArea );
+    }
     else
+    {
         compositor->ClearBuffer( COLOR4D::BLACK );
+    }
 
     // Restore the previous state
     compositor->SetBuffer( oldTarget );
 }
 
 
+bool OPENGL_GAL::IsRedrawAreaSupported() const
+{
+    return ADVANCED_CFG::GetCfg().m_partialRedraw;
+}
+
+
+void OPENGL_GAL::SetRedrawArea( const BOX2I& aArea )
+{
+    // The compositor works in the pixels of the framebuffers, which differ from the screen
+    // pixels on HiDPI displays
+    const double scaleFactor = GetBackingScaleFactor();
+
+    redrawArea = BOX2I( VECTOR2I( KiROUND( aArea.GetX() * scaleFactor ),
+                                  KiROUND( aArea.GetY() * scaleFactor ) ),
+                        VECTOR2I( KiROUND( aArea.GetWidth() * scaleFactor ),
+                                  KiROUND( aArea.GetHeight() * scaleFactor ) ) );
+    isRedrawAreaSet = true;
+
+    compositor->SetClipArea( redrawArea );
+}
+
+
 void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 {
     // Now we should only store the position of the mouse cursor
@@ -1616,7 +1679,8 @@ void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 }
 
 
-void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                               bool aReserve )
 {
     /* Helper drawing:                   ____--- v3       ^
      *                           ____---- ...   \          \
@@ -1638,7 +1702,8 @@ void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 
     VECTOR2D vs( v2.x - v1.x, v2.y - v1.y );
 
-    currentManager->Reserve( 6 );
+    if( aReserve )
+        currentManager->Reserve( 6 );
 
     // Line width is maintained by the vertex shader
     currentManager->Shader( SHADER_LINE_A, lineWidth, vs.x, vs.y );
@@ -1784,14 +1849,20 @@ void OPENGL_GAL::drawPolyline( const std::function<VECTOR2D (int)>& aPointGetter
         return;
 
     currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-    int i;
 
-    for( i = 1; i < aPointCount; ++i )
+    // One allocation for all the segments, instead of one per segment (the strokes of the
+    // text are drawn this way)
+    if( !currentManager->Reserve( 6 * ( aPointCount - 1 ) ) )
+        return;
+
+    VECTOR2D start = aPointGetter( 0 );
+
+    for( int i = 1; i < aPointCount; ++i )
     {
-        auto start = aPointGetter( i - 1 );
-        auto end = aPointGetter( i );
+        VECTOR2D end = aPointGetter( i );
 
-        drawLineQuad( start, end );
+        drawLineQuad( start, end, false );
+        start = end;
     }
 }
 
@@ -2057,6 +2128,16 @@ void OPENGL_GAL::init()
     nonCachedManager->SetShader( *shader );
     overlayManager->SetShader( *shader );
 
+    // The vertices of the cached container may be stored in the video memory
+    containersMemory.Set( "GAL containers",
+            [this]()
+            {
+                size_t vertices = cachedManager->GetSize() + nonCachedManager->GetSize()
+                                  + overlayManager->GetSize();
+
+                return vertices * VERTEX_SIZE + groups.size() * sizeof( VERTEX_ITEM );
+            } );
+
     isInitialized = true;
 }
 
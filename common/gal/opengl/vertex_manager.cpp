@@ -251,6 +251,18 @@ void VERTEX_MANAGER::EndDrawing() const
 }
 
 
+unsigned int VERTEX_MANAGER::GetUsedSize() const
+{
+    return m_container->GetUsedSize();
+}
+
+
+unsigned int VERTEX_MANAGER::GetSize() const
+{
+    return m_container->GetSize();
+}
+
+
 void VERTEX_MANAGER::putVertex( VERTEX& aTarget, GLfloat aX, GLfloat aY, GLfloat aZ ) const
 {
     // Modify the vertex according to the currently used transformations
@@ -331,6 +331,9 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText, int markupFlags )
     bool     in_overbar = false;
     VECTOR2D glyphSize = baseGlyphSize;
 
+    // The points of a stroke, reused for all the strokes of the text
+    std::vector<VECTOR2D> ptListScaled;
+
     yOffset = 0;
 
     for( UTF8::uni_iter chIt = aText.ubegin(), end = aText.uend(); chIt < end; ++chIt )
@@ -457,7 +460,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText, int markupFlags )
 
         for( const std::vector<VECTOR2D>* ptList : *glyph )
         {
-            std::deque<VECTOR2D> ptListScaled;
+            ptListScaled.clear();
 
             for( const VECTOR2D& pt : *ptList )
             {
@@ -476,7 +479,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText, int markupFlags )
                 ptListScaled.push_back( scaledPt );
             }
 
-            m_gal->DrawPolyline( ptListScaled );
+            m_gal->DrawPolyline( ptListScaled.data(), ptListScaled.size() );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
@@ -28,6 +28,9 @@
 #include <class_text_mod.h>
 #include <class_edge_mod.h>
 #include <class_pad.h>
+#include <class_track.h>
+#include <class_drawsegment.h>
+#include <class_pcb_text.h>
 
 #include <functional>
 
@@ -86,6 +89,9 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
             ret += hash<int>{}( pad->GetOffset().y << 7 );
             ret += hash<int>{}( pad->GetDelta().x << 4 );
             ret += hash<int>{}( pad->GetDelta().y << 5 );
+            ret += hash<int>{}( pad->GetDrillSize().x << 10 );
+            ret += hash<int>{}( pad->GetDrillSize().y << 11 );
+            ret += hash<string>{}( pad->GetName().ToStdString() );
 
             if( aFlags & POSITION )
             {
@@ -180,8 +186,96 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         }
         break;
 
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        {
+            const TRACK* track = static_cast<const TRACK*>( aItem );
+            ret += hash_board_item( track, aFlags );
+            ret += hash<int>{}( track->Type() << 12 );
+            ret += hash<int>{}( track->GetWidth() );
+
+            if( aItem->Type() == PCB_VIA_T )
+            {
+                const VIA* via = static_cast<const VIA*>( aItem );
+                ret += hash<int>{}( via->GetDrillValue() << 3 );
+                ret += hash<int>{}( static_cast<int>( via->GetViaType() ) << 14 );
+            }
+
+            if( aItem->Type() == PCB_ARC_T )
+            {
+                const ARC* arc = static_cast<const ARC*>( aItem );
+                ret += hash<int>{}( arc->GetMid().x << 2 );
+                ret += hash<int>{}( arc->GetMid().y << 3 );
+            }
+
+            if( aFlags & POSITION )
+            {
+                ret += hash<int>{}( track->GetStart().x );
+                ret += hash<int>{}( track->GetStart().y );
+                ret += hash<int>{}( track->GetEnd().x << 1 );
+                ret += hash<int>{}( track->GetEnd().y << 1 );
+            }
+
+            if( aFlags & NET )
+                ret += hash<int>{}( track->GetNetCode() << 6 );
+        }
+        break;
+
+    case PCB_LINE_T:
+        {
+            const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+            ret += hash_board_item( segment, aFlags );
+            ret += hash<int>{}( segment->GetShape() );
+            ret += hash<int>{}( segment->GetWidth() );
+
+            if( aFlags & POSITION )
+            {
+                ret += hash<int>{}( segment->GetStart().x );
+                ret += hash<int>{}( segment->GetStart().y );
+                ret += hash<int>{}( segment->GetEnd().x << 1 );
+                ret += hash<int>{}( segment->GetEnd().y << 1 );
+
+                for( const wxPoint& pt : segment->BuildPolyPointsList() )
+                {
+                    ret += hash<int>{}( pt.x << 2 );
+                    ret += hash<int>{}( pt.y << 3 );
+                }
+            }
+
+            if( aFlags & ROTATION )
+                ret += hash<double>{}( segment->GetAngle() );
+        }
+        break;
+
+    case PCB_TEXT_T:
+        {
+            const TEXTE_PCB* text = static_cast<const TEXTE_PCB*>( aItem );
+
+            ret += hash_board_item( text, aFlags );
+            ret += hash<string>{}( text->GetShownText().ToStdString() );
+            ret += hash<bool>{}( text->IsItalic() );
+            ret += hash<bool>{}( text->IsBold() );
+            ret += hash<bool>{}( text->IsMirrored() );
+            ret += hash<int>{}( text->GetTextWidth() );
+            ret += hash<int>{}( text->GetTextHeight() );
+            ret += hash<int>{}( text->GetThickness() << 2 );
+            ret += hash<int>{}( text->GetHorizJustify() );
+            ret += hash<int>{}( text->GetVertJustify() );
+
+            if( aFlags & POSITION )
+            {
+                ret += hash<int>{}( text->GetTextPos().x );
+                ret += hash<int>{}( text->GetTextPos().y );
+            }
+
+            if( aFlags & ROTATION )
+                ret += hash<double>{}( text->GetTextAngle() );
+        }
+        break;
+
     default:
-        wxASSERT_MSG( false, "Unhandled type in function hashModItem() (exporter_gencad.cpp)" );
+        wxASSERT_MSG( false, "Unhandled type in function hash_eda()" );
     }
 
     return ret;
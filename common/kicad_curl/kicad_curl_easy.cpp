@@ -25,8 +25,11 @@
 #include <kicad_curl/kicad_curl.h>
 #include <kicad_curl/kicad_curl_easy.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cstdarg>
 #include <cstddef>
+#include <cstring>
 #include <exception>
 #include <ki_exception.h>   // THROW_IO_ERROR
 #include <sstream>
@@ -44,6 +47,22 @@ static size_t write_callback( void* contents, size_t size, size_t nmemb, void* u
 }
 
 
+static size_t header_callback( char* buffer, size_t size, size_t nitems, void* userp )
+{
+    size_t realsize = size * nitems;
+
+    std::string* p = (std::string*) userp;
+
+    // Each response of a redirect chain starts with its status line
+    if( realsize >= 5 && strncmp( buffer, "HTTP/", 5 ) == 0 )
+        p->clear();
+
+    p->append( buffer, realsize );
+
+    return realsize;
+}
+
+
 KICAD_CURL_EASY::KICAD_CURL_EASY() :
     m_headers( NULL )
 {
@@ -62,6 +81,8 @@ KICAD_CURL_EASY::KICAD_CURL_EASY() :
 
     curl_easy_setopt( m_CURL, CURLOPT_WRITEFUNCTION, write_callback );
     curl_easy_setopt( m_CURL, CURLOPT_WRITEDATA, (void*) &m_buffer );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERFUNCTION, header_callback );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERDATA, (void*) &m_responseHeaders );
 }
 
 
@@ -83,6 +104,7 @@ void KICAD_CURL_EASY::Perform()
 
     // bonus: retain worst case memory allocation, should re-use occur
     m_buffer.clear();
+    m_responseHeaders.clear();
 
     CURLcode res = curl_easy_perform( m_CURL );
 
@@ -144,6 +166,52 @@ bool KICAD_CURL_EASY::SetFollowRedirects( bool aFollow )
 }
 
 
+long KICAD_CURL_EASY::GetResponseCode()
+{
+    long code = 0;
+
+    if( curl_easy_getinfo( m_CURL, CURLINFO_RESPONSE_CODE, &code ) != CURLE_OK )
+        return 0;
+
+    return code;
+}
+
+
+std::string KICAD_CURL_EASY::GetResponseHeader( const std::string& aName ) const
+{
+    std::istringstream headers( m_responseHeaders );
+    std::string        line;
+
+    while( std::getline( headers, line ) )
+    {
+        size_t colon = line.find( ':' );
+
+        if( colon != aName.length() )
+            continue;
+
+        bool match = std::equal( aName.begin(), aName.end(), line.begin(),
+                                 []( char a, char b )
+                                 {
+                                     return tolower( (unsigned char) a )
+                                            == tolower( (unsigned char) b );
+                                 } );
+
+        if( !match )
+            continue;
+
+        size_t first = line.find_first_not_of( " \t", colon + 1 );
+        size_t last = line.find_last_not_of( " \t\r\n" );
+
+        if( first == std::string::npos || last < first )
+            return std::string();
+
+        return line.substr( first, last - first + 1 );
+    }
+
+    return std::string();
+}
+
+
 std::string KICAD_CURL_EASY::Escape( const std::string& aUrl )
 {
     char* escaped = curl_easy_escape( m_CURL, aUrl.c_str(), aUrl.length() );
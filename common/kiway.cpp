@@ -210,7 +210,14 @@ KIFACE*  KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
         std::string user_locale = setlocale( lc_new_type, nullptr );
         setlocale( lc_new_type, "C" );
 
-        bool success = dso.Load( dname, wxDL_VERBATIM | wxDL_NOW | wxDL_GLOBAL );
+        wxString phaseName = wxFileName( dname ).GetName();
+        bool     success;
+
+        {
+            SCOPED_STARTUP_PHASE phase( m_program, wxT( "Loading " ) + phaseName );
+
+            success = dso.Load( dname, wxDL_VERBATIM | wxDL_NOW | wxDL_GLOBAL );
+        }
 
         setlocale( lc_new_type, user_locale.c_str() );
 
@@ -245,9 +252,17 @@ KIFACE*  KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
             wxASSERT_MSG( kiface,
                           wxT( "attempted DSO has a bug, failed to return a KIFACE*" ) );
 
+            bool started;
+
             // Give the DSO a single chance to do its "process level" initialization.
             // "Process level" specifically means stay away from any projects in there.
-            if( kiface->OnKifaceStart( m_program, m_ctl ) )
+            {
+                SCOPED_STARTUP_PHASE phase( m_program, wxT( "Starting " ) + phaseName );
+
+                started = kiface->OnKifaceStart( m_program, m_ctl );
+            }
+
+            if( started )
             {
                 // Tell dso's wxDynamicLibrary destructor not to Unload() the program image.
                 (void) dso.Detach();
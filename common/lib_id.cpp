@@ -24,7 +24,10 @@
  */
 
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <wx/wx.h>      // _()
 
 #include <macros.h>     // TO_UTF8()
@@ -111,11 +114,68 @@ static int okRevision( const UTF8& aField )
 //----</Policy and field test functions>-------------------------------------
 
 
+namespace
+{
+
+struct UTF8_HASH
+{
+    size_t operator()( const UTF8& aString ) const
+    {
+        return std::hash<std::string>()( aString );
+    }
+};
+
+
+/**
+ * The pool of the LIB_ID strings.  It is split in shards with their own lock, so that the
+ * threads parsing libraries do not all wait for the same lock.
+ */
+struct LIB_ID_STRING_POOL
+{
+    static const size_t SHARDS = 16;
+
+    struct SHARD
+    {
+        std::mutex                          m_lock;
+        std::unordered_set<UTF8, UTF8_HASH> m_strings;    // nodes, which never move
+    };
+
+    SHARD m_shards[SHARDS];
+};
+
+} // namespace
+
+
+const UTF8& LIB_ID::emptyString()
+{
+    static const UTF8 empty;
+
+    return empty;
+}
+
+
+const UTF8* LIB_ID::intern( const UTF8& aString )
+{
+    if( aString.empty() )
+        return &emptyString();
+
+    // Never destroyed, as the LIB_IDs of the static objects may outlive it
+    static LIB_ID_STRING_POOL* pool = new LIB_ID_STRING_POOL;
+
+    LIB_ID_STRING_POOL::SHARD& shard =
+            pool->m_shards[UTF8_HASH()( aString ) % LIB_ID_STRING_POOL::SHARDS];
+
+    std::lock_guard<std::mutex> lock( shard.m_lock );
+
+    return &*shard.m_strings.insert( aString ).first;
+}
+
+
 void LIB_ID::clear()
 {
-    nickname.clear();
-    item_name.clear();
-    revision.clear();
+    nickname = &emptyString();
+    item_name = &emptyString();
+    revision = &emptyString();
 }
 
 
@@ -136,7 +196,7 @@ int LIB_ID::Parse( const UTF8& aId, LIB_ID_TYPE aType, bool aFix )
         revNdx = rev - buffer;
 
         // no need to check revision, EndsWithRev did that.
-        revision = aId.substr( revNdx );
+        revision = intern( aId.substr( revNdx ) );
         --revNdx;  // back up to omit the '/' which precedes the rev
     }
     else
@@ -183,9 +243,9 @@ int LIB_ID::Parse( const UTF8& aId, LIB_ID_TYPE aType, bool aFix )
 
 LIB_ID::LIB_ID( const wxString& aLibName, const wxString& aLibItemName,
                 const wxString& aRevision ) :
-    nickname( aLibName ),
-    item_name( aLibItemName ),
-    revision( aRevision )
+    nickname( intern( aLibName ) ),
+    item_name( intern( aLibItemName ) ),
+    revision( intern( aRevision ) )
 {
 }
 
@@ -196,7 +256,7 @@ int LIB_ID::SetLibNickname( const UTF8& aLogical )
 
     if( offset == -1 )
     {
-        nickname = aLogical;
+        nickname = intern( aLogical );
     }
 
     return offset;
@@ -209,12 +269,12 @@ int LIB_ID::SetLibItemName( const UTF8& aLibItemName, bool aTestForRev )
 
     if( aTestForRev && separation != -1 )
     {
-        item_name = aLibItemName.substr( 0, separation-1 );
+        item_name = intern( aLibItemName.substr( 0, separation-1 ) );
         return separation;
     }
     else
     {
-        item_name = aLibItemName;
+        item_name = intern( aLibItemName );
     }
 
     return -1;
@@ -227,7 +287,7 @@ int LIB_ID::SetRevision( const UTF8& aRevision )
 
     if( offset == -1 )
     {
-        revision = aRevision;
+        revision = intern( aRevision );
     }
 
     return offset;
@@ -238,18 +298,18 @@ UTF8 LIB_ID::Format() const
 {
     UTF8    ret;
 
-    if( nickname.size() )
+    if( nickname->size() )
     {
-        ret += nickname;
+        ret += *nickname;
         ret += ':';
     }
 
-    ret += item_name;
+    ret += *item_name;
 
-    if( revision.size() )
+    if( revision->size() )
     {
         ret += '/';
-        ret += revision;
+        ret += *revision;
     }
 
     return ret;
@@ -260,10 +320,10 @@ UTF8 LIB_ID::GetLibItemNameAndRev() const
 {
     UTF8 ret;
 
-    if( revision.size() )
+    if( revision->size() )
     {
         ret += '/';
-        ret += revision;
+        ret += *revision;
     }
 
     return ret;
@@ -319,17 +379,18 @@ int LIB_ID::compare( const LIB_ID& aLibId ) const
     if( this == &aLibId )
         return 0;
 
-    int retv = nickname.compare( aLibId.nickname );
+    // The strings are interned: the same string is the same object
+    int retv = nickname == aLibId.nickname ? 0 : nickname->compare( *aLibId.nickname );
 
     if( retv != 0 )
         return retv;
 
-    retv = item_name.compare( aLibId.item_name );
+    retv = item_name == aLibId.item_name ? 0 : item_name->compare( *aLibId.item_name );
 
     if( retv != 0 )
         return retv;
 
-    return revision.compare( aLibId.revision );
+    return revision == aLibId.revision ? 0 : revision->compare( *aLibId.revision );
 }
 
 
@@ -0,0 +1,387 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <lib_index.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <wx/debug.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/*
+ * The layout of an index, in the byte order of the machine which wrote it:
+ *    HEADER
+ *    RECORD[m_count], sorted by nickname then by name
+ *    the nul terminated strings, without duplicates
+ * The strings are referenced by their offset from the first string.
+ */
+
+static const char     INDEX_MAGIC[8] = { 'K', 'I', 'L', 'I', 'B', 'I', 'D', 'X' };
+static const uint32_t INDEX_VERSION = 1;
+static const uint32_t INDEX_BYTE_ORDER = 0x01020304;
+
+
+struct LIB_INDEX::HEADER
+{
+    char     m_magic[8];
+    uint32_t m_version;
+    uint32_t m_byteOrder;
+    int64_t  m_timestamp;
+    uint32_t m_count;
+    uint32_t m_reserved;
+    uint64_t m_stringsOffset;
+    uint64_t m_stringsSize;
+};
+
+
+struct LIB_INDEX::RECORD
+{
+    uint32_t m_nickname;
+    uint32_t m_name;
+    uint32_t m_description;
+    uint32_t m_keywords;
+    int32_t  m_orderNum;
+    uint32_t m_padCount;
+    uint32_t m_uniquePadCount;
+    uint32_t m_reserved;
+};
+
+
+LIB_INDEX::LIB_INDEX() :
+        m_data( nullptr ),
+        m_size( 0 )
+{
+}
+
+
+LIB_INDEX::~LIB_INDEX()
+{
+    Close();
+}
+
+
+bool LIB_INDEX::Write( const wxString& aFileName, std::vector<LIB_INDEX_ENTRY> aEntries,
+                       long long aTimestamp )
+{
+    std::sort( aEntries.begin(), aEntries.end(),
+               []( const LIB_INDEX_ENTRY& a, const LIB_INDEX_ENTRY& b )
+               {
+                   int cmp = strcmp( a.m_Nickname.c_str(), b.m_Nickname.c_str() );
+
+                   return cmp ? cmp < 0 : strcmp( a.m_Name.c_str(), b.m_Name.c_str() ) < 0;
+               } );
+
+    std::string                     strings;
+    std::unordered_map<std::string, uint32_t> offsets;
+
+    auto addString =
+            [&]( const UTF8& aString ) -> uint32_t
+            {
+                auto it = offsets.find( aString );
+
+                if( it != offsets.end() )
+                    return it->second;
+
+                uint32_t offset = strings.size();
+
+                strings.append( aString.c_str(), aString.size() + 1 );   // with the nul
+                offsets[aString] = offset;
+                return offset;
+            };
+
+    std::vector<RECORD> records( aEntries.size() );
+
+    for( size_t ii = 0; ii < aEntries.size(); ii++ )
+    {
+        const LIB_INDEX_ENTRY& entry = aEntries[ii];
+        RECORD&                record = records[ii];
+
+        record.m_nickname = addString( entry.m_Nickname );
+        record.m_name = addString( entry.m_Name );
+        record.m_description = addString( entry.m_Description );
+        record.m_keywords = addString( entry.m_Keywords );
+        record.m_orderNum = entry.m_OrderNum;
+        record.m_padCount = entry.m_PadCount;
+        record.m_uniquePadCount = entry.m_UniquePadCount;
+        record.m_reserved = 0;
+    }
+
+    HEADER header;
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.m_magic, INDEX_MAGIC, sizeof( INDEX_MAGIC ) );
+    header.m_version = INDEX_VERSION;
+    header.m_byteOrder = INDEX_BYTE_ORDER;
+    header.m_timestamp = aTimestamp;
+    header.m_count = records.size();
+    header.m_stringsOffset = sizeof( HEADER ) + records.size() * sizeof( RECORD );
+    header.m_stringsSize = strings.size();
+
+    // Written aside then renamed, so the readers never see a partial index
+    wxString tmpFileName = aFileName + wxT( ".tmp" );
+    wxFFile  file;
+
+    if( !file.Open( tmpFileName, "wb" ) )
+        return false;
+
+    bool ok = file.Write( &header, sizeof( header ) ) == sizeof( header )
+              && file.Write( records.data(), records.size() * sizeof( RECORD ) )
+                         == records.size() * sizeof( RECORD )
+              && file.Write( strings.data(), strings.size() ) == strings.size();
+
+    ok = file.Close() && ok;
+
+    if( !ok || !wxRenameFile( tmpFileName, aFileName, true ) )
+    {
+        wxRemoveFile( tmpFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+bool LIB_INDEX::Open( const wxString& aFileName )
+{
+    Close();
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    LARGE_INTEGER size;
+
+    if( file == INVALID_HANDLE_VALUE )
+        return false;
+
+    if( GetFileSizeEx( file, &size ) && size.QuadPart >= (LONGLONG) sizeof( HEADER ) )
+    {
+        HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+        if( mapping )
+        {
+            m_data = (const char*) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            m_size = size.QuadPart;
+            CloseHandle( mapping );     // the view keeps the mapping
+        }
+    }
+
+    CloseHandle( file );
+#else
+    int         fd = open( aFileName.fn_str(), O_RDONLY );
+    struct stat st;
+
+    if( fd < 0 )
+        return false;
+
+    if( fstat( fd, &st ) == 0 && st.st_size >= (off_t) sizeof( HEADER ) )
+    {
+        void* data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+        if( data != MAP_FAILED )
+        {
+            m_data = (const char*) data;
+            m_size = st.st_size;
+        }
+    }
+
+    close( fd );
+#endif
+
+    if( !m_data )
+        return false;
+
+    const HEADER* header = reinterpret_cast<const HEADER*>( m_data );
+
+    // The string offsets are checked when read, and the nul ending the last string
+    // terminates all of them
+    bool valid = memcmp( header->m_magic, INDEX_MAGIC, sizeof( INDEX_MAGIC ) ) == 0
+                 && header->m_version == INDEX_VERSION
+                 && header->m_byteOrder == INDEX_BYTE_ORDER
+                 && header->m_stringsOffset
+                            == sizeof( HEADER ) + uint64_t( header->m_count ) * sizeof( RECORD )
+                 && header->m_stringsSize > 0
+                 && header->m_stringsOffset + header->m_stringsSize == m_size
+                 && m_data[m_size - 1] == 0;
+
+    if( !valid )
+        Close();
+
+    return valid;
+}
+
+
+void LIB_INDEX::Close()
+{
+    if( m_data )
+    {
+#if defined( _WIN32 )
+        UnmapViewOfFile( m_data );
+#else
+        munmap( const_cast<char*>( m_data ), m_size );
+#endif
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+long long LIB_INDEX::GetTimestamp() const
+{
+    return m_data ? reinterpret_cast<const HEADER*>( m_data )->m_timestamp : 0;
+}
+
+
+unsigned LIB_INDEX::GetCount() const
+{
+    return m_data ? reinterpret_cast<const HEADER*>( m_data )->m_count : 0;
+}
+
+
+const LIB_INDEX::RECORD* LIB_INDEX::record( unsigned aIdx ) const
+{
+    wxASSERT( aIdx < GetCount() );
+
+    return reinterpret_cast<const RECORD*>( m_data + sizeof( HEADER ) ) + aIdx;
+}
+
+
+const char* LIB_INDEX::string( uint32_t aOffset ) const
+{
+    const HEADER* header = reinterpret_cast<const HEADER*>( m_data );
+
+    // A damaged index gives empty strings
+    if( aOffset >= header->m_stringsSize )
+        return m_data + m_size - 1;
+
+    return m_data + header->m_stringsOffset + aOffset;
+}
+
+
+unsigned LIB_INDEX::lowerBound( const char* aNickname, const char* aName ) const
+{
+    unsigned first = 0;
+    unsigned count = GetCount();
+
+    while( count > 0 )
+    {
+        unsigned      step = count / 2;
+        const RECORD* rec = record( first + step );
+        int           cmp = strcmp( string( rec->m_nickname ), aNickname );
+
+        if( cmp == 0 && aName )
+            cmp = strcmp( string( rec->m_name ), aName );
+
+        if( cmp < 0 )
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+
+int LIB_INDEX::Find( const UTF8& aNickname, const UTF8& aName ) const
+{
+    unsigned idx = lowerBound( aNickname.c_str(), aName.c_str() );
+
+    if( idx < GetCount() && strcmp( GetNickname( idx ), aNickname.c_str() ) == 0
+            && strcmp( GetName( idx ), aName.c_str() ) == 0 )
+    {
+        return idx;
+    }
+
+    return -1;
+}
+
+
+void LIB_INDEX::FindLibrary( const UTF8& aNickname, int& aFirst, int& aLast ) const
+{
+    aFirst = lowerBound( aNickname.c_str(), nullptr );
+    aLast = aFirst;
+
+    while( aLast < (int) GetCount() && strcmp( GetNickname( aLast ), aNickname.c_str() ) == 0 )
+        aLast++;
+}
+
+
+const char* LIB_INDEX::GetNickname( unsigned aIdx ) const
+{
+    return string( record( aIdx )->m_nickname );
+}
+
+
+const char* LIB_INDEX::GetName( unsigned aIdx ) const
+{
+    return string( record( aIdx )->m_name );
+}
+
+
+const char* LIB_INDEX::GetDescription( unsigned aIdx ) const
+{
+    return string( record( aIdx )->m_description );
+}
+
+
+const char* LIB_INDEX::GetKeywords( unsigned aIdx ) const
+{
+    return string( record( aIdx )->m_keywords );
+}
+
+
+int LIB_INDEX::GetOrderNum( unsigned aIdx ) const
+{
+    return record( aIdx )->m_orderNum;
+}
+
+
+unsigned LIB_INDEX::GetPadCount( unsigned aIdx ) const
+{
+    return record( aIdx )->m_padCount;
+}
+
+
+unsigned LIB_INDEX::GetUniquePadCount( unsigned aIdx ) const
+{
+    return record( aIdx )->m_uniquePadCount;
+}
@@ -23,9 +23,14 @@
 
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
 #include <utility>
 #include <pgm_base.h>
 #include <kicad_string.h>
+#include <thread_pool.h>
+#include <wx/tokenzr.h>
 
 // Each node gets this lowest score initially, without any matches applied.
 // Matches will then increase this score depending on match quality.  This way,
@@ -49,6 +54,60 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// A plain term has no regular expression, wildcard or relational syntax, so all the
+// matchers just look for it as a substring.
+static bool isPlainTerm( const wxString& aTerm )
+{
+    for( wxUniChar c : aTerm )
+    {
+        if( !wxIsalnum( c ) && c != '-' && c != '_' )
+            return false;
+    }
+
+    return true;
+}
+
+
+static unsigned ngramBit( uint32_t aFirst, uint32_t aSecond, uint32_t aThird )
+{
+    uint32_t hash = aFirst * 0x9E3779B1u;
+    hash = ( hash ^ aSecond ) * 0x85EBCA77u;
+    hash = ( hash ^ aThird ) * 0xC2B2AE3Du;
+
+    return ( hash ^ ( hash >> 16 ) ) & 511;
+}
+
+
+void LIB_TREE_SIGNATURE::Add( const wxString& aText )
+{
+    uint32_t prev1 = 0;     // the previous character
+    uint32_t prev2 = 0;     // the one before
+    size_t   count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        uint32_t cur = c.GetValue();
+        unsigned bit;
+
+        if( count >= 1 )
+        {
+            bit = ngramBit( 0, prev1, cur );
+            m_Bits[bit >> 6] |= uint64_t( 1 ) << ( bit & 63 );
+        }
+
+        if( count >= 2 )
+        {
+            bit = ngramBit( prev2, prev1, cur );
+            m_Bits[bit >> 6] |= uint64_t( 1 ) << ( bit & 63 );
+        }
+
+        prev2 = prev1;
+        prev1 = cur;
+        count++;
+    }
+}
+
+
 void LIB_TREE_NODE::ResetScore()
 {
     for( auto& child: m_Children )
@@ -167,6 +226,7 @@ LIB_TREE_NODE_LIB_ID::LIB_TREE_NODE_LIB_ID( LIB_TREE_NODE* aParent, LIB_TREE_ITE
     m_MatchName = aItem->GetName();
     m_SearchText = aItem->GetSearchText();
     m_Normalized = false;
+    m_OutOfSearch = false;
 
     m_IsRoot = aItem->IsRoot();
 
@@ -210,12 +270,7 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
     if( m_Score <= 0 )
         return; // Leaf nodes without scores are out of the game.
 
-    if( !m_Normalized )
-    {
-        m_MatchName = m_MatchName.Lower();
-        m_SearchText = m_SearchText.Lower();
-        m_Normalized = true;
-    }
+    Normalize();
 
     // Keywords and description we only count if the match string is at
     // least two characters long. That avoids spurious, low quality
@@ -260,6 +315,22 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 }
 
 
+void LIB_TREE_NODE_LIB_ID::Normalize()
+{
+    if( m_Normalized )
+        return;
+
+    m_MatchName = m_MatchName.Lower();
+    m_SearchText = m_SearchText.Lower();
+
+    m_Signature = LIB_TREE_SIGNATURE();
+    m_Signature.Add( m_MatchName );
+    m_Signature.Add( m_SearchText );
+
+    m_Normalized = true;
+}
+
+
 LIB_TREE_NODE_LIB::LIB_TREE_NODE_LIB( LIB_TREE_NODE* aParent, wxString const& aName,
                                       wxString const& aDesc )
 {
@@ -336,3 +407,168 @@ void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
         child->UpdateScore( aMatcher );
 }
 
+
+void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
+{
+    for( auto& child: m_Children )
+        child->UpdateScore( aMatcher );
+}
+
+
+// Characters which can be appended to a search string without adding matches: only the
+// parts which matched the shorter string can match the longer one.
+static bool isPlainSearch( const wxString& aSearch )
+{
+    for( wxUniChar c : aSearch )
+    {
+        if( !wxIsalnum( c ) && !wxIsspace( c ) && c != '-' && c != '_' )
+            return false;
+    }
+
+    return true;
+}
+
+
+void LIB_TREE_NODE_ROOT::UpdateScores( const wxString& aSearch )
+{
+    bool incremental = !m_lastSearch.IsEmpty() && aSearch.StartsWith( m_lastSearch )
+                       && isPlainSearch( aSearch );
+
+    m_lastSearch = aSearch;
+
+    std::vector<LIB_TREE_NODE_LIB_ID*> leaves;
+
+    for( auto& lib: m_Children )
+    {
+        for( auto& child: lib->m_Children )
+        {
+            LIB_TREE_NODE_LIB_ID* leaf = static_cast<LIB_TREE_NODE_LIB_ID*>( child.get() );
+
+            // A part left out by the previous search is left out by this one too, unless
+            // it was updated since
+            if( incremental && leaf->m_OutOfSearch && leaf->m_Normalized )
+                leaf->m_Score = 0;
+            else
+                leaves.push_back( leaf );
+        }
+    }
+
+    wxStringTokenizer tokenizer( aSearch );
+
+    while( tokenizer.HasMoreTokens() )
+        scoreTerm( tokenizer.GetNextToken().Lower(), leaves );
+
+    for( auto& lib: m_Children )
+    {
+        for( auto& child: lib->m_Children )
+        {
+            LIB_TREE_NODE_LIB_ID* leaf = static_cast<LIB_TREE_NODE_LIB_ID*>( child.get() );
+            leaf->m_OutOfSearch = leaf->m_Score <= 0;
+        }
+    }
+}
+
+
+void LIB_TREE_NODE_ROOT::scoreTerm( const wxString& aTerm,
+                                    std::vector<LIB_TREE_NODE_LIB_ID*>& aLeaves )
+{
+    auto removeUnscored =
+            [&]()
+            {
+                aLeaves.erase( std::remove_if( aLeaves.begin(), aLeaves.end(),
+                                               []( LIB_TREE_NODE_LIB_ID* aLeaf )
+                                               {
+                                                   return aLeaf->m_Score <= 0;
+                                               } ),
+                               aLeaves.end() );
+            };
+
+    // The relational matcher shares static wxRegEx objects, which are not thread safe.
+    // It is only created for terms with a relational syntax, which are not plain terms.
+    if( !isPlainTerm( aTerm ) )
+    {
+        EDA_COMBINED_MATCHER matcher( aTerm );
+        UpdateScore( matcher );
+        removeUnscored();
+        return;
+    }
+
+    // All the n-grams of the term are in the texts which contain it
+    LIB_TREE_SIGNATURE termSignature;
+    termSignature.Add( aTerm );
+
+    bool indexed = aTerm.length() >= 2;
+
+    // The parts of a library whose name contains the term match it, whatever their texts
+    std::unordered_set<LIB_TREE_NODE*> matchingLibs;
+
+    for( auto& lib: m_Children )
+    {
+        if( lib->m_MatchName.Contains( aTerm ) )
+            matchingLibs.insert( lib.get() );
+    }
+
+    // Each thread needs its own matcher: wxRegEx objects cannot be shared
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    const size_t blockSize = 64;
+    unsigned     parallelism = std::min<size_t>( pool.GetThreadCount() + 1,
+                                                 aLeaves.size() / ( 4 * blockSize ) + 1 );
+
+    std::vector<std::unique_ptr<EDA_COMBINED_MATCHER>> matchers;
+
+    for( unsigned i = 0; i < parallelism; ++i )
+        matchers.push_back( std::make_unique<EDA_COMBINED_MATCHER>( aTerm ) );
+
+    std::atomic<unsigned> nextMatcher( 0 );
+    std::atomic<size_t>   nextLeaf( 0 );
+
+    pool.RunParallel(
+            [&]()
+            {
+                EDA_COMBINED_MATCHER& matcher = *matchers[nextMatcher++];
+
+                for( size_t begin = nextLeaf.fetch_add( blockSize ); begin < aLeaves.size();
+                     begin = nextLeaf.fetch_add( blockSize ) )
+                {
+                    size_t end = std::min( begin + blockSize, aLeaves.size() );
+
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        LIB_TREE_NODE_LIB_ID* leaf = aLeaves[i];
+
+                        if( leaf->m_Score <= 0 )
+                            continue;
+
+                        leaf->Normalize();
+
+                        if( indexed && !leaf->m_Signature.Covers( termSignature )
+                                && !matchingLibs.count( leaf->m_Parent ) )
+                        {
+                            leaf->m_Score = 0;  // Cannot match, no need to run the matchers
+                        }
+                        else
+                        {
+                            leaf->UpdateScore( matcher );
+                        }
+                    }
+                }
+            },
+            parallelism );
+
+    for( auto& lib: m_Children )
+    {
+        if( lib->m_Children.empty() )
+        {
+            // No children; the library is a leaf and scores itself.
+            lib->UpdateScore( *matchers[0] );
+            continue;
+        }
+
+        lib->m_Score = 0;
+
+        for( auto& child: lib->m_Children )
+            lib->m_Score = std::max( lib->m_Score, child->m_Score );
+    }
+
+    removeUnscored();
+}
@@ -22,6 +22,8 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <wx/string.h>
@@ -176,6 +178,43 @@ public:
 };
 
 
+/**
+ * A 512 bit set of the hashes of the bigrams and trigrams of a text.
+ *
+ * When a text contains a term, its signature covers the signature of the term, so the
+ * nodes whose signature does not cover a search term cannot match it and can be skipped
+ * without running the matchers.
+ */
+struct LIB_TREE_SIGNATURE
+{
+    std::array<uint64_t, 8> m_Bits;
+
+    LIB_TREE_SIGNATURE()
+    {
+        m_Bits.fill( 0 );
+    }
+
+    /**
+     * Add the bigrams and trigrams of aText to the set.
+     */
+    void Add( const wxString& aText );
+
+    /**
+     * @return true if all the n-grams of aOther are in this set.
+     */
+    bool Covers( const LIB_TREE_SIGNATURE& aOther ) const
+    {
+        for( size_t i = 0; i < m_Bits.size(); ++i )
+        {
+            if( ( m_Bits[i] & aOther.m_Bits[i] ) != aOther.m_Bits[i] )
+                return false;
+        }
+
+        return true;
+    }
+};
+
+
 /**
  * Node type: #LIB_ID.
  */
@@ -214,6 +253,14 @@ public:
      */
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
 
+    /**
+     * Lower the match name and the search text, and build their signature, if not done yet.
+     */
+    void Normalize();
+
+    LIB_TREE_SIGNATURE m_Signature;    // N-grams of m_MatchName and m_SearchText
+    bool               m_OutOfSearch;  // Had no score at the end of the last search
+
 protected:
     /**
      * Add a new unit to the component and return it.
@@ -282,6 +329,27 @@ public:
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Score the whole tree for a search string, one whitespace separated term at a time.
+     *
+     * This gives the same scores as calling UpdateScore() for each term, but the parts which
+     * cannot contain a plain term (letters, digits, '-' and '_') are skipped using their
+     * signatures, and the parts are scored in parallel.  When the search string extends the
+     * previous one with plain characters, only the parts which matched it are searched.
+     *
+     * ResetScore() must have been called first.
+     */
+    void UpdateScores( const wxString& aSearch );
+
+private:
+    /**
+     * Add a search term to the scores of the libraries and to the scores of aLeaves, and
+     * remove from aLeaves the parts left without a score.
+     */
+    void scoreTerm( const wxString& aTerm, std::vector<LIB_TREE_NODE_LIB_ID*>& aLeaves );
+
+    wxString m_lastSearch;    // Search string of the last UpdateScores() call
 };
 
 
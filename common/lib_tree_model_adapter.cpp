@@ -25,7 +25,6 @@
 #include <config_params.h>
 #include <lib_tree_model_adapter.h>
 #include <settings/app_settings.h>
-#include <wx/tokenzr.h>
 #include <wx/wupdlock.h>
 
 
@@ -194,15 +193,7 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
             child->m_Score *= 2;
     }
 
-    wxStringTokenizer tokenizer( aSearch );
-
-    while( tokenizer.HasMoreTokens() )
-    {
-        const wxString term = tokenizer.GetNextToken().Lower();
-        EDA_COMBINED_MATCHER matcher( term );
-
-        m_tree.UpdateScore( matcher );
-    }
+    m_tree.UpdateScores( aSearch );
 
     m_tree.SortNodes();
 
@@ -132,7 +132,6 @@ bool NUMERIC_EVALUATOR::Process( const wxString& aString )
     newString( aString );
     m_parseError = false;
     m_parseFinished = false;
-    Token tok;
 
     if( aString.IsEmpty() )
     {
@@ -140,9 +139,18 @@ bool NUMERIC_EVALUATOR::Process( const wxString& aString )
         return true;
     }
 
-    do
+    CompiledExpr& expr = compile( aString );
+
+    // Nothing can change the result of an expression without variables
+    if( expr.evaluated )
+    {
+        snprintf( m_token.token, m_token.OutLen, "%s", expr.result.c_str() );
+        m_parseError = !expr.resultValid;
+        return expr.resultValid;
+    }
+
+    for( const Token& tok : expr.tokens )
     {
-        tok = getToken();
         numEval::Parse( m_parser, tok.token, tok.value, this );
 
         if( m_parseFinished || tok.token == ENDS )
@@ -151,12 +159,65 @@ bool NUMERIC_EVALUATOR::Process( const wxString& aString )
             numEval::Parse( m_parser, 0, tok.value, this );
             break;
         }
-    } while( tok.token );
+    }
+
+    if( expr.tokenError )
+        m_parseError = true;
+
+    if( !expr.hasVars )
+    {
+        expr.evaluated = true;
+        expr.resultValid = !m_parseError;
+        expr.result = m_token.token;
+    }
 
     return !m_parseError;
 }
 
 
+NUMERIC_EVALUATOR::CompiledExpr& NUMERIC_EVALUATOR::compile( const wxString& aString )
+{
+    auto cached = m_cacheIndex.find( aString );
+
+    if( cached != m_cacheIndex.end() )
+    {
+        // Move it to the front, as the most recently used
+        m_cache.splice( m_cache.begin(), m_cache, cached->second );
+        return cached->second->second;
+    }
+
+    CompiledExpr expr;
+    Token        tok;
+
+    // getToken() flags the invalid characters as parse errors
+    bool parseError = m_parseError;
+    m_parseError = false;
+
+    do
+    {
+        tok = getToken();
+        expr.tokens.push_back( tok );
+
+        if( tok.token == VAR )
+            expr.hasVars = true;
+    } while( tok.token != ENDS );
+
+    expr.tokenError = m_parseError;
+    m_parseError = parseError;
+
+    m_cache.emplace_front( aString, std::move( expr ) );
+    m_cacheIndex[aString] = m_cache.begin();
+
+    if( m_cache.size() > CacheSize )
+    {
+        m_cacheIndex.erase( m_cache.back().first );
+        m_cache.pop_back();
+    }
+
+    return m_cache.front().second;
+}
+
+
 void NUMERIC_EVALUATOR::newString( const wxString& aString )
 {
     Clear();
@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory_usage.h>
+
+#include <algorithm>
+#include <cstdio>
+
+
+MEMORY_USAGE& MEMORY_USAGE::Get()
+{
+    // Never destroyed: the providers of the static objects may be unregistered after it
+    static MEMORY_USAGE* usage = new MEMORY_USAGE();
+
+    return *usage;
+}
+
+
+int MEMORY_USAGE::Register( const std::string& aCategory, PROVIDER aProvider )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    if( std::find( m_categories.begin(), m_categories.end(), aCategory ) == m_categories.end() )
+        m_categories.push_back( aCategory );
+
+    int id = m_nextId++;
+
+    m_providers[id] = { aCategory, std::move( aProvider ) };
+
+    return id;
+}
+
+
+void MEMORY_USAGE::Unregister( int aId )
+{
+    // Waits for a running Report(), which may be calling this provider
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_providers.erase( aId );
+}
+
+
+std::vector<MEMORY_USAGE::ENTRY> MEMORY_USAGE::Report() const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+    std::vector<ENTRY>          report;
+
+    for( const std::string& category : m_categories )
+        report.emplace_back( category, 0 );
+
+    for( const auto& provider : m_providers )
+    {
+        auto it = std::find_if( report.begin(), report.end(),
+                [&]( const ENTRY& aEntry )
+                {
+                    return aEntry.first == provider.second.m_Category;
+                } );
+
+        it->second += provider.second.m_Provider();
+    }
+
+    return report;
+}
+
+
+std::string MEMORY_USAGE::Format() const
+{
+    std::string text;
+    size_t      total = 0;
+
+    for( const ENTRY& entry : Report() )
+    {
+        text += entry.first + ": " + FormatBytes( entry.second ) + "\n";
+        total += entry.second;
+    }
+
+    text += "Total: " + FormatBytes( total ) + "\n";
+
+    return text;
+}
+
+
+std::string MEMORY_USAGE::FormatBytes( size_t aBytes )
+{
+    const char* units[] = { "B", "kB", "MB", "GB", "TB" };
+    double      value = aBytes;
+    int         unit = 0;
+
+    while( value >= 1024.0 && unit < 4 )
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    char buffer[32];
+
+    if( unit == 0 )
+        snprintf( buffer, sizeof( buffer ), "%zu B", aBytes );
+    else
+        snprintf( buffer, sizeof( buffer ), "%.1f %s", value, units[unit] );
+
+    return buffer;
+}
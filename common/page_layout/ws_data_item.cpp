@@ -75,6 +75,8 @@ WS_DATA_ITEM::WS_DATA_ITEM( WS_ITEM_TYPE aType )
 
 void WS_DATA_ITEM::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aView )
 {
+    m_drawItemsKey.clear();
+
     int pensize = GetPenSizeUi();
 
     if( pensize == 0 )
@@ -126,6 +128,29 @@ void WS_DATA_ITEM::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aV
 }
 
 
+void WS_DATA_ITEM::UpdateDrawItems( WS_DRAW_ITEM_LIST* aCollector, const wxString& aPageKey )
+{
+    if( WS_DATA_MODEL::GetTheInstance().m_EditMode )
+    {
+        SyncDrawItems( aCollector, nullptr );
+        return;
+    }
+
+    wxString key = aPageKey + wxT( "\n" ) + drawItemsKey( aCollector );
+
+    if( !m_drawItemsKey.IsEmpty() && key == m_drawItemsKey )
+    {
+        for( WS_DRAW_ITEM_BASE* item : m_drawItems )
+            aCollector->Append( item );
+
+        return;
+    }
+
+    SyncDrawItems( aCollector, nullptr );
+    m_drawItemsKey = key;
+}
+
+
 int WS_DATA_ITEM::GetPenSizeUi()
 {
     WS_DATA_MODEL& model = WS_DATA_MODEL::GetTheInstance();
@@ -404,6 +429,8 @@ WS_DATA_ITEM_POLYGONS::WS_DATA_ITEM_POLYGONS() :
 
 void WS_DATA_ITEM_POLYGONS::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aView )
 {
+    m_drawItemsKey.clear();
+
     std::map<int, STATUS_FLAGS> itemFlags;
     WS_DRAW_ITEM_BASE*          item = nullptr;
 
@@ -551,6 +578,8 @@ WS_DATA_ITEM_TEXT::WS_DATA_ITEM_TEXT( const wxString& aTextBase ) :
 
 void WS_DATA_ITEM_TEXT::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aView )
 {
+    m_drawItemsKey.clear();
+
     int   pensize = GetPenSizeUi();
     bool  multilines = false;
 
@@ -621,6 +650,12 @@ void WS_DATA_ITEM_TEXT::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIE
 }
 
 
+wxString WS_DATA_ITEM_TEXT::drawItemsKey( WS_DRAW_ITEM_LIST* aCollector )
+{
+    return aCollector->BuildFullText( m_TextBase );
+}
+
+
 int WS_DATA_ITEM_TEXT::GetPenSizeUi()
 {
     WS_DATA_MODEL& model = WS_DATA_MODEL::GetTheInstance();
@@ -730,6 +765,8 @@ void WS_DATA_ITEM_TEXT::SetConstrainedTextSize()
 
 void WS_DATA_ITEM_BITMAP::SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aView )
 {
+    m_drawItemsKey.clear();
+
     std::map<int, STATUS_FLAGS> itemFlags;
     WS_DRAW_ITEM_BASE*          item = nullptr;
 
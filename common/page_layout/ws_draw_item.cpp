@@ -461,6 +461,16 @@ void WS_DRAW_ITEM_LIST::BuildWorkSheetGraphicList( const PAGE_INFO& aPageInfo,
 
     model.SetupDrawEnvironment( aPageInfo, m_milsToIu );
 
+    // The draw items of the previous page are kept if they are made with the same parameters:
+    // only the items of the texts which changed are made again
+    wxString pageKey = wxString::Format( "%.10g %.10g %.10g %.10g %.10g %d %.10g %.10g %.10g %.10g",
+                                         model.m_WSunits2Iu,
+                                         model.m_LT_Corner.x, model.m_LT_Corner.y,
+                                         model.m_RB_Corner.x, model.m_RB_Corner.y,
+                                         m_penSize, model.m_DefaultLineWidth,
+                                         model.m_DefaultTextSize.x, model.m_DefaultTextSize.y,
+                                         model.m_DefaultTextThickness );
+
     for( WS_DATA_ITEM* wsItem : model.GetItems() )
     {
         // Generate it only if the page option allows this
@@ -469,7 +479,7 @@ void WS_DRAW_ITEM_LIST::BuildWorkSheetGraphicList( const PAGE_INFO& aPageInfo,
         else if( wsItem->GetPage1Option() == SUBSEQUENT_PAGES && m_sheetNumber == 1 )
             continue;
 
-        wsItem->SyncDrawItems( this, nullptr );
+        wsItem->UpdateDrawItems( this, pageKey );
     }
 }
 
@@ -65,6 +65,17 @@ void RENDER_SETTINGS::update()
 }
 
 
+bool RENDER_SETTINGS::isLayerColorTransparent( int aLayer ) const
+{
+    if( aLayer < 0 || aLayer >= LAYER_ID_COUNT )
+        return false;
+
+    return m_layerColors[aLayer].a <= 0.0 && m_layerColorsHi[aLayer].a <= 0.0
+           && m_layerColorsSel[aLayer].a <= 0.0 && m_layerColorsDark[aLayer].a <= 0.0
+           && m_hiContrastColor[aLayer].a <= 0.0;
+}
+
+
 PAINTER::PAINTER( GAL* aGal ) :
     m_gal( aGal ),
     m_brightenedColor( 0.0, 1.0, 0.0, 0.9 )
@@ -59,10 +59,21 @@
 #include <systemdirsappend.h>
 #include <trace_helpers.h>
 
+#include <chrono>
+
 
 static const wxChar traceEnvVars[]     = wxT( "KIENVVARS" );
 
 
+///> @return the time in microseconds of the clock of the startup phases
+static int64_t startupClock()
+{
+    using namespace std::chrono;
+
+    return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count();
+}
+
+
 /**
  * LanguagesList
  * Note: because this list is not created on the fly, wxTranslation
@@ -115,6 +126,8 @@ PGM_BASE::PGM_BASE()
     setLanguageId( wxLANGUAGE_DEFAULT );
 
     ForceSystemPdfBrowser( false );
+
+    m_startTime = startupClock();
 }
 
 
@@ -142,6 +155,50 @@ wxApp& PGM_BASE::App()
 }
 
 
+void PGM_BASE::AddStartupPhase( const wxString& aName, int64_t aMicroseconds )
+{
+    m_startupPhases.emplace_back( aName, aMicroseconds );
+
+    wxLogTrace( traceStartup, wxT( "%s: %.1f ms" ), aName, aMicroseconds / 1000.0 );
+}
+
+
+void PGM_BASE::ReportStartupPhases() const
+{
+    if( !wxLog::IsAllowedTraceMask( traceStartup ) )
+        return;
+
+    wxString report;
+
+    report.Printf( wxT( "First frame shown %.1f ms after the program start" ),
+                   ( startupClock() - m_startTime ) / 1000.0 );
+
+    // The nested phases end, and are listed, before the phases which contain them
+    for( const std::pair<wxString, int64_t>& phase : m_startupPhases )
+    {
+        report << wxString::Format( wxT( "\n    %-40s %8.1f ms" ), phase.first,
+                                    phase.second / 1000.0 );
+    }
+
+    wxLogTrace( traceStartup, wxT( "%s" ), report );
+}
+
+
+SCOPED_STARTUP_PHASE::SCOPED_STARTUP_PHASE( PGM_BASE* aProgram, const wxString& aName ) :
+        m_program( aProgram ),
+        m_name( aName ),
+        m_start( startupClock() )
+{
+}
+
+
+SCOPED_STARTUP_PHASE::~SCOPED_STARTUP_PHASE()
+{
+    if( m_program )
+        m_program->AddStartupPhase( m_name, startupClock() - m_start );
+}
+
+
 void PGM_BASE::SetEditorName( const wxString& aFileName )
 {
     m_editor_name = aFileName;
@@ -27,6 +27,8 @@
  * @brief specialized plotter for GERBER files format
  */
 
+#include <cstdarg>
+
 #include <fctsys.h>
 #include <gr_basic.h>
 #include <trigo.h>
@@ -46,8 +48,8 @@
 
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
-    workFile  = NULL;
-    finalFile = NULL;
+    m_outputToMemory = false;
+    m_apertureListPos = 0;
     m_currentApertureIdx = -1;
     m_apertureAttribute = 0;
 
@@ -99,19 +101,82 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 }
 
 
-void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
+void GERBER_PLOTTER::emitf( const char* aFormat, ... )
 {
+    char    buf[1024];
+    va_list args;
+
+    va_start( args, aFormat );
+    int len = vsnprintf( buf, sizeof( buf ), aFormat, args );
+    va_end( args );
+
+    if( len < 0 )
+        return;
+
+    if( len < (int) sizeof( buf ) )
+    {
+        m_gbrData.append( buf, len );
+        return;
+    }
+
+    // Too long for the stack buffer (only very long header lines can be): format it again
+    // directly at the end of the output data
+    size_t start = m_gbrData.size();
+    m_gbrData.resize( start + len + 1 );
+
+    va_start( args, aFormat );
+    vsnprintf( &m_gbrData[start], len + 1, aFormat, args );
+    va_end( args );
+
+    m_gbrData.resize( start + len );
+}
+
+
+void GERBER_PLOTTER::emitInt( int aValue )
+{
+    // Hand-rolled replacement of "%d": this is the innermost loop of the plotter
+    char  buf[12];
+    char* end = buf + sizeof( buf );
+    char* p = end;
+
+    unsigned int value = aValue < 0 ? 0u - (unsigned int) aValue : (unsigned int) aValue;
+
+    do
+    {
+        *--p = (char) ( '0' + value % 10 );
+        value /= 10;
+    } while( value );
+
+    if( aValue < 0 )
+        *--p = '-';
+
+    m_gbrData.append( p, end - p );
+}
+
 
-    fprintf( outputFile, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
+{
+    // X%dY%dD%02d*
+    m_gbrData += 'X';
+    emitInt( KiROUND( pt.x ) );
+    m_gbrData += 'Y';
+    emitInt( KiROUND( pt.y ) );
+    m_gbrData += 'D';
+
+    if( dcode < 10 )
+        m_gbrData += '0';
+
+    emitInt( dcode );
+    emit( "*\n" );
 }
 
 void GERBER_PLOTTER::ClearAllAttributes()
 {
     // Remove all attributes from object attributes dictionary (TO. and TA commands)
     if( m_useX2format )
-        fputs( "%TD*%\n", outputFile );
+        emit( "%TD*%\n" );
     else
-        fputs( "G04 #@! TD*\n", outputFile );
+        emit( "G04 #@! TD*\n" );
 
     m_objectAttributesDictionnary.clear();
 }
@@ -125,9 +190,9 @@ void GERBER_PLOTTER::clearNetAttribute()
 
     // Remove all net attributes from object attributes dictionary
     if( m_useX2format )
-        fputs( "%TD*%\n", outputFile );
+        emit( "%TD*%\n" );
     else
-        fputs( "G04 #@! TD*\n", outputFile );
+        emit( "G04 #@! TD*\n" );
 
     m_objectAttributesDictionnary.clear();
 }
@@ -171,36 +236,35 @@ void GERBER_PLOTTER::formatNetAttribute( GBR_NETLIST_METADATA* aData )
         clearNetAttribute();
 
     if( !short_attribute_string.empty() )
-        fputs( short_attribute_string.c_str(), outputFile );
+        emit( short_attribute_string );
 
     if( m_useX2format && !aData->m_ExtraData.IsEmpty() )
     {
         std::string extra_data = TO_UTF8( aData->m_ExtraData );
-        fputs( extra_data.c_str(), outputFile );
+        emit( extra_data );
     }
 }
 
 
 bool GERBER_PLOTTER::StartPlot()
 {
-    wxASSERT( outputFile );
-
-    finalFile = outputFile;     // the actual gerber file will be created later
-
-    // Create a temporary filename to store gerber file
-    // note tmpfile() does not work under Vista and W7 in user mode
-    m_workFilename = filename + wxT(".tmp");
-    workFile   = wxFopen( m_workFilename, wxT( "wt" ));
-    outputFile = workFile;
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_outputToMemory );
 
-    if( outputFile == NULL )
+    if( outputFile == NULL && !m_outputToMemory )
         return false;
 
+    // The whole file is built in memory: the aperture list must be inserted before the
+    // items using it, and is known only at the end of the plot.
+    m_gbrData.clear();
+    m_gbrData.reserve( 1 << 20 );
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
-            fprintf( outputFile, "%s\n", TO_UTF8( m_headerExtraLines[ii] ) );
+        {
+            emit( TO_UTF8( m_headerExtraLines[ii] ) );
+            emit( "\n" );
+        }
     }
 
     // Set coordinate format to 3.6 or 4.5 absolute, leading zero omitted
@@ -209,36 +273,36 @@ bool GERBER_PLOTTER::StartPlot()
     // It is fixed here to 3 (inch) or 4 (mm), but is not actually used
     int leadingDigitCount = m_gerberUnitInch ? 3 : 4;
 
-    fprintf( outputFile, "%%FSLAX%d%dY%d%d*%%\n",
-             leadingDigitCount, m_gerberUnitFmt,
-             leadingDigitCount, m_gerberUnitFmt );
-    fprintf( outputFile,
-             "G04 Gerber Fmt %d.%d, Leading zero omitted, Abs format (unit %s)*\n",
-             leadingDigitCount, m_gerberUnitFmt,
-             m_gerberUnitInch ? "inch" : "mm" );
+    emitf( "%%FSLAX%d%dY%d%d*%%\n",
+           leadingDigitCount, m_gerberUnitFmt,
+           leadingDigitCount, m_gerberUnitFmt );
+    emitf( "G04 Gerber Fmt %d.%d, Leading zero omitted, Abs format (unit %s)*\n",
+           leadingDigitCount, m_gerberUnitFmt,
+           m_gerberUnitInch ? "inch" : "mm" );
 
     wxString Title = creator + wxT( " " ) + GetBuildVersion();
     // In gerber files, ASCII7 chars only are allowed.
     // So use a ISO date format (using a space as separator between date and time),
     // not a localized date format
     wxDateTime date = wxDateTime::Now();
-    fprintf( outputFile, "G04 Created by KiCad (%s) date %s*\n",
+    emitf( "G04 Created by KiCad (%s) date %s*\n",
              TO_UTF8( Title ), TO_UTF8( date.FormatISOCombined( ' ') ) );
 
     /* Mass parameter: unit = INCHES/MM */
     if( m_gerberUnitInch )
-        fputs( "%MOIN*%\n", outputFile );
+        emit( "%MOIN*%\n" );
     else
-        fputs( "%MOMM*%\n", outputFile );
+        emit( "%MOMM*%\n" );
 
     // Be sure the usual dark polarity is selected:
-    fputs( "%LPD*%\n", outputFile );
+    emit( "%LPD*%\n" );
 
     // Set initial interpolation mode: always G01 (linear):
-    fputs( "G01*\n", outputFile );
+    emit( "G01*\n" );
 
     // Set aperture list starting point:
-    fputs( "G04 APERTURE LIST*\n", outputFile );
+    emit( "G04 APERTURE LIST*\n" );
+    m_apertureListPos = m_gbrData.size();
 
     return true;
 }
@@ -246,40 +310,43 @@ bool GERBER_PLOTTER::StartPlot()
 
 bool GERBER_PLOTTER::EndPlot()
 {
-    char     line[1024];
-    wxString msg;
+    wxASSERT( outputFile || m_outputToMemory );
 
-    wxASSERT( outputFile );
+    emit( "M02*\n" );
 
-    /* Outfile is actually a temporary file i.e. workFile */
-    fputs( "M02*\n", outputFile );
-    fflush( outputFile );
+    // Placement of apertures in RS274X, after the header
+    std::string body;
+    body.swap( m_gbrData );
 
-    fclose( workFile );
-    workFile   = wxFopen( m_workFilename, wxT( "rt" ));
-    wxASSERT( workFile );
-    outputFile = finalFile;
+    m_gbrData.assign( body, 0, m_apertureListPos );
+    writeApertureList();
+    emit( "G04 APERTURE END LIST*\n" );
 
-    // Placement of apertures in RS274X
-    while( fgets( line, 1024, workFile ) )
+    if( m_outputToMemory )
     {
-        fputs( line, outputFile );
+        m_gbrData.append( body, m_apertureListPos, std::string::npos );
+        return true;
+    }
 
-        char* substr = strtok( line, "\n\r" );
+    bool success = fwrite( m_gbrData.data(), 1, m_gbrData.size(), outputFile ) == m_gbrData.size();
 
-        if( substr && strcmp( substr, "G04 APERTURE LIST*" ) == 0 )
-        {
-            writeApertureList();
-            fputs( "G04 APERTURE END LIST*\n", outputFile );
-        }
-    }
+    size_t bodySize = body.size() - m_apertureListPos;
+    success &= fwrite( body.data() + m_apertureListPos, 1, bodySize, outputFile ) == bodySize;
 
-    fclose( workFile );
-    fclose( finalFile );
-    ::wxRemoveFile( m_workFilename );
+    success &= fclose( outputFile ) == 0;
     outputFile = 0;
+    m_gbrData.clear();
 
-    return true;
+    return success;
+}
+
+
+void GERBER_PLOTTER::OpenMemory()
+{
+    wxASSERT( !outputFile );
+
+    filename.Clear();
+    m_outputToMemory = true;
 }
 
 
@@ -354,7 +421,9 @@ void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
     {
         // Pick an existing aperture or create a new one
         m_currentApertureIdx = GetOrCreateAperture( aSize, aType, aApertureAttribute );
-        fprintf( outputFile, "D%d*\n", m_apertures[m_currentApertureIdx].m_DCode );
+        m_gbrData += 'D';
+        emitInt( m_apertures[m_currentApertureIdx].m_DCode );
+        emit( "*\n" );
     }
 }
 
@@ -377,7 +446,7 @@ void GERBER_PLOTTER::selectAperture( int aDiameter, double aPolygonRotation,
 
 void GERBER_PLOTTER::writeApertureList()
 {
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_outputToMemory );
     char cbuf[1024];
 
     bool useX1StructuredComment = false;
@@ -399,9 +468,9 @@ void GERBER_PLOTTER::writeApertureList()
 
         if( attribute != m_apertureAttribute )
         {
-            fputs( GBR_APERTURE_METADATA::FormatAttribute(
+            emit( GBR_APERTURE_METADATA::FormatAttribute(
                     (GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB) attribute,
-                            useX1StructuredComment ).c_str(), outputFile );
+                            useX1StructuredComment )) );
         }
 
         char* text = cbuf + sprintf( cbuf, "%%ADD%d", tool.m_DCode );
@@ -449,7 +518,7 @@ void GERBER_PLOTTER::writeApertureList()
             break;
         }
 
-        fputs( cbuf, outputFile );
+        emit( cbuf );
 
         m_apertureAttribute = attribute;
 
@@ -458,9 +527,9 @@ void GERBER_PLOTTER::writeApertureList()
         if( attribute )
         {
             if( m_useX2format )
-                fputs( "%TD*%\n", outputFile );
+                emit( "%TD*%\n" );
             else
-                fputs( "G04 #@! TD*\n", outputFile );
+                emit( "G04 #@! TD*\n" );
 
             m_apertureAttribute = 0;
         }
@@ -471,7 +540,7 @@ void GERBER_PLOTTER::writeApertureList()
 
 void GERBER_PLOTTER::PenTo( const wxPoint& aPos, char plume )
 {
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_outputToMemory );
     DPOINT pos_dev = userToDeviceCoordinates( aPos );
 
     switch( plume )
@@ -542,18 +611,25 @@ void GERBER_PLOTTER::plotArc( const wxPoint& aCenter, double aStAngle, double aE
     DPOINT devEnd = userToDeviceCoordinates( end );
     DPOINT devCenter = userToDeviceCoordinates( aCenter ) - userToDeviceCoordinates( start );
 
-    fprintf( outputFile, "G75*\n" );        // Multiquadrant (360 degrees) mode
+    emit( "G75*\n" );     // Multiquadrant (360 degrees) mode
 
     if( aStAngle < aEndAngle )
-        fprintf( outputFile, "G03*\n" );    // Active circular interpolation, CCW
+        emit( "G03*\n" ); // Active circular interpolation, CCW
     else
-        fprintf( outputFile, "G02*\n" );    // Active circular interpolation, CW
-
-    fprintf( outputFile, "X%dY%dI%dJ%dD01*\n",
-             KiROUND( devEnd.x ), KiROUND( devEnd.y ),
-             KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
-
-    fprintf( outputFile, "G01*\n" ); // Back to linear interpol (perhaps useless here).
+        emit( "G02*\n" ); // Active circular interpolation, CW
+
+    // X%dY%dI%dJ%dD01*
+    m_gbrData += 'X';
+    emitInt( KiROUND( devEnd.x ) );
+    m_gbrData += 'Y';
+    emitInt( KiROUND( devEnd.y ) );
+    m_gbrData += 'I';
+    emitInt( KiROUND( devCenter.x ) );
+    m_gbrData += 'J';
+    emitInt( KiROUND( devCenter.y ) );
+    emit( "D01*\n" );
+
+    emit( "G01*\n" ); // Back to linear interpol (perhaps useless here).
 }
 
 
@@ -573,7 +649,7 @@ void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList
 
         if( !attrib.empty() )
         {
-            fputs( attrib.c_str(), outputFile );
+            emit( attrib );
             clearTA_AperFunction = true;
         }
     }
@@ -585,11 +661,11 @@ void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList
     {
         if( m_useX2format )
         {
-            fputs( "%TD.AperFunction*%\n", outputFile );
+            emit( "%TD.AperFunction*%\n" );
         }
         else
         {
-            fputs( "G04 #@! TD.AperFunction*\n", outputFile );
+            emit( "G04 #@! TD.AperFunction*\n" );
         }
     }
 }
@@ -610,10 +686,10 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
 
     if( aFill )
     {
-        fputs( "G36*\n", outputFile );
+        emit( "G36*\n" );
 
         MoveTo( aCornerList[0] );
-        fputs( "G01*\n", outputFile );      // Set linear interpolation.
+        emit( "G01*\n" );  // Set linear interpolation.
 
         for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
             LineTo( aCornerList[ii] );
@@ -622,7 +698,7 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
         if( aCornerList[0] != aCornerList[aCornerList.size()-1] )
             FinishTo( aCornerList[0] );
 
-        fputs( "G37*\n", outputFile );
+        emit( "G37*\n" );
     }
 
     if( aWidth > 0 )    // Draw the polyline/polygon outline
@@ -771,7 +847,7 @@ void GERBER_PLOTTER::FlashPadCircle( const wxPoint& pos, int diametre, EDA_DRAW_
 void GERBER_PLOTTER::FlashPadOval( const wxPoint& pos, const wxSize& aSize, double orient,
                                    EDA_DRAW_MODE_T trace_mode, void* aData )
 {
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_outputToMemory );
     wxSize size( aSize );
     GBR_METADATA* gbr_metadata = static_cast<GBR_METADATA*>( aData );
 
@@ -824,7 +900,7 @@ void GERBER_PLOTTER::FlashPadRect( const wxPoint& pos, const wxSize& aSize,
                                    double orient, EDA_DRAW_MODE_T trace_mode, void* aData )
 
 {
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_outputToMemory );
     wxSize size( aSize );
     GBR_METADATA* gbr_metadata = static_cast<GBR_METADATA*>( aData );
 
@@ -929,7 +1005,7 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
 
             if( !attrib.empty() )
             {
-                fputs( attrib.c_str(), outputFile );
+                emit( attrib );
                 clearTA_AperFunction = true;
             }
         }
@@ -942,11 +1018,11 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
         {
             if( m_useX2format )
             {
-                fputs( "%TD.AperFunction*%\n", outputFile );
+                emit( "%TD.AperFunction*%\n" );
             }
             else
             {
-                fputs( "G04 #@! TD.AperFunction*\n", outputFile );
+                emit( "G04 #@! TD.AperFunction*\n" );
             }
         }
     }
@@ -1039,8 +1115,8 @@ void GERBER_PLOTTER::plotRoundRectAsRegion( const wxPoint& aRectCenter, const wx
         rr_edge.m_center += aRectCenter;
     }
 
-    fputs( "G36*\n", outputFile );      // Start region
-    fputs( "G01*\n", outputFile );      // Set linear interpolation.
+    emit( "G36*\n" );  // Start region
+    emit( "G01*\n" );  // Set linear interpolation.
     MoveTo( rr_outline[0].m_start );    // Start point of region
 
     for( RR_EDGE& rr_edge: rr_outline )
@@ -1055,7 +1131,7 @@ void GERBER_PLOTTER::plotRoundRectAsRegion( const wxPoint& aRectCenter, const wx
             LineTo( rr_edge.m_end );
     }
 
-    fputs( "G37*\n", outputFile );      // Close region
+    emit( "G37*\n" );  // Close region
 }
 
 
@@ -1199,7 +1275,7 @@ void GERBER_PLOTTER::Text( const wxPoint& aPos, const COLOR4D aColor,
 void GERBER_PLOTTER::SetLayerPolarity( bool aPositive )
 {
     if( aPositive )
-        fprintf( outputFile, "%%LPD*%%\n" );
+        emit( "%LPD*%\n" );
     else
-        fprintf( outputFile, "%%LPC*%%\n" );
+        emit( "%LPC*%\n" );
 }
@@ -39,6 +39,77 @@
 #include <wx/zstream.h>
 #include <wx/mstream.h>
 #include <math/util.h>      // for KiROUND
+#include <thread_pool.h>
+
+#include <atomic>
+#include <future>
+
+
+/**
+ * A page content stream, compressed by the thread pool while the next pages are plotted
+ */
+struct PDF_STREAM_JOB
+{
+    enum STATE { PENDING, RUNNING, DONE };
+
+    int                m_Handle;        ///< the stream object
+    int                m_LengthHandle;  ///< the deferred length of the stream
+    std::string        m_Dict;          ///< the other entries of the stream dictionary
+    std::string        m_Data;          ///< the raw stream, then the compressed one
+    std::atomic<int>   m_State;
+    std::future<void>  m_Task;
+
+    PDF_STREAM_JOB( int aHandle, int aLengthHandle ) :
+            m_Handle( aHandle ),
+            m_LengthHandle( aLengthHandle ),
+            m_State( PENDING )
+    {}
+
+    /**
+     * Compresses the stream, unless it is already done (or being done) by another thread
+     * @return true if the stream was compressed by this call
+     */
+    bool Run()
+    {
+        int expected = PENDING;
+
+        if( !m_State.compare_exchange_strong( expected, RUNNING ) )
+            return false;
+
+        // NULL means memos owns the memory, but provide a hint on optimum size needed.
+        wxMemoryOutputStream memos( NULL, std::max<size_t>( 2000, m_Data.size() ) );
+
+        {
+            /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
+             * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
+             * stream! (a DEFLATE stream would be generated with -15 instead of 15)
+             * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
+             *                    8, Z_DEFAULT_STRATEGY );
+             */
+
+            wxZlibOutputStream zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+
+            zos.Write( m_Data.data(), m_Data.size() );
+
+        }   // flush the zip stream using zos destructor
+
+        wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+
+        m_Data.assign( (const char*) sb->GetBufferStart(), sb->Tell() );
+        m_State.store( DONE );
+
+        return true;
+    }
+
+    /// Waits for the compressed stream, compressing it in the calling thread if not started
+    void Wait()
+    {
+        // Never block on a task still queued behind the caller itself (the plot can
+        // already run in a thread of the pool): only wait for a task already running
+        if( !Run() && m_Task.valid() )
+            m_Task.wait();
+    }
+};
 
 
 /*
@@ -478,22 +549,23 @@ void PDF_PLOTTER::closePdfObject()
  * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
  * can contain a lot of things, but for the moment we only handle page
  * content.
+ * The object is only allocated: it is written by writePdfStreams(), once compressed.
  */
 int PDF_PLOTTER::startPdfStream(int handle)
 {
     wxASSERT( outputFile );
     wxASSERT( !workFile );
-    handle = startPdfObject( handle );
 
-    // This is guaranteed to be handle+1 but needs to be allocated since
-    // you could allocate more object during stream preparation
+    if( handle < 0 )
+        handle = allocPdfObject();
+
+    // This needs to be allocated since you could allocate more object
+    // during stream preparation
     streamLengthHandle = allocPdfObject();
-    fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
+    // Open a temporary file to accumulate the stream (the page one stays open during a
+    // block definition)
+    workFilename = filename + ( m_pageWorkFile ? wxT( ".blk.tmp" ) : wxT( ".tmp" ) );
     workFile = wxFopen( workFilename, wxT( "w+b" ));
     wxASSERT( workFile );
     return handle;
@@ -501,9 +573,10 @@ int PDF_PLOTTER::startPdfStream(int handle)
 
 
 /**
- * Finish the current PDF stream (writes the deferred length, too)
+ * Finish the current PDF stream: it is compressed by the thread pool, and written
+ * (with its deferred length) by a later call to writePdfStreams()
  */
-void PDF_PLOTTER::closePdfStream()
+void PDF_PLOTTER::closePdfStream( int handle, const std::string& aDict )
 {
     wxASSERT( workFile );
 
@@ -515,11 +588,14 @@ void PDF_PLOTTER::closePdfStream()
         return;
     }
 
-    // Rewind the file, read in the page stream and DEFLATE it
+    auto job = std::make_shared<PDF_STREAM_JOB>( handle, streamLengthHandle );
+    job->m_Dict = aDict;
+
+    // Rewind the file and read in the page stream
     fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
+    job->m_Data.resize( stream_len );
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
+    int rc = fread( &job->m_Data[0], 1, stream_len, workFile );
     wxASSERT( rc == stream_len );
     (void) rc;
 
@@ -528,38 +604,52 @@ void PDF_PLOTTER::closePdfStream()
     workFile = 0;
     ::wxRemoveFile( workFilename );
 
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+    // DEFLATE it while the next page is plotted
+    job->m_Task = GetKiCadThreadPool().Submit( [job]() { job->Run(); } );
+    m_pendingStreams.push_back( job );
 
-    {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
+    // Write the streams already compressed, so they do not pile up in memory
+    writePdfStreams( false );
+}
 
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
 
-        zos.Write( inbuf, stream_len );
+/**
+ * Write the compressed streams, in the order of the pages.
+ * If aWaitAll is false, stops at the first stream not yet compressed.
+ */
+void PDF_PLOTTER::writePdfStreams( bool aWaitAll )
+{
+    wxASSERT( outputFile );
+    wxASSERT( !workFile );
 
-        delete[] inbuf;
+    size_t count = 0;
 
-    }   // flush the zip stream using zos destructor
+    for( const std::shared_ptr<PDF_STREAM_JOB>& job : m_pendingStreams )
+    {
+        if( aWaitAll )
+            job->Wait();
+        else if( job->m_State.load() != PDF_STREAM_JOB::DONE )
+            break;
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+        startPdfObject( job->m_Handle );
+        fprintf( outputFile,
+                 "<< /Length %d 0 R /Filter /FlateDecode%s >>\n" // Length is deferred
+                 "stream\n", job->m_LengthHandle, job->m_Dict.c_str() );
 
-    unsigned out_count = sb->Tell();
+        fwrite( job->m_Data.data(), 1, job->m_Data.size(), outputFile );
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+        fputs( "endstream\n", outputFile );
+        closePdfObject();
 
-    fputs( "endstream\n", outputFile );
-    closePdfObject();
+        // Writing the deferred length as an indirect object
+        startPdfObject( job->m_LengthHandle );
+        fprintf( outputFile, "%u\n", (unsigned) job->m_Data.size() );
+        closePdfObject();
 
-    // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
-    closePdfObject();
+        count++;
+    }
+
+    m_pendingStreams.erase( m_pendingStreams.begin(), m_pendingStreams.begin() + count );
 }
 
 /**
@@ -596,7 +686,7 @@ void PDF_PLOTTER::ClosePage()
     wxASSERT( workFile );
 
     // Close the page stream (and compress it)
-    closePdfStream();
+    closePdfStream( pageStreamHandle );
 
     // Emit the page object and put it in the page list for later
     pageHandles.push_back( startPdfObject() );
@@ -616,12 +706,26 @@ void PDF_PLOTTER::ClosePage()
              "/Parent %d 0 R\n"
              "/Resources <<\n"
              "    /ProcSet [/PDF /Text /ImageC /ImageB]\n"
-             "    /Font %d 0 R >>\n"
+             "    /Font %d 0 R",
+             pageTreeHandle,
+             fontResDictHandle );
+
+    // The block definitions (they can be used by any page)
+    if( !m_blockHandles.empty() )
+    {
+        fputs( "\n    /XObject <<", outputFile );
+
+        for( unsigned ii = 0; ii < m_blockHandles.size(); ii++ )
+            fprintf( outputFile, " /KicadBlock%u %d 0 R", ii, m_blockHandles[ii] );
+
+        fputs( " >>", outputFile );
+    }
+
+    fprintf( outputFile,
+             " >>\n"
              "/MediaBox [0 0 %d %d]\n"
              "/Contents %d 0 R\n"
              ">>\n",
-             pageTreeHandle,
-             fontResDictHandle,
              int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
              int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
              pageStreamHandle );
@@ -631,6 +735,65 @@ void PDF_PLOTTER::ClosePage()
     pageStreamHandle = 0;
 }
 
+/**
+ * Start a block definition: a Form XObject, with its own content stream
+ */
+int PDF_PLOTTER::StartBlockDefinition()
+{
+    wxASSERT( workFile );
+    wxASSERT( !m_pageWorkFile );
+
+    // Put the page stream aside up to EndBlockDefinition()
+    m_pageWorkFile = workFile;
+    m_pageWorkFilename = workFilename;
+    m_pageStreamLengthHandle = streamLengthHandle;
+    workFile = NULL;
+
+    m_blockHandles.push_back( startPdfStream() );
+
+    // The content of the form must not depend on the graphic state of the page at the
+    // time it is placed
+    currentPenWidth = -1;
+
+    return m_blockHandles.size() - 1;
+}
+
+
+void PDF_PLOTTER::EndBlockDefinition()
+{
+    wxASSERT( m_pageWorkFile );
+
+    // The definition is made in the same space as the page content: the placement
+    // matrix maps it to the instance.  Its bounding box is therefore not known, and
+    // the form is not clipped
+    char dict[256];
+    sprintf( dict, " /Type /XObject /Subtype /Form /BBox [-1e7 -1e7 1e7 1e7]"
+                   " /Resources << /Font %d 0 R >>", fontResDictHandle );
+
+    closePdfStream( m_blockHandles.back(), dict );
+
+    workFile = m_pageWorkFile;
+    workFilename = m_pageWorkFilename;
+    streamLengthHandle = m_pageStreamLengthHandle;
+    m_pageWorkFile = NULL;
+
+    // The page state is restored after the form is drawn, but not the state of the plotter
+    currentPenWidth = -1;
+}
+
+
+void PDF_PLOTTER::PlaceBlockDefinition( int aId, const wxPoint& aPos, double aOrient )
+{
+    wxASSERT( workFile );
+    double m[6];
+
+    blockPlacementMatrix( aPos, aOrient, m );
+
+    fprintf( workFile, "q %g %g %g %g %g %g cm /KicadBlock%d Do Q\n",
+             m[0], m[1], m[2], m[3], m[4], m[5], aId );
+}
+
+
 /**
  * The PDF engine supports multiple pages; the first one is opened
  * 'for free' the following are to be closed and reopened. Between
@@ -643,6 +806,8 @@ bool PDF_PLOTTER::StartPlot()
     // First things first: the customary null object
     xrefTable.clear();
     xrefTable.push_back( 0 );
+    m_pendingStreams.clear();
+    m_blockHandles.clear();
 
     /* The header (that's easy!). The second line is binary junk required
        to make the file binary from the beginning (the important thing is
@@ -672,6 +837,9 @@ bool PDF_PLOTTER::EndPlot()
     // Close the current page (often the only one)
     ClosePage();
 
+    // Wait for the compression of the last pages
+    writePdfStreams( true );
+
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
        is *very* involved! */
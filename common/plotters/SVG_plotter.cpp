@@ -171,6 +171,7 @@ SVG_PLOTTER::SVG_PLOTTER()
     m_pen_rgb_color   = 0;       // current color value (black)
     m_brush_rgb_color = 0;       // current color value (black)
     m_dashed          = PLOT_DASH_TYPE::SOLID;
+    m_blockDefinitionCount = 0;
 }
 
 
@@ -316,6 +317,42 @@ void SVG_PLOTTER::EndBlock( void* aData )
 }
 
 
+int SVG_PLOTTER::StartBlockDefinition()
+{
+    int id = m_blockDefinitionCount++;
+
+    // The definition is opened with an empty group, closed by the first style change, like
+    // the group of the current style is closed on the page
+    fprintf( outputFile, "<defs>\n<g id=\"KicadBlock%d\">\n<g>\n", id );
+
+    // The definition must not inherit the style of the page
+    m_graphics_changed = true;
+
+    return id;
+}
+
+
+void SVG_PLOTTER::EndBlockDefinition()
+{
+    fputs( "</g>\n</g>\n</defs>\n", outputFile );
+
+    // The style of the page, still open, is not the current one
+    m_graphics_changed = true;
+}
+
+
+void SVG_PLOTTER::PlaceBlockDefinition( int aId, const wxPoint& aPos, double aOrient )
+{
+    double m[6];
+
+    blockPlacementMatrix( aPos, aOrient, m );
+
+    fprintf( outputFile,
+             "<use xlink:href=\"#KicadBlock%d\" transform=\"matrix(%g %g %g %g %g %g)\" />\n",
+             aId, m[0], m[1], m[2], m[3], m[4], m[5] );
+}
+
+
 /* initialize m_red, m_green, m_blue ( 0 ... 255)
  * from reduced values r, g ,b ( 0.0 to 1.0 )
  */
@@ -685,12 +722,15 @@ bool SVG_PLOTTER::StartPlot()
     wxASSERT( outputFile );
     wxString            msg;
 
+    m_blockDefinitionCount = 0;
+
     static const char*  header[] =
     {
         "<?xml version=\"1.0\" standalone=\"no\"?>\n",
         " <!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \n",
         " \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\"> \n",
         "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" \n",
+        "    xmlns:xlink=\"http://www.w3.org/1999/xlink\" \n",
         NULL
     };
 
@@ -33,6 +33,8 @@
 #include "ws_data_item.h"
 #include <wx/filename.h>
 
+#include <mutex>
+
 
 wxString GetDefaultPlotExtension( PLOT_FORMAT aFormat )
 {
@@ -73,6 +75,11 @@ void PlotWorkSheet( PLOTTER* plotter, const PROJECT* aProject, const TITLE_BLOCK
     plotter->SetColor( plotColor );
     WS_DRAW_ITEM_LIST drawList;
 
+    // Building the draw items updates the items of the shared page layout model, and the
+    // sheets of several boards or layers can be plotted at the same time
+    static std::mutex worksheet_mutex;
+    std::lock_guard<std::mutex> lock( worksheet_mutex );
+
     // Print only a short filename, if aFilename is the full filename
     wxFileName fn( aFilename );
 
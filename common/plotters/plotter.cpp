@@ -122,6 +122,44 @@ DPOINT PLOTTER::userToDeviceCoordinates( const wxPoint& aCoordinate )
 }
 
 
+void PLOTTER::blockPlacementMatrix( const wxPoint& aPos, double aOrient, double aMatrix[6] )
+{
+    // The definition is plotted relative to (0,0). An instance maps the image of a point v
+    // to the image of aPos + v rotated by aOrient: this affine transform is found from the
+    // images of 3 points.  The long axes keep the rounding of the rotation negligible.
+    const int axisLen = 1000000;
+
+    wxPoint axisX( axisLen, 0 );
+    wxPoint axisY( 0, axisLen );
+
+    DPOINT  u0 = userToDeviceCoordinates( wxPoint( 0, 0 ) );
+    DPOINT  ux = userToDeviceCoordinates( axisX ) - u0;
+    DPOINT  uy = userToDeviceCoordinates( axisY ) - u0;
+
+    RotatePoint( &axisX, aOrient );
+    RotatePoint( &axisY, aOrient );
+
+    DPOINT  w0 = userToDeviceCoordinates( aPos );
+    DPOINT  wx = userToDeviceCoordinates( aPos + axisX ) - w0;
+    DPOINT  wy = userToDeviceCoordinates( aPos + axisY ) - w0;
+
+    // M = W * inverse( U ), U and W having the images of the axes as columns
+    double det = ux.x * uy.y - uy.x * ux.y;
+
+    double a = ( wx.x * uy.y - wy.x * ux.y ) / det;
+    double c = ( wy.x * ux.x - wx.x * uy.x ) / det;
+    double b = ( wx.y * uy.y - wy.y * ux.y ) / det;
+    double d = ( wy.y * ux.x - wx.y * uy.x ) / det;
+
+    aMatrix[0] = a;
+    aMatrix[1] = b;
+    aMatrix[2] = c;
+    aMatrix[3] = d;
+    aMatrix[4] = w0.x - ( a * u0.x + c * u0.y );
+    aMatrix[5] = w0.y - ( b * u0.x + d * u0.y );
+}
+
+
 DPOINT PLOTTER::userToDeviceSize( const wxSize& size )
 {
     return DPOINT( size.x * plotScale * iuPerDeviceUnit,
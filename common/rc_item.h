@@ -257,6 +257,9 @@ public:
     wxString GetMainText() const { return m_MainText; }
     wxString GetAuxText() const { return m_AuxText; }
 
+    const wxPoint& GetMainPosition() const { return m_MainPosition; }
+    const wxPoint& GetAuxPosition() const { return m_AuxPosition; }
+
     KIID GetMainItemID() const { return m_mainItemUuid; }
     KIID GetAuxItemID() const { return m_auxItemUuid; }
 
@@ -23,11 +23,27 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
 
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,6 +241,152 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+MMAP_LINE_READER::MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( aMaxLineLength ),
+    m_data( NULL ), m_size( 0 ), m_next( 0 ),
+    m_terminated( false ), m_nextChar( 0 )
+{
+    m_buffer  = m_line;
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+
+    bool opened = false;
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    LARGE_INTEGER size;
+
+    if( file != INVALID_HANDLE_VALUE && GetFileSizeEx( file, &size ) )
+    {
+        opened = true;
+        m_size = size.QuadPart;
+
+        if( m_size )
+        {
+            // A copy on write view, private to the process
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+
+            if( mapping )
+            {
+                m_data = (char*) MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+                CloseHandle( mapping );     // the view keeps the mapping
+            }
+
+            opened = m_data != NULL;
+        }
+    }
+
+    if( file != INVALID_HANDLE_VALUE )
+        CloseHandle( file );
+#else
+    int         fd = open( aFileName.fn_str(), O_RDONLY );
+    struct stat st;
+
+    if( fd >= 0 && fstat( fd, &st ) == 0 )
+    {
+        opened = true;
+        m_size = st.st_size;
+
+        if( m_size )
+        {
+            void* data = mmap( NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+            if( data != MAP_FAILED )
+            {
+                m_data = (char*) data;
+                madvise( data, m_size, MADV_SEQUENTIAL );
+            }
+
+            opened = m_data != NULL;
+        }
+    }
+
+    if( fd >= 0 )
+        close( fd );
+#endif
+
+    if( !opened )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+}
+
+
+MMAP_LINE_READER::~MMAP_LINE_READER()
+{
+    if( m_data )
+    {
+#if defined( _WIN32 )
+        UnmapViewOfFile( m_data );
+#else
+        munmap( m_data, m_size );
+#endif
+    }
+
+    // LINE_READER frees its own buffer, never the mapping
+    m_line = m_buffer;
+}
+
+
+char* MMAP_LINE_READER::ReadLine()
+{
+    restoreNext();
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    if( m_next >= m_size )
+    {
+        m_length = 0;
+        m_line = m_buffer;
+        m_line[0] = 0;
+        return NULL;
+    }
+
+    char*  start = m_data + m_next;
+    char*  nl = (char*) memchr( start, '\n', m_size - m_next );
+    size_t length = nl ? nl - start + 1 : m_size - m_next;
+
+    if( length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_next += length;
+
+    if( m_next < m_size )
+    {
+        // Terminate the line in place with the first byte of the next one
+        m_nextChar = m_data[m_next];
+        m_data[m_next] = 0;
+        m_terminated = true;
+
+        m_line = start;
+        m_length = length;
+    }
+    else
+    {
+        // The mapping may end right after the last line, so it is copied to be terminated
+        m_line = m_buffer;
+        m_length = 0;
+
+        if( length + 1 > m_capacity )
+            expandCapacity( length + 1 );
+
+        m_buffer = m_line;
+
+        memcpy( m_line, start, length );
+        m_line[length] = 0;
+        m_length = length;
+    }
+
+    return m_line;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -320,6 +482,109 @@ char* INPUTSTREAM_LINE_READER::ReadLine()
 }
 
 
+#define GZIP_LINE_READER_BLOCKZ     ( 1 << 18 )    ///< size of the inflated blocks
+
+
+GZIP_LINE_READER::GZIP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( aMaxLineLength ),
+    m_blockNext( 0 ),
+    m_blockEnd( 0 )
+{
+    m_file.reset( new wxFFileInputStream( aFileName ) );
+
+    if( !m_file->IsOk() )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    m_stream.reset( new wxZlibInputStream( *m_file, wxZLIB_GZIP ) );
+    m_block.resize( GZIP_LINE_READER_BLOCKZ );
+
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+}
+
+
+GZIP_LINE_READER::~GZIP_LINE_READER()
+{
+    // the inflating stream reads from the file stream, delete it first
+    m_stream.reset();
+}
+
+
+bool GZIP_LINE_READER::IsGzipFile( const wxString& aFileName )
+{
+    FILE*           fp = wxFopen( aFileName, wxT( "rb" ) );
+    unsigned char   magic[2] = { 0, 0 };
+
+    if( !fp )
+        return false;
+
+    size_t count = fread( magic, 1, sizeof( magic ), fp );
+    fclose( fp );
+
+    return count == sizeof( magic ) && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+
+bool GZIP_LINE_READER::readBlock()
+{
+    m_stream->Read( &m_block[0], m_block.size() );
+
+    m_blockNext = 0;
+    m_blockEnd  = m_stream->LastRead();
+
+    if( !m_blockEnd && m_stream->GetLastError() == wxSTREAM_READ_ERROR )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to read the compressed file \"%s\"" ), m_source.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    return m_blockEnd > 0;
+}
+
+
+char* GZIP_LINE_READER::ReadLine()
+{
+    m_length  = 0;
+
+    for(;;)
+    {
+        if( m_blockNext == m_blockEnd && !readBlock() )
+            break;
+
+        const char* start = &m_block[m_blockNext];
+        const char* eol   = (const char*) memchr( start, '\n', m_blockEnd - m_blockNext );
+        size_t      count = eol ? eol - start + 1 : m_blockEnd - m_blockNext;
+
+        if( m_length + count > m_maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        if( m_length + count + 1 > m_capacity )
+            expandCapacity( std::max<unsigned>( m_capacity * 2, m_length + count + 1 ) );
+
+        memcpy( m_line + m_length, start, count );
+        m_length += count;
+        m_blockNext += count;
+
+        if( eol )
+            break;
+    }
+
+    m_line[ m_length ] = 0;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return m_length ? m_line : NULL;
+}
+
+
 //-----<OUTPUTFORMATTER>----------------------------------------------------
 
 // factor out a common GetQuoteChar
@@ -365,6 +630,22 @@ const char* OUTPUTFORMATTER::GetQuoteChar( const char* wrapee )
 
 int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )
 {
+    // Many format strings are only punctuation, like ")\n": write them as they are
+    const char* end = fmt;
+
+    while( *end && *end != '%' )
+        ++end;
+
+    if( !*end )
+    {
+        int len = end - fmt;
+
+        if( len > 0 )
+            write( fmt, len );
+
+        return len;
+    }
+
     // This function can call vsnprintf twice.
     // But internally, vsnprintf retrieves arguments from the va_list identified by arg as if
     // va_arg was used on it, and thus the state of the va_list is likely to be altered by the call.
@@ -412,12 +693,18 @@ int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... )
     int result = 0;
     int total  = 0;
 
-    for( int i=0; i<nestLevel;  ++i )
+    if( nestLevel > 0 )
     {
-        // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+        static const char spaces[] = "                                                  ";
+        const int         maxCount = sizeof( spaces ) - 1;
 
-        total += result;
+        // no error checking needed, an exception indicates an error.
+        for( int count = nestLevel * NESTWIDTH;  count > 0;  count -= maxCount )
+        {
+            result = std::min( count, maxCount );
+            write( spaces, result );
+            total += result;
+        }
     }
 
     // no error checking needed, an exception indicates an error.
@@ -507,26 +794,58 @@ void STRING_FORMATTER::StripUseless()
 FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName, const wxChar* aMode,
                                             char aQuoteChar ):
     OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
-    m_filename( aFileName )
+    m_filename( aFileName ),
+    m_pendingCount( 0 )
 {
     m_fp = wxFopen( aFileName, aMode );
 
     if( !m_fp )
         THROW_IO_ERROR( strerror( errno ) );
+
+    m_pending.resize( FILE_OUTPUTFMTBUFZ );
 }
 
 
 FILE_OUTPUTFORMATTER::~FILE_OUTPUTFORMATTER()
 {
     if( m_fp )
+    {
+        // Like for the buffer of the FILE, an error at this point cannot be reported
+        flushPending();
         fclose( m_fp );
+    }
+}
+
+
+bool FILE_OUTPUTFORMATTER::flushPending()
+{
+    size_t count = m_pendingCount;
+
+    m_pendingCount = 0;
+
+    return !count || fwrite( &m_pending[0], count, 1, m_fp ) == 1;
 }
 
 
 void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
 {
-    if( fwrite( aOutBuf, (unsigned) aCount, 1, m_fp ) != 1 )
-        THROW_IO_ERROR( strerror( errno ) );
+    // Gather the small writes in a large buffer: fwrite() locks the FILE at each call
+    if( m_pendingCount + aCount > m_pending.size() )
+    {
+        if( !flushPending() )
+            THROW_IO_ERROR( strerror( errno ) );
+
+        if( (size_t) aCount >= m_pending.size() )
+        {
+            if( fwrite( aOutBuf, (unsigned) aCount, 1, m_fp ) != 1 )
+                THROW_IO_ERROR( strerror( errno ) );
+
+            return;
+        }
+    }
+
+    memcpy( &m_pending[m_pendingCount], aOutBuf, aCount );
+    m_pendingCount += aCount;
 }
 
 
@@ -549,3 +868,68 @@ void STREAM_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
     }
 }
 
+
+//-----<GZIP_OUTPUTFORMATTER>----------------------------------------
+
+GZIP_OUTPUTFORMATTER::GZIP_OUTPUTFORMATTER( const wxString& aFileName, char aQuoteChar ) :
+    OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
+    m_pendingCount( 0 )
+{
+    m_file.reset( new wxFFileOutputStream( aFileName ) );
+
+    if( !m_file->IsOk() )
+        THROW_IO_ERROR( strerror( errno ) );
+
+    m_stream.reset( new wxZlibOutputStream( *m_file, wxZ_DEFAULT_COMPRESSION, wxZLIB_GZIP ) );
+    m_pending.resize( FILE_OUTPUTFMTBUFZ );
+}
+
+
+GZIP_OUTPUTFORMATTER::~GZIP_OUTPUTFORMATTER()
+{
+    // Like for FILE_OUTPUTFORMATTER, an error at this point cannot be reported
+    flushPending();
+
+    // the deflating stream writes the end of the compressed data to the file stream
+    m_stream->Close();
+    m_stream.reset();
+    m_file->Close();
+}
+
+
+bool GZIP_OUTPUTFORMATTER::IsGzipFileName( const wxString& aFileName )
+{
+    return wxFileName( aFileName ).GetExt().IsSameAs( wxT( "gz" ), false );
+}
+
+
+bool GZIP_OUTPUTFORMATTER::flushPending()
+{
+    size_t count = m_pendingCount;
+
+    m_pendingCount = 0;
+
+    return !count || m_stream->Write( &m_pending[0], count ).LastWrite() == count;
+}
+
+
+void GZIP_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
+{
+    // Deflate large blocks: each Write() of the stream runs the compressor
+    if( m_pendingCount + aCount > m_pending.size() )
+    {
+        if( !flushPending() )
+            THROW_IO_ERROR( _( "GZIP_OUTPUTFORMATTER write error" ) );
+
+        if( (size_t) aCount >= m_pending.size() )
+        {
+            if( m_stream->Write( aOutBuf, aCount ).LastWrite() != (size_t) aCount )
+                THROW_IO_ERROR( _( "GZIP_OUTPUTFORMATTER write error" ) );
+
+            return;
+        }
+    }
+
+    memcpy( &m_pending[m_pendingCount], aOutBuf, aCount );
+    m_pendingCount += aCount;
+}
@@ -294,8 +294,12 @@ bool PGM_SINGLE_TOP::OnPgmInit()
     }
 #endif
 
-    if( !InitPgm() )
-        return false;
+    {
+        SCOPED_STARTUP_PHASE phase( this, wxT( "Program initialization" ) );
+
+        if( !InitPgm() )
+            return false;
+    }
 
 #if !defined(BUILD_KIWAY_DLL)
 
@@ -362,7 +366,13 @@ bool PGM_SINGLE_TOP::OnPgmInit()
     // Use KIWAY to create a top window, which registers its existence also.
     // "TOP_FRAME" is a macro that is passed on compiler command line from CMake,
     // and is one of the types in FRAME_T.
-    KIWAY_PLAYER* frame = Kiway.Player( appType, true );
+    KIWAY_PLAYER* frame;
+
+    {
+        SCOPED_STARTUP_PHASE phase( this, wxT( "Top frame creation" ) );
+
+        frame = Kiway.Player( appType, true );
+    }
 
     Kiway.SetTop( frame );
 
@@ -425,5 +435,7 @@ bool PGM_SINGLE_TOP::OnPgmInit()
 
     frame->Show();
 
+    ReportStartupPhases();
+
     return true;
 }
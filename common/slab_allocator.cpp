@@ -0,0 +1,276 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <slab_allocator.h>
+#include <memory_usage.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace
+{
+
+struct SLOT
+{
+    SLOT* m_Next;
+};
+
+
+///> The slots moved at once between a thread and the shared free list of their size
+const size_t BATCH_SIZE = 32;
+
+///> The smallest slab: the slabs of the large sizes hold at least BATCH_SIZE slots
+const size_t SLAB_SIZE = 64 * 1024;
+
+const size_t CLASS_COUNT = SLAB_ALLOCATOR::MAX_SIZE / SLAB_ALLOCATOR::GRANULARITY;
+
+
+/**
+ * The slots of a size shared by the threads
+ */
+struct SIZE_CLASS
+{
+    std::mutex                           m_Lock;
+    SLOT*                                m_Free = nullptr;
+    size_t                               m_FreeCount = 0;
+    char*                                m_Next = nullptr;     ///< the free end of the last slab
+    char*                                m_End = nullptr;
+    std::vector<std::unique_ptr<char[]>> m_Slabs;
+};
+
+
+SIZE_CLASS* sizeClasses()
+{
+    // Never destroyed: the objects may be freed by the static destructors of other modules
+    static SIZE_CLASS* classes = new SIZE_CLASS[CLASS_COUNT];
+
+    return classes;
+}
+
+
+size_t classIndex( size_t aSize )
+{
+    return ( std::max<size_t>( aSize, 1 ) - 1 ) / SLAB_ALLOCATOR::GRANULARITY;
+}
+
+
+size_t slotSize( size_t aIndex )
+{
+    return ( aIndex + 1 ) * SLAB_ALLOCATOR::GRANULARITY;
+}
+
+
+/**
+ * Moves up to aCount slots of the class aIndex to the list aList, from the shared free list
+ * or else from the last slab
+ */
+void takeSlots( size_t aIndex, SLOT*& aList, size_t& aListCount, size_t aCount )
+{
+    SIZE_CLASS&                 sizeClass = sizeClasses()[aIndex];
+    std::lock_guard<std::mutex> lock( sizeClass.m_Lock );
+
+    while( aCount > 0 && sizeClass.m_Free )
+    {
+        SLOT* slot = sizeClass.m_Free;
+
+        sizeClass.m_Free = slot->m_Next;
+        sizeClass.m_FreeCount--;
+        slot->m_Next = aList;
+        aList = slot;
+        aListCount++;
+        aCount--;
+    }
+
+    size_t size = slotSize( aIndex );
+
+    while( aCount > 0 )
+    {
+        if( sizeClass.m_Next + size > sizeClass.m_End )
+        {
+            size_t slabSize = std::max( SLAB_SIZE, BATCH_SIZE * size );
+
+            sizeClass.m_Slabs.emplace_back( new char[slabSize] );
+            sizeClass.m_Next = sizeClass.m_Slabs.back().get();
+            sizeClass.m_End = sizeClass.m_Next + slabSize;
+        }
+
+        SLOT* slot = reinterpret_cast<SLOT*>( sizeClass.m_Next );
+
+        sizeClass.m_Next += size;
+        slot->m_Next = aList;
+        aList = slot;
+        aListCount++;
+        aCount--;
+    }
+}
+
+
+///> Moves up to aCount slots of aList to the shared free list of the class aIndex
+void giveSlots( size_t aIndex, SLOT*& aList, size_t& aListCount, size_t aCount )
+{
+    SIZE_CLASS&                 sizeClass = sizeClasses()[aIndex];
+    std::lock_guard<std::mutex> lock( sizeClass.m_Lock );
+
+    while( aCount > 0 && aList )
+    {
+        SLOT* slot = aList;
+
+        aList = slot->m_Next;
+        aListCount--;
+        slot->m_Next = sizeClass.m_Free;
+        sizeClass.m_Free = slot;
+        sizeClass.m_FreeCount++;
+        aCount--;
+    }
+}
+
+
+/**
+ * The free slots of a thread, given back to the shared lists when the thread ends
+ */
+struct THREAD_CACHE
+{
+    SLOT*  m_Free[CLASS_COUNT] = {};
+    size_t m_Count[CLASS_COUNT] = {};
+
+    ~THREAD_CACHE();
+};
+
+
+///> Set once the cache of the thread is destroyed: the objects freed later by the static
+///> destructors go straight to the shared lists
+thread_local bool threadCacheDestroyed = false;
+
+
+THREAD_CACHE::~THREAD_CACHE()
+{
+    for( size_t ii = 0; ii < CLASS_COUNT; ii++ )
+        giveSlots( ii, m_Free[ii], m_Count[ii], m_Count[ii] );
+
+    threadCacheDestroyed = true;
+}
+
+
+THREAD_CACHE* threadCache()
+{
+    thread_local THREAD_CACHE cache;
+
+    return threadCacheDestroyed ? nullptr : &cache;
+}
+
+
+MEMORY_USAGE_PROVIDER freeSlotsMemory( "Free slab slots", &SLAB_ALLOCATOR::FreeBytes );
+
+} // namespace
+
+
+void* SLAB_ALLOCATOR::Allocate( size_t aSize )
+{
+#if defined( KICAD_SANITIZE ) || defined( KICAD_USE_VALGRIND )
+    return ::operator new( aSize );
+#else
+    if( aSize > MAX_SIZE )
+        return ::operator new( aSize );
+
+    size_t        index = classIndex( aSize );
+    THREAD_CACHE* cache = threadCache();
+    SLOT*         slot;
+
+    if( !cache )
+    {
+        SLOT*  list = nullptr;
+        size_t count = 0;
+
+        takeSlots( index, list, count, 1 );
+        return list;
+    }
+
+    if( !cache->m_Free[index] )
+        takeSlots( index, cache->m_Free[index], cache->m_Count[index], BATCH_SIZE );
+
+    slot = cache->m_Free[index];
+    cache->m_Free[index] = slot->m_Next;
+    cache->m_Count[index]--;
+
+    return slot;
+#endif
+}
+
+
+void SLAB_ALLOCATOR::Free( void* aPtr, size_t aSize )
+{
+#if defined( KICAD_SANITIZE ) || defined( KICAD_USE_VALGRIND )
+    ::operator delete( aPtr );
+#else
+    if( !aPtr )
+        return;
+
+    if( aSize > MAX_SIZE )
+    {
+        ::operator delete( aPtr );
+        return;
+    }
+
+    size_t        index = classIndex( aSize );
+    THREAD_CACHE* cache = threadCache();
+    SLOT*         slot = static_cast<SLOT*>( aPtr );
+
+    if( !cache )
+    {
+        size_t count = 1;
+
+        slot->m_Next = nullptr;
+        giveSlots( index, slot, count, 1 );
+        return;
+    }
+
+    slot->m_Next = cache->m_Free[index];
+    cache->m_Free[index] = slot;
+
+    // The objects allocated by a thread and freed by another one go back to the shared list
+    if( ++cache->m_Count[index] > 2 * BATCH_SIZE )
+        giveSlots( index, cache->m_Free[index], cache->m_Count[index], BATCH_SIZE );
+#endif
+}
+
+
+size_t SLAB_ALLOCATOR::FreeBytes()
+{
+    // The slots cached by the threads are not counted: there are at most 2 * BATCH_SIZE of
+    // them per size and per thread
+    size_t bytes = 0;
+
+    for( size_t ii = 0; ii < CLASS_COUNT; ii++ )
+    {
+        SIZE_CLASS&                 sizeClass = sizeClasses()[ii];
+        std::lock_guard<std::mutex> lock( sizeClass.m_Lock );
+
+        bytes += sizeClass.m_FreeCount * slotSize( ii ) + ( sizeClass.m_End - sizeClass.m_Next );
+    }
+
+    return bytes;
+}
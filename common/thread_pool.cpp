@@ -0,0 +1,236 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
+
+#include <algorithm>
+#include <chrono>
+
+
+THREAD_POOL::THREAD_POOL( unsigned aThreadCount ) :
+        m_stopping( false )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max( 1u, std::thread::hardware_concurrency() );
+
+    for( unsigned ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( &THREAD_POOL::workerLoop, this );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_stopping = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& worker : m_workers )
+        worker.join();
+}
+
+
+std::future<void> THREAD_POOL::Submit( std::function<void()> aTask, TASK_PRIORITY aPriority )
+{
+    TASK task = std::make_shared<std::packaged_task<void()>>( std::move( aTask ) );
+    std::future<void> result = task->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( aPriority == TASK_PRIORITY::BACKGROUND )
+            m_backgroundTasks.push_back( std::move( task ) );
+        else
+            m_tasks.push_back( std::move( task ) );
+    }
+
+    m_wakeUp.notify_one();
+
+    return result;
+}
+
+
+void THREAD_POOL::RunParallel( const std::function<void()>& aWork, unsigned aParallelism,
+                               TASK_PRIORITY aPriority )
+{
+    unsigned helpers = std::min( aParallelism, GetThreadCount() + 1 );
+    std::vector<std::future<void>> returns;
+
+    for( unsigned ii = 1; ii < helpers; ++ii )
+        returns.push_back( Submit( aWork, aPriority ) );
+
+    aWork();
+
+    for( std::future<void>& ret : returns )
+    {
+        // Help instead of blocking: the workers may all be waiting for tasks queued behind ours
+        while( ret.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+        {
+            if( !runPendingTask() )
+                ret.wait_for( std::chrono::microseconds( 100 ) );
+        }
+
+        ret.get();
+    }
+}
+
+
+bool THREAD_POOL::runPendingTask()
+{
+    TASK task;
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( !hasTasks() )
+            return false;
+
+        task = popTask();
+    }
+
+    ( *task )();
+    return true;
+}
+
+
+THREAD_POOL::TASK THREAD_POOL::popTask()
+{
+    std::deque<TASK>& queue = m_tasks.empty() ? m_backgroundTasks : m_tasks;
+    TASK              task = std::move( queue.front() );
+
+    queue.pop_front();
+    return task;
+}
+
+
+void THREAD_POOL::workerLoop()
+{
+    while( true )
+    {
+        TASK task;
+
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+
+            m_wakeUp.wait( lock, [this]() { return m_stopping || hasTasks(); } );
+
+            if( m_stopping && !hasTasks() )
+                return;
+
+            task = popTask();
+        }
+
+        ( *task )();
+    }
+}
+
+
+THREAD_POOL& GetKiCadThreadPool()
+{
+    static THREAD_POOL pool;
+
+    return pool;
+}
+
+
+TASK_GROUP::TASK_GROUP( TASK_PRIORITY aPriority, THREAD_POOL& aPool ) :
+        m_pool( aPool ),
+        m_priority( aPriority ),
+        m_cancelled( false )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    for( std::future<void>& task : m_tasks )
+    {
+        if( task.valid() )
+            task.wait();
+    }
+}
+
+
+void TASK_GROUP::Run( std::function<void()> aTask )
+{
+    m_tasks.push_back( m_pool.Submit(
+            [this, aTask]()
+            {
+                if( !m_cancelled )
+                    aTask();
+            },
+            m_priority ) );
+}
+
+
+void TASK_GROUP::RunParallel( const std::function<void()>& aWork, unsigned aParallelism )
+{
+    unsigned count = std::max( 1u, std::min( aParallelism, m_pool.GetThreadCount() ) );
+
+    for( unsigned ii = 0; ii < count; ++ii )
+        Run( aWork );
+}
+
+
+void TASK_GROUP::Wait( PROGRESS_REPORTER* aReporter, const std::function<void()>& aOnRefresh )
+{
+    bool refreshing = aReporter || aOnRefresh;
+
+    for( std::future<void>& task : m_tasks )
+    {
+        if( !task.valid() )
+            continue;
+
+        while( task.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+        {
+            if( refreshing )
+            {
+                if( aReporter && !aReporter->KeepRefreshing() )
+                    Cancel();
+
+                if( aOnRefresh )
+                    aOnRefresh();
+
+                task.wait_for( std::chrono::milliseconds( 100 ) );
+            }
+            else if( !m_pool.runPendingTask() )
+            {
+                task.wait_for( std::chrono::microseconds( 100 ) );
+            }
+        }
+    }
+
+    std::vector<std::future<void>> tasks;
+
+    tasks.swap( m_tasks );
+
+    // All are done: rethrow the first exception
+    for( std::future<void>& task : tasks )
+    {
+        if( task.valid() )
+            task.get();
+    }
+}
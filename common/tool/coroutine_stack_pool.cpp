@@ -0,0 +1,184 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <tool/coroutine_stack_pool.h>
+
+#include <algorithm>
+#include <new>
+
+#include <wx/log.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Flag to enable the measure of the coroutine stack usage.
+ *
+ * Use "KICAD_COROUTINE_STACK" to enable.
+ *
+ * @ingroup trace_env_vars
+ */
+static const wxChar* const traceCoroutineStack = wxT( "KICAD_COROUTINE_STACK" );
+
+
+COROUTINE_STACK_POOL& COROUTINE_STACK_POOL::Get()
+{
+    static COROUTINE_STACK_POOL pool;
+    return pool;
+}
+
+
+COROUTINE_STACK_POOL::COROUTINE_STACK_POOL() :
+        m_peakUsage( 0 )
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    m_pageSize = info.dwPageSize;
+#else
+    m_pageSize = (size_t) sysconf( _SC_PAGESIZE );
+#endif
+}
+
+
+COROUTINE_STACK_POOL::~COROUTINE_STACK_POOL()
+{
+    for( const auto& freeStacks : m_freeStacks )
+    {
+        for( const STACK& stack : freeStacks.second )
+            deallocate( stack );
+    }
+}
+
+
+COROUTINE_STACK_POOL::STACK COROUTINE_STACK_POOL::Acquire( size_t aSize )
+{
+    // Whole pages, so that the stacks of a size are interchangeable
+    aSize = ( ( aSize + m_pageSize - 1 ) / m_pageSize ) * m_pageSize;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::vector<STACK>&         freeStacks = m_freeStacks[aSize];
+
+        if( !freeStacks.empty() )
+        {
+            STACK stack = freeStacks.back();
+            freeStacks.pop_back();
+            return stack;
+        }
+    }
+
+    return allocate( aSize );
+}
+
+
+void COROUTINE_STACK_POOL::Release( const STACK& aStack )
+{
+    if( !aStack.m_Base )
+        return;
+
+    if( wxLog::IsAllowedTraceMask( traceCoroutineStack ) )
+    {
+        size_t usage = measureUsage( aStack );
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        m_peakUsage = std::max( m_peakUsage, usage );
+        wxLogTrace( traceCoroutineStack, wxT( "Coroutine stack: %d of %d bytes used (peak %d)" ),
+                    (int) usage, (int) aStack.m_Size, (int) m_peakUsage );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::vector<STACK>&         freeStacks = m_freeStacks[aStack.m_Size];
+
+        if( freeStacks.size() < MAX_FREE_STACKS )
+        {
+            freeStacks.push_back( aStack );
+            return;
+        }
+    }
+
+    deallocate( aStack );
+}
+
+
+size_t COROUTINE_STACK_POOL::measureUsage( const STACK& aStack )
+{
+    // The stacks grow down from zeroed memory: the lowest non-zero byte is the deepest one
+    // reached by any of the coroutines which ran on this stack
+    const char* end = aStack.m_Base + aStack.m_Size;
+    const char* deepest = std::find_if( (const char*) aStack.m_Base, end,
+                                        []( char aByte )
+                                        {
+                                            return aByte != 0;
+                                        } );
+
+    return end - deepest;
+}
+
+
+COROUTINE_STACK_POOL::STACK COROUTINE_STACK_POOL::allocate( size_t aSize )
+{
+    STACK  stack;
+    size_t mappingSize = aSize + m_pageSize;    // with the guard page
+
+#ifdef _WIN32
+    char* mapping = (char*) VirtualAlloc( nullptr, mappingSize, MEM_COMMIT | MEM_RESERVE,
+                                          PAGE_READWRITE );
+    DWORD oldProtection;
+
+    if( !mapping )
+        throw std::bad_alloc();
+
+    VirtualProtect( mapping, m_pageSize, PAGE_NOACCESS, &oldProtection );
+#else
+    void* mapping = mmap( nullptr, mappingSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+    if( mapping == MAP_FAILED )
+        throw std::bad_alloc();
+
+    mprotect( mapping, m_pageSize, PROT_NONE );
+#endif
+
+    stack.m_Base = (char*) mapping + m_pageSize;
+    stack.m_Size = aSize;
+
+    return stack;
+}
+
+
+void COROUTINE_STACK_POOL::deallocate( const STACK& aStack )
+{
+    char* mapping = aStack.m_Base - m_pageSize;
+
+#ifdef _WIN32
+    VirtualFree( mapping, 0, MEM_RELEASE );
+#else
+    munmap( mapping, aStack.m_Size + m_pageSize );
+#endif
+}
@@ -31,6 +31,27 @@
 using namespace std::placeholders;
 
 
+/**
+ * @return true if the type of every selected item is in aTypes, from the cached types of the
+ * selection (the items of other types may match aTypes too, see EDA_ITEM::IsType())
+ */
+static bool allTypesListed( const SELECTION& aSelection, const KICAD_T aTypes[] )
+{
+    for( KICAD_T type : aSelection.GetItemTypes() )
+    {
+        const KICAD_T* p = aTypes;
+
+        while( *p != EOT && *p != type )
+            ++p;
+
+        if( *p == EOT )
+            return false;
+    }
+
+    return true;
+}
+
+
 bool SELECTION_CONDITIONS::NotEmpty( const SELECTION& aSelection )
 {
     return !aSelection.Empty();
@@ -75,13 +96,7 @@ SELECTION_CONDITION SELECTION_CONDITIONS::LessThan( int aNumber )
 
 bool SELECTION_CONDITIONS::hasTypeFunc( const SELECTION& aSelection, KICAD_T aType )
 {
-    for( const auto& item : aSelection )
-    {
-        if( item->Type() == aType )
-            return true;
-    }
-
-    return false;
+    return aSelection.HasType( aType );
 }
 
 
@@ -92,6 +107,9 @@ bool SELECTION_CONDITIONS::onlyTypeFunc( const SELECTION& aSelection, KICAD_T aT
 
     KICAD_T types[] = { aType, EOT };
 
+    if( allTypesListed( aSelection, types ) )
+        return true;
+
     for( const auto& item : aSelection )
     {
         if( !item->IsType( types ) )
@@ -107,6 +125,9 @@ bool SELECTION_CONDITIONS::onlyTypesFunc( const SELECTION& aSelection, const KIC
     if( aSelection.Empty() )
         return false;
 
+    if( allTypesListed( aSelection, aTypes ) )
+        return true;
+
     for( const auto& item : aSelection )
     {
         if( !item->IsType( aTypes ) )
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <core/optional.h>
 #include <map>
+#include <profile.h>
 #include <stack>
 #include <trace_helpers.h>
 
@@ -44,6 +45,63 @@
 
 #include <class_draw_panel_gal.h>
 
+/**
+ * Flag to enable the trace of the time spent processing each event.
+ *
+ * Use "KICAD_TOOL_LATENCY" to enable.
+ *
+ * @ingroup trace_env_vars
+ */
+static const wxChar* const traceToolLatency = wxT( "KICAD_TOOL_LATENCY" );
+
+
+/**
+ * The categories and actions of all the events of a list, to skip without matching them one
+ * by one the lists which cannot match an event: most of them, for the mouse motion and drag
+ * events which are dispatched many times per second.
+ */
+struct EVENT_MASK
+{
+    EVENT_MASK()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        m_categories = 0;
+        m_actions = 0;
+    }
+
+    void Add( const TOOL_EVENT_LIST& aEvents )
+    {
+        for( auto it = aEvents.cbegin(); it != aEvents.cend(); ++it )
+        {
+            m_categories |= it->Category();
+            m_actions |= it->Action();
+        }
+    }
+
+    /**
+     * @return false if no event of the list can match aEvent (see TOOL_EVENT::Matches()).
+     */
+    bool MayMatch( const TOOL_EVENT& aEvent ) const
+    {
+        if( !( m_categories & aEvent.Category() ) )
+            return false;
+
+        // The commands and the messages also match on their name
+        if( aEvent.Category() == TC_COMMAND || aEvent.Category() == TC_MESSAGE )
+            return true;
+
+        return ( m_actions & aEvent.Action() ) != 0;
+    }
+
+    int m_categories;
+    int m_actions;
+};
+
+
 /// Struct describing the current execution state of a TOOL
 struct TOOL_MANAGER::TOOL_STATE
 {
@@ -65,7 +123,9 @@ struct TOOL_MANAGER::TOOL_STATE
         cofunc             = aState.cofunc;
         wakeupEvent        = aState.wakeupEvent;
         waitEvents         = aState.waitEvents;
+        waitMask           = aState.waitMask;
         transitions        = aState.transitions;
+        transitionMask     = aState.transitionMask;
         vcSettings         = aState.vcSettings;
         // do not copy stateStack
     }
@@ -107,10 +167,16 @@ struct TOOL_MANAGER::TOOL_STATE
     /// List of events the tool is currently waiting for
     TOOL_EVENT_LIST waitEvents;
 
+    /// Categories and actions of waitEvents
+    EVENT_MASK waitMask;
+
     /// List of possible transitions (ie. association of events and state handlers that are executed
     /// upon the event reception
     std::vector<TRANSITION> transitions;
 
+    /// Categories and actions of the events of all the transitions
+    EVENT_MASK transitionMask;
+
     /// VIEW_CONTROLS settings to preserve settings when the tools are switched
     KIGFX::VC_SETTINGS vcSettings;
 
@@ -126,7 +192,9 @@ struct TOOL_MANAGER::TOOL_STATE
         cofunc             = aState.cofunc;
         wakeupEvent        = aState.wakeupEvent;
         waitEvents         = aState.waitEvents;
+        waitMask           = aState.waitMask;
         transitions        = aState.transitions;
+        transitionMask     = aState.transitionMask;
         vcSettings         = aState.vcSettings;
         // do not copy stateStack
         return *this;
@@ -193,6 +261,7 @@ private:
         contextMenuTrigger = CMENU_OFF;
         vcSettings.Reset();
         transitions.clear();
+        transitionMask.Clear();
     }
 };
 
@@ -485,6 +554,7 @@ void TOOL_MANAGER::ShutdownTool( TOOL_BASE* aTool )
             st->shutdown = true;
             st->pendingWait = false;
             st->waitEvents.clear();
+            st->waitMask.Clear();
 
             if( st->cofunc )
             {
@@ -603,12 +673,16 @@ void TOOL_MANAGER::ScheduleNextState( TOOL_BASE* aTool, TOOL_STATE_FUNC& aHandle
     TOOL_STATE* st = m_toolState[aTool];
 
     st->transitions.emplace_back( TRANSITION( aConditions, aHandler ) );
+    st->transitionMask.Add( aConditions );
 }
 
 
 void TOOL_MANAGER::ClearTransitions( TOOL_BASE* aTool )
 {
-    m_toolState[aTool]->transitions.clear();
+    TOOL_STATE* st = m_toolState[aTool];
+
+    st->transitions.clear();
+    st->transitionMask.Clear();
 }
 
 
@@ -630,6 +704,8 @@ TOOL_EVENT* TOOL_MANAGER::ScheduleWait( TOOL_BASE* aTool, const TOOL_EVENT_LIST&
     // woken up when an event matching aConditions arrive
     st->pendingWait = true;
     st->waitEvents = aConditions;
+    st->waitMask.Clear();
+    st->waitMask.Add( aConditions );
 
     // switch context back to event dispatcher loop
     st->cofunc->KiYield();
@@ -661,7 +737,7 @@ bool TOOL_MANAGER::dispatchInternal( const TOOL_EVENT& aEvent )
         }
 
         // the tool state handler is waiting for events (i.e. called Wait() method)
-        if( st && st->pendingWait )
+        if( st && st->pendingWait && st->waitMask.MayMatch( aEvent ) )
         {
             if( st->waitEvents.Matches( aEvent ) )
             {
@@ -672,6 +748,7 @@ bool TOOL_MANAGER::dispatchInternal( const TOOL_EVENT& aEvent )
                 st->wakeupEvent = aEvent;
                 st->pendingWait = false;
                 st->waitEvents.clear();
+                st->waitMask.Clear();
 
                 if( st->cofunc )
                 {
@@ -707,7 +784,7 @@ bool TOOL_MANAGER::dispatchInternal( const TOOL_EVENT& aEvent )
 
         // no state handler in progress - check if there are any transitions (defined by
         // Go() method that match the event.
-        if( !st->transitions.empty() )
+        if( !st->transitions.empty() && st->transitionMask.MayMatch( aEvent ) )
         {
             for( TRANSITION& tr : st->transitions )
             {
@@ -731,6 +808,7 @@ bool TOOL_MANAGER::dispatchInternal( const TOOL_EVENT& aEvent )
 
                     // as the state changes, the transition table has to be set up again
                     st->transitions.clear();
+                    st->transitionMask.Clear();
 
                     wxLogTrace( kicadTraceToolStack,
                             "TOOL_MANAGER::dispatchInternal Running tool %s for event: %s",
@@ -813,6 +891,8 @@ void TOOL_MANAGER::DispatchContextMenu( const TOOL_EVENT& aEvent )
 
         st->pendingWait = true;
         st->waitEvents = TOOL_EVENT( TC_ANY, TA_ANY );
+        st->waitMask.Clear();
+        st->waitMask.Add( st->waitEvents );
 
         // Store the menu pointer in case it is changed by the TOOL when handling menu events
         ACTION_MENU* m = st->contextMenu;
@@ -928,7 +1008,9 @@ TOOL_MANAGER::ID_LIST::iterator TOOL_MANAGER::finishTool( TOOL_STATE* aState )
 
 bool TOOL_MANAGER::ProcessEvent( const TOOL_EVENT& aEvent )
 {
-    bool handled = processEvent( aEvent );
+    PROF_COUNTER latency;
+    bool         handled = processEvent( aEvent );
+    double       dispatchTime = latency.msecs();
 
     TOOL_STATE* activeTool = GetCurrentToolState();
 
@@ -947,6 +1029,9 @@ bool TOOL_MANAGER::ProcessEvent( const TOOL_EVENT& aEvent )
 
     UpdateUI( aEvent );
 
+    wxLogTrace( traceToolLatency, "TOOL_MANAGER::ProcessEvent %s: %.3f ms dispatching, "
+            "%.3f ms total", aEvent.Format(), dispatchTime, latency.msecs() );
+
     return handled;
 }
 
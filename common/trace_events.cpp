@@ -0,0 +1,151 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <trace_events.h>
+
+#include <cstdlib>
+#include <fstream>
+
+
+TRACE_EVENTS& TRACE_EVENTS::Get()
+{
+    // Never destroyed: the threads may still record while the static objects are destroyed
+    static TRACE_EVENTS* events = new TRACE_EVENTS();
+
+    return *events;
+}
+
+
+TRACE_EVENTS::TRACE_EVENTS() :
+        m_enabled( false ),
+        m_origin( std::chrono::steady_clock::now() )
+{
+    const char* outputFile = std::getenv( "KICAD_TRACE_EVENTS" );
+
+    if( outputFile && *outputFile )
+    {
+        m_outputFile = outputFile;
+        m_enabled = true;
+
+        std::atexit(
+                []()
+                {
+                    TRACE_EVENTS& events = Get();
+
+                    events.Enable( false );
+                    events.Write( events.m_outputFile );
+                } );
+    }
+}
+
+
+int TRACE_EVENTS::Enter()
+{
+    return threadBuffer()->m_Depth++;
+}
+
+
+void TRACE_EVENTS::Leave( const char* aName, int64_t aStart, int aDepth )
+{
+    THREAD_BUFFER* buffer = threadBuffer();
+    EVENT          event = { aName, aStart, Now() - aStart, aDepth };
+
+    buffer->m_Depth = aDepth;
+
+    std::lock_guard<std::mutex> lock( buffer->m_Lock );
+
+    if( buffer->m_Events.size() < EVENTS_PER_THREAD )
+        buffer->m_Events.push_back( event );
+    else
+        buffer->m_Events[buffer->m_Next] = event;
+
+    buffer->m_Next = ( buffer->m_Next + 1 ) % EVENTS_PER_THREAD;
+}
+
+
+TRACE_EVENTS::THREAD_BUFFER* TRACE_EVENTS::threadBuffer()
+{
+    thread_local THREAD_BUFFER* buffer = nullptr;
+
+    if( !buffer )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        m_buffers.emplace_back( new THREAD_BUFFER );
+        buffer = m_buffers.back().get();
+        buffer->m_ThreadId = (int) m_buffers.size();
+        buffer->m_Events.reserve( EVENTS_PER_THREAD );
+    }
+
+    return buffer;
+}
+
+
+void TRACE_EVENTS::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( const std::unique_ptr<THREAD_BUFFER>& buffer : m_buffers )
+    {
+        std::lock_guard<std::mutex> bufferLock( buffer->m_Lock );
+
+        buffer->m_Events.clear();
+        buffer->m_Next = 0;
+    }
+}
+
+
+bool TRACE_EVENTS::Write( const std::string& aFileName )
+{
+    std::ofstream out( aFileName );
+
+    if( !out )
+        return false;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( const std::unique_ptr<THREAD_BUFFER>& buffer : m_buffers )
+    {
+        std::lock_guard<std::mutex> bufferLock( buffer->m_Lock );
+
+        for( const EVENT& event : buffer->m_Events )
+        {
+            out << ( first ? "\n" : ",\n" );
+            first = false;
+
+            // The names are string literals of the code, which need no escaping
+            out << "{\"name\":\"" << event.m_Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << buffer->m_ThreadId << ",\"ts\":" << event.m_Start
+                << ",\"dur\":" << event.m_Duration
+                << ",\"args\":{\"depth\":" << event.m_Depth << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+
+    return out.good();
+}
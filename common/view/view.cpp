@@ -36,6 +36,15 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <trace_events.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -219,6 +228,9 @@ private:
     /// Stores layer numbers used by the item.
     std::vector<int> m_layers;
 
+    /// Bounding box of the item in the layer trees, marked dirty when the item changes.
+    BOX2I m_bbox;
+
     /**
      * Function saveLayers()
      * Saves layers used by the item.
@@ -291,9 +303,13 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_painter( NULL ),
     m_gal( NULL ),
     m_dynamic( aIsDynamic ),
+    m_dirtyAreaValid( false ),
+    m_partialRedraw( false ),
+    m_drawnItemCount( 0 ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_aggregateThreshold( 0.0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -339,6 +355,9 @@ void VIEW::AddLayer( int aLayer, bool aDisplayOnly )
         m_layers[aLayer].visible        = true;
         m_layers[aLayer].displayOnly    = aDisplayOnly;
         m_layers[aLayer].target         = TARGET_CACHED;
+        m_layers[aLayer].aggregateValid = false;
+        m_layers[aLayer].aggregateGroup = -1;
+        m_layers[aLayer].aggregateAge   = 0;
     }
 }
 
@@ -359,13 +378,15 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
 
+    const BOX2I& bbox = aItem->m_viewPrivData->m_bbox = aItem->ViewBBox();
+
     m_allItems->push_back( aItem );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Insert( aItem, bbox );
+        markTargetDirtyArea( l.target, bbox );
     }
 
     SetVisible( aItem, true );
@@ -399,7 +420,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        markTargetDirtyArea( l.target, viewData->m_bbox );
+        invalidateAggregate( layers[i] );
 
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
@@ -413,6 +435,58 @@ void VIEW::Remove( VIEW_ITEM* aItem )
 }
 
 
+void VIEW::RemoveItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    std::unordered_set<VIEW_ITEM*>                          removed;
+    std::unordered_map<int, std::unordered_set<VIEW_ITEM*>> layerItems;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        auto viewData = item ? item->viewPrivData() : nullptr;
+
+        if( !viewData || viewData->m_view != this )
+            continue;
+
+        removed.insert( item );
+        viewData->clearUpdateFlags();
+
+        int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
+        viewData->getLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            VIEW_LAYER& l = m_layers[layers[i]];
+            layerItems[layers[i]].insert( item );
+            markTargetDirtyArea( l.target, viewData->m_bbox );
+            invalidateAggregate( layers[i] );
+
+            // Clear the GAL cache
+            int prevGroup = viewData->getGroup( layers[i] );
+
+            if( prevGroup >= 0 )
+                m_gal->DeleteGroup( prevGroup );
+        }
+
+        viewData->deleteGroups();
+        viewData->m_view = nullptr;
+    }
+
+    if( removed.empty() )
+        return;
+
+    // The layer trees are searched for each removed item, or rebuilt if they lose many
+    for( const auto& entry : layerItems )
+        m_layers[entry.first].items->Update( entry.second, {} );
+
+    m_allItems->erase( std::remove_if( m_allItems->begin(), m_allItems->end(),
+                                       [&]( VIEW_ITEM* aItem )
+                                       {
+                                           return removed.count( aItem ) > 0;
+                                       } ),
+                       m_allItems->end() );
+}
+
+
 void VIEW::SetRequired( int aLayerId, int aRequiredId, bool aRequired )
 {
     wxCHECK( (unsigned) aLayerId < m_layers.size(), /*void*/ );
@@ -523,7 +597,10 @@ void VIEW::SetGAL( GAL* aGal )
 
     // clear group numbers, so everything is going to be recached
     if( recacheGroups )
+    {
         clearGroupCache();
+        resetAggregates();
+    }
 
     // every target has to be refreshed
     MarkDirty();
@@ -727,6 +804,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
     }
 
     m_layers = new_map;
+    invalidateAggregates();
 
     for( VIEW_ITEM* item : *m_allItems )
     {
@@ -792,6 +870,8 @@ void VIEW::UpdateLayerColor( int aLayer )
         m_layers[aLayer].items->Query( r, visitor );
         MarkTargetDirty( m_layers[aLayer].target );
     }
+
+    invalidateAggregate( aLayer );
 }
 
 
@@ -822,6 +902,7 @@ void VIEW::UpdateAllLayersColor()
         }
     }
 
+    invalidateAggregates();
     MarkDirty();
 }
 
@@ -881,6 +962,9 @@ void VIEW::SetTopLayer( int aLayer, bool aEnabled )
         if( m_enableOrderModifier )
             m_layers[aLayer].renderingOrder -= TOP_LAYER_MODIFIER;
     }
+
+    // The depth of the items is stored in the aggregate groups
+    invalidateAggregates();
 }
 
 
@@ -921,6 +1005,7 @@ void VIEW::ClearTopLayers()
     }
 
     m_topLayers.clear();
+    invalidateAggregates();
 }
 
 
@@ -958,10 +1043,12 @@ void VIEW::UpdateAllLayersOrder()
 
 struct VIEW::drawItem
 {
-    drawItem( VIEW* aView, int aLayer, bool aUseDrawPriority, bool aReverseDrawOrder ) :
+    drawItem( VIEW* aView, int aLayer, bool aUseDrawPriority, bool aReverseDrawOrder,
+              bool aDeferDraw = false ) :
         view( aView ), layer( aLayer ),
         useDrawPriority( aUseDrawPriority ),
-        reverseDrawOrder( aReverseDrawOrder )
+        reverseDrawOrder( aReverseDrawOrder ),
+        deferDraw( aUseDrawPriority || aDeferDraw )
     {
     }
 
@@ -975,7 +1062,7 @@ struct VIEW::drawItem
         if( !drawCondition )
             return true;
 
-        if( useDrawPriority )
+        if( deferDraw )
             drawItems.push_back( aItem );
         else
             view->draw( aItem, layer );
@@ -983,8 +1070,12 @@ struct VIEW::drawItem
         return true;
     }
 
-    void deferredDraw()
+    ///> Sorts the deferred items in the drawing order
+    void sortItems()
     {
+        if( !useDrawPriority )
+            return;
+
         if( reverseDrawOrder )
             std::sort( drawItems.begin(), drawItems.end(),
                        []( VIEW_ITEM* a, VIEW_ITEM* b ) -> bool {
@@ -995,6 +1086,11 @@ struct VIEW::drawItem
                        []( VIEW_ITEM* a, VIEW_ITEM* b ) -> bool {
                            return a->viewPrivData()->m_drawPriority < b->viewPrivData()->m_drawPriority;
                        });
+    }
+
+    void deferredDraw()
+    {
+        sortItems();
 
         for( auto item : drawItems )
             view->draw( item, layer );
@@ -1002,27 +1098,157 @@ struct VIEW::drawItem
 
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
-    bool useDrawPriority, reverseDrawOrder;
+    bool useDrawPriority, reverseDrawOrder, deferDraw;
     std::vector<VIEW_ITEM*> drawItems;
 };
 
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    bool aggregated = useAggregates();
+
+    // On a partial redraw, the cached and noncached targets are only drawn in the redraw area
+    const BOX2I& mainRect = m_partialRedraw ? m_redrawArea : aRect;
+
+    const RENDER_SETTINGS* settings = m_painter->GetSettings();
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
         {
-            drawItem drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder );
+            // Nothing drawn on a fully transparent layer would show up
+            if( settings->IsTransparentLayer( l->id ) )
+                continue;
 
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
 
-            if( m_useDrawPriority )
+            if( aggregated && isAggregateCurrent( *l ) )
+            {
+                if( l->aggregateGroup >= 0 )
+                    m_gal->DrawGroup( l->aggregateGroup );
+
+                continue;
+            }
+
+            // The noncached items are drawn by the painter for each frame, so they are worth
+            // drawing in tiles; the GAL tells if it can
+            bool tiled = l->target == TARGET_NONCACHED;
+
+            drawItem drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder, tiled );
+
+            l->items->Query( l->target == TARGET_OVERLAY ? aRect : mainRect, drawFunc );
+
+            if( tiled )
+            {
+                drawFunc.sortItems();
+
+                if( drawTiled( l->id, drawFunc.drawItems ) )
+                    continue;
+
+                for( VIEW_ITEM* item : drawFunc.drawItems )
+                    draw( item, l->id );
+            }
+            else if( m_useDrawPriority )
+            {
                 drawFunc.deferredDraw();
+            }
+        }
+    }
+}
+
+
+bool VIEW::drawTiled( int aLayer, const std::vector<VIEW_ITEM*>& aItems )
+{
+    // Below this, the threads cost more than they save
+    const size_t MIN_TILED_ITEMS = 64;
+
+    if( aItems.size() < MIN_TILED_ITEMS )
+        return false;
+
+    THREAD_POOL& pool = GetKiCadThreadPool();
+
+    // More tiles than threads, as the items are not evenly spread over the screen
+    int tileCount = m_gal->BeginTiledDrawing( 2 * ( pool.GetThreadCount() + 1 ) );
+
+    if( tileCount == 0 )
+        return false;
+
+    for( int ii = m_tilePainters.size(); ii < tileCount; ++ii )
+    {
+        PAINTER* painter = m_painter->Clone( m_gal->GetTile( ii ) );
+
+        if( !painter )
+        {
+            m_gal->EndTiledDrawing();
+            return false;
         }
+
+        m_tilePainters.emplace_back( painter );
     }
+
+    double depth = m_layers.at( aLayer ).renderingOrder;
+
+    // The items the painter does not know are drawn by themselves, on the VIEW GAL
+    std::vector<std::unordered_set<const VIEW_ITEM*>> skipped( tileCount );
+
+    std::atomic<int> next( 0 );
+
+    auto work = [&]()
+    {
+        for( int ii = next++; ii < tileCount; ii = next++ )
+        {
+            GAL*     gal = m_gal->GetTile( ii );
+            PAINTER* painter = m_tilePainters[ii].get();
+
+            painter->SetGAL( gal );
+            gal->SetLayerDepth( depth );
+
+            // The tile area, with a margin for the antialiasing
+            const MATRIX3x3D& screenWorld = gal->GetScreenWorldMatrix();
+            VECTOR2D          tileSize( gal->GetScreenPixelSize() );
+            BOX2D             area( screenWorld * VECTOR2D( -2, -2 ),
+                                    screenWorld * ( tileSize + VECTOR2D( 2, 2 ) )
+                                            - screenWorld * VECTOR2D( -2, -2 ) );
+            area.Normalize();
+
+            BOX2I areai( VECTOR2I( (int) std::floor( area.GetX() ),
+                                   (int) std::floor( area.GetY() ) ),
+                         VECTOR2I( (int) std::ceil( area.GetWidth() ) + 1,
+                                   (int) std::ceil( area.GetHeight() ) + 1 ) );
+
+            for( VIEW_ITEM* item : aItems )
+            {
+                if( !areai.Intersects( item->viewPrivData()->m_bbox ) )
+                    continue;
+
+                if( !painter->Draw( item, aLayer ) )
+                    skipped[ii].insert( item );
+            }
+        }
+    };
+
+    pool.RunParallel( work, std::min<int>( tileCount, pool.GetThreadCount() + 1 ) );
+
+    m_gal->EndTiledDrawing();
+
+    m_drawnItemCount += aItems.size();
+
+    std::unordered_set<const VIEW_ITEM*> skippedItems;
+
+    for( const std::unordered_set<const VIEW_ITEM*>& tileSkipped : skipped )
+        skippedItems.insert( tileSkipped.begin(), tileSkipped.end() );
+
+    if( !skippedItems.empty() )
+    {
+        for( VIEW_ITEM* item : aItems )
+        {
+            if( skippedItems.count( item ) )
+                item->ViewDraw( aLayer, this );  // Alternative drawing method
+        }
+    }
+
+    return true;
 }
 
 
@@ -1033,6 +1259,8 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( !viewData )
         return;
 
+    m_drawnItemCount++;
+
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
@@ -1119,6 +1347,7 @@ void VIEW::Clear()
 
     m_nextDrawPriority = 0;
 
+    resetAggregates();
     m_gal->ClearCache();
 }
 
@@ -1127,6 +1356,28 @@ void VIEW::ClearTargets()
 {
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
+        // When only some items have changed, the rest of the targets is kept from the
+        // previous frame
+        m_partialRedraw = m_dirtyAreaValid && m_gal->IsRedrawAreaSupported();
+
+        if( m_partialRedraw )
+        {
+            BOX2I screenArea = dirtyScreenArea();
+
+            m_gal->SetRedrawArea( screenArea );
+
+            // Redraw the items in the pixels really cleared
+            BOX2D area( ToWorld( VECTOR2D( screenArea.GetOrigin() ) ),
+                        ToWorld( VECTOR2D( screenArea.GetEnd() ) )
+                                - ToWorld( VECTOR2D( screenArea.GetOrigin() ) ) );
+            area.Normalize();
+
+            m_redrawArea = BOX2I( VECTOR2I( (int) std::floor( area.GetX() ),
+                                            (int) std::floor( area.GetY() ) ),
+                                  VECTOR2I( (int) std::ceil( area.GetWidth() ) + 1,
+                                            (int) std::ceil( area.GetHeight() ) + 1 ) );
+        }
+
         // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
         // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
         m_gal->ClearTarget( TARGET_NONCACHED );
@@ -1144,6 +1395,8 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    SCOPED_TRACE_EVENT trace( "VIEW::Redraw" );
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
 #endif /* __WXDEBUG__ */
@@ -1161,11 +1414,17 @@ void VIEW::Redraw()
             rect.GetHeight() > std::numeric_limits<int>::max() )
         recti.SetMaximum();
 
+    m_drawnItemCount = 0;
+
     redrawRect( recti );
+    // The settings of the painter may change before the next frame
+    m_tilePainters.clear();
+
     // All targets were redrawn, so nothing is dirty
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
+    m_partialRedraw = false;
 
 #ifdef __WXDEBUG__
     totalRealTime.Stop();
@@ -1174,6 +1433,59 @@ void VIEW::Redraw()
 }
 
 
+void VIEW::markTargetDirtyArea( int aTarget, const BOX2I& aArea )
+{
+    wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
+
+    // The overlay is always redrawn entirely
+    if( aTarget == TARGET_OVERLAY )
+    {
+        MarkTargetDirty( aTarget );
+        return;
+    }
+
+    if( !IsTargetDirty( TARGET_CACHED ) && !IsTargetDirty( TARGET_NONCACHED ) )
+    {
+        m_dirtyArea = aArea;
+        m_dirtyArea.Normalize();
+        m_dirtyAreaValid = true;
+    }
+    else if( m_dirtyAreaValid )
+    {
+        m_dirtyArea.Merge( aArea );
+    }
+
+    m_dirtyTargets[aTarget] = true;
+}
+
+
+BOX2I VIEW::dirtyScreenArea() const
+{
+    // Leaves room for the antialiasing of the item outlines and for the rounding of the
+    // item positions to pixels
+    const double MARGIN = 4.0;
+
+    VECTOR2D start = ToScreen( VECTOR2D( m_dirtyArea.GetOrigin() ) );
+    VECTOR2D end = ToScreen( VECTOR2D( m_dirtyArea.GetEnd() ) );
+    BOX2D    area( start, end - start );
+
+    area.Normalize();
+    area.Inflate( MARGIN );
+
+    BOX2D screen( VECTOR2D( 0, 0 ), VECTOR2D( m_gal->GetScreenPixelSize() ) );
+
+    if( !area.Intersects( screen ) )
+        return BOX2I();
+
+    area = area.Intersect( screen );
+
+    VECTOR2I origin( (int) std::floor( area.GetX() ), (int) std::floor( area.GetY() ) );
+    VECTOR2I corner( (int) std::ceil( area.GetRight() ), (int) std::ceil( area.GetBottom() ) );
+
+    return BOX2I( origin, corner - origin );
+}
+
+
 const VECTOR2I& VIEW::GetScreenPixelSize() const
 {
     return m_gal->GetScreenPixelSize();
@@ -1234,6 +1546,12 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         }
     }
 
+    updateItemCache( aItem, aUpdateFlags );
+}
+
+
+void VIEW::updateItemCache( VIEW_ITEM* aItem, int aUpdateFlags )
+{
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
@@ -1242,6 +1560,8 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     {
         int layerId = layers[i];
 
+        invalidateAggregate( layerId );
+
         if( IsCached( layerId ) )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
@@ -1250,8 +1570,8 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
                 updateItemColor( aItem, layerId );
         }
 
-        // Mark those layers as dirty, so the VIEW will be refreshed
-        MarkTargetDirty( m_layers[layerId].target );
+        // Mark the area of the item in those layers as dirty, so the VIEW will be refreshed
+        markTargetDirtyArea( m_layers[layerId].target, aItem->viewPrivData()->m_bbox );
     }
 
     aItem->viewPrivData()->clearUpdateFlags();
@@ -1269,6 +1589,7 @@ void VIEW::sortLayers()
 
     sort( m_orderedLayers.begin(), m_orderedLayers.end(), compareRenderingOrder );
 
+    invalidateAggregates();
     MarkDirty();
 }
 
@@ -1324,16 +1645,25 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
+    auto viewData = aItem->viewPrivData();
     int layers[VIEW_MAX_LAYERS], layers_count;
 
+    if( !viewData )
+        return;
+
+    // Both the previous and the new areas of the item have to be redrawn
+    const BOX2I prevBBox = viewData->m_bbox;
+    viewData->m_bbox = aItem->ViewBBox();
+
     aItem->ViewGetLayers( layers, layers_count );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Insert( aItem, viewData->m_bbox );
+        markTargetDirtyArea( l.target, prevBBox );
+        markTargetDirtyArea( l.target, viewData->m_bbox );
     }
 }
 
@@ -1353,7 +1683,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        markTargetDirtyArea( l.target, viewData->m_bbox );
+        invalidateAggregate( l.id );
 
         if( IsCached( l.id ) )
         {
@@ -1371,16 +1702,104 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Insert( aItem, viewData->m_bbox );
+        markTargetDirtyArea( l.target, viewData->m_bbox );
     }
 }
 
 
+void VIEW::updateIndexes( const std::vector<VIEW_ITEM*>& aItems )
+{
+    struct LAYER_UPDATE
+    {
+        std::unordered_set<VIEW_ITEM*>           removed;
+        std::vector<std::pair<VIEW_ITEM*, BOX2I>> inserted;
+    };
+
+    std::unordered_map<int, LAYER_UPDATE> updates;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        auto viewData = item->viewPrivData();
+        int  flags = viewData->m_requiredUpdate;
+        int  layers[VIEW_MAX_LAYERS], layers_count;
+
+        // Items being added are already indexed by VIEW::Add()
+        if( ( flags & INITIAL_ADD ) || !( flags & ( LAYERS | GEOMETRY ) ) )
+            continue;
+
+        if( flags & LAYERS )
+        {
+            // Remove the item from previous layer set, like updateLayers() does
+            viewData->getLayers( layers, layers_count );
+
+            for( int i = 0; i < layers_count; ++i )
+            {
+                updates[layers[i]].removed.insert( item );
+                markTargetDirtyArea( m_layers[layers[i]].target, viewData->m_bbox );
+                invalidateAggregate( layers[i] );
+
+                if( IsCached( layers[i] ) )
+                {
+                    int prevGroup = viewData->getGroup( layers[i] );
+
+                    if( prevGroup >= 0 )
+                    {
+                        m_gal->DeleteGroup( prevGroup );
+                        viewData->setGroup( layers[i], -1 );
+                    }
+                }
+            }
+
+            item->ViewGetLayers( layers, layers_count );
+            viewData->saveLayers( layers, layers_count );
+        }
+        else
+        {
+            item->ViewGetLayers( layers, layers_count );
+
+            for( int i = 0; i < layers_count; ++i )
+            {
+                updates[layers[i]].removed.insert( item );
+                markTargetDirtyArea( m_layers[layers[i]].target, viewData->m_bbox );
+            }
+        }
+
+        // The bounding box is computed once, not once per layer
+        const BOX2I& bbox = viewData->m_bbox = item->ViewBBox();
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            updates[layers[i]].inserted.emplace_back( item, bbox );
+            markTargetDirtyArea( m_layers[layers[i]].target, bbox );
+        }
+    }
+
+    std::vector<std::pair<VIEW_LAYER*, LAYER_UPDATE*>> jobs;
+
+    for( auto& update : updates )
+        jobs.emplace_back( &m_layers[update.first], &update.second );
+
+    // The layers have their own trees, so they are updated concurrently
+    std::atomic<size_t> next( 0 );
+
+    auto work = [&]()
+    {
+        for( size_t ii = next++; ii < jobs.size(); ii = next++ )
+            jobs[ii].first->items->Update( jobs[ii].second->removed, jobs[ii].second->inserted );
+    };
+
+    THREAD_POOL& pool = GetKiCadThreadPool();
+
+    pool.RunParallel( work, std::min<size_t>( jobs.size(), pool.GetThreadCount() + 1 ) );
+}
+
+
 bool VIEW::areRequiredLayersEnabled( int aLayerId ) const
 {
     wxCHECK( (unsigned) aLayerId < m_layers.size(), false );
@@ -1415,6 +1834,8 @@ void VIEW::RecacheAllItems()
             l->items->Query( r, visitor );
         }
     }
+
+    invalidateAggregates();
 }
 
 
@@ -1422,21 +1843,49 @@ void VIEW::UpdateItems()
 {
     if( m_gal->IsVisible() )
     {
+        // Below this count of items, updating them one by one is cheaper than rebuilding
+        // the spatial indexes of their layers
+        const size_t BULK_UPDATE_COUNT = 256;
+
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
+        std::vector<VIEW_ITEM*> dirtyItems;
+
         for( VIEW_ITEM* item : *m_allItems )
         {
             auto viewData = item->viewPrivData();
 
-            if( !viewData )
-                continue;
+            if( viewData && viewData->m_requiredUpdate != NONE )
+                dirtyItems.push_back( item );
+        }
 
-            if( viewData->m_requiredUpdate != NONE )
+        if( dirtyItems.size() < BULK_UPDATE_COUNT )
+        {
+            for( VIEW_ITEM* item : dirtyItems )
             {
+                auto viewData = item->viewPrivData();
+
                 invalidateItem( item, viewData->m_requiredUpdate );
                 viewData->m_requiredUpdate = NONE;
             }
         }
+        else
+        {
+            updateIndexes( dirtyItems );
+
+            // The GAL and the painter are not thread safe, so the items are recached serially
+            for( VIEW_ITEM* item : dirtyItems )
+            {
+                auto viewData = item->viewPrivData();
+                int  flags = viewData->m_requiredUpdate;
+
+                updateItemCache( item, ( flags & INITIAL_ADD ) ? ALL : flags );
+                viewData->m_requiredUpdate = NONE;
+            }
+        }
+
+        if( useAggregates() )
+            updateAggregates();
     }
 }
 
@@ -1478,6 +1927,7 @@ std::unique_ptr<VIEW> VIEW::DataReference() const
     auto ret = std::make_unique<VIEW>();
     ret->m_allItems = m_allItems;
     ret->m_layers = m_layers;
+    ret->resetAggregates();     // the groups belong to the GAL of this view
     ret->sortLayers();
     return ret;
 }
@@ -1551,6 +2001,126 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
 }
 
 
+bool VIEW::useAggregates() const
+{
+    return m_aggregateThreshold > 0.0 && !m_useDrawPriority && m_gal
+           && ToWorld( 1.0 ) >= m_aggregateThreshold;
+}
+
+
+bool VIEW::isAggregateCurrent( const VIEW_LAYER& aLayer ) const
+{
+    return aLayer.aggregateValid && aLayer.target == TARGET_CACHED
+           && m_scale > aLayer.aggregateMinScale && m_scale <= aLayer.aggregateMaxScale;
+}
+
+
+void VIEW::invalidateAggregate( int aLayer )
+{
+    VIEW_LAYER& l = m_layers[aLayer];
+
+    // The group is deleted when rebuilt, the VIEW may have no GAL here
+    l.aggregateValid = false;
+    l.aggregateAge = 0;
+}
+
+
+void VIEW::invalidateAggregates()
+{
+    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    {
+        i->second.aggregateValid = false;
+        i->second.aggregateAge = 0;
+    }
+}
+
+
+void VIEW::resetAggregates()
+{
+    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    {
+        i->second.aggregateValid = false;
+        i->second.aggregateGroup = -1;
+        i->second.aggregateAge = 0;
+    }
+}
+
+
+void VIEW::updateAggregates()
+{
+    // Number of updates without change of a layer before it is aggregated, so that the
+    // aggregate is not rebuilt during an interactive edit
+    const int AGGREGATE_DELAY = 1;
+
+    BOX2I r;
+
+    r.SetMaximum();
+
+    for( VIEW_LAYER* l : m_orderedLayers )
+    {
+        if( l->target != TARGET_CACHED || !l->visible || isAggregateCurrent( *l ) )
+            continue;
+
+        if( l->aggregateAge++ < AGGREGATE_DELAY )
+            continue;
+
+        std::vector<VIEW_ITEM*> items;
+        double                  minScale = 0.0;
+        double                  maxScale = std::numeric_limits<double>::max();
+
+        // The items are drawn in the order of redrawRect(), with the same conditions
+        auto collect =
+                [&]( VIEW_ITEM* aItem ) -> bool
+                {
+                    if( !aItem->viewPrivData()->isRenderable() )
+                        return true;
+
+                    double lod = aItem->ViewGetLOD( l->id, this );
+
+                    if( lod < m_scale )
+                    {
+                        items.push_back( aItem );
+                        minScale = std::max( minScale, lod );
+                    }
+                    else
+                    {
+                        maxScale = std::min( maxScale, lod );
+                    }
+
+                    return true;
+                };
+
+        l->items->Query( r, collect );
+
+        if( l->aggregateGroup >= 0 )
+            m_gal->DeleteGroup( l->aggregateGroup );
+
+        l->aggregateGroup = -1;
+
+        if( !items.empty() )
+        {
+            m_gal->SetTarget( l->target );
+            m_gal->SetLayerDepth( l->renderingOrder );
+
+            l->aggregateGroup = m_gal->BeginGroup();
+
+            for( VIEW_ITEM* item : items )
+            {
+                if( !m_painter->Draw( static_cast<EDA_ITEM*>( item ), l->id ) )
+                    item->ViewDraw( l->id, this );
+            }
+
+            m_gal->EndGroup();
+        }
+
+        l->aggregateValid = true;
+        l->aggregateMinScale = minScale;
+        l->aggregateMaxScale = maxScale;
+        MarkTargetDirty( l->target );
+    }
+}
+
+
 std::shared_ptr<VIEW_OVERLAY> VIEW::MakeOverlay()
 {
     std::shared_ptr<VIEW_OVERLAY> overlay( new VIEW_OVERLAY );
@@ -43,6 +43,7 @@
 #include <cstdio>   // used only for debug
 #include <ctime>    // used for representation of x axes involving date
 #include <set>
+#include <vector>
 
 // Memory leak debugging
 #ifdef _DEBUG
@@ -696,24 +697,81 @@ void mpFXY::Plot( wxDC& dc, mpWindow& w )
         }
         else
         {
-            wxPoint* points = new wxPoint[GetCount()];
-            int      count = 0;
+            // The points are decimated to the screen resolution: of the points falling in
+            // the same pixel column, only the first, the lowest, the highest and the last ones
+            // are kept, in their order, which draws the same lines.
+            std::vector<wxPoint> points;
+            bool                 first = true;
+            wxPoint              colFirst, colMin, colMax, colLast;
+            size_t               colMinIdx = 0, colMaxIdx = 0, idx = 0;
+
+            auto addPoint =
+                    [&]( const wxPoint& aPoint )
+                    {
+                        if( points.empty() || points.back() != aPoint )
+                            points.push_back( aPoint );
+                    };
+
+            auto flushColumn =
+                    [&]()
+                    {
+                        addPoint( colFirst );
+
+                        if( colMinIdx < colMaxIdx )
+                        {
+                            addPoint( colMin );
+                            addPoint( colMax );
+                        }
+                        else
+                        {
+                            addPoint( colMax );
+                            addPoint( colMin );
+                        }
+
+                        addPoint( colLast );
+                    };
 
             while( GetNextXY( x, y ) )
             {
                 double px = m_scaleX->TransformToPlot( x );
                 double py = m_scaleY->TransformToPlot( y );
 
-                wxCoord x1 = w.x2p( px );
-                wxCoord y1 = w.y2p( py );
+                wxPoint pt( w.x2p( px ), w.y2p( py ) );
+
+                if( !first && pt.x == colFirst.x )
+                {
+                    if( pt.y < colMin.y )
+                    {
+                        colMin = pt;
+                        colMinIdx = idx;
+                    }
+
+                    if( pt.y > colMax.y )
+                    {
+                        colMax = pt;
+                        colMaxIdx = idx;
+                    }
+
+                    colLast = pt;
+                }
+                else
+                {
+                    if( !first )
+                        flushColumn();
+
+                    colFirst = colMin = colMax = colLast = pt;
+                    colMinIdx = colMaxIdx = idx;
+                    first = false;
+                }
 
-                points[count++] = wxPoint( x1, y1 );
+                idx++;
             }
 
-            if( count > 0 )
-                dc.DrawLines( count, points );
+            if( !first )
+                flushColumn();
 
-            delete[] points;
+            if( !points.empty() )
+                dc.DrawLines( (int) points.size(), points.data() );
         }
 
         if( !m_name.IsEmpty() && m_showName )
@@ -33,6 +33,7 @@
 #include <wx/regex.h>
 #include <algorithm>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <fctsys.h>
@@ -219,39 +220,41 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+/**
+ * The reference numbers in use for a reference prefix, from a minimum value.  Numbers are
+ * only added while a prefix is annotated, so the first free number is found by resuming the
+ * search from the last one created.
+ */
+class REF_ID_POOL
 {
-    int expectedId = aFirstValue;
-
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
+public:
+    void Reset( int aFirstValue )
+    {
+        m_inUse.clear();
+        m_nextFree = aFirstValue;
+    }
 
-    for( ; ii < aIdList.size(); ii++ )
+    void Add( int aId )
     {
-        if( expectedId <= aIdList[ii] )
-            break;
+        if( aId >= m_nextFree )
+            m_inUse.insert( aId );
     }
 
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+    /**
+     * @return the first free (not yet used) number, which is now in use
+     */
+    int CreateFirstFreeRefId()
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
+        while( m_inUse.count( m_nextFree ) )
+            m_nextFree++;
 
-        expectedId++;
+        return m_nextFree++;
     }
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
-    return expectedId;
-}
+private:
+    std::unordered_set<int> m_inUse;
+    int                     m_nextFree = 0;
+};
 
 
 // A helper function to build a full reference string of a SCH_REFERENCE item
@@ -278,6 +281,32 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     int LastReferenceNumber = 0;
     int NumberOfUnits, Unit;
 
+    // The references are indexed by prefix and by component, so that the searches below
+    // only visit the candidates instead of the whole list.  The indices are increasing.
+    std::unordered_map<std::string, std::vector<unsigned>>    prefixRefs;
+    std::unordered_map<SCH_COMPONENT*, std::vector<unsigned>> componentRefs;
+
+    for( unsigned ii = 0; ii < flatList.size(); ii++ )
+    {
+        prefixRefs[flatList[ii].m_Ref].push_back( ii );
+        componentRefs[flatList[ii].GetComp()].push_back( ii );
+    }
+
+    // The locked units lists by component.  A component found in several lists belongs to
+    // the first one, in map order.
+    std::unordered_map<SCH_COMPONENT*, std::vector<SCH_REFERENCE_LIST*>> lockedLists;
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+        {
+            std::vector<SCH_REFERENCE_LIST*>& lists = lockedLists[pair.second[thisRefI].GetComp()];
+
+            if( lists.empty() || lists.back() != &pair.second )
+                lists.push_back( &pair.second );
+        }
+    }
+
     /* calculate index of the first component with the same reference prefix
      * than the current component.  All components having the same reference
      * prefix will receive a reference number with consecutive values:
@@ -306,10 +335,20 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     // inUseRefs keep trace of previously allocated references
     std::unordered_set<wxString> inUseRefs;
 
-    // This is the list of all Id already in use for a given reference prefix.
+    // This is the set of all Id already in use for a given reference prefix.
     // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    REF_ID_POOL idPool;
+
+    auto get_refs_in_use =
+            [&]( unsigned aIndex )
+            {
+                idPool.Reset( minRefId );
+
+                for( unsigned jj : prefixRefs[flatList[aIndex].m_Ref] )
+                    idPool.Add( flatList[jj].m_NumRef );
+            };
+
+    get_refs_in_use( first );
 
     for( unsigned ii = 0; ii < flatList.size(); ii++ )
     {
@@ -320,21 +359,24 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
+        auto                locked = lockedLists.find( ref_unit.GetComp() );
 
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+        if( locked != lockedLists.end() )
+        {
+            for( SCH_REFERENCE_LIST* list : locked->second )
             {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( ref_unit ) )
+                for( unsigned thisRefI = 0; thisRefI < list->GetCount(); ++thisRefI )
                 {
-                    lockedList = &pair.second;
-                    break;
+                    if( (*list)[thisRefI].IsSameInstance( ref_unit ) )
+                    {
+                        lockedList = list;
+                        break;
+                    }
                 }
+
+                if( lockedList != NULL )
+                    break;
             }
-            if( lockedList != NULL ) break;
         }
 
         if(  ( flatList[first].CompareRef( ref_unit ) != 0 )
@@ -349,15 +391,19 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             else
                 minRefId = aStartNumber + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            get_refs_in_use( first );
         }
 
+        // The references with the same prefix, after this one
+        const std::vector<unsigned>& samePrefix = prefixRefs[ref_unit.m_Ref];
+        auto nextSamePrefix = std::upper_bound( samePrefix.begin(), samePrefix.end(), ii );
+
         // Annotation of one part per package components (trivial case).
         if( ref_unit.GetLibPart()->GetUnitCount() <= 1 )
         {
             if( ref_unit.m_IsNew )
             {
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = idPool.CreateFirstFreeRefId();
                 ref_unit.m_NumRef = LastReferenceNumber;
             }
 
@@ -372,7 +418,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         if( ref_unit.m_IsNew )
         {
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = idPool.CreateFirstFreeRefId();
             ref_unit.m_NumRef = LastReferenceNumber;
 
             if( !ref_unit.IsUnitsLocked() )
@@ -406,9 +452,14 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                auto sameComp = componentRefs.find( thisRef.GetComp() );
+
+                if( sameComp == componentRefs.end() )
+                    continue;
+
+                for( unsigned jj : sameComp->second )
                 {
-                    if( ! thisRef.IsSameInstance( flatList[jj] ) )
+                    if( jj <= ii || !thisRef.IsSameInstance( flatList[jj] ) )
                         continue;
 
                     wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_Unit );
@@ -440,22 +491,33 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( ref_unit.m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
+                // Check whether this unit exists for this reference (unit already annotated),
+                // as FindUnit() does
+                bool found = false;
 
-                if( found >= 0 )
-                    continue; // this unit exists for this reference (unit already annotated)
+                for( unsigned jj : samePrefix )
+                {
+                    const SCH_REFERENCE& other = flatList[jj];
+
+                    if( jj != ii && !other.m_IsNew && other.m_NumRef == ref_unit.m_NumRef
+                            && other.m_Unit == Unit )
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+
+                if( found )
+                    continue;
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                for( auto it = nextSamePrefix; it != samePrefix.end(); ++it )
                 {
-                    auto& cmp_unit = flatList[jj];
+                    auto& cmp_unit = flatList[*it];
 
                     if( cmp_unit.m_Flag )    // already tested
                         continue;
 
-                    if( cmp_unit.CompareRef( ref_unit ) != 0 )
-                        continue;
-
                     if( cmp_unit.CompareValue( ref_unit ) != 0 )
                         continue;
 
@@ -485,6 +547,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     }
 }
 
+
 int SCH_REFERENCE_LIST::CheckAnnotation( REPORTER& aReporter )
 {
     int            error = 0;
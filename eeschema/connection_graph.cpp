@@ -18,6 +18,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <list>
 #include <thread>
 #include <algorithm>
@@ -41,6 +42,7 @@
 #include <advanced_config.h>
 #include <connection_graph.h>
 #include <widgets/ui_common.h>
+#include <trace_events.h>
 
 bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
 {
@@ -344,6 +346,10 @@ void CONNECTION_GRAPH::Reset()
         delete subgraph;
 
     m_items.clear();
+    m_screen_items.clear();
+    m_item_pins.clear();
+    m_sheet_paths.clear();
+    m_bus_alias_signature.Empty();
     m_subgraphs.clear();
     m_driver_subgraphs.clear();
     m_sheet_to_subgraphs_map.clear();
@@ -355,6 +361,7 @@ void CONNECTION_GRAPH::Reset()
     m_net_name_to_subgraphs_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_link_name_to_subgraphs_map.clear();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
@@ -363,40 +370,59 @@ void CONNECTION_GRAPH::Reset()
 
 void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional )
 {
-    PROF_COUNTER recalc_time;
-    PROF_COUNTER update_items;
+    SCOPED_TRACE_EVENT trace( "CONNECTION_GRAPH::Recalculate" );
 
-    if( aUnconditional )
-        Reset();
+    PROF_COUNTER recalc_time;
 
-    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    if( !aUnconditional && updateChangedItems( aSheetList ) )
     {
-        std::vector<SCH_ITEM*> items;
+        recalc_time.Stop();
+        wxLogTrace( "CONN_PROFILE", "Incremental recalculate time %0.4f ms",
+                    recalc_time.msecs() );
+    }
+    else
+    {
+        PROF_COUNTER update_items;
 
-        for( auto item : sheet.LastScreen()->Items() )
+        Reset();
+
+        for( const SCH_SHEET_PATH& sheet : aSheetList )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
-                items.push_back( item );
-        }
+            std::vector<SCH_ITEM*>         items;
+            std::unordered_set<SCH_ITEM*>& screen_items = m_screen_items[ sheet.LastScreen() ];
 
-        updateItemConnectivity( sheet, items );
+            for( auto item : sheet.LastScreen()->Items() )
+            {
+                if( item->IsConnectable() )
+                {
+                    items.push_back( item );
+                    screen_items.insert( item );
+                }
+            }
 
-        // UpdateDanglingState() also adds connected items for SCH_TEXT
-        sheet.LastScreen()->TestDanglingEnds( &sheet );
-    }
+            updateItemConnectivity( sheet, items );
+
+            // UpdateDanglingState() also adds connected items for SCH_TEXT
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+        }
 
-    update_items.Stop();
-    wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
+        update_items.Stop();
+        wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
 
-    PROF_COUNTER build_graph;
+        PROF_COUNTER build_graph;
 
-    buildConnectionGraph();
+        buildConnectionGraph();
+        cacheLinkNames( m_subgraphs );
 
-    build_graph.Stop();
-    wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
+        m_sheet_paths.assign( aSheetList.begin(), aSheetList.end() );
+        m_bus_alias_signature = getBusAliasSignature( aSheetList );
 
-    recalc_time.Stop();
-    wxLogTrace( "CONN_PROFILE", "Recalculate time %0.4f ms", recalc_time.msecs() );
+        build_graph.Stop();
+        wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
+
+        recalc_time.Stop();
+        wxLogTrace( "CONN_PROFILE", "Recalculate time %0.4f ms", recalc_time.msecs() );
+    }
 
 #ifndef DEBUG
     // Pressure relief valve for release builds
@@ -411,11 +437,664 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 }
 
 
+/// Adds the names of aConnection and of all its bus members, regardless of the sheet
+static void addConnectionNames( const SCH_CONNECTION& aConnection,
+                                std::vector<wxString>& aNames )
+{
+    wxString name = aConnection.Name( true );
+
+    aNames.push_back( name );
+
+    // A weakly driven net renamed to be unique still competes for its original name
+    if( !aConnection.Suffix().IsEmpty() && name.EndsWith( aConnection.Suffix() ) )
+        aNames.push_back( name.Left( name.Length() - aConnection.Suffix().Length() ) );
+
+    for( const auto& member : aConnection.Members() )
+        addConnectionNames( *member, aNames );
+}
+
+
+void CONNECTION_GRAPH::getLinkNames( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet,
+                                     std::vector<wxString>& aNames )
+{
+    switch( aItem->Type() )
+    {
+    case SCH_PIN_T:
+        aNames.push_back( static_cast<SCH_PIN*>( aItem )->GetDefaultNetName( aSheet ) );
+        break;
+
+    case SCH_LABEL_T:
+    case SCH_GLOBAL_LABEL_T:
+    case SCH_HIER_LABEL_T:
+    case SCH_SHEET_PIN_T:
+    {
+        SCH_CONNECTION connection( aItem, aSheet );
+
+        connection.ConfigureFromLabel( static_cast<SCH_TEXT*>( aItem )->GetText() );
+        addConnectionNames( connection, aNames );
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+void CONNECTION_GRAPH::cacheLinkNames( const std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs )
+{
+    for( CONNECTION_SUBGRAPH* subgraph : aSubgraphs )
+    {
+        std::vector<wxString>& names = subgraph->m_link_names;
+
+        names.clear();
+
+        if( subgraph->m_driver_connection )
+            addConnectionNames( *subgraph->m_driver_connection, names );
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            // The name of a plain pin only matters when it drives the subgraph, and then it is
+            // the name of the driver connection
+            if( item->Type() == SCH_PIN_T
+                    && !static_cast<SCH_PIN*>( item )->IsPowerConnection() )
+                continue;
+
+            getLinkNames( item, subgraph->m_sheet, names );
+        }
+
+        std::sort( names.begin(), names.end() );
+        names.erase( std::unique( names.begin(), names.end() ), names.end() );
+
+        for( const wxString& name : names )
+            m_link_name_to_subgraphs_map[ name ].push_back( subgraph );
+    }
+}
+
+
+wxString CONNECTION_GRAPH::getBusAliasSignature( const SCH_SHEET_LIST& aSheetList ) const
+{
+    wxString                       signature;
+    std::unordered_set<SCH_SCREEN*> screens;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        if( !screens.insert( sheet.LastScreen() ).second )
+            continue;
+
+        std::vector<wxString> aliases;
+
+        for( const auto& alias : sheet.LastScreen()->GetBusAliases() )
+        {
+            wxString members;
+
+            for( const wxString& member : alias->Members() )
+                members << member << ' ';
+
+            aliases.push_back( alias->GetName() + '{' + members + '}' );
+        }
+
+        // The aliases of a screen are not ordered
+        std::sort( aliases.begin(), aliases.end() );
+
+        for( const wxString& alias : aliases )
+            signature << alias;
+    }
+
+    return signature;
+}
+
+
+bool CONNECTION_GRAPH::updateChangedItems( const SCH_SHEET_LIST& aSheetList )
+{
+    if( m_sheet_paths.empty() || m_sheet_paths.size() != aSheetList.size()
+            || !std::equal( m_sheet_paths.begin(), m_sheet_paths.end(), aSheetList.begin() ) )
+    {
+        return false;
+    }
+
+    // A bus alias change affects every bus using it, without changing any item
+    if( getBusAliasSignature( aSheetList ) != m_bus_alias_signature )
+        return false;
+
+    // The graph is made of items called leaves below: the pins of the components and sheets,
+    // and the other connectable items themselves.  The removed leaves may have been deleted
+    // already, so they are only looked up by address, never dereferenced.
+
+    std::unordered_map<SCH_SCREEN*, std::unordered_set<SCH_ITEM*>> screen_items;
+    std::unordered_map<SCH_SCREEN*, std::vector<SCH_ITEM*>>        dirty_items;
+    std::unordered_map<SCH_SCREEN*, std::vector<SCH_BUS_ENTRY_BASE*>> bus_entries;
+    std::unordered_set<SCH_SCREEN*>                                changed_screens;
+    std::unordered_set<SCH_ITEM*>                                  removed;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+
+        if( !m_screen_items.count( screen ) )
+            return false;
+
+        if( screen_items.count( screen ) )
+            continue;
+
+        std::unordered_set<SCH_ITEM*>& items = screen_items[ screen ];
+
+        for( SCH_ITEM* item : screen->Items() )
+        {
+            if( !item->IsConnectable() )
+                continue;
+
+            items.insert( item );
+
+            if( item->Type() == SCH_BUS_WIRE_ENTRY_T || item->Type() == SCH_BUS_BUS_ENTRY_T )
+                bus_entries[ screen ].push_back( static_cast<SCH_BUS_ENTRY_BASE*>( item ) );
+
+            if( item->IsConnectivityDirty() )
+            {
+                dirty_items[ screen ].push_back( item );
+                changed_screens.insert( screen );
+            }
+        }
+
+        for( SCH_ITEM* item : m_screen_items.at( screen ) )
+        {
+            if( items.count( item ) )
+                continue;
+
+            auto pins = m_item_pins.find( item );
+
+            if( pins != m_item_pins.end() )
+            {
+                removed.insert( pins->second.begin(), pins->second.end() );
+                m_item_pins.erase( pins );
+            }
+
+            removed.insert( item );
+            changed_screens.insert( screen );
+        }
+    }
+
+    if( changed_screens.empty() )
+        return true;
+
+    // The leaves of the changed items, and the leaves they touch, on each sheet
+
+    std::unordered_map<SCH_SHEET_PATH, std::vector<SCH_ITEM*>> changed_leaves;
+    std::unordered_map<SCH_SHEET_PATH, std::unordered_set<SCH_ITEM*>> owned_leaves;
+    std::unordered_set<SCH_ITEM*> all_owned_leaves;
+    std::unordered_set<SCH_ITEM*> live;
+
+    auto has_pins =
+            []( SCH_ITEM* aItem )
+            {
+                return aItem->Type() == SCH_COMPONENT_T || aItem->Type() == SCH_SHEET_T;
+            };
+
+    auto get_pins =
+            [&]( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet, std::vector<SCH_ITEM*>& aPins )
+            {
+                if( aItem->Type() == SCH_COMPONENT_T )
+                {
+                    SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( aItem );
+
+                    for( SCH_PIN* pin : component->GetSchPins( &aSheet ) )
+                        aPins.push_back( pin );
+                }
+                else if( aItem->Type() == SCH_SHEET_T )
+                {
+                    for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( aItem )->GetPins() )
+                        aPins.push_back( pin );
+                }
+            };
+
+    // A bus entry holds the bus it is connected to, which may have been moved or removed
+    auto is_changed =
+            [&]( SCH_ITEM* aItem )
+            {
+                return aItem && ( removed.count( aItem ) || aItem->IsConnectivityDirty() );
+            };
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+
+        if( !changed_screens.count( screen ) )
+            continue;
+
+        std::vector<SCH_ITEM*>&        leaves = changed_leaves[ sheet ];
+        std::unordered_set<SCH_ITEM*>& owned = owned_leaves[ sheet ];
+
+        auto add_touching =
+                [&]( SCH_ITEM* aLeaf, const wxPoint& aPoint )
+                {
+                    for( SCH_ITEM* item : screen->Items().Overlapping( aPoint ) )
+                    {
+                        if( item == aLeaf || !item->IsConnectable() )
+                            continue;
+
+                        if( !has_pins( item ) )
+                        {
+                            leaves.push_back( item );
+                            continue;
+                        }
+
+                        std::vector<SCH_ITEM*> pins;
+                        get_pins( item, sheet, pins );
+
+                        // Only the pins on the point itself, not the whole component
+                        for( SCH_ITEM* pin : pins )
+                        {
+                            wxPoint pos = ( pin->Type() == SCH_PIN_T )
+                                    ? static_cast<SCH_PIN*>( pin )->GetTransformedPosition()
+                                    : static_cast<SCH_SHEET_PIN*>( pin )->GetTextPos();
+
+                            if( pos == aPoint )
+                                leaves.push_back( pin );
+                        }
+                    }
+                };
+
+        for( SCH_BUS_ENTRY_BASE* entry : bus_entries[ screen ] )
+        {
+            bool changed = false;
+
+            if( entry->Type() == SCH_BUS_WIRE_ENTRY_T )
+            {
+                auto wire_entry = static_cast<SCH_BUS_WIRE_ENTRY*>( entry );
+                changed = is_changed( wire_entry->m_connected_bus_item );
+            }
+            else
+            {
+                auto bus_entry = static_cast<SCH_BUS_BUS_ENTRY*>( entry );
+
+                for( SCH_ITEM* bus : bus_entry->m_connected_bus_items )
+                    changed |= is_changed( bus );
+            }
+
+            if( changed )
+                leaves.push_back( entry );
+        }
+
+        if( !dirty_items.count( screen ) )
+        {
+            live.insert( leaves.begin(), leaves.end() );
+            continue;
+        }
+
+        for( SCH_ITEM* item : dirty_items.at( screen ) )
+        {
+            std::vector<SCH_ITEM*> pins;
+
+            if( has_pins( item ) )
+                get_pins( item, sheet, pins );
+            else
+                pins.push_back( item );
+
+            for( SCH_ITEM* leaf : pins )
+            {
+                std::vector<wxPoint> points;
+
+                if( leaf->Type() == SCH_PIN_T )
+                    points.push_back( static_cast<SCH_PIN*>( leaf )->GetTransformedPosition() );
+                else if( leaf->Type() == SCH_SHEET_PIN_T )
+                    points.push_back( static_cast<SCH_SHEET_PIN*>( leaf )->GetTextPos() );
+                else
+                    leaf->GetConnectionPoints( points );
+
+                leaves.push_back( leaf );
+                owned.insert( leaf );
+
+                for( const wxPoint& point : points )
+                    add_touching( leaf, point );
+
+                // Bus entries connect anywhere along a bus
+                if( leaf->Type() == SCH_LINE_T && leaf->GetLayer() == LAYER_BUS )
+                {
+                    for( SCH_ITEM* entry : screen->Items().Overlapping( leaf->GetBoundingBox() ) )
+                    {
+                        if( entry->Type() == SCH_BUS_WIRE_ENTRY_T
+                                || entry->Type() == SCH_BUS_BUS_ENTRY_T )
+                            leaves.push_back( entry );
+                    }
+                }
+            }
+        }
+
+        all_owned_leaves.insert( owned.begin(), owned.end() );
+        live.insert( leaves.begin(), leaves.end() );
+    }
+
+    // The pins a changed component or sheet no longer has are removed too, and so is the
+    // component or sheet itself in case its address was a removed leaf
+    for( const auto& it : dirty_items )
+    {
+        for( SCH_ITEM* item : it.second )
+        {
+            auto pins = m_item_pins.find( item );
+
+            if( pins != m_item_pins.end() )
+            {
+                for( SCH_ITEM* pin : pins->second )
+                {
+                    if( !all_owned_leaves.count( pin ) )
+                        removed.insert( pin );
+                }
+
+                m_item_pins.erase( pins );
+            }
+
+            if( has_pins( item ) )
+            {
+                removed.insert( item );
+
+                std::vector<SCH_ITEM*>& item_pins = m_item_pins[ item ];
+
+                for( const SCH_SHEET_PATH& sheet : aSheetList )
+                {
+                    if( sheet.LastScreen() == it.first )
+                        get_pins( item, sheet, item_pins );
+                }
+
+                std::sort( item_pins.begin(), item_pins.end() );
+                item_pins.erase( std::unique( item_pins.begin(), item_pins.end() ),
+                                 item_pins.end() );
+            }
+        }
+    }
+
+    // Find the subgraphs holding the changed leaves or the removed ones
+
+    std::unordered_map<long, CONNECTION_SUBGRAPH*> code_to_subgraph;
+    std::unordered_set<const CONNECTION_SUBGRAPH*> affected;
+    std::vector<CONNECTION_SUBGRAPH*>              affected_list;
+
+    auto add_affected =
+            [&]( CONNECTION_SUBGRAPH* aSubgraph )
+            {
+                if( affected.insert( aSubgraph ).second )
+                    affected_list.push_back( aSubgraph );
+            };
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        code_to_subgraph[ subgraph->m_code ] = subgraph;
+
+        if( !removed.empty() )
+        {
+            for( SCH_ITEM* item : subgraph->m_items )
+            {
+                if( removed.count( item ) )
+                {
+                    add_affected( subgraph );
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<wxString> names;
+
+    for( const auto& it : changed_leaves )
+    {
+        for( SCH_ITEM* leaf : it.second )
+        {
+            SCH_CONNECTION* connection = leaf->Connection( it.first );
+
+            if( connection )
+            {
+                auto subgraph = code_to_subgraph.find( connection->SubgraphCode() );
+
+                if( subgraph != code_to_subgraph.end() && subgraph->second->m_sheet == it.first )
+                    add_affected( subgraph->second );
+            }
+
+            getLinkNames( leaf, it.first, names );
+        }
+    }
+
+    // Then all the subgraphs linked to them by a name, the old names and the new ones
+
+    auto add_linked =
+            [&]( const wxString& aName )
+            {
+                auto linked = m_link_name_to_subgraphs_map.find( aName );
+
+                if( linked != m_link_name_to_subgraphs_map.end() )
+                {
+                    for( CONNECTION_SUBGRAPH* subgraph : linked->second )
+                        add_affected( subgraph );
+                }
+            };
+
+    for( const wxString& name : names )
+        add_linked( name );
+
+    for( size_t i = 0; i < affected_list.size(); i++ )
+    {
+        for( const wxString& name : affected_list[i]->m_link_names )
+            add_linked( name );
+    }
+
+    wxLogTrace( "CONN", "Incremental update: %lu of %lu subgraphs affected",
+                affected_list.size(), m_subgraphs.size() );
+
+    // Rebuild the leaves of the affected subgraphs in a separate graph.  It shares the net
+    // and bus codes, and the subgraph codes, of this one.
+
+    CONNECTION_GRAPH sub( m_frame );
+
+    std::swap( sub.m_net_name_to_code_map, m_net_name_to_code_map );
+    std::swap( sub.m_bus_name_to_code_map, m_bus_name_to_code_map );
+    sub.m_last_net_code = m_last_net_code;
+    sub.m_last_bus_code = m_last_bus_code;
+    sub.m_last_subgraph_code = m_last_subgraph_code;
+
+    std::unordered_map<SCH_SHEET_PATH, std::vector<SCH_ITEM*>>        sheet_leaves;
+    std::unordered_map<SCH_SHEET_PATH, std::unordered_set<SCH_ITEM*>> sheet_leaf_set;
+
+    auto add_leaf =
+            [&]( const SCH_SHEET_PATH& aSheet, SCH_ITEM* aLeaf )
+            {
+                if( sheet_leaf_set[ aSheet ].insert( aLeaf ).second )
+                    sheet_leaves[ aSheet ].push_back( aLeaf );
+            };
+
+    for( const auto& it : changed_leaves )
+    {
+        for( SCH_ITEM* leaf : it.second )
+            add_leaf( it.first, leaf );
+    }
+
+    for( CONNECTION_SUBGRAPH* subgraph : affected_list )
+    {
+        const SCH_SHEET_PATH& sheet = subgraph->m_sheet;
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( removed.count( item ) && !live.count( item ) )
+                continue;
+
+            // A pin a changed component no longer has on this sheet (e.g. another unit)
+            if( all_owned_leaves.count( item ) && !owned_leaves[ sheet ].count( item ) )
+                continue;
+
+            add_leaf( sheet, item );
+        }
+    }
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        if( sheet_leaves.count( sheet ) )
+            sub.updateItemConnectivity( sheet, sheet_leaves.at( sheet ) );
+
+        if( changed_screens.count( sheet.LastScreen() ) )
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+    }
+
+    for( const auto& it : dirty_items )
+    {
+        for( SCH_ITEM* item : it.second )
+            item->SetConnectivityDirty( false );
+    }
+
+    // The invisible power pins rebuilt, or removed, are replaced by the ones of the new graph
+    m_invisible_power_pins.erase(
+            std::remove_if( m_invisible_power_pins.begin(), m_invisible_power_pins.end(),
+                            [&]( const std::pair<SCH_SHEET_PATH, SCH_PIN*>& aPin )
+                            {
+                                if( removed.count( aPin.second ) )
+                                    return true;
+
+                                auto leaves = sheet_leaf_set.find( aPin.first );
+
+                                return leaves != sheet_leaf_set.end()
+                                       && leaves->second.count( aPin.second ) > 0;
+                            } ),
+            m_invisible_power_pins.end() );
+
+    sub.buildConnectionGraph();
+
+    // Drop the affected subgraphs from this graph
+
+    auto purge =
+            [&]( auto& aSubgraphs )
+            {
+                aSubgraphs.erase( std::remove_if( aSubgraphs.begin(), aSubgraphs.end(),
+                                                  [&]( const CONNECTION_SUBGRAPH* aSubgraph )
+                                                  {
+                                                      return affected.count( aSubgraph ) > 0;
+                                                  } ),
+                                  aSubgraphs.end() );
+            };
+
+    auto purge_map =
+            [&]( auto& aMap )
+            {
+                for( auto it = aMap.begin(); it != aMap.end(); )
+                {
+                    purge( it->second );
+
+                    if( it->second.empty() )
+                        it = aMap.erase( it );
+                    else
+                        ++it;
+                }
+            };
+
+    for( const CONNECTION_SUBGRAPH* subgraph : affected )
+    {
+        for( const wxString& name : subgraph->m_link_names )
+        {
+            auto linked = m_link_name_to_subgraphs_map.find( name );
+
+            if( linked == m_link_name_to_subgraphs_map.end() )
+                continue;
+
+            purge( linked->second );
+
+            if( linked->second.empty() )
+                m_link_name_to_subgraphs_map.erase( linked );
+        }
+    }
+
+    purge( m_driver_subgraphs );
+    purge_map( m_sheet_to_subgraphs_map );
+    purge_map( m_global_label_cache );
+    purge_map( m_local_label_cache );
+    purge_map( m_net_name_to_subgraphs_map );
+    purge_map( m_net_code_to_subgraphs_map );
+
+    for( const CONNECTION_SUBGRAPH* subgraph : affected )
+        delete subgraph;
+
+    purge( m_subgraphs );
+
+    for( SCH_ITEM* item : removed )
+    {
+        if( !live.count( item ) )
+            m_items.erase( item );
+    }
+
+    // And merge the new ones
+
+    std::swap( sub.m_net_name_to_code_map, m_net_name_to_code_map );
+    std::swap( sub.m_bus_name_to_code_map, m_bus_name_to_code_map );
+    m_last_net_code = sub.m_last_net_code;
+    m_last_bus_code = sub.m_last_bus_code;
+    m_last_subgraph_code = sub.m_last_subgraph_code;
+
+    m_items.insert( sub.m_items.begin(), sub.m_items.end() );
+    m_subgraphs.insert( m_subgraphs.end(), sub.m_subgraphs.begin(), sub.m_subgraphs.end() );
+    m_driver_subgraphs.insert( m_driver_subgraphs.end(), sub.m_driver_subgraphs.begin(),
+                               sub.m_driver_subgraphs.end() );
+    m_invisible_power_pins.insert( m_invisible_power_pins.end(),
+                                   sub.m_invisible_power_pins.begin(),
+                                   sub.m_invisible_power_pins.end() );
+
+    auto merge_map =
+            [&]( auto& aMap, const auto& aOther )
+            {
+                for( const auto& it : aOther )
+                {
+                    auto& subgraphs = aMap[ it.first ];
+                    subgraphs.insert( subgraphs.end(), it.second.begin(), it.second.end() );
+                }
+            };
+
+    merge_map( m_sheet_to_subgraphs_map, sub.m_sheet_to_subgraphs_map );
+    merge_map( m_global_label_cache, sub.m_global_label_cache );
+    merge_map( m_local_label_cache, sub.m_local_label_cache );
+    merge_map( m_net_name_to_subgraphs_map, sub.m_net_name_to_subgraphs_map );
+    merge_map( m_net_code_to_subgraphs_map, sub.m_net_code_to_subgraphs_map );
+
+    cacheLinkNames( sub.m_subgraphs );
+
+    // The subgraphs are owned by this graph now
+    sub.m_subgraphs.clear();
+
+    m_screen_items = std::move( screen_items );
+
+    return true;
+}
+
+
 void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                                const std::vector<SCH_ITEM*>& aItemList )
 {
     std::unordered_map< wxPoint, std::vector<SCH_ITEM*> > connection_map;
 
+    // The pins are updated with their parent, or alone by an incremental update
+    auto add_sheet_pin =
+            [&]( SCH_SHEET_PIN* aPin )
+            {
+                if( !aPin->Connection( aSheet ) )
+                    aPin->InitializeConnection( aSheet );
+
+                aPin->ConnectedItems( aSheet ).clear();
+                aPin->Connection( aSheet )->Reset();
+
+                connection_map[ aPin->GetTextPos() ].push_back( aPin );
+                m_items.insert( aPin );
+            };
+
+    auto add_component_pin =
+            [&]( SCH_PIN* aPin )
+            {
+                aPin->InitializeConnection( aSheet );
+
+                // because calling the first time is not thread-safe
+                aPin->GetDefaultNetName( aSheet );
+                aPin->ConnectedItems( aSheet ).clear();
+
+                // Invisible power pins need to be post-processed later
+
+                if( aPin->IsPowerConnection() && !aPin->IsVisible() )
+                    m_invisible_power_pins.emplace_back( std::make_pair( aSheet, aPin ) );
+
+                connection_map[ aPin->GetTransformedPosition() ].push_back( aPin );
+                m_items.insert( aPin );
+            };
+
     for( SCH_ITEM* item : aItemList )
     {
         std::vector< wxPoint > points;
@@ -424,22 +1103,24 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
         if( item->Type() == SCH_SHEET_T )
         {
+            std::vector<SCH_ITEM*>& item_pins = m_item_pins[ item ];
+
             for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
             {
-                if( !pin->Connection( aSheet ) )
-                    pin->InitializeConnection( aSheet );
+                add_sheet_pin( pin );
 
-                pin->ConnectedItems( aSheet ).clear();
-                pin->Connection( aSheet )->Reset();
-
-                connection_map[ pin->GetTextPos() ].push_back( pin );
-                m_items.insert( pin );
+                if( std::find( item_pins.begin(), item_pins.end(), pin ) == item_pins.end() )
+                    item_pins.push_back( pin );
             }
         }
+        else if( item->Type() == SCH_SHEET_PIN_T )
+        {
+            add_sheet_pin( static_cast<SCH_SHEET_PIN*>( item ) );
+        }
         else if( item->Type() == SCH_COMPONENT_T )
         {
             SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
-            TRANSFORM t = component->GetTransform();
+            std::vector<SCH_ITEM*>& item_pins = m_item_pins[ item ];
 
             // TODO(JE) right now this relies on GetSchPins() returning good SCH_PIN pointers
             // that contain good LIB_PIN pointers.  Since these get invalidated whenever the
@@ -450,24 +1131,16 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
             for( SCH_PIN* pin : component->GetSchPins( &aSheet ) )
             {
-                pin->InitializeConnection( aSheet );
+                add_component_pin( pin );
 
-                wxPoint pos = t.TransformCoordinate( pin->GetPosition() ) +
-                              component->GetPosition();
-
-                // because calling the first time is not thread-safe
-                pin->GetDefaultNetName( aSheet );
-                pin->ConnectedItems( aSheet ).clear();
-
-                // Invisible power pins need to be post-processed later
-
-                if( pin->IsPowerConnection() && !pin->IsVisible() )
-                    m_invisible_power_pins.emplace_back( std::make_pair( aSheet, pin ) );
-
-                connection_map[ pos ].push_back( pin );
-                m_items.insert( pin );
+                if( std::find( item_pins.begin(), item_pins.end(), pin ) == item_pins.end() )
+                    item_pins.push_back( pin );
             }
         }
+        else if( item->Type() == SCH_PIN_T )
+        {
+            add_component_pin( static_cast<SCH_PIN*>( item ) );
+        }
         else
         {
             m_items.insert( item );
@@ -956,16 +1629,21 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     std::unordered_set<CONNECTION_SUBGRAPH*> invalidated_subgraphs;
 
-    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs)
+    // Test subgraphs with weak drivers for net name conflicts and fix them.  This needs the
+    // name map of the whole schematic, so it is done first, in order.  The sheet pins to promote
+    // are only recorded: the subgraphs before them on their sheet must not see the promotion, so
+    // it is applied by mergeSheetSubgraphs().
+
+    std::unordered_set<CONNECTION_SUBGRAPH*> promoted_subgraphs;
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
     {
-        if( subgraph->m_absorbed )
+        if( subgraph->m_absorbed || subgraph->m_strong_driver )
             continue;
 
         SCH_CONNECTION* connection = subgraph->m_driver_connection;
-        SCH_SHEET_PATH sheet = subgraph->m_sheet;
         wxString name = connection->Name();
 
-        // Test subgraphs with weak drivers for net name conflicts and fix them
         unsigned suffix = 1;
 
         auto create_new_name = [&] ( SCH_CONNECTION* aConn, wxString aName ) -> wxString
@@ -976,225 +1654,118 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                                    return new_name;
                                };
 
-        if( !subgraph->m_strong_driver )
-        {
-            auto& vec = m_net_name_to_subgraphs_map.at( name );
-
-            if( vec.size() > 1 )
-            {
-                wxString new_name = create_new_name( connection, name );
-
-                while( m_net_name_to_subgraphs_map.count( new_name ) )
-                    new_name = create_new_name( connection, name );
+        auto& vec = m_net_name_to_subgraphs_map.at( name );
 
-                wxLogTrace( "CONN", "%ld (%s) is weakly driven and not unique. Changing to %s.",
-                            subgraph->m_code, name, new_name );
+        if( vec.size() > 1 )
+        {
+            wxString new_name = create_new_name( connection, name );
 
-                vec.erase( std::remove( vec.begin(), vec.end(), subgraph ), vec.end() );
+            while( m_net_name_to_subgraphs_map.count( new_name ) )
+                new_name = create_new_name( connection, name );
 
-                m_net_name_to_subgraphs_map[new_name].emplace_back( subgraph );
+            wxLogTrace( "CONN", "%ld (%s) is weakly driven and not unique. Changing to %s.",
+                        subgraph->m_code, name, new_name );
 
-                name = new_name;
+            vec.erase( std::remove( vec.begin(), vec.end(), subgraph ), vec.end() );
 
-                subgraph->UpdateItemConnections();
-            }
-            else
-            {
-                // If there is no conflict, promote sheet pins to be strong drivers so that they
-                // will be considered below for propagation/merging.
+            m_net_name_to_subgraphs_map[new_name].emplace_back( subgraph );
 
-                if( subgraph->m_driver->Type() == SCH_SHEET_PIN_T )
-                {
-                    wxLogTrace( "CONN", "%ld (%s) weakly driven by unique sheet pin %s, promoting",
-                            subgraph->m_code, name,
-                            subgraph->m_driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
-
-                    subgraph->m_strong_driver = true;
-                }
-            }
+            subgraph->UpdateItemConnections();
         }
-
-        // Assign net codes
-
-        if( connection->IsBus() )
+        else if( subgraph->m_driver->Type() == SCH_SHEET_PIN_T )
         {
-            int code = -1;
+            // If there is no conflict, promote sheet pins to be strong drivers so that they
+            // will be considered below for propagation/merging.
 
-            if( m_bus_name_to_code_map.count( name ) )
-            {
-                code = m_bus_name_to_code_map.at( name );
-            }
-            else
-            {
-                code = m_last_bus_code++;
-                m_bus_name_to_code_map[ name ] = code;
-            }
+            wxLogTrace( "CONN", "%ld (%s) weakly driven by unique sheet pin %s, promoting",
+                        subgraph->m_code, name,
+                        subgraph->m_driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
 
-            connection->SetBusCode( code );
-            assignNetCodesToBus( connection );
+            promoted_subgraphs.insert( subgraph );
         }
-        else
-        {
-            assignNewNetCode( *connection );
-        }
-
-        subgraph->UpdateItemConnections();
-
-        // Reset the flag for the next loop below
-        subgraph->m_dirty = true;
-
-        // Next, we merge together subgraphs that have label connections, and create
-        // neighbor links for subgraphs that are part of a bus on the same sheet.
-        // For merging, we consider each possible strong driver.
-
-        // If this subgraph doesn't have a strong driver, let's skip it, since there is no
-        // way it will be merged with anything.
-
-        if( !subgraph->m_strong_driver )
-            continue;
+    }
 
-        // candidate_subgraphs will contain each valid, non-bus subgraph on the same sheet
-        // as the subgraph we are considering that has a strong driver.
-        // Weakly driven subgraphs are not considered since they will never be absorbed or
-        // form neighbor links.
+    // Next, we merge together subgraphs that have label connections, and create neighbor links
+    // for subgraphs that are part of a bus on the same sheet.  This only involves the subgraphs
+    // of a single sheet, so the sheets are processed in parallel.
 
-        std::vector<CONNECTION_SUBGRAPH*> candidate_subgraphs;
-        std::copy_if( m_sheet_to_subgraphs_map[ subgraph->m_sheet ].begin(),
-                      m_sheet_to_subgraphs_map[ subgraph->m_sheet ].end(),
-                      std::back_inserter( candidate_subgraphs ),
-                      [&] ( const CONNECTION_SUBGRAPH* candidate )
-                      {
-                          return ( !candidate->m_absorbed &&
-                                   candidate->m_strong_driver &&
-                                   candidate != subgraph );
-                      } );
+    std::vector<std::vector<CONNECTION_SUBGRAPH*>*> sheet_subgraphs;
 
-        // This is a list of connections on the current subgraph to compare to the
-        // drivers of each candidate subgraph.  If the current subgraph is a bus,
-        // we should consider each bus member.
-        std::vector< std::shared_ptr<SCH_CONNECTION> > connections_to_check;
+    for( auto& it : m_sheet_to_subgraphs_map )
+        sheet_subgraphs.push_back( &it.second );
 
-        // Also check the main driving connection
-        connections_to_check.push_back( std::make_shared<SCH_CONNECTION>( *connection ) );
+    std::vector<std::unordered_set<CONNECTION_SUBGRAPH*>> sheet_invalidated_subgraphs(
+            sheet_subgraphs.size() );
+    std::atomic<size_t> nextSheet( 0 );
 
-        auto add_connections_to_check = [&] ( CONNECTION_SUBGRAPH* aSubgraph ) {
-            for( SCH_ITEM* possible_driver : aSubgraph->m_items )
+    auto merge_lambda =
+            [&]() -> size_t
             {
-                if( possible_driver == aSubgraph->m_driver )
-                    continue;
-
-                auto c = getDefaultConnection( possible_driver, aSubgraph->m_sheet );
-
-                if( c )
+                for( size_t ii = nextSheet++; ii < sheet_subgraphs.size(); ii = nextSheet++ )
                 {
-                    if( c->Type() != aSubgraph->m_driver_connection->Type() )
-                        continue;
-
-                    if( c->Name( true ) == aSubgraph->m_driver_connection->Name( true ) )
-                        continue;
-
-                    connections_to_check.push_back( c );
-                    wxLogTrace( "CONN", "%lu (%s): Adding secondary driver %s", aSubgraph->m_code,
-                            aSubgraph->m_driver_connection->Name( true ), c->Name( true ) );
+                    mergeSheetSubgraphs( *sheet_subgraphs[ii], promoted_subgraphs,
+                                         sheet_invalidated_subgraphs[ii] );
                 }
-            }
-        };
-
-        // Now add other strong drivers
-        // The actual connection attached to these items will have been overwritten
-        // by the chosen driver of the subgraph, so we need to create a dummy connection
-        add_connections_to_check( subgraph );
 
-        for( unsigned i = 0; i < connections_to_check.size(); i++ )
-        {
-            auto member = connections_to_check[i];
-
-            if( member->IsBus() )
-            {
-                connections_to_check.insert( connections_to_check.end(),
-                                             member->Members().begin(),
-                                             member->Members().end() );
-            }
-
-            wxString test_name = member->Name( true );
-
-            for( auto candidate : candidate_subgraphs )
-            {
-                if( candidate->m_absorbed )
-                    continue;
-
-                bool match = false;
-
-                if( candidate->m_driver_connection->Name( true ) == test_name )
-                {
-                    match = true;
-                }
-                else
-                {
-                    if( !candidate->m_multiple_drivers )
-                        continue;
+                return 1;
+            };
 
-                    for( SCH_ITEM *driver : candidate->m_drivers )
-                    {
-                        if( driver == candidate->m_driver )
-                            continue;
+    size_t mergeThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                sheet_subgraphs.size() );
 
-                        // Sheet pins are not candidates for merging
-                        if( driver->Type() == SCH_SHEET_PIN_T )
-                            continue;
+    if( mergeThreadCount <= 1 )
+        merge_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> merges( mergeThreadCount );
 
-                        if( driver->Type() == SCH_PIN_T )
-                        {
-                            auto pin = static_cast<SCH_PIN*>( driver );
+        for( size_t ii = 0; ii < mergeThreadCount; ++ii )
+            merges[ii] = std::async( std::launch::async, merge_lambda );
 
-                            if( pin->IsPowerConnection() && pin->GetName() == test_name )
-                            {
-                                match = true;
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            wxASSERT( driver->Type() == SCH_LABEL_T ||
-                                      driver->Type() == SCH_GLOBAL_LABEL_T ||
-                                      driver->Type() == SCH_HIER_LABEL_T );
+        for( size_t ii = 0; ii < mergeThreadCount; ++ii )
+            merges[ii].wait();
+    }
 
-                            auto text = static_cast<SCH_TEXT*>( driver );
+    for( const auto& invalidated : sheet_invalidated_subgraphs )
+        invalidated_subgraphs.insert( invalidated.begin(), invalidated.end() );
 
-                            if( text->GetShownText() == test_name )
-                            {
-                                match = true;
-                                break;
-                            }
-                        }
-                    }
-                }
+    // Assign net codes, in the order of the subgraphs.  Subgraphs which were absorbed don't
+    // need one: the subgraphs which absorbed them are resolved again below.
 
-                if( match )
-                {
-                    if( connection->IsBus() && candidate->m_driver_connection->IsNet() )
-                    {
-                         wxLogTrace( "CONN", "%lu (%s) has bus child %lu (%s)", subgraph->m_code,
-                                     connection->Name(), candidate->m_code, member->Name() );
+    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
+    {
+        if( subgraph->m_absorbed )
+            continue;
 
-                        subgraph->m_bus_neighbors[member].insert( candidate );
-                        candidate->m_bus_parents[member].insert( subgraph );
-                    }
-                    else
-                    {
-                        wxLogTrace( "CONN", "%lu (%s) absorbs neighbor %lu (%s)",
-                                    subgraph->m_code, connection->Name(),
-                                    candidate->m_code, candidate->m_driver_connection->Name() );
+        SCH_CONNECTION* connection = subgraph->m_driver_connection;
+        wxString name = connection->Name();
 
-                        // Candidate may have other non-chosen drivers we need to follow
-                        add_connections_to_check( candidate );
+        if( connection->IsBus() )
+        {
+            int code = -1;
 
-                        subgraph->Absorb( candidate );
-                        invalidated_subgraphs.insert( subgraph );
-                    }
-                }
+            if( m_bus_name_to_code_map.count( name ) )
+            {
+                code = m_bus_name_to_code_map.at( name );
             }
+            else
+            {
+                code = m_last_bus_code++;
+                m_bus_name_to_code_map[ name ] = code;
+            }
+
+            connection->SetBusCode( code );
+            assignNetCodesToBus( connection );
         }
+        else
+        {
+            assignNewNetCode( *connection );
+        }
+
+        subgraph->UpdateItemConnections();
+
+        // Reset the flag for the next loop below
+        subgraph->m_dirty = true;
     }
 
     // Update any subgraph that was invalidated above
@@ -1224,14 +1795,17 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                               } ),
                               m_driver_subgraphs.end() );
 
-    // Store global subgraphs for later reference
-    std::vector<CONNECTION_SUBGRAPH*> global_subgraphs;
-    std::copy_if( m_driver_subgraphs.begin(), m_driver_subgraphs.end(),
-                  std::back_inserter( global_subgraphs ),
-                  [&] ( const CONNECTION_SUBGRAPH* candidate ) -> bool
-                  {
-                      return !candidate->m_local_driver;
-                  } );
+    // Store global subgraphs by name for later reference
+    m_global_name_to_subgraphs_map.clear();
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
+    {
+        if( !subgraph->m_local_driver )
+        {
+            wxString name = subgraph->m_driver_connection->Name();
+            m_global_name_to_subgraphs_map[name].push_back( subgraph );
+        }
+    }
 
     // Recache remaining valid subgraphs by sheet path
     m_sheet_to_subgraphs_map.clear();
@@ -1266,7 +1840,15 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                 bool secondary_is_global = CONNECTION_SUBGRAPH::GetDriverPriority( driver )
                                            >= CONNECTION_SUBGRAPH::PRIORITY::POWER_PIN;
 
-                for( CONNECTION_SUBGRAPH* candidate : global_subgraphs )
+                auto it = m_global_name_to_subgraphs_map.find( secondary_name );
+
+                if( it == m_global_name_to_subgraphs_map.end() )
+                    continue;
+
+                // A copy, since the promoted subgraphs are cached under their new name
+                std::vector<CONNECTION_SUBGRAPH*> candidates = it->second;
+
+                for( CONNECTION_SUBGRAPH* candidate : candidates )
                 {
                     if( candidate == subgraph )
                         continue;
@@ -1284,6 +1866,8 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                         conn->Clone( *subgraph->m_driver_connection );
                         candidate->UpdateItemConnections();
 
+                        m_global_name_to_subgraphs_map[conn->Name()].push_back( candidate );
+
                         candidate->m_dirty = false;
                     }
                 }
@@ -1294,6 +1878,8 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         propagateToNeighbors( subgraph );
     }
 
+    m_global_name_to_subgraphs_map.clear();
+
     // Handle buses that have been linked together somewhere by member (net) connections.
     // This feels a bit hacky, perhaps this algorithm should be revisited in the future.
 
@@ -1395,6 +1981,171 @@ void CONNECTION_GRAPH::buildConnectionGraph()
             m_subgraphs.end() );
 }
 
+void CONNECTION_GRAPH::mergeSheetSubgraphs( std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                                   const std::unordered_set<CONNECTION_SUBGRAPH*>& aPromoted,
+                                   std::unordered_set<CONNECTION_SUBGRAPH*>& aInvalidated )
+{
+    for( CONNECTION_SUBGRAPH* subgraph : aSubgraphs )
+    {
+        if( subgraph->m_absorbed )
+            continue;
+
+        if( aPromoted.count( subgraph ) )
+            subgraph->m_strong_driver = true;
+
+        // For merging, we consider each possible strong driver.
+        // If this subgraph doesn't have a strong driver, let's skip it, since there is no
+        // way it will be merged with anything.
+
+        if( !subgraph->m_strong_driver )
+            continue;
+
+        SCH_CONNECTION* connection = subgraph->m_driver_connection;
+
+        // candidate_subgraphs will contain each valid, non-bus subgraph on the same sheet
+        // as the subgraph we are considering that has a strong driver.
+        // Weakly driven subgraphs are not considered since they will never be absorbed or
+        // form neighbor links.
+
+        std::vector<CONNECTION_SUBGRAPH*> candidate_subgraphs;
+        std::copy_if( aSubgraphs.begin(), aSubgraphs.end(),
+                      std::back_inserter( candidate_subgraphs ),
+                      [&] ( const CONNECTION_SUBGRAPH* candidate )
+                      {
+                          return ( !candidate->m_absorbed &&
+                                   candidate->m_strong_driver &&
+                                   candidate != subgraph );
+                      } );
+
+        // This is a list of connections on the current subgraph to compare to the
+        // drivers of each candidate subgraph.  If the current subgraph is a bus,
+        // we should consider each bus member.
+        std::vector< std::shared_ptr<SCH_CONNECTION> > connections_to_check;
+
+        // Also check the main driving connection
+        connections_to_check.push_back( std::make_shared<SCH_CONNECTION>( *connection ) );
+
+        auto add_connections_to_check = [&] ( CONNECTION_SUBGRAPH* aSubgraph ) {
+            for( SCH_ITEM* possible_driver : aSubgraph->m_items )
+            {
+                if( possible_driver == aSubgraph->m_driver )
+                    continue;
+
+                auto c = getDefaultConnection( possible_driver, aSubgraph->m_sheet );
+
+                if( c )
+                {
+                    if( c->Type() != aSubgraph->m_driver_connection->Type() )
+                        continue;
+
+                    if( c->Name( true ) == aSubgraph->m_driver_connection->Name( true ) )
+                        continue;
+
+                    connections_to_check.push_back( c );
+                    wxLogTrace( "CONN", "%lu (%s): Adding secondary driver %s", aSubgraph->m_code,
+                            aSubgraph->m_driver_connection->Name( true ), c->Name( true ) );
+                }
+            }
+        };
+
+        // Now add other strong drivers
+        // The actual connection attached to these items will have been overwritten
+        // by the chosen driver of the subgraph, so we need to create a dummy connection
+        add_connections_to_check( subgraph );
+
+        for( unsigned i = 0; i < connections_to_check.size(); i++ )
+        {
+            auto member = connections_to_check[i];
+
+            if( member->IsBus() )
+            {
+                connections_to_check.insert( connections_to_check.end(),
+                                             member->Members().begin(),
+                                             member->Members().end() );
+            }
+
+            wxString test_name = member->Name( true );
+
+            for( auto candidate : candidate_subgraphs )
+            {
+                if( candidate->m_absorbed )
+                    continue;
+
+                bool match = false;
+
+                if( candidate->m_driver_connection->Name( true ) == test_name )
+                {
+                    match = true;
+                }
+                else
+                {
+                    if( !candidate->m_multiple_drivers )
+                        continue;
+
+                    for( SCH_ITEM *driver : candidate->m_drivers )
+                    {
+                        if( driver == candidate->m_driver )
+                            continue;
+
+                        // Sheet pins are not candidates for merging
+                        if( driver->Type() == SCH_SHEET_PIN_T )
+                            continue;
+
+                        if( driver->Type() == SCH_PIN_T )
+                        {
+                            auto pin = static_cast<SCH_PIN*>( driver );
+
+                            if( pin->IsPowerConnection() && pin->GetName() == test_name )
+                            {
+                                match = true;
+                                break;
+                            }
+                        }
+                        else
+                        {
+                            wxASSERT( driver->Type() == SCH_LABEL_T ||
+                                      driver->Type() == SCH_GLOBAL_LABEL_T ||
+                                      driver->Type() == SCH_HIER_LABEL_T );
+
+                            auto text = static_cast<SCH_TEXT*>( driver );
+
+                            if( text->GetShownText() == test_name )
+                            {
+                                match = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if( match )
+                {
+                    if( connection->IsBus() && candidate->m_driver_connection->IsNet() )
+                    {
+                         wxLogTrace( "CONN", "%lu (%s) has bus child %lu (%s)", subgraph->m_code,
+                                     connection->Name(), candidate->m_code, member->Name() );
+
+                        subgraph->m_bus_neighbors[member].insert( candidate );
+                        candidate->m_bus_parents[member].insert( subgraph );
+                    }
+                    else
+                    {
+                        wxLogTrace( "CONN", "%lu (%s) absorbs neighbor %lu (%s)",
+                                    subgraph->m_code, connection->Name(),
+                                    candidate->m_code, candidate->m_driver_connection->Name() );
+
+                        // Candidate may have other non-chosen drivers we need to follow
+                        add_connections_to_check( candidate );
+
+                        subgraph->Absorb( candidate );
+                        aInvalidated.insert( subgraph );
+                    }
+                }
+            }
+        }
+    }
+}
+
 
 int CONNECTION_GRAPH::assignNewNetCode( SCH_CONNECTION& aConnection )
 {
@@ -1812,6 +2563,13 @@ void CONNECTION_GRAPH::recacheSubgraphName(
         aSubgraph->m_driver_connection->Name() );
 
     m_net_name_to_subgraphs_map[aSubgraph->m_driver_connection->Name()].push_back( aSubgraph );
+
+    // The stale entry under the old name is skipped by the name check of the lookups
+    if( !aSubgraph->m_local_driver && !m_global_name_to_subgraphs_map.empty() )
+    {
+        wxString name = aSubgraph->m_driver_connection->Name();
+        m_global_name_to_subgraphs_map[name].push_back( aSubgraph );
+    }
 }
 
 
@@ -22,6 +22,7 @@
 #define _CONNECTION_GRAPH_H
 
 #include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <common.h>
@@ -39,6 +40,7 @@
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -196,6 +198,9 @@ public:
 
     // If not null, this indicates the subgraph on a higher level sheet that is linked to this one
     CONNECTION_SUBGRAPH* m_hier_parent;
+
+    /// Names this subgraph may be linked to other subgraphs by (see CONNECTION_GRAPH)
+    std::vector<wxString> m_link_names;
 };
 
 /// Associates a net code with the final name of a net
@@ -227,6 +232,11 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless aUnconditional is set, only the part of the graph reached by the items changed,
+     * added or removed since the last update is recalculated.  Changed items must have been
+     * flagged with SCH_ITEM::SetConnectivityDirty().  The graph is fully recalculated when the
+     * hierarchy or the bus aliases changed.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
@@ -267,6 +277,18 @@ private:
 
     std::unordered_set<SCH_ITEM*> m_items;
 
+    /// The connectable items of each screen at the last update, to find the removed ones
+    std::unordered_map<SCH_SCREEN*, std::unordered_set<SCH_ITEM*>> m_screen_items;
+
+    /// The pins of the components and sheets at the last update
+    std::unordered_map<SCH_ITEM*, std::vector<SCH_ITEM*>> m_item_pins;
+
+    /// The hierarchy at the last update
+    std::vector<SCH_SHEET_PATH> m_sheet_paths;
+
+    /// The bus aliases at the last update, as returned by getBusAliasSignature()
+    wxString m_bus_alias_signature;
+
     // The owner of all CONNECTION_SUBGRAPH objects
     std::vector<CONNECTION_SUBGRAPH*> m_subgraphs;
 
@@ -295,6 +317,15 @@ private:
 
     NET_MAP m_net_code_to_subgraphs_map;
 
+    /// The globally driven subgraphs by driver name, while buildConnectionGraph() propagates
+    /// the secondary global drivers.  May hold stale entries: check the name of the subgraphs
+    std::unordered_map<wxString,
+                       std::vector<CONNECTION_SUBGRAPH*>> m_global_name_to_subgraphs_map;
+
+    /// Every subgraph by each of its CONNECTION_SUBGRAPH::m_link_names
+    std::unordered_map<wxString,
+                       std::vector<CONNECTION_SUBGRAPH*>> m_link_name_to_subgraphs_map;
+
     int m_last_net_code;
 
     int m_last_bus_code;
@@ -336,6 +367,31 @@ private:
     void updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                  const std::vector<SCH_ITEM*>& aItemList );
 
+    /**
+     * Recalculates the part of the graph reached by the items changed since the last update.
+     *
+     * The subgraphs holding the changed or removed items, or touching the changed ones, are
+     * rebuilt together with all the subgraphs linked to them by a name (label, sheet pin,
+     * power pin, bus member or net name), which are the only ones the propagation of the new
+     * nets can reach.  They are built in a separate graph, merged back into this one.
+     *
+     * @return false if the graph cannot be updated this way and must be fully recalculated
+     */
+    bool updateChangedItems( const SCH_SHEET_LIST& aSheetList );
+
+    /**
+     * Adds to aNames the names aItem may link its subgraph to other subgraphs by, in any
+     * sheet: its label or pin net name, and the names of the members of a bus.
+     */
+    void getLinkNames( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet,
+                       std::vector<wxString>& aNames );
+
+    /// Sets the m_link_names of aSubgraphs and adds them to m_link_name_to_subgraphs_map
+    void cacheLinkNames( const std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs );
+
+    /// @return a string identifying the bus aliases of all the sheets and their members
+    wxString getBusAliasSignature( const SCH_SHEET_LIST& aSheetList ) const;
+
     /**
      * Generates the connection graph (after all item connectivity has been updated)
      *
@@ -394,6 +450,19 @@ private:
      */
     std::shared_ptr<SCH_CONNECTION> getDefaultConnection( SCH_ITEM* aItem, SCH_SHEET_PATH aSheet );
 
+    /**
+     * Merges the strongly driven subgraphs of a sheet that are connected by labels, and
+     * creates the neighbor links of the bus subgraphs of the sheet.  Only the given subgraphs
+     * are modified, so the sheets can be processed concurrently.
+     *
+     * @param aSubgraphs are the driven subgraphs of the sheet, in order
+     * @param aPromoted are the weakly driven subgraphs to promote to strong drivers
+     * @param aInvalidated receives the subgraphs which absorbed others
+     */
+    void mergeSheetSubgraphs( std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                              const std::unordered_set<CONNECTION_SUBGRAPH*>& aPromoted,
+                              std::unordered_set<CONNECTION_SUBGRAPH*>& aInvalidated );
+
     void recacheSubgraphName( CONNECTION_SUBGRAPH* aSubgraph, const wxString& aOldName );
 
     /**
@@ -168,10 +168,14 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
 {
     // This is process-level-initialization, not project-level-initialization of the DSO.
     // Do nothing in here pertinent to a project!
-    InitSettings( new EESCHEMA_SETTINGS );
-    aProgram->GetSettingsManager().RegisterSettings( KifaceSettings() );
+    {
+        SCOPED_STARTUP_PHASE phase( aProgram, wxT( "Eeschema settings" ) );
+
+        InitSettings( new EESCHEMA_SETTINGS );
+        aProgram->GetSettingsManager().RegisterSettings( KifaceSettings() );
 
-    start_common( aCtlBits );
+        start_common( aCtlBits );
+    }
 
     wxFileName fn = SYMBOL_LIB_TABLE::GetGlobalTableFileName();
 
@@ -185,6 +189,8 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
     {
         try
         {
+            SCOPED_STARTUP_PHASE phase( aProgram, wxT( "Global symbol library table" ) );
+
             // The global table is not related to a specific project.  All projects
             // will use the same global table.  So the KIFACE::OnKifaceStart() contract
             // of avoiding anything project specific is not violated here.
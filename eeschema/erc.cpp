@@ -28,6 +28,11 @@
  * @brief Electrical Rules Check implementation.
  */
 
+#include <atomic>
+#include <map>
+#include <set>
+#include <unordered_map>
+
 #include <fctsys.h>
 #include <sch_draw_panel.h>
 #include <kicad_string.h>
@@ -38,6 +43,10 @@
 #include <sch_marker.h>
 #include <sch_sheet.h>
 #include <sch_reference_list.h>
+#include <connection_graph.h>
+#include <erc_settings.h>
+#include <reporter.h>
+#include <thread_pool.h>
 #include <wx/ffile.h>
 
 
@@ -200,68 +209,96 @@ int TestDuplicateSheetNames( bool aCreateMarker )
 
 void TestTextVars()
 {
-    SCH_SCREENS screens;
+    SCH_SCREENS              screens;
+    std::vector<SCH_SCREEN*> screenList;
 
     for( SCH_SCREEN* screen = screens.GetFirst(); screen != NULL; screen = screens.GetNext() )
-    {
-        for( SCH_ITEM* item : screen->Items().OfType( SCH_LOCATE_ANY_T ) )
-        {
-            if( item->Type() == SCH_COMPONENT_T )
-            {
-                SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+        screenList.push_back( screen );
 
-                for( SCH_FIELD& field : component->GetFields() )
-                {
-                    if( field.GetShownText().Matches( wxT( "*${*}*" ) ) )
-                    {
-                        wxPoint delta = field.GetPosition() - component->GetPosition();
-                        delta = component->GetTransform().TransformCoordinate( delta );
+    // The screens are independent: each one is tested by a single task, and its markers are
+    // committed once all the screens are tested
+    std::vector<ERC_MARKER_LIST> markers( screenList.size() );
+    std::atomic<size_t>          nextScreen( 0 );
 
-                        SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
-                        marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
-                                         component->GetPosition() + delta, &field );
-                        screen->Append( marker );
-                    }
-                }
-            }
-            else if( item->Type() == SCH_SHEET_T )
+    auto testScreen =
+            []( SCH_SCREEN* aScreen, ERC_MARKER_LIST& aMarkers )
             {
-                SCH_SHEET* sheet = static_cast<SCH_SHEET*>( item );
-
-                for( SCH_FIELD& field : sheet->GetFields() )
+                for( SCH_ITEM* item : aScreen->Items().OfType( SCH_LOCATE_ANY_T ) )
                 {
-                    if( field.GetShownText().Matches( wxT( "*${*}*" ) ) )
+                    if( item->Type() == SCH_COMPONENT_T )
                     {
-                        SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
-                        marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
-                                         field.GetPosition(), &field );
-                        screen->Append( marker );
+                        SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+
+                        for( SCH_FIELD& field : component->GetFields() )
+                        {
+                            if( field.GetShownText().Matches( wxT( "*${*}*" ) ) )
+                            {
+                                wxPoint delta = field.GetPosition() - component->GetPosition();
+                                delta = component->GetTransform().TransformCoordinate( delta );
+
+                                SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
+                                marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
+                                                 component->GetPosition() + delta, &field );
+                                aMarkers.Add( aScreen, marker );
+                            }
+                        }
                     }
-                }
-
-                for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
-                {
-                    if( pin->GetShownText().Matches( wxT( "*${*}*" ) ) )
+                    else if( item->Type() == SCH_SHEET_T )
                     {
-                        SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
-                        marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
-                                         pin->GetPosition(), pin );
-                        screen->Append( marker );
+                        SCH_SHEET* sheet = static_cast<SCH_SHEET*>( item );
+
+                        for( SCH_FIELD& field : sheet->GetFields() )
+                        {
+                            if( field.GetShownText().Matches( wxT( "*${*}*" ) ) )
+                            {
+                                SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
+                                marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
+                                                 field.GetPosition(), &field );
+                                aMarkers.Add( aScreen, marker );
+                            }
+                        }
+
+                        for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+                        {
+                            if( pin->GetShownText().Matches( wxT( "*${*}*" ) ) )
+                            {
+                                SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
+                                marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
+                                                 pin->GetPosition(), pin );
+                                aMarkers.Add( aScreen, marker );
+                            }
+                        }
+                    }
+                    else if( SCH_TEXT* text = dynamic_cast<SCH_TEXT*>( item ) )
+                    {
+                        if( text->GetShownText().Matches( wxT( "*${*}*" ) ) )
+                        {
+                            SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
+                            marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
+                                             text->GetPosition(), text );
+                            aMarkers.Add( aScreen, marker );
+                        }
                     }
                 }
-            }
-            else if( SCH_TEXT* text = dynamic_cast<SCH_TEXT*>( item ) )
+            };
+
+    auto testScreens =
+            [&]()
             {
-                if( text->GetShownText().Matches( wxT( "*${*}*" ) ) )
-                {
-                    SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
-                    marker->SetData( EDA_UNITS::UNSCALED, ERCE_UNRESOLVED_VARIABLE,
-                                     text->GetPosition(), text );
-                    screen->Append( marker );
-                }
-            }
-        }
-    }
+                for( size_t i = nextScreen++; i < screenList.size(); i = nextScreen++ )
+                    testScreen( screenList[i], markers[i] );
+            };
+
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    size_t       parallelism = std::min<size_t>( pool.GetThreadCount() + 1, screenList.size() );
+
+    if( parallelism <= 1 )
+        testScreens();
+    else
+        pool.RunParallel( testScreens, parallelism );
+
+    for( ERC_MARKER_LIST& screenMarkers : markers )
+        screenMarkers.Commit();
 }
 
 
@@ -368,7 +405,25 @@ int TestMultiunitFootprints( SCH_SHEET_LIST& aSheetList )
 }
 
 
-void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst, int aMinConn, int aDiag )
+ERC_MARKER_LIST::~ERC_MARKER_LIST()
+{
+    // Markers not committed belong to nobody
+    for( const std::pair<SCH_SCREEN*, SCH_MARKER*>& entry : m_markers )
+        delete entry.second;
+}
+
+
+void ERC_MARKER_LIST::Commit()
+{
+    for( const std::pair<SCH_SCREEN*, SCH_MARKER*>& entry : m_markers )
+        entry.first->Append( entry.second );
+
+    m_markers.clear();
+}
+
+
+void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst, int aMinConn, int aDiag,
+               ERC_MARKER_LIST& aMarkers )
 {
     if( aDiag == OK || aMinConn < 1 || aNetItemRef->m_Type != NETLIST_ITEM::PIN )
         return;
@@ -377,7 +432,7 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst, int aMi
 
     /* Create new marker for ERC error. */
     SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
-    aNetItemRef->m_SheetPath.LastScreen()->Append( marker );
+    aMarkers.Add( aNetItemRef->m_SheetPath.LastScreen(), marker );
 
     if( aNetItemTst == NULL)
     {
@@ -402,7 +457,8 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst, int aMi
 
 
 void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion )
+                      int* aMinConnexion, const std::vector<unsigned>& aPinInstances,
+                      ERC_MARKER_LIST& aMarkers )
 {
     unsigned netItemTst = aNetStart;
     ELECTRICAL_PINTYPE jj;
@@ -442,24 +498,11 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned
                      * TODO test also if instances connected are connected to
                      * the same net
                      */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
+                    for( unsigned duplicate : aPinInstances )
                     {
-                        if( aList->GetItemType( duplicate ) != NETLIST_ITEM::PIN )
-                            continue;
-
                         if( duplicate == aNetItemRef )
                             continue;
 
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
                         // Same component and same pin. Do dot create error for this pin
                         // if the other pin is connected (i.e. if duplicate net has another
                         // item)
@@ -476,7 +519,7 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned
                 }
 
                 if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR, aMarkers );
 
                 *aMinConnexion = DRV;   // inhibiting other messages of this
                                        // type for the net.
@@ -523,7 +566,7 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned
                     if( aList->GetConnectionType( netItemTst ) == NET_CONNECTION::UNCONNECTED )
                     {
                         Diagnose( aList->GetItem( aNetItemRef ), aList->GetItem( netItemTst ),
-                                  0, erc );
+                                  0, erc, aMarkers );
                         aList->SetConnectionType( netItemTst,
                                                   NET_CONNECTION::NOCONNECT_SYMBOL_PRESENT );
                     }
@@ -535,6 +578,123 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned
     }
 }
 
+void TestPinConnections( NETLIST_OBJECT_LIST* aList )
+{
+    // A shared pin has to appear in only one net: multi-unit components that have shared pins
+    // could be wired to different nets.  This test spans the nets, so it is run first, on the
+    // calling thread.  The instances of each pin are gathered by the same pass, for the
+    // unconnected pins test of TestOthersItems().
+    std::map<std::pair<wxString, wxString>, std::vector<unsigned>> pinInstances;
+    std::unordered_map<wxString, wxString>                         pin_to_net_map;
+    std::unordered_map<unsigned, SCH_MARKER*>                      unitNetMarkers;
+    std::vector<std::pair<unsigned, unsigned>>                     netRanges;
+
+    for( unsigned itemIdx = 0; itemIdx < aList->size(); itemIdx++ )
+    {
+        NETLIST_OBJECT* item = aList->GetItem( itemIdx );
+
+        wxASSERT_MSG( itemIdx == 0 || aList->GetItemNet( itemIdx - 1 ) <= item->GetNet(),
+                      wxT( "Netlist not correctly ordered" ) );
+
+        // The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted by net number,
+        // which means we can group netlist items into ranges that live in the same net.
+        if( netRanges.empty() || aList->GetItemNet( netRanges.back().first ) != item->GetNet() )
+            netRanges.emplace_back( itemIdx, itemIdx );
+
+        netRanges.back().second = itemIdx + 1;
+
+        if( item->m_Type != NETLIST_ITEM::PIN || !item->m_Link )
+            continue;
+
+        wxString ref = item->GetComponentParent()->GetRef( &item->m_SheetPath );
+
+        pinInstances[ std::make_pair( ref, item->m_PinNum ) ].push_back( itemIdx );
+
+        if( g_ErcSettings->IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
+        {
+            wxString pin_name = ref + "_" + item->m_PinNum;
+            wxString msg;
+
+            if( pin_to_net_map.count( pin_name ) == 0 )
+            {
+                pin_to_net_map[pin_name] = item->GetNetName();
+            }
+            else if( pin_to_net_map[pin_name] != item->GetNetName() )
+            {
+                msg.Printf( _( "Pin %s on %s is connected to both %s and %s" ),
+                            item->m_PinNum,
+                            ref,
+                            pin_to_net_map[pin_name],
+                            item->GetNetName() );
+
+                SCH_MARKER* marker = new SCH_MARKER( MARKER_BASE::MARKER_ERC );
+                marker->SetData( ERCE_DIFFERENT_UNIT_NET, item->m_Start, msg, item->m_Start );
+                unitNetMarkers[itemIdx] = marker;
+            }
+        }
+    }
+
+    std::vector<const std::vector<unsigned>*> itemInstances( aList->size(), nullptr );
+
+    for( const auto& pin : pinInstances )
+    {
+        for( unsigned itemIdx : pin.second )
+            itemInstances[itemIdx] = &pin.second;
+    }
+
+    // The other tests only look at the items of a net, and the nets are tested concurrently.
+    // The markers of each net are kept in the order of a serial test, and committed in the
+    // order of the nets.
+    std::vector<ERC_MARKER_LIST> markers( netRanges.size() );
+    std::atomic<size_t>          nextNet( 0 );
+    const std::vector<unsigned>  noInstance;
+
+    auto testNets =
+            [&]()
+            {
+                for( size_t net = nextNet++; net < netRanges.size(); net = nextNet++ )
+                {
+                    unsigned netStart = netRanges[net].first;
+                    int      minConn = NOC;
+
+                    for( unsigned itemIdx = netStart; itemIdx < netRanges[net].second; itemIdx++ )
+                    {
+                        if( aList->GetItemType( itemIdx ) != NETLIST_ITEM::PIN )
+                            continue;
+
+                        auto unitNetMarker = unitNetMarkers.find( itemIdx );
+
+                        if( unitNetMarker != unitNetMarkers.end() )
+                        {
+                            markers[net].Add( aList->GetItem( itemIdx )->m_SheetPath.LastScreen(),
+                                              unitNetMarker->second );
+                        }
+
+                        // Look for ERC problems between pins:
+                        const std::vector<unsigned>* instances = itemInstances[itemIdx];
+
+                        TestOthersItems( aList, itemIdx, netStart, &minConn,
+                                         instances ? *instances : noInstance, markers[net] );
+                    }
+                }
+            };
+
+    // Waking up a worker is only worth it for a few hundred items
+    const size_t itemsPerThread = 256;
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    size_t       parallelism = std::min<size_t>( { pool.GetThreadCount() + 1, netRanges.size(),
+                                                   aList->size() / itemsPerThread + 1 } );
+
+    if( parallelism <= 1 )
+        testNets();
+    else
+        pool.RunParallel( testNets, parallelism );
+
+    for( ERC_MARKER_LIST& netMarkers : markers )
+        netMarkers.Commit();
+}
+
+
 // this code try to detect similar labels, i.e. labels which are identical
 // when they are compared using case insensitive coparisons.
 
@@ -730,3 +890,136 @@ static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItem
                      aItemA->m_Comp, aItemB->m_Comp );
     aItemA->m_SheetPath.LastScreen()->Append( marker );
 }
+
+
+void RunErcTests( SCH_EDIT_FRAME* aFrame, REPORTER& aReporter )
+{
+    SCH_SHEET_LIST sheets( g_RootSheet );
+
+    // Test duplicate sheet names inside a given sheet.  While one can have multiple references
+    // to the same file, each must have a unique name.
+    if( g_ErcSettings->IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
+    {
+        aReporter.ReportTail( _( "Checking sheet names...\n" ), RPT_SEVERITY_INFO );
+        TestDuplicateSheetNames( true );
+    }
+
+    if( g_ErcSettings->IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
+    {
+        aReporter.ReportTail( _( "Checking bus conflicts...\n" ), RPT_SEVERITY_INFO );
+        TestConflictingBusAliases();
+    }
+
+    // The connection graph has a whole set of ERC checks it can run
+    aReporter.ReportTail( _( "Checking conflicts...\n" ) );
+    aFrame->RecalculateConnections( NO_CLEANUP );
+    g_ConnectionGraph->RunERC();
+
+    // Test is all units of each multiunit component have the same footprint assigned.
+    if( g_ErcSettings->IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
+    {
+        aReporter.ReportTail( _( "Checking footprints...\n" ), RPT_SEVERITY_INFO );
+        TestMultiunitFootprints( sheets );
+    }
+
+    std::unique_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( aFrame->BuildNetListBase() );
+
+    // Reset the connection type indicator
+    objectsConnectedList->ResetConnectionsType();
+
+    aReporter.ReportTail( _( "Checking connections...\n" ), RPT_SEVERITY_INFO );
+    TestPinConnections( objectsConnectedList.get() );
+
+    // Test similar labels (i;e. labels which are identical when
+    // using case insensitive comparisons)
+    if( g_ErcSettings->IsTestEnabled( ERCE_SIMILAR_LABELS ) )
+    {
+        aReporter.ReportTail( _( "Checking labels...\n" ), RPT_SEVERITY_INFO );
+        objectsConnectedList->TestforSimilarLabels();
+    }
+
+    if( g_ErcSettings->IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
+        TestTextVars();
+}
+
+
+int RunErcHeadless( SCH_EDIT_FRAME* aFrame, std::ostream& aStream, EDA_UNITS aUnits )
+{
+    SCH_SHEET_LIST sheetList( g_RootSheet );
+    sheetList.AnnotatePowerSymbols();
+
+    if( aFrame->CheckAnnotate( NULL_REPORTER::GetInstance(), false ) )
+        return -1;
+
+    // The markers already on the schematic are not part of this run
+    std::set<SCH_ITEM*> previousMarkers;
+    SCH_SCREENS         screens;
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen != NULL; screen = screens.GetNext() )
+    {
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_MARKER_T ) )
+            previousMarkers.insert( item );
+    }
+
+    RunErcTests( aFrame, NULL_REPORTER::GetInstance() );
+
+    // Same report as the ERC dialog
+    int err_count = 0;
+    int warn_count = 0;
+    int total_count = 0;
+
+    aStream << TO_UTF8( wxString::Format( _( "ERC report (%s, Encoding UTF8)\n" ),
+                                          DateAndTime() ) );
+
+    for( unsigned i = 0; i < sheetList.size(); i++ )
+    {
+        aStream << TO_UTF8( wxString::Format( _( "\n***** Sheet %s\n" ),
+                                              sheetList[i].PathHumanReadable() ) );
+
+        for( SCH_ITEM* item : sheetList[i].LastScreen()->Items().OfType( SCH_MARKER_T ) )
+        {
+            SCH_MARKER* marker = static_cast<SCH_MARKER*>( item );
+
+            if( marker->GetMarkerType() != MARKER_BASE::MARKER_ERC
+                    || previousMarkers.count( marker ) )
+            {
+                continue;
+            }
+
+            total_count++;
+
+            switch( g_ErcSettings->m_Severities[ marker->GetRCItem()->GetErrorCode() ] )
+            {
+            case RPT_SEVERITY_ERROR:   err_count++;  break;
+            case RPT_SEVERITY_WARNING: warn_count++; break;
+            default:                                 break;
+            }
+
+            aStream << TO_UTF8( marker->GetRCItem()->ShowReport( aUnits ) );
+        }
+    }
+
+    aStream << TO_UTF8( wxString::Format( _( "\n ** ERC messages: %d  Errors %d  Warnings %d\n" ),
+                                          total_count, err_count, warn_count ) );
+    aStream.flush();
+
+    // Leave the schematic as it was
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen != NULL; screen = screens.GetNext() )
+    {
+        std::vector<SCH_ITEM*> newMarkers;
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_MARKER_T ) )
+        {
+            if( !previousMarkers.count( item ) )
+                newMarkers.push_back( item );
+        }
+
+        for( SCH_ITEM* marker : newMarkers )
+        {
+            screen->Remove( marker );
+            delete marker;
+        }
+    }
+
+    return total_count;
+}
@@ -30,9 +30,18 @@
 #ifndef _ERC_H
 #define _ERC_H
 
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <common.h>     // EDA_UNITS
 
 class NETLIST_OBJECT;
 class NETLIST_OBJECT_LIST;
+class REPORTER;
+class SCH_EDIT_FRAME;
+class SCH_MARKER;
+class SCH_SCREEN;
 class SCH_SHEET_LIST;
 
 /* For ERC markers: error types (used in diags, and to set the color):
@@ -84,13 +93,40 @@ enum ERCE_T
 #define NOC    0  // initial state of a net: no connection
 
 
+/**
+ * ERC_MARKER_LIST
+ * holds the markers found by an ERC test running on the thread pool.  The screens are only
+ * modified by the calling thread, which commits the lists of all the tasks in a fixed order
+ * once they are done.
+ */
+class ERC_MARKER_LIST
+{
+public:
+    ~ERC_MARKER_LIST();
+
+    void Add( SCH_SCREEN* aScreen, SCH_MARKER* aMarker )
+    {
+        m_markers.emplace_back( aScreen, aMarker );
+    }
+
+    /**
+     * Append the markers to their screen, in the order they were added, and empty the list.
+     */
+    void Commit();
+
+private:
+    std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>> m_markers;
+};
+
+
 /**
  * Performs ERC testing and creates an ERC marker to show the ERC problem for aNetItemRef
  * or between aNetItemRef and aNetItemTst.
  *  if MinConn < 0: this is an error on labels
+ * @param aMarkers = the list receiving the marker
  */
 void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst, int MinConnexion,
-               int Diag );
+               int Diag, ERC_MARKER_LIST& aMarkers );
 
 /**
  * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
@@ -100,9 +136,23 @@ void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst, int MinCo
  * @param aNetStart = index in list of net objects of the first item
  * @param aMinConnexion = a pointer to a variable to store the minimal connection
  * found( NOD, DRV, NPI, NET_NC)
+ * @param aPinInstances = the indices in list of all the instances of the pin aNetItemRef
+ *                        (same component reference and pin number), including aNetItemRef
+ * @param aMarkers = the list receiving the markers
  */
 void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion );
+                      int* aMinConnexion, const std::vector<unsigned>& aPinInstances,
+                      ERC_MARKER_LIST& aMarkers );
+
+/**
+ * Test the connections of all the pins of \a aList: pin to pin conflicts, pins not driven
+ * or not connected, and shared pins of multi-unit components connected to different nets.
+ *
+ * The nets are independent, so they are tested concurrently on the thread pool; the markers
+ * are added to the screens in the order of the list, as a serial test would do.
+ * @param aList = the list of connected objects, sorted by net code
+ */
+void TestPinConnections( NETLIST_OBJECT_LIST* aList );
 
 /**
  * Function TestDuplicateSheetNames( )
@@ -117,6 +167,7 @@ int TestDuplicateSheetNames( bool aCreateMarker );
 /**
  * Function TestTextVars()
  * Checks for any unresolved text variable references.
+ * The screens are tested concurrently on the thread pool.
  */
 void TestTextVars();
 
@@ -137,5 +188,20 @@ int TestConflictingBusAliases();
  */
 int TestMultiunitFootprints( SCH_SHEET_LIST& aSheetList );
 
+/**
+ * Run all the enabled ERC tests on the schematic of \a aFrame, the markers being added to the
+ * screens.  The annotation must have been checked beforehand.
+ * @param aReporter = receives the progress messages
+ */
+void RunErcTests( SCH_EDIT_FRAME* aFrame, REPORTER& aReporter );
+
+/**
+ * Run the ERC tests without the ERC dialog, and write the same report as the dialog to
+ * \a aStream.  The markers found are removed from the schematic once written, the markers
+ * of a previous ERC being left untouched.
+ * @return the number of violations written, or -1 if the schematic is not fully annotated
+ */
+int RunErcHeadless( SCH_EDIT_FRAME* aFrame, std::ostream& aStream, EDA_UNITS aUnits );
+
 
 #endif  // _ERC_H
@@ -199,8 +199,16 @@ void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT*
 
 XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
 {
-    XNODE*      xcomps = node( "components" );
+    XNODE* xcomps = node( "components" );
 
+    visitComponents( [&]( XNODE* aComp ) { xcomps->AddChild( aComp ); } );
+
+    return xcomps;
+}
+
+
+void NETLIST_EXPORTER_GENERIC::visitComponents( const std::function<void( XNODE* )>& aVisitor )
+{
     m_ReferencesAlreadyFound.Clear();
 
     SCH_SHEET_LIST sheetList( g_RootSheet );
@@ -247,7 +255,7 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
             // under XSL processing systems which do sequential searching within
             // an element.
 
-            xcomps->AddChild( xcomp = node( "comp" ) );
+            xcomp = node( "comp" );
             xcomp->AddAttribute( "ref", comp->GetRef( &sheetList[i] ) );
 
             addComponentFields( xcomp, comp, &sheetList[i] );
@@ -272,10 +280,10 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
             xsheetpath->AddAttribute( "names", sheetList[i].PathHumanReadable() );
             xsheetpath->AddAttribute( "tstamps", sheetList[i].PathAsString() );
             xcomp->AddChild( node( "tstamp", comp->m_Uuid.AsString() ) );
+
+            aVisitor( xcomp );
         }
     }
-
-    return xcomps;
 }
 
 
@@ -396,8 +404,16 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibraries()
 
 XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 {
-    XNODE*      xlibparts = node( "libparts" );   // auto_ptr
+    XNODE* xlibparts = node( "libparts" );   // auto_ptr
 
+    visitLibParts( [&]( XNODE* aLibPart ) { xlibparts->AddChild( aLibPart ); } );
+
+    return xlibparts;
+}
+
+
+void NETLIST_EXPORTER_GENERIC::visitLibParts( const std::function<void( XNODE* )>& aVisitor )
+{
     LIB_PINS    pinList;
     LIB_FIELDS  fieldList;
 
@@ -411,8 +427,7 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts component's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( "libpart" ) );
+        XNODE* xlibpart = node( "libpart" );
         xlibpart->AddAttribute( "lib", libNickname );
         xlibpart->AddAttribute( "part", lcomp->GetName()  );
 
@@ -491,9 +506,9 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
                 // caution: construction work site here, drive slowly
             }
         }
-    }
 
-    return xlibparts;
+        aVisitor( xlibpart );
+    }
 }
 
 
@@ -501,14 +516,6 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
 {
     XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
-    wxString    netName;
-    wxString    ref;
-
-    XNODE*      xnet = 0;
-    int         netCode;
-    int         lastNetCode = -1;
-    int         sameNetcodeCount = 0;
-
 
     /*  output:
         <net code="123" name="/cfcard.sch/WAIT#">
@@ -517,6 +524,38 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
         </net>
     */
 
+    visitNets(
+            [&]( int aCode, const wxString& aName, const std::vector<NET_NODE>& aNodes )
+            {
+                XNODE* xnet;
+
+                xnets->AddChild( xnet = node( "net" ) );
+                netCodeTxt.Printf( "%d", aCode );
+                xnet->AddAttribute( "code", netCodeTxt );
+                xnet->AddAttribute( "name", aName );
+
+                for( const NET_NODE& netNode : aNodes )
+                {
+                    XNODE* xnode;
+
+                    xnet->AddChild( xnode = node( "node" ) );
+                    xnode->AddAttribute( "ref", netNode.m_Ref );
+                    xnode->AddAttribute( "pin", netNode.m_Pin );
+
+                    if( !netNode.m_PinFunction.IsEmpty() )
+                        xnode->AddAttribute( "pinfunction", netNode.m_PinFunction );
+                }
+            },
+            aUseGraph );
+
+    return xnets;
+}
+
+
+void NETLIST_EXPORTER_GENERIC::visitNets( const NET_VISITOR& aVisitor, bool aUseGraph )
+{
+    std::vector<NET_NODE> nodes;
+
     m_LibParts.clear();     // must call this function before using m_LibParts.
 
     if( aUseGraph )
@@ -524,100 +563,99 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
         wxASSERT( m_graph );
         int code = 0;
 
-        for( const auto& it : m_graph->GetNetMap() )
+        /// A pin of the net, and the reference of its component
+        struct NET_PIN
         {
-            bool     added     = false;
-            wxString net_name  = it.first.first;
-            auto     subgraphs = it.second;
+            SCH_PIN* m_Pin;
+            wxString m_Ref;
+        };
+
+        std::vector<NET_PIN> sorted_items;
 
+        for( const auto& it : m_graph->GetNetMap() )
+        {
             // Code starts at 1
             code++;
 
-            XNODE* xnode;
-            std::vector<std::pair<SCH_PIN*, SCH_SHEET_PATH>> sorted_items;
+            sorted_items.clear();
 
-            for( auto subgraph : subgraphs )
+            for( CONNECTION_SUBGRAPH* subgraph : it.second )
             {
-                auto sheet = subgraph->m_sheet;
+                SCH_SHEET_PATH& sheet = subgraph->m_sheet;
 
-                for( auto item : subgraph->m_items )
+                // The references are looked for once, not each time two pins are compared
+                for( SCH_ITEM* item : subgraph->m_items )
+                {
                     if( item->Type() == SCH_PIN_T )
-                        sorted_items.emplace_back(
-                                std::make_pair( static_cast<SCH_PIN*>( item ), sheet ) );
+                    {
+                        SCH_PIN* pin = static_cast<SCH_PIN*>( item );
+                        wxString ref = pin->GetParentComponent()->GetRef( &sheet );
+
+                        sorted_items.push_back( { pin, ref } );
+                    }
+                }
             }
 
             // Netlist ordering: Net name, then ref des, then pin name
-            std::sort( sorted_items.begin(), sorted_items.end(), [] ( auto a, auto b ) {
-                        auto ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                        auto ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                        if( ref_a == ref_b )
-                            return a.first->GetNumber() < b.first->GetNumber();
+            std::sort( sorted_items.begin(), sorted_items.end(),
+                    []( const NET_PIN& a, const NET_PIN& b )
+                    {
+                        if( a.m_Ref == b.m_Ref )
+                            return a.m_Pin->GetNumber() < b.m_Pin->GetNumber();
 
-                        return ref_a < ref_b;
+                        return a.m_Ref < b.m_Ref;
                     } );
 
             // Some duplicates can exist, for example on multi-unit parts with duplicated
             // pins across units.  If the user connects the pins on each unit, they will
             // appear on separate subgraphs.  Remove those here:
             sorted_items.erase( std::unique( sorted_items.begin(), sorted_items.end(),
-                    [] ( auto a, auto b ) {
-                        auto ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                        auto ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                        return ref_a == ref_b && a.first->GetNumber() == b.first->GetNumber();
+                    []( const NET_PIN& a, const NET_PIN& b )
+                    {
+                        return a.m_Ref == b.m_Ref
+                               && a.m_Pin->GetNumber() == b.m_Pin->GetNumber();
                     } ), sorted_items.end() );
 
-            for( const auto& pair : sorted_items )
-            {
-                SCH_PIN* pin = pair.first;
-                SCH_SHEET_PATH sheet = pair.second;
-
-                auto refText = pin->GetParentComponent()->GetRef( &sheet );
-                const auto& pinText = pin->GetNumber();
+            nodes.clear();
 
+            for( const NET_PIN& netPin : sorted_items )
+            {
                 // Skip power symbols and virtual components
-                if( refText[0] == wxChar( '#' ) )
+                if( netPin.m_Ref[0] == wxChar( '#' ) )
                     continue;
 
-                if( !added )
-                {
-                    xnets->AddChild( xnet = node( "net" ) );
-                    netCodeTxt.Printf( "%d", code );
-                    xnet->AddAttribute( "code", netCodeTxt );
-                    xnet->AddAttribute( "name", net_name );
-
-                    added = true;
-                }
-
-                xnet->AddChild( xnode = node( "node" ) );
-                xnode->AddAttribute( "ref", refText );
-                xnode->AddAttribute( "pin", pinText );
-
                 wxString pinName;
 
-                if( pin->GetName() != "~" ) //  ~ is a char used to code empty strings in libs.
-                    pinName = pin->GetName();
-
-                if( !pinName.IsEmpty() )
-                    xnode->AddAttribute( "pinfunction", pinName );
+                //  ~ is a char used to code empty strings in libs.
+                if( netPin.m_Pin->GetName() != "~" )
+                    pinName = netPin.m_Pin->GetName();
 
+                nodes.push_back( { netPin.m_Ref, netPin.m_Pin->GetNumber(), pinName } );
             }
+
+            if( !nodes.empty() )
+                aVisitor( code, it.first.first, nodes );
         }
     }
     else
     {
+        wxString netName;
+        int      lastNetCode = -1;
+
         for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         {
             NETLIST_OBJECT* nitem = m_masterList->GetItem( ii );
             SCH_COMPONENT*  comp;
 
-            // New net found, write net id;
-            if( ( netCode = nitem->GetNet() ) != lastNetCode )
+            // New net found, write the previous one
+            if( nitem->GetNet() != lastNetCode )
             {
-                sameNetcodeCount = 0;   // item count for this net
+                if( !nodes.empty() )
+                    aVisitor( lastNetCode, netName, nodes );
+
+                nodes.clear();
                 netName = nitem->GetNetName();
-                lastNetCode  = netCode;
+                lastNetCode = nitem->GetNet();
             }
 
             if( nitem->m_Type != NETLIST_ITEM::PIN )
@@ -629,29 +667,17 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
             comp = nitem->GetComponentParent();
 
             // Get the reference for the net name and the main parent component
-            ref = comp->GetRef( &nitem->m_SheetPath );
+            wxString ref = comp->GetRef( &nitem->m_SheetPath );
+
             if( ref[0] == wxChar( '#' ) )
                 continue;
 
-            if( ++sameNetcodeCount == 1 )
-            {
-                xnets->AddChild( xnet = node( "net" ) );
-                netCodeTxt.Printf( "%d", netCode );
-                xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", netName );
-            }
-
-            XNODE*      xnode;
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", ref );
-            xnode->AddAttribute( "pin",  nitem->GetPinNumText() );
-
-            if( !nitem->GetPinNameText().IsEmpty() )
-                xnode->AddAttribute( "pinfunction", nitem->GetPinNameText() );
+            nodes.push_back( { ref, nitem->GetPinNumText(), nitem->GetPinNameText() } );
         }
-    }
 
-    return xnets;
+        if( !nodes.empty() )
+            aVisitor( lastNetCode, netName, nodes );
+    }
 }
 
 
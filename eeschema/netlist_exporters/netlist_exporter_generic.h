@@ -26,6 +26,8 @@
 #ifndef NETLIST_EXPORT_GENERIC_H
 #define NETLIST_EXPORT_GENERIC_H
 
+#include <functional>
+
 #include <netlist_exporter.h>
 
 #include <project.h>
@@ -112,6 +114,14 @@ protected:
      */
     XNODE* makeComponents();
 
+    /**
+     * Function visitComponents
+     * builds the node of each schematic component, in the order of makeComponents(), and
+     * passes it to \a aVisitor which takes its ownership.  Used to write the components
+     * one by one, without building the whole sub-tree.
+     */
+    void visitComponents( const std::function<void( XNODE* )>& aVisitor );
+
     /**
      * Function makeDesignHeader
      * fills out a project "design" header into an XML node.
@@ -126,6 +136,24 @@ protected:
      */
     XNODE* makeLibParts();
 
+    /**
+     * Function visitLibParts
+     * builds the node of each library part, in the order of makeLibParts(), and passes it
+     * to \a aVisitor which takes its ownership.
+     */
+    void visitLibParts( const std::function<void( XNODE* )>& aVisitor );
+
+    /// A pin of a net, as written in the netlist
+    struct NET_NODE
+    {
+        wxString m_Ref;
+        wxString m_Pin;
+        wxString m_PinFunction;     ///< the pin name, empty if the pin has no name
+    };
+
+    typedef std::function<void( int aCode, const wxString& aName,
+                                const std::vector<NET_NODE>& aNodes )> NET_VISITOR;
+
     /**
      * Function makeListOfNets
      * fills out an XML node with a list of nets and returns it.
@@ -133,6 +161,14 @@ protected:
      */
     XNODE* makeListOfNets( bool aUseGraph = true );
 
+    /**
+     * Function visitNets
+     * calls \a aVisitor with the code, the name and the sorted pins of each net connected
+     * to at least one pin of a real component, in the order of makeListOfNets().  The pins
+     * of a net are only kept until the visitor returns.
+     */
+    void visitNets( const NET_VISITOR& aVisitor, bool aUseGraph = true );
+
     /**
      * Function makeLibraries
      * fills out an XML node with a list of used libraries and returns it.
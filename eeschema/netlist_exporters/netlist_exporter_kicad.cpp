@@ -60,7 +60,79 @@ void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    // The document tree of makeRoot() is never built: each section is written as soon as
+    // it is built, one component, library part or net at a time, with the layout of
+    // XNODE::Format().  A node is preceded by a new line, which also ends its previous
+    // sibling.
+    auto formatNode =
+            [&]( XNODE* aNode, int aNestLevel )
+            {
+                std::unique_ptr<XNODE> xnode( aNode );
 
-    xroot->Format( aOut, 0 );
+                aOut->Print( 0, "\n" );
+                xnode->Format( aOut, aNestLevel );
+            };
+
+    aOut->Print( 0, "(export (version D)" );
+
+    if( aCtl & GNL_HEADER )
+        formatNode( makeDesignHeader(), 1 );
+
+    if( aCtl & GNL_COMPONENTS )
+    {
+        aOut->Print( 0, "\n" );
+        aOut->Print( 1, "(components" );
+        visitComponents( [&]( XNODE* aComp ) { formatNode( aComp, 2 ); } );
+        aOut->Print( 0, ")" );
+    }
+
+    if( aCtl & GNL_PARTS )
+    {
+        aOut->Print( 0, "\n" );
+        aOut->Print( 1, "(libparts" );
+        visitLibParts( [&]( XNODE* aLibPart ) { formatNode( aLibPart, 2 ); } );
+        aOut->Print( 0, ")" );
+    }
+
+    if( aCtl & GNL_LIBRARIES )
+    {
+        // must follow visitLibParts()
+        formatNode( makeLibraries(), 1 );
+    }
+
+    if( aCtl & GNL_NETS )
+    {
+        aOut->Print( 0, "\n" );
+        aOut->Print( 1, "(nets" );
+
+        visitNets(
+                [&]( int aCode, const wxString& aName, const std::vector<NET_NODE>& aNodes )
+                {
+                    aOut->Print( 0, "\n" );
+                    aOut->Print( 2, "(net (code %d) (name %s)", aCode,
+                                 aOut->Quotew( aName ).c_str() );
+
+                    for( const NET_NODE& netNode : aNodes )
+                    {
+                        aOut->Print( 0, "\n" );
+                        aOut->Print( 3, "(node (ref %s) (pin %s)",
+                                     aOut->Quotew( netNode.m_Ref ).c_str(),
+                                     aOut->Quotew( netNode.m_Pin ).c_str() );
+
+                        if( !netNode.m_PinFunction.IsEmpty() )
+                        {
+                            aOut->Print( 0, " (pinfunction %s)",
+                                         aOut->Quotew( netNode.m_PinFunction ).c_str() );
+                        }
+
+                        aOut->Print( 0, ")" );
+                    }
+
+                    aOut->Print( 0, ")" );
+                } );
+
+        aOut->Print( 0, ")" );
+    }
+
+    aOut->Print( 0, ")" );
 }
@@ -162,7 +162,7 @@ bool NETLIST_EXPORTER_PSPICE::Format( OUTPUTFORMATTER* aFormatter, unsigned aCtl
             }
         }
 
-        aFormatter->Print( 0, "%s\n", (const char*) item.m_model.c_str() );
+        aFormatter->Print( 0, "%s\n", (const char*) getItemModel( item ).c_str() );
     }
 
     // Print out all directives found in the text fields on the schematics
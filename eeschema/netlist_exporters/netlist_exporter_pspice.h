@@ -228,6 +228,14 @@ protected:
      */
     virtual void writeDirectives( OUTPUTFORMATTER* aFormatter, unsigned aCtl ) const;
 
+    /**
+     * @brief Returns the model (or value) written for an item.
+     */
+    virtual wxString getItemModel( const SPICE_ITEM& aItem ) const
+    {
+        return aItem.m_model;
+    }
+
 private:
     ///> Spice simulation title found in the processed schematic sheet
     wxString m_title;
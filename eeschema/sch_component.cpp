@@ -51,6 +51,7 @@
 #include <wx/tokenzr.h>
 #include <iostream>
 #include <cctype>
+#include <mutex>
 
 #include <eeschema_id.h>    // for MAX_UNIT_COUNT_PER_PACKAGE definition
 
@@ -113,6 +114,94 @@ static LIB_PART* dummy()
 }
 
 
+/**
+ * The flattened library symbols of the components, shared by all the screens.  The symbols
+ * are keyed by a hash of their library identifier and content, and only weakly referenced:
+ * a symbol is freed by its last component.
+ */
+class SHARED_LIB_PARTS
+{
+public:
+    static SHARED_LIB_PARTS& Instance()
+    {
+        static SHARED_LIB_PARTS cache;
+        return cache;
+    }
+
+    std::shared_ptr<LIB_PART> Share( std::unique_ptr<LIB_PART> aPart )
+    {
+        if( !aPart )
+            return nullptr;
+
+        // LIB_PART::Compare() ignores the case of the texts, which matters for a pin name
+        // of a power symbol, so the exact texts are compared too
+        wxString texts = exactTexts( *aPart );
+        size_t   hash = std::hash<wxString>{}( aPart->GetLibId().Format().wx_str() + texts );
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        std::vector<ENTRY>& bucket = m_parts[hash];
+
+        for( auto it = bucket.begin(); it != bucket.end(); )
+        {
+            std::shared_ptr<LIB_PART> candidate = it->m_Part.lock();
+
+            if( !candidate )
+            {
+                it = bucket.erase( it );
+                continue;
+            }
+
+            if( it->m_Texts == texts && candidate->Compare( *aPart ) == 0 )
+                return candidate;
+
+            ++it;
+        }
+
+        std::shared_ptr<LIB_PART> shared( aPart.release() );
+        bucket.push_back( { shared, texts } );
+
+        return shared;
+    }
+
+private:
+    struct ENTRY
+    {
+        std::weak_ptr<LIB_PART> m_Part;
+        wxString                m_Texts;
+    };
+
+    static wxString exactTexts( LIB_PART& aPart )
+    {
+        wxString texts;
+
+        for( LIB_ITEM& item : aPart.GetDrawItems() )
+        {
+            if( item.Type() == LIB_PIN_T )
+            {
+                LIB_PIN& pin = static_cast<LIB_PIN&>( item );
+                texts << pin.GetNumber() << '\t' << pin.GetName() << '\n';
+            }
+            else if( EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( &item ) )
+            {
+                texts << text->GetText() << '\n';
+            }
+        }
+
+        return texts;
+    }
+
+    std::mutex                                    m_mutex;
+    std::unordered_map<size_t, std::vector<ENTRY>> m_parts;
+};
+
+
+std::shared_ptr< LIB_PART > SCH_COMPONENT::ShareLibPart( std::unique_ptr< LIB_PART > aPart )
+{
+    return SHARED_LIB_PARTS::Instance().Share( std::move( aPart ) );
+}
+
+
 SCH_COMPONENT::SCH_COMPONENT( const wxPoint& aPos, SCH_ITEM* aParent ) :
     SCH_ITEM( aParent, SCH_COMPONENT_T )
 {
@@ -134,7 +223,7 @@ SCH_COMPONENT::SCH_COMPONENT( LIB_PART& aPart, LIB_ID aLibId, SCH_SHEET_PATH* sh
 
     part = aPart.Flatten();
     part->SetParent();
-    m_part.reset( part.release() );
+    m_part = ShareLibPart( std::move( part ) );
 
     // Copy fields from the library component
     UpdateFields( true, true );
@@ -174,8 +263,7 @@ SCH_COMPONENT::SCH_COMPONENT( const SCH_COMPONENT& aComponent ) :
     m_lib_id      = aComponent.m_lib_id;
     m_isInNetlist = aComponent.m_isInNetlist;
 
-    if( aComponent.m_part )
-        m_part.reset( new LIB_PART( *aComponent.m_part.get() ) );
+    m_part = aComponent.m_part;
 
     const_cast<KIID&>( m_Uuid ) = aComponent.m_Uuid;
 
@@ -290,7 +378,7 @@ void SCH_COMPONENT::SetLibId( const LIB_ID& aLibId, SYMBOL_LIB_TABLE* aSymLibTab
         }
     }
 
-    m_part.reset( symbol.release() );
+    m_part = ShareLibPart( std::move( symbol ) );
     UpdatePins();
 }
 
@@ -325,7 +413,7 @@ bool SCH_COMPONENT::Resolve( PART_LIBS* aLibs )
     {
         std::unique_ptr< LIB_PART > flattenedPart = part->Flatten();
         flattenedPart->SetParent();
-        m_part.reset( flattenedPart.release() );
+        m_part = ShareLibPart( std::move( flattenedPart ) );
         UpdatePins();
         return true;
     }
@@ -379,7 +467,7 @@ bool SCH_COMPONENT::Resolve( SYMBOL_LIB_TABLE& aLibTable, PART_LIB* aCacheLib )
 
         if( part )
         {
-            m_part.reset( part.release() );
+            m_part = ShareLibPart( std::move( part ) );
             UpdatePins();
             return true;
         }
@@ -439,7 +527,7 @@ void SCH_COMPONENT::ResolveAll(
                 break;
 
             if( cmp->m_part )
-                next_cmp->m_part.reset( new LIB_PART( *cmp->m_part.get() ) );
+                next_cmp->m_part = cmp->m_part;
 
             next_cmp->UpdatePins();
 
@@ -449,6 +537,19 @@ void SCH_COMPONENT::ResolveAll(
 }
 
 
+LIB_PART* SCH_COMPONENT::GetPartForEdit()
+{
+    // Copy on write: the other components keep the shared symbol
+    if( m_part && m_part.use_count() > 1 )
+    {
+        m_part = std::make_shared<LIB_PART>( *m_part );
+        UpdatePins();
+    }
+
+    return m_part.get();
+}
+
+
 void SCH_COMPONENT::UpdatePins()
 {
     m_pins.clear();
@@ -670,6 +771,9 @@ void SCH_COMPONENT::SetRef( const SCH_SHEET_PATH* sheet, const wxString& ref )
 
     // Power components have references starting with # and are not included in netlists
     m_isInNetlist = ! ref.StartsWith( wxT( "#" ) );
+
+    // The reference names the nets driven by the pins
+    SetConnectivityDirty();
 }
 
 
@@ -720,6 +824,9 @@ void SCH_COMPONENT::SetUnitSelection( const SCH_SHEET_PATH* aSheet, int aUnitSel
 
     if( notInArray )
         AddHierarchicalReference( path, m_prefix, aUnitSelection );
+
+    // The unit selects the pins
+    SetConnectivityDirty();
 }
 
 
@@ -904,10 +1011,8 @@ void SCH_COMPONENT::SwapData( SCH_ITEM* aItem )
 
     std::swap( m_lib_id, component->m_lib_id );
 
-    LIB_PART* part = component->m_part.release();
-    component->m_part.reset( m_part.release() );
+    m_part.swap( component->m_part );
     component->UpdatePins();
-    m_part.reset( part );
     UpdatePins();
 
     std::swap( m_Pos, component->m_Pos );
@@ -970,6 +1075,7 @@ void SCH_COMPONENT::ClearAnnotation( SCH_SHEET_PATH* aSheetPath )
     m_Fields[REFERENCE].SetText( defRef ); //for drawing.
 
     SetModified();
+    SetConnectivityDirty();
 }
 
 
@@ -1669,9 +1775,7 @@ SCH_COMPONENT& SCH_COMPONENT::operator=( const SCH_ITEM& aItem )
 
         m_lib_id    = c->m_lib_id;
 
-        LIB_PART* libSymbol = c->m_part ? new LIB_PART( *c->m_part.get() ) : nullptr;
-
-        m_part.reset( libSymbol );
+        m_part = c->m_part;
         m_Pos       = c->m_Pos;
         m_unit      = c->m_unit;
         m_convert   = c->m_convert;
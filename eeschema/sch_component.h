@@ -119,7 +119,9 @@ private:
     SCH_FIELDS  m_Fields;       ///< Variable length list of fields.
 
     ///< A flattened copy of a LIB_PART found in the PROJECT's libraries to for this component.
-    std::unique_ptr< LIB_PART > m_part;
+    ///< It is shared with all the components, of any screen, using the same library symbol
+    ///< with the same content; see GetPartForEdit() to modify it.
+    std::shared_ptr< LIB_PART > m_part;
 
     SCH_PINS    m_pins;         ///< a SCH_PIN for every LIB_PIN (across all units)
     SCH_PIN_MAP m_pinMap;       ///< the component's pins mapped by LIB_PIN*
@@ -204,7 +206,21 @@ public:
 
     const LIB_ID& GetLibId() const        { return m_lib_id; }
 
-    std::unique_ptr< LIB_PART >& GetPartRef() { return m_part; }
+    std::shared_ptr< LIB_PART >& GetPartRef() { return m_part; }
+
+    /**
+     * Return the library symbol of the component, for modification.  The symbol is shared
+     * by all the components using the same library symbol, so it is copied first if it is
+     * used by another component: the change only affects this component.
+     */
+    LIB_PART* GetPartForEdit();
+
+    /**
+     * Return the symbol of the shared symbol cache with the same library identifier and
+     * content as \a aPart, creating it from \a aPart if there is none.  The cache only holds
+     * weak references: a symbol is freed with the last component using it.
+     */
+    static std::shared_ptr< LIB_PART > ShareLibPart( std::unique_ptr< LIB_PART > aPart );
 
     /**
      * Return information about the aliased parts
@@ -239,6 +239,10 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     icon.CopyFromBitmap( KiBitmap( icon_eeschema_xpm ) );
     SetIcon( icon );
 
+    m_connectivityTimer.SetOwner( this );
+    Connect( m_connectivityTimer.GetId(), wxEVT_TIMER,
+             wxTimerEventHandler( SCH_EDIT_FRAME::onConnectivityTimer ), NULL, this );
+
     // Initialize grid id to the default value (50 mils):
     m_LastGridSizeId = ID_POPUP_GRID_LEVEL_50 - ID_POPUP_GRID_LEVEL_1000;
 
@@ -292,6 +296,8 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
 
 SCH_EDIT_FRAME::~SCH_EDIT_FRAME()
 {
+    m_connectivityTimer.Stop();
+
     // Shutdown all running tools
     if( m_toolManager )
         m_toolManager->ShutdownAllTools();
@@ -599,7 +605,43 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetSave();
 
     if( ADVANCED_CFG::GetCfg().m_realTimeConnectivity && CONNECTION_GRAPH::m_allowRealTime )
+        ScheduleConnectivityUpdate();
+
+    GetCanvas()->Refresh();
+}
+
+
+void SCH_EDIT_FRAME::ScheduleConnectivityUpdate()
+{
+    // Restarting the timer drops the update scheduled by the previous edit
+    m_connectivityTimer.StartOnce( 150 );
+}
+
+
+void SCH_EDIT_FRAME::FlushConnectivityUpdate()
+{
+    if( m_connectivityTimer.IsRunning() )
         RecalculateConnections( NO_CLEANUP );
+}
+
+
+void SCH_EDIT_FRAME::onConnectivityTimer( wxTimerEvent& aEvent )
+{
+    // Don't update while items are being moved or drawn: they are not connected yet
+    for( EDA_ITEM* item : m_toolManager->GetTool<EE_SELECTION_TOOL>()->GetSelection() )
+    {
+        if( item->IsMoving() || item->IsNew() )
+        {
+            ScheduleConnectivityUpdate();
+            return;
+        }
+    }
+
+    RecalculateConnections( NO_CLEANUP );
+
+    // Publish the new connections
+    if( !GetSelectedNetName().IsEmpty() )
+        m_toolManager->RunAction( EE_ACTIONS::updateNetHighlighting, true );
 
     GetCanvas()->Refresh();
 }
@@ -1070,6 +1112,8 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     SCH_SHEET_LIST list( g_RootSheet );
     PROF_COUNTER   timer;
 
+    m_connectivityTimer.Stop();
+
     // Ensure schematic graph is accurate
     if( aCleanupFlags == LOCAL_CLEANUP )
     {
@@ -1084,7 +1128,9 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     timer.Stop();
     wxLogTrace( "CONN_PROFILE", "SchematicCleanUp() %0.4f ms", timer.msecs() );
 
-    g_ConnectionGraph->Recalculate( list, true );
+    // Edits flag the items they change, but a global clean up follows a load
+    // or a change of the whole schematic
+    g_ConnectionGraph->Recalculate( list, aCleanupFlags == GLOBAL_CLEANUP );
 }
 
 
@@ -32,6 +32,7 @@
 #include <wx/event.h>
 #include <wx/gdicmn.h>
 #include <wx/string.h>
+#include <wx/timer.h>
 #include <wx/utils.h>
 
 #include <config_params.h>
@@ -162,6 +163,9 @@ private:
     wxArrayString           m_componentLibFiles;
     */
 
+    /// Runs the real-time connectivity update once the edits pause
+    wxTimer                 m_connectivityTimer;
+
     static PINSHEETLABEL_SHAPE m_lastSheetPinType;    ///< Last sheet pin type.
     static wxSize           m_lastSheetPinTextSize;   ///< Last sheet pin text size.
     static wxPoint          m_lastSheetPinPosition;   ///< Last sheet pin position.
@@ -717,6 +721,9 @@ private:
 
     void OnClearFileHistory( wxCommandEvent& aEvent );
 
+    /// Runs the real-time connectivity update scheduled by ScheduleConnectivityUpdate()
+    void onConnectivityTimer( wxTimerEvent& aEvent );
+
     /**
      * Set the main window title bar text.
      *
@@ -1031,10 +1038,24 @@ public:
     wxString GetNetListerCommand() const { return m_netListerCommand; }
 
     /**
-     * Generates the connection data for the entire schematic hierarchy.
+     * Generates the connection data for the entire schematic hierarchy.  Any pending
+     * real-time update is cancelled, as superseded.
      */
     void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags );
 
+    /**
+     * Schedules the real-time connectivity update after an edit.  The update runs once the
+     * edits pause, so a burst of edits (typing, dragging) leads to a single update; a new
+     * edit postpones the pending update rather than waiting for it.
+     */
+    void ScheduleConnectivityUpdate();
+
+    /**
+     * Runs the pending real-time connectivity update, if any.  Must be called before reading
+     * the connections of the items in real-time mode.
+     */
+    void FlushConnectivityUpdate();
+
     /**
      * Allows Eeschema to install its preferences panels into the preferences dialog.
      */
@@ -21,8 +21,10 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
+#include <exception>
 #include <set>
 
 #include <wx/mstream.h>
@@ -34,6 +36,7 @@
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <thread_pool.h>
 #include <core/typeinfo.h>
 #include <properties.h>
 #include <trace_helpers.h>
@@ -472,7 +475,7 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -578,6 +581,7 @@ void SCH_LEGACY_PLUGIN::init( KIWAY* aKiway, const PROPERTIES* aProperties )
 {
     m_version = 0;
     m_rootSheet = NULL;
+    m_modified = false;
     m_props = aProperties;
     m_kiway = aKiway;
     m_cache = NULL;
@@ -647,82 +651,159 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 
     wxASSERT( m_currentPath.size() == 1 );  // only the project path should remain
 
+    // Set the file as modified so the user can be warned about the fixed up components
+    if( m_modified && m_rootSheet->GetScreen() )
+        m_rootSheet->GetScreen()->SetModify();
+
     return sheet;
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
+// The hierarchy is loaded breadth first, one level of sheets at a time.  The files of a level
+// are independent, so they are parsed concurrently.  The screens are created, shared between
+// the sheets and linked to them on the calling thread only.
 
 void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
-
-    if( !aSheet->GetScreen() )
+    /// A sheet to load, with the path its file name is relative to
+    struct SHEET_REF
     {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+        SCH_SHEET* m_Sheet;
+        wxString   m_Path;
+    };
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_currentPath.top() );
+    /// A sheet file to parse, by the sheet it was first found in
+    struct SHEET_FILE
+    {
+        SCH_SHEET*         m_Sheet;
+        wxString           m_FullFileName;
+        bool               m_Modified;
+        std::exception_ptr m_Error;
+    };
 
-        // Save the current path so that it gets restored when decending and ascending the
-        // sheet hierarchy which allows for sheet schematic files to be nested in folders
-        // relative to the last path a schematic was loaded from.
-        wxLogTrace( traceSchLegacyPlugin, "Saving path    \"%s\"", m_currentPath.top() );
-        m_currentPath.push( fileName.GetPath() );
-        wxLogTrace( traceSchLegacyPlugin, "Current path   \"%s\"", m_currentPath.top() );
-        wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+    std::vector<SHEET_REF> sheets = { { aSheet, m_currentPath.top() } };
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    while( !sheets.empty() )
+    {
+        std::vector<SHEET_FILE> files;
 
-        if( screen )
+        for( const SHEET_REF& ref : sheets )
         {
-            aSheet->SetScreen( screen );
+            if( ref.m_Sheet->GetScreen() )
+                continue;
+
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object
+            // only stores the file name and extension.  Add the path of the parent sheet file
+            // to the file name and extension to compare when calling
+            // SCH_SHEET::SearchHierarchy().  This allows for sheet schematic files to be nested
+            // in folders relative to the last path a schematic was loaded from.
+            wxFileName  fileName = ref.m_Sheet->GetFileName();
+            SCH_SCREEN* screen = NULL;
 
-            // Do not need to load the sub-sheets - this has already been done.
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( ref.m_Path );
+
+            wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+
+            // The screens of the sheets found above are already set, so a file used by several
+            // sheets is only loaded once.
+            m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+
+            if( screen )
+            {
+                ref.m_Sheet->SetScreen( screen );
+
+                // Do not need to load the sub-sheets - this has already been done.
+            }
+            else
+            {
+                ref.m_Sheet->SetScreen( new SCH_SCREEN( m_kiway ) );
+                ref.m_Sheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+
+                files.push_back( { ref.m_Sheet, fileName.GetFullPath(), false, nullptr } );
+            }
         }
+
+        // Each file is parsed by its own plugin, as the parser state is per file
+        std::atomic<size_t> nextFile( 0 );
+
+        auto work =
+                [&]()
+                {
+                    for( size_t ii = nextFile++; ii < files.size(); ii = nextFile++ )
+                    {
+                        SHEET_FILE&       file = files[ii];
+                        SCH_LEGACY_PLUGIN loader;
+
+                        loader.init( m_kiway, m_props );
+                        loader.m_rootSheet = m_rootSheet;
+
+                        try
+                        {
+                            loader.loadFile( file.m_FullFileName, file.m_Sheet->GetScreen() );
+                        }
+                        catch( ... )
+                        {
+                            file.m_Error = std::current_exception();
+                        }
+
+                        file.m_Modified = loader.m_modified;
+                    }
+                };
+
+        THREAD_POOL& pool = GetKiCadThreadPool();
+        size_t       parallelism = std::min<size_t>( pool.GetThreadCount() + 1, files.size() );
+
+        if( parallelism <= 1 )
+            work();
         else
+            pool.RunParallel( work, parallelism );
+
+        sheets.clear();
+
+        for( SHEET_FILE& file : files )
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            m_modified |= file.m_Modified;
 
-            try
+            if( file.m_Error )
             {
-                loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
-                for( auto aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
+                try
                 {
-                    assert( aItem->Type() == SCH_SHEET_T );
-                    auto sheet = static_cast<SCH_SHEET*>( aItem );
-
-                    // Set the parent to aSheet.  This effectively creates a method to find
-                    // the root sheet from any sheet so a pointer to the root sheet does not
-                    // need to be stored globally.  Note: this is not the same as a hierarchy.
-                    // Complex hierarchies can have multiple copies of a sheet.  This only
-                    // provides a simple tree to find the root sheet.
-                    sheet->SetParent( aSheet );
-
-                    // Recursion starts here.
-                    loadHierarchy( sheet );
+                    std::rethrow_exception( file.m_Error );
                 }
+                catch( const IO_ERROR& ioe )
+                {
+                    // If there is a problem loading the root sheet, there is no recovery.
+                    if( file.m_Sheet == m_rootSheet )
+                        throw;
+
+                    // For all subsheets, queue up the error message for the caller.
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
+
+                    m_error += ioe.What();
+                }
+
+                continue;
             }
-            catch( const IO_ERROR& ioe )
+
+            wxString path = wxFileName( file.m_FullFileName ).GetPath();
+
+            for( auto aItem : file.m_Sheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
             {
-                // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw( ioe );
+                assert( aItem->Type() == SCH_SHEET_T );
+                auto sheet = static_cast<SCH_SHEET*>( aItem );
 
-                // For all subsheets, queue up the error message for the caller.
-                if( !m_error.IsEmpty() )
-                    m_error += "\n";
+                // Set the parent to the sheet.  This effectively creates a method to find
+                // the root sheet from any sheet so a pointer to the root sheet does not
+                // need to be stored globally.  Note: this is not the same as a hierarchy.
+                // Complex hierarchies can have multiple copies of a sheet.  This only
+                // provides a simple tree to find the root sheet.
+                sheet->SetParent( file.m_Sheet );
 
-                m_error += ioe.What();
+                sheets.push_back( { sheet, path } );
             }
         }
-
-        m_currentPath.pop();
-        wxLogTrace( traceSchLegacyPlugin, "Restoring path \"%s\"", m_currentPath.top() );
     }
 }
 
@@ -759,40 +840,54 @@ void SCH_LEGACY_PLUGIN::LoadContent( LINE_READER& aReader, SCH_SCREEN* aScreen,
     if( m_rootSheet == nullptr )
         m_rootSheet = g_RootSheet;
 
-    while( aReader.ReadLine() )
-    {
-        char* line = aReader.Line();
-
-        while( *line == ' ' )
-            line++;
+    // The items are appended to the screen all at once, which is much faster than one by one
+    // for a large sheet.  They are also appended if the load fails, so the screen owns them.
+    std::vector<SCH_ITEM*> items;
 
-        // Either an object will be loaded properly or the file load will fail and raise
-        // an exception.
-        if( strCompare( "$Descr", line ) )
-            loadPageSettings( aReader, aScreen );
-        else if( strCompare( "$Comp", line ) )
-            aScreen->Append( loadComponent( aReader ) );
-        else if( strCompare( "$Sheet", line ) )
-            aScreen->Append( loadSheet( aReader ) );
-        else if( strCompare( "$Bitmap", line ) )
-            aScreen->Append( loadBitmap( aReader ) );
-        else if( strCompare( "Connection", line ) )
-            aScreen->Append( loadJunction( aReader ) );
-        else if( strCompare( "NoConn", line ) )
-            aScreen->Append( loadNoConnect( aReader ) );
-        else if( strCompare( "Wire", line ) )
-            aScreen->Append( loadWire( aReader ) );
-        else if( strCompare( "Entry", line ) )
-            aScreen->Append( loadBusEntry( aReader ) );
-        else if( strCompare( "Text", line ) )
-            aScreen->Append( loadText( aReader ) );
-        else if( strCompare( "BusAlias", line ) )
-            aScreen->AddBusAlias( loadBusAlias( aReader, aScreen ) );
-        else if( strCompare( "$EndSCHEMATC", line ) )
-            return;
-        else
-            SCH_PARSE_ERROR( "unrecognized token", aReader, line );
+    try
+    {
+        while( aReader.ReadLine() )
+        {
+            char* line = aReader.Line();
+
+            while( *line == ' ' )
+                line++;
+
+            // Either an object will be loaded properly or the file load will fail and raise
+            // an exception.
+            if( strCompare( "$Descr", line ) )
+                loadPageSettings( aReader, aScreen );
+            else if( strCompare( "$Comp", line ) )
+                items.push_back( loadComponent( aReader ) );
+            else if( strCompare( "$Sheet", line ) )
+                items.push_back( loadSheet( aReader ) );
+            else if( strCompare( "$Bitmap", line ) )
+                items.push_back( loadBitmap( aReader ) );
+            else if( strCompare( "Connection", line ) )
+                items.push_back( loadJunction( aReader ) );
+            else if( strCompare( "NoConn", line ) )
+                items.push_back( loadNoConnect( aReader ) );
+            else if( strCompare( "Wire", line ) )
+                items.push_back( loadWire( aReader ) );
+            else if( strCompare( "Entry", line ) )
+                items.push_back( loadBusEntry( aReader ) );
+            else if( strCompare( "Text", line ) )
+                items.push_back( loadText( aReader ) );
+            else if( strCompare( "BusAlias", line ) )
+                aScreen->AddBusAlias( loadBusAlias( aReader, aScreen ) );
+            else if( strCompare( "$EndSCHEMATC", line ) )
+                break;
+            else
+                SCH_PARSE_ERROR( "unrecognized token", aReader, line );
+        }
     }
+    catch( ... )
+    {
+        aScreen->Append( items );
+        throw;
+    }
+
+    aScreen->Append( items );
 }
 
 
@@ -1545,8 +1640,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( LINE_READER& aReader )
                 unit = 1;
 
                 // Set the file as modified so the user can be warned.
-                if( m_rootSheet && m_rootSheet->GetScreen() )
-                    m_rootSheet->GetScreen()->SetModify();
+                m_modified = true;
             }
 
             component->SetUnit( unit );
@@ -1559,8 +1653,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( LINE_READER& aReader )
                 convert = 1;
 
                 // Set the file as modified so the user can be warned.
-                if( m_rootSheet && m_rootSheet->GetScreen() )
-                    m_rootSheet->GetScreen()->SetModify();
+                m_modified = true;
             }
 
             component->SetConvert( convert );
@@ -2388,7 +2481,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -179,6 +179,7 @@ protected:
     const PROPERTIES*    m_props;      ///< Passed via Save() or Load(), no ownership, may be nullptr.
     KIWAY*               m_kiway;      ///< Required for path to legacy component libraries.
     SCH_SHEET*           m_rootSheet;  ///< The root sheet of the schematic being loaded..
+    bool                 m_modified;   ///< Set if the loaded files had to be fixed up.
     OUTPUTFORMATTER*     m_out;        ///< The output formatter for saving SCH_SCREEN objects.
     SCH_LEGACY_PLUGIN_CACHE* m_cache;
 
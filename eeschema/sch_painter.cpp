@@ -137,7 +137,8 @@ static LIB_PART* dummy()
 
 
 SCH_PAINTER::SCH_PAINTER( GAL* aGal ) :
-    KIGFX::PAINTER( aGal )
+    KIGFX::PAINTER( aGal ),
+    m_orientedPartsPruneSize( 256 )
 { }
 
 
@@ -1315,27 +1316,71 @@ static void orientPart( LIB_PART* part, int orientation )
 }
 
 
+SCH_PAINTER::ORIENTED_PART& SCH_PAINTER::getOrientedPart( const std::shared_ptr<LIB_PART>& aPart,
+                                                          int aOrientation )
+{
+    auto key = std::make_pair( (const LIB_PART*) aPart.get(), aOrientation );
+    auto it = m_orientedParts.find( key );
+
+    if( it != m_orientedParts.end() )
+        return it->second;
+
+    // Forget the symbols no longer used by any component, once in a while
+    if( m_orientedParts.size() >= m_orientedPartsPruneSize )
+    {
+        for( auto entry = m_orientedParts.begin(); entry != m_orientedParts.end(); )
+        {
+            if( entry->second.m_Source.use_count() == 1 )
+                entry = m_orientedParts.erase( entry );
+            else
+                ++entry;
+        }
+
+        m_orientedPartsPruneSize = std::max<size_t>( 256, 2 * m_orientedParts.size() );
+    }
+
+    ORIENTED_PART& orientedPart = m_orientedParts[key];
+
+    orientedPart.m_Source = aPart;
+    orientedPart.m_Part = std::make_unique<LIB_PART>( *aPart );
+
+    orientPart( orientedPart.m_Part.get(), aOrientation );
+
+    for( LIB_ITEM& item : orientedPart.m_Part->GetDrawItems() )
+        orientedPart.m_ItemFlags.push_back( item.GetFlags() );
+
+    return orientedPart;
+}
+
+
 void SCH_PAINTER::draw( SCH_COMPONENT *aComp, int aLayer )
 {
     // Use dummy part if the actual couldn't be found (or couldn't be locked).
-    LIB_PART* originalPart = aComp->GetPartRef() ? aComp->GetPartRef().get() : dummy();
+    static std::shared_ptr<LIB_PART> dummyPart( dummy(), []( LIB_PART* ) {} );
 
-    // Copy the source so we can re-orient and translate it.
-    LIB_PART tempPart( *originalPart );
+    const std::shared_ptr<LIB_PART>& originalPart = aComp->GetPartRef() ? aComp->GetPartRef()
+                                                                        : dummyPart;
 
-    tempPart.SetFlags( aComp->GetFlags() );
+    // The oriented copy is shared by the components with the same symbol and orientation:
+    // only the flags are set for this component, and it is drawn translated.
+    ORIENTED_PART& orientedPart = getOrientedPart( originalPart, aComp->GetOrientation() );
+    LIB_PART*      tempPart = orientedPart.m_Part.get();
+    size_t         itemIdx = 0;
 
-    orientPart( &tempPart, aComp->GetOrientation() );
+    tempPart->ClearFlags();
+    tempPart->SetFlags( originalPart->GetFlags() );
+    tempPart->SetFlags( aComp->GetFlags() );
 
-    for( auto& tempItem : tempPart.GetDrawItems() )
+    for( auto& tempItem : tempPart->GetDrawItems() )
     {
+        tempItem.ClearFlags();
+        tempItem.SetFlags( orientedPart.m_ItemFlags[ itemIdx++ ] );
         tempItem.SetFlags( aComp->GetFlags() );     // SELECTED, HIGHLIGHTED, BRIGHTENED
-        tempItem.MoveTo( tempItem.GetPosition() + (wxPoint) mapCoords( aComp->GetPosition() ) );
     }
 
     // Copy the pin info from the component to the temp pins
     LIB_PINS tempPins;
-    tempPart.GetPins( tempPins, aComp->GetUnit(), aComp->GetConvert() );
+    tempPart->GetPins( tempPins, aComp->GetUnit(), aComp->GetConvert() );
     const SCH_PIN_PTRS compPins = aComp->GetSchPins();
 
     for( unsigned i = 0; i < tempPins.size() && i < compPins.size(); ++ i )
@@ -1350,7 +1395,14 @@ void SCH_PAINTER::draw( SCH_COMPONENT *aComp, int aLayer )
             tempPin->SetFlags( IS_DANGLING );
     }
 
-    draw( &tempPart, aLayer, false, aComp->GetUnit(), aComp->GetConvert() );
+    // The library coordinates have the Y axis upwards: the position of the component is
+    // a translation in the coordinates of the GAL
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( aComp->GetPosition() ) );
+
+    draw( tempPart, aLayer, false, aComp->GetUnit(), aComp->GetConvert() );
+
+    m_gal->Restore();
 
     // The fields are SCH_COMPONENT-specific so don't need to be copied/oriented/translated
     for( SCH_FIELD& field : aComp->GetFields() )
@@ -25,6 +25,10 @@
 #ifndef __SCH_PAINTER_H
 #define __SCH_PAINTER_H
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #include <sch_component.h>
 
 #include <painter.h>
@@ -174,7 +178,26 @@ private:
     void triLine ( const VECTOR2D &a, const VECTOR2D &b, const VECTOR2D &c );
     void strokeText( const wxString& aText, const VECTOR2D& aPosition, double aRotationAngle );
 
+    /// A library symbol oriented like a component, at the origin
+    struct ORIENTED_PART
+    {
+        std::shared_ptr<LIB_PART> m_Source;     ///< keeps the source alive and shared, so a
+                                                ///< component copies it to modify it
+        std::unique_ptr<LIB_PART> m_Part;
+        std::vector<STATUS_FLAGS> m_ItemFlags;  ///< the flags of the items of m_Part
+    };
+
+    /**
+     * Return the copy of \a aPart oriented as \a aOrientation.  The copies are cached: all the
+     * components using the same library symbol with the same orientation share one copy,
+     * which is translated by the GAL when drawn.
+     */
+    ORIENTED_PART& getOrientedPart( const std::shared_ptr<LIB_PART>& aPart, int aOrientation );
+
     SCH_RENDER_SETTINGS m_schSettings;
+
+    std::map<std::pair<const LIB_PART*, int>, ORIENTED_PART> m_orientedParts;
+    size_t                                                   m_orientedPartsPruneSize;
 };
 
 }; // namespace KIGFX
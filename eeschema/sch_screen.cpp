@@ -130,6 +130,7 @@ SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    m_pinIndexDirty = true;
 
     SetZoom( 32 );
 
@@ -178,6 +179,27 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem )
     {
         m_rtree.insert( aItem );
         --m_modification_sync;
+        m_pinIndexDirty = true;
+    }
+}
+
+
+void SCH_SCREEN::Append( const std::vector<SCH_ITEM*>& aItems )
+{
+    std::vector<SCH_ITEM*> items;
+    items.reserve( aItems.size() );
+
+    std::copy_if( aItems.begin(), aItems.end(), std::back_inserter( items ),
+            []( SCH_ITEM* aItem )
+            {
+                return ( aItem->Type() != SCH_SHEET_PIN_T && aItem->Type() != SCH_FIELD_T );
+            } );
+
+    if( !items.empty() )
+    {
+        m_rtree.insert( items );
+        --m_modification_sync;
+        m_pinIndexDirty = true;
     }
 }
 
@@ -188,8 +210,9 @@ void SCH_SCREEN::Append( SCH_SCREEN* aScreen )
 
     // No need to descend the hierarchy.  Once the top level screen is copied, all of it's
     // children are copied as well.
-    for( auto aItem : aScreen->m_rtree )
-        Append( aItem );
+    std::vector<SCH_ITEM*> items( aScreen->m_rtree.begin(), aScreen->m_rtree.end() );
+
+    Append( items );
 
     aScreen->Clear( false );
 }
@@ -202,6 +225,8 @@ void SCH_SCREEN::Clear( bool aFree )
     else
         m_rtree.clear();
 
+    m_pinIndexDirty = true;
+
     // Clear the project settings
     m_ScreenNumber = m_NumberOfScreens = 1;
 
@@ -222,6 +247,7 @@ void SCH_SCREEN::FreeDrawList()
             } );
 
     m_rtree.clear();
+    m_pinIndexDirty = true;
 
     for( auto item : delete_list )
         delete item;
@@ -237,6 +263,8 @@ void SCH_SCREEN::Update( SCH_ITEM* aItem )
 
 bool SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
+    m_pinIndexDirty = true;
+
     return m_rtree.remove( aItem );
 }
 
@@ -646,43 +674,71 @@ void SCH_SCREEN::ClearDrawingState()
 }
 
 
+void SCH_SCREEN::buildPinIndex()
+{
+    m_pinIndex.clear();
+
+    for( SCH_ITEM* item : Items().OfType( SCH_COMPONENT_T ) )
+    {
+        SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+
+        if( !component->GetPartRef() )
+            continue;
+
+        for( LIB_PIN* pin = component->GetPartRef()->GetNextPin(); pin;
+             pin = component->GetPartRef()->GetNextPin( pin ) )
+        {
+            // Skip items not used for this part.
+            if( component->GetUnit() && pin->GetUnit() &&
+                ( pin->GetUnit() != component->GetUnit() ) )
+                continue;
+
+            if( component->GetConvert() && pin->GetConvert() &&
+                ( pin->GetConvert() != component->GetConvert() ) )
+                continue;
+
+            PIN_INDEX_ENTRY entry = { component, component->GetPartRef().get(), pin };
+            m_pinIndex[component->GetPinPhysicalPosition( pin )].push_back( entry );
+        }
+    }
+
+    m_pinIndexDirty = false;
+}
+
+
 LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent,
                              bool aEndPointOnly )
 {
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
 
-    for( SCH_ITEM* item : Items().Overlapping( SCH_COMPONENT_T, aPosition ) )
+    if( aEndPointOnly )
     {
-        component = static_cast<SCH_COMPONENT*>( item );
+        if( m_pinIndexDirty )
+            buildPinIndex();
 
-        if( aEndPointOnly )
-        {
-            pin = NULL;
+        auto it = m_pinIndex.find( aPosition );
 
-            if( !component->GetPartRef() )
-                continue;
-
-            for( pin = component->GetPartRef()->GetNextPin(); pin;
-                 pin = component->GetPartRef()->GetNextPin( pin ) )
+        if( it != m_pinIndex.end() )
+        {
+            for( const PIN_INDEX_ENTRY& entry : it->second )
             {
-                // Skip items not used for this part.
-                if( component->GetUnit() && pin->GetUnit() &&
-                    ( pin->GetUnit() != component->GetUnit() ) )
-                    continue;
-
-                if( component->GetConvert() && pin->GetConvert() &&
-                    ( pin->GetConvert() != component->GetConvert() ) )
+                // Skip the entries of components changed since the index was built
+                if( entry.m_Component->GetPartRef().get() != entry.m_Part
+                        || entry.m_Component->GetPinPhysicalPosition( entry.m_Pin ) != aPosition )
                     continue;
 
-                if(component->GetPinPhysicalPosition( pin ) == aPosition )
-                    break;
-            }
-            if( pin )
+                component = entry.m_Component;
+                pin = entry.m_Pin;
                 break;
+            }
         }
-        else
+    }
+    else
+    {
+        for( SCH_ITEM* item : Items().Overlapping( SCH_COMPONENT_T, aPosition ) )
         {
+            component = static_cast<SCH_COMPONENT*>( item );
             pin = (LIB_PIN*) component->GetDrawItem( aPosition, LIB_PIN_T );
 
             if( pin )
@@ -777,6 +833,9 @@ bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
     std::vector< DANGLING_END_ITEM > endPoints;
     bool hasStateChanged = false;
 
+    // This follows the edits, which may have modified components in place
+    m_pinIndexDirty = true;
+
     for( SCH_ITEM* item : Items() )
         item->GetEndPoints( endPoints );
 
@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <stddef.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <wx/arrstr.h>
@@ -51,6 +52,7 @@
 
 class BUS_ALIAS;
 
+class LIB_PART;
 class LIB_PIN;
 class SCH_COMPONENT;
 class SCH_LINE;
@@ -115,6 +117,21 @@ private:
     /// List of bus aliases stored in this screen
     std::unordered_set< std::shared_ptr< BUS_ALIAS > > m_aliases;
 
+    /// A component pin, indexed by the position of its connection point
+    struct PIN_INDEX_ENTRY
+    {
+        SCH_COMPONENT* m_Component;
+        LIB_PART*      m_Part;          ///< the part of the component, owning the pin
+        LIB_PIN*       m_Pin;
+    };
+
+    /// The component pins used by their unit and body style, by connection point.  Rebuilt
+    /// by GetPin() after the items of the screen have changed.
+    std::unordered_map<wxPoint, std::vector<PIN_INDEX_ENTRY>> m_pinIndex;
+    bool                                                      m_pinIndexDirty;
+
+    void buildPinIndex();
+
 public:
 
     /**
@@ -183,6 +200,12 @@ public:
 
     void Append( SCH_ITEM* aItem );
 
+    /**
+     * Append a set of items at once, which is much faster for a large set (e.g. the content
+     * of a schematic file) than appending them one by one.
+     */
+    void Append( const std::vector<SCH_ITEM*>& aItems );
+
     /**
      * Copy the contents of \a aScreen into this #SCH_SCREEN object.
      *
@@ -356,7 +379,9 @@ public:
      * @param aPosition Position to test.
      * @param aComponent The component if a pin was found, otherwise NULL.
      * @param aEndPointOnly Set to true to test if \a aPosition is the connection
-     *                      point of the pin.
+     *                      point of the pin.  The connection points are indexed: like for
+     *                      the R-tree, a component modified in place must be updated with
+     *                      Update() to be found at its new pin positions.
      * @return The pin item if found, otherwise NULL.
      */
     LIB_PIN* GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent = NULL,
@@ -346,11 +346,19 @@ LIB_ITEM* SCH_SEXPR_PARSER::ParseDrawItem()
 
 double SCH_SEXPR_PARSER::parseDouble()
 {
+    DECIMAL decimal;
+    double  fval;
+
+    // The plain decimal numbers, almost all the numbers of a file, are read without strtod()
+    // and its locale lookups, to the same value.
+    if( ParseDecimal( CurStr(), decimal ) && decimal.ToDouble( fval ) )
+        return fval;
+
     char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = strtod( CurText(), &tmp );
 
     if( errno )
     {
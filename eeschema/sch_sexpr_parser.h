@@ -32,6 +32,7 @@
 #define __SCH_SEXPR_PARSER_H__
 
 #include <convert_to_biu.h>                      // IU_PER_MM
+#include <decimal_parser.h>
 #include <math/util.h>                           // KiROUND, Clamp
 
 #include <class_library.h>
@@ -90,23 +91,30 @@ class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
 
     inline int parseInternalUnits()
     {
-        auto retval = parseDouble() * IU_PER_MM;
-
         // Schematic internal units are represented as integers.  Any values that are
         // larger or smaller than the schematic units represent undefined behavior for
         // the system.  Limit values to the largest that can be displayed on the screen.
         double int_limit = std::numeric_limits<int>::max() * 0.7071; // 0.7071 = roughly 1/sqrt(2)
 
+        // Values with at most 4 decimals in mm are read without a double round trip
+        DECIMAL   decimal;
+        long long value;
+
+        if( ParseDecimal( CurStr(), decimal ) && decimal.ToScaledInt( IU_PER_MM, value )
+                && value >= -int_limit && value <= int_limit )
+        {
+            return (int) value;
+        }
+
+        auto retval = parseDouble() * IU_PER_MM;
+
         return KiROUND( Clamp<double>( -int_limit, retval, int_limit ) );
     }
 
     inline int parseInternalUnits( const char* aExpected )
     {
-        auto retval = parseDouble( aExpected ) * IU_PER_MM;
-
-        double int_limit = std::numeric_limits<int>::max() * 0.7071;
-
-        return KiROUND( Clamp<double>( -int_limit, retval, int_limit ) );
+        NeedNUMBER( aExpected );
+        return parseInternalUnits();
     }
 
     inline int parseInternalUnits( TSYMBOL_LIB_T::T aToken )
@@ -20,8 +20,10 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
+#include <exception>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -34,6 +36,7 @@
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <thread_pool.h>
 #include <core/typeinfo.h>
 #include <plotter.h>               // PLOT_DASH_TYPE
 #include <properties.h>
@@ -311,7 +314,7 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel, int aWidt
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -479,90 +482,163 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
+// The hierarchy is loaded breadth first, one level of sheets at a time.  The files of a level
+// are independent, so they are parsed concurrently.  The screens are created, shared between
+// the sheets and linked to them on the calling thread only.
 
 void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
-
-    if( !aSheet->GetScreen() )
+    /// A sheet to load, with the path its file name is relative to
+    struct SHEET_REF
     {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+        SCH_SHEET* m_Sheet;
+        wxString   m_Path;
+    };
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_currentPath.top() );
+    /// A sheet file to parse, by the sheet it was first found in
+    struct SHEET_FILE
+    {
+        SCH_SHEET*         m_Sheet;
+        wxString           m_FullFileName;
+        std::exception_ptr m_Error;
+    };
 
-        // Save the current path so that it gets restored when decending and ascending the
-        // sheet hierarchy which allows for sheet schematic files to be nested in folders
-        // relative to the last path a schematic was loaded from.
-        wxLogTrace( traceSchLegacyPlugin, "Saving path    \"%s\"", m_currentPath.top() );
-        m_currentPath.push( fileName.GetPath() );
-        wxLogTrace( traceSchLegacyPlugin, "Current path   \"%s\"", m_currentPath.top() );
-        wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+    std::vector<SHEET_REF> sheets = { { aSheet, m_currentPath.top() } };
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    while( !sheets.empty() )
+    {
+        std::vector<SHEET_FILE> files;
 
-        if( screen )
+        for( const SHEET_REF& ref : sheets )
         {
-            aSheet->SetScreen( screen );
+            if( ref.m_Sheet->GetScreen() )
+                continue;
+
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object
+            // only stores the file name and extension.  Add the path of the parent sheet file
+            // to the file name and extension to compare when calling
+            // SCH_SHEET::SearchHierarchy().  This allows for sheet schematic files to be nested
+            // in folders relative to the last path a schematic was loaded from.
+            wxFileName  fileName = ref.m_Sheet->GetFileName();
+            SCH_SCREEN* screen = NULL;
+
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( ref.m_Path );
 
-            // Do not need to load the sub-sheets - this has already been done.
+            wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+
+            // The screens of the sheets found above are already set, so a file used by several
+            // sheets is only loaded once.
+            m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+
+            if( screen )
+            {
+                ref.m_Sheet->SetScreen( screen );
+
+                // Do not need to load the sub-sheets - this has already been done.
+            }
+            else
+            {
+                ref.m_Sheet->SetScreen( new SCH_SCREEN( m_kiway ) );
+                ref.m_Sheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+
+                files.push_back( { ref.m_Sheet, fileName.GetFullPath(), nullptr } );
+            }
         }
+
+        // Each file is parsed by its own plugin, as the parser state is per file
+        std::atomic<size_t> nextFile( 0 );
+
+        auto work =
+                [&]()
+                {
+                    for( size_t ii = nextFile++; ii < files.size(); ii = nextFile++ )
+                    {
+                        SHEET_FILE&      file = files[ii];
+                        SCH_SEXPR_PLUGIN loader;
+
+                        loader.init( m_kiway, m_props );
+                        loader.m_rootSheet = m_rootSheet;
+
+                        try
+                        {
+                            loader.loadFile( file.m_FullFileName, file.m_Sheet->GetScreen() );
+                        }
+                        catch( ... )
+                        {
+                            file.m_Error = std::current_exception();
+                        }
+                    }
+                };
+
+        THREAD_POOL& pool = GetKiCadThreadPool();
+        size_t       parallelism = std::min<size_t>( pool.GetThreadCount() + 1, files.size() );
+
+        if( parallelism <= 1 )
+            work();
         else
-        {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            pool.RunParallel( work, parallelism );
 
-            try
-            {
-                loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
+        sheets.clear();
 
-                for( auto aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
+        for( SHEET_FILE& file : files )
+        {
+            if( file.m_Error )
+            {
+                try
                 {
-                    assert( aItem->Type() == SCH_SHEET_T );
-                    auto sheet = static_cast<SCH_SHEET*>( aItem );
-
-                    // Set the parent to aSheet.  This effectively creates a method to find
-                    // the root sheet from any sheet so a pointer to the root sheet does not
-                    // need to be stored globally.  Note: this is not the same as a hierarchy.
-                    // Complex hierarchies can have multiple copies of a sheet.  This only
-                    // provides a simple tree to find the root sheet.
-                    sheet->SetParent( aSheet );
-
-                    // Recursion starts here.
-                    loadHierarchy( sheet );
+                    std::rethrow_exception( file.m_Error );
                 }
+                catch( const IO_ERROR& ioe )
+                {
+                    // If there is a problem loading the root sheet, there is no recovery.
+                    if( file.m_Sheet == m_rootSheet )
+                        throw;
+
+                    // For all subsheets, queue up the error message for the caller.
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
+
+                    m_error += ioe.What();
+                }
+
+                continue;
             }
-            catch( const IO_ERROR& ioe )
+
+            wxString path = wxFileName( file.m_FullFileName ).GetPath();
+
+            for( auto aItem : file.m_Sheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
             {
-                // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw( ioe );
+                assert( aItem->Type() == SCH_SHEET_T );
+                auto sheet = static_cast<SCH_SHEET*>( aItem );
 
-                // For all subsheets, queue up the error message for the caller.
-                if( !m_error.IsEmpty() )
-                    m_error += "\n";
+                // Set the parent to the sheet.  This effectively creates a method to find
+                // the root sheet from any sheet so a pointer to the root sheet does not
+                // need to be stored globally.  Note: this is not the same as a hierarchy.
+                // Complex hierarchies can have multiple copies of a sheet.  This only
+                // provides a simple tree to find the root sheet.
+                sheet->SetParent( file.m_Sheet );
 
-                m_error += ioe.What();
+                sheets.push_back( { sheet, path } );
             }
         }
-
-        m_currentPath.pop();
-        wxLogTrace( traceSchLegacyPlugin, "Restoring path \"%s\"", m_currentPath.top() );
     }
 }
 
 
 void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SCREEN* aScreen )
 {
-    FILE_LINE_READER reader( aFileName );
+    std::unique_ptr<LINE_READER> reader;
+
+    // A compressed schematic is inflated while it is parsed
+    if( GZIP_LINE_READER::IsGzipFile( aFileName ) )
+        reader.reset( new GZIP_LINE_READER( aFileName ) );
+    else
+        reader.reset( new FILE_LINE_READER( aFileName ) );
 
-    loadHeader( reader, aScreen );
+    loadHeader( *reader, aScreen );
 
-    LoadContent( reader, aScreen, m_version );
+    LoadContent( *reader, aScreen, m_version );
 }
 
 
@@ -678,9 +754,14 @@ void SCH_SEXPR_PLUGIN::Save( const wxString& aFileName, SCH_SCREEN* aScreen, KIW
     // works properly.
     wxASSERT( fn.IsAbsolute() );
 
-    FILE_OUTPUTFORMATTER formatter( fn.GetFullPath() );
+    std::unique_ptr<OUTPUTFORMATTER> formatter;
+
+    if( GZIP_OUTPUTFORMATTER::IsGzipFileName( fn.GetFullPath() ) )
+        formatter.reset( new GZIP_OUTPUTFORMATTER( fn.GetFullPath() ) );
+    else
+        formatter.reset( new FILE_OUTPUTFORMATTER( fn.GetFullPath() ) );
 
-    m_out = &formatter;     // no ownership
+    m_out = formatter.get();     // no ownership
 
     Format( aScreen );
 }
@@ -1188,7 +1269,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -1363,9 +1444,14 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading sexpr symbol library file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    std::unique_ptr<LINE_READER> reader;
 
-    SCH_SEXPR_PARSER parser( &reader );
+    if( GZIP_LINE_READER::IsGzipFile( m_libFileName.GetFullPath() ) )
+        reader.reset( new GZIP_LINE_READER( m_libFileName.GetFullPath() ) );
+    else
+        reader.reset( new FILE_LINE_READER( m_libFileName.GetFullPath() ) );
+
+    SCH_SEXPR_PARSER parser( reader.get() );
 
     parser.ParseLib( m_symbols );
     ++m_modHash;
@@ -1395,7 +1481,12 @@ void SCH_SEXPR_PLUGIN_CACHE::Save()
     // Write through symlinks, don't replace them.
     wxFileName fn = GetRealFile();
 
-    std::unique_ptr< FILE_OUTPUTFORMATTER > formatter( new FILE_OUTPUTFORMATTER( fn.GetFullPath() ) );
+    std::unique_ptr< OUTPUTFORMATTER > formatter;
+
+    if( GZIP_OUTPUTFORMATTER::IsGzipFileName( fn.GetFullPath() ) )
+        formatter.reset( new GZIP_OUTPUTFORMATTER( fn.GetFullPath() ) );
+    else
+        formatter.reset( new FILE_OUTPUTFORMATTER( fn.GetFullPath() ) );
 
     formatter->Print( 0, "(kicad_symbol_lib (version %d) (host kicad_symbol_editor %s)\n",
                       SEXPR_SYMBOL_LIB_FILE_VERSION,
@@ -281,6 +281,9 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
         else if( status == UR_DELETED )
         {
             // deleted items are re-inserted on undo
+            if( SCH_ITEM* sch_item = dynamic_cast<SCH_ITEM*>( eda_item ) )
+                sch_item->SetConnectivityDirty();
+
             AddToScreen( eda_item );
             aList->SetPickedItemStatus( UR_NEW, (unsigned) ii );
         }
@@ -343,6 +346,8 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
                 break;
             }
 
+            // Connectivity may change
+            item->SetConnectivityDirty();
             AddToScreen( item );
         }
     }
@@ -178,6 +178,20 @@ bool NETLIST_EXPORTER_PSPICE_SIM::ParseDCCommand( const wxString& aCmd, SPICE_DC
 }
 
 
+wxString NETLIST_EXPORTER_PSPICE_SIM::getItemModel( const SPICE_ITEM& aItem ) const
+{
+    if( !m_deviceValues.empty() )
+    {
+        auto it = m_deviceValues.find( GetSpiceDevice( aItem.m_refName ).Lower() );
+
+        if( it != m_deviceValues.end() )
+            return it->second;
+    }
+
+    return aItem.m_model;
+}
+
+
 void NETLIST_EXPORTER_PSPICE_SIM::writeDirectives( OUTPUTFORMATTER* aFormatter, unsigned aCtl ) const
 {
     // Add a directive to obtain currents
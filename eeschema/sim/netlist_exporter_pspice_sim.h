@@ -92,6 +92,23 @@ public:
         m_simCommand.Clear();
     }
 
+    /**
+     * @brief Overrides the values of devices, to generate variants of the netlist.
+     * @param aValues maps the lower case Spice device names to their values.
+     */
+    void SetDeviceValues( const std::map<wxString, wxString>& aValues )
+    {
+        m_deviceValues = aValues;
+    }
+
+    /**
+     * @brief Clears the device value overrides.
+     */
+    void ClearDeviceValues()
+    {
+        m_deviceValues.clear();
+    }
+
     /**
      * Returns the command directive that is in use (either from the sheet or from m_simCommand
      * @return
@@ -135,10 +152,15 @@ public:
 protected:
     void writeDirectives( OUTPUTFORMATTER* aFormatter, unsigned aCtl ) const override;
 
+    wxString getItemModel( const SPICE_ITEM& aItem ) const override;
+
 private:
 
     ///> Custom simulation command (has priority over the schematic sheet simulation commands)
     wxString m_simCommand;
+
+    ///> Device value overrides, by lower case Spice device name
+    std::map<wxString, wxString> m_deviceValues;
 };
 
 #endif /* NETLIST_EXPORTER_PSPICE_SIM_H */
@@ -35,6 +35,7 @@
 #include <wx/stdpaths.h>
 #include <wx/dir.h>
 
+#include <cmath>
 #include <stdexcept>
 
 using namespace std;
@@ -365,7 +366,8 @@ void NGSPICE::init_dll()
     m_ngSpice_AllVecs = (ngSpice_AllVecs) m_dll.GetSymbol( "ngSpice_AllVecs" );
     m_ngSpice_Running = (ngSpice_Running) m_dll.GetSymbol( "ngSpice_running" ); // it is not a typo
 
-    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, NULL, NULL, &cbBGThreadRunning, this );
+    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, &cbSendData, &cbSendInitData,
+                    &cbBGThreadRunning, this );
 
     // Load a custom spinit file, to fix the problem with loading .cm files
     // Switch to the executable directory, so the relative paths are correct
@@ -537,6 +539,62 @@ int NGSPICE::cbControlledExit( int status, bool immediate, bool exit_upon_quit,
 }
 
 
+int NGSPICE::cbSendInitData( pvecinfoall aInfo, int id, void* user )
+{
+    // A new plot starts: forget the vectors of the previous one
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
+    std::lock_guard<std::mutex> lock( sim->m_streamMutex );
+
+    sim->m_streamedPlots.clear();
+
+    for( int i = 0; aInfo && i < aInfo->veccount; ++i )
+        sim->m_streamedPlots[ wxString( aInfo->vecs[i]->vecname ).Lower().ToStdString() ];
+
+    return 0;
+}
+
+
+int NGSPICE::cbSendData( pvecvaluesall aValues, int count, int id, void* user )
+{
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
+    std::lock_guard<std::mutex> lock( sim->m_streamMutex );
+
+    for( int i = 0; aValues && i < aValues->veccount; ++i )
+    {
+        pvecvalues value = aValues->vecsa[i];
+        auto       it = sim->m_streamedPlots.find( wxString( value->name ).Lower().ToStdString() );
+
+        if( it == sim->m_streamedPlots.end() )
+            continue;
+
+        if( value->is_complex )
+            it->second.push_back( std::hypot( value->creal, value->cimag ) );
+        else
+            it->second.push_back( value->creal );
+    }
+
+    return 0;
+}
+
+
+vector<double> NGSPICE::GetStreamedPlot( const string& aName )
+{
+    std::lock_guard<std::mutex> lock( m_streamMutex );
+    wxString name = wxString( aName ).Lower();
+
+    auto it = m_streamedPlots.find( name.ToStdString() );
+
+    // Node voltages may be named after the node only
+    if( it == m_streamedPlots.end() && name.StartsWith( "v(" ) && name.EndsWith( ")" ) )
+        it = m_streamedPlots.find( name.Mid( 2, name.Length() - 3 ).ToStdString() );
+
+    if( it == m_streamedPlots.end() )
+        return vector<double>();
+
+    return it->second;
+}
+
+
 void NGSPICE::validate()
 {
     if( m_error )
@@ -30,6 +30,9 @@
 #include <wx/dynlib.h>
 #include <ngspice/sharedspice.h>
 
+#include <map>
+#include <mutex>
+
 class wxDynamicLibrary;
 
 class NGSPICE : public SPICE_SIMULATOR {
@@ -74,6 +77,9 @@ public:
     ///> @copydoc SPICE_SIMULATOR::GetPhasePlot()
     std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) override;
 
+    ///> @copydoc SPICE_SIMULATOR::GetStreamedPlot()
+    std::vector<double> GetStreamedPlot( const std::string& aName ) override;
+
     ///> @copydoc SPICE_SIMULATOR::GetNetlist()
     virtual const std::string GetNetlist() const override;
 
@@ -119,6 +125,8 @@ private:
     static int cbSendStat( char* what, int id, void* user );
     static int cbBGThreadRunning( bool is_running, int id, void* user );
     static int cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user );
+    static int cbSendInitData( pvecinfoall aInfo, int id, void* user );
+    static int cbSendData( pvecvaluesall aValues, int count, int id, void* user );
 
     // Assures ngspice is in a valid state and reinitializes it if need be
     void validate();
@@ -131,6 +139,11 @@ private:
 
     ///> current netlist
     std::string m_netlist;
+
+    ///> Values of the vectors of the running simulation, received from the ngspice thread,
+    ///> indexed by their lower case name
+    std::map<std::string, std::vector<double>> m_streamedPlots;
+    std::mutex                                 m_streamMutex;
 };
 
 #endif /* NGSPICE_H */
@@ -38,9 +38,11 @@
 #include <pgm_base.h>
 #include "sim_plot_frame.h"
 #include "sim_plot_panel.h"
+#include "spice_batch.h"
 #include "spice_simulator.h"
 #include "spice_reporter.h"
 #include <menus_helpers.h>
+#include <widgets/progress_reporter.h>
 #include <tool/tool_manager.h>
 #include <tools/ee_actions.h>
 #include <eeschema_settings.h>
@@ -172,6 +174,10 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
 
+    m_streamTimer.SetOwner( this );
+    Connect( m_streamTimer.GetId(), wxEVT_TIMER,
+             wxTimerEventHandler( SIM_PLOT_FRAME::onStreamTimer ), NULL, this );
+
     // Toolbar buttons
     m_toolSimulate = m_toolBar->AddTool( ID_SIM_RUN, _( "Run/Stop Simulation" ),
             KiBitmap( sim_run_xpm ), _( "Run Simulation" ), wxITEM_NORMAL );
@@ -200,6 +206,12 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onAddSignal,   this, m_addSignals->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onProbe,       this, m_probeSignals->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onTune,        this, m_tuneValue->GetId() );
+
+    wxMenuItem* sweepTuners = m_simulationMenu->Insert(
+            m_simulationMenu->GetMenuItems().IndexOf( m_tuneValue ) + 1, wxID_ANY,
+            _( "Sweep Tuned Values" ),
+            _( "Simulate the corners of the ranges of the tuned component values" ) );
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSweepTuners, this, sweepTuners->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onShowNetlist, this, m_showNetlist->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSettings,    this, m_settings->GetId() );
 
@@ -224,6 +236,7 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
 
 SIM_PLOT_FRAME::~SIM_PLOT_FRAME()
 {
+    m_streamTimer.Stop();
     m_simulator->SetReporter( nullptr );
     delete m_reporter;
     delete m_signalsIconColorList;
@@ -758,6 +771,42 @@ bool SIM_PLOT_FRAME::updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL*
 }
 
 
+void SIM_PLOT_FRAME::updateStreamedPlots()
+{
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    if( !plotPanel || plotPanel->GetType() != ST_TRANSIENT
+            || m_exporter->GetSimType() != ST_TRANSIENT )
+        return;
+
+    // The X axis is read first: the Y axis vectors are at least as long
+    std::vector<double> data_x =
+            m_simulator->GetStreamedPlot( m_simulator->GetXAxis( ST_TRANSIENT ) );
+
+    if( data_x.empty() )
+        return;
+
+    for( const auto& trace : m_plots[plotPanel].m_traces )
+    {
+        const TRACE_DESC& desc = trace.second;
+        wxString          spiceVector = m_exporter->GetSpiceVector( desc.GetName(), desc.GetType(),
+                                                                    desc.GetParam() );
+
+        std::vector<double> data_y =
+                m_simulator->GetStreamedPlot( (const char*) spiceVector.c_str() );
+        size_t size = std::min( data_x.size(), data_y.size() );
+
+        if( size > 0 )
+        {
+            plotPanel->AddTrace( trace.first, (int) size, data_x.data(), data_y.data(),
+                                 desc.GetType() );
+        }
+    }
+
+    plotPanel->ResetScales();
+}
+
+
 void SIM_PLOT_FRAME::updateSignalList()
 {
     SIM_PLOT_PANEL* plotPanel = CurrentPlot();
@@ -869,6 +918,131 @@ void SIM_PLOT_FRAME::applyTuners()
 }
 
 
+void SIM_PLOT_FRAME::sweepTuners()
+{
+    // Every tuned value at either end of its range: 2^N simulations
+    static constexpr size_t MAX_SWEPT_TUNERS = 6;
+
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    if( m_tuners.empty() || !plotPanel || !SIM_PLOT_PANEL::IsPlottable( plotPanel->GetType() )
+            || m_plots[plotPanel].m_traces.empty() )
+    {
+        DisplayInfoMessage( this, _( "Tune component values and add signals to a plot "
+                                     "before sweeping the tuned values." ) );
+        return;
+    }
+
+    if( !m_settingsDlg )
+        m_settingsDlg = new DIALOG_SIM_SETTINGS( this );
+
+    updateNetlistExporter();
+    m_exporter->SetSimCommand( m_plots[plotPanel].m_simCommand );
+
+    std::vector<TUNER_SLIDER*> tuners( m_tuners.begin(), m_tuners.end() );
+    SPICE_BATCH                batch;
+
+    if( tuners.size() > MAX_SWEPT_TUNERS )
+        tuners.resize( MAX_SWEPT_TUNERS );
+
+    for( size_t corner = 0; corner < ( (size_t) 1 << tuners.size() ); ++corner )
+    {
+        std::map<wxString, wxString> values;
+        wxString                     title;
+
+        for( size_t i = 0; i < tuners.size(); ++i )
+        {
+            const SPICE_VALUE& value = ( corner & ( (size_t) 1 << i ) ) ? tuners[i]->GetMax()
+                                                                        : tuners[i]->GetMin();
+
+            values[ tuners[i]->GetSpiceName() ] = value.ToSpiceString();
+
+            if( !title.IsEmpty() )
+                title += wxT( ", " );
+
+            title += tuners[i]->GetComponentName() + wxT( " = " ) + value.ToSpiceString();
+        }
+
+        STRING_FORMATTER formatter;
+        m_exporter->SetDeviceValues( values );
+
+        if( !m_exporter->Format( &formatter, m_settingsDlg->GetNetlistOptions() ) )
+        {
+            m_exporter->ClearDeviceValues();
+            DisplayError( this, _( "There were errors during netlist export, aborted." ) );
+            return;
+        }
+
+        batch.AddRun( title, formatter.GetString() );
+    }
+
+    m_exporter->ClearDeviceValues();
+
+    SIM_TYPE             simType = plotPanel->GetType();
+    WX_PROGRESS_REPORTER reporter( this, _( "Sweeping Tuned Values" ), 1 );
+
+    reporter.SetMaxProgress( (int) batch.GetRuns().size() );
+
+    if( !batch.Run( &reporter ) )
+    {
+        DisplayError( this, _( "Some of the simulations failed; is the ngspice program "
+                               "installed?" ) );
+    }
+
+    // Overlay the traces of each corner on the plotted ones
+    TRACE_MAP traces = m_plots[plotPanel].m_traces;
+
+    for( const SPICE_BATCH_RUN& run : batch.GetRuns() )
+    {
+        if( !run.m_Success )
+            continue;
+
+        std::vector<COMPLEX> data_x = SPICE_BATCH::GetPlot( run,
+                                                            m_simulator->GetXAxis( simType ) );
+
+        if( data_x.empty() )
+            continue;
+
+        std::vector<double> x( data_x.size() );
+        std::vector<double> y( data_x.size() );
+
+        for( size_t i = 0; i < data_x.size(); ++i )
+            x[i] = std::abs( data_x[i] );
+
+        for( const auto& trace : traces )
+        {
+            const TRACE_DESC& desc = trace.second;
+            wxString          spiceVector = m_exporter->GetSpiceVector( desc.GetName(),
+                                                                        desc.GetType(),
+                                                                        desc.GetParam() );
+
+            std::vector<COMPLEX> data_y = SPICE_BATCH::GetPlot( run,
+                                                                (const char*) spiceVector.c_str() );
+
+            if( data_y.size() != data_x.size() )
+                continue;
+
+            for( size_t i = 0; i < data_y.size(); ++i )
+            {
+                if( desc.GetType() & SPT_AC_PHASE )
+                    y[i] = std::arg( data_y[i] );
+                else
+                    y[i] = std::abs( data_y[i] );
+            }
+
+            wxString name = wxString::Format( "%s (%s)", trace.first, run.m_Title );
+
+            if( plotPanel->AddTrace( name, (int) x.size(), x.data(), y.data(), desc.GetType() ) )
+                m_plots[plotPanel].m_traces.insert( std::make_pair( name, desc ) );
+        }
+    }
+
+    updateSignalList();
+    plotPanel->UpdateAll();
+    plotPanel->ResetScales();
+}
+
+
 bool SIM_PLOT_FRAME::loadWorkbook( const wxString& aPath )
 {
     m_plots.clear();
@@ -1327,6 +1501,16 @@ void SIM_PLOT_FRAME::onTune( wxCommandEvent& event )
     m_schematicFrame->Raise();
 }
 
+
+void SIM_PLOT_FRAME::onSweepTuners( wxCommandEvent& event )
+{
+    if( IsSimulationRunning() )
+        return;
+
+    sweepTuners();
+}
+
+
 void SIM_PLOT_FRAME::onShowNetlist( wxCommandEvent& event )
 {
     class NETLIST_VIEW_DIALOG : public wxDialog
@@ -1442,11 +1626,23 @@ void SIM_PLOT_FRAME::onSimStarted( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_stop_xpm ) );
     SetCursor( wxCURSOR_ARROWWAIT );
+
+    // Show the progress of long transient simulations
+    if( m_exporter->GetSimType() == ST_TRANSIENT )
+        m_streamTimer.Start( 250 );
+}
+
+
+void SIM_PLOT_FRAME::onStreamTimer( wxTimerEvent& aEvent )
+{
+    updateStreamedPlots();
 }
 
 
 void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 {
+    m_streamTimer.Stop();
+
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_run_xpm ) );
     SetCursor( wxCURSOR_ARROW );
 
@@ -41,6 +41,7 @@
 #include <dialogs/dialog_sim_settings.h>
 
 #include <wx/event.h>
+#include <wx/timer.h>
 
 #include <list>
 #include <memory>
@@ -240,6 +241,12 @@ private:
      */
     bool updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL* aPanel );
 
+    /**
+     * @brief Updates the traces of the current transient plot with the values received so
+     * far, while the simulation is running.
+     */
+    void updateStreamedPlots();
+
     /**
      * @brief Updates the list of currently plotted signals.
      */
@@ -261,6 +268,12 @@ private:
      */
     void applyTuners();
 
+    /**
+     * @brief Simulates the corners of the ranges of the tuned component values in parallel,
+     * and overlays their traces on the current plot.
+     */
+    void sweepTuners();
+
     /**
      * @brief Loads plot settings from a file.
      * @param aPath is the file name.
@@ -319,6 +332,7 @@ private:
     void onAddSignal( wxCommandEvent& event );
     void onProbe( wxCommandEvent& event );
     void onTune( wxCommandEvent& event );
+    void onSweepTuners( wxCommandEvent& event );
     void onShowNetlist( wxCommandEvent& event );
 
     void onClose( wxCloseEvent& aEvent );
@@ -328,6 +342,7 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onStreamTimer( wxTimerEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -347,6 +362,9 @@ private:
     std::shared_ptr<SPICE_SIMULATOR> m_simulator;
     SIM_THREAD_REPORTER* m_reporter;
 
+    ///> Refreshes the traces with the values streamed while the simulation is running
+    wxTimer m_streamTimer;
+
     typedef std::map<wxString, TRACE_DESC> TRACE_MAP;
 
     struct PLOT_INFO
@@ -0,0 +1,362 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "spice_batch.h"
+
+#include <widgets/progress_reporter.h>
+
+#include <wx/app.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/process.h>
+#include <wx/stdpaths.h>
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+static const wxChar* const traceSpiceBatch = wxT( "KICAD_SPICE_BATCH" );
+
+
+namespace
+{
+
+/// An ngspice process of the batch
+class BATCH_PROCESS : public wxProcess
+{
+public:
+    BATCH_PROCESS() :
+            m_pid( 0 ),
+            m_status( -1 ),
+            m_done( false )
+    {
+    }
+
+    void OnTerminate( int aPid, int aStatus ) override
+    {
+        m_status = aStatus;
+        m_done = true;
+    }
+
+    wxString m_netlistFile;
+    wxString m_rawFile;
+    wxString m_logFile;
+    long     m_pid;
+    int      m_status;
+    bool     m_done;
+};
+
+}
+
+
+void SPICE_BATCH::AddRun( const wxString& aTitle, const std::string& aNetlist )
+{
+    SPICE_BATCH_RUN run;
+    run.m_Title = aTitle;
+    run.m_Netlist = aNetlist;
+
+    m_runs.push_back( std::move( run ) );
+}
+
+
+bool SPICE_BATCH::Run( PROGRESS_REPORTER* aReporter, int aParallelism )
+{
+    if( aParallelism <= 0 )
+        aParallelism = std::max<int>( 1, std::thread::hardware_concurrency() );
+
+    // ngspice writes the raw files in ASCII when asked through its environment
+    wxExecuteEnv env;
+    wxGetEnvMap( &env.env );
+    env.env["SPICE_ASCIIRAWFILE"] = wxT( "1" );
+
+    const wxString command = getSimulatorCommand();
+    const wxString tempPrefix = wxFileName::GetTempDir() + wxFileName::GetPathSeparator()
+                                + wxT( "kicad_sim" );
+
+    std::vector<std::unique_ptr<BATCH_PROCESS>> processes( m_runs.size() );
+    size_t next = 0;
+    size_t finished = 0;
+    int    running = 0;
+    bool   cancelled = false;
+
+    auto launch =
+            [&]( size_t aIdx )
+            {
+                auto process = std::make_unique<BATCH_PROCESS>();
+                wxString base = wxFileName::CreateTempFileName( tempPrefix );
+
+                process->m_netlistFile = base + wxT( ".cir" );
+                process->m_rawFile = base + wxT( ".raw" );
+                process->m_logFile = base + wxT( ".log" );
+                wxRemoveFile( base );
+
+                wxFFile netlist( process->m_netlistFile, wxT( "wb" ) );
+
+                if( !netlist.IsOpened() || !netlist.Write( m_runs[aIdx].m_Netlist.c_str(),
+                                                           m_runs[aIdx].m_Netlist.size() ) )
+                {
+                    return false;
+                }
+
+                netlist.Close();
+
+                wxString cmd = wxString::Format( wxT( "%s -b -o \"%s\" -r \"%s\" \"%s\"" ),
+                                                 command, process->m_logFile,
+                                                 process->m_rawFile, process->m_netlistFile );
+
+                wxLogTrace( traceSpiceBatch, wxT( "Running %s" ), cmd );
+
+                process->m_pid = wxExecute( cmd, wxEXEC_ASYNC | wxEXEC_HIDE_CONSOLE,
+                                            process.get(), &env );
+
+                if( process->m_pid == 0 )
+                {
+                    wxRemoveFile( process->m_netlistFile );
+                    return false;
+                }
+
+                processes[aIdx] = std::move( process );
+                return true;
+            };
+
+    auto collect =
+            [&]( size_t aIdx )
+            {
+                BATCH_PROCESS* process = processes[aIdx].get();
+
+                if( process->m_status == 0 )
+                    m_runs[aIdx].m_Success = readRawFile( process->m_rawFile, m_runs[aIdx] );
+
+                wxLogTrace( traceSpiceBatch, wxT( "%s: exit status %d" ),
+                            m_runs[aIdx].m_Title, process->m_status );
+
+                wxRemoveFile( process->m_netlistFile );
+                wxRemoveFile( process->m_rawFile );
+                wxRemoveFile( process->m_logFile );
+                processes[aIdx].reset();
+            };
+
+    while( finished < m_runs.size() )
+    {
+        while( !cancelled && running < aParallelism && next < m_runs.size() )
+        {
+            if( launch( next ) )
+                running++;
+            else
+                finished++;
+
+            next++;
+        }
+
+        if( cancelled && running == 0 )
+            break;
+
+        // The termination of the processes is notified through the event loop
+        if( aReporter )
+        {
+            if( !aReporter->KeepRefreshing() && !cancelled )
+            {
+                cancelled = true;
+
+                for( const std::unique_ptr<BATCH_PROCESS>& process : processes )
+                {
+                    if( process && !process->m_done )
+                        wxProcess::Kill( process->m_pid, wxSIGKILL );
+                }
+            }
+        }
+        else if( wxTheApp )
+        {
+            wxTheApp->Yield( true );
+        }
+
+        wxMilliSleep( 10 );
+
+        for( size_t i = 0; i < processes.size(); ++i )
+        {
+            if( processes[i] && processes[i]->m_done )
+            {
+                collect( i );
+                running--;
+                finished++;
+
+                if( aReporter )
+                    aReporter->AdvanceProgress();
+            }
+        }
+    }
+
+    for( const SPICE_BATCH_RUN& run : m_runs )
+    {
+        if( !run.m_Success )
+            return false;
+    }
+
+    return true;
+}
+
+
+std::vector<COMPLEX> SPICE_BATCH::GetPlot( const SPICE_BATCH_RUN& aRun, const std::string& aName )
+{
+    wxString name = wxString( aName ).Lower();
+    auto     it = aRun.m_Vectors.find( name.ToStdString() );
+
+    // Node voltages may be named after the node only
+    if( it == aRun.m_Vectors.end() && name.StartsWith( "v(" ) && name.EndsWith( ")" ) )
+        it = aRun.m_Vectors.find( name.Mid( 2, name.Length() - 3 ).ToStdString() );
+
+    if( it == aRun.m_Vectors.end() )
+        return std::vector<COMPLEX>();
+
+    return it->second;
+}
+
+
+wxString SPICE_BATCH::getSimulatorCommand()
+{
+    // Prefer the ngspice executable installed with KiCad, if any
+    wxFileName exe( wxStandardPaths::Get().GetExecutablePath() );
+    exe.SetName( wxT( "ngspice" ) );
+
+    if( exe.FileExists() )
+        return wxT( "\"" ) + exe.GetFullPath() + wxT( "\"" );
+
+    return wxT( "ngspice" );
+}
+
+
+bool SPICE_BATCH::readRawFile( const wxString& aFileName, SPICE_BATCH_RUN& aRun )
+{
+    wxTextFile file( aFileName );
+
+    if( !file.Open() )
+        return false;
+
+    std::vector<std::string> names;
+    long                     variables = 0;
+    long                     points = 0;
+    bool                     complex = false;
+    bool                     success = false;
+
+    aRun.m_Vectors.clear();
+
+    for( wxString line = file.GetFirstLine(); !file.Eof(); line = file.GetNextLine() )
+    {
+        if( line.StartsWith( wxT( "Plotname:" ) ) )
+        {
+            // A new plot: only the last one is kept
+            names.clear();
+            variables = points = 0;
+            complex = false;
+            success = false;
+        }
+        else if( line.StartsWith( wxT( "Flags:" ) ) )
+        {
+            complex = line.Contains( wxT( "complex" ) );
+        }
+        else if( line.StartsWith( wxT( "No. Variables:" ) ) )
+        {
+            line.AfterFirst( ':' ).Trim( false ).ToLong( &variables );
+        }
+        else if( line.StartsWith( wxT( "No. Points:" ) ) )
+        {
+            line.AfterFirst( ':' ).Trim( false ).ToLong( &points );
+        }
+        else if( line.StartsWith( wxT( "Variables:" ) ) )
+        {
+            for( long i = 0; i < variables && !file.Eof(); ++i )
+            {
+                wxStringTokenizer tokens( file.GetNextLine() );
+
+                tokens.GetNextToken();      // the index
+                names.push_back( tokens.GetNextToken().Lower().ToStdString() );
+            }
+        }
+        else if( line.StartsWith( wxT( "Binary:" ) ) )
+        {
+            return false;
+        }
+        else if( line.StartsWith( wxT( "Values:" ) ) )
+        {
+            if( (long) names.size() != variables )
+                return false;
+
+            std::vector<std::vector<COMPLEX>> values( names.size() );
+            long                              point = 0;
+            size_t                            var = 0;
+
+            for( auto& vector : values )
+                vector.reserve( points );
+
+            // Each point is its index followed by the values of the variables
+            while( point < points && !file.Eof() )
+            {
+                wxStringTokenizer tokens( file.GetNextLine() );
+
+                while( tokens.HasMoreTokens() )
+                {
+                    wxString token = tokens.GetNextToken();
+
+                    // The line of the first variable starts with the index of the point
+                    if( var == 0 && tokens.HasMoreTokens() )
+                        continue;
+
+                    double re = 0.0, im = 0.0;
+
+                    if( complex )
+                    {
+                        token.BeforeFirst( ',' ).ToCDouble( &re );
+                        token.AfterFirst( ',' ).ToCDouble( &im );
+                    }
+                    else
+                    {
+                        token.ToCDouble( &re );
+                    }
+
+                    values[var].emplace_back( re, im );
+
+                    if( ++var == values.size() )
+                    {
+                        var = 0;
+                        point++;
+                    }
+                }
+            }
+
+            if( point != points )
+                return false;
+
+            aRun.m_Vectors.clear();
+
+            for( size_t i = 0; i < names.size(); ++i )
+                aRun.m_Vectors[names[i]] = std::move( values[i] );
+
+            success = true;
+        }
+    }
+
+    return success;
+}
@@ -0,0 +1,107 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SPICE_BATCH_H
+#define SPICE_BATCH_H
+
+#include "spice_simulator.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+class PROGRESS_REPORTER;
+
+/**
+ * @brief A simulation of a SPICE_BATCH, and its results.
+ */
+struct SPICE_BATCH_RUN
+{
+    ///> Description of the variant of the netlist (e.g. the values of the swept devices)
+    wxString m_Title;
+
+    std::string m_Netlist;
+
+    ///> True if the simulation ran and its results were read
+    bool m_Success = false;
+
+    ///> Vectors of the last plot of the simulation, by lower case name
+    std::map<std::string, std::vector<COMPLEX>> m_Vectors;
+};
+
+
+/**
+ * @brief Runs a batch of simulations, for instance the variants of a netlist of a parameter
+ * sweep, in parallel.
+ *
+ * The ngspice shared library keeps a global state, so there can only be one SPICE_SIMULATOR
+ * running at a time: each simulation of the batch runs in its own ngspice process instead,
+ * isolated from the others and from the interactive simulator.
+ */
+class SPICE_BATCH
+{
+public:
+    SPICE_BATCH() {}
+
+    /**
+     * @brief Adds a simulation to the batch.
+     * @param aTitle describes the variant of the netlist.
+     * @param aNetlist is the netlist, including its simulation command.
+     */
+    void AddRun( const wxString& aTitle, const std::string& aNetlist );
+
+    /**
+     * @brief Runs the simulations, and waits until they are done.
+     * @param aReporter is an optional progress reporter, advanced once per simulation;
+     * cancelling it kills the running simulations and skips the others.
+     * @param aParallelism is the maximum number of simulations running at the same time,
+     * the number of cores if 0.
+     * @return True if all the simulations succeeded.
+     */
+    bool Run( PROGRESS_REPORTER* aReporter = nullptr, int aParallelism = 0 );
+
+    const std::vector<SPICE_BATCH_RUN>& GetRuns() const
+    {
+        return m_runs;
+    }
+
+    /**
+     * @brief Returns a vector of the results of a simulation.
+     * @param aName is the vector named in Spice convention (e.g. V(3), @r1[i]).
+     * @return Requested vector. It might be empty if there is no vector with requested name.
+     */
+    static std::vector<COMPLEX> GetPlot( const SPICE_BATCH_RUN& aRun, const std::string& aName );
+
+private:
+    ///> Returns the command running ngspice in batch mode
+    static wxString getSimulatorCommand();
+
+    ///> Reads the vectors of the last plot of an ASCII raw file
+    static bool readRawFile( const wxString& aFileName, SPICE_BATCH_RUN& aRun );
+
+    std::vector<SPICE_BATCH_RUN> m_runs;
+};
+
+#endif /* SPICE_BATCH_H */
@@ -136,6 +136,15 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * @brief Returns the values of a vector received so far, while the simulation is running.
+     * Unlike the other Get*Plot() functions, it is safe to call during the simulation.
+     * @param aName is the vector named in Spice convention (e.g. V(3), I(R1)).
+     * @return Magnitude of the values received. It might be empty if the vector is not
+     * streamed.
+     */
+    virtual std::vector<double> GetStreamedPlot( const std::string& aName ) = 0;
+
     /**
      * @brief Returns current SPICE netlist used by the simulator.
      * @return The netlist.
@@ -22,10 +22,18 @@
 #include <wx/tokenzr.h>
 #include <wx/progdlg.h>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+
+#include <advanced_config.h>
+#include <common.h>
 #include <eda_pattern_match.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
+#include <template_fieldnames.h>
+#include <thread_pool.h>
 
 #include <symbol_tree_model_adapter.h>
 
@@ -64,18 +72,25 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                     aNicknames.size(), aParent );
     }
 
-    unsigned int ii = 0;
-
-    for( const auto& nickname : aNicknames )
+    if( ADVANCED_CFG::GetCfg().m_parallelSymbolLibLoad )
+    {
+        addLibrariesParallel( aNicknames, prg );
+    }
+    else
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        unsigned int ii = 0;
+
+        for( const auto& nickname : aNicknames )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
-            nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
+            if( prg && wxGetUTCTimeMillis() > nextUpdate )
+            {
+                prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+                nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
+            }
+
+            AddLibrary( nickname );
+            ii++;
         }
-
-        AddLibrary( nickname );
-        ii++;
     }
 
     m_tree.AssignIntrinsicRanks();
@@ -88,6 +103,86 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
 }
 
 
+void SYMBOL_TREE_MODEL_ADAPTER::addLibrariesParallel( const std::vector<wxString>& aNicknames,
+                                                      wxProgressDialog* aProgress )
+{
+    struct LOADED_LIB
+    {
+        std::vector<LIB_PART*> m_symbols;
+        wxString               m_error;
+    };
+
+    bool                           onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<LOADED_LIB>        loaded( aNicknames.size() );
+    std::vector<std::future<void>> returns;
+    std::atomic<unsigned>          finished( 0 );
+
+    // The rows create their plugin, and the default field names are translated, on first
+    // use: do it here, before the threads need them.
+    for( const wxString& nickname : aNicknames )
+        m_libs->FindRow( nickname );
+
+    TEMPLATE_FIELDNAME::GetDefaultFieldName( 0 );
+
+    // The plugins need the C locale, which is GLOBAL.  It is set for the whole load, and
+    // the main thread only waits for the loaders and adds their results to the tree.
+    LOCALE_IO toggle_locale;
+
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        returns.push_back( GetKiCadThreadPool().Submit(
+                [&, ii]()
+                {
+                    try
+                    {
+                        m_libs->LoadSymbolLib( loaded[ii].m_symbols, aNicknames[ii],
+                                               onlyPowerSymbols );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        loaded[ii].m_error = ioe.What();
+                    }
+                    catch( const std::exception& e )
+                    {
+                        loaded[ii].m_error = e.what();
+                    }
+
+                    finished++;
+                } ) );
+    }
+
+    // Add the libraries in the table order, each as soon as it is loaded
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        const wxString& nickname = aNicknames[ii];
+
+        while( returns[ii].wait_for( std::chrono::milliseconds( PROGRESS_INTERVAL_MILLIS ) )
+               != std::future_status::ready )
+        {
+            if( aProgress )
+            {
+                aProgress->Update( finished,
+                                   wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            }
+        }
+
+        if( !loaded[ii].m_error.IsEmpty() )
+        {
+            wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                          nickname,
+                                          loaded[ii].m_error ) );
+        }
+        else if( loaded[ii].m_symbols.size() > 0 )
+        {
+            std::vector<LIB_TREE_ITEM*> comp_list( loaded[ii].m_symbols.begin(),
+                                                   loaded[ii].m_symbols.end() );
+
+            DoAddLibrary( nickname, m_libs->GetDescription( nickname ), comp_list, false );
+        }
+    }
+}
+
+
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
     bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
@@ -26,6 +26,7 @@
 
 class LIB_TABLE;
 class SYMBOL_LIB_TABLE;
+class wxProgressDialog;
 
 class SYMBOL_TREE_MODEL_ADAPTER : public LIB_TREE_MODEL_ADAPTER
 {
@@ -62,6 +63,13 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( EDA_BASE_FRAME* aParent, LIB_TABLE* aLibs );
 
 private:
+    /**
+     * Load the libraries on the threads of the thread pool, and add them to the model in
+     * the order of aNicknames as they complete.
+     */
+    void addLibrariesParallel( const std::vector<wxString>& aNicknames,
+                               wxProgressDialog* aProgress );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
@@ -711,6 +711,8 @@ static bool highlightNet( TOOL_MANAGER* aToolMgr, const VECTOR2D& aPosition )
         }
         else
         {
+            editFrame->FlushConnectivityUpdate();
+
             SCH_ITEM* item = (SCH_ITEM*) selTool->GetNode( aPosition );
 
             if( item && item->Connection( *g_CurrentSheet ) )
@@ -839,6 +841,8 @@ int SCH_EDITOR_CONTROL::HighlightNetCursor( const TOOL_EVENT& aEvent )
     // TODO(JE) remove once real-time connectivity is a given
     if( !ADVANCED_CFG::GetCfg().m_realTimeConnectivity || !CONNECTION_GRAPH::m_allowRealTime )
         m_frame->RecalculateConnections( NO_CLEANUP );
+    else
+        m_frame->FlushConnectivityUpdate();
 
     std::string  tool = aEvent.GetCommandStr().get();
     PICKER_TOOL* picker = m_toolMgr->GetTool<PICKER_TOOL>();
@@ -123,6 +123,10 @@ private:
             selection = selTool->RequestSelection( busType );
             bus = (SCH_LINE*) selection.Front();
         }
+        else
+        {
+            frame->FlushConnectivityUpdate();
+        }
 
         if( !bus )
         {
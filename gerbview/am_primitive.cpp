@@ -107,7 +107,9 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                             aShapeBuffer.Append( polybuffer[0].x, polybuffer[0].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
+    // create a static buffer to avoid a lot of memory reallocation, one per thread because
+    // the shapes of several files can be built at the same time
+    static thread_local std::vector<wxPoint> polybuffer;
     polybuffer.clear();
 
     wxPoint curPos = aShapePos;
@@ -782,44 +784,71 @@ int AM_PRIMITIVE::GetShapeDim( const GERBER_DRAW_ITEM* aParent )
 SHAPE_POLY_SET* APERTURE_MACRO::GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent,
                                                        wxPoint aShapePos )
 {
-    SHAPE_POLY_SET holeBuffer;
-    bool hasHole = false;
-
-    m_shape.RemoveAllContours();
+    // The shape only depends on the parameters of the D_CODE and on the layer transform of the
+    // flash (see GERBER_DRAW_ITEM::GetABPosition). The shape of the last flash of the D_CODE is
+    // kept, and only moved for a flash having the same transform.
+    D_CODE*         tool = aParent->GetDcodeDescr();
+    SHAPE_POLY_SET& shape = tool->m_MacroShape;
+    wxPoint         shapePos = aParent->GetABPosition( aShapePos );
+    std::array<wxPoint, 3> axes = aParent->GetABTransformKey();
+
+    if( tool->m_MacroShapeValid && tool->m_MacroShapeAxes == axes )
+    {
+        wxPoint offset = shapePos - tool->m_MacroShapePos;
 
-    for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
-         prim_macro != primitives.end(); ++prim_macro )
+        if( offset != wxPoint( 0, 0 ) )
+        {
+            shape.Move( VECTOR2I( offset ) );
+            tool->m_MacroShapeBBox.Move( VECTOR2I( offset ) );
+        }
+    }
+    else
     {
-        if( prim_macro->primitive_id == AMP_COMMENT )
-            continue;
+        SHAPE_POLY_SET holeBuffer;
+        bool hasHole = false;
+
+        shape.RemoveAllContours();
 
-        if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
-            prim_macro->DrawBasicShape( aParent, m_shape, aShapePos );
-        else
+        for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
+             prim_macro != primitives.end(); ++prim_macro )
         {
-            prim_macro->DrawBasicShape( aParent, holeBuffer, aShapePos );
+            if( prim_macro->primitive_id == AMP_COMMENT )
+                continue;
 
-            if( holeBuffer.OutlineCount() )     // we have a new hole in shape: remove the hole
+            if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
+                prim_macro->DrawBasicShape( aParent, shape, aShapePos );
+            else
             {
-                m_shape.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
-                holeBuffer.RemoveAllContours();
-                hasHole = true;
+                prim_macro->DrawBasicShape( aParent, holeBuffer, aShapePos );
+
+                if( holeBuffer.OutlineCount() )     // we have a new hole in shape: remove the hole
+                {
+                    shape.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
+                    holeBuffer.RemoveAllContours();
+                    hasHole = true;
+                }
             }
         }
+
+        // If a hole is defined inside a polygon, we must fracture the polygon
+        // to be able to drawn it (i.e link holes by overlapping edges)
+        if( hasHole )
+            shape.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+        tool->m_MacroShapeBBox = shape.BBox();
+        tool->m_MacroShapeAxes = axes;
+        tool->m_MacroShapeValid = true;
     }
 
-    // If a hole is defined inside a polygon, we must fracture the polygon
-    // to be able to drawn it (i.e link holes by overlapping edges)
-    if( hasHole )
-        m_shape.Fracture( SHAPE_POLY_SET::PM_FAST );
+    tool->m_MacroShapePos = shapePos;
 
     m_boundingBox = EDA_RECT( wxPoint( 0, 0 ), wxSize( 1, 1 ) );
-    auto bb = m_shape.BBox();
+    const BOX2I& bb = tool->m_MacroShapeBBox;
     wxPoint center( bb.Centre().x, bb.Centre().y );
     m_boundingBox.Move( aParent->GetABPosition( center ) );
     m_boundingBox.Inflate( bb.GetWidth() / 2, bb.GetHeight() / 2 );
 
-    return &m_shape;
+    return &shape;
 }
 
 
@@ -173,7 +173,6 @@ struct APERTURE_MACRO
      */
     AM_PARAMS m_localparamStack;
 
-    SHAPE_POLY_SET m_shape;     ///< The shape of the item, calculated by GetApertureMacroShape
     EDA_RECT m_boundingBox;     ///< The bounding box of the item, calculated by GetApertureMacroShape
 
     /**
@@ -195,7 +194,7 @@ struct APERTURE_MACRO
      * Calculate the primitive shape for flashed items.
      * When an item is flashed, this is the shape of the item
      * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
-     * @return The shape of the item
+     * @return The shape of the item, cached by the D_CODE of aParent until its next flash
      */
     SHAPE_POLY_SET* GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos );
 
@@ -87,6 +87,10 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    m_MacroShape.RemoveAllContours();
+    m_MacroShapeValid = false;
+    m_FlashShape.RemoveAllContours();
+    m_FlashShapeValid = false;
 }
 
 
@@ -304,6 +308,7 @@ void D_CODE::ConvertShapeToPolygon()
     wxPoint currpos;
 
     m_Polygon.RemoveAllContours();
+    m_FlashShapeValid = false;
 
     switch( m_Shape )
     {
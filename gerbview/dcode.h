@@ -30,6 +30,7 @@
 #ifndef _DCODE_H_
 #define _DCODE_H_
 
+#include <array>
 #include <vector>
 
 #include <base_struct.h>
@@ -108,6 +109,18 @@ public:
                                              * complex shapes which are converted to polygon
                                              * (shapes with hole )
                                              */
+    SHAPE_POLY_SET        m_MacroShape;     ///< Shape of the last flash of an aperture macro,
+                                            ///< in A,B coordinates (see GetApertureMacroShape)
+    BOX2I                 m_MacroShapeBBox; ///< the bounding box of m_MacroShape
+    wxPoint               m_MacroShapePos;  ///< the A,B position of the flash of m_MacroShape
+    std::array<wxPoint, 3> m_MacroShapeAxes;    ///< the layer transform of the flash of
+                                                ///< m_MacroShape (see GetABTransformKey)
+    bool                  m_MacroShapeValid;    ///< false if m_MacroShape must be rebuilt
+    SHAPE_POLY_SET        m_FlashShape;     ///< Filled shape of the polygon and macro flashes,
+                                            ///< in A,B coordinates relative to the position of
+                                            ///< the flash, shared by the flashes drawn by the GAL
+    std::array<wxPoint, 3> m_FlashShapeAxes;    ///< the layer transform of m_FlashShape
+    bool                  m_FlashShapeValid;    ///< false if m_FlashShape must be rebuilt
 
 public:
     D_CODE( int num_dcode );
@@ -122,6 +135,8 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_MacroShapeValid = false;
+        m_FlashShapeValid = false;
     }
 
     /**
@@ -151,6 +166,8 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_MacroShapeValid = false;
+        m_FlashShapeValid = false;
     }
 
 
@@ -191,7 +191,7 @@ extern void fillArcGBRITEM(  GERBER_DRAW_ITEM* aGbrItem, int Dcode_index,
 // In gerbview, we add this attribute, similat to a Gerber drill file
 static const char file_attribute[] = ".FileFunction,Other,Drill*";
 
-static EXCELLON_CMD excellonHeaderCmdList[] =
+static const EXCELLON_CMD excellonHeaderCmdList[] =
 {
     { "M0",     DRILL_M_END,                 -1 },  // End of Program - No Rewind
     { "M00",    DRILL_M_END,                 -1 },  // End of Program - No Rewind
@@ -226,7 +226,7 @@ static EXCELLON_CMD excellonHeaderCmdList[] =
     { "",       DRILL_M_UNKNOWN,              0 }   // last item in list
 };
 
-static EXCELLON_CMD excellon_G_CmdList[] =
+static const EXCELLON_CMD excellon_G_CmdList[] =
 {
     { "G90", DRILL_G_ABSOLUTE,    0 },  // Absolute Mode
     { "G91", DRILL_G_INCREMENTAL, 0 },  // Incremental Input Mode
@@ -242,7 +242,8 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName,
+                                         EXCELLON_IMAGE* aParsedImage )
 {
     wxString msg;
     int layerId = GetActiveLayer();      // current layer used in GerbView
@@ -253,10 +254,22 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
     if( gerber_layer )
         Erase_Current_DrawLayer( false );
 
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    EXCELLON_IMAGE* drill_layer;
+    bool            success = true;
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
+    if( aParsedImage )
+    {
+        // The file was read beforehand: only move its image to the active layer
+        drill_layer = aParsedImage;
+        drill_layer->m_GraphicLayer = layerId;
+    }
+    else
+    {
+        drill_layer = new EXCELLON_IMAGE( layerId );
+
+        // Read the Excellon drill file:
+        success = drill_layer->LoadFile( aFullFileName );
+    }
 
     if( !success )
     {
@@ -384,11 +397,12 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     X2_ATTRIBUTE dummy;
     char* text = (char*)file_attribute;
     int dummyline = 0;
-    dummy.ParseAttribCmd( NULL, NULL, 0, text, dummyline );
+    dummy.ParseAttribCmd( NULL, text, dummyline );
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
     m_InUse = true;
+    BuildItemsIndex();
 
     return true;
 }
@@ -396,13 +410,13 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
 
 bool EXCELLON_IMAGE::Execute_HEADER_And_M_Command( char*& text )
 {
-    EXCELLON_CMD* cmd = NULL;
-    wxString      msg;
+    const EXCELLON_CMD* cmd = NULL;
+    wxString            msg;
 
     // Search command in list
     for( unsigned ii = 0; ; ii++ )
     {
-        EXCELLON_CMD* candidate = &excellonHeaderCmdList[ii];
+        const EXCELLON_CMD* candidate = &excellonHeaderCmdList[ii];
         int len = candidate->m_Name.size();
 
         if( len == 0 )                                                  // End of list reached
@@ -738,12 +752,12 @@ bool EXCELLON_IMAGE::Select_Tool( char*& text )
 
 bool EXCELLON_IMAGE::Execute_EXCELLON_G_Command( char*& text )
 {
-    EXCELLON_CMD* cmd     = NULL;
-    bool          success = false;
-    int           id = DRILL_G_UNKNOWN;
+    const EXCELLON_CMD* cmd = NULL;
+    bool                success = false;
+    int                 id = DRILL_G_UNKNOWN;
 
     // Search command in list
-    EXCELLON_CMD* candidate;
+    const EXCELLON_CMD* candidate;
     char * gcmd = text;         // gcmd points the G command, for error messages.
 
     for( unsigned ii = 0; ; ii++ )
@@ -84,6 +84,21 @@ private:
      */
     void    writePcbPolygonItem( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer );
 
+    /**
+     * write the shape of a flashed aperture macro item to the board file, as polygons.
+     * @param aGbrItem = the flashed Gerber item to export
+     * @param aLayer = the layer to use
+     * @return false if the item has no aperture macro
+     */
+    bool    writePcbMacroItem( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer );
+
+    /**
+     * write the outlines of a set of polygons, in X,Y coordinates, to the board file.
+     * @param aPolys = the polygons (cleaned up and fractured by this function)
+     * @param aLayer = the layer to use
+     */
+    void    writePcbPolygons( SHAPE_POLY_SET& aPolys, LAYER_NUM aLayer );
+
     /**
      * write a zone item to the board file.
      * Currently: only experimental, for tests
@@ -308,6 +323,9 @@ void GBR_TO_PCB_EXPORTER::export_non_copper_item( GERBER_DRAW_ITEM* aGbrItem, LA
         return;
     }
 
+    if( aGbrItem->m_Shape == GBR_SPOT_MACRO && writePcbMacroItem( aGbrItem, aLayer ) )
+        return;
+
     if( aGbrItem->m_Shape == GBR_ARC )
     {
         double  a = atan2( (double) ( aGbrItem->m_Start.y - aGbrItem->m_ArcCentre.y),
@@ -342,6 +360,13 @@ void GBR_TO_PCB_EXPORTER::export_copper_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_
         export_flashed_copper_item( aGbrItem );
         break;
 
+    case GBR_SPOT_MACRO:
+        // Aperture macros have no via equivalent: the shape is exported as polygons
+        if( !writePcbMacroItem( aGbrItem, aLayer ) )
+            export_segline_copper_item( aGbrItem, aLayer );
+
+        break;
+
     case GBR_ARC:
         export_segarc_copper_item( aGbrItem, aLayer );
         break;
@@ -553,46 +578,85 @@ void GBR_TO_PCB_EXPORTER::writePcbPolygonItem( GERBER_DRAW_ITEM* aGbrItem, LAYER
 {
     SHAPE_POLY_SET polys = aGbrItem->m_Polygon;
 
+    writePcbPolygons( polys, aLayer );
+}
+
+
+bool GBR_TO_PCB_EXPORTER::writePcbMacroItem( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer )
+{
+    D_CODE*         code = aGbrItem->GetDcodeDescr();
+    APERTURE_MACRO* macro = code ? code->GetMacro() : NULL;
+
+    if( macro == NULL )
+        return false;
+
+    // The macro shape is cached by the D_CODE in A,B coordinates: convert it back to X,Y
+    // coordinates, like the other exported items
+    SHAPE_POLY_SET polys = *macro->GetApertureMacroShape( aGbrItem, aGbrItem->m_Start );
+
+    for( int ii = 0; ii < polys.OutlineCount(); ii++ )
+    {
+        SHAPE_LINE_CHAIN& outline = polys.Outline( ii );
+
+        for( int jj = 0; jj < outline.PointCount(); jj++ )
+        {
+            wxPoint pos = aGbrItem->GetXYPosition( (wxPoint) outline.CPoint( jj ) );
+            outline.SetPoint( jj, VECTOR2I( pos ) );
+        }
+    }
+
+    writePcbPolygons( polys, aLayer );
+    return true;
+}
+
+
+void GBR_TO_PCB_EXPORTER::writePcbPolygons( SHAPE_POLY_SET& aPolys, LAYER_NUM aLayer )
+{
     // Cleanup the polygon
-    polys.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    aPolys.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
     // Ensure the polygon is valid:
-    if( polys.OutlineCount() == 0 )
+    if( aPolys.OutlineCount() == 0 )
         return;
 
-    polys.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    aPolys.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
-    SHAPE_LINE_CHAIN& poly = polys.Outline( 0 );
+    #define MAX_COORD_CNT 4
 
-    fprintf( m_fp, "(gr_poly (pts " );
+    for( int idx = 0; idx < aPolys.OutlineCount(); idx++ )
+    {
+        const SHAPE_LINE_CHAIN& poly = aPolys.COutline( idx );
 
-    #define MAX_COORD_CNT 4
-    int jj = MAX_COORD_CNT;
-    int cnt_max = poly.PointCount() -1;
+        fprintf( m_fp, "(gr_poly (pts " );
 
-    // Do not generate last corner, if it is the same point as the first point:
-    if( poly.CPoint( 0 ) == poly.CPoint( cnt_max ) )
-        cnt_max--;
+        int jj = MAX_COORD_CNT;
+        int cnt_max = poly.PointCount() -1;
 
-    for( int ii = 0; ii <= cnt_max; ii++ )
-    {
-        if( --jj == 0 )
+        // Do not generate last corner, if it is the same point as the first point:
+        if( poly.CPoint( 0 ) == poly.CPoint( cnt_max ) )
+            cnt_max--;
+
+        for( int ii = 0; ii <= cnt_max; ii++ )
         {
-            jj = MAX_COORD_CNT;
-            fprintf( m_fp, "\n" );
+            if( --jj == 0 )
+            {
+                jj = MAX_COORD_CNT;
+                fprintf( m_fp, "\n" );
+            }
+
+            fprintf( m_fp, " (xy %s %s)",
+                     Double2Str( MapToPcbUnits( poly.CPoint( ii ).x ) ).c_str(),
+                     Double2Str( MapToPcbUnits( -poly.CPoint( ii ).y ) ).c_str() );
         }
 
-        fprintf( m_fp, " (xy %s %s)", Double2Str( MapToPcbUnits( poly.CPoint( ii ).x ) ).c_str(),
-                Double2Str( MapToPcbUnits( -poly.CPoint( ii ).y ) ).c_str() );
-    }
-
-    fprintf( m_fp, ")" );
+        fprintf( m_fp, ")" );
 
-    if( jj != MAX_COORD_CNT )
-        fprintf( m_fp, "\n" );
+        if( jj != MAX_COORD_CNT )
+            fprintf( m_fp, "\n" );
 
-    fprintf( m_fp, "(layer %s) (width 0) )\n",
-             TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
+        fprintf( m_fp, "(layer %s) (width 0) )\n",
+                 TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
+    }
 }
 
 
@@ -37,6 +37,9 @@
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
+#include <thread_pool.h>
+
+#include <atomic>
 
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER\
@@ -276,6 +279,80 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
 }
 
 
+std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> GERBVIEW_FRAME::readGerberAndDrillFiles(
+        const std::vector<wxString>& aFullFileNames, const std::vector<int>& aFileTypes,
+        PROGRESS_REPORTER* aProgressReporter )
+{
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images( aFullFileNames.size() );
+    std::atomic_size_t                              next( 0 );
+    std::atomic_size_t                              finished( 0 );
+
+    // The images are read with a placeholder layer: they are moved to their actual layer
+    // when they are added to the layout
+    auto work = [&]()
+                {
+                    for( size_t ii = next++; ii < aFullFileNames.size(); ii = next++ )
+                    {
+                        if( aProgressReporter )
+                        {
+                            aProgressReporter->Report( wxString::Format( _( "Loading %s" ),
+                                                                         aFullFileNames[ii] ) );
+                        }
+
+                        bool success = false;
+
+                        // A file which cannot be read here is read again by the caller, which
+                        // reports the error
+                        try
+                        {
+                            if( aFileTypes[ii] == 1 )
+                            {
+                                EXCELLON_IMAGE* drill = new EXCELLON_IMAGE( 0 );
+                                images[ii].reset( drill );
+                                success = drill->LoadFile( aFullFileNames[ii] );
+                            }
+                            else
+                            {
+                                images[ii] = std::make_unique<GERBER_FILE_IMAGE>( 0 );
+                                success = images[ii]->LoadGerberFile( aFullFileNames[ii] );
+                            }
+                        }
+                        catch( ... )
+                        {
+                        }
+
+                        if( !success )
+                            images[ii].reset();
+
+                        if( aProgressReporter )
+                            aProgressReporter->AdvanceProgress();
+
+                        finished.fetch_add( 1 );
+                    }
+                };
+
+    // The main thread keeps the progress reporter alive while the pool works
+    THREAD_POOL&                   pool = GetKiCadThreadPool();
+    std::vector<std::future<void>> tasks;
+
+    for( size_t ii = 0; ii < std::min<size_t>( pool.GetThreadCount(), images.size() ); ++ii )
+        tasks.push_back( pool.Submit( work ) );
+
+    while( finished.load() < images.size() )
+    {
+        if( aProgressReporter )
+            aProgressReporter->KeepRefreshing();
+
+        wxMilliSleep( 30 );
+    }
+
+    for( std::future<void>& task : tasks )
+        task.wait();
+
+    return images;
+}
+
+
 bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
                                             const wxArrayString& aFilenameList,
                                             const std::vector<int>* aFileType )
@@ -291,8 +368,8 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    std::vector<wxString> fullFileNames;
+    std::vector<int>      fileTypes;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -313,62 +390,71 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
-        m_lastFileName = filename.GetFullPath();
+        fullFileNames.push_back( filename.GetFullPath() );
+        fileTypes.push_back( aFileType ? (*aFileType)[ii] : 0 );
+    }
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
-        {
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-            progress->KeepRefreshing();
-        }
+    // Create progress dialog (only used if more than 1 file to load
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    if( fullFileNames.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 1, false );
+        progress->SetMaxProgress( fullFileNames.size() );
+    }
+
+    // The files are parsed at the same time, but are added to the layers in the order
+    // of the list
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images =
+            readGerberAndDrillFiles( fullFileNames, fileTypes, progress.get() );
+
+    for( unsigned ii = 0; ii < fullFileNames.size(); ii++ )
+    {
+        m_lastFileName = fullFileNames[ii];
 
         SetActiveLayer( layer, false );
 
         visibility[ layer ] = true;
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        bool isDrill = fileTypes[ii] == 1;
+        bool loaded;
+
+        // The Read functions take the ownership of the image
+        if( isDrill )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            loaded = Read_EXCELLON_File( m_lastFileName,
+                                         static_cast<EXCELLON_IMAGE*>( images[ii].release() ) );
         }
         else
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
-                UpdateFileHistory( m_lastFileName );
+            loaded = Read_GERBER_File( m_lastFileName, images[ii].release() );
+        }
 
-                layer = getNextAvailableLayer( layer );
+        if( loaded )
+        {
+            UpdateFileHistory( m_lastFileName, isDrill ? &m_drillFileHistory : nullptr );
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
+            layer = getNextAvailableLayer( layer );
 
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, RPT_SEVERITY_ERROR );
-                    }
-                    break;
-                }
+            if( layer == NO_AVAILABLE_LAYERS && ii < fullFileNames.size()-1 )
+            {
+                success = false;
+                reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
 
-                SetActiveLayer( layer, false );
+                // Report the name of not loaded files:
+                ii += 1;
+                while( ii < fullFileNames.size() )
+                {
+                    filename = fullFileNames[ii++];
+                    wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                    reporter.Report( txt, RPT_SEVERITY_ERROR );
+                }
+                break;
             }
-        }
 
-        if( progress )
-            progress->AdvanceProgress();
+            SetActiveLayer( layer, false );
+        }
     }
 
     if( !success )
@@ -450,6 +536,8 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
+    std::vector<wxString> fullFileNames;
+
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
         filename = filenamesList[ii];
@@ -457,11 +545,32 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
         if( !filename.IsAbsolute() )
             filename.SetPath( currentPath );
 
+        fullFileNames.push_back( filename.GetFullPath() );
+    }
+
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    if( fullFileNames.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading NC drill files..." ), 1, false );
+        progress->SetMaxProgress( fullFileNames.size() );
+    }
+
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images =
+            readGerberAndDrillFiles( fullFileNames, std::vector<int>( fullFileNames.size(), 1 ),
+                                     progress.get() );
+
+    for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
+    {
+        filename = fullFileNames[ii];
+
         m_lastFileName = filename.GetFullPath();
 
         SetActiveLayer( layer, false );
 
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
+        if( Read_EXCELLON_File( filename.GetFullPath(),
+                                static_cast<EXCELLON_IMAGE*>( images[ii].release() ) ) )
         {
             // Update the list of recent drill files.
             UpdateFileHistory( filename.GetFullPath(), &m_drillFileHistory );
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GBR_RTREE_H_
+#define GBR_RTREE_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <convert_to_biu.h>
+#include <math/box2.h>
+#include <gerber_draw_item.h>
+
+#include <geometry/rtree.h>
+
+
+/**
+ * GBR_RTREE -
+ * Implements an R-tree for fast spatial indexing of the draw items of a Gerber image.
+ * The items are indexed by their bounding box in A,B coordinates, widened by the tolerance
+ * of GERBER_DRAW_ITEM::HitTest().
+ * Non-owning.
+ */
+class GBR_RTREE
+{
+private:
+    using gbr_rtree = RTree<GERBER_DRAW_ITEM*, int, 2, double>;
+
+public:
+    GBR_RTREE()
+    {
+        this->m_tree = new gbr_rtree();
+    }
+
+    ~GBR_RTREE()
+    {
+        delete this->m_tree;
+    }
+
+    /**
+     * Function BulkLoad()
+     * Replaces the content of the tree by aItems.  The tree is packed in one go, which is
+     * much faster than inserting the items one by one and gives faster queries.
+     */
+    void BulkLoad( const std::vector<GERBER_DRAW_ITEM*>& aItems )
+    {
+        std::vector<gbr_rtree::BulkEntry> entries;
+        entries.reserve( aItems.size() );
+
+        for( GERBER_DRAW_ITEM* item : aItems )
+        {
+            // The hit test of thin lines and arcs reaches a bit beyond their bounding box
+            EDA_RECT bbox = item->GetBoundingBox();
+            bbox.Inflate( std::max( item->m_Size.x, item->m_Size.y ) / 2 + HIT_TOLERANCE );
+
+            entries.push_back( { { { bbox.GetX(), bbox.GetY() },
+                                   { bbox.GetRight(), bbox.GetBottom() } },
+                                 item } );
+        }
+
+        m_tree->BulkLoad( entries );
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the RTree
+     */
+    void RemoveAll()
+    {
+        m_tree->RemoveAll();
+    }
+
+    /**
+     * Function Query()
+     * Executes a function object aVisitor for each item whose bounding box intersects
+     * with aBounds.  aVisitor returns false to stop the search.
+     */
+    template <class Visitor>
+    void Query( const BOX2I& aBounds, Visitor& aVisitor ) const
+    {
+        const int mmin[2] = { aBounds.GetX(), aBounds.GetY() };
+        const int mmax[2] = { aBounds.GetRight(), aBounds.GetBottom() };
+
+        m_tree->Search( mmin, mmax, aVisitor );
+    }
+
+private:
+    /// The minimal hit test radius of GERBER_DRAW_ITEM::HitTest()
+    static constexpr int HIT_TOLERANCE = Millimeter2iu( 0.01 );
+
+    gbr_rtree* m_tree;
+};
+
+
+#endif /* GBR_RTREE_H_ */
@@ -62,16 +62,11 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 }
 
 
-void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
+const GBR_NETLIST_METADATA& GERBER_DRAW_ITEM::GetNetAttributes() const
 {
-    m_netAttributes = aNetAttributes;
+    static const GBR_NETLIST_METADATA noAttributes;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+    return m_netAttributes ? *m_netAttributes : noAttributes;
 }
 
 
@@ -178,6 +173,15 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
 }
 
 
+std::array<wxPoint, 3> GERBER_DRAW_ITEM::GetABTransformKey() const
+{
+    const int axisLength = 1 << 20;
+
+    return { { GetABPosition( wxPoint( 0, 0 ) ), GetABPosition( wxPoint( axisLength, 0 ) ),
+               GetABPosition( wxPoint( 0, axisLength ) ) } };
+}
+
+
 wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 {
     // do the inverse transform made by GetABPosition
@@ -715,41 +719,43 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_UNITS aUnits, std::vector<MSG_PANEL_
     aList.emplace_back( _( "AB axis" ), msg, DARKRED );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    const GBR_NETLIST_METADATA& netAttributes = GetNetAttributes();
+
+    if( netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( netAttributes.m_Netname.IsEmpty() )
             net_msg << "<no net>";
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( netAttributes.m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
-        if( m_netAttributes.m_PadPinFunction.IsEmpty() )
+        if( netAttributes.m_PadPinFunction.IsEmpty() )
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue() );
+                                netAttributes.m_Cmpref,
+                                netAttributes.m_Padname.GetValue() );
         else
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s  Fct %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue(),
-                                m_netAttributes.m_PadPinFunction.GetValue() );
+                                netAttributes.m_Cmpref,
+                                netAttributes.m_Padname.GetValue(),
+                                netAttributes.m_PadPinFunction.GetValue() );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << netAttributes.m_Cmpref;
     }
 
     aList.emplace_back( net_msg, cmp_pad_msg, DARKCYAN );
@@ -36,6 +36,9 @@
 #include <dcode.h>
 #include <geometry/shape_poly_set.h>
 
+#include <array>
+#include <memory>
+
 class GERBER_FILE_IMAGE;
 class GBR_LAYOUT;
 class D_CODE;
@@ -113,16 +116,26 @@ private:
     wxRealPoint m_drawScale;                // A and B scaling factor
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_netAttributes;
+                                            ///< the string given by a %TO attribute set in aperture
+                                            ///< (dcode). Set for each item, because %TO is
+                                            ///< a dynamic object attribute, but shared by the
+                                            ///< items created with the same attributes
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
     ~GERBER_DRAW_ITEM();
 
-    void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    /**
+     * @param aNetAttributes is the shared copy of the net attributes of the image, given by
+     * GERBER_FILE_IMAGE::GetSharedNetAttributes()
+     */
+    void SetNetAttributes( const std::shared_ptr<const GBR_NETLIST_METADATA>& aNetAttributes )
+    {
+        m_netAttributes = aNetAttributes;
+    }
+
+    const GBR_NETLIST_METADATA& GetNetAttributes() const;
 
     /**
      * Function GetLayer
@@ -222,6 +235,14 @@ public:
      */
     wxPoint GetXYPosition( const wxPoint& aABPosition ) const;
 
+    /**
+     * Function GetABTransformKey
+     * returns the A,B positions of the origin and of 2 points of the X and Y axis, which
+     * identify the transform made by GetABPosition():
+     * items having the same key are drawn with the same transform
+     */
+    std::array<wxPoint, 3> GetABTransformKey() const;
+
     /**
      * Function GetDcodeDescr
      * returns the GetDcodeDescr of this object, or NULL.
@@ -95,6 +95,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
+    m_itemsIndexUpToDate = false;
 
     ResetDefaultValues();
 
@@ -227,6 +228,25 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
 }
 
 
+const std::shared_ptr<const GBR_NETLIST_METADATA>& GERBER_FILE_IMAGE::GetSharedNetAttributes()
+{
+    if( !m_sharedNetAttributes )
+    {
+        m_sharedNetAttributes = std::make_shared<const GBR_NETLIST_METADATA>( m_NetAttributeDict );
+
+        // The names are listed once per copy, instead of once per item
+        if( ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+            ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+            m_ComponentsList.insert( std::make_pair( m_NetAttributeDict.m_Cmpref, 0 ) );
+
+        if( ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+            m_NetnamesList.insert( std::make_pair( m_NetAttributeDict.m_Netname, 0 ) );
+    }
+
+    return m_sharedNetAttributes;
+}
+
+
 /* Function HasNegativeItems
  * return true if at least one item must be drawn in background color
  * used to optimize screen refresh
@@ -381,12 +401,35 @@ void GERBER_FILE_IMAGE::RemoveAttribute( X2_ATTRIBUTE& aAttribute )
      */
     wxString cmd = aAttribute.GetPrm( 0 );
     m_NetAttributeDict.ClearAttribute( &cmd );
+    m_sharedNetAttributes.reset();
 
     if( cmd.IsEmpty() || cmd == ".AperFunction" )
         m_AperFunction.Clear();
 }
 
 
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    m_itemsIndex.BulkLoad( m_drawings );
+    m_itemsIndexUpToDate = true;
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const BOX2I& aArea,
+                                    const std::function<bool( GERBER_DRAW_ITEM* )>& aFunc )
+{
+    if( !m_itemsIndexUpToDate )
+        BuildItemsIndex();
+
+    auto visitor = [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                   {
+                       return aFunc( aItem );
+                   };
+
+    m_itemsIndex.Query( aArea, visitor );
+}
+
+
 SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
 {
     KICAD_T        stype;
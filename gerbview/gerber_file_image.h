@@ -25,6 +25,8 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -32,6 +34,7 @@
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
+#include <gbr_rtree.h>
 
 // An useful macro used when reading gerber files;
 #define IsNumber( x ) ( ( ( (x) >= '0' ) && ( (x) <='9' ) )   \
@@ -66,6 +69,7 @@ class D_CODE;
 class GERBER_FILE_IMAGE;
 class X2_ATTRIBUTE;
 class X2_ATTRIBUTE_FILEFUNCTION;
+class LINE_READER;
 
 // For arcs, coordinates need 3 info: start point, end point and center or radius
 // In Excellon files it can be a A## value (radius) or I#J# center coordinates (like in gerber)
@@ -114,6 +118,10 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
 
     GERBER_LAYER       m_GBRLayerParams;                    // hold params for the current gerber layer
     GERBER_DRAW_ITEMS  m_drawings;                              // linked list of Gerber Items to draw
+    GBR_RTREE          m_itemsIndex;                        ///< spatial index of m_drawings
+    bool               m_itemsIndexUpToDate;                ///< false if items were added to
+                                                            ///< m_drawings since m_itemsIndex
+                                                            ///< was built
 
 public:
     bool               m_InUse;                                 // true if this image is currently in use
@@ -189,31 +197,34 @@ private:
                                                                 // -1 = negative items are
                                                                 // 0 = no negative items found
                                                                 // 1 = have negative items found
+
+    // The copy of m_NetAttributeDict shared by the items, or null if it has changed since
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_sharedNetAttributes;
+
     /**
      * test for an end of line
      * if a end of line is found:
      *   read a new line
-     * @param aBuff = buffer (size = GERBER_BUFZ) to fill with a new line
-     * @param aText = pointer to the last useful char in aBuff
+     * @param aReader = the reader of the GERBER file
+     * @param aText = pointer to the last useful char in the current line
      *          on return: points the beginning of the next line.
-     * @param aBuffSize = the size in bytes of aBuff
-     * @param aFile = the opened GERBER file to read
      * @return a pointer to the beginning of the next line or NULL if end of file
     */
-    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile );
+    char* GetNextLine( LINE_READER* aReader, char* aText );
 
-    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* aGerberFile );
+    bool GetEndOfBlock( LINE_READER* aReader, char*& aText );
 
     /**
       * reads a single RS274X command terminated with a %
      */
-    bool ReadRS274XCommand( char *aBuff, unsigned int aBuffSize, char*& aText );
+    bool ReadRS274XCommand( LINE_READER* aReader, char*& aText );
 
     /**
      * executes a RS274X command
+     * @param aReader is the reader of the GERBER file, to read the next lines of the
+     *                command, or NULL if the whole command is in aText
      */
-    bool ExecuteRS274XCommand( int aCommand, char* aBuff,
-                               unsigned int aBuffSize, char*& aText );
+    bool ExecuteRS274XCommand( int aCommand, LINE_READER* aReader, char*& aText );
 
     /**
      * reads two bytes of data and assembles them into an int with the first
@@ -227,16 +238,13 @@ private:
 
     /**
      * reads in an aperture macro and saves it in m_aperture_macros.
-     * @param aBuff a character buffer at least GERBER_BUFZ long that can be
-     *          used to read successive lines from the gerber file.
+     * @param aReader is the reader of the GERBER file, used to read the successive
+     *                lines of the macro
      * @param text A reference to a character pointer which gives the initial
      *              text to read from.
-     * @param aBuffSize is the size of aBuff
-     * @param gerber_file Which file to read from for continuation.
      * @return bool - true if a macro was read in successfully, else false.
      */
-    bool ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                            char* & text, FILE * gerber_file );
+    bool ReadApertureMacro( LINE_READER* aReader, char* & text );
 
     // functions to execute G commands or D basic commands:
     bool    Execute_G_Command( char*& text, int G_command );
@@ -288,8 +296,32 @@ public:
     void AddItemToList( GERBER_DRAW_ITEM* aItem )
     {
         m_drawings.push_back( aItem );
+        m_itemsIndexUpToDate = false;
     }
 
+    /**
+     * Function BuildItemsIndex
+     * packs the spatial index of the items, once all the items of the image are created.
+     */
+    void BuildItemsIndex();
+
+    /**
+     * Function QueryItems
+     * calls aFunc for each item whose bounding box, widened by the hit test tolerance,
+     * intersects aArea (in A,B coordinates). aFunc returns false to stop the search.
+     * The spatial index is built first if items were added since it was built.
+     */
+    void QueryItems( const BOX2I& aArea, const std::function<bool( GERBER_DRAW_ITEM* )>& aFunc );
+
+    /**
+     * Function GetSharedNetAttributes
+     * The items created while the same %TO net attributes are set share one copy of them,
+     * instead of storing their own copy.
+     * @return the copy of the current net attributes (m_NetAttributeDict) to give to the
+     * new items
+     */
+    const std::shared_ptr<const GBR_NETLIST_METADATA>& GetSharedNetAttributes();
+
     /**
      * @return the last GERBER_DRAW_ITEM* item of the items list
      */
@@ -42,6 +42,8 @@ class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
+class EXCELLON_IMAGE;
+class PROGRESS_REPORTER;
 class REPORTER;
 
 
@@ -210,6 +212,19 @@ private:
                                         const wxArrayString& aFilenameList,
                                         const std::vector<int>* aFileType = nullptr );
 
+    /**
+     * Reads a list of Gerber and NC drill files at the same time on the thread pool.
+     * Only the images are built: they are added to the layers later, from the main thread.
+     * @param aFullFileNames is the list of files to read
+     * @param aFileTypes is the type of each file (0 = Gerber, 1 = NC drill)
+     * @param aProgressReporter, if not null, is advanced once per file
+     * @return the images, in the order of aFullFileNames.  An image is null when its file
+     * could not be read.
+     */
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> readGerberAndDrillFiles(
+            const std::vector<wxString>& aFullFileNames, const std::vector<int>& aFileTypes,
+            PROGRESS_REPORTER* aProgressReporter );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -509,7 +524,15 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * Loads a Gerber file on the active layer.
+     * @param GERBER_FullFileName is the file to load
+     * @param aParsedImage, if not null, is the image of the file already read by
+     * readGerberAndDrillFiles(): it is added as is.  Its ownership is taken.
+     */
+    bool Read_GERBER_File( const wxString    bool Read_GERBER_File( const wxString&   GERBER_FullFileName, GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aParsedImage = nullptr );
 
     /**
      * function LoadExcellonFiles
@@ -520,7 +543,15 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
+
+    /**
+     * Loads a NC drill file on the active layer.
+     * @param aFullFileName is the file to load
+     * @param aParsedImage, if not null, is the image of the file already read by
+     * readGerberAndDrillFiles(): it is added as is.  Its ownership is taken.
+     */
+    bool Read_EXCELLON_File( const wxString& aFullFileName,
+                             EXCELLON_IMAGE* aParsedImage = nullptr );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
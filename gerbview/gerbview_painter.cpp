@@ -470,10 +470,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else    // rectangular hole
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, code, aFilled );
         }
 
         break;
@@ -495,10 +492,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, code, aFilled );
         }
         break;
     }
@@ -534,25 +528,19 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, code, aFilled );
         }
         break;
     }
 
     case GBR_SPOT_POLY:
     {
-        if( code->m_Polygon.OutlineCount() == 0 )
-            code->ConvertShapeToPolygon();
-
-        drawPolygon( aItem, code->m_Polygon, aFilled, true );
+        drawFlashedPolygon( aItem, code, aFilled );
         break;
     }
 
     case GBR_SPOT_MACRO:
-        drawApertureMacro( aItem, aFilled );
+        drawFlashedPolygon( aItem, code, aFilled );
         break;
 
     default:
@@ -582,4 +570,57 @@ void GERBVIEW_PAINTER::drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFille
 }
 
 
+void GERBVIEW_PAINTER::drawFlashedPolygon( GERBER_DRAW_ITEM* aParent, D_CODE* aCode,
+                                           bool aFilled )
+{
+    bool isMacro = aParent->m_Shape == GBR_SPOT_MACRO;
+
+    if( !isMacro && aCode->m_Polygon.OutlineCount() == 0 )
+        aCode->ConvertShapeToPolygon();
+
+    if( !aFilled )
+    {
+        if( isMacro )
+            drawApertureMacro( aParent, aFilled );
+        else
+            drawPolygon( aParent, aCode->m_Polygon, aFilled, true );
+
+        return;
+    }
+
+    SHAPE_POLY_SET&        shape = aCode->m_FlashShape;
+    std::array<wxPoint, 3> axes = aParent->GetABTransformKey();
+    VECTOR2I               position = aParent->GetABPosition( VECTOR2I( aParent->m_Start ) );
+
+    if( !aCode->m_FlashShapeValid || aCode->m_FlashShapeAxes != axes )
+    {
+        if( isMacro )
+        {
+            shape = *aCode->GetMacro()->GetApertureMacroShape( aParent, aParent->m_Start );
+        }
+        else
+        {
+            shape.RemoveAllContours();
+            shape.NewOutline();
+
+            for( const VECTOR2I& pt : aCode->m_Polygon.COutline( 0 ).CPoints() )
+                shape.Append( aParent->GetABPosition( pt + VECTOR2I( aParent->m_Start ) ) );
+        }
+
+        shape.Move( -position );
+        aCode->m_FlashShapeAxes = axes;
+        aCode->m_FlashShapeValid = true;
+    }
+
+    // on Opengl, the triangulation is shared by all the flashes
+    if( m_gal->IsOpenGlEngine() && !shape.IsTriangulationUpToDate() )
+        shape.CacheTriangulation();
+
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( position ) );
+    m_gal->DrawPolygon( shape );
+    m_gal->Restore();
+}
+
+
 const double GERBVIEW_RENDER_SETTINGS::MAX_FONT_SIZE = Millimeter2iu( 10.0 );
@@ -200,6 +200,16 @@ protected:
     void drawPolygon( GERBER_DRAW_ITEM* aParent, const SHAPE_POLY_SET& aPolygon,
                       bool aFilled, bool aShift = false );
 
+    /**
+     * Helper to draw the polygon of a flashed D_CODE, or the shape of its aperture macro.
+     * Filled flashes of a D_CODE drawn with the same layer transform share one shape, built
+     * and triangulated once, which the GAL only translates to the position of each flash.
+     * @param aParent the flashed item
+     * @param aCode the D_CODE of aParent
+     * @param aFilled If true, draw the shape as filled, otherwise only outline
+     */
+    void drawFlashedPolygon( GERBER_DRAW_ITEM* aParent, D_CODE* aCode, bool aFilled );
+
     /// Helper to draw a flashed shape (aka spot)
     void drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled );
 
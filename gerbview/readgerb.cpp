@@ -34,10 +34,15 @@
 
 #include <html_messagebox.h>
 #include <macros.h>
+#include <richio.h>
+
+#include <limits>
+#include <memory>
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                       GERBER_FILE_IMAGE* aParsedImage )
 {
     wxString msg;
 
@@ -50,11 +55,22 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    bool success = true;
+
+    if( aParsedImage )
+    {
+        // The file was read beforehand: only move its image to the active layer
+        gerber = aParsedImage;
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -108,12 +124,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 
 
 
-// size of a single line of text from a gerber file.
-// warning: some files can have *very long* lines, so the buffer must be large.
-#define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
-
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
     int      G_command = 0;        // command number for G commands like G04
@@ -123,11 +133,20 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     ClearMessageList( );
     ResetDefaultValues();
 
-    // Read the gerber file */
-    m_Current_File = wxFopen( aFullFileName, wxT( "rt" ) );
+    // Read the gerber file, mapped in memory: the lines are handed out in place, so a large
+    // file is not copied line by line to a buffer.  Some files have *very long* lines (or
+    // only one line), so their length is not limited.
+    std::unique_ptr<MMAP_LINE_READER> reader;
 
-    if( m_Current_File == 0 )
+    try
+    {
+        reader = std::make_unique<MMAP_LINE_READER>( aFullFileName, 0,
+                                                     std::numeric_limits<int>::max() );
+    }
+    catch( const IO_ERROR& )
+    {
         return false;
+    }
 
     m_FileName = aFullFileName;
 
@@ -137,11 +156,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     while( true )
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( reader->ReadLine() == NULL )
             break;
 
         m_LineNum++;
-        text = StrPurge( lineBuffer );
+        text = StrPurge( reader->Line() );
 
         while( text && *text )
         {
@@ -198,7 +217,7 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
                 if( m_CommandState != ENTER_RS274X_CMD )
                 {
                     m_CommandState = ENTER_RS274X_CMD;
-                    ReadRS274XCommand( lineBuffer, GERBER_BUFZ, text );
+                    ReadRS274XCommand( reader.get(), text );
                 }
                 else        //Error
                 {
@@ -217,9 +236,8 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
         }
     }
 
-    fclose( m_Current_File );
-
     m_InUse = true;
+    BuildItemsIndex();
 
     return true;
 }
@@ -29,6 +29,9 @@
 #include <gerber_file_image.h>
 #include <base_units.h>
 
+#include <algorithm>
+#include <cstring>
+
 
 /* These routines read the text string point from Text.
  * On exit, Text points the beginning of the sequence unread
@@ -39,7 +42,7 @@
 // this scale list assumes gerber units are imperial.
 // for metric gerber units, the imperial to metric conversion is made in read functions
 #define SCALE_LIST_SIZE 9
-static double scale_list[SCALE_LIST_SIZE] =
+static const double scale_list[SCALE_LIST_SIZE] =
 {
     1000.0 * IU_PER_MILS,   // x.1 format (certainly useless)
     100.0 * IU_PER_MILS,    // x.2 format (certainly useless)
@@ -70,14 +73,86 @@ int scaletoIU( double aCoord, bool isMetric )
 }
 
 
+/**
+ * Function readCoordNumber
+ * reads the number of a X, Y, A, I or J coordinate, and advances aText past it.
+ * The coordinates are most of the text of a Gerber file, so an integer coordinate is
+ * accumulated while its digits are read, instead of being copied to be converted by atoi().
+ * @param aText is the text to read, starting at the number
+ * @param aIsFloat is set to true if the number has a decimal point.  It is not reset,
+ *                 so the next coordinates of the command are also read as decimal numbers.
+ * @param aDigitCount is the number of digits of the coordinate format, when the trailing
+ *                    zeros are omitted and must be added, or 0
+ * @param aTruncate is true to remove the digits beyond aDigitCount (for Excellon files)
+ * @return the number in the file units if aIsFloat is set, or else the integer coordinate
+ */
+static double readCoordNumber( char*& aText, bool& aIsFloat, int aDigitCount, bool aTruncate )
+{
+    char*     start    = aText;
+    long long value    = 0;
+    int       nbdigits = 0;
+    bool      negative = false;
+    bool      regular  = true;     // false if a sign is found after the first char
+
+    if( *aText == '-' || *aText == '+' )
+        negative = *aText++ == '-';
+
+    while( IsNumber( *aText ) )
+    {
+        if( ( *aText >= '0' ) && ( *aText <= '9' ) )
+        {
+            // Like atoi(), stop at the first char which is not a digit
+            if( regular && !aIsFloat && nbdigits < 18 )
+                value = value * 10 + ( *aText - '0' );
+
+            nbdigits++;
+        }
+        else if( *aText == '.' )  // Force decimat format if reading a floating point number
+        {
+            aIsFloat = true;
+        }
+        else
+        {
+            regular = false;
+        }
+
+        aText++;
+    }
+
+    if( aIsFloat )
+    {
+        // When X or Y (or A) values are float numbers, they are given in mm or inches
+        char   line[256];
+        size_t len = std::min<size_t>( aText - start, sizeof( line ) - 1 );
+
+        memcpy( line, start, len );
+        line[len] = 0;
+
+        return atof( line );
+    }
+
+    if( regular && aDigitCount > 0 )
+    {
+        // no trailing zero format, we need to add missing zeros.
+        for( ; nbdigits < aDigitCount; nbdigits++ )
+            value *= 10;
+
+        // Truncate the extra digits if the len is more than expected
+        // because the conversion to internal units expect exactly
+        // digit_count digits
+        for( ; aTruncate && nbdigits > aDigitCount; nbdigits-- )
+            value /= 10;
+    }
+
+    return negative ? -value : value;
+}
+
+
 wxPoint GERBER_FILE_IMAGE::ReadXYCoord( char*& Text, bool aExcellonMode )
 {
     wxPoint pos;
-    int     type_coord = 0, current_coord, nbdigits;
+    int     type_coord = 0, current_coord;
     bool    is_float   = false;
-    char*   text;
-    char    line[256];
-
 
     if( m_Relative )
         pos.x = pos.y = 0;
@@ -87,74 +162,37 @@ wxPoint GERBER_FILE_IMAGE::ReadXYCoord( char*& Text, bool aExcellonMode )
     if( Text == NULL )
         return pos;
 
-    text = line;
     while( *Text )
     {
         if( (*Text == 'X') || (*Text == 'Y') || (*Text == 'A') )
         {
             type_coord = *Text;
             Text++;
-            text     = line;
-            nbdigits = 0;
 
-            while( IsNumber( *Text ) )
-            {
-                if( *Text == '.' )  // Force decimat format if reading a floating point number
-                    is_float = true;
+            int digit_count = 0;
 
-                // count digits only (sign and decimal point are not counted)
-                if( (*Text >= '0') && (*Text <='9') )
-                    nbdigits++;
-                *(text++) = *(Text++);
-            }
+            if( m_NoTrailingZeros )
+                digit_count = (type_coord == 'X') ? m_FmtLen.x : m_FmtLen.y;
 
-            *text = 0;
+            double coord = readCoordNumber( Text, is_float, digit_count, aExcellonMode );
 
             if( is_float )
             {
                 // When X or Y (or A) values are float numbers, they are given in mm or inches
                 if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
+                    current_coord = KiROUND( coord * IU_PER_MILS / 0.0254 );
                 else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
+                    current_coord = KiROUND( coord * IU_PER_MILS * 1000 );
             }
             else
             {
                 int fmt_scale = (type_coord == 'X') ? m_FmtScale.x : m_FmtScale.y;
-
-                if( m_NoTrailingZeros )
-                {
-                    // no trailing zero format, we need to add missing zeros.
-                    int digit_count = (type_coord == 'X') ? m_FmtLen.x : m_FmtLen.y;
-
-                    while( nbdigits < digit_count )
-                    {
-                        *(text++) = '0';
-                        nbdigits++;
-                    }
-
-                    if( aExcellonMode )
-                    {
-                        // Truncate the extra digits if the len is more than expected
-                        // because the conversion to internal units expect exactly
-                        // digit_count digits
-                        while( nbdigits > digit_count )
-                        {
-                            *(text--) = 0;
-                            nbdigits--;
-                        }
-                    }
-
-                    *text = 0;
-                }
-
-                current_coord = atoi( line );
                 double real_scale = scale_list[fmt_scale];
 
                 if( m_GerbMetric )
                     real_scale = real_scale / 25.4;
 
-                current_coord = KiROUND( current_coord * real_scale );
+                current_coord = KiROUND( coord * real_scale );
             }
 
             if( type_coord == 'X' )
@@ -192,70 +230,45 @@ wxPoint GERBER_FILE_IMAGE::ReadIJCoord( char*& Text )
 {
     wxPoint pos( 0, 0 );
 
-    int     type_coord = 0, current_coord, nbdigits;
+    int     type_coord = 0, current_coord;
     bool    is_float   = false;
-    char*   text;
-    char    line[256];
 
     if( Text == NULL )
         return pos;
 
-    text = line;
     while( *Text )
     {
         if( (*Text == 'I') || (*Text == 'J') )
         {
             type_coord = *Text;
             Text++;
-            text     = line;
-            nbdigits = 0;
-            while( IsNumber( *Text ) )
-            {
-                if( *Text == '.' )
-                    is_float = true;
 
-                // count digits only (sign and decimal point are not counted)
-                if( (*Text >= '0') && (*Text <='9') )
-                    nbdigits++;
+            int min_digit = 0;
 
-                *(text++) = *(Text++);
-            }
+            if( m_NoTrailingZeros )
+                min_digit = (type_coord == 'I') ? m_FmtLen.x : m_FmtLen.y;
+
+            double coord = readCoordNumber( Text, is_float, min_digit, false );
 
-            *text = 0;
             if( is_float )
             {
                 // When X or Y values are float numbers, they are given in mm or inches
                 if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
+                    current_coord = KiROUND( coord * IU_PER_MILS / 0.0254 );
                 else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
+                    current_coord = KiROUND( coord * IU_PER_MILS * 1000 );
             }
             else
             {
                 int fmt_scale =
                     (type_coord == 'I') ? m_FmtScale.x : m_FmtScale.y;
 
-                if( m_NoTrailingZeros )
-                {
-                    int min_digit =
-                        (type_coord == 'I') ? m_FmtLen.x : m_FmtLen.y;
-                    while( nbdigits < min_digit )
-                    {
-                        *(text++) = '0';
-                        nbdigits++;
-                    }
-
-                    *text = 0;
-                }
-
-                current_coord = atoi( line );
-
                 double real_scale = scale_list[fmt_scale];
 
                 if( m_GerbMetric )
                     real_scale = real_scale / 25.4;
 
-                current_coord = KiROUND( current_coord * real_scale );
+                current_coord = KiROUND( coord * real_scale );
             }
             if( type_coord == 'I' )
                 pos.x = current_coord;
@@ -113,7 +113,7 @@ void fillFlashedGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     aGbrItem->m_DCode = Dcode_index;
     aGbrItem->SetLayerPolarity( aLayerNegative );
     aGbrItem->m_Flashed = true;
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetSharedNetAttributes() );
 
     switch( aAperture )
     {
@@ -172,7 +172,7 @@ void fillLineGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     aGbrItem->m_DCode = Dcode_index;
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetSharedNetAttributes() );
 }
 
 
@@ -217,7 +217,7 @@ void fillArcGBRITEM(  GERBER_DRAW_ITEM* aGbrItem, int Dcode_index,
     aGbrItem->m_Flashed = false;
 
     if( aGbrItem->m_GerberImageFile )
-        aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+        aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetSharedNetAttributes() );
 
     if( aMultiquadrant )
         center = aStart + aRelCenter;
@@ -339,8 +339,9 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
 {
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
+     * (one per thread, because several files can be read at the same time)
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    static thread_local GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -348,7 +349,7 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
                      aStart, aEnd, rel_center, wxSize(0, 0),
                      aClockwise, aMultiquadrant, aLayerNegative );
 
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetSharedNetAttributes() );
 
     wxPoint   center;
     center = dummyGbrItem.m_ArcCentre;
@@ -495,7 +496,7 @@ bool GERBER_FILE_IMAGE::Execute_G_Command( char*& text, int G_command )
 
             char* cptr = (char*)x2buf.data();
             int code_command = ReadXCommandID( cptr );
-            ExecuteRS274XCommand( code_command, NULL, 0, cptr );
+            ExecuteRS274XCommand( code_command, NULL, cptr );
         }
 
         while( *text && (*text != '*') )
@@ -630,7 +631,8 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
 
                 if( gbritem->m_GerberImageFile )
                 {
-                    gbritem->SetNetAttributes( gbritem->m_GerberImageFile->m_NetAttributeDict );
+                    gbritem->SetNetAttributes(
+                            gbritem->m_GerberImageFile->GetSharedNetAttributes() );
                     gbritem->m_AperFunction = gbritem->m_GerberImageFile->m_AperFunction;
                 }
             }
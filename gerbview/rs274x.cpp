@@ -36,6 +36,7 @@
 #include <gerber_file_image.h>
 #include <X2_gerber_attributes.h>
 #include <gbr_metadata.h>
+#include <richio.h>
 
 extern int ReadInt( char*& text, bool aSkipSeparator = true );
 extern double ReadDouble( char*& text, bool aSkipSeparator = true );
@@ -141,7 +142,7 @@ int GERBER_FILE_IMAGE::ReadXCommandID( char*& text )
 }
 
 
-bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize, char*& aText )
+bool GERBER_FILE_IMAGE::ReadRS274XCommand( LINE_READER* aReader, char*& aText )
 {
     bool ok = true;
     int  code_command;
@@ -171,7 +172,7 @@ bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize,
 
             default:
                 code_command = ReadXCommandID( aText );
-                ok = ExecuteRS274XCommand( code_command, aBuff, aBuffSize, aText );
+                ok = ExecuteRS274XCommand( code_command, aReader, aText );
 
                 if( !ok )
                     goto exit;
@@ -181,14 +182,14 @@ bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize,
         }
 
         // end of current line, read another one.
-        if( fgets( aBuff, aBuffSize, m_Current_File ) == NULL )
+        if( aReader->ReadLine() == NULL )
         {
             // end of file
             ok = false;
             break;
         }
         m_LineNum++;
-        aText = aBuff;
+        aText = aReader->Line();
     }
 
 exit:
@@ -196,8 +197,8 @@ exit:
 }
 
 
-bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
-                                              unsigned int aBuffSize, char*& aText )
+bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, LINE_READER* aReader,
+                                              char*& aText )
 {
     int      code;
     int      seq_len;    // not used, just provided
@@ -229,7 +230,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 
             case 'D':       // Non-standard option for all zeros (leading + tailing)
                 msg.Printf( _( "RS274X: Invalid GERBER format command '%c' at line %d: \"%s\"" ),
-                        'D', m_LineNum, aBuff );
+                        'D', m_LineNum, aReader ? aReader->Line() : aText );
                 AddMessageToList( msg );
                 msg.Printf( _("GERBER file \"%s\" may not display as intended." ),
                         m_FileName.ToAscii() );
@@ -314,7 +315,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
                 msg.Printf( wxT( "Unknown id (%c) in FS command" ),
                            *aText );
                 AddMessageToList( msg );
-                GetEndOfBlock( aBuff, aBuffSize, aText, m_Current_File );
+                GetEndOfBlock( aReader, aText );
                 ok = false;
                 break;
             }
@@ -368,7 +369,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
         m_IsX2_file = true;
         {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( aReader, aText, m_LineNum );
 
         if( dummy.IsFileFunction() )
         {
@@ -389,7 +390,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
     case APERTURE_ATTRIBUTE:    // Command %TA
         {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( aReader, aText, m_LineNum );
 
         if( dummy.GetAttribute() == ".AperFunction" )
         {
@@ -406,7 +407,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
         {
         X2_ATTRIBUTE dummy;
 
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( aReader, aText, m_LineNum );
 
         if( dummy.GetAttribute() == ".N" )
         {
@@ -430,13 +431,15 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
             else
                 m_NetAttributeDict.m_PadPinFunction.Clear();
         }
+
+        m_sharedNetAttributes.reset();
         }
         break;
 
     case REMOVE_APERTURE_ATTRIBUTE:    // Command %TD ...
         {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( aReader, aText, m_LineNum );
         RemoveAttribute( dummy );
         }
         break;
@@ -649,7 +652,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
     case AP_MACRO:  // lines like %AMMYMACRO*
                     // 5,1,8,0,0,1.08239X$1,22.5*
                     // %
-        /*ok = */ReadApertureMacro( aBuff, aBuffSize, aText, m_Current_File );
+        /*ok = */ReadApertureMacro( aReader, aText );
         break;
 
     case AP_DEFINITION:
@@ -857,17 +860,17 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 
     (void) seq_len;     // quiet g++, or delete the unused variable.
 
-    ok = GetEndOfBlock( aBuff, aBuffSize, aText, m_Current_File );
+    ok = GetEndOfBlock( aReader, aText );
 
     return ok;
 }
 
 
-bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* gerber_file )
+bool GERBER_FILE_IMAGE::GetEndOfBlock( LINE_READER* aReader, char*& aText )
 {
     for( ; ; )
     {
-        while( (aText < aBuff + aBuffSize) && *aText )
+        while( *aText )
         {
             if( *aText == '*' )
                 return true;
@@ -878,18 +881,18 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
             aText++;
         }
 
-        if( fgets( aBuff, aBuffSize, gerber_file ) == NULL )
+        if( !aReader || aReader->ReadLine() == NULL )
             break;
 
         m_LineNum++;
-        aText = aBuff;
+        aText = aReader->Line();
     }
 
     return false;
 }
 
 
-char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile )
+char* GERBER_FILE_IMAGE::GetNextLine( LINE_READER* aReader, char* aText )
 {
     for( ; ; )
     {
@@ -901,12 +904,12 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
                 ++aText;
                 break;
 
-            case 0:    // End of text found in aBuff: Read a new string
-                if( fgets( aBuff, aBuffSize, aFile ) == NULL )
+            case 0:    // End of text found in the line: Read a new string
+                if( !aReader || aReader->ReadLine() == NULL )
                     return NULL;
 
                 m_LineNum++;
-                aText = aBuff;
+                aText = aReader->Line();
                 return aText;
 
             default:
@@ -917,9 +920,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
 }
 
 
-bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                                char*&    aText,
-                                FILE*     gerber_file )
+bool GERBER_FILE_IMAGE::ReadApertureMacro( LINE_READER* aReader, char*& aText )
 {
     wxString       msg;
     APERTURE_MACRO am;
@@ -942,7 +943,7 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
         if( *aText == '*' )
             ++aText;
 
-        aText = GetNextLine( aBuff, aBuffSize, aText, gerber_file );
+        aText = GetNextLine( aReader, aText );
 
         if( aText == NULL )  // End of File
             return false;
@@ -968,7 +969,7 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
         {
             am.m_localparamStack.push_back( AM_PARAM() );
             AM_PARAM& param = am.m_localparamStack.back();
-            aText = GetNextLine(  aBuff, aBuffSize, aText, gerber_file );
+            aText = GetNextLine( aReader, aText );
             if( aText == NULL)   // End of File
                 return false;
             param.ReadParam( aText );
@@ -977,7 +978,8 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
         else if( !isdigit(*aText)  )     // Ill. symbol
         {
             msg.Printf( wxT( "RS274X: Aperture Macro \"%s\": ill. symbol, line: \"%s\"" ),
-                        GetChars( am.name ), GetChars( FROM_UTF8( aBuff ) ) );
+                        GetChars( am.name ),
+                        GetChars( FROM_UTF8( aReader ? aReader->Line() : aText ) ) );
             AddMessageToList( msg );
             primitive_type = AMP_COMMENT;
         }
@@ -1033,7 +1035,8 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
 
         default:
             msg.Printf( wxT( "RS274X: Aperture Macro \"%s\": Invalid primitive id code %d, line %d: \"%s\"" ),
-                        GetChars( am.name ), primitive_type, m_LineNum, GetChars( FROM_UTF8( aBuff ) ) );
+                        GetChars( am.name ), primitive_type, m_LineNum,
+                        GetChars( FROM_UTF8( aReader ? aReader->Line() : aText ) ) );
             AddMessageToList( msg );
             return false;
         }
@@ -1051,7 +1054,7 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
 
             AM_PARAM& param = prim.params.back();
 
-            aText = GetNextLine( aBuff, aBuffSize, aText, gerber_file );
+            aText = GetNextLine( aReader, aText );
 
             if( aText == NULL)   // End of File
                 return false;
@@ -1085,7 +1088,7 @@ bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
 
                 AM_PARAM& param = prim.params.back();
 
-                aText = GetNextLine( aBuff, aBuffSize, aText, gerber_file );
+                aText = GetNextLine( aReader, aText );
 
                 if( aText == NULL )  // End of File
                     return false;
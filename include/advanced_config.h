@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -88,6 +90,110 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * Run the independent DRC tests concurrently, and split the track clearance test
+     * across all the available cores
+     */
+    bool m_parallelDRC;
+
+    /**
+     * Re-run the track DRC tests around the edited items after each board change
+     */
+    bool m_incrementalDRC;
+
+    /**
+     * Save the zone fills to, and reuse them from, a cache file next to the board file
+     */
+    bool m_zoneFillCache;
+
+    /**
+     * Subtract the knockouts of large zones tile by tile, on all cores
+     */
+    bool m_tiledZoneFill;
+
+    /**
+     * Update the connectivity clusters around the edited items only, instead of searching
+     * again all the items of the edited nets
+     */
+    bool m_incrementalConnectivity;
+
+    /**
+     * Triangulate the nodes of the ratsnest nets with the sweep triangulator of kimath, which
+     * works on flat arrays, instead of the half-edge structures of ttl
+     */
+    bool m_sweepRatsnestTriangulation;
+
+    /**
+     * Write a binary snapshot of the board next to the board file when saving, and reopen
+     * the board from it while the board file is unchanged
+     */
+    bool m_boardSnapshot;
+
+    /**
+     * List the footprints of a .pretty library from its file names, and parse a footprint
+     * file only when the footprint is first needed
+     */
+    bool m_lazyFootprintCache;
+
+    /**
+     * Load the symbol libraries of the symbol chooser on several threads
+     */
+    bool m_parallelSymbolLibLoad;
+
+    /**
+     * Watch the footprint library directories for changes instead of reading their file
+     * timestamps each time a library is checked
+     */
+    bool m_watchLibraryDirs;
+
+    /**
+     * Draw each layer of the board from a single group of vertices when zoomed out
+     */
+    bool m_aggregateZoomedOutLayers;
+
+    /**
+     * Redraw only the changed area of the view, when the graphics backend supports it
+     */
+    bool m_partialRedraw;
+
+    /**
+     * Draw the noncached layers of the Cairo canvas in tiles, on several threads
+     */
+    bool m_cairoTiledRendering;
+
+    /**
+     * Show the time and the item counts of each frame over the drawing canvases
+     */
+    bool m_showFrameStats;
+
+    /**
+     * CSV file receiving the measures of each frame of the drawing canvases, if not empty
+     */
+    wxString m_frameTraceFile;
+
+    /**
+     * Evaluate the alternative paths of the interactive router (walkaround directions,
+     * shove attempts) on several threads
+     */
+    bool m_parallelRouterCandidates;
+
+    /**
+     * File receiving the events of the interactive router, for the pns_replay tool,
+     * if not empty
+     */
+    wxString m_routerEventLogFile;
+
+    /**
+     * Adapt the shove time limit of the interactive router to the latency of the moves, and
+     * refine the moves which ran out of time between the input events
+     */
+    bool m_anytimeRouting;
+
+    /**
+     * Rebuild only the layers of the edited items in the 3D viewer, instead of the whole board
+     */
+    bool m_incremental3DView;
+
 
 private:
     ADVANCED_CFG();
@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file background_file_writer.h
+ * @brief Writing of the files prepared in memory on a background thread.
+ */
+
+#ifndef BACKGROUND_FILE_WRITER_H
+#define BACKGROUND_FILE_WRITER_H
+
+#include <wx/string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+
+
+/**
+ * Class BACKGROUND_FILE_WRITER
+ *
+ * Writes the files formatted in memory on a background task of the thread pool, so that the
+ * editor does not wait for the disk (like for the auto save files).
+ *
+ * Each file is first written to a temporary file next to it, which is then renamed over it:
+ * the file always holds either its previous or its new content, never a partial one.  The
+ * writes are done in order, and a queued write of a file is replaced by a newer one.
+ */
+class BACKGROUND_FILE_WRITER
+{
+public:
+    BACKGROUND_FILE_WRITER();
+
+    ///> Waits for the queued writes
+    ~BACKGROUND_FILE_WRITER();
+
+    BACKGROUND_FILE_WRITER( const BACKGROUND_FILE_WRITER& ) = delete;
+    BACKGROUND_FILE_WRITER& operator=( const BACKGROUND_FILE_WRITER& ) = delete;
+
+    /**
+     * Function Write
+     * queues the writing of aContent to aFileName and returns at once.
+     */
+    void Write( const wxString& aFileName, std::string aContent );
+
+    /**
+     * Function Wait
+     * returns once the queued writes are done, for example before removing their files.
+     * @return false if a write failed since the last call
+     */
+    bool Wait();
+
+    ///> @return true if some writes are queued or running
+    bool IsBusy() const;
+
+    /**
+     * Function WriteFile
+     * writes aContent to aFileName through a temporary file, on the calling thread.
+     * @return true on success
+     */
+    static bool WriteFile( const wxString& aFileName, const std::string& aContent );
+
+private:
+    ///> Runs the queued writes, on a task of the thread pool
+    void run();
+
+    std::deque<std::pair<wxString, std::string>> m_queue;
+    bool                                         m_running;
+    bool                                         m_failed;
+    mutable std::mutex                           m_lock;
+    std::condition_variable                      m_done;
+};
+
+#endif // BACKGROUND_FILE_WRITER_H
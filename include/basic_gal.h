@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -167,4 +169,9 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// basic_gal is shared by all the texts drawn, plotted or measured outside a GAL canvas, which
+/// can be done from several threads (the layers of a board are plotted concurrently): its
+/// users must hold this lock
+extern std::recursive_mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
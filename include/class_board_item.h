@@ -35,6 +35,7 @@
 #include <convert_to_biu.h>
 #include <gr_basic.h>
 #include <layers_id_colors_and_visibility.h>
+#include <slab_allocator.h>
 
 
 class BOARD;
@@ -85,6 +86,22 @@ public:
     // Do not create a copy constructor & operator=.
     // The ones generated by the compiler are adequate.
 
+#ifndef SWIG
+    /**
+     * The boards hold millions of tracks, pads and footprint items, which are allocated from
+     * slabs rather than one by one: the board files load and close faster, with less memory.
+     */
+    static void* operator new( size_t aSize )
+    {
+        return SLAB_ALLOCATOR::Allocate( aSize );
+    }
+
+    static void operator delete( void* aPtr, size_t aSize )
+    {
+        SLAB_ALLOCATOR::Free( aPtr, aSize );
+    }
+#endif
+
     virtual const wxPoint GetPosition() const = 0;
 
     /**
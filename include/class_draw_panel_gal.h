@@ -37,6 +37,7 @@
 class BOARD;
 class EDA_DRAW_FRAME;
 class TOOL_DISPATCHER;
+class wxFFile;
 
 namespace KIGFX
 {
@@ -206,6 +207,12 @@ protected:
     void onShowTimer( wxTimerEvent& aEvent );
     void onSetCursor( wxSetCursorEvent& event );
 
+    /// Draws the measures of the previous frame on the overlay target
+    void drawFrameStats();
+
+    /// Appends the measures of the last frame to the frame trace file
+    void traceFrameStats();
+
     static const int MinRefreshPeriod = 17;             ///< 60 FPS.
 
     wxCursor                 m_currentCursor;    /// Current mouse cursor shape id.
@@ -252,6 +259,13 @@ protected:
     /// Flag to indicate whether the panel should take focus at certain times (when moused over,
     /// and on various mouse/key events)
     bool                     m_stealsFocus;
+
+    /// Measures of the last frame, see ADVANCED_CFG::m_showFrameStats
+    struct FRAME_STATS;
+    std::unique_ptr<FRAME_STATS> m_frameStats;
+
+    /// File receiving the measures of the frames, see ADVANCED_CFG::m_frameTraceFile
+    std::unique_ptr<wxFFile> m_frameTrace;
 };
 
 #endif
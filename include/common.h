@@ -46,6 +46,7 @@
 #include <atomic>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <typeinfo>
 #include <boost/uuid/uuid.hpp>
@@ -208,13 +209,16 @@ public:
     ~LOCALE_IO();
 
 private:
-    // allow for nesting of LOCALE_IO instantiations
-    static std::atomic<unsigned int> m_c_count;
+    // allow for nesting of LOCALE_IO instantiations, also from several threads: the locale
+    // is switched by the first one and restored by the last one, which can be in another
+    // thread, so the state is shared and changed under m_lock.
+    static unsigned int m_c_count;
+    static std::mutex   m_lock;
 
     // The locale in use before switching to the "C" locale
     // (the locale can be set by user, and is not always the system locale)
-    std::string m_user_locale;
-    wxLocale*   m_wxLocale;
+    static std::string  m_user_locale;
+    static wxLocale*    m_wxLocale;
 };
 
 /**
@@ -191,6 +191,7 @@ enum KICAD_T
     // serialized layout used in undo/redo commands
     WS_PROXY_UNDO_ITEM_T,      // serialized layout used in undo/redo commands
     WS_PROXY_UNDO_ITEM_PLUS_T, // serialized layout plus page and title block settings
+    MODULE_PLACEMENT_UNDO_ITEM_T, // placement of a footprint used in undo/redo commands
 
     /*
      * FOR PROJECT::_ELEMs
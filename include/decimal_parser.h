@@ -0,0 +1,229 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file decimal_parser.h
+ * A locale independent reader of the decimal numbers of the S-expression files, which
+ * gives the same results as strtod() in the C locale, without its locale lookups.
+ */
+
+#ifndef DECIMAL_PARSER_H_
+#define DECIMAL_PARSER_H_
+
+#include <cstdint>
+#include <string>
+
+
+/**
+ * Struct DECIMAL
+ * is a decimal number as read from a text, without any rounding:
+ *     ( m_negative ? -1 : 1 ) * m_digits * 10^m_exponent
+ */
+struct DECIMAL
+{
+    uint64_t m_digits;
+    int      m_exponent;
+    bool     m_negative;
+
+    /**
+     * Function ToDouble
+     * gives the double nearest to the number, like strtod() does, when this can be
+     * computed with a single correctly rounded operation (at most 15 significant digits
+     * and a small exponent, which covers the numbers written by KiCad).
+     * @return false if the number must be converted by strtod().
+     */
+    bool ToDouble( double& aValue ) const
+    {
+        static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+        if( m_digits > ( 1ull << 53 ) || m_exponent < -22 || m_exponent > 22 )
+            return false;
+
+        double value = (double) m_digits;
+
+        if( m_exponent < 0 )
+            value /= pow10[-m_exponent];
+        else
+            value *= pow10[m_exponent];
+
+        aValue = m_negative ? -value : value;
+        return true;
+    }
+
+    /**
+     * Function ToScaledInt
+     * gives the exact value of the number multiplied by aScale, a power of ten such as
+     * IU_PER_MM, when it is an integer: the file values are then converted to internal
+     * units without a double round trip.  This is the value KiROUND( strtod() * aScale )
+     * gives for these numbers.
+     * @return false if the scaled number is not an integer, or does not fit in aValue.
+     */
+    bool ToScaledInt( double aScale, long long& aValue ) const
+    {
+        static const uint64_t pow10[] = { 1ull,
+                                          10ull,
+                                          100ull,
+                                          1000ull,
+                                          10000ull,
+                                          100000ull,
+                                          1000000ull,
+                                          10000000ull,
+                                          100000000ull,
+                                          1000000000ull,
+                                          10000000000ull,
+                                          100000000000ull,
+                                          1000000000000ull,
+                                          10000000000000ull,
+                                          100000000000000ull,
+                                          1000000000000000ull,
+                                          10000000000000000ull,
+                                          100000000000000000ull,
+                                          1000000000000000000ull };
+        const int maxPower = 18;
+        int       scale = 0;
+
+        while( scale < maxPower && (double) pow10[scale] < aScale )
+            scale++;
+
+        if( (double) pow10[scale] != aScale )
+            return false;
+
+        int      exponent = m_exponent + scale;
+        uint64_t value = m_digits;
+
+        if( exponent < 0 )
+        {
+            if( exponent < -maxPower || value % pow10[-exponent] )
+                return false;
+
+            value /= pow10[-exponent];
+        }
+        else if( exponent > 0 )
+        {
+            if( exponent > maxPower || value > INT64_MAX / pow10[exponent] )
+                return false;
+
+            value *= pow10[exponent];
+        }
+        else if( value > INT64_MAX )
+        {
+            return false;
+        }
+
+        aValue = m_negative ? -(long long) value : (long long) value;
+        return true;
+    }
+};
+
+
+/**
+ * Function ParseDecimal
+ * reads the decimal number [sign] digits [. digits] [e|E [sign] digits] which is all the
+ * text from aText to aEnd, with up to 19 significant digits.  The decimal point is always
+ * a '.' whatever the locale.
+ * @return false if the text is not such a number (it may still be a number for strtod()).
+ */
+inline bool ParseDecimal( const char* aText, const char* aEnd, DECIMAL& aResult )
+{
+    const int   maxDigits = 19;
+    const char* p = aText;
+    uint64_t    digits = 0;
+    int         count = 0;
+    int         exponent = 0;
+    bool        negative = false;
+    bool        any = false;
+
+    if( p < aEnd && ( *p == '-' || *p == '+' ) )
+        negative = *p++ == '-';
+
+    for( ; p < aEnd && *p >= '0' && *p <= '9'; ++p )
+    {
+        any = true;
+
+        if( digits == 0 && *p == '0' )
+            continue;
+
+        if( ++count > maxDigits )
+            return false;
+
+        digits = digits * 10 + ( *p - '0' );
+    }
+
+    if( p < aEnd && *p == '.' )
+    {
+        for( ++p; p < aEnd && *p >= '0' && *p <= '9'; ++p )
+        {
+            any = true;
+            exponent--;
+
+            if( digits == 0 && *p == '0' )
+                continue;
+
+            if( ++count > maxDigits )
+                return false;
+
+            digits = digits * 10 + ( *p - '0' );
+        }
+    }
+
+    if( !any )
+        return false;
+
+    if( p < aEnd && ( *p == 'e' || *p == 'E' ) )
+    {
+        bool negativeExp = false;
+        int  value = 0;
+
+        if( ++p < aEnd && ( *p == '-' || *p == '+' ) )
+            negativeExp = *p++ == '-';
+
+        if( p == aEnd )
+            return false;
+
+        for( ; p < aEnd && *p >= '0' && *p <= '9'; ++p )
+        {
+            if( value < 10000 )
+                value = value * 10 + ( *p - '0' );
+        }
+
+        exponent += negativeExp ? -value : value;
+    }
+
+    if( p != aEnd )
+        return false;
+
+    aResult.m_digits = digits;
+    aResult.m_exponent = exponent;
+    aResult.m_negative = negative;
+    return true;
+}
+
+
+inline bool ParseDecimal( const std::string& aText, DECIMAL& aResult )
+{
+    return ParseDecimal( aText.data(), aText.data() + aText.size(), aResult );
+}
+
+#endif  // DECIMAL_PARSER_H_
@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DIR_TIMESTAMP_CACHE_H
+#define DIR_TIMESTAMP_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <wx/event.h>
+#include <wx/string.h>
+
+class wxFileSystemWatcher;
+class wxFileSystemWatcherEvent;
+
+
+/**
+ * Class DIR_TIMESTAMP_CACHE
+ *
+ * Keeps the results of TimestampDir() for the library directories, and watches the
+ * directories with a wxFileSystemWatcher to forget a result as soon as a file of its
+ * directory changes.  Until then, the timestamp of a directory is returned without
+ * reading the directory again.
+ *
+ * It is only used when the WatchLibraryDirs advanced config key is set.  The directories
+ * are watched from the main thread, once the event loop runs; the other threads get the
+ * cached timestamps of the watched directories and compute the other ones.
+ */
+class DIR_TIMESTAMP_CACHE : public wxEvtHandler
+{
+public:
+    DIR_TIMESTAMP_CACHE();
+    ~DIR_TIMESTAMP_CACHE();
+
+    /**
+     * Function Timestamp
+     * @return the same hash of the last-mod-dates of the files of aDirPath matching
+     * aFilespec as TimestampDir()
+     */
+    long long Timestamp( const wxString& aDirPath, const wxString& aFilespec );
+
+private:
+    struct DIR_STATE
+    {
+        bool                          m_watched = false;
+
+        ///> Incremented by each change of the directory, so that a timestamp computed during
+        ///> a change is not kept
+        unsigned                      m_generation = 0;
+
+        ///> The timestamps by file spec, valid until the directory changes
+        std::map<wxString, long long> m_timestamps;
+    };
+
+    ///> Starts watching aDir.  @return false if it cannot be watched from this thread
+    bool watch( const wxString& aDir, DIR_STATE& aState );
+
+    void invalidate( const wxString& aPath );
+
+    void onFileSystemEvent( wxFileSystemWatcherEvent& aEvent );
+
+    std::unique_ptr<wxFileSystemWatcher> m_watcher;
+    std::map<wxString, DIR_STATE>        m_dirs;
+    std::mutex                           m_lock;
+};
+
+
+/**
+ * Function LibraryDirTimestamp
+ * @return TimestampDir( aDirPath, aFilespec ), through the directory timestamp cache when
+ * the library directories are watched
+ */
+long long LibraryDirTimestamp( const wxString& aDirPath, const wxString& aFilespec );
+
+#endif  // DIR_TIMESTAMP_CACHE_H
@@ -25,6 +25,7 @@
 #ifndef DSNLEXER_H_
 #define DSNLEXER_H_
 
+#include <cstdint>
 #include <cstdio>
 #include <hashtables.h>
 #include <string>
@@ -42,6 +43,54 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+
+/**
+ * Class KEYWORD_INDEX
+ * is a minimal perfect hash of a KEYWORD table: a keyword is found with one hash of its
+ * characters and one compare, straight from the lexer's line buffer, without building
+ * a C string or a std::string and without any allocation.
+ *
+ * The index of a table is built once, by the first lexer using the table, and then
+ * shared by all the lexers using it, see Get().
+ */
+class KEYWORD_INDEX
+{
+public:
+    KEYWORD_INDEX( const KEYWORD* aKeywords, unsigned aCount );
+
+    /**
+     * Function Find
+     * @return the token of the keyword made of the aLength chars at aText, or -1 if these
+     *         chars are not a keyword.
+     */
+    int Find( const char* aText, size_t aLength ) const;
+
+    /**
+     * Function Get
+     * @return the shared index of the table aKeywords, which is built on first use.
+     *         This is thread safe.
+     */
+    static const KEYWORD_INDEX* Get( const KEYWORD* aKeywords, unsigned aCount );
+
+private:
+    struct SLOT
+    {
+        const char* name;
+        size_t      length;
+        int         token;
+    };
+
+    static uint64_t hash( const char* aText, size_t aLength );
+
+    ///> Spreads aHash over the slots for the displacement aSeed of a bucket
+    size_t slot( uint64_t aHash, uint32_t aSeed ) const;
+
+    ///> Per bucket: a seed for slot(), or -1 - the slot of a bucket of a single keyword.
+    ///> Empty if the keywords could not be separated, in which case Find() is a linear search.
+    std::vector<int32_t> m_displacements;
+    std::vector<SLOT>    m_slots;
+};
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -110,7 +159,7 @@ protected:
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    const KEYWORD_INDEX* keywordIndex;          ///< shared perfect hash of keywords
 
     void init();
 
@@ -142,7 +191,16 @@ protected:
      * @return int - with a value from the enum DSN_T matching the keyword text,
      *         or DSN_SYMBOL if @a aToken is not in the kewords table.
      */
-    int findToken( const std::string& aToken );
+    int findToken( const std::string& aToken )
+    {
+        return findToken( aToken.data(), aToken.size() );
+    }
+
+    /**
+     * Function findToken
+     * looks up the aLength chars at aText in the keywords table.
+     */
+    int findToken( const char* aText, size_t aLength );
 
     bool isStringTerminator( char cc )
     {
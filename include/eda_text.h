@@ -263,6 +263,14 @@ public:
      */
     void TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const;
 
+    /**
+     * Return the text shape as a list of segments, like TransformTextShapeToSegmentList().
+     *
+     * The list is cached, and only built again when the text or its effects have changed
+     * since the previous call.  Not thread-safe: the cache is updated by this call.
+     */
+    const std::vector<wxPoint>& GetTextShapeSegments() const;
+
     /**
      * Convert the text bounding box to a rectangular polygon depending on the text
      * orientation, the bounding box is not always horizontal or vertical
@@ -384,6 +392,13 @@ private:
     // Private text effects data. API above provides accessor funcs.
     TEXT_EFFECTS    m_e;
 
+    // Cache of the text shape returned by GetTextShapeSegments(), and the text and effects
+    // it was built from
+    mutable std::vector<wxPoint> m_segmentsCache;
+    mutable bool                 m_segmentsCacheValid;
+    mutable TEXT_EFFECTS         m_segmentsCacheEffects;
+    mutable wxString             m_segmentsCacheText;
+
     /// EDA_TEXT effects bools
     enum TE_FLAGS {
         // start at zero, sequence is irrelevant
@@ -99,9 +99,9 @@ public:
         FOOTPRINT_FILTER* m_filter;
 
         /**
-         * Check if the stored component matches an item by footprint filter.
+         * Check if the stored component matches the item at aPos by footprint filter.
          */
-        bool FootprintFilterMatch( FOOTPRINT_INFO& aItem );
+        bool FootprintFilterMatch( size_t aPos );
 
         /**
          * Check if the stored component matches an item by pin count.
@@ -142,7 +142,14 @@ private:
     int             m_filter_type;
 
     std::vector<std::unique_ptr<EDA_COMBINED_MATCHER>> m_pattern_filters;
-    std::vector<std::unique_ptr<EDA_PATTERN_MATCH>>    m_footprint_filters;
+    wxArrayString                                      m_footprint_filters;
+
+    ///> The footprints of m_list matched by one of m_footprint_filters, from the matches
+    ///> cached by the list
+    std::vector<bool> m_footprint_filter_matches;
+    bool              m_footprint_filters_matched;
+
+    void matchFootprintFilters();
 };
 
 #endif // FOOTPRINT_FILTER_H
@@ -38,7 +38,9 @@
 #include <lib_tree_item.h>
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <vector>
 
 
 class FP_LIB_TABLE;
@@ -198,6 +200,21 @@ protected:
     FPILIST m_list;
     ERRLIST m_errors; ///< some can be PARSE_ERRORs also
 
+    ///> The lower case names of the footprints, without and with their library, for the filters
+    std::vector<wxString> m_filter_names;
+    std::vector<wxString> m_filter_lib_names;
+
+    ///> The footprints matched by each footprint filter, see GetFilterMatches()
+    std::map<wxString, std::vector<unsigned>> m_filter_matches;
+
+    ///> Drops the matches of the footprint filters, after the list is changed
+    void clearFilterMatches()
+    {
+        m_filter_names.clear();
+        m_filter_lib_names.clear();
+        m_filter_matches.clear();
+    }
+
 public:
     FOOTPRINT_LIST() : m_lib_table( 0 )
     {
@@ -210,6 +227,12 @@ public:
     virtual void WriteCacheToFile( wxTextFile* aFile ) { };
     virtual void ReadCacheFromFile( wxTextFile* aFile ) { };
 
+    /**
+     * Writes the list as a LIB_INDEX, for the tools which look footprints up by name
+     * without loading the list.
+     */
+    virtual void WriteIndexFile( const wxString& aFileName ) { };
+
     /**
      * @return the number of items stored in list
      */
@@ -244,6 +267,19 @@ public:
         return *m_list[aIdx];
     }
 
+    /**
+     * Get the footprints matched by a footprint filter of a symbol: the wildcard pattern
+     * aFilter matches the footprint name, prefixed by the library name when the filter
+     * contains a ':', ignoring the case.
+     *
+     * The filter is compiled and matched against the whole list the first time, and its
+     * matches are kept until the list is read again, so that the symbols which share their
+     * filters do not match them again.
+     *
+     * @return the indexes of the matching footprints in the list, in increasing order.
+     */
+    const std::vector<unsigned>& GetFilterMatches( const wxString& aFilter );
+
     unsigned GetErrorCount() const
     {
         return m_errors.size();
@@ -236,6 +236,9 @@ protected:
 
     void resetContext();
 
+    /// Resets the Cairo transformations and drawing state to the world <-> screen matrices
+    void resetCairoState();
+
     /**
      * @brief Draw a grid line (usually a simplified line function).
      *
@@ -336,6 +339,36 @@ protected:
 };
 
 
+/**
+ * @brief Class CAIRO_TILE_GAL draws a horizontal band of the image of another Cairo GAL.
+ *
+ * It draws directly in the pixels of the band, so several tiles of the same image can be
+ * drawn concurrently, each by its own thread.
+ */
+class CAIRO_TILE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    CAIRO_TILE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions );
+
+    /**
+     * @brief Starts drawing a band of an image.
+     *
+     * @param aParent is the GAL drawing the whole image, its view is copied.
+     * @param aTarget is the image surface.
+     * @param aTop is the first row of the band.
+     * @param aHeight is the number of rows of the band.
+     * @param aAntialias is the antialiasing mode of aParent.
+     */
+    void Begin( const GAL& aParent, cairo_surface_t* aTarget, int aTop, int aHeight,
+                cairo_antialias_t aAntialias );
+
+    /**
+     * @brief Ends drawing the band, the pixels of the image are up to date.
+     */
+    void End();
+};
+
+
 class CAIRO_GAL : public CAIRO_GAL_BASE, public wxWindow
 {
 public:
@@ -380,6 +413,12 @@ public:
 
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    virtual int BeginTiledDrawing( int aMaxTiles ) override;
+
+    virtual GAL* GetTile( int aIndex ) override;
+
+    virtual void EndTiledDrawing() override;
+
     /**
      * Function PostPaint
      * posts an event to m_paint_listener.  A post is used so that the actual drawing
@@ -426,6 +465,14 @@ protected:
     bool                isInitialized;          ///< Are Cairo image & surface ready to use
     COLOR4D             backgroundColor;        ///< Background color
 
+    // Variables related to the tiled drawing
+    std::vector<std::unique_ptr<CAIRO_TILE_GAL>> tiles; ///< GALs drawing the tiles
+    int                 tileCount;              ///< Number of tiles being drawn
+    cairo_surface_t*    tiledSurface;           ///< Surface drawn by the tiles
+
+    /// Minimal height of a tile, in pixels
+    static const int MIN_TILE_HEIGHT = 32;
+
     /// @copydoc GAL::BeginDrawing()
     virtual void beginDrawing() override;
 
@@ -31,6 +31,7 @@
 #include <stack>
 #include <limits>
 
+#include <math/box2.h>
 #include <math/matrix3x3.h>
 
 #include <gal/color4d.h>
@@ -46,6 +47,22 @@ class BITMAP_BASE;
 namespace KIGFX
 {
 
+/**
+ * @brief Measures of the work of a GAL for the last frame, for profiling.
+ *
+ * The times are in milliseconds, as seen by the CPU: the GPU may still be busy after them.
+ */
+struct GAL_FRAME_STATS
+{
+    double       m_uploadTime = 0.0;     ///< Upload of the cached vertices
+    double       m_compositeTime = 0.0;  ///< Drawing and composition of the targets
+    double       m_swapTime = 0.0;       ///< Display of the frame (buffer swap or blit)
+    int          m_groups = 0;           ///< Number of cached groups drawn
+    unsigned int m_cachedVertices = 0;   ///< Vertices stored in the cached target
+    unsigned int m_cachedCapacity = 0;   ///< Size of the storage of the cached target
+};
+
+
 /**
  * @brief Class GAL is the abstract interface for drawing on a 2D-surface.
  *
@@ -827,6 +844,58 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Returns true if SetRedrawArea() limits the drawing of the frame.
+     */
+    virtual bool IsRedrawAreaSupported() const { return false; };
+
+    /**
+     * @brief Limits the clearing and the drawing of the cached and noncached targets to an area
+     * of the screen, until the end of the current frame.
+     *
+     * The rest of these targets keeps the contents of the previous frame.
+     *
+     * @param aArea is the area to redraw, in screen pixels.
+     */
+    virtual void SetRedrawArea( const BOX2I& aArea ) {};
+
+    /**
+     * @brief Splits the current target in horizontal tiles, that can be drawn concurrently.
+     *
+     * Each tile is drawn by its own GAL, returned by GetTile().  This GAL must not be used
+     * until EndTiledDrawing() is called.
+     *
+     * @param aMaxTiles is the maximal number of tiles.
+     * @return the number of tiles, or 0 if the tiled drawing is not supported.
+     */
+    virtual int BeginTiledDrawing( int aMaxTiles ) { return 0; };
+
+    /**
+     * @brief Returns the GAL drawing a tile, between BeginTiledDrawing() and EndTiledDrawing().
+     *
+     * Its screen is the tile: its screen size and its world <-> screen matrices only cover
+     * the tile.
+     */
+    virtual GAL* GetTile( int aIndex ) { return nullptr; };
+
+    /**
+     * @brief Ends the drawing of the tiles, this GAL can be used again.
+     */
+    virtual void EndTiledDrawing() {};
+
+    /**
+     * @brief Returns the measures of the frames drawn since the last ResetFrameStats().
+     */
+    const GAL_FRAME_STATS& GetFrameStats() const
+    {
+        return frameStats;
+    }
+
+    void ResetFrameStats()
+    {
+        frameStats = GAL_FRAME_STATS();
+    }
+
     /**
      * @brief Sets negative draw mode in the renderer
      *
@@ -1096,6 +1165,9 @@ protected:
     /// Instance of object that stores information about how to draw texts
     STROKE_FONT        strokeFont;
 
+    /// Measures of the drawn frames, filled by the backends
+    GAL_FRAME_STATS    frameStats;
+
     /// Private: use GAL_CONTEXT_LOCKER RAII object
     virtual void lockContext( int aClientCookie ) {}
 
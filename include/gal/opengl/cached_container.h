@@ -82,6 +82,11 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     virtual void Unmap() override = 0;
 
+    /**
+     * Called once the draw commands reading the vertex buffer are issued.
+     */
+    virtual void DrawingFinished() {}
+
 protected:
     ///> Maps size of free memory chunks to their offsets
     typedef std::pair<unsigned int, unsigned int> CHUNK;
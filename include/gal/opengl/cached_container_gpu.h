@@ -56,6 +56,9 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     void Unmap() override;
 
+    ///> @copydoc CACHED_CONTAINER::DrawingFinished()
+    void DrawingFinished() override;
+
 protected:
     ///> Flag saying if vertex buffer is currently mapped
     bool m_isMapped;
@@ -66,6 +69,25 @@ protected:
     ///> Flag saying whether it is safe to use glCopyBufferSubData
     bool m_useCopyBuffer;
 
+    ///> Flag saying whether the buffer is mapped once for all (ARB_buffer_storage), instead of
+    ///> being mapped and unmapped around each update
+    bool m_usePersistentMap;
+
+    ///> The persistent mapping of the vertex buffer
+    VERTEX* m_persistentMapping;
+
+    ///> Signaled once the GPU is done with the last drawing from the persistent mapping
+    GLsync m_drawFence;
+
+    /**
+     * Allocates the immutable storage of the buffer bound to aTarget, and maps it persistently.
+     * @return the mapping, or NULL in case of failure
+     */
+    VERTEX* allocatePersistent( GLenum aTarget, unsigned int aSize );
+
+    ///> Waits until the GPU does not read the vertices anymore, before they are modified
+    void waitDrawFence();
+
     /**
      * Function defragmentResize()
      * removes empty spaces between chunks and optionally resizes the container.
@@ -26,7 +26,7 @@
 #define GPU_MANAGER_H_
 
 #include <gal/opengl/vertex_common.h>
-#include <boost/scoped_array.hpp>
+#include <vector>
 
 namespace KIGFX
 {
@@ -130,26 +130,14 @@ public:
     void Unmap();
 
 protected:
-    ///> Resizes the indices buffer to aNewSize if necessary
-    void resizeIndices( unsigned int aNewSize );
+    ///> First vertex and number of vertices of the ranges to draw.  The ranges which follow
+    ///> each other in the container are merged, as the items cached together usually are
+    ///> drawn together.
+    std::vector<GLint>   m_rangeFirsts;
+    std::vector<GLsizei> m_rangeCounts;
 
-    ///> Buffers initialization flag
-    bool m_buffersInitialized;
-
-    ///> Pointer to the current indices buffer
-    boost::scoped_array<GLuint> m_indices;
-
-    ///> Pointer to the first free cell in the indices buffer
-    GLuint* m_indicesPtr;
-
-    ///> Handle to indices buffer
-    GLuint  m_indicesBuffer;
-
-    ///> Number of indices stored in the indices buffer
+    ///> Number of vertices to draw
     unsigned int m_indicesSize;
-
-    ///> Current indices buffer size
-    unsigned int m_indicesCapacity;
 };
 
 
@@ -34,6 +34,7 @@
 #include <gal/compositor.h>
 #include <gal/opengl/antialiasing.h>
 #include <gal/gal_display_options.h>
+#include <math/box2.h>
 #include <GL/glew.h>
 #include <deque>
 
@@ -93,6 +94,17 @@ public:
 
     int GetAntialiasSupersamplingFactor() const;
 
+    /**
+     * Function SetClipArea()
+     * limits the clearing and the drawing to an area of the screen, until ResetClipArea() is
+     * called.  The area is scaled to the dimensions of each buffer, which are larger than the
+     * screen with supersampling.
+     * @param aArea is the area in screen pixels, with the Y axis pointing down.
+     */
+    void SetClipArea( const BOX2I& aArea );
+
+    void ResetClipArea();
+
 protected:
     // Buffers are simply textures storing a result of certain target rendering.
     typedef struct
@@ -115,11 +127,17 @@ protected:
     GLuint          m_curFbo;
 
     OPENGL_ANTIALIASING_MODE m_currentAntialiasingMode;
+
+    BOX2I           m_clipArea;               ///< Area the drawing is limited to, in screen pixels
+    bool            m_useClipArea;            ///< Is the drawing limited to m_clipArea?
     std::unique_ptr<OPENGL_PRESENTOR> m_antialiasing;
 
     /// Binds a specific Framebuffer Object.
     void bindFb( unsigned int aFb );
 
+    /// Sets the scissor box to the clip area, in the pixels of a buffer of aDimensions
+    void applyClipArea( const VECTOR2U& aDimensions );
+
     /**
      * Function clean()
      * performs freeing of resources.
@@ -39,6 +39,7 @@
 #include <gal/opengl/noncached_container.h>
 #include <gal/opengl/opengl_compositor.h>
 #include <gal/hidpi_gl_canvas.h>
+#include <memory_usage.h>
 
 #include <unordered_map>
 #include <boost/smart_ptr/shared_array.hpp>
@@ -228,6 +229,12 @@ public:
     /// @copydoc GAL::ClearTarget()
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    /// @copydoc GAL::IsRedrawAreaSupported()
+    virtual bool IsRedrawAreaSupported() const override;
+
+    /// @copydoc GAL::SetRedrawArea()
+    virtual void SetRedrawArea( const BOX2I& aArea ) override;
+
     /// @copydoc GAL::SetNegativeDrawMode()
     virtual void SetNegativeDrawMode( bool aSetting ) override {}
 
@@ -299,12 +306,15 @@ private:
     VERTEX_MANAGER*         cachedManager;          ///< Container for storing cached VERTEX_ITEMs
     VERTEX_MANAGER*         nonCachedManager;       ///< Container for storing non-cached VERTEX_ITEMs
     VERTEX_MANAGER*         overlayManager;         ///< Container for storing overlaid VERTEX_ITEMs
+    MEMORY_USAGE_PROVIDER   containersMemory;       ///< Memory used by the vertex containers
 
     // Framebuffer & compositing
     OPENGL_COMPOSITOR*      compositor;             ///< Handles multiple rendering targets
     unsigned int            mainBuffer;             ///< Main rendering target
     unsigned int            overlayBuffer;          ///< Auxiliary rendering target (for menus etc.)
     RENDER_TARGET           currentTarget;          ///< Current rendering target
+    BOX2I                   redrawArea;             ///< Area of the main buffer to redraw
+    bool                    isRedrawAreaSet;        ///< Is the redraw limited to redrawArea?
 
     // Shader
     SHADER*                 shader;                 ///< There is only one shader used for different objects
@@ -354,8 +364,10 @@ private:
      *
      * @param aStartPoint is the start point of the line.
      * @param aEndPoint is the end point of the line.
+     * @param aReserve is false if the 6 vertices of the quad are already reserved.
      */
-    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                       bool aReserve = true );
 
     /**
      * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
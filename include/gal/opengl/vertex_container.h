@@ -121,6 +121,15 @@ public:
         return m_currentSize;
     }
 
+    /**
+     * Function GetUsedSize()
+     * returns the number of vertices in use in the container.
+     */
+    unsigned int GetUsedSize() const
+    {
+        return usedSpace();
+    }
+
     /**
      * Returns information about the container cache state.
      * @return True in case the vertices have to be reuploaded.
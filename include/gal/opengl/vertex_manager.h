@@ -355,6 +355,18 @@ public:
      */
     void EnableDepthTest( bool aEnabled );
 
+    /**
+     * Function GetUsedSize()
+     * returns the number of vertices stored in the container.
+     */
+    unsigned int GetUsedSize() const;
+
+    /**
+     * Function GetSize()
+     * returns the size of the container, expressed in vertices.
+     */
+    unsigned int GetSize() const;
+
 protected:
     /**
      * Function putVertex()
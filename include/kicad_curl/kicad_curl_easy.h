@@ -126,6 +126,22 @@ public:
         return m_buffer;
     }
 
+    /**
+     * Function GetResponseCode
+     * returns the HTTP status code of the last response (e.g. 200, or 304 for a
+     * conditional request whose resource did not change), or 0 if there is none
+     */
+    long GetResponseCode();
+
+    /**
+     * Function GetResponseHeader
+     * returns the value of a header of the last response, or an empty string if the
+     * response has no such header.  After redirects, the last response is the final one.
+     *
+     * @param aName is the header name without the colon, matched without regard to case
+     */
+    std::string GetResponseHeader( const std::string& aName ) const;
+
     /// Escapes a string for use as a URL
     std::string Escape( const std::string& aUrl );
 
@@ -144,6 +160,7 @@ private:
     CURL*           m_CURL;
     curl_slist*     m_headers;
     std::string     m_buffer;
+    std::string     m_responseHeaders;  ///< the raw header lines of the last response
 };
 
 #endif // KICAD_CURL_EASY_H_
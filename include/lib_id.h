@@ -55,7 +55,11 @@ public:
     ///> Types of library identifiers
     enum LIB_ID_TYPE { ID_SCH, ID_PCB };
 
-    LIB_ID() {}
+    LIB_ID() :
+        nickname( &emptyString() ),
+        item_name( &emptyString() ),
+        revision( &emptyString() )
+    {}
 
     // NOTE: don't define any constructors which call Parse() on their arguments.  We want it
     // to be obvious to callers that parsing is involved (and that valid IDs are guaranteed in
@@ -96,7 +100,7 @@ public:
      */
     const UTF8& GetLibNickname() const
     {
-        return nickname;
+        return *nickname;
     }
 
     /**
@@ -111,14 +115,14 @@ public:
     /**
      * @return the library item name, i.e. footprintName, in UTF8.
      */
-    const UTF8& GetLibItemName() const { return item_name; }
+    const UTF8& GetLibItemName() const { return *item_name; }
 
     /**
      * @return the library item name, i.e. footprintName in a wxString (UTF16 or 32).
      * useful to display messages in dialogs
      * Equivalent to item_name.wx_str(), but more explicit when building a Unicode string in messages.
      */
-    const wxString GetUniStringLibItemName() const { return item_name.wx_str(); }
+    const wxString GetUniStringLibItemName() const { return item_name->wx_str(); }
 
     /**
      * Override the library item name portion of the LIB_ID to @a aLibItemName
@@ -131,7 +135,7 @@ public:
 
     int SetRevision( const UTF8& aRevision );
 
-    const UTF8& GetRevision() const { return revision; }
+    const UTF8& GetRevision() const { return *revision; }
 
     UTF8 GetLibItemNameAndRev() const;
 
@@ -168,12 +172,15 @@ public:
      * @note A return value of true does not indicated that the #LIB_ID is a valid #LIB_TABLE
      *       entry.
      */
-    bool IsValid() const { return !nickname.empty() && !item_name.empty(); }
+    bool IsValid() const { return !nickname->empty() && !item_name->empty(); }
 
     /**
      * @return true if the #LIB_ID only has the #item_name name defined.
      */
-    bool IsLegacy() const { return nickname.empty() && !item_name.empty() && revision.empty(); }
+    bool IsLegacy() const
+    {
+        return nickname->empty() && !item_name->empty() && revision->empty();
+    }
 
     /**
      * Clear the contents of the library nickname, library entry name, and revision strings.
@@ -183,7 +190,7 @@ public:
     /**
      * @return a boolean true value if the LIB_ID is empty.  Otherwise return false.
      */
-    bool empty() const { return nickname.empty() && item_name.empty() && revision.empty(); }
+    bool empty() const { return nickname->empty() && item_name->empty() && revision->empty(); }
 
     /**
      * Compare the contents of LIB_ID objects by performing a std::string comparison of the
@@ -197,7 +204,14 @@ public:
 
     bool operator < ( const LIB_ID& aLibId ) const { return this->compare( aLibId ) < 0; }
     bool operator > ( const LIB_ID& aLibId ) const { return this->compare( aLibId ) > 0; }
-    bool operator ==( const LIB_ID& aLibId ) const { return this->compare( aLibId ) == 0; }
+
+    ///> The strings are interned, so equal strings are the same object
+    bool operator ==( const LIB_ID& aLibId ) const
+    {
+        return nickname == aLibId.nickname && item_name == aLibId.item_name
+                && revision == aLibId.revision;
+    }
+
     bool operator !=( const LIB_ID& aLibId ) const { return !(*this == aLibId); }
 
     /**
@@ -262,9 +276,20 @@ protected:
      */
     static bool isLegalLibNicknameChar( unsigned aUniChar, LIB_ID_TYPE aType );
 
-    UTF8    nickname;       ///< The nickname of the library or empty.
-    UTF8    item_name;      ///< The name of the entry in the logical library.
-    UTF8    revision;       ///< The revision of the entry.
+    /**
+     * Return the unique copy of a string in the process-wide pool of the LIB_ID strings.
+     *
+     * The same nicknames and item names are used by many LIB_IDs, which share one copy of
+     * each.  The pooled strings are never freed.  This is thread safe.
+     */
+    static const UTF8* intern( const UTF8& aString );
+
+    ///> The pooled empty string
+    static const UTF8& emptyString();
+
+    const UTF8* nickname;       ///< The nickname of the library or empty.
+    const UTF8* item_name;      ///< The name of the entry in the logical library.
+    const UTF8* revision;       ///< The revision of the entry.
 };
 
 
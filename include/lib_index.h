@@ -0,0 +1,130 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_INDEX_H
+#define LIB_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include <utf8.h>
+#include <wx/string.h>
+
+
+/**
+ * An entry of a library index, as given to LIB_INDEX::Write().
+ */
+struct LIB_INDEX_ENTRY
+{
+    UTF8     m_Nickname;            ///< nickname of the library in its library table
+    UTF8     m_Name;                ///< footprint or symbol name
+    UTF8     m_Description;
+    UTF8     m_Keywords;
+    int      m_OrderNum = 0;
+    unsigned m_PadCount = 0;        ///< pads of a footprint, or pins of a symbol
+    unsigned m_UniquePadCount = 0;
+};
+
+
+/**
+ * Class LIB_INDEX
+ *
+ * A read only, memory mapped index of the items of the libraries of a library table: their
+ * names, descriptions, keywords and pad counts.  The lookup of an item by name is a binary
+ * search in the mapped file, so the tools which only need a few items (scripts, cvpcb) do
+ * not enumerate and parse the libraries, nor read the whole index.
+ *
+ * The index is written in one go by the application which loaded the libraries, to a
+ * temporary file renamed over the previous index, so any number of processes can map an
+ * index while it is replaced.  The timestamp of the library table is recorded in the
+ * index, for the readers to check it is current.
+ */
+class LIB_INDEX
+{
+public:
+    LIB_INDEX();
+    ~LIB_INDEX();
+
+    LIB_INDEX( const LIB_INDEX& ) = delete;
+    LIB_INDEX& operator=( const LIB_INDEX& ) = delete;
+
+    /**
+     * Function Write
+     * writes an index of aEntries to aFileName.
+     * @param aTimestamp is the timestamp of the library table the entries come from
+     * @return true if the index was written
+     */
+    static bool Write( const wxString& aFileName, std::vector<LIB_INDEX_ENTRY> aEntries,
+                       long long aTimestamp );
+
+    /**
+     * Function Open
+     * maps the index aFileName, after closing the previous one.
+     * @return false if the file is missing or is not a valid index
+     */
+    bool Open( const wxString& aFileName );
+
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+
+    ///> @return the timestamp of the library table given to Write()
+    long long GetTimestamp() const;
+
+    unsigned GetCount() const;
+
+    /**
+     * Function Find
+     * @return the index of the entry of the item aName of the library aNickname, or -1
+     */
+    int Find( const UTF8& aNickname, const UTF8& aName ) const;
+
+    ///> @return the range [aFirst, aLast) of the entries of the library aNickname
+    void FindLibrary( const UTF8& aNickname, int& aFirst, int& aLast ) const;
+
+    /**
+     * The entries, sorted by nickname then by name.  The strings point to the mapping and
+     * are valid until Close().
+     */
+    const char* GetNickname( unsigned aIdx ) const;
+    const char* GetName( unsigned aIdx ) const;
+    const char* GetDescription( unsigned aIdx ) const;
+    const char* GetKeywords( unsigned aIdx ) const;
+    int GetOrderNum( unsigned aIdx ) const;
+    unsigned GetPadCount( unsigned aIdx ) const;
+    unsigned GetUniquePadCount( unsigned aIdx ) const;
+
+private:
+    struct HEADER;
+    struct RECORD;
+
+    const RECORD* record( unsigned aIdx ) const;
+    const char* string( uint32_t aOffset ) const;
+
+    /// @return the first entry not lower than ( aNickname, aName ), with aName possibly NULL
+    unsigned lowerBound( const char* aNickname, const char* aName ) const;
+
+    const char* m_data;     ///< the mapped file, or NULL
+    size_t      m_size;
+};
+
+#endif  // LIB_INDEX_H
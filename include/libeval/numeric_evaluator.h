@@ -68,8 +68,10 @@ Supported units are millimeters (mm), Mil (mil) and inch (")
 #define NUMERIC_EVALUATOR_H_
 
 #include <cstddef>
+#include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <base_units.h>
 
@@ -118,6 +120,10 @@ public:
     /* Evaluate input string.
      * Result can be retrieved by result().
      * Returns true if input string could be evaluated, otherwise false.
+     *
+     * The input strings are compiled once: the tokens of the last strings are kept to evaluate
+     * them again, with the current values of the variables.  The result of the strings which
+     * do not refer to variables is kept too.
      */
     bool Process( const wxString& aString );
 
@@ -144,9 +150,23 @@ protected:
         numEval::TokenType value;
     };
 
+    /* The compiled form of an input string */
+    struct CompiledExpr
+    {
+        std::vector<Token> tokens;          // up to the end of the input (ENDS)
+        bool        tokenError = false;     // the input holds an invalid character
+        bool        hasVars = false;        // the result depends on the variables
+        bool        evaluated = false;      // the result below is known (if !hasVars)
+        bool        resultValid = false;
+        std::string result;
+    };
+
     /* Begin processing of a new input string */
     void newString( const wxString& aString );
 
+    /* Tokenize the input string set by newString(), or find its tokens in the cache. */
+    CompiledExpr& compile( const wxString& aString );
+
     /* Tokenizer: Next token/value taken from input string. */
     Token getToken();
 
@@ -179,6 +199,13 @@ private:
     wxString m_originalText;
 
     std::map<wxString, double> m_varMap;
+
+    /* The compiled input strings, the most recently used first */
+    enum { CacheSize = 64 };
+    typedef std::list<std::pair<wxString, CompiledExpr>> CompiledList;
+
+    CompiledList                               m_cache;
+    std::map<wxString, CompiledList::iterator> m_cacheIndex;
 };
 
 
@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_usage.h
+ * @brief Accounting of the memory used by the subsystems of the applications.
+ */
+
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Class MEMORY_USAGE
+ *
+ * The registry of the memory used by the subsystems.  The owners of large data structures
+ * register a provider which returns the bytes they currently hold, under a category such as
+ * "Zone fills"; the providers are only called by Report(), so the accounting costs nothing
+ * while the application runs.
+ *
+ * The bytes are estimates computed from the sizes of the containers, which do not include the
+ * overhead of the allocator.
+ */
+class MEMORY_USAGE
+{
+public:
+    typedef std::function<size_t()> PROVIDER;
+
+    ///> A category and its bytes, as reported by Report()
+    typedef std::pair<std::string, size_t> ENTRY;
+
+    static MEMORY_USAGE& Get();
+
+    /**
+     * Adds a provider of the bytes used in aCategory.
+     * @return the id to pass to Unregister() before the data of the provider is destroyed
+     */
+    int Register( const std::string& aCategory, PROVIDER aProvider );
+
+    void Unregister( int aId );
+
+    /**
+     * @return the bytes of each category, summed over its providers, in the order in which
+     * the categories were first registered.
+     */
+    std::vector<ENTRY> Report() const;
+
+    /**
+     * @return the report as text, a line per category followed by the total.
+     */
+    std::string Format() const;
+
+    ///> @return aBytes as a human readable size ("12.3 MB")
+    static std::string FormatBytes( size_t aBytes );
+
+private:
+    MEMORY_USAGE() :
+            m_nextId( 0 )
+    {
+    }
+
+    struct ITEM
+    {
+        std::string m_Category;
+        PROVIDER    m_Provider;
+    };
+
+    mutable std::mutex       m_lock;
+    std::map<int, ITEM>      m_providers;
+    std::vector<std::string> m_categories;     ///< in the order of their registration
+    int                      m_nextId;
+};
+
+
+/**
+ * Class MEMORY_USAGE_PROVIDER
+ *
+ * Registers a provider for the lifetime of the object.  It is usually a member of the class
+ * owning the data, declared after the data so that it is unregistered first.
+ */
+class MEMORY_USAGE_PROVIDER
+{
+public:
+    MEMORY_USAGE_PROVIDER() :
+            m_id( -1 )
+    {
+    }
+
+    MEMORY_USAGE_PROVIDER( const std::string& aCategory, MEMORY_USAGE::PROVIDER aProvider ) :
+            m_id( MEMORY_USAGE::Get().Register( aCategory, std::move( aProvider ) ) )
+    {
+    }
+
+    ~MEMORY_USAGE_PROVIDER()
+    {
+        Reset();
+    }
+
+    MEMORY_USAGE_PROVIDER( const MEMORY_USAGE_PROVIDER& ) = delete;
+    MEMORY_USAGE_PROVIDER& operator=( const MEMORY_USAGE_PROVIDER& ) = delete;
+
+    ///> Replaces the provider held by this object, if any
+    void Set( const std::string& aCategory, MEMORY_USAGE::PROVIDER aProvider )
+    {
+        Reset();
+        m_id = MEMORY_USAGE::Get().Register( aCategory, std::move( aProvider ) );
+    }
+
+    void Reset()
+    {
+        if( m_id >= 0 )
+            MEMORY_USAGE::Get().Unregister( m_id );
+
+        m_id = -1;
+    }
+
+private:
+    int m_id;
+};
+
+#endif // MEMORY_USAGE_H
@@ -236,6 +236,20 @@ public:
         return false;
     }
 
+    /**
+     * Function IsTransparentLayer
+     * Returns true if all the items of a layer are drawn fully transparent, in any display mode,
+     * so the layer can be skipped when drawing.  The items brightened as selection
+     * candidates are skipped with their layer.
+     * The default implementation returns false, for the painters which draw items with
+     * colors of their own.
+     * @param aLayer is the layer number.
+     */
+    virtual bool IsTransparentLayer( int aLayer ) const
+    {
+        return false;
+    }
+
     /**
      * Set line width used for drawing outlines.
      *
@@ -254,6 +268,13 @@ protected:
      */
     virtual void update();
 
+    /**
+     * Function isLayerColorTransparent
+     * Returns true if all the colors of a layer (normal, highlighted, selected, darkened and
+     * high contrast) are fully transparent.
+     */
+    bool isLayerColorTransparent( int aLayer ) const;
+
     std::set<unsigned int> m_activeLayers; ///< Stores active layers number
 
     ///> Colors for all layers (normal)
@@ -354,6 +375,19 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a copy of this painter, with the same settings, drawing on another GAL.
+     * The copies are used to draw items on several threads, so Draw() must only read the
+     * items and the settings.
+     * @param aGal is the GAL used by the copy.
+     * @return the copy, owned by the caller, or nullptr if the painter cannot be copied.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -116,6 +116,12 @@ public:
      */
     virtual void Update3DView( bool aForceReload, const wxString* aTitle = nullptr );
 
+    /**
+     * Update only the given layers of the 3D view, if the viewer is opened by this frame.
+     * The 3D view is rebuilt at its next refresh.
+     */
+    void Update3DLayers( const LSET& aLayers );
+
     /**
      * Function LoadFootprint
      * attempts to load \a aFootprintId from the footprint library table.
@@ -274,6 +280,20 @@ public:
      */
     virtual void OnModify();
 
+    /**
+     * Called instead of OnModify() by BOARD_COMMIT::Push(), with the layers of the changed
+     * items, before and after the change.
+     */
+    virtual void OnModifyLayers( const LSET& aChangedLayers ) { OnModify(); }
+
+    /**
+     * Called by BOARD_COMMIT::Push() once a change has been applied to the board.
+     *
+     * @param aDirtyAreas are the bounding boxes of the changed items, before and after the
+     *                    change.
+     */
+    virtual void OnBoardItemsChanged( const std::vector<EDA_RECT>& aDirtyAreas ) {}
+
     // Modules (footprints)
 
     /**
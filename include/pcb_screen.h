@@ -32,6 +32,7 @@
 
 #include <base_screen.h>
 #include <class_board_item.h>
+#include <memory_usage.h>
 
 
 class UNDO_REDO_CONTAINER;
@@ -75,6 +76,9 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) override;
+
+private:
+    MEMORY_USAGE_PROVIDER m_undoMemory;     ///< the memory of the undo and redo commands
 };
 
 #endif  // PCB_SCREEN_H
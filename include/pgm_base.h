@@ -32,8 +32,11 @@
 #define  PGM_BASE_H_
 
 #include <bitmaps_png/bitmap_def.h>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <search_stack.h>
 #include <wx/filename.h>
 #include <wx/gdicmn.h>
@@ -307,6 +310,21 @@ public:
      */
     VTBL_ENTRY wxApp&   App();
 
+    /**
+     * Function AddStartupPhase
+     * records the duration of a phase of the startup of the program or of one of its kifaces
+     * (see SCOPED_STARTUP_PHASE), to be called from the main thread.
+     */
+    VTBL_ENTRY void AddStartupPhase( const wxString& aName, int64_t aMicroseconds );
+
+    /**
+     * Function ReportStartupPhases
+     * logs the startup phases recorded so far and the time elapsed since the program started
+     * under the "KICAD_STARTUP" trace mask.  It is called once the first frame is shown; the
+     * phases which end later, like the loading of the Python plugins, are logged alone.
+     */
+    VTBL_ENTRY void ReportStartupPhases() const;
+
     //----</Cross Module API>----------------------------------------------------
 
     static const wxChar workingDirKey[];
@@ -385,9 +403,43 @@ protected:
 
     /// Flag to indicate if the environment variable overwrite warning dialog should be shown.
     bool            m_show_env_var_dialog;
+
+    /// The time of the construction of the program, in microseconds
+    int64_t         m_startTime;
+
+    /// The names and durations in microseconds of the startup phases, as they ended
+    std::vector<std::pair<wxString, int64_t>> m_startupPhases;
 };
 
 
+#ifndef SWIG
+/**
+ * Class SCOPED_STARTUP_PHASE
+ * records the time spent in its scope as a startup phase of aProgram, if it is not null:
+ *
+ *     {
+ *         SCOPED_STARTUP_PHASE phase( aProgram, wxT( "Global footprint library table" ) );
+ *         ...
+ *     }
+ */
+class SCOPED_STARTUP_PHASE
+{
+public:
+    SCOPED_STARTUP_PHASE( PGM_BASE* aProgram, const wxString& aName );
+
+    ~SCOPED_STARTUP_PHASE();
+
+    SCOPED_STARTUP_PHASE( const SCOPED_STARTUP_PHASE& ) = delete;
+    SCOPED_STARTUP_PHASE& operator=( const SCOPED_STARTUP_PHASE& ) = delete;
+
+private:
+    PGM_BASE* m_program;
+    wxString  m_name;
+    int64_t   m_start;
+};
+#endif
+
+
 /// The global Program "get" accessor.
 /// Implemented in: 1) common/single_top.cpp,  2) kicad/kicad.cpp, and 3) scripting/kiway.i
 extern PGM_BASE& Pgm();
@@ -32,6 +32,7 @@
 #ifndef PLOT_COMMON_H_
 #define PLOT_COMMON_H_
 
+#include <memory>
 #include <vector>
 #include <math/box2.h>
 #include <gr_text.h>
@@ -42,6 +43,7 @@ class COLOR_SETTINGS;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
 class GBR_NETLIST_METADATA;
+struct PDF_STREAM_JOB;
 
 /**
  * Enum PlotFormat
@@ -496,8 +498,43 @@ public:
      */
     virtual void EndBlock( void* aData ) {}
 
+    /**
+     * @return true if the plotter can define a group of items once and place it several
+     * times (see StartBlockDefinition()).  Only SVG and PDF can.
+     */
+    virtual bool CanReuseBlocks() const { return false; }
+
+    /**
+     * Start the definition of a group of items plotted once, and placed several times by
+     * PlaceBlockDefinition().  The items plotted up to EndBlockDefinition() go in the
+     * definition, not on the page.  Definitions cannot be nested.
+     * @return the id of the definition, or -1 if the plotter cannot reuse blocks
+     */
+    virtual int StartBlockDefinition() { return -1; }
+
+    /**
+     * Close the block definition started by StartBlockDefinition()
+     */
+    virtual void EndBlockDefinition() {}
+
+    /**
+     * Place an instance of a block definition.
+     * @param aId is the id returned by StartBlockDefinition()
+     * @param aPos is the position of the point (0,0) of the definition
+     * @param aOrient is the rotation of the definition around aPos, in 0.1 degrees
+     */
+    virtual void PlaceBlockDefinition( int aId, const wxPoint& aPos, double aOrient ) {}
+
 
 protected:
+    /**
+     * Compute the transform, in device coordinates, of a block definition placed at aPos
+     * with the orientation aOrient (see PlaceBlockDefinition())
+     * @param aMatrix receives the transform as in SVG and PDF: x' = a*x + c*y + e,
+     * y' = b*x + d*y + f for {a, b, c, d, e, f}
+     */
+    void blockPlacementMatrix( const wxPoint& aPos, double aOrient, double aMatrix[6] );
+
     // These are marker subcomponents
     /**
      * Plot a circle centered on the position. Building block for markers
@@ -861,11 +898,12 @@ protected:
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
-    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL )
+    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL ), m_pageWorkFile( NULL )
     {
         // Avoid non initialized variables:
         pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
         pageTreeHandle = 0;
+        m_pageStreamLengthHandle = 0;
     }
 
     virtual PLOT_FORMAT GetPlotterType() const override
@@ -928,6 +966,14 @@ public:
     virtual void PlotImage( const wxImage& aImage, const wxPoint& aPos,
                             double aScaleFactor ) override;
 
+    /**
+     * Block definitions are Form XObjects, usable by all the pages of the document
+     */
+    virtual bool CanReuseBlocks() const override { return true; }
+    virtual int StartBlockDefinition() override;
+    virtual void EndBlockDefinition() override;
+    virtual void PlaceBlockDefinition( int aId, const wxPoint& aPos, double aOrient ) override;
+
 
 protected:
     virtual void emitSetRGBColor( double r, double g, double b ) override;
@@ -935,7 +981,8 @@ protected:
     int startPdfObject(int handle = -1);
     void closePdfObject();
     int startPdfStream(int handle = -1);
-    void closePdfStream();
+    void closePdfStream( int handle, const std::string& aDict = std::string() );
+    void writePdfStreams( bool aWaitAll );
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
@@ -944,6 +991,14 @@ protected:
     wxString workFilename;
     FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
     std::vector<long> xrefTable; /// The PDF xref offset table
+
+    /// The closed page streams, being compressed by the thread pool and not yet written
+    std::vector<std::shared_ptr<PDF_STREAM_JOB>> m_pendingStreams;
+
+    std::vector<int> m_blockHandles;    /// The Form XObjects of the block definitions
+    FILE*    m_pageWorkFile;            /// The page stream, during a block definition
+    wxString m_pageWorkFilename;
+    int      m_pageStreamLengthHandle;
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
@@ -1005,6 +1060,14 @@ public:
      */
     virtual void EndBlock( void* aData ) override;
 
+    /**
+     * Block definitions are SVG groups in a <defs> element, placed by <use> elements
+     */
+    virtual bool CanReuseBlocks() const override { return true; }
+    virtual int StartBlockDefinition() override;
+    virtual void EndBlockDefinition() override;
+    virtual void PlaceBlockDefinition( int aId, const wxPoint& aPos, double aOrient ) override;
+
     virtual void Text( const wxPoint&              aPos,
                        const COLOR4D               aColor,
                        const wxString&             aText,
@@ -1019,6 +1082,7 @@ public:
                        void* aData = NULL ) override;
 
 protected:
+    int    m_blockDefinitionCount;  // the number of block definitions, to give them an id
     FILL_T m_fillMode;              // true if the current contour
                                     // rect, arc, circle, polygon must be filled
     long m_pen_rgb_color;           // current rgb color value: each color has
@@ -1175,6 +1239,19 @@ public:
      */
     virtual bool StartPlot() override;
     virtual bool EndPlot() override;
+
+    /**
+     * Plot in memory instead of a file.  To be called instead of OpenFile().
+     * The Gerber data is available from GetGerberData() after EndPlot(), for a preview
+     * or a comparison without any temporary file.
+     */
+    void OpenMemory();
+
+    /**
+     * @return the Gerber data of a plot made in memory (see OpenMemory())
+     */
+    const std::string& GetGerberData() const { return m_gbrData; }
+
     virtual void SetCurrentLineWidth( int width, void* aData = NULL ) override;
     virtual void SetDefaultLineWidth( int width ) override;
 
@@ -1375,6 +1452,24 @@ protected:
      */
     void emitDcode( const DPOINT& pt, int dcode );
 
+    /**
+     * Append some text to the Gerber data.  The output is buffered in memory and written
+     * in one go by EndPlot(), so there is no stdio call for each record.
+     */
+    void emit( const char* aText ) { m_gbrData += aText; }
+    void emit( const std::string& aText ) { m_gbrData += aText; }
+
+    /**
+     * Append a printf formatted text to the Gerber data.
+     * Used for the seldom records only: coordinates are formatted by emitInt()
+     */
+    void emitf( const char* aFormat, ... );
+
+    /**
+     * Append an integer to the Gerber data, like the "%d" format but much faster
+     */
+    void emitInt( int aValue );
+
     /**
      * print a Gerber net attribute object record.
      * In a gerber file, a net attribute is owned by a graphic object
@@ -1403,9 +1498,9 @@ protected:
     // The last aperture attribute generated (only one aperture attribute can be set)
     int           m_apertureAttribute;
 
-    FILE* workFile;
-    FILE* finalFile;
-    wxString m_workFilename;
+    bool        m_outputToMemory;   // true to keep the plot in m_gbrData (see OpenMemory())
+    std::string m_gbrData;          // the Gerber data, built in memory up to EndPlot()
+    size_t      m_apertureListPos;  // the offset of the aperture list in m_gbrData
 
     /**
      * Generate the table of D codes
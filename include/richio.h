@@ -29,6 +29,7 @@
 // "richio" after its author, Richard Hollenbeck, aka Dick Hollenbeck.
 
 
+#include <memory>
 #include <vector>
 #include <utf8.h>
 
@@ -39,6 +40,11 @@
 
 #include <ki_exception.h>
 
+class wxFFileInputStream;
+class wxFFileOutputStream;
+class wxZlibInputStream;
+class wxZlibOutputStream;
+
 
 /**
  * Function StrPrintf
@@ -247,6 +253,70 @@ public:
 };
 
 
+/**
+ * MMAP_LINE_READER
+ * is a LINE_READER that maps a whole file in memory and hands out its lines in place,
+ * instead of copying them to a line buffer.  The mapping is private, so the lines may be
+ * modified like the ones of the other readers, without changing the file.
+ * <p>
+ * The lines are not copied, but they still end with a nul: the first byte of the next line
+ * is replaced by a nul until the next ReadLine().  The file content is not translated, so a
+ * line may end with "\r\n".
+ */
+class MMAP_LINE_READER : public LINE_READER
+{
+protected:
+    char*   m_data;         ///< the mapped file, or NULL if it is empty
+    size_t  m_size;         ///< no. bytes in the file
+    size_t  m_next;         ///< offset of the next line in the mapping
+
+    char*   m_buffer;       ///< the line buffer of LINE_READER, used for the last line
+    bool    m_terminated;   ///< true if the byte at m_next was replaced by a nul
+    char    m_nextChar;     ///< the replaced byte
+
+    /// Puts back the byte replaced by the terminating nul of the current line
+    void    restoreNext()
+    {
+        if( m_terminated )
+        {
+            m_data[m_next] = m_nextChar;
+            m_terminated = false;
+        }
+    }
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * maps the file @a aFileName, closed once mapped.
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the greatest length of a line.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or mapped.
+     */
+    MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MMAP_LINE_READER();
+
+    char* ReadLine() override;
+
+    /**
+     * Function Rewind
+     * goes back to the beginning of the file and resets the line number back to zero.
+     */
+    void Rewind()
+    {
+        restoreNext();
+        m_next = 0;
+        m_lineNum = 0;
+    }
+};
+
+
 /**
  * STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -306,7 +376,58 @@ public:
 };
 
 
+/**
+ * GZIP_LINE_READER
+ * is a LINE_READER that reads a gzip compressed file.  The file is read and inflated by
+ * blocks while the lines are read, so the memory used does not depend on the file size.
+ */
+class GZIP_LINE_READER : public LINE_READER
+{
+protected:
+    std::unique_ptr<wxFFileInputStream> m_file;
+    std::unique_ptr<wxZlibInputStream>  m_stream;
+
+    std::vector<char>   m_block;        ///< the last inflated block
+    size_t              m_blockNext;    ///< offset in m_block of the next line
+    size_t              m_blockEnd;     ///< no. bytes in m_block
+
+    /// Inflates the next block, returns false at the end of the file
+    bool    readBlock();
+
+public:
+
+    /**
+     * Constructor GZIP_LINE_READER
+     * opens the gzip file @a aFileName.
+     *
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the greatest length of a line.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    GZIP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~GZIP_LINE_READER();
+
+    /**
+     * Function ReadLine
+     * @throw IO_ERROR also if the compressed data is corrupted.
+     */
+    char* ReadLine() override;
+
+    /**
+     * Function IsGzipFile
+     * @return true if the file @a aFileName starts with the gzip magic bytes.
+     */
+    static bool IsGzipFile( const wxString& aFileName );
+};
+
+
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define FILE_OUTPUTFMTBUFZ  ( 1 << 20 ) ///< size of the write buffer of FILE_OUTPUTFORMATTER
 
 /**
  * OUTPUTFORMATTER
@@ -513,8 +634,13 @@ protected:
     void write( const char* aOutBuf, int aCount ) override;
     //-----</OUTPUTFORMATTER>-----------------------------------------------
 
-    FILE*       m_fp;               ///< takes ownership
-    wxString    m_filename;
+    ///> Writes the pending text to the file, returns false on error
+    bool flushPending();
+
+    FILE*               m_fp;               ///< takes ownership
+    wxString            m_filename;
+    std::vector<char>   m_pending;          ///< text not yet written to m_fp
+    size_t              m_pendingCount;
 };
 
 
@@ -545,4 +671,45 @@ protected:
     //-----</OUTPUTFORMATTER>-----------------------------------------------
 };
 
+
+/**
+ * GZIP_OUTPUTFORMATTER
+ * may be used for gzip compressed text file output.  The text is deflated by blocks
+ * while it is written, so the memory used does not depend on the file size.
+ */
+class GZIP_OUTPUTFORMATTER : public OUTPUTFORMATTER
+{
+public:
+
+    /**
+     * Constructor
+     * @param aFileName is the full filename to create and save to.
+     * @param aQuoteChar is a char used for quoting problematic strings
+            (with whitespace or special characters in them).
+     * @throw IO_ERROR if the file cannot be created.
+     */
+    GZIP_OUTPUTFORMATTER( const wxString& aFileName, char aQuoteChar = '"' );
+
+    ~GZIP_OUTPUTFORMATTER();
+
+    /**
+     * Function IsGzipFileName
+     * @return true if @a aFileName has the ".gz" extension of the gzip files.
+     */
+    static bool IsGzipFileName( const wxString& aFileName );
+
+protected:
+    //-----<OUTPUTFORMATTER>------------------------------------------------
+    void write( const char* aOutBuf, int aCount ) override;
+    //-----</OUTPUTFORMATTER>-----------------------------------------------
+
+    ///> Deflates the pending text to the file, returns false on error
+    bool flushPending();
+
+    std::unique_ptr<wxFFileOutputStream>    m_file;
+    std::unique_ptr<wxZlibOutputStream>     m_stream;
+    std::vector<char>                       m_pending;  ///< text not yet deflated
+    size_t                                  m_pendingCount;
+};
+
 #endif // RICHIO_H_
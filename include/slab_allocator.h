@@ -0,0 +1,77 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file slab_allocator.h
+ * @brief Allocation of the small objects created in large numbers from slabs.
+ */
+
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <cstddef>
+
+
+/**
+ * Class SLAB_ALLOCATOR
+ *
+ * Allocates the objects of up to MAX_SIZE bytes from large slabs, split in slots of the
+ * same size: the objects of a size are packed together instead of being spread over the
+ * heap, without the header of each block of the system allocator, and they are allocated
+ * and freed by popping and pushing a free list.
+ *
+ * Each thread keeps its own free slots, so the threads only share a lock when their lists
+ * run out or grow too long.  The freed slots are kept for the next objects of their size:
+ * the slabs are never given back to the system.
+ *
+ * The classes allocated this way use it from their operator new and operator delete, which
+ * must be the sized version so that the slot of an object is found from its size:
+ *
+ *     static void* operator new( size_t aSize ) { return SLAB_ALLOCATOR::Allocate( aSize ); }
+ *     static void  operator delete( void* aPtr, size_t aSize )
+ *     {
+ *         SLAB_ALLOCATOR::Free( aPtr, aSize );
+ *     }
+ *
+ * The objects are allocated by the system allocator when KiCad is built for the memory
+ * debuggers (KICAD_SANITIZE or KICAD_USE_VALGRIND), to keep their checks.
+ */
+class SLAB_ALLOCATOR
+{
+public:
+    static void* Allocate( size_t aSize );
+
+    ///> Frees an object of aSize bytes returned by Allocate( aSize )
+    static void Free( void* aPtr, size_t aSize );
+
+    ///> @return the bytes of the slabs which are not used by an object
+    static size_t FreeBytes();
+
+    ///> The objects are rounded up to a multiple of this size, which is also their alignment
+    static const size_t GRANULARITY = 16;
+
+    ///> The larger objects are allocated by the system allocator
+    static const size_t MAX_SIZE = 2048;
+};
+
+#endif // SLAB_ALLOCATOR_H
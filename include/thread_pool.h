@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PROGRESS_REPORTER;
+
+
+/**
+ * The queued tasks of the interactive priority run before the background ones (like the
+ * loading of the 3D models), so that a background job does not delay the response to the
+ * user.  A running task is never interrupted.
+ */
+enum class TASK_PRIORITY
+{
+    INTERACTIVE,
+    BACKGROUND
+};
+
+
+/**
+ * Class THREAD_POOL
+ *
+ * A pool of worker threads started once and kept for the whole session, so that the short
+ * parallel jobs (like the update of a few ratsnest nets after an edit) do not pay for the
+ * creation of their threads, and the parallel jobs of the application share the cores instead
+ * of each one starting a thread per core.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @param aThreadCount is the number of worker threads, or 0 for one per hardware thread
+     */
+    THREAD_POOL( unsigned aThreadCount = 0 );
+
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    unsigned GetThreadCount() const
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * Function Submit
+     * queues a task for the worker threads.
+     * @return the future of the task, which rethrows its exception if any
+     */
+    std::future<void> Submit( std::function<void()> aTask,
+                              TASK_PRIORITY aPriority = TASK_PRIORITY::INTERACTIVE );
+
+    /**
+     * Function RunParallel
+     * calls aWork on up to aParallelism threads, the calling thread being one of them, and
+     * returns once all the calls are done.  The calls are expected to share the work, usually
+     * through an atomic index.
+     * While it waits, the calling thread runs the queued tasks, so this may be called from a
+     * task of the pool.
+     */
+    void RunParallel( const std::function<void()>& aWork, unsigned aParallelism,
+                      TASK_PRIORITY aPriority = TASK_PRIORITY::INTERACTIVE );
+
+private:
+    friend class TASK_GROUP;
+
+    typedef std::shared_ptr<std::packaged_task<void()>> TASK;
+
+    ///> Runs a queued task, if any.  @return true if a task was run
+    bool runPendingTask();
+
+    ///> @return the next task to run, the m_lock being held; there must be one
+    TASK popTask();
+
+    bool hasTasks() const
+    {
+        return !m_tasks.empty() || !m_backgroundTasks.empty();
+    }
+
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<TASK>         m_tasks;
+    std::deque<TASK>         m_backgroundTasks;
+    std::mutex               m_lock;
+    std::condition_variable  m_wakeUp;
+    bool                     m_stopping;
+};
+
+
+/**
+ * Function GetKiCadThreadPool
+ * @return the thread pool shared by the whole application
+ */
+THREAD_POOL& GetKiCadThreadPool();
+
+
+/**
+ * Class TASK_GROUP
+ *
+ * A set of tasks queued on a THREAD_POOL and waited for together.  The group can be cancelled:
+ * its tasks which did not start yet are skipped, and the running ones can poll IsCancelled()
+ * to stop early.
+ */
+class TASK_GROUP
+{
+public:
+    TASK_GROUP( TASK_PRIORITY aPriority = TASK_PRIORITY::INTERACTIVE,
+                THREAD_POOL& aPool = GetKiCadThreadPool() );
+
+    ///> Waits for the tasks still running, ignoring their exceptions
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    void Run( std::function<void()> aTask );
+
+    /**
+     * Function RunParallel
+     * queues aWork for up to aParallelism threads of the pool.  The calls are expected to
+     * share the work, usually through an atomic index (see THREAD_POOL::RunParallel()).
+     */
+    void RunParallel( const std::function<void()>& aWork, unsigned aParallelism );
+
+    void Cancel()
+    {
+        m_cancelled = true;
+    }
+
+    bool IsCancelled() const
+    {
+        return m_cancelled;
+    }
+
+    /**
+     * Function Wait
+     * returns once all the tasks are done, rethrowing the first exception of the tasks.
+     *
+     * With a progress reporter or a refresh function, which are called on the calling thread
+     * about every 100 ms, the group is cancelled when the user aborts the reporter.  Else the
+     * calling thread runs the queued tasks while it waits, so this may be called from a task
+     * of the pool.
+     */
+    void Wait( PROGRESS_REPORTER* aReporter = nullptr,
+               const std::function<void()>& aOnRefresh = nullptr );
+
+private:
+    THREAD_POOL&                   m_pool;
+    TASK_PRIORITY                  m_priority;
+    std::vector<std::future<void>> m_tasks;
+    std::atomic<bool>              m_cancelled;
+};
+
+#endif // THREAD_POOL_H
@@ -37,6 +37,7 @@
 #include <libcontext.h>
 #include <memory>
 #include <advanced_config.h>
+#include <tool/coroutine_stack_pool.h>
 
 /**
  *  Class COROUNTINE.
@@ -161,6 +162,7 @@ public:
 #ifdef KICAD_USE_VALGRIND
         VALGRIND_STACK_DEREGISTER( valgrind_stack );
 #endif
+        COROUTINE_STACK_POOL::Get().Release( m_stack );
     }
 
 public:
@@ -298,23 +300,24 @@ private:
 
         m_args = &aArgs;
 
-        assert( m_stack == nullptr );
+        assert( m_stack.m_Base == nullptr );
 
         size_t stackSize = m_stacksize;
         void* sp = nullptr;
 
         #ifndef LIBCONTEXT_HAS_OWN_STACK
-        // fixme: Clean up stack stuff. Add a guard
-        m_stack.reset( new char[stackSize] );
+        // The stacks come from a pool, with a guard page below them
+        m_stack = COROUTINE_STACK_POOL::Get().Acquire( stackSize );
+        stackSize = m_stack.m_Size;
 
         // align to 16 bytes
-        sp = (void*)((((ptrdiff_t) m_stack.get()) + stackSize - 0xf) & (~0x0f));
+        sp = (void*)((((ptrdiff_t) m_stack.m_Base) + stackSize - 0xf) & (~0x0f));
 
         // correct the stack size
-        stackSize -= size_t( ( (ptrdiff_t) m_stack.get() + stackSize ) - (ptrdiff_t) sp );
+        stackSize -= size_t( ( (ptrdiff_t) m_stack.m_Base + stackSize ) - (ptrdiff_t) sp );
 
 #ifdef KICAD_USE_VALGRIND
-        valgrind_stack = VALGRIND_STACK_REGISTER( sp, m_stack.get() );
+        valgrind_stack = VALGRIND_STACK_REGISTER( sp, m_stack.m_Base );
 #endif
         #endif
 
@@ -376,8 +379,8 @@ private:
         }
     }
 
-    ///< coroutine stack
-    std::unique_ptr<char[]> m_stack;
+    ///< coroutine stack, from COROUTINE_STACK_POOL
+    COROUTINE_STACK_POOL::STACK m_stack;
 
     int m_stacksize;
 
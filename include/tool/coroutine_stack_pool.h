@@ -0,0 +1,92 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __COROUTINE_STACK_POOL_H
+#define __COROUTINE_STACK_POOL_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Class COROUTINE_STACK_POOL
+ *
+ * Keeps the stacks of the finished coroutines for the next ones, instead of allocating and
+ * freeing a large block each time a tool is invoked.  The stacks are mapped from the system
+ * with a guard page below them, where supported, so that a stack overflow faults instead of
+ * silently corrupting the heap.
+ *
+ * The peak usage of the stacks is measured when the trace mask "KICAD_COROUTINE_STACK" is
+ * enabled, to tune the stack size (ADVANCED_CFG::m_coroutineStackSize) on real data.
+ */
+class COROUTINE_STACK_POOL
+{
+public:
+    struct STACK
+    {
+        char*  m_Base = nullptr;    ///< lowest usable address
+        size_t m_Size = 0;          ///< usable size, without the guard page
+    };
+
+    static COROUTINE_STACK_POOL& Get();
+
+    ~COROUTINE_STACK_POOL();
+
+    /**
+     * @return a stack of at least aSize bytes, from the free list of this size if possible.
+     */
+    STACK Acquire( size_t aSize );
+
+    /**
+     * Gives back a stack returned by Acquire(), which must not be in use anymore.
+     */
+    void Release( const STACK& aStack );
+
+    /**
+     * @return the largest stack usage measured, in bytes (only measured when traced).
+     */
+    size_t GetPeakUsage() const
+    {
+        return m_peakUsage;
+    }
+
+private:
+    COROUTINE_STACK_POOL();
+
+    ///> @return the bytes of aStack which have ever been written to
+    static size_t measureUsage( const STACK& aStack );
+
+    STACK allocate( size_t aSize );
+    void  deallocate( const STACK& aStack );
+
+    ///> The free stacks kept for each size; the others are given back to the system
+    static const size_t MAX_FREE_STACKS = 8;
+
+    std::mutex                              m_mutex;
+    std::map<size_t, std::vector<STACK>>    m_freeStacks;
+    size_t                                  m_pageSize;
+    size_t                                  m_peakUsage;
+};
+
+#endif
@@ -26,8 +26,11 @@
 #ifndef SELECTION_H
 #define SELECTION_H
 
+#include <algorithm>
 #include <core/optional.h>
 #include <deque>
+#include <set>
+#include <vector>
 #include <eda_rect.h>
 #include <base_struct.h>
 #include <view/view_group.h>
@@ -39,18 +42,21 @@ public:
     SELECTION() : KIGFX::VIEW_GROUP::VIEW_GROUP()
     {
         m_isHover = false;
+        m_typesValid = false;
     }
 
     SELECTION( const SELECTION& aOther ) : KIGFX::VIEW_GROUP::VIEW_GROUP()
     {
         m_items = aOther.m_items;
         m_isHover = aOther.m_isHover;
+        m_typesValid = false;
     }
 
     SELECTION& operator= ( const SELECTION& aOther )
     {
         m_items = aOther.m_items;
         m_isHover = aOther.m_isHover;
+        m_typesValid = false;
         return *this;
     }
 
@@ -80,7 +86,22 @@ public:
         ITER i = std::lower_bound( m_items.begin(), m_items.end(), aItem );
 
         if( i == m_items.end() || *i > aItem )
+        {
             m_items.insert( i, aItem );
+            m_typesValid = false;
+        }
+    }
+
+    /**
+     * Adds many items at once: inserting them one by one with Add() takes a time quadratic in
+     * the size of the selection.
+     */
+    void AddItems( const std::vector<EDA_ITEM*>& aItems )
+    {
+        m_items.insert( m_items.end(), aItems.begin(), aItems.end() );
+        std::sort( m_items.begin(), m_items.end() );
+        m_items.erase( std::unique( m_items.begin(), m_items.end() ), m_items.end() );
+        m_typesValid = false;
     }
 
     virtual void Remove( EDA_ITEM *aItem )
@@ -88,12 +109,16 @@ public:
         ITER i = std::lower_bound( m_items.begin(), m_items.end(), aItem );
 
         if( !( i == m_items.end() || *i > aItem  ) )
+        {
             m_items.erase( i );
+            m_typesValid = false;
+        }
     }
 
     virtual void Clear() override
     {
         m_items.clear();
+        m_typesValid = false;
     }
 
     virtual unsigned int GetSize() const override
@@ -187,9 +212,29 @@ public:
 
     std::deque<EDA_ITEM*>& Items()
     {
+        m_typesValid = false;    // the caller may modify the items
         return m_items;
     }
 
+    /**
+     * @return the types of the selected items, cached until the selection changes to keep
+     * the evaluation of the selection conditions cheap on large selections.
+     */
+    const std::set<KICAD_T>& GetItemTypes() const
+    {
+        if( !m_typesValid )
+        {
+            m_types.clear();
+
+            for( const EDA_ITEM* item : m_items )
+                m_types.insert( item->Type() );
+
+            m_typesValid = true;
+        }
+
+        return m_types;
+    }
+
     template<class T>
     T* FirstOfKind() const
     {
@@ -212,13 +257,7 @@ public:
      */
     bool HasType( KICAD_T aType ) const
     {
-        for( auto item : m_items )
-        {
-            if( item->Type() == aType )
-                return true;
-        }
-
-        return false;
+        return GetItemTypes().count( aType ) > 0;
     }
 
     virtual const VIEW_GROUP::ITEMS updateDrawList() const override
@@ -258,11 +297,7 @@ public:
      */
     bool AreAllItemsIdentical() const
     {
-        return ( std::all_of( m_items.begin() + 1, m_items.end(),
-                        [&]( const EDA_ITEM* r )
-                        {
-                            return r->Type() == m_items.front()->Type();
-                        } ) );
+        return GetItemTypes().size() <= 1;
     }
 
 protected:
@@ -270,6 +305,10 @@ protected:
     std::deque<EDA_ITEM*> m_items;
     bool                  m_isHover;
 
+    ///> Cache of the types of m_items, see GetItemTypes()
+    mutable std::set<KICAD_T> m_types;
+    mutable bool              m_typesValid;
+
     // mute hidden overloaded virtual function warnings
     using VIEW_GROUP::Add;
     using VIEW_GROUP::Remove;
@@ -0,0 +1,165 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file trace_events.h
+ * @brief Recording of timed scopes, exported as a Chrome trace.
+ */
+
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/**
+ * Class TRACE_EVENTS
+ *
+ * Records the scopes timed by SCOPED_TRACE_EVENT in a ring buffer per thread, which keeps the
+ * last EVENTS_PER_THREAD events of the thread, and writes them in the Chrome trace event JSON
+ * format, opened by chrome://tracing and by Perfetto (https://ui.perfetto.dev).
+ *
+ * The recording is enabled by setting the environment variable KICAD_TRACE_EVENTS to the name
+ * of the file to write when the application exits, or by Enable().  When it is disabled, a
+ * timed scope only costs the test of a flag.
+ */
+class TRACE_EVENTS
+{
+public:
+    static TRACE_EVENTS& Get();
+
+    bool IsEnabled() const
+    {
+        return m_enabled.load( std::memory_order_relaxed );
+    }
+
+    void Enable( bool aEnable )
+    {
+        m_enabled = aEnable;
+    }
+
+    /**
+     * Writes the events recorded so far.
+     * @return false if the file could not be written
+     */
+    bool Write( const std::string& aFileName );
+
+    ///> Drops the events recorded so far
+    void Clear();
+
+    ///> @return the time since the start of the recording, in microseconds
+    int64_t Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - m_origin ).count();
+    }
+
+    ///> Starts a scope on the calling thread.  @return its nesting depth
+    int Enter();
+
+    ///> Ends the scope aName of the calling thread, started at aStart by Enter()
+    void Leave( const char* aName, int64_t aStart, int aDepth );
+
+private:
+    TRACE_EVENTS();
+
+    struct EVENT
+    {
+        const char* m_Name;         ///< a string literal
+        int64_t     m_Start;
+        int64_t     m_Duration;
+        int         m_Depth;
+    };
+
+    struct THREAD_BUFFER
+    {
+        int                m_ThreadId;
+        int                m_Depth = 0;     ///< only used by the thread itself
+        std::mutex         m_Lock;
+        std::vector<EVENT> m_Events;        ///< the ring buffer
+        size_t             m_Next = 0;      ///< index of the next event in m_Events
+    };
+
+    THREAD_BUFFER* threadBuffer();
+
+    static const size_t EVENTS_PER_THREAD = 16384;
+
+    std::atomic<bool>                           m_enabled;
+    std::chrono::steady_clock::time_point       m_origin;
+    std::mutex                                  m_lock;
+    std::vector<std::unique_ptr<THREAD_BUFFER>> m_buffers;
+    std::string                                 m_outputFile;   ///< written on exit
+};
+
+
+/**
+ * Class SCOPED_TRACE_EVENT
+ *
+ * Records the time from its creation to its destruction in TRACE_EVENTS, when enabled:
+ *
+ *     void ZONE_FILLER::Fill(...)
+ *     {
+ *         SCOPED_TRACE_EVENT trace( "ZONE_FILLER::Fill" );
+ *         ...
+ *
+ * The name must be a string literal: it is only stored as a pointer.
+ */
+class SCOPED_TRACE_EVENT
+{
+public:
+    SCOPED_TRACE_EVENT( const char* aName ) :
+            m_name( aName ),
+            m_start( -1 ),
+            m_depth( 0 )
+    {
+        TRACE_EVENTS& events = TRACE_EVENTS::Get();
+
+        if( events.IsEnabled() )
+        {
+            m_depth = events.Enter();
+            m_start = events.Now();
+        }
+    }
+
+    ~SCOPED_TRACE_EVENT()
+    {
+        if( m_start >= 0 )
+            TRACE_EVENTS::Get().Leave( m_name, m_start, m_depth );
+    }
+
+    SCOPED_TRACE_EVENT( const SCOPED_TRACE_EVENT& ) = delete;
+    SCOPED_TRACE_EVENT& operator=( const SCOPED_TRACE_EVENT& ) = delete;
+
+private:
+    const char* m_name;
+    int64_t     m_start;    ///< -1 if not recorded
+    int         m_depth;
+};
+
+#endif // TRACE_EVENTS_H
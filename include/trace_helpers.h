@@ -160,6 +160,13 @@ extern const wxChar* const traceZoomScroll;
  */
 extern const wxChar* const traceSymbolResolver;
 
+/**
+ * Flag to enable the timings of the startup phases of the programs and of the kifaces.
+ *
+ * Use "KICAD_STARTUP" to enable.
+ */
+extern const wxChar* const traceStartup;
+
 ///@}
 
 /**
@@ -61,6 +61,8 @@ enum UNDO_REDO_T {
     UR_ROTATED,             // Rotated item (counterclockwise), undo by rotating it
     UR_ROTATED_CLOCKWISE,   // Rotated item (clockwise), undo by rotating it
     UR_FLIPPED,             // flipped (board items only), undo by flipping it
+    UR_PLACEMENT,           // footprint moved or rotated (board editor only): undo is made by
+                            // exchange of its placement with the one saved in the link
     UR_LIBEDIT,             // Specific to the component editor (libedit creates a full copy
                             // of the current component when changed)
     UR_LIB_RENAME,          // As UR_LIBEDIT, but old copy should be removed from library
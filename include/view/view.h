@@ -95,6 +95,16 @@ public:
      */
     virtual void Remove( VIEW_ITEM* aItem );
 
+    /**
+     * Function RemoveItems()
+     * Removes a list of VIEW_ITEMs from the view in one pass.  Equivalent to calling
+     * VIEW::Remove() for each item, but the list of all items is only walked once, and the
+     * layer trees losing many items are rebuilt instead of searched for each of them, which
+     * matters when thousands of items (e.g. DRC markers) are cleared at once.
+     * @param aItems: items to be removed. Caller must dispose the removed items if necessary
+     */
+    void RemoveItems( const std::vector<VIEW_ITEM*>& aItems );
+
 
     /**
      * Function Query()
@@ -405,6 +415,9 @@ public:
             // Target has to be redrawn after changing its visibility
             MarkTargetDirty( m_layers[aLayer].target );
             m_layers[aLayer].visible = aVisible;
+
+            // The level of details of the items may depend on the visible layers
+            invalidateAggregates();
         }
     }
 
@@ -549,6 +562,15 @@ public:
         return m_dynamic;
     }
 
+    /**
+     * Function GetDrawnItemCount()
+     * Returns the number of items drawn by the last Redraw(), counted once per layer.
+     */
+    int GetDrawnItemCount() const
+    {
+        return m_drawnItemCount;
+    }
+
     /**
      * Function IsDirty()
      * Returns true if any of the VIEW layers needs to be refreshened.
@@ -586,6 +608,10 @@ public:
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
         m_dirtyTargets[aTarget] = true;
+
+        // The whole target has to be redrawn
+        if( aTarget != TARGET_OVERLAY )
+            m_dirtyAreaValid = false;
     }
 
     /// Returns true if the layer is cached
@@ -611,6 +637,8 @@ public:
     {
         for( int i = 0; i < TARGETS_NUMBER; ++i )
             m_dirtyTargets[i] = true;
+
+        m_dirtyAreaValid = false;
     }
 
     /**
@@ -677,6 +705,22 @@ public:
         m_reverseDrawOrder = aFlag;
     }
 
+    /**
+     * Function SetAggregateThreshold()
+     * Sets the zoom level below which the items of a cached layer are drawn all at once, from
+     * a group holding the whole layer, instead of one by one.
+     * The group of a layer is built once its items have not changed for a redraw, so it is not
+     * rebuilt on each step of an interactive edit.  It holds a second copy of the vertices of
+     * the layer.
+     * @param aWorldSize is the size in world units of a screen pixel below which the layers are
+     * aggregated, or 0 to draw the items one by one at all the zoom levels.
+     */
+    void SetAggregateThreshold( double aWorldSize )
+    {
+        m_aggregateThreshold = aWorldSize;
+        invalidateAggregates();
+    }
+
     std::shared_ptr<VIEW_OVERLAY> MakeOverlay();
 
     /**
@@ -710,6 +754,12 @@ protected:
         int                     id;              ///< layer ID
         RENDER_TARGET           target;          ///< where the layer should be rendered
         std::set<int>           requiredLayers;  ///< layers that have to be enabled to show the layer
+
+        bool    aggregateValid;     ///< is aggregateGroup up to date?
+        int     aggregateGroup;     ///< group drawing all the items at once, or -1 if none
+        double  aggregateMinScale;  ///< the items of aggregateGroup are the ones to draw at the
+        double  aggregateMaxScale;  ///< scales in ( aggregateMinScale, aggregateMaxScale ]
+        int     aggregateAge;       ///< number of updates since an item of the layer changed
     };
 
     // Convenience typedefs
@@ -731,12 +781,33 @@ protected:
     ///* Redraws contents within rect aRect
     void redrawRect( const BOX2I& aRect );
 
+    /**
+     * Function drawTiled()
+     * Draws items of a layer in the tiles of the GAL, on several threads.
+     * @param aLayer is the layer to draw.
+     * @param aItems are the items to draw, in the drawing order.
+     * @return false if the items could not be drawn in tiles, nothing was drawn then.
+     */
+    bool drawTiled( int aLayer, const std::vector<VIEW_ITEM*>& aItems );
+
     inline void markTargetClean( int aTarget )
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
         m_dirtyTargets[aTarget] = false;
     }
 
+    /**
+     * Function markTargetDirtyArea()
+     * Marks a target as dirty in an area only.  While nothing else is marked dirty in the
+     * cached and noncached targets, only the union of their dirty areas is redrawn.
+     * @param aTarget is the target to set.
+     * @param aArea is the dirty area, in world coordinates.
+     */
+    void markTargetDirtyArea( int aTarget, const BOX2I& aArea );
+
+    /// Returns the area of the screen to redraw, in pixels, for the current dirty area
+    BOX2I dirtyScreenArea() const;
+
     /**
      * Function draw()
      * Draws an item, but on a specified layers. It has to be marked that some of drawing settings
@@ -784,6 +855,22 @@ protected:
      */
     void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
 
+    /**
+     * Function updateItemCache()
+     * Recaches or recolors an item on its layers, once its bounding box and layers are up to date.
+     * @param aItem is the item to be updated.
+     * @param aUpdateFlags determines the way an item is refreshed.
+     */
+    void updateItemCache( VIEW_ITEM* aItem, int aUpdateFlags );
+
+    /**
+     * Function updateIndexes()
+     * Updates the bounding boxes and layers of many items at once, in the update order of
+     * UpdateItems().  The spatial index of each touched layer is rebuilt in one go, on the
+     * thread pool, instead of removing and inserting each item.
+     */
+    void updateIndexes( const std::vector<VIEW_ITEM*>& aItems );
+
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
@@ -805,6 +892,22 @@ protected:
     /// Checks if every layer required by the aLayerId layer is enabled.
     bool areRequiredLayersEnabled( int aLayerId ) const;
 
+    /// Returns true if the layers are drawn from their aggregate groups at the current zoom
+    bool useAggregates() const;
+
+    /// Returns true if the aggregate group of aLayer holds the items to draw at the current scale
+    bool isAggregateCurrent( const VIEW_LAYER& aLayer ) const;
+
+    /// Marks the aggregate group of a layer, or of all the layers, as out of date
+    void invalidateAggregate( int aLayer );
+    void invalidateAggregates();
+
+    /// Forgets the aggregate groups, which do not exist anymore in the GAL
+    void resetAggregates();
+
+    /// Builds the out of date aggregate groups, if the layers are aggregated at this zoom level
+    void updateAggregates();
+
     ///* Whether to use rendering order modifier or not
     bool m_enableOrderModifier;
 
@@ -854,6 +957,24 @@ protected:
     /// Flags to mark targets as dirty, so they have to be redrawn on the next refresh event
     bool m_dirtyTargets[TARGETS_NUMBER];
 
+    /// Area of the cached and noncached targets to redraw, if m_dirtyAreaValid
+    BOX2I m_dirtyArea;
+
+    /// True if the dirtiness of the cached and noncached targets is limited to m_dirtyArea
+    bool m_dirtyAreaValid;
+
+    /// True if the current frame only redraws m_redrawArea of the cached and noncached targets
+    bool m_partialRedraw;
+
+    /// Area of the partial redraw, in world coordinates
+    BOX2I m_redrawArea;
+
+    /// Copies of m_painter drawing the tiles of the GAL, for the current frame
+    std::vector<std::unique_ptr<PAINTER>> m_tilePainters;
+
+    /// Number of items drawn by the last Redraw()
+    int m_drawnItemCount;
+
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
@@ -867,6 +988,9 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Size of a screen pixel in world units below which the layers are aggregated, or 0
+    double m_aggregateThreshold;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
@@ -29,6 +29,11 @@
 
 #include <geometry/rtree.h>
 
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace KIGFX
 {
 typedef RTree<VIEW_ITEM*, int, 2, double> VIEW_RTREE_BASE;
@@ -55,6 +60,18 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Insert()
+     * Inserts an item into the tree, with an already known bounding box.
+     */
+    void Insert( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
@@ -71,6 +88,50 @@ public:
         VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Update()
+     * Removes the items of aRemoved, then inserts the items of aInserted with their bounding
+     * box.  Each Remove() searches the whole tree, so when many items are updated the tree is
+     * rather rebuilt from its remaining entries.
+     */
+    void Update( const std::unordered_set<VIEW_ITEM*>& aRemoved,
+                 const std::vector<std::pair<VIEW_ITEM*, BOX2I>>& aInserted )
+    {
+        const size_t MIN_REBUILD_COUNT = 16;
+
+        if( aRemoved.size() < MIN_REBUILD_COUNT )
+        {
+            for( VIEW_ITEM* item : aRemoved )
+                Remove( item );
+
+            for( const auto& entry : aInserted )
+                Insert( entry.first, entry.second );
+
+            return;
+        }
+
+        std::vector<BulkEntry> entries;
+        GetEntries( entries );
+
+        entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                       [&]( const BulkEntry& aEntry )
+                                       {
+                                           return aRemoved.count( aEntry.m_data ) > 0;
+                                       } ),
+                       entries.end() );
+
+        for( const auto& entry : aInserted )
+        {
+            const BOX2I& bbox = entry.second;
+
+            entries.push_back( { { { bbox.GetX(), bbox.GetY() },
+                                   { bbox.GetRight(), bbox.GetBottom() } },
+                                 entry.first } );
+        }
+
+        BulkLoad( entries );
+    }
+
     /**
      * Function Query()
      * Executes a function object aVisitor for each item whose bounding box intersects
@@ -107,6 +107,12 @@ protected:
 
     std::vector<WS_DRAW_ITEM_BASE*> m_drawItems;
 
+    ///> The page of m_drawItems, when they were made by UpdateDrawItems(); empty otherwise
+    wxString                        m_drawItemsKey;
+
+    ///> @return what the draw items depend on, besides the page (e.g. the expanded text)
+    virtual wxString drawItemsKey( WS_DRAW_ITEM_LIST* aCollector ) { return wxEmptyString; }
+
 public:
     wxString       m_Name;                  // a item name used in page layout
                                             // editor to identify items
@@ -129,6 +135,14 @@ public:
 
     virtual void SyncDrawItems( WS_DRAW_ITEM_LIST* aCollector, KIGFX::VIEW* aView );
 
+    /**
+     * Adds the draw items of this item to aCollector, like SyncDrawItems( aCollector, nullptr ),
+     * but keeps the draw items of the last call if they were made for the same page and the
+     * same text.
+     * @param aPageKey identifies the page size and the drawing parameters of aCollector.
+     */
+    void UpdateDrawItems( WS_DRAW_ITEM_LIST* aCollector, const wxString& aPageKey );
+
     void SetStart( double aPosx, double aPosy, enum CORNER_ANCHOR aAnchor = RB_CORNER )
     {
         m_Pos.m_Pos.x = aPosx;
@@ -322,6 +336,10 @@ public:
 
     virtual int GetPenSizeUi() override;
 
+protected:
+    wxString drawItemsKey( WS_DRAW_ITEM_LIST* aCollector ) override;
+
+public:
     /**
      * move item to a new position
      * @param aPosition = the new position of item
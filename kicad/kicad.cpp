@@ -87,8 +87,12 @@ bool PGM_KICAD::OnPgmInit()
     }
 #endif
 
-    if( !InitPgm() )
-        return false;
+    {
+        SCOPED_STARTUP_PHASE phase( this, wxT( "Program initialization" ) );
+
+        if( !InitPgm() )
+            return false;
+    }
 
     m_bm.InitSettings( new KICAD_SETTINGS );
     GetSettingsManager().RegisterSettings( PgmSettings() );
@@ -127,8 +131,15 @@ bool PGM_KICAD::OnPgmInit()
             m_bm.m_search.Insert( it->second.GetValue(), 0 );
     }
 
-    KICAD_MANAGER_FRAME* frame = new KICAD_MANAGER_FRAME( NULL, wxT( "KiCad" ),
-                                                          wxDefaultPosition, wxSize( 775, -1 ) );
+    KICAD_MANAGER_FRAME* frame;
+
+    {
+        SCOPED_STARTUP_PHASE phase( this, wxT( "Project manager frame creation" ) );
+
+        frame = new KICAD_MANAGER_FRAME( NULL, wxT( "KiCad" ), wxDefaultPosition,
+                                         wxSize( 775, -1 ) );
+    }
+
     App().SetTopWindow( frame );
 
     Kiway.SetTop( frame );
@@ -162,6 +173,9 @@ bool PGM_KICAD::OnPgmInit()
         if( fn.Exists() )
         {
             fn.MakeAbsolute();
+
+            SCOPED_STARTUP_PHASE phase( this, wxT( "Project loading" ) );
+
             frame->LoadProject( fn );
         }
     }
@@ -169,6 +183,8 @@ bool PGM_KICAD::OnPgmInit()
     frame->Show( true );
     frame->Raise();
 
+    ReportStartupPhases();
+
     return true;
 }
 
@@ -29,6 +29,8 @@
  * @file convert_basic_shapes_to_polygon.h
  */
 
+#include <vector>
+
 #include <geometry/shape_poly_set.h>
 #include <wx/gdicmn.h>      // for wxPoint
 
@@ -61,6 +63,19 @@ enum RECT_CHAMFER_POSITIONS : int
 void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, int aRadius,
                                int aError );
 
+/**
+ * Function TransformCirclesToPolygon
+ * convert circles of the same radius to polygons, one outline per circle.
+ * The circle is polygonized once, and each outline is a translated copy of it, so the
+ * outlines are the same as the ones built by TransformCircleToPolygon for each circle.
+ * @param aCornerBuffer = a buffer to store the polygons
+ * @param aCenters = the centers of the circles
+ * @param aRadius = the radius of the circles
+ * @param aError = the IU allowed for error in approximation
+ */
+void TransformCirclesToPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                const std::vector<wxPoint>& aCenters, int aRadius, int aError );
+
 
 /**
  * convert a oblong shape to a polygon, using multiple segments
@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __DELAUNAY_2D_H
+#define __DELAUNAY_2D_H
+
+#include <utility>
+#include <vector>
+
+#include <math/vector2d.h>              // for VECTOR2I
+
+
+/**
+ * Class DELAUNAY_2D
+ *
+ * A Delaunay triangulation of a set of points, built by a sweep of the points ordered by their
+ * distance to a seed triangle, like the Delaunator library does.  The triangles and the
+ * adjacency between them are stored in flat arrays of indices, which are kept from one
+ * triangulation to the next one, so that triangulating sets of points again and again does not
+ * allocate memory.
+ */
+class DELAUNAY_2D
+{
+public:
+    DELAUNAY_2D()
+    {
+    }
+
+    /**
+     * Function Triangulate
+     * replaces the triangulation by the one of aPoints.
+     * @param aPoints are the points to triangulate.  They must be distinct.
+     * @return false if there is no triangle, i.e. if there are less than 3 points or if all
+     * of them are on the same line
+     */
+    bool Triangulate( const std::vector<VECTOR2I>& aPoints );
+
+    ///> @return the number of triangles
+    int TriangleCount() const
+    {
+        return m_trianglesLen / 3;
+    }
+
+    /**
+     * Function GetEdges
+     * fills aEdges with the edges of the triangulation, each edge once, as pairs of indices
+     * into the points given to Triangulate().
+     */
+    void GetEdges( std::vector<std::pair<int, int>>& aEdges ) const;
+
+    /**
+     * Function GetTriangles
+     * fills aTriangles with the triangles of the triangulation, as triples of indices into the
+     * points given to Triangulate(), in counterclockwise order in the screen coordinates.
+     */
+    void GetTriangles( std::vector<int>& aTriangles ) const;
+
+private:
+    int  addTriangle( int aI0, int aI1, int aI2, int aA, int aB, int aC );
+
+    void link( int aA, int aB );
+
+    int  legalize( int aA );
+
+    int  hashKey( double aX, double aY ) const;
+
+    double x( int aIndex ) const
+    {
+        return m_coords[2 * aIndex];
+    }
+
+    double y( int aIndex ) const
+    {
+        return m_coords[2 * aIndex + 1];
+    }
+
+    std::vector<double> m_coords;
+
+    ///> The vertices of the triangles, 3 by 3; the half edge e goes from m_triangles[e] to the
+    ///> next vertex of its triangle
+    std::vector<int>    m_triangles;
+
+    ///> The opposite of each half edge, or -1 for the edges of the convex hull
+    std::vector<int>    m_halfedges;
+    int                 m_trianglesLen = 0;
+
+    // The convex hull of the points added so far, a circular list of points, with a hash of
+    // its points by their angle around the center of the seed triangle
+    std::vector<int>    m_hullPrev;
+    std::vector<int>    m_hullNext;
+    std::vector<int>    m_hullTri;
+    std::vector<int>    m_hullHash;
+    int                 m_hullStart = 0;
+    double              m_cx = 0.0;
+    double              m_cy = 0.0;
+
+    std::vector<int>    m_ids;
+    std::vector<double> m_dists;
+    std::vector<int>    m_edgeStack;
+};
+
+#endif // __DELAUNAY_2D_H
@@ -0,0 +1,93 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __KDTREE_2D_H
+#define __KDTREE_2D_H
+
+#include <cstddef>                      // for size_t
+#include <vector>
+
+#include <math/vector2d.h>              // for VECTOR2I
+
+
+/**
+ * Class KDTREE_2D
+ *
+ * A static 2D k-d tree of points, for the nearest neighbour queries run many times on the
+ * same set of points.  The tree is stored in a flat array, each subtree being the range of
+ * the array around its median point.
+ */
+class KDTREE_2D
+{
+public:
+    typedef VECTOR2I::extended_type ecoord;
+
+    KDTREE_2D()
+    {
+    }
+
+    KDTREE_2D( const std::vector<VECTOR2I>& aPoints )
+    {
+        Build( aPoints );
+    }
+
+    /**
+     * Function Build
+     * replaces the points of the tree by aPoints.
+     */
+    void Build( const std::vector<VECTOR2I>& aPoints );
+
+    /**
+     * Function Nearest
+     * @return the index in the points given to Build() of the point the closest to aPoint, the
+     * smallest index among the points at the same distance, or -1 if the tree is empty.
+     * @param aDistSq, if not null, receives the squared distance to the returned point
+     */
+    int Nearest( const VECTOR2I& aPoint, ecoord* aDistSq = nullptr ) const;
+
+    size_t Size() const
+    {
+        return m_nodes.size();
+    }
+
+    bool Empty() const
+    {
+        return m_nodes.empty();
+    }
+
+private:
+    struct NODE
+    {
+        VECTOR2I m_pos;
+        int      m_index;
+    };
+
+    void build( int aFirst, int aLast, int aDepth );
+
+    void nearest( int aFirst, int aLast, int aDepth, const VECTOR2I& aPoint, int& aBest,
+                  ecoord& aBestDist ) const;
+
+    std::vector<NODE> m_nodes;
+};
+
+#endif // __KDTREE_2D_H
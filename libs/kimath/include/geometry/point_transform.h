@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POINT_TRANSFORM_H
+#define __POINT_TRANSFORM_H
+
+#include <cmath>                        // for copysign
+#include <cstddef>                      // for size_t
+
+#include <math/vector2d.h>              // for VECTOR2I
+
+
+/**
+ * Class POINT_TRANSFORM
+ *
+ * An affine transform of integer points, built once and applied to whole arrays of points:
+ *     p' = round( M * ( p - aOrigin ) ) + aTarget
+ * where M is a rotation or a mirror and aOrigin and aTarget are integer points.
+ * Rounding is done like KiROUND.  Mirrors, translations and rotations by a multiple of 90
+ * degrees are applied in integer arithmetic, so they are exact.
+ * The loops of Apply() have no per point branches, so the compiler vectorizes them.
+ */
+class POINT_TRANSFORM
+{
+public:
+    ///> Builds the identity transform
+    POINT_TRANSFORM();
+
+    /**
+     * Function Rotation
+     * @return the rotation by aAngle about aCenter, with the VECTOR2::Rotate() convention
+     * @param aAngle is the rotation angle in radians
+     * @param aCenter is the rotation center
+     */
+    static POINT_TRANSFORM Rotation( double aAngle, const VECTOR2I& aCenter = VECTOR2I( 0, 0 ) );
+
+    /**
+     * Function RotationDeciDeg
+     * @return the rotation by aAngle about aCenter, with the RotatePoint() convention.
+     * The transformed points are the same as the ones given by RotatePoint().
+     * @param aAngle is the rotation angle in 0.1 degrees
+     * @param aCenter is the rotation center
+     */
+    static POINT_TRANSFORM RotationDeciDeg( double aAngle,
+                                            const VECTOR2I& aCenter = VECTOR2I( 0, 0 ) );
+
+    /**
+     * Function Mirror
+     * @return the mirror about a vertical (aX) and/or horizontal (aY) line through aRef, with
+     * the SHAPE_LINE_CHAIN::Mirror() convention
+     */
+    static POINT_TRANSFORM Mirror( bool aX, bool aY, const VECTOR2I& aRef = VECTOR2I( 0, 0 ) );
+
+    ///> @return the translation by aVector
+    static POINT_TRANSFORM Translation( const VECTOR2I& aVector );
+
+    ///> Appends a translation by aVector to this transform
+    POINT_TRANSFORM& Translate( const VECTOR2I& aVector )
+    {
+        m_target += aVector;
+        return *this;
+    }
+
+    ///> @return true if the transform reverses the orientation of the shapes (a single mirror)
+    bool IsReflection() const
+    {
+        return m_m00 * m_m11 - m_m01 * m_m10 < 0.0;
+    }
+
+    ///> @return the transformed aPoint
+    VECTOR2I Apply( const VECTOR2I& aPoint ) const
+    {
+        VECTOR2I p( aPoint );
+        Apply( &p, 1 );
+        return p;
+    }
+
+    /**
+     * Function Apply
+     * transforms aCount points in place.
+     * @param aPoints points to the first point.  POINT is any type with int x and y members,
+     * like VECTOR2I and wxPoint
+     */
+    template <typename POINT>
+    void Apply( POINT* aPoints, size_t aCount ) const
+    {
+        const int ox = m_origin.x;
+        const int oy = m_origin.y;
+        const int tx = m_target.x;
+        const int ty = m_target.y;
+
+        if( m_integral )
+        {
+            const int m00 = (int) m_m00, m01 = (int) m_m01;
+            const int m10 = (int) m_m10, m11 = (int) m_m11;
+
+            for( size_t ii = 0; ii < aCount; ii++ )
+            {
+                const int x = aPoints[ii].x - ox;
+                const int y = aPoints[ii].y - oy;
+
+                aPoints[ii].x = m00 * x + m01 * y + tx;
+                aPoints[ii].y = m10 * x + m11 * y + ty;
+            }
+        }
+        else
+        {
+            for( size_t ii = 0; ii < aCount; ii++ )
+            {
+                const double x = aPoints[ii].x - ox;
+                const double y = aPoints[ii].y - oy;
+
+                aPoints[ii].x = round( m_m00 * x + m_m01 * y ) + tx;
+                aPoints[ii].y = round( m_m10 * x + m_m11 * y ) + ty;
+            }
+        }
+    }
+
+private:
+    POINT_TRANSFORM( double aM00, double aM01, double aM10, double aM11,
+                     const VECTOR2I& aOrigin, const VECTOR2I& aTarget );
+
+    ///> KiROUND for results in the int range, without the overflow check and the sign test
+    ///> which prevent vectorizing the loops (and are mispredicted around the origin)
+    static int round( double aValue )
+    {
+        return (int) ( aValue + std::copysign( 0.5, aValue ) );
+    }
+
+    double   m_m00, m_m01, m_m10, m_m11;
+    VECTOR2I m_origin;
+    VECTOR2I m_target;
+
+    ///> true if the matrix entries are all integers (-1, 0 or 1)
+    bool     m_integral;
+};
+
+#endif // __POINT_TRANSFORM_H
@@ -49,6 +49,7 @@
 #include <algorithm>
 #include <deque>
 #include <cmath>
+#include <vector>
 
 #include <clipper.hpp>
 #include <geometry/shape_line_chain.h>
@@ -179,7 +180,7 @@ private:
          */
         void zSort()
         {
-            std::deque<Vertex*> queue;
+            std::vector<Vertex*> queue;
 
             queue.push_back( this );
 
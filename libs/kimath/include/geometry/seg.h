@@ -338,6 +338,28 @@ public:
 
     bool PointCloserThan( const VECTOR2I& aP, int aDist ) const;
 
+    /**
+     * Function FirstCollision()
+     *
+     * Batched version of Collide() for the segments of a polyline, given by its points (the
+     * segment k goes from aPoints[k] to aPoints[k + 1], the closing one from the last point
+     * to the first).  The segments are first screened by blocks with a branch-free bounding
+     * box test, and Collide() only runs on the ones closer than aClearance to the box of aSeg.
+     * @return the index of the first segment colliding with aSeg, or -1.
+     */
+    static int FirstCollision( const SEG& aSeg, int aClearance, const VECTOR2I* aPoints,
+                               int aPointCount, bool aClosed );
+
+    /**
+     * Function FirstCollision()
+     *
+     * Same as above for a circle: finds the first segment of the polyline whose Distance()
+     * to aCenter is smaller than aRadius.
+     * @return the index of the first segment colliding with the circle, or -1.
+     */
+    static int FirstCollision( const VECTOR2I& aCenter, int aRadius, const VECTOR2I* aPoints,
+                               int aPointCount, bool aClosed );
+
     void Reverse()
     {
         std::swap( A, B );
@@ -26,6 +26,7 @@
 #ifndef __SHAPE_ARC_H
 #define __SHAPE_ARC_H
 
+#include <geometry/point_transform.h>
 #include <geometry/seg.h>
 #include <geometry/shape.h>
 #include <math/box2.h>       // for BOX2I
@@ -111,32 +112,25 @@ public:
      */
     void Rotate( double aAngle, const VECTOR2I& aCenter )
     {
-        m_p0 -= aCenter;
-        m_pc -= aCenter;
-
-        m_p0.Rotate( aAngle );
-        m_pc.Rotate( aAngle );
-
-        m_pc += aCenter;
-        m_p0 += aCenter;
-        update_bbox();
+        Transform( POINT_TRANSFORM::Rotation( aAngle, aCenter ) );
     }
 
     void Mirror( bool aX = true, bool aY = false, const VECTOR2I& aVector = { 0, 0 } )
     {
-        if( aX )
-        {
-            m_p0.x = -m_p0.x + 2 * aVector.x;
-            m_pc.x = -m_pc.x + 2 * aVector.x;
-            m_centralAngle = - m_centralAngle;
-        }
-
-        if( aY )
-        {
-            m_p0.y = -m_p0.y + 2 * aVector.y;
-            m_pc.y = -m_pc.y + 2 * aVector.y;
-            m_centralAngle = - m_centralAngle;
-        }
+        Transform( POINT_TRANSFORM::Mirror( aX, aY, aVector ) );
+    }
+
+    /**
+     * Function Transform
+     * applies a rotation, mirror or translation to the arc
+     */
+    void Transform( const POINT_TRANSFORM& aTransform )
+    {
+        aTransform.Apply( &m_p0, 1 );
+        aTransform.Apply( &m_pc, 1 );
+
+        if( aTransform.IsReflection() )
+            m_centralAngle = -m_centralAngle;
 
         update_bbox();
     }
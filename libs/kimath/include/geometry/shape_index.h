@@ -336,23 +336,18 @@ void SHAPE_INDEX<T>::RemoveAll()
 template <class T>
 void SHAPE_INDEX<T>::Reindex()
 {
-    RTree<T, int, 2, double>* newTree;
-    newTree = new RTree<T, int, 2, double>();
+    std::vector<typename RTree<T, int, 2, double>::BulkEntry> entries;
 
-    Iterator iter = this->Begin();
-
-    while( !iter.IsNull() )
+    for( T shape : *this->m_tree )
     {
-        T shape = *iter;
         BOX2I box = boundingBox( shape );
-        int min[2] = { box.GetX(), box.GetY() };
-        int max[2] = { box.GetRight(), box.GetBottom() };
-        newTree->Insert( min, max, shape );
-        iter++;
+
+        entries.push_back( { { { box.GetX(), box.GetY() }, { box.GetRight(), box.GetBottom() } },
+                             shape } );
     }
 
-    delete this->m_tree;
-    this->m_tree = newTree;
+    // The whole content is known, so pack a new tree rather than inserting the shapes in it
+    this->m_tree->BulkLoad( entries );
 }
 
 template <class T>
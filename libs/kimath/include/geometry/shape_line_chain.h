@@ -35,6 +35,7 @@
 #include <core/optional.h>
 
 #include <clipper.hpp>
+#include <geometry/point_transform.h>
 #include <geometry/seg.h>
 #include <geometry/shape.h>
 #include <geometry/shape_arc.h>
@@ -368,6 +369,15 @@ public:
      */
     bool Collide( const SEG& aSeg, int aClearance = 0 ) const override;
 
+    /**
+     * Function Collide()
+     *
+     * Checks if the circle of center aCenter and radius aRadius lies closer to us than
+     * aClearance (the same test as SHAPE_CIRCLE::Collide() run on each of our segments).
+     * @return true, when a collision has been found
+     */
+    bool Collide( const VECTOR2I& aCenter, int aRadius, int aClearance ) const;
+
     /**
      * Function Distance()
      *
@@ -643,6 +653,12 @@ public:
      */
     ClipperLib::Path convertToClipper( bool aRequiredOrientation ) const;
 
+    /**
+     * Same as above, but fills aPath (cleared first), so that a caller converting many chains
+     * can reuse the storage of a single path.
+     */
+    void convertToClipper( bool aRequiredOrientation, ClipperLib::Path& aPath ) const;
+
     /**
      * Find the segment nearest the given point.
      *
@@ -717,6 +733,13 @@ public:
      */
     void Rotate( double aAngle, const VECTOR2I& aCenter = VECTOR2I( 0, 0 ) );
 
+    /**
+     * Function Transform
+     * applies a rotation, mirror or translation to all vertices and arcs
+     * @param aTransform is the transform, built once for all the points
+     */
+    void Transform( const POINT_TRANSFORM& aTransform );
+
     bool IsSolid() const override
     {
         return false;
@@ -26,10 +26,12 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <iosfwd>                       // for string, stringstream
 #include <memory>
+#include <mutex>
 #include <set>                          // for set
 #include <stdexcept>                    // for out_of_range
 #include <stdlib.h>                     // for abs
@@ -43,6 +45,8 @@
 #include <math/vector2d.h>              // for VECTOR2I
 #include <md5_hash.h>
 
+class POLY_GRID_PARTITION;
+
 
 /**
  * SHAPE_POLY_SET
@@ -68,6 +72,9 @@ class SHAPE_POLY_SET : public SHAPE
         ///> N.B. SWIG only supports typedef, so avoid c++ 'using' keyword
         typedef std::vector<SHAPE_LINE_CHAIN> POLYGON;
 
+        ///> A triangulated polygon keeps its vertices and its triangles (as triplets of vertex
+        ///> indices) in two contiguous arrays, which can be used as they are as the vertex and
+        ///> index buffers of a GPU.
         class TRIANGULATED_POLYGON
         {
         public:
@@ -119,10 +126,39 @@ class SHAPE_POLY_SET : public SHAPE
                 return m_vertices.size();
             }
 
+            const TRI& GetTriangleIndices( int index ) const
+            {
+                return m_triangles[ index ];
+            }
+
+            const VECTOR2I& GetVertex( int index ) const
+            {
+                return m_vertices[ index ];
+            }
+
+            ///> @return the vertices, contiguous
+            const std::vector<VECTOR2I>& Vertices() const
+            {
+                return m_vertices;
+            }
+
+            ///> @return the triangles, contiguous (3 vertex indices each)
+            const std::vector<TRI>& Triangles() const
+            {
+                return m_triangles;
+            }
+
+            ///> Releases the memory reserved for vertices and triangles which were not added
+            void ShrinkToFit()
+            {
+                m_triangles.shrink_to_fit();
+                m_vertices.shrink_to_fit();
+            }
+
         private:
 
-            std::deque<TRI> m_triangles;
-            std::deque<VECTOR2I> m_vertices;
+            std::vector<TRI> m_triangles;
+            std::vector<VECTOR2I> m_vertices;
         };
 
         /**
@@ -484,6 +520,12 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Adds a new outline to the set and returns its index
         int AddOutline( const SHAPE_LINE_CHAIN& aOutline );
 
+        ///> Preallocates the storage for aCount polygons in the set
+        void ReserveOutlines( unsigned int aCount )
+        {
+            m_polys.reserve( aCount );
+        }
+
         ///> Adds a new hole to the given outline (default: last) and returns its index
         int AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline = -1 );
 
@@ -580,6 +622,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateGridPartitions();
             return m_polys[aIndex][0];
         }
 
@@ -602,12 +645,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateGridPartitions();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateGridPartitions();
             return m_polys[aIndex];
         }
 
@@ -819,6 +864,12 @@ class SHAPE_POLY_SET : public SHAPE
             return IterateSegments( aOutline, aOutline, true );
         }
 
+        ///> Returns an iterator object, for all outlines in the set (with holes)
+        CONST_SEGMENT_ITERATOR CIterateSegmentsWithHoles() const
+        {
+            return CIterateSegments( 0, OutlineCount() - 1, true );
+        }
+
         ///> Returns an iterator object, for the aOutline-th outline in the set (with holes)
         CONST_SEGMENT_ITERATOR CIterateSegmentsWithHoles( int aOutline ) const
         {
@@ -860,6 +911,18 @@ class SHAPE_POLY_SET : public SHAPE
         void BooleanSubtract( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
                               POLYGON_MODE aFastMode );
 
+        ///> Performs boolean polyset union with all the polysets of aOthers, in a single
+        ///> operation (much faster than adding them one by one)
+        ///> For aFastMode meaning, see function booleanOp
+        void BooleanAdd( const std::vector<const SHAPE_POLY_SET*>& aOthers,
+                         POLYGON_MODE aFastMode );
+
+        ///> Performs boolean polyset difference with all the polysets of aOthers, in a single
+        ///> operation (much faster than subtracting them one by one)
+        ///> For aFastMode meaning, see function booleanOp
+        void BooleanSubtract( const std::vector<const SHAPE_POLY_SET*>& aOthers,
+                              POLYGON_MODE aFastMode );
+
         ///> Performs boolean polyset intersection between a and b, store the result in it self
         ///> For aFastMode meaning, see function booleanOp
         void BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
@@ -959,6 +1022,13 @@ class SHAPE_POLY_SET : public SHAPE
          */
         void Rotate( double aAngle, const VECTOR2I& aCenter = { 0, 0 } );
 
+        /**
+         * Function Transform
+         * applies a rotation, mirror or translation to all vertices
+         * @param aTransform is the transform, built once for all the contours
+         */
+        void Transform( const POINT_TRANSFORM& aTransform );
+
         /// @copydoc SHAPE::IsSolid()
         bool IsSolid() const override
         {
@@ -1035,6 +1105,17 @@ class SHAPE_POLY_SET : public SHAPE
          */
         void BuildBBoxCaches();
 
+        /**
+         * Enables the grid partitions of Contains(), for the repeated containment tests against
+         * the same large polygons.  The grids of the large contours are built by the first test
+         * and dropped by any edit of the set (including through Outline(), Hole() or Polygon()),
+         * to be rebuilt by the next test.  The set must not be edited while it is tested.
+         * Copies of the set get the same setting; assigning other polygons to the set keeps it.
+         * @param aGridSize is the number of grid cells along each axis, or 0 to disable the
+         *                  grids.
+         */
+        void EnableGridPartitions( int aGridSize = 16 );
+
         /**
          * Returns true if a given subpolygon contains the point aP
          *
@@ -1227,6 +1308,11 @@ class SHAPE_POLY_SET : public SHAPE
         void booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aShape,
                         const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
 
+        ///> Same as above, with the union of the aOtherCount sets of aOtherShapes as other shape
+        void booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aShape,
+                        const SHAPE_POLY_SET* const* aOtherShapes, size_t aOtherCount,
+                        POLYGON_MODE aFastMode );
+
         bool pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath,
                              bool aIgnoreEdges, bool aUseBBoxCaches = false ) const;
 
@@ -1248,6 +1334,17 @@ class SHAPE_POLY_SET : public SHAPE
         bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                              bool aUseBBoxCaches = false ) const;
 
+        typedef std::vector<std::vector<std::unique_ptr<POLY_GRID_PARTITION>>> GRID_PARTITIONS;
+
+        ///> Returns the grid partitions of the contours (null for the small ones), building
+        ///> them if the set was edited since they were last built
+        const GRID_PARTITIONS& gridPartitions() const;
+
+        void invalidateGridPartitions()
+        {
+            m_gridPartitionsValid.store( false, std::memory_order_relaxed );
+        }
+
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
          * method; this enum is defined to make the necessary distinction when calling this method
@@ -1289,9 +1386,34 @@ class SHAPE_POLY_SET : public SHAPE
 
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
-        void CacheTriangulation();
+        /**
+         * Function CacheTriangulation
+         * triangulates the polygons of the set, if they changed since the last call.  The
+         * outlines which did not change keep their triangulation.
+         * @param aParallel allows the outlines to be triangulated on several threads (the
+         *                  result is the same).
+         */
+        void CacheTriangulation( bool aParallel = true );
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * Function SetTriangulation
+         * sets the triangulation of the polygon set, taking the ownership of aTriangulation.
+         * The triangulation must have been computed by CacheTriangulation() for the same
+         * polygons (e.g. it was saved in a file along with them).
+         */
+        void SetTriangulation( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& aTriangulation );
+
+        /**
+         * Function TriangulateOutline
+         * triangulates the outline aIndex into aResult, ignoring its holes and leaving the
+         * cached triangulation alone.  Several outlines can be triangulated concurrently, and
+         * the results installed with SetTriangulation() when the set has no holes.
+         * @return false if the outline cannot be triangulated (CacheTriangulation() is then
+         * able to simplify the set first).
+         */
+        bool TriangulateOutline( int aIndex, TRIANGULATED_POLYGON& aResult ) const;
+
         MD5_HASH GetHash() const;
 
     private:
@@ -1302,6 +1424,16 @@ class SHAPE_POLY_SET : public SHAPE
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        ///> Checksums of the outlines each triangulated polygon was built from (invalid when
+        ///> unknown), so that CacheTriangulation() reuses the ones of the unchanged outlines
+        std::vector<MD5_HASH> m_triangulationSources;
+
+        ///> Grid size of the grid partitions of Contains(), 0 when they are disabled
+        int m_gridPartitionSize = 0;
+        mutable GRID_PARTITIONS m_gridPartitions;
+        mutable std::atomic<bool> m_gridPartitionsValid{ false };
+        mutable std::mutex m_gridPartitionsMutex;
+
 };
 
 #endif
@@ -30,6 +30,9 @@ public:
     bool operator==( const MD5_HASH& aOther ) const;
     bool operator!=( const MD5_HASH& aOther ) const;
 
+    ///> An arbitrary ordering of the hashes, e.g. to store them in a std::map
+    bool operator<( const MD5_HASH& aOther ) const;
+
     /** @return Build a hexadecimal string from the 16 bytes of MD5_HASH
      *  Mainly for debug purposes.
      */
@@ -28,9 +28,11 @@
 #include <algorithm>                    // for max, min
 #include <math.h>                       // for atan2
 #include <type_traits>                  // for swap
+#include <vector>
 
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/point_transform.h>
 #include <geometry/shape_line_chain.h>  // for SHAPE_LINE_CHAIN
 #include <geometry/shape_poly_set.h>    // for SHAPE_POLY_SET, SHAPE_POLY_SE...
 #include <math/util.h>
@@ -38,6 +40,37 @@
 #include <trigo.h>
 
 
+/**
+ * Returns the rotation by aHalfDeciDeg * 0.05 degrees.
+ * The circles and rounded ends are built using only rotations by multiples of their angle
+ * step or of half of it, given by a whole number of 0.1 degrees.  So all these rotations
+ * are taken from a single table of 7200 entries, filled on the first use, whatever the
+ * segment count.
+ */
+static const POINT_TRANSFORM& unitCircleRotation( int aHalfDeciDeg )
+{
+    static const int TABLE_SIZE = 7200;
+
+    static const std::vector<POINT_TRANSFORM> table = []()
+    {
+        std::vector<POINT_TRANSFORM> rotations;
+        rotations.reserve( TABLE_SIZE );
+
+        for( int ii = 0; ii < TABLE_SIZE; ii++ )
+            rotations.push_back( POINT_TRANSFORM::RotationDeciDeg( ii / 2.0 ) );
+
+        return rotations;
+    }();
+
+    aHalfDeciDeg %= TABLE_SIZE;
+
+    if( aHalfDeciDeg < 0 )
+        aHalfDeciDeg += TABLE_SIZE;
+
+    return table[aHalfDeciDeg];
+}
+
+
 void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aBuffer,
                                wxPoint aCenter, int aRadius,
                                int aError )
@@ -47,14 +80,13 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aBuffer,
     int     delta = 3600 / numSegs;   // rotate angle in 0.1 degree
     double  correction = GetCircletoPolyCorrectionFactor( numSegs );
     int     radius = aRadius * correction;    // make segments outside the circles
-    double  halfstep = delta/2.0;    // the starting value for rot angles
 
+    // The rotation angles are (ii * delta) + delta / 2, in 0.05 degrees below
     for( int ii = 0; ii < numSegs; ii++ )
     {
         corner_position.x   = radius;
         corner_position.y   = 0;
-        double angle = (ii * delta) + halfstep;
-        RotatePoint( &corner_position, angle );
+        unitCircleRotation( ( 2 * ii + 1 ) * delta ).Apply( &corner_position, 1 );
         corner_position += aCenter;
         aBuffer.Append( corner_position.x, corner_position.y );
     }
@@ -66,23 +98,27 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aBuffer,
 void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, int aRadius,
                                int aError )
 {
-    wxPoint corner_position;
-    int     numSegs = std::max( GetArcToSegmentCount( aRadius, aError, 360.0 ), 6 );
-    int     delta = 3600 / numSegs;   // rotate angle in 0.1 degree
-    double  correction = GetCircletoPolyCorrectionFactor( numSegs );
-    int     radius = aRadius * correction;    // make segments outside the circles
-    double  halfstep = delta/2.0;    // the starting value for rot angles
+    int outline = aCornerBuffer.NewOutline();
 
-    aCornerBuffer.NewOutline();
+    TransformCircleToPolygon( aCornerBuffer.Outline( outline ), aCenter, aRadius, aError );
+}
 
-    for( int ii = 0; ii < numSegs; ii++ )
+
+void TransformCirclesToPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                const std::vector<wxPoint>& aCenters, int aRadius, int aError )
+{
+    SHAPE_LINE_CHAIN circle;
+
+    TransformCircleToPolygon( circle, wxPoint( 0, 0 ), aRadius, aError );
+
+    aCornerBuffer.ReserveOutlines( aCornerBuffer.OutlineCount() + aCenters.size() );
+
+    for( const wxPoint& center : aCenters )
     {
-        corner_position.x   = radius;
-        corner_position.y   = 0;
-        double angle = (ii * delta) + halfstep;
-        RotatePoint( &corner_position, angle );
-        corner_position += aCenter;
-        aCornerBuffer.Append( corner_position.x, corner_position.y );
+        SHAPE_LINE_CHAIN outline( circle );
+
+        outline.Move( center );
+        aCornerBuffer.AddOutline( outline );
     }
 }
 
@@ -137,7 +173,7 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     for( int ii = 0; ii < numSegs / 2; ii++ )
     {
         corner = wxPoint( 0, radius );
-        RotatePoint( &corner, delta * ii );
+        unitCircleRotation( 2 * delta * ii ).Apply( &corner, 1 );
         corner.x += seg_len;
         polyshape.Append( corner.x, corner.y );
     }
@@ -150,7 +186,7 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     for( int ii = 0; ii < numSegs / 2; ii++ )
     {
         corner = wxPoint( 0, -radius );
-        RotatePoint( &corner, delta * ii );
+        unitCircleRotation( 2 * delta * ii ).Apply( &corner, 1 );
         polyshape.Append( corner.x, corner.y );
     }
 
@@ -347,15 +383,16 @@ void TransformSegmentToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 
     double delta_angle = ArcTangente( endp.y, endp.x ); // delta_angle is in 0.1 degrees
     int seg_len        = KiROUND( EuclideanNorm( endp ) );
+    POINT_TRANSFORM rotation = POINT_TRANSFORM::RotationDeciDeg( -delta_angle );
 
     // Compute the outlines of the segment, and creates a polygon
     // add right rounded end:
     for( int ii = 0; ii < 1800; ii += delta )
     {
         corner = wxPoint( 0, radius );
-        RotatePoint( &corner, ii );
+        unitCircleRotation( 2 * ii ).Apply( &corner, 1 );
         corner.x += seg_len;
-        RotatePoint( &corner, -delta_angle );
+        rotation.Apply( &corner, 1 );
         corner += startp;
         polypoint.x = corner.x;
         polypoint.y = corner.y;
@@ -364,7 +401,7 @@ void TransformSegmentToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 
     // Finish arc:
     corner = wxPoint( seg_len, -radius );
-    RotatePoint( &corner, -delta_angle );
+    rotation.Apply( &corner, 1 );
     corner += startp;
     polypoint.x = corner.x;
     polypoint.y = corner.y;
@@ -374,8 +411,8 @@ void TransformSegmentToPolygon( SHAPE_POLY_SET& aCornerBuffer,
     for( int ii = 0; ii < 1800; ii += delta )
     {
         corner = wxPoint( 0, -radius );
-        RotatePoint( &corner, ii );
-        RotatePoint( &corner, -delta_angle );
+        unitCircleRotation( 2 * ii ).Apply( &corner, 1 );
+        rotation.Apply( &corner, 1 );
         corner += startp;
         polypoint.x = corner.x;
         polypoint.y = corner.y;
@@ -384,7 +421,7 @@ void TransformSegmentToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 
     // Finish arc:
     corner = wxPoint( 0, radius );
-    RotatePoint( &corner, -delta_angle );
+    rotation.Apply( &corner, 1 );
     corner += startp;
     polypoint.x = corner.x;
     polypoint.y = corner.y;
@@ -420,8 +457,9 @@ void TransformArcToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 
     for( int ii = delta; ii < aArcAngle; ii += delta )
     {
-        curr_end = arc_start;
-        RotatePoint( &curr_end, aCentre, -ii );
+        curr_end = arc_start - aCentre;
+        unitCircleRotation( -2 * ii ).Apply( &curr_end, 1 );
+        curr_end += aCentre;
         TransformSegmentToPolygon( aCornerBuffer, curr_start, curr_end, aError,
                                    aWidth );
         curr_start = curr_end;
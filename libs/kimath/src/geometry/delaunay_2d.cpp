@@ -0,0 +1,472 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>                    // for sort, fill
+#include <cmath>                        // for ceil, sqrt, floor, fabs
+#include <limits>                       // for numeric_limits
+
+#include <geometry/delaunay_2d.h>
+
+
+// Some of the helpers and the structure of the sweep come from the Delaunator library
+// (https://github.com/mapbox/delaunator, ISC license)
+
+static double dist( double aAx, double aAy, double aBx, double aBy )
+{
+    const double dx = aAx - aBx;
+    const double dy = aAy - aBy;
+
+    return dx * dx + dy * dy;
+}
+
+
+// true if r is on the right of the line from p to q
+static bool orient( double aPx, double aPy, double aQx, double aQy, double aRx, double aRy )
+{
+    return ( aQy - aPy ) * ( aRx - aQx ) - ( aQx - aPx ) * ( aRy - aQy ) < 0.0;
+}
+
+
+static double circumradius( double aAx, double aAy, double aBx, double aBy, double aCx,
+                            double aCy )
+{
+    const double dx = aBx - aAx;
+    const double dy = aBy - aAy;
+    const double ex = aCx - aAx;
+    const double ey = aCy - aAy;
+
+    const double bl = dx * dx + dy * dy;
+    const double cl = ex * ex + ey * ey;
+    const double det = dx * ey - dy * ex;
+
+    if( det == 0.0 )
+        return std::numeric_limits<double>::infinity();
+
+    const double d = 0.5 / det;
+    const double x = ( ey * bl - dy * cl ) * d;
+    const double y = ( dx * cl - ex * bl ) * d;
+
+    return x * x + y * y;
+}
+
+
+static void circumcenter( double aAx, double aAy, double aBx, double aBy, double aCx,
+                          double aCy, double& aX, double& aY )
+{
+    const double dx = aBx - aAx;
+    const double dy = aBy - aAy;
+    const double ex = aCx - aAx;
+    const double ey = aCy - aAy;
+
+    const double bl = dx * dx + dy * dy;
+    const double cl = ex * ex + ey * ey;
+    const double d = 0.5 / ( dx * ey - dy * ex );
+
+    aX = aAx + ( ey * bl - dy * cl ) * d;
+    aY = aAy + ( dx * cl - ex * bl ) * d;
+}
+
+
+// true if p is inside the circumcircle of a, b, c
+static bool inCircle( double aAx, double aAy, double aBx, double aBy, double aCx, double aCy,
+                      double aPx, double aPy )
+{
+    const double dx = aAx - aPx;
+    const double dy = aAy - aPy;
+    const double ex = aBx - aPx;
+    const double ey = aBy - aPy;
+    const double fx = aCx - aPx;
+    const double fy = aCy - aPy;
+
+    const double ap = dx * dx + dy * dy;
+    const double bp = ex * ex + ey * ey;
+    const double cp = fx * fx + fy * fy;
+
+    return dx * ( ey * cp - bp * fy ) - dy * ( ex * cp - bp * fx ) + ap * ( ex * fy - ey * fx )
+           < 0.0;
+}
+
+
+// A monotonic function of the angle of ( aDx, aDy ), in [0, 1]
+static double pseudoAngle( double aDx, double aDy )
+{
+    const double p = aDx / ( std::fabs( aDx ) + std::fabs( aDy ) );
+
+    return ( aDy > 0.0 ? 3.0 - p : 1.0 + p ) / 4.0;
+}
+
+
+int DELAUNAY_2D::hashKey( double aX, double aY ) const
+{
+    const int size = m_hullHash.size();
+    int       key = std::floor( pseudoAngle( aX - m_cx, aY - m_cy ) * size );
+
+    return std::min( std::max( key, 0 ), size - 1 );
+}
+
+
+void DELAUNAY_2D::link( int aA, int aB )
+{
+    m_halfedges[aA] = aB;
+
+    if( aB != -1 )
+        m_halfedges[aB] = aA;
+}
+
+
+int DELAUNAY_2D::addTriangle( int aI0, int aI1, int aI2, int aA, int aB, int aC )
+{
+    const int t = m_trianglesLen;
+
+    m_triangles[t] = aI0;
+    m_triangles[t + 1] = aI1;
+    m_triangles[t + 2] = aI2;
+
+    link( t, aA );
+    link( t + 1, aB );
+    link( t + 2, aC );
+
+    m_trianglesLen += 3;
+
+    return t;
+}
+
+
+int DELAUNAY_2D::legalize( int aA )
+{
+    int ar = 0;
+
+    m_edgeStack.clear();
+
+    // Flip the edges recursively, until all the triangles around the new point are Delaunay
+    while( true )
+    {
+        const int b = m_halfedges[aA];
+        const int a0 = aA - aA % 3;
+
+        ar = a0 + ( aA + 2 ) % 3;
+
+        if( b == -1 )
+        {
+            // An edge of the convex hull
+            if( m_edgeStack.empty() )
+                break;
+
+            aA = m_edgeStack.back();
+            m_edgeStack.pop_back();
+            continue;
+        }
+
+        const int b0 = b - b % 3;
+        const int al = a0 + ( aA + 1 ) % 3;
+        const int bl = b0 + ( b + 2 ) % 3;
+
+        const int p0 = m_triangles[ar];
+        const int pr = m_triangles[aA];
+        const int pl = m_triangles[al];
+        const int p1 = m_triangles[bl];
+
+        if( inCircle( x( p0 ), y( p0 ), x( pr ), y( pr ), x( pl ), y( pl ), x( p1 ), y( p1 ) ) )
+        {
+            m_triangles[aA] = p1;
+            m_triangles[b] = p0;
+
+            const int hbl = m_halfedges[bl];
+
+            // The flipped edge was on the convex hull: fix the triangle referenced by the hull
+            if( hbl == -1 )
+            {
+                int e = m_hullStart;
+
+                do
+                {
+                    if( m_hullTri[e] == bl )
+                    {
+                        m_hullTri[e] = aA;
+                        break;
+                    }
+
+                    e = m_hullPrev[e];
+                } while( e != m_hullStart );
+            }
+
+            link( aA, hbl );
+            link( b, m_halfedges[ar] );
+            link( ar, bl );
+
+            m_edgeStack.push_back( b0 + ( b + 1 ) % 3 );
+        }
+        else
+        {
+            if( m_edgeStack.empty() )
+                break;
+
+            aA = m_edgeStack.back();
+            m_edgeStack.pop_back();
+        }
+    }
+
+    return ar;
+}
+
+
+bool DELAUNAY_2D::Triangulate( const std::vector<VECTOR2I>& aPoints )
+{
+    const int n = aPoints.size();
+
+    m_trianglesLen = 0;
+
+    if( n < 3 )
+        return false;
+
+    m_coords.resize( 2 * n );
+
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = std::numeric_limits<double>::infinity();
+    double maxX = -std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+
+    for( int i = 0; i < n; i++ )
+    {
+        m_coords[2 * i] = aPoints[i].x;
+        m_coords[2 * i + 1] = aPoints[i].y;
+
+        minX = std::min( minX, x( i ) );
+        minY = std::min( minY, y( i ) );
+        maxX = std::max( maxX, x( i ) );
+        maxY = std::max( maxY, y( i ) );
+    }
+
+    const double cx = ( minX + maxX ) / 2;
+    const double cy = ( minY + maxY ) / 2;
+
+    // The seed triangle: the point the closest to the center, the point the closest to it, and
+    // the point making the smallest circumcircle with them
+    int    i0 = 0;
+    int    i1 = -1;
+    int    i2 = -1;
+    double minDist = std::numeric_limits<double>::infinity();
+
+    for( int i = 0; i < n; i++ )
+    {
+        const double d = dist( cx, cy, x( i ), y( i ) );
+
+        if( d < minDist )
+        {
+            i0 = i;
+            minDist = d;
+        }
+    }
+
+    minDist = std::numeric_limits<double>::infinity();
+
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == i0 )
+            continue;
+
+        const double d = dist( x( i0 ), y( i0 ), x( i ), y( i ) );
+
+        if( d < minDist && d > 0.0 )
+        {
+            i1 = i;
+            minDist = d;
+        }
+    }
+
+    if( i1 < 0 )
+        return false;
+
+    double minRadius = std::numeric_limits<double>::infinity();
+
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == i0 || i == i1 )
+            continue;
+
+        const double r = circumradius( x( i0 ), y( i0 ), x( i1 ), y( i1 ), x( i ), y( i ) );
+
+        if( r < minRadius )
+        {
+            i2 = i;
+            minRadius = r;
+        }
+    }
+
+    // All the points are on the same line
+    if( i2 < 0 )
+        return false;
+
+    if( orient( x( i0 ), y( i0 ), x( i1 ), y( i1 ), x( i2 ), y( i2 ) ) )
+        std::swap( i1, i2 );
+
+    circumcenter( x( i0 ), y( i0 ), x( i1 ), y( i1 ), x( i2 ), y( i2 ), m_cx, m_cy );
+
+    // Sweep the points in the order of their distance to the circumcenter of the seed triangle
+    m_ids.resize( n );
+    m_dists.resize( n );
+
+    for( int i = 0; i < n; i++ )
+    {
+        m_ids[i] = i;
+        m_dists[i] = dist( x( i ), y( i ), m_cx, m_cy );
+    }
+
+    std::sort( m_ids.begin(), m_ids.end(),
+            [this]( int aA, int aB )
+            {
+                return m_dists[aA] < m_dists[aB] || ( m_dists[aA] == m_dists[aB] && aA < aB );
+            } );
+
+    const int maxTriangles = std::max( 2 * n - 5, 0 );
+
+    m_triangles.resize( maxTriangles * 3 );
+    m_halfedges.resize( maxTriangles * 3 );
+
+    m_hullPrev.resize( n );
+    m_hullNext.resize( n );
+    m_hullTri.resize( n );
+    m_hullHash.assign( std::max( 1, (int) std::ceil( std::sqrt( n ) ) ), -1 );
+
+    m_hullStart = i0;
+
+    m_hullNext[i0] = m_hullPrev[i2] = i1;
+    m_hullNext[i1] = m_hullPrev[i0] = i2;
+    m_hullNext[i2] = m_hullPrev[i1] = i0;
+
+    m_hullTri[i0] = 0;
+    m_hullTri[i1] = 1;
+    m_hullTri[i2] = 2;
+
+    m_hullHash[hashKey( x( i0 ), y( i0 ) )] = i0;
+    m_hullHash[hashKey( x( i1 ), y( i1 ) )] = i1;
+    m_hullHash[hashKey( x( i2 ), y( i2 ) )] = i2;
+
+    addTriangle( i0, i1, i2, -1, -1, -1 );
+
+    const int hashSize = m_hullHash.size();
+
+    for( int k = 0; k < n; k++ )
+    {
+        const int    i = m_ids[k];
+        const double px = x( i );
+        const double py = y( i );
+
+        if( i == i0 || i == i1 || i == i2 )
+            continue;
+
+        // Find a visible edge of the hull, starting from a point of the hull close in angle
+        int       start = 0;
+        const int key = hashKey( px, py );
+
+        for( int j = 0; j < hashSize; j++ )
+        {
+            start = m_hullHash[( key + j ) % hashSize];
+
+            if( start != -1 && start != m_hullNext[start] )
+                break;
+        }
+
+        start = m_hullPrev[start];
+
+        int e = start;
+        int q;
+
+        while( q = m_hullNext[e], !orient( px, py, x( e ), y( e ), x( q ), y( q ) ) )
+        {
+            e = q;
+
+            if( e == start )
+            {
+                e = -1;
+                break;
+            }
+        }
+
+        // Only possible for points which are (almost) duplicates
+        if( e == -1 )
+            continue;
+
+        // Add the first triangle from the point
+        int t = addTriangle( e, i, m_hullNext[e], -1, -1, m_hullTri[e] );
+
+        m_hullTri[i] = legalize( t + 2 );
+        m_hullTri[e] = t;
+
+        // Walk forward through the hull, adding more triangles and flipping recursively
+        int next = m_hullNext[e];
+
+        while( q = m_hullNext[next], orient( px, py, x( next ), y( next ), x( q ), y( q ) ) )
+        {
+            t = addTriangle( next, i, q, m_hullTri[i], -1, m_hullTri[next] );
+            m_hullTri[i] = legalize( t + 2 );
+            m_hullNext[next] = next; // the point is no more on the hull
+            next = q;
+        }
+
+        // Walk backward from the other side, adding more triangles and flipping
+        if( e == start )
+        {
+            while( q = m_hullPrev[e], orient( px, py, x( q ), y( q ), x( e ), y( e ) ) )
+            {
+                t = addTriangle( q, i, e, -1, m_hullTri[e], m_hullTri[q] );
+                legalize( t + 2 );
+                m_hullTri[q] = t;
+                m_hullNext[e] = e;
+                e = q;
+            }
+        }
+
+        // Update the hull indices
+        m_hullStart = m_hullPrev[i] = e;
+        m_hullNext[e] = m_hullPrev[next] = i;
+        m_hullNext[i] = next;
+
+        m_hullHash[hashKey( px, py )] = i;
+        m_hullHash[hashKey( x( e ), y( e ) )] = e;
+    }
+
+    return true;
+}
+
+
+void DELAUNAY_2D::GetEdges( std::vector<std::pair<int, int>>& aEdges ) const
+{
+    aEdges.clear();
+
+    for( int e = 0; e < m_trianglesLen; e++ )
+    {
+        if( m_halfedges[e] == -1 || e > m_halfedges[e] )
+        {
+            const int next = ( e % 3 == 2 ) ? e - 2 : e + 1;
+
+            aEdges.emplace_back( m_triangles[e], m_triangles[next] );
+        }
+    }
+}
+
+
+void DELAUNAY_2D::GetTriangles( std::vector<int>& aTriangles ) const
+{
+    aTriangles.assign( m_triangles.begin(), m_triangles.begin() + m_trianglesLen );
+}
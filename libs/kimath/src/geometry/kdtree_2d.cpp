@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>                    // for nth_element
+#include <limits>                       // for numeric_limits
+
+#include <geometry/kdtree_2d.h>
+
+
+void KDTREE_2D::Build( const std::vector<VECTOR2I>& aPoints )
+{
+    m_nodes.resize( aPoints.size() );
+
+    for( size_t ii = 0; ii < aPoints.size(); ii++ )
+    {
+        m_nodes[ii].m_pos = aPoints[ii];
+        m_nodes[ii].m_index = ii;
+    }
+
+    build( 0, m_nodes.size(), 0 );
+}
+
+
+void KDTREE_2D::build( int aFirst, int aLast, int aDepth )
+{
+    if( aLast - aFirst <= 1 )
+        return;
+
+    int  mid = ( aFirst + aLast ) / 2;
+    bool splitX = ( aDepth % 2 ) == 0;
+
+    std::nth_element( m_nodes.begin() + aFirst, m_nodes.begin() + mid, m_nodes.begin() + aLast,
+            [splitX] ( const NODE& aA, const NODE& aB )
+            {
+                return splitX ? aA.m_pos.x < aB.m_pos.x : aA.m_pos.y < aB.m_pos.y;
+            } );
+
+    build( aFirst, mid, aDepth + 1 );
+    build( mid + 1, aLast, aDepth + 1 );
+}
+
+
+int KDTREE_2D::Nearest( const VECTOR2I& aPoint, ecoord* aDistSq ) const
+{
+    int    best = -1;
+    ecoord bestDist = std::numeric_limits<ecoord>::max();
+
+    nearest( 0, m_nodes.size(), 0, aPoint, best, bestDist );
+
+    if( aDistSq )
+        *aDistSq = bestDist;
+
+    return best;
+}
+
+
+void KDTREE_2D::nearest( int aFirst, int aLast, int aDepth, const VECTOR2I& aPoint, int& aBest,
+                         ecoord& aBestDist ) const
+{
+    if( aFirst >= aLast )
+        return;
+
+    int         mid = ( aFirst + aLast ) / 2;
+    const NODE& node = m_nodes[mid];
+    ecoord      dist = ( node.m_pos - aPoint ).SquaredEuclideanNorm();
+
+    if( dist < aBestDist || ( dist == aBestDist && node.m_index < aBest ) )
+    {
+        aBest = node.m_index;
+        aBestDist = dist;
+    }
+
+    bool   splitX = ( aDepth % 2 ) == 0;
+    ecoord delta = splitX ? (ecoord) aPoint.x - node.m_pos.x : (ecoord) aPoint.y - node.m_pos.y;
+
+    // Search first the side of the point, then the other side if it can hold a closer point
+    // (or an equally close one with a smaller index)
+    if( delta < 0 )
+    {
+        nearest( aFirst, mid, aDepth + 1, aPoint, aBest, aBestDist );
+
+        if( delta * delta <= aBestDist )
+            nearest( mid + 1, aLast, aDepth + 1, aPoint, aBest, aBestDist );
+    }
+    else
+    {
+        nearest( mid + 1, aLast, aDepth + 1, aPoint, aBest, aBestDist );
+
+        if( delta * delta <= aBestDist )
+            nearest( aFirst, mid, aDepth + 1, aPoint, aBest, aBestDist );
+    }
+}
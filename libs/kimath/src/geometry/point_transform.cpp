@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>                    // for max
+#include <math.h>                       // for sin, cos, M_PI
+
+#include <geometry/point_transform.h>
+#include <trigo.h>                      // for DECIDEG2RAD, NORMALIZE_ANGLE_POS
+
+
+POINT_TRANSFORM::POINT_TRANSFORM() :
+        POINT_TRANSFORM( 1.0, 0.0, 0.0, 1.0, VECTOR2I( 0, 0 ), VECTOR2I( 0, 0 ) )
+{
+}
+
+
+POINT_TRANSFORM::POINT_TRANSFORM( double aM00, double aM01, double aM10, double aM11,
+                                  const VECTOR2I& aOrigin, const VECTOR2I& aTarget ) :
+        m_m00( aM00 ),
+        m_m01( aM01 ),
+        m_m10( aM10 ),
+        m_m11( aM11 ),
+        m_origin( aOrigin ),
+        m_target( aTarget )
+{
+    auto isIntegral = []( double aValue )
+    {
+        return aValue == -1.0 || aValue == 0.0 || aValue == 1.0;
+    };
+
+    m_integral = isIntegral( aM00 ) && isIntegral( aM01 )
+                 && isIntegral( aM10 ) && isIntegral( aM11 );
+}
+
+
+POINT_TRANSFORM POINT_TRANSFORM::Rotation( double aAngle, const VECTOR2I& aCenter )
+{
+    // Rotations by a multiple of 90 degrees are frequent (pads, footprints, zones) and are
+    // made exact, without the rounding of sin( M_PI / 2 ) and friends
+    double quarters = aAngle / ( M_PI / 2 );
+    double rounded = floor( quarters + 0.5 );
+
+    if( fabs( quarters - rounded ) < 1e-12 * std::max( 1.0, fabs( quarters ) ) )
+    {
+        int quarter = (int) fmod( rounded, 4.0 );
+
+        if( quarter < 0 )
+            quarter += 4;
+
+        static const double sines[4] = { 0.0, 1.0, 0.0, -1.0 };
+        static const double cosines[4] = { 1.0, 0.0, -1.0, 0.0 };
+
+        double sa = sines[quarter];
+        double ca = cosines[quarter];
+
+        return POINT_TRANSFORM( ca, -sa, sa, ca, aCenter, aCenter );
+    }
+
+    double sa = sin( aAngle );
+    double ca = cos( aAngle );
+
+    return POINT_TRANSFORM( ca, -sa, sa, ca, aCenter, aCenter );
+}
+
+
+POINT_TRANSFORM POINT_TRANSFORM::RotationDeciDeg( double aAngle, const VECTOR2I& aCenter )
+{
+    double sinus, cosinus;
+
+    NORMALIZE_ANGLE_POS( aAngle );
+
+    // Same special cases and same sin/cos arguments as RotatePoint()
+    if( aAngle == 0 )
+    {
+        sinus = 0.0;
+        cosinus = 1.0;
+    }
+    else if( aAngle == 900 )
+    {
+        sinus = 1.0;
+        cosinus = 0.0;
+    }
+    else if( aAngle == 1800 )
+    {
+        sinus = 0.0;
+        cosinus = -1.0;
+    }
+    else if( aAngle == 2700 )
+    {
+        sinus = -1.0;
+        cosinus = 0.0;
+    }
+    else
+    {
+        double fangle = DECIDEG2RAD( aAngle );
+        sinus = sin( fangle );
+        cosinus = cos( fangle );
+    }
+
+    return POINT_TRANSFORM( cosinus, sinus, -sinus, cosinus, aCenter, aCenter );
+}
+
+
+POINT_TRANSFORM POINT_TRANSFORM::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
+{
+    return POINT_TRANSFORM( aX ? -1.0 : 1.0, 0.0, 0.0, aY ? -1.0 : 1.0, aRef, aRef );
+}
+
+
+POINT_TRANSFORM POINT_TRANSFORM::Translation( const VECTOR2I& aVector )
+{
+    return POINT_TRANSFORM( 1.0, 0.0, 0.0, 1.0, VECTOR2I( 0, 0 ), aVector );
+}
@@ -23,6 +23,7 @@
  */
 
 #include <algorithm>        // for min
+#include <limits>           // for numeric_limits
 #include <geometry/seg.h>
 #include <math/util.h>      // for rescale
 #include <math/vector2d.h>  // for VECTOR2I, VECTOR2
@@ -197,6 +198,142 @@ bool SEG::Collide( const SEG& aSeg, int aClearance ) const
 }
 
 
+// Number of segments screened at once by SEG::FirstCollision()
+static const int SCREEN_BLOCK = 64;
+
+
+/*
+ * Exact bounding box screening of a polyline segment: the segment is kept when the squared
+ * distance between its bounding box and the box aBox (xmin, ymin, xmax, ymax) is smaller
+ * than aLimit * aLimit.  The gaps are clamped to aLimit, so that the sum of their squares
+ * cannot overflow.
+ */
+static inline bool screenSegment( const VECTOR2I& aA, const VECTOR2I& aB,
+                                  const SEG::ecoord aBox[4], SEG::ecoord aLimit )
+{
+    SEG::ecoord xmin = std::min( aA.x, aB.x );
+    SEG::ecoord xmax = std::max( aA.x, aB.x );
+    SEG::ecoord ymin = std::min( aA.y, aB.y );
+    SEG::ecoord ymax = std::max( aA.y, aB.y );
+
+    SEG::ecoord gx = std::max( std::max( xmin - aBox[2], aBox[0] - xmax ), (SEG::ecoord) 0 );
+    SEG::ecoord gy = std::max( std::max( ymin - aBox[3], aBox[1] - ymax ), (SEG::ecoord) 0 );
+
+    gx = std::min( gx, aLimit );
+    gy = std::min( gy, aLimit );
+
+    return gx * gx + gy * gy < aLimit * aLimit;
+}
+
+
+/*
+ * Coarse screening of aCount consecutive segments against the box aBox inflated by aLimit,
+ * clamped to the int range (aBounds).  A segment whose two ends lie on the same side out of
+ * these bounds is also rejected by screenSegment(), so only the segments flagged in aNear
+ * need the exact test.  The loop only compares ints and has no branches, so that the
+ * compiler can vectorize it.
+ */
+static void screenSegments( const VECTOR2I* aPoints, int aCount, const int aBounds[4],
+                            bool* aNear )
+{
+    const int xlo = aBounds[0];
+    const int ylo = aBounds[1];
+    const int xhi = aBounds[2];
+    const int yhi = aBounds[3];
+
+    for( int k = 0; k < aCount; k++ )
+    {
+        const VECTOR2I& a = aPoints[k];
+        const VECTOR2I& b = aPoints[k + 1];
+
+        int out = ( ( a.x < xlo ) & ( b.x < xlo ) ) | ( ( a.x > xhi ) & ( b.x > xhi ) )
+                  | ( ( a.y < ylo ) & ( b.y < ylo ) ) | ( ( a.y > yhi ) & ( b.y > yhi ) );
+
+        aNear[k] = !out;
+    }
+}
+
+
+template <typename TEST>
+static int firstCollision( const VECTOR2I* aPoints, int aPointCount, bool aClosed,
+                           const SEG::ecoord aBox[4], SEG::ecoord aLimit, TEST aTest )
+{
+    const SEG::ecoord imin = std::numeric_limits<int>::min();
+    const SEG::ecoord imax = std::numeric_limits<int>::max();
+    const int         bounds[4] = { (int) std::max( aBox[0] - aLimit, imin ),
+                                    (int) std::max( aBox[1] - aLimit, imin ),
+                                    (int) std::min( aBox[2] + aLimit, imax ),
+                                    (int) std::min( aBox[3] + aLimit, imax ) };
+
+    bool near[SCREEN_BLOCK];
+    int  openCount = aPointCount - 1;
+
+    for( int base = 0; base < openCount; base += SCREEN_BLOCK )
+    {
+        int count = std::min( SCREEN_BLOCK, openCount - base );
+
+        screenSegments( aPoints + base, count, bounds, near );
+
+        for( int k = 0; k < count; k++ )
+        {
+            if( !near[k] )
+                continue;
+
+            const VECTOR2I& a = aPoints[base + k];
+            const VECTOR2I& b = aPoints[base + k + 1];
+
+            if( screenSegment( a, b, aBox, aLimit ) && aTest( SEG( a, b ) ) )
+                return base + k;
+        }
+    }
+
+    if( aClosed && aPointCount > 0 )
+    {
+        const VECTOR2I& a = aPoints[aPointCount - 1];
+        const VECTOR2I& b = aPoints[0];
+
+        if( screenSegment( a, b, aBox, aLimit ) && aTest( SEG( a, b ) ) )
+            return aPointCount - 1;
+    }
+
+    return -1;
+}
+
+
+int SEG::FirstCollision( const SEG& aSeg, int aClearance, const VECTOR2I* aPoints,
+                         int aPointCount, bool aClosed )
+{
+    // As in SHAPE_LINE_CHAIN::Collide(), segments whose box is not closer than aClearance
+    // to the box of aSeg are not tested (so nothing collides with a zero clearance).
+    const ecoord box[4] = { std::min( aSeg.A.x, aSeg.B.x ), std::min( aSeg.A.y, aSeg.B.y ),
+                            std::max( aSeg.A.x, aSeg.B.x ), std::max( aSeg.A.y, aSeg.B.y ) };
+
+    return firstCollision( aPoints, aPointCount, aClosed, box, std::abs( (ecoord) aClearance ),
+                           [&]( const SEG& aCandidate )
+                           {
+                               return aCandidate.Collide( aSeg, aClearance );
+                           } );
+}
+
+
+int SEG::FirstCollision( const VECTOR2I& aCenter, int aRadius, const VECTOR2I* aPoints,
+                         int aPointCount, bool aClosed )
+{
+    // Distance() is never negative, and a segment whose box is not closer than aRadius to
+    // aCenter cannot have a Distance() smaller than aRadius, so the screening is exact.
+    if( aRadius <= 0 )
+        return -1;
+
+    const ecoord box[4] = { aCenter.x, aCenter.y, aCenter.x, aCenter.y };
+
+    return firstCollision( aPoints, aPointCount, aClosed, box, aRadius,
+                           [&]( const SEG& aCandidate )
+                           {
+                               return aCandidate.Distance( aCenter ) < aRadius;
+                           } );
+}
+
+
 bool SEG::Contains( const VECTOR2I& aP ) const
 {
     return PointCloserThan( aP, 1 );
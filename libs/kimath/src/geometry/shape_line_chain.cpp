@@ -49,19 +49,26 @@ ClipperLib::Path SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation )
 {
     ClipperLib::Path c_path;
 
-    for( int i = 0; i < PointCount(); i++ )
-    {
-        const VECTOR2I& vertex = CPoint( i );
-        c_path.push_back( ClipperLib::IntPoint( vertex.x, vertex.y ) );
-    }
-
-    if( Orientation( c_path ) != aRequiredOrientation )
-        ReversePath( c_path );
+    convertToClipper( aRequiredOrientation, c_path );
 
     return c_path;
 }
 
 
+void SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation,
+                                         ClipperLib::Path& aPath ) const
+{
+    aPath.clear();
+    aPath.reserve( m_points.size() );
+
+    for( const VECTOR2I& vertex : m_points )
+        aPath.emplace_back( vertex.x, vertex.y );
+
+    if( Orientation( aPath ) != aRequiredOrientation )
+        ReversePath( aPath );
+}
+
+
 //TODO(SH): Adjust this into two functions: one to convert and one to split the arc into two arcs
 void SHAPE_LINE_CHAIN::convertArc( ssize_t aArcIndex )
 {
@@ -95,38 +102,30 @@ bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_LINE_CHAIN::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
-    for( auto& pt : m_points )
-    {
-        pt -= aCenter;
-        pt = pt.Rotate( aAngle );
-        pt += aCenter;
-    }
+    Transform( POINT_TRANSFORM::Rotation( aAngle, aCenter ) );
+}
+
+
+void SHAPE_LINE_CHAIN::Transform( const POINT_TRANSFORM& aTransform )
+{
+    aTransform.Apply( m_points.data(), m_points.size() );
 
     for( auto& arc : m_arcs )
-        arc.Rotate( aAngle, aCenter );
+        arc.Transform( aTransform );
 }
 
 
 bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
 {
-    BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
-    BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
-
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG& s = CSegment( i );
-        BOX2I box_b( s.A, s.B - s.A );
-
-        BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
+    return SEG::FirstCollision( aSeg, aClearance, m_points.data(), m_points.size(), m_closed )
+           >= 0;
+}
 
-        if( d < dist_sq )
-        {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
-        }
-    }
 
-    return false;
+bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aCenter, int aRadius, int aClearance ) const
+{
+    return SEG::FirstCollision( aCenter, aClearance + aRadius, m_points.data(), m_points.size(),
+                                m_closed ) >= 0;
 }
 
 
@@ -164,17 +163,7 @@ long long int SHAPE_LINE_CHAIN::Length() const
 
 void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
-    for( auto& pt : m_points )
-    {
-        if( aX )
-            pt.x = -pt.x + 2 * aRef.x;
-
-        if( aY )
-            pt.y = -pt.y + 2 * aRef.y;
-    }
-
-    for( auto& arc : m_arcs )
-        arc.Mirror( aX, aY, aRef );
+    Transform( POINT_TRANSFORM::Mirror( aX, aY, aRef ) );
 }
 
 
@@ -267,15 +256,28 @@ void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
 
 int SHAPE_LINE_CHAIN::Distance( const VECTOR2I& aP, bool aOutlineOnly ) const
 {
-    int d = INT_MAX;
-
     if( IsClosed() && PointInside( aP ) && !aOutlineOnly )
         return 0;
 
-    for( int s = 0; s < SegmentCount(); s++ )
-        d = std::min( d, CSegment( s ).Distance( aP ) );
+    // Compare squared distances, and only take the square root of the smallest one.
+    const std::vector<VECTOR2I>& points = m_points;
+    int pointCount = points.size();
+    int segmentCount = SegmentCount();
+
+    if( segmentCount == 0 )
+        return INT_MAX;
+
+    SEG::ecoord d_sq = VECTOR2I::ECOORD_MAX;
+
+    for( int i = 0; i < segmentCount; i++ )
+    {
+        const VECTOR2I& a = points[ i ];
+        const VECTOR2I& b = points[ i + 1 == pointCount ? 0 : i + 1 ];
+
+        d_sq = std::min( d_sq, SEG( a, b ).SquaredDistance( aP ) );
+    }
 
-    return d;
+    return sqrt( d_sq );
 }
 
 
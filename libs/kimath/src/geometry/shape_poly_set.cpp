@@ -28,19 +28,24 @@
 
 #include <algorithm>
 #include <assert.h>                          // for assert
+#include <atomic>
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <future>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
+#include <map>
 #include <memory>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
 
 #include <clipper.hpp>                       // for Clipper, PolyNode, Clipp...
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_grid_partition.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
 #include <geometry/shape.h>
@@ -61,7 +66,8 @@ SHAPE_POLY_SET::SHAPE_POLY_SET() :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ),
+    m_gridPartitionSize( aOther.m_gridPartitionSize )
 {
     if( aOther.IsTriangulationUpToDate() )
     {
@@ -69,6 +75,7 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
             m_triangulatedPolys.push_back(
                     std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
 
+        m_triangulationSources = aOther.m_triangulationSources;
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
     }
@@ -174,6 +181,8 @@ int SHAPE_POLY_SET::NewOutline()
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
+    invalidateGridPartitions();
+
     empty_path.SetClosed( true );
     poly.push_back( empty_path );
     m_polys.push_back( poly );
@@ -185,6 +194,7 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 {
     SHAPE_LINE_CHAIN empty_path;
 
+    invalidateGridPartitions();
     empty_path.SetClosed( true );
 
     // Default outline is the last one
@@ -215,6 +225,7 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
     assert( aOutline < (int) m_polys.size() );
     assert( idx < (int) m_polys[aOutline].size() );
 
+    invalidateGridPartitions();
     m_polys[aOutline][idx].Append( x, y, aAllowDuplication );
 
     return m_polys[aOutline][idx].PointCount();
@@ -236,7 +247,10 @@ void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
     {
         // Assure the position to be inserted exists; throw an exception otherwise
         if( GetRelativeIndices( aGlobalIndex, &index ) )
+        {
+            invalidateGridPartitions();
             m_polys[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
+        }
         else
             throw( std::out_of_range( "aGlobalIndex-th vertex does not exist" ) );
     }
@@ -414,6 +428,7 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
     poly.push_back( aOutline );
 
+    invalidateGridPartitions();
     m_polys.push_back( poly );
 
     return m_polys.size() - 1;
@@ -433,12 +448,57 @@ int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 
     assert( poly.size() );
 
+    invalidateGridPartitions();
     poly.push_back( aHole );
 
     return poly.size() - 1;
 }
 
 
+/**
+ * The Clipper engines and the path buffer used by the boolean operations and the inflation
+ * of a thread.  They are kept from one operation to the next, so that the thousands of small
+ * operations of a zone fill or a DRC run do not each allocate (and free) their own engines
+ * and buffers.  The engines are cleared before each use; an operation never runs another one
+ * while it uses them.
+ */
+struct CLIPPER_CONTEXT
+{
+    Clipper       m_clipper;
+    ClipperOffset m_offset;
+    PolyTree      m_solution;
+    Path          m_path;
+};
+
+
+static CLIPPER_CONTEXT& clipperContext()
+{
+    static thread_local CLIPPER_CONTEXT context;
+
+    return context;
+}
+
+
+/**
+ * Adds the chains of the polygons of aShape to the Clipper engine of aContext, as paths of
+ * type aType.  The conversion goes through the path buffer of the context.
+ */
+static void addClipperPaths( CLIPPER_CONTEXT& aContext, const SHAPE_POLY_SET& aShape,
+                             PolyType aType )
+{
+    for( int ii = 0; ii < aShape.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aShape.CPolygon( ii );
+
+        for( size_t i = 0; i < poly.size(); i++ )
+        {
+            poly[i].convertToClipper( i == 0, aContext.m_path );
+            aContext.m_clipper.AddPath( aContext.m_path, aType, true );
+        }
+    }
+}
+
+
 void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
@@ -451,27 +511,36 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
         const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
-    Clipper c;
+    const SHAPE_POLY_SET* others[] = { &aOtherShape };
+
+    booleanOp( aType, aShape, others, 1, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
+        const SHAPE_POLY_SET& aShape,
+        const SHAPE_POLY_SET* const* aOtherShapes, size_t aOtherCount,
+        POLYGON_MODE aFastMode )
+{
+    CLIPPER_CONTEXT& context = clipperContext();
+    Clipper&         c = context.m_clipper;
 
+    c.Clear();
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
 
-    for( auto poly : aShape.m_polys )
-    {
-        for( size_t i = 0 ; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
-    }
+    addClipperPaths( context, aShape, ptSubject );
 
-    for( auto poly : aOtherShape.m_polys )
-    {
-        for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
-    }
+    // With the non-zero fill rule, the clip paths of several sets act as their union
+    for( size_t ii = 0; ii < aOtherCount; ii++ )
+        addClipperPaths( context, *aOtherShapes[ii], ptClip );
 
-    PolyTree solution;
+    c.Execute( aType, context.m_solution, pftNonZero, pftNonZero );
 
-    c.Execute( aType, solution, pftNonZero, pftNonZero );
+    // aShape and the other shapes may be this set, so they are only replaced now
+    importTree( &context.m_solution );
 
-    importTree( &solution );
+    context.m_solution.Clear();
+    c.Clear();
 }
 
 
@@ -517,6 +586,20 @@ void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& a,
 }
 
 
+void SHAPE_POLY_SET::BooleanAdd( const std::vector<const SHAPE_POLY_SET*>& aOthers,
+        POLYGON_MODE aFastMode )
+{
+    booleanOp( ctUnion, *this, aOthers.data(), aOthers.size(), aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BooleanSubtract( const std::vector<const SHAPE_POLY_SET*>& aOthers,
+        POLYGON_MODE aFastMode )
+{
+    booleanOp( ctDifference, *this, aOthers.data(), aOthers.size(), aFastMode );
+}
+
+
 void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCount,
                                              POLYGON_MODE aFastMode )
 {
@@ -535,7 +618,10 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     #define SEG_CNT_MAX 64
     static double arc_tolerance_factor[SEG_CNT_MAX + 1];
 
-    ClipperOffset c;
+    CLIPPER_CONTEXT& context = clipperContext();
+    ClipperOffset&   c = context.m_offset;
+
+    c.Clear();
 
     // N.B. see the Clipper documentation for jtSquare/jtMiter/jtRound.  They are poorly named
     // and are not what you'd think they are.
@@ -576,11 +662,12 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     for( const POLYGON& poly : m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
+        {
+            poly[i].convertToClipper( i == 0, context.m_path );
+            c.AddPath( context.m_path, joinType, etClosedPolygon );
+        }
     }
 
-    PolyTree solution;
-
     // Calculate the arc tolerance (arc error) from the seg count by circle. The seg count is
     // nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aAmount))
     // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
@@ -603,14 +690,18 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     c.ArcTolerance = std::abs( aAmount ) * coeff;
     c.MiterLimit = miterLimit;
     c.MiterFallback = miterFallback;
-    c.Execute( solution, aAmount );
+    c.Execute( context.m_solution, aAmount );
 
-    importTree( &solution );
+    importTree( &context.m_solution );
+
+    context.m_solution.Clear();
+    c.Clear();
 }
 
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    invalidateGridPartitions();
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -661,7 +752,60 @@ struct FractureEdge
 typedef std::vector<FractureEdge*> FractureEdgeSet;
 
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+/**
+ * Buckets the fracture edges by the horizontal bands of the polygon they cross, so that the
+ * edges crossing a given y are found without scanning all the edges of the polygon.
+ * Each bucket keeps its edges in creation order, so the nearest edge found in a bucket is
+ * the same one a scan of all the edges would find.
+ */
+class FractureEdgeBuckets
+{
+public:
+    FractureEdgeBuckets( int aYMin, int aYMax, size_t aEdgeCount ) :
+        m_yMin( aYMin )
+    {
+        size_t count = std::min<size_t>( std::max<size_t>( aEdgeCount / 16, 1 ), 4096 );
+
+        m_bucketHeight = ( (long long) aYMax - aYMin ) / (long long) count + 1;
+        m_buckets.resize( count );
+    }
+
+    void Insert( FractureEdge* aEdge )
+    {
+        size_t first = bucket( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) );
+        size_t last = bucket( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( size_t ii = first; ii <= last; ++ii )
+            m_buckets[ii].push_back( aEdge );
+    }
+
+    ///> @return the edges which may cross aY (and possibly a few more)
+    const FractureEdgeSet& Find( int aY ) const
+    {
+        return m_buckets[ bucket( aY ) ];
+    }
+
+private:
+    size_t bucket( int aY ) const
+    {
+        long long ii = ( (long long) aY - m_yMin ) / m_bucketHeight;
+
+        return (size_t) std::max<long long>( 0, std::min<long long>( ii, m_buckets.size() - 1 ) );
+    }
+
+    int                          m_yMin;
+    long long                    m_bucketHeight;
+    std::vector<FractureEdgeSet> m_buckets;
+};
+
+
+/**
+ * Connects the hole starting at edge to the nearest connected edge on its left.  The three
+ * new edges are created in aEdges, which must have room for them (the edges are pointed
+ * to, they must not move).
+ */
+static int processEdge( std::vector<FractureEdge>& aEdges, FractureEdgeBuckets& aBuckets,
+                        FractureEdge* edge )
 {
     int x   = edge->m_p1.x;
     int y   = edge->m_p1.y;
@@ -670,46 +814,49 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
     FractureEdge* e_nearest = NULL;
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+    for( FractureEdge* e : aBuckets.Find( y ) )
     {
-        if( !(*i)->matches( y ) )
+        if( !e->m_connected || !e->matches( y ) )
             continue;
 
         int x_intersect;
 
-        if( (*i)->m_p1.y == (*i)->m_p2.y ) // horizontal edge
-            x_intersect = std::max( (*i)->m_p1.x, (*i)->m_p2.x );
+        if( e->m_p1.y == e->m_p2.y ) // horizontal edge
+            x_intersect = std::max( e->m_p1.x, e->m_p2.x );
         else
-            x_intersect = (*i)->m_p1.x + rescale( (*i)->m_p2.x - (*i)->m_p1.x, y - (*i)->m_p1.y,
-                    (*i)->m_p2.y - (*i)->m_p1.y );
+            x_intersect = e->m_p1.x + rescale( e->m_p2.x - e->m_p1.x, y - e->m_p1.y,
+                    e->m_p2.y - e->m_p1.y );
 
         int dist = ( x - x_intersect );
 
-        if( dist >= 0 && dist < min_dist && (*i)->m_connected )
+        if( dist >= 0 && dist < min_dist )
         {
             min_dist    = dist;
             x_nearest   = x_intersect;
-            e_nearest   = (*i);
+            e_nearest   = e;
         }
     }
 
-    if( e_nearest && e_nearest->m_connected )
+    if( e_nearest )
     {
         int count = 0;
 
-        FractureEdge* lead1 =
-            new FractureEdge( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
-        FractureEdge* lead2 =
-            new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
-        FractureEdge* split_2 =
-            new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
+        assert( aEdges.capacity() - aEdges.size() >= 3 );
+
+        aEdges.emplace_back( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
+        FractureEdge* split_2 = &aEdges.back();
+        aEdges.emplace_back( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
+        FractureEdge* lead1 = &aEdges.back();
+        aEdges.emplace_back( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
+        FractureEdge* lead2 = &aEdges.back();
 
-        edges.push_back( split_2 );
-        edges.push_back( lead1 );
-        edges.push_back( lead2 );
+        aBuckets.Insert( split_2 );
+        aBuckets.Insert( lead1 );
+        aBuckets.Insert( lead2 );
 
         FractureEdge* link = e_nearest->m_next;
 
+        // e_nearest only gets shorter, it stays in the buckets of its former extent
         e_nearest->m_p2 = VECTOR2I( x_nearest, y );
         e_nearest->m_next = lead1;
         lead1->m_next = edge;
@@ -736,23 +883,37 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
-    FractureEdgeSet edges;
-    FractureEdgeSet border_edges;
-    FractureEdge*   root = NULL;
-
-    bool first = true;
-
     if( paths.size() == 1 )
         return;
 
-    int num_unconnected = 0;
+    // All the edges live in one block: each hole adds 3 edges when it gets connected
+    std::vector<FractureEdge> edges;
+    FractureEdgeSet           border_edges;
+    size_t                    edgeCount = 3 * ( paths.size() - 1 );
+    int                       y_min = std::numeric_limits<int>::max();
+    int                       y_max = std::numeric_limits<int>::min();
+
+    for( const SHAPE_LINE_CHAIN& path : paths )
+    {
+        edgeCount += path.PointCount();
+
+        for( const VECTOR2I& p : path.CPoints() )
+        {
+            y_min = std::min( y_min, p.y );
+            y_max = std::max( y_max, p.y );
+        }
+    }
+
+    edges.reserve( edgeCount );
+
+    bool first = true;
 
     for( const SHAPE_LINE_CHAIN& path : paths )
     {
         const std::vector<VECTOR2I>& points = path.CPoints();
         int pointCount = points.size();
 
-        FractureEdge* prev = NULL, * first_edge = NULL;
+        size_t first_edge = edges.size();
 
         int x_min = std::numeric_limits<int>::max();
 
@@ -766,59 +927,51 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         {
             // Do not use path.CPoint() here; open-coding it using the local variables "points"
             // and "pointCount" gives a non-trivial performance boost to zone fill times.
-            FractureEdge* fe = new FractureEdge( first, points[ i ],
-                                                        points[ i+1 == pointCount ? 0 : i+1 ] );
+            edges.emplace_back( first, points[ i ], points[ i+1 == pointCount ? 0 : i+1 ] );
+            FractureEdge* fe = &edges.back();
 
-            if( !root )
-                root = fe;
-
-            if( !first_edge )
-                first_edge = fe;
-
-            if( prev )
-                prev->m_next = fe;
+            if( i > 0 )
+                edges[ edges.size() - 2 ].m_next = fe;
 
             if( i == pointCount - 1 )
-                fe->m_next = first_edge;
-
-            prev = fe;
-            edges.push_back( fe );
+                fe->m_next = &edges[ first_edge ];
 
             if( !first )
             {
                 if( fe->m_p1.x == x_min )
                     border_edges.push_back( fe );
             }
-
-            if( !fe->m_connected )
-                num_unconnected++;
         }
 
         first = false;    // first path is always the outline
     }
 
-    // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
-    {
-        int x_min = std::numeric_limits<int>::max();
+    if( edges.empty() )
+        return;
 
-        FractureEdge* smallestX = NULL;
+    FractureEdgeBuckets buckets( y_min, y_max, edgeCount );
 
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdge* border_edge : border_edges )
-        {
-            int xt = border_edge->m_p1.x;
+    for( FractureEdge& edge : edges )
+        buckets.Insert( &edge );
 
-            if( ( xt < x_min ) && !border_edge->m_connected )
-            {
-                x_min = xt;
-                smallestX = border_edge;
-            }
-        }
+    // keep connecting holes to the main outline, from the left-most one to the right-most
+    // one, until there's no holes left...  Among holes starting at the same x, the first
+    // one in the polygon goes first.
+    std::stable_sort( border_edges.begin(), border_edges.end(),
+                      []( const FractureEdge* aA, const FractureEdge* aB )
+                      {
+                          return aA->m_p1.x < aB->m_p1.x;
+                      } );
 
-        num_unconnected -= processEdge( edges, smallestX );
+    for( FractureEdge* border_edge : border_edges )
+    {
+        // Skip the other left-most edges of the holes already connected
+        if( !border_edge->m_connected )
+            processEdge( edges, buckets, border_edge );
     }
 
+    FractureEdge* root = &edges[0];
+
     paths.clear();
     SHAPE_LINE_CHAIN newPath;
 
@@ -831,21 +984,66 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.Append( e->m_p1 );
 
-    for( FractureEdge* edge : edges )
-        delete edge;
-
     paths.push_back( std::move( newPath ) );
 }
 
 
+// Below this number of holes in the whole set, fracturing on several threads does not pay
+static const size_t FRACTURE_PARALLEL_MIN_HOLES = 64;
+
+
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
+    invalidateGridPartitions();
+
+    std::vector<POLYGON*> withHoles;
+    size_t                holeCount = 0;
 
     for( POLYGON& paths : m_polys )
     {
-        fractureSingle( paths );
+        if( paths.size() > 1 )
+        {
+            withHoles.push_back( &paths );
+            holeCount += paths.size() - 1;
+        }
+    }
+
+    size_t threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                           withHoles.size() );
+
+    if( threadCount <= 1 || holeCount < FRACTURE_PARALLEL_MIN_HOLES )
+    {
+        for( POLYGON* paths : withHoles )
+            fractureSingle( *paths );
+
+        return;
     }
+
+    // The polygons are fractured independently.  Handing them out biggest first keeps the
+    // threads busy until the end.
+    std::stable_sort( withHoles.begin(), withHoles.end(),
+                      []( const POLYGON* aA, const POLYGON* aB )
+                      {
+                          return aA->size() > aB->size();
+                      } );
+
+    std::atomic<size_t> next( 0 );
+
+    auto worker =
+            [&]()
+            {
+                for( size_t i = next++; i < withHoles.size(); i = next++ )
+                    fractureSingle( *withHoles[i] );
+            };
+
+    std::vector<std::future<void>> returns( threadCount );
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, worker );
+
+    for( std::future<void>& ret : returns )
+        ret.wait();
 }
 
 
@@ -1027,6 +1225,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    invalidateGridPartitions();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1111,6 +1311,8 @@ bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
     if( tmp != "polyset" )
         return false;
 
+    invalidateGridPartitions();
+
     aStream >> tmp;
 
     int n_polys = atoi( tmp.c_str() );
@@ -1244,6 +1446,7 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    invalidateGridPartitions();
     m_polys.clear();
 }
 
@@ -1254,6 +1457,7 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
 
+    invalidateGridPartitions();
     m_polys[aPolygonIdx].erase( m_polys[aPolygonIdx].begin() + aContourIdx );
 }
 
@@ -1313,12 +1517,14 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    invalidateGridPartitions();
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    invalidateGridPartitions();
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1409,6 +1615,57 @@ void SHAPE_POLY_SET::BuildBBoxCaches()
 }
 
 
+// Contours with fewer segments are faster to test by walking their edges than with a grid
+static const int GRID_PARTITION_MIN_SEGMENTS = 64;
+
+
+void SHAPE_POLY_SET::EnableGridPartitions( int aGridSize )
+{
+    m_gridPartitionSize = std::max( aGridSize, 0 );
+    invalidateGridPartitions();
+}
+
+
+const SHAPE_POLY_SET::GRID_PARTITIONS& SHAPE_POLY_SET::gridPartitions() const
+{
+    if( m_gridPartitionsValid.load( std::memory_order_acquire ) )
+        return m_gridPartitions;
+
+    std::lock_guard<std::mutex> lock( m_gridPartitionsMutex );
+
+    // Another thread may have built them while this one was waiting
+    if( m_gridPartitionsValid.load( std::memory_order_relaxed ) )
+        return m_gridPartitions;
+
+    m_gridPartitions.clear();
+    m_gridPartitions.resize( m_polys.size() );
+
+    for( size_t ii = 0; ii < m_polys.size(); ii++ )
+    {
+        for( const SHAPE_LINE_CHAIN& contour : m_polys[ii] )
+        {
+            const BOX2I bbox = contour.BBox();
+
+            // The grid cannot partition a contour without area
+            if( contour.SegmentCount() >= GRID_PARTITION_MIN_SEGMENTS
+                    && bbox.GetWidth() > 0 && bbox.GetHeight() > 0 )
+            {
+                m_gridPartitions[ii].push_back(
+                        std::make_unique<POLY_GRID_PARTITION>( contour, m_gridPartitionSize ) );
+            }
+            else
+            {
+                m_gridPartitions[ii].push_back( nullptr );
+            }
+        }
+    }
+
+    m_gridPartitionsValid.store( true, std::memory_order_release );
+
+    return m_gridPartitions;
+}
+
+
 bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                bool aUseBBoxCaches ) const
 {
@@ -1444,6 +1701,7 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    invalidateGridPartitions();
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
@@ -1461,6 +1719,7 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
+    invalidateGridPartitions();
     m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
 }
 
@@ -1468,17 +1727,30 @@ void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                      bool aUseBBoxCaches ) const
 {
+    const std::vector<std::unique_ptr<POLY_GRID_PARTITION>>* grids = nullptr;
+
+    if( m_gridPartitionSize > 0 )
+        grids = &gridPartitions()[aSubpolyIndex];
+
+    auto pointInside =
+            [&]( int aContour, int aContourAccuracy, bool aUseBBoxCache )
+            {
+                if( grids && ( *grids )[aContour] )
+                    return ( *grids )[aContour]->PointInside( aP, aContourAccuracy );
+
+                return m_polys[aSubpolyIndex][aContour].PointInside( aP, aContourAccuracy,
+                                                                     aUseBBoxCache );
+            };
+
     // Check that the point is inside the outline
-    if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
+    if( pointInside( 0, aAccuracy, false ) )
     {
         // Check that the point is not in any of the holes
         for( int holeIdx = 0; holeIdx < HoleCount( aSubpolyIndex ); holeIdx++ )
         {
-            const SHAPE_LINE_CHAIN& hole = CHole( aSubpolyIndex, holeIdx );
-
             // If the point is inside a hole it is outside of the polygon.  Do not use aAccuracy
             // here as it's meaning would be inverted.
-            if( hole.PointInside( aP, 1, aUseBBoxCaches ) )
+            if( pointInside( holeIdx + 1, 1, aUseBBoxCaches ) )
                 return false;
         }
 
@@ -1491,6 +1763,8 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    invalidateGridPartitions();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1501,22 +1775,24 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
-    for( POLYGON& poly : m_polys )
-    {
-        for( SHAPE_LINE_CHAIN& path : poly )
-        {
-            path.Mirror( aX, aY, aRef );
-        }
-    }
+    Transform( POINT_TRANSFORM::Mirror( aX, aY, aRef ) );
 }
 
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    Transform( POINT_TRANSFORM::Rotation( aAngle, aCenter ) );
+}
+
+
+void SHAPE_POLY_SET::Transform( const POINT_TRANSFORM& aTransform )
+{
+    invalidateGridPartitions();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
-            path.Rotate( aAngle, aCenter );
+            path.Transform( aTransform );
     }
 }
 
@@ -1855,11 +2131,12 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
     m_polys = aOther.m_polys;
+    invalidateGridPartitions();
 
-    // reset poly cache:
+    // reset poly cache.  The triangulated polygons are kept for CacheTriangulation(), which
+    // reuses the ones of the outlines found again in the new polygons.
     m_hash = MD5_HASH{};
     m_triangulationValid = false;
-    m_triangulatedPolys.clear();
     return *this;
 }
 
@@ -1872,6 +2149,27 @@ MD5_HASH SHAPE_POLY_SET::GetHash() const
 }
 
 
+/**
+ * Returns the checksum of the points of aOutline, which is all its triangulation depends on.
+ */
+static MD5_HASH outlineChecksum( const SHAPE_LINE_CHAIN& aOutline )
+{
+    MD5_HASH hash;
+
+    hash.Hash( aOutline.PointCount() );
+
+    for( int i = 0; i < aOutline.PointCount(); i++ )
+    {
+        hash.Hash( aOutline.CPoint( i ).x );
+        hash.Hash( aOutline.CPoint( i ).y );
+    }
+
+    hash.Finalize();
+
+    return hash;
+}
+
+
 bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 {
     if( !m_triangulationValid )
@@ -1886,7 +2184,45 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 }
 
 
-void SHAPE_POLY_SET::CacheTriangulation()
+void SHAPE_POLY_SET::SetTriangulation(
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& aTriangulation )
+{
+    m_triangulatedPolys = std::move( aTriangulation );
+    aTriangulation.clear();
+
+    // Without holes, the triangulated polygons are the ones of the outlines
+    m_triangulationSources.assign( m_triangulatedPolys.size(), MD5_HASH() );
+
+    if( !HasHoles() && (int) m_triangulatedPolys.size() == OutlineCount() )
+    {
+        for( int ii = 0; ii < OutlineCount(); ++ii )
+            m_triangulationSources[ii] = outlineChecksum( COutline( ii ) );
+    }
+
+    m_triangulationValid = true;
+    m_hash = checksum();
+}
+
+
+bool SHAPE_POLY_SET::TriangulateOutline( int aIndex, TRIANGULATED_POLYGON& aResult ) const
+{
+    aResult.Clear();
+
+    PolygonTriangulation tess( aResult );
+
+    if( !tess.TesselatePolygon( COutline( aIndex ) ) )
+        return false;
+
+    aResult.ShrinkToFit();
+    return true;
+}
+
+
+// Below this number of vertices in the whole set, triangulating on several threads does not pay
+static const int TRIANGULATION_PARALLEL_MIN_VERTICES = 1000;
+
+
+void SHAPE_POLY_SET::CacheTriangulation( bool aParallel )
 {
     bool recalculate = !m_hash.IsValid();
     MD5_HASH hash;
@@ -1913,26 +2249,122 @@ void SHAPE_POLY_SET::CacheTriangulation()
     if( tmpSet.HasHoles() )
         tmpSet.Fracture( PM_FAST );
 
+    // The triangulations of the outlines which did not change are reused, whatever their
+    // position in the set
+    std::multimap<MD5_HASH, std::unique_ptr<TRIANGULATED_POLYGON>> previous;
+
+    for( size_t ii = 0; ii < m_triangulationSources.size(); ++ii )
+    {
+        if( m_triangulationSources[ii].IsValid() && m_triangulatedPolys[ii] )
+            previous.emplace( m_triangulationSources[ii], std::move( m_triangulatedPolys[ii] ) );
+    }
+
     m_triangulatedPolys.clear();
+    m_triangulationSources.clear();
     m_triangulationValid = true;
 
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        // The outlines are independent, so they are all triangulated at once.  The results
+        // are then taken in order up to the first failure, as if they had been computed one
+        // by one.
+        int count = tmpSet.OutlineCount();
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> results( count );
+        std::vector<MD5_HASH> sources( count );
+        std::vector<char> success( count, false );
+        std::vector<int> changed;
+        int changedVertices = 0;
+
+        for( int ii = 0; ii < count; ++ii )
+        {
+            sources[ii] = outlineChecksum( tmpSet.COutline( ii ) );
+
+            auto it = previous.find( sources[ii] );
+
+            if( it != previous.end() )
+            {
+                results[ii] = std::move( it->second );
+                success[ii] = true;
+                previous.erase( it );
+            }
+            else
+            {
+                results[ii] = std::make_unique<TRIANGULATED_POLYGON>();
+                changed.push_back( ii );
+                changedVertices += tmpSet.COutline( ii ).PointCount();
+            }
+        }
+
+        size_t threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                               changed.size() );
+
+        if( !aParallel || threadCount <= 1
+                || changedVertices < TRIANGULATION_PARALLEL_MIN_VERTICES )
+        {
+            for( int ii : changed )
+            {
+                success[ii] = tmpSet.TriangulateOutline( ii, *results[ii] );
+
+                if( !success[ii] )
+                    break;
+            }
+        }
+        else
+        {
+            std::atomic<size_t> next( 0 );
+
+            auto worker =
+                    [&]()
+                    {
+                        for( size_t ii = next++; ii < changed.size(); ii = next++ )
+                        {
+                            int outline = changed[ii];
+                            success[outline] = tmpSet.TriangulateOutline( outline,
+                                                                          *results[outline] );
+                        }
+                    };
+
+            std::vector<std::future<void>> returns( threadCount );
 
-        // If the tesselation fails, we re-fracture the polygon, which will
+            for( size_t ii = 0; ii < threadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, worker );
+
+            for( std::future<void>& ret : returns )
+                ret.wait();
+        }
+
+        int done = 0;
+
+        while( done < count && success[done] )
+        {
+            m_triangulatedPolys.push_back( std::move( results[done] ) );
+            m_triangulationSources.push_back( sources[done++] );
+        }
+
+        if( done == count )
+        {
+            m_triangulationValid = true;
+            break;
+        }
+
+        // If the tesselation fails, we re-fracture the remaining polygons, which will
         // first simplify the system before fracturing and removing the holes
         // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
+        m_triangulatedPolys.push_back( std::move( results[done] ) );
+        m_triangulationSources.emplace_back();
+
+        // The outlines after the failed one may come back unchanged from the fracture
+        for( int ii = done + 1; ii < count; ++ii )
         {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
-            continue;
+            if( success[ii] )
+                previous.emplace( sources[ii], std::move( results[ii] ) );
         }
 
-        tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
+        for( int ii = 0; ii < done; ++ii )
+            tmpSet.DeletePolygon( 0 );
+
+        tmpSet.Fracture( PM_FAST );
+        m_triangulationValid = false;
     }
 
     if( m_triangulationValid )
@@ -31,18 +31,26 @@
 #include <dialogs/dialog_create_array.h>
 
 /**
- * Transform a #BOARD_ITEM from the given #ARRAY_OPTIONS and an index into the array.
+ * Transform a #BOARD_ITEM by a transform of an #ARRAY_OPTIONS.
  *
- * @param aArrOpts The array options that describe the array
- * @param aIndex   The index in the array of this item
- * @param aItem    The item to transform
+ * @param aTransform The transform of the item array position
+ * @param aItem      The item to transform
  */
-static void TransformItem( const ARRAY_OPTIONS& aArrOpts, int aIndex, BOARD_ITEM& aItem )
+static void TransformItem( const ARRAY_OPTIONS::TRANSFORM& aTransform, BOARD_ITEM& aItem )
 {
-    const ARRAY_OPTIONS::TRANSFORM transform = aArrOpts.GetTransform( aIndex, aItem.GetPosition() );
+    if( aTransform.m_offset != VECTOR2I( 0, 0 ) )
+        aItem.Move( (wxPoint) aTransform.m_offset );
 
-    aItem.Move( (wxPoint) transform.m_offset );
-    aItem.Rotate( aItem.GetPosition(), transform.m_rotation * 10 );
+    // Rotating a footprint updates all of its items, even by a null angle
+    if( aTransform.m_rotation != 0.0 )
+        aItem.Rotate( aItem.GetPosition(), aTransform.m_rotation * 10 );
+}
+
+
+///> @return true if aTransform leaves the items where they are
+static bool IsIdentity( const ARRAY_OPTIONS::TRANSFORM& aTransform )
+{
+    return aTransform.m_offset == VECTOR2I( 0, 0 ) && aTransform.m_rotation == 0.0;
 }
 
 
@@ -80,6 +88,15 @@ void ARRAY_CREATOR::Invoke()
             item = static_cast<MODULE*>( item )->GetParent();
         }
 
+        // The transforms only depend on the position of the original item, which all the
+        // copies start from
+        std::vector<ARRAY_OPTIONS::TRANSFORM> transforms;
+
+        transforms.reserve( array_opts->GetArraySize() );
+
+        for( int ptN = 0; ptN < array_opts->GetArraySize(); ptN++ )
+            transforms.push_back( array_opts->GetTransform( ptN, item->GetPosition() ) );
+
         // The first item in list is the original item. We do not modify it
         for( int ptN = 0; ptN < array_opts->GetArraySize(); ptN++ )
         {
@@ -90,6 +107,11 @@ void ARRAY_CREATOR::Invoke()
                 // the first point: we don't own this or add it, but
                 // we might still modify it (position or label)
                 this_item = item;
+
+                if( array_opts->ShouldNumberItems() && item->Type() == PCB_PAD_T )
+                    commit.Modify( item );
+                else if( !IsIdentity( transforms[ptN] ) )
+                    commit.ModifyPlacement( item );
             }
             else
             {
@@ -156,10 +178,7 @@ void ARRAY_CREATOR::Invoke()
 
             // always transform the item
             if( this_item )
-            {
-                commit.Modify( this_item );
-                TransformItem( *array_opts, ptN, *this_item );
-            }
+                TransformItem( transforms[ptN], *this_item );
 
             // attempt to renumber items if the array parameters define
             // a complete numbering scheme to number by (as opposed to
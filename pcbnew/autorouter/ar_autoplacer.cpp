@@ -45,6 +45,10 @@
 #include "ar_autoplacer.h"
 #include "ar_cell.h"
 #include "ar_matrix.h"
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
 #include <memory>
 
 #define AR_GAIN            16
@@ -427,60 +431,132 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( MODULE* Module )
 }
 
 
-/* Test if the rectangular area (ux, ux .. y0, y1):
- * - is a free zone (except OCCUPED_By_MODULE returns)
- * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
- *
- * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+void AR_AUTOPLACER::buildPlacementSums()
+{
+    int    rows = m_matrix.m_Nrows;
+    int    cols = m_matrix.m_Ncols;
+    size_t stride = cols + 1;
+
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        std::vector<int64_t>& keepOutSums = m_keepOutSums[side];
+        std::vector<int>&     outOfBoardSums = m_outOfBoardSums[side];
+        std::vector<int>&     moduleSums = m_moduleSums[side];
+
+        if( !m_matrix.m_BoardSide[side] )
+        {
+            keepOutSums.clear();
+            outOfBoardSums.clear();
+            moduleSums.clear();
+            continue;
+        }
+
+        // The first row and the first column stay at 0
+        keepOutSums.assign( ( rows + 1 ) * stride, 0 );
+        outOfBoardSums.assign( ( rows + 1 ) * stride, 0 );
+        moduleSums.assign( ( rows + 1 ) * stride, 0 );
+
+        for( int row = 0; row < rows; row++ )
+        {
+            int64_t rowKeepOut = 0;
+            int     rowOutOfBoard = 0;
+            int     rowModule = 0;
+
+            for( int col = 0; col < cols; col++ )
+            {
+                unsigned int data = m_matrix.GetCell( row, col, side );
+                size_t       ii = ( row + 1 ) * stride + col + 1;
+
+                rowKeepOut += m_matrix.GetDist( row, col, side );
+                rowOutOfBoard += ( data & CELL_IS_ZONE ) == 0;
+                rowModule += ( data & CELL_IS_MODULE ) != 0;
+
+                keepOutSums[ii] = keepOutSums[ii - stride] + rowKeepOut;
+                outOfBoardSums[ii] = outOfBoardSums[ii - stride] + rowOutOfBoard;
+                moduleSums[ii] = moduleSums[ii - stride] + rowModule;
+            }
+        }
+    }
+}
+
+
+/**
+ * @return the sum of the cells aRowMin to aRowMax and aColMin to aColMax from the summed area
+ * table aSums of a matrix of aCols columns
  */
-int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
+template <typename T>
+static T rectangleSum( const std::vector<T>& aSums, int aCols, int aRowMin, int aRowMax,
+                       int aColMin, int aColMax )
 {
-    EDA_RECT rect = aRect;
+    size_t stride = aCols + 1;
+    size_t top = aRowMin * stride;
+    size_t bottom = ( aRowMax + 1 ) * stride;
+
+    return aSums[bottom + aColMax + 1] - aSums[top + aColMax + 1] - aSums[bottom + aColMin]
+           + aSums[top + aColMin];
+}
 
-    rect.Inflate( m_matrix.m_GridRouting / 2 );
 
-    wxPoint start   = rect.GetOrigin();
-    wxPoint end     = rect.GetEnd();
+bool AR_AUTOPLACER::getCellRange( const EDA_RECT& aRect, int& aRowMin, int& aRowMax,
+                                  int& aColMin, int& aColMax ) const
+{
+    wxPoint start   = aRect.GetOrigin();
+    wxPoint end     = aRect.GetEnd();
 
     start   -= m_matrix.m_BrdBox.GetOrigin();
     end     -= m_matrix.m_BrdBox.GetOrigin();
 
-    int row_min = start.y / m_matrix.m_GridRouting;
-    int row_max = end.y / m_matrix.m_GridRouting;
-    int col_min = start.x / m_matrix.m_GridRouting;
-    int col_max = end.x / m_matrix.m_GridRouting;
+    aRowMin = start.y / m_matrix.m_GridRouting;
+    aRowMax = end.y / m_matrix.m_GridRouting;
+    aColMin = start.x / m_matrix.m_GridRouting;
+    aColMax = end.x / m_matrix.m_GridRouting;
 
-    if( start.y > row_min * m_matrix.m_GridRouting )
-        row_min++;
+    if( start.y > aRowMin * m_matrix.m_GridRouting )
+        aRowMin++;
 
-    if( start.x > col_min * m_matrix.m_GridRouting )
-        col_min++;
+    if( start.x > aColMin * m_matrix.m_GridRouting )
+        aColMin++;
 
-    if( row_min < 0 )
-        row_min = 0;
+    if( aRowMin < 0 )
+        aRowMin = 0;
 
-    if( row_max >= ( m_matrix.m_Nrows - 1 ) )
-        row_max = m_matrix.m_Nrows - 1;
+    if( aRowMax >= ( m_matrix.m_Nrows - 1 ) )
+        aRowMax = m_matrix.m_Nrows - 1;
 
-    if( col_min < 0 )
-        col_min = 0;
+    if( aColMin < 0 )
+        aColMin = 0;
 
-    if( col_max >= ( m_matrix.m_Ncols - 1 ) )
-        col_max = m_matrix.m_Ncols - 1;
+    if( aColMax >= ( m_matrix.m_Ncols - 1 ) )
+        aColMax = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
+    return aRowMin <= aRowMax && aColMin <= aColMax;
+}
 
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
 
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
-    }
+/* Test if the rectangular area (ux, ux .. y0, y1):
+ * - is a free zone (except OCCUPED_By_MODULE returns)
+ * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
+ *
+ * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+ * The cells are counted from the tables of buildPlacementSums()
+ */
+int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side ) const
+{
+    EDA_RECT rect = aRect;
+    int      row_min, row_max, col_min, col_max;
+
+    rect.Inflate( m_matrix.m_GridRouting / 2 );
+
+    if( !getCellRange( rect, row_min, row_max, col_min, col_max ) )
+        return AR_FREE_CELL;
+
+    if( rectangleSum( m_outOfBoardSums[side], m_matrix.m_Ncols, row_min, row_max, col_min,
+                      col_max ) )
+        return AR_OUT_OF_BOARD;
+
+    if( rectangleSum( m_moduleSums[side], m_matrix.m_Ncols, row_min, row_max, col_min,
+                      col_max ) )
+        return AR_OCCUIPED_BY_MODULE;
 
     return AR_FREE_CELL;
 }
@@ -505,61 +581,28 @@ int AR_AUTOPLACER::testModuleByPolygon( MODULE* aModule, int aSide, const wxPoin
 /* Calculates and returns the clearance area of the rectangular surface
  * aRect):
  * (Sum of cells in terms of distance)
+ * The cells are summed from the tables of buildPlacementSums()
  */
-unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side )
+unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side ) const
 {
-    wxPoint start   = aRect.GetOrigin();
-    wxPoint end     = aRect.GetEnd();
-
-    start   -= m_matrix.m_BrdBox.GetOrigin();
-    end     -= m_matrix.m_BrdBox.GetOrigin();
-
-    int row_min = start.y / m_matrix.m_GridRouting;
-    int row_max = end.y / m_matrix.m_GridRouting;
-    int col_min = start.x / m_matrix.m_GridRouting;
-    int col_max = end.x / m_matrix.m_GridRouting;
-
-    if( start.y > row_min * m_matrix.m_GridRouting )
-        row_min++;
-
-    if( start.x > col_min * m_matrix.m_GridRouting )
-        col_min++;
-
-    if( row_min < 0 )
-        row_min = 0;
-
-    if( row_max >= ( m_matrix.m_Nrows - 1 ) )
-        row_max = m_matrix.m_Nrows - 1;
-
-    if( col_min < 0 )
-        col_min = 0;
-
-    if( col_max >= ( m_matrix.m_Ncols - 1 ) )
-        col_max = m_matrix.m_Ncols - 1;
-
-    unsigned int keepOutCost = 0;
+    int row_min, row_max, col_min, col_max;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
+    if( !getCellRange( aRect, row_min, row_max, col_min, col_max ) )
+        return 0;
 
-    return keepOutCost;
+    // m_matrix.GetDist returns the "cost" of the cell at position (row, col)
+    // in autoplace this is the cost of the cell, if it is inside aRect
+    return (unsigned int) rectangleSum( m_keepOutSums[side], m_matrix.m_Ncols, row_min, row_max,
+                                        col_min, col_max );
 }
 
 
 /* Test if the module can be placed on the board.
  * Returns the value TstRectangle().
- * Module is known by its bounding box
+ * Module is known by its footprint rectangle aFpRect, at its current position
  */
-int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset )
+int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, const EDA_RECT& aFpRect, bool TstOtherSide,
+                                      const wxPoint& aOffset ) const
 {
     int side = AR_SIDE_TOP;
     int otherside = AR_SIDE_BOTTOM;
@@ -569,14 +612,12 @@ int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const
         side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
     }
 
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
+    EDA_RECT    fpBBox = aFpRect;
     fpBBox.Move( -aOffset );
 
-    buildFpAreas( aModule, 0 );
-
     int diag = //testModuleByPolygon( aModule, side, aOffset );
         testRectangle( fpBBox, side );
-//printf("test %p diag %d\n", aModule, diag);fflush(0);
+
     if( diag != AR_FREE_CELL )
         return diag;
 
@@ -600,7 +641,7 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 {
     int     error = 1;
     wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    TstOtherSide;
 
     aModule->CalculateBoundingBox();
@@ -624,9 +665,6 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    auto moduleOffset = mod_pos - m_curPosition;
-
     /* Examine pads, and set TstOtherSide to true if a footprint
      * has at least 1 pad through.
      */
@@ -646,42 +684,80 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-
-    min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
+    // The footprint does not move during the search: its areas, its rectangle and the pads
+    // it connects to are computed once, as the tables of the matrix cells
+    buildFpAreas( aModule, 0 );
+    buildRatsnestTargets( aModule );
+    buildPlacementSums();
 
+    EDA_RECT fpRect = aModule->GetFootprintRect();
+    int      step = m_matrix.m_GridRouting;
+    int      colCount = 0;
+    int      rowCount = 0;
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
-    {
-        m_curPosition.y = initialPos.y;
+    if( xylimit.x > initialPos.x )
+        colCount = ( xylimit.x - initialPos.x + step - 1 ) / step;
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    if( xylimit.y > initialPos.y )
+        rowCount = ( xylimit.y - initialPos.y + step - 1 ) / step;
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            moduleOffset = mod_pos - m_curPosition;
-            int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, moduleOffset );
+    // The best position of each column of the grid, a negative score if none is free
+    std::vector<std::pair<double, wxPoint>> columnBest( colCount,
+                                                        std::make_pair( -1.0, wxPoint() ) );
+    std::atomic<int>                        nextColumn( 0 );
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
+    auto searchColumns =
+            [&]()
             {
-                error = 0;
-                // m_frame->build_ratsnest_module( aModule ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aModule, moduleOffset );
-                Score       = curr_cost + keepOutCost;
-
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                for( int ii = nextColumn++; ii < colCount; ii = nextColumn++ )
                 {
-                    LastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
+                    std::pair<double, wxPoint>& best = columnBest[ii];
+                    wxPoint                     pos( initialPos.x + ii * step, initialPos.y );
+
+                    for( int jj = 0; jj < rowCount; jj++, pos.y += step )
+                    {
+                        wxPoint moduleOffset = mod_pos - pos;
+                        int     keepOutCost = testModuleOnBoard( aModule, fpRect, TstOtherSide,
+                                                                 moduleOffset );
+
+                        if( keepOutCost < 0 )    // i.e. if the module cannot be put here
+                            continue;
+
+                        double score = computePlacementRatsnestCost( aModule, moduleOffset )
+                                       + keepOutCost;
+
+                        if( ( best.first >= score ) || ( best.first < 0 ) )
+                        {
+                            best.first = score;
+                            best.second = pos;
+                        }
+                    }
                 }
-            }
+            };
+
+    // A column of positions is a few hundred tests at most: a thread per column is enough
+    size_t parallelism = std::min<size_t>( colCount, GetKiCadThreadPool().GetThreadCount() + 1 );
+
+    if( parallelism <= 1 )
+        searchColumns();
+    else
+        GetKiCadThreadPool().RunParallel( searchColumns, parallelism );
+
+    // Merged in the order of the scan, so that the last position of the best score is kept
+    // as when the positions were tested one after the other
+    min_cost = -1.0;
+
+    for( const std::pair<double, wxPoint>& best : columnBest )
+    {
+        if( best.first < 0 )
+            continue;
+
+        error = 0;
+
+        if( ( min_cost >= best.first ) || ( min_cost < 0 ) )
+        {
+            LastPosOK   = best.second;
+            min_cost    = best.first;
         }
     }
 
@@ -693,62 +769,68 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 }
 
 
-const D_PAD* AR_AUTOPLACER::nearestPad( MODULE *aRefModule, D_PAD* aRefPad, const wxPoint& aOffset)
+void AR_AUTOPLACER::buildRatsnestTargets( MODULE* aModule )
 {
-    const D_PAD* nearest = nullptr;
-    int64_t nearestDist = INT64_MAX;
+    m_ratsnestTargets.clear();
 
-    for ( auto mod : m_board->Modules() )
+    for( auto refPad : aModule->Pads() )
     {
-        if ( mod == aRefModule )
-            continue;
+        m_ratsnestTargets.emplace_back();
 
-        if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
+        if( refPad->GetNetCode() <= 0 )
             continue;
 
-        for ( auto pad: mod->Pads() )
+        for( auto mod : m_board->Modules() )
         {
-            if ( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
+            if( mod == aModule )
                 continue;
 
-            auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+            if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
+                continue;
 
-            if ( dist < nearestDist )
+            for( auto pad : mod->Pads() )
             {
-                nearestDist = dist;
-                nearest = pad;
+                if( pad->GetNetCode() == refPad->GetNetCode() )
+                    m_ratsnestTargets.back().emplace_back( pad->GetPosition() );
             }
         }
     }
-
-    return nearest;
 }
 
 
-double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule, const wxPoint& aOffset )
+double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule,
+                                                    const wxPoint& aOffset ) const
 {
     double  curr_cost;
     VECTOR2I start;      // start point of a ratsnest
     VECTOR2I end;        // end point of a ratsnest
     int     dx, dy;
+    size_t  padIndex = 0;
 
     curr_cost = 0;
 
     for ( auto pad : aModule->Pads() )
     {
-        auto nearest = nearestPad( aModule, pad, aOffset );
+        const std::vector<VECTOR2I>& targets = m_ratsnestTargets[padIndex++];
 
-        if( !nearest )
+        if( targets.empty() )
             continue;
 
-        //printf("pad %s nearest %s\n", (const char *)aModule->GetReference().c_str(), (const char *)nearest->GetParent()->GetReference().c_str());
-
         start   = VECTOR2I( pad->GetPosition() ) - VECTOR2I(aOffset);
-        end     = VECTOR2I( nearest->GetPosition() );
 
-        //m_overlay->SetIsStroke( true );
-        //m_overlay->SetStrokeColor( COLOR4D(0.0, 1.0, 0.0, 1.0) );
-        //m_overlay->Line( start, end );
+        // The nearest pad of the net
+        int64_t nearestDist = INT64_MAX;
+
+        for( const VECTOR2I& target : targets )
+        {
+            int64_t dist = ( start - target ).EuclideanNorm();
+
+            if( dist < nearestDist )
+            {
+                nearestDist = dist;
+                end = target;
+            }
+        }
 
         // Cost of the ratsnest.
         dx  = end.x - start.x;
@@ -103,12 +103,28 @@ private:
     bool         fillMatrix();
     void         genModuleOnRoutingMatrix( MODULE* Module );
 
-    int          testRectangle( const EDA_RECT& aRect, int side );
+    /**
+     * Build the summed area tables of the routing matrix used by testRectangle() and
+     * calculateKeepOutArea(), which must be rebuilt once the matrix is changed.
+     */
+    void         buildPlacementSums();
+
+    /**
+     * Give the range of the matrix cells inside aRect.
+     * @return false if there are no such cells
+     */
+    bool         getCellRange( const EDA_RECT& aRect, int& aRowMin, int& aRowMax, int& aColMin,
+                               int& aColMax ) const;
+
+    // The placement tests of a candidate position: they only read the board and the matrix,
+    // so the positions are tested in parallel
+    int          testRectangle( const EDA_RECT& aRect, int side ) const;
     int          testModuleByPolygon( MODULE* aModule,int aSide, const wxPoint& aOffset );
-    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
-    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset );
+    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side ) const;
+    int          testModuleOnBoard( MODULE* aModule, const EDA_RECT& aFpRect, bool TstOtherSide,
+                                    const wxPoint& aOffset ) const;
     int          getOptimalModulePlacement( MODULE* aModule );
-    double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset );
+    double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset ) const;
 
     /**
      * Find the "best" module place. The criteria are:
@@ -118,7 +134,12 @@ private:
     MODULE*      pickModule();
 
     void         placeModule( MODULE* aModule, bool aDoNotRecreateRatsnest, const wxPoint& aPos );
-    const D_PAD* nearestPad( MODULE* aRefModule, D_PAD* aRefPad, const wxPoint& aOffset );
+
+    /**
+     * Fill m_ratsnestTargets with the positions of the pads of the other footprints on the
+     * board connected to each pad of aModule
+     */
+    void         buildRatsnestTargets( MODULE* aModule );
 
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void         addFpBody( wxPoint aStart, wxPoint aEnd, LSET aLayerMask );
@@ -137,6 +158,15 @@ private:
     SHAPE_POLY_SET m_fpAreaTop;         // The polygonal description of the footprint to place, top side;
     SHAPE_POLY_SET m_fpAreaBottom;      // The polygonal description of the footprint to place, bottom side;
 
+    // Summed area tables of the routing matrix, per side: the keep out cost of the cells, and
+    // the count of the cells out of the board and of the cells used by a footprint
+    std::vector<int64_t> m_keepOutSums[AR_MAX_ROUTING_LAYERS_COUNT];
+    std::vector<int>     m_outOfBoardSums[AR_MAX_ROUTING_LAYERS_COUNT];
+    std::vector<int>     m_moduleSums[AR_MAX_ROUTING_LAYERS_COUNT];
+
+    // For each pad of the footprint being placed, the pads of the other footprints of its net
+    std::vector<std::vector<VECTOR2I>> m_ratsnestTargets;
+
     BOARD* m_board;
 
     wxPoint m_curPosition;
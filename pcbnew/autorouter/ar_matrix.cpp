@@ -28,6 +28,8 @@
 #include "ar_matrix.h"
 #include "ar_cell.h"
 
+#include <algorithm>
+
 #include <common.h>
 #include <math/util.h>      // for KiROUND
 #include <math_for_graphics.h>
@@ -46,6 +48,7 @@ AR_MATRIX::AR_MATRIX()
     m_DirSide[0]         = nullptr;
     m_DirSide[1]         = nullptr;
     m_opWriteCell        = nullptr;
+    m_cellOp             = WRITE_CELL;
     m_InitMatrixDone     = false;
     m_Nrows              = 0;
     m_Ncols              = 0;
@@ -192,6 +195,53 @@ void AR_MATRIX::SetCellOperation( AR_MATRIX::CELL_OP aLogicOp )
 
     case WRITE_ADD_CELL: m_opWriteCell = &AR_MATRIX::AddCell; break;
     }
+
+    m_cellOp = aLogicOp;
+}
+
+
+void AR_MATRIX::WriteCellSpan( int aRow, int aColMin, int aColMax, int aSide, MATRIX_CELL aCell )
+{
+    if( aColMin > aColMax )
+        return;
+
+    MATRIX_CELL* row = m_BoardSide[aSide] + aRow * m_Ncols;
+    MATRIX_CELL* p = row + aColMin;
+    MATRIX_CELL* end = row + aColMax + 1;
+
+    // The operation is chosen once for the span, and the loops over the row are turned into
+    // word or vector operations by the compiler
+    switch( m_cellOp )
+    {
+    default:
+    case WRITE_CELL:
+        std::fill( p, end, aCell );
+        break;
+
+    case WRITE_OR_CELL:
+        for( ; p < end; ++p )
+            *p |= aCell;
+
+        break;
+
+    case WRITE_XOR_CELL:
+        for( ; p < end; ++p )
+            *p ^= aCell;
+
+        break;
+
+    case WRITE_AND_CELL:
+        for( ; p < end; ++p )
+            *p &= aCell;
+
+        break;
+
+    case WRITE_ADD_CELL:
+        for( ; p < end; ++p )
+            *p += aCell;
+
+        break;
+    }
 }
 
 
@@ -635,12 +685,11 @@ void AR_MATRIX::traceCircle( int ux0, int uy0, int ux1, int uy1, int lg, LAYER_N
 void AR_MATRIX::traceFilledCircle(
         int cx, int cy, int radius, LSET aLayerMask, int color, AR_MATRIX::CELL_OP op_logic )
 {
-    int    row, col;
+    int    row;
     int    ux0, uy0, ux1, uy1;
     int    row_max, col_max, row_min, col_min;
     int    trace = 0;
     double fdistmin, fdistx, fdisty;
-    int    tstwrite = 0;
     int    distmin;
 
     if( aLayerMask[m_routeLayerBottom] )
@@ -691,32 +740,54 @@ void AR_MATRIX::traceFilledCircle(
     if( col_min > col_max )
         col_max = col_min;
 
-    fdistmin = (double) distmin * distmin;
+    // The cells of a row closer to the center than aDistMin are contiguous: they are written
+    // as a span, found from both ends of the row
+    auto traceRows =
+            [&]( double aDistMin2 ) -> bool
+            {
+                bool written = false;
 
-    for( row = row_min; row <= row_max; row++ )
-    {
-        fdisty = (double) ( cy - ( row * m_GridRouting ) );
-        fdisty *= fdisty;
+                for( row = row_min; row <= row_max; row++ )
+                {
+                    fdisty = (double) ( cy - ( row * m_GridRouting ) );
+                    fdisty *= fdisty;
 
-        for( col = col_min; col <= col_max; col++ )
-        {
-            fdistx = (double) ( cx - ( col * m_GridRouting ) );
-            fdistx *= fdistx;
+                    auto inside =
+                            [&]( int aCol )
+                            {
+                                fdistx = (double) ( cx - ( aCol * m_GridRouting ) );
+                                fdistx *= fdistx;
 
-            if( fdistmin <= ( fdistx + fdisty ) )
-                continue;
+                                return aDistMin2 > ( fdistx + fdisty );
+                            };
 
-            if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
+                    int first = col_min;
+                    int last = col_max;
 
-            if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
+                    while( first <= last && !inside( first ) )
+                        first++;
 
-            tstwrite = 1;
-        }
-    }
+                    while( last > first && !inside( last ) )
+                        last--;
+
+                    if( first > last )
+                        continue;
+
+                    if( trace & 1 )
+                        WriteCellSpan( row, first, last, AR_SIDE_BOTTOM, color );
+
+                    if( trace & 2 )
+                        WriteCellSpan( row, first, last, AR_SIDE_TOP, color );
+
+                    written = true;
+                }
+
+                return written;
+            };
 
-    if( tstwrite )
+    fdistmin = (double) distmin * distmin;
+
+    if( traceRows( fdistmin ) )
         return;
 
     /* If no cell has been written, it affects the 4 neighboring diagonal
@@ -725,26 +796,7 @@ void AR_MATRIX::traceFilledCircle(
     distmin = m_GridRouting / 2 + 1;
     fdistmin = ( (double) distmin * distmin ) * 2; // Distance to center point diagonally
 
-    for( row = row_min; row <= row_max; row++ )
-    {
-        fdisty = (double) ( cy - ( row * m_GridRouting ) );
-        fdisty *= fdisty;
-
-        for( col = col_min; col <= col_max; col++ )
-        {
-            fdistx = (double) ( cx - ( col * m_GridRouting ) );
-            fdistx *= fdistx;
-
-            if( fdistmin <= ( fdistx + fdisty ) )
-                continue;
-
-            if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
-
-            if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
-        }
-    }
+    traceRows( fdistmin );
 }
 
 
@@ -888,7 +940,7 @@ void AR_MATRIX::TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1, double
 void AR_MATRIX::TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1, LSET aLayerMask,
         int color, AR_MATRIX::CELL_OP op_logic )
 {
-    int row, col;
+    int row;
     int row_min, row_max, col_min, col_max;
     int trace = 0;
 
@@ -935,14 +987,11 @@ void AR_MATRIX::TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1, LSET a
 
     for( row = row_min; row <= row_max; row++ )
     {
-        for( col = col_min; col <= col_max; col++ )
-        {
-            if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
+        if( trace & 1 )
+            WriteCellSpan( row, col_min, col_max, AR_SIDE_BOTTOM, color );
 
-            if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
-        }
+        if( trace & 2 )
+            WriteCellSpan( row, col_min, col_max, AR_SIDE_TOP, color );
     }
 }
 
@@ -69,11 +69,6 @@ public:
     PCB_LAYER_ID m_routeLayerTop;
     PCB_LAYER_ID m_routeLayerBottom;
 
-private:
-    // a pointer to the current selected cell operation
-    void ( AR_MATRIX::*m_opWriteCell )( int aRow, int aCol, int aSide, MATRIX_CELL aCell );
-
-public:
     enum CELL_OP
     {
         WRITE_CELL = 0,
@@ -83,6 +78,15 @@ public:
         WRITE_ADD_CELL = 4
     };
 
+private:
+    // a pointer to the current selected cell operation
+    void ( AR_MATRIX::*m_opWriteCell )( int aRow, int aCol, int aSide, MATRIX_CELL aCell );
+
+    // the current selected cell operation, for WriteCellSpan()
+    CELL_OP m_cellOp;
+
+public:
+
     AR_MATRIX();
     ~AR_MATRIX();
 
@@ -91,6 +95,13 @@ public:
         ( *this.*m_opWriteCell )( aRow, aCol, aSide, aCell );
     }
 
+    /**
+     * Function WriteCellSpan
+     * applies the current cell operation to the cells aColMin to aColMax of the row aRow,
+     * in one loop over the row rather than one WriteCell() call per cell.
+     */
+    void WriteCellSpan( int aRow, int aColMin, int aColMax, int aSide, MATRIX_CELL aCell );
+
     /**
      * function GetBrdCoordOrigin
      * @return the board coordinate corresponding to the
@@ -24,6 +24,8 @@
 
 #include <class_board.h>
 #include <class_module.h>
+#include <class_pad.h>
+#include <module_placement_undo_item.h>
 #include <pcb_edit_frame.h>
 #include <tool/tool_manager.h>
 #include <tools/selection_tool.h>
@@ -32,6 +34,7 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <router/pns_tool_base.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -68,9 +71,49 @@ COMMIT& BOARD_COMMIT::Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType )
             aItem = item;
     }
 
+    // A footprint staged for a change of its placement only needs a full copy now: it is the
+    // current footprint, placed back as it was
+    if( aItem && aChangeType == CHT_MODIFY )
+    {
+        COMMIT_LINE* ent = findEntry( aItem );
+
+        if( ent && ent->m_copy && ent->m_copy->Type() == MODULE_PLACEMENT_UNDO_ITEM_T )
+        {
+            auto    placement = static_cast<MODULE_PLACEMENT_UNDO_ITEM*>( ent->m_copy );
+            MODULE* copy = static_cast<MODULE*>( aItem->Clone() );
+
+            placement->Restore( copy );
+            delete placement;
+            ent->m_copy = copy;
+            return *this;
+        }
+    }
+
     return COMMIT::Stage( aItem, aChangeType );
 }
 
+
+BOARD_COMMIT& BOARD_COMMIT::ModifyPlacement( BOARD_ITEM* aItem )
+{
+    // The copies of the other items are hardly larger than a placement, and the rotation of
+    // the zones of a footprint cannot be exactly reverted
+    if( m_editModules || aItem->Type() != PCB_MODULE_T
+            || !static_cast<MODULE*>( aItem )->Zones().empty() )
+    {
+        Modify( aItem );
+        return *this;
+    }
+
+    if( m_changedItems.find( aItem ) == m_changedItems.end() )
+    {
+        makeEntry( aItem, CHT_MODIFY,
+                   new MODULE_PLACEMENT_UNDO_ITEM( static_cast<MODULE*>( aItem ) ) );
+    }
+
+    return *this;
+}
+
+
 COMMIT& BOARD_COMMIT::Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType )
 {
     return COMMIT::Stage( container, aChangeType );
@@ -81,6 +124,33 @@ COMMIT& BOARD_COMMIT::Stage( const PICKED_ITEMS_LIST& aItems, UNDO_REDO_T aModFl
     return COMMIT::Stage( aItems, aModFlag );
 }
 
+/**
+ * @return the layers of a board item, with the layers of its items for a footprint
+ */
+static LSET itemLayers( const BOARD_ITEM* aItem )
+{
+    if( aItem->Type() != PCB_MODULE_T )
+        return aItem->GetLayerSet();
+
+    const MODULE* module = static_cast<const MODULE*>( aItem );
+    LSET          layers( module->GetLayer() );
+
+    layers.set( module->Reference().GetLayer() );
+    layers.set( module->Value().GetLayer() );
+
+    for( const D_PAD* pad : module->Pads() )
+        layers |= pad->GetLayerSet();
+
+    for( const BOARD_ITEM* item : module->GraphicalItems() )
+        layers |= item->GetLayerSet();
+
+    for( const MODULE_ZONE_CONTAINER* zone : module->Zones() )
+        layers |= zone->GetLayerSet();
+
+    return layers;
+}
+
+
 void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool aSetDirtyBit )
 {
     // Objects potentially interested in changes:
@@ -92,16 +162,92 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     std::set<EDA_ITEM*> savedModules;
     SELECTION_TOOL*     selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
     bool                itemsDeselected = false;
+    std::vector<EDA_RECT> dirtyAreas;
+    LSET                  changedLayers;
+    std::vector<BOARD_ITEM*> removedItems;     // removed or modified, for the router tools
+    std::vector<BOARD_ITEM*> addedItems;       // added or modified
 
     if( Empty() )
         return;
 
+    // The large commits (pasting or deleting thousands of items, updating the board from the
+    // netlist, ...) index the new connectivity items and remove the items from the view and
+    // from the board at once, at the end: all are much faster in bulk than item by item
+    const size_t                   MIN_BULK_CHANGES = 64;
+    bool                           bulk = !m_editModules && m_changes.size() >= MIN_BULK_CHANGES;
+    std::vector<KIGFX::VIEW_ITEM*> viewRemovals;
+    std::vector<BOARD_ITEM*>       boardRemovals;
+
+    auto removeFromBoard =
+            [&]( BOARD_ITEM* aItem )
+            {
+                if( bulk )
+                    boardRemovals.push_back( aItem );
+                else
+                    board->Remove( aItem );     // handles connectivity
+            };
+
+    auto removeFromView =
+            [&]( BOARD_ITEM* aItem )
+            {
+                if( !bulk )
+                {
+                    view->Remove( aItem );
+                    return;
+                }
+
+                if( aItem->Type() == PCB_MODULE_T )
+                {
+                    static_cast<MODULE*>( aItem )->RunOnChildren(
+                            [&]( BOARD_ITEM* aChild )
+                            {
+                                viewRemovals.push_back( aChild );
+                            } );
+                }
+
+                viewRemovals.push_back( aItem );
+            };
+
+    if( bulk )
+        connectivity->BeginBulkUpdate();
+
+    // Keep track of the areas touched by the change, before and after it.  Markers are
+    // the output of the DRC, and do not need to be tested again.
+    auto addDirtyArea = [&]( const COMMIT_LINE& aEnt )
+                        {
+                            if( m_editModules || aEnt.m_item->Type() == PCB_MARKER_T )
+                                return;
+
+                            dirtyAreas.push_back( aEnt.m_item->GetBoundingBox() );
+                            changedLayers |= itemLayers( static_cast<BOARD_ITEM*>( aEnt.m_item ) );
+
+                            if( aEnt.m_copy )
+                            {
+                                dirtyAreas.push_back( aEnt.m_copy->GetBoundingBox() );
+
+                                // A placement is on the layers of the item
+                                if( aEnt.m_copy->Type() != MODULE_PLACEMENT_UNDO_ITEM_T )
+                                {
+                                    changedLayers |= itemLayers(
+                                            static_cast<BOARD_ITEM*>( aEnt.m_copy ) );
+                                }
+                            }
+                        };
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
         int changeFlags = ent.m_type & CHT_FLAGS;
         BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+        addDirtyArea( ent );
+
+        if( changeType != CHT_ADD )
+            removedItems.push_back( boardItem );
+
+        if( changeType != CHT_REMOVE )
+            addedItems.push_back( boardItem );
+
         // Module items need to be saved in the undo buffer before modification
         if( m_editModules )
         {
@@ -218,10 +364,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 case PCB_TARGET_T:              // a target (graphic item)
                 case PCB_MARKER_T:              // a marker used to show something
                 case PCB_ZONE_AREA_T:
-                    view->Remove( boardItem );
+                    removeFromView( boardItem );
 
                     if( !( changeFlags & CHT_DONE ) )
-                        board->Remove( boardItem );
+                        removeFromBoard( boardItem );
 
                     break;
 
@@ -231,11 +377,11 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     wxASSERT( !m_editModules );
 
                     MODULE* module = static_cast<MODULE*>( boardItem );
-                    view->Remove( module );
+                    removeFromView( module );
                     module->ClearFlags();
 
                     if( !( changeFlags & CHT_DONE ) )
-                        board->Remove( module );        // handles connectivity
+                        removeFromBoard( module );
                 }
                 break;
 
@@ -249,15 +395,20 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
             case CHT_MODIFY:
             {
+                wxASSERT( ent.m_copy );
+                bool placementOnly = ent.m_copy
+                                     && ent.m_copy->Type() == MODULE_PLACEMENT_UNDO_ITEM_T;
+
                 if( !m_editModules && aCreateUndoEntry )
                 {
-                    ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
-                    wxASSERT( ent.m_copy );
+                    UNDO_REDO_T status = placementOnly ? UR_PLACEMENT : UR_CHANGED;
+                    ITEM_PICKER itemWrapper( boardItem, status );
                     itemWrapper.SetLink( ent.m_copy );
                     undoList.PushItem( itemWrapper );
                 }
 
-                if( ent.m_copy )
+                // The nets of a footprint do not change with its placement
+                if( ent.m_copy && !placementOnly )
                     connectivity->MarkItemNetAsDirty( static_cast<BOARD_ITEM*>( ent.m_copy ) );
 
                 connectivity->Update( boardItem );
@@ -276,6 +427,13 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         }
     }
 
+    if( bulk )
+    {
+        board->RemoveItems( boardRemovals );
+        view->RemoveItems( viewRemovals );
+        connectivity->EndBulkUpdate();
+    }
+
     if ( !m_editModules )
     {
         size_t num_changes = m_changes.size();
@@ -295,6 +453,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 auto boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+                addDirtyArea( ent );
+                removedItems.push_back( boardItem );
+                addedItems.push_back( boardItem );
+
                 if( aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
@@ -312,20 +474,35 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         }
     }
 
+    // The modified items may have moved or changed of net
+    board->InvalidateIndexes();
+
     if( !m_editModules && aCreateUndoEntry )
         frame->SaveCopyInUndoList( undoList, UR_UNSPECIFIED );
 
+    // The router tools keep their own copy of the copper items, even when they are not running
+    if( !m_editModules )
+        PNS::TOOL_BASE::UpdateWorlds( m_toolMgr, removedItems, addedItems );
+
     m_toolMgr->PostEvent( { TC_MESSAGE, TA_MODEL_CHANGE, AS_GLOBAL } );
 
     if( itemsDeselected )
         m_toolMgr->PostEvent( EVENTS::UnselectedEvent );
 
     if( aSetDirtyBit )
-        frame->OnModify();
+    {
+        if( m_editModules )
+            frame->OnModify();
+        else
+            frame->OnModifyLayers( changedLayers );
+    }
 
     frame->UpdateMsgPanel();
 
     clear();
+
+    if( !dirtyAreas.empty() )
+        frame->OnBoardItemsChanged( dirtyAreas );
 }
 
 
@@ -388,6 +565,17 @@ void BOARD_COMMIT::Revert()
 
         case CHT_MODIFY:
         {
+            if( ent.m_copy->Type() == MODULE_PLACEMENT_UNDO_ITEM_T )
+            {
+                auto placement = static_cast<MODULE_PLACEMENT_UNDO_ITEM*>( ent.m_copy );
+
+                placement->Restore( static_cast<MODULE*>( item ) );
+                view->Update( item );
+                connectivity->Update( item );
+                delete placement;
+                break;
+            }
+
             view->Remove( item );
             connectivity->Remove( item );
 
@@ -405,6 +593,8 @@ void BOARD_COMMIT::Revert()
         }
     }
 
+    board->InvalidateIndexes();
+
     if ( !m_editModules )
         connectivity->RecalculateRatsnest();
 
@@ -46,10 +46,16 @@ public:
                        bool aCreateUndoEntry = true, bool aSetDirtyBit = true ) override;
 
     virtual void Revert() override;
-    COMMIT&      Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType ) override;
-    COMMIT&      Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType ) override;
-    COMMIT&      Stage(
-                 const PICKED_ITEMS_LIST& aItems, UNDO_REDO_T aModFlag = UR_UNSPECIFIED ) override;
+
+    ///> Modifies the position or the orientation of an item only, as moving or rotating it
+    ///> does.  Must be called before the modification is performed.  The undo entry of a
+    ///> footprint holds its placement then, instead of a copy of the footprint.
+    BOARD_COMMIT& ModifyPlacement( BOARD_ITEM* aItem );
+
+    COMMIT&      Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType ) override;
+    COMMIT&      Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType ) override;
+    COMMIT&      Stage(
+                 const PICKED_ITEMS_LIST& aItems, UNDO_REDO_T aModFlag = UR_UNSPECIFIED ) override;
 
 private:
     TOOL_MANAGER* m_toolMgr;
@@ -539,12 +539,76 @@ void TRACK::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 }
 
 
+PAD_SHAPE_KEY D_PAD::shapeKey( int aClearanceValue, int aError ) const
+{
+    PAD_SHAPE_KEY key;
+
+    key.m_Clearance = aClearanceValue;
+    key.m_Error = aError;
+    key.m_Shape = GetShape();
+    key.m_Pos = m_Pos;
+    key.m_Offset = m_Offset;
+    key.m_Size = m_Size;
+    key.m_Delta = m_DeltaSize;
+    key.m_Orient = m_Orient;
+    key.m_RoundRectRatio = m_padRoundRectRadiusScale;
+    key.m_ChamferRatio = m_padChamferRectScale;
+    key.m_ChamferPositions = m_chamferPositions;
+    key.m_CustomShapeVersion = m_customShapeVersion;
+
+    return key;
+}
+
+
 void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
                                                   int aClearanceValue, int aError,
                                                   bool ignoreLineWidth ) const
 {
     wxASSERT_MSG( !ignoreLineWidth, "IgnoreLineWidth has no meaning for pads." );
 
+    // The circles and ovals are built faster than they would be copied from the cache, and
+    // so are the rectangles without clearance
+    bool cached = false;
+
+    switch( GetShape() )
+    {
+    case PAD_SHAPE_TRAPEZOID:
+    case PAD_SHAPE_RECT:
+        cached = aClearanceValue != 0;
+        break;
+
+    case PAD_SHAPE_CHAMFERED_RECT:
+    case PAD_SHAPE_ROUNDRECT:
+    case PAD_SHAPE_CUSTOM:
+        cached = true;
+        break;
+
+    default:
+        break;
+    }
+
+    if( !cached )
+    {
+        buildShapeWithClearance( aCornerBuffer, aClearanceValue, aError );
+        return;
+    }
+
+    PAD_SHAPE_KEY key = shapeKey( aClearanceValue, aError );
+
+    if( m_shapeCache.Get( key, aCornerBuffer ) )
+        return;
+
+    SHAPE_POLY_SET shape;
+
+    buildShapeWithClearance( shape, aClearanceValue, aError );
+    aCornerBuffer.Append( shape );
+    m_shapeCache.Store( key, shape );
+}
+
+
+void D_PAD::buildShapeWithClearance( SHAPE_POLY_SET& aCornerBuffer, int aClearanceValue,
+                                     int aError ) const
+{
     // minimal segment count to approximate a circle to create the polygonal pad shape
     // This minimal value is mainly for very small pads, like SM0402.
     // Most of time pads are using the segment count given by aError value.
@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board_memory_usage.h>
+
+#include <class_dimension.h>
+#include <class_drawsegment.h>
+#include <class_edge_mod.h>
+#include <class_marker_pcb.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_pcb_target.h>
+#include <class_pcb_text.h>
+#include <class_text_mod.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <module_placement_undo_item.h>
+#include <undo_redo_container.h>
+
+
+size_t PolySetMemoryUsage( const SHAPE_POLY_SET& aPolySet )
+{
+    // A SHAPE_LINE_CHAIN stores a point and a shape index per vertex
+    size_t bytes = aPolySet.TotalVertices() * ( sizeof( VECTOR2I ) + sizeof( ssize_t ) );
+
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ii++ )
+        bytes += aPolySet.CPolygon( ii ).capacity() * sizeof( SHAPE_LINE_CHAIN );
+
+    for( unsigned ii = 0; ii < aPolySet.TriangulatedPolyCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri = aPolySet.TriangulatedPolygon( ii );
+
+        bytes += sizeof( *tri );
+        bytes += tri->Vertices().capacity() * sizeof( VECTOR2I );
+        bytes += tri->Triangles().capacity() * sizeof( SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI );
+    }
+
+    return bytes;
+}
+
+
+static size_t textMemoryUsage( const EDA_TEXT* aText )
+{
+    return aText->GetText().length() * sizeof( wxChar );
+}
+
+
+size_t BoardItemMemoryUsage( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t        bytes = sizeof( MODULE );
+
+        bytes += BoardItemMemoryUsage( &module->Reference() );
+        bytes += BoardItemMemoryUsage( &module->Value() );
+
+        for( const D_PAD* pad : module->Pads() )
+            bytes += BoardItemMemoryUsage( pad );
+
+        for( const BOARD_ITEM* item : module->GraphicalItems() )
+            bytes += BoardItemMemoryUsage( item );
+
+        for( const MODULE_ZONE_CONTAINER* zone : module->Zones() )
+            bytes += BoardItemMemoryUsage( zone );
+
+        bytes += module->Models().size() * sizeof( MODULE_3D_SETTINGS );
+
+        return bytes;
+    }
+
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        return sizeof( D_PAD ) + pad->GetPrimitives().capacity() * sizeof( PAD_CS_PRIMITIVE )
+               + PolySetMemoryUsage( pad->GetCustomShapeAsPolygon() );
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+        size_t             bytes = aItem->Type() == PCB_LINE_T ? sizeof( DRAWSEGMENT )
+                                                               : sizeof( EDGE_MODULE );
+
+        return bytes + segment->GetBezierPoints().capacity() * sizeof( wxPoint )
+               + PolySetMemoryUsage( segment->GetPolyShape() );
+    }
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB ) + textMemoryUsage( static_cast<const TEXTE_PCB*>( aItem ) );
+
+    case PCB_MODULE_TEXT_T:
+        return sizeof( TEXTE_MODULE )
+               + textMemoryUsage( static_cast<const TEXTE_MODULE*>( aItem ) );
+
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+        size_t                bytes = sizeof( ZONE_CONTAINER );
+
+        if( zone->Outline() )
+            bytes += PolySetMemoryUsage( *zone->Outline() );
+
+        return bytes + zone->GetHatchLines().capacity() * sizeof( SEG );
+    }
+
+    case PCB_TRACE_T: return sizeof( TRACK );
+    case PCB_ARC_T:   return sizeof( ARC );
+    case PCB_VIA_T:   return sizeof( VIA );
+
+    case PCB_DIMENSION_T:
+        return sizeof( DIMENSION )
+               + textMemoryUsage( &static_cast<const DIMENSION*>( aItem )->Text() );
+
+    case PCB_TARGET_T: return sizeof( PCB_TARGET );
+    case PCB_MARKER_T: return sizeof( MARKER_PCB );
+
+    default:
+        return sizeof( BOARD_ITEM );
+    }
+}
+
+
+size_t ZoneFillMemoryUsage( const ZONE_CONTAINER* aZone )
+{
+    return PolySetMemoryUsage( aZone->GetFilledPolysList() )
+           + aZone->FillSegments().capacity() * sizeof( SEG );
+}
+
+
+size_t PickedItemsMemoryUsage( const PICKED_ITEMS_LIST& aList )
+{
+    size_t bytes = sizeof( PICKED_ITEMS_LIST ) + aList.GetCount() * sizeof( ITEM_PICKER );
+
+    auto itemUsage =
+            []( const EDA_ITEM* aItem ) -> size_t
+            {
+                if( aItem->Type() == MODULE_PLACEMENT_UNDO_ITEM_T )
+                    return sizeof( MODULE_PLACEMENT_UNDO_ITEM );
+
+                const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+                if( !item )
+                    return 0;
+
+                size_t itemBytes = BoardItemMemoryUsage( item );
+
+                if( item->Type() == PCB_ZONE_AREA_T )
+                    itemBytes += ZoneFillMemoryUsage( static_cast<const ZONE_CONTAINER*>( item ) );
+
+                return itemBytes;
+            };
+
+    for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
+    {
+        // The copies of the changed items, and the deleted items, belong to the command
+        if( EDA_ITEM* link = aList.GetPickedItemLink( ii ) )
+            bytes += itemUsage( link );
+
+        if( aList.GetPickedItemStatus( ii ) == UR_DELETED && aList.GetPickedItem( ii ) )
+            bytes += itemUsage( aList.GetPickedItem( ii ) );
+    }
+
+    return bytes;
+}
@@ -0,0 +1,67 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_memory_usage.h
+ * @brief Estimates of the memory used by the board items, for MEMORY_USAGE.
+ */
+
+#ifndef BOARD_MEMORY_USAGE_H
+#define BOARD_MEMORY_USAGE_H
+
+#include <cstddef>
+
+class BOARD_ITEM;
+class PICKED_ITEMS_LIST;
+class SHAPE_POLY_SET;
+class ZONE_CONTAINER;
+
+///> Memory categories of the boards
+#define MEMORY_BOARD_ITEMS        "Board items"
+#define MEMORY_ZONE_FILLS         "Zone fills"
+#define MEMORY_CONNECTIVITY       "Connectivity"
+#define MEMORY_UNDO_STACK         "Undo stack"
+#define MEMORY_FOOTPRINT_CACHES   "Footprint caches"
+
+/**
+ * @return the bytes of the outlines and of the triangulation of aPolySet
+ */
+size_t PolySetMemoryUsage( const SHAPE_POLY_SET& aPolySet );
+
+/**
+ * @return the bytes of aItem and of its children (the items of a footprint), excluding the
+ * fill of the zones, which is given by ZoneFillMemoryUsage()
+ */
+size_t BoardItemMemoryUsage( const BOARD_ITEM* aItem );
+
+/**
+ * @return the bytes of the filled areas and of the fill segments of aZone
+ */
+size_t ZoneFillMemoryUsage( const ZONE_CONTAINER* aZone );
+
+/**
+ * @return the bytes of the item copies and of the deleted items held by an undo command
+ */
+size_t PickedItemsMemoryUsage( const PICKED_ITEMS_LIST& aList );
+
+#endif // BOARD_MEMORY_USAGE_H
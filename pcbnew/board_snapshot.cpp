@@ -0,0 +1,721 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board_snapshot.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <kicad_plugin.h>
+#include <macros.h>
+#include <pcb_parser.h>
+#include <richio.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+///> Version of the layout, a snapshot of another version is ignored
+static const uint32_t BOARD_SNAPSHOT_VERSION = 1;
+
+static const char     BOARD_SNAPSHOT_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', 'S', 'N', 'P' };
+
+///> Written in the native byte order, so that a snapshot from another machine is ignored
+static const uint32_t BOARD_SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+
+/*
+ * The snapshot is a header, a table of sections and the sections, each starting on an
+ * 8 byte boundary.  All the sections but TEXT and NETS are arrays of the records below.
+ */
+enum SNAPSHOT_SECTION_TYPE : uint32_t
+{
+    SNAP_TEXT,      ///< the board file, without its tracks and board zone fills
+    SNAP_NETS,      ///< the net names (UTF8, nul terminated), indexed by the saved net codes
+    SNAP_TRACKS,    ///< SNAPSHOT_TRACK records, in the order of BOARD::Tracks()
+    SNAP_FILLS,     ///< SNAPSHOT_FILL records
+    SNAP_CHAINS,    ///< SNAPSHOT_CHAIN records, the outlines and holes of the fills
+    SNAP_POINTS,    ///< SNAPSHOT_POINT records, the points of the chains
+    SNAP_SECTION_COUNT
+};
+
+
+struct SNAPSHOT_HEADER
+{
+    char     m_magic[8];
+    uint32_t m_version;
+    uint32_t m_byteOrder;
+    uint64_t m_boardSize;       ///< of the board file the snapshot was written with
+    uint64_t m_boardHash;       ///< of the board file the snapshot was written with
+    uint32_t m_sectionCount;
+    uint32_t m_reserved;
+};
+
+
+struct SNAPSHOT_SECTION
+{
+    uint32_t m_type;
+    uint32_t m_count;           ///< of records, or of net names
+    uint64_t m_offset;          ///< from the start of the file
+    uint64_t m_size;            ///< in bytes
+};
+
+
+enum SNAPSHOT_TRACK_TYPE : uint8_t
+{
+    SNAP_SEGMENT,
+    SNAP_ARC,
+    SNAP_VIA
+};
+
+
+struct SNAPSHOT_TRACK
+{
+    uint8_t  m_type;            ///< SNAPSHOT_TRACK_TYPE
+    uint8_t  m_viaType;         ///< VIATYPE of a via
+    uint8_t  m_layer;           ///< the layer, or the top layer of a via
+    uint8_t  m_bottomLayer;     ///< the bottom layer of a via
+    int32_t  m_net;             ///< index in the SNAP_NETS section
+    int32_t  m_start[2];
+    int32_t  m_mid[2];          ///< of an arc
+    int32_t  m_end[2];
+    int32_t  m_width;
+    int32_t  m_drill;           ///< of a via, may be UNDEFINED_DRILL_DIAMETER
+    uint32_t m_status;
+    uint32_t m_reserved;
+    char     m_uuid[40];        ///< nul terminated KIID string
+};
+
+
+struct SNAPSHOT_FILL
+{
+    char     m_uuid[40];        ///< of the zone, checked against the zone read from the text
+    uint32_t m_zone;            ///< index of the zone in BOARD::Zones()
+    uint32_t m_firstChain;
+    uint32_t m_chainCount;
+    uint32_t m_reserved;
+};
+
+
+struct SNAPSHOT_CHAIN
+{
+    uint32_t m_polygon;         ///< index of the polygon in the fill
+    uint32_t m_hole;            ///< 0 for the outline, 1 + the hole index for a hole
+    uint32_t m_firstPoint;
+    uint32_t m_pointCount;
+};
+
+
+struct SNAPSHOT_POINT
+{
+    int32_t  m_x;
+    int32_t  m_y;
+};
+
+
+static_assert( sizeof( SNAPSHOT_HEADER ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+static_assert( sizeof( SNAPSHOT_SECTION ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+static_assert( sizeof( SNAPSHOT_TRACK ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+static_assert( sizeof( SNAPSHOT_FILL ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+static_assert( sizeof( SNAPSHOT_CHAIN ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+static_assert( sizeof( SNAPSHOT_POINT ) % 8 == 0, "snapshot records must be 8 byte aligned" );
+
+
+/**
+ * Computes the size and a 64 bit hash of the content of the file aFileName.  This is only
+ * meant to notice that the board file was changed by something else than pcbnew.
+ */
+static bool hashFile( const wxString& aFileName, uint64_t& aSize, uint64_t& aHash )
+{
+    wxFFile file( aFileName, wxT( "rb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    // FNV-1a on 64 bit words, with a shift to bring the high bits down
+    std::vector<unsigned char> buffer( 1 << 20 );
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t size = 0;
+    size_t   length;
+
+    while( ( length = file.Read( buffer.data(), buffer.size() ) ) > 0 )
+    {
+        size_t ii = 0;
+
+        for( ; ii + 8 <= length; ii += 8 )
+        {
+            uint64_t word;
+
+            memcpy( &word, &buffer[ii], 8 );
+            hash = ( hash ^ word ) * 1099511628211ull;
+            hash ^= hash >> 32;
+        }
+
+        for( ; ii < length; ++ii )
+            hash = ( hash ^ buffer[ii] ) * 1099511628211ull;
+
+        size += length;
+    }
+
+    if( file.Error() )
+        return false;
+
+    aSize = size;
+    aHash = hash ^ size;
+    return true;
+}
+
+
+static void setUuid( char* aDest, const KIID& aUuid )
+{
+    wxString uuid = aUuid.AsString();
+
+    memset( aDest, 0, 40 );
+    strncpy( aDest, uuid.ToAscii(), 39 );
+}
+
+
+static wxString getUuid( const char* aSource )
+{
+    return wxString::FromAscii( aSource, strnlen( aSource, 39 ) );
+}
+
+
+/**
+ * SNAPSHOT_IO
+ * formats a board without its tracks and board zone fills, and gives the net codes used
+ * in the text.
+ */
+class SNAPSHOT_IO : public PCB_IO
+{
+public:
+    SNAPSHOT_IO() :
+            PCB_IO( CTL_FOR_BOARD | CTL_OMIT_TRACKS | CTL_OMIT_ZONE_FILLS )
+    {
+    }
+
+    std::string FormatBoard( BOARD* aBoard )
+    {
+        LOCALE_IO toggle;
+
+        m_board = aBoard;
+        m_mapping->SetBoard( aBoard );
+        m_sf.Clear();
+        m_out = &m_sf;
+
+        m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew snapshot)\n",
+                      SEXPR_BOARD_FILE_VERSION );
+        Format( aBoard, 1 );
+        m_out->Print( 0, ")\n" );
+
+        return GetStringOutput( true );
+    }
+
+    ///> @return the net names, indexed by the net codes written in the text
+    std::vector<std::string> NetNames() const
+    {
+        std::vector<std::string> names;
+
+        for( NETINFO_ITEM* net : *m_mapping )
+        {
+            size_t code = (size_t) m_mapping->Translate( net->GetNet() );
+
+            if( code >= names.size() )
+                names.resize( code + 1 );
+
+            names[code] = TO_UTF8( net->GetNetname() );
+        }
+
+        return names;
+    }
+
+    int NetCode( int aNetCode ) const
+    {
+        return m_mapping->Translate( aNetCode );
+    }
+};
+
+
+wxString BOARD_SNAPSHOT::GetSnapshotFileName( const wxString& aBoardFileName )
+{
+    wxFileName fn( aBoardFileName );
+
+    fn.SetExt( wxT( "board-snapshot" ) );
+
+    return fn.GetFullPath();
+}
+
+
+/// Appends the records aRecords to the image aImage, as a new section of aSections
+template <typename RECORD>
+static void appendSection( std::vector<char>& aImage, std::vector<SNAPSHOT_SECTION>& aSections,
+                           uint32_t aType, const RECORD* aRecords, size_t aCount, size_t aSize )
+{
+    SNAPSHOT_SECTION section;
+
+    section.m_type = aType;
+    section.m_count = (uint32_t) aCount;
+    section.m_offset = aImage.size();
+    section.m_size = aSize;
+
+    const char* data = reinterpret_cast<const char*>( aRecords );
+
+    aImage.insert( aImage.end(), data, data + aSize );
+    aImage.resize( ( aImage.size() + 7 ) & ~size_t( 7 ), 0 );
+    aSections.push_back( section );
+}
+
+
+bool BOARD_SNAPSHOT::Save( BOARD* aBoard, const wxString& aBoardFileName )
+{
+    SNAPSHOT_HEADER header;
+
+    memcpy( header.m_magic, BOARD_SNAPSHOT_MAGIC, sizeof( header.m_magic ) );
+    header.m_version = BOARD_SNAPSHOT_VERSION;
+    header.m_byteOrder = BOARD_SNAPSHOT_BYTE_ORDER;
+    header.m_sectionCount = SNAP_SECTION_COUNT;
+    header.m_reserved = 0;
+
+    if( !hashFile( aBoardFileName, header.m_boardSize, header.m_boardHash ) )
+        return false;
+
+    SNAPSHOT_IO io;
+    std::string text;
+
+    try
+    {
+        text = io.FormatBoard( aBoard );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    std::string netNames;
+    std::vector<std::string> names = io.NetNames();
+
+    for( const std::string& name : names )
+        netNames.append( name.c_str(), name.size() + 1 );
+
+    std::vector<SNAPSHOT_TRACK> tracks;
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        SNAPSHOT_TRACK record;
+
+        memset( &record, 0, sizeof( record ) );
+
+        record.m_layer = (uint8_t) track->GetLayer();
+        record.m_net = io.NetCode( track->GetNetCode() );
+        record.m_start[0] = track->GetStart().x;
+        record.m_start[1] = track->GetStart().y;
+        record.m_end[0] = track->GetEnd().x;
+        record.m_end[1] = track->GetEnd().y;
+        record.m_width = track->GetWidth();
+        record.m_status = track->GetStatus();
+        setUuid( record.m_uuid, track->m_Uuid );
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            VIA*         via = static_cast<VIA*>( track );
+            PCB_LAYER_ID top, bottom;
+
+            via->LayerPair( &top, &bottom );
+
+            record.m_type = SNAP_VIA;
+            record.m_viaType = (uint8_t) via->GetViaType();
+            record.m_layer = (uint8_t) top;
+            record.m_bottomLayer = (uint8_t) bottom;
+            record.m_drill = via->GetDrill();
+        }
+        else if( track->Type() == PCB_ARC_T )
+        {
+            ARC* arc = static_cast<ARC*>( track );
+
+            record.m_type = SNAP_ARC;
+            record.m_mid[0] = arc->GetMid().x;
+            record.m_mid[1] = arc->GetMid().y;
+        }
+        else
+        {
+            record.m_type = SNAP_SEGMENT;
+        }
+
+        tracks.push_back( record );
+    }
+
+    std::vector<SNAPSHOT_FILL>  fills;
+    std::vector<SNAPSHOT_CHAIN> chains;
+    std::vector<SNAPSHOT_POINT> points;
+
+    for( int zoneIdx = 0; zoneIdx < aBoard->GetAreaCount(); ++zoneIdx )
+    {
+        ZONE_CONTAINER*       zone = aBoard->GetArea( zoneIdx );
+        const SHAPE_POLY_SET& polys = zone->GetFilledPolysList();
+
+        if( polys.IsEmpty() )
+            continue;
+
+        SNAPSHOT_FILL fill;
+
+        memset( &fill, 0, sizeof( fill ) );
+        setUuid( fill.m_uuid, zone->m_Uuid );
+        fill.m_zone = (uint32_t) zoneIdx;
+        fill.m_firstChain = (uint32_t) chains.size();
+
+        for( int ii = 0; ii < polys.OutlineCount(); ++ii )
+        {
+            for( int jj = 0; jj <= polys.HoleCount( ii ); ++jj )
+            {
+                const SHAPE_LINE_CHAIN& chain = jj ? polys.CHole( ii, jj - 1 )
+                                                   : polys.COutline( ii );
+                SNAPSHOT_CHAIN          record;
+
+                record.m_polygon = (uint32_t) ii;
+                record.m_hole = (uint32_t) jj;
+                record.m_firstPoint = (uint32_t) points.size();
+                record.m_pointCount = (uint32_t) chain.PointCount();
+
+                for( int kk = 0; kk < chain.PointCount(); ++kk )
+                    points.push_back( { chain.CPoint( kk ).x, chain.CPoint( kk ).y } );
+
+                chains.push_back( record );
+            }
+        }
+
+        fill.m_chainCount = (uint32_t) chains.size() - fill.m_firstChain;
+        fills.push_back( fill );
+    }
+
+    std::vector<char>             image( sizeof( header ) + SNAP_SECTION_COUNT
+                                         * sizeof( SNAPSHOT_SECTION ), 0 );
+    std::vector<SNAPSHOT_SECTION> sections;
+
+    appendSection( image, sections, SNAP_TEXT, text.data(), text.size(), text.size() );
+    appendSection( image, sections, SNAP_NETS, netNames.data(), names.size(), netNames.size() );
+    appendSection( image, sections, SNAP_TRACKS, tracks.data(), tracks.size(),
+                   tracks.size() * sizeof( SNAPSHOT_TRACK ) );
+    appendSection( image, sections, SNAP_FILLS, fills.data(), fills.size(),
+                   fills.size() * sizeof( SNAPSHOT_FILL ) );
+    appendSection( image, sections, SNAP_CHAINS, chains.data(), chains.size(),
+                   chains.size() * sizeof( SNAPSHOT_CHAIN ) );
+    appendSection( image, sections, SNAP_POINTS, points.data(), points.size(),
+                   points.size() * sizeof( SNAPSHOT_POINT ) );
+
+    memcpy( image.data(), &header, sizeof( header ) );
+    memcpy( image.data() + sizeof( header ), sections.data(),
+            sections.size() * sizeof( SNAPSHOT_SECTION ) );
+
+    wxFFile file( GetSnapshotFileName( aBoardFileName ), wxT( "wb" ) );
+
+    if( !file.IsOpened() || file.Write( image.data(), image.size() ) != image.size() )
+        return false;
+
+    return file.Close();
+}
+
+
+/**
+ * SNAPSHOT_IMAGE
+ * is the content of a snapshot file, with checked access to its sections.
+ */
+class SNAPSHOT_IMAGE
+{
+public:
+    bool Read( const wxString& aFileName )
+    {
+        wxFFile file( aFileName, wxT( "rb" ) );
+
+        if( !file.IsOpened() )
+            return false;
+
+        wxFileOffset length = file.Length();
+
+        if( length < (wxFileOffset) sizeof( SNAPSHOT_HEADER ) )
+            return false;
+
+        // uint64_t storage keeps the records aligned
+        m_storage.resize( ( (size_t) length + 7 ) / 8 );
+        m_size = (size_t) length;
+
+        if( file.Read( m_storage.data(), m_size ) != m_size )
+            return false;
+
+        const SNAPSHOT_HEADER& header = Header();
+
+        if( memcmp( header.m_magic, BOARD_SNAPSHOT_MAGIC, sizeof( header.m_magic ) )
+                || header.m_version != BOARD_SNAPSHOT_VERSION
+                || header.m_byteOrder != BOARD_SNAPSHOT_BYTE_ORDER
+                || header.m_sectionCount != SNAP_SECTION_COUNT
+                || sizeof( SNAPSHOT_HEADER )
+                           + SNAP_SECTION_COUNT * sizeof( SNAPSHOT_SECTION ) > m_size )
+        {
+            return false;
+        }
+
+        for( uint32_t ii = 0; ii < SNAP_SECTION_COUNT; ++ii )
+        {
+            const SNAPSHOT_SECTION& section = Section( ii );
+
+            if( section.m_type != ii || section.m_offset % 8 || section.m_offset > m_size
+                    || section.m_size > m_size - section.m_offset )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const SNAPSHOT_HEADER& Header() const
+    {
+        return *reinterpret_cast<const SNAPSHOT_HEADER*>( m_storage.data() );
+    }
+
+    const SNAPSHOT_SECTION& Section( uint32_t aType ) const
+    {
+        const char* base = reinterpret_cast<const char*>( m_storage.data() );
+
+        return reinterpret_cast<const SNAPSHOT_SECTION*>( base + sizeof( SNAPSHOT_HEADER ) )[aType];
+    }
+
+    const char* Data( uint32_t aType ) const
+    {
+        return reinterpret_cast<const char*>( m_storage.data() ) + Section( aType ).m_offset;
+    }
+
+    /**
+     * @return the records of the section aType, or nullptr if the size of the section is not
+     *         the one of its records
+     */
+    template <typename RECORD>
+    const RECORD* Records( uint32_t aType ) const
+    {
+        const SNAPSHOT_SECTION& section = Section( aType );
+
+        if( section.m_size != (uint64_t) section.m_count * sizeof( RECORD ) )
+            return nullptr;
+
+        return reinterpret_cast<const RECORD*>( Data( aType ) );
+    }
+
+private:
+    std::vector<uint64_t> m_storage;
+    size_t                m_size = 0;
+};
+
+
+BOARD* BOARD_SNAPSHOT::Load( const wxString& aBoardFileName )
+{
+    SNAPSHOT_IMAGE image;
+    uint64_t       boardSize;
+    uint64_t       boardHash;
+
+    if( !image.Read( GetSnapshotFileName( aBoardFileName ) ) )
+        return nullptr;
+
+    if( !hashFile( aBoardFileName, boardSize, boardHash )
+            || boardSize != image.Header().m_boardSize
+            || boardHash != image.Header().m_boardHash )
+    {
+        return nullptr;     // the board file was changed since the snapshot was written
+    }
+
+    const SNAPSHOT_TRACK* tracks = image.Records<SNAPSHOT_TRACK>( SNAP_TRACKS );
+    const SNAPSHOT_FILL*  fills = image.Records<SNAPSHOT_FILL>( SNAP_FILLS );
+    const SNAPSHOT_CHAIN* chains = image.Records<SNAPSHOT_CHAIN>( SNAP_CHAINS );
+    const SNAPSHOT_POINT* points = image.Records<SNAPSHOT_POINT>( SNAP_POINTS );
+
+    if( !tracks || !fills || !chains || !points )
+        return nullptr;
+
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        LOCALE_IO          toggle;
+        const SNAPSHOT_SECTION& textSection = image.Section( SNAP_TEXT );
+        STRING_LINE_READER reader( std::string( image.Data( SNAP_TEXT ), textSection.m_size ),
+                                   aBoardFileName );
+        PCB_PARSER         parser;
+
+        parser.SetLineReader( &reader );
+
+        BOARD_ITEM* item = parser.Parse();
+
+        board.reset( dynamic_cast<BOARD*>( item ) );
+
+        if( !board )
+        {
+            delete item;
+            return nullptr;
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        return nullptr;
+    }
+
+    // The nets of the saved net codes
+    std::vector<NETINFO_ITEM*> nets;
+    const SNAPSHOT_SECTION&    netSection = image.Section( SNAP_NETS );
+    const char*                name = image.Data( SNAP_NETS );
+    const char*                namesEnd = name + netSection.m_size;
+
+    for( uint32_t ii = 0; ii < netSection.m_count; ++ii )
+    {
+        const char* end = static_cast<const char*>( memchr( name, 0, namesEnd - name ) );
+
+        if( !end )
+            return nullptr;
+
+        // The unconnected net has an empty name
+        NETINFO_ITEM* net = end == name ? board->FindNet( NETINFO_LIST::UNCONNECTED )
+                                        : board->FindNet( wxString::FromUTF8( name, end - name ) );
+
+        if( !net )
+            return nullptr;
+
+        nets.push_back( net );
+        name = end + 1;
+    }
+
+    const SNAPSHOT_TRACK* tracksEnd = tracks + image.Section( SNAP_TRACKS ).m_count;
+
+    for( const SNAPSHOT_TRACK* record = tracks; record < tracksEnd; ++record )
+    {
+        if( record->m_net < 0 || (size_t) record->m_net >= nets.size()
+                || record->m_layer >= PCB_LAYER_ID_COUNT
+                || record->m_bottomLayer >= PCB_LAYER_ID_COUNT )
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<TRACK> track;
+        wxPoint                start( record->m_start[0], record->m_start[1] );
+        wxPoint                end( record->m_end[0], record->m_end[1] );
+
+        switch( record->m_type )
+        {
+        case SNAP_SEGMENT:
+            track.reset( new TRACK( board.get() ) );
+            track->SetLayer( (PCB_LAYER_ID) record->m_layer );
+            break;
+
+        case SNAP_ARC:
+        {
+            ARC* arc = new ARC( board.get() );
+
+            track.reset( arc );
+            arc->SetMid( wxPoint( record->m_mid[0], record->m_mid[1] ) );
+            arc->SetLayer( (PCB_LAYER_ID) record->m_layer );
+            break;
+        }
+
+        case SNAP_VIA:
+        {
+            VIA* via = new VIA( board.get() );
+
+            track.reset( via );
+            via->SetViaType( (VIATYPE) record->m_viaType );
+            via->SetDrill( record->m_drill );
+            via->SetLayerPair( (PCB_LAYER_ID) record->m_layer,
+                               (PCB_LAYER_ID) record->m_bottomLayer );
+            break;
+        }
+
+        default:
+            return nullptr;
+        }
+
+        track->SetStart( start );
+        track->SetEnd( end );
+        track->SetWidth( record->m_width );
+        track->SetNetCode( nets[record->m_net]->GetNet(), /* aNoAssert */ true );
+        track->SetStatus( record->m_status );
+        const_cast<KIID&>( track->m_Uuid ) = KIID( getUuid( record->m_uuid ) );
+
+        // Inserted at the front, like PCB_PARSER does: the order is the one of a parsed board
+        board->Add( track.release(), ADD_MODE::INSERT );
+    }
+
+    const SNAPSHOT_SECTION& chainSection = image.Section( SNAP_CHAINS );
+    const SNAPSHOT_SECTION& pointSection = image.Section( SNAP_POINTS );
+    const SNAPSHOT_FILL*    fillsEnd = fills + image.Section( SNAP_FILLS ).m_count;
+
+    for( const SNAPSHOT_FILL* fill = fills; fill < fillsEnd; ++fill )
+    {
+        if( (int) fill->m_zone >= board->GetAreaCount()
+                || fill->m_firstChain > chainSection.m_count
+                || fill->m_chainCount > chainSection.m_count - fill->m_firstChain )
+        {
+            return nullptr;
+        }
+
+        ZONE_CONTAINER* zone = board->GetArea( fill->m_zone );
+
+        if( zone->m_Uuid.AsString() != getUuid( fill->m_uuid ) )
+            return nullptr;
+
+        SHAPE_POLY_SET polys;
+
+        for( uint32_t ii = 0; ii < fill->m_chainCount; ++ii )
+        {
+            const SNAPSHOT_CHAIN& chain = chains[fill->m_firstChain + ii];
+
+            int  outlines = polys.OutlineCount();
+            bool isHole = chain.m_hole != 0;
+
+            if( chain.m_firstPoint > pointSection.m_count
+                    || chain.m_pointCount > pointSection.m_count - chain.m_firstPoint
+                    || ( isHole ? outlines == 0 || chain.m_polygon != (uint32_t) outlines - 1
+                                : chain.m_polygon != (uint32_t) outlines ) )
+            {
+                return nullptr;
+            }
+
+            SHAPE_LINE_CHAIN      line;
+            const SNAPSHOT_POINT* point = points + chain.m_firstPoint;
+
+            for( uint32_t jj = 0; jj < chain.m_pointCount; ++jj, ++point )
+                line.Append( point->m_x, point->m_y, true );
+
+            line.SetClosed( true );
+
+            if( isHole )
+                polys.AddHole( line );
+            else
+                polys.AddOutline( line );
+        }
+
+        zone->SetFilledPolysList( polys );
+        zone->CalculateFilledArea();
+    }
+
+    board->SetFileName( aBoardFileName );
+
+    return board.release();
+}
@@ -0,0 +1,68 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_SNAPSHOT_H
+#define BOARD_SNAPSHOT_H
+
+#include <wx/string.h>
+
+class BOARD;
+
+
+/**
+ * BOARD_SNAPSHOT
+ * writes and reads the binary snapshot of a board, a file next to the board file which lets
+ * pcbnew reopen a large board quickly.  The .kicad_pcb file stays the canonical format: the
+ * snapshot records the size and the hash of the board file it was written with, and is
+ * ignored as soon as the board file no longer matches.
+ *
+ * The snapshot is a flat, versioned layout of fixed size records, 8 byte aligned, which can
+ * be used straight from memory: the tracks and vias, the filled polygons of the board zones
+ * and the net names, which are most of a large board file, are stored in binary.  The rest
+ * of the board (setup, footprints, drawings, zone outlines) is kept as the s-expression text
+ * of the board file without its tracks and zone fills, and is read by PCB_PARSER.
+ */
+class BOARD_SNAPSHOT
+{
+public:
+    /**
+     * @return the name of the snapshot file of the board aBoardFileName.
+     */
+    static wxString GetSnapshotFileName( const wxString& aBoardFileName );
+
+    /**
+     * Writes the snapshot of aBoard, which was just saved to aBoardFileName.
+     * @return false if the board file cannot be read or the snapshot cannot be written.
+     */
+    static bool Save( BOARD* aBoard, const wxString& aBoardFileName );
+
+    /**
+     * Reads the board aBoardFileName from its snapshot.
+     * @return the board, or nullptr if there is no valid snapshot written for the current
+     *         content of the board file, in which case the board file must be parsed.
+     */
+    static BOARD* Load( const wxString& aBoardFileName );
+};
+
+
+#endif  // BOARD_SNAPSHOT_H
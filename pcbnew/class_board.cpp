@@ -32,8 +32,10 @@
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 #include <fctsys.h>
 #include <common.h>
+#include <board_memory_usage.h>
 #include <kicad_string.h>
 #include <pcb_base_frame.h>
 #include <msgpanel.h>
@@ -41,6 +43,7 @@
 #include <ratsnest_data.h>
 #include <ratsnest_viewitem.h>
 #include <ws_proxy_view_item.h>
+#include <geometry/rtree.h>
 #include <pcbnew.h>
 #include <collectors.h>
 #include <class_board.h>
@@ -99,11 +102,24 @@ wxPoint BOARD_ITEM::ZeroOffset( 0, 0 );
 // one hasn't been provided by the application.
 static PCBNEW_SETTINGS dummyGeneralSettings;
 
+
+/**
+ * The pads of the board in the order of the footprints, indexed by the square around their
+ * shape which is searched by D_PAD::HitTest(), extended to their position
+ */
+struct BOARD::PAD_INDEX
+{
+    std::vector<D_PAD*>            m_Pads;
+    RTree<size_t, int, 2, double>  m_Tree;
+};
+
+
 BOARD::BOARD() :
         BOARD_ITEM_CONTAINER( (BOARD_ITEM*) NULL, PCB_T ),
         m_paper( PAGE_INFO::A4 ),
         m_NetInfo( this ),
-        m_project( nullptr )
+        m_project( nullptr ),
+        m_netTracksValid( false )
 {
     // we have not loaded a board yet, assume latest until then.
     m_fileFormatVersionAtLoad = LEGACY_BOARD_FILE_VERSION;
@@ -138,11 +154,62 @@ BOARD::BOARD() :
 
     // Initialize ratsnest
     m_connectivity.reset( new CONNECTIVITY_DATA() );
+
+    m_itemsMemory.Set( MEMORY_BOARD_ITEMS,
+            [this]()
+            {
+                size_t bytes = sizeof( BOARD ) + m_NetInfo.GetNetCount() * sizeof( NETINFO_ITEM );
+
+                for( const MODULE* module : m_modules )
+                    bytes += BoardItemMemoryUsage( module );
+
+                for( const TRACK* track : m_tracks )
+                    bytes += BoardItemMemoryUsage( track );
+
+                for( const BOARD_ITEM* drawing : m_drawings )
+                    bytes += BoardItemMemoryUsage( drawing );
+
+                for( const ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+                    bytes += BoardItemMemoryUsage( zone );
+
+                for( const MARKER_PCB* marker : m_markers )
+                    bytes += BoardItemMemoryUsage( marker );
+
+                return bytes;
+            } );
+
+    m_zoneFillsMemory.Set( MEMORY_ZONE_FILLS,
+            [this]()
+            {
+                size_t bytes = 0;
+
+                for( const ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+                    bytes += ZoneFillMemoryUsage( zone );
+
+                for( const MODULE* module : m_modules )
+                {
+                    for( const MODULE_ZONE_CONTAINER* zone : module->Zones() )
+                        bytes += ZoneFillMemoryUsage( zone );
+                }
+
+                return bytes;
+            } );
+
+    m_connectivityMemory.Set( MEMORY_CONNECTIVITY,
+            [this]()
+            {
+                return m_connectivity->MemoryUsage();
+            } );
 }
 
 
 BOARD::~BOARD()
 {
+    // Before the items are deleted
+    m_itemsMemory.Reset();
+    m_zoneFillsMemory.Reset();
+    m_connectivityMemory.Reset();
+
     while( m_ZoneDescriptorList.size() )
     {
         ZONE_CONTAINER* area_to_remove = m_ZoneDescriptorList[0];
@@ -229,23 +296,47 @@ void BOARD::Move( const wxPoint& aMoveVector )        // overload
 
 TRACKS BOARD::TracksInNet( int aNetCode )
 {
-    TRACKS ret;
+    return GetNetTracks( aNetCode ).m_Tracks;
+}
+
 
-    INSPECTOR_FUNC inspector = [aNetCode,&ret] ( EDA_ITEM* item, void* testData )
+const NET_TRACKS& BOARD::GetNetTracks( int aNetCode ) const
+{
+    static const NET_TRACKS empty;
+
+    if( !m_netTracksValid )
     {
-        TRACK*  t = (TRACK*) item;
+        m_netTracks.clear();
 
-        if( t->GetNetCode() == aNetCode )
-            ret.push_back( t );
+        for( TRACK* track : m_tracks )
+        {
+            NET_TRACKS& net = m_netTracks[ track->GetNetCode() ];
 
-        return SEARCH_RESULT::CONTINUE;
-    };
+            net.m_Tracks.push_back( track );
+
+            if( track->Type() == PCB_VIA_T )
+                net.m_ViaCount++;
+            else
+                net.m_Length += track->GetLength();
+        }
 
-    // visit this BOARD's TRACKs and VIAs with above TRACK INSPECTOR which
-    // appends all in aNetCode to ret.
-    Visit( inspector, NULL, GENERAL_COLLECTOR::Tracks  );
+        for( MODULE* module : m_modules )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                NET_TRACKS& net = m_netTracks[ pad->GetNetCode() ];
 
-    return ret;
+                net.m_PadCount++;
+                net.m_PadToDieLength += pad->GetPadToDieLength();
+            }
+        }
+
+        m_netTracksValid = true;
+    }
+
+    auto it = m_netTracks.find( aNetCode );
+
+    return it != m_netTracks.end() ? it->second : empty;
 }
 
 
@@ -566,6 +657,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         else
             m_tracks.push_front( static_cast<TRACK*>( aBoardItem ) );
 
+        InvalidateNetTracks();
         break;
 
     case PCB_MODULE_T:
@@ -574,6 +666,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         else
             m_modules.push_front( (MODULE*) aBoardItem );
 
+        InvalidateIndexes();
         break;
 
     case PCB_DIMENSION_T:
@@ -651,6 +744,7 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
                                          {
                                              return aItem == aBoardItem;
                                          } ) );
+        InvalidateIndexes();
         break;
 
     case PCB_TRACE_T:
@@ -661,6 +755,7 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
                                         {
                                             return aItem == aBoardItem;
                                         } ) );
+        InvalidateNetTracks();
         break;
 
     case PCB_DIMENSION_T:
@@ -683,6 +778,62 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
 }
 
 
+void BOARD::RemoveItems( const std::vector<BOARD_ITEM*>& aItems )
+{
+    std::unordered_set<BOARD_ITEM*> removed;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        switch( item->Type() )
+        {
+        case PCB_NETINFO_T:
+            m_NetInfo.RemoveNet( static_cast<NETINFO_ITEM*>( item ) );
+            break;
+
+        case PCB_MARKER_T:
+        case PCB_ZONE_AREA_T:
+        case PCB_MODULE_T:
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+        case PCB_DIMENSION_T:
+        case PCB_LINE_T:
+        case PCB_TEXT_T:
+        case PCB_TARGET_T:
+            removed.insert( item );
+            break;
+
+        default:
+            wxFAIL_MSG( wxT( "BOARD::RemoveItems() needs more ::Type() support" ) );
+        }
+
+        m_connectivity->Remove( item );
+    }
+
+    if( removed.empty() )
+        return;
+
+    auto isRemoved =
+            [&]( BOARD_ITEM* aItem )
+            {
+                return removed.count( aItem ) > 0;
+            };
+
+    m_markers.erase( std::remove_if( m_markers.begin(), m_markers.end(), isRemoved ),
+                     m_markers.end() );
+    m_ZoneDescriptorList.erase( std::remove_if( m_ZoneDescriptorList.begin(),
+                                                m_ZoneDescriptorList.end(), isRemoved ),
+                                m_ZoneDescriptorList.end() );
+    m_modules.erase( std::remove_if( m_modules.begin(), m_modules.end(), isRemoved ),
+                     m_modules.end() );
+    m_tracks.erase( std::remove_if( m_tracks.begin(), m_tracks.end(), isRemoved ),
+                    m_tracks.end() );
+    InvalidateIndexes();
+    m_drawings.erase( std::remove_if( m_drawings.begin(), m_drawings.end(), isRemoved ),
+                      m_drawings.end() );
+}
+
+
 wxString BOARD::GetSelectMenuText( EDA_UNITS aUnits ) const
 {
     return wxString::Format( _( "PCB" ) );
@@ -760,14 +911,17 @@ BOARD_ITEM* BOARD::GetItem( const KIID& aID )
 
 unsigned BOARD::GetNodesCount( int aNet )
 {
+    if( aNet != -1 )
+        return GetNetTracks( aNet ).m_PadCount;
+
     unsigned retval = 0;
-    for( auto mod : Modules() )
+
+    GetNetTracks( 0 );      // builds the index
+
+    for( const std::pair<const int, NET_TRACKS>& net : m_netTracks )
     {
-        for( auto pad : mod->Pads() )
-        {
-            if( ( aNet == -1 && pad->GetNetCode() > 0 ) || aNet == pad->GetNetCode() )
-                retval++;
-        }
+        if( net.first > 0 )
+            retval += net.second.m_PadCount;
     }
 
     return retval;
@@ -1254,23 +1408,68 @@ int BOARD::SetAreasNetCodesFromNetNames()
 }
 
 
+const BOARD::PAD_INDEX& BOARD::padIndex() const
+{
+    if( !m_padIndex )
+    {
+        std::unique_ptr<PAD_INDEX>                          index( new PAD_INDEX );
+        std::vector<RTree<size_t, int, 2, double>::BulkEntry> entries;
+
+        for( MODULE* module : m_modules )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                EDA_RECT area( pad->ShapePos(), wxSize( 0, 0 ) );
+
+                area.Inflate( pad->GetBoundingRadius() );
+                area.Merge( pad->GetPosition() );
+
+                entries.push_back( { { { area.GetX(), area.GetY() },
+                                       { area.GetRight(), area.GetBottom() } },
+                                     index->m_Pads.size() } );
+                index->m_Pads.push_back( pad );
+            }
+        }
+
+        index->m_Tree.BulkLoad( entries );
+        m_padIndex = std::move( index );
+    }
+
+    return *m_padIndex;
+}
+
+
+void BOARD::InvalidatePadIndex()
+{
+    m_padIndex.reset();
+}
+
+
 D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerSet )
 {
     if( !aLayerSet.any() )
         aLayerSet = LSET::AllCuMask();
 
-    for( auto module : m_modules )
-    {
-        D_PAD* pad = NULL;
+    const PAD_INDEX& index = padIndex();
+    const int        point[2] = { aPosition.x, aPosition.y };
+    size_t           first = index.m_Pads.size();
 
-        if( module->HitTest( aPosition ) )
-            pad = module->GetPad( aPosition, aLayerSet );
+    // The first pad hit in the order of the footprints
+    index.m_Tree.Search( point, point,
+            [&]( const size_t& aPad )
+            {
+                D_PAD* pad = index.m_Pads[aPad];
 
-        if( pad )
-            return pad;
-    }
+                if( aPad < first && ( pad->GetLayerSet() & aLayerSet ).any()
+                        && pad->HitTest( aPosition ) )
+                {
+                    first = aPad;
+                }
 
-    return NULL;
+                return true;
+            } );
+
+    return first < index.m_Pads.size() ? index.m_Pads[first] : nullptr;
 }
 
 
@@ -1286,20 +1485,26 @@ D_PAD* BOARD::GetPad( TRACK* aTrace, ENDPOINT_T aEndPoint )
 
 D_PAD* BOARD::GetPadFast( const wxPoint& aPosition, LSET aLayerSet )
 {
-    for( auto mod : Modules() )
-    {
-        for ( auto pad : mod->Pads() )
-        {
-        if( pad->GetPosition() != aPosition )
-            continue;
+    const PAD_INDEX& index = padIndex();
+    const int        point[2] = { aPosition.x, aPosition.y };
+    size_t           first = index.m_Pads.size();
 
-        // Pad found, it must be on the correct layer
-        if( ( pad->GetLayerSet() & aLayerSet ).any() )
-            return pad;
-        }
-    }
+    index.m_Tree.Search( point, point,
+            [&]( const size_t& aPad )
+            {
+                D_PAD* pad = index.m_Pads[aPad];
 
-    return nullptr;
+                // The pad must be on the correct layer
+                if( aPad < first && pad->GetPosition() == aPosition
+                        && ( pad->GetLayerSet() & aLayerSet ).any() )
+                {
+                    first = aPad;
+                }
+
+                return true;
+            } );
+
+    return first < index.m_Pads.size() ? index.m_Pads[first] : nullptr;
 }
 
 
@@ -1431,6 +1636,7 @@ void BOARD::PadDelete( D_PAD* aPad )
 {
     GetConnectivity()->Remove( aPad );
     aPad->DeleteStructure();
+    InvalidateIndexes();
 }
 
 
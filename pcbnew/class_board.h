@@ -33,12 +33,14 @@
 #include <common.h> // PAGE_INFO
 #include <eda_rect.h>
 #include <layers_id_colors_and_visibility.h>
+#include <memory_usage.h>
 #include <netinfo.h>
 #include <pcb_plot_params.h>
 #include <title_block.h>
 #include <zone_settings.h>
 
 #include <memory>
+#include <unordered_map>
 
 using std::unique_ptr;
 
@@ -157,6 +159,19 @@ DECL_VEC_FOR_SWIG( ZONE_CONTAINERS, ZONE_CONTAINER* )
 DECL_DEQ_FOR_SWIG( TRACKS, TRACK* )
 
 
+/**
+ * The tracks and vias of a net, with the totals of the net reports
+ */
+struct NET_TRACKS
+{
+    TRACKS m_Tracks;
+    double m_Length = 0.0;      ///< the length of the track segments and arcs
+    int    m_ViaCount = 0;
+    int    m_PadCount = 0;
+    int    m_PadToDieLength = 0;    ///< the sum of the pad to die lengths of the pads
+};
+
+
 /**
  * BOARD
  * holds information pertinent to a Pcbnew printed circuit board.
@@ -194,6 +209,17 @@ private:
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
+    /// The tracks of each net, built by GetNetTracks() and dropped by InvalidateNetTracks()
+    mutable std::unordered_map<int, NET_TRACKS> m_netTracks;
+    mutable bool                                m_netTracksValid;
+
+    /// The pads indexed by position, built by the first pad query and dropped by
+    /// InvalidatePadIndex()
+    struct PAD_INDEX;
+    mutable std::unique_ptr<PAD_INDEX>          m_padIndex;
+
+    const PAD_INDEX& padIndex() const;
+
     BOARD_DESIGN_SETTINGS   m_designSettings;
     PCBNEW_SETTINGS*        m_generalSettings;      // reference only; I have no ownership
     PAGE_INFO               m_paper;
@@ -202,6 +228,11 @@ private:
     NETINFO_LIST            m_NetInfo;              // net info list (name, design constraints ..
     PROJECT*                m_project;              // project this board is a part of (if any)
 
+    /// The providers of the memory used by the items, the zone fills and the connectivity
+    MEMORY_USAGE_PROVIDER   m_itemsMemory;
+    MEMORY_USAGE_PROVIDER   m_zoneFillsMemory;
+    MEMORY_USAGE_PROVIDER   m_connectivityMemory;
+
 
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
@@ -278,6 +309,15 @@ public:
 
     void Remove( BOARD_ITEM* aBoardItem ) override;
 
+    /**
+     * Function RemoveItems
+     * removes many items at once, as Remove() would do one by one: each list of the board
+     * is compacted once, instead of being searched for each item.
+     * @param aItems the items to remove, which must be on the board and of the types handled
+     *               by Remove()
+     */
+    void RemoveItems( const std::vector<BOARD_ITEM*>& aItems );
+
     /**
      * Gets the first module in the list (used in footprint viewer/editor) or NULL if none
      * @return first module or null pointer
@@ -1031,11 +1071,8 @@ public:
 
     /**
      * Function GetPadFast
-     * return pad found at \a aPosition on \a aLayerMask using the fast search method.
-     * <p>
-     * The fast search method only works if the pad list has already been built.
-     * </p>
-     * @param aPosition A wxPoint object containing the position to hit test.
+     * return pad whose position is \a aPosition on \a aLayerMask.
+     * @param aPosition A wxPoint object containing the position of the pad.
      * @param aLayerMask A layer or layers to mask the hit test.
      * @return A pointer to a D_PAD object if found or NULL if not found.
      */
@@ -1046,9 +1083,8 @@ public:
      * locates the pad connected at \a aPosition on \a aLayer starting at list position
      * \a aPad
      * <p>
-     * This function uses a fast search in this sorted pad list and it is faster than
-     * GetPadFast().  This list is a sorted pad list must be built before calling this
-     * function.
+     * This function uses a binary search in this sorted pad list, which must be built
+     * before calling this function.  GetPadFast() searches all the pads of the board.
      * </p>
      * @note The normal pad list is sorted by increasing netcodes.
      * @param aPadList = the list of pads candidates (a std::vector<D_PAD*>)
@@ -1098,6 +1134,40 @@ public:
      */
     TRACKS TracksInNet( int aNetCode );
 
+    /**
+     * Returns the tracks and vias of a net with their routed length and via count, and the
+     * count and the pad to die length of the pads of the net.
+     *
+     * The tracks and the pads of all the nets are indexed by the first call, and the index is
+     * kept until tracks or footprints are added, removed or changed (by a BOARD_COMMIT or an
+     * undo).
+     * @param aNetCode gives the id of the net.
+     * @return the tracks of the net, valid until the next change of the tracks.
+     */
+    const NET_TRACKS& GetNetTracks( int aNetCode ) const;
+
+    /**
+     * Drops the index of the tracks of the nets.  Must be called after changing the net, the
+     * geometry or the type of tracks, or the net of pads, outside of Add() and Remove(),
+     * BOARD_COMMIT and the undo.
+     */
+    void InvalidateNetTracks() { m_netTracksValid = false; }
+
+    /**
+     * Drops the index of the pads used by GetPad() and GetPadFast().  Must be called after
+     * moving or changing pads outside of Add() and Remove(), BOARD_COMMIT and the undo.
+     */
+    void InvalidatePadIndex();
+
+    /**
+     * Drops the indexes of the tracks and of the pads, after changes of any item.
+     */
+    void InvalidateIndexes()
+    {
+        InvalidateNetTracks();
+        InvalidatePadIndex();
+    }
+
     /**
      * Function GetFootprint
      * get a footprint by its bounding rectangle at \a aPosition on \a aLayer.
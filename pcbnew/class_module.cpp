@@ -48,7 +48,8 @@
 
 MODULE::MODULE( BOARD* parent ) :
     BOARD_ITEM_CONTAINER( (BOARD_ITEM*) parent, PCB_MODULE_T ),
-    m_initial_comments( 0 )
+    m_initial_comments( 0 ),
+    m_courtyard_cache_ok( false )
 {
     m_Attributs    = MOD_DEFAULT;
     m_Layer        = F_Cu;
@@ -75,7 +76,8 @@ MODULE::MODULE( BOARD* parent ) :
 
 
 MODULE::MODULE( const MODULE& aModule ) :
-    BOARD_ITEM_CONTAINER( aModule )
+    BOARD_ITEM_CONTAINER( aModule ),
+    m_courtyard_cache_ok( false )
 {
     m_Pos = aModule.m_Pos;
     m_fpid = aModule.m_fpid;
@@ -183,6 +185,9 @@ MODULE& MODULE::operator=( const MODULE& aOther )
 
     m_Pos           = aOther.m_Pos;
     m_fpid          = aOther.m_fpid;
+
+    // The courtyard polygons are not copied
+    m_courtyard_cache_key.clear();
     m_Attributs     = aOther.m_Attributs;
     m_ModuleStatus  = aOther.m_ModuleStatus;
     m_Orient        = aOther.m_Orient;
@@ -1484,8 +1489,51 @@ double MODULE::CoverageRatio( const GENERAL_COLLECTOR& aCollector ) const
 extern bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SET& aPolygons,
         wxString* aErrorText, unsigned int aTolerance, wxPoint* aErrorLocation = nullptr );
 
+std::vector<double> MODULE::courtyardCacheKey() const
+{
+    std::vector<double> key = { (double) m_Pos.x, (double) m_Pos.y, m_Orient,
+                                (double) IsFlipped() };
+
+    for( auto item : GraphicalItems() )
+    {
+        if( item->Type() != PCB_MODULE_EDGE_T )
+            continue;
+
+        if( item->GetLayer() != F_CrtYd && item->GetLayer() != B_CrtYd )
+            continue;
+
+        const DRAWSEGMENT* seg = static_cast<const DRAWSEGMENT*>( item );
+
+        key.insert( key.end(), { (double) seg->GetLayer(), (double) seg->GetShape(),
+                                 (double) seg->GetStart().x, (double) seg->GetStart().y,
+                                 (double) seg->GetEnd().x, (double) seg->GetEnd().y,
+                                 seg->GetAngle(),
+                                 (double) seg->GetBezControl1().x,
+                                 (double) seg->GetBezControl1().y,
+                                 (double) seg->GetBezControl2().x,
+                                 (double) seg->GetBezControl2().y } );
+
+        if( seg->GetShape() == S_POLYGON )
+        {
+            for( auto it = seg->GetPolyShape().CIterateWithHoles(); it; it++ )
+                key.insert( key.end(), { (double) it->x, (double) it->y } );
+        }
+    }
+
+    return key;
+}
+
+
 bool MODULE::BuildPolyCourtyard()
 {
+    std::vector<double> key = courtyardCacheKey();
+
+    if( !m_courtyard_cache_key.empty() && key == m_courtyard_cache_key )
+        return m_courtyard_cache_ok;
+
+    m_courtyard_cache_key = key;
+    m_courtyard_cache_ok = true;
+
     m_poly_courtyard_front.RemoveAllContours();
     m_poly_courtyard_back.RemoveAllContours();
     // Build the courtyard area from graphic items on the courtyard.
@@ -1530,6 +1578,8 @@ bool MODULE::BuildPolyCourtyard()
                                         error_msg) );
     }
 
+    m_courtyard_cache_ok = success;
+
     return success;
 }
 
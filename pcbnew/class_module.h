@@ -667,6 +667,8 @@ public:
 
     /** Used in DRC to build the courtyard area (a complex polygon)
      * from graphic items put on the courtyard
+     * The polygons are cached, and only rebuilt when the footprint position, orientation
+     * or courtyard items have changed since the previous call.
      * @return true if OK, or no courtyard defined,
      * false only if the polygon cannot be built due to amalformed courtyard shape
      * The polygon cannot be built if segments/arcs on courtyard layers
@@ -719,6 +721,14 @@ private:
     /// Note also a footprint can have courtyards on both board sides
     SHAPE_POLY_SET m_poly_courtyard_front;
     SHAPE_POLY_SET m_poly_courtyard_back;
+
+    /// The footprint position, orientation and courtyard geometry used to build the
+    /// courtyard polygons, and the result of that build.  An empty key means no cache.
+    std::vector<double> m_courtyard_cache_key;
+    bool                m_courtyard_cache_ok;
+
+    /// Return the key describing everything the courtyard polygons are built from
+    std::vector<double> courtyardCacheKey() const;
 };
 
 #endif     // MODULE_H_
@@ -98,6 +98,7 @@ D_PAD::D_PAD( MODULE* parent ) :
     SetSubRatsnest( 0 );                       // used in ratsnest calculations
 
     m_boundingRadius      = -1;
+    m_customShapeVersion  = 0;
 }
 
 
@@ -500,6 +501,7 @@ void D_PAD::FlipPrimitives()
 
     // Flip local coordinates in merged Polygon
     m_customShapeAsPolygon.Mirror( false, true );
+    m_customShapeVersion++;
 }
 
 
@@ -532,6 +534,8 @@ void D_PAD::MirrorXPrimitives( int aX )
         SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon.Outline( cnt );
         poly.Mirror( true, false );
     }
+
+    m_customShapeVersion++;
 }
 
 
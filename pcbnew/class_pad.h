@@ -36,6 +36,7 @@
 #include <convert_to_biu.h>
 #include <geometry/shape_poly_set.h>
 #include <pad_shapes.h>
+#include <pad_shape_cache.h>
 #include <pcbnew.h>
 
 class DRAWSEGMENT;
@@ -845,6 +846,13 @@ private:
 
     bool buildCustomPadPolygon( SHAPE_POLY_SET* aMergedPolygon, int aError );
 
+    ///> @return the geometry of the pad polygon built for aClearanceValue and aError
+    PAD_SHAPE_KEY shapeKey( int aClearanceValue, int aError ) const;
+
+    ///> Builds the polygon of TransformShapeWithClearanceToPolygon(), without the cache
+    void buildShapeWithClearance( SHAPE_POLY_SET& aCornerBuffer, int aClearanceValue,
+                                  int aError ) const;
+
 private:    // Private variable members:
 
     // Actually computed and cached on demand by the accessor
@@ -871,6 +879,10 @@ private:    // Private variable members:
      * in local coordinates, orient 0, coordinates relative to m_Pos
      */
     SHAPE_POLY_SET m_customShapeAsPolygon;
+    unsigned       m_customShapeVersion;    ///< changed with m_customShapeAsPolygon
+
+    ///> The polygons built by TransformShapeWithClearanceToPolygon()
+    mutable PAD_SHAPE_CACHE m_shapeCache;
 
     /**
      * How to build the custom shape in zone, to create the clearance area:
@@ -26,6 +26,7 @@
 #include <bitmaps.h>
 #include <fctsys.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/point_transform.h>
 #include <kicad_string.h>
 #include <macros.h>
 #include <msgpanel.h>
@@ -52,6 +53,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
 {
     m_CornerSelection = nullptr;                // no corner is selected
     m_IsFilled = false;                         // fill status : true when the zone is filled
+    m_fillFingerprint = 0;                      // fill inputs unknown: the zone must be refilled
     m_FillMode = ZONE_FILL_MODE::POLYGONS;
     m_hatchStyle = ZONE_HATCH_STYLE::DIAGONAL_EDGE;
     m_hatchPitch = GetDefaultHatchPitch();
@@ -72,6 +74,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
     m_FilledPolysUseThickness = true;           // set the "old" way to build filled polygon areas (before 6.0.x)
+    m_FilledPolysList.EnableGridPartitions();   // for the repeated hit tests of the fill
     aParent->GetZoneSettings().ExportSetting( *this );
 
     m_needRefill = false;   // True only after some edition.
@@ -109,6 +112,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     m_FilledPolysList.Append( aOther.m_FilledPolysList );
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
+    m_fillFingerprint = 0;
 
     m_HatchFillTypeThickness = aOther.m_HatchFillTypeThickness;
     m_HatchFillTypeGap = aOther.m_HatchFillTypeGap;
@@ -147,6 +151,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     // For corner moving, corner index to drag, or nullptr if no selection
     m_CornerSelection = nullptr;
     m_IsFilled = aZone.m_IsFilled;
+    m_fillFingerprint = aZone.m_fillFingerprint;
     m_ZoneClearance = aZone.m_ZoneClearance;     // clearance value
     m_ZoneMinThickness = aZone.m_ZoneMinThickness;
     m_FilledPolysUseThickness = aZone.m_FilledPolysUseThickness;
@@ -156,6 +161,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
+    m_FilledPolysList.EnableGridPartitions();
     m_FilledPolysList.Append( aZone.m_FilledPolysList );
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
@@ -815,24 +821,19 @@ void ZONE_CONTAINER::MoveEdge( const wxPoint& offset, int aEdge )
 
 void ZONE_CONTAINER::Rotate( const wxPoint& centre, double angle )
 {
-    wxPoint pos;
+    POINT_TRANSFORM rotation = POINT_TRANSFORM::Rotation( -DECIDEG2RAD( angle ),
+                                                          VECTOR2I( centre ) );
 
-    angle = -DECIDEG2RAD( angle );
-
-    m_Poly->Rotate( angle, VECTOR2I( centre ) );
+    m_Poly->Transform( rotation );
     Hatch();
 
     /* rotate filled areas: */
-    m_FilledPolysList.Rotate( angle, VECTOR2I( centre ) );
+    m_FilledPolysList.Transform( rotation );
 
-    for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
+    for( SEG& seg : m_FillSegmList )
     {
-        wxPoint a( m_FillSegmList[ic].A );
-        RotatePoint( &a, centre, angle );
-        m_FillSegmList[ic].A = a;
-        wxPoint b( m_FillSegmList[ic].B );
-        RotatePoint( &b, centre, angle );
-        m_FillSegmList[ic].B = a;
+        seg.A = rotation.Apply( seg.A );
+        seg.B = rotation.Apply( seg.B );
     }
 }
 
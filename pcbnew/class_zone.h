@@ -587,15 +587,19 @@ public:
         m_FilledPolysList = aPolysList;
     }
 
+#ifndef SWIG
     /**
-      * Function SetFilledPolysList
-      * sets the list of filled polygons.
-      */
-    void SetRawPolysList( SHAPE_POLY_SET& aPolysList )
+     * Function SetFilledPolysList
+     * sets the list of filled polygons and its triangulation, which must have been built for
+     * these polygons (e.g. by an earlier fill).  Takes the ownership of aTriangulation.
+     */
+    void SetFilledPolysList( SHAPE_POLY_SET& aPolysList,
+            std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>& aTriangulation )
     {
-        m_RawPolysList = aPolysList;
+        m_FilledPolysList = aPolysList;
+        m_FilledPolysList.SetTriangulation( aTriangulation );
     }
-
+#endif
 
     /**
      * Function GetSmoothedPoly
@@ -632,11 +636,6 @@ public:
         m_FillSegmList = aSegments;
     }
 
-    SHAPE_POLY_SET& RawPolysList()
-    {
-        return m_RawPolysList;
-    }
-
     wxString GetSelectMenuText( EDA_UNITS aUnits ) const override;
 
     BITMAP_DEF GetMenuImage() const override;
@@ -719,6 +718,12 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /** @return the fingerprint of the fill inputs (outline, settings and neighbouring
+     * copper items) recorded by ZONE_FILLER when the zone was last filled, or 0 if unknown.
+     */
+    size_t GetFillFingerprint() const { return m_fillFingerprint; }
+    void SetFillFingerprint( size_t aFingerprint ) { m_fillFingerprint = aFingerprint; }
+
 
 
 #if defined(DEBUG)
@@ -822,9 +827,10 @@ protected:
      * described by m_Poly can have many filled areas
      */
     SHAPE_POLY_SET        m_FilledPolysList;
-    SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    size_t                m_fillFingerprint;    // Fingerprint of the inputs of the last fill,
+                                                // used to skip the refill of unchanged zones
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
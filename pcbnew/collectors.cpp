@@ -34,6 +34,9 @@
 #include <class_drawsegment.h>
 #include <math/util.h>      // for KiROUND
 
+#include <algorithm>
+#include <unordered_set>
+
 
 /* This module contains out of line member functions for classes given in
  * collectors.h.  Those classes augment the functionality of class PCB_EDIT_FRAME.
@@ -549,6 +552,79 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
 
     aItem->Visit( m_inspector, NULL, m_ScanTypes );
 
+    finishCollect();
+}
+
+
+void GENERAL_COLLECTOR::Collect( KIGFX::VIEW* aView, const KICAD_T aScanList[],
+                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide )
+{
+    Empty();        // empty the collection, primary criteria list
+    Empty2nd();     // empty the collection, secondary criteria list
+
+    SetGuide( &aGuide );
+    SetScanTypes( aScanList );
+    SetRefPos( aRefPos );
+
+    // Inspect() hits the items up to twice its accuracy away from their bounding box
+    int   margin = KiROUND( 10 * aGuide.OnePixelInIU() ) + 1;
+    BOX2I area( VECTOR2I( aRefPos.x - margin, aRefPos.y - margin ),
+                VECTOR2I( 2 * margin, 2 * margin ) );
+
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> viewItems;
+
+    aView->Query( area, viewItems );
+
+    // The candidates with the rank of their type in the scan list.  An item is returned by
+    // the query for each of its layers.
+    std::vector<std::pair<int, BOARD_ITEM*>> candidates;
+    std::unordered_set<BOARD_ITEM*>          found;
+
+    auto addCandidate =
+            [&]( BOARD_ITEM* aCandidate )
+            {
+                for( int ii = 0; aScanList[ii] != EOT; ii++ )
+                {
+                    if( aCandidate->Type() == aScanList[ii] )
+                    {
+                        if( found.insert( aCandidate ).second )
+                            candidates.emplace_back( ii, aCandidate );
+
+                        return;
+                    }
+                }
+            };
+
+    for( const KIGFX::VIEW::LAYER_ITEM_PAIR& viewItem : viewItems )
+    {
+        BOARD_ITEM* item = dynamic_cast<BOARD_ITEM*>( viewItem.first );
+
+        if( !item )
+            continue;
+
+        addCandidate( item );
+
+        // A footprint is hit on its children, even when its own view layers are hidden
+        if( item->GetParent() && item->GetParent()->Type() == PCB_MODULE_T )
+            addCandidate( static_cast<BOARD_ITEM*>( item->GetParent() ) );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+                      []( const std::pair<int, BOARD_ITEM*>& a,
+                          const std::pair<int, BOARD_ITEM*>& b )
+                      {
+                          return a.first < b.first;
+                      } );
+
+    for( const std::pair<int, BOARD_ITEM*>& candidate : candidates )
+        Inspect( candidate.second, nullptr );
+
+    finishCollect();
+}
+
+
+void GENERAL_COLLECTOR::finishCollect()
+{
     // record the length of the primary list before concatenating on to it.
     m_PrimaryLength = m_List.size();
 
@@ -375,6 +375,26 @@ public:
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+
+    /**
+     * Collect the items of a view found around aRefPos by the R-tree of the view, instead of
+     * testing all the items of a board.  The hidden view layers are not searched.
+     *
+     * The items are collected in the order of their type in aScanList, and the items of a
+     * type from the top of the rendering stack.
+     *
+     * @param aView The view which holds the items.
+     * @param aScanList A list of KICAD_Ts with a terminating EOT, that specs what is to be
+     *  collected and the priority order of the resultant collection in "m_List".
+     * @param aRefPos A wxPoint to use in hit-testing.
+     * @param aGuide The COLLECTORS_GUIDE to use in collecting items.
+     */
+    void Collect( KIGFX::VIEW* aView, const KICAD_T aScanList[],
+                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+
+private:
+    ///> Appends the secondary list to the primary one, at the end of a collection
+    void finishCollect();
 };
 
 
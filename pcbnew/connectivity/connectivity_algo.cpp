@@ -24,8 +24,11 @@
 
 #include <connectivity/connectivity_algo.h>
 #include <widgets/progress_reporter.h>
+#include <advanced_config.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
+#include <trace_events.h>
 
 #include <thread>
 #include <mutex>
@@ -37,6 +40,26 @@
 #endif
 
 
+CN_CONNECTIVITY_ALGO::CN_CONNECTIVITY_ALGO()
+{
+    m_incremental = ADVANCED_CFG::GetCfg().m_incrementalConnectivity;
+}
+
+
+void CN_CONNECTIVITY_ALGO::removeEntry( const BOARD_ITEM* aItem )
+{
+    auto& entry = m_itemMap[ aItem ];
+
+    // Invalidate first, so that the items of the entry are not taken as neighbours
+    entry.MarkItemsAsInvalid();
+
+    for( auto item : entry.GetItems() )
+        touchItem( item, true );
+
+    m_itemMap.erase( aItem );
+}
+
+
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
@@ -45,40 +68,19 @@ bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
     {
     case PCB_MODULE_T:
         for( auto pad : static_cast<MODULE*>( aItem ) -> Pads() )
-        {
-            m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( pad ) ].MarkItemsAsInvalid();
-            m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( pad ) );
-        }
+            removeEntry( pad );
 
         m_itemList.SetDirty( true );
         break;
 
     case PCB_PAD_T:
-        m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
-        m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
-        m_itemList.SetDirty( true );
-        break;
-
     case PCB_TRACE_T:
     case PCB_ARC_T:
-        m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
-        m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
-        m_itemList.SetDirty( true );
-        break;
-
     case PCB_VIA_T:
-        m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
-        m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
-        m_itemList.SetDirty( true );
-        break;
-
     case PCB_ZONE_AREA_T:
-    {
-        m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
-        m_itemMap.erase ( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
+        removeEntry( aItem );
         m_itemList.SetDirty( true );
         break;
-    }
 
     default:
         return false;
@@ -111,6 +113,49 @@ void CN_CONNECTIVITY_ALGO::markItemNetAsDirty( const BOARD_ITEM* aItem )
 }
 
 
+void CN_CONNECTIVITY_ALGO::touchItem( CN_ITEM* aItem, bool aRemoved )
+{
+    if( !m_incremental )
+        return;
+
+    CN_CLUSTER* cluster = aItem->Cluster();
+
+    if( cluster )
+    {
+        // The item leaves its cluster: what was connected through it may be split off
+        m_splitClusters.insert( cluster );
+        aItem->SetCluster( nullptr );
+
+        for( auto neighbour : aItem->ConnectedItems() )
+        {
+            if( neighbour->Valid() && neighbour->Cluster() == cluster )
+                m_pendingItems.insert( neighbour );
+        }
+    }
+
+    if( aRemoved )
+    {
+        m_pendingItems.erase( aItem );
+        m_propagationSeeds.erase( aItem );
+
+        // Even detached, the item may still be listed by the cluster it was in
+        m_removedItems.insert( aItem );
+
+        // A removed item may have been the conflicting pad of a propagation cluster
+        for( auto neighbour : aItem->ConnectedItems() )
+        {
+            if( neighbour->Valid() )
+                m_propagationSeeds.insert( neighbour );
+        }
+    }
+    else
+    {
+        m_pendingItems.insert( aItem );
+        m_propagationSeeds.insert( aItem );
+    }
+}
+
+
 bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 {
     if( !aItem->IsOnCopperLayer() )
@@ -179,10 +224,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
         if( m_itemMap.find( aItem ) != m_itemMap.end() )
             return false;
 
-        m_itemMap[zone] = ITEM_MAP_ENTRY();
-
-        for( auto zitem : m_itemList.Add( zone ) )
-            m_itemMap[zone].Link(zitem);
+        addZone( zone );
 
         break;
     }
@@ -195,8 +237,23 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 }
 
 
+void CN_CONNECTIVITY_ALGO::addZone( ZONE_CONTAINER* aZone,
+                                    std::vector<std::unique_ptr<POLY_GRID_PARTITION>>* aPartitions )
+{
+    m_itemMap[aZone] = ITEM_MAP_ENTRY();
+
+    for( auto zitem : m_itemList.Add( aZone, aPartitions ) )
+    {
+        m_itemMap[aZone].Link( zitem );
+        touchItem( zitem, false );
+    }
+}
+
+
 void CN_CONNECTIVITY_ALGO::searchConnections()
 {
+    SCOPED_TRACE_EVENT trace( "CN_CONNECTIVITY_ALGO::searchConnections" );
+
 #ifdef CONNECTIVITY_DEBUG
     printf("Search start\n");
 #endif
@@ -210,7 +267,7 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
     m_itemList.RemoveInvalidItems( garbage );
 
     for( auto item : garbage )
-        delete item;
+        m_itemList.Delete( item );
 
 #ifdef PROFILE
     garbage_collection.Show();
@@ -229,14 +286,13 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+        size_t parallelThreadCount = std::min<size_t>( GetKiCadThreadPool().GetThreadCount(),
                 ( dirtyItems.size() + 7 ) / 8 );
 
         std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
         auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
+                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter)
         {
             for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
             {
@@ -246,30 +302,36 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
                 if( aReporter )
                     aReporter->AdvanceProgress();
             }
-
-            return 1;
         };
 
         if( parallelThreadCount <= 1 )
             conn_lambda( &m_itemList, m_progressReporter );
-        else
+        else if( m_progressReporter )
         {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
+            TASK_GROUP tasks;
 
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+            tasks.RunParallel(
+                    [&]()
+                    {
+                        conn_lambda( &m_itemList, m_progressReporter );
+                    },
+                    parallelThreadCount );
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
+            // Refresh the UI meanwhile; the search cannot be cancelled
+            tasks.Wait( nullptr,
+                    [&]()
+                    {
+                        m_progressReporter->KeepRefreshing();
+                    } );
+        }
+        else
+        {
+            GetKiCadThreadPool().RunParallel(
+                    [&]()
+                    {
+                        conn_lambda( &m_itemList, nullptr );
+                    },
+                    parallelThreadCount );
         }
 
         if( m_progressReporter )
@@ -406,8 +468,308 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 }
 
 
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::searchPropagationClusters()
+{
+    std::deque<CN_ITEM*> Q;
+    CLUSTERS clusters;
+
+    // The visited flags are left set by SearchClusters(), so they cannot be used here
+    std::unordered_set<CN_ITEM*> visited;
+
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    // Same clusters as SearchClusters( CSM_PROPAGATE ), but only the ones of the seeds
+    auto canVisit = [&visited] ( CN_ITEM* aItem )
+    {
+        return aItem->Valid() && !visited.count( aItem )
+                && aItem->Parent()->Type() != PCB_ZONE_AREA_T;
+    };
+
+    for( auto root : m_propagationSeeds )
+    {
+        if( !canVisit( root ) )
+            continue;
+
+        CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
+
+        visited.insert( root );
+        Q.push_back( root );
+
+        while( Q.size() )
+        {
+            CN_ITEM* current = Q.front();
+
+            Q.pop_front();
+            cluster->Add( current );
+
+            for( auto n : current->ConnectedItems() )
+            {
+                if( canVisit( n ) )
+                {
+                    visited.insert( n );
+                    Q.push_back( n );
+                }
+            }
+        }
+
+        clusters.push_back( cluster );
+    }
+
+    m_propagationSeeds.clear();
+
+    return clusters;
+}
+
+
+void CN_CONNECTIVITY_ALGO::splitCluster( CN_CLUSTER* aCluster,
+                                         const std::vector<CN_ITEM*>& aBoundary,
+                                         CLUSTERS& aNewClusters )
+{
+    // One breadth first search per boundary item.  Searches which meet are merged, and a
+    // search which runs out of items before the others has found a part to split off.
+    struct SEARCH
+    {
+        int                   m_parent;
+        bool                  m_done;
+        std::deque<CN_ITEM*>  m_queue;
+        std::vector<CN_ITEM*> m_items;
+    };
+
+    std::vector<SEARCH> searches;
+    std::unordered_map<CN_ITEM*, int> owner;
+
+    for( auto item : aBoundary )
+    {
+        if( owner.count( item ) )
+            continue;
+
+        int index = searches.size();
+
+        owner[item] = index;
+        searches.push_back( SEARCH() );
+        searches.back().m_parent = index;
+        searches.back().m_done = false;
+        searches.back().m_queue.push_back( item );
+        searches.back().m_items.push_back( item );
+    }
+
+    auto find = [&searches] ( int aSearch )
+    {
+        while( searches[aSearch].m_parent != aSearch )
+            aSearch = searches[aSearch].m_parent;
+
+        return aSearch;
+    };
+
+    int  running = searches.size();
+    bool split = false;
+
+    while( running > 1 )
+    {
+        for( int ii = 0; ii < (int) searches.size() && running > 1; ii++ )
+        {
+            if( searches[ii].m_parent != ii || searches[ii].m_done )
+                continue;
+
+            if( !searches[ii].m_queue.empty() )
+            {
+                CN_ITEM* current = searches[ii].m_queue.front();
+                searches[ii].m_queue.pop_front();
+
+                for( auto n : current->ConnectedItems() )
+                {
+                    if( !n->Valid() || n->Cluster() != aCluster )
+                        continue;
+
+                    int  self = find( ii );
+                    auto it = owner.find( n );
+
+                    if( it == owner.end() )
+                    {
+                        owner[n] = self;
+                        searches[self].m_queue.push_back( n );
+                        searches[self].m_items.push_back( n );
+                        continue;
+                    }
+
+                    int other = find( it->second );
+
+                    if( other == self )
+                        continue;
+
+                    // The two searches met: the smaller one is merged into the larger one
+                    if( searches[self].m_items.size() < searches[other].m_items.size() )
+                        std::swap( self, other );
+
+                    SEARCH& dst = searches[self];
+                    SEARCH& src = searches[other];
+
+                    src.m_parent = self;
+                    dst.m_queue.insert( dst.m_queue.end(), src.m_queue.begin(), src.m_queue.end() );
+                    dst.m_items.insert( dst.m_items.end(), src.m_items.begin(), src.m_items.end() );
+                    src.m_queue.clear();
+                    src.m_items.clear();
+                    running--;
+                }
+            }
+
+            int root = find( ii );
+
+            if( searches[root].m_queue.empty() && running > 1 )
+            {
+                // A whole part of the cluster was found while the other searches go on
+                CN_CLUSTER_PTR part( new CN_CLUSTER() );
+
+                for( auto item : searches[root].m_items )
+                {
+                    part->Add( item );
+                    item->SetCluster( part.get() );
+                }
+
+                aNewClusters.push_back( part );
+                searches[root].m_items.clear();
+                searches[root].m_done = true;
+                running--;
+                split = true;
+            }
+        }
+    }
+
+    if( split )
+        aCluster->RemoveIf( [aCluster] ( CN_ITEM* aItem ) { return aItem->Cluster() != aCluster; } );
+}
+
+
+void CN_CONNECTIVITY_ALGO::updateRatsnestClusters()
+{
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    // Many changes (a new board, a netlist update...) are faster to process at once
+    if( !m_clustersValid || m_pendingItems.size() > (size_t) m_itemList.Size() / 4 )
+    {
+        m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+
+        for( auto item : m_itemList )
+            item->SetCluster( nullptr );
+
+        for( const auto& cluster : m_ratsnestClusters )
+        {
+            for( auto item : *cluster )
+                item->SetCluster( cluster.get() );
+        }
+
+        m_pendingItems.clear();
+        m_splitClusters.clear();
+        m_removedItems.clear();
+        m_clustersValid = true;
+        return;
+    }
+
+    if( m_pendingItems.empty() && m_splitClusters.empty() )
+        return;
+
+    CLUSTERS newClusters;
+    std::unordered_map<CN_CLUSTER*, std::vector<CN_ITEM*>> boundaries;
+
+    // First the clusters which lost items are split where they are no longer connected
+    for( auto cluster : m_splitClusters )
+    {
+        cluster->RemoveIf( [this, cluster] ( CN_ITEM* aItem )
+                {
+                    return m_removedItems.count( aItem ) || aItem->Cluster() != cluster;
+                } );
+    }
+
+    for( auto item : m_pendingItems )
+    {
+        if( item->Cluster() && m_splitClusters.count( item->Cluster() ) )
+            boundaries[item->Cluster()].push_back( item );
+    }
+
+    for( const auto& boundary : boundaries )
+        splitCluster( boundary.first, boundary.second, newClusters );
+
+    // Then the clusters joined by the changed items are merged.  This is a union-find on the
+    // clusters, with union by size: the items of the smaller cluster are moved to the larger
+    // one, so that the cluster of every item is always the root of its set.
+    std::vector<CN_ITEM*> queue( m_pendingItems.begin(), m_pendingItems.end() );
+
+    auto newCluster = [&newClusters] ( CN_ITEM* aItem )
+    {
+        CN_CLUSTER_PTR cluster( new CN_CLUSTER() );
+
+        cluster->Add( aItem );
+        aItem->SetCluster( cluster.get() );
+        newClusters.push_back( cluster );
+    };
+
+    for( auto item : m_pendingItems )
+    {
+        if( item->Valid() && item->Net() > 0 && !item->Cluster() )
+            newCluster( item );
+    }
+
+    for( size_t ii = 0; ii < queue.size(); ii++ )
+    {
+        CN_ITEM* item = queue[ii];
+
+        if( !item->Valid() || item->Net() <= 0 || !item->Cluster() )
+            continue;
+
+        for( auto n : item->ConnectedItems() )
+        {
+            if( !n->Valid() || n->Net() != item->Net() )
+                continue;
+
+            if( !n->Cluster() )
+            {
+                newCluster( n );
+                queue.push_back( n );
+            }
+
+            CN_CLUSTER* a = item->Cluster();
+            CN_CLUSTER* b = n->Cluster();
+
+            if( a == b )
+                continue;
+
+            if( a->Size() < b->Size() )
+                std::swap( a, b );
+
+            for( auto moved : *b )
+            {
+                a->Add( moved );
+                moved->SetCluster( a );
+            }
+
+            b->RemoveIf( [] ( CN_ITEM* ) { return true; } );
+        }
+    }
+
+    m_ratsnestClusters.insert( m_ratsnestClusters.end(), newClusters.begin(), newClusters.end() );
+
+    m_ratsnestClusters.erase( std::remove_if( m_ratsnestClusters.begin(), m_ratsnestClusters.end(),
+            [] ( const CN_CLUSTER_PTR& aCluster ) { return aCluster->Size() == 0; } ),
+            m_ratsnestClusters.end() );
+
+    std::sort( m_ratsnestClusters.begin(), m_ratsnestClusters.end(),
+            []( const CN_CLUSTER_PTR& a, const CN_CLUSTER_PTR& b )
+            {
+                return a->OriginNet() < b->OriginNet();
+            } );
+
+    m_pendingItems.clear();
+    m_splitClusters.clear();
+    m_removedItems.clear();
+}
+
+
 void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
 {
+    m_itemList.BeginBulkLoad();
+
     for( int i = 0; i<aBoard->GetAreaCount(); i++ )
     {
         auto zone = aBoard->GetArea( i );
@@ -423,6 +785,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
             Add( pad );
     }
 
+    m_itemList.EndBulkLoad();
+
     /*wxLogTrace( "CN", "zones : %lu, pads : %lu vias : %lu tracks : %lu\n",
             m_zoneList.Size(), m_padList.Size(),
             m_viaList.Size(), m_trackList.Size() );*/
@@ -431,6 +795,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
 
 void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    m_itemList.BeginBulkLoad();
+
     for( auto item : aItems )
     {
         switch( item->Type() )
@@ -456,6 +822,8 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
                 break;
         }
     }
+
+    m_itemList.EndBulkLoad();
 }
 
 
@@ -489,6 +857,7 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
                         if( aCommit )
                             aCommit->Modify( item->Parent() );
 
+                        touchItem( item, false );
                         item->Parent()->SetNetCode( cluster->OriginNet() );
                         n_changed++;
                     }
@@ -513,7 +882,11 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    if( m_incremental )
+        m_connClusters = searchPropagationClusters();
+    else
+        m_connClusters = SearchClusters( CSM_PROPAGATE );
+
     propagateConnections( aCommit );
 }
 
@@ -554,29 +927,36 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
     for ( auto& z : aZones )
     {
-        if( !z.m_zone->GetFilledPolysList().IsEmpty() )
-            Add( z.m_zone );
+        if( z.m_zone->GetFilledPolysList().IsEmpty() || !z.m_zone->IsOnCopperLayer() )
+            continue;
+
+        markItemNetAsDirty( z.m_zone );
+        addZone( z.m_zone, &z.m_partitions );
+        z.m_partitions.clear();
     }
 
     m_connClusters = SearchClusters( CSM_CONNECTIVITY_CHECK );
 
-    for ( auto& zone : aZones )
+    // A single pass on the clusters, instead of a pass per zone
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, CN_ZONE_ISOLATED_ISLAND_LIST*> zones;
+
+    for( auto& zone : aZones )
     {
-        if( zone.m_zone->GetFilledPolysList().IsEmpty() )
+        if( !zone.m_zone->GetFilledPolysList().IsEmpty() )
+            zones[zone.m_zone] = &zone;
+    }
+
+    for( const auto& cluster : m_connClusters )
+    {
+        if( !cluster->IsOrphaned() )
             continue;
 
-        for( const auto& cluster : m_connClusters )
+        for( auto z : *cluster )
         {
-            if( cluster->Contains( zone.m_zone ) && cluster->IsOrphaned() )
-            {
-                for( auto z : *cluster )
-                {
-                    if( z->Parent() == zone.m_zone )
-                    {
-                        zone.m_islands.push_back( static_cast<CN_ZONE*>(z)->SubpolyIndex() );
-                    }
-                }
-            }
+            auto it = zones.find( z->Parent() );
+
+            if( it != zones.end() )
+                it->second->m_islands.push_back( static_cast<CN_ZONE*>( z )->SubpolyIndex() );
         }
     }
 }
@@ -584,7 +964,11 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    if( m_incremental )
+        updateRatsnestClusters();
+    else
+        m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+
     return m_ratsnestClusters;
 }
 
@@ -745,6 +1129,12 @@ void CN_CONNECTIVITY_ALGO::Clear()
     m_itemMap.clear();
     m_itemList.Clear();
 
+    m_pendingItems.clear();
+    m_propagationSeeds.clear();
+    m_splitClusters.clear();
+    m_removedItems.clear();
+    m_clustersValid = false;
+
 }
 
 
@@ -769,3 +1159,27 @@ void CN_CONNECTIVITY_ALGO::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 {
     m_progressReporter = aReporter;
 }
+
+
+size_t CN_CONNECTIVITY_ALGO::MemoryUsage() const
+{
+    // A node of the map holds its value and the link to the next node, and a node of the list
+    // of an entry holds the item and two links
+    size_t bytes = m_itemList.MemoryUsage()
+                   + m_itemMap.bucket_count() * sizeof( void* )
+                   + m_itemMap.size() * ( sizeof( decltype( m_itemMap )::value_type )
+                                          + sizeof( void* ) );
+
+    for( const auto& entry : m_itemMap )
+        bytes += entry.second.m_items.size() * 3 * sizeof( void* );
+
+    for( const CLUSTERS* clusters : { &m_connClusters, &m_ratsnestClusters } )
+    {
+        bytes += clusters->capacity() * sizeof( CN_CLUSTER_PTR );
+
+        for( const CN_CLUSTER_PTR& cluster : *clusters )
+            bytes += cluster->MemoryUsage();
+    }
+
+    return bytes;
+}
@@ -39,6 +39,8 @@
 #include <memory>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <deque>
 #include <intrusive_list.h>
@@ -152,6 +154,26 @@ private:
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
+    ///> true if the clusters are updated around the changed items (see touchItem())
+    bool m_incremental;
+
+    ///> true once m_ratsnestClusters has been searched, in the incremental mode
+    bool m_clustersValid = false;
+
+    ///> items whose ratsnest cluster must be looked up again: the new items, the items whose
+    ///> net changed and the former neighbours of the removed items
+    std::unordered_set<CN_ITEM*> m_pendingItems;
+
+    ///> items from which the net propagation must search again
+    std::unordered_set<CN_ITEM*> m_propagationSeeds;
+
+    ///> ratsnest clusters which lost items, and may have to be split
+    std::unordered_set<CN_CLUSTER*> m_splitClusters;
+
+    ///> removed items still listed by the clusters of m_splitClusters.  They may be deleted
+    ///> already, so the pointers are only compared.
+    std::unordered_set<const CN_ITEM*> m_removedItems;
+
     void    searchConnections();
 
     void    update();
@@ -164,13 +186,46 @@ private:
         auto item = c.Add( brditem );
 
         m_itemMap[ brditem ] = ITEM_MAP_ENTRY( item );
+
+        if( item )
+            touchItem( item, false );
     }
 
     void markItemNetAsDirty( const BOARD_ITEM* aItem );
 
+    /**
+     * Adds the filled polygons of aZone, with their partitions if built in advance (see
+     * CN_LIST::Add()).  The zone must not be in the connectivity.
+     */
+    void addZone( ZONE_CONTAINER* aZone,
+                  std::vector<std::unique_ptr<POLY_GRID_PARTITION>>* aPartitions = nullptr );
+
+    ///> Removes the items of aItem from the connectivity graph
+    void removeEntry( const BOARD_ITEM* aItem );
+
+    /**
+     * Records a change of aItem for the incremental update of the clusters.
+     * @param aRemoved is true if the item is removed, false if it is new or its net changed
+     */
+    void touchItem( CN_ITEM* aItem, bool aRemoved );
+
+    ///> Brings m_ratsnestClusters up to date with the changes recorded by touchItem()
+    void updateRatsnestClusters();
+
+    /**
+     * Splits off aCluster the parts which are no longer connected to the rest, after items
+     * were removed from it.  The searches start from aBoundary, the former neighbours of the
+     * removed items, and are run side by side so that the cost is that of the smaller parts.
+     */
+    void splitCluster( CN_CLUSTER* aCluster, const std::vector<CN_ITEM*>& aBoundary,
+                       CLUSTERS& aNewClusters );
+
+    ///> @return the propagation clusters which contain the items of m_propagationSeeds
+    const CLUSTERS searchPropagationClusters();
+
 public:
 
-    CN_CONNECTIVITY_ALGO() {}
+    CN_CONNECTIVITY_ALGO();
     ~CN_CONNECTIVITY_ALGO() { Clear(); }
 
     bool ItemExists( const BOARD_CONNECTED_ITEM* aItem )
@@ -236,6 +291,8 @@ public:
      * Finds the copper islands that are not connected to a net.  These are added to
      * the m_islands vector.
      * N.B. This must be called after aZones has been refreshed.
+     * The partitions built in advance in aZones (see CONNECTIVITY_DATA::PrepareIslandSearch())
+     * are moved to the connectivity.
      * @param: aZones The set of zones to search for islands
      */
     void    FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones );
@@ -253,6 +310,8 @@ public:
     void MarkNetAsDirty( int aNet );
     void SetProgressReporter( PROGRESS_REPORTER* aReporter );
 
+    ///> @return the bytes of the items, of their lookup map and of the clusters
+    size_t MemoryUsage() const;
 };
 
 /**
@@ -27,23 +27,46 @@
 #include <profile.h>
 #endif
 
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <atomic>
+#include <map>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_snapshot.h>
+#include <geometry/kdtree_2d.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
+#include <trace_events.h>
+
+
+struct CONNECTIVITY_DATA::DYNAMIC_RATSNEST_CACHE
+{
+    ///> The nodes of a net which can be the target of a dynamic ratsnest line
+    struct NET_TARGETS
+    {
+        std::vector<CN_ANCHOR_PTR> m_nodes;
+        KDTREE_2D                  m_index;
+    };
+
+    ///> The moved items
+    std::vector<BOARD_ITEM*> m_items;
+
+    ///> The targets of the nets of the moved items, indexed once for the whole move
+    std::map<int, NET_TARGETS> m_nets;
+};
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_progressReporter = nullptr;
+    m_snapshot = std::make_shared<CONNECTIVITY_SNAPSHOT>();
 }
 
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA( const std::vector<BOARD_ITEM*>& aItems )
 {
+    m_snapshot = std::make_shared<CONNECTIVITY_SNAPSHOT>();
     Build( aItems );
     m_progressReporter = nullptr;
 }
@@ -77,8 +100,23 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 }
 
 
+void CONNECTIVITY_DATA::BeginBulkUpdate()
+{
+    m_connAlgo->ItemList().BeginBulkUpdate();
+}
+
+
+void CONNECTIVITY_DATA::EndBulkUpdate()
+{
+    m_connAlgo->ItemList().EndBulkUpdate();
+}
+
+
 void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 {
+    SCOPED_TRACE_EVENT trace( "CONNECTIVITY_DATA::Build" );
+
+    m_dynamicCache.reset();
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aBoard );
     RecalculateRatsnest();
@@ -87,6 +125,9 @@ void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    SCOPED_TRACE_EVENT trace( "CONNECTIVITY_DATA::Build" );
+
+    m_dynamicCache.reset();
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aItems );
 
@@ -106,32 +147,35 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
+    // Start with the biggest nets, so that the last one to finish is a small one instead of
+    // a big one left alone on a thread
+    std::sort( dirty_nets.begin(), dirty_nets.end(),
+            [] ( RN_NET* aFirst, RN_NET* aSecond )
+            {
+                return aFirst->GetNodeCount() > aSecond->GetNodeCount();
+            } );
+
+    size_t nodeCount = 0;
+
+    for( RN_NET* net : dirty_nets )
+        nodeCount += net->GetNodeCount();
+
+    // Waking up a worker is only worth it for a few hundred nodes
+    const size_t nodesPerThread = 256;
+    size_t parallelism = std::min( dirty_nets.size(), nodeCount / nodesPerThread + 1 );
 
     std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
+    auto update_lambda = [&nextNet, &dirty_nets]()
     {
         for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
             dirty_nets[i]->Update();
-
-        return 1;
     };
 
-    if( parallelThreadCount == 1 )
+    if( parallelism <= 1 )
         update_lambda();
     else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+        GetKiCadThreadPool().RunParallel( update_lambda, parallelism );
 
     #ifdef PROFILE
     rnUpdate.Show();
@@ -149,6 +193,11 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
+    SCOPED_TRACE_EVENT trace( "CONNECTIVITY_DATA::RecalculateRatsnest" );
+
+    // The nodes of the nets may change
+    m_dynamicCache.reset();
+
     m_connAlgo->PropagateNets( aCommit );
 
     int lastNet = m_connAlgo->NetCount();
@@ -165,12 +214,14 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
     auto clusters = m_connAlgo->GetClusters();
 
     int dirtyNets = 0;
+    std::vector<bool> changedNets( m_nets.size(), false );
 
     for( int net = 0; net < lastNet; net++ )
     {
         if( m_connAlgo->IsNetDirty( net ) )
         {
             m_nets[net]->Clear();
+            changedNets[net] = true;
             dirtyNets++;
         }
     }
@@ -188,6 +239,96 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
     m_connAlgo->ClearDirtyFlags();
 
     updateRatsnest();
+    updateSnapshot( changedNets );
+}
+
+
+void CONNECTIVITY_DATA::updateSnapshot( const std::vector<bool>& aChangedNets )
+{
+    auto prev = std::atomic_load( &m_snapshot );
+    auto snapshot = std::make_shared<CONNECTIVITY_SNAPSHOT>();
+
+    snapshot->m_version = prev->m_version + 1;
+
+    // The clusters which did not change since the last snapshot keep their copy
+    for( const auto& cluster : m_connAlgo->GetClusters() )
+    {
+        if( !cluster->HasValidNet() )
+            continue;
+
+        if( !cluster->GetSnapshot() )
+        {
+            auto copy = std::make_shared<CN_CLUSTER_SNAPSHOT>();
+
+            copy->m_net = cluster->OriginNet();
+            copy->m_conflicting = cluster->IsConflicting();
+            copy->m_items.reserve( cluster->Size() );
+
+            for( CN_ITEM* item : *cluster )
+            {
+                if( item->Valid() )
+                    copy->m_items.push_back( item->Parent() );
+            }
+
+            // The outlines of a zone are separate items of the cluster
+            std::sort( copy->m_items.begin(), copy->m_items.end() );
+            copy->m_items.erase( std::unique( copy->m_items.begin(), copy->m_items.end() ),
+                                 copy->m_items.end() );
+
+            cluster->SetSnapshot( copy );
+        }
+
+        snapshot->m_clusters.push_back( cluster->GetSnapshot() );
+    }
+
+    std::stable_sort( snapshot->m_clusters.begin(), snapshot->m_clusters.end(),
+            []( const std::shared_ptr<const CN_CLUSTER_SNAPSHOT>& aFirst,
+                const std::shared_ptr<const CN_CLUSTER_SNAPSHOT>& aSecond )
+            {
+                return aFirst->m_net < aSecond->m_net;
+            } );
+
+    snapshot->m_netEdges.resize( m_nets.size() );
+
+    for( unsigned int net = 1; net < m_nets.size(); net++ )
+    {
+        bool changed = net >= aChangedNets.size() || aChangedNets[net]
+                       || net >= prev->m_netEdges.size();
+
+        if( !changed )
+        {
+            snapshot->m_netEdges[net] = prev->m_netEdges[net];
+        }
+        else if( !m_nets[net]->GetUnconnected().empty() )
+        {
+            auto edges = std::make_shared<CONNECTIVITY_SNAPSHOT::EDGES>();
+
+            for( const auto& edge : m_nets[net]->GetUnconnected() )
+            {
+                CN_DISJOINT_NET_ENTRY ent;
+                ent.net = net;
+                ent.a   = edge.GetSourceNode()->Parent();
+                ent.b   = edge.GetTargetNode()->Parent();
+                ent.anchorA = edge.GetSourcePos();
+                ent.anchorB = edge.GetTargetPos();
+                edges->push_back( ent );
+            }
+
+            snapshot->m_netEdges[net] = edges;
+        }
+
+        if( snapshot->m_netEdges[net] )
+            snapshot->m_unconnectedCount += snapshot->m_netEdges[net]->size();
+    }
+
+    std::atomic_store( &m_snapshot,
+                       std::shared_ptr<const CONNECTIVITY_SNAPSHOT>( std::move( snapshot ) ) );
+}
+
+
+std::shared_ptr<const CONNECTIVITY_SNAPSHOT> CONNECTIVITY_DATA::GetSnapshot() const
+{
+    return std::atomic_load( &m_snapshot );
 }
 
 
@@ -242,6 +383,21 @@ void CONNECTIVITY_DATA::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_
 }
 
 
+void CONNECTIVITY_DATA::PrepareIslandSearch( CN_ZONE_ISOLATED_ISLAND_LIST& aZone )
+{
+    ZONE_CONTAINER* zone = aZone.m_zone;
+
+    aZone.m_partitions.clear();
+
+    // The other zones are not added to the connectivity
+    if( !zone->IsOnCopperLayer() )
+        return;
+
+    for( int ii = 0; ii < zone->GetFilledPolysList().OutlineCount(); ii++ )
+        aZone.m_partitions.push_back( CN_ZONE::BuildPartition( zone, ii ) );
+}
+
+
 void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems )
 {
     m_dynamicRatsnest.clear();
@@ -254,28 +410,77 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
         return ;
     }
 
+    // While the same items are moved, the rest of the board does not change: its nodes
+    // are blocked and indexed once, and only the nodes of the moved items are searched again
+    if( !m_dynamicCache || m_dynamicCache->m_items != aItems )
+    {
+        m_dynamicCache.reset( new DYNAMIC_RATSNEST_CACHE );
+        m_dynamicCache->m_items = aItems;
+        BlockRatsnestItems( aItems );
+    }
+
     CONNECTIVITY_DATA connData( aItems );
-    BlockRatsnestItems( aItems );
 
-    for( unsigned int nc = 1; nc < connData.m_nets.size(); nc++ )
+    for( unsigned int nc = 1; nc < connData.m_nets.size() && nc < m_nets.size(); nc++ )
     {
         auto dynNet = connData.m_nets[nc];
 
-        if( dynNet->GetNodeCount() != 0 )
+        if( dynNet->GetNodeCount() == 0 )
+            continue;
+
+        auto it = m_dynamicCache->m_nets.find( nc );
+
+        if( it == m_dynamicCache->m_nets.end() )
         {
-            auto ourNet = m_nets[nc];
-            CN_ANCHOR_PTR nodeA, nodeB;
+            DYNAMIC_RATSNEST_CACHE::NET_TARGETS& targets = m_dynamicCache->m_nets[nc];
+            std::vector<VECTOR2I>                positions;
 
-            if( ourNet->NearestBicoloredPair( *dynNet, nodeA, nodeB ) )
+            for( const auto& node : m_nets[nc]->GetNodes() )
             {
-                RN_DYNAMIC_LINE l;
-                l.a = nodeA->Pos();
-                l.b = nodeB->Pos();
-                l.netCode = nc;
+                if( !node->GetNoLine() )
+                {
+                    targets.m_nodes.push_back( node );
+                    positions.push_back( node->Pos() );
+                }
+            }
+
+            targets.m_index.Build( positions );
+            it = m_dynamicCache->m_nets.find( nc );
+        }
+
+        const DYNAMIC_RATSNEST_CACHE::NET_TARGETS& targets = it->second;
+
+        // The pair found by RN_NET::NearestBicoloredPair(), the nearest target of each
+        // moved node being found in the index
+        int                     bestTarget = -1;
+        CN_ANCHOR_PTR           bestNode;
+        VECTOR2I::extended_type bestDist = VECTOR2I::ECOORD_MAX;
+
+        for( const auto& node : dynNet->GetNodes() )
+        {
+            VECTOR2I::extended_type dist;
+            int target = targets.m_index.Nearest( node->Pos(), &dist );
 
-                m_dynamicRatsnest.push_back( l );
+            if( target < 0 )
+                break;
+
+            if( dist < bestDist || ( dist == bestDist && target < bestTarget ) )
+            {
+                bestTarget = target;
+                bestNode = node;
+                bestDist = dist;
             }
         }
+
+        if( bestTarget >= 0 )
+        {
+            RN_DYNAMIC_LINE l;
+            l.a = targets.m_nodes[bestTarget]->Pos();
+            l.b = bestNode->Pos();
+            l.netCode = nc;
+
+            m_dynamicRatsnest.push_back( l );
+        }
     }
 
     for( auto net : connData.m_nets )
@@ -305,6 +510,7 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
 
 void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 {
+    m_dynamicCache.reset();
     m_connAlgo->ForEachAnchor( [] ( CN_ANCHOR& anchor ) { anchor.SetNoLine( false ); } );
     HideDynamicRatsnest();
 }
@@ -345,10 +551,18 @@ unsigned int CONNECTIVITY_DATA::GetUnconnectedCount() const
 
 void CONNECTIVITY_DATA::Clear()
 {
+    m_dynamicCache.reset();
+
     for( auto net : m_nets )
         delete net;
 
     m_nets.clear();
+
+    auto snapshot = std::make_shared<CONNECTIVITY_SNAPSHOT>();
+    snapshot->m_version = GetSnapshot()->m_version + 1;
+
+    std::atomic_store( &m_snapshot,
+                       std::shared_ptr<const CONNECTIVITY_SNAPSHOT>( std::move( snapshot ) ) );
 }
 
 
@@ -666,6 +880,21 @@ void CONNECTIVITY_DATA::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 }
 
 
+size_t CONNECTIVITY_DATA::MemoryUsage() const
+{
+    size_t bytes = m_connAlgo->MemoryUsage() + m_nets.capacity() * sizeof( RN_NET* )
+                   + m_dynamicRatsnest.capacity() * sizeof( RN_DYNAMIC_LINE );
+
+    for( const RN_NET* net : m_nets )
+    {
+        if( net )
+            bytes += net->MemoryUsage();
+    }
+
+    return bytes;
+}
+
+
 const std::vector<CN_EDGE> CONNECTIVITY_DATA::GetRatsnestForComponent( MODULE* aComponent, bool aSkipInternalConnections )
 {
     std::set<int> nets;
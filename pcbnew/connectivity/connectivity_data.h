@@ -36,10 +36,12 @@
 
 #include <math/vector2d.h>
 #include <geometry/shape_poly_set.h>
+#include <geometry/poly_grid_partition.h>
 #include <class_zone.h>
 
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
+class CONNECTIVITY_SNAPSHOT;
 class CN_EDGE;
 class BOARD;
 class BOARD_COMMIT;
@@ -68,6 +70,10 @@ struct CN_ZONE_ISOLATED_ISLAND_LIST
 
     ZONE_CONTAINER*      m_zone;
     std::vector<int>     m_islands;
+
+    ///> The connection test structures of the filled polygons, if built in advance by
+    ///> CONNECTIVITY_DATA::PrepareIslandSearch()
+    std::vector<std::unique_ptr<POLY_GRID_PARTITION>> m_partitions;
 };
 
 struct RN_DYNAMIC_LINE
@@ -121,6 +127,20 @@ public:
      */
     bool Update( BOARD_ITEM* aItem );
 
+    /**
+     * Function BeginBulkUpdate()
+     * Defers the indexing of the items added from now on to EndBulkUpdate(), for the changes
+     * of many items at once.
+     */
+    void BeginBulkUpdate();
+
+    /**
+     * Function EndBulkUpdate()
+     * Indexes the items added since BeginBulkUpdate().  Must be called before the
+     * connectivity is searched again.
+     */
+    void EndBulkUpdate();
+
     /**
      * Function Clear()
      * Erases the connectivity database.
@@ -156,6 +176,14 @@ public:
     void FindIsolatedCopperIslands( ZONE_CONTAINER* aZone, std::vector<int>& aIslands );
     void FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones );
 
+    /**
+     * Function PrepareIslandSearch()
+     * Builds in advance the structures used by FindIsolatedCopperIslands() to test the
+     * connections to the filled polygons of aZone.m_zone.  It only reads the zone, so the
+     * zone filler calls it from its threads, once each zone is filled.
+     */
+    static void PrepareIslandSearch( CN_ZONE_ISOLATED_ISLAND_LIST& aZone );
+
     /**
      * Function RecalculateRatsnest()
      * Updates the ratsnest for the board.
@@ -244,23 +272,44 @@ public:
     void MarkItemNetAsDirty( BOARD_ITEM* aItem );
     void SetProgressReporter( PROGRESS_REPORTER* aReporter );
 
+    ///> @return the bytes of the connectivity items, of the clusters and of the ratsnest
+    size_t MemoryUsage() const;
+
 #ifndef SWIG
     const std::vector<CN_EDGE> GetRatsnestForComponent( MODULE* aComponent, bool aSkipInternalConnections = false );
+
+    /**
+     * Function GetSnapshot()
+     * Returns the connectivity as of the last ratsnest computation.  The snapshot is immutable,
+     * so it may be queried from any thread without holding the lock, while the connectivity
+     * is being changed.
+     */
+    std::shared_ptr<const CONNECTIVITY_SNAPSHOT> GetSnapshot() const;
 #endif
 
 private:
 
     void    updateRatsnest();
+
+    ///> Publishes a new snapshot, copying only the clusters and ratsnests of the changed nets
+    void    updateSnapshot( const std::vector<bool>& aChangedNets );
     void    addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& aCluster );
 
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
 
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
+
+    ///> The static part of the dynamic ratsnest, kept while the same items are moved
+    struct DYNAMIC_RATSNEST_CACHE;
+    std::unique_ptr<DYNAMIC_RATSNEST_CACHE> m_dynamicCache;
     std::vector<RN_NET*> m_nets;
 
     PROGRESS_REPORTER* m_progressReporter;
 
     std::mutex m_lock;
+
+    ///> Accessed with the atomic shared_ptr functions only
+    std::shared_ptr<const CONNECTIVITY_SNAPSHOT> m_snapshot;
 };
 
 #endif
@@ -206,8 +206,8 @@ CN_ITEM* CN_LIST::Add( D_PAD* pad )
     if( !pad->IsOnCopperLayer() )
          return nullptr;
 
-     auto item = new CN_ITEM( pad, false, 1 );
-     item->AddAnchor( pad->ShapePos() );
+     auto item = m_itemPool.New( pad, false, 1 );
+     item->AddAnchor( m_anchorPool, pad->ShapePos() );
      item->SetLayers( LAYER_RANGE( F_Cu, B_Cu ) );
 
      switch( pad->GetAttribute() )
@@ -240,10 +240,10 @@ CN_ITEM* CN_LIST::Add( D_PAD* pad )
 
 CN_ITEM* CN_LIST::Add( TRACK* track )
 {
-    auto item = new CN_ITEM( track, true );
+    auto item = m_itemPool.New( track, true );
     m_items.push_back( item );
-    item->AddAnchor( track->GetStart() );
-    item->AddAnchor( track->GetEnd() );
+    item->AddAnchor( m_anchorPool, track->GetStart() );
+    item->AddAnchor( m_anchorPool, track->GetEnd() );
     item->SetLayer( track->GetLayer() );
     addItemtoTree( item );
     SetDirty();
@@ -252,10 +252,10 @@ CN_ITEM* CN_LIST::Add( TRACK* track )
 
 CN_ITEM* CN_LIST::Add( ARC* aArc )
 {
-    auto item = new CN_ITEM( aArc, true );
+    auto item = m_itemPool.New( aArc, true );
     m_items.push_back( item );
-    item->AddAnchor( aArc->GetStart() );
-    item->AddAnchor( aArc->GetEnd() );
+    item->AddAnchor( m_anchorPool, aArc->GetStart() );
+    item->AddAnchor( m_anchorPool, aArc->GetEnd() );
     item->SetLayer( aArc->GetLayer() );
     addItemtoTree( item );
     SetDirty();
@@ -264,29 +264,35 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
 
  CN_ITEM* CN_LIST::Add( VIA* via )
  {
-     auto item = new CN_ITEM( via, true, 1 );
+     auto item = m_itemPool.New( via, true, 1 );
 
      m_items.push_back( item );
-     item->AddAnchor( via->GetStart() );
+     item->AddAnchor( m_anchorPool, via->GetStart() );
      item->SetLayers( LAYER_RANGE( F_Cu, B_Cu ) );
      addItemtoTree( item );
      SetDirty();
      return item;
  }
 
- const std::vector<CN_ITEM*> CN_LIST::Add( ZONE_CONTAINER* zone )
+ const std::vector<CN_ITEM*> CN_LIST::Add( ZONE_CONTAINER* zone,
+         std::vector<std::unique_ptr<POLY_GRID_PARTITION>>* aPartitions )
  {
      const auto& polys = zone->GetFilledPolysList();
 
      std::vector<CN_ITEM*> rv;
 
+     if( aPartitions && (int) aPartitions->size() != polys.OutlineCount() )
+         aPartitions = nullptr;
+
      for( int j = 0; j < polys.OutlineCount(); j++ )
      {
-         CN_ZONE* zitem = new CN_ZONE( zone, false, j );
+         CN_ZONE* zitem = m_zonePool.New( zone, false, j,
+                                          aPartitions ? std::move( ( *aPartitions )[j] )
+                                                      : nullptr );
          const auto& outline = zone->GetFilledPolysList().COutline( j );
 
          for( int k = 0; k < outline.PointCount(); k++ )
-             zitem->AddAnchor( outline.CPoint( k ) );
+             zitem->AddAnchor( m_anchorPool, outline.CPoint( k ) );
 
          m_items.push_back( zitem );
          zitem->SetLayer( zone->GetLayer() );
@@ -299,6 +305,30 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
  }
 
 
+void CN_LIST::Delete( CN_ITEM* aItem )
+{
+    if( auto zone = dynamic_cast<CN_ZONE*>( aItem ) )
+        m_zonePool.Delete( zone );
+    else
+        m_itemPool.Delete( aItem );
+}
+
+
+size_t CN_LIST::MemoryUsage() const
+{
+    size_t bytes = m_itemPool.MemoryUsage() + m_zonePool.MemoryUsage()
+                   + m_anchorPool->MemoryUsage() + m_items.capacity() * sizeof( CN_ITEM* );
+
+    for( const CN_ITEM* item : m_items )
+    {
+        bytes += item->ConnectedItems().capacity() * sizeof( CN_ITEM* );
+        bytes += item->Anchors().capacity() * sizeof( CN_ANCHOR_PTR );
+    }
+
+    return bytes;
+}
+
+
 void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 {
     if( !m_hasInvalid )
@@ -317,8 +347,15 @@ void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 
     m_items.resize( lastItem - m_items.begin() );
 
-    for( auto item : m_items )
-        item->RemoveInvalidRefs();
+    // Connections are reciprocal, so only the neighbours of the removed items refer to them
+    for( auto item : aGarbage )
+    {
+        for( auto neighbour : item->ConnectedItems() )
+        {
+            if( neighbour->Valid() )
+                neighbour->RemoveInvalidRefs();
+        }
+    }
 
     for( auto item : aGarbage )
         m_index.Remove( item );
@@ -456,7 +493,27 @@ void CN_CLUSTER::Dump()
 void CN_CLUSTER::Add( CN_ITEM* item )
 {
     m_items.push_back( item );
+    updateOrigin( item );
+    m_snapshot.reset();
+}
+
+
+void CN_CLUSTER::RemoveIf( const std::function<bool( CN_ITEM* )>& aPredicate )
+{
+    m_items.erase( std::remove_if( m_items.begin(), m_items.end(), aPredicate ), m_items.end() );
+
+    m_snapshot.reset();
+    m_originPad = nullptr;
+    m_originNet = -1;
+    m_conflicting = false;
+
+    for( auto item : m_items )
+        updateOrigin( item );
+}
 
+
+void CN_CLUSTER::updateOrigin( CN_ITEM* item )
+{
     if( item->Net() <= 0 )
         return;
 
@@ -40,7 +40,9 @@
 
 #include <memory>
 #include <algorithm>
+#include <cassert>
 #include <functional>
+#include <type_traits>
 #include <vector>
 #include <deque>
 #include <intrusive_list.h>
@@ -50,6 +52,109 @@
 
 class CN_ITEM;
 class CN_CLUSTER;
+class CN_ANCHOR_POOL;
+struct CN_CLUSTER_SNAPSHOT;
+
+
+/**
+ * Class CN_POOL
+ *
+ * Allocates objects of type T in blocks, and recycles the memory of the deleted objects for
+ * the next allocations.  The blocks are released with the pool, or by Clear() once all the
+ * objects are deleted.
+ */
+template <class T>
+class CN_POOL
+{
+public:
+    CN_POOL() :
+        m_free( nullptr ),
+        m_blockUsed( BLOCK_SIZE ),
+        m_count( 0 )
+    {
+    }
+
+    CN_POOL( const CN_POOL& ) = delete;
+    CN_POOL& operator=( const CN_POOL& ) = delete;
+
+    ~CN_POOL()
+    {
+        assert( m_count == 0 );
+    }
+
+    template <typename... ARGS>
+    T* New( ARGS&&... aArgs )
+    {
+        SLOT* slot;
+
+        if( m_free )
+        {
+            slot = m_free;
+            m_free = m_free->m_next;
+        }
+        else
+        {
+            if( m_blockUsed == BLOCK_SIZE )
+            {
+                m_blocks.emplace_back( new SLOT[BLOCK_SIZE] );
+                m_blockUsed = 0;
+            }
+
+            slot = &m_blocks.back()[m_blockUsed++];
+        }
+
+        m_count++;
+
+        return new( &slot->m_storage ) T( std::forward<ARGS>( aArgs )... );
+    }
+
+    void Delete( T* aObject )
+    {
+        aObject->~T();
+
+        SLOT* slot = reinterpret_cast<SLOT*>( aObject );
+        slot->m_next = m_free;
+        m_free = slot;
+        m_count--;
+    }
+
+    ///> Releases the blocks; all the objects must have been deleted
+    void Clear()
+    {
+        assert( m_count == 0 );
+
+        m_blocks.clear();
+        m_free = nullptr;
+        m_blockUsed = BLOCK_SIZE;
+    }
+
+    ///> @return the number of allocated objects
+    size_t Count() const
+    {
+        return m_count;
+    }
+
+    ///> @return the bytes of the blocks of the pool
+    size_t MemoryUsage() const
+    {
+        return m_blocks.size() * BLOCK_SIZE * sizeof( SLOT );
+    }
+
+private:
+    static const int BLOCK_SIZE = 256;
+
+    union SLOT
+    {
+        SLOT* m_next;
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type m_storage;
+    };
+
+    std::vector<std::unique_ptr<SLOT[]>> m_blocks;
+    SLOT*  m_free;
+    int    m_blockUsed;
+    size_t m_count;
+};
+
 
 class CN_ANCHOR
 {
@@ -66,6 +171,9 @@ public:
         assert( m_item );
     }
 
+    CN_ANCHOR( const CN_ANCHOR& ) = delete;
+    CN_ANCHOR& operator=( const CN_ANCHOR& ) = delete;
+
     bool Valid() const;
 
 
@@ -149,10 +257,175 @@ private:
 
     /// Cluster to which the anchor belongs
     std::shared_ptr<CN_CLUSTER> m_cluster;
+
+    /// Number of CN_ANCHOR_PTR referring to the anchor
+    int m_refCount = 0;
+
+    /// Pool the anchor was allocated from
+    CN_ANCHOR_POOL* m_pool = nullptr;
+
+    friend class CN_ANCHOR_PTR;
+    friend class CN_ANCHOR_POOL;
+    friend class CN_ITEM;
 };
 
 
-typedef std::shared_ptr<CN_ANCHOR>  CN_ANCHOR_PTR;
+/**
+ * Class CN_ANCHOR_POOL
+ *
+ * The anchors of the items of a CN_LIST.  The ratsnest keeps handles to the anchors, which can
+ * outlive their items and the list itself, so the pool is deleted by the last of its users:
+ * the list (see Release()) or the last anchor.
+ */
+class CN_ANCHOR_POOL
+{
+public:
+    CN_ANCHOR* New( const VECTOR2I& aPos, CN_ITEM* aItem )
+    {
+        CN_ANCHOR* anchor = m_anchors.New( aPos, aItem );
+
+        anchor->m_pool = this;
+        return anchor;
+    }
+
+    void Delete( CN_ANCHOR* aAnchor )
+    {
+        m_anchors.Delete( aAnchor );
+
+        if( m_released && m_anchors.Count() == 0 )
+            delete this;
+    }
+
+    ///> Called by the owner of the pool instead of deleting it
+    void Release()
+    {
+        m_released = true;
+
+        if( m_anchors.Count() == 0 )
+            delete this;
+    }
+
+    size_t MemoryUsage() const
+    {
+        return m_anchors.MemoryUsage();
+    }
+
+private:
+    CN_POOL<CN_ANCHOR> m_anchors;
+    bool               m_released = false;
+};
+
+
+/**
+ * Class CN_ANCHOR_PTR
+ *
+ * A reference counted handle to a CN_ANCHOR, the count being kept in the anchor.  The anchor
+ * goes back to its pool with the last handle.  The count is not atomic: an anchor must only
+ * be handled by one thread at a time, which is the case as the ratsnest nets are updated in
+ * parallel but each anchor belongs to a single net.
+ */
+class CN_ANCHOR_PTR
+{
+public:
+    CN_ANCHOR_PTR() :
+        m_anchor( nullptr )
+    {
+    }
+
+    CN_ANCHOR_PTR( std::nullptr_t ) :
+        m_anchor( nullptr )
+    {
+    }
+
+    explicit CN_ANCHOR_PTR( CN_ANCHOR* aAnchor ) :
+        m_anchor( aAnchor )
+    {
+        acquire();
+    }
+
+    CN_ANCHOR_PTR( const CN_ANCHOR_PTR& aOther ) :
+        m_anchor( aOther.m_anchor )
+    {
+        acquire();
+    }
+
+    CN_ANCHOR_PTR( CN_ANCHOR_PTR&& aOther ) noexcept :
+        m_anchor( aOther.m_anchor )
+    {
+        aOther.m_anchor = nullptr;
+    }
+
+    ~CN_ANCHOR_PTR()
+    {
+        release();
+    }
+
+    CN_ANCHOR_PTR& operator=( CN_ANCHOR_PTR aOther )
+    {
+        std::swap( m_anchor, aOther.m_anchor );
+        return *this;
+    }
+
+    CN_ANCHOR* get() const
+    {
+        return m_anchor;
+    }
+
+    CN_ANCHOR* operator->() const
+    {
+        return m_anchor;
+    }
+
+    CN_ANCHOR& operator*() const
+    {
+        return *m_anchor;
+    }
+
+    explicit operator bool() const
+    {
+        return m_anchor != nullptr;
+    }
+
+    bool operator==( const CN_ANCHOR_PTR& aOther ) const
+    {
+        return m_anchor == aOther.m_anchor;
+    }
+
+    bool operator!=( const CN_ANCHOR_PTR& aOther ) const
+    {
+        return m_anchor != aOther.m_anchor;
+    }
+
+private:
+    void acquire()
+    {
+        if( m_anchor )
+            m_anchor->m_refCount++;
+    }
+
+    void release()
+    {
+        if( m_anchor && --m_anchor->m_refCount == 0 )
+            m_anchor->m_pool->Delete( m_anchor );
+    }
+
+    CN_ANCHOR* m_anchor;
+};
+
+
+namespace std
+{
+    template <>
+    struct hash<CN_ANCHOR_PTR>
+    {
+        size_t operator()( const CN_ANCHOR_PTR& aAnchor ) const
+        {
+            return hash<CN_ANCHOR*>()( aAnchor.get() );
+        }
+    };
+}
+
+
 typedef std::vector<CN_ANCHOR_PTR>  CN_ANCHORS;
 
 
@@ -182,6 +455,9 @@ private:
     ///> mutex protecting this item's connected_items set to allow parallel connection threads
     std::mutex m_listLock;
 
+    ///> ratsnest cluster of the item, kept only by the incremental cluster update
+    CN_CLUSTER* m_cluster;
+
 protected:
     ///> dirty flag, used to identify recently added item not yet scanned into the connectivity search
     bool m_dirty;
@@ -202,16 +478,22 @@ public:
         m_visited = false;
         m_valid = true;
         m_dirty = true;
-        m_anchors.reserve( std::max( 6, aAnchorCount ) );
+        m_cluster = nullptr;
+        m_anchors.reserve( aAnchorCount );
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
         m_connected.reserve( 8 );
     }
 
-    virtual ~CN_ITEM() {};
+    virtual ~CN_ITEM()
+    {
+        // The ratsnest may still refer to the anchors
+        for( auto& anchor : m_anchors )
+            anchor->m_item = nullptr;
+    }
 
-    void AddAnchor( const VECTOR2I& aPos )
+    void AddAnchor( CN_ANCHOR_POOL* aPool, const VECTOR2I& aPos )
     {
-        m_anchors.emplace_back( std::make_shared<CN_ANCHOR>( aPos, this ) );
+        m_anchors.emplace_back( aPool->New( aPos, this ) );
     }
 
     CN_ANCHORS& Anchors()
@@ -219,6 +501,11 @@ public:
         return m_anchors;
     }
 
+    const CN_ANCHORS& Anchors() const
+    {
+        return m_anchors;
+    }
+
     void SetValid( bool aValid )
     {
         m_valid = aValid;
@@ -314,6 +601,16 @@ public:
         return m_visited;
     }
 
+    void SetCluster( CN_CLUSTER* aCluster )
+    {
+        m_cluster = aCluster;
+    }
+
+    CN_CLUSTER* Cluster() const
+    {
+        return m_cluster;
+    }
+
     bool CanChangeNet() const
     {
         return m_canChangeNet;
@@ -344,16 +641,36 @@ typedef std::shared_ptr<CN_ITEM> CN_ITEM_PTR;
 class CN_ZONE : public CN_ITEM
 {
 public:
-    CN_ZONE( ZONE_CONTAINER* aParent, bool aCanChangeNet, int aSubpolyIndex ) :
+    /**
+     * @param aPartition, if not null, is the partition of the filled polygon built in advance
+     * by BuildPartition()
+     */
+    CN_ZONE( ZONE_CONTAINER* aParent, bool aCanChangeNet, int aSubpolyIndex,
+             std::unique_ptr<POLY_GRID_PARTITION> aPartition = nullptr ) :
         CN_ITEM( aParent, aCanChangeNet ),
         m_subpolyIndex( aSubpolyIndex )
     {
-        SHAPE_LINE_CHAIN outline = aParent->GetFilledPolysList().COutline( aSubpolyIndex );
+        if( aPartition )
+            m_cachedPoly = std::move( aPartition );
+        else
+            m_cachedPoly = BuildPartition( aParent, aSubpolyIndex );
+    }
+
+    /**
+     * Function BuildPartition()
+     *
+     * Builds the structure used to test the connections to the filled polygon aSubpolyIndex
+     * of aZone.  Only reads the zone, so it can be called by several threads.
+     */
+    static std::unique_ptr<POLY_GRID_PARTITION> BuildPartition( const ZONE_CONTAINER* aZone,
+                                                                int aSubpolyIndex )
+    {
+        SHAPE_LINE_CHAIN outline = aZone->GetFilledPolysList().COutline( aSubpolyIndex );
 
         outline.SetClosed( true );
         outline.Simplify();
 
-        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
+        return std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
     }
 
     int SubpolyIndex() const
@@ -361,7 +678,7 @@ public:
         return m_subpolyIndex;
     }
 
-    bool ContainsAnchor( const CN_ANCHOR_PTR anchor ) const
+    bool ContainsAnchor( const CN_ANCHOR_PTR& anchor ) const
     {
         return ContainsPoint( anchor->Pos() );
     }
@@ -395,15 +712,22 @@ class CN_LIST
 private:
     bool m_dirty;
     bool m_hasInvalid;
+    bool m_bulkLoading;
+    size_t m_bulkStart;     ///< the first item added since BeginBulkUpdate()
 
     CN_RTREE<CN_ITEM*> m_index;
 
+    CN_POOL<CN_ITEM> m_itemPool;
+    CN_POOL<CN_ZONE> m_zonePool;
+    CN_ANCHOR_POOL*  m_anchorPool;
+
 protected:
     std::vector<CN_ITEM*> m_items;
 
     void addItemtoTree( CN_ITEM* item )
     {
-        m_index.Insert( item );
+        if( !m_bulkLoading )
+            m_index.Insert( item );
     }
 
 public:
@@ -411,17 +735,88 @@ public:
     {
         m_dirty = false;
         m_hasInvalid = false;
+        m_bulkLoading = false;
+        m_bulkStart = 0;
+        m_anchorPool = new CN_ANCHOR_POOL;
+    }
+
+    ~CN_LIST()
+    {
+        Clear();
+        m_anchorPool->Release();
+    }
+
+    /**
+     * Defers the indexing of the items added from now on to EndBulkLoad().
+     */
+    void BeginBulkLoad()
+    {
+        m_bulkLoading = true;
+    }
+
+    /**
+     * Indexes all the items of the list at once (packing the index is much faster than
+     * inserting the items one by one).
+     */
+    void EndBulkLoad()
+    {
+        m_bulkLoading = false;
+        m_index.BulkLoad( m_items );
+    }
+
+    /**
+     * Defers the indexing of the items added from now on to EndBulkUpdate().  Unlike
+     * BeginBulkLoad(), the list may already hold indexed items.
+     */
+    void BeginBulkUpdate()
+    {
+        m_bulkLoading = true;
+        m_bulkStart = m_items.size();
+    }
+
+    /**
+     * Indexes the items added since BeginBulkUpdate(), one by one, or by packing the index
+     * again when they are a large share of the list.
+     */
+    void EndBulkUpdate()
+    {
+        m_bulkLoading = false;
+
+        if( ( m_items.size() - m_bulkStart ) * 4 > m_items.size() )
+        {
+            m_index.RemoveAll();
+            m_index.BulkLoad( m_items );
+        }
+        else
+        {
+            for( size_t i = m_bulkStart; i < m_items.size(); ++i )
+                m_index.Insert( m_items[i] );
+        }
     }
 
     void Clear()
     {
         for( auto item : m_items )
-            delete item;
+            Delete( item );
 
         m_items.clear();
         m_index.RemoveAll();
+
+        // Release the memory of the items and of the anchors at once.  The anchors still
+        // referred to by the ratsnest keep the old pool until they are gone.
+        m_itemPool.Clear();
+        m_zonePool.Clear();
+        m_anchorPool->Release();
+        m_anchorPool = new CN_ANCHOR_POOL;
     }
 
+    /**
+     * Function Delete()
+     *
+     * Deletes an item allocated by Add(), which must not be in the list any more.
+     */
+    void Delete( CN_ITEM* aItem );
+
     using ITER = decltype(m_items)::iterator;
 
     ITER begin() { return m_items.begin(); };
@@ -452,6 +847,9 @@ public:
 
     void RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage );
 
+    ///> @return the bytes of the items and of their anchors and connections
+    size_t MemoryUsage() const;
+
     void ClearDirtyFlags()
     {
         for( auto item : m_items )
@@ -481,7 +879,13 @@ public:
 
     CN_ITEM* Add( VIA* via );
 
-    const std::vector<CN_ITEM*> Add( ZONE_CONTAINER* zone );
+    /**
+     * Adds the filled polygons of zone.
+     * @param aPartitions, if not null, are the partitions of the polygons built in advance (see
+     * CN_ZONE::BuildPartition()).  They are used if there is one per polygon.
+     */
+    const std::vector<CN_ITEM*> Add( ZONE_CONTAINER* zone,
+            std::vector<std::unique_ptr<POLY_GRID_PARTITION>>* aPartitions = nullptr );
 };
 
 class CN_CLUSTER
@@ -493,6 +897,11 @@ private:
     CN_ITEM* m_originPad = nullptr;
     std::vector<CN_ITEM*> m_items;
 
+    ///> Copy of the cluster in the last connectivity snapshot, dropped when the cluster changes
+    std::shared_ptr<const CN_CLUSTER_SNAPSHOT> m_snapshot;
+
+    void updateOrigin( CN_ITEM* aItem );
+
 public:
     CN_CLUSTER();
     ~CN_CLUSTER();
@@ -518,6 +927,11 @@ public:
         return m_items.size();
     }
 
+    size_t MemoryUsage() const
+    {
+        return sizeof( CN_CLUSTER ) + m_items.capacity() * sizeof( CN_ITEM* );
+    }
+
     bool HasNet() const
     {
         return m_originNet > 0;
@@ -535,6 +949,22 @@ public:
 
     void Add( CN_ITEM* item );
 
+    /**
+     * Removes the items matching aPredicate and recomputes the origin of the cluster.
+     * aPredicate may be called on items which were deleted, so it must not dereference them.
+     */
+    void RemoveIf( const std::function<bool( CN_ITEM* )>& aPredicate );
+
+    const std::shared_ptr<const CN_CLUSTER_SNAPSHOT>& GetSnapshot() const
+    {
+        return m_snapshot;
+    }
+
+    void SetSnapshot( const std::shared_ptr<const CN_CLUSTER_SNAPSHOT>& aSnapshot )
+    {
+        m_snapshot = aSnapshot;
+    }
+
     using ITER = decltype(m_items)::iterator;
 
     ITER begin() { return m_items.begin(); };
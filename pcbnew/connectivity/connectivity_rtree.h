@@ -65,6 +65,29 @@ public:
         m_tree->Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Replaces the content of the tree by aItems.  The tree is packed in one go, which is
+     * much faster than inserting the items one by one and gives faster queries.
+     */
+    void BulkLoad( const std::vector<T>& aItems )
+    {
+        std::vector<typename RTree<T, int, 3, double>::BulkEntry> entries;
+        entries.reserve( aItems.size() );
+
+        for( T item : aItems )
+        {
+            const BOX2I&        bbox    = item->BBox();
+            const LAYER_RANGE   layers  = item->Layers();
+
+            entries.push_back( { { { layers.Start(), bbox.GetX(), bbox.GetY() },
+                                   { layers.End(), bbox.GetRight(), bbox.GetBottom() } },
+                                 item } );
+        }
+
+        m_tree->BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attempting
@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <connectivity/connectivity_snapshot.h>
+
+#include <algorithm>
+
+#include <board_connected_item.h>
+
+
+static bool hasType( const BOARD_CONNECTED_ITEM* aItem, const KICAD_T aTypes[] )
+{
+    for( int i = 0; aTypes[i] > 0; ++i )
+    {
+        if( aItem->Type() == aTypes[i] )
+            return true;
+    }
+
+    return false;
+}
+
+
+CONNECTIVITY_SNAPSHOT::CONNECTIVITY_SNAPSHOT() :
+        m_version( 0 ),
+        m_unconnectedCount( 0 )
+{
+}
+
+
+const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_SNAPSHOT::GetConnectedItems(
+        const BOARD_CONNECTED_ITEM* aItem, const KICAD_T aTypes[] ) const
+{
+    std::call_once( m_itemIndexBuilt,
+            [this]()
+            {
+                for( const auto& cluster : m_clusters )
+                {
+                    for( BOARD_CONNECTED_ITEM* item : cluster->m_items )
+                        m_itemIndex.emplace( item, cluster.get() );
+                }
+            } );
+
+    std::vector<BOARD_CONNECTED_ITEM*> rv;
+    auto range = m_itemIndex.equal_range( aItem );
+
+    for( auto it = range.first; it != range.second; ++it )
+    {
+        for( BOARD_CONNECTED_ITEM* item : it->second->m_items )
+        {
+            if( hasType( item, aTypes ) )
+                rv.push_back( item );
+        }
+    }
+
+    // An item in several clusters is connected to the items of all of them
+    if( std::distance( range.first, range.second ) > 1 )
+    {
+        std::sort( rv.begin(), rv.end() );
+        rv.erase( std::unique( rv.begin(), rv.end() ), rv.end() );
+    }
+
+    return rv;
+}
+
+
+const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_SNAPSHOT::GetNetItems( int aNetCode,
+        const KICAD_T aTypes[] ) const
+{
+    std::vector<BOARD_CONNECTED_ITEM*> rv;
+
+    auto first = std::lower_bound( m_clusters.begin(), m_clusters.end(), aNetCode,
+            []( const std::shared_ptr<const CN_CLUSTER_SNAPSHOT>& aCluster, int aNet )
+            {
+                return aCluster->m_net < aNet;
+            } );
+
+    for( auto it = first; it != m_clusters.end() && ( *it )->m_net == aNetCode; ++it )
+    {
+        for( BOARD_CONNECTED_ITEM* item : ( *it )->m_items )
+        {
+            if( hasType( item, aTypes ) )
+                rv.push_back( item );
+        }
+    }
+
+    // The clusters of a net are disjoint, except for the zones having several outlines
+    std::sort( rv.begin(), rv.end() );
+    rv.erase( std::unique( rv.begin(), rv.end() ), rv.end() );
+
+    return rv;
+}
+
+
+const CONNECTIVITY_SNAPSHOT::EDGES& CONNECTIVITY_SNAPSHOT::GetUnconnectedEdges( int aNetCode ) const
+{
+    static const EDGES empty;
+
+    if( aNetCode < 0 || aNetCode >= (int) m_netEdges.size() || !m_netEdges[aNetCode] )
+        return empty;
+
+    return *m_netEdges[aNetCode];
+}
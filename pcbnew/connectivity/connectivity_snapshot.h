@@ -0,0 +1,128 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __CONNECTIVITY_SNAPSHOT_H
+#define __CONNECTIVITY_SNAPSHOT_H
+
+#include <core/typeinfo.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <connectivity/connectivity_data.h>
+
+class BOARD_CONNECTED_ITEM;
+
+
+/**
+ * Struct CN_CLUSTER_SNAPSHOT
+ * is an immutable copy of a CN_CLUSTER.  The cluster keeps it until it changes, so the
+ * consecutive snapshots share the copies of the clusters which did not change.
+ */
+struct CN_CLUSTER_SNAPSHOT
+{
+    int                                m_net;
+    bool                               m_conflicting;
+    std::vector<BOARD_CONNECTED_ITEM*> m_items;
+};
+
+
+/**
+ * Class CONNECTIVITY_SNAPSHOT
+ *
+ * An immutable copy of the connectivity as of a ratsnest computation: the clusters of connected
+ * items and the unconnected edges of the ratsnest.  Background jobs may hold and query it
+ * without locking while the editor keeps changing the live connectivity.
+ *
+ * The snapshot does not own the board items it refers to: a job must not dereference the items
+ * removed from the board after the snapshot was made.
+ */
+class CONNECTIVITY_SNAPSHOT
+{
+public:
+    typedef std::vector<std::shared_ptr<const CN_CLUSTER_SNAPSHOT>> CLUSTERS;
+    typedef std::vector<CN_DISJOINT_NET_ENTRY>                     EDGES;
+
+    CONNECTIVITY_SNAPSHOT();
+
+    ///> @return the number of the snapshot, which grows with each ratsnest computation
+    unsigned int GetVersion() const
+    {
+        return m_version;
+    }
+
+    ///> @return the clusters of items (with a net), sorted by net
+    const CLUSTERS& GetClusters() const
+    {
+        return m_clusters;
+    }
+
+    /**
+     * Function GetConnectedItems()
+     * @return the items connected to aItem (aItem included) whose type is in aTypes.
+     * @param aTypes is a list of types ended by EOT
+     */
+    const std::vector<BOARD_CONNECTED_ITEM*> GetConnectedItems( const BOARD_CONNECTED_ITEM* aItem,
+            const KICAD_T aTypes[] ) const;
+
+    /**
+     * Function GetNetItems()
+     * @return the items of the net aNetCode (greater than 0) whose type is in aTypes.
+     * @param aTypes is a list of types ended by EOT
+     */
+    const std::vector<BOARD_CONNECTED_ITEM*> GetNetItems( int aNetCode,
+            const KICAD_T aTypes[] ) const;
+
+    ///> @return the unconnected edges of the ratsnest of the net aNetCode
+    const EDGES& GetUnconnectedEdges( int aNetCode ) const;
+
+    unsigned int GetUnconnectedCount() const
+    {
+        return m_unconnectedCount;
+    }
+
+    int GetNetCount() const
+    {
+        return m_netEdges.size();
+    }
+
+private:
+    friend class CONNECTIVITY_DATA;
+
+    unsigned int m_version;
+    CLUSTERS     m_clusters;
+
+    ///> Unconnected edges of each net, shared with the previous snapshot if the net did not change
+    std::vector<std::shared_ptr<const EDGES>> m_netEdges;
+
+    unsigned int m_unconnectedCount;
+
+    ///> Clusters of each item (a zone may be in several ones), indexed at the first query
+    mutable std::once_flag m_itemIndexBuilt;
+    mutable std::unordered_multimap<const BOARD_CONNECTED_ITEM*,
+                                    const CN_CLUSTER_SNAPSHOT*> m_itemIndex;
+};
+
+#endif
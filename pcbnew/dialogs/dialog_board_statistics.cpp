@@ -24,6 +24,7 @@
 
 
 #include "dialog_board_statistics.h"
+#include <memory_usage.h>
 #include <wildcards_and_files_ext.h>
 
 #define COL_LABEL 0
@@ -108,6 +109,23 @@ DIALOG_BOARD_STATISTICS::DIALOG_BOARD_STATISTICS( PCB_EDIT_FRAME* aParentFrame )
             grid->SetCellAlignment( i, COL_LABEL, wxALIGN_LEFT, wxALIGN_CENTRE );
     }
 
+    // The memory page, which the form builder file does not have
+    wxPanel*    memoryPanel = new wxPanel( topNotebook );
+    wxBoxSizer* memorySizer = new wxBoxSizer( wxVERTICAL );
+
+    m_gridMemory = new wxGrid( memoryPanel, wxID_ANY );
+    m_gridMemory->CreateGrid( 0, 2 );
+    m_gridMemory->EnableEditing( false );
+    m_gridMemory->EnableGridLines( false );
+    m_gridMemory->SetColLabelSize( 0 );
+    m_gridMemory->SetRowLabelSize( 0 );
+    m_gridMemory->SetCellHighlightPenWidth( 0 );
+    m_gridMemory->SetColMinimalAcceptableWidth( 80 );
+
+    memorySizer->Add( m_gridMemory, 1, wxALL | wxEXPAND, 5 );
+    memoryPanel->SetSizer( memorySizer );
+    topNotebook->AddPage( memoryPanel, _( "Memory" ) );
+
     wxFileName fn = m_parentFrame->GetBoard()->GetFileName();
 
     if( !s_savedDialogState.saveReportInitialized
@@ -429,12 +447,14 @@ void DIALOG_BOARD_STATISTICS::updateWidets()
     }
 
     updateDrillGrid();
+    updateMemoryGrid();
 
     m_gridComponents->AutoSize();
     m_gridPads->AutoSize();
     m_gridBoard->AutoSize();
     m_gridVias->AutoSize();
     m_gridDrills->AutoSize();
+    m_gridMemory->AutoSize();
 
     adjustDrillGridColumns();
 }
@@ -491,6 +511,37 @@ void DIALOG_BOARD_STATISTICS::updateDrillGrid()
     }
 }
 
+void DIALOG_BOARD_STATISTICS::updateMemoryGrid()
+{
+    std::vector<MEMORY_USAGE::ENTRY> report = MEMORY_USAGE::Get().Report();
+    size_t                           total = 0;
+    int                              currentRow = 0;
+
+    if( m_gridMemory->GetNumberRows() > 0 )
+        m_gridMemory->DeleteRows( 0, m_gridMemory->GetNumberRows() );
+
+    m_gridMemory->AppendRows( report.size() + 1 );
+
+    auto setRow =
+            [&]( const wxString& aLabel, size_t aBytes )
+            {
+                m_gridMemory->SetCellValue( currentRow, COL_LABEL, aLabel );
+                m_gridMemory->SetCellValue( currentRow, COL_AMOUNT,
+                                            MEMORY_USAGE::FormatBytes( aBytes ) );
+                m_gridMemory->SetCellAlignment( currentRow, COL_AMOUNT, wxALIGN_RIGHT,
+                                                wxALIGN_CENTRE );
+                currentRow++;
+            };
+
+    for( const MEMORY_USAGE::ENTRY& entry : report )
+    {
+        setRow( wxString::FromUTF8( entry.first.c_str() ) + ":", entry.second );
+        total += entry.second;
+    }
+
+    setRow( _( "Total:" ), total );
+}
+
 void DIALOG_BOARD_STATISTICS::printGridToStringAsTable( wxGrid* aGrid, wxString& aStr,
         bool aUseRowLabels, bool aUseColLabels, bool aUseFirstColAsLabel )
 {
@@ -727,6 +778,15 @@ void DIALOG_BOARD_STATISTICS::saveReportClicked( wxCommandEvent& aEvent )
 
     printGridToStringAsTable( m_gridDrills, msg, false, true, false );
 
+    msg << "\n";
+    msg << _( "Memory\n------" ) << "\n";
+
+    for( int row = 0; row < m_gridMemory->GetNumberRows(); row++ )
+    {
+        msg << "- " << m_gridMemory->GetCellValue( row, COL_LABEL ) << " "
+            << m_gridMemory->GetCellValue( row, COL_AMOUNT ) << "\n";
+    }
+
     if( fprintf( outFile, "%s", TO_UTF8( msg ) ) < 0 )
     {
         msg.Printf( _( "Error writing to file \"%s\"" ), saveFileDialog.GetPath() );
@@ -197,6 +197,9 @@ private:
     ///> Holds all drill hole types to be shown in the dialog
     drillTypeList_t m_drillTypes;
 
+    ///> The memory used by the subsystems, in a page built by the dialog itself
+    wxGrid* m_gridMemory;
+
     ///> Function to fill up all items types to be shown in the dialog.
     void refreshItemsTypes();
 
@@ -209,6 +212,9 @@ private:
     ///> Updates drills grid
     void updateDrillGrid();
 
+    ///> Updates the memory grid from the MEMORY_USAGE report
+    void updateMemoryGrid();
+
     ///> Prints grid to string in tabular format
     void printGridToStringAsTable( wxGrid* aGrid, wxString& aStr, bool aUseRowLabels,
             bool aUseColLabels, bool aUseFirstColAsLabel );
@@ -483,6 +483,12 @@ void DIALOG_DRC::deleteAllMarkers()
     // Clear current selection list to avoid selection of deleted items
     m_brdEditor->GetToolManager()->RunAction( PCB_ACTIONS::selectionClear, true );
 
+    // Take the markers out of the view in one pass, rather than one by one as they get deleted
+    MARKERS&                       markers = m_brdEditor->GetBoard()->Markers();
+    std::vector<KIGFX::VIEW_ITEM*> viewItems( markers.begin(), markers.end() );
+
+    m_brdEditor->GetCanvas()->GetView()->RemoveItems( viewItems );
+
     m_markerTreeModel->DeleteAllItems();
     m_unconnectedTreeModel->DeleteAllItems();
 }
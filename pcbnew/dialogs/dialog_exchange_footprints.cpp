@@ -28,8 +28,10 @@
 #include <board_commit.h>
 #include <class_board.h>
 #include <class_module.h>
+#include <class_pad.h>
 #include <dialog_exchange_footprints.h>
 #include <fctsys.h>
+#include <hash_eda.h>
 #include <kicad_string.h>
 #include <kiway.h>
 #include <macros.h>
@@ -293,15 +295,18 @@ void DIALOG_EXCHANGE_FOOTPRINTS::OnApplyClicked( wxCommandEvent& event )
     m_MessageWindow->Clear();
     m_MessageWindow->Flush( false );
 
-    if( processMatchingModules() )
-    {
-        m_parent->Compile_Ratsnest( true );
-        m_parent->GetCanvas()->Refresh();
-    }
+    bool change = processMatchingModules();
 
     m_MessageWindow->Flush( false );
 
+    // All the footprints are changed by a single commit, which updates the connectivity once
     m_commit.Push( wxT( "Changed footprint" ) );
+
+    if( change )
+    {
+        m_parent->Compile_Ratsnest( true );
+        m_parent->GetCanvas()->Refresh();
+    }
 }
 
 
@@ -322,6 +327,9 @@ bool DIALOG_EXCHANGE_FOOTPRINTS::processMatchingModules()
             return false;
     }
 
+    m_libraryFootprints.clear();
+    m_libraryHashes.clear();
+
     /* The change is done from the last module because processModule() modifies the last item
      * in the list.
      */
@@ -345,6 +353,9 @@ bool DIALOG_EXCHANGE_FOOTPRINTS::processMatchingModules()
         }
     }
 
+    m_libraryFootprints.clear();
+    m_libraryHashes.clear();
+
     return change;
 }
 
@@ -361,7 +372,14 @@ bool DIALOG_EXCHANGE_FOOTPRINTS::processModule( MODULE* aModule, const LIB_ID& a
                 oldFPID.Format().c_str(),
                 aNewFPID.Format().c_str() );
 
-    MODULE* newModule = m_parent->LoadFootprint( aNewFPID );
+    if( m_updateMode && isUpToDate( aModule ) )
+    {
+        msg << ": " << _( "already up to date" );
+        m_MessageWindow->Report( msg, RPT_SEVERITY_INFO );
+        return false;
+    }
+
+    MODULE* newModule = loadFootprint( aNewFPID );
 
     if( !newModule )
     {
@@ -386,6 +404,79 @@ bool DIALOG_EXCHANGE_FOOTPRINTS::processModule( MODULE* aModule, const LIB_ID& a
 }
 
 
+const MODULE* DIALOG_EXCHANGE_FOOTPRINTS::libraryFootprint( const LIB_ID& aFPID )
+{
+    auto it = m_libraryFootprints.find( aFPID );
+
+    // Each footprint is read from its library once, as many footprints are usually changed
+    // to the same one
+    if( it == m_libraryFootprints.end() )
+    {
+        std::unique_ptr<MODULE> footprint( m_parent->LoadFootprint( aFPID ) );
+
+        it = m_libraryFootprints.emplace( aFPID, std::move( footprint ) ).first;
+    }
+
+    return it->second.get();
+}
+
+
+MODULE* DIALOG_EXCHANGE_FOOTPRINTS::loadFootprint( const LIB_ID& aFPID )
+{
+    const MODULE* footprint = libraryFootprint( aFPID );
+
+    if( !footprint )
+        return nullptr;
+
+    return static_cast<MODULE*>( footprint->Duplicate() );
+}
+
+
+/**
+ * @return the hash of the items of aModule in its local coordinates, independent of its
+ * placement, of its reference and value and of the nets of its pads
+ */
+static size_t shapeHash( const MODULE* aModule )
+{
+    const int flags = HASH_FLAGS::POSITION | HASH_FLAGS::REL_COORD | HASH_FLAGS::LAYER;
+    size_t    ret = 0;
+
+    for( BOARD_ITEM* item : aModule->GraphicalItems() )
+        ret += hash_eda( item, flags );
+
+    for( D_PAD* pad : aModule->Pads() )
+        ret += hash_eda( pad, flags );
+
+    return ret;
+}
+
+
+bool DIALOG_EXCHANGE_FOOTPRINTS::isUpToDate( MODULE* aModule )
+{
+    // The reset options change the footprints even when they match their library
+    if( m_removeExtraBox->GetValue() || m_resetTextItemLayers->GetValue()
+            || m_resetTextItemEffects->GetValue() || m_reset3DModels->GetValue() )
+    {
+        return false;
+    }
+
+    const MODULE* footprint = libraryFootprint( aModule->GetFPID() );
+
+    // The flipped footprints have mirrored local coordinates: they are always updated
+    if( !footprint || aModule->GetLayer() != footprint->GetLayer() )
+        return false;
+
+    auto it = m_libraryHashes.find( aModule->GetFPID() );
+
+    if( it == m_libraryHashes.end() )
+        it = m_libraryHashes.emplace( aModule->GetFPID(), shapeHash( footprint ) ).first;
+
+    return aModule->GraphicalItems().size() == footprint->GraphicalItems().size()
+           && aModule->Pads().size() == footprint->Pads().size()
+           && shapeHash( aModule ) == it->second;
+}
+
+
 void processTextItem( const TEXTE_MODULE& aSrc, TEXTE_MODULE& aDest,
                       bool resetText, bool resetTextLayers, bool resetTextEffects )
 {
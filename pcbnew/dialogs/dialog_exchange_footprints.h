@@ -28,10 +28,13 @@
 #include <dialog_exchange_footprints_base.h>
 
 #include <board_commit.h>
+#include <lib_id.h>
+
+#include <map>
+#include <memory>
 
 class PCB_EDIT_FRAME;
 class MODULE;
-class LIB_ID;
 
 class DIALOG_EXCHANGE_FOOTPRINTS : public DIALOG_EXCHANGE_FOOTPRINTS_BASE
 {
@@ -42,6 +45,13 @@ private:
     bool            m_updateMode;
     int*            m_matchMode;
 
+    ///> The footprints loaded from the libraries by processMatchingModules(), each copied
+    ///> for all the footprints changed to it (null for the footprints not found)
+    std::map<LIB_ID, std::unique_ptr<MODULE>> m_libraryFootprints;
+
+    ///> The hashes of the shape of the library footprints, computed once per footprint
+    std::map<LIB_ID, size_t> m_libraryHashes;
+
 public:
     DIALOG_EXCHANGE_FOOTPRINTS( PCB_EDIT_FRAME* aParent, MODULE* aModule, bool updateMode,
                                 bool selectedMode );
@@ -62,6 +72,17 @@ private:
     bool isMatch( MODULE* );
     bool processMatchingModules();
     bool processModule( MODULE* aModule, const LIB_ID& aNewFPID );
+
+    ///> @return the library footprint aFPID, loaded once per processMatchingModules() call,
+    ///> or nullptr if it is not found
+    const MODULE* libraryFootprint( const LIB_ID& aFPID );
+
+    ///> @return a new copy of the library footprint aFPID, or nullptr if it is not found
+    MODULE* loadFootprint( const LIB_ID& aFPID );
+
+    ///> @return true if aModule has the same shape as its library footprint, so that an update
+    ///> without any reset option would not change it
+    bool isUpToDate( MODULE* aModule );
 };
 
 #endif // DIALOG_EXCHANGE_FOOTPRINTS_H_
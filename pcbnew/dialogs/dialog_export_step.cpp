@@ -31,6 +31,7 @@
 #include "reporter.h"
 #include "class_board.h"
 #include "dialog_export_step_base.h"
+#include <background_file_writer.h>
 #include <pcbnew_settings.h>
 #include <widgets/text_ctrl_eval.h>
 #include <wx_html_report_panel.h>
@@ -190,7 +191,8 @@ void PCB_EDIT_FRAME::OnExportSTEP( wxCommandEvent& event )
 
     if( GetScreen()->IsModify() || brdFile.GetFullPath().empty() )
     {
-        if( !doAutoSave() )
+        // The export reads the auto save file, so it waits for it to be written
+        if( !doAutoSave() || ( m_autoSaveWriter && !m_autoSaveWriter->Wait() ) )
         {
             DisplayErrorMessage( this,
                                  _( "STEP export failed!  Please save the PCB and try again" ) );
@@ -53,6 +53,8 @@ public:
     wxPoint          m_FileDrillOffset;          // Drill offset: 0,0 for absolute coordinates,
                                                  // or origin of the auxiliary axis
     static bool      m_UseRouteModeForOvalHoles; // True to use a G00 route command for oval holes
+    static bool      m_OptimizeHoleOrder;        // True to shorten the drill path (no UI yet,
+                                                 // set by gen_drill.optimize_hole_order)
                                                  // False to use a G85 canned mode for oval holes
 
 private:
@@ -226,7 +226,12 @@ void DIALOG_GLOBAL_DELETION::AcceptPcbDelete()
     commit.Push( "Global delete" );
 
     if( m_DelMarkers->GetValue() )
+    {
+        std::vector<KIGFX::VIEW_ITEM*> markers( pcb->Markers().begin(), pcb->Markers().end() );
+
+        m_Parent->GetCanvas()->GetView()->RemoveItems( markers );
         pcb->DeleteMARKERs();
+    }
 
     if( gen_rastnest )
         m_Parent->Compile_Ratsnest( true );
@@ -27,6 +27,7 @@
 #include <pcb_edit_frame.h>
 #include <class_board.h>
 #include <class_track.h>
+#include <board_commit.h>
 #include <connectivity/connectivity_data.h>
 #include <view/view.h>
 #include <pcb_layer_box_selector.h>
@@ -36,6 +37,8 @@
 #include <tools/global_edit_tool.h>
 #include "dialog_global_edit_tracks_and_vias_base.h"
 
+#include <unordered_set>
+
 // Columns of netclasses grid
 enum {
     GRID_NAME = 0,
@@ -69,6 +72,12 @@ private:
     int*            m_originalColWidths;
     bool            m_failedDRC;
 
+    ///> The filters of the items to edit, read from the dialog once for all the items
+    int                     m_filterNetCode;        ///< -1 for no filter
+    bool                    m_filterByNetclass;
+    std::unordered_set<int> m_netclassNetCodes;     ///< the nets of the filtered netclass
+    LAYER_NUM               m_filterLayer;          ///< UNDEFINED_LAYER for no filter
+
 public:
     DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS( PCB_EDIT_FRAME* aParent );
     ~DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS() override;
@@ -266,6 +275,7 @@ void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::OnUpdateUI( wxUpdateUIEvent&  )
 void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::processItem( PICKED_ITEMS_LIST* aUndoList, TRACK* aItem )
 {
     BOARD_DESIGN_SETTINGS& brdSettings = m_brd->GetDesignSettings();
+    unsigned               pickedCount = aUndoList->GetCount();
 
     if( m_setToSpecifiedValues->GetValue() )
     {
@@ -283,7 +293,8 @@ void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::processItem( PICKED_ITEMS_LIST* aUndoLi
 
         if( m_layerBox->GetLayerSelection() != UNDEFINED_LAYER && aItem->Type() == PCB_TRACE_T )
         {
-            if( aUndoList->FindItem( aItem ) < 0 )
+            // Each item is visited once: it is already saved only if its width was changed
+            if( aUndoList->GetCount() == pickedCount )
             {
                 ITEM_PICKER picker( aItem, UR_CHANGED );
                 picker.SetLink( aItem->Clone() );
@@ -291,7 +302,6 @@ void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::processItem( PICKED_ITEMS_LIST* aUndoLi
             }
 
             aItem->SetLayer( ToLAYER_ID( m_layerBox->GetLayerSelection() ) );
-            m_parent->GetBoard()->GetConnectivity()->Update( aItem );
         }
     }
     else
@@ -304,23 +314,14 @@ void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::processItem( PICKED_ITEMS_LIST* aUndoLi
 
 void DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::visitItem( PICKED_ITEMS_LIST* aUndoList, TRACK* aItem )
 {
-    if( m_netFilterOpt->GetValue() && m_netFilter->GetSelectedNetcode() >= 0 )
-    {
-        if( aItem->GetNetCode() != m_netFilter->GetSelectedNetcode() )
-            return;
-    }
+    if( m_filterNetCode >= 0 && aItem->GetNetCode() != m_filterNetCode )
+        return;
 
-    if( m_netclassFilterOpt->GetValue() && !m_netclassFilter->GetStringSelection().IsEmpty() )
-    {
-        if( aItem->GetNetClassName() != m_netclassFilter->GetStringSelection() )
-            return;
-    }
+    if( m_filterByNetclass && m_netclassNetCodes.count( aItem->GetNetCode() ) == 0 )
+        return;
 
-    if( m_layerFilterOpt->GetValue() && m_layerFilter->GetLayerSelection() != UNDEFINED_LAYER )
-    {
-        if( aItem->GetLayer() != m_layerFilter->GetLayerSelection() )
-            return;
-    }
+    if( m_filterLayer != UNDEFINED_LAYER && aItem->GetLayer() != m_filterLayer )
+        return;
 
     processItem( aUndoList, aItem );
 }
@@ -331,6 +332,31 @@ bool DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::TransferDataFromWindow()
     PICKED_ITEMS_LIST itemsListPicker;
     wxBusyCursor dummy;
 
+    m_filterNetCode = -1;
+    m_filterByNetclass = false;
+    m_netclassNetCodes.clear();
+    m_filterLayer = UNDEFINED_LAYER;
+
+    if( m_netFilterOpt->GetValue() && m_netFilter->GetSelectedNetcode() >= 0 )
+        m_filterNetCode = m_netFilter->GetSelectedNetcode();
+
+    if( m_netclassFilterOpt->GetValue() && !m_netclassFilter->GetStringSelection().IsEmpty() )
+    {
+        // The netclass of the items is the netclass of their net
+        wxString netclass = m_netclassFilter->GetStringSelection();
+
+        m_filterByNetclass = true;
+
+        for( NETINFO_ITEM* net : m_brd->GetNetInfo() )
+        {
+            if( net->GetClassName() == netclass )
+                m_netclassNetCodes.insert( net->GetNet() );
+        }
+    }
+
+    if( m_layerFilterOpt->GetValue() && m_layerFilter->GetLayerSelection() != UNDEFINED_LAYER )
+        m_filterLayer = m_layerFilter->GetLayerSelection();
+
     // Examine segments
     for( auto segment : m_brd->Tracks() )
     {
@@ -340,12 +366,13 @@ bool DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::TransferDataFromWindow()
             visitItem( &itemsListPicker, segment );
     }
 
+    // The changed items are saved, redrawn and updated in the connectivity by one commit
     if( itemsListPicker.GetCount() > 0 )
     {
-        m_parent->SaveCopyInUndoList( itemsListPicker, UR_CHANGED );
+        BOARD_COMMIT commit( m_parent );
 
-        for( auto segment : m_brd->Tracks() )
-            m_parent->GetCanvas()->GetView()->Update( segment );
+        commit.Stage( itemsListPicker, UR_CHANGED );
+        commit.Push( _( "Edit track and via properties" ) );
     }
 
     return !m_failedDRC;
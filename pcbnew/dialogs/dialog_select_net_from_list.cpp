@@ -125,15 +125,11 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
     wxString                   netFilter = m_textCtrlFilter->GetValue();
     EDA_PATTERN_MATCH_WILDCARD filter;
 
-    constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_VIA_T, PCB_PAD_T, EOT };
-
     filter.SetPattern( netFilter.MakeUpper() );
 
     m_netsList->DeleteAllItems();
     m_netsInitialNames.Clear();
 
-    auto connectivity = m_brd->GetConnectivity();
-
     auto units = GetUserUnits();
 
     // Populate the nets list with nets names matching the filters:
@@ -165,28 +161,10 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
         {
             dataLine.push_back( wxVariant( wxString::Format( "%u", nodes ) ) );
 
-            int lenPadToDie = 0;
-            int len = 0;
-            int viaCount = 0;
-
-            for( auto item : connectivity->GetNetItems( netcode, types ) )
-            {
-
-                if( item->Type() == PCB_PAD_T )
-                {
-                    D_PAD *pad = dyn_cast<D_PAD*>( item );
-                    lenPadToDie += pad->GetPadToDieLength();
-                }
-                else if( item->Type() == PCB_TRACE_T )
-                {
-                    TRACK *track = dyn_cast<TRACK*>( item );
-                    len += track->GetLength();
-                }
-                else if( item->Type() == PCB_VIA_T )
-                {
-                    viaCount++;
-                }
-            }
+            const NET_TRACKS& tracks = m_brd->GetNetTracks( netcode );
+            int               lenPadToDie = tracks.m_PadToDieLength;
+            int               len = KiROUND( tracks.m_Length );
+            int               viaCount = tracks.m_ViaCount;
 
             dataLine.push_back( wxVariant( wxString::Format( "%u", viaCount ) ) );
             dataLine.push_back( wxVariant( MessageTextFromValue( units, len ) ) );
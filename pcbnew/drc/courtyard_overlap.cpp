@@ -33,9 +33,14 @@
 #include <class_module.h>
 #include <drc/drc.h>
 
+#include <advanced_config.h>
 #include <widgets/ui_common.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <thread>
 
 /**
  * Flag to enable courtyard DRC debug tracing.
@@ -62,6 +67,9 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) const
     wxString msg;
     bool     success = true;
 
+    m_stats = DRC_STAGE_STATS( wxT( "Courtyard" ) );
+    m_stats.m_items = aBoard.Modules().size();
+
     // Update courtyard polygons, and test for missing courtyard definition:
     for( MODULE* footprint : aBoard.Modules() )
     {
@@ -94,75 +102,125 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) const
 
     wxLogTrace( DRC_COURTYARD_TRACE, "Checking for courtyard overlap" );
 
-    // Now test for overlapping on top layer:
-    SHAPE_POLY_SET courtyard; // temporary storage of the courtyard of current footprint
+    std::vector<MODULE*> footprints( aBoard.Modules().begin(), aBoard.Modules().end() );
 
-    for( auto it1 = aBoard.Modules().begin(); it1 != aBoard.Modules().end(); it1++ )
+    // Now test for overlapping on top layer, then on bottom layer
+    for( bool front : { true, false } )
     {
-        MODULE* footprint = *it1;
-
-        if( footprint->GetPolyCourtyardFront().OutlineCount() == 0 )
-            continue; // No courtyard defined
-
-        for( auto it2 = it1 + 1; it2 != aBoard.Modules().end(); it2++ )
+        auto getCourtyard = [front]( MODULE* aFootprint ) -> const SHAPE_POLY_SET&
+                            {
+                                return front ? aFootprint->GetPolyCourtyardFront()
+                                             : aFootprint->GetPolyCourtyardBack();
+                            };
+
+        // Sweep the footprints sorted by the left side of their courtyard bounding box to
+        // find the pairs whose courtyards can overlap
+        std::vector<size_t> sorted;
+        std::vector<BOX2I>  bboxes( footprints.size() );
+
+        for( size_t ii = 0; ii < footprints.size(); ++ii )
         {
-            MODULE* candidate = *it2;
-
-            if( candidate->GetPolyCourtyardFront().OutlineCount() == 0 )
+            if( getCourtyard( footprints[ii] ).OutlineCount() == 0 )
                 continue; // No courtyard defined
 
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardFront() );
+            bboxes[ii] = getCourtyard( footprints[ii] ).BBox();
+            sorted.push_back( ii );
+        }
+
+        std::sort( sorted.begin(), sorted.end(),
+                   [&]( size_t a, size_t b )
+                   {
+                       return bboxes[a].GetLeft() < bboxes[b].GetLeft();
+                   } );
 
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection( candidate->GetPolyCourtyardFront(),
-                                           SHAPE_POLY_SET::PM_FAST );
+        std::vector<std::pair<size_t, size_t>> candidates;
 
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
+        for( size_t ii = 0; ii < sorted.size(); ++ii )
+        {
+            for( size_t jj = ii + 1; jj < sorted.size(); ++jj )
             {
-                //Overlap between footprint and candidate
-                auto  m = std::make_unique<MARKER_PCB>( aUnits, DRCE_OVERLAPPING_FOOTPRINTS,
-                                                        (wxPoint) courtyard.CVertex( 0, 0, -1 ),
-                                                        footprint, candidate );
-                HandleMarker( std::move( m ) );
-                success = false;
+                if( bboxes[ sorted[jj] ].GetLeft() > bboxes[ sorted[ii] ].GetRight() )
+                    break;
+
+                if( bboxes[ sorted[ii] ].Intersects( bboxes[ sorted[jj] ] ) )
+                {
+                    candidates.emplace_back( std::min( sorted[ii], sorted[jj] ),
+                                             std::max( sorted[ii], sorted[jj] ) );
+                }
             }
         }
-    }
 
-    // Test for overlapping on bottom layer:
-    for( auto it1 = aBoard.Modules().begin(); it1 != aBoard.Modules().end(); it1++ )
-    {
-        MODULE* footprint = *it1;
+        // Test the pairs in the board order, so the markers are reported in the same order
+        // whatever the number of threads
+        std::sort( candidates.begin(), candidates.end() );
+        m_stats.m_pairChecks += candidates.size();
+
+        std::vector<std::unique_ptr<MARKER_PCB>> markers( candidates.size() );
+        std::atomic<size_t>                      nextPair( 0 );
+
+        auto testPairs =
+                [&]() -> size_t
+                {
+                    SHAPE_POLY_SET courtyard; // temporary storage of the common area
+                    size_t         num = 0;
+
+                    for( size_t i = nextPair++; i < candidates.size(); i = nextPair++ )
+                    {
+                        MODULE* footprint = footprints[ candidates[i].first ];
+                        MODULE* candidate = footprints[ candidates[i].second ];
 
-        if( footprint->GetPolyCourtyardBack().OutlineCount() == 0 )
-            continue; // No courtyard defined
+                        courtyard.RemoveAllContours();
+                        courtyard.Append( getCourtyard( footprint ) );
 
-        for( auto it2 = it1 + 1; it2 != aBoard.Modules().end(); it2++ )
+                        // Build the common area between footprint and the candidate:
+                        courtyard.BooleanIntersection( getCourtyard( candidate ),
+                                                       SHAPE_POLY_SET::PM_FAST );
+
+                        // If no overlap, courtyard is empty (no common area).
+                        // Therefore if a common polygon exists, this is a DRC error
+                        if( courtyard.OutlineCount() )
+                        {
+                            //Overlap between footprint and candidate
+                            markers[i] = std::make_unique<MARKER_PCB>(
+                                    aUnits, DRCE_OVERLAPPING_FOOTPRINTS,
+                                    (wxPoint) courtyard.CVertex( 0, 0, -1 ), footprint,
+                                    candidate );
+                        }
+
+                        num++;
+                    }
+
+                    return num;
+                };
+
+        size_t parallelThreadCount = 1;
+
+        if( ADVANCED_CFG::GetCfg().m_parallelDRC )
         {
-            MODULE* candidate = *it2;
+            parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                    candidates.size() );
+        }
 
-            if( candidate->GetPolyCourtyardBack().OutlineCount() == 0 )
-                continue; // No courtyard defined
+        if( parallelThreadCount <= 1 )
+        {
+            testPairs();
+        }
+        else
+        {
+            std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardBack() );
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, testPairs );
 
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection( candidate->GetPolyCourtyardBack(),
-                                           SHAPE_POLY_SET::PM_FAST );
+            for( std::future<size_t>& ret : returns )
+                ret.wait();
+        }
 
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
+        for( std::unique_ptr<MARKER_PCB>& marker : markers )
+        {
+            if( marker )
             {
-                //Overlap between footprint and candidate
-                auto  m = std::make_unique<MARKER_PCB>( aUnits, DRCE_OVERLAPPING_FOOTPRINTS,
-                                                        (wxPoint) courtyard.CVertex( 0, 0, -1 ),
-                                                        footprint, candidate );
-                HandleMarker( std::move( m ) );
+                HandleMarker( std::move( marker ) );
                 success = false;
             }
         }
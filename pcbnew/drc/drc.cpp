@@ -23,7 +23,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <set>
+#include <thread>
+
 #include <fctsys.h>
+#include <advanced_config.h>
 #include <pcb_edit_frame.h>
 #include <trigo.h>
 #include <board_design_settings.h>
@@ -46,6 +54,7 @@
 #include <drc/drc.h>
 #include <netlist_reader/pcb_netlist.h>
 #include <math/util.h>      // for KiROUND
+#include <profile.h>
 
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
@@ -53,13 +62,31 @@
 #include <geometry/shape_arc.h>
 #include <drc/drc_item.h>
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_report_writer.h>
+#include <drc/drc_rtree.h>
 #include <tools/zone_filler_tool.h>
+#include <trace_events.h>
+
+/**
+ * When not null, the markers created by the current thread are appended to this list instead
+ * of being committed to the board.  Used to collect the markers of tests run in parallel.
+ */
+static thread_local std::vector<MARKER_PCB*>* s_markerSink = nullptr;
+
+/**
+ * When not null, the counters of the stage run by the current thread.
+ */
+static thread_local DRC_STAGE_STATS* s_stageStats = nullptr;
+
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" ),
         m_pcbEditorFrame( nullptr ),
         m_pcb( nullptr ),
-        m_drcDialog( nullptr )
+        m_drcDialog( nullptr ),
+        m_reportWriter( nullptr ),
+        m_headlessUnits( EDA_UNITS::MILLIMETRES ),
+        m_pendingMarkers( nullptr )
 {
     // establish initial values for everything:
     m_doPad2PadTest     = true;         // enable pad to pad clearance tests
@@ -72,14 +99,6 @@ DRC::DRC() :
 
     m_drcRun = false;
     m_footprintsTested = false;
-
-    m_segmAngle  = 0;
-    m_segmLength = 0;
-
-    m_xcliplo = 0;
-    m_ycliplo = 0;
-    m_xcliphi = 0;
-    m_ycliphi = 0;
 }
 
 
@@ -160,12 +179,81 @@ bool DRC::IsDRCDialogShown()
 
 void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
 {
+    if( s_stageStats )
+        s_stageStats->m_markers++;
+
+    if( s_markerSink )
+    {
+        s_markerSink->push_back( aMarker );
+        return;
+    }
+
+    if( m_reportWriter )
+    {
+        m_reportWriter->WriteItem( *aMarker->GetRCItem() );
+        delete aMarker;
+        return;
+    }
+
+    if( m_pendingMarkers )
+    {
+        m_pendingMarkers->push_back( aMarker );
+        return;
+    }
+
     BOARD_COMMIT commit( m_pcbEditorFrame );
     commit.Add( aMarker );
     commit.Push( wxEmptyString, false, false );
 }
 
 
+void DRC::runStage( DRC_STAGE_STATS& aStats, const std::function<void()>& aTest )
+{
+    DRC_STAGE_STATS* callerStats = s_stageStats;
+    PROF_COUNTER     timer;
+
+    s_stageStats = &aStats;
+    aTest();
+    s_stageStats = callerStats;
+
+    aStats.m_msecs = timer.msecs();
+}
+
+
+void DRC::countTests( long aItems, long long aPairChecks )
+{
+    if( s_stageStats )
+    {
+        s_stageStats->m_items += aItems;
+        s_stageStats->m_pairChecks += aPairChecks;
+    }
+}
+
+
+void DRC::addMarkersToPcb( std::vector<MARKER_PCB*>& aMarkers )
+{
+    if( s_markerSink || m_reportWriter || m_pendingMarkers )
+    {
+        for( MARKER_PCB* marker : aMarkers )
+            addMarkerToPcb( marker );
+    }
+    else if( !aMarkers.empty() )
+    {
+        if( s_stageStats )
+            s_stageStats->m_markers += aMarkers.size();
+
+        BOARD_COMMIT commit( m_pcbEditorFrame );
+
+        for( MARKER_PCB* marker : aMarkers )
+            commit.Add( marker );
+
+        commit.Push( wxEmptyString, false, false );
+    }
+
+    aMarkers.clear();
+}
+
+
 void DRC::DestroyDRCDialog( int aReason )
 {
     if( m_drcDialog )
@@ -176,14 +264,112 @@ void DRC::DestroyDRCDialog( int aReason )
 }
 
 
+int DRC::testZonePair( ZONE_CONTAINER* aZoneRef, const SHAPE_POLY_SET& aRefPoly,
+                       ZONE_CONTAINER* aZoneToTest, const SHAPE_POLY_SET& aTestPoly,
+                       std::vector<MARKER_PCB*>& aMarkers ) const
+{
+    int nerrors = 0;
+
+    // Get clearance used in zone to zone test.  The policy used to
+    // obtain that value is now part of the zone object itself by way of
+    // ZONE_CONTAINER::GetClearance().
+    int zone2zoneClearance = aZoneRef->GetClearance( aZoneToTest );
+
+    // Keepout areas have no clearance, so set zone2zoneClearance to 1
+    // ( zone2zoneClearance = 0  can create problems in test functions)
+    if( aZoneRef->GetIsKeepout() )
+        zone2zoneClearance = 1;
+
+    // test for some corners of zoneRef inside zoneToTest
+    for( auto iterator = aRefPoly.CIterateWithHoles(); iterator; iterator++ )
+    {
+        VECTOR2I currentVertex = *iterator;
+        wxPoint pt( currentVertex.x, currentVertex.y );
+
+        if( aTestPoly.Contains( currentVertex, -1, 0, true ) )
+        {
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_ZONES_INTERSECT, pt,
+                                                aZoneRef, aZoneToTest ) );
+            nerrors++;
+        }
+    }
+
+    // test for some corners of zoneToTest inside zoneRef
+    for( auto iterator = aTestPoly.CIterateWithHoles(); iterator; iterator++ )
+    {
+        VECTOR2I currentVertex = *iterator;
+        wxPoint pt( currentVertex.x, currentVertex.y );
+
+        if( aRefPoly.Contains( currentVertex, -1, 0, true ) )
+        {
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_ZONES_INTERSECT, pt,
+                                                aZoneToTest, aZoneRef ) );
+            nerrors++;
+        }
+    }
+
+    // Iterate through all the segments of refSmoothedPoly
+    std::set<wxPoint> conflictPoints;
+
+    for( auto refIt = aRefPoly.CIterateSegmentsWithHoles(); refIt; refIt++ )
+    {
+        // Build ref segment
+        SEG refSegment = *refIt;
+
+        // Iterate through all the segments in aTestPoly
+        for( auto testIt = aTestPoly.CIterateSegmentsWithHoles(); testIt; testIt++ )
+        {
+            // Build test segment
+            SEG testSegment = *testIt;
+            wxPoint pt;
+
+            int ax1, ay1, ax2, ay2;
+            ax1 = refSegment.A.x;
+            ay1 = refSegment.A.y;
+            ax2 = refSegment.B.x;
+            ay2 = refSegment.B.y;
+
+            int bx1, by1, bx2, by2;
+            bx1 = testSegment.A.x;
+            by1 = testSegment.A.y;
+            bx2 = testSegment.B.x;
+            by2 = testSegment.B.y;
+
+            int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
+                                                 0,
+                                                 ax1, ay1, ax2, ay2,
+                                                 0,
+                                                 zone2zoneClearance,
+                                                 &pt.x, &pt.y );
+
+            if( d < zone2zoneClearance )
+                conflictPoints.insert( pt );
+        }
+    }
+
+    for( wxPoint pt : conflictPoints )
+    {
+        aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_ZONES_TOO_CLOSE, pt,
+                                            aZoneRef, aZoneToTest ) );
+        nerrors++;
+    }
+
+    return nerrors;
+}
+
+
 int DRC::TestZoneToZoneOutlines()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
     int nerrors = 0;
 
     std::vector<SHAPE_POLY_SET> smoothed_polys;
+    std::vector<BOX2I>          bboxes;
     smoothed_polys.resize( board->GetAreaCount() );
+    bboxes.resize( board->GetAreaCount() );
 
+    // Build the outline of each zone (and its bounding box, inflated by the zone clearance)
+    // once, before testing the pairs
     for( int ia = 0; ia < board->GetAreaCount(); ia++ )
     {
         ZONE_CONTAINER*    zoneRef = board->GetArea( ia );
@@ -191,149 +377,182 @@ int DRC::TestZoneToZoneOutlines()
         zoneRef->GetColinearCorners( board, colinearCorners );
 
         zoneRef->BuildSmoothedPoly( smoothed_polys[ia], &colinearCorners );
+
+        smoothed_polys[ia].BuildBBoxCaches();
+        smoothed_polys[ia].EnableGridPartitions();
+
+        bboxes[ia] = smoothed_polys[ia].BBox();
+        bboxes[ia].Inflate( std::max( zoneRef->GetClearance(), 1 ) );
     }
 
-    // iterate through all areas
+    // Bucket the copper zones by layer, sorted by the left side of their bounding box, so
+    // that a sweep on X only visits the zones whose bounding boxes can overlap
+    std::map<PCB_LAYER_ID, std::vector<int>> layerBuckets;
+
     for( int ia = 0; ia < board->GetAreaCount(); ia++ )
     {
-        ZONE_CONTAINER* zoneRef = board->GetArea( ia );
+        ZONE_CONTAINER* zone = board->GetArea( ia );
 
-        if( !zoneRef->IsOnCopperLayer() )
+        if( !zone->IsOnCopperLayer() )
             continue;
 
-        // If we are testing a single zone, then iterate through all other zones
-        // Otherwise, we have already tested the zone combination
-        for( int ia2 = ia + 1; ia2 < board->GetAreaCount(); ia2++ )
-        {
-            ZONE_CONTAINER* zoneToTest = board->GetArea( ia2 );
+        countTests( 1, 0 );
+        layerBuckets[ zone->GetLayer() ].push_back( ia );
+    }
 
-            if( zoneRef == zoneToTest )
-                continue;
+    std::vector<std::pair<int, int>> candidates;
 
-            // test for same layer
-            if( zoneRef->GetLayer() != zoneToTest->GetLayer() )
-                continue;
+    for( auto& bucket : layerBuckets )
+    {
+        std::vector<int>& zones = bucket.second;
 
-            // Test for same net
-            if( zoneRef->GetNetCode() == zoneToTest->GetNetCode() && zoneRef->GetNetCode() >= 0 )
-                continue;
+        std::sort( zones.begin(), zones.end(),
+                   [&]( int a, int b )
+                   {
+                       return bboxes[a].GetLeft() < bboxes[b].GetLeft();
+                   } );
 
-            // test for different priorities
-            if( zoneRef->GetPriority() != zoneToTest->GetPriority() )
-                continue;
+        for( size_t ii = 0; ii < zones.size(); ++ii )
+        {
+            for( size_t jj = ii + 1; jj < zones.size(); ++jj )
+            {
+                if( bboxes[ zones[jj] ].GetLeft() > bboxes[ zones[ii] ].GetRight() )
+                    break;
 
-            // test for different types
-            if( zoneRef->GetIsKeepout() != zoneToTest->GetIsKeepout() )
-                continue;
+                if( !bboxes[ zones[ii] ].Intersects( bboxes[ zones[jj] ] ) )
+                    continue;
 
-            // Examine a candidate zone: compare zoneToTest to zoneRef
+                ZONE_CONTAINER* zoneA = board->GetArea( zones[ii] );
+                ZONE_CONTAINER* zoneB = board->GetArea( zones[jj] );
 
-            // Get clearance used in zone to zone test.  The policy used to
-            // obtain that value is now part of the zone object itself by way of
-            // ZONE_CONTAINER::GetClearance().
-            int zone2zoneClearance = zoneRef->GetClearance( zoneToTest );
+                // Test for same net
+                if( zoneA->GetNetCode() == zoneB->GetNetCode() && zoneA->GetNetCode() >= 0 )
+                    continue;
 
-            // Keepout areas have no clearance, so set zone2zoneClearance to 1
-            // ( zone2zoneClearance = 0  can create problems in test functions)
-            if( zoneRef->GetIsKeepout() )
-                zone2zoneClearance = 1;
+                // test for different priorities
+                if( zoneA->GetPriority() != zoneB->GetPriority() )
+                    continue;
 
-            // test for some corners of zoneRef inside zoneToTest
-            for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
-            {
-                VECTOR2I currentVertex = *iterator;
-                wxPoint pt( currentVertex.x, currentVertex.y );
+                // test for different types
+                if( zoneA->GetIsKeepout() != zoneB->GetIsKeepout() )
+                    continue;
 
-                if( smoothed_polys[ia2].Contains( currentVertex ) )
-                {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_ZONES_INTERSECT, pt,
-                                                    zoneRef, zoneToTest ) );
-                    nerrors++;
-                }
+                candidates.emplace_back( std::min( zones[ii], zones[jj] ),
+                                         std::max( zones[ii], zones[jj] ) );
             }
+        }
+    }
+
+    // Test the pairs in the order of the board zone list, so the markers do not depend on
+    // the sweep or on the scheduling of the threads
+    std::sort( candidates.begin(), candidates.end() );
+    countTests( 0, candidates.size() );
+
+    std::vector<std::vector<MARKER_PCB*>> pairMarkers( candidates.size() );
+    std::atomic<size_t>                   nextPair( 0 );
+    std::atomic<int>                      errorCount( 0 );
 
-            // test for some corners of zoneToTest inside zoneRef
-            for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+    auto testPairs =
+            [&]() -> size_t
             {
-                VECTOR2I currentVertex = *iterator;
-                wxPoint pt( currentVertex.x, currentVertex.y );
+                size_t num = 0;
 
-                if( smoothed_polys[ia].Contains( currentVertex ) )
+                for( size_t i = nextPair++; i < candidates.size(); i = nextPair++ )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_ZONES_INTERSECT, pt,
-                                                    zoneToTest, zoneRef ) );
-                    nerrors++;
+                    int ia = candidates[i].first;
+                    int ia2 = candidates[i].second;
+
+                    errorCount += testZonePair( board->GetArea( ia ), smoothed_polys[ia],
+                                                board->GetArea( ia2 ), smoothed_polys[ia2],
+                                                pairMarkers[i] );
+                    num++;
                 }
-            }
 
-            // Iterate through all the segments of refSmoothedPoly
-            std::set<wxPoint> conflictPoints;
+                return num;
+            };
 
-            for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
-            {
-                // Build ref segment
-                SEG refSegment = *refIt;
+    size_t parallelThreadCount = 1;
 
-                // Iterate through all the segments in smoothed_polys[ia2]
-                for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
-                {
-                    // Build test segment
-                    SEG testSegment = *testIt;
-                    wxPoint pt;
-
-                    int ax1, ay1, ax2, ay2;
-                    ax1 = refSegment.A.x;
-                    ay1 = refSegment.A.y;
-                    ax2 = refSegment.B.x;
-                    ay2 = refSegment.B.y;
-
-                    int bx1, by1, bx2, by2;
-                    bx1 = testSegment.A.x;
-                    by1 = testSegment.A.y;
-                    bx2 = testSegment.B.x;
-                    by2 = testSegment.B.y;
-
-                    int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
-                                                         0,
-                                                         ax1, ay1, ax2, ay2,
-                                                         0,
-                                                         zone2zoneClearance,
-                                                         &pt.x, &pt.y );
-
-                    if( d < zone2zoneClearance )
-                        conflictPoints.insert( pt );
-                }
-            }
+    if( ADVANCED_CFG::GetCfg().m_parallelDRC )
+    {
+        parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                candidates.size() );
+    }
 
-            for( wxPoint pt : conflictPoints )
-            {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_ZONES_TOO_CLOSE, pt,
-                                                zoneRef, zoneToTest ) );
-                nerrors++;
-            }
-        }
+    if( parallelThreadCount <= 1 )
+    {
+        testPairs();
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, testPairs );
+
+        for( std::future<size_t>& ret : returns )
+            ret.wait();
+    }
+
+    for( std::vector<MARKER_PCB*>& markers : pairMarkers )
+    {
+        for( MARKER_PCB* marker : markers )
+            addMarkerToPcb( marker );
     }
 
+    nerrors = errorCount;
+
     return nerrors;
 }
 
 
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
+    SCOPED_TRACE_EVENT trace( "DRC::RunTests" );
+
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
     m_pcb = m_pcbEditorFrame->GetBoard();
 
+    m_stageStats.clear();
+
+    // A DRC run on a large board can create thousands of markers.  Adding them one commit
+    // at a time means one undo/ratsnest/view update per marker, so they are collected
+    // during the run and added to the board in a single commit.
+    std::vector<MARKER_PCB*> pendingMarkers;
+
+    auto flushMarkers =
+            [&]()
+            {
+                m_pendingMarkers = nullptr;
+                addMarkersToPcb( pendingMarkers );
+            };
+
+    m_pendingMarkers = &pendingMarkers;
+
+    // Each stage is timed, and its counters are reported at the end of the run.  The
+    // stages are run in this order, so m_stageStats is only appended to by this thread.
+    auto stage =
+            [&]( const wxString& aName, const std::function<void()>& aTest )
+            {
+                m_stageStats.emplace_back( aName );
+                runStage( m_stageStats.back(), aTest );
+            };
+
     if( aMessages )
     {
         aMessages->AppendText( _( "Board Outline...\n" ) );
         wxSafeYield();
     }
 
-    testOutline();
+    stage( _( "Board outline" ), [&]() { testOutline(); } );
+
+    bool netclassesOk = true;
+
+    stage( _( "Netclasses" ), [&]() { netclassesOk = testNetClasses(); } );
 
     // someone should have cleared the two lists before calling this.
-    if( !testNetClasses() )
+    if( !netclassesOk )
     {
         // testing the netclasses is a special case because if the netclasses
         // do not pass the BOARD_DESIGN_SETTINGS checks, then every member of a net
@@ -342,33 +561,14 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "Aborting\n" ) );
 
+        flushMarkers();
+
         // update the m_drcDialog listboxes
         updatePointers();
 
         return;
     }
 
-    // test pad to pad clearances, nothing to do with tracks, vias or zones.
-    if( m_doPad2PadTest )
-    {
-        if( aMessages )
-        {
-            aMessages->AppendText( _( "Pad clearances...\n" ) );
-            wxSafeYield();
-        }
-
-        testPad2Pad();
-    }
-
-    // test clearances between drilled holes
-    if( aMessages )
-    {
-        aMessages->AppendText( _( "Drill clearances...\n" ) );
-        wxSafeYield();
-    }
-
-    testDrilledHoles();
-
     // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
     wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
 
@@ -387,68 +587,106 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         m_toolMgr->GetTool<ZONE_FILLER_TOOL>()->CheckAllZones( caller );
     }
 
-    // test track and via clearances to other tracks, pads, and vias
-    if( aMessages )
+    if( ADVANCED_CFG::GetCfg().m_parallelDRC )
     {
-        aMessages->AppendText( _( "Track clearances...\n" ) );
-        wxSafeYield();
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Pad, drill, track, zone, keepout, text and courtyard "
+                                      "clearances...\n" ) );
+            wxSafeYield();
+        }
+
+        testClearancesInParallel( caller );
     }
+    else
+    {
+        // test pad to pad clearances, nothing to do with tracks, vias or zones.
+        if( m_doPad2PadTest )
+        {
+            if( aMessages )
+            {
+                aMessages->AppendText( _( "Pad clearances...\n" ) );
+                wxSafeYield();
+            }
 
-    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
+            stage( _( "Pad clearances" ), [&]() { testPad2Pad(); } );
+        }
 
-    // test zone clearances to other zones
-    if( aMessages )
-    {
-        aMessages->AppendText( _( "Zone to zone clearances...\n" ) );
-        wxSafeYield();
-    }
+        // test clearances between drilled holes
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Drill clearances...\n" ) );
+            wxSafeYield();
+        }
 
-    testZones();
+        stage( _( "Drill clearances" ), [&]() { testDrilledHoles(); } );
 
-    // find and gather unconnected pads.
-    if( m_doUnconnectedTest )
-    {
+        // test track and via clearances to other tracks, pads, and vias
         if( aMessages )
         {
-            aMessages->AppendText( _( "Unconnected pads...\n" ) );
-            aMessages->Refresh();
+            aMessages->AppendText( _( "Track clearances...\n" ) );
+            wxSafeYield();
         }
 
-        testUnconnected();
-    }
+        stage( _( "Track clearances" ), [&]() { testTracks( caller, true ); } );
 
-    // find and gather vias, tracks, pads inside keepout areas.
-    if( m_doKeepoutTest )
-    {
+        // test zone clearances to other zones
         if( aMessages )
         {
-            aMessages->AppendText( _( "Keepout areas ...\n" ) );
-            aMessages->Refresh();
+            aMessages->AppendText( _( "Zone to zone clearances...\n" ) );
+            wxSafeYield();
         }
 
-        testKeepoutAreas();
-    }
+        stage( _( "Zone to zone clearances" ), [&]() { testZones(); } );
 
-    // find and gather vias, tracks, pads inside text boxes.
-    if( aMessages )
-    {
-        aMessages->AppendText( _( "Text and graphic clearances...\n" ) );
-        wxSafeYield();
-    }
+        // find and gather vias, tracks, pads inside keepout areas.
+        if( m_doKeepoutTest )
+        {
+            if( aMessages )
+            {
+                aMessages->AppendText( _( "Keepout areas ...\n" ) );
+                aMessages->Refresh();
+            }
 
-    testCopperTextAndGraphics();
+            stage( _( "Keepout areas" ), [&]() { testKeepoutAreas(); } );
+        }
 
-    // find overlapping courtyard ares.
-    if( !m_pcb->GetDesignSettings().Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
-        && !m_pcb->GetDesignSettings().Ignore( DRCE_MISSING_COURTYARD_IN_FOOTPRINT ) )
+        // find and gather vias, tracks, pads inside text boxes.
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Text and graphic clearances...\n" ) );
+            wxSafeYield();
+        }
+
+        stage( _( "Text and graphic clearances" ), [&]() { testCopperTextAndGraphics(); } );
+
+        // find overlapping courtyard ares.
+        if( !m_pcb->GetDesignSettings().Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
+            && !m_pcb->GetDesignSettings().Ignore( DRCE_MISSING_COURTYARD_IN_FOOTPRINT ) )
+        {
+            if( aMessages )
+            {
+                aMessages->AppendText( _( "Courtyard areas...\n" ) );
+                aMessages->Refresh();
+            }
+
+            stage( _( "Courtyard areas" ), [&]() { doOverlappingCourtyardsDrc(); } );
+        }
+    }
+
+    // find and gather unconnected pads.
+    if( m_doUnconnectedTest )
     {
         if( aMessages )
         {
-            aMessages->AppendText( _( "Courtyard areas...\n" ) );
+            aMessages->AppendText( _( "Unconnected pads...\n" ) );
             aMessages->Refresh();
         }
 
-        doOverlappingCourtyardsDrc();
+        stage( _( "Unconnected pads" ), [&]() { testUnconnected(); } );
+
+        // Unconnected items are not markers, but they are the problems found by this stage
+        m_stageStats.back().m_markers = m_unconnected.size();
     }
 
     for( DRC_ITEM* footprintItem : m_footprints )
@@ -471,12 +709,19 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( m_drcDialog )
             m_drcDialog->Raise();
 
-        TestFootprints( netlist, m_pcb, m_drcDialog->GetUserUnits(), m_footprints );
+        stage( _( "Footprints against schematic" ),
+               [&]()
+               {
+                   TestFootprints( netlist, m_pcb, m_drcDialog->GetUserUnits(), m_footprints );
+               } );
+
+        m_stageStats.back().m_items = m_pcb->Modules().size();
+        m_stageStats.back().m_markers = m_footprints.size();
         m_footprintsTested = true;
     }
 
     // Check if there are items on disabled layers
-    testDisabledLayers();
+    stage( _( "Items on disabled layers" ), [&]() { testDisabledLayers(); } );
 
     if( aMessages )
     {
@@ -485,15 +730,22 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     }
 
     if( !m_pcb->GetDesignSettings().Ignore( DRCE_UNRESOLVED_VARIABLE ) )
-        testTextVars();
+        stage( _( "Text variables" ), [&]() { testTextVars(); } );
 
     m_drcRun = true;
 
+    flushMarkers();
+
     // update the m_drcDialog listboxes
     updatePointers();
 
     if( aMessages )
     {
+        aMessages->AppendText( _( "Timings:\n" ) );
+
+        for( const DRC_STAGE_STATS& stats : m_stageStats )
+            aMessages->AppendText( wxT( "  " ) + stats.Format() + wxT( "\n" ) );
+
         // no newline on this one because it is last, don't want the window
         // to unnecessarily scroll.
         aMessages->AppendText( _( "Finished" ) );
@@ -501,6 +753,218 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 }
 
 
+int DRC::RunTestsHeadless( BOARD* aBoard, DRC_REPORT_WRITER& aWriter, EDA_UNITS aUnits )
+{
+    m_pcb = aBoard;
+    m_headlessUnits = aUnits;
+    m_reportWriter = &aWriter;
+    m_stageStats.clear();
+
+    int firstItem = aWriter.GetCount();
+
+    auto stage =
+            [&]( const wxString& aName, const std::function<void()>& aTest )
+            {
+                m_stageStats.emplace_back( aName );
+                runStage( m_stageStats.back(), aTest );
+            };
+
+    aWriter.Begin( m_pcb->GetFileName() );
+
+    stage( _( "Board outline" ), [&]() { testOutline(); } );
+
+    bool netclassesOk = true;
+
+    stage( _( "Netclasses" ), [&]() { netclassesOk = testNetClasses(); } );
+
+    // As in RunTests(), the other tests are meaningless with invalid netclasses
+    if( netclassesOk )
+    {
+        if( m_doPad2PadTest )
+            stage( _( "Pad clearances" ), [&]() { testPad2Pad(); } );
+
+        stage( _( "Drill clearances" ), [&]() { testDrilledHoles(); } );
+        stage( _( "Track clearances" ), [&]() { testTracks( nullptr, false ); } );
+        stage( _( "Zone to zone clearances" ), [&]() { testZones(); } );
+
+        if( m_doKeepoutTest )
+            stage( _( "Keepout areas" ), [&]() { testKeepoutAreas(); } );
+
+        stage( _( "Text and graphic clearances" ), [&]() { testCopperTextAndGraphics(); } );
+
+        if( !m_pcb->GetDesignSettings().Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
+            && !m_pcb->GetDesignSettings().Ignore( DRCE_MISSING_COURTYARD_IN_FOOTPRINT ) )
+        {
+            stage( _( "Courtyard areas" ), [&]() { doOverlappingCourtyardsDrc(); } );
+        }
+
+        if( m_doUnconnectedTest )
+        {
+            stage( _( "Unconnected pads" ), [&]() { testUnconnected(); } );
+
+            for( DRC_ITEM* unconnectedItem : m_unconnected )
+            {
+                aWriter.WriteItem( *unconnectedItem );
+                delete unconnectedItem;
+            }
+
+            m_stageStats.back().m_markers = m_unconnected.size();
+            m_unconnected.clear();
+        }
+
+        stage( _( "Items on disabled layers" ), [&]() { testDisabledLayers(); } );
+
+        if( !m_pcb->GetDesignSettings().Ignore( DRCE_UNRESOLVED_VARIABLE ) )
+            stage( _( "Text variables" ), [&]() { testTextVars(); } );
+    }
+
+    aWriter.End();
+    m_reportWriter = nullptr;
+
+    return aWriter.GetCount() - firstItem;
+}
+
+
+/**
+ * @return true if aErrorCode is one of the errors reported by DRC::doTrackDrc().  The main
+ *         item of these markers is always the reference track.
+ */
+static bool isTrackTestError( int aErrorCode )
+{
+    switch( aErrorCode )
+    {
+    case DRCE_TRACK_NEAR_THROUGH_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA_DRILL:
+    case DRCE_TOO_SMALL_MICROVIA_DRILL:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_MICRO_VIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_TRACK_NEAR_EDGE:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+void DRC::RunIncrementalTests( const std::vector<EDA_RECT>& aDirtyAreas )
+{
+    // be sure m_pcb is the current board, not a old one
+    // ( the board can be reloaded )
+    m_pcb = m_pcbEditorFrame->GetBoard();
+
+    if( aDirtyAreas.empty() )
+        return;
+
+    m_board_outlines.RemoveAllContours();
+    m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+
+    DRC_RTREE<TRACK*> trackIndex;
+    DRC_RTREE<D_PAD*> padIndex;
+    const int         margin = buildTrackIndexes( trackIndex, padIndex );
+
+    // A track can be in conflict with a changed item only if it is closer than the largest
+    // clearance to the old or the new position of this item.  Such tracks are tested again
+    // against all their neighbours, exactly as during a full run.
+    std::vector<EDA_RECT> areas;
+
+    for( EDA_RECT area : aDirtyAreas )
+    {
+        area.Normalize();
+        area.Inflate( margin );
+        areas.push_back( area );
+    }
+
+    const TRACKS&       tracks = m_pcb->Tracks();
+    std::vector<size_t> retestRanks;
+    std::set<KIID>      retestIds;
+    std::set<KIID>      trackIds;
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+    {
+        EDA_RECT bbox = tracks[ii]->GetBoundingBox();
+
+        trackIds.insert( tracks[ii]->m_Uuid );
+
+        for( const EDA_RECT& area : areas )
+        {
+            if( area.Intersects( bbox ) )
+            {
+                retestRanks.push_back( ii );
+                retestIds.insert( tracks[ii]->m_Uuid );
+                break;
+            }
+        }
+    }
+
+    // The track markers of the tested tracks, and of the deleted tracks, are obsolete
+    std::vector<MARKER_PCB*> obsoleteMarkers;
+
+    for( MARKER_PCB* marker : m_pcb->Markers() )
+    {
+        const RC_ITEM* rcItem = marker->GetRCItem();
+
+        if( !isTrackTestError( rcItem->GetErrorCode() ) )
+            continue;
+
+        if( retestIds.count( rcItem->GetMainItemID() )
+                || !trackIds.count( rcItem->GetMainItemID() ) )
+        {
+            obsoleteMarkers.push_back( marker );
+        }
+    }
+
+    std::vector<MARKER_PCB*> newMarkers;
+
+    s_markerSink = &newMarkers;
+
+    for( size_t rank : retestRanks )
+        testTrackNeighbours( trackIndex, padIndex, margin, rank );
+
+    s_markerSink = nullptr;
+
+    if( obsoleteMarkers.empty() && newMarkers.empty() )
+        return;
+
+    for( MARKER_PCB* marker : obsoleteMarkers )
+    {
+        if( marker->IsSelected() )
+            m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+        getView()->Remove( marker );
+        m_pcb->Remove( marker );
+        delete marker;
+    }
+
+    if( !newMarkers.empty() )
+    {
+        BOARD_COMMIT commit( m_pcbEditorFrame );
+
+        for( MARKER_PCB* marker : newMarkers )
+            commit.Add( marker );
+
+        commit.Push( wxEmptyString, false, false );
+    }
+
+    // update the m_drcDialog listboxes
+    if( m_drcDialog )
+        updatePointers();
+}
+
+
 void DRC::updatePointers()
 {
     // update my pointers, m_pcbEditorFrame is the only unchangeable one
@@ -525,7 +989,7 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
 
     const BOARD_DESIGN_SETTINGS& g = m_pcb->GetDesignSettings();
 
-#define FmtVal( x ) GetChars( StringFromValue( m_pcbEditorFrame->GetUserUnits(), x ) )
+#define FmtVal( x ) GetChars( StringFromValue( userUnits(), x ) )
 
 #if 0   // set to 1 when (if...) BOARD_DESIGN_SETTINGS has a m_MinClearance value
     if( nc->GetClearance() < g.m_MinClearance )
@@ -645,15 +1109,28 @@ void DRC::testPad2Pad()
             max_size = radius;
     }
 
-    // Upper limit of pad list (limit not included)
-    D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
+    // Index the pads by position.  They are inserted in the X then Y order, so each query
+    // returns the candidates in the same order as a scan of the sorted list.
+    DRC_RTREE<D_PAD*> padIndex;
+
+    for( D_PAD* pad : sortedPads )
+        padIndex.Insert( pad, EDA_RECT( pad->GetPosition(), wxSize( 0, 0 ) ) );
+
+    std::vector<D_PAD*> candidates;
 
-    // Test the pads
-    for( auto& pad : sortedPads )
+    // Test each pad against the pads following it in the list, which are close enough on
+    // both axis to be in conflict with it
+    for( size_t ii = 0; ii < sortedPads.size(); ++ii )
     {
-        int x_limit = pad->GetClearance() + pad->GetBoundingRadius() + pad->GetPosition().x;
+        D_PAD*   pad = sortedPads[ii];
+        int      limit = max_size + pad->GetClearance() + pad->GetBoundingRadius();
+        EDA_RECT area( pad->GetPosition(), wxSize( 0, 0 ) );
 
-        doPadToPadsDrc( pad, &pad, listEnd, max_size + x_limit );
+        area.Inflate( limit );
+        padIndex.Query( area, candidates, (int) ii + 1 );
+        countTests( 1, candidates.size() );
+
+        doPadToPadsDrc( pad, candidates );
     }
 }
 
@@ -706,6 +1183,8 @@ void DRC::testDrilledHoles()
         }
     }
 
+    countTests( holes.size(), (long long) holes.size() * ( holes.size() - 1 ) / 2 );
+
     for( size_t ii = 0; ii < holes.size(); ++ii )
     {
         const DRILLED_HOLE& refHole = holes[ ii ];
@@ -721,7 +1200,7 @@ void DRC::testDrilledHoles()
             if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
                     <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
             {
-                addMarkerToPcb( new MARKER_PCB( m_pcbEditorFrame->GetUserUnits(),
+                addMarkerToPcb( new MARKER_PCB( userUnits(),
                                                 DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
                                                 refHole.m_owner, refHole.m_location,
                                                 checkHole.m_owner, checkHole.m_location ) );
@@ -731,6 +1210,65 @@ void DRC::testDrilledHoles()
 }
 
 
+int DRC::buildTrackIndexes( DRC_RTREE<TRACK*>& aTrackIndex, DRC_RTREE<D_PAD*>& aPadIndex )
+{
+    // Build the broad phase: tracks and pads are indexed by their bounding box, and each
+    // reference segment is only tested against the items whose box intersects its own box
+    // inflated by the largest clearance found on the board.
+    int maxClearance = 0;
+
+    for( TRACK* track : m_pcb->Tracks() )
+    {
+        aTrackIndex.Insert( track, track->GetBoundingBox() );
+        maxClearance = std::max( maxClearance, track->GetNetClass()->GetClearance() );
+        maxClearance = std::max( maxClearance, track->GetClearance() );
+    }
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+        {
+            // Use the bounding circle of the shape, and include the hole, which is also
+            // tested when the pad is not on the layers of the reference segment
+            EDA_RECT bbox( pad->ShapePos(), wxSize( 0, 0 ) );
+            bbox.Inflate( pad->GetBoundingRadius() );
+
+            EDA_RECT holeBox( pad->GetPosition(), wxSize( 0, 0 ) );
+            holeBox.Inflate( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 );
+            bbox.Merge( holeBox );
+
+            aPadIndex.Insert( pad, bbox );
+            maxClearance = std::max( maxClearance, pad->GetClearance() );
+        }
+    }
+
+    // A small margin absorbs the rounding of the coordinate rotations in doTrackDrc
+    return maxClearance + Millimeter2iu( 0.001 );
+}
+
+
+void DRC::testTrackNeighbours( DRC_RTREE<TRACK*>& aTrackIndex, DRC_RTREE<D_PAD*>& aPadIndex,
+                               int aMargin, size_t aRank )
+{
+    std::vector<TRACK*> trackCandidates;
+    std::vector<D_PAD*> padCandidates;
+    TRACK*              track = m_pcb->Tracks()[aRank];
+    EDA_RECT            searchArea = track->GetBoundingBox();
+
+    searchArea.Inflate( aMargin );
+
+    // Only tracks following the reference segment in the list are tested, as in an
+    // exhaustive sweep: the previous ones have already been tested against it
+    aTrackIndex.Query( searchArea, trackCandidates, (int) aRank + 1 );
+    aPadIndex.Query( searchArea, padCandidates );
+
+    countTests( 1, trackCandidates.size() + padCandidates.size() );
+
+    // Test new segment against tracks and pads, optionally against copper zones
+    doTrackDrc( track, trackCandidates, padCandidates, m_doZonesTest );
+}
+
+
 void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 {
     wxProgressDialog * progressDialog = NULL;
@@ -750,30 +1288,118 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    DRC_RTREE<TRACK*> trackIndex;
+    DRC_RTREE<D_PAD*> padIndex;
+    const int         margin = buildTrackIndexes( trackIndex, padIndex );
+    const TRACKS&     tracks = m_pcb->Tracks();
+
+    // The tracks are tested by chunks of consecutive segments, possibly on several threads.
+    // The markers of each chunk are collected separately, and added to the board in the chunk
+    // order once all the tracks are tested, so that the result does not depend on the
+    // scheduling of the threads.
+    const size_t                          chunkSize = delta;
+    size_t                                chunkCount = ( tracks.size() + chunkSize - 1 ) / chunkSize;
+    std::vector<std::vector<MARKER_PCB*>> chunkMarkers( chunkCount );
+    std::vector<DRC_STAGE_STATS>          chunkStats( chunkCount );
+    std::atomic<size_t>                   nextChunk( 0 );
+    std::atomic<size_t>                   testedChunks( 0 );
+    std::atomic<bool>                     cancelled( false );
+
+    auto testChunk =
+            [&]( size_t aChunk )
+            {
+                std::vector<MARKER_PCB*>* callerSink = s_markerSink;
+                DRC_STAGE_STATS*          callerStats = s_stageStats;
+                size_t                    last = std::min( tracks.size(), ( aChunk + 1 ) * chunkSize );
 
-    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end(); seg_it++ )
-    {
-        if( ii++ > delta )
-        {
-            ii = 0;
-            count++;
+                s_markerSink = &chunkMarkers[aChunk];
+                s_stageStats = &chunkStats[aChunk];
+
+                for( size_t ii = aChunk * chunkSize; ii < last; ++ii )
+                    testTrackNeighbours( trackIndex, padIndex, margin, ii );
+
+                s_markerSink = callerSink;
+                s_stageStats = callerStats;
+                testedChunks++;
+            };
 
-            if( progressDialog )
+    auto updateProgress =
+            [&]() -> bool
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                if( !progressDialog )
+                    return true;
+
+                int done = std::min<int>( testedChunks, deltamax );
+
+                if( !progressDialog->Update( done, wxEmptyString ) )
+                    return false;   // Aborted by user
 #ifdef __WXMAC__
                 // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
+                if( done == deltamax )
                     aActiveWindow->Raise();
 #endif
-            }
+                return true;
+            };
+
+    size_t parallelThreadCount = 1;
+
+    if( ADVANCED_CFG::GetCfg().m_parallelDRC )
+        parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(), chunkCount );
+
+    if( parallelThreadCount <= 1 )
+    {
+        for( size_t chunk = 0; chunk < chunkCount; ++chunk )
+        {
+            if( !updateProgress() )
+                break;
+
+            testChunk( chunk );
+        }
+    }
+    else
+    {
+        auto track_lambda =
+                [&]() -> size_t
+                {
+                    size_t num = 0;
+
+                    for( size_t i = nextChunk++; i < chunkCount && !cancelled; i = nextChunk++ )
+                    {
+                        testChunk( i );
+                        num++;
+                    }
+
+                    return num;
+                };
+
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, track_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+
+            do
+            {
+                if( !cancelled && !updateProgress() )
+                    cancelled = true;
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
         }
+    }
+
+    // The markers of the chunks are counted when they are added below
+    for( const DRC_STAGE_STATS& stats : chunkStats )
+        countTests( stats.m_items, stats.m_pairChecks );
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        doTrackDrc( *seg_it, seg_it + 1, m_pcb->Tracks().end(), m_doZonesTest );
+    for( std::vector<MARKER_PCB*>& markers : chunkMarkers )
+    {
+        for( MARKER_PCB* marker : markers )
+            addMarkerToPcb( marker );
     }
 
     if( progressDialog )
@@ -781,6 +1407,88 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 }
 
 
+void DRC::testClearancesInParallel( wxWindow* aActiveWindow )
+{
+    // The test families below do not depend on each other, and only read the board.  Each of
+    // them runs on its own thread and collects its markers in its own list.  The lists are
+    // added to the board in the order of the sequential run, so that the report is the same.
+    std::vector<std::function<void()>> families;
+    std::vector<DRC_STAGE_STATS>       familyStats;
+
+    auto addFamily =
+            [&]( const wxString& aName, const std::function<void()>& aTest )
+            {
+                families.push_back( aTest );
+                familyStats.emplace_back( aName );
+            };
+
+    if( m_doPad2PadTest )
+        addFamily( _( "Pad clearances" ), [&]() { testPad2Pad(); } );
+
+    addFamily( _( "Drill clearances" ), [&]() { testDrilledHoles(); } );
+
+    // The track test is run by this thread, because it shows the progress dialog and splits
+    // its own work across several threads.  Its markers are inserted at this rank.
+    size_t tracksRank = families.size();
+
+    addFamily( _( "Zone to zone clearances" ), [&]() { testZones(); } );
+
+    if( m_doKeepoutTest )
+        addFamily( _( "Keepout areas" ), [&]() { testKeepoutAreas(); } );
+
+    addFamily( _( "Text and graphic clearances" ), [&]() { testCopperTextAndGraphics(); } );
+
+    if( !m_pcb->GetDesignSettings().Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
+        && !m_pcb->GetDesignSettings().Ignore( DRCE_MISSING_COURTYARD_IN_FOOTPRINT ) )
+    {
+        addFamily( _( "Courtyard areas" ), [&]() { doOverlappingCourtyardsDrc(); } );
+    }
+
+    std::vector<std::vector<MARKER_PCB*>> familyMarkers( families.size() );
+    std::vector<std::future<void>>        returns;
+
+    for( size_t ii = 0; ii < families.size(); ++ii )
+    {
+        returns.push_back( std::async( std::launch::async,
+                                       [this, &families, &familyMarkers, &familyStats, ii]()
+                                       {
+                                           s_markerSink = &familyMarkers[ii];
+                                           runStage( familyStats[ii], families[ii] );
+                                           s_markerSink = nullptr;
+                                       } ) );
+    }
+
+    std::vector<MARKER_PCB*> trackMarkers;
+    DRC_STAGE_STATS          trackStats( _( "Track clearances" ) );
+
+    s_markerSink = &trackMarkers;
+    runStage( trackStats, [&]() { testTracks( aActiveWindow, true ); } );
+    s_markerSink = nullptr;
+
+    for( std::future<void>& ret : returns )
+        ret.wait();
+
+    std::vector<MARKER_PCB*> markers;
+
+    for( size_t ii = 0; ii <= families.size(); ++ii )
+    {
+        if( ii == tracksRank )
+        {
+            markers.insert( markers.end(), trackMarkers.begin(), trackMarkers.end() );
+            m_stageStats.push_back( trackStats );
+        }
+
+        if( ii < families.size() )
+        {
+            markers.insert( markers.end(), familyMarkers[ii].begin(), familyMarkers[ii].end() );
+            m_stageStats.push_back( familyStats[ii] );
+        }
+    }
+
+    addMarkersToPcb( markers );
+}
+
+
 void DRC::testUnconnected()
 {
     for( DRC_ITEM* unconnectedItem : m_unconnected )
@@ -800,7 +1508,7 @@ void DRC::testUnconnected()
     for( const auto& edge : edges )
     {
         DRC_ITEM* item = new DRC_ITEM();
-        item->SetData( m_pcbEditorFrame->GetUserUnits(), DRCE_UNCONNECTED_ITEMS,
+        item->SetData( userUnits(), DRCE_UNCONNECTED_ITEMS,
                        edge.GetSourceNode()->Parent(), (wxPoint) edge.GetSourcePos(),
                        edge.GetTargetNode()->Parent(), (wxPoint) edge.GetTargetPos() );
         m_unconnected.push_back( item );
@@ -856,6 +1564,8 @@ void DRC::testKeepoutAreas()
         if( !area->GetIsKeepout() )
             continue;
 
+        countTests( 1, m_pcb->Tracks().size() );
+
         for( auto segm : m_pcb->Tracks() )
         {
             if( segm->Type() == PCB_TRACE_T )
@@ -901,12 +1611,22 @@ void DRC::testCopperTextAndGraphics()
 {
     // Test copper items for clearance violations with vias, tracks and pads
 
+    // The texts only test the tracks and pads found near their bounding box
+    DRC_RTREE<TRACK*> trackIndex;
+    DRC_RTREE<D_PAD*> padIndex;
+    const int         margin = buildTrackIndexes( trackIndex, padIndex );
+
+    auto testText = [&]( BOARD_ITEM* aText )
+                    {
+                        testCopperTextItem( aText, trackIndex, padIndex, margin );
+                    };
+
     for( BOARD_ITEM* brdItem : m_pcb->Drawings() )
     {
         if( IsCopperLayer( brdItem->GetLayer() ) )
         {
             if( brdItem->Type() == PCB_TEXT_T )
-                testCopperTextItem( brdItem );
+                testText( brdItem );
             else if( brdItem->Type() == PCB_LINE_T )
                 testCopperDrawItem( static_cast<DRAWSEGMENT*>( brdItem ));
         }
@@ -918,10 +1638,10 @@ void DRC::testCopperTextAndGraphics()
         TEXTE_MODULE& val = module->Value();
 
         if( ref.IsVisible() && IsCopperLayer( ref.GetLayer() ) )
-            testCopperTextItem( &ref );
+            testText( &ref );
 
         if( val.IsVisible() && IsCopperLayer( val.GetLayer() ) )
-            testCopperTextItem( &val );
+            testText( &val );
 
         if( module->IsNetTie() )
             continue;
@@ -931,7 +1651,7 @@ void DRC::testCopperTextAndGraphics()
             if( IsCopperLayer( item->GetLayer() ) )
             {
                 if( item->Type() == PCB_MODULE_TEXT_T && ( (TEXTE_MODULE*) item )->IsVisible() )
-                    testCopperTextItem( item );
+                    testText( item );
                 else if( item->Type() == PCB_MODULE_EDGE_T )
                     testCopperDrawItem( static_cast<DRAWSEGMENT*>( item ));
             }
@@ -995,12 +1715,16 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
         break;
     }
 
+    countTests( 1, 0 );
+
     // Test tracks and vias
     for( auto track : m_pcb->Tracks() )
     {
         if( !track->IsOnLayer( aItem->GetLayer() ) )
             continue;
 
+        countTests( 0, 1 );
+
         int minDist = ( track->GetWidth() + itemWidth ) / 2 + track->GetClearance( NULL );
         SEG trackAsSeg( track->GetStart(), track->GetEnd() );
 
@@ -1035,6 +1759,8 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
         if( pad->GetParent() == aItem->GetParent() )
             continue;
 
+        countTests( 0, 1 );
+
         SHAPE_POLY_SET padOutline;
         pad->TransformShapeWithClearanceToPolygon( padOutline, pad->GetClearance( NULL ) );
 
@@ -1051,27 +1777,41 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
 }
 
 
-void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
+void DRC::testCopperTextItem( BOARD_ITEM* aTextItem, DRC_RTREE<TRACK*>& aTrackIndex,
+                              DRC_RTREE<D_PAD*>& aPadIndex, int aMargin )
 {
     EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aTextItem );
 
     if( text == nullptr )
         return;
 
-    std::vector<wxPoint> textShape;      // a buffer to store the text shape (set of segments)
+    // the text shape (set of segments), cached by the text item
+    const std::vector<wxPoint>& textShape = text->GetTextShapeSegments();
     int textWidth = text->GetThickness();
 
-    // So far the bounding box makes up the text-area
-    text->TransformTextShapeToSegmentList( textShape );
-
     if( textShape.size() == 0 )     // Should not happen (empty text?)
         return;
 
+    // So far the bounding box makes up the text-area
     EDA_RECT bbox = text->GetTextBox();
     SHAPE_RECT rect_area( bbox.GetX(), bbox.GetY(), bbox.GetWidth(), bbox.GetHeight() );
 
+    countTests( 1, 0 );
+
+    // Only the items whose bounding box is closer to the text box than the largest clearance
+    // (plus the text width) can be in conflict with the text
+    EDA_RECT searchArea = bbox;
+    searchArea.Normalize();
+    searchArea.Inflate( textWidth / 2 + aMargin );
+
+    std::vector<TRACK*> tracks;
+    std::vector<D_PAD*> pads;
+
+    aTrackIndex.Query( searchArea, tracks );
+    aPadIndex.Query( searchArea, pads );
+
     // Test tracks and vias
-    for( auto track : m_pcb->Tracks() )
+    for( auto track : tracks )
     {
         if( !track->IsOnLayer( aTextItem->GetLayer() ) )
             continue;
@@ -1083,6 +1823,8 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
         if( !rect_area.Collide( trackAsSeg, minDist ) )
             continue;
 
+        countTests( 0, 1 );
+
         for( unsigned jj = 0; jj < textShape.size(); jj += 2 )
         {
             SEG textSeg( textShape[jj], textShape[jj+1] );
@@ -1107,7 +1849,7 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
     }
 
     // Test pads
-    for( auto pad : m_pcb->GetPads() )
+    for( auto pad : pads )
     {
         if( !pad->IsOnLayer( aTextItem->GetLayer() ) )
             continue;
@@ -1120,6 +1862,8 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
         if( !rect_area.Collide( SEG( shape_pos, shape_pos ), bb_radius ) )
             continue;
 
+        countTests( 0, 1 );
+
         SHAPE_POLY_SET padOutline;
 
         int minDist = textWidth/2 + pad->GetClearance( NULL );
@@ -1156,7 +1900,7 @@ void DRC::testOutline()
 
 void DRC::testDisabledLayers()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
     wxCHECK( board, /*void*/ );
     LSET disabledLayers = board->GetEnabledLayers().flip();
 
@@ -1198,7 +1942,7 @@ void DRC::testDisabledLayers()
 
 void DRC::testTextVars()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
 
     for( MODULE* module : board->Modules() )
     {
@@ -1234,7 +1978,7 @@ void DRC::testTextVars()
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC::doPadToPadsDrc( D_PAD* aRefPad, const std::vector<D_PAD*>& aPads )
 {
     const static LSET all_cu = LSET::AllCuMask();
 
@@ -1257,18 +2001,11 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
     // (a value = 0 means use netclass value)
     dummypad.SetLocalClearance( 1 );
 
-    for( D_PAD** pad_list = aStart;  pad_list<aEnd;  ++pad_list )
+    for( D_PAD* pad : aPads )
     {
-        D_PAD* pad = *pad_list;
-
         if( pad == aRefPad )
             continue;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
-
         // No problem if pads which are on copper layers are on different copper layers,
         // (pads can be only on a technical layer, to build complex pads)
         // but their hole (if any ) can create DRC error because they are on all
@@ -1374,6 +2111,9 @@ void DRC::doOverlappingCourtyardsDrc()
     DRC_COURTYARD_OVERLAP drc_overlap( [&]( MARKER_PCB* aMarker ) { addMarkerToPcb( aMarker ); } );
 
     drc_overlap.RunDRC( userUnits(), *m_pcb );
+
+    // the markers are counted by addMarkerToPcb()
+    countTests( drc_overlap.GetStats().m_items, drc_overlap.GetStats().m_pairChecks );
 }
 
 
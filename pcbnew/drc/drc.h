@@ -28,12 +28,17 @@
 #include <class_board.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
+#include <drc/drc_rtree.h>
+#include <drc/drc_stats.h>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
+class DRC_REPORT_WRITER;
+
 #define OK_DRC  0
 #define BAD_DRC 1
 
@@ -154,28 +159,12 @@ private:
     bool     m_reportAllTrackErrors;    // Report all tracks errors (or only 4 first errors)
     bool     m_testFootprints;          // Test footprints against schematic
 
-    /* In DRC functions, many calculations are using coordinates relative
-     * to the position of the segment under test (segm to segm DRC, segm to pad DRC
-     * Next variables store coordinates relative to the start point of this segment
-     */
-    wxPoint  m_padToTestPos;            // Position of the pad for segm-to-pad and pad-to-pad
-    wxPoint  m_segmEnd;                 // End point of the reference segment (start = (0, 0) )
-
-    /* Some functions are comparing the ref segm to pads or others segments using
-     * coordinates relative to the ref segment considered as the X axis
-     * so we store the ref segment length (the end point relative to these axis)
-     * and the segment orientation (used to rotate other coordinates)
+    /* In DRC functions, many calculations are using coordinates relative to the position
+     * of the segment under test (segm to segm DRC, segm to pad DRC).  This state (relative
+     * pad position, end point, angle and length of the reference segment, clipping box used
+     * by checkLine) is thread-local and lives in drc_clearance_test_functions.cpp, so that
+     * tracks and pads can be tested in parallel.
      */
-    double   m_segmAngle;               // Ref segm orientation in 0.1 degree
-    int      m_segmLength;              // length of the reference segment
-
-    /* variables used in checkLine to test DRC segm to segm:
-     * define the area relative to the ref segment that does not contains any other segment
-     */
-    int      m_xcliplo;
-    int      m_ycliplo;
-    int      m_xcliphi;
-    int      m_ycliphi;
 
     PCB_EDIT_FRAME*        m_pcbEditorFrame;   // The pcb frame editor which owns the board
     BOARD*                 m_pcb;
@@ -187,6 +176,14 @@ private:
     bool                   m_drcRun;
     bool                   m_footprintsTested;
 
+    std::vector<DRC_STAGE_STATS> m_stageStats;  // timings and counters of the last run
+
+    DRC_REPORT_WRITER*     m_reportWriter;     // when not null, the violations are streamed
+                                               // to this writer instead of the board
+    EDA_UNITS              m_headlessUnits;    // units used when there is no editor frame
+    std::vector<MARKER_PCB*>* m_pendingMarkers; // when not null, the markers are collected
+                                               // here and committed at the end of the run
+
     ///> Sets up handlers for various events.
     void setTransitions() override;
 
@@ -195,13 +192,36 @@ private:
      */
     void updatePointers();
 
-    EDA_UNITS userUnits() const { return m_pcbEditorFrame->GetUserUnits(); }
+    EDA_UNITS userUnits() const
+    {
+        return m_pcbEditorFrame ? m_pcbEditorFrame->GetUserUnits() : m_headlessUnits;
+    }
 
     /**
      * Adds a DRC marker to the PCB through the COMMIT mechanism.
+     * When called by a test run in parallel, the marker is only collected, and is added
+     * when the test is finished.  During RunTests() all markers are collected, and are
+     * added to the board (and to the view) in a single commit at the end of the run.
      */
     void addMarkerToPcb( MARKER_PCB* aMarker );
 
+    /**
+     * Adds a list of DRC markers to the PCB in a single commit (or to the collecting list,
+     * or to the report writer, like addMarkerToPcb()), and clears the list.
+     */
+    void addMarkersToPcb( std::vector<MARKER_PCB*>& aMarkers );
+
+    /**
+     * Run aTest, measuring its time in aStats.  While it runs, the items, pairs and
+     * markers counted by the current thread are added to aStats.
+     */
+    void runStage( DRC_STAGE_STATS& aStats, const std::function<void()>& aTest );
+
+    /**
+     * Add aItems and aPairChecks to the counters of the stage run by the current thread.
+     */
+    static void countTests( long aItems, long long aPairChecks );
+
     /**
      * Fetches a reasonable point for marking a violoation between two non-point objects.
      */
@@ -231,6 +251,30 @@ private:
      */
     void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
 
+    /**
+     * Fill the broad phase indexes used by the track tests with the tracks and the pads
+     * of the board.
+     *
+     * @return the margin by which the bounding box of a reference segment must be inflated
+     *         to find all the items which can be in conflict with it.
+     */
+    int buildTrackIndexes( DRC_RTREE<TRACK*>& aTrackIndex, DRC_RTREE<D_PAD*>& aPadIndex );
+
+    /**
+     * Test the track of rank aRank in the board track list against the pads and the tracks
+     * following it in the list.
+     */
+    void testTrackNeighbours( DRC_RTREE<TRACK*>& aTrackIndex, DRC_RTREE<D_PAD*>& aPadIndex,
+                              int aMargin, size_t aRank );
+
+    /**
+     * Run the pad, drill, track, zone, keepout, text and courtyard tests concurrently.
+     *
+     * The markers are added to the board in the same order as the sequential run.
+     * @param aActiveWindow = the active window used as parent for the progress bar
+     */
+    void testClearancesInParallel( wxWindow* aActiveWindow );
+
     void testPad2Pad();
 
     void testDrilledHoles();
@@ -242,7 +286,9 @@ private:
     void testKeepoutAreas();
 
     // aTextItem is type BOARD_ITEM* to accept either TEXTE_PCB or TEXTE_MODULE
-    void testCopperTextItem( BOARD_ITEM* aTextItem );
+    // The tracks and pads are searched in the indexes filled by buildTrackIndexes()
+    void testCopperTextItem( BOARD_ITEM* aTextItem, DRC_RTREE<TRACK*>& aTrackIndex,
+                             DRC_RTREE<D_PAD*>& aPadIndex, int aMargin );
 
     void testCopperDrawItem( DRAWSEGMENT* aDrawing );
 
@@ -263,32 +309,42 @@ private:
 
     bool doNetClass( const std::shared_ptr<NETCLASS>& aNetClass, wxString& msg );
 
+    /**
+     * Test the clearance between two zones on the same layer.
+     *
+     * @param aRefPoly and aTestPoly are the smoothed outlines of the zones, with their
+     *                 bounding box caches built.
+     * @param aMarkers receives the markers found (they are not added to the board)
+     * @return the number of errors found
+     */
+    int testZonePair( ZONE_CONTAINER* aZoneRef, const SHAPE_POLY_SET& aRefPoly,
+                      ZONE_CONTAINER* aZoneToTest, const SHAPE_POLY_SET& aTestPoly,
+                      std::vector<MARKER_PCB*>& aMarkers ) const;
+
     /**
      * Test the clearance between aRefPad and other pads.
      *
-     * The pad list must be sorted by x coordinate.
+     * Stops at the first conflict found.
      *
      * @param aRefPad is the pad to test
-     * @param aStart is the first pad of the list to test against aRefPad
-     * @param aEnd is the end of the list and is not included
-     * @param x_limit is used to stop the test
-     * (i.e. when the current pad pos X in list exceeds this limit, because the list
-     * is sorted by X coordinate)
+     * @param aPads are the pads to test against aRefPad (usually the neighbours found by
+     *              the pad index of testPad2Pad(), in the X then Y order)
      */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
+    bool doPadToPadsDrc( D_PAD* aRefPad, const std::vector<D_PAD*>& aPads );
 
     /**
      * Test the current segment.
      *
      * @param aRefSeg The segment to test
-     * @param aStartIt the iterator to the first track to test
-     * @param aEndIt the marker for the iterator end
+     * @param aTracks the tracks to test against aRefSeg (usually the neighbours found by
+     *                the broad phase of testTracks())
+     * @param aPads the pads to test against aRefSeg
      * @param aTestZones true if should do copper zones test. This can be very time consumming
      * @return bool - true if no problems, else false and m_currentMarker is
      *          filled in with the problem information.
      */
-    void doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                     bool aTestZones );
+    void doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                     const std::vector<D_PAD*>& aPads, bool aTestZones );
 
     /**
      * Test for footprint courtyard overlaps.
@@ -307,11 +363,11 @@ private:
 
     /**
      * Check the distance from a pad to segment.  This function uses several
-     * instance variable not passed in:
-     *      m_segmLength = length of the segment being tested
-     *      m_segmAngle  = angle of the segment with the X axis;
-     *      m_segmEnd    = end coordinate of the segment
-     *      m_padToTestPos = position of pad relative to the origin of segment
+     * thread-local variables not passed in:
+     *      s_segmLength = length of the segment being tested
+     *      s_segmAngle  = angle of the segment with the X axis;
+     *      s_segmEnd    = end coordinate of the segment
+     *      s_padToTestPos = position of pad relative to the origin of segment
      * @param aPad Is the pad involved in the check
      * @param aSegmentWidth width of the segment to test
      * @param aMinDist Is the minimum clearance needed
@@ -342,7 +398,7 @@ private:
      * (helper function used in drc calculations to see if one track is in contact with
      *  another track).
      * Test if a line intersects a bounding box (a rectangle)
-     * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
+     * The rectangle is defined by s_xcliplo, s_ycliplo and s_xcliphi, s_ycliphi
      * return true if the line from aSegStart to aSegEnd is outside the bounding box
      */
     bool checkLine( wxPoint aSegStart, wxPoint aSegEnd );
@@ -404,6 +460,31 @@ public:
      * @param aMessages = a wxTextControl where to display some activity messages. Can be NULL
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
+
+    /**
+     * Run the board tests without a board editor: no zone refill, no progress dialog, and
+     * no marker is added to the board.  Each violation is written to aWriter as soon as it
+     * is found, then freed.  Unconnected items are reported too.  The footprints are not
+     * tested against the schematic.
+     *
+     * @return the number of violations written.
+     */
+    int RunTestsHeadless( BOARD* aBoard, DRC_REPORT_WRITER& aWriter, EDA_UNITS aUnits );
+
+    /**
+     * @return the timings and counters of each stage of the last RunTests() call.
+     */
+    const std::vector<DRC_STAGE_STATS>& GetStageStats() const { return m_stageStats; }
+
+    /**
+     * Test again the tracks which can be affected by a change of the board, and replace
+     * their markers.  The markers of the other tests, and of tracks far from the changes,
+     * are kept.
+     *
+     * @param aDirtyAreas are the bounding boxes of the changed items, before and after the
+     *                    change.
+     */
+    void RunIncrementalTests( const std::vector<EDA_RECT>& aDirtyAreas );
 };
 
 
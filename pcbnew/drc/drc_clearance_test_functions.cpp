@@ -41,6 +41,31 @@
 #include <math/util.h>      // for KiROUND
 
 
+/* In DRC functions, many calculations are using coordinates relative
+ * to the position of the segment under test (segm to segm DRC, segm to pad DRC
+ * Next variables store coordinates relative to the start point of this segment.
+ * They are thread-local, because the tests can be run by several threads.
+ */
+static thread_local wxPoint s_padToTestPos;     // Position of the pad for segm-to-pad and pad-to-pad
+static thread_local wxPoint s_segmEnd;          // End point of the reference segment (start = (0, 0) )
+
+/* Some functions are comparing the ref segm to pads or others segments using
+ * coordinates relative to the ref segment considered as the X axis
+ * so we store the ref segment length (the end point relative to these axis)
+ * and the segment orientation (used to rotate other coordinates)
+ */
+static thread_local double  s_segmAngle = 0;    // Ref segm orientation in 0.1 degree
+static thread_local int     s_segmLength = 0;   // length of the reference segment
+
+/* variables used in checkLine to test DRC segm to segm:
+ * define the area relative to the ref segment that does not contains any other segment
+ */
+static thread_local int     s_xcliplo = 0;
+static thread_local int     s_ycliplo = 0;
+static thread_local int     s_xcliphi = 0;
+static thread_local int     s_ycliphi = 0;
+
+
 /**
  * compare 2 convex polygons and return true if distance > aDist (if no error DRC)
  * i.e if for each edge of the first polygon distance from each edge of the other polygon
@@ -107,10 +132,9 @@ bool poly2segmentDRC( wxPoint* aTref, int aTrefCount, wxPoint aSegStart, wxPoint
 }
 
 
-void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                      bool aTestZones )
+void DRC::doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                      const std::vector<D_PAD*>& aPads, bool aTestZones )
 {
-    TRACK*    track;
     wxPoint   delta;           // length on X and Y axis of segments
     wxPoint   shape_pos;
 
@@ -121,8 +145,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     // coordinates will be made relative to the reference segment origin
     wxPoint origin = aRefSeg->GetStart();
 
-    m_segmEnd   = delta = aRefSeg->GetEnd() - origin;
-    m_segmAngle = 0;
+    s_segmEnd   = delta = aRefSeg->GetEnd() - origin;
+    s_segmAngle = 0;
 
     LSET layerMask = aRefSeg->GetLayerSet();
     int  net_code_ref = aRefSeg->GetNetCode();
@@ -233,14 +257,14 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     if( delta.x || delta.y )
     {
         // Compute the segment angle in 0,1 degrees
-        m_segmAngle = ArcTangente( delta.y, delta.x );
+        s_segmAngle = ArcTangente( delta.y, delta.x );
 
         // Compute the segment length: we build an equivalent rotated segment,
         // this segment is horizontal, therefore dx = length
-        RotatePoint( &delta, m_segmAngle );    // delta.x = length, delta.y = 0
+        RotatePoint( &delta, s_segmAngle );    // delta.x = length, delta.y = 0
     }
 
-    m_segmLength = delta.x;
+    s_segmLength = delta.x;
 
     /******************************************/
     /* Phase 1 : test DRC track to pads :     */
@@ -260,63 +284,60 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
 
     // Compute the min distance to pads
-    for( MODULE* mod : m_pcb->Modules() )
+    for( D_PAD* pad : aPads )
     {
-        for( D_PAD* pad : mod->Pads() )
-        {
-            SEG padSeg( pad->GetPosition(), pad->GetPosition() );
-
-            // No problem if pads are on another layer, but if a drill hole exists (a pad on
-            // a single layer can have a hole!) we must test the hole
-            if( !( pad->GetLayerSet() & layerMask ).any() )
-            {
-                // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
-                // pseudo pad is used, with a shape and a size like the hole
-                if( pad->GetDrillSize().x == 0 )
-                    continue;
-
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetPosition( pad->GetPosition() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                                                                            PAD_SHAPE_OVAL :
-                                                                            PAD_SHAPE_CIRCLE );
-                dummypad.SetOrientation( pad->GetOrientation() );
-
-                m_padToTestPos = dummypad.GetPosition() - origin;
-
-                if( !checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
-                {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_THROUGH_HOLE,
-                                                    getLocation( aRefSeg, pad, padSeg ),
-                                                    aRefSeg, pad ) );
-
-                    if( !m_reportAllTrackErrors )
-                        return;
-                }
+        SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
+        // No problem if pads are on another layer, but if a drill hole exists (a pad on
+        // a single layer can have a hole!) we must test the hole
+        if( !( pad->GetLayerSet() & layerMask ).any() )
+        {
+            // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
+            // pseudo pad is used, with a shape and a size like the hole
+            if( pad->GetDrillSize().x == 0 )
                 continue;
-            }
 
-            // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
-            // but no problem if the pad netcode is the current netcode (same net)
-            if( pad->GetNetCode()                       // the pad must be connected
-               && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
-                continue;
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetPosition( pad->GetPosition() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                                                                        PAD_SHAPE_OVAL :
+                                                                        PAD_SHAPE_CIRCLE );
+            dummypad.SetOrientation( pad->GetOrientation() );
 
-            // DRC for the pad
-            shape_pos = pad->ShapePos();
-            m_padToTestPos = shape_pos - origin;
-            int segToPadClearance = std::max( ref_seg_clearance, pad->GetClearance() );
+            s_padToTestPos = dummypad.GetPosition() - origin;
 
-            if( !checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
+            if( !checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_PAD,
+                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_THROUGH_HOLE,
                                                 getLocation( aRefSeg, pad, padSeg ),
                                                 aRefSeg, pad ) );
 
                 if( !m_reportAllTrackErrors )
                     return;
             }
+
+            continue;
+        }
+
+        // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
+        // but no problem if the pad netcode is the current netcode (same net)
+        if( pad->GetNetCode()                       // the pad must be connected
+           && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
+            continue;
+
+        // DRC for the pad
+        shape_pos = pad->ShapePos();
+        s_padToTestPos = shape_pos - origin;
+        int segToPadClearance = std::max( ref_seg_clearance, pad->GetClearance() );
+
+        if( !checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
+        {
+            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_PAD,
+                                            getLocation( aRefSeg, pad, padSeg ),
+                                            aRefSeg, pad ) );
+
+            if( !m_reportAllTrackErrors )
+                return;
         }
     }
 
@@ -330,9 +351,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( auto it = aStartIt; it != aEndIt; it++ )
+    for( TRACK* track : aTracks )
     {
-        track = *it;
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
             continue;
@@ -399,14 +419,14 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
          */
         segStartPoint = track->GetStart() - origin;
         segEndPoint   = track->GetEnd() - origin;
-        RotatePoint( &segStartPoint, m_segmAngle );
-        RotatePoint( &segEndPoint, m_segmAngle );
+        RotatePoint( &segStartPoint, s_segmAngle );
+        RotatePoint( &segEndPoint, s_segmAngle );
 
         SEG seg( segStartPoint, segEndPoint );
 
         if( track->Type() == PCB_VIA_T )
         {
-            if( checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+            if( checkMarginToCircle( segStartPoint, w_dist, s_segmLength ) )
                 continue;
 
             addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_VIA,
@@ -429,14 +449,14 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             if( segStartPoint.x > segEndPoint.x )
                 std::swap( segStartPoint.x, segEndPoint.x );
 
-            if( segStartPoint.x > ( -w_dist ) && segStartPoint.x < ( m_segmLength + w_dist ) )
+            if( segStartPoint.x > ( -w_dist ) && segStartPoint.x < ( s_segmLength + w_dist ) )
             {
                 // the start point is inside the reference range
                 //      X........
                 //    O--REF--+
 
                 // Fine test : we consider the rounded shape of each end of the track segment:
-                if( segStartPoint.x >= 0 && segStartPoint.x <= m_segmLength )
+                if( segStartPoint.x >= 0 && segStartPoint.x <= s_segmLength )
                 {
                     addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                     getLocation( aRefSeg, track, seg ),
@@ -446,7 +466,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                         return;
                 }
 
-                if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+                if( !checkMarginToCircle( segStartPoint, w_dist, s_segmLength ) )
                 {
                     addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                     getLocation( aRefSeg, track, seg ),
@@ -457,13 +477,13 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 }
             }
 
-            if( segEndPoint.x > ( -w_dist ) && segEndPoint.x < ( m_segmLength + w_dist ) )
+            if( segEndPoint.x > ( -w_dist ) && segEndPoint.x < ( s_segmLength + w_dist ) )
             {
                 // the end point is inside the reference range
                 //  .....X
                 //    O--REF--+
                 // Fine test : we consider the rounded shape of the ends
-                if( segEndPoint.x >= 0 && segEndPoint.x <= m_segmLength )
+                if( segEndPoint.x >= 0 && segEndPoint.x <= s_segmLength )
                 {
                     addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                     getLocation( aRefSeg, track, seg ),
@@ -473,7 +493,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                         return;
                 }
 
-                if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
+                if( !checkMarginToCircle( segEndPoint, w_dist, s_segmLength ) )
                 {
                     addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                     getLocation( aRefSeg, track, seg ),
@@ -501,7 +521,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         }
         else if( segStartPoint.x == segEndPoint.x ) // perpendicular segments
         {
-            if( segStartPoint.x <= -w_dist || segStartPoint.x >= m_segmLength + w_dist )
+            if( segStartPoint.x <= -w_dist || segStartPoint.x >= s_segmLength + w_dist )
                 continue;
 
             // Test if segments are crossing
@@ -519,7 +539,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             }
 
             // At this point the drc error is due to an end near a reference segm end
-            if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+            if( !checkMarginToCircle( segStartPoint, w_dist, s_segmLength ) )
             {
                 addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                 getLocation( aRefSeg, track, seg ),
@@ -528,7 +548,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 if( !m_reportAllTrackErrors )
                     return;
             }
-            if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
+            if( !checkMarginToCircle( segEndPoint, w_dist, s_segmLength ) )
             {
                 addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
                                                 getLocation( aRefSeg, track, seg ),
@@ -543,9 +563,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             // calcul de la "surface de securite du segment de reference
             // First rought 'and fast) test : the track segment is like a rectangle
 
-            m_xcliplo = m_ycliplo = -w_dist;
-            m_xcliphi = m_segmLength + w_dist;
-            m_ycliphi = w_dist;
+            s_xcliplo = s_ycliplo = -w_dist;
+            s_xcliphi = s_segmLength + w_dist;
+            s_ycliphi = w_dist;
 
             // A fine test is needed because a serment is not exactly a
             // rectangle, it has rounded ends
@@ -556,8 +576,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                  * rectangular zone
                  */
 
-                m_xcliplo = 0;
-                m_xcliphi = m_segmLength;
+                s_xcliplo = 0;
+                s_xcliphi = s_segmLength;
 
                 if( !checkLine( segStartPoint, segEndPoint ) )
                 {
@@ -798,12 +818,12 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
         /* One can use checkClearanceSegmToPad to test clearance
          * aRefPad is like a track segment with a null length and a witdth = GetSize().x
          */
-        m_segmLength = 0;
-        m_segmAngle  = 0;
+        s_segmLength = 0;
+        s_segmAngle  = 0;
 
-        m_segmEnd.x = m_segmEnd.y = 0;
+        s_segmEnd.x = s_segmEnd.y = 0;
 
-        m_padToTestPos = relativePadPos;
+        s_padToTestPos = relativePadPos;
         diag = checkClearanceSegmToPad( aPad, aRefPad->GetSize().x, dist_min );
         break;
 
@@ -956,36 +976,36 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
          * and use checkClearanceSegmToPad function to test aPad to aRefPad clearance
          */
         int segm_width;
-        m_segmAngle = aRefPad->GetOrientation();                // Segment orient.
+        s_segmAngle = aRefPad->GetOrientation();                // Segment orient.
 
         if( aRefPad->GetSize().y < aRefPad->GetSize().x )     // Build an horizontal equiv segment
         {
             segm_width   = aRefPad->GetSize().y;
-            m_segmLength = aRefPad->GetSize().x - aRefPad->GetSize().y;
+            s_segmLength = aRefPad->GetSize().x - aRefPad->GetSize().y;
         }
         else        // Vertical oval: build an horizontal equiv segment and rotate 90.0 deg
         {
             segm_width   = aRefPad->GetSize().x;
-            m_segmLength = aRefPad->GetSize().y - aRefPad->GetSize().x;
-            m_segmAngle += 900;
+            s_segmLength = aRefPad->GetSize().y - aRefPad->GetSize().x;
+            s_segmAngle += 900;
         }
 
         /* the start point must be 0,0 and currently relativePadPos
          * is relative the center of pad coordinate */
         wxPoint segstart;
-        segstart.x = -m_segmLength / 2;                 // Start point coordinate of the horizontal equivalent segment
+        segstart.x = -s_segmLength / 2;                 // Start point coordinate of the horizontal equivalent segment
 
-        RotatePoint( &segstart, m_segmAngle );          // actual start point coordinate of the equivalent segment
+        RotatePoint( &segstart, s_segmAngle );          // actual start point coordinate of the equivalent segment
         // Calculate segment end position relative to the segment origin
-        m_segmEnd.x = -2 * segstart.x;
-        m_segmEnd.y = -2 * segstart.y;
+        s_segmEnd.x = -2 * segstart.x;
+        s_segmEnd.y = -2 * segstart.y;
 
         // Recalculate the equivalent segment angle in 0,1 degrees
         // to prepare a call to checkClearanceSegmToPad()
-        m_segmAngle = ArcTangente( m_segmEnd.y, m_segmEnd.x );
+        s_segmAngle = ArcTangente( s_segmEnd.y, s_segmEnd.x );
 
         // move pad position relative to the segment origin
-        m_padToTestPos = relativePadPos - segstart;
+        s_padToTestPos = relativePadPos - segstart;
 
         // Use segment to pad check to test the second pad:
         diag = checkClearanceSegmToPad( aPad, segm_width, dist_min );
@@ -1002,8 +1022,8 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
 
 
 /* test if distance between a segment is > aMinDist
- * segment start point is assumed in (0,0) and  segment start point in m_segmEnd
- * and its orientation is m_segmAngle (m_segmAngle must be already initialized)
+ * segment start point is assumed in (0,0) and  segment start point in s_segmEnd
+ * and its orientation is s_segmAngle (s_segmAngle must be already initialized)
  * and have aSegmentWidth.
  */
 bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist )
@@ -1012,12 +1032,12 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
     // we are using a horizontal segment for test, because we know here
     // only the length and orientation+ of the segment
     // Therefore the coordinates of the  shape of pad to compare
-    // must be calculated in a axis system rotated by m_segmAngle
+    // must be calculated in a axis system rotated by s_segmAngle
     // and centered to the segment origin, before they can be tested
     // against the segment
     // We are using:
-    // m_padToTestPos the position of the pad shape in this axis system
-    // m_segmAngle the axis system rotation
+    // s_padToTestPos the position of the pad shape in this axis system
+    // s_segmAngle the axis system rotation
 
     int segmHalfWidth = aSegmentWidth / 2;
     int distToLine = segmHalfWidth + aMinDist;
@@ -1046,27 +1066,27 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         /* Easy case: just test the distance between segment and pad centre
          * calculate pad coordinates in the X,Y axis with X axis = segment to test
          */
-        RotatePoint( &m_padToTestPos, m_segmAngle );
-        return checkMarginToCircle( m_padToTestPos, distToLine + padHalfsize.x, m_segmLength );
+        RotatePoint( &s_padToTestPos, s_segmAngle );
+        return checkMarginToCircle( s_padToTestPos, distToLine + padHalfsize.x, s_segmLength );
     }
 
     /* calculate the bounding box of the pad, including the clearance and the segment width
-     * if the line from 0 to m_segmEnd does not intersect this bounding box,
+     * if the line from 0 to s_segmEnd does not intersect this bounding box,
      * the clearance is always OK
      * But if intersect, a better analysis of the pad shape must be done.
      */
-    m_xcliplo = m_padToTestPos.x - distToLine - padHalfsize.x;
-    m_ycliplo = m_padToTestPos.y - distToLine - padHalfsize.y;
-    m_xcliphi = m_padToTestPos.x + distToLine + padHalfsize.x;
-    m_ycliphi = m_padToTestPos.y + distToLine + padHalfsize.y;
+    s_xcliplo = s_padToTestPos.x - distToLine - padHalfsize.x;
+    s_ycliplo = s_padToTestPos.y - distToLine - padHalfsize.y;
+    s_xcliphi = s_padToTestPos.x + distToLine + padHalfsize.x;
+    s_ycliphi = s_padToTestPos.y + distToLine + padHalfsize.y;
 
     wxPoint startPoint( 0, 0 );
-    wxPoint endPoint = m_segmEnd;
+    wxPoint endPoint = s_segmEnd;
 
     double orient = aPad->GetOrientation();
 
-    RotatePoint( &startPoint, m_padToTestPos, -orient );
-    RotatePoint( &endPoint, m_padToTestPos, -orient );
+    RotatePoint( &startPoint, s_padToTestPos, -orient );
+    RotatePoint( &endPoint, s_padToTestPos, -orient );
 
     if( checkLine( startPoint, endPoint ) )
         return true;
@@ -1090,8 +1110,8 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
          * In calculations we are using a vertical or horizontal oval shape
          * (i.e. a vertical or horizontal rounded segment)
          */
-        wxPoint cstart = m_padToTestPos;
-        wxPoint cend = m_padToTestPos;   // center of each circle
+        wxPoint cstart = s_padToTestPos;
+        wxPoint cend = s_padToTestPos;   // center of each circle
         int delta = std::abs( padHalfsize.y - padHalfsize.x );
         int radius = std::min( padHalfsize.y, padHalfsize.x );
 
@@ -1102,10 +1122,10 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
             // Build the rectangular clearance area between the two circles
             // the rect starts at cstart.x and ends at cend.x and its height
             // is (radius + distToLine)*2
-            m_xcliplo = cstart.x;
-            m_ycliplo = cstart.y - radius - distToLine;
-            m_xcliphi = cend.x;
-            m_ycliphi = cend.y + radius + distToLine;
+            s_xcliplo = cstart.x;
+            s_ycliplo = cstart.y - radius - distToLine;
+            s_xcliphi = cend.x;
+            s_ycliphi = cend.y + radius + distToLine;
         }
         else    // vertical equivalent segment
         {
@@ -1114,37 +1134,37 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
             // Build the rectangular clearance area between the two circles
             // the rect starts at cstart.y and ends at cend.y and its width
             // is (radius + distToLine)*2
-            m_xcliplo = cstart.x - distToLine - radius;
-            m_ycliplo = cstart.y;
-            m_xcliphi = cend.x + distToLine + radius;
-            m_ycliphi = cend.y;
+            s_xcliplo = cstart.x - distToLine - radius;
+            s_ycliplo = cstart.y;
+            s_xcliphi = cend.x + distToLine + radius;
+            s_ycliphi = cend.y;
         }
 
         // Test the rectangular clearance area between the two circles (the rounded ends)
         // If the segment legth is zero, only check the endpoints, skip the rectangle
-        if( m_segmLength && !checkLine( startPoint, endPoint ) )
+        if( s_segmLength && !checkLine( startPoint, endPoint ) )
         {
             return false;
         }
 
         // test the first end
         // Calculate the actual position of the circle, given the pad orientation:
-        RotatePoint( &cstart, m_padToTestPos, orient );
+        RotatePoint( &cstart, s_padToTestPos, orient );
 
         // Calculate the actual position of the circle in the new X,Y axis, relative
         // to the segment:
-        RotatePoint( &cstart, m_segmAngle );
+        RotatePoint( &cstart, s_segmAngle );
 
-        if( !checkMarginToCircle( cstart, radius + distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( cstart, radius + distToLine, s_segmLength ) )
         {
             return false;
         }
 
         // test the second end
-        RotatePoint( &cend, m_padToTestPos, orient );
-        RotatePoint( &cend, m_segmAngle );
+        RotatePoint( &cend, s_padToTestPos, orient );
+        RotatePoint( &cend, s_segmAngle );
 
-        if( !checkMarginToCircle( cend, radius + distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( cend, radius + distToLine, s_segmLength ) )
         {
             return false;
         }
@@ -1165,19 +1185,19 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         // this can be done by testing 2 rectangles and 4 circles (the corners)
 
         // Testing the first rectangle dimx + distToLine, dimy:
-        m_xcliplo = m_padToTestPos.x - padHalfsize.x - distToLine;
-        m_ycliplo = m_padToTestPos.y - padHalfsize.y;
-        m_xcliphi = m_padToTestPos.x + padHalfsize.x + distToLine;
-        m_ycliphi = m_padToTestPos.y + padHalfsize.y;
+        s_xcliplo = s_padToTestPos.x - padHalfsize.x - distToLine;
+        s_ycliplo = s_padToTestPos.y - padHalfsize.y;
+        s_xcliphi = s_padToTestPos.x + padHalfsize.x + distToLine;
+        s_ycliphi = s_padToTestPos.y + padHalfsize.y;
 
         if( !checkLine( startPoint, endPoint ) )
             return false;
 
         // Testing the second rectangle dimx , dimy + distToLine
-        m_xcliplo = m_padToTestPos.x - padHalfsize.x;
-        m_ycliplo = m_padToTestPos.y - padHalfsize.y - distToLine;
-        m_xcliphi = m_padToTestPos.x + padHalfsize.x;
-        m_ycliphi = m_padToTestPos.y + padHalfsize.y + distToLine;
+        s_xcliplo = s_padToTestPos.x - padHalfsize.x;
+        s_ycliplo = s_padToTestPos.y - padHalfsize.y - distToLine;
+        s_xcliphi = s_padToTestPos.x + padHalfsize.x;
+        s_ycliphi = s_padToTestPos.y + padHalfsize.y + distToLine;
 
         if( !checkLine( startPoint, endPoint ) )
             return false;
@@ -1185,39 +1205,39 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         // testing the 4 circles which are the clearance area of each corner:
 
         // testing the left top corner of the rectangle
-        startPoint.x = m_padToTestPos.x - padHalfsize.x;
-        startPoint.y = m_padToTestPos.y - padHalfsize.y;
-        RotatePoint( &startPoint, m_padToTestPos, orient );
-        RotatePoint( &startPoint, m_segmAngle );
+        startPoint.x = s_padToTestPos.x - padHalfsize.x;
+        startPoint.y = s_padToTestPos.y - padHalfsize.y;
+        RotatePoint( &startPoint, s_padToTestPos, orient );
+        RotatePoint( &startPoint, s_segmAngle );
 
-        if( !checkMarginToCircle( startPoint, distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( startPoint, distToLine, s_segmLength ) )
             return false;
 
         // testing the right top corner of the rectangle
-        startPoint.x = m_padToTestPos.x + padHalfsize.x;
-        startPoint.y = m_padToTestPos.y - padHalfsize.y;
-        RotatePoint( &startPoint, m_padToTestPos, orient );
-        RotatePoint( &startPoint, m_segmAngle );
+        startPoint.x = s_padToTestPos.x + padHalfsize.x;
+        startPoint.y = s_padToTestPos.y - padHalfsize.y;
+        RotatePoint( &startPoint, s_padToTestPos, orient );
+        RotatePoint( &startPoint, s_segmAngle );
 
-        if( !checkMarginToCircle( startPoint, distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( startPoint, distToLine, s_segmLength ) )
             return false;
 
         // testing the left bottom corner of the rectangle
-        startPoint.x = m_padToTestPos.x - padHalfsize.x;
-        startPoint.y = m_padToTestPos.y + padHalfsize.y;
-        RotatePoint( &startPoint, m_padToTestPos, orient );
-        RotatePoint( &startPoint, m_segmAngle );
+        startPoint.x = s_padToTestPos.x - padHalfsize.x;
+        startPoint.y = s_padToTestPos.y + padHalfsize.y;
+        RotatePoint( &startPoint, s_padToTestPos, orient );
+        RotatePoint( &startPoint, s_segmAngle );
 
-        if( !checkMarginToCircle( startPoint, distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( startPoint, distToLine, s_segmLength ) )
             return false;
 
         // testing the right bottom corner of the rectangle
-        startPoint.x = m_padToTestPos.x + padHalfsize.x;
-        startPoint.y = m_padToTestPos.y + padHalfsize.y;
-        RotatePoint( &startPoint, m_padToTestPos, orient );
-        RotatePoint( &startPoint, m_segmAngle );
+        startPoint.x = s_padToTestPos.x + padHalfsize.x;
+        startPoint.y = s_padToTestPos.y + padHalfsize.y;
+        RotatePoint( &startPoint, s_padToTestPos, orient );
+        RotatePoint( &startPoint, s_segmAngle );
 
-        if( !checkMarginToCircle( startPoint, distToLine, m_segmLength ) )
+        if( !checkMarginToCircle( startPoint, distToLine, s_segmLength ) )
             return false;
 
         break;
@@ -1227,15 +1247,15 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         wxPoint poly[4];
         aPad->BuildPadPolygon( poly, wxSize( 0, 0 ), orient );
 
-        // Move shape to m_padToTestPos
+        // Move shape to s_padToTestPos
         for( int ii = 0; ii < 4; ii++ )
         {
-            poly[ii] += m_padToTestPos;
-            RotatePoint( &poly[ii], m_segmAngle );
+            poly[ii] += s_padToTestPos;
+            RotatePoint( &poly[ii], s_segmAngle );
         }
 
         if( !poly2segmentDRC( poly, 4, wxPoint( 0, 0 ),
-                              wxPoint(m_segmLength,0), distToLine ) )
+                              wxPoint(s_segmLength,0), distToLine ) )
             return false;
         }
         break;
@@ -1247,24 +1267,24 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         // The pad can be rotated. calculate the coordinates
         // relatives to the segment being tested
         // Note, the pad position relative to the segment origin
-        // is m_padToTestPos
+        // is s_padToTestPos
         aPad->CustomShapeAsPolygonToBoardPosition( &polyset,
-                    m_padToTestPos, orient );
+                    s_padToTestPos, orient );
 
-        // Rotate all coordinates by m_segmAngle, because the segment orient
-        // is m_segmAngle
+        // Rotate all coordinates by s_segmAngle, because the segment orient
+        // is s_segmAngle
         // we are using a horizontal segment for test, because we know here
         // only the lenght and orientation+ of the segment
         // therefore all coordinates of the pad to test must be rotated by
-        // m_segmAngle (they are already relative to the segment origin)
+        // s_segmAngle (they are already relative to the segment origin)
         aPad->CustomShapeAsPolygonToBoardPosition( &polyset,
-                    wxPoint( 0, 0 ), m_segmAngle );
+                    wxPoint( 0, 0 ), s_segmAngle );
 
         const SHAPE_LINE_CHAIN& refpoly = polyset.COutline( 0 );
 
         if( !poly2segmentDRC( (wxPoint*) &refpoly.CPoint( 0 ),
                               refpoly.PointCount(),
-                              wxPoint( 0, 0 ), wxPoint(m_segmLength,0),
+                              wxPoint( 0, 0 ), wxPoint(s_segmLength,0),
                               distToLine ) )
             return false;
         }
@@ -1282,25 +1302,25 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
         // The pad can be rotated. calculate the coordinates
         // relatives to the segment being tested
         // Note, the pad position relative to the segment origin
-        // is m_padToTestPos
+        // is s_padToTestPos
         int padRadius = aPad->GetRoundRectCornerRadius();
-        TransformRoundChamferedRectToPolygon( polyset, m_padToTestPos, aPad->GetSize(),
+        TransformRoundChamferedRectToPolygon( polyset, s_padToTestPos, aPad->GetSize(),
                                          aPad->GetOrientation(),
                                          padRadius, aPad->GetChamferRectRatio(),
                                          aPad->GetChamferPositions(), maxError );
-        // Rotate also coordinates by m_segmAngle, because the segment orient
-        // is m_segmAngle.
+        // Rotate also coordinates by s_segmAngle, because the segment orient
+        // is s_segmAngle.
         // we are using a horizontal segment for test, because we know here
         // only the lenght and orientation of the segment
         // therefore all coordinates of the pad to test must be rotated by
-        // m_segmAngle (they are already relative to the segment origin)
-        polyset.Rotate( DECIDEG2RAD( -m_segmAngle ), VECTOR2I( 0, 0 ) );
+        // s_segmAngle (they are already relative to the segment origin)
+        polyset.Rotate( DECIDEG2RAD( -s_segmAngle ), VECTOR2I( 0, 0 ) );
 
         const SHAPE_LINE_CHAIN& refpoly = polyset.COutline( 0 );
 
         if( !poly2segmentDRC( (wxPoint*) &refpoly.CPoint( 0 ),
                               refpoly.PointCount(),
-                              wxPoint( 0, 0 ), wxPoint(m_segmLength,0),
+                              wxPoint( 0, 0 ), wxPoint(s_segmLength,0),
                               distToLine ) )
             return false;
         }
@@ -1367,7 +1387,7 @@ static inline int USCALE( unsigned arg, unsigned num, unsigned den )
 
 /** Helper function checkLine
  * Test if a line intersects a bounding box (a rectangle)
- * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
+ * The rectangle is defined by s_xcliplo, s_ycliplo and s_xcliphi, s_ycliphi
  * return true if the line from aSegStart to aSegEnd is outside the bounding box
  */
 bool DRC::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
@@ -1379,123 +1399,123 @@ bool DRC::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
     if( aSegStart.x > aSegEnd.x )
         std::swap( aSegStart, aSegEnd );
 
-    if( (aSegEnd.x <= m_xcliplo) || (aSegStart.x >= m_xcliphi) )
+    if( (aSegEnd.x <= s_xcliplo) || (aSegStart.x >= s_xcliphi) )
     {
         WHEN_OUTSIDE;
     }
 
     if( aSegStart.y < aSegEnd.y )
     {
-        if( (aSegEnd.y <= m_ycliplo) || (aSegStart.y >= m_ycliphi) )
+        if( (aSegEnd.y <= s_ycliplo) || (aSegStart.y >= s_ycliphi) )
         {
             WHEN_OUTSIDE;
         }
 
-        if( aSegStart.y < m_ycliplo )
+        if( aSegStart.y < s_ycliplo )
         {
-            temp = USCALE( (aSegEnd.x - aSegStart.x), (m_ycliplo - aSegStart.y),
+            temp = USCALE( (aSegEnd.x - aSegStart.x), (s_ycliplo - aSegStart.y),
                            (aSegEnd.y - aSegStart.y) );
 
-            if( (aSegStart.x += temp) >= m_xcliphi )
+            if( (aSegStart.x += temp) >= s_xcliphi )
             {
                 WHEN_OUTSIDE;
             }
 
-            aSegStart.y = m_ycliplo;
+            aSegStart.y = s_ycliplo;
             WHEN_INSIDE;
         }
 
-        if( aSegEnd.y > m_ycliphi )
+        if( aSegEnd.y > s_ycliphi )
         {
-            temp = USCALE( (aSegEnd.x - aSegStart.x), (aSegEnd.y - m_ycliphi),
+            temp = USCALE( (aSegEnd.x - aSegStart.x), (aSegEnd.y - s_ycliphi),
                            (aSegEnd.y - aSegStart.y) );
 
-            if( (aSegEnd.x -= temp) <= m_xcliplo )
+            if( (aSegEnd.x -= temp) <= s_xcliplo )
             {
                 WHEN_OUTSIDE;
             }
 
-            aSegEnd.y = m_ycliphi;
+            aSegEnd.y = s_ycliphi;
             WHEN_INSIDE;
         }
 
-        if( aSegStart.x < m_xcliplo )
+        if( aSegStart.x < s_xcliplo )
         {
-            temp = USCALE( (aSegEnd.y - aSegStart.y), (m_xcliplo - aSegStart.x),
+            temp = USCALE( (aSegEnd.y - aSegStart.y), (s_xcliplo - aSegStart.x),
                            (aSegEnd.x - aSegStart.x) );
             aSegStart.y += temp;
-            aSegStart.x  = m_xcliplo;
+            aSegStart.x  = s_xcliplo;
             WHEN_INSIDE;
         }
 
-        if( aSegEnd.x > m_xcliphi )
+        if( aSegEnd.x > s_xcliphi )
         {
-            temp = USCALE( (aSegEnd.y - aSegStart.y), (aSegEnd.x - m_xcliphi),
+            temp = USCALE( (aSegEnd.y - aSegStart.y), (aSegEnd.x - s_xcliphi),
                            (aSegEnd.x - aSegStart.x) );
             aSegEnd.y -= temp;
-            aSegEnd.x  = m_xcliphi;
+            aSegEnd.x  = s_xcliphi;
             WHEN_INSIDE;
         }
     }
     else
     {
-        if( (aSegStart.y <= m_ycliplo) || (aSegEnd.y >= m_ycliphi) )
+        if( (aSegStart.y <= s_ycliplo) || (aSegEnd.y >= s_ycliphi) )
         {
             WHEN_OUTSIDE;
         }
 
-        if( aSegStart.y > m_ycliphi )
+        if( aSegStart.y > s_ycliphi )
         {
-            temp = USCALE( (aSegEnd.x - aSegStart.x), (aSegStart.y - m_ycliphi),
+            temp = USCALE( (aSegEnd.x - aSegStart.x), (aSegStart.y - s_ycliphi),
                            (aSegStart.y - aSegEnd.y) );
 
-            if( (aSegStart.x += temp) >= m_xcliphi )
+            if( (aSegStart.x += temp) >= s_xcliphi )
             {
                 WHEN_OUTSIDE;
             }
 
-            aSegStart.y = m_ycliphi;
+            aSegStart.y = s_ycliphi;
             WHEN_INSIDE;
         }
 
-        if( aSegEnd.y < m_ycliplo )
+        if( aSegEnd.y < s_ycliplo )
         {
-            temp = USCALE( (aSegEnd.x - aSegStart.x), (m_ycliplo - aSegEnd.y),
+            temp = USCALE( (aSegEnd.x - aSegStart.x), (s_ycliplo - aSegEnd.y),
                            (aSegStart.y - aSegEnd.y) );
 
-            if( (aSegEnd.x -= temp) <= m_xcliplo )
+            if( (aSegEnd.x -= temp) <= s_xcliplo )
             {
                 WHEN_OUTSIDE;
             }
 
-            aSegEnd.y = m_ycliplo;
+            aSegEnd.y = s_ycliplo;
             WHEN_INSIDE;
         }
 
-        if( aSegStart.x < m_xcliplo )
+        if( aSegStart.x < s_xcliplo )
         {
-            temp = USCALE( (aSegStart.y - aSegEnd.y), (m_xcliplo - aSegStart.x),
+            temp = USCALE( (aSegStart.y - aSegEnd.y), (s_xcliplo - aSegStart.x),
                            (aSegEnd.x - aSegStart.x) );
             aSegStart.y -= temp;
-            aSegStart.x  = m_xcliplo;
+            aSegStart.x  = s_xcliplo;
             WHEN_INSIDE;
         }
 
-        if( aSegEnd.x > m_xcliphi )
+        if( aSegEnd.x > s_xcliphi )
         {
-            temp = USCALE( (aSegStart.y - aSegEnd.y), (aSegEnd.x - m_xcliphi),
+            temp = USCALE( (aSegStart.y - aSegEnd.y), (aSegEnd.x - s_xcliphi),
                            (aSegEnd.x - aSegStart.x) );
             aSegEnd.y += temp;
-            aSegEnd.x  = m_xcliphi;
+            aSegEnd.x  = s_xcliphi;
             WHEN_INSIDE;
         }
     }
 
     // Do not divide here to avoid rounding errors
-    if( ( (aSegEnd.x + aSegStart.x) < m_xcliphi * 2 )
-       && ( (aSegEnd.x + aSegStart.x) > m_xcliplo * 2) \
-       && ( (aSegEnd.y + aSegStart.y) < m_ycliphi * 2 )
-       && ( (aSegEnd.y + aSegStart.y) > m_ycliplo * 2 ) )
+    if( ( (aSegEnd.x + aSegStart.x) < s_xcliphi * 2 )
+       && ( (aSegEnd.x + aSegStart.x) > s_xcliplo * 2) \
+       && ( (aSegEnd.y + aSegStart.y) < s_ycliphi * 2 )
+       && ( (aSegEnd.y + aSegStart.y) > s_ycliplo * 2 ) )
     {
         return false;
     }
@@ -27,6 +27,7 @@
 
 #include <class_board.h>
 #include <class_marker_pcb.h>
+#include <drc/drc_stats.h>
 
 #include <functional>
 
@@ -57,6 +58,15 @@ public:
      */
     virtual bool RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) const = 0;
 
+    /**
+     * @return the counters of the last RunDRC() call.  The time is not measured by the
+     *         provider and is left to zero.
+     */
+    const DRC_STAGE_STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
 protected:
     DRC_PROVIDER( MARKER_HANDLER aMarkerHandler ) :
             m_marker_handler( std::move( aMarkerHandler ) )
@@ -68,11 +78,16 @@ protected:
      */
     void HandleMarker( std::unique_ptr<MARKER_PCB> aMarker ) const
     {
+        m_stats.m_markers++;
+
         // The marker hander currently takes a raw pointer,
         // but it also assumes ownership
         m_marker_handler( aMarker.release() );
     }
 
+    /// The counters of the last run, updated by the (const) RunDRC()
+    mutable DRC_STAGE_STATS m_stats;
+
 
 private:
     /// The handler for any generated markers
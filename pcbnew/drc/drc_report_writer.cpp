@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_report_writer.h>
+
+#include <convert_to_biu.h>
+#include <macros.h>
+#include <rc_item.h>
+#include <wx/datetime.h>
+
+#include <nlohmann/json.hpp>
+
+
+void DRC_TEXT_REPORT_WRITER::Begin( const wxString& aBoardName )
+{
+    wxDateTime now = wxDateTime::Now();
+
+    m_stream << "** Drc report for " << TO_UTF8( aBoardName ) << " **\n";
+    m_stream << "** Created on " << TO_UTF8( now.Format( wxT( "%F %T" ) ) ) << " **\n\n";
+}
+
+
+void DRC_TEXT_REPORT_WRITER::writeItem( const RC_ITEM& aItem )
+{
+    m_stream << TO_UTF8( aItem.ShowReport( m_units ) );
+}
+
+
+void DRC_TEXT_REPORT_WRITER::End()
+{
+    m_stream << "\n** Found " << m_count << " DRC violations **\n";
+    m_stream << "\n** End of Report **\n";
+    m_stream.flush();
+}
+
+
+void DRC_JSON_REPORT_WRITER::Begin( const wxString& aBoardName )
+{
+    // The document is written by hand around the items, so that they can be streamed
+    m_stream << "{\n  \"board\": " << nlohmann::json( TO_UTF8( aBoardName ) ).dump()
+             << ",\n  \"violations\": [";
+}
+
+
+void DRC_JSON_REPORT_WRITER::writeItem( const RC_ITEM& aItem )
+{
+    auto itemToJson = []( const KIID& aId, const wxString& aText, const wxPoint& aPos )
+                      {
+                          return nlohmann::json( {
+                                  { "uuid", TO_UTF8( aId.AsString() ) },
+                                  { "description", TO_UTF8( aText ) },
+                                  { "pos", { Iu2Millimeter( aPos.x ),
+                                             Iu2Millimeter( aPos.y ) } } } );
+                      };
+
+    nlohmann::json items = nlohmann::json::array();
+
+    items.push_back( itemToJson( aItem.GetMainItemID(), aItem.GetMainText(),
+                                 aItem.GetMainPosition() ) );
+
+    if( aItem.HasSecondItem() )
+    {
+        items.push_back( itemToJson( aItem.GetAuxItemID(), aItem.GetAuxText(),
+                                     aItem.GetAuxPosition() ) );
+    }
+
+    nlohmann::json violation = {
+        { "code", aItem.GetErrorCode() },
+        { "description", TO_UTF8( aItem.GetErrorText() ) },
+        { "items", items }
+    };
+
+    m_stream << ( m_count ? ",\n    " : "\n    " ) << violation.dump();
+}
+
+
+void DRC_JSON_REPORT_WRITER::End()
+{
+    m_stream << ( m_count ? "\n  ],\n" : "],\n" );
+    m_stream << "  \"count\": " << m_count << "\n}\n";
+    m_stream.flush();
+}
@@ -0,0 +1,129 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_REPORT_WRITER_H
+#define DRC_REPORT_WRITER_H
+
+#include <ostream>
+
+#include <common.h>     // EDA_UNITS
+
+class RC_ITEM;
+
+
+/**
+ * DRC_REPORT_WRITER
+ * streams DRC violations to an output stream as they are found, for headless DRC runs.
+ * Nothing is kept in memory: each item is written when it is received.
+ */
+class DRC_REPORT_WRITER
+{
+public:
+    DRC_REPORT_WRITER( std::ostream& aStream, EDA_UNITS aUnits ) :
+            m_stream( aStream ),
+            m_units( aUnits ),
+            m_count( 0 )
+    {
+    }
+
+    virtual ~DRC_REPORT_WRITER()
+    {
+    }
+
+    /**
+     * Write the report header.
+     * @param aBoardName is the name of the tested board file.
+     */
+    virtual void Begin( const wxString& aBoardName ) = 0;
+
+    /**
+     * Write one violation.
+     */
+    void WriteItem( const RC_ITEM& aItem )
+    {
+        writeItem( aItem );
+        m_count++;
+    }
+
+    /**
+     * Write the report footer, and flush the stream.
+     */
+    virtual void End() = 0;
+
+    /**
+     * @return the number of violations written since the writer creation.
+     */
+    int GetCount() const { return m_count; }
+
+protected:
+    virtual void writeItem( const RC_ITEM& aItem ) = 0;
+
+    std::ostream&   m_stream;
+    EDA_UNITS       m_units;
+    int             m_count;
+};
+
+
+/**
+ * DRC_TEXT_REPORT_WRITER
+ * writes the same text as the report of the DRC dialog.
+ */
+class DRC_TEXT_REPORT_WRITER : public DRC_REPORT_WRITER
+{
+public:
+    DRC_TEXT_REPORT_WRITER( std::ostream& aStream, EDA_UNITS aUnits ) :
+            DRC_REPORT_WRITER( aStream, aUnits )
+    {
+    }
+
+    void Begin( const wxString& aBoardName ) override;
+    void End() override;
+
+protected:
+    void writeItem( const RC_ITEM& aItem ) override;
+};
+
+
+/**
+ * DRC_JSON_REPORT_WRITER
+ * writes a JSON document: { "board": ..., "violations": [ ... ], "count": ... }.
+ * Each violation is an object with its "code", "description" and "items".
+ * Coordinates are in millimeters.
+ */
+class DRC_JSON_REPORT_WRITER : public DRC_REPORT_WRITER
+{
+public:
+    DRC_JSON_REPORT_WRITER( std::ostream& aStream, EDA_UNITS aUnits ) :
+            DRC_REPORT_WRITER( aStream, aUnits )
+    {
+    }
+
+    void Begin( const wxString& aBoardName ) override;
+    void End() override;
+
+protected:
+    void writeItem( const RC_ITEM& aItem ) override;
+};
+
+
+#endif  // DRC_REPORT_WRITER_H
@@ -0,0 +1,131 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE_H
+#define DRC_RTREE_H
+
+#include <algorithm>
+#include <vector>
+
+#include <eda_rect.h>
+#include <geometry/rtree.h>
+
+
+/**
+ * DRC_RTREE -
+ * Implements an R-tree used as the broad phase of the DRC clearance tests.
+ *
+ * Every item is stored along with its insertion rank, and queries return the items in
+ * that order.  This way a test walking the query result visits the items in the same
+ * order as an exhaustive scan of the original list, and reports the same markers.
+ * Non-owning.
+ */
+template< class T >
+class DRC_RTREE
+{
+public:
+    DRC_RTREE()
+    {
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree, using aBBox as its bounding box.
+     */
+    void Insert( T aItem, const EDA_RECT& aBBox )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_tree.Insert( mmin, mmax, (int) m_items.size() );
+        m_items.push_back( aItem );
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the tree.
+     */
+    void RemoveAll()
+    {
+        m_tree.RemoveAll();
+        m_items.clear();
+    }
+
+    /**
+     * Function Size()
+     * @return the number of items inserted in the tree.
+     */
+    int Size() const
+    {
+        return (int) m_items.size();
+    }
+
+    /**
+     * Function Query()
+     * Collects the items whose bounding box intersects aBounds, sorted by insertion order.
+     * Queries do not modify the tree, so they can be run concurrently by several threads.
+     *
+     * @param aBounds is the area to search.
+     * @param aResult receives the items found (it is cleared first).
+     * @param aFirst is the insertion rank of the first item which can be reported; items
+     *               inserted before it are ignored.
+     */
+    void Query( const EDA_RECT& aBounds, std::vector<T>& aResult, int aFirst = 0 )
+    {
+        EDA_RECT  bounds = aBounds;
+        bounds.Normalize();
+
+        const int mmin[2] = { bounds.GetX(), bounds.GetY() };
+        const int mmax[2] = { bounds.GetRight(), bounds.GetBottom() };
+
+        std::vector<int> found;
+
+        auto visitor = [&]( int aRank ) -> bool
+                       {
+                           if( aRank >= aFirst )
+                               found.push_back( aRank );
+
+                           return true;
+                       };
+
+        m_tree.Search( mmin, mmax, visitor );
+
+        std::sort( found.begin(), found.end() );
+
+        aResult.clear();
+        aResult.reserve( found.size() );
+
+        for( int rank : found )
+            aResult.push_back( m_items[rank] );
+    }
+
+private:
+    RTree<int, int, 2, double> m_tree;
+    std::vector<T>             m_items;
+};
+
+
+#endif  // DRC_RTREE_H
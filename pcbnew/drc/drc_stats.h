@@ -0,0 +1,72 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_STATS_H
+#define DRC_STATS_H
+
+#include <wx/string.h>
+
+
+/**
+ * DRC_STAGE_STATS
+ * holds the timing and the counters of one stage of a DRC run.
+ */
+struct DRC_STAGE_STATS
+{
+    DRC_STAGE_STATS( const wxString& aName = wxEmptyString ) :
+            m_name( aName ),
+            m_msecs( 0.0 ),
+            m_items( 0 ),
+            m_pairChecks( 0 ),
+            m_markers( 0 )
+    {
+    }
+
+    /**
+     * Adds the counters of aOther (but not its time, the stages may have run concurrently)
+     */
+    void AddCounts( const DRC_STAGE_STATS& aOther )
+    {
+        m_items += aOther.m_items;
+        m_pairChecks += aOther.m_pairChecks;
+        m_markers += aOther.m_markers;
+    }
+
+    /**
+     * @return a one line summary, suitable for the DRC message pane.
+     */
+    wxString Format() const
+    {
+        return wxString::Format( wxT( "%s: %.1f ms, %ld items, %lld pair checks, %ld markers" ),
+                                 m_name, m_msecs, m_items, m_pairChecks, m_markers );
+    }
+
+    wxString  m_name;           ///< name of the stage
+    double    m_msecs;          ///< wall clock time of the stage
+    long      m_items;          ///< number of board items tested
+    long long m_pairChecks;     ///< number of item pairs tested against each other
+    long      m_markers;        ///< number of markers (or DRC items) emitted
+};
+
+
+#endif  // DRC_STATS_H
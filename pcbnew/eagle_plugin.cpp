@@ -50,7 +50,11 @@ Load() TODO's
 
 */
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <exception>
+#include <memory>
 
 #include <wx/string.h>
 #include <wx/xml/xml.h>
@@ -62,6 +66,7 @@ Load() TODO's
 #include <kicad_string.h>
 #include <macros.h>
 #include <properties.h>
+#include <thread_pool.h>
 #include <trigo.h>
 #include <wx/filename.h>
 #include <math/util.h>      // for KiROUND
@@ -803,24 +808,63 @@ void EAGLE_PLUGIN::loadLibrary( wxXmlNode* aLib, const wxString* aLibName )
     // to instantiate needed MODULES in our BOARD.  Save the MODULE templates in
     // a MODULE_MAP using a single lookup key consisting of libname+pkgname.
 
-    // Get the first package and iterate
-    wxXmlNode* package = packages->GetChildren();
+    // The packages are independent: they are converted in parallel, and then stored in their
+    // order, which also reports the first error of the library as when loading them in turn
+    std::vector<wxXmlNode*> packageNodes;
+    std::vector<wxString>   packageNames;
 
-    while( package )
+    for( wxXmlNode* package = packages->GetChildren(); package; package = package->GetNext() )
     {
-        m_xpath->push( "package", "name" );
-
         wxString pack_ref = package->GetAttribute( "name" );
         ReplaceIllegalFileNameChars( pack_ref, '_' );
 
+        packageNodes.push_back( package );
+        packageNames.push_back( pack_ref );
+    }
+
+    std::vector<std::unique_ptr<MODULE>> modules( packageNodes.size() );
+    std::vector<std::exception_ptr>      errors( packageNodes.size() );
+    std::atomic<size_t>                  nextPackage( 0 );
+
+    auto makeModules =
+            [&]()
+            {
+                for( size_t ii = nextPackage++; ii < packageNodes.size(); ii = nextPackage++ )
+                {
+                    try
+                    {
+                        modules[ii].reset( makeModule( packageNodes[ii], packageNames[ii] ) );
+                    }
+                    catch( ... )
+                    {
+                        errors[ii] = std::current_exception();
+                    }
+                }
+            };
+
+    size_t parallelism = std::min<size_t>( packageNodes.size(),
+                                           GetKiCadThreadPool().GetThreadCount() + 1 );
+
+    if( parallelism <= 1 )
+        makeModules();
+    else
+        GetKiCadThreadPool().RunParallel( makeModules, parallelism );
+
+    for( size_t ii = 0; ii < packageNodes.size(); ii++ )
+    {
+        m_xpath->push( "package", "name" );
+
+        const wxString& pack_ref = packageNames[ii];
+
         m_xpath->Value( pack_ref.ToUTF8() );
 
-        wxString key = aLibName ? makeKey( *aLibName, pack_ref ) : pack_ref;
+        if( errors[ii] )
+            std::rethrow_exception( errors[ii] );
 
-        MODULE* m = makeModule( package, pack_ref );
+        wxString key = aLibName ? makeKey( *aLibName, pack_ref ) : pack_ref;
 
         // add the templating MODULE to the MODULE template factory "m_templates"
-        std::pair<MODULE_ITER, bool> r = m_templates.insert( {key, m} );
+        std::pair<MODULE_ITER, bool> r = m_templates.insert( {key, modules[ii].get()} );
 
         if( !r.second
             // && !( m_props && m_props->Value( "ignore_duplicates" ) )
@@ -837,9 +881,9 @@ void EAGLE_PLUGIN::loadLibrary( wxXmlNode* aLib, const wxString* aLibName )
             THROW_IO_ERROR( emsg );
         }
 
-        m_xpath->pop();
+        modules[ii].release();    // owned by m_templates
 
-        package = package->GetNext();
+        m_xpath->pop();
     }
 
     m_xpath->pop();     // "packages"
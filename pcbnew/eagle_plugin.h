@@ -30,15 +30,16 @@
 #include <eagle_parser.h>
 
 #include <map>
+#include <unordered_map>
 #include <wx/xml/xml.h>
 
 class D_PAD;
 class TEXTE_MODULE;
 
-typedef std::map<wxString, MODULE*>  MODULE_MAP;
-typedef std::vector<ZONE_CONTAINER*> ZONES;
-typedef std::map<wxString, ENET>     NET_MAP;
-typedef NET_MAP::const_iterator      NET_MAP_CITER;
+typedef std::map<wxString, MODULE*>        MODULE_MAP;
+typedef std::vector<ZONE_CONTAINER*>       ZONES;
+typedef std::unordered_map<wxString, ENET> NET_MAP;
+typedef NET_MAP::const_iterator            NET_MAP_CITER;
 
 
 /// subset of eagle.drawing.board.designrules in the XML document
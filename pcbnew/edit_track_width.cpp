@@ -99,8 +99,6 @@ int PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
 
     if( initial_width != new_width || initial_drill != new_drill )
     {
-        OnModify();
-
         if( aItemsListPicker )
         {
             aTrackItem->SetWidth( initial_width );
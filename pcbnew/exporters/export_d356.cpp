@@ -278,9 +278,11 @@ void IPC356D_WRITER::write_D356_records( std::vector <D356_RECORD> &aRecords, FI
 
         if( !rk.netname.empty() )
         {
-            d356_net = d356_net_map[rk.netname];
+            auto it = d356_net_map.find( rk.netname );
 
-            if( d356_net.empty() )
+            if( it != d356_net_map.end() )
+                d356_net = it->second;
+            else
                 d356_net = intern_new_d356_netname( rk.netname, d356_net_map, d356_net_set );
         }
 
@@ -330,21 +332,26 @@ void IPC356D_WRITER::write_D356_records( std::vector <D356_RECORD> &aRecords, FI
 }
 
 
-void IPC356D_WRITER::Write( const wxString& aFilename )
+bool IPC356D_WRITER::Write( const wxString& aFilename )
 {
     FILE*     file = nullptr;
     LOCALE_IO toggle; // Switch the locale to standard C
 
     if( ( file = wxFopen( aFilename, wxT( "wt" ) ) ) == nullptr )
     {
-        wxString details;
-        details.Printf( "The file %s could not be opened for writing", aFilename );
-        DisplayErrorMessage( m_parent, "Could not write IPC-356D file!", details );
-        return;
+        if( m_parent )
+        {
+            wxString details;
+            details.Printf( "The file %s could not be opened for writing", aFilename );
+            DisplayErrorMessage( m_parent, "Could not write IPC-356D file!", details );
+        }
+
+        return false;
     }
 
     // This will contain everything needed for the 356 file
     std::vector<D356_RECORD> d356_records;
+    d356_records.reserve( m_pcb->Tracks().size() + m_pcb->GetPadCount() );
 
     build_via_testpoints( m_pcb, d356_records );
 
@@ -359,6 +366,7 @@ void IPC356D_WRITER::Write( const wxString& aFilename )
     fprintf( file, "999\n" );
 
     fclose( file );
+    return true;
 }
 
 
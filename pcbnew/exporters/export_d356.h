@@ -67,8 +67,10 @@ public:
     /**
      * Generates and writes the netlist to a given path
      * @param aFilename is the full path and name of the output file
+     * @return true if the file was written; when it cannot be, an error is shown only
+     *         if the writer has a parent window
      */
-    void Write( const wxString& aFilename );
+    bool Write( const wxString& aFilename );
 
 private:
     BOARD* m_pcb;
@@ -927,6 +927,21 @@ static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
 
     fputs( "$SIGNALS\n", aFile );
 
+    // Index the pads by net once, in board order, rather than scanning every pad of the
+    // board for each net
+    std::vector<std::vector<std::pair<MODULE*, D_PAD*>>> netPads( aPcb->GetNetCount() );
+
+    for( auto module : aPcb->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            int netcode = pad->GetNetCode();
+
+            if( netcode > 0 && netcode < (int) netPads.size() )
+                netPads[netcode].emplace_back( module, pad );
+        }
+    }
+
     for( unsigned ii = 0; ii < aPcb->GetNetCount(); ii++ )
     {
         net = aPcb->FindNet( ii );
@@ -944,20 +959,17 @@ static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
         fputs( TO_UTF8( msg ), aFile );
         fputs( "\n", aFile );
 
-        for( auto module : aPcb->Modules() )
-        {
-            for( auto pad : module->Pads() )
-            {
-                if( pad->GetNetCode() != net->GetNet() )
-                    continue;
+        if( net->GetNet() >= (int) netPads.size() )
+            continue;
 
-                msg.Printf( wxT( "NODE \"%s\" \"%s\"" ),
-                            GetChars( escapeString( module->GetReference() ) ),
-                            GetChars( escapeString( pad->GetName() ) ) );
+        for( const auto& node : netPads[net->GetNet()] )
+        {
+            msg.Printf( wxT( "NODE \"%s\" \"%s\"" ),
+                        GetChars( escapeString( node.first->GetReference() ) ),
+                        GetChars( escapeString( node.second->GetName() ) ) );
 
-                fputs( TO_UTF8( msg ), aFile );
-                fputs( "\n", aFile );
-            }
+            fputs( TO_UTF8( msg ), aFile );
+            fputs( "\n", aFile );
         }
     }
 
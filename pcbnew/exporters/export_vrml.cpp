@@ -27,7 +27,9 @@
 #include <cmath>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iomanip>
+#include <map>
 #include <vector>
 #include <wx/dir.h>
 
@@ -46,6 +48,7 @@
 #include "pgm_base.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "streamwrapper.h"
+#include <thread_pool.h>
 #include "vrml_layer.h"
 #include "pcb_edit_frame.h"
 
@@ -164,6 +167,10 @@ public:
 
     std::list< SGNODE* > m_components;
 
+    // DEF names of the inline models already written, by model file name; an empty name
+    // marks a model which could not be copied
+    std::map< wxString, std::string > m_inlineModels;
+
     bool m_plainPCB;
 
     double m_minLineWidth;    // minimum width of a VRML line segment
@@ -420,11 +427,44 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 }
 
 
+static void tesselate_layers( MODEL_VRML& aModel )
+{
+    // Each layer has its own tesselator and only reads the shared holes, so the layers
+    // can be tesselated concurrently
+    std::vector< VRML_LAYER* > layers = { &aModel.m_board };
+
+    if( !aModel.m_plainPCB )
+    {
+        layers.insert( layers.end(), { &aModel.m_top_copper, &aModel.m_top_tin,
+                                       &aModel.m_bot_copper, &aModel.m_bot_tin,
+                                       &aModel.m_top_silk, &aModel.m_bot_silk } );
+    }
+
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    std::vector< std::future<void> > tasks;
+
+    for( VRML_LAYER* layer : layers )
+    {
+        tasks.push_back( pool.Submit( [layer, &aModel]()
+                                      {
+                                          layer->Tesselate( &aModel.m_holes );
+                                      } ) );
+    }
+
+    if( !aModel.m_plainPCB )
+        aModel.m_plated_holes.Tesselate( NULL, true );
+
+    for( std::future<void>& task : tasks )
+        task.wait();
+}
+
+
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     const char* aFileName, OSTREAM* aOutputFile )
 {
+    tesselate_layers( aModel );
+
     // VRML_LAYER board;
-    aModel.m_board.Tesselate( &aModel.m_holes );
     double brdz = aModel.m_brd_thickness / 2.0
                   - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * BOARD_SCALE;
 
@@ -447,8 +487,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_copper;
-    aModel.m_top_copper.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
@@ -462,8 +500,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_tin;
-    aModel.m_top_tin.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
@@ -479,8 +515,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_copper;
-    aModel.m_bot_copper.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
@@ -494,8 +528,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_tin;
-    aModel.m_bot_tin.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
@@ -512,8 +544,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER PTH;
-    aModel.m_plated_holes.Tesselate( NULL, true );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
@@ -529,8 +559,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_silk;
-    aModel.m_top_silk.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_top_silk,
@@ -543,8 +571,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_silk;
-    aModel.m_bot_silk.Tesselate( &aModel.m_holes );
-
     if( USE_INLINES )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_bot_silk,
@@ -1435,42 +1461,72 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
 
         if( USE_INLINES )
         {
-            wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
-            wxFileName dstFile;
-            dstFile.SetPath( SUBDIR_3D );
-            dstFile.SetName( srcFile.GetName() );
-            dstFile.SetExt( "wrl"  );
+            // Each model file is copied and defined once; its other instances reuse it
+            auto defIt = aModel.m_inlineModels.find( sM->m_Filename );
+            bool firstInstance = defIt == aModel.m_inlineModels.end();
+            wxString fn;
 
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
+            if( firstInstance )
+            {
+                wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
+                wxFileName dstFile;
+                dstFile.SetPath( SUBDIR_3D );
+                dstFile.SetName( srcFile.GetName() );
+                dstFile.SetExt( "wrl"  );
 
-            destModTime.SetToCurrent();
+                // copy the file if necessary
+                wxDateTime srcModTime = srcFile.GetModificationTime();
+                wxDateTime destModTime = srcModTime;
 
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
+                destModTime.SetToCurrent();
 
-            if( srcModTime != destModTime )
-            {
-                wxLogDebug( "Copying 3D model %s to %s.",
-                            GetChars( srcFile.GetFullPath() ),
-                            GetChars( dstFile.GetFullPath() ) );
+                if( dstFile.FileExists() )
+                    destModTime = dstFile.GetModificationTime();
 
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
+                bool copied = true;
 
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == "wrl" )
+                if( srcModTime != destModTime )
                 {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
-                        continue;
+                    wxLogDebug( "Copying 3D model %s to %s.",
+                                GetChars( srcFile.GetFullPath() ),
+                                GetChars( dstFile.GetFullPath() ) );
+
+                    wxString fileExt = srcFile.GetExt();
+                    fileExt.LowerCase();
+
+                    // copy VRML models and use the scenegraph library to
+                    // translate other model types
+                    if( fileExt == "wrl" )
+                        copied = wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() );
+                    else
+                        copied = S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d,
+                                                 USE_DEFS, true );
                 }
-                else
+
+                std::string defName;
+
+                if( copied )
+                    defName = "KiCadModel" + std::to_string( aModel.m_inlineModels.size() );
+
+                defIt = aModel.m_inlineModels.emplace( sM->m_Filename, defName ).first;
+
+                if( USE_RELPATH )
                 {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, USE_DEFS, true ) )
-                        continue;
+                    wxFileName tmp = dstFile;
+                    tmp.SetExt( "" );
+                    tmp.SetName( "" );
+                    tmp.RemoveLastDir();
+                    dstFile.MakeRelativeTo( tmp.GetPath() );
                 }
+
+                fn = dstFile.GetFullPath();
+                fn.Replace( "\\", "/" );
+            }
+
+            if( defIt->second.empty() )
+            {
+                ++sM;
+                continue;
             }
 
             (*aOutputFile) << "Transform {\n";
@@ -1492,20 +1548,17 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             (*aOutputFile) << sM->m_Scale.y << " ";
             (*aOutputFile) << sM->m_Scale.z << "\n";
 
-            (*aOutputFile) << "  children [\n    Inline {\n      url \"";
-
-            if( USE_RELPATH )
+            if( firstInstance )
+            {
+                (*aOutputFile) << "  children [\n    DEF " << defIt->second;
+                (*aOutputFile) << " Inline {\n      url \"";
+                (*aOutputFile) << TO_UTF8( fn ) << "\"\n    } ]\n";
+            }
+            else
             {
-                wxFileName tmp = dstFile;
-                tmp.SetExt( "" );
-                tmp.SetName( "" );
-                tmp.RemoveLastDir();
-                dstFile.MakeRelativeTo( tmp.GetPath() );
+                (*aOutputFile) << "  children [ USE " << defIt->second << " ]\n";
             }
 
-            wxString fn = dstFile.GetFullPath();
-            fn.Replace( "\\", "/" );
-            (*aOutputFile) << TO_UTF8( fn ) << "\"\n    } ]\n";
             (*aOutputFile) << "  }\n";
         }
         else
@@ -0,0 +1,325 @@
+/**
+ * @file fabrication_outputs.cpp
+ * @brief Generation of the full set of fabrication files of a board in one pass
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
+#include <fctsys.h>
+#include <build_version.h>
+#include <class_board.h>
+#include <common.h>
+#include <kicad_string.h>
+#include <pcbplot.h>
+#include <reporter.h>
+#include <thread_pool.h>
+#include <wildcards_and_files_ext.h>
+#include <widgets/progress_reporter.h>
+
+#include <exporters/export_d356.h>
+#include <exporters/export_footprints_placefile.h>
+#include <exporters/fabrication_outputs.h>
+#include <exporters/gendrill_Excellon_writer.h>
+#include <exporters/gerber_jobfile_writer.h>
+
+
+namespace
+{
+
+/// A writer run on the thread pool, other than the Gerber plot
+struct WRITER_TASK
+{
+    std::function<void( WRITER_TASK& )> m_Run;
+    std::vector<FABRICATION_OUTPUT>     m_Outputs;
+    wxString                            m_Messages;     ///< reported by the writer
+    std::future<void>                   m_Done;
+};
+
+}
+
+
+FABRICATION_OUTPUTS::FABRICATION_OUTPUTS( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts ) :
+        m_board( aBoard ),
+        m_plotOpts( aPlotOpts )
+{
+    m_plotOpts.SetFormat( PLOT_FORMAT::GERBER );
+}
+
+
+bool FABRICATION_OUTPUTS::Run( REPORTER* aReporter, PROGRESS_REPORTER* aProgressReporter )
+{
+    REPORTER&  reporter = aReporter ? *aReporter : NULL_REPORTER::GetInstance();
+    wxString   boardFilename = m_board->GetFileName();
+    wxFileName outputDir = wxFileName::DirName( m_plotOpts.GetOutputDirectory() );
+    wxString   msg;
+
+    m_outputs.clear();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename, &reporter ) )
+    {
+        msg.Printf( _( "Could not write fabrication files to folder \"%s\"." ),
+                    outputDir.GetPath() );
+        reporter.Report( msg, RPT_SEVERITY_ERROR );
+        return false;
+    }
+
+    // The work common to all the writers is done once, here: the C locale is global and
+    // kept until all the writers are done, and the file names are built up front.
+    LOCALE_IO toggle;
+    wxString  outputPath = outputDir.GetPath();
+    wxPoint   offset = m_plotOpts.GetUseAuxOrigin() ? m_board->GetAuxOrigin() : wxPoint( 0, 0 );
+
+    std::vector<PLOT_LAYER_JOB> layerJobs;
+
+    if( m_options.m_Gerbers )
+    {
+        for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
+        {
+            PCB_LAYER_ID layer = *seq;
+
+            // Skip the copper layers which are not enabled on the board
+            if( ( LSET::AllCuMask() & ~m_board->GetEnabledLayers() )[layer] )
+                continue;
+
+            wxFileName fn( boardFilename );
+            wxString   ext = m_plotOpts.GetUseGerberProtelExtensions()
+                                     ? GetGerberProtelExtension( layer )
+                                     : GetDefaultPlotExtension( PLOT_FORMAT::GERBER );
+
+            BuildPlotFileName( &fn, outputPath, m_board->GetLayerName( layer ), ext );
+
+            PLOT_LAYER_JOB job;
+            job.m_Layer = layer;
+            job.m_FullFileName = fn.GetFullPath();
+            layerJobs.push_back( job );
+        }
+    }
+
+    std::vector<WRITER_TASK> tasks;
+    std::atomic<bool>        cancelled( false );
+
+    if( m_options.m_DrillFiles )
+    {
+        tasks.emplace_back();
+        tasks.back().m_Run =
+                [&]( WRITER_TASK& aTask )
+                {
+                    WX_STRING_REPORTER taskReporter( &aTask.m_Messages );
+                    EXCELLON_WRITER    writer( m_board );
+
+                    writer.SetFormat( m_options.m_DrillUnitsMM );
+                    writer.SetOptions( false, false, offset, m_options.m_DrillMergePTH_NPTH );
+                    writer.CreateDrillandMapFilesSet( outputPath, true, false, &taskReporter );
+
+                    for( const wxString& file : writer.GetCreatedDrillFiles() )
+                        aTask.m_Outputs.push_back( { "drill", file, true } );
+                };
+    }
+
+    if( m_options.m_PositionFiles )
+    {
+        tasks.emplace_back();
+        tasks.back().m_Run =
+                [&]( WRITER_TASK& aTask )
+                {
+                    for( bool front : { true, false } )
+                    {
+                        wxFileName fn( boardFilename );
+                        fn.SetPath( outputPath );
+                        std::string side = front ? PLACE_FILE_EXPORTER::GetFrontSideName()
+                                                 : PLACE_FILE_EXPORTER::GetBackSideName();
+
+                        fn.SetName( fn.GetName() + wxT( "-" ) + side.c_str() );
+                        fn.SetExt( FootprintPlaceFileExtension );
+
+                        PLACE_FILE_EXPORTER exporter( m_board, m_options.m_PositionUnitsMM,
+                                                      false, front, !front, false );
+                        std::string data = exporter.GenPositionData();
+                        FILE*       file = wxFopen( fn.GetFullPath(), wxT( "wt" ) );
+
+                        if( file )
+                        {
+                            fputs( data.c_str(), file );
+                            fclose( file );
+                        }
+
+                        aTask.m_Outputs.push_back( { "position", fn.GetFullPath(),
+                                                     file != nullptr } );
+                    }
+                };
+    }
+
+    if( m_options.m_IPC356File )
+    {
+        tasks.emplace_back();
+        tasks.back().m_Run =
+                [&]( WRITER_TASK& aTask )
+                {
+                    wxFileName fn( boardFilename );
+                    fn.SetPath( outputPath );
+                    fn.SetExt( IpcD356FileExtension );
+
+                    IPC356D_WRITER writer( m_board );
+                    bool           created = writer.Write( fn.GetFullPath() );
+
+                    aTask.m_Outputs.push_back( { "ipc356", fn.GetFullPath(), created } );
+                };
+    }
+
+    if( aProgressReporter )
+        aProgressReporter->SetMaxProgress( (int) ( layerJobs.size() + tasks.size() ) );
+
+    // The writers run concurrently with the Gerber plot, which uses the thread pool too
+    THREAD_POOL& pool = GetKiCadThreadPool();
+
+    for( WRITER_TASK& task : tasks )
+    {
+        WRITER_TASK* current = &task;
+
+        task.m_Done = pool.Submit(
+                [&, current]()
+                {
+                    if( !cancelled )
+                        current->m_Run( *current );
+
+                    if( aProgressReporter )
+                        aProgressReporter->AdvanceProgress();
+                } );
+    }
+
+    if( !layerJobs.empty() )
+        PlotBoardLayers( m_board, m_plotOpts, layerJobs, aProgressReporter );
+
+    for( WRITER_TASK& task : tasks )
+    {
+        while( task.m_Done.wait_for( std::chrono::milliseconds( 30 ) )
+               != std::future_status::ready )
+        {
+            if( aProgressReporter && !aProgressReporter->KeepRefreshing() )
+                cancelled = true;
+        }
+    }
+
+    // Collect the outputs, in the order of the manifest
+    for( const PLOT_LAYER_JOB& job : layerJobs )
+        m_outputs.push_back( { "gerber", job.m_FullFileName, job.m_Created } );
+
+    if( m_options.m_Gerbers && m_options.m_GerberJobFile && !layerJobs.empty() )
+    {
+        GERBER_JOBFILE_WRITER jobfileWriter( m_board, &reporter );
+
+        for( const PLOT_LAYER_JOB& job : layerJobs )
+        {
+            wxString name = wxFileName( job.m_FullFileName ).GetFullName();
+
+            if( job.m_Created )
+                jobfileWriter.AddGbrFile( job.m_Layer, name );
+        }
+
+        wxFileName fn( boardFilename );
+        BuildPlotFileName( &fn, outputPath, "job", GerberJobFileExtension );
+
+        bool created = jobfileWriter.CreateJobFile( fn.GetFullPath() );
+        m_outputs.push_back( { "gerber_job", fn.GetFullPath(), created } );
+    }
+
+    for( WRITER_TASK& task : tasks )
+    {
+        if( !task.m_Messages.IsEmpty() )
+            reporter.Report( task.m_Messages, RPT_SEVERITY_INFO );
+
+        m_outputs.insert( m_outputs.end(), task.m_Outputs.begin(), task.m_Outputs.end() );
+    }
+
+    bool success = !cancelled;
+
+    for( const FABRICATION_OUTPUT& output : m_outputs )
+    {
+        if( output.m_Created )
+        {
+            msg.Printf( _( "File \"%s\" created." ), output.m_FullFileName );
+            reporter.Report( msg, RPT_SEVERITY_ACTION );
+        }
+        else
+        {
+            msg.Printf( _( "Unable to create file \"%s\"." ), output.m_FullFileName );
+            reporter.Report( msg, RPT_SEVERITY_ERROR );
+            success = false;
+        }
+    }
+
+    if( m_options.m_Manifest )
+    {
+        wxFileName fn( boardFilename );
+        BuildPlotFileName( &fn, outputPath, "fab-manifest", "txt" );
+
+        if( writeManifest( outputPath, fn.GetFullPath() ) )
+        {
+            msg.Printf( _( "Manifest \"%s\" created." ), fn.GetFullPath() );
+            reporter.Report( msg, RPT_SEVERITY_ACTION );
+        }
+        else
+        {
+            msg.Printf( _( "Unable to create file \"%s\"." ), fn.GetFullPath() );
+            reporter.Report( msg, RPT_SEVERITY_ERROR );
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+
+bool FABRICATION_OUTPUTS::writeManifest( const wxString& aOutputDir,
+                                         const wxString& aFullFileName )
+{
+    FILE* file = wxFopen( aFullFileName, wxT( "wt" ) );
+
+    if( !file )
+        return false;
+
+    fprintf( file, "# Fabrication files of %s\n",
+             TO_UTF8( wxFileName( m_board->GetFileName() ).GetFullName() ) );
+    fprintf( file, "# Created on %s by Pcbnew %s\n",
+             TO_UTF8( DateAndTime() ), TO_UTF8( GetBuildVersion() ) );
+
+    for( const FABRICATION_OUTPUT& output : m_outputs )
+    {
+        if( !output.m_Created )
+            continue;
+
+        wxFileName fn( output.m_FullFileName );
+        fn.MakeRelativeTo( aOutputDir );
+
+        fprintf( file, "%s %s\n", TO_UTF8( output.m_Kind ), TO_UTF8( fn.GetFullPath() ) );
+    }
+
+    fclose( file );
+    return true;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file fabrication_outputs.h
+ * @brief Generation of the full set of fabrication files of a board in one pass
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FABRICATION_OUTPUTS_H
+#define FABRICATION_OUTPUTS_H
+
+#include <vector>
+
+#include <pcb_plot_params.h>
+
+class BOARD;
+class PROGRESS_REPORTER;
+class REPORTER;
+
+
+/**
+ * The fabrication files to create, and the options of the writers which are not part of
+ * the plot options
+ */
+struct FABRICATION_OUTPUTS_OPTIONS
+{
+    bool m_Gerbers = true;              ///< the layers selected in the plot options
+    bool m_GerberJobFile = true;        ///< the job file describing the Gerber files
+    bool m_DrillFiles = true;           ///< Excellon drill files
+    bool m_DrillUnitsMM = true;
+    bool m_DrillMergePTH_NPTH = false;
+    bool m_PositionFiles = true;        ///< front and back footprint position files
+    bool m_PositionUnitsMM = true;
+    bool m_IPC356File = true;           ///< IPC-D-356 netlist
+    bool m_Manifest = true;             ///< list of the created files
+};
+
+
+/**
+ * A file created, or which could not be created, by FABRICATION_OUTPUTS::Run()
+ */
+struct FABRICATION_OUTPUT
+{
+    wxString m_Kind;            ///< "gerber", "gerber_job", "drill", "position" or "ipc356"
+    wxString m_FullFileName;
+    bool     m_Created;
+};
+
+
+/**
+ * FABRICATION_OUTPUTS
+ * creates the Gerber, drill, position and IPC-D-356 files of a board in a single pass.
+ *
+ * The work common to the writers is done once, then the writers run concurrently on the
+ * thread pool, the Gerber layers being plotted by PlotBoardLayers().  The board is only
+ * read: its zones must be filled beforehand, and it must not be modified until Run()
+ * returns.  Especially useful in Python scripts.
+ */
+class FABRICATION_OUTPUTS
+{
+public:
+    /**
+     * @param aBoard is the board
+     * @param aPlotOpts are the plot options of the Gerber files (the format is forced to
+     * Gerber); their output directory and auxiliary origin option are used by all the files
+     */
+    FABRICATION_OUTPUTS( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts );
+
+    void SetOptions( const FABRICATION_OUTPUTS_OPTIONS& aOptions ) { m_options = aOptions; }
+
+    /**
+     * Create the files
+     * @param aReporter = an optional reporter, for the messages of the writers.  It is only
+     *                    used from the calling thread
+     * @param aProgressReporter = an optional progress reporter, advanced once per Gerber
+     *                            layer and once per other writer; cancelling it skips the
+     *                            outputs not yet started
+     * @return true if all the files were created
+     */
+    bool Run( REPORTER* aReporter = nullptr, PROGRESS_REPORTER* aProgressReporter = nullptr );
+
+    /// @return the files of the last Run(), in the order of the manifest
+    const std::vector<FABRICATION_OUTPUT>& GetOutputs() const { return m_outputs; }
+
+private:
+    /// Write the list of the created files, relative to the output directory
+    bool writeManifest( const wxString& aOutputDir, const wxString& aFullFileName );
+
+    BOARD*                          m_board;
+    PCB_PLOT_PARAMS                 m_plotOpts;
+    FABRICATION_OUTPUTS_OPTIONS     m_options;
+    std::vector<FABRICATION_OUTPUT> m_outputs;
+};
+
+#endif  // FABRICATION_OUTPUTS_H
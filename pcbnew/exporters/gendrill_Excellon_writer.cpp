@@ -84,6 +84,8 @@ void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
     wxFileName  fn;
     wxString    msg;
 
+    m_createdDrillFiles.clear();
+
     std::vector<DRILL_LAYER_PAIR> hole_sets = getUniqueLayerPairs();
 
     // append a pair representing the NPTH set of holes, for separate drill files.
@@ -131,6 +133,7 @@ void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
                 }
 
                 createDrillFile( file, pair, doing_npth );
+                m_createdDrillFiles.push_back( fullFilename );
             }
         }
     }
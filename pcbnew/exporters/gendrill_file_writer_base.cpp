@@ -24,6 +24,11 @@
  */
 #include <fctsys.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
@@ -83,12 +88,16 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
     // build hole list for vias
     if( ! aGenerateNPTH_list )  // vias are always plated !
     {
-        for( auto track : m_pcb->Tracks() )
-        {
-            if( track->Type() != PCB_VIA_T )
-                continue;
+        static const std::vector<VIA*> noVias;
+
+        const std::map<DRILL_LAYER_PAIR, std::vector<VIA*>>& viaIndex = getViaIndex();
+        auto pairVias = viaIndex.find( aLayerPair );
 
-            auto via = static_cast<VIA*>( track );
+        const std::vector<VIA*>& vias = pairVias != viaIndex.end() ? pairVias->second : noVias;
+        m_holeListBuffer.reserve( vias.size() );
+
+        for( VIA* via : vias )
+        {
             int hole_sz = via->GetDrillValue();
 
             if( hole_sz == 0 )   // Should not occur.
@@ -104,14 +113,9 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
             new_hole.m_Hole_Shape = 0;              // hole shape: round
             new_hole.m_Hole_Pos = via->GetStart();
 
-            via->LayerPair( &new_hole.m_Hole_Top_Layer, &new_hole.m_Hole_Bottom_Layer );
-
-            // LayerPair() returns params with m_Hole_Bottom_Layer > m_Hole_Top_Layer
-            // Remember: top layer = 0 and bottom layer = 31 for through hole vias
-            // Any captured via should be from aLayerPair.first to aLayerPair.second exactly.
-            if( new_hole.m_Hole_Top_Layer    != aLayerPair.first ||
-                new_hole.m_Hole_Bottom_Layer != aLayerPair.second )
-                continue;
+            // The index has the vias from aLayerPair.first to aLayerPair.second exactly.
+            new_hole.m_Hole_Top_Layer    = aLayerPair.first;
+            new_hole.m_Hole_Bottom_Layer = aLayerPair.second;
 
             m_holeListBuffer.push_back( new_hole );
         }
@@ -159,6 +163,8 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
     // Sort holes per increasing diameter value
     sort( m_holeListBuffer.begin(), m_holeListBuffer.end(), CmpHoleSorting );
 
+    removeDuplicateHoles();
+
     // build the tool list
     int last_hole = -1;     // Set to not initialized (this is a value not used
                             // for m_holeListBuffer[ii].m_Hole_Diameter)
@@ -191,37 +197,404 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
         if( m_holeListBuffer[ii].m_Hole_Shape )
             m_toolListBuffer.back().m_OvalCount++;
     }
+
+    if( m_optimizeHolesOrder )
+        optimizeHolesOrder();
 }
 
 
-std::vector<DRILL_LAYER_PAIR> GENDRILL_WRITER_BASE::getUniqueLayerPairs() const
+/* Hash of the holes drilled identically: same place, same tool, same shape
+ */
+struct HOLE_INFO_HASH
 {
-    wxASSERT( m_pcb );
+    size_t operator()( const HOLE_INFO* aHole ) const
+    {
+        size_t seed = std::hash<int>()( aHole->m_Hole_Pos.x );
+        seed ^= std::hash<int>()( aHole->m_Hole_Pos.y ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+        seed ^= std::hash<int>()( aHole->m_Hole_Diameter ) + 0x9e3779b9 + ( seed << 6 )
+                + ( seed >> 2 );
+        return seed;
+    }
+};
 
-    static const KICAD_T interesting_stuff_to_collect[] = {
-        PCB_VIA_T,
-        EOT
-    };
 
-    PCB_TYPE_COLLECTOR  vias;
+struct HOLE_INFO_EQUAL
+{
+    bool operator()( const HOLE_INFO* a, const HOLE_INFO* b ) const
+    {
+        return a->m_Hole_Pos == b->m_Hole_Pos && a->m_Hole_Diameter == b->m_Hole_Diameter
+               && a->m_Hole_NotPlated == b->m_Hole_NotPlated
+               && a->m_Hole_Shape == b->m_Hole_Shape && a->m_Hole_Size == b->m_Hole_Size
+               && ( !a->m_Hole_Shape || a->m_Hole_Orient == b->m_Hole_Orient );
+    }
+};
 
-    vias.Collect( m_pcb, interesting_stuff_to_collect );
 
-    std::set< DRILL_LAYER_PAIR >  unique;
+void GENDRILL_WRITER_BASE::removeDuplicateHoles()
+{
+    // A pad and a via, or stacked pads, can have the same hole: drilling it twice is useless
+    // (and hard on the tool)
+    std::unordered_set<const HOLE_INFO*, HOLE_INFO_HASH, HOLE_INFO_EQUAL> drilled;
+    drilled.reserve( m_holeListBuffer.size() );
 
-    DRILL_LAYER_PAIR  layer_pair;
+    size_t kept = 0;
 
-    for( int i = 0; i < vias.GetCount(); ++i )
+    for( size_t ii = 0; ii < m_holeListBuffer.size(); ii++ )
     {
-        VIA*  v = (VIA*) vias[i];
+        if( !drilled.insert( &m_holeListBuffer[ii] ).second )
+            continue;
+
+        // The holes are moved down: the ones already in the set are never moved again
+        if( kept != ii )
+        {
+            drilled.erase( &m_holeListBuffer[ii] );
+            m_holeListBuffer[kept] = m_holeListBuffer[ii];
+            drilled.insert( &m_holeListBuffer[kept] );
+        }
+
+        kept++;
+    }
+
+    m_holeListBuffer.resize( kept );
+}
+
+
+/* A uniform grid over a set of hole positions, to find the nearest ones quickly
+ */
+class HOLE_GRID
+{
+public:
+    HOLE_GRID( const std::vector<wxPoint>& aPoints )
+    {
+        int xmin = std::numeric_limits<int>::max();
+        int ymin = xmin;
+        int xmax = std::numeric_limits<int>::min();
+        int ymax = xmax;
+
+        for( const wxPoint& pt : aPoints )
+        {
+            xmin = std::min( xmin, pt.x );
+            ymin = std::min( ymin, pt.y );
+            xmax = std::max( xmax, pt.x );
+            ymax = std::max( ymax, pt.y );
+        }
+
+        // About one point per cell
+        double width = std::max( 1.0, (double) xmax - xmin );
+        double height = std::max( 1.0, (double) ymax - ymin );
+
+        m_cellSize = std::max( 1.0, std::sqrt( width * height / aPoints.size() ) );
+        m_origin = wxPoint( xmin, ymin );
+        m_cols = std::min( 4096, (int) ( width / m_cellSize ) + 1 );
+        m_rows = std::min( 4096, (int) ( height / m_cellSize ) + 1 );
+        m_cellSize = std::max( width / m_cols, height / m_rows ) * 1.0001;
+
+        // Points sorted by cell (counting sort)
+        m_cellStart.assign( m_cols * m_rows + 1, 0 );
+
+        for( const wxPoint& pt : aPoints )
+            m_cellStart[ cellIndex( pt ) + 1 ]++;
+
+        for( size_t ii = 1; ii < m_cellStart.size(); ii++ )
+            m_cellStart[ii] += m_cellStart[ii - 1];
 
-        v->LayerPair( &layer_pair.first, &layer_pair.second );
+        m_cellItems.resize( aPoints.size() );
+        std::vector<int> fill( m_cellStart.begin(), m_cellStart.end() - 1 );
+
+        for( size_t ii = 0; ii < aPoints.size(); ii++ )
+            m_cellItems[ fill[ cellIndex( aPoints[ii] ) ]++ ] = ii;
+
+        m_alive.assign( aPoints.size(), true );
+    }
+
+    void Remove( int aItem ) { m_alive[aItem] = false; }
+
+    /**
+     * Visit the alive points in the order of the rings of cells around aPos, up to the ring
+     * where aVisitor says the nearest points are all visited.
+     * @param aVisitor is called with each point index, and with -1 at the end of each ring
+     * with the distance from aPos to the next ring: returns false to stop
+     */
+    template <typename VISITOR>
+    void Visit( const wxPoint& aPos, VISITOR aVisitor ) const
+    {
+        int col, row;
+        cellOf( aPos, col, row );
+
+        int maxRing = std::max( std::max( col, m_cols - 1 - col ), std::max( row, m_rows - 1 - row ) );
+
+        for( int ring = 0; ring <= maxRing; ring++ )
+        {
+            for( int r = row - ring; r <= row + ring; r++ )
+            {
+                if( r < 0 || r >= m_rows )
+                    continue;
+
+                bool edgeRow = ( r == row - ring || r == row + ring );
+                int  step = edgeRow ? 1 : 2 * ring;
+
+                for( int c = col - ring; c <= col + ring; c += std::max( step, 1 ) )
+                {
+                    if( c < 0 || c >= m_cols )
+                        continue;
+
+                    int cell = r * m_cols + c;
+
+                    for( int ii = m_cellStart[cell]; ii < m_cellStart[cell + 1]; ii++ )
+                    {
+                        if( m_alive[ m_cellItems[ii] ] )
+                            aVisitor( m_cellItems[ii], 0.0 );
+                    }
+                }
+            }
+
+            // The points of the next ring are at least at this distance
+            if( !aVisitor( -1, ring * m_cellSize ) )
+                break;
+        }
+    }
+
+private:
+    void cellOf( const wxPoint& aPos, int& aCol, int& aRow ) const
+    {
+        aCol = (int) ( ( (double) aPos.x - m_origin.x ) / m_cellSize );
+        aRow = (int) ( ( (double) aPos.y - m_origin.y ) / m_cellSize );
+        aCol = std::max( 0, std::min( m_cols - 1, aCol ) );
+        aRow = std::max( 0, std::min( m_rows - 1, aRow ) );
+    }
+
+    int cellIndex( const wxPoint& aPos ) const
+    {
+        int col, row;
+        cellOf( aPos, col, row );
+        return row * m_cols + col;
+    }
+
+    wxPoint           m_origin;
+    double            m_cellSize;
+    int               m_cols;
+    int               m_rows;
+    std::vector<int>  m_cellStart;      // first item of each cell in m_cellItems
+    std::vector<int>  m_cellItems;
+    std::vector<bool> m_alive;
+};
+
+
+static double holeDistance( const wxPoint& a, const wxPoint& b )
+{
+    return std::hypot( (double) a.x - b.x, (double) a.y - b.y );
+}
+
+
+/* Order the holes of aPoints in a short drill path starting near aStart:
+ * nearest neighbour path, improved by 2-opt moves between near holes.
+ * @return the new order of the holes
+ */
+static std::vector<int> shortDrillPath( const std::vector<wxPoint>& aPoints, const wxPoint& aStart )
+{
+    const int n = aPoints.size();
+    HOLE_GRID grid( aPoints );
+
+    // The candidates of the 2-opt moves: the nearest holes of each hole
+    const int neighbourCount = 8;
+    std::vector<std::vector<int>> neighbours( n );
+
+    for( int ii = 0; ii < n; ii++ )
+    {
+        std::vector<std::pair<double, int>> found;
+
+        grid.Visit( aPoints[ii],
+                [&]( int aItem, double aNextRing ) -> bool
+                {
+                    if( aItem < 0 )
+                    {
+                        return (int) found.size() < neighbourCount + 1
+                               || found[neighbourCount].first > aNextRing;
+                    }
 
+                    found.emplace_back( holeDistance( aPoints[ii], aPoints[aItem] ), aItem );
+                    std::sort( found.begin(), found.end() );
+
+                    if( (int) found.size() > neighbourCount + 1 )
+                        found.pop_back();
+
+                    return true;
+                } );
+
+        for( const std::pair<double, int>& candidate : found )
+        {
+            if( candidate.second != ii )
+                neighbours[ii].push_back( candidate.second );
+        }
+    }
+
+    // Greedy path: always drill the nearest hole not yet drilled
+    std::vector<int> order;
+    order.reserve( n );
+    wxPoint current = aStart;
+
+    for( int step = 0; step < n; step++ )
+    {
+        int    best = -1;
+        double bestDist = std::numeric_limits<double>::max();
+
+        grid.Visit( current,
+                [&]( int aItem, double aNextRing ) -> bool
+                {
+                    if( aItem < 0 )
+                        return best < 0 || bestDist > aNextRing;
+
+                    double dist = holeDistance( current, aPoints[aItem] );
+
+                    if( dist < bestDist )
+                    {
+                        bestDist = dist;
+                        best = aItem;
+                    }
+
+                    return true;
+                } );
+
+        order.push_back( best );
+        grid.Remove( best );
+        current = aPoints[best];
+    }
+
+    // 2-opt: replace the edges (a,b) and (c,d) of the path by (a,c) and (b,d) when shorter,
+    // by reversing the path from b to c.  Long reversals are skipped to bound the time.
+    const int maxReversal = 1000;
+    const int maxPasses = 10;
+    std::vector<int> pos( n );
+
+    for( int ii = 0; ii < n; ii++ )
+        pos[ order[ii] ] = ii;
+
+    auto dist = [&]( int a, int b ) { return holeDistance( aPoints[a], aPoints[b] ); };
+
+    for( int pass = 0; pass < maxPasses; pass++ )
+    {
+        bool improved = false;
+
+        for( int i = 0; i < n - 1; i++ )
+        {
+            int a = order[i];
+            int b = order[i + 1];
+
+            for( int c : neighbours[a] )
+            {
+                int j = pos[c];
+
+                if( j <= i + 1 || j - i > maxReversal )
+                    continue;
+
+                // The end of the path has no next hole
+                double gain = dist( a, b ) - dist( a, c );
+
+                if( j < n - 1 )
+                {
+                    int d = order[j + 1];
+                    gain += dist( c, d ) - dist( b, d );
+                }
+
+                if( gain > 1.0 )
+                {
+                    std::reverse( order.begin() + i + 1, order.begin() + j + 1 );
+
+                    for( int k = i + 1; k <= j; k++ )
+                        pos[ order[k] ] = k;
+
+                    improved = true;
+                    b = order[i + 1];
+                }
+            }
+        }
+
+        if( !improved )
+            break;
+    }
+
+    return order;
+}
+
+
+void GENDRILL_WRITER_BASE::optimizeHolesOrder()
+{
+    wxPoint current( 0, 0 );
+
+    // The holes of each tool are consecutive: reorder each range
+    for( size_t first = 0; first < m_holeListBuffer.size(); )
+    {
+        size_t last = first;
+
+        while( last < m_holeListBuffer.size()
+                && m_holeListBuffer[last].m_Tool_Reference
+                        == m_holeListBuffer[first].m_Tool_Reference )
+        {
+            last++;
+        }
+
+        std::vector<wxPoint> points;
+        points.reserve( last - first );
+
+        for( size_t ii = first; ii < last; ii++ )
+            points.push_back( m_holeListBuffer[ii].m_Hole_Pos );
+
+        std::vector<int>       order = shortDrillPath( points, current );
+        std::vector<HOLE_INFO> reordered;
+        reordered.reserve( order.size() );
+
+        for( int ii : order )
+            reordered.push_back( m_holeListBuffer[first + ii] );
+
+        std::copy( reordered.begin(), reordered.end(), m_holeListBuffer.begin() + first );
+
+        // The next tool starts where this one ends
+        current = m_holeListBuffer[last - 1].m_Hole_Pos;
+        first = last;
+    }
+}
+
+
+const std::map<DRILL_LAYER_PAIR, std::vector<VIA*>>& GENDRILL_WRITER_BASE::getViaIndex() const
+{
+    if( !m_viaIndexUpToDate )
+    {
+        m_viaIndex.clear();
+
+        for( auto track : m_pcb->Tracks() )
+        {
+            if( track->Type() != PCB_VIA_T )
+                continue;
+
+            VIA*             via = static_cast<VIA*>( track );
+            DRILL_LAYER_PAIR layer_pair;
+
+            // LayerPair() returns params with second > first
+            // Remember: top layer = 0 and bottom layer = 31 for through hole vias
+            via->LayerPair( &layer_pair.first, &layer_pair.second );
+            m_viaIndex[ layer_pair ].push_back( via );
+        }
+
+        m_viaIndexUpToDate = true;
+    }
+
+    return m_viaIndex;
+}
+
+
+std::vector<DRILL_LAYER_PAIR> GENDRILL_WRITER_BASE::getUniqueLayerPairs() const
+{
+    wxASSERT( m_pcb );
+
+    std::set< DRILL_LAYER_PAIR >  unique;
+
+    for( const auto& pairVias : getViaIndex() )
+    {
         // only make note of blind buried.
         // thru hole is placed unconditionally as first in fetched list.
-        if( layer_pair != DRILL_LAYER_PAIR( F_Cu, B_Cu ) )
+        if( pairVias.first != DRILL_LAYER_PAIR( F_Cu, B_Cu ) )
         {
-            unique.insert( layer_pair );
+            unique.insert( pairVias.first );
         }
     }
 
@@ -29,9 +29,11 @@
 #ifndef GENDRILL_FILE_WRITER_BASE_H
 #define GENDRILL_FILE_WRITER_BASE_H
 
+#include <map>
 #include <vector>
 
 class BOARD_ITEM;
+class VIA;
 
 
 // the DRILL_TOOL class  handles tools used in the excellon drill file:
@@ -143,9 +145,18 @@ protected:
                                                         // Excellon/Gerber units (i.e inches or mm)
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizeHolesOrder;      // True to shorten the drill path
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
+    // The vias of the board by layer pair, built on the first use: the board must not be
+    // modified during the life of the writer
+    mutable std::map<DRILL_LAYER_PAIR, std::vector<VIA*>> m_viaIndex;
+    mutable bool             m_viaIndexUpToDate;
+
+    std::vector<wxString>    m_createdDrillFiles;       // Drill files created by the last
+                                                        // CreateDrillandMapFilesSet()
+
     PLOT_FORMAT m_mapFileFmt;                           // the format of the map drill file,
                                                         // if this map is needed
     const PAGE_INFO*         m_pageInfo;                // the page info used to plot drill maps
@@ -161,6 +172,8 @@ protected:
         m_pageInfo        = NULL;
         m_merge_PTH_NPTH  = false;
         m_zeroFormat      = DECIMAL_FORMAT;
+        m_optimizeHolesOrder = false;
+        m_viaIndexUpToDate = false;
     }
 
 public:
@@ -175,6 +188,19 @@ public:
      */
     void SetMergeOption( bool aMerge ) { m_merge_PTH_NPTH = aMerge; }
 
+    /**
+     * set the option to order the holes of each tool for a short drill path
+     * (nearest neighbour path, improved by 2-opt moves) instead of by position
+     * @param aOptimize = true to optimize the path of the drill
+     */
+    void SetOptimizeHolesOrder( bool aOptimize ) { m_optimizeHolesOrder = aOptimize; }
+
+    /**
+     * @return the full names of the drill files created by the last call to
+     * CreateDrillandMapFilesSet()
+     */
+    const std::vector<wxString>& GetCreatedDrillFiles() const { return m_createdDrillFiles; }
+
     /**
      * Return the plot offset (usually the position
      * of the auxiliary axis
@@ -296,6 +322,20 @@ protected:
 
     int  getHolesCount() const { return m_holeListBuffer.size(); }
 
+    /**
+     * Remove the holes drilled twice (same position, tool and shape) from the sorted
+     * m_holeListBuffer, like a via in a pad hole
+     */
+    void removeDuplicateHoles();
+
+    /**
+     * Reorder the holes of each tool of m_holeListBuffer for a short drill path
+     */
+    void optimizeHolesOrder();
+
+    /// @return the vias of the board by layer pair (see m_viaIndex)
+    const std::map<DRILL_LAYER_PAIR, std::vector<VIA*>>& getViaIndex() const;
+
     /** Helper function.
      * Writes the drill marks in HPGL, POSTSCRIPT or other supported formats
      * Each hole size has a symbol (circle, cross X, cross + ...) up to
@@ -70,6 +70,8 @@ void GERBER_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
     wxFileName  fn;
     wxString    msg;
 
+    m_createdDrillFiles.clear();
+
     std::vector<DRILL_LAYER_PAIR> hole_sets = getUniqueLayerPairs();
 
     // append a pair representing the NPTH set of holes, for separate drill files.
@@ -114,6 +116,8 @@ void GERBER_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
                         msg.Printf( _( "Create file %s\n" ), fullFilename );
                         aReporter->Report( msg );
                     }
+
+                    m_createdDrillFiles.push_back( fullFilename );
                 }
 
             }
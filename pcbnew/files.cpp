@@ -24,6 +24,9 @@
  */
 
 #include <fctsys.h>
+#include <advanced_config.h>
+#include <background_file_writer.h>
+#include <board_snapshot.h>
 #include <confirm.h>
 #include <kicad_string.h>
 #include <gestfich.h>
@@ -44,6 +47,7 @@
 #include <pcbnew.h>
 #include <pcbnew_id.h>
 #include <io_mgr.h>
+#include <kicad_plugin.h>
 #include <wildcards_and_files_ext.h>
 
 #include <class_board.h>
@@ -52,6 +56,7 @@
 #include <wx/stdpaths.h>
 #include <pcb_layer_widget.h>
 #include <wx/wupdlock.h>
+#include <zone_fill_cache.h>
 
 
 //#define     USE_INSTRUMENTATION     1
@@ -525,7 +530,12 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             unsigned startTime = GetRunningMicroSecs();
 #endif
 
-            loadedBoard = pi->Load( fullFileName, NULL, &props );
+            // A snapshot written with the board file saves parsing most of it
+            if( ADVANCED_CFG::GetCfg().m_boardSnapshot && pluginType == IO_MGR::KICAD_SEXP )
+                loadedBoard = BOARD_SNAPSHOT::Load( fullFileName );
+
+            if( !loadedBoard )
+                loadedBoard = pi->Load( fullFileName, NULL, &props );
 
 #if USE_INSTRUMENTATION
             unsigned stopTime = GetRunningMicroSecs();
@@ -622,6 +632,10 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
     Compile_Ratsnest( true );
     GetBoard()->BuildConnectivity();
 
+    // Get back the zone fills of the previous sessions, if they are kept
+    if( ZONE_FILL_CACHE* fillCache = GetZoneFillCache() )
+        fillCache->Load( ZONE_FILL_CACHE::GetCacheFileName( GetBoard()->GetFileName() ) );
+
     onBoardLoaded();
 
     // Refresh the 3D view, if any
@@ -759,7 +773,23 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( aCreateBackupFile )
         UpdateFileHistory( GetBoard()->GetFileName() );
 
-    // Delete auto save file on successful save.
+    // Keep the zone fills for the next session.  Not done for the autosave files.
+    ZONE_FILL_CACHE* fillCache = GetZoneFillCache();
+
+    if( fillCache && aCreateBackupFile )
+    {
+        fillCache->Update( GetBoard() );
+        fillCache->Save( ZONE_FILL_CACHE::GetCacheFileName( pcbFileName.GetFullPath() ) );
+    }
+
+    // Write the snapshot used to reopen the board quickly.  Not done for the autosave files.
+    if( ADVANCED_CFG::GetCfg().m_boardSnapshot && aCreateBackupFile )
+        BOARD_SNAPSHOT::Save( GetBoard(), pcbFileName.GetFullPath() );
+
+    // Delete auto save file on successful save, once it is written.
+    if( m_autoSaveWriter )
+        m_autoSaveWriter->Wait();
+
     wxFileName autoSaveFileName = pcbFileName;
 
     autoSaveFileName.SetName( GetAutoSaveFilePrefix() + pcbFileName.GetName() );
@@ -866,18 +896,41 @@ bool PCB_EDIT_FRAME::doAutoSave()
 
     wxLogTrace( traceAutoSave, "Creating auto save file <" + autoSaveFileName.GetFullPath() + ">" );
 
-    if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE ) )
+    // The board is formatted here, as it can change as soon as this returns, but the file is
+    // written on a background thread: the editor does not wait for the disk.
+    GetBoard()->SynchronizeNetsAndNetClasses();
+    SetCurrentNetClass( NETCLASS::Default );
+
+    std::string content;
+
+    try
     {
-        GetScreen()->SetModify();
-        GetBoard()->SetFileName( tmpFileName.GetFullPath() );
-        UpdateTitle();
-        m_autoSaveState = false;
-        return true;
+        PCB_IO pi;
+
+        content = pi.FormatBoardFile( GetBoard() );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceAutoSave, "Cannot format the auto save file: " + ioe.What() );
+        return false;
     }
 
-    GetBoard()->SetFileName( tmpFileName.GetFullPath() );
+    if( !m_autoSaveWriter )
+        m_autoSaveWriter.reset( new BACKGROUND_FILE_WRITER );
 
-    return false;
+    // The failures of the previous auto save are only reported now
+    if( !m_autoSaveWriter->IsBusy() && !m_autoSaveWriter->Wait() )
+    {
+        wxString msg = wxString::Format( _( "Error saving auto save file \"%s\"." ),
+                                         autoSaveFileName.GetFullPath() );
+        AppendMsgPanel( wxEmptyString, msg, CYAN );
+    }
+
+    m_autoSaveWriter->Write( autoSaveFileName.GetFullPath(), std::move( content ) );
+    UpdateTitle();
+    m_autoSaveState = false;
+
+    return true;
 }
 
 
@@ -32,12 +32,14 @@
 #include <kiface_ids.h>
 #include <kiway.h>
 #include <lib_id.h>
+#include <lib_index.h>
 #include <macros.h>
 #include <pgm_base.h>
+#include <thread_pool.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
-#include <thread>
+#include <algorithm>
 #include <mutex>
 
 
@@ -98,10 +100,10 @@ bool FOOTPRINT_LIST_IMPL::CatchErrors( const std::function<void()>& aFunc )
 
 void FOOTPRINT_LIST_IMPL::loader_job()
 {
-    wxString nickname;
-
-    while( m_queue_in.pop( nickname ) && !m_cancelled )
+    for( size_t ii = m_next_lib++; ii < m_stale_libs.size() && !m_cancelled; ii = m_next_lib++ )
     {
+        const wxString& nickname = m_stale_libs[ii];
+
         CatchErrors( [this, &nickname]() {
             m_lib_table->PrefetchLib( nickname );
             m_queue_out.push( nickname );
@@ -118,11 +120,52 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
                                               PROGRESS_REPORTER* aProgressReporter )
 {
-    long long int generatedTimestamp = aTable->GenerateTimestamp( aNickname );
+    std::vector<wxString>         nicknames;
+    std::map<wxString, long long> timestamps;
+    long long int                 generatedTimestamp = 0;
+
+    if( aNickname )
+        nicknames.push_back( *aNickname );
+    else
+        nicknames = aTable->GetLogicalLibs();
+
+    // The timestamp of the table is the sum of the ones of its libraries
+    for( const wxString& nickname : nicknames )
+    {
+        timestamps[nickname] = aTable->GenerateTimestamp( &nickname );
+        generatedTimestamp += timestamps[nickname];
+    }
 
     if( generatedTimestamp == m_list_timestamp )
         return true;
 
+    // Keep the footprints of the libraries which did not change, and load the other ones
+    m_stale_libs.clear();
+
+    for( const wxString& nickname : nicknames )
+    {
+        auto it = m_lib_timestamps.find( nickname );
+
+        if( it == m_lib_timestamps.end() || it->second != timestamps[nickname] )
+            m_stale_libs.push_back( nickname );
+    }
+
+    FPILIST kept;
+
+    for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+    {
+        const wxString& nickname = fpinfo->GetLibNickname();
+
+        if( timestamps.count( nickname )
+                && std::find( m_stale_libs.begin(), m_stale_libs.end(), nickname )
+                        == m_stale_libs.end() )
+        {
+            kept.push_back( std::move( fpinfo ) );
+        }
+    }
+
+    m_list = std::move( kept );
+
     m_progress_reporter = aProgressReporter;
     m_cancelled = false;
 
@@ -133,7 +176,7 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
 
     if( m_progress_reporter )
     {
-        m_progress_reporter->SetMaxProgress( m_queue_in.size() );
+        m_progress_reporter->SetMaxProgress( m_stale_libs.size() );
         m_progress_reporter->Report( _( "Fetching Footprint Libraries" ) );
     }
 
@@ -165,9 +208,15 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
     }
 
     if( m_cancelled )
+    {
         m_list_timestamp = 0;       // God knows what we got before we were cancelled
+        m_lib_timestamps.clear();
+    }
     else
+    {
         m_list_timestamp = generatedTimestamp;
+        m_lib_timestamps = timestamps;
+    }
 
     return m_errors.empty();
 }
@@ -179,43 +228,42 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_loader = aLoader;
     m_lib_table = aTable;
 
-    // Clear data before reading files
+    // Clear data before reading files.  m_list holds the footprints of the libraries which
+    // are not loaded again.
     m_count_finished.store( 0 );
+    m_next_lib.store( 0 );
     m_errors.clear();
-    m_list.clear();
-    m_threads.clear();
-    m_queue_in.clear();
+    m_workers.clear();
     m_queue_out.clear();
 
-    if( aNickname )
-        m_queue_in.push( *aNickname );
-    else
-    {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
-    }
+    m_loader->m_total_libs = m_stale_libs.size();
 
-    m_loader->m_total_libs = m_queue_in.size();
+    // The prefetch may wait for the network, so it runs on aNThreads tasks even when the
+    // pool has fewer threads
+    for( unsigned i = 0; i < std::max( aNThreads, 1u ); ++i )
+        m_workers.push_back( GetKiCadThreadPool().Submit( [this]() { loader_job(); } ) );
+}
 
-    for( unsigned i = 0; i < aNThreads; ++i )
-    {
-        m_threads.emplace_back( &FOOTPRINT_LIST_IMPL::loader_job, this );
-    }
+
+void FOOTPRINT_LIST_IMPL::waitWorkers()
+{
+    for( std::future<void>& worker : m_workers )
+        worker.wait();
+
+    m_workers.clear();
 }
 
+
 void FOOTPRINT_LIST_IMPL::StopWorkers()
 {
     std::lock_guard<std::mutex> lock1( m_join );
 
     // To safely stop our workers, we set the cancellation flag (they will each
     // exit on their next safe loop location when this is set).  Then we need to wait
-    // for all threads to finish as closing the implementation will free the queues
-    // that the threads write to.
-    for( auto& i : m_threads )
-        i.join();
+    // for all tasks to finish as closing the implementation will free the queues
+    // that the tasks write to.
+    waitWorkers();
 
-    m_threads.clear();
-    m_queue_in.clear();
     m_count_finished.store( 0 );
 
     // If we have cancelled in the middle of a load, clear our timestamp to re-load next time
@@ -228,75 +276,62 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     {
         std::lock_guard<std::mutex> lock1( m_join );
 
-        for( auto& i : m_threads )
-            i.join();
-
-        m_threads.clear();
-        m_queue_in.clear();
+        waitWorkers();
         m_count_finished.store( 0 );
     }
 
-    size_t total_count = m_queue_out.size();
+    std::vector<wxString> nicknames;
+    wxString              nickname;
+
+    while( m_queue_out.pop( nickname ) )
+        nicknames.push_back( nickname );
 
     LOCALE_IO toggle_locale;
 
     // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
+    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the tasks are started,
     // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
     // from this will cause nasal demons.
     //
     // TODO: blast LOCALE_IO into the sun
+    //
+    // A library is enumerated by a single task, as its plugin is not thread safe, but the
+    // plugins parse the files of a large library on all the threads of the pool.
 
-    SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
-
-    for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
-    {
-        threads.emplace_back( [this, &queue_parsed]() {
-            wxString nickname;
-
-            while( this->m_queue_out.pop( nickname ) && !m_cancelled )
-            {
-                wxArrayString fpnames;
+    std::vector<FPILIST>           parsed( nicknames.size() );
+    std::vector<std::future<void>> tasks;
+    std::atomic_size_t             next( 0 );
 
-                try
-                {
-                    m_lib_table->FootprintEnumerate( fpnames, nickname, false );
-                }
-                catch( const IO_ERROR& ioe )
+    auto work = [&]()
                 {
-                    m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                }
-                catch( const std::exception& se )
-                {
-                    // This is a round about way to do this, but who knows what THROW_IO_ERROR()
-                    // may be tricked out to do someday, keep it in the game.
-                    try
-                    {
-                        THROW_IO_ERROR( se.what() );
-                    }
-                    catch( const IO_ERROR& ioe )
+                    for( size_t ii = next++; ii < nicknames.size() && !m_cancelled; ii = next++ )
                     {
-                        m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                    }
-                }
+                        wxArrayString fpnames;
 
-                for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
-                {
-                    wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
-                }
+                        CatchErrors( [&]() {
+                            m_lib_table->FootprintEnumerate( fpnames, nicknames[ii], false );
+                        } );
 
-                if( m_progress_reporter )
-                    m_progress_reporter->AdvanceProgress();
+                        for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
+                        {
+                            parsed[ii].push_back( std::make_unique<FOOTPRINT_INFO_IMPL>(
+                                    this, nicknames[ii], fpnames[jj] ) );
+                        }
 
-                m_count_finished.fetch_add( 1 );
-            }
-        } );
-    }
+                        if( m_progress_reporter )
+                            m_progress_reporter->AdvanceProgress();
 
-    while( !m_cancelled && (size_t)m_count_finished.load() < total_count )
+                        m_count_finished.fetch_add( 1 );
+                    }
+                };
+
+    // The main thread keeps the progress reporter alive while the pool works
+    THREAD_POOL& pool = GetKiCadThreadPool();
+
+    for( size_t ii = 0; ii < std::min<size_t>( pool.GetThreadCount(), nicknames.size() ); ++ii )
+        tasks.push_back( pool.Submit( work ) );
+
+    while( !m_cancelled && m_count_finished.load() < nicknames.size() )
     {
         if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
             m_cancelled = true;
@@ -304,13 +339,14 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
         wxMilliSleep( 30 );
     }
 
-    for( auto& thr : threads )
-        thr.join();
+    for( std::future<void>& task : tasks )
+        task.wait();
 
-    std::unique_ptr<FOOTPRINT_INFO> fpi;
-
-    while( queue_parsed.pop( fpi ) )
-        m_list.push_back( std::move( fpi ) );
+    for( FPILIST& libFootprints : parsed )
+    {
+        for( std::unique_ptr<FOOTPRINT_INFO>& fpi : libFootprints )
+            m_list.push_back( std::move( fpi ) );
+    }
 
     std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
                                                  std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
@@ -338,6 +374,10 @@ FOOTPRINT_LIST_IMPL::~FOOTPRINT_LIST_IMPL()
 }
 
 
+/// The first line of a footprint info cache which holds the timestamps of its libraries
+#define FP_INFO_CACHE_VERSION wxT( "fp-info-cache v2" )
+
+
 void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
 {
     if( aCacheFile->Exists() )
@@ -353,7 +393,15 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
             return;
     }
 
+    aCacheFile->AddLine( FP_INFO_CACHE_VERSION );
     aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
+    aCacheFile->AddLine( wxString::Format( "%u", (unsigned) m_lib_timestamps.size() ) );
+
+    for( const std::pair<const wxString, long long>& lib : m_lib_timestamps )
+    {
+        aCacheFile->AddLine( lib.first );
+        aCacheFile->AddLine( wxString::Format( "%lld", lib.second ) );
+    }
 
     for( auto& fpinfo : m_list )
     {
@@ -371,16 +419,65 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
 }
 
 
+void FOOTPRINT_LIST_IMPL::WriteIndexFile( const wxString& aFileName )
+{
+    std::vector<LIB_INDEX_ENTRY> entries;
+
+    entries.reserve( m_list.size() );
+
+    for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+    {
+        LIB_INDEX_ENTRY entry;
+
+        entry.m_Nickname = fpinfo->GetLibNickname();
+        entry.m_Name = fpinfo->GetName();
+        entry.m_Description = fpinfo->GetDescription();
+        entry.m_Keywords = fpinfo->GetKeywords();
+        entry.m_OrderNum = fpinfo->GetOrderNum();
+        entry.m_PadCount = fpinfo->GetPadCount();
+        entry.m_UniquePadCount = fpinfo->GetUniquePadCount();
+
+        entries.push_back( std::move( entry ) );
+    }
+
+    LIB_INDEX::Write( aFileName, std::move( entries ), m_list_timestamp );
+}
+
+
 void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
 {
     m_list_timestamp = 0;
     m_list.clear();
+    m_lib_timestamps.clear();
+    clearFilterMatches();
 
     try
     {
         if( aCacheFile->Exists() && aCacheFile->Open() )
         {
-            aCacheFile->GetFirstLine().ToLongLong( &m_list_timestamp );
+            wxString firstLine = aCacheFile->GetFirstLine();
+
+            // The caches written before the library timestamps start with the list timestamp
+            if( firstLine == FP_INFO_CACHE_VERSION )
+            {
+                unsigned long libCount = 0;
+
+                aCacheFile->GetNextLine().ToLongLong( &m_list_timestamp );
+                aCacheFile->GetNextLine().ToULong( &libCount );
+
+                for( unsigned long ii = 0; ii < libCount; ii++ )
+                {
+                    wxString  nickname = aCacheFile->GetNextLine();
+                    long long timestamp = 0;
+
+                    aCacheFile->GetNextLine().ToLongLong( &timestamp );
+                    m_lib_timestamps[nickname] = timestamp;
+                }
+            }
+            else
+            {
+                firstLine.ToLongLong( &m_list_timestamp );
+            }
 
             while( aCacheFile->GetCurrentLine() + 6 < aCacheFile->GetLineCount() )
             {
@@ -402,11 +499,15 @@ void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
     {
         // whatever went wrong, invalidate the cache
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
     }
 
     // Sanity check: an empty list is very unlikely to be correct.
     if( m_list.size() == 0 )
+    {
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
+    }
 
     if( aCacheFile->IsOpened() )
         aCacheFile->Close();
@@ -22,8 +22,9 @@
 
 #include <atomic>
 #include <functional>
+#include <future>
+#include <map>
 #include <memory>
-#include <thread>
 #include <vector>
 
 #include <footprint_info.h>
@@ -83,15 +84,22 @@ protected:
 
 class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
 {
-    FOOTPRINT_ASYNC_LOADER*  m_loader;
-    std::vector<std::thread> m_threads;
-    SYNC_QUEUE<wxString>     m_queue_in;
-    SYNC_QUEUE<wxString>     m_queue_out;
-    std::atomic_size_t       m_count_finished;
-    long long                m_list_timestamp;
-    PROGRESS_REPORTER*       m_progress_reporter;
-    std::atomic_bool         m_cancelled;
-    std::mutex               m_join;
+    FOOTPRINT_ASYNC_LOADER*        m_loader;
+    std::vector<std::future<void>> m_workers;     // Tasks of the thread pool
+    std::atomic_size_t             m_next_lib;    // Index in m_stale_libs of the next library
+    SYNC_QUEUE<wxString>           m_queue_out;
+    std::atomic_size_t             m_count_finished;
+    long long                      m_list_timestamp;
+    PROGRESS_REPORTER*             m_progress_reporter;
+    std::atomic_bool               m_cancelled;
+    std::mutex                     m_join;
+
+    ///> The timestamps of the libraries listed in m_list, so that a library which did not
+    ///> change is not loaded again
+    std::map<wxString, long long> m_lib_timestamps;
+
+    ///> The libraries to load by the workers, set by ReadFootprintFiles()
+    std::vector<wxString>         m_stale_libs;
 
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
@@ -107,9 +115,12 @@ protected:
 
     void StopWorkers() override;
 
+    ///> Waits for the tasks of m_workers
+    void waitWorkers();
+
     /**
      * Function loader_job
-     * loads footprints from m_queue_in.
+     * prefetches the libraries of m_stale_libs.
      */
     void loader_job();
 
@@ -118,6 +129,7 @@ public:
     virtual ~FOOTPRINT_LIST_IMPL();
 
     void WriteCacheToFile( wxTextFile* aFile ) override;
+    void WriteIndexFile( const wxString& aFileName ) override;
     void ReadCacheFromFile( wxTextFile* aFile ) override;
 
     bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = nullptr,
@@ -19,6 +19,9 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <condition_variable>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -49,6 +52,12 @@ class FP_THREAD_IFACE
 {
     using CACHE_ENTRY = FOOTPRINT_PREVIEW_PANEL::CACHE_ENTRY;
 
+    /// Oldest requests beyond this count are dropped: the selection has moved on
+    static const size_t MAX_QUEUED = 8;
+
+    /// Count of loaded footprints kept for the next previews
+    static const size_t MAX_CACHED = 64;
+
     public:
         FP_THREAD_IFACE() : m_panel( nullptr )
         {
@@ -61,7 +70,10 @@ class FP_THREAD_IFACE
             auto it = m_cachedFootprints.find( aFPID );
 
             if( it != m_cachedFootprints.end() )
+            {
+                touch( aFPID );
                 return it->second;
+            }
             else
                 return NULLOPT;
         }
@@ -78,24 +90,45 @@ class FP_THREAD_IFACE
             m_cachedFootprints[aEntry] = ent;
             m_loaderQueue.push_back( ent );
 
+            // Forget the placeholders of the dropped requests, so that they are queued
+            // again if they are displayed later
+            while( m_loaderQueue.size() > MAX_QUEUED )
+            {
+                m_cachedFootprints.erase( m_loaderQueue.front().fpid );
+                m_loaderQueue.pop_front();
+            }
+
+            m_wakeUp.notify_one();
+
             return ent;
         }
 
-        /// Pop an entry from the queue, or empty option if none is available.
-        OPT<CACHE_ENTRY> PopFromQueue()
+        /**
+         * Wait for an entry to load, and pop it from the queue: the current footprint
+         * first, then the most recent requests.  Return an empty option once the panel
+         * is gone.
+         */
+        OPT<CACHE_ENTRY> WaitForEntry()
         {
-            std::lock_guard<std::mutex> lock( m_lock );
+            std::unique_lock<std::mutex> lock( m_lock );
 
-            if( m_loaderQueue.empty() )
-            {
+            m_wakeUp.wait( lock, [this]() { return !m_panel || !m_loaderQueue.empty(); } );
+
+            if( !m_panel )
                 return NULLOPT;
-            }
-            else
-            {
-                auto ent = m_loaderQueue.front();
-                m_loaderQueue.pop_front();
-                return ent;
-            }
+
+            auto it = std::find_if( m_loaderQueue.begin(), m_loaderQueue.end(),
+                                    [this]( const CACHE_ENTRY& aEntry )
+                                    {
+                                        return aEntry.fpid == m_current_fp;
+                                    } );
+
+            if( it == m_loaderQueue.end() )
+                it = std::prev( m_loaderQueue.end() );
+
+            CACHE_ENTRY ent = *it;
+            m_loaderQueue.erase( it );
+            return ent;
         }
 
         /// Add an entry to the cache.
@@ -103,6 +136,15 @@ class FP_THREAD_IFACE
         {
             std::lock_guard<std::mutex> lock( m_lock );
             m_cachedFootprints[aEntry.fpid] = aEntry;
+            touch( aEntry.fpid );
+
+            // Drop the least recently used footprints; the displayed one is kept alive by
+            // the panel anyway
+            while( m_recentlyUsed.size() > MAX_CACHED )
+            {
+                m_cachedFootprints.erase( m_recentlyUsed.back() );
+                m_recentlyUsed.pop_back();
+            }
         }
 
         /**
@@ -130,6 +172,7 @@ class FP_THREAD_IFACE
         {
             std::lock_guard<std::mutex> lock( m_lock );
             m_panel = aPanel;
+            m_wakeUp.notify_all();
         }
 
         /**
@@ -170,11 +213,24 @@ class FP_THREAD_IFACE
         }
 
     private:
+        /// Move a cached footprint to the front of m_recentlyUsed.  m_lock must be held.
+        void touch( const LIB_ID& aFPID )
+        {
+            auto it = std::find( m_recentlyUsed.begin(), m_recentlyUsed.end(), aFPID );
+
+            if( it != m_recentlyUsed.end() )
+                m_recentlyUsed.splice( m_recentlyUsed.begin(), m_recentlyUsed, it );
+            else
+                m_recentlyUsed.push_front( aFPID );
+        }
+
         std::deque<CACHE_ENTRY>       m_loaderQueue;
         std::map<LIB_ID, CACHE_ENTRY> m_cachedFootprints;
+        std::list<LIB_ID>             m_recentlyUsed;   // loaded footprints, most recent first
         LIB_ID                        m_current_fp;
         FOOTPRINT_PREVIEW_PANEL*      m_panel;
         std::mutex                    m_lock;
+        std::condition_variable       m_wakeUp;
 };
 
 
@@ -234,15 +290,8 @@ public:
 
     virtual void* Entry() override
     {
-        while( m_iface->GetPanel() )
-        {
-            auto ent = m_iface->PopFromQueue();
-
-            if( ent )
-                ProcessEntry( *ent );
-            else
-                wxMilliSleep( 100 );
-        }
+        while( OPT<CACHE_ENTRY> ent = m_iface->WaitForEntry() )
+            ProcessEntry( *ent );
 
         return nullptr;
     }
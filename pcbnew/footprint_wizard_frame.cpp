@@ -85,6 +85,9 @@ FOOTPRINT_WIZARD_FRAME::FOOTPRINT_WIZARD_FRAME( KIWAY* aKiway, wxWindow* aParent
 {
     wxASSERT( aFrameType == FRAME_FOOTPRINT_WIZARD );
 
+    // The footprint wizards are Python plugins
+    PythonPluginsLoadBase();
+
     // This frame is always show modal:
     SetModal( true );
 
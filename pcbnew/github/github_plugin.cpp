@@ -72,12 +72,14 @@ Vary: Accept-Encoding
 
 #include <boost/ptr_container/ptr_map.hpp>
 #include <set>
+#include <sstream>
 
 #include <kicad_curl/kicad_curl_easy.h>     // Include before any wx file
 
 #include <wx/zipstrm.h>
 #include <wx/mstream.h>
 #include <wx/uri.h>
+#include <wx/ffile.h>
 
 #include <fctsys.h>
 
@@ -95,6 +97,7 @@ using namespace std;
 
 
 static const char* PRETTY_DIR = "allow_pretty_writing_to_this_dir";
+static const char* ZIP_CACHE_DIR = "cache_github_zip_in_this_dir";
 
 
 typedef boost::ptr_map< wxString, wxZipEntry >  MODULE_MAP;
@@ -181,7 +184,7 @@ void GITHUB_PLUGIN::PrefetchLib(
         m_zip_image.clear();
     }
 
-    remoteGetZip( aLibraryPath );
+    remoteGetZip( aLibraryPath, aProperties );
 }
 
 
@@ -358,12 +361,12 @@ void GITHUB_PLUGIN::FootprintLibOptions( PROPERTIES* aListToAppendTo ) const
         "format of the save is pretty.</p>"
         ));
 
-    /*
-    (*aListToAppendTo)["cache_github_zip_in_this_dir"] = UTF8( _(
+    (*aListToAppendTo)[ ZIP_CACHE_DIR ] = UTF8( _(
         "Set this property to a directory where the github *.zip file will be cached. "
-        "This should speed up subsequent visits to this library."
+        "This should speed up subsequent visits to this library: the zip file is only "
+        "downloaded again when the server reports that it changed, and the cached zip "
+        "file is used when the server cannot be reached."
         ));
-    */
 }
 
 
@@ -424,7 +427,7 @@ void GITHUB_PLUGIN::cacheLib( const wxString& aLibraryPath, const PROPERTIES* aP
         m_gh_cache = new GH_CACHE();
 
         // INIT_LOGGER( "/tmp", "test.log" );
-        remoteGetZip( aLibraryPath );
+        remoteGetZip( aLibraryPath, aProperties );
         // UNINIT_LOGGER();
 
         m_lib_path = aLibraryPath;
@@ -552,7 +555,77 @@ bool GITHUB_PLUGIN::repoURL_zipURL( const wxString& aRepoURL, std::string* aZipU
 }
 
 
-void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
+static bool readFile( const wxString& aPath, std::string* aContents )
+{
+    wxFFile file;
+
+    if( !wxFileName::FileExists( aPath ) || !file.Open( aPath, "rb" ) )
+        return false;
+
+    aContents->resize( file.Length() );
+
+    return aContents->empty() || file.Read( &( *aContents )[0], aContents->size() )
+                                         == aContents->size();
+}
+
+
+static bool writeFile( const wxString& aPath, const std::string& aContents )
+{
+    // Write a temporary file first so that a reader never sees a partial file
+    wxString tmpPath = aPath + wxT( ".tmp" );
+    wxFFile  file;
+
+    if( !file.Open( tmpPath, "wb" ) )
+        return false;
+
+    bool ok = file.Write( aContents.data(), aContents.size() ) == aContents.size();
+
+    ok = file.Close() && ok;
+
+    return ok && wxRenameFile( tmpPath, aPath, true );
+}
+
+
+/**
+ * Gets the paths of the zip file and of the validators file of a library in its zip cache
+ * directory, where they are named after the zip URL.
+ * @return false if the library has no zip cache directory
+ */
+static bool zipCacheFiles( const PROPERTIES* aProperties, const std::string& aZipURL,
+                           wxString* aZipFile, wxString* aValidatorsFile )
+{
+    UTF8 cache_dir;
+
+    if( !aProperties || !aProperties->Value( ZIP_CACHE_DIR, &cache_dir ) )
+        return false;
+
+    wxString dir = LIB_TABLE::ExpandSubstitutions( cache_dir );
+
+    if( !wxFileName::DirExists( dir ) && !wxFileName::Mkdir( dir, wxS_DIR_DEFAULT,
+                                                             wxPATH_MKDIR_FULL ) )
+    {
+        wxLogDebug( wxT( "Cannot create the Github zip cache directory: " ) + dir );
+        return false;
+    }
+
+    wxString name = FROM_UTF8( aZipURL.c_str() );
+
+    for( wxString::iterator it = name.begin(); it != name.end(); ++it )
+    {
+        wxUniChar c = *it;
+
+        if( !wxIsalnum( c ) && c != '-' && c != '.' )
+            *it = '_';
+    }
+
+    *aZipFile = wxFileName( dir, name, wxT( "zip" ) ).GetFullPath();
+    *aValidatorsFile = wxFileName( dir, name, wxT( "validators" ) ).GetFullPath();
+
+    return true;
+}
+
+
+void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL, const PROPERTIES* aProperties )
 {
     std::string  zip_url;
 
@@ -565,6 +638,25 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
         THROW_IO_ERROR( msg );
     }
 
+    // The validators file holds the ETag and the Last-Modified headers of the cached zip
+    wxString    cache_zip;
+    wxString    cache_validators;
+    std::string validators;
+    std::string etag;
+    std::string last_modified;
+
+    bool cached = zipCacheFiles( aProperties, zip_url, &cache_zip, &cache_validators )
+                  && wxFileName::FileExists( cache_zip )
+                  && readFile( cache_validators, &validators );
+
+    if( cached )
+    {
+        std::istringstream lines( validators );
+
+        std::getline( lines, etag );
+        std::getline( lines, last_modified );
+    }
+
     wxLogDebug( wxT( "Attempting to download: " ) + zip_url );
 
     KICAD_CURL_EASY kcurl;      // this can THROW_IO_ERROR
@@ -574,13 +666,31 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
     kcurl.SetHeader( "Accept", "application/zip" );
     kcurl.SetFollowRedirects( true );
 
+    if( !etag.empty() )
+        kcurl.SetHeader( "If-None-Match", etag );
+
+    if( !last_modified.empty() )
+        kcurl.SetHeader( "If-Modified-Since", last_modified );
+
     try
     {
         kcurl.Perform();
+
+        // Not modified: the cached zip file is current
+        if( cached && kcurl.GetResponseCode() == 304 && readFile( cache_zip, &m_zip_image ) )
+            return;
+
         m_zip_image = kcurl.GetBuffer();
     }
     catch( const IO_ERROR& ioe )
     {
+        // Work offline with the cached zip file
+        if( cached && readFile( cache_zip, &m_zip_image ) )
+        {
+            wxLogDebug( wxT( "Using the cached zip file of: " ) + zip_url );
+            return;
+        }
+
         // https "GET" has failed, report this to API caller.
         // Note: kcurl.Perform() does not return an error if the file to download is not found
         static const char errorcmd[] = "http GET command failed";  // Do not translate this message
@@ -607,6 +717,19 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
 
         THROW_IO_ERROR( msg );
     }
+
+    if( !cache_zip.IsEmpty() && kcurl.GetResponseCode() == 200 )
+    {
+        validators = kcurl.GetResponseHeader( "ETag" ) + '\n'
+                     + kcurl.GetResponseHeader( "Last-Modified" ) + '\n';
+
+        // The validators are written last: they must never describe another zip file
+        if( wxFileName::FileExists( cache_validators ) )
+            wxRemoveFile( cache_validators );
+
+        if( writeFile( cache_zip, m_zip_image ) )
+            writeFile( cache_validators, validators );
+    }
 }
 
 #if 0 && defined(STANDALONE)
@@ -222,8 +222,13 @@ protected:
      * fetches a zip file image from a github repo synchronously.  The byte image
      * is received into the m_input_stream. If the image has already been stored,
      * do nothing.
+     *
+     * When the library has a zip cache directory option, the zip file is saved there
+     * with its ETag and Last-Modified headers, and the next fetch is a conditional
+     * request: the saved zip file is used if the server reports that it did not change,
+     * or if the server cannot be reached.
      */
-    void remoteGetZip( const wxString& aRepoURL );
+    void remoteGetZip( const wxString& aRepoURL, const PROPERTIES* aProperties );
 
     wxString    m_lib_path;     ///< from aLibraryPath, something like https://github.com/liftoff-sr/pretty_footprints
     std::string m_zip_image;    ///< byte image of the zip file in its entirety.
@@ -29,6 +29,7 @@
 
 #include <fctsys.h>
 #include <common.h>
+#include <dir_timestamp_cache.h>
 #include <macros.h>
 #include <trigo.h>
 #include <wildcards_and_files_ext.h>
@@ -308,7 +309,7 @@ long long GPCB_FPL_CACHE::GetTimestamp( const wxString& aLibPath )
 {
     wxString fileSpec = wxT( "*." ) + GedaPcbFootprintLibFileExtension;
 
-    return TimestampDir( aLibPath, fileSpec );
+    return LibraryDirTimestamp( aLibPath, fileSpec );
 }
 
 
@@ -23,10 +23,13 @@
  */
 
 #include <wx/clipbrd.h>
+#include <wx/dataobj.h>
+#include <wx/utils.h>
 
 #include <build_version.h>
 #include <class_board.h>
 #include <class_track.h>
+#include <class_zone.h>
 #include <common.h>
 #include <netinfo.h>
 #include <pcb_parser.h>
@@ -34,6 +37,183 @@
 #include <kicad_plugin.h>
 #include <kicad_clipboard.h>
 
+#include <memory>
+
+namespace
+{
+
+///> The format of the tag identifying the items copied by this process on the clipboard
+const char SNAPSHOT_FORMAT[] = "application/x-kicad-pcb-snapshot";
+
+///> The items of the last copy, and the tag identifying them on the clipboard
+std::shared_ptr<BOARD_ITEM> s_snapshot;
+wxString                    s_snapshotId;
+unsigned                    s_snapshotCount = 0;
+
+
+/**
+ * The text of a snapshot of copied items, formatted only when the text is read from the
+ * clipboard
+ */
+class SNAPSHOT_TEXT_DATA : public wxTextDataObject
+{
+public:
+    SNAPSHOT_TEXT_DATA( std::shared_ptr<BOARD_ITEM> aSnapshot ) :
+        m_snapshot( std::move( aSnapshot ) )
+    {
+    }
+
+    size_t GetTextLength() const override
+    {
+        format();
+        return wxTextDataObject::GetTextLength();
+    }
+
+    wxString GetText() const override
+    {
+        format();
+        return wxTextDataObject::GetText();
+    }
+
+private:
+    void format() const
+    {
+        if( !m_snapshot )
+            return;
+
+        std::string text = CLIPBOARD_IO::FormatSnapshot( m_snapshot.get() );
+
+        m_snapshot.reset();
+        const_cast<SNAPSHOT_TEXT_DATA*>( this )->SetText( wxString( text.c_str(), wxConvUTF8 ) );
+    }
+
+    mutable std::shared_ptr<BOARD_ITEM> m_snapshot;
+};
+
+
+///> @return true if the clipboard, which must be opened, holds the items of s_snapshot
+bool isSnapshotOnClipboard()
+{
+    wxDataFormat format( SNAPSHOT_FORMAT );
+
+    if( !s_snapshot || !wxTheClipboard->IsSupported( format ) )
+        return false;
+
+    wxCustomDataObject id( format );
+
+    if( !wxTheClipboard->GetData( id ) )
+        return false;
+
+    return std::string( static_cast<const char*>( id.GetData() ), id.GetSize() )
+           == s_snapshotId.ToStdString();
+}
+
+
+/**
+ * Detaches aModule from its board, and clears the nets of its pads to make it safe to
+ * transfer to other pcbs
+ * @return aModule
+ */
+MODULE* orphanModule( MODULE* aModule )
+{
+    aModule->SetParent( nullptr );
+
+    for( D_PAD* pad : aModule->Pads() )
+        pad->SetNetCode( 0 );
+
+    for( MODULE_ZONE_CONTAINER* zone : aModule->Zones() )
+        zone->SetNetCode( 0 );
+
+    return aModule;
+}
+
+
+///> @return an empty board with the layers of aSource, to hold the items copied from it
+BOARD* newClipboardBoard( const BOARD* aSource )
+{
+    BOARD* board = new BOARD();
+    LSET   layers = aSource->GetEnabledLayers();
+
+    board->SetEnabledLayers( layers );
+
+    for( LSEQ seq = ( layers & LSET::AllCuMask() ).Seq(); seq; ++seq )
+    {
+        board->SetLayerName( *seq, aSource->GetLayerName( *seq ) );
+        board->SetLayerType( *seq, aSource->GetLayerType( *seq ) );
+    }
+
+    return board;
+}
+
+
+/**
+ * Adds aItem to aBoard, moving the items connected to a net to the net of the same name of
+ * aBoard, which is created if needed
+ */
+void addClipboardItem( BOARD* aBoard, BOARD_ITEM* aItem )
+{
+    std::vector<BOARD_CONNECTED_ITEM*> connectedItems;
+
+    if( MODULE* module = dyn_cast<MODULE*>( aItem ) )
+    {
+        connectedItems.insert( connectedItems.end(), module->Pads().begin(),
+                               module->Pads().end() );
+        connectedItems.insert( connectedItems.end(), module->Zones().begin(),
+                               module->Zones().end() );
+    }
+    else if( BOARD_CONNECTED_ITEM* item = dynamic_cast<BOARD_CONNECTED_ITEM*>( aItem ) )
+    {
+        connectedItems.push_back( item );
+    }
+
+    // The parent is set first, so that the nets are given to aBoard before it sees the item
+    aItem->SetParent( aBoard );
+
+    for( BOARD_CONNECTED_ITEM* item : connectedItems )
+    {
+        wxString      netname = item->GetNetname();
+        NETINFO_ITEM* net = aBoard->FindNet( netname );
+
+        if( !net )
+        {
+            net = new NETINFO_ITEM( aBoard, netname );
+            aBoard->Add( net );
+        }
+
+        item->SetNet( net );
+    }
+
+    aBoard->Add( aItem, ADD_MODE::APPEND );
+}
+
+
+///> @return a copy of aSnapshot, to be owned by the caller
+BOARD_ITEM* cloneSnapshot( BOARD_ITEM* aSnapshot )
+{
+    if( aSnapshot->Type() != PCB_T )
+        return orphanModule( new MODULE( *static_cast<MODULE*>( aSnapshot ) ) );
+
+    BOARD* snapshot = static_cast<BOARD*>( aSnapshot );
+    BOARD* board = newClipboardBoard( snapshot );
+
+    for( MODULE* module : snapshot->Modules() )
+        addClipboardItem( board, static_cast<BOARD_ITEM*>( module->Clone() ) );
+
+    for( BOARD_ITEM* drawing : snapshot->Drawings() )
+        addClipboardItem( board, static_cast<BOARD_ITEM*>( drawing->Clone() ) );
+
+    for( TRACK* track : snapshot->Tracks() )
+        addClipboardItem( board, static_cast<BOARD_ITEM*>( track->Clone() ) );
+
+    for( ZONE_CONTAINER* zone : snapshot->Zones() )
+        addClipboardItem( board, static_cast<BOARD_ITEM*>( zone->Clone() ) );
+
+    return board;
+}
+
+} // namespace
+
+
 CLIPBOARD_IO::CLIPBOARD_IO():
     PCB_IO( CTL_STD_LAYER_NAMES ),
     m_formatter(),
@@ -72,10 +252,7 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
     if( aSelected.HasReferencePoint() )
         refPoint = aSelected.GetReferencePoint();
 
-    // Prepare net mapping that assures that net codes saved in a file are consecutive integers
-    m_mapping->SetBoard( m_board );
-
-    // Differentiate how it is formatted depending on what selection contains
+    // Differentiate how it is copied depending on what selection contains
     bool onlyModuleParts = true;
     for( const auto i : aSelected )
     {
@@ -89,9 +266,9 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
         }
     }
 
-    // if there is only parts of a module selected, format it as a new module else
-    // format it as an entire board
-    MODULE partialModule( m_board );
+    // The copied items are kept as they are: they are formatted only if another application
+    // reads the clipboard, or when pcbnew ends (see FlushSnapshot())
+    std::shared_ptr<BOARD_ITEM> snapshot;
 
     // only a module selected.
     if( aSelected.Size() == 1 && aSelected.Front()->Type() == PCB_MODULE_T )
@@ -99,22 +276,22 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
         // make the module safe to transfer to other pcbs
         const MODULE* mod = static_cast<MODULE*>( aSelected.Front() );
         // Do not modify existing board
-        MODULE newModule( *mod );
-
-        for( D_PAD* pad : newModule.Pads() )
-            pad->SetNetCode( 0 );
+        MODULE* newModule = new MODULE( *mod );
 
         // locked means "locked in place"; copied items therefore can't be locked
-        newModule.SetLocked( false );
+        newModule->SetLocked( false );
 
         // locate the reference point at (0, 0) in the copied items
-        newModule.Move( wxPoint( -refPoint.x, -refPoint.y ) );
+        newModule->Move( wxPoint( -refPoint.x, -refPoint.y ) );
 
-        Format( static_cast<BOARD_ITEM*>( &newModule ) );
+        snapshot.reset( orphanModule( newModule ) );
     }
     // partial module selected.
     else if( onlyModuleParts )
     {
+        // if there is only parts of a module selected, copy them as a new module
+        MODULE* partialModule = new MODULE( m_board );
+
         for( const auto item : aSelected )
         {
             BOARD_ITEM* clone = static_cast<BOARD_ITEM*>( item->Clone() );
@@ -123,12 +300,8 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
             if( TEXTE_MODULE* text = dyn_cast<TEXTE_MODULE*>( clone ) )
                 text->SetType( TEXTE_MODULE::TEXT_is_DIVERS );
 
-            // If it is only a module, clear the nets from the pads
-            if( D_PAD* pad = dyn_cast<D_PAD*>( clone ) )
-               pad->SetNetCode( 0 );
-
             // Add the pad to the new module before moving to ensure the local coords are correct
-            partialModule.Add( clone );
+            partialModule->Add( clone );
 
             // locate the reference point at (0, 0) in the copied items
             clone->Move( (wxPoint) -refPoint );
@@ -136,55 +309,43 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
 
         // Set the new relative internal local coordinates of copied items
         MODULE* editedModule = m_board->Modules().front();
-        wxPoint moveVector = partialModule.GetPosition() + editedModule->GetPosition();
-
-        partialModule.MoveAnchorPosition( moveVector );
+        wxPoint moveVector = partialModule->GetPosition() + editedModule->GetPosition();
 
-        Format( &partialModule, 0 );
+        partialModule->MoveAnchorPosition( moveVector );
 
+        snapshot.reset( orphanModule( partialModule ) );
     }
     // lots of stuff selected
     else
     {
-        // we will fake being a .kicad_pcb to get the full parser kicking
-        // This means we also need layers and nets
-        LOCALE_IO io;
-
-        m_formatter.Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n",
-                SEXPR_BOARD_FILE_VERSION, m_formatter.Quotew( GetBuildVersion() ).c_str() );
-
-
-        m_formatter.Print( 0, "\n" );
-
-        formatBoardLayers( m_board );
-        formatNetInformation( m_board );
-
-        m_formatter.Print( 0, "\n" );
+        // copy them to a board, holding the layers and the nets of the items
+        BOARD* board = newClipboardBoard( m_board );
 
+        snapshot.reset( board );
 
         for( const auto i : aSelected )
         {
-            // Dont format stuff that cannot exist standalone!
+            // Dont copy stuff that cannot exist standalone!
             if( ( i->Type() != PCB_MODULE_EDGE_T ) &&
                 ( i->Type() != PCB_MODULE_TEXT_T ) &&
-                ( i->Type() != PCB_PAD_T ) )
+                ( i->Type() != PCB_PAD_T ) &&
+                ( i->Type() != PCB_MARKER_T ) )
             {
                 auto item = static_cast<BOARD_ITEM*>( i );
-                std::unique_ptr<BOARD_ITEM> clone( static_cast<BOARD_ITEM*> ( item->Clone() ) );
+                BOARD_ITEM* clone = static_cast<BOARD_ITEM*>( item->Clone() );
 
                 // locked means "locked in place"; copied items therefore can't be locked
-                if( MODULE* module = dyn_cast<MODULE*>( clone.get() ) )
+                if( MODULE* module = dyn_cast<MODULE*>( clone ) )
                     module->SetLocked( false );
-                else if( TRACK* track = dyn_cast<TRACK*>( clone.get() ) )
+                else if( TRACK* track = dyn_cast<TRACK*>( clone ) )
                     track->SetLocked( false );
 
                 // locate the reference point at (0, 0) in the copied items
                 clone->Move( (wxPoint) -refPoint );
 
-                Format( clone.get(), 1 );
+                addClipboardItem( board, clone );
             }
         }
-        m_formatter.Print( 0, "\n)" );
     }
 
     // These are placed at the end to minimize the open time of the clipboard
@@ -194,20 +355,19 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
     if( !clipboardLock || !clipboard->IsOpened() )
         return;
 
-    clipboard->SetData( new wxTextDataObject(
-                wxString( m_formatter.GetString().c_str(), wxConvUTF8 ) ) );
+    s_snapshot = snapshot;
+    s_snapshotId = wxString::Format( "%lu:%u", wxGetProcessId(), ++s_snapshotCount );
 
-    clipboard->Flush();
+    wxDataObjectComposite* data = new wxDataObjectComposite();
+    wxCustomDataObject*    id = new wxCustomDataObject( wxDataFormat( SNAPSHOT_FORMAT ) );
+    std::string            idString = s_snapshotId.ToStdString();
 
-    // This section exists to return the clipboard data, ensuring it has fully
-    // been processed by the system clipboard.  This appears to be needed for
-    // extremely large clipboard copies on asynchronous linux clipboard managers
-    // such as KDE's Klipper
-    {
-        wxTextDataObject data;
-        clipboard->GetData( data );
-        ( void )data.GetText(); // Keep unused variable
-    }
+    id->SetData( idString.size(), idString.c_str() );
+
+    data->Add( new SNAPSHOT_TEXT_DATA( snapshot ), true );
+    data->Add( id );
+
+    clipboard->SetData( data );
 }
 
 
@@ -222,6 +382,9 @@ BOARD_ITEM* CLIPBOARD_IO::Parse()
     if( !clipboardLock )
         return nullptr;
 
+    // The items copied by this process are cloned rather than parsed
+    if( isSnapshotOnClipboard() )
+        return cloneSnapshot( s_snapshot.get() );
 
     if( clipboard->IsSupported( wxDF_TEXT ) )
     {
@@ -243,6 +406,76 @@ BOARD_ITEM* CLIPBOARD_IO::Parse()
 }
 
 
+std::string CLIPBOARD_IO::FormatSnapshot( BOARD_ITEM* aSnapshot )
+{
+    CLIPBOARD_IO io;
+    LOCALE_IO    toggle;
+
+    if( aSnapshot->Type() != PCB_T )
+    {
+        io.Format( aSnapshot, 0 );
+        return io.m_formatter.GetString();
+    }
+
+    // we will fake being a .kicad_pcb to get the full parser kicking
+    // This means we also need layers and nets
+    BOARD* board = static_cast<BOARD*>( aSnapshot );
+
+    io.SetBoard( board );
+
+    // Prepare net mapping that assures that net codes saved in a file are consecutive integers
+    io.m_mapping->SetBoard( board );
+
+    io.m_formatter.Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n",
+            SEXPR_BOARD_FILE_VERSION, io.m_formatter.Quotew( GetBuildVersion() ).c_str() );
+
+    io.m_formatter.Print( 0, "\n" );
+
+    io.formatBoardLayers( board );
+    io.formatNetInformation( board );
+
+    io.m_formatter.Print( 0, "\n" );
+
+    for( MODULE* module : board->Modules() )
+        io.Format( module, 1 );
+
+    for( BOARD_ITEM* drawing : board->Drawings() )
+        io.Format( drawing, 1 );
+
+    for( TRACK* track : board->Tracks() )
+        io.Format( track, 1 );
+
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        io.Format( zone, 1 );
+
+    io.m_formatter.Print( 0, "\n)" );
+
+    return io.m_formatter.GetString();
+}
+
+
+void CLIPBOARD_IO::FlushSnapshot()
+{
+    if( !s_snapshot )
+        return;
+
+    auto clipboard = wxTheClipboard;
+    wxClipboardLocker clipboardLock( clipboard );
+
+    if( clipboardLock && isSnapshotOnClipboard() )
+    {
+        // Leave the text of the copied items on the clipboard, for the other applications
+        // and the next session
+        clipboard->SetData( new wxTextDataObject(
+                    wxString( FormatSnapshot( s_snapshot.get() ).c_str(), wxConvUTF8 ) ) );
+
+        clipboard->Flush();
+    }
+
+    s_snapshot.reset();
+}
+
+
 void CLIPBOARD_IO::Save( const wxString& aFileName, BOARD* aBoard,
                 const PROPERTIES* aProperties )
 {
@@ -55,13 +55,25 @@ public:
     /* Saves the entire board to the clipboard formatted using the PCB_IO formatting */
     void Save( const wxString& aFileName, BOARD* aBoard,
                 const PROPERTIES* aProperties = NULL ) override;
-    /* Writes all the settings of the BOARD* set by setBoard() and then adds all
-     * the BOARD_ITEM* found in selection formatted by PCB_IO to clipboard as a text
+    /* Puts a copy of the BOARD_ITEM* found in selection on the clipboard, with the layers
+     * and the nets of the BOARD* set by setBoard().  The copy is formatted by PCB_IO when
+     * another application reads the clipboard, or by FlushSnapshot()
      */
     void SaveSelection( const PCBNEW_SELECTION& selected );
 
+    /* Returns the items of the clipboard, owned by the caller: a copy of the items saved
+     * by SaveSelection() in this process, or else the items parsed from the clipboard text
+     */
     BOARD_ITEM* Parse();
 
+    ///> Formats the copy of the items made by SaveSelection()
+    static std::string FormatSnapshot( BOARD_ITEM* aSnapshot );
+
+    /* Replaces the copy of the items held by the clipboard by their text, so that it is
+     * kept when pcbnew is unloaded
+     */
+    static void FlushSnapshot();
+
     BOARD* Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties = NULL ) override;
     CLIPBOARD_IO();
     ~CLIPBOARD_IO();
@@ -25,11 +25,13 @@
 #include <fctsys.h>
 #include <kicad_string.h>
 #include <common.h>
+#include <dir_timestamp_cache.h>
 #include <build_version.h>      // LEGACY_BOARD_FILE_VERSION
 #include <macros.h>
 #include <wildcards_and_files_ext.h>
 #include <base_units.h>
 #include <trace_helpers.h>
+#include <board_memory_usage.h>
 #include <class_board.h>
 #include <class_module.h>
 #include <class_pcb_text.h>
@@ -54,10 +56,18 @@
 #include <kiface_i.h>
 
 #include <advanced_config.h> // for pad pin function and pad property feature management
+#include <thread_pool.h>
+#include <trace_events.h>
+#include <atomic>
 
 using namespace PCB_KEYS_T;
 
 
+///> The footprint files of a library are parsed on several threads when there are more
+///> than this count of them
+static const size_t FOOTPRINTS_PER_THREAD = 16;
+
+
 ///> Removes empty nets (i.e. with node count equal zero) from net classes
 void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 {
@@ -86,20 +96,53 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;       // NULL until the file is parsed, in a lazy cache
+    size_t                  m_memoryUsage;  // the bytes of m_module, in s_cacheMemoryUsage
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
+    ~FP_CACHE_ITEM();
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+    void               SetModule( MODULE* aModule );
 };
 
 
+///> The bytes of the footprints of all the caches.  The caches are filled on several threads,
+///> so their items account for their footprints when they are set rather than being walked
+///> by the provider.
+static std::atomic<size_t> s_cacheMemoryUsage( 0 );
+
+static MEMORY_USAGE_PROVIDER s_cacheMemoryProvider( MEMORY_FOOTPRINT_CACHES,
+        []()
+        {
+            return s_cacheMemoryUsage.load();
+        } );
+
+
 FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
     m_filename( aFileName ),
-    m_module( aModule )
-{ }
+    m_memoryUsage( 0 )
+{
+    SetModule( aModule );
+}
+
+
+FP_CACHE_ITEM::~FP_CACHE_ITEM()
+{
+    s_cacheMemoryUsage -= m_memoryUsage;
+}
+
+
+void FP_CACHE_ITEM::SetModule( MODULE* aModule )
+{
+    m_module.reset( aModule );
+
+    s_cacheMemoryUsage -= m_memoryUsage;
+    m_memoryUsage = aModule ? sizeof( FP_CACHE_ITEM ) + BoardItemMemoryUsage( aModule ) : 0;
+    s_cacheMemoryUsage += m_memoryUsage;
+}
 
 
 typedef boost::ptr_map< wxString, FP_CACHE_ITEM >   MODULE_MAP;
@@ -118,6 +161,10 @@ class FP_CACHE
                                         // m_cache_timestamp against all the files.
     long long       m_cache_timestamp;  // A hash of the timestamps for all the footprint
                                         // files.
+    bool            m_lazy;             // Load() only lists the files, which are parsed by
+                                        // GetModule() when first needed.
+
+    MODULE* parseFootprint( PCB_PARSER& aParser, const WX_FILENAME& aFileName );
 
 public:
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
@@ -141,6 +188,13 @@ public:
 
     void Load();
 
+    /**
+     * Function GetModule
+     * @return the footprint aFootprintName, parsing its file if the cache is lazy and it was
+     *         not parsed yet, or NULL if there is no such footprint or its file cannot be parsed.
+     */
+    const MODULE* GetModule( const wxString& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -180,6 +234,7 @@ FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
     m_lib_path.SetPath( aLibraryPath );
     m_cache_timestamp = 0;
     m_cache_dirty = true;
+    m_lazy = ADVANCED_CFG::GetCfg().m_lazyFootprintCache;
 }
 
 
@@ -206,6 +261,13 @@ void FP_CACHE::Save( MODULE* aModule )
 
         WX_FILENAME fn = it->second->GetFileName();
 
+        // A footprint of a lazy cache which was never parsed is unchanged on disk
+        if( !it->second->GetModule() )
+        {
+            m_cache_timestamp += fn.GetTimestamp();
+            continue;
+        }
+
         wxString tempFileName =
 #ifdef USE_TMP_FILE
         wxFileName::CreateTempFileName( fn.GetPath() );
@@ -274,41 +336,126 @@ void FP_CACHE::Load()
     // the filename thereafter.
     WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
 
+    std::vector<WX_FILENAME> files;
+
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
+            files.push_back( fn );
+        } while( dir.GetNext( &fullName ) );
+    }
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+    // The footprints of a lazy cache are known from their file names alone
+    if( m_lazy )
+    {
+        for( WX_FILENAME& file : files )
+        {
+            m_modules.insert( file.GetName(), new FP_CACHE_ITEM( nullptr, file ) );
+            m_cache_timestamp += file.GetTimestamp();
+        }
 
-                m_owner->m_parser->SetLineReader( &reader );
+        return;
+    }
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
+    // Parse the files on several threads, each with its own parser, so that a large library
+    // is shared between the cores.  The results are added in the directory order.
+    std::vector<std::unique_ptr<MODULE>> footprints( files.size() );
+    std::vector<wxString>                errors( files.size() );
+    std::atomic<size_t>                  nextFile( 0 );
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+    auto work = [&]()
+                {
+                    PCB_PARSER parser;
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+                    for( size_t ii = nextFile++; ii < files.size(); ii = nextFile++ )
+                    {
+                        try
+                        {
+                            footprints[ii].reset( parseFootprint( parser, files[ii] ) );
+                        }
+                        catch( const IO_ERROR& ioe )
+                        {
+                            errors[ii] = ioe.What();
+                        }
+                    }
+                };
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    size_t       parallelism = std::min<size_t>( pool.GetThreadCount() + 1,
+                                                 files.size() / FOOTPRINTS_PER_THREAD + 1 );
+
+    if( parallelism <= 1 )
+        work();
+    else
+        pool.RunParallel( work, parallelism );
+
+    // Queue I/O errors so only files that fail to parse don't get loaded.
+    wxString cacheError;
+
+    for( size_t ii = 0; ii < files.size(); ii++ )
+    {
+        if( footprints[ii] )
+        {
+            m_modules.insert( files[ii].GetName(),
+                              new FP_CACHE_ITEM( footprints[ii].release(), files[ii] ) );
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+            m_cache_timestamp += files[ii].GetTimestamp();
+        }
+        else
+        {
+            if( !cacheError.IsEmpty() )
+                cacheError += "\n\n";
+
+            cacheError += errors[ii];
+        }
     }
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
+}
+
+
+MODULE* FP_CACHE::parseFootprint( PCB_PARSER& aParser, const WX_FILENAME& aFileName )
+{
+    MMAP_LINE_READER reader( aFileName.GetFullPath() );
+
+    aParser.SetLineReader( &reader );
+
+    MODULE* footprint = (MODULE*) aParser.Parse();
+
+    footprint->SetFPID( LIB_ID( wxEmptyString, aFileName.GetName() ) );
+
+    return footprint;
+}
+
+
+const MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
+
+    if( it == m_modules.end() )
+        return nullptr;
+
+    if( !it->second->GetModule() )
+    {
+        try
+        {
+            it->second->SetModule( parseFootprint( *m_owner->m_parser,
+                                                   it->second->GetFileName() ) );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            // Like a file which fails to parse in Load(), the footprint is dropped
+            wxLogTrace( traceKicadPcbPlugin, wxT( "Cannot parse footprint file '%s': %s" ),
+                        it->second->GetFileName().GetFullPath(), ioe.What() );
+            m_modules.erase( it );
+            return nullptr;
+        }
+    }
+
+    return it->second->GetModule();
 }
 
 
@@ -349,11 +496,35 @@ long long FP_CACHE::GetTimestamp( const wxString& aLibPath )
 {
     wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
 
-    return TimestampDir( aLibPath, fileSpec );
+    return LibraryDirTimestamp( aLibPath, fileSpec );
 }
 
 
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
+{
+    std::unique_ptr<OUTPUTFORMATTER> formatter;
+
+    if( GZIP_OUTPUTFORMATTER::IsGzipFileName( aFileName ) )
+        formatter.reset( new GZIP_OUTPUTFORMATTER( aFileName ) );
+    else
+        formatter.reset( new FILE_OUTPUTFORMATTER( aFileName ) );
+
+    formatBoardFile( aBoard, formatter.get(), aProperties );
+}
+
+
+std::string PCB_IO::FormatBoardFile( BOARD* aBoard, const PROPERTIES* aProperties )
+{
+    STRING_FORMATTER formatter;
+
+    formatBoardFile( aBoard, &formatter, aProperties );
+
+    return formatter.GetString();
+}
+
+
+void PCB_IO::formatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter,
+                              const PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
@@ -364,12 +535,10 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
-
-    m_out = &formatter;     // no ownership
+    m_out = aFormatter;     // no ownership
 
     m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+                  m_out->Quotew( GetBuildVersion() ).c_str() );
 
     Format( aBoard, 1 );
 
@@ -787,11 +956,14 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     // Do not save MARKER_PCBs, they can be regenerated easily.
 
     // Save the tracks and vias.
-    for( auto track : aBoard->Tracks() )
-        Format( track, aNestLevel );
+    if( !( m_ctl & CTL_OMIT_TRACKS ) )
+    {
+        for( auto track : aBoard->Tracks() )
+            Format( track, aNestLevel );
 
-    if( aBoard->Tracks().size() )
-        m_out->Print( 0, "\n" );
+        if( aBoard->Tracks().size() )
+            m_out->Print( 0, "\n" );
+    }
 
     // Save the polygon (which are the newer technology) zones.
     for( int i = 0; i < aBoard->GetAreaCount();  ++i )
@@ -1948,7 +2120,10 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
     const SHAPE_POLY_SET& fv = aZone->GetFilledPolysList();
     newLine = 0;
 
-    if( !fv.IsEmpty() )
+    // The fills of the board zones are kept in the board snapshot, when it is written
+    bool omitFill = ( m_ctl & CTL_OMIT_ZONE_FILLS ) && aZone->Type() == PCB_ZONE_AREA_T;
+
+    if( !fv.IsEmpty() && !omitFill )
     {
         bool new_polygon = true;
         bool is_closed = false;
@@ -2040,11 +2215,19 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    SCOPED_TRACE_EVENT trace( "PCB_IO::Load" );
+
+    std::unique_ptr<LINE_READER> reader;
+
+    // A compressed board is inflated while it is parsed
+    if( GZIP_LINE_READER::IsGzipFile( aFileName ) )
+        reader.reset( new GZIP_LINE_READER( aFileName ) );
+    else
+        reader.reset( new MMAP_LINE_READER( aFileName ) );
 
     init( aProperties );
 
-    m_parser->SetLineReader( &reader );
+    m_parser->SetLineReader( reader.get() );
     m_parser->SetBoard( aAppendToMe );
 
     BOARD* board;
@@ -2150,14 +2333,7 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( aFootprintName );
-
-    if( it == mods.end() )
-        return nullptr;
-
-    return it->second->GetModule();
+    return m_cache->GetModule( aFootprintName );
 }
 
 
@@ -76,6 +76,9 @@ class TEXTE_PCB;
 #define CTL_OMIT_AT                 (1 << 5)    ///< Omit position and rotation
                                                 // (always saved with potion 0,0 and rotation = 0 in library)
 //#define CTL_OMIT_HIDE             (1 << 6)    // found and defined in eda_text.h
+#define CTL_OMIT_TRACKS             (1 << 7)    ///< Omit the tracks and vias of a board
+#define CTL_OMIT_ZONE_FILLS         (1 << 8)    ///< Omit the filled polygons of the board zones
+                                                // (both kept in the board snapshot instead)
 
 
 // common combinations of the above:
@@ -179,6 +182,14 @@ public:
 
     void SetOutputFormatter( OUTPUTFORMATTER* aFormatter ) { m_out = aFormatter; }
 
+    /**
+     * Function FormatBoardFile
+     * formats \a aBoard in memory, as Save() writes it to its file.
+     *
+     * @throw IO_ERROR on format error.
+     */
+    std::string FormatBoardFile( BOARD* aBoard, const PROPERTIES* aProperties = NULL );
+
     BOARD_ITEM* Parse( const wxString& aClipboardSourceInput );
 
 protected:
@@ -209,6 +220,10 @@ protected:
 
     void init( const PROPERTIES* aProperties );
 
+    /// formats the whole board file, for Save() and FormatBoardFile()
+    void formatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter,
+                          const PROPERTIES* aProperties );
+
     /// formats the board setup information
     void formatSetup( BOARD* aBoard, int aNestLevel = 0 ) const;
 
@@ -0,0 +1,90 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <class_module.h>
+#include <class_text_mod.h>
+#include <module_placement_undo_item.h>
+
+
+/**
+ * Runs aFunction on the reference, the value and the texts of the graphical items of aModule
+ */
+template <typename FUNC>
+static void runOnTexts( const MODULE* aModule, FUNC aFunction )
+{
+    aFunction( &aModule->Reference() );
+    aFunction( &aModule->Value() );
+
+    for( BOARD_ITEM* item : aModule->GraphicalItems() )
+    {
+        if( item->Type() == PCB_MODULE_TEXT_T )
+            aFunction( static_cast<TEXTE_MODULE*>( item ) );
+    }
+}
+
+
+MODULE_PLACEMENT_UNDO_ITEM::MODULE_PLACEMENT_UNDO_ITEM( const MODULE* aModule ) :
+        EDA_ITEM( MODULE_PLACEMENT_UNDO_ITEM_T ),
+        m_position( aModule->GetPosition() ),
+        m_orientation( aModule->GetOrientation() ),
+        m_lastEditTime( aModule->GetLastEditTime() ),
+        m_boundingBox( aModule->GetBoundingBox() )
+{
+    runOnTexts( aModule,
+            [&]( TEXTE_MODULE* aText )
+            {
+                m_texts.push_back( { aText->GetTextAngle(), aText->GetHorizJustify() } );
+            } );
+}
+
+
+void MODULE_PLACEMENT_UNDO_ITEM::Restore( MODULE* aModule ) const
+{
+    aModule->SetPosition( m_position );
+    aModule->SetOrientation( m_orientation );
+    aModule->SetLastEditTime( m_lastEditTime );
+
+    size_t idx = 0;
+
+    runOnTexts( aModule,
+            [&]( TEXTE_MODULE* aText )
+            {
+                wxCHECK( idx < m_texts.size(), /* void */ );
+
+                aText->SetTextAngle( m_texts[idx].m_Angle );
+                aText->SetHorizJustify( m_texts[idx].m_HorizJustify );
+                aText->SetDrawCoord();
+                idx++;
+            } );
+
+    aModule->CalculateBoundingBox();
+}
+
+
+void MODULE_PLACEMENT_UNDO_ITEM::Swap( MODULE* aModule )
+{
+    MODULE_PLACEMENT_UNDO_ITEM current( aModule );
+
+    Restore( aModule );
+    *this = current;
+}
@@ -0,0 +1,93 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef MODULE_PLACEMENT_UNDO_ITEM_H
+#define MODULE_PLACEMENT_UNDO_ITEM_H
+
+#include <base_struct.h>
+#include <eda_text.h>
+
+#include <vector>
+
+class MODULE;
+
+/**
+ * MODULE_PLACEMENT_UNDO_ITEM
+ *
+ * The placement of a footprint (its position, its orientation and the orientation of its
+ * texts, which moving or rotating it can turn upright), stored in undo/redo commands in
+ * place of a copy of the footprint when only its placement changed.
+ *
+ * The items of a footprint are placed from their coordinates relative to the footprint,
+ * which the moves and rotations do not change: restoring the placement restores them.  The
+ * zones of a footprint are the exception, so this is not suitable for the footprints which
+ * have some.
+ */
+class MODULE_PLACEMENT_UNDO_ITEM : public EDA_ITEM
+{
+public:
+    MODULE_PLACEMENT_UNDO_ITEM( const MODULE* aModule );
+
+    /**
+     * Places aModule as the footprint was when this placement was saved.
+     */
+    void Restore( MODULE* aModule ) const;
+
+    /**
+     * Exchanges this placement and the current placement of aModule.
+     */
+    void Swap( MODULE* aModule );
+
+    /// @return the bounding box of the footprint in this placement
+    const EDA_RECT GetBoundingBox() const override
+    {
+        return m_boundingBox;
+    }
+
+#if defined(DEBUG)
+    /// @copydoc EDA_ITEM::Show()
+    void Show( int x, std::ostream& st ) const override { }
+#endif
+
+    wxString GetClass() const override
+    {
+        return wxT( "MODULE_PLACEMENT_UNDO_ITEM" );
+    }
+
+private:
+    struct TEXT_PLACEMENT
+    {
+        double              m_Angle;
+        EDA_TEXT_HJUSTIFY_T m_HorizJustify;
+    };
+
+    wxPoint     m_position;
+    double      m_orientation;
+    timestamp_t m_lastEditTime;
+    EDA_RECT    m_boundingBox;
+
+    ///> The reference, the value, then the texts of the graphical items
+    std::vector<TEXT_PLACEMENT> m_texts;
+};
+
+#endif /* MODULE_PLACEMENT_UNDO_ITEM_H */
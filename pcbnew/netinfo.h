@@ -33,6 +33,7 @@
 #include <gr_basic.h>
 #include <netclass.h>
 #include <class_board_item.h>
+#include <hashtables.h>
 
 
 
@@ -566,11 +567,35 @@ private:
      */
     int getFreeNetCode();
 
+    ///> Hash and equality of the net names pointed by the keys of m_netNameIndex
+    struct NETNAME_PTR_HASH
+    {
+        std::size_t operator()( const wxString* aName ) const
+        {
+            return WXSTRING_HASH()( *aName );
+        }
+    };
+
+    struct NETNAME_PTR_EQUAL
+    {
+        bool operator()( const wxString* aFirst, const wxString* aSecond ) const
+        {
+            return *aFirst == *aSecond;
+        }
+    };
+
+    typedef std::unordered_map<const wxString*, NETINFO_ITEM*, NETNAME_PTR_HASH,
+                               NETNAME_PTR_EQUAL> NETNAME_INDEX;
+
     BOARD* m_Parent;
 
     NETNAMES_MAP m_netNames;        ///< map of <wxString, NETINFO_ITEM*>, is NETINFO_ITEM owner
     NETCODES_MAP m_netCodes;        ///< map of <int, NETINFO_ITEM*> is NOT owner
 
+    ///> Hashed index of the nets by name, for a look up without string comparisons along the
+    ///> sorted map.  The keys point to the names stored in the nets, so they are not copied.
+    NETNAME_INDEX m_netNameIndex;
+
     int m_newNetCode;               ///< possible value for new net code assignment
 };
 
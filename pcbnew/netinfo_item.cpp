@@ -101,38 +101,16 @@ void NETINFO_ITEM::GetMsgPanelInfo( EDA_UNITS aUnits, std::vector<MSG_PANEL_ITEM
     if( board == NULL )
         return;
 
-    int count = 0;
-    for( auto mod : board->Modules() )
-    {
-        for( auto pad : mod->Pads() )
-        {
-            if( pad->GetNetCode() == GetNet() )
-            {
-                count++;
-                lengthPadToDie += pad->GetPadToDieLength();
-            }
-        }
-    }
+    const NET_TRACKS& tracks = board->GetNetTracks( GetNet() );
+    int               count = tracks.m_PadCount;
+
+    lengthPadToDie = tracks.m_PadToDieLength;
 
     txt.Printf( wxT( "%d" ), count );
     aList.emplace_back( _( "Pads" ), txt, DARKGREEN );
 
-    count  = 0;
-
-    for( auto track : board->Tracks() )
-    {
-        if( track->Type() == PCB_VIA_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                count++;
-        }
-
-        if( track->Type() == PCB_TRACE_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                lengthnet += track->GetLength();
-        }
-    }
+    count = tracks.m_ViaCount;
+    lengthnet = tracks.m_Length;
 
     txt.Printf( wxT( "%d" ), count );
     aList.emplace_back( _( "Vias" ), txt, BLUE );
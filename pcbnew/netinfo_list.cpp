@@ -58,6 +58,7 @@ void NETINFO_LIST::clear()
 
     m_netNames.clear();
     m_netCodes.clear();
+    m_netNameIndex.clear();
     m_newNetCode = 0;
 }
 
@@ -75,9 +76,9 @@ NETINFO_ITEM* NETINFO_LIST::GetNetItem( int aNetCode ) const
 
 NETINFO_ITEM* NETINFO_LIST::GetNetItem( const wxString& aNetName ) const
 {
-    NETNAMES_MAP::const_iterator result = m_netNames.find( aNetName );
+    NETNAME_INDEX::const_iterator result = m_netNameIndex.find( &aNetName );
 
-    if( result != m_netNames.end() )
+    if( result != m_netNameIndex.end() )
         return (*result).second;
 
     return NULL;
@@ -86,24 +87,31 @@ NETINFO_ITEM* NETINFO_LIST::GetNetItem( const wxString& aNetName ) const
 
 void NETINFO_LIST::RemoveNet( NETINFO_ITEM* aNet )
 {
-    for( NETCODES_MAP::iterator i = m_netCodes.begin(); i != m_netCodes.end(); ++i )
-    {
-        if ( i->second == aNet )
-        {
-            m_netCodes.erase(i);
-            break;
-        }
-    }
+    NETCODES_MAP::iterator code = m_netCodes.find( aNet->GetNet() );
 
-    for( NETNAMES_MAP::iterator i = m_netNames.begin(); i != m_netNames.end(); ++i )
+    // The net code may have been changed since the net was added
+    if( code == m_netCodes.end() || code->second != aNet )
     {
-        if ( i->second == aNet )
+        for( code = m_netCodes.begin(); code != m_netCodes.end(); ++code )
         {
-            m_netNames.erase(i);
-            break;
+            if( code->second == aNet )
+                break;
         }
     }
 
+    if( code != m_netCodes.end() )
+        m_netCodes.erase( code );
+
+    NETNAMES_MAP::iterator name = m_netNames.find( aNet->GetNetname() );
+
+    if( name != m_netNames.end() && name->second == aNet )
+        m_netNames.erase( name );
+
+    NETNAME_INDEX::iterator index = m_netNameIndex.find( &aNet->GetNetname() );
+
+    if( index != m_netNameIndex.end() && index->second == aNet )
+        m_netNameIndex.erase( index );
+
     m_newNetCode = std::min( m_newNetCode, aNet->m_NetCode - 1 );
 }
 
@@ -133,6 +141,7 @@ void NETINFO_LIST::AppendNet( NETINFO_ITEM* aNewElement )
     // add an entry for fast look up by a net name using a map
     m_netNames.insert( std::make_pair( aNewElement->GetNetname(), aNewElement ) );
     m_netCodes.insert( std::make_pair( aNewElement->GetNet(), aNewElement ) );
+    m_netNameIndex.insert( std::make_pair( &aNewElement->GetNetname(), aNewElement ) );
 }
 
 
@@ -49,6 +49,9 @@
 
 #include <pcb_edit_frame.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard ) :
     m_frame( aFrame ),
@@ -86,10 +89,15 @@ void BOARD_NETLIST_UPDATER::cacheNetname( D_PAD* aPad, const wxString& aNetname
 
 wxString BOARD_NETLIST_UPDATER::getNetname( D_PAD* aPad )
 {
-    if( m_isDryRun && m_padNets.count( aPad ) )
-        return m_padNets[ aPad ];
-    else
-        return aPad->GetNetname();
+    if( m_isDryRun )
+    {
+        auto it = m_padNets.find( aPad );
+
+        if( it != m_padNets.end() )
+            return it->second;
+    }
+
+    return aPad->GetNetname();
 }
 
 
@@ -101,10 +109,25 @@ void BOARD_NETLIST_UPDATER::cachePinFunction( D_PAD* aPad, const wxString& aPinF
 
 wxString BOARD_NETLIST_UPDATER::getPinFunction( D_PAD* aPad )
 {
-    if( m_isDryRun && m_padPinFunctions.count( aPad ) )
-        return m_padPinFunctions[ aPad ];
+    if( m_isDryRun )
+    {
+        auto it = m_padPinFunctions.find( aPad );
+
+        if( it != m_padPinFunctions.end() )
+            return it->second;
+    }
+
+    return aPad->GetPinFunction();
+}
+
+
+wxString BOARD_NETLIST_UPDATER::footprintKey( const wxString& aReference,
+                                              const KIID_PATH& aPath ) const
+{
+    if( m_lookupByTimestamp )
+        return aPath.AsString();
     else
-        return aPad->GetPinFunction();
+        return aReference.Lower();
 }
 
 
@@ -312,10 +335,23 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE* aPcbComponent
     MODULE* copy = m_commit.GetStatus( aPcbComponent ) ? nullptr : (MODULE*) aPcbComponent->Clone();
     bool changed = false;
 
+    // The nets of the component by pin name, instead of searching the pins for each pad.
+    // The first net of a pin is used, as in COMPONENT::GetNet()
+    std::unordered_map<wxString, const COMPONENT_NET*> componentNets;
+    const COMPONENT_NET                                noNet;
+
+    for( unsigned ii = 0; ii < aNewComponent->GetNetCount(); ii++ )
+    {
+        const COMPONENT_NET& net = aNewComponent->GetNet( ii );
+
+        componentNets.emplace( net.GetPinName(), &net );
+    }
+
     // At this point, the component footprint is updated.  Now update the nets.
     for( auto pad : aPcbComponent->Pads() )
     {
-        const COMPONENT_NET& net = aNewComponent->GetNet( pad->GetName() );
+        auto                 netIt = componentNets.find( pad->GetName() );
+        const COMPONENT_NET& net = netIt != componentNets.end() ? *netIt->second : noNet;
 
         wxString pinFunction;
 
@@ -583,17 +619,27 @@ bool BOARD_NETLIST_UPDATER::updateCopperZoneNets( NETLIST& aNetlist )
 bool BOARD_NETLIST_UPDATER::deleteUnusedComponents( NETLIST& aNetlist )
 {
     wxString msg;
-    const COMPONENT* component;
 
-    for( auto module : m_board->Modules() )
+    // The paths or the references of the components, instead of searching the netlist for
+    // each footprint.  The references are compared with their case here.
+    std::unordered_set<wxString> components;
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ii++ )
     {
+        const COMPONENT* component = aNetlist.GetComponent( ii );
 
         if( m_lookupByTimestamp )
-            component = aNetlist.GetComponentByPath( module->GetPath() );
+            components.insert( component->GetPath().AsString() );
         else
-            component = aNetlist.GetComponentByReference( module->GetReference() );
+            components.insert( component->GetReference() );
+    }
 
-        if( component == NULL )
+    for( auto module : m_board->Modules() )
+    {
+        wxString key = m_lookupByTimestamp ? module->GetPath().AsString()
+                                           : module->GetReference();
+
+        if( components.count( key ) == 0 )
         {
             if( module->IsLocked() )
             {
@@ -625,43 +671,48 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
 
     m_board->BuildListOfNets();
 
-    std::vector<D_PAD*> padlist = m_board->GetPads();
+    // The pads with their netlist name, looked up once instead of at each comparison
+    std::vector<std::pair<wxString, D_PAD*>> padlist;
+
+    for( D_PAD* pad : m_board->GetPads() )
+        padlist.emplace_back( getNetname( pad ), pad );
 
     // Sort pads by netlist name
-    std::sort( padlist.begin(), padlist.end(),
-        [ this ]( D_PAD* a, D_PAD* b ) -> bool { return getNetname( a ) < getNetname( b ); } );
+    std::stable_sort( padlist.begin(), padlist.end(),
+            []( const std::pair<wxString, D_PAD*>& a, const std::pair<wxString, D_PAD*>& b )
+            {
+                return a.first < b.first;
+            } );
 
-    for( D_PAD* pad : padlist )
+    // The nets of the copper zones: a pad attached to a zone is not really a single pad net
+    std::unordered_set<wxString> zoneNets;
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+    {
+        if( zone->IsOnCopperLayer() && !zone->GetIsKeepout() )
+            zoneNets.insert( zone->GetNetname() );
+    }
+
+    for( const std::pair<wxString, D_PAD*>& padEntry : padlist )
     {
-        if( getNetname( pad ).IsEmpty() )
+        D_PAD* pad = padEntry.second;
+
+        if( padEntry.first.IsEmpty() )
             continue;
 
-        if( netname != getNetname( pad ) )  // End of net
+        if( netname != padEntry.first )  // End of net
         {
             if( previouspad && count == 1 )
             {
                 // First, see if we have a copper zone attached to this pad.
                 // If so, this is not really a single pad net
-
-                for( ZONE_CONTAINER* zone : m_board->Zones() )
-                {
-                    if( !zone->IsOnCopperLayer() )
-                        continue;
-
-                    if( zone->GetIsKeepout() )
-                        continue;
-
-                    if( zone->GetNetname() == getNetname( previouspad ) )
-                    {
-                        count++;
-                        break;
-                    }
-                }
+                if( zoneNets.count( netname ) )
+                    count++;
 
                 if( count == 1 )    // Really one pad, and nothing else
                 {
                     msg.Printf( _( "Remove single pad net %s." ),
-                                UnescapeString( getNetname( previouspad ) ) );
+                                UnescapeString( netname ) );
                     m_reporter->Report( msg, RPT_SEVERITY_ACTION );
 
                     if( !m_isDryRun )
@@ -671,7 +722,7 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
                 }
             }
 
-            netname = getNetname( pad );
+            netname = padEntry.first;
             count = 1;
         }
         else
@@ -705,14 +756,22 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
     wxString msg;
     wxString padname;
 
+    // The first footprint of each reference, as found by BOARD::FindModuleByReference()
+    std::unordered_map<wxString, MODULE*> footprints;
+
+    for( MODULE* footprint : m_board->Modules() )
+        footprints.emplace( footprint->GetReference(), footprint );
+
     for( int i = 0; i < (int) aNetlist.GetCount(); i++ )
     {
         const COMPONENT* component = aNetlist.GetComponent( i );
-        MODULE* footprint = m_board->FindModuleByReference( component->GetReference() );
+        auto             it = footprints.find( component->GetReference() );
 
-        if( footprint == NULL )    // It can be missing in partial designs
+        if( it == footprints.end() )    // It can be missing in partial designs
             continue;
 
+        MODULE* footprint = it->second;
+
         // Explore all pins/pads in component
         for( unsigned jj = 0; jj < component->GetNetCount(); jj++ )
         {
@@ -742,10 +801,22 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
     m_errorCount = 0;
     m_warningCount = 0;
     m_newFootprintsCount = 0;
-    MODULE* lastPreexistingFootprint = m_board->Modules().empty() ? NULL : m_board->Modules().back();
 
     cacheCopperZoneConnections();
 
+    // The footprints of the board by the key matching them to the components, in the order
+    // of the board, instead of scanning the board for each component.  The footprints added
+    // by this update are only added to the board when the commit is pushed, so they are not
+    // matched to the next components.
+    std::unordered_map<wxString, std::vector<MODULE*>> footprintsByKey;
+
+    for( MODULE* footprint : m_board->Modules() )
+    {
+        wxString key = footprintKey( footprint->GetReference(), footprint->GetPath() );
+
+        footprintsByKey[ key ].push_back( footprint );
+    }
+
     if( !m_isDryRun )
     {
         m_board->SetStatus( 0 );
@@ -767,19 +838,12 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
                     component->GetFPID().Format().wx_str() );
         m_reporter->Report( msg, RPT_SEVERITY_INFO );
 
-        for( auto footprint : m_board->Modules() )
-        {
-            bool     match = false;
-
-            if( footprint )
-            {
-                if( m_lookupByTimestamp )
-                    match = footprint->GetPath() == component->GetPath();
-                else
-                    match = footprint->GetReference().CmpNoCase( component->GetReference() ) == 0;
-            }
+        auto matches = footprintsByKey.find( footprintKey( component->GetReference(),
+                                                           component->GetPath() ) );
 
-            if( match )
+        if( matches != footprintsByKey.end() )
+        {
+            for( MODULE* footprint : matches->second )
             {
                 tmp = footprint;
 
@@ -794,12 +858,6 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
 
                 matchCount++;
             }
-
-            if( footprint == lastPreexistingFootprint )
-            {
-                // No sense going through the newly-created footprints: end of loop
-                break;
-            }
         }
 
         if( matchCount == 0 )
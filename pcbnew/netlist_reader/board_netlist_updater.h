@@ -43,6 +43,8 @@ class PCB_EDIT_FRAME;
 
 #include <board_commit.h>
 
+#include <unordered_map>
+
 /**
  * BOARD_NETLIST_UPDATER
  * updates the #BOARD with a new netlist.
@@ -140,6 +142,10 @@ private:
     void cachePinFunction( D_PAD* aPad, const wxString& aPinFunction );
     wxString getPinFunction( D_PAD* aPad );
 
+    ///> @return the key matching the footprints to the components: their symbol path, or
+    ///> their reference in lower case (the references are compared regardless of the case)
+    wxString footprintKey( const wxString& aReference, const KIID_PATH& aPath ) const;
+
     wxPoint estimateComponentInsertionPosition();
     MODULE* addNewComponent( COMPONENT* aComponent );
     MODULE* replaceComponent( NETLIST& aNetlist, MODULE* aPcbComponent, COMPONENT* aNewComponent );
@@ -158,8 +164,8 @@ private:
 
     std::map< ZONE_CONTAINER*, std::vector<D_PAD*> > m_zoneConnectionsCache;
     std::map< wxString, wxString> m_oldToNewNets;
-    std::map< D_PAD*, wxString > m_padNets;
-    std::map< D_PAD*, wxString > m_padPinFunctions;
+    std::unordered_map< D_PAD*, wxString > m_padNets;
+    std::unordered_map< D_PAD*, wxString > m_padPinFunctions;
     std::vector<MODULE*> m_addedComponents;
     std::map<wxString, NETINFO_ITEM*> m_addedNets;
 
@@ -144,23 +144,24 @@ void NETLIST::Format( const char* aDocName, OUTPUTFORMATTER* aOut, int aNestLeve
 void NETLIST::AddComponent( COMPONENT* aComponent )
 {
     m_components.push_back( aComponent );
+    m_componentsByReference.emplace( aComponent->GetReference(), aComponent );
 }
 
 
 COMPONENT* NETLIST::GetComponentByReference( const wxString& aReference )
 {
-    COMPONENT* component = NULL;
+    auto it = m_componentsByReference.find( aReference );
 
-    for( unsigned i = 0;  i < m_components.size();  i++ )
-    {
-        if( m_components[i].GetReference() == aReference )
-        {
-            component = &m_components[i];
-            break;
-        }
-    }
+    return it != m_componentsByReference.end() ? it->second : nullptr;
+}
 
-    return component;
+
+void NETLIST::buildReferenceIndex()
+{
+    m_componentsByReference.clear();
+
+    for( COMPONENT& component : m_components )
+        m_componentsByReference.emplace( component.GetReference(), &component );
 }
 
 
@@ -189,6 +190,9 @@ static bool ByFPID( const COMPONENT& ref, const COMPONENT& cmp )
 void NETLIST::SortByFPID()
 {
     m_components.sort( ByFPID );
+
+    // The first component of a duplicated reference may have changed
+    buildReferenceIndex();
 }
 
 
@@ -205,6 +209,7 @@ bool operator < ( const COMPONENT& item1, const COMPONENT& item2 )
 void NETLIST::SortByReference()
 {
     m_components.sort();
+    buildReferenceIndex();
 }
 
 
@@ -29,6 +29,8 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <wx/arrstr.h>
 
+#include <unordered_map>
+
 #include <lib_id.h>
 #include <class_module.h>
 
@@ -213,6 +215,9 @@ class NETLIST
 {
     COMPONENTS         m_components;           ///< Components found in the netlist.
 
+    /// The first component of #m_components with each reference designator
+    std::unordered_map<wxString, COMPONENT*> m_componentsByReference;
+
     /// Remove footprints from #BOARD not found in netlist when true.
     bool               m_deleteExtraFootprints;
 
@@ -226,6 +231,8 @@ class NETLIST
     /// Replace component footprints when they differ from the netlist if true.
     bool               m_replaceFootprints;
 
+    void buildReferenceIndex();
+
 public:
     NETLIST() :
         m_deleteExtraFootprints( false ),
@@ -245,7 +252,11 @@ public:
      * Function Clear
      * removes all components from the netlist.
      */
-    void Clear() { m_components.clear(); }
+    void Clear()
+    {
+        m_components.clear();
+        m_componentsByReference.clear();
+    }
 
     /**
      * Function GetCount
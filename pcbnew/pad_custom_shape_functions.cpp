@@ -41,6 +41,7 @@
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/point_transform.h>
 #include <geometry/shape_rect.h>
 
 
@@ -102,9 +103,8 @@ void PAD_CS_PRIMITIVE::Rotate( const wxPoint& aRotCentre, double aAngle )
         break;
 
     case S_POLYGON:
-        for( auto& pt : m_Poly )
-            RotatePoint( &pt, aRotCentre, aAngle );
-
+        POINT_TRANSFORM::RotationDeciDeg( aAngle, aRotCentre ).Apply( m_Poly.data(),
+                                                                      m_Poly.size() );
         break;
 
     case S_CURVE:
@@ -245,6 +245,7 @@ void D_PAD::DeletePrimitivesList()
 {
     m_basicShapes.clear();
     m_customShapeAsPolygon.RemoveAllContours();
+    m_customShapeVersion++;
 }
 
 
@@ -360,7 +361,10 @@ bool D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon )
     // if aMergedPolygon == NULL, use m_customShapeAsPolygon as target
 
     if( !aMergedPolygon )
+    {
         aMergedPolygon = &m_customShapeAsPolygon;
+        m_customShapeVersion++;
+    }
 
     aMergedPolygon->RemoveAllContours();
 
@@ -397,9 +401,10 @@ void D_PAD::CustomShapeAsPolygonToBoardPosition( SHAPE_POLY_SET * aMergedPolygon
         return;
 
     // Move, rotate, ... coordinates in aMergedPolygon according to the
-    // pad position and orientation
-    aMergedPolygon->Rotate( -DECIDEG2RAD( aRotation ) );
-    aMergedPolygon->Move( VECTOR2I( aPosition ) );
+    // pad position and orientation, in a single pass
+    POINT_TRANSFORM transform = POINT_TRANSFORM::Rotation( -DECIDEG2RAD( aRotation ) );
+
+    aMergedPolygon->Transform( transform.Translate( VECTOR2I( aPosition ) ) );
 }
 
 bool D_PAD::GetBestAnchorPosition( VECTOR2I& aPos )
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pad_shape_cache.h>
+
+
+bool PAD_SHAPE_KEY::operator==( const PAD_SHAPE_KEY& aOther ) const
+{
+    return m_Clearance == aOther.m_Clearance
+           && m_Error == aOther.m_Error
+           && m_Shape == aOther.m_Shape
+           && m_Pos == aOther.m_Pos
+           && m_Offset == aOther.m_Offset
+           && m_Size == aOther.m_Size
+           && m_Delta == aOther.m_Delta
+           && m_Orient == aOther.m_Orient
+           && m_RoundRectRatio == aOther.m_RoundRectRatio
+           && m_ChamferRatio == aOther.m_ChamferRatio
+           && m_ChamferPositions == aOther.m_ChamferPositions
+           && m_CustomShapeVersion == aOther.m_CustomShapeVersion;
+}
+
+
+bool PAD_SHAPE_CACHE::Get( const PAD_SHAPE_KEY& aKey, SHAPE_POLY_SET& aCornerBuffer ) const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( const std::pair<PAD_SHAPE_KEY, SHAPE_POLY_SET>& entry : m_entries )
+    {
+        if( entry.first == aKey )
+        {
+            aCornerBuffer.Append( entry.second );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void PAD_SHAPE_CACHE::Store( const PAD_SHAPE_KEY& aKey, const SHAPE_POLY_SET& aShape )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    // An entry of the same clearance was built for an older geometry of the pad, or stored
+    // by another thread meanwhile: replace it
+    for( std::pair<PAD_SHAPE_KEY, SHAPE_POLY_SET>& entry : m_entries )
+    {
+        if( entry.first.m_Clearance == aKey.m_Clearance && entry.first.m_Error == aKey.m_Error )
+        {
+            entry.first = aKey;
+            entry.second = aShape;
+            return;
+        }
+    }
+
+    if( m_entries.size() < MAX_ENTRIES )
+    {
+        m_entries.emplace_back( aKey, aShape );
+        return;
+    }
+
+    m_entries[m_next] = std::make_pair( aKey, aShape );
+    m_next = ( m_next + 1 ) % MAX_ENTRIES;
+}
+
+
+void PAD_SHAPE_CACHE::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_entries.clear();
+    m_next = 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pad_shape_cache.h
+ * @brief Cache of the pad shapes inflated by a clearance.
+ */
+
+#ifndef PAD_SHAPE_CACHE_H
+#define PAD_SHAPE_CACHE_H
+
+#include <geometry/shape_poly_set.h>
+#include <wx/gdicmn.h>
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+/**
+ * The geometry a pad polygon is built from: two polygons built from equal keys are equal
+ */
+struct PAD_SHAPE_KEY
+{
+    int      m_Clearance;
+    int      m_Error;
+    int      m_Shape;
+    wxPoint  m_Pos;
+    wxPoint  m_Offset;
+    wxSize   m_Size;
+    wxSize   m_Delta;
+    double   m_Orient;
+    double   m_RoundRectRatio;
+    double   m_ChamferRatio;
+    int      m_ChamferPositions;
+    unsigned m_CustomShapeVersion;      ///< changed with the custom shape polygon
+
+    bool operator==( const PAD_SHAPE_KEY& aOther ) const;
+};
+
+
+/**
+ * Class PAD_SHAPE_CACHE
+ *
+ * Keeps the last polygons built for a pad, for the next requests of the same shape: the
+ * zone filler, the DRC, the 3D viewer and the plotters ask for the same few clearances
+ * of each pad again and again.  The entries are only reused when the whole geometry of the
+ * pad is unchanged, so the pad does not need to invalidate them.
+ *
+ * The cache can be read and filled by several threads at once.  A copy of a pad starts
+ * with an empty cache.
+ */
+class PAD_SHAPE_CACHE
+{
+public:
+    PAD_SHAPE_CACHE() :
+        m_next( 0 )
+    {}
+
+    PAD_SHAPE_CACHE( const PAD_SHAPE_CACHE& ) :
+        m_next( 0 )
+    {}
+
+    PAD_SHAPE_CACHE& operator=( const PAD_SHAPE_CACHE& )
+    {
+        Clear();
+        return *this;
+    }
+
+    /**
+     * Function Get
+     * appends the polygons stored for aKey to aCornerBuffer.
+     * @return false if there are none
+     */
+    bool Get( const PAD_SHAPE_KEY& aKey, SHAPE_POLY_SET& aCornerBuffer ) const;
+
+    ///> Stores aShape for aKey, replacing the oldest entry when the cache is full
+    void Store( const PAD_SHAPE_KEY& aKey, const SHAPE_POLY_SET& aShape );
+
+    void Clear();
+
+    ///> The number of clearances kept for a pad
+    static const size_t MAX_ENTRIES = 4;
+
+private:
+    mutable std::mutex                                    m_lock;
+    std::vector<std::pair<PAD_SHAPE_KEY, SHAPE_POLY_SET>> m_entries;
+    size_t                                                m_next;   ///< the entry to replace
+};
+
+#endif // PAD_SHAPE_CACHE_H
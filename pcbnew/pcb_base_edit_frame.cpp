@@ -55,6 +55,7 @@ PCB_BASE_EDIT_FRAME::~PCB_BASE_EDIT_FRAME()
     {
         wxTextFile footprintInfoCache( Prj().GetProjectPath() + "fp-info-cache" );
         GFootprintList.WriteCacheToFile( &footprintInfoCache );
+        GFootprintList.WriteIndexFile( Prj().GetProjectPath() + "fp-info-index" );
     }
 
     GetCanvas()->GetView()->Clear();
@@ -115,6 +115,15 @@ void PCB_BASE_FRAME::Update3DView( bool aForceReload, const wxString* aTitle )
 }
 
 
+void PCB_BASE_FRAME::Update3DLayers( const LSET& aLayers )
+{
+    EDA_3D_VIEWER* draw3DFrame = Get3DViewerFrame();
+
+    if( draw3DFrame )
+        draw3DFrame->ReloadLayersRequest( aLayers );
+}
+
+
 FP_LIB_TABLE* PROJECT::PcbFootprintLibs()
 {
     // This is a lazy loading function, it loads the project specific table when
@@ -35,16 +35,20 @@
 #include <class_module.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
+#include <class_drawsegment.h>
 #include <pcb_base_frame.h>
 #include <pgm_base.h>
 #include <settings/settings_manager.h>
 #include <confirm.h>
+#include <advanced_config.h>
 
 #include <gal/graphics_abstraction_layer.h>
 
+#include <thread_pool.h>
+
 #include <functional>
+#include <future>
 #include <memory>
-#include <thread>
 using namespace std::placeholders;
 
 const LAYER_NUM GAL_LAYER_ORDER[] =
@@ -119,6 +123,10 @@ PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     setDefaultLayerOrder();
     setDefaultLayerDeps();
 
+    // At a tenth of a millimeter per pixel, the items are mostly too small to be edited
+    if( ADVANCED_CFG::GetCfg().m_aggregateZoomedOutLayers )
+        m_view->SetAggregateThreshold( Millimeter2iu( 0.1 ) );
+
     // View controls is the first in the event handler chain, so the Tool Framework operates
     // on updated viewport data.
     m_viewControls = new KIGFX::WX_VIEW_CONTROLS( m_view, this );
@@ -144,24 +152,60 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 
     m_view->Clear();
 
-    auto zones = aBoard->Zones();
-    std::atomic<size_t> next( 0 );
-    std::atomic<size_t> count_done( 0 );
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+    // The filled polygons are triangulated on the pool threads while the items are added
+    // to the view, instead of on the main thread by the first redraw.  The polygons of the
+    // graphic items are only triangulated for the OpenGL canvas, like PCB_PAINTER does.
+    const ZONE_CONTAINERS&       zones = aBoard->Zones();
+    std::vector<SHAPE_POLY_SET*> polygons;
 
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    if( m_backend == GAL_TYPE_OPENGL )
     {
-        std::thread t = std::thread( [ &count_done, &next, &zones ]( )
-        {
-            for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
+        auto addPolygon =
+                [&]( BOARD_ITEM* aItem )
+                {
+                    if( aItem->Type() != PCB_LINE_T && aItem->Type() != PCB_MODULE_EDGE_T )
+                        return;
+
+                    DRAWSEGMENT* segment = static_cast<DRAWSEGMENT*>( aItem );
 
-            count_done++;
-        } );
+                    if( segment->GetShape() == S_POLYGON
+                            && !segment->GetPolyShape().IsTriangulationUpToDate() )
+                    {
+                        polygons.push_back( &segment->GetPolyShape() );
+                    }
+                };
 
-        t.detach();
+        for( BOARD_ITEM* drawing : aBoard->Drawings() )
+            addPolygon( drawing );
+
+        for( MODULE* module : aBoard->Modules() )
+        {
+            for( BOARD_ITEM* drawing : module->GraphicalItems() )
+                addPolygon( drawing );
+        }
     }
 
+    std::atomic<size_t> next( 0 );
+    size_t              count = zones.size() + polygons.size();
+
+    auto triangulate =
+            [&]()
+            {
+                for( size_t i = next.fetch_add( 1 ); i < count; i = next.fetch_add( 1 ) )
+                {
+                    if( i < zones.size() )
+                        zones[i]->CacheTriangulation();
+                    else
+                        polygons[i - zones.size()]->CacheTriangulation();
+                }
+            };
+
+    THREAD_POOL&                   pool = GetKiCadThreadPool();
+    std::vector<std::future<void>> workers;
+
+    for( size_t ii = 0; ii < std::min<size_t>( pool.GetThreadCount(), count ); ++ii )
+        workers.push_back( pool.Submit( triangulate ) );
+
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
 
@@ -181,9 +225,11 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     for( auto marker : aBoard->Markers() )
         m_view->Add( marker );
 
-    // Finalize the triangulation threads
-    while( count_done < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    // Help with the remaining polygons, and wait for the ones in progress
+    triangulate();
+
+    for( std::future<void>& worker : workers )
+        worker.wait();
 
     // Load zones
     for( auto zone : aBoard->Zones() )
@@ -435,6 +481,16 @@ void PCB_DRAW_PANEL_GAL::RedrawRatsnest()
 }
 
 
+void PCB_DRAW_PANEL_GAL::onPaint( wxPaintEvent& aEvent )
+{
+    // The nets whose ratsnest has changed have to be recached with the other view items
+    if( m_ratsnest )
+        m_ratsnest->UpdateNets( m_view );
+
+    EDA_DRAW_PANEL_GAL::onPaint( aEvent );
+}
+
+
 BOX2I PCB_DRAW_PANEL_GAL::GetDefaultViewBBox() const
 {
     if( m_worksheet && m_view->IsLayerVisible( LAYER_WORKSHEET ) )
@@ -488,7 +544,7 @@ void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
     m_view->SetLayerDisplayOnly( LAYER_SELECT_OVERLAY ) ;
     m_view->SetLayerTarget( LAYER_GP_OVERLAY , KIGFX::TARGET_OVERLAY );
     m_view->SetLayerDisplayOnly( LAYER_GP_OVERLAY ) ;
-    m_view->SetLayerTarget( LAYER_RATSNEST, KIGFX::TARGET_OVERLAY );
+    // The ratsnest of the nets is cached, only the dynamic ratsnest is drawn on the overlay
     m_view->SetLayerDisplayOnly( LAYER_RATSNEST );
 
     m_view->SetLayerTarget( LAYER_WORKSHEET, KIGFX::TARGET_NONCACHED );
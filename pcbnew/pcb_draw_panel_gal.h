@@ -115,6 +115,9 @@ protected:
     ///> Sets rendering targets & dependencies for layers.
     void setDefaultLayerDeps();
 
+    ///> @copydoc EDA_DRAW_PANEL_GAL::onPaint()
+    void onPaint( wxPaintEvent& aEvent ) override;
+
     ///> Currently used worksheet
     std::unique_ptr<KIGFX::WS_PROXY_VIEW_ITEM> m_worksheet;
 
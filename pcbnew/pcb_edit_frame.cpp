@@ -21,6 +21,8 @@
  */
 
 #include <fctsys.h>
+#include <advanced_config.h>
+#include <background_file_writer.h>
 #include <kiface_i.h>
 #include <pgm_base.h>
 #include <confirm.h>
@@ -76,6 +78,7 @@
 #include <tools/microwave_tool.h>
 #include <tools/position_relative_tool.h>
 #include <tools/zone_filler_tool.h>
+#include <zone_fill_cache.h>
 #include <tools/pcb_actions.h>
 #include <router/router_tool.h>
 #include <router/length_tuner_tool.h>
@@ -557,6 +560,10 @@ void PCB_EDIT_FRAME::OnCloseWindow( wxCloseEvent& aEvent )
 
     GetCanvas()->StopDrawing();
 
+    // Let a running auto save finish before removing its file
+    if( m_autoSaveWriter )
+        m_autoSaveWriter->Wait();
+
     // Delete the auto save file if it exists.
     wxFileName fn = GetBoard()->GetFileName();
 
@@ -862,6 +869,46 @@ void PCB_EDIT_FRAME::OnModify( )
 }
 
 
+void PCB_EDIT_FRAME::OnModifyLayers( const LSET& aChangedLayers )
+{
+    if( !ADVANCED_CFG::GetCfg().m_incremental3DView )
+    {
+        OnModify();
+        return;
+    }
+
+    PCB_BASE_FRAME::OnModify();
+
+    Update3DLayers( aChangedLayers );
+
+    m_ZoneFillsDirty = true;
+}
+
+
+void PCB_EDIT_FRAME::OnBoardItemsChanged( const std::vector<EDA_RECT>& aDirtyAreas )
+{
+    if( !ADVANCED_CFG::GetCfg().m_incrementalDRC )
+        return;
+
+    DRC* drcTool = m_toolManager->GetTool<DRC>();
+
+    if( drcTool )
+        drcTool->RunIncrementalTests( aDirtyAreas );
+}
+
+
+ZONE_FILL_CACHE* PCB_EDIT_FRAME::GetZoneFillCache()
+{
+    if( !ADVANCED_CFG::GetCfg().m_zoneFillCache )
+        return nullptr;
+
+    if( !m_zoneFillCache )
+        m_zoneFillCache = std::make_unique<ZONE_FILL_CACHE>();
+
+    return m_zoneFillCache.get();
+}
+
+
 void PCB_EDIT_FRAME::ExportSVG( wxCommandEvent& event )
 {
     InvokeExportSVG( this, GetBoard() );
@@ -1154,6 +1201,20 @@ void PCB_EDIT_FRAME::PythonPluginsReload()
 }
 
 
+void PCB_EDIT_FRAME::PythonPluginsLoad()
+{
+#if defined(KICAD_SCRIPTING)
+    PythonPluginsLoadBase();
+
+    #if defined(KICAD_SCRIPTING_ACTION_MENU)
+        // The menus and the toolbar were created without the action plugins
+        ReCreateMenuBar();
+        ReCreateHToolbar();
+    #endif
+#endif
+}
+
+
 void PCB_EDIT_FRAME::InstallFootprintPropertiesDialog( MODULE* Module )
 {
     if( Module == NULL )
@@ -60,6 +60,8 @@ class IO_ERROR;
 class FP_LIB_TABLE;
 class BOARD_NETLIST_UPDATER;
 class ACTION_MENU;
+class ZONE_FILL_CACHE;
+class BACKGROUND_FILE_WRITER;
 
 namespace PCB { struct IFACE; }     // KIFACE_I is in pcbnew.cpp
 
@@ -108,6 +110,10 @@ protected:
 
     std::set<wxString>      m_drcExclusions;
 
+    std::unique_ptr<ZONE_FILL_CACHE> m_zoneFillCache;     // zone fills of the current board
+
+    std::unique_ptr<BACKGROUND_FILE_WRITER> m_autoSaveWriter;  // writes the auto save files
+
     /**
      * Store the previous layer toolbar icon state information
      */
@@ -312,6 +318,14 @@ public:
      */
     void PythonPluginsReload();
 
+    /**
+     * Load the Python plugins, if not already loaded, and add the action plugins to the
+     * menus and the toolbar.  Called once the frame is shown, as the plugins are not loaded
+     * when Pcbnew starts.
+     * Do nothing if KICAD_SCRIPTING is not defined
+     */
+    void PythonPluginsLoad();
+
     /**
      * Update the layer manager and other widgets from the board setup
      * (layer and items visibility, colors ...)
@@ -489,6 +503,24 @@ public:
      */
     void OnModify() override;
 
+    /**
+     * Same as OnModify(), but only the changed layers of the 3D view are rebuilt, when it
+     * is enabled in the advanced settings.
+     */
+    void OnModifyLayers( const LSET& aChangedLayers ) override;
+
+    /**
+     * Runs the incremental DRC on the changed areas, when it is enabled in the advanced
+     * settings.
+     */
+    void OnBoardItemsChanged( const std::vector<EDA_RECT>& aDirtyAreas ) override;
+
+    /**
+     * @return the zone fill cache of the current board, or nullptr if the cache is not enabled
+     * in the advanced settings.
+     */
+    ZONE_FILL_CACHE* GetZoneFillCache();
+
     /**
      * Function SetActiveLayer
      * will change the currently active layer to \a aLayer and also
@@ -841,6 +873,7 @@ public:
      *  Basic routine used by other routines when editing tracks or vias.
      *  Note that casting this to boolean will allow you to determine whether any action
      *  happened.
+     *  The caller commits the change, which marks the board as modified.
      * @param aTrackItem = the track segment or via to modify
      * @param aItemsListPicker = the list picker to use for an undo command
      *                           (can be NULL)
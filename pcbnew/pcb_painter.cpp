@@ -34,6 +34,7 @@
 #include <class_dimension.h>
 #include <class_pcb_target.h>
 #include <class_marker_pcb.h>
+#include <ratsnest_viewitem.h>
 
 #include <layers_id_colors_and_visibility.h>
 #include <pcb_painter.h>
@@ -223,6 +224,13 @@ const COLOR4D& PCB_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer
     int netCode = -1;
     const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
 
+    // The ratsnest lines of a net only follow the net highlighting
+    if( auto ratsnest = dynamic_cast<const RATSNEST_NET_VIEWITEM*>( aItem ) )
+    {
+        netCode = ratsnest->GetNetCode();
+        item = nullptr;
+    }
+
     if( item )
     {
         // Selection disambiguation
@@ -297,6 +305,34 @@ const COLOR4D& PCB_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer
 }
 
 
+bool PCB_RENDER_SETTINGS::IsTransparentLayer( int aLayer ) const
+{
+    if( !isLayerColorTransparent( aLayer ) )
+        return false;
+
+    switch( aLayer )
+    {
+    // GetColor() draws the pads which should be NPTH with the color of another layer
+    case LAYER_PADS_PLATEDHOLES:
+    case LAYER_NON_PLATEDHOLES:
+    case LAYER_PADS_TH:
+    case LAYER_PADS_NETNAMES:
+    case LAYER_PAD_FR:
+    case LAYER_PAD_BK:
+    case LAYER_PAD_FR_NETNAMES:
+    case LAYER_PAD_BK_NETNAMES:
+        return isLayerColorTransparent( LAYER_MOD_TEXT_INVISIBLE );
+
+    default:
+        // The board layers hold pads too
+        if( aLayer < PCB_LAYER_ID_COUNT )
+            return isLayerColorTransparent( LAYER_MOD_TEXT_INVISIBLE );
+
+        return true;
+    }
+}
+
+
 PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
     PAINTER( aGal )
 {
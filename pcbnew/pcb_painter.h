@@ -101,6 +101,9 @@ public:
     /// @copydoc RENDER_SETTINGS::GetColor()
     virtual const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const override;
 
+    /// @copydoc RENDER_SETTINGS::IsTransparentLayer()
+    virtual bool IsTransparentLayer( int aLayer ) const override;
+
     /**
      * Function SetSketchMode
      * Turns on/off sketch mode for given item layer.
@@ -241,6 +244,14 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override
+    {
+        PCB_PAINTER* painter = new PCB_PAINTER( *this );
+        painter->SetGAL( aGal );
+        return painter;
+    }
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
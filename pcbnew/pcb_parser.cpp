@@ -27,7 +27,10 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <atomic>
 #include <cerrno>
+#include <exception>
+#include <mutex>
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
@@ -51,10 +54,163 @@
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
 #include <template_fieldnames.h>
+#include <thread_pool.h>
 
 using namespace PCB_KEYS_T;
 
 
+/**
+ * The text of a board after its header, split in lines.  Each line is followed by a nul,
+ * so that the readers of the sections hand out the lines in place.
+ */
+struct PCB_PARSER::BOARD_TEXT
+{
+    wxString                                  m_source;
+    unsigned                                  m_firstLineNum;   ///< line number of m_lines[0]
+    std::vector<char>                         m_chars;
+    std::vector<std::pair<size_t, unsigned>>  m_lines;          ///< offset and length
+};
+
+
+/**
+ * A top level section of a board, from its opening to its closing parenthesis.
+ */
+struct PCB_PARSER::BOARD_SECTION
+{
+    size_t              m_firstLine;
+    size_t              m_lastLine;
+    T                   m_token;
+
+    BOARD_ITEM*         m_item = nullptr;       ///< the parsed item, until added to the board
+    std::exception_ptr  m_error;                ///< the error of the parse, if any
+    bool                m_deferred = false;     ///< true if left to the main parser
+};
+
+
+/**
+ * BOARD_TEXT_READER
+ * is a LINE_READER handing out in place a range of lines of a board text.
+ */
+class BOARD_TEXT_READER : public LINE_READER
+{
+public:
+    BOARD_TEXT_READER( char* aChars, const std::pair<size_t, unsigned>* aLines, size_t aCount,
+                       unsigned aFirstLineNum, const wxString& aSource ) :
+            LINE_READER( 0 ),
+            m_chars( aChars ),
+            m_lines( aLines ),
+            m_count( aCount ),
+            m_next( 0 )
+    {
+        m_empty[0] = 0;
+        m_line = m_empty;
+        m_source = aSource;
+        m_lineNum = aFirstLineNum - 1;
+    }
+
+    ~BOARD_TEXT_READER()
+    {
+        m_line = nullptr;   // not owned
+    }
+
+    char* ReadLine() override
+    {
+        ++m_lineNum;
+
+        if( m_next == m_count )
+        {
+            m_line = m_empty;
+            m_length = 0;
+            return NULL;
+        }
+
+        m_line = m_chars + m_lines[m_next].first;
+        m_length = m_lines[m_next].second;
+        m_next++;
+
+        return m_line;
+    }
+
+private:
+    char*                               m_chars;
+    const std::pair<size_t, unsigned>*  m_lines;
+    size_t                              m_count;
+    size_t                              m_next;
+    char                                m_empty[1];
+};
+
+
+/**
+ * Thrown by the parsers of the worker threads when a section must be parsed by the main
+ * parser, because it changes the board or asks the user.
+ */
+struct PCB_PARSER_DEFERRED
+{
+};
+
+
+/**
+ * Pops the readers pushed in a lexer on leaving the scope, even on exception, so that the
+ * lexer is not left with a dangling reader.
+ */
+class PCB_READER_GUARD
+{
+public:
+    PCB_READER_GUARD( DSNLEXER* aLexer, LINE_READER* aReader ) :
+            m_lexer( aLexer )
+    {
+        m_lexer->PushReader( aReader );
+    }
+
+    ~PCB_READER_GUARD()
+    {
+        m_lexer->PopReader();
+    }
+
+private:
+    DSNLEXER* m_lexer;
+};
+
+
+/// Minimum number of item sections per thread of the parallel loader
+static const size_t SECTIONS_PER_THREAD = 64;
+
+
+static bool isItemSection( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+    case T_gr_text:
+    case T_dimension:
+    case T_module:
+    case T_segment:
+    case T_arc:
+    case T_via:
+    case T_zone:
+    case T_target:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+static ADD_MODE itemAddMode( T aToken )
+{
+    // Tracks are inserted at the front, as they always were
+    if( aToken == T_segment || aToken == T_arc || aToken == T_via )
+        return ADD_MODE::INSERT;
+
+    return ADD_MODE::APPEND;
+}
+
+
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
@@ -149,11 +305,19 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
+    DECIMAL decimal;
+    double  fval;
+
+    // The plain decimal numbers, almost all the numbers of a file, are read without strtod()
+    // and its locale lookups, to the same value.
+    if( ParseDecimal( CurStr(), decimal ) && decimal.ToDouble( fval ) )
+        return fval;
+
     char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = strtod( CurText(), &tmp );
 
     if( errno )
     {
@@ -526,87 +690,33 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 
     parseHeader();
 
-    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
-    {
-        if( token != T_LEFT )
-            Expecting( T_LEFT );
-
-        token = NextTok();
-
-        switch( token )
-        {
-        case T_general:
-            parseGeneralSection();
-            break;
-
-        case T_page:
-            parsePAGE_INFO();
-            break;
-
-        case T_title_block:
-            parseTITLE_BLOCK();
-            break;
-
-        case T_layers:
-            parseLayers();
-            break;
-
-        case T_setup:
-            parseSetup();
-            break;
-
-        case T_net:
-            parseNETINFO_ITEM();
-            break;
-
-        case T_net_class:
-            parseNETCLASS();
-            break;
-
-        case T_gr_arc:
-        case T_gr_circle:
-        case T_gr_curve:
-        case T_gr_line:
-        case T_gr_poly:
-            m_board->Add( parseDRAWSEGMENT(), ADD_MODE::APPEND );
-            break;
-
-        case T_gr_text:
-            m_board->Add( parseTEXTE_PCB(), ADD_MODE::APPEND );
-            break;
-
-        case T_dimension:
-            m_board->Add( parseDIMENSION(), ADD_MODE::APPEND );
-            break;
+    BOARD_TEXT                 text;
+    std::vector<BOARD_SECTION> sections;
 
-        case T_module:
-            m_board->Add( parseMODULE(), ADD_MODE::APPEND );
-            break;
+    readBoardText( text );
 
-        case T_segment:
-            m_board->Add( parseTRACK(), ADD_MODE::INSERT );
-            break;
-
-        case T_arc:
-            m_board->Add( parseARC(), ADD_MODE::INSERT );
-            break;
-
-        case T_via:
-            m_board->Add( parseVIA(), ADD_MODE::INSERT );
-            break;
+    if( splitBoardText( text, sections ) )
+    {
+        parseBoardSections( text, sections );
+    }
+    else
+    {
+        // Let the serial parser report the error, if any
+        BOARD_TEXT_READER reader( text.m_chars.data(), text.m_lines.data(), text.m_lines.size(),
+                                  text.m_firstLineNum, text.m_source );
+        PCB_READER_GUARD  guard( this, &reader );
 
-        case T_zone:
-            m_board->Add( parseZONE_CONTAINER( m_board ), ADD_MODE::APPEND );
-            break;
+        for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+        {
+            if( token != T_LEFT )
+                Expecting( T_LEFT );
 
-        case T_target:
-            m_board->Add( parsePCB_TARGET(), ADD_MODE::APPEND );
-            break;
+            token = NextTok();
 
-        default:
-            wxString err;
-            err.Printf( _( "Unknown token \"%s\"" ), GetChars( FromUTF8() ) );
-            THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+            if( isItemSection( token ) )
+                m_board->Add( parseBoardItem( token ), itemAddMode( token ) );
+            else
+                parseBoardSettings( token );
         }
     }
 
@@ -693,6 +803,332 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+void PCB_PARSER::parseBoardSettings( T aToken )
+{
+    switch( aToken )
+    {
+    case T_general:
+        parseGeneralSection();
+        break;
+
+    case T_page:
+        parsePAGE_INFO();
+        break;
+
+    case T_title_block:
+        parseTITLE_BLOCK();
+        break;
+
+    case T_layers:
+        parseLayers();
+        break;
+
+    case T_setup:
+        parseSetup();
+        break;
+
+    case T_net:
+        parseNETINFO_ITEM();
+        break;
+
+    case T_net_class:
+        parseNETCLASS();
+        break;
+
+    default:
+        wxString err;
+        err.Printf( _( "Unknown token \"%s\"" ), GetChars( FromUTF8() ) );
+        THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseBoardItem( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
+
+    case T_gr_text:
+        return parseTEXTE_PCB();
+
+    case T_dimension:
+        return parseDIMENSION();
+
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_arc:
+        return parseARC();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER( m_board );
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        return NULL;
+    }
+}
+
+
+void PCB_PARSER::readBoardText( BOARD_TEXT& aText )
+{
+    aText.m_source = CurSource();
+    aText.m_firstLineNum = CurLineNumber();
+
+    auto addLine = [&aText]( const char* aLine, unsigned aLength )
+                   {
+                       aText.m_lines.emplace_back( aText.m_chars.size(), aLength );
+                       aText.m_chars.insert( aText.m_chars.end(), aLine, aLine + aLength );
+                       aText.m_chars.push_back( 0 );
+                   };
+
+    std::string first( next - start, ' ' );
+    first.append( next, limit );
+    addLine( first.c_str(), first.size() );
+
+    while( reader->ReadLine() )
+        addLine( reader->Line(), reader->Length() );
+}
+
+
+static bool isSectionSpace( char cc )
+{
+    return cc == ' ' || cc == '\t' || cc == '\n' || cc == '\r' || cc == '\0';
+}
+
+
+bool PCB_PARSER::splitBoardText( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections )
+{
+    // The scan follows the rules of DSNLEXER::NextTok() in KiCad mode: comment lines,
+    // quoted strings with escapes, and symbols ended by a blank or a parenthesis.
+    // The depth is 0 between the sections, in the kicad_pcb list.
+    int           depth = 0;
+    size_t        lastEnd = std::string::npos;
+    BOARD_SECTION section;
+
+    for( size_t ii = 0; ii < aText.m_lines.size(); ii++ )
+    {
+        const char* cur = &aText.m_chars[aText.m_lines[ii].first];
+        const char* end = cur + aText.m_lines[ii].second;
+
+        while( cur < end && isSectionSpace( *cur ) )
+            ++cur;
+
+        if( cur < end && *cur == '#' )
+            continue;
+
+        while( cur < end )
+        {
+            if( isSectionSpace( *cur ) )
+            {
+                ++cur;
+            }
+            else if( *cur == '(' )
+            {
+                if( depth++ == 0 )
+                {
+                    // Two sections cannot share a line
+                    if( lastEnd == ii )
+                        return false;
+
+                    const char* keyword = ++cur;
+
+                    while( cur < end && !isSectionSpace( *cur ) && *cur != '(' && *cur != ')'
+                            && *cur != '"' )
+                        ++cur;
+
+                    section.m_firstLine = ii;
+                    section.m_token = (T) findToken( std::string( keyword, cur ) );
+                }
+                else
+                {
+                    ++cur;
+                }
+            }
+            else if( *cur == ')' )
+            {
+                ++cur;
+
+                // The end of the board; the serial parser also ignores what follows
+                if( depth == 0 )
+                    return true;
+
+                if( --depth == 0 )
+                {
+                    section.m_lastLine = ii;
+                    aSections.push_back( section );
+                    lastEnd = ii;
+                }
+            }
+            else if( depth == 0 )
+            {
+                return false;       // not a section
+            }
+            else if( *cur == '"' )
+            {
+                for( ++cur; cur < end && *cur != '"'; ++cur )
+                {
+                    if( *cur == '\\' )
+                        ++cur;
+                }
+
+                if( cur >= end )
+                    return false;   // un-terminated string
+
+                ++cur;
+            }
+            else
+            {
+                while( cur < end && !isSectionSpace( *cur ) && *cur != '(' && *cur != ')' )
+                    ++cur;
+            }
+        }
+    }
+
+    return false;                   // the board is not closed
+}
+
+
+void PCB_PARSER::parseBoardSections( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections )
+{
+    size_t first = 0;
+
+    while( first < aSections.size() )
+    {
+        size_t last = first;
+
+        while( last < aSections.size() && isItemSection( aSections[last].m_token ) )
+            ++last;
+
+        if( last > first )
+        {
+            parseItemSections( aText, aSections, first, last );
+            first = last;
+            continue;
+        }
+
+        // The settings change the state of the parser, so they are parsed once the items
+        // before them are on the board, and before the items after them are parsed
+        const BOARD_SECTION& section = aSections[first];
+        BOARD_TEXT_READER    reader( aText.m_chars.data(), &aText.m_lines[section.m_firstLine],
+                                     section.m_lastLine - section.m_firstLine + 1,
+                                     aText.m_firstLineNum + section.m_firstLine, aText.m_source );
+        PCB_READER_GUARD     guard( this, &reader );
+
+        NeedLEFT();
+        parseBoardSettings( (T) NextTok() );
+        first++;
+    }
+}
+
+
+void PCB_PARSER::parseItemSections( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections,
+                                    size_t aFirst, size_t aLast )
+{
+    std::atomic<size_t> nextSection( aFirst );
+    std::mutex          layersLock;
+
+    auto parseSection = [&]( PCB_PARSER& aParser, BOARD_SECTION& aSection )
+                        {
+                            BOARD_TEXT_READER reader( aText.m_chars.data(),
+                                                      &aText.m_lines[aSection.m_firstLine],
+                                                      aSection.m_lastLine - aSection.m_firstLine + 1,
+                                                      aText.m_firstLineNum + aSection.m_firstLine,
+                                                      aText.m_source );
+                            PCB_READER_GUARD  guard( &aParser, &reader );
+
+                            // A previous section may have left the lexer at the end of file
+                            aParser.curTok = DSN_NONE;
+                            aParser.NeedLEFT();
+                            aSection.m_item = aParser.parseBoardItem( (T) aParser.NextTok() );
+                        };
+
+    auto work = [&]()
+                {
+                    // The parsers have their own lexer, and a copy of the state set by the
+                    // settings sections
+                    PCB_PARSER parser;
+
+                    parser.m_board = m_board;
+                    parser.m_layerIndices = m_layerIndices;
+                    parser.m_layerMasks = m_layerMasks;
+                    parser.m_netCodes = m_netCodes;
+                    parser.m_tooRecent = m_tooRecent;
+                    parser.m_requiredVersion = m_requiredVersion;
+                    parser.m_showLegacyZoneWarning = m_showLegacyZoneWarning;
+                    parser.m_isWorker = true;
+
+                    for( size_t ii = nextSection++; ii < aLast; ii = nextSection++ )
+                    {
+                        try
+                        {
+                            parseSection( parser, aSections[ii] );
+                        }
+                        catch( const PCB_PARSER_DEFERRED& )
+                        {
+                            aSections[ii].m_deferred = true;
+                        }
+                        catch( ... )
+                        {
+                            aSections[ii].m_error = std::current_exception();
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lock( layersLock );
+                    m_undefinedLayers.insert( parser.m_undefinedLayers.begin(),
+                                              parser.m_undefinedLayers.end() );
+                };
+
+    THREAD_POOL& pool = GetKiCadThreadPool();
+    size_t       parallelism = std::min<size_t>( pool.GetThreadCount() + 1,
+                                                 ( aLast - aFirst ) / SECTIONS_PER_THREAD + 1 );
+
+    if( parallelism <= 1 )
+        work();
+    else
+        pool.RunParallel( work, parallelism );
+
+    // Add the items in file order, as the serial parser does
+    try
+    {
+        for( size_t ii = aFirst; ii < aLast; ii++ )
+        {
+            BOARD_SECTION& section = aSections[ii];
+
+            if( section.m_error )
+                std::rethrow_exception( section.m_error );
+
+            if( section.m_deferred )
+                parseSection( *this, section );
+
+            m_board->Add( section.m_item, itemAddMode( section.m_token ) );
+            section.m_item = nullptr;
+        }
+    }
+    catch( ... )
+    {
+        for( size_t ii = aFirst; ii < aLast; ii++ )
+            delete aSections[ii].m_item;
+
+        throw;
+    }
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3769,6 +4205,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
 
                     if( token == T_segment )    // deprecated
                     {
+                        if( m_isWorker )
+                            throw PCB_PARSER_DEFERRED();
+
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
                         if( m_showLegacyZoneWarning )
                         {
@@ -4027,6 +4466,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
             zone->SetNetCode( net->GetNet() );
         else    // Not existing net: add a new net to keep trace of the zone netname
         {
+            if( m_isWorker )
+                throw PCB_PARSER_DEFERRED();
+
             int newnetcode = m_board->GetNetCount();
             net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
             m_board->Add( net );
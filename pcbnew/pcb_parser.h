@@ -31,6 +31,7 @@
 #define _PCBNEW_PARSER_H_
 
 #include <convert_to_biu.h>                      // IU_PER_MM
+#include <decimal_parser.h>
 #include <hashtables.h>
 #include <layers_id_colors_and_visibility.h>     // PCB_LAYER_ID
 #include <math/util.h>                           // KiROUND, Clamp
@@ -81,6 +82,13 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    ///> true for the parsers of the threads of the parallel board loader, which leave to the
+    ///> main parser the sections changing the board or asking the user
+    bool                m_isWorker;
+
+    struct BOARD_TEXT;
+    struct BOARD_SECTION;
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -171,6 +179,44 @@ class PCB_PARSER : public PCB_LEXER
      */
     BOARD*          parseBOARD_unchecked();
 
+    /**
+     * Function parseBoardSettings
+     * parses a section of the board which is not an item: general, page, layers, setup, nets...
+     */
+    void            parseBoardSettings( PCB_KEYS_T::T aToken );
+
+    /**
+     * Function parseBoardItem
+     * parses a section of the board which is an item (module, track, zone, drawing...).
+     * @return the new item, or NULL if aToken is not an item section.
+     */
+    BOARD_ITEM*     parseBoardItem( PCB_KEYS_T::T aToken );
+
+    /**
+     * Function readBoardText
+     * reads the rest of the board after the header, the parsed part of the current line
+     * being replaced by blanks to keep the token offsets.
+     */
+    void            readBoardText( BOARD_TEXT& aText );
+
+    /**
+     * Function splitBoardText
+     * finds the top level sections of aText, with a lexical scan only.
+     * @return false if the text cannot be split in whole lines sections, which the serial
+     *  parser will report as an error if it is not valid.
+     */
+    bool            splitBoardText( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections );
+
+    /**
+     * Function parseBoardSections
+     * parses the sections of a board in file order, the runs of item sections on the thread
+     * pool.  The items of a run are added to the board once all of them are parsed.
+     */
+    void            parseBoardSections( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections );
+
+    void            parseItemSections( BOARD_TEXT& aText, std::vector<BOARD_SECTION>& aSections,
+                                       size_t aFirst, size_t aLast );
+
 
     /**
      * Function lookUpLayer
@@ -260,29 +306,33 @@ class PCB_PARSER : public PCB_LEXER
         // to confirm or experiment.  Use a similar strategy in both places, here
         // and in the test program. Make that program with:
         // $ make test-nm-biu-to-ascii-mm-round-tripping
-        auto retval = parseDouble() * IU_PER_MM;
 
         // N.B. we currently represent board units as integers.  Any values that are
         // larger or smaller than those board units represent undefined behavior for
         // the system.  We limit values to the largest that is visible on the screen
         // This is the diagonal distance of the full screen ~1.5m
         double int_limit = std::numeric_limits<int>::max() * 0.7071;    // 0.7071 = roughly 1/sqrt(2)
+
+        // The values written by KiCad have at most 6 decimals, so they are an exact count
+        // of nanometers: read them without the double round trip, which gives the same.
+        DECIMAL   decimal;
+        long long value;
+
+        if( ParseDecimal( CurStr(), decimal ) && decimal.ToScaledInt( IU_PER_MM, value )
+                && value >= -int_limit && value <= int_limit )
+        {
+            return (int) value;
+        }
+
+        auto retval = parseDouble() * IU_PER_MM;
+
         return KiROUND( Clamp<double>( -int_limit, retval, int_limit ) );
     }
 
     inline int parseBoardUnits( const char* aExpected )
     {
-        auto retval = parseDouble( aExpected ) * IU_PER_MM;
-
-        // N.B. we currently represent board units as integers.  Any values that are
-        // larger or smaller than those board units represent undefined behavior for
-        // the system.  We limit values to the largest that is visible on the screen
-        double int_limit = std::numeric_limits<int>::max() * 0.7071;
-
-        // Use here KiROUND, not KIROUND (see comments about them)
-        // when having a function as argument, because it will be called twice
-        // with KIROUND
-        return KiROUND( Clamp<double>( -int_limit, retval, int_limit ) );
+        NeedNUMBER( aExpected );
+        return parseBoardUnits();
     }
 
     inline int parseBoardUnits( PCB_KEYS_T::T aToken )
@@ -319,7 +369,8 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_isWorker( false )
     {
         init();
     }
@@ -34,6 +34,7 @@
 
 #include <pcbnew.h>
 #include <board_design_settings.h>
+#include <board_memory_usage.h>
 #include <layers_id_colors_and_visibility.h>
 
 #include <id.h>
@@ -170,10 +171,25 @@ PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
     m_Route_Layer_BOTTOM = B_Cu;
 
     InitDataPoints( aPageSizeIU );
+
+    m_undoMemory.Set( MEMORY_UNDO_STACK,
+            [this]()
+            {
+                size_t bytes = 0;
+
+                for( UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+                {
+                    for( PICKED_ITEMS_LIST* command : list->m_CommandsList )
+                        bytes += PickedItemsMemoryUsage( *command );
+                }
+
+                return bytes;
+            } );
 }
 
 
 PCB_SCREEN::~PCB_SCREEN()
 {
+    m_undoMemory.Reset();
     ClearUndoRedoList();
 }
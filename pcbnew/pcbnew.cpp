@@ -54,7 +54,10 @@
 #include <footprint_wizard_frame.h>
 #include <footprint_preview_panel.h>
 #include <footprint_info_impl.h>
+#include <kicad_clipboard.h>
 #include <dialog_configure_paths.h>
+#include <profile.h>
+#include <thread_pool.h>
 #include "invoke_pcb_dialog.h"
 #include "dialog_global_fp_lib_table_config.h"
 
@@ -85,6 +88,13 @@ static struct IFACE : public KIFACE_I
 #if defined( KICAD_SCRIPTING )
             // give the scripting helpers access to our frame
             ScriptingSetPcbEditFrame( frame );
+
+            // The Python plugins are loaded once the frame is shown, so that it is painted
+            // without waiting for them
+            frame->CallAfter( [frame]()
+                    {
+                        frame->PythonPluginsLoad();
+                    } );
 #endif
 
             if( Kiface().IsSingle() )
@@ -208,6 +218,13 @@ PGM_BASE* PgmOrNull()
 
 
 #if defined( KICAD_SCRIPTING )
+///> Set once the Python interpreter is initialized
+static bool s_scriptingReady = false;
+
+///> Set once the pcbnew module and the Python plugins are loaded
+static bool s_pluginsLoaded = false;
+
+
 static bool scriptingSetup()
 {
 
@@ -276,33 +293,52 @@ static bool scriptingSetup()
 
 #endif
 
-    if( !pcbnewInitPythonScripting( TO_UTF8( PyScriptingPath() ) ) )
+    if( !pcbnewInitPythonScripting() )
     {
         wxLogError( "pcbnewInitPythonScripting() failed." );
         return false;
     }
 
+    s_scriptingReady = true;
     return true;
 }
 #endif  // KICAD_SCRIPTING
 
 
+void PythonPluginsLoadBase()
+{
+#if defined( KICAD_SCRIPTING )
+    if( !s_pluginsLoaded )
+    {
+        SCOPED_STARTUP_PHASE phase( process, wxT( "Python plugins" ) );
+
+        PythonPluginsReloadBase();
+    }
+#endif
+}
+
+
 void PythonPluginsReloadBase()
 {
 #if defined( KICAD_SCRIPTING )
+    if( !s_scriptingReady )
+        return;
+
     // Reload plugin list: reload Python plugins if they are newer than the already loaded,
     // and load new plugins
     char cmd[1024];
 
-    snprintf( cmd, sizeof( cmd ), "pcbnew.LoadPlugins(\"%s\")", TO_UTF8( PyScriptingPath() ) );
+    snprintf( cmd, sizeof( cmd ), "import pcbnew\n"
+              "pcbnew.LoadPlugins(\"%s\")", TO_UTF8( PyScriptingPath() ) );
 
     PyLOCK lock;
 
-    // ReRun the Python method pcbnew.LoadPlugins (already called when starting Pcbnew)
     int retv = PyRun_SimpleString( cmd );
 
     if( retv != 0 )
         wxLogError( "Python error %d occurred running command:\n\n`%s`", retv, cmd );
+
+    s_pluginsLoaded = true;
 #endif
 }
 
@@ -323,12 +359,18 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
 {
     // This is process-level-initialization, not project-level-initialization of the DSO.
     // Do nothing in here pertinent to a project!
-    InitSettings( new PCBNEW_SETTINGS );
-    aProgram->GetSettingsManager().RegisterSettings( KifaceSettings() );
+    {
+        SCOPED_STARTUP_PHASE phase( aProgram, wxT( "Pcbnew settings" ) );
 
-    start_common( aCtlBits );
+        InitSettings( new PCBNEW_SETTINGS );
+        aProgram->GetSettingsManager().RegisterSettings( KifaceSettings() );
 
-    wxFileName fn = FP_LIB_TABLE::GetGlobalTableFileName();
+        start_common( aCtlBits );
+    }
+
+    wxFileName        fn = FP_LIB_TABLE::GetGlobalTableFileName();
+    std::future<void> tableLoad;
+    int64_t           tableLoadTime = 0;
 
     if( !fn.FileExists() )
     {
@@ -337,14 +379,36 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         fpDialog.ShowModal();
     }
     else
+    {
+        // The global table is not related to a specific project.  All projects
+        // will use the same global table.  So the KIFACE::OnKifaceStart() contract
+        // of avoiding anything project specific is not violated here.
+        // It is parsed by a worker thread while the Python interpreter starts; nothing reads
+        // it before this function returns.
+        tableLoad = GetKiCadThreadPool().Submit(
+                [&]()
+                {
+                    PROF_COUNTER timer;
+
+                    GFootprintTable.Load( fn.GetFullPath() );
+                    tableLoadTime = static_cast<int64_t>( timer.msecs() * 1000 );
+                } );
+    }
+
+#if defined( KICAD_SCRIPTING )
+    {
+        SCOPED_STARTUP_PHASE phase( aProgram, wxT( "Python interpreter" ) );
+
+        scriptingSetup();
+    }
+#endif
+
+    if( tableLoad.valid() )
     {
         try
         {
-            // The global table is not related to a specific project.  All projects
-            // will use the same global table.  So the KIFACE::OnKifaceStart() contract
-            // of avoiding anything project specific is not violated here.
-            if( !FP_LIB_TABLE::LoadGlobalTable( GFootprintTable ) )
-                return false;
+            tableLoad.get();
+            aProgram->AddStartupPhase( wxT( "Global footprint library table" ), tableLoadTime );
         }
         catch( const IO_ERROR& ioe )
         {
@@ -360,10 +424,6 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         }
     }
 
-#if defined( KICAD_SCRIPTING )
-    scriptingSetup();
-#endif
-
     return true;
 }
 
@@ -379,6 +439,8 @@ void IFACE::OnKifaceEnd()
         pcbnewFinishPythonScripting();
 #endif
 
+    CLIPBOARD_IO::FlushSnapshot();
+
     end_common();
 }
 
@@ -47,6 +47,14 @@
 /// List of segments of the trace currently being drawn.
 class TRACK;
 
+/**
+ * Helper function PythonPluginsLoadBase
+ * Load the pcbnew Python module and the Python plugins on first use: they are not loaded
+ * when Pcbnew starts, so that its first frame is shown without waiting for them.
+ * Do nothing if they are already loaded.
+ */
+void PythonPluginsLoadBase();
+
 /**
  * Helper function PythonPluginsReloadBase
  * Reload Python plugins if they are newer than
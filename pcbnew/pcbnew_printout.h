@@ -97,6 +97,13 @@ public:
         m_drillMarkSize = aSize;
     }
 
+    PAINTER* Clone( GAL* aGal ) const override
+    {
+        PCB_PRINT_PAINTER* painter = new PCB_PRINT_PAINTER( *this );
+        painter->SetGAL( aGal );
+        return painter;
+    }
+
 protected:
     int getDrillShape( const D_PAD* aPad ) const override;
 
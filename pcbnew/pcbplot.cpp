@@ -491,6 +491,45 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+bool PLOT_CONTROLLER::PlotLayers( const LSEQ& aLayers, PLOT_FORMAT aFormat,
+                                  const wxString& aSheetDesc )
+{
+    GetPlotOptions().SetFormat( aFormat );
+
+    // Ensure that the previous plot is closed
+    ClosePlot();
+
+    wxString   outputDirName = GetPlotOptions().GetOutputDirectory() ;
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString   boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return false;
+
+    std::vector<PLOT_LAYER_JOB> jobs;
+
+    for( PCB_LAYER_ID layer : aLayers )
+    {
+        wxFileName fn( boardFilename );
+        wxString   fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( GetPlotOptions().GetFormat() == PLOT_FORMAT::GERBER
+                && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, outputDir.GetPath(), m_board->GetLayerName( layer ), fileExt );
+
+        PLOT_LAYER_JOB job;
+        job.m_Layer = layer;
+        job.m_FullFileName = fn.GetFullPath();
+        job.m_SheetDesc = aSheetDesc;
+        jobs.push_back( job );
+    }
+
+    return PlotBoardLayers( m_board, GetPlotOptions(), jobs ) == (int) jobs.size();
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
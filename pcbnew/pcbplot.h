@@ -38,6 +38,8 @@
 #include <settings/settings_manager.h>
 #include <wx/filename.h>
 
+#include <vector>
+
 class PLOTTER;
 class TEXTE_PCB;
 class D_PAD;
@@ -50,6 +52,7 @@ class TEXTE_MODULE;
 class ZONE_CONTAINER;
 class BOARD;
 class REPORTER;
+class PROGRESS_REPORTER;
 
 
 // Define min and max reasonable values for plot/print scale
@@ -158,6 +161,36 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * A layer to plot in its own file by PlotBoardLayers()
+ */
+struct PLOT_LAYER_JOB
+{
+    PCB_LAYER_ID m_Layer;
+    wxString     m_FullFileName;
+    wxString     m_SheetDesc;
+    bool         m_Created = false;     ///< set by PlotBoardLayers() if the file is created
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots each layer of aJobs in its own file, like StartPlotBoard() followed by
+ * PlotOneBoardLayer(), with one plotter per layer.  The layers are plotted
+ * concurrently on the thread pool: the board is only read, and must not be modified
+ * until this function returns.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options, common to all the layers
+ * @param aJobs = the layers to plot, and their files
+ * @param aProgressReporter = an optional progress reporter, advanced once per layer;
+ *                            the calling thread keeps it refreshed while the layers are
+ *                            plotted, and the layers not yet started when it is cancelled
+ *                            are not plotted
+ * @return the number of files created
+ */
+int PlotBoardLayers( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts,
+                     std::vector<PLOT_LAYER_JOB>& aJobs,
+                     PROGRESS_REPORTER* aProgressReporter = nullptr );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
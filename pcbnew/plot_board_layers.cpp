@@ -29,6 +29,9 @@
  */
 
 
+#include <atomic>
+#include <map>
+
 #include <fctsys.h>
 #include <common.h>
 #include <plotter.h>
@@ -53,6 +56,9 @@
 #include <pcbnew.h>
 #include <pcbplot.h>
 #include <gbr_metadata.h>
+#include <kicad_plugin.h>
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -130,8 +136,9 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
     aPlotter->StartBlock( NULL );
 
     // Plot all zones together so we don't end up with divots where zones touch each other.
-    ZONE_CONTAINER* zone = nullptr;
-    SHAPE_POLY_SET aggregateArea;
+    ZONE_CONTAINER*                    zone = nullptr;
+    SHAPE_POLY_SET                     aggregateArea;
+    std::vector<const SHAPE_POLY_SET*> zoneFills;
 
     for( ZONE_CONTAINER* candidate : aBoard->Zones() )
     {
@@ -141,11 +148,12 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
         if( !zone )
             zone = candidate;
 
-        aggregateArea.BooleanAdd( candidate->GetFilledPolysList(), SHAPE_POLY_SET::PM_FAST );
+        zoneFills.push_back( &candidate->GetFilledPolysList() );
     }
 
     if( zone )
     {
+        aggregateArea.BooleanAdd( zoneFills, SHAPE_POLY_SET::PM_FAST );
         aggregateArea.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
         itemplotter.PlotFilledAreas( zone, aggregateArea );
     }
@@ -292,197 +300,312 @@ void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
 }
 
 
-/* Plot a copper layer or mask.
- * Silk screen layers are not plotted here.
+/*
+ * Plot the graphic items of a footprint on the layers of aLayerMask (not its texts)
  */
-void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
-                        LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt )
+static void plotFootprintGraphicItems( BRDITEMS_PLOTTER& aItemPlotter, MODULE* aModule,
+                                       LSET aLayerMask )
 {
-    BRDITEMS_PLOTTER itemplotter( aPlotter, aBoard, aPlotOpt );
+    for( auto item : aModule->GraphicalItems() )
+    {
+        if( item->Type() == PCB_MODULE_EDGE_T && aLayerMask[ item->GetLayer() ] )
+            aItemPlotter.Plot_1_EdgeModule( (EDGE_MODULE*) item );
+    }
+}
 
-    itemplotter.SetLayerSet( aLayerMask );
 
+/*
+ * Plot the pads of a footprint on the layers of aLayerMask, with the margins of these layers
+ */
+static void plotFootprintPads( BRDITEMS_PLOTTER& aItemPlotter, BOARD* aBoard, MODULE* aModule,
+                               LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt )
+{
     EDA_DRAW_MODE_T plotMode = aPlotOpt.GetPlotMode();
 
-     // Plot edge layer and graphic items
-    itemplotter.PlotBoardGraphicItems();
-
-    // Draw footprint texts:
-    for( auto module : aBoard->Modules() )
+    for( auto pad : aModule->Pads() )
     {
-        if( ! itemplotter.PlotAllTextsModule( module ) )
+        if( (pad->GetLayerSet() & aLayerMask) == 0 )
+            continue;
+
+        wxSize margin;
+        double width_adj = 0;
+
+        if( ( aLayerMask & LSET::AllCuMask() ).any() )
+            width_adj =  aItemPlotter.getFineWidthAdj();
+
+        static const LSET speed( 4, B_Mask, F_Mask, B_Paste, F_Paste );
+
+        LSET anded = ( speed & aLayerMask );
+
+        if( anded == LSET( F_Mask ) || anded == LSET( B_Mask ) )
         {
-            wxLogMessage( _( "Your BOARD has a bad layer number for footprint %s" ),
-                          module->GetReference() );
+            margin.x = margin.y = pad->GetSolderMaskMargin();
+        }
+        else if( anded == LSET( F_Paste ) || anded == LSET( B_Paste ) )
+        {
+            margin = pad->GetSolderPasteMargin();
         }
-    }
 
-    // Draw footprint other graphic items:
-    for( auto module : aBoard->Modules() )
-    {
-        for( auto item : module->GraphicalItems() )
+        // Now offset the pad size by margin + width_adj
+        // this is easy for most shapes, but not for a trapezoid or a custom shape
+        wxSize padPlotsSize;
+        wxSize extraSize = margin * 2;
+        extraSize.x += width_adj;
+        extraSize.y += width_adj;
+
+        // The inflated/deflated pad shape is plotted from a copy of the pad: the board is
+        // not modified, so its layers can be plotted from several threads
+        D_PAD dummy( *pad );
+
+        if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
+        {   // The easy way is to use BuildPadPolygon to calculate
+            // size and delta of the trapezoidal pad after offseting:
+            wxPoint coord[4];
+            pad->BuildPadPolygon( coord, extraSize/2, 0.0 );
+            // Calculate the size and delta from polygon corners coordinates:
+            // coord[0] is the lower left
+            // coord[1] is the upper left
+            // coord[2] is the upper right
+            // coord[3] is the lower right
+
+            // the size is the distance between middle of segments
+            // (left/right or top/bottom)
+            // size X is the dist between left and right middle points:
+            padPlotsSize.x = ( ( -coord[0].x + coord[3].x )     // the lower segment X length
+                             + ( -coord[1].x + coord[2].x ) )   // the upper segment X length
+                             / 2;           // the Y size is the half sum
+            // size Y is the dist between top and bottom middle points:
+            padPlotsSize.y = ( ( coord[0].y - coord[1].y )      // the left segment Y lenght
+                             + ( coord[3].y - coord[2].y ) )    // the right segment Y lenght
+                             / 2;           // the Y size is the half sum
+
+            // calculate the delta ( difference of lenght between 2 opposite edges )
+            // The delta.x is the delta along the X axis, therefore the delta of Y lenghts
+            wxSize delta;
+
+            if( coord[0].y != coord[3].y )
+                delta.x = coord[0].y - coord[3].y;
+            else
+                delta.y = coord[1].x - coord[0].x;
+
+            dummy.SetDelta( delta );
+        }
+        else
+            padPlotsSize = pad->GetSize() + extraSize;
+
+        // Don't draw a null size item :
+        if( padPlotsSize.x <= 0 || padPlotsSize.y <= 0 )
+            continue;
+
+        COLOR4D color = COLOR4D::BLACK;
+
+        if( pad->GetLayerSet()[B_Cu] )
+           color = aPlotOpt.ColorSettings()->GetColor( LAYER_PAD_BK );
+
+        if( pad->GetLayerSet()[F_Cu] )
+            color = color.LegacyMix( aPlotOpt.ColorSettings()->GetColor( LAYER_PAD_FR ) );
+
+        switch( pad->GetShape() )
         {
-            if( item->Type() == PCB_MODULE_EDGE_T && aLayerMask[ item->GetLayer() ] )
-                itemplotter.Plot_1_EdgeModule( (EDGE_MODULE*) item );
+        case PAD_SHAPE_CIRCLE:
+        case PAD_SHAPE_OVAL:
+            dummy.SetSize( padPlotsSize );
+
+            if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
+                ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
+                ( dummy.GetSize() == dummy.GetDrillSize() ) &&
+                ( dummy.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                break;
+
+            aItemPlotter.PlotPad( &dummy, color, plotMode );
+            break;
+
+        case PAD_SHAPE_RECT:
+            if( margin.x > 0 )
+            {
+                dummy.SetShape( PAD_SHAPE_ROUNDRECT );
+                dummy.SetSize( padPlotsSize );
+                dummy.SetRoundRectCornerRadius( margin.x );
+            }
+            // Fall through
+        case PAD_SHAPE_TRAPEZOID:
+        case PAD_SHAPE_ROUNDRECT:
+        case PAD_SHAPE_CHAMFERED_RECT:
+            dummy.SetSize( padPlotsSize );
+            aItemPlotter.PlotPad( &dummy, color, plotMode );
+            break;
+
+        case PAD_SHAPE_CUSTOM:
+        {
+            // inflate/deflate a custom shape is a bit complex.
+            // so build a similar pad shape, and inflate/deflate the polygonal shape
+            SHAPE_POLY_SET shape;
+            pad->MergePrimitivesAsPolygon( &shape );
+            // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
+            // which can create bad shapes if margin.x is < 0
+            int maxError = aBoard->GetDesignSettings().m_MaxError;
+            int numSegs = std::max( GetArcToSegmentCount( margin.x, maxError, 360.0 ), 6 );
+            shape.InflateWithLinkedHoles( margin.x, numSegs, SHAPE_POLY_SET::PM_FAST );
+            dummy.DeletePrimitivesList();
+            dummy.AddPrimitivePoly( shape, 0, false );
+            dummy.MergePrimitivesAsPolygon();
+
+            // Be sure the anchor pad is not bigger than the deflated shape because this
+            // anchor will be added to the pad shape when plotting the pad. So now the
+            // polygonal shape is built, we can clamp the anchor size
+            if( margin.x < 0 )  // we expect margin.x = margin.y for custom pads
+                dummy.SetSize( padPlotsSize );
+
+            aItemPlotter.PlotPad( &dummy, color, plotMode );
+        }
+            break;
         }
     }
+}
+
+
+/*
+ * @return a description of what a footprint plots, regardless of its position, orientation,
+ * texts and nets: two footprints having the same one are plotted identically up to their
+ * placement
+ */
+static std::string footprintPlotKey( const MODULE* aModule )
+{
+    MODULE copy( *aModule );
+    copy.SetPosition( wxPoint( 0, 0 ) );
+    copy.SetOrientation( 0 );
+    copy.SetLastEditTime( 0 );
+
+    // The texts are plotted for each footprint
+    for( TEXTE_MODULE* text : { &copy.Reference(), &copy.Value() } )
+    {
+        text->SetText( wxEmptyString );
+        text->SetPos0( wxPoint( 0, 0 ) );
+    }
+
+    PCB_IO io( CTL_FOR_LIBRARY );
+    io.Format( &copy );
+
+    return io.GetStringOutput( true );
+}
+
+
+/*
+ * @return the groups of at least 2 footprints of aBoard plotted identically on the layers of
+ * aLayerMask, up to their position and orientation (footprints having nothing to plot on
+ * these layers excepted)
+ */
+static std::vector<std::vector<MODULE*>> findIdenticalFootprints( BOARD* aBoard,
+                                                                  LSET aLayerMask )
+{
+    // Only the instances of a same library footprint are worth comparing
+    std::map<wxString, std::vector<MODULE*>> candidates;
 
-    // Plot footprint pads
     for( auto module : aBoard->Modules() )
     {
-        aPlotter->StartBlock( NULL );
+        bool plotted = false;
 
         for( auto pad : module->Pads() )
-        {
-            if( (pad->GetLayerSet() & aLayerMask) == 0 )
-                continue;
+            plotted |= ( pad->GetLayerSet() & aLayerMask ).any();
 
-            wxSize margin;
-            double width_adj = 0;
+        for( auto item : module->GraphicalItems() )
+            plotted |= item->Type() == PCB_MODULE_EDGE_T && aLayerMask[ item->GetLayer() ];
 
-            if( ( aLayerMask & LSET::AllCuMask() ).any() )
-                width_adj =  itemplotter.getFineWidthAdj();
+        if( plotted )
+            candidates[ module->GetFPID().GetUniStringLibId() ].push_back( module );
+    }
 
-            static const LSET speed( 4, B_Mask, F_Mask, B_Paste, F_Paste );
+    std::vector<std::vector<MODULE*>> groups;
 
-            LSET anded = ( speed & aLayerMask );
+    for( const auto& candidate : candidates )
+    {
+        if( candidate.second.size() < 2 )
+            continue;
 
-            if( anded == LSET( F_Mask ) || anded == LSET( B_Mask ) )
-            {
-                margin.x = margin.y = pad->GetSolderMaskMargin();
-            }
-            else if( anded == LSET( F_Paste ) || anded == LSET( B_Paste ) )
-            {
-                margin = pad->GetSolderPasteMargin();
-            }
+        std::map<std::string, std::vector<MODULE*>> identical;
 
-            // Now offset the pad size by margin + width_adj
-            // this is easy for most shapes, but not for a trapezoid or a custom shape
-            wxSize padPlotsSize;
-            wxSize extraSize = margin * 2;
-            extraSize.x += width_adj;
-            extraSize.y += width_adj;
-
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
-            PAD_SHAPE_T padShape = pad->GetShape();
-            double padCornerRadius = pad->GetRoundRectCornerRadius();
-
-            if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
-            {   // The easy way is to use BuildPadPolygon to calculate
-                // size and delta of the trapezoidal pad after offseting:
-                wxPoint coord[4];
-                pad->BuildPadPolygon( coord, extraSize/2, 0.0 );
-                // Calculate the size and delta from polygon corners coordinates:
-                // coord[0] is the lower left
-                // coord[1] is the upper left
-                // coord[2] is the upper right
-                // coord[3] is the lower right
-
-                // the size is the distance between middle of segments
-                // (left/right or top/bottom)
-                // size X is the dist between left and right middle points:
-                padPlotsSize.x = ( ( -coord[0].x + coord[3].x )     // the lower segment X length
-                                 + ( -coord[1].x + coord[2].x ) )   // the upper segment X length
-                                 / 2;           // the Y size is the half sum
-                // size Y is the dist between top and bottom middle points:
-                padPlotsSize.y = ( ( coord[0].y - coord[1].y )      // the left segment Y lenght
-                                 + ( coord[3].y - coord[2].y ) )    // the right segment Y lenght
-                                 / 2;           // the Y size is the half sum
-
-                // calculate the delta ( difference of lenght between 2 opposite edges )
-                // The delta.x is the delta along the X axis, therefore the delta of Y lenghts
-                wxSize delta;
-
-                if( coord[0].y != coord[3].y )
-                    delta.x = coord[0].y - coord[3].y;
-                else
-                    delta.y = coord[1].x - coord[0].x;
+        for( MODULE* module : candidate.second )
+            identical[ footprintPlotKey( module ) ].push_back( module );
 
-                pad->SetDelta( delta );
-            }
-            else
-                padPlotsSize = pad->GetSize() + extraSize;
+        for( auto& group : identical )
+        {
+            if( group.second.size() >= 2 )
+                groups.push_back( std::move( group.second ) );
+        }
+    }
 
-            // Don't draw a null size item :
-            if( padPlotsSize.x <= 0 || padPlotsSize.y <= 0 )
-                continue;
+    return groups;
+}
 
-            COLOR4D color = COLOR4D::BLACK;
 
-            if( pad->GetLayerSet()[B_Cu] )
-               color = aPlotOpt.ColorSettings()->GetColor( LAYER_PAD_BK );
+/* Plot a copper layer or mask.
+ * Silk screen layers are not plotted here.
+ */
+void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
+                        LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt )
+{
+    BRDITEMS_PLOTTER itemplotter( aPlotter, aBoard, aPlotOpt );
 
-            if( pad->GetLayerSet()[F_Cu] )
-                color = color.LegacyMix( aPlotOpt.ColorSettings()->GetColor( LAYER_PAD_FR ) );
+    itemplotter.SetLayerSet( aLayerMask );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
+    EDA_DRAW_MODE_T plotMode = aPlotOpt.GetPlotMode();
 
-            switch( pad->GetShape() )
-            {
-            case PAD_SHAPE_CIRCLE:
-            case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+     // Plot edge layer and graphic items
+    itemplotter.PlotBoardGraphicItems();
 
-                if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
-                    break;
+    // Draw footprint texts:
+    for( auto module : aBoard->Modules() )
+    {
+        if( ! itemplotter.PlotAllTextsModule( module ) )
+        {
+            wxLogMessage( _( "Your BOARD has a bad layer number for footprint %s" ),
+                          module->GetReference() );
+        }
+    }
 
-                itemplotter.PlotPad( pad, color, plotMode );
-                break;
+    // Footprints plotted identically, up to their position and orientation, are defined
+    // once and placed, when the plotter can do it (the block definition of each footprint)
+    std::map<MODULE*, int> blockDefinitions;
 
-            case PAD_SHAPE_RECT:
-                if( margin.x > 0 )
-                {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetSize( padPlotsSize );
-                    pad->SetRoundRectCornerRadius( margin.x );
-                }
-                // Fall through
-            case PAD_SHAPE_TRAPEZOID:
-            case PAD_SHAPE_ROUNDRECT:
-            case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, plotMode );
-                break;
+    if( aPlotter->CanReuseBlocks() )
+    {
+        for( const std::vector<MODULE*>& group : findIdenticalFootprints( aBoard, aLayerMask ) )
+        {
+            MODULE model( *group[0] );
+            model.SetPosition( wxPoint( 0, 0 ) );
+            model.SetOrientation( 0 );
 
-            case PAD_SHAPE_CUSTOM:
-            {
-                // inflate/deflate a custom shape is a bit complex.
-                // so build a similar pad shape, and inflate/deflate the polygonal shape
-                D_PAD dummy( *pad );
-                SHAPE_POLY_SET shape;
-                pad->MergePrimitivesAsPolygon( &shape );
-                // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
-                // which can create bad shapes if margin.x is < 0
-                int maxError = aBoard->GetDesignSettings().m_MaxError;
-                int numSegs = std::max( GetArcToSegmentCount( margin.x, maxError, 360.0 ), 6 );
-                shape.InflateWithLinkedHoles( margin.x, numSegs, SHAPE_POLY_SET::PM_FAST );
-                dummy.DeletePrimitivesList();
-                dummy.AddPrimitivePoly( shape, 0, false );
-                dummy.MergePrimitivesAsPolygon();
-
-                // Be sure the anchor pad is not bigger than the deflated shape because this
-                // anchor will be added to the pad shape when plotting the pad. So now the
-                // polygonal shape is built, we can clamp the anchor size
-                if( margin.x < 0 )  // we expect margin.x = margin.y for custom pads
-                    dummy.SetSize( padPlotsSize );
-
-                itemplotter.PlotPad( &dummy, color, plotMode );
-            }
-                break;
-            }
+            int id = aPlotter->StartBlockDefinition();
+            plotFootprintGraphicItems( itemplotter, &model, aLayerMask );
+            plotFootprintPads( itemplotter, aBoard, &model, aLayerMask, aPlotOpt );
+            aPlotter->EndBlockDefinition();
 
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( tmppadsize );
-            pad->SetDelta( deltaSize );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
+            for( MODULE* module : group )
+                blockDefinitions[ module ] = id;
         }
+    }
+
+    // Draw footprint other graphic items:
+    for( auto module : aBoard->Modules() )
+    {
+        if( !blockDefinitions.count( module ) )
+            plotFootprintGraphicItems( itemplotter, module, aLayerMask );
+    }
+
+    // Plot footprint pads
+    for( auto module : aBoard->Modules() )
+    {
+        auto definition = blockDefinitions.find( module );
 
+        if( definition != blockDefinitions.end() )
+        {
+            aPlotter->PlaceBlockDefinition( definition->second, module->GetPosition(),
+                                            module->GetOrientation() );
+            continue;
+        }
+
+        aPlotter->StartBlock( NULL );
+        plotFootprintPads( itemplotter, aBoard, module, aLayerMask, aPlotOpt );
         aPlotter->EndBlock( NULL );
     }
 
@@ -1254,3 +1377,76 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+int PlotBoardLayers( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts,
+                     std::vector<PLOT_LAYER_JOB>& aJobs, PROGRESS_REPORTER* aProgressReporter )
+{
+    // The C locale is global: it is kept for all the worker threads until the end
+    LOCALE_IO           toggle;
+    std::atomic<size_t> nextJob( 0 );
+    std::atomic<size_t> finishedJobs( 0 );
+    std::atomic<int>    createdFiles( 0 );
+    std::atomic<bool>   cancelled( false );
+
+    auto work =
+            [&]()
+            {
+                for( size_t ii = nextJob.fetch_add( 1 ); ii < aJobs.size();
+                     ii = nextJob.fetch_add( 1 ) )
+                {
+                    PLOT_LAYER_JOB& job = aJobs[ii];
+                    PCB_PLOT_PARAMS plotOpts = aPlotOpts;
+
+                    job.m_Created = false;
+
+                    try
+                    {
+                        std::unique_ptr<PLOTTER> plotter;
+
+                        if( !cancelled )
+                            plotter.reset( StartPlotBoard( aBoard, &plotOpts, job.m_Layer,
+                                                           job.m_FullFileName,
+                                                           job.m_SheetDesc ) );
+
+                        if( plotter )
+                        {
+                            PlotOneBoardLayer( aBoard, plotter.get(), job.m_Layer, plotOpts );
+                            plotter->EndPlot();
+
+                            job.m_Created = true;
+                            createdFiles.fetch_add( 1 );
+                        }
+                    }
+                    catch( ... )
+                    {
+                        // The file is reported as not created
+                    }
+
+                    if( aProgressReporter )
+                        aProgressReporter->AdvanceProgress();
+
+                    finishedJobs.fetch_add( 1 );
+                }
+            };
+
+    // The main thread keeps the progress reporter alive while the pool works
+    THREAD_POOL&                   pool = GetKiCadThreadPool();
+    std::vector<std::future<void>> tasks;
+
+    for( size_t ii = 0; ii < std::min<size_t>( pool.GetThreadCount(), aJobs.size() ); ++ii )
+        tasks.push_back( pool.Submit( work ) );
+
+    while( finishedJobs.load() < aJobs.size() )
+    {
+        if( aProgressReporter && !aProgressReporter->KeepRefreshing() )
+            cancelled = true;
+
+        wxMilliSleep( 30 );
+    }
+
+    for( std::future<void>& task : tasks )
+        task.wait();
+
+    return createdFiles.load();
+}
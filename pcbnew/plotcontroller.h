@@ -83,6 +83,16 @@ public:
      */
     bool PlotLayer();
 
+    /** Plot several layers, each one in its own file, concurrently.
+     * The current plot is closed first, and the files are named like OpenPlotfile()
+     * does, the suffix being the layer name
+     * @param aLayers is the list of layers to plot
+     * @param aFormat is the plot file format identifier
+     * @param aSheetDesc is the sheet description of the frame reference
+     * @return true if all the files were created
+     */
+    bool PlotLayers( const LSEQ& aLayers, PLOT_FORMAT aFormat, const wxString& aSheetDesc );
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
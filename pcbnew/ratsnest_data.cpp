@@ -33,6 +33,8 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <advanced_config.h>
+#include <geometry/delaunay_2d.h>
 #include <functional>
 using namespace std::placeholders;
 
@@ -155,6 +157,11 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::vector<CN_ANCHOR_PTR>  m_allNodes;
 
+    // The sweep triangulation and its buffers, kept from one update of the net to the next one
+    DELAUNAY_2D                      m_delaunay;
+    std::vector<VECTOR2I>            m_points;
+    std::vector<std::pair<int, int>> m_edges;
+
     std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
     {
         hed::TRIANGULATION triangulator;
@@ -204,13 +211,12 @@ public:
     const std::list<CN_EDGE> Triangulate()
     {
         std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
+        std::vector<int> uniqueIds;
 
         using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
         std::vector<ANCHOR_LIST> anchorChains;
 
-        triNodes.reserve( m_allNodes.size() );
+        uniqueIds.reserve( m_allNodes.size() );
         anchorChains.resize( m_allNodes.size() );
 
         std::sort( m_allNodes.begin(), m_allNodes.end(),
@@ -233,12 +239,7 @@ public:
         for( const auto& n : m_allNodes )
         {
             if( !prev || prev->Pos() != n->Pos() )
-            {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
-
-                tn->SetId( id );
-                triNodes.push_back( tn );
-            }
+                uniqueIds.push_back( id );
 
             id++;
             prev = n;
@@ -246,44 +247,90 @@ public:
 
         int prevId = 0;
 
-        for( const auto& n : triNodes )
+        for( int uniqueId : uniqueIds )
         {
-            for( int i = prevId; i < n->Id(); i++ )
+            for( int i = prevId; i < uniqueId; i++ )
                 anchorChains[prevId].push_back( m_allNodes[ i ] );
 
-            prevId = n->Id();
+            prevId = uniqueId;
         }
 
         for( int i = prevId; i < id; i++ )
             anchorChains[prevId].push_back( m_allNodes[ i ] );
 
-        if( triNodes.size() == 1 )
+        if( uniqueIds.size() == 1 )
         {
             return mstEdges;
         }
-        else if( areNodesColinear( triNodes ) )
+
+        bool triangulated = false;
+
+        if( ADVANCED_CFG::GetCfg().m_sweepRatsnestTriangulation )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
+            m_points.clear();
+
+            for( int uniqueId : uniqueIds )
+                m_points.push_back( m_allNodes[ uniqueId ]->Pos() );
+
+            // Fails only if the nodes are colinear
+            if( m_delaunay.Triangulate( m_points ) )
             {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                m_delaunay.GetEdges( m_edges );
+
+                for( const auto& e : m_edges )
+                {
+                    auto    src = m_allNodes[ uniqueIds[e.first] ];
+                    auto    dst = m_allNodes[ uniqueIds[e.second] ];
+
+                    mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                }
+
+                triangulated = true;
             }
         }
         else
         {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
+            std::list<hed::EDGE_PTR> triangEdges;
+            std::vector<hed::NODE_PTR> triNodes;
+
+            triNodes.reserve( uniqueIds.size() );
 
-            for( const auto& e : triangEdges )
+            for( int uniqueId : uniqueIds )
             {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+                const auto& n = m_allNodes[ uniqueId ];
+                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
+
+                tn->SetId( uniqueId );
+                triNodes.push_back( tn );
+            }
+
+            if( !areNodesColinear( triNodes ) )
+            {
+                hed::TRIANGULATION triangulator;
+                triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
+                triangulator.GetEdges( triangEdges );
+
+                for( const auto& e : triangEdges )
+                {
+                    auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
+                    auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+
+                    mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                }
 
+                triangulated = true;
+            }
+        }
+
+        if( !triangulated )
+        {
+            // special case: all nodes are on the same line - there's no
+            // triangulation for such set. In this case, we sort along any coordinate
+            // and chain the nodes together.
+            for(int i = 0; i < (int)uniqueIds.size() - 1; i++ )
+            {
+                auto src = m_allNodes[ uniqueIds[i] ];
+                auto dst = m_allNodes[ uniqueIds[i + 1] ];
                 mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
             }
         }
@@ -366,6 +413,10 @@ void RN_NET::compute()
     cnt.Show();
     #endif
 
+    // Do not keep handles to the nodes until the next update: they could be the last ones to
+    // the anchors of removed items, and be released by another thread (see CN_ANCHOR_PTR)
+    m_triangulator->Clear();
+
     for( const auto& e : m_boardEdges )
         triangEdges.push_back( e );
 
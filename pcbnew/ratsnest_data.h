@@ -95,7 +95,7 @@ public:
      * Returns pointer to a vector of edges that makes ratsnest for a given net.
      * @return Pointer to a vector of edges that makes ratsnest for a given net.
      */
-    const std::vector<CN_EDGE> GetUnconnected() const
+    const std::vector<CN_EDGE>& GetUnconnected() const
     {
         return m_rnEdges;
     }
@@ -114,6 +114,11 @@ public:
         return m_nodes.size();
     }
 
+    const std::vector<CN_ANCHOR_PTR>& GetNodes() const
+    {
+        return m_nodes;
+    }
+
     /**
      * Function GetNodes()
      * Returns list of nodes that are associated with a given item.
@@ -127,6 +132,13 @@ public:
         return m_rnEdges;
     }
 
+    ///> @return the bytes of the nodes and of the edges (the triangulation is not included)
+    size_t MemoryUsage() const
+    {
+        return sizeof( RN_NET ) + m_nodes.capacity() * sizeof( CN_ANCHOR_PTR )
+               + ( m_boardEdges.capacity() + m_rnEdges.capacity() ) * sizeof( CN_EDGE );
+    }
+
     /**
      * Function GetAllItems()
      * Adds all stored items to a list.
@@ -36,6 +36,7 @@
 #include <layers_id_colors_and_visibility.h>
 #include <pcb_base_frame.h>
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -43,145 +44,238 @@
 
 namespace KIGFX {
 
-RATSNEST_VIEWITEM::RATSNEST_VIEWITEM(  std::shared_ptr<CONNECTIVITY_DATA> aData ) :
-        EDA_ITEM( NOT_USED ), m_data( std::move(aData) )
+static constexpr int CROSS_SIZE = 200000;
+
+
+static void drawRatsnestLine( GAL* aGal, const VECTOR2I& aA, const VECTOR2I& aB, bool aCurved )
 {
+    if( aA == aB )
+    {
+        aGal->DrawLine( VECTOR2I( aA.x - CROSS_SIZE, aA.y - CROSS_SIZE ),
+                        VECTOR2I( aB.x + CROSS_SIZE, aB.y + CROSS_SIZE ) );
+        aGal->DrawLine( VECTOR2I( aA.x - CROSS_SIZE, aA.y + CROSS_SIZE ),
+                        VECTOR2I( aB.x + CROSS_SIZE, aB.y - CROSS_SIZE ) );
+    }
+    else if( aCurved )
+    {
+        auto dx = aB.x - aA.x;
+        auto dy = aB.y - aA.y;
+        const auto center = VECTOR2I( aA.x + 0.5 * dx - 0.1 * dy, aA.y + 0.5 * dy + 0.1 * dx );
+        aGal->DrawCurve( aA, center, center, aB );
+    }
+    else
+    {
+        aGal->DrawLine( aA, aB );
+    }
 }
 
 
-const BOX2I RATSNEST_VIEWITEM::ViewBBox() const
+/**
+ * Collects the ratsnest lines of aNet which are shown, according to the visibility of the
+ * local ratsnest of their items.
+ */
+static void collectLines( const RN_NET* aNet, bool aGlobalRatsnest, std::vector<SEG>& aLines )
 {
-    // Make it always visible
-    BOX2I bbox;
-    bbox.SetMaximum();
+    for( const auto& edge : aNet->GetUnconnected() )
+    {
+        const auto& sourceNode = edge.GetSourceNode();
+        const auto& targetNode = edge.GetTargetNode();
 
-    return bbox;
+        if( !sourceNode->Valid() || !targetNode->Valid() )
+            continue;
+
+        bool enable =  !sourceNode->GetNoLine() && !targetNode->GetNoLine();
+        bool show;
+
+        // If the global ratsnest is currently enabled, the local ratsnest
+        // should be easy to turn off, so either element can disable it
+        // If the global ratsnest is disabled, the local ratsnest should be easy to turn on
+        // so either element can enable it.
+        if( aGlobalRatsnest )
+            show = sourceNode->Parent()->GetLocalRatsnestVisible() &&
+                   targetNode->Parent()->GetLocalRatsnestVisible();
+        else
+            show = sourceNode->Parent()->GetLocalRatsnestVisible() ||
+                   targetNode->Parent()->GetLocalRatsnestVisible();
+
+        if( enable && show )
+            aLines.emplace_back( sourceNode->Pos(), targetNode->Pos() );
+    }
 }
 
 
-void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
+RATSNEST_NET_VIEWITEM::RATSNEST_NET_VIEWITEM( int aNetCode ) :
+        EDA_ITEM( NOT_USED ), m_netCode( aNetCode )
 {
-    std::unique_lock<std::mutex> lock( m_data->GetLock(), std::try_to_lock );
+}
 
-    if( !lock )
-        return;
 
-    constexpr int CROSS_SIZE = 200000;
+bool RATSNEST_NET_VIEWITEM::SetLines( std::vector<SEG>& aLines )
+{
+    if( aLines == m_lines )
+        return false;
+
+    m_lines.swap( aLines );
+    m_bbox = BOX2I();
 
+    for( size_t i = 0; i < m_lines.size(); i++ )
+    {
+        const SEG& line = m_lines[i];
+
+        // The curves bulge out by a tenth of their length, inside the box of their control points
+        VECTOR2I d = line.B - line.A;
+        VECTOR2I center( line.A.x + d.x / 2 - d.y / 10, line.A.y + d.y / 2 + d.x / 10 );
+        BOX2I    box( line.A, VECTOR2I( 0, 0 ) );
+
+        box.Merge( line.B );
+        box.Merge( center );
+        box.Inflate( CROSS_SIZE );
+
+        if( i == 0 )
+            m_bbox = box;
+        else
+            m_bbox.Merge( box );
+    }
+
+    return true;
+}
+
+
+const BOX2I RATSNEST_NET_VIEWITEM::ViewBBox() const
+{
+    return m_bbox;
+}
+
+
+void RATSNEST_NET_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
+{
     auto gal = aView->GetGAL();
-	gal->SetIsStroke( true );
+    auto rs = static_cast<PCB_RENDER_SETTINGS*>( aView->GetPainter()->GetSettings() );
+
+    gal->SetIsStroke( true );
     gal->SetIsFill( false );
     gal->SetLineWidth( 1.0 );
-    auto rs = static_cast<PCB_RENDER_SETTINGS*>(aView->GetPainter()->GetSettings());
-    auto color = rs->GetColor( NULL, LAYER_RATSNEST );
+    gal->SetStrokeColor( rs->GetColor( this, LAYER_RATSNEST ) );
 
-    int highlightedNet = rs->GetHighlightNetCode();
+    const bool curved_ratsnest = rs->GetCurvedRatsnestLinesEnabled();
 
-    gal->SetStrokeColor( color.Brightened(0.5) );
+    for( const SEG& line : m_lines )
+        drawRatsnestLine( gal, line.A, line.B, curved_ratsnest );
+}
+
+
+void RATSNEST_NET_VIEWITEM::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    aCount = 1;
+    aLayers[0] = LAYER_RATSNEST;
+}
+
+
+RATSNEST_VIEWITEM::RATSNEST_VIEWITEM(  std::shared_ptr<CONNECTIVITY_DATA> aData ) :
+        EDA_ITEM( NOT_USED ), m_data( std::move(aData) ), m_curvedRatsnest( false )
+{
+}
+
+
+void RATSNEST_VIEWITEM::UpdateNets( VIEW* aView )
+{
+    std::unique_lock<std::mutex> lock( m_data->GetLock(), std::try_to_lock );
+
+    // The ratsnest is being recomputed; the next redraw will catch up
+    if( !lock )
+        return;
 
+    auto rs = static_cast<PCB_RENDER_SETTINGS*>( aView->GetPainter()->GetSettings() );
     const bool curved_ratsnest = rs->GetCurvedRatsnestLinesEnabled();
+    const bool global_ratsnest = rs->GetGlobalRatsnestLinesEnabled();
+    const bool line_mode_changed = curved_ratsnest != m_curvedRatsnest;
+    const int  net_count = std::max( m_data->GetNetCount(), 1 );
 
-    // Draw the "dynamic" ratsnest (i.e. for objects that may be currently being moved)
-    for( const auto& l : m_data->GetDynamicRatsnest() )
+    m_curvedRatsnest = curved_ratsnest;
+
+    while( (int) m_nets.size() > net_count )
     {
-        if ( l.a == l.b )
-        {
-            gal->DrawLine( VECTOR2I( l.a.x - CROSS_SIZE, l.a.y - CROSS_SIZE ),
-                           VECTOR2I( l.b.x + CROSS_SIZE, l.b.y + CROSS_SIZE ) );
-            gal->DrawLine( VECTOR2I( l.a.x - CROSS_SIZE, l.a.y + CROSS_SIZE ),
-                           VECTOR2I( l.b.x + CROSS_SIZE, l.b.y - CROSS_SIZE ) );
-        }
-        else
-        {
-            if( curved_ratsnest )
-            {
-                auto dx = l.b.x - l.a.x;
-                auto dy = l.b.y - l.a.y;
-                const auto center = VECTOR2I( l.a.x + 0.5 * dx - 0.1 * dy,
-                        l.a.y + 0.5 * dy + 0.1 * dx );
-                gal->DrawCurve( l.a, center, center, l.b );
-            }
-            else
-            {
-                gal->DrawLine( l.a, l.b );
-            }
-        }
+        if( m_nets.back() )
+            aView->Remove( m_nets.back().get() );
+
+        m_nets.pop_back();
     }
 
-    for( int i = 1 /* skip "No Net" at [0] */; i < m_data->GetNetCount(); ++i )
+    m_nets.resize( net_count );
+
+    std::vector<SEG> lines;
+
+    for( int i = 1 /* skip "No Net" at [0] */; i < net_count; ++i )
     {
         RN_NET* net = m_data->GetRatsnestForNet( i );
 
-        if( !net )
-            continue;
-
-        // Draw the "static" ratsnest
-        if( i != highlightedNet )
-            gal->SetStrokeColor( color );  // using the default ratsnest color for not highlighted
-        else
-            gal->SetStrokeColor( color.Brightened(0.8) );
+        lines.clear();
 
-        for( const auto& edge : net->GetUnconnected() )
-        {
-            //if ( !edge.IsVisible() )
-            //    continue;
+        if( net )
+            collectLines( net, global_ratsnest, lines );
 
-            const auto& sourceNode = edge.GetSourceNode();
-            const auto& targetNode = edge.GetTargetNode();
-            const VECTOR2I source( sourceNode->Pos() );
-            const VECTOR2I target( targetNode->Pos() );
+        std::unique_ptr<RATSNEST_NET_VIEWITEM>& item = m_nets[i];
 
-            if( !sourceNode->Valid() || !targetNode->Valid() )
+        if( !item )
+        {
+            if( lines.empty() )
                 continue;
 
-            bool enable =  !sourceNode->GetNoLine() && !targetNode->GetNoLine();
-            bool show;
-
-            // If the global ratsnest is currently enabled, the local ratsnest
-            // should be easy to turn off, so either element can disable it
-            // If the global ratsnest is disabled, the local ratsnest should be easy to turn on
-            // so either element can enable it.
-            if( rs->GetGlobalRatsnestLinesEnabled() )
-                show = sourceNode->Parent()->GetLocalRatsnestVisible() &&
-                       targetNode->Parent()->GetLocalRatsnestVisible();
-            else
-                show = sourceNode->Parent()->GetLocalRatsnestVisible() ||
-                       targetNode->Parent()->GetLocalRatsnestVisible();
-
-            if ( enable && show )
-            {
-                if ( source == target )
-                {
-                    gal->DrawLine( VECTOR2I( source.x - CROSS_SIZE, source.y - CROSS_SIZE ),
-                                   VECTOR2I( source.x + CROSS_SIZE, source.y + CROSS_SIZE ) );
-                    gal->DrawLine( VECTOR2I( source.x - CROSS_SIZE, source.y + CROSS_SIZE ),
-                                   VECTOR2I( source.x + CROSS_SIZE, source.y - CROSS_SIZE ) );
-                }
-                else
-                {
-                    if( curved_ratsnest )
-                    {
-                        auto dx = target.x - source.x;
-                        auto dy = target.y - source.y;
-                        const auto center = VECTOR2I( source.x + 0.5 * dx - 0.1 * dy,
-                                source.y + 0.5 * dy + 0.1 * dx );
-                        gal->DrawCurve( source, center, center, target );
-                    }
-                    else
-                    {
-                        gal->DrawLine( source, target );
-                    }
-                }
-            }
+            item = std::make_unique<RATSNEST_NET_VIEWITEM>( i );
+            item->SetLines( lines );
+            aView->Add( item.get() );
+        }
+        else if( item->SetLines( lines ) || line_mode_changed )
+        {
+            aView->Update( item.get(), GEOMETRY );
         }
     }
 }
 
 
+const BOX2I RATSNEST_VIEWITEM::ViewBBox() const
+{
+    // Make it always visible
+    BOX2I bbox;
+    bbox.SetMaximum();
+
+    return bbox;
+}
+
+
+void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Only the dynamic ratsnest is drawn here, the nets are drawn by the RATSNEST_NET_VIEWITEMs
+    if( !aView->IsLayerVisible( LAYER_RATSNEST ) )
+        return;
+
+    std::unique_lock<std::mutex> lock( m_data->GetLock(), std::try_to_lock );
+
+    if( !lock )
+        return;
+
+    auto gal = aView->GetGAL();
+    gal->SetIsStroke( true );
+    gal->SetIsFill( false );
+    gal->SetLineWidth( 1.0 );
+    auto rs = static_cast<PCB_RENDER_SETTINGS*>(aView->GetPainter()->GetSettings());
+    auto color = rs->GetColor( NULL, LAYER_RATSNEST );
+
+    gal->SetStrokeColor( color.Brightened(0.5) );
+
+    const bool curved_ratsnest = rs->GetCurvedRatsnestLinesEnabled();
+
+    // Draw the "dynamic" ratsnest (i.e. for objects that may be currently being moved)
+    for( const auto& l : m_data->GetDynamicRatsnest() )
+        drawRatsnestLine( gal, l.a, l.b, curved_ratsnest );
+}
+
+
 void RATSNEST_VIEWITEM::ViewGetLayers( int aLayers[], int& aCount ) const
 {
+    // The dynamic ratsnest changes with every move, so it is not cached
     aCount = 1;
-    aLayers[0] = LAYER_RATSNEST;
+    aLayers[0] = LAYER_GP_OVERLAY;
 }
 
 }
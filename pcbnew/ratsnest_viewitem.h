@@ -31,19 +31,98 @@
 #define RATSNEST_VIEWITEM_H
 
 #include <memory>
+#include <vector>
 #include <base_struct.h>
 #include <math/vector2d.h>
+#include <geometry/seg.h>
 
 class GAL;
 class CONNECTIVITY_DATA;
 
 namespace KIGFX
 {
+class VIEW;
+
+/**
+ * Class RATSNEST_NET_VIEWITEM
+ *
+ * Draws the ratsnest lines of a single net.  Like the board items, it is cached by the view
+ * in a GAL group, so the lines are only tessellated again when they change, and the view
+ * recolors the group when the net highlight changes.
+ */
+class RATSNEST_NET_VIEWITEM : public EDA_ITEM
+{
+public:
+    RATSNEST_NET_VIEWITEM( int aNetCode );
+
+    int GetNetCode() const
+    {
+        return m_netCode;
+    }
+
+    /**
+     * Function SetLines()
+     * Sets the ratsnest lines to draw.  A line whose ends are the same point is drawn as a cross.
+     * @return true if the lines have changed and the item has to be redrawn.  In that case,
+     * aLines is swapped with the previous lines.
+     */
+    bool SetLines( std::vector<SEG>& aLines );
+
+    bool HasLines() const
+    {
+        return !m_lines.empty();
+    }
+
+    /// @copydoc VIEW_ITEM::ViewBBox()
+    const BOX2I ViewBBox() const override;
+
+    /// @copydoc VIEW_ITEM::ViewDraw()
+    void ViewDraw( int aLayer, KIGFX::VIEW* aView ) const override;
+
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    void ViewGetLayers( int aLayers[], int& aCount ) const override;
+
+    bool HitTest( const wxPoint& aPoint, int aAccuracy = 0 ) const override
+    {
+        return false;   // Not selectable
+    }
+
+#if defined(DEBUG)
+    /// @copydoc EDA_ITEM::Show()
+    void Show( int x, std::ostream& st ) const override { }
+#endif
+
+    virtual wxString GetClass() const override
+    {
+        return wxT( "RATSNEST_NET_VIEWITEM" );
+    }
+
+private:
+    int              m_netCode;
+    std::vector<SEG> m_lines;
+    BOX2I            m_bbox;
+};
+
+
+/**
+ * Class RATSNEST_VIEWITEM
+ *
+ * Draws the dynamic ratsnest (of the items being moved) on the overlay, and owns the
+ * RATSNEST_NET_VIEWITEMs drawing the ratsnest of each net.
+ */
 class RATSNEST_VIEWITEM : public EDA_ITEM
 {
 public:
     RATSNEST_VIEWITEM( std::shared_ptr<CONNECTIVITY_DATA> aData );
 
+    /**
+     * Function UpdateNets()
+     * Synchronizes the net view items with the ratsnest: only the nets whose visible
+     * ratsnest lines have changed are redrawn.  Must be called out of the drawing, before
+     * the view updates its items.
+     */
+    void UpdateNets( VIEW* aView );
+
     /// @copydoc VIEW_ITEM::ViewBBox()
     const BOX2I ViewBBox() const override;
 
@@ -74,6 +153,12 @@ public:
 protected:
     ///> Object containing ratsnest data.
     std::shared_ptr<CONNECTIVITY_DATA> m_data;
+
+    ///> Ratsnest of the nets, indexed by the net code.  Only created once a net has lines.
+    std::vector<std::unique_ptr<RATSNEST_NET_VIEWITEM>> m_nets;
+
+    ///> Line mode used to draw the cached nets
+    bool m_curvedRatsnest;
 };
 
 }   // namespace KIGFX
@@ -19,6 +19,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
@@ -339,49 +340,51 @@ void DP_GATEWAYS::BuildOrthoProjections( DP_GATEWAYS& aEntries,
 }
 
 
-bool DP_GATEWAYS::FitGateways( DP_GATEWAYS& aEntry, DP_GATEWAYS& aTarget,
-        bool aPrefDiagonal, DIFF_PAIR& aDp )
+bool DP_GATEWAYS::FitGateways( const DP_GATEWAYS& aEntry, const DP_GATEWAYS& aTarget,
+        bool aPrefDiagonal, DIFF_PAIR& aDp ) const
 {
-    DP_CANDIDATE best;
+    std::vector<DP_CANDIDATE> candidates;
 
-    int n = 0;
-    int bestScore = -1000;
-    bool found = false;
+    candidates.reserve( 2 * aEntry.CGateways().size() * aTarget.CGateways().size() );
 
-    for( const DP_GATEWAY& g_entry : aEntry.Gateways() )
+    for( const DP_GATEWAY& g_entry : aEntry.CGateways() )
     {
-        for( const DP_GATEWAY& g_target : aTarget.Gateways() )
+        for( const DP_GATEWAY& g_target : aTarget.CGateways() )
         {
-            n++;
-
             for( int attempt = 0; attempt < 2; attempt++ )
             {
                 int score = ( attempt == 1 ? -3 : 0 );
                 score += g_entry.Priority();
                 score += g_target.Priority();
 
-                if( score < bestScore )
-                    continue;
-
-                DIFF_PAIR l( m_gap );
-
-                if( l.BuildInitial( g_entry, g_target, aPrefDiagonal ^ ( attempt ? true : false ) ) )
-                {
-                    best.p = l.CP();
-                    best.n = l.CN();
-                    bestScore = score;
-                    found = true;
-                }
+                candidates.push_back( { &g_entry, &g_target, attempt == 1, score,
+                                        (int) candidates.size() } );
             }
         }
     }
 
+    // The pair chosen is the last one which fits among the best scored ones, so sorting
+    // them by decreasing score, and by decreasing order for the same score, lets the search
+    // stop at the first fit instead of building the traces of all of them
+    std::sort( candidates.begin(), candidates.end(),
+               []( const DP_CANDIDATE& aA, const DP_CANDIDATE& aB )
+               {
+                   if( aA.score != aB.score )
+                       return aA.score > aB.score;
 
-    if( found )
+                   return aA.order > aB.order;
+               } );
+
+    for( const DP_CANDIDATE& c : candidates )
     {
-        aDp.SetGap( m_gap );
-        aDp.SetShape( best.p, best.n );
-        return true;
+        DIFF_PAIR l( m_gap );
+
+        if( l.BuildInitial( *c.entry, *c.target, aPrefDiagonal ^ c.flipPosture ) )
+        {
+            aDp.SetGap( m_gap );
+            aDp.SetShape( l.CP(), l.CN() );
+            return true;
+        }
     }
 
     return false;
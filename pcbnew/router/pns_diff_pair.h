@@ -221,7 +221,8 @@ class DP_GATEWAYS
         void BuildGeneric( const VECTOR2I& p0_p, const VECTOR2I& p0_n, bool aBuildEntries = false, bool aViaMode = false );
         void BuildFromPrimitivePair( const DP_PRIMITIVE_PAIR& aPair, bool aPreferDiagonal );
 
-        bool FitGateways( DP_GATEWAYS& aEntry, DP_GATEWAYS& aTarget, bool aPrefDiagonal, DIFF_PAIR& aDp );
+        bool FitGateways( const DP_GATEWAYS& aEntry, const DP_GATEWAYS& aTarget, bool aPrefDiagonal,
+                          DIFF_PAIR& aDp ) const;
 
         std::vector<DP_GATEWAY>& Gateways()
         {
@@ -238,9 +239,11 @@ class DP_GATEWAYS
     private:
         struct DP_CANDIDATE
         {
-            SHAPE_LINE_CHAIN p, n;
-            VECTOR2I gw_p, gw_n;
+            const DP_GATEWAY* entry;
+            const DP_GATEWAY* target;
+            bool flipPosture;
             int score;
+            int order;      ///< index in the exhaustive search order
         };
 
         bool checkDiagonalAlignment( const VECTOR2I& a, const VECTOR2I& b ) const;
@@ -36,7 +36,9 @@
 namespace PNS {
 
 DIFF_PAIR_PLACER::DIFF_PAIR_PLACER( ROUTER* aRouter ) :
-    PLACEMENT_ALGO( aRouter )
+    PLACEMENT_ALGO( aRouter ),
+    m_entryGateways( 0 ),
+    m_targetGateways( 0 )
 {
     m_state = RT_START;
     m_chainedPlacement = false;
@@ -62,6 +64,11 @@ DIFF_PAIR_PLACER::DIFF_PAIR_PLACER( ROUTER* aRouter ) :
     m_currentEndItem = NULL;
     m_currentMode = RM_MarkObstacles;
     m_idle = true;
+    m_entryGatewaysValid = false;
+    m_entryGatewaysDiagonal = false;
+    m_targetGatewaysValid = false;
+    m_targetParentP = nullptr;
+    m_targetParentN = nullptr;
 }
 
 DIFF_PAIR_PLACER::~DIFF_PAIR_PLACER()
@@ -609,6 +616,10 @@ void DIFF_PAIR_PLACER::initPlacement()
     m_currentEndItem = NULL;
     m_startDiagonal = m_initialDiagonal;
 
+    // The start pair or the sizes may have changed
+    m_entryGatewaysValid = false;
+    m_targetGatewaysValid = false;
+
     NODE* world = Router()->GetWorld();
 
     world->KillChildren();
@@ -636,19 +647,19 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
 {
     m_fitOk = false;
 
-    DP_GATEWAYS gwsEntry( gap() );
-    DP_GATEWAYS gwsTarget( gap() );
+    DP_GATEWAYS gwsCursor( gap() );
+    const DP_GATEWAYS* gwsTarget = &gwsCursor;
 
     if( !m_prevPair )
         m_prevPair = m_start;
 
-    gwsEntry.BuildFromPrimitivePair( *m_prevPair, m_startDiagonal );
+    const DP_GATEWAYS& gwsEntry = entryGateways();
 
     DP_PRIMITIVE_PAIR target;
 
     if( findDpPrimitivePair( aP, m_currentEndItem, target ) )
     {
-        gwsTarget.BuildFromPrimitivePair( target, m_startDiagonal );
+        gwsTarget = &targetGateways( target );
         m_snapOnTarget = true;
     }
     else
@@ -667,19 +678,19 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
         // on the extension of the starting segment pair of the DP)
         int lead_dist = ( fpProj - fp ).EuclideanNorm();
 
-        gwsTarget.SetFitVias( m_placingVia, m_sizes.ViaDiameter(), viaGap() );
+        gwsCursor.SetFitVias( m_placingVia, m_sizes.ViaDiameter(), viaGap() );
 
         // far from the initial segment extension line -> allow a 45-degree obtuse turn
         if( lead_dist > m_sizes.DiffPairGap() + m_sizes.DiffPairWidth() )
         {
-            gwsTarget.BuildForCursor( fp );
+            gwsCursor.BuildForCursor( fp );
         }
         // close to the initial segment extension line -> keep straight part only, project as close
         // as possible to the cursor
         else
         {
-            gwsTarget.BuildForCursor( fpProj );
-            gwsTarget.FilterByOrientation( DIRECTION_45::ANG_STRAIGHT | DIRECTION_45::ANG_HALF_FULL, DIRECTION_45( dirV ) );
+            gwsCursor.BuildForCursor( fpProj );
+            gwsCursor.FilterByOrientation( DIRECTION_45::ANG_STRAIGHT | DIRECTION_45::ANG_HALF_FULL, DIRECTION_45( dirV ) );
         }
 
         m_snapOnTarget = false;
@@ -689,7 +700,7 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
     m_currentTrace.SetGap( gap() );
     m_currentTrace.SetLayer( m_currentLayer );
 
-    bool result = gwsEntry.FitGateways( gwsEntry, gwsTarget, m_startDiagonal, m_currentTrace );
+    bool result = gwsCursor.FitGateways( gwsEntry, *gwsTarget, m_startDiagonal, m_currentTrace );
 
     if( result )
     {
@@ -710,6 +721,55 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
 }
 
 
+const DP_GATEWAYS& DIFF_PAIR_PLACER::entryGateways()
+{
+    if( !m_entryGatewaysValid || m_entryGatewaysDiagonal != m_startDiagonal )
+    {
+        m_entryGateways = DP_GATEWAYS( gap() );
+        m_entryGateways.BuildFromPrimitivePair( *m_prevPair, m_startDiagonal );
+        m_entryGatewaysValid = true;
+        m_entryGatewaysDiagonal = m_startDiagonal;
+    }
+
+    return m_entryGateways;
+}
+
+
+const DP_GATEWAYS& DIFF_PAIR_PLACER::targetGateways( const DP_PRIMITIVE_PAIR& aTarget )
+{
+    const int pvMask = ITEM::SOLID_T | ITEM::VIA_T;
+
+    // The gateways of a pad or via pair only depend on its anchors and shapes, so they are
+    // kept while the cursor stays on the same pair. The continuations of segments depend on
+    // the posture, and are cheap to build anyway.
+    bool cacheable = aTarget.PrimP() && aTarget.PrimN()
+                     && aTarget.PrimP()->OfKind( pvMask ) && aTarget.PrimN()->OfKind( pvMask )
+                     && aTarget.PrimP()->Parent() && aTarget.PrimN()->Parent();
+
+    if( cacheable && m_targetGatewaysValid
+            && m_targetAnchorP == aTarget.AnchorP() && m_targetAnchorN == aTarget.AnchorN()
+            && m_targetParentP == aTarget.PrimP()->Parent()
+            && m_targetParentN == aTarget.PrimN()->Parent() )
+    {
+        return m_targetGateways;
+    }
+
+    m_targetGateways = DP_GATEWAYS( gap() );
+    m_targetGateways.BuildFromPrimitivePair( aTarget, m_startDiagonal );
+    m_targetGatewaysValid = cacheable;
+
+    if( cacheable )
+    {
+        m_targetAnchorP = aTarget.AnchorP();
+        m_targetAnchorN = aTarget.AnchorN();
+        m_targetParentP = aTarget.PrimP()->Parent();
+        m_targetParentN = aTarget.PrimN()->Parent();
+    }
+
+    return m_targetGateways;
+}
+
+
 bool DIFF_PAIR_PLACER::Move( const VECTOR2I& aP , ITEM* aEndItem )
 {
     m_currentEndItem = aEndItem;
@@ -240,6 +240,9 @@ private:
     bool attemptWalk( NODE* aNode, DIFF_PAIR* aCurrent, DIFF_PAIR& aWalk, bool aPFirst, bool aWindCw, bool aSolidsOnly );
     bool propagateDpHeadForces ( const VECTOR2I& aP, VECTOR2I& aNewP );
 
+    const DP_GATEWAYS& entryGateways();
+    const DP_GATEWAYS& targetGateways( const DP_PRIMITIVE_PAIR& aTarget );
+
     enum State {
         RT_START = 0,
         RT_ROUTE = 1,
@@ -258,6 +261,18 @@ private:
     DP_PRIMITIVE_PAIR m_start;
     OPT<DP_PRIMITIVE_PAIR> m_prevPair;
 
+    ///> Gateways of m_prevPair, built once per placement and posture
+    DP_GATEWAYS m_entryGateways;
+    bool m_entryGatewaysValid;
+    bool m_entryGatewaysDiagonal;
+
+    ///> Gateways of the last pad or via pair snapped on, and the anchors they were built for
+    DP_GATEWAYS m_targetGateways;
+    bool m_targetGatewaysValid;
+    VECTOR2I m_targetAnchorP, m_targetAnchorN;
+    const BOARD_CONNECTED_ITEM* m_targetParentP;
+    const BOARD_CONNECTED_ITEM* m_targetParentN;
+
     ///> current algorithm iteration
     int m_iteration;
 
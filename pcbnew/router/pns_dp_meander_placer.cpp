@@ -43,9 +43,10 @@ DP_MEANDER_PLACER::DP_MEANDER_PLACER( ROUTER* aRouter ) :
     m_padToDieN = 0;
 
     // Init temporary variables (do not leave uninitialized members)
-    m_initialSegment = NULL;
-    m_lastLength     = 0;
-    m_lastStatus     = TOO_SHORT;
+    m_initialSegment  = NULL;
+    m_tunedPathLength = 0;
+    m_lastLength      = 0;
+    m_lastStatus      = TOO_SHORT;
 }
 
 
@@ -111,6 +112,7 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_padToDieP = GetTotalPadToDieLength( m_originPair.PLine() );
     m_padToDieN = GetTotalPadToDieLength( m_originPair.NLine() );
     m_padToDieLenth = std::max( m_padToDieP, m_padToDieN );
+    m_tunedPathLength = origPathLength();
 
     m_world->Remove( m_originPair.PLine() );
     m_world->Remove( m_originPair.NLine() );
@@ -250,7 +252,7 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
     while( curIndexN < tunedN.PointCount() )
         m_result.AddCorner( tunedP.CPoint( -1 ), tunedN.CPoint( curIndexN++ ) );
 
-    long long int dpLen = origPathLength();
+    long long int dpLen = m_tunedPathLength;
 
     m_lastStatus = TUNED;
 
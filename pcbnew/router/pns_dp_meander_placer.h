@@ -129,6 +129,7 @@ private:
     void setWorld( NODE* aWorld );
     void release();
 
+    ///> @return the length of the longer line of the tuned pair, including the pad to die lengths
     long long int origPathLength() const;
 
     ///> current routing start point (end of tail, beginning of head)
@@ -147,6 +148,9 @@ private:
     MEANDERED_LINE m_result;
     SEGMENT* m_initialSegment;
 
+    ///> length of the tuned pair before tuning, computed once by Start()
+    long long int m_tunedPathLength;
+
     long long int m_lastLength;
     int           m_padToDieP;
     int           m_padToDieN;
@@ -29,6 +29,15 @@ INDEX::INDEX()
 }
 
 
+INDEX::INDEX( const INDEX& aOther )
+{
+    memset( m_subIndices, 0, sizeof( m_subIndices ) );
+
+    for( ITEM* item : aOther.m_allItems )
+        Add( item );
+}
+
+
 INDEX::~INDEX()
 {
     Clear();
@@ -51,6 +51,10 @@ public:
     typedef std::unordered_set<ITEM*>   ITEM_SET;
 
     INDEX();
+
+    ///> Creates an index holding the same items as aOther
+    INDEX( const INDEX& aOther );
+
     ~INDEX();
 
     /**
@@ -85,10 +89,12 @@ public:
      * @param aMinDistance proximity distance (wrs to the item's shape)
      * @param aVisitor function object called on each found item. Return
               false from the visitor to stop searching.
+     * @param aExcludedNet if not negative, the items of this net are skipped
+              without calling the visitor.
      * @return number of items found.
      */
     template<class Visitor>
-    int Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor );
+    int Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor, int aExcludedNet = -1 );
 
     /**
      * Function Query()
@@ -141,6 +147,8 @@ public:
     ITEM_SET::iterator end() { return m_allItems.end(); }
 
 private:
+    INDEX& operator=( const INDEX& aOther );
+
     static const int    MaxSubIndices   = 128;
     static const int    SI_Multilayer   = 2;
     static const int    SI_SegDiagonal  = 0;
@@ -149,9 +157,33 @@ private:
     static const int    SI_PadsTop      = 0;
     static const int    SI_PadsBottom   = 1;
 
+    ///> visitor wrapper dropping the items of a given net before they reach the real visitor
+    template <class Visitor>
+    struct NET_FILTER
+    {
+        NET_FILTER( Visitor& aVisitor, int aNet ) :
+            m_visitor( aVisitor ),
+            m_net( aNet )
+        {}
+
+        bool operator()( ITEM* aItem )
+        {
+            if( aItem->Net() == m_net )
+                return true;
+
+            return m_visitor( aItem );
+        }
+
+        Visitor& m_visitor;
+        int      m_net;
+    };
+
     template <class Visitor>
     int querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor );
 
+    template <class Visitor>
+    int queryLayers( const ITEM* aItem, int aMinDistance, Visitor& aVisitor );
+
     ITEM_SHAPE_INDEX* getSubindex( const ITEM* aItem );
 
     ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
@@ -170,7 +202,19 @@ int INDEX::querySingle( int index, const SHAPE* aShape, int aMinDistance, Visito
 }
 
 template<class Visitor>
-int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor )
+int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor, int aExcludedNet )
+{
+    if( aExcludedNet >= 0 )
+    {
+        NET_FILTER<Visitor> filter( aVisitor, aExcludedNet );
+        return queryLayers( aItem, aMinDistance, filter );
+    }
+
+    return queryLayers( aItem, aMinDistance, aVisitor );
+}
+
+template<class Visitor>
+int INDEX::queryLayers( const ITEM* aItem, int aMinDistance, Visitor& aVisitor )
 {
     const SHAPE* shape = aItem->Shape();
     int total = 0;
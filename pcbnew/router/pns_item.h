@@ -78,6 +78,7 @@ public:
         m_marker = 0;
         m_rank = -1;
         m_routable = true;
+        m_overrideCount = 0;
     }
 
     ITEM( const ITEM& aOther )
@@ -91,6 +92,7 @@ public:
         m_marker = aOther.m_marker;
         m_rank = aOther.m_rank;
         m_routable = aOther.m_routable;
+        m_overrideCount = 0;
     }
 
     virtual ~ITEM();
@@ -257,6 +259,13 @@ protected:
     int                     m_marker;
     int                     m_rank;
     bool                    m_routable;
+
+private:
+    friend class NODE;
+
+    ///> number of branch override sets holding this item, lets NODE::Overrides() skip
+    ///> the hash lookup for the (many) root items no branch has touched
+    int                     m_overrideCount;
 };
 
 template< typename T, typename S >
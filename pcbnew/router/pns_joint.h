@@ -253,7 +253,7 @@ public:
     }
 
 private:
-    ///> hash tag for unordered_multimap
+    ///> hash tag for the JOINT_MAP
     HASH_TAG m_tag;
 
     ///> list of items linked to this joint
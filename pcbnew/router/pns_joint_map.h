@@ -0,0 +1,275 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_JOINT_MAP_H
+#define __PNS_JOINT_MAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "pns_joint.h"
+
+namespace PNS {
+
+/**
+ * JOINT_MAP
+ *
+ * Open addressing hash table of the joints of a NODE, keyed by their position and net.
+ * Several joints may share a key, when their layer ranges do not overlap.
+ *
+ * The joints are stored inline in a single array and the keys in a separate, smaller one,
+ * so that a lookup only touches a few contiguous cache lines, and copying the table for a
+ * branch is a plain copy of both arrays. The erased slots are marked as deleted until the
+ * next rehash, which keeps the other joints in place: a JOINT pointer stays valid until
+ * that joint is erased or until a later insertion rehashes the table.
+ */
+class JOINT_MAP
+{
+public:
+    typedef JOINT::HASH_TAG HASH_TAG;
+
+    JOINT_MAP() :
+        m_size( 0 ),
+        m_used( 0 ),
+        m_bits( 0 )
+    {
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        m_keys.clear();
+        m_joints.clear();
+        m_size = 0;
+        m_used = 0;
+        m_bits = 0;
+    }
+
+    ///> @return true if at least one joint has the given key, whatever its layers
+    bool Contains( const HASH_TAG& aTag ) const
+    {
+        return findSlot( aTag, nullptr ) >= 0;
+    }
+
+    ///> @return the first joint with the given key and a layer range overlapping aLayers
+    JOINT* Find( const HASH_TAG& aTag, const LAYER_RANGE& aLayers )
+    {
+        int slot = findSlot( aTag, &aLayers );
+        return slot >= 0 ? &m_joints[slot] : nullptr;
+    }
+
+    const JOINT* Find( const HASH_TAG& aTag, const LAYER_RANGE& aLayers ) const
+    {
+        int slot = findSlot( aTag, &aLayers );
+        return slot >= 0 ? &m_joints[slot] : nullptr;
+    }
+
+    JOINT* Find( const HASH_TAG& aTag, int aLayer )
+    {
+        return Find( aTag, LAYER_RANGE( aLayer ) );
+    }
+
+    ///> Calls aFunc for each joint with the given key
+    template <class FUNC>
+    void ForEach( const HASH_TAG& aTag, FUNC aFunc ) const
+    {
+        if( m_keys.empty() )
+            return;
+
+        for( size_t slot = home( aTag ); m_keys[slot].m_state != EMPTY; slot = next( slot ) )
+        {
+            if( m_keys[slot].m_state == FULL && m_keys[slot].m_tag == aTag )
+                aFunc( m_joints[slot] );
+        }
+    }
+
+    ///> Adds a copy of aJoint, keyed by its tag, even if a joint with the same key exists
+    JOINT& Insert( JOINT aJoint )
+    {
+        if( ( m_used + 1 ) * 4 > m_keys.size() * 3 )
+            rehash( ( m_size + 1 ) * 2 > m_keys.size() ? m_bits + 1 : m_bits );
+
+        size_t slot = home( aJoint.Tag() );
+
+        // Reuse the first deleted slot of the probe sequence
+        while( m_keys[slot].m_state == FULL )
+            slot = next( slot );
+
+        if( m_keys[slot].m_state == EMPTY )
+            m_used++;
+
+        m_keys[slot].m_tag = aJoint.Tag();
+        m_keys[slot].m_state = FULL;
+        m_joints[slot] = std::move( aJoint );
+        m_size++;
+
+        return m_joints[slot];
+    }
+
+    ///> Removes a joint returned by Find() or Insert()
+    void Erase( JOINT* aJoint )
+    {
+        size_t slot = aJoint - m_joints.data();
+
+        assert( slot < m_keys.size() && m_keys[slot].m_state == FULL );
+
+        m_keys[slot].m_state = DELETED;
+        m_joints[slot] = JOINT();     // releases the links
+        m_size--;
+    }
+
+    template <class VALUE, class SLOTS>
+    class ITERATOR
+    {
+    public:
+        ITERATOR( SLOTS* aMap, size_t aSlot ) :
+            m_map( aMap ),
+            m_slot( aSlot )
+        {
+            skipFree();
+        }
+
+        VALUE& operator*() const
+        {
+            return m_map->m_joints[m_slot];
+        }
+
+        VALUE* operator->() const
+        {
+            return &m_map->m_joints[m_slot];
+        }
+
+        ITERATOR& operator++()
+        {
+            m_slot++;
+            skipFree();
+            return *this;
+        }
+
+        bool operator!=( const ITERATOR& aOther ) const
+        {
+            return m_slot != aOther.m_slot;
+        }
+
+    private:
+        void skipFree()
+        {
+            while( m_slot < m_map->m_keys.size() && m_map->m_keys[m_slot].m_state != FULL )
+                m_slot++;
+        }
+
+        SLOTS* m_map;
+        size_t m_slot;
+    };
+
+    typedef ITERATOR<JOINT, JOINT_MAP>             iterator;
+    typedef ITERATOR<const JOINT, const JOINT_MAP> const_iterator;
+
+    iterator begin() { return iterator( this, 0 ); }
+    iterator end() { return iterator( this, m_keys.size() ); }
+    const_iterator begin() const { return const_iterator( this, 0 ); }
+    const_iterator end() const { return const_iterator( this, m_keys.size() ); }
+
+private:
+    enum SLOT_STATE : uint8_t
+    {
+        EMPTY = 0,
+        FULL,
+        DELETED
+    };
+
+    struct KEY
+    {
+        HASH_TAG   m_tag;
+        SLOT_STATE m_state = EMPTY;
+    };
+
+    size_t home( const HASH_TAG& aTag ) const
+    {
+        uint64_t h = ( (uint64_t) (uint32_t) aTag.pos.x << 32 ) ^ (uint32_t) aTag.pos.y;
+
+        h ^= (uint64_t) (uint32_t) aTag.net * 0xff51afd7ed558ccdULL;
+        h *= 0x9e3779b97f4a7c15ULL;
+
+        return h >> ( 64 - m_bits );
+    }
+
+    size_t next( size_t aSlot ) const
+    {
+        return ( aSlot + 1 ) & ( m_keys.size() - 1 );
+    }
+
+    ///> @return the slot of the first joint with the key aTag, and overlapping aLayers if not null
+    int findSlot( const HASH_TAG& aTag, const LAYER_RANGE* aLayers ) const
+    {
+        if( m_keys.empty() )
+            return -1;
+
+        for( size_t slot = home( aTag ); m_keys[slot].m_state != EMPTY; slot = next( slot ) )
+        {
+            if( m_keys[slot].m_state == FULL && m_keys[slot].m_tag == aTag
+                    && ( !aLayers || m_joints[slot].Layers().Overlaps( *aLayers ) ) )
+                return (int) slot;
+        }
+
+        return -1;
+    }
+
+    void rehash( int aBits )
+    {
+        aBits = std::max( aBits, 4 );
+
+        std::vector<KEY>   keys( size_t( 1 ) << aBits );
+        std::vector<JOINT> joints( keys.size() );
+
+        m_keys.swap( keys );
+        m_joints.swap( joints );
+        m_bits = aBits;
+        m_size = 0;
+        m_used = 0;
+
+        for( size_t ii = 0; ii < keys.size(); ii++ )
+        {
+            if( keys[ii].m_state == FULL )
+                Insert( std::move( joints[ii] ) );
+        }
+    }
+
+    std::vector<KEY>   m_keys;
+    std::vector<JOINT> m_joints;
+
+    size_t m_size;      ///< number of joints
+    size_t m_used;      ///< number of full or deleted slots, which end the probe sequences
+    int    m_bits;      ///< log2 of the number of slots
+};
+
+}
+
+#endif    // __PNS_JOINT_MAP_H
@@ -48,7 +48,9 @@
 #include <geometry/shape_arc.h>
 #include <geometry/shape_simple.h>
 
+#include <algorithm>
 #include <memory>
+#include <unordered_set>
 
 #include "tools/pcb_tool_base.h"
 
@@ -530,6 +532,7 @@ PNS_KICAD_IFACE_BASE::PNS_KICAD_IFACE_BASE()
 {
     m_ruleResolver = nullptr;
     m_board = nullptr;
+    m_syncedNetCount = 0;
     m_router = nullptr;
     m_debugDecorator = nullptr;
     m_router = nullptr;
@@ -1229,12 +1232,96 @@ void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
 
     delete m_ruleResolver;
     m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, m_router );
+    m_syncedNetCount = m_board->GetNetCount();
 
     aWorld->SetRuleResolver( m_ruleResolver );
     aWorld->SetMaxClearance( 4 * std::max(worstPadClearance, worstRuleClearance ) );
 }
 
 
+bool PNS_KICAD_IFACE_BASE::SyncItems( PNS::NODE* aWorld, const std::vector<BOARD_ITEM*>& aRemoved,
+                                      const std::vector<BOARD_ITEM*>& aAdded )
+{
+    // Only the tracks, vias and zones are found back from their board item in the world.
+    // The pads come with the clearances cached by the rule resolver, the footprints and the
+    // drawings with items which do not know their board item.
+    auto isSynced = []( const BOARD_ITEM* aItem )
+                    {
+                        switch( aItem->Type() )
+                        {
+                        case PCB_TRACE_T:
+                        case PCB_ARC_T:
+                        case PCB_VIA_T:
+                        case PCB_ZONE_AREA_T:
+                        case PCB_MARKER_T:      // not in the world
+                        case PCB_DIMENSION_T:
+                        case PCB_TARGET_T:
+                            return true;
+
+                        default:
+                            return false;
+                        }
+                    };
+
+    if( !m_board || !m_ruleResolver || m_board->GetNetCount() != m_syncedNetCount
+            || !std::all_of( aRemoved.begin(), aRemoved.end(), isSynced )
+            || !std::all_of( aAdded.begin(), aAdded.end(), isSynced ) )
+    {
+        return false;
+    }
+
+    std::unordered_set<const BOARD_CONNECTED_ITEM*> parents;
+    std::vector<PNS::ITEM*>                         removed;
+
+    for( BOARD_ITEM* item : aRemoved )
+    {
+        if( item->IsConnected() )
+            parents.insert( static_cast<BOARD_CONNECTED_ITEM*>( item ) );
+    }
+
+    aWorld->FindItemsByParents( parents, removed );
+
+    for( PNS::ITEM* item : removed )
+        aWorld->Remove( item );
+
+    for( BOARD_ITEM* item : aAdded )
+    {
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+            if( auto segment = syncTrack( static_cast<TRACK*>( item ) ) )
+                aWorld->Add( std::move( segment ) );
+
+            break;
+
+        case PCB_ARC_T:
+            if( auto arc = syncArc( static_cast<ARC*>( item ) ) )
+                aWorld->Add( std::move( arc ) );
+
+            break;
+
+        case PCB_VIA_T:
+            if( auto via = syncVia( static_cast<VIA*>( item ) ) )
+                aWorld->Add( std::move( via ) );
+
+            break;
+
+        case PCB_ZONE_AREA_T:
+            syncZone( aWorld, static_cast<ZONE_CONTAINER*>( item ) );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    wxLogTrace( "PNS", "SyncItems: %d items removed, %d added", (int) removed.size(),
+                (int) aAdded.size() );
+
+    return true;
+}
+
+
 void PNS_KICAD_IFACE::EraseView()
 {
     for( auto item : m_hiddenItems )
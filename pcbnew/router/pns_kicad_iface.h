@@ -53,6 +53,8 @@ public:
     void EraseView() override {};
     void SetBoard( BOARD* aBoard );
     void SyncWorld( PNS::NODE* aWorld ) override;
+    bool SyncItems( PNS::NODE* aWorld, const std::vector<BOARD_ITEM*>& aRemoved,
+                    const std::vector<BOARD_ITEM*>& aAdded ) override;
     bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) override { return true; };
     bool IsItemVisible( const PNS::ITEM* aItem ) override { return true; }
     void HideItem( PNS::ITEM* aItem ) override {}
@@ -82,6 +84,7 @@ protected:
 
     PNS::ROUTER* m_router;
     BOARD* m_board;
+    unsigned m_syncedNetCount;  ///< number of nets known by m_ruleResolver
 };
 
 class PNS_KICAD_IFACE : public PNS_KICAD_IFACE_BASE {
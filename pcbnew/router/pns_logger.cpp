@@ -49,6 +49,48 @@ void LOGGER::Clear()
 {
     m_theLog.str( std::string() );
     m_groupOpened = false;
+    m_events.clear();
+}
+
+
+void LOGGER::Log( const EVENT_ENTRY& aEvent )
+{
+    m_events.push_back( aEvent );
+}
+
+
+bool LOGGER::ParseEvents( std::istream& aStream, std::vector<EVENT_ENTRY>& aEvents )
+{
+    std::string line;
+
+    while( std::getline( aStream, line ) )
+    {
+        std::istringstream ss( line );
+        std::string        tag, uuid;
+        int                type;
+        EVENT_ENTRY        evt;
+
+        if( !( ss >> tag ) || tag != "event" )
+            continue;
+
+        if( !( ss >> type >> evt.m_p.x >> evt.m_p.y >> uuid ) || type < EVT_START_ROUTE
+                || type > EVT_ABORT )
+            return false;
+
+        evt.m_type = (EVENT_TYPE) type;
+        evt.m_uuid = ( uuid == "-" ) ? std::string() : uuid;
+
+        if( evt.m_type == EVT_START_ROUTE || evt.m_type == EVT_START_DRAG )
+        {
+            if( !( ss >> evt.m_layer >> evt.m_mode >> evt.m_trackWidth >> evt.m_viaDiameter
+                      >> evt.m_viaDrill ) )
+                return false;
+        }
+
+        aEvents.push_back( evt );
+    }
+
+    return true;
 }
 
 
@@ -194,12 +236,30 @@ void LOGGER::dumpShape( const SHAPE* aSh )
 }
 
 
-void LOGGER::Save( const std::string& aFilename )
+void LOGGER::Save( const std::string& aFilename, bool aAppend )
 {
     EndGroup();
 
-    FILE* f = fopen( aFilename.c_str(), "wb" );
+    FILE* f = fopen( aFilename.c_str(), aAppend ? "ab" : "wb" );
     wxLogTrace( "PNS", "Saving to '%s' [%p]", aFilename.c_str(), f );
+
+    if( !f )
+        return;
+
+    for( const EVENT_ENTRY& evt : m_events )
+    {
+        fprintf( f, "event %d %d %d %s", evt.m_type, evt.m_p.x, evt.m_p.y,
+                 evt.m_uuid.empty() ? "-" : evt.m_uuid.c_str() );
+
+        if( evt.m_type == EVT_START_ROUTE || evt.m_type == EVT_START_DRAG )
+        {
+            fprintf( f, " %d %d %d %d %d", evt.m_layer, evt.m_mode, evt.m_trackWidth,
+                     evt.m_viaDiameter, evt.m_viaDrill );
+        }
+
+        fprintf( f, "\n" );
+    }
+
     const std::string s = m_theLog.str();
     fwrite( s.c_str(), 1, s.length(), f );
     fclose( f );
@@ -23,6 +23,7 @@
 #define __PNS_LOGGER_H
 
 #include <cstdio>
+#include <istream>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -39,12 +40,51 @@ class ITEM;
 class LOGGER
 {
 public:
+    ///> Calls of the router recorded by the event log, to replay an interactive session
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_FIX,
+        EVT_MOVE,
+        EVT_ABORT
+    };
+
+    struct EVENT_ENTRY
+    {
+        EVENT_TYPE  m_type;
+        VECTOR2I    m_p;
+        std::string m_uuid;         ///< of the board item under the cursor, or empty
+
+        // EVT_START_ROUTE and EVT_START_DRAG only
+        int         m_layer = -1;   ///< start layer, or drag mode for EVT_START_DRAG
+        int         m_mode = 0;     ///< the PNS_MODE of the router settings
+        int         m_trackWidth = 0;
+        int         m_viaDiameter = 0;
+        int         m_viaDrill = 0;
+    };
+
     LOGGER();
     ~LOGGER();
 
-    void Save( const std::string& aFilename );
+    void Save( const std::string& aFilename, bool aAppend = false );
     void Clear();
 
+    void Log( const EVENT_ENTRY& aEvent );
+
+    const std::vector<EVENT_ENTRY>& GetEvents() const
+    {
+        return m_events;
+    }
+
+    /**
+     * Function ParseEvents()
+     *
+     * Reads the events written by Save(), skipping the other lines of the log.
+     * @return false if an event line is malformed
+     */
+    static bool ParseEvents( std::istream& aStream, std::vector<EVENT_ENTRY>& aEvents );
+
     void NewGroup( const std::string& aName, int aIter = 0 );
     void EndGroup();
 
@@ -58,6 +98,7 @@ private:
 
     bool m_groupOpened;
     std::stringstream m_theLog;
+    std::vector<EVENT_ENTRY> m_events;
 };
 
 }
@@ -38,6 +38,7 @@ MEANDER_PLACER::MEANDER_PLACER( ROUTER* aRouter ) :
 
     // Init temporary variables (do not leave uninitialized members)
     m_initialSegment = NULL;
+    m_tunedPathLength = 0;
     m_lastLength = 0;
     m_lastStatus = TOO_SHORT;
 }
@@ -81,6 +82,7 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
     TOPOLOGY topo( m_world );
     m_tunedPath = topo.AssembleTrivialPath( m_initialSegment );
+    m_tunedPathLength = origPathLength();
 
     m_world->Remove( m_originLine );
 
@@ -135,7 +137,9 @@ bool MEANDER_PLACER::doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int a
         m_result.AddCorner( s.B );
     }
 
-    long long int lineLen = origPathLength();
+    // The path outside of the tuned span does not change while tuning, so only the length
+    // of the span is recomputed for each move
+    long long int lineLen = m_tunedPathLength;
 
     m_lastLength = lineLen;
     m_lastStatus = TUNED;
@@ -102,6 +102,7 @@ protected:
 
     void setWorld( NODE* aWorld );
 
+    ///> @return the length of the whole tuned path, including the pad to die lengths
     virtual long long int origPathLength() const;
 
     ///> current routing start point (end of tail, beginning of head)
@@ -118,6 +119,9 @@ protected:
     MEANDERED_LINE   m_result;
     SEGMENT*         m_initialSegment;
 
+    ///> length of the tuned path before tuning, computed once by Start()
+    long long int m_tunedPathLength;
+
     long long int m_lastLength;
     TUNING_STATUS m_lastStatus;
 };
@@ -105,6 +105,8 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
         m_coupledLength = itemsetLength( m_tunedPathP );
     }
 
+    m_tunedPathLength = origPathLength();
+
     return true;
 }
 
@@ -52,7 +52,7 @@ NODE::NODE()
     m_parent = NULL;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
-    m_index = new INDEX;
+    m_index = std::make_shared<INDEX>();
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -90,8 +90,6 @@ NODE::~NODE()
 
     releaseGarbage();
     unlinkParent();
-
-    delete m_index;
 }
 
 int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
@@ -118,25 +116,53 @@ NODE* NODE::Branch()
     child->m_maxClearance = m_maxClearance;
 
     // Immmediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // the joints and share the overridden item set and the index of the stored items: they are
+    // copied only when the parent or the child changes them.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( ITEM* item : *m_index )
-            child->m_index->Add( item );
-
+        child->m_index = m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
 
-    wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+    wxLogTrace( "PNS", "%d items, %d joints, %d overrides", child->m_index->Size(),
+            (int) child->m_joints.size(), child->m_override ? child->m_override->Size() : 0 );
 
     return child;
 }
 
 
+INDEX* NODE::writableIndex()
+{
+    if( m_index.use_count() > 1 )
+        m_index = std::make_shared<INDEX>( *m_index );
+
+    return m_index.get();
+}
+
+
+NODE::OVERRIDE_SET::OVERRIDE_SET( const OVERRIDE_SET& aOther ) :
+    m_items( aOther.m_items )
+{
+    for( ITEM* item : m_items )
+        item->m_overrideCount++;
+}
+
+
+NODE::OVERRIDE_SET::~OVERRIDE_SET()
+{
+    for( ITEM* item : m_items )
+        item->m_overrideCount--;
+}
+
+
+void NODE::OVERRIDE_SET::Insert( ITEM* aItem )
+{
+    if( m_items.insert( aItem ).second )
+        aItem->m_overrideCount++;
+}
+
+
 void NODE::unlinkParent()
 {
     if( isRoot() )
@@ -287,14 +313,19 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
     visitor.SetCountLimit( aLimitCount );
     visitor.SetWorld( this, NULL );
     visitor.m_forceClearance = aForceClearance;
+
+    // items of the same net never collide when aDifferentNetsOnly is set, so let the index
+    // skip them before they cost a clearance lookup
+    int excludedNet = ( aDifferentNetsOnly && aItem->Net() >= 0 ) ? aItem->Net() : -1;
+
     // first, look for colliding items in the local index
-    m_index->Query( aItem, m_maxClearance, visitor );
+    m_index->Query( aItem, m_maxClearance, visitor, excludedNet );
 
     // if we haven't found enough items, look in the root branch as well.
     if( !isRoot() && ( visitor.m_matchCount < aLimitCount || aLimitCount < 0 ) )
     {
         visitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, visitor );
+        m_root->m_index->Query( aItem, m_maxClearance, visitor, excludedNet );
     }
 
     return aObstacles.size();
@@ -541,7 +572,7 @@ void NODE::addSolid( SOLID* aSolid )
     if( aSolid->IsRoutable() )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
-    m_index->Add( aSolid );
+    writableIndex()->Add( aSolid );
 }
 
 void NODE::Add( std::unique_ptr< SOLID > aSolid )
@@ -553,7 +584,7 @@ void NODE::Add( std::unique_ptr< SOLID > aSolid )
 void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
-    m_index->Add( aVia );
+    writableIndex()->Add( aVia );
 }
 
 void NODE::Add( std::unique_ptr< VIA > aVia )
@@ -614,7 +645,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
-    m_index->Add( aSeg );
+    writableIndex()->Add( aSeg );
 }
 
 bool NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -639,7 +670,7 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 0 ), aArc->Layers(), aArc->Net(), aArc );
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
-    m_index->Add( aArc );
+    writableIndex()->Add( aArc );
 }
 
 void NODE::Add( std::unique_ptr< ARC > aArc )
@@ -673,12 +704,19 @@ void NODE::doRemove( ITEM* aItem )
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+    {
+        if( !m_override )
+            m_override = std::make_shared<OVERRIDE_SET>();
+        else if( m_override.use_count() > 1 )
+            m_override = std::make_shared<OVERRIDE_SET>( *m_override );
+
+        m_override->Insert( aItem );
+    }
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
-        m_index->Remove( aItem );
+        writableIndex()->Remove( aItem );
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -715,27 +753,9 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
     tag.net = net;
     tag.pos = aJoint->Pos();
 
-    bool split;
-    do
-    {
-        split = false;
-        auto range = m_joints.equal_range( tag );
-
-        if( range.first == m_joints.end() )
-            break;
-
-        // find and remove all joints containing the via to be removed
-
-        for( auto f = range.first; f != range.second; ++f )
-        {
-            if( aItem->LayersOverlap( &f->second ) )
-            {
-                m_joints.erase( f );
-                split = true;
-                break;
-            }
-        }
-    } while( split );
+    // find and remove all joints containing the via to be removed
+    while( JOINT* f = m_joints.Find( tag, aItem->Layers() ) )
+        m_joints.Erase( f );
 
     // and re-link them, using the former via's link list
     for(ITEM* link : links)
@@ -1031,26 +1051,13 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
+    JOINT* jt = m_joints.Find( tag, aLayer );
 
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
-
-    if( f == end )
-        return NULL;
+    // The joints of a position are all copied to the branch when one of them changes
+    if( !jt && !isRoot() && !m_joints.Contains( tag ) )
+        jt = m_root->m_joints.Find( tag, aLayer );
 
-    while( f != end )
-    {
-        if( f->second.Layers().Overlaps( aLayer ) )
-            return &f->second;
-
-        ++f;
-    }
-
-    return NULL;
+    return jt;
 }
 
 
@@ -1068,47 +1075,25 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
-    // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
-
-    std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
-
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    // not found in this node and we are not root? copy the joints of the root here.
+    if( !isRoot() && !m_joints.Contains( tag ) )
     {
-        range = m_root->m_joints.equal_range( tag );
-
-        for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
+        m_root->m_joints.ForEach( tag, [this]( const JOINT& aJoint )
+                                       {
+                                           m_joints.Insert( aJoint );
+                                       } );
     }
 
     // now insert and combine overlapping joints
     JOINT jt( aPos, aLayers, aNet );
 
-    bool merged;
-
-    do
+    while( JOINT* f = m_joints.Find( tag, aLayers ) )
     {
-        merged  = false;
-        range   = m_joints.equal_range( tag );
-
-        if( range.first == m_joints.end() )
-            break;
-
-        for( f = range.first; f != range.second; ++f )
-        {
-            if( aLayers.Overlaps( f->second.Layers() ) )
-            {
-                jt.Merge( f->second );
-                m_joints.erase( f );
-                merged = true;
-                break;
-            }
-        }
+        jt.Merge( *f );
+        m_joints.Erase( f );
     }
-    while( merged );
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return m_joints.Insert( std::move( jt ) );
 }
 
 
@@ -1165,10 +1150,10 @@ void NODE::Dump( bool aLong )
         for( j = m_joints.begin(); j != m_joints.end(); ++j )
         {
             wxLogTrace( "PNS", "joint : %s, links : %d\n",
-                    j->second.GetPos().Format().c_str(), j->second.LinkCount() );
+                    j->GetPos().Format().c_str(), j->LinkCount() );
             JOINT::LINKED_ITEMS::const_iterator k;
 
-            for( k = j->second.GetLinkList().begin(); k != j->second.GetLinkList().end(); ++k )
+            for( k = j->GetLinkList().begin(); k != j->GetLinkList().end(); ++k )
             {
                 const ITEM* m_item = *k;
 
@@ -1224,15 +1209,17 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
-    
+    if( m_override )
+    {
+        aRemoved.reserve( m_override->Size() );
+
+        for( ITEM* item : *m_override )
+            aRemoved.push_back( item );
+    }
+
     if( m_index->Size() )
         aAdded.reserve( m_index->Size() );
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
-
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
         aAdded.push_back( *i );
 }
@@ -1270,8 +1257,11 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
-            Remove( item );
+        if( aNode->m_override )
+        {
+            for( ITEM* item : *aNode->m_override )
+                Remove( item );
+        }
 
         for( auto i : *aNode->m_index )
         {
@@ -1412,9 +1402,9 @@ int NODE::QueryJoints( const BOX2I& aBox,
 
     for( auto j = m_joints.begin(); j != m_joints.end(); ++j )
     {
-        if ( aBox.Contains(j->second.Pos()) && j->second.LinkCount ( aKindMask ) )
+        if ( aBox.Contains(j->Pos()) && j->LinkCount ( aKindMask ) )
         {
-            aJoints.push_back( &j->second );
+            aJoints.push_back( &*j );
             n++;
 
         }
@@ -1425,10 +1415,10 @@ int NODE::QueryJoints( const BOX2I& aBox,
 
     for( auto j = m_root->m_joints.begin(); j != m_root->m_joints.end(); ++j )
     {
-        if( ! Overrides( &j->second) )
-        {   if ( aBox.Contains(j->second.Pos()) && j->second.LinkCount ( aKindMask ) )
+        if( ! Overrides( &*j ) )
+        {   if ( aBox.Contains(j->Pos()) && j->LinkCount ( aKindMask ) )
             {
-                aJoints.push_back( &j->second );
+                aJoints.push_back( &*j );
                 n++;
             }
         }
@@ -1454,4 +1444,18 @@ ITEM *NODE::FindItemByParent( const BOARD_CONNECTED_ITEM* aParent )
     return NULL;
 }
 
+
+void NODE::FindItemsByParents( const std::unordered_set<const BOARD_CONNECTED_ITEM*>& aParents,
+                               std::vector<ITEM*>& aItems )
+{
+    if( aParents.empty() )
+        return;
+
+    for( ITEM* item : *m_index )
+    {
+        if( item->Parent() && aParents.count( item->Parent() ) )
+            aItems.push_back( item );
+    }
+}
+
 }
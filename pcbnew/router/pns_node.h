@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -35,6 +36,7 @@
 
 #include "pns_item.h"
 #include "pns_joint.h"
+#include "pns_joint_map.h"
 #include "pns_itemset.h"
 
 namespace PNS {
@@ -419,6 +421,10 @@ public:
     const ITEM_SET FindItemsByParent( const BOARD_CONNECTED_ITEM* aParent );
     ITEM* FindItemByParent( const BOARD_CONNECTED_ITEM* aParent );
 
+    ///> finds the items of any net whose parent is in aParents, with a single scan of the index
+    void FindItemsByParents( const std::unordered_set<const BOARD_CONNECTED_ITEM*>& aParents,
+                             std::vector<ITEM*>& aItems );
+
     bool HasChildren() const
     {
         return !m_children.empty();
@@ -433,13 +439,46 @@ public:
     ///> from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        if( !aItem->m_overrideCount || !m_override )
+            return false;
+
+        return m_override->Contains( aItem );
     }
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
-    typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
-    typedef JOINT_MAP::value_type TagJointPair;
+
+    /**
+     * OVERRIDE_SET
+     *
+     * Set of the root items overridden by a branch. It is shared between a branch and its
+     * children until one of them changes it, and keeps the override count of its items
+     * up to date.
+     */
+    class OVERRIDE_SET
+    {
+    public:
+        OVERRIDE_SET() {}
+        OVERRIDE_SET( const OVERRIDE_SET& aOther );
+        ~OVERRIDE_SET();
+
+        void Insert( ITEM* aItem );
+
+        bool Contains( ITEM* aItem ) const
+        {
+            return m_items.find( aItem ) != m_items.end();
+        }
+
+        int Size() const { return m_items.size(); }
+
+        std::unordered_set<ITEM*>::const_iterator begin() const { return m_items.begin(); }
+        std::unordered_set<ITEM*>::const_iterator end() const { return m_items.end(); }
+
+    private:
+        OVERRIDE_SET& operator=( const OVERRIDE_SET& aOther );
+
+        std::unordered_set<ITEM*> m_items;
+    };
 
     /// nodes are not copyable
     NODE( const NODE& aB );
@@ -468,6 +507,9 @@ private:
     void removeViaIndex( VIA* aVia );
     void removeArcIndex( ARC* aVia );
 
+    ///> returns the index of this node, copying it first if it is shared with another node
+    INDEX* writableIndex();
+
     void doRemove( ITEM* aItem );
     void unlinkParent();
     void releaseChildren();
@@ -492,7 +534,7 @@ private:
             LINKED_ITEM** aSegments, bool& aGuardHit, bool aStopAtLockedJoints );
 
     ///> hash table with the joints, linking the items. Joints are hashed by
-    ///> their position, layer set and net.
+    ///> their position and net, several joints of a position may have disjoint layer sets.
     JOINT_MAP m_joints;
 
     ///> node this node was branched from
@@ -504,8 +546,9 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    ///> hash of root's items that have been changed in this node (null if there are none),
+    ///> shared with the parent until one of them changes it
+    std::shared_ptr<OVERRIDE_SET> m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -513,8 +556,8 @@ private:
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
-    INDEX* m_index;
+    ///> Geometric/Net index of the items, shared with the parent until one of them changes it
+    std::shared_ptr<INDEX> m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
@@ -463,9 +463,31 @@ bool OPTIMIZER::checkConstraints(  int aVertex1, int aVertex2, LINE* aOriginLine
 
 bool OPTIMIZER::checkColliding( LINE* aLine, const SHAPE_LINE_CHAIN& aOptPath )
 {
+    // The merge passes restart from the beginning of the line after each change, and try
+    // again the same bypasses as before: remember the results of the short ones.
+    bool cacheable = aOptPath.PointCount() <= 3 && aOptPath.ArcCount() == 0;
+    PATH_KEY key;
+
+    if( cacheable )
+    {
+        key.m_count = aOptPath.PointCount();
+
+        for( int i = 0; i < key.m_count; i++ )
+            key.m_points[i] = aOptPath.CPoint( i );
+
+        auto cached = m_collisionCache.find( key );
+
+        if( cached != m_collisionCache.end() )
+            return cached->second;
+    }
+
     LINE tmp( *aLine, aOptPath );
+    bool colliding = checkColliding( &tmp );
+
+    if( cacheable )
+        m_collisionCache[key] = colliding;
 
-    return checkColliding( &tmp );
+    return colliding;
 }
 
 
@@ -527,9 +549,7 @@ bool OPTIMIZER::mergeObtuse( LINE* aLine )
                     opt_path.Append( s1opt.B );
                     opt_path.Append( s2opt.B );
 
-                    LINE opt_track( *aLine, opt_path );
-
-                    if( !checkColliding( &opt_track ) )
+                    if( !checkColliding( aLine, opt_path ) )
                     {
                         current_path.Replace( s1.Index() + 1, s2.Index(), ip );
                         // removeCachedSegments(aLine, s1.Index(), s2.Index());
@@ -605,6 +625,10 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
         *aResult = *aLine;
 
     m_keepPostures = false;
+    m_collisionCache.clear();
+
+    if( ROUTER* router = ROUTER::GetInstance() )
+        router->Stats().m_optimizations++;
 
     bool rv = false;
 
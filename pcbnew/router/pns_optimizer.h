@@ -22,6 +22,8 @@
 #ifndef __PNS_OPTIMIZER_H
 #define __PNS_OPTIMIZER_H
 
+#include <algorithm>
+#include <functional>
 #include <unordered_map>
 #include <memory>
 
@@ -156,6 +158,35 @@ private:
         bool m_isStatic;
     };
 
+    ///> a short candidate path (a bypass or an obtuse corner), the key of the collision cache
+    struct PATH_KEY
+    {
+        VECTOR2I m_points[3];
+        int      m_count;
+
+        bool operator==( const PATH_KEY& aOther ) const
+        {
+            return m_count == aOther.m_count
+                   && std::equal( m_points, m_points + m_count, aOther.m_points );
+        }
+    };
+
+    struct PATH_KEY_HASH
+    {
+        std::size_t operator()( const PATH_KEY& aKey ) const
+        {
+            std::size_t seed = aKey.m_count;
+
+            for( int i = 0; i < aKey.m_count; i++ )
+            {
+                seed = seed * 31 + std::hash<int>()( aKey.m_points[i].x );
+                seed = seed * 31 + std::hash<int>()( aKey.m_points[i].y );
+            }
+
+            return seed;
+        }
+    };
+
     bool mergeObtuse( LINE* aLine );
     bool mergeFull( LINE* aLine );
     bool removeUglyCorners( LINE* aLine );
@@ -190,6 +221,11 @@ private:
     std::vector<OPT_CONSTRAINT*> m_constraints;
     typedef std::unordered_map<ITEM*, CACHED_ITEM> CachedItemTags;
     CachedItemTags m_cacheTags;
+
+    ///> collision results of the candidate paths already tried on the line being optimized.
+    ///> The line's width, net and layers and the world do not change during an optimization,
+    ///> so the results stay valid until the next one.
+    std::unordered_map<PATH_KEY, bool, PATH_KEY_HASH> m_collisionCache;
     NODE* m_world;
     int m_collisionKindMask;
     int m_effortLevel;
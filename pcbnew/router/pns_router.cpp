@@ -29,8 +29,11 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <gal/color4d.h>
 
+#include <advanced_config.h>
+#include <class_board_connected_item.h>
 #include <pgm_base.h>
 #include <settings/settings_manager.h>
+#include <trace_events.h>
 
 #include <pcb_painter.h>
 #include <pcbnew_settings.h>
@@ -77,6 +80,10 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_logEvents = false;
+    m_worldStale = true;
+    m_committing = false;
+    m_anytime = false;
 }
 
 
@@ -86,10 +93,18 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+void ROUTER::SetActive()
+{
+    theRouter = this;
+}
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
-    theRouter = nullptr;
+
+    if( theRouter == this )
+        theRouter = nullptr;
 }
 
 
@@ -99,7 +114,26 @@ void ROUTER::SyncWorld()
 
     m_world = std::make_unique<NODE>( );
     m_iface->SyncWorld( m_world.get() );
+    m_worldStale = false;
+}
+
 
+void ROUTER::UpdateWorld( const std::vector<BOARD_ITEM*>& aRemoved,
+                          const std::vector<BOARD_ITEM*>& aAdded )
+{
+    if( m_committing || m_worldStale || !m_world )
+        return;
+
+    // The branches of the current operation refer to the items of the world
+    if( RoutingInProgress() || !m_iface->SyncItems( m_world.get(), aRemoved, aAdded ) )
+        m_worldStale = true;
+}
+
+
+void ROUTER::RefreshWorld()
+{
+    if( m_worldStale || !m_world )
+        SyncWorld();
 }
 
 void ROUTER::ClearWorld()
@@ -130,7 +164,12 @@ const ITEM_SET ROUTER::QueryHoverItems( const VECTOR2I& aP )
 
 bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aItem, int aDragMode )
 {
-    return StartDragging( aP, ITEM_SET( aItem ), aDragMode );
+    if( !StartDragging( aP, ITEM_SET( aItem ), aDragMode ) )
+        return false;
+
+    // Only the drags of a single item can be replayed, the component drags are not logged
+    logEvent( LOGGER::EVT_START_DRAG, aP, aItem, aDragMode );
+    return true;
 }
 
 
@@ -159,7 +198,10 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     m_dragger->SetDebugDecorator ( m_iface->GetDebugDecorator () );
 
     if( m_dragger->Start ( aP, aStartItems ) )
+    {
         m_state = DRAG_SEGMENT;
+        startBudget();
+    }
     else
     {
         m_dragger.reset();
@@ -232,6 +274,8 @@ bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 
     m_currentEnd = aP;
     m_state = ROUTE_TRACK;
+    startBudget();
+    logEvent( LOGGER::EVT_START_ROUTE, aP, aStartItem, aLayer );
     return rv;
 }
 
@@ -245,16 +289,76 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    SCOPED_TRACE_EVENT trace( "ROUTER::Move" );
+
     m_currentEnd = aP;
 
+    if( m_logEvents )
+        logEvent( LOGGER::EVT_MOVE, aP, endItem );
+
+    if( !m_anytime )
+    {
+        moveStep( aP, endItem );
+        return;
+    }
+
+    m_budget.StartMove();
+    moveStep( aP, endItem );
+    m_budget.EndStep();
+}
+
+
+bool ROUTER::Refine( ITEM* aItem )
+{
+    if( !RefinePending() )
+        return false;
+
+    m_budget.StartRefine();
+    moveStep( m_currentEnd, aItem );
+    m_budget.EndStep();
+
+    return true;
+}
+
+
+bool ROUTER::RefinePending() const
+{
+    return m_anytime && RoutingInProgress() && m_budget.RefinePending();
+}
+
+
+TIME_LIMIT ROUTER::ShoveTimeLimit() const
+{
+    if( m_anytime && m_state != IDLE )
+        return m_budget.Limit();
+
+    return m_settings->ShoveTimeLimit();
+}
+
+
+void ROUTER::ShoveTimeExpired()
+{
+    m_budget.Exhausted();
+}
+
+
+void ROUTER::startBudget()
+{
+    m_anytime = ADVANCED_CFG::GetCfg().m_anytimeRouting;
+    m_budget.Reset( m_settings->ShoveTimeLimit().Get() );
+}
+
+
+void ROUTER::moveStep( const VECTOR2I& aP, ITEM* aItem )
+{
     switch( m_state )
     {
     case ROUTE_TRACK:
-        movePlacing( aP, endItem );
+        movePlacing( aP, aItem );
         break;
 
     case DRAG_SEGMENT:
-        moveDragging( aP, endItem );
+        moveDragging( aP, aItem );
         break;
 
     default:
@@ -383,7 +487,10 @@ void ROUTER::CommitRouting( NODE* aNode )
     for( auto item : added )
         m_iface->AddItem( item );
 
+    m_committing = true;
     m_iface->Commit();
+    m_committing = false;
+
     m_world->Commit( aNode );
 }
 
@@ -392,6 +499,12 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
     bool rv = false;
 
+    if( m_logEvents )
+        logEvent( LOGGER::EVT_FIX, aP, aEndItem );
+
+    // The fixed items are not the ones of the last move anymore
+    m_budget.Cancel();
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -416,6 +529,7 @@ void ROUTER::UndoLastSegment()
         return;
 
     m_placer->UnfixRoute();
+    m_budget.Cancel();
 }
 
 
@@ -445,8 +559,19 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    if( m_logEvents )
+    {
+        logEvent( LOGGER::EVT_ABORT, m_currentEnd, nullptr );
+
+        const wxString& logFile = ADVANCED_CFG::GetCfg().m_routerEventLogFile;
+        m_eventLog.Save( std::string( logFile.fn_str() ), true );
+        m_eventLog.Clear();
+        m_logEvents = false;
+    }
+
     m_placer.reset();
     m_dragger.reset();
+    m_budget.Cancel();
 
     m_iface->EraseView();
 
@@ -505,6 +630,36 @@ int ROUTER::GetCurrentLayer() const
 }
 
 
+void ROUTER::logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       int aLayer )
+{
+    if( aType == LOGGER::EVT_START_ROUTE || aType == LOGGER::EVT_START_DRAG )
+        m_logEvents = !ADVANCED_CFG::GetCfg().m_routerEventLogFile.IsEmpty();
+
+    if( !m_logEvents )
+        return;
+
+    LOGGER::EVENT_ENTRY evt;
+
+    evt.m_type = aType;
+    evt.m_p = aP;
+
+    if( aItem && aItem->Parent() )
+        evt.m_uuid = aItem->Parent()->m_Uuid.AsString().ToStdString();
+
+    if( aType == LOGGER::EVT_START_ROUTE || aType == LOGGER::EVT_START_DRAG )
+    {
+        evt.m_layer = aLayer;
+        evt.m_mode = Settings().Mode();
+        evt.m_trackWidth = m_sizes.TrackWidth();
+        evt.m_viaDiameter = m_sizes.ViaDiameter();
+        evt.m_viaDrill = m_sizes.ViaDrill();
+    }
+
+    m_eventLog.Log( evt );
+}
+
+
 void ROUTER::DumpLog()
 {
     LOGGER* logger = nullptr;
@@ -22,6 +22,7 @@
 #ifndef __PNS_ROUTER_H
 #define __PNS_ROUTER_H
 
+#include <atomic>
 #include <list>
 
 #include <memory>
@@ -35,8 +36,11 @@
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
 #include "pns_itemset.h"
+#include "pns_logger.h"
 #include "pns_node.h"
 
+class BOARD_ITEM;
+
 namespace KIGFX
 {
 
@@ -96,6 +100,19 @@ enum DRAG_MODE
 
         virtual void SetRouter( ROUTER* aRouter ) = 0;
         virtual void SyncWorld( NODE* aNode ) = 0;
+
+        /**
+         * Replaces in aNode the items of the board items aRemoved by the items of aAdded
+         * (an item modified by a commit is in both lists).
+         * @return false if the changes cannot be applied incrementally, and the world must be
+         * synchronized again
+         */
+        virtual bool SyncItems( NODE* aNode, const std::vector<BOARD_ITEM*>& aRemoved,
+                                const std::vector<BOARD_ITEM*>& aAdded )
+        {
+            return false;
+        }
+
         virtual void AddItem( ITEM* aItem ) = 0;
         virtual void RemoveItem( ITEM* aItem ) = 0;
         virtual bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) = 0;
@@ -112,6 +129,17 @@ enum DRAG_MODE
         virtual DEBUG_DECORATOR* GetDebugDecorator() = 0;
 };
 
+/**
+ * Counters of the work done by the router, read by the benchmarks.
+ * Atomic, as the router may evaluate some candidates on several threads.
+ */
+struct ROUTER_STATS
+{
+    std::atomic<int64_t> m_shoveIterations { 0 };  ///< iterations of the main loop of SHOVE
+    std::atomic<int64_t> m_optimizations { 0 };    ///< lines passed to OPTIMIZER::Optimize()
+};
+
+
 class ROUTER
 {
 private:
@@ -132,14 +160,45 @@ public:
 
     static ROUTER* GetInstance();
 
+    ///> Makes this router the one returned by GetInstance(), when several routers exist
+    void SetActive();
+
     void ClearWorld();
     void SyncWorld();
 
+    /**
+     * Applies the changes of a board commit to the world, or marks the world as stale if
+     * they cannot be applied incrementally. The commits of the router itself are ignored,
+     * as it updates its world on its own.
+     */
+    void UpdateWorld( const std::vector<BOARD_ITEM*>& aRemoved,
+                      const std::vector<BOARD_ITEM*>& aAdded );
+
+    ///> The board changed without a commit, the world must be synchronized again before use
+    void InvalidateWorld() { m_worldStale = true; }
+
+    ///> Synchronizes the world again, if it is stale
+    void RefreshWorld();
+
     void SetView( KIGFX::VIEW* aView );
 
     bool RoutingInProgress() const;
     bool StartRouting( const VECTOR2I& aP, ITEM* aItem, int aLayer );
     void Move( const VECTOR2I& aP, ITEM* aItem );
+
+    /**
+     * Runs the last move again with a larger shove budget, when it ran out of budget.
+     * Called between the input events, so that the result keeps improving while the cursor
+     * does not move.
+     * @param aItem is the end item of the last move, picked again by the caller as the last
+     * move may have replaced it
+     * @return true if the routed or dragged items were updated
+     */
+    bool Refine( ITEM* aItem );
+
+    ///> @return true if the result of the last move can be refined by Refine()
+    bool RefinePending() const;
+
     bool FixRoute( const VECTOR2I& aP, ITEM* aItem, bool aForceFinish = false );
     void BreakSegment( ITEM *aItem, const VECTOR2I& aP );
 
@@ -232,7 +291,23 @@ public:
         return m_iface;
     }
 
+    ROUTER_STATS& Stats()
+    {
+        return m_stats;
+    }
+
+    ///> @return the time limit of the shove steps, adapted to the latency of the moves
+    TIME_LIMIT ShoveTimeLimit() const;
+
+    ///> Called by SHOVE when a step stopped before completion, as it ran out of time
+    void ShoveTimeExpired();
+
 private:
+    void logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                   int aLayer = -1 );
+
+    void startBudget();
+    void moveStep( const VECTOR2I& aP, ITEM* aItem );
     void movePlacing( const VECTOR2I& aP, ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, ITEM* aItem );
 
@@ -283,6 +358,19 @@ private:
 
     wxString m_toolStatusbarName;
     wxString m_failureReason;
+
+    ///> Events of the current operation, saved to ADVANCED_CFG::m_routerEventLogFile
+    LOGGER m_eventLog;
+    bool m_logEvents;
+
+    ROUTER_STATS m_stats;
+
+    ///> Adaptive shove budget of the current operation, see ADVANCED_CFG::m_anytimeRouting
+    ANYTIME_BUDGET m_budget;
+    bool m_anytime;
+
+    bool m_worldStale;      ///< the world does not match the board anymore
+    bool m_committing;      ///< the board changes come from CommitRouting()
 };
 
 }
@@ -19,6 +19,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <deque>
 #include <cassert>
 #include <math/box2.h>
@@ -38,6 +39,9 @@
 
 #include "time_limit.h"
 
+#include <advanced_config.h>
+#include <thread_pool.h>
+
 
 typedef VECTOR2I::extended_type ecoord;
 
@@ -158,102 +162,157 @@ SHOVE::SHOVE_STATUS SHOVE::walkaroundLoneVia( LINE& aCurrent, LINE& aObstacle, L
 
 
 /*
- * TODO describe....
+ * Walks the obstacle around the hull set in one of the 4 possible ways (clockwise or not,
+ * starting from the first or the last hull), without changing the world.
  */
-SHOVE::SHOVE_STATUS SHOVE::processHullSet( LINE& aCurrent, LINE& aObstacle,
-                                                   LINE& aShoved, const HULL_SET& aHulls )
+SHOVE::HULL_ATTEMPT SHOVE::tryHullSet( int aAttempt, const LINE& aCurrent,
+                                       const LINE& aObstacle, LINE& aShoved,
+                                       const HULL_SET& aHulls ) const
 {
     const SHAPE_LINE_CHAIN& obs = aObstacle.CLine();
 
-    int attempt;
-
-    for( attempt = 0; attempt < 4; attempt++ )
-    {
-        bool invertTraversal = ( attempt >= 2 );
-        bool clockwise = attempt % 2;
-        int vFirst = -1, vLast = -1;
+    bool invertTraversal = ( aAttempt >= 2 );
+    bool clockwise = aAttempt % 2;
+    int vFirst = -1, vLast = -1;
 
-        SHAPE_LINE_CHAIN path;
-        LINE l( aObstacle );
+    SHAPE_LINE_CHAIN path;
+    LINE& l = aShoved;
 
-        for( int i = 0; i < (int) aHulls.size(); i++ )
-        {
-            const SHAPE_LINE_CHAIN& hull = aHulls[invertTraversal ? aHulls.size() - 1 - i : i];
+    for( int i = 0; i < (int) aHulls.size(); i++ )
+    {
+        const SHAPE_LINE_CHAIN& hull = aHulls[invertTraversal ? aHulls.size() - 1 - i : i];
 
-            if( ! l.Walkaround( hull, path, clockwise ) )
-                return SH_INCOMPLETE;
+        if( ! l.Walkaround( hull, path, clockwise ) )
+            return HA_STUCK;
 
-            path.Simplify();
-            l.SetShape( path );
-        }
+        path.Simplify();
+        l.SetShape( path );
+    }
 
-        for( int i = 0; i < std::min( path.PointCount(), obs.PointCount() ); i++ )
+    for( int i = 0; i < std::min( path.PointCount(), obs.PointCount() ); i++ )
+    {
+        if( path.CPoint( i ) != obs.CPoint( i ) )
         {
-            if( path.CPoint( i ) != obs.CPoint( i ) )
-            {
-                vFirst = i;
-                break;
-            }
+            vFirst = i;
+            break;
         }
+    }
 
-        int k = obs.PointCount() - 1;
-        for( int i = path.PointCount() - 1; i >= 0 && k >= 0; i--, k-- )
+    int k = obs.PointCount() - 1;
+    for( int i = path.PointCount() - 1; i >= 0 && k >= 0; i--, k-- )
+    {
+        if( path.CPoint( i ) != obs.CPoint( k ) )
         {
-            if( path.CPoint( i ) != obs.CPoint( k ) )
-            {
-                vLast = i;
-                break;
-            }
+            vLast = i;
+            break;
         }
+    }
 
-        if( ( vFirst < 0 || vLast < 0 ) && !path.CompareGeometry( aObstacle.CLine() ) )
-        {
-            wxLogTrace( "PNS", "attempt %d fail vfirst-last", attempt );
-            continue;
-        }
+    if( ( vFirst < 0 || vLast < 0 ) && !path.CompareGeometry( aObstacle.CLine() ) )
+    {
+        wxLogTrace( "PNS", "attempt %d fail vfirst-last", aAttempt );
+        return HA_FAILED;
+    }
 
-        if( path.CPoint( -1 ) != obs.CPoint( -1 ) || path.CPoint( 0 ) != obs.CPoint( 0 ) )
-        {
-            wxLogTrace( "PNS", "attempt %d fail vend-start\n", attempt );
-            continue;
-        }
+    if( path.CPoint( -1 ) != obs.CPoint( -1 ) || path.CPoint( 0 ) != obs.CPoint( 0 ) )
+    {
+        wxLogTrace( "PNS", "attempt %d fail vend-start\n", aAttempt );
+        return HA_FAILED;
+    }
 
-        if( !checkBumpDirection( aCurrent, l ) )
-        {
-            wxLogTrace( "PNS", "attempt %d fail direction-check", attempt );
-            aShoved.SetShape( l.CLine() );
+    if( !checkBumpDirection( aCurrent, l ) )
+    {
+        wxLogTrace( "PNS", "attempt %d fail direction-check", aAttempt );
+        return HA_WRONG_DIRECTION;
+    }
 
-            continue;
-        }
+    if( path.SelfIntersecting() )
+    {
+        wxLogTrace( "PNS", "attempt %d fail self-intersect", aAttempt );
+        return HA_FAILED;
+    }
+
+    bool colliding = m_currentNode->CheckColliding( &l, &aCurrent, ITEM::ANY_T, m_forceClearance );
+
+    if( ( aCurrent.Marker() & MK_HEAD ) && !colliding )
+    {
+        JOINT* jtStart = m_currentNode->FindJoint( aCurrent.CPoint( 0 ), &aCurrent );
 
-        if( path.SelfIntersecting() )
+        for( ITEM* item : jtStart->LinkList() )
         {
-            wxLogTrace( "PNS", "attempt %d fail self-intersect", attempt );
-            continue;
+            if( m_currentNode->CheckColliding( item, &l ) )
+                colliding = true;
         }
+    }
+
+    if( colliding )
+    {
+        wxLogTrace( "PNS", "attempt %d fail coll-check", aAttempt );
+        return HA_FAILED;
+    }
+
+    return HA_OK;
+}
+
+
+/*
+ * TODO describe....
+ */
+SHOVE::SHOVE_STATUS SHOVE::processHullSet( LINE& aCurrent, LINE& aObstacle,
+                                                   LINE& aShoved, const HULL_SET& aHulls )
+{
+    const int attemptCount = 4;
+
+    // Below this many hull vertices, the attempts are too quick to be worth a thread
+    const int minParallelHullVertices = 64;
+
+    HULL_ATTEMPT outcome[attemptCount];
+    std::vector<LINE> shoved( attemptCount, aObstacle );
+
+    int hullVertices = 0;
+
+    for( const SHAPE_LINE_CHAIN& hull : aHulls )
+        hullVertices += hull.PointCount();
 
-        bool colliding = m_currentNode->CheckColliding( &l, &aCurrent, ITEM::ANY_T, m_forceClearance );
+    // The attempts only query the world, so they can all be tried at once.  Their outcomes
+    // are then taken in the same order as the serial search, so the result is the same.
+    bool parallel = ADVANCED_CFG::GetCfg().m_parallelRouterCandidates
+                    && hullVertices >= minParallelHullVertices;
 
-        if( ( aCurrent.Marker() & MK_HEAD ) && !colliding )
+    if( parallel )
+    {
+        std::atomic<int> nextAttempt( 0 );
+
+        auto work = [&]()
         {
-            JOINT* jtStart = m_currentNode->FindJoint( aCurrent.CPoint( 0 ), &aCurrent );
+            for( int i = nextAttempt++; i < attemptCount; i = nextAttempt++ )
+                outcome[i] = tryHullSet( i, aCurrent, aObstacle, shoved[i], aHulls );
+        };
 
-            for( ITEM* item : jtStart->LinkList() )
-            {
-                if( m_currentNode->CheckColliding( item, &l ) )
-                    colliding = true;
-            }
-        }
+        GetKiCadThreadPool().RunParallel( work, attemptCount );
+    }
 
-        if( colliding )
+    for( int attempt = 0; attempt < attemptCount; attempt++ )
+    {
+        if( !parallel )
+            outcome[attempt] = tryHullSet( attempt, aCurrent, aObstacle, shoved[attempt], aHulls );
+
+        switch( outcome[attempt] )
         {
-            wxLogTrace( "PNS", "attempt %d fail coll-check", attempt );
-            continue;
-        }
+        case HA_OK:
+            aShoved.SetShape( shoved[attempt].CLine() );
+            return SH_OK;
 
-        aShoved.SetShape( l.CLine() );
+        case HA_WRONG_DIRECTION:
+            aShoved.SetShape( shoved[attempt].CLine() );
+            break;
 
-        return SH_OK;
+        case HA_STUCK:
+            return SH_INCOMPLETE;
+
+        case HA_FAILED:
+            break;
+        }
     }
 
     return SH_INCOMPLETE;
@@ -1196,7 +1255,7 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
            m_currentNode->JointCount() );
 
     int iterLimit = Settings().ShoveIterationLimit();
-    TIME_LIMIT timeLimit = Settings().ShoveTimeLimit();
+    TIME_LIMIT timeLimit = Router()->ShoveTimeLimit();
 
     m_iter = 0;
 
@@ -1214,9 +1273,17 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         st = shoveIteration( m_iter );
 
         m_iter++;
+        Router()->Stats().m_shoveIterations++;
+
+        if( st == SH_INCOMPLETE || m_iter >= iterLimit )
+        {
+            st = SH_INCOMPLETE;
+            break;
+        }
 
-        if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit )
+        if( timeLimit.Expired() )
         {
+            Router()->ShoveTimeExpired();
             st = SH_INCOMPLETE;
             break;
         }
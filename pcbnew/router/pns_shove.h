@@ -107,9 +107,21 @@ private:
         bool m_locked;
     };
 
+    ///> outcome of one of the ways of walking an obstacle line around a hull set
+    enum HULL_ATTEMPT
+    {
+        HA_OK = 0,
+        HA_FAILED,
+        HA_WRONG_DIRECTION,
+        HA_STUCK
+    };
+
     SHOVE_STATUS processHullSet( LINE& aCurrent, LINE& aObstacle,
                                  LINE& aShoved, const HULL_SET& hulls );
 
+    HULL_ATTEMPT tryHullSet( int aAttempt, const LINE& aCurrent, const LINE& aObstacle,
+                             LINE& aShoved, const HULL_SET& aHulls ) const;
+
     NODE* reduceSpringback( const ITEM_SET& aHeadSet, VIA_HANDLE& aDraggedVia );
 
     bool pushSpringback( NODE* aNode, const OPT_BOX2I& aAffectedArea, VIA* aDraggedVia );
@@ -32,6 +32,11 @@
 
 namespace PNS {
 
+///> The clearances of the hulls kept by a solid: the clearances of a few net classes and
+///> track widths
+static const size_t MAX_CACHED_HULLS = 8;
+
+
 const SHAPE_LINE_CHAIN SOLID::Hull( int aClearance, int aWalkaroundThickness ) const
 {
     int cl = aClearance + ( aWalkaroundThickness + 1 )/ 2;
@@ -62,7 +67,26 @@ const SHAPE_LINE_CHAIN SOLID::Hull( int aClearance, int aWalkaroundThickness ) c
     {
         SHAPE_SIMPLE* convex = static_cast<SHAPE_SIMPLE*>( m_shape );
 
-        return ConvexHull( *convex, cl );
+        {
+            std::lock_guard<std::mutex> lock( m_hullsLock );
+
+            for( const std::pair<int, SHAPE_LINE_CHAIN>& hull : m_hulls )
+            {
+                if( hull.first == cl )
+                    return hull.second;
+            }
+        }
+
+        SHAPE_LINE_CHAIN hull = ConvexHull( *convex, cl );
+
+        std::lock_guard<std::mutex> lock( m_hullsLock );
+
+        if( m_hulls.size() >= MAX_CACHED_HULLS )
+            m_hulls.erase( m_hulls.begin() );
+
+        m_hulls.emplace_back( cl, hull );
+
+        return hull;
     }
 
     default:
@@ -87,6 +111,7 @@ void SOLID::SetPos( const VECTOR2I& aCenter )
         m_shape->Move( delta );
 
     m_pos = aCenter;
+    clearHulls();
 }
 
 
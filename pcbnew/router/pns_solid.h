@@ -28,6 +28,10 @@
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "pns_item.h"
 
 namespace PNS {
@@ -52,6 +56,9 @@ public:
         m_shape = aSolid.m_shape->Clone();
         m_pos = aSolid.m_pos;
         m_padToDie = aSolid.m_padToDie;
+
+        std::lock_guard<std::mutex> lock( aSolid.m_hullsLock );
+        m_hulls = aSolid.m_hulls;
     }
 
     static inline bool ClassOf( const ITEM* aItem )
@@ -71,6 +78,7 @@ public:
             delete m_shape;
 
         m_shape = shape;
+        clearHulls();
     }
 
     const VECTOR2I& Pos() const
@@ -111,10 +119,23 @@ public:
     }
 
 private:
+    void clearHulls()
+    {
+        std::lock_guard<std::mutex> lock( m_hullsLock );
+        m_hulls.clear();
+    }
+
     VECTOR2I    m_pos;
     SHAPE*      m_shape;
     VECTOR2I    m_offset;
     int         m_padToDie;
+
+    ///> The hulls of a SH_SIMPLE shape (the custom, rounded and rotated pads) by clearance,
+    ///> as the router asks for the same few clearances many times around a pad
+    mutable std::vector<std::pair<int, SHAPE_LINE_CHAIN>> m_hulls;
+
+    ///> Hull() is called from several threads by the walkaround and the shove
+    mutable std::mutex m_hullsLock;
 };
 
 }
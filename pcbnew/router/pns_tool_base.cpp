@@ -47,6 +47,8 @@ using namespace std::placeholders;
 #include "pns_arc.h"
 #include "pns_kicad_iface.h"
 #include "pns_tool_base.h"
+#include "router_tool.h"
+#include "length_tuner_tool.h"
 #include "pns_segment.h"
 #include "pns_solid.h"
 #include "pns_via.h"
@@ -92,19 +94,31 @@ TOOL_BASE::~TOOL_BASE()
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
     delete m_gridHelper;
-    delete m_iface;
-    delete m_router;
-
-    m_iface = new PNS_KICAD_IFACE;
-    m_iface->SetBoard( board() );
-    m_iface->SetView( getView() );
-    m_iface->SetHostTool( this );
-    m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
 
-    m_router = new ROUTER;
-    m_router->SetInterface( m_iface );
-    m_router->ClearWorld();
-    m_router->SyncWorld();
+    // The world follows the board commits while the tool is not running (see UpdateWorlds()),
+    // it is only built again when a change could not be applied to it.
+    if( aReason == RUN && m_router )
+    {
+        m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
+        m_router->SetActive();
+        m_router->RefreshWorld();
+    }
+    else
+    {
+        delete m_iface;
+        delete m_router;
+
+        m_iface = new PNS_KICAD_IFACE;
+        m_iface->SetBoard( board() );
+        m_iface->SetView( getView() );
+        m_iface->SetHostTool( this );
+        m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
+
+        m_router = new ROUTER;
+        m_router->SetInterface( m_iface );
+        m_router->ClearWorld();
+        m_router->SyncWorld();
+    }
 
     m_router->UpdateSizes( m_savedSizes );
 
@@ -119,6 +133,41 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
 }
 
 
+static std::vector<TOOL_BASE*> routerTools( TOOL_MANAGER* aToolMgr )
+{
+    std::vector<TOOL_BASE*> tools;
+
+    if( ROUTER_TOOL* router = aToolMgr->GetTool<ROUTER_TOOL>() )
+        tools.push_back( router );
+
+    if( LENGTH_TUNER_TOOL* tuner = aToolMgr->GetTool<LENGTH_TUNER_TOOL>() )
+        tools.push_back( tuner );
+
+    return tools;
+}
+
+
+void TOOL_BASE::UpdateWorlds( TOOL_MANAGER* aToolMgr, const std::vector<BOARD_ITEM*>& aRemoved,
+                              const std::vector<BOARD_ITEM*>& aAdded )
+{
+    for( TOOL_BASE* tool : routerTools( aToolMgr ) )
+    {
+        if( tool->m_router )
+            tool->m_router->UpdateWorld( aRemoved, aAdded );
+    }
+}
+
+
+void TOOL_BASE::InvalidateWorlds( TOOL_MANAGER* aToolMgr )
+{
+    for( TOOL_BASE* tool : routerTools( aToolMgr ) )
+    {
+        if( tool->m_router )
+            tool->m_router->InvalidateWorld();
+    }
+}
+
+
 ITEM* TOOL_BASE::pickSingleItem( const VECTOR2I& aWhere, int aNet, int aLayer, bool aIgnorePads,
 								 const std::vector<ITEM*> aAvoidItems)
 {
@@ -307,7 +356,6 @@ void TOOL_BASE::updateStartItem( const TOOL_EVENT& aEvent, bool aIgnorePads )
 
 void TOOL_BASE::updateEndItem( const TOOL_EVENT& aEvent )
 {
-    int layer;
     bool snapEnabled = !aEvent.Modifier( MD_SHIFT );
     m_gridHelper->SetUseGrid( !aEvent.Modifier( MD_ALT ) );
     m_gridHelper->SetSnap( snapEnabled );
@@ -325,6 +373,36 @@ void TOOL_BASE::updateEndItem( const TOOL_EVENT& aEvent )
         return;
     }
 
+    ITEM* endItem = pickEndItem( mousePos );
+
+    if( endItem )
+    {
+        m_endItem = endItem;
+        m_endSnapPoint = snapToItem( snapEnabled, endItem, mousePos );
+    } else {
+        m_endItem = nullptr;
+        m_endSnapPoint = m_gridHelper->Align( mousePos );
+    }
+
+    controls()->ForceCursorPosition( true, m_endSnapPoint );
+
+    if( m_endItem )
+    {
+        wxLogTrace( "PNS", "%s, layer : %d", m_endItem->KindStr().c_str(), m_endItem->Layers().Start() );
+    }
+}
+
+
+ITEM* TOOL_BASE::pickEndItem( const VECTOR2I& aWhere )
+{
+    if( m_router->Settings().Mode() != RM_MarkObstacles &&
+        ( m_router->GetCurrentNets().empty() || m_router->GetCurrentNets().front() < 0 ) )
+    {
+        return nullptr;
+    }
+
+    int layer;
+
     if( m_router->IsPlacingVia() )
         layer = -1;
     else
@@ -336,27 +414,13 @@ void TOOL_BASE::updateEndItem( const TOOL_EVENT& aEvent )
 
     for( int net : nets )
     {
-        endItem = pickSingleItem( mousePos, net, layer, false, { m_startItem } );
+        endItem = pickSingleItem( aWhere, net, layer, false, { m_startItem } );
 
         if( endItem )
             break;
     }
 
-    if( checkSnap( endItem ) )
-    {
-        m_endItem = endItem;
-        m_endSnapPoint = snapToItem( snapEnabled, endItem, mousePos );
-    } else {
-        m_endItem = nullptr;
-        m_endSnapPoint = m_gridHelper->Align( mousePos );
-    }
-
-    controls()->ForceCursorPosition( true, m_endSnapPoint );
-
-    if( m_endItem )
-    {
-        wxLogTrace( "PNS", "%s, layer : %d", m_endItem->KindStr().c_str(), m_endItem->Layers().Start() );
-    }
+    return checkSnap( endItem ) ? endItem : nullptr;
 }
 
 
@@ -51,6 +51,18 @@ public:
 
     ROUTER* Router() const;
 
+    /**
+     * Applies the changes of a board commit to the worlds of the router tools of aToolMgr,
+     * which are kept between two runs of the tools.
+     * @param aRemoved are the board items removed or modified by the commit
+     * @param aAdded are the board items added or modified by the commit
+     */
+    static void UpdateWorlds( TOOL_MANAGER* aToolMgr, const std::vector<BOARD_ITEM*>& aRemoved,
+                              const std::vector<BOARD_ITEM*>& aAdded );
+
+    ///> Marks the worlds of the router tools as stale, after a change made without a commit
+    static void InvalidateWorlds( TOOL_MANAGER* aToolMgr );
+
 protected:
     bool checkSnap( ITEM* aItem );
     const VECTOR2I snapToItem( bool aEnabled, ITEM* aItem, VECTOR2I aP);
@@ -59,6 +71,9 @@ protected:
     virtual void highlightNet( bool aEnabled, int aNetcode = -1 );
     virtual void updateStartItem( const TOOL_EVENT& aEvent, bool aIgnorePads = false );
     virtual void updateEndItem( const TOOL_EVENT& aEvent );
+
+    ///> @return the item of the current nets the routed track can end on, at aWhere
+    ITEM* pickEndItem( const VECTOR2I& aWhere );
     void deleteTraces( ITEM* aStartItem, bool aWholeTrack );
 
     MSG_PANEL_ITEMS m_panelItems;
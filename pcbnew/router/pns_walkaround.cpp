@@ -19,9 +19,13 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+
 #include <core/optional.h>
 
 #include <geometry/shape_line_chain.h>
+#include <advanced_config.h>
+#include <thread_pool.h>
 
 #include "pns_walkaround.h"
 #include "pns_optimizer.h"
@@ -153,7 +157,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
 
 
-bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
+static bool clipToLoopStart( SHAPE_LINE_CHAIN& l, DEBUG_DECORATOR* aDbg )
 {
     auto ip = l.SelfIntersecting();
 
@@ -166,8 +170,8 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
         int pidx2 = tail.Split( ip->p );
         
-        auto dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-        dbg->AddPoint( ip->p, 5 );
+        if( aDbg )
+            aDbg->AddPoint( ip->p, 5 );
         
         l = lead;
         l.Append( tail.Slice( 0, pidx2 ) );
@@ -179,6 +183,55 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 }
 
 
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::walkSingleDirection( LINE& aPath,
+                                                               bool aWindingDirection )
+{
+    WALKAROUND_STATUS status = IN_PROGRESS;
+
+    while( m_iteration < m_iterationLimit )
+    {
+        status = singleStep( aPath, aWindingDirection );
+
+        if( clipToLoopStart( aPath.Line(), nullptr ) )
+            status = ALMOST_DONE;
+
+        if( status != IN_PROGRESS )
+            break;
+
+        m_iteration++;
+    }
+
+    return status;
+}
+
+
+void WALKAROUND::walkParallel( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+                               WALKAROUND_STATUS& aStatusCcw )
+{
+    // Each direction gets its own copy of the walker, as the obstacle being walked around,
+    // the iteration and the blockage counters are per direction.  The world is only
+    // queried, so both threads can share it.  The debug graphics are not thread safe.
+    WALKAROUND walkers[2] = { *this, *this };
+    LINE* paths[2] = { &aPathCw, &aPathCcw };
+    WALKAROUND_STATUS* status[2] = { &aStatusCw, &aStatusCcw };
+    std::atomic<int> nextDirection( 0 );
+
+    for( WALKAROUND& walker : walkers )
+    {
+        walker.SetDebugDecorator( nullptr );
+        walker.SetLogger( nullptr );
+    }
+
+    auto work = [&]()
+    {
+        for( int i = nextDirection++; i < 2; i = nextDirection++ )
+            *status[i] = walkers[i].walkSingleDirection( *paths[i], i == 0 );
+    };
+
+    GetKiCadThreadPool().RunParallel( work, 2 );
+}
+
+
 
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
@@ -213,35 +266,10 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
+    if( !m_forceWinding && ADVANCED_CFG::GetCfg().m_parallelRouterCandidates )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
-
-        //Dbg()->AddLine( path_cw.CLine(), 2, 10000 );
-
-
-        //printf("iter %d s_cw %d s_ccw %d\n", m_iteration, s_cw, s_ccw );
-        
-        auto old = path_cw.CLine();
+        walkParallel( path_cw, path_ccw, s_cw, s_ccw );
 
-        if( clipToLoopStart( path_cw.Line() ))
-        {
-            //printf("ClipCW\n");
-            //Dbg()->AddLine( old, 1, 40000 );
-            s_cw = ALMOST_DONE;
-        }
-
-        if( clipToLoopStart( path_ccw.Line() ))
-        {
-            //printf("ClipCCW\n");
-            s_ccw = ALMOST_DONE;
-        }
-
-        
         if( s_cw != IN_PROGRESS )
         {
             result.lineCw = path_cw;
@@ -253,11 +281,57 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
             result.lineCcw = path_ccw;
             result.statusCcw = s_ccw;
         }
+    }
+    else
+    {
+        while( m_iteration < m_iterationLimit )
+        {
+            if( s_cw != STUCK )
+                s_cw = singleStep( path_cw, true );
 
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
+            if( s_ccw != STUCK )
+                s_ccw = singleStep( path_ccw, false );
 
-        m_iteration++;
+            //Dbg()->AddLine( path_cw.CLine(), 2, 10000 );
+
+
+            //printf("iter %d s_cw %d s_ccw %d\n", m_iteration, s_cw, s_ccw );
+        
+            auto old = path_cw.CLine();
+
+            DEBUG_DECORATOR* dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
+
+            if( clipToLoopStart( path_cw.Line(), dbg ))
+            {
+                //printf("ClipCW\n");
+                //Dbg()->AddLine( old, 1, 40000 );
+                s_cw = ALMOST_DONE;
+            }
+
+            if( clipToLoopStart( path_ccw.Line(), dbg ))
+            {
+                //printf("ClipCCW\n");
+                s_ccw = ALMOST_DONE;
+            }
+
+        
+            if( s_cw != IN_PROGRESS )
+            {
+                result.lineCw = path_cw;
+                result.statusCw = s_cw;
+            }
+
+            if( s_ccw != IN_PROGRESS )
+            {
+                result.lineCcw = path_ccw;
+                result.statusCcw = s_ccw;
+            }
+
+            if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
+                break;
+
+            m_iteration++;
+        }
     }
 
     if( s_cw == IN_PROGRESS )
@@ -143,6 +143,14 @@ private:
     void start( const LINE& aInitialPath );
 
     WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+
+    ///> walks around the obstacles in one direction only, until done or out of iterations
+    WALKAROUND_STATUS walkSingleDirection( LINE& aPath, bool aWindingDirection );
+
+    ///> walks around the obstacles in both directions at once, on two threads
+    void walkParallel( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+                       WALKAROUND_STATUS& aStatusCcw );
+
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
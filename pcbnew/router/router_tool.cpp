@@ -157,7 +157,8 @@ static const TOOL_ACTION ACT_SwitchRounding( "pcbnew.InteractiveRouter.SwitchRou
 
 
 ROUTER_TOOL::ROUTER_TOOL() :
-    TOOL_BASE( "pcbnew.InteractiveRouter" )
+    TOOL_BASE( "pcbnew.InteractiveRouter" ),
+    m_refineScheduled( false )
 {
 }
 
@@ -859,8 +860,11 @@ void ROUTER_TOOL::performRouting()
             // pass the event.
             evt->SetPassEvent();
         }
+
+        scheduleRefine();
     }
 
+    cancelRefine();
     m_router->CommitRouting();
     m_router->StopRouting();
 
@@ -959,6 +963,11 @@ int ROUTER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
         {
             m_router->ClearWorld();
         }
+        else if( evt->Action() == TA_MODEL_CHANGE && evt->Category() == TC_MESSAGE )
+        {
+            // Posted by the board commits, which already updated the world
+            m_router->RefreshWorld();
+        }
         else if( evt->Action() == TA_UNDO_REDO_POST || evt->Action() == TA_MODEL_CHANGE )
         {
             m_router->SyncWorld();
@@ -1088,8 +1097,11 @@ void ROUTER_TOOL::performDragging( int aMode )
         }
 
         handleCommonEvents( *evt );
+        scheduleRefine();
     }
 
+    cancelRefine();
+
     if( m_router->RoutingInProgress() )
         m_router->StopRouting();
 
@@ -1193,7 +1205,7 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    m_router->RefreshWorld();
     m_startItem = nullptr;
 
     PNS::ITEM* startItem = nullptr;
@@ -1267,8 +1279,12 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
             m_router->FixRoute( m_endSnapPoint, m_endItem );
             break;
         }
+
+        scheduleRefine();
     }
 
+    cancelRefine();
+
     if( m_router->RoutingInProgress() )
         m_router->StopRouting();
 
@@ -1281,6 +1297,43 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
 }
 
 
+void ROUTER_TOOL::scheduleRefine()
+{
+    if( m_refineScheduled || !m_router->RefinePending() )
+        return;
+
+    // The idle events only come once the pending input events are processed, so a new
+    // move always takes precedence over the refinement of the previous one
+    canvas()->Bind( wxEVT_IDLE, &ROUTER_TOOL::onIdleRefine, this );
+    m_refineScheduled = true;
+}
+
+
+void ROUTER_TOOL::cancelRefine()
+{
+    if( !m_refineScheduled )
+        return;
+
+    canvas()->Unbind( wxEVT_IDLE, &ROUTER_TOOL::onIdleRefine, this );
+    m_refineScheduled = false;
+}
+
+
+void ROUTER_TOOL::onIdleRefine( wxIdleEvent& aEvent )
+{
+    // The last move may have replaced the items under the cursor, so pick them again
+    m_endItem = pickEndItem( controls()->GetMousePosition() );
+
+    if( m_router->Refine( m_endItem ) )
+        canvas()->Refresh();
+
+    if( m_router->RefinePending() )
+        aEvent.RequestMore();
+    else
+        cancelRefine();
+}
+
+
 int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
 {
     const auto& selection = m_toolMgr->GetTool<SELECTION_TOOL>()->GetSelection();
@@ -1296,7 +1349,7 @@ int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    m_router->RefreshWorld();
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
     m_startSnapPoint = snapToItem( true, m_startItem, controls()->GetCursorPosition() );
 
@@ -66,6 +66,13 @@ private:
 
     bool prepareInteractive();
     bool finishInteractive();
+
+    ///> Refines the last move between the input events, if it ran out of shove budget
+    void scheduleRefine();
+    void cancelRefine();
+    void onIdleRefine( wxIdleEvent& aEvent );
+
+    bool m_refineScheduled;
 };
 
 #endif
@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <wx/timer.h>
 
 #include "time_limit.h"
@@ -53,4 +55,67 @@ void TIME_LIMIT::Set( int aMilliseconds )
     m_limitMs = aMilliseconds;
 }
 
+
+
+ANYTIME_BUDGET::ANYTIME_BUDGET( int aTargetMs, int aMinMs ) :
+    m_targetMs( aTargetMs ),
+    m_minMs( aMinMs ),
+    m_maxMs( aTargetMs ),
+    m_moveMs( aTargetMs / 2 ),
+    m_refineMs( 0 ),
+    m_stepMs( aTargetMs / 2 ),
+    m_refining( false ),
+    m_refinePending( false ),
+    m_startTics( 0 ),
+    m_exhausted( false )
+{
+}
+
+
+void ANYTIME_BUDGET::Reset( int aMaxMs )
+{
+    // The budget of the moves is kept from one operation to the next, as it mostly depends
+    // on the speed of the machine
+    m_maxMs = std::max( aMaxMs, m_minMs );
+    m_moveMs = std::min( std::max( m_moveMs, m_minMs ), m_maxMs );
+    m_refinePending = false;
+}
+
+
+void ANYTIME_BUDGET::StartMove()
+{
+    m_stepMs = m_moveMs;
+    m_refining = false;
+    m_exhausted = false;
+    m_startTics = wxGetLocalTimeMillis().GetValue();
+}
+
+
+void ANYTIME_BUDGET::StartRefine()
+{
+    m_stepMs = m_refineMs;
+    m_refining = true;
+    m_exhausted = false;
+    m_startTics = wxGetLocalTimeMillis().GetValue();
+}
+
+
+void ANYTIME_BUDGET::EndStep()
+{
+    if( !m_refining )
+    {
+        int latency = (int) ( wxGetLocalTimeMillis().GetValue() - m_startTics );
+
+        // Most of the latency above the target is spent shoving, so the overshoot is taken
+        // from the budget.  The budget only grows when it was actually used up.
+        if( latency > m_targetMs )
+            m_moveMs = std::max( m_minMs, m_moveMs - ( latency - m_targetMs ) );
+        else if( m_exhausted )
+            m_moveMs = std::min( m_maxMs, m_moveMs + ( m_targetMs - latency + 1 ) / 2 );
+    }
+
+    m_refinePending = m_exhausted && m_stepMs < m_maxMs;
+    m_refineMs = std::min( m_maxMs, m_stepMs * 2 );
+}
+
 }
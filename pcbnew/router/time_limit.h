@@ -22,6 +22,7 @@
 #ifndef __TIME_LIMIT_H
 #define __TIME_LIMIT_H
 
+#include <atomic>
 #include <cstdint>
 
 namespace PNS {
@@ -43,6 +44,59 @@ private:
     int64_t m_startTics;
 };
 
+
+/**
+ * ANYTIME_BUDGET
+ *
+ * Time budget of the shove steps of an interactive routing operation.  The budget of a move
+ * is adapted to the latency measured for the previous moves: it shrinks when a move takes
+ * longer than the target frame time, and grows when a move ran out of budget but left some
+ * headroom.  When a step runs out of budget, its result is refined later by another step
+ * with twice the budget, until the step completes or the maximum budget is reached.
+ */
+class ANYTIME_BUDGET
+{
+public:
+    ANYTIME_BUDGET( int aTargetMs = 30, int aMinMs = 5 );
+
+    ///> Starts an operation, with aMaxMs as the budget limit of its steps
+    void Reset( int aMaxMs );
+
+    ///> Starts a step following the input of the user
+    void StartMove();
+
+    ///> Starts a step refining the result of the last step which ran out of budget
+    void StartRefine();
+
+    ///> Ends the current step, and adapts the budget of the next moves to its latency
+    void EndStep();
+
+    ///> Drops the pending refinement, when the last result is not the current one anymore
+    void Cancel() { m_refinePending = false; }
+
+    ///> @return the time limit of the current step
+    TIME_LIMIT Limit() const { return TIME_LIMIT( m_stepMs ); }
+
+    ///> Called when the current step stopped before completion, as it ran out of budget
+    void Exhausted() { m_exhausted = true; }
+
+    ///> @return true if the last result can be refined with a larger budget
+    bool RefinePending() const { return m_refinePending; }
+
+private:
+    int m_targetMs;         ///< target latency of a move
+    int m_minMs;
+    int m_maxMs;
+    int m_moveMs;           ///< budget of the next move
+    int m_refineMs;         ///< budget of the next refinement
+    int m_stepMs;           ///< budget of the current step
+    bool m_refining;
+    bool m_refinePending;
+    int64_t m_startTics;
+
+    std::atomic<bool> m_exhausted;  ///< set by the shove threads
+};
+
 }
 
 #endif
@@ -36,7 +36,9 @@
 #include <specctra_import_export/specctra_lexer.h>
 #include <pcbnew.h>
 
+#include <map>
 #include <memory>
+#include <unordered_map>
 
 // all outside the DSN namespace:
 class BOARD;
@@ -2098,6 +2100,7 @@ typedef boost::ptr_vector<IMAGE>    IMAGES;
 class PADSTACK : public ELEM_HOLDER
 {
     friend class SPECCTRA_DB;
+    friend class LIBRARY;
 
     std::string     hash;       ///< a hash string used by Compare(), not Format()ed/exported.
 
@@ -2238,6 +2241,45 @@ class LIBRARY : public ELEM
     PADSTACKS       padstacks;      ///< all except vias, which are in 'vias'
     PADSTACKS       vias;
 
+    // Indices of the containers above, for the lookups of large boards.  The containers
+    // are only appended to, so the indices catch up with them lazily.
+    std::unordered_map<std::string, int>    imageIndex;     ///< by hash, of the first image
+    std::unordered_map<std::string, int>    imageIdCount;   ///< images by image_id
+    unsigned                                imagesIndexed = 0;
+
+    std::map<std::pair<std::string, std::string>, int>  viaIndex;   ///< by hash and id
+    unsigned                                viasIndexed = 0;
+
+    std::unordered_map<std::string, PADSTACK*>  padstackIndex;  ///< by padstack_id
+    unsigned                                padstacksIndexed = 0;
+
+    void indexImages()
+    {
+        for( ;  imagesIndexed < images.size();  ++imagesIndexed )
+        {
+            IMAGE* image = &images[imagesIndexed];
+
+            if( !image->hash.size() )
+                image->hash = image->makeHash();
+
+            imageIndex.emplace( image->hash, (int) imagesIndexed );
+            imageIdCount[image->image_id]++;
+        }
+    }
+
+    void indexVias()
+    {
+        for( ;  viasIndexed < vias.size();  ++viasIndexed )
+        {
+            PADSTACK* via = &vias[viasIndexed];
+
+            if( !via->hash.size() )
+                via->hash = via->makeHash();
+
+            viaIndex.emplace( std::make_pair( via->hash, via->padstack_id ), (int) viasIndexed );
+        }
+    }
+
 public:
 
     LIBRARY( ELEM* aParent, DSN_T aType = T_library ) :
@@ -2276,21 +2318,22 @@ public:
      */
     int FindIMAGE( IMAGE* aImage )
     {
-        unsigned i;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == IMAGE::Compare( aImage, &images[i] ) )
-                return (int) i;
-        }
+        indexImages();
+
+        if( !aImage->hash.size() )
+            aImage->hash = aImage->makeHash();
+
+        auto found = imageIndex.find( aImage->hash );
+
+        if( found != imageIndex.end() )
+            return found->second;
 
         // There is no match to the IMAGE contents, but now generate a unique
         // name for it.
-        int dups = 1;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == aImage->image_id.compare( images[i].image_id ) )
-                aImage->duplicated = dups++;
-        }
+        auto dups = imageIdCount.find( aImage->image_id );
+
+        if( dups != imageIdCount.end() )
+            aImage->duplicated = dups->second;
 
         return -1;
     }
@@ -2332,11 +2375,16 @@ public:
      */
     int FindVia( PADSTACK* aVia )
     {
-        for( unsigned i=0;  i<vias.size();  ++i )
-        {
-            if( 0 == PADSTACK::Compare( aVia, &vias[i] ) )
-                return int( i );
-        }
+        indexVias();
+
+        if( !aVia->hash.size() )
+            aVia->hash = aVia->makeHash();
+
+        auto found = viaIndex.find( std::make_pair( aVia->hash, aVia->padstack_id ) );
+
+        if( found != viaIndex.end() )
+            return found->second;
+
         return -1;
     }
 
@@ -2387,12 +2435,17 @@ public:
      */
     PADSTACK* FindPADSTACK( const std::string& aPadstackId )
     {
-        for( unsigned i=0;  i<padstacks.size();  ++i )
+        for( ;  padstacksIndexed < padstacks.size();  ++padstacksIndexed )
         {
-            PADSTACK* ps = &padstacks[i];
-            if( 0 == ps->GetPadstackId().compare( aPadstackId ) )
-                return ps;
+            PADSTACK* ps = &padstacks[padstacksIndexed];
+            padstackIndex.emplace( ps->GetPadstackId(), ps );
         }
+
+        auto found = padstackIndex.find( aPadstackId );
+
+        if( found != padstackIndex.end() )
+            return found->second;
+
         return NULL;
     }
 
@@ -48,6 +48,8 @@
 #include <math/util.h>      // for KiROUND
 #include <pcbnew_settings.h>
 
+#include <unordered_map>
+
 using namespace DSN;
 
 
@@ -344,6 +346,14 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
         // each COMPONENT, reposition and re-orient each component and put on
         // correct side of the board.
         COMPONENTS& components = session->placement->components;
+
+        // Index the footprints by reference once; FindModuleByReference() would scan the
+        // board for each placement.  The first footprint wins, as with the scan.
+        std::unordered_map<wxString, MODULE*> modulesByRef;
+
+        for( MODULE* module : aBoard->Modules() )
+            modulesByRef.emplace( module->GetReference(), module );
+
         for( COMPONENTS::iterator comp=components.begin();  comp!=components.end();  ++comp )
         {
             PLACES& places = comp->places;
@@ -352,7 +362,8 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
                 PLACE* place = &places[i];  // '&' even though places[] holds a pointer!
 
                 wxString reference = FROM_UTF8( place->component_id.c_str() );
-                MODULE* module = aBoard->FindModuleByReference( reference );
+                auto    found = modulesByRef.find( reference );
+                MODULE* module = found != modulesByRef.end() ? found->second : nullptr;
 
                 if( !module )
                 {
@@ -181,3 +181,5 @@ HANDLE_EXCEPTIONS(BOARD::TracksInNetBetweenPoints)
         return netclassmap
     %}
 }
+
+%include board_arrays.i
@@ -0,0 +1,338 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_arrays.i
+ * @brief Bulk accessors of the items of a BOARD, as contiguous arrays
+ *
+ * Reading or modifying the items of a large board one call per item spends most of the time
+ * crossing the Python/C++ boundary.  These accessors exchange the data of all the tracks,
+ * pads or footprints at once: each array holds one native 32 bit int per item, in the order
+ * of the board containers, and supports the buffer protocol (numpy.asarray() wraps it
+ * without a copy).
+ */
+
+%{
+#include <board_commit.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <pcb_edit_frame.h>
+#include <pcbnew_scripting_helpers.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<const char*, std::vector<int32_t>>> BOARD_ARRAYS;
+
+
+/// Returns a new dict of bytes objects, one per array
+static PyObject* boardArraysToPython( const BOARD_ARRAYS& aArrays )
+{
+    PyObject* dict = PyDict_New();
+
+    for( const auto& array : aArrays )
+    {
+        PyObject* data = PyBytes_FromStringAndSize( (const char*) array.second.data(),
+                                                    array.second.size() * sizeof( int32_t ) );
+
+        if( !data || PyDict_SetItemString( dict, array.first, data ) != 0 )
+        {
+            Py_XDECREF( data );
+            Py_DECREF( dict );
+            return NULL;
+        }
+
+        Py_DECREF( data );
+    }
+
+    return dict;
+}
+
+
+/**
+ * Reads the array aKey of aDict, if any, which must hold aCount 32 bit ints
+ * @return false if the array is invalid, with the Python error set
+ */
+static bool boardArrayFromPython( PyObject* aDict, const char* aKey, size_t aCount,
+                                  std::vector<int32_t>& aValues )
+{
+    aValues.clear();
+
+    PyObject* obj = PyDict_GetItemString( aDict, aKey );    // borrowed
+
+    if( !obj )
+        return true;
+
+    Py_buffer view;
+
+    if( PyObject_GetBuffer( obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT ) != 0 )
+        return false;
+
+    // 32 bit ints, or raw bytes
+    bool validFormat = ( view.itemsize == 4 && view.format
+                         && ( strchr( view.format, 'i' ) || strchr( view.format, 'l' ) ) )
+                       || ( view.itemsize == 1 && view.format
+                            && ( strchr( view.format, 'B' ) || strchr( view.format, 'b' ) ) );
+
+    if( !validFormat || view.len != (Py_ssize_t) ( aCount * sizeof( int32_t ) ) )
+    {
+        PyErr_Format( PyExc_ValueError, "'%s' must hold %d 32 bit ints", aKey, (int) aCount );
+        PyBuffer_Release( &view );
+        return false;
+    }
+
+    aValues.resize( aCount );
+    memcpy( aValues.data(), view.buf, view.len );
+    PyBuffer_Release( &view );
+
+    return true;
+}
+%}
+
+
+%extend BOARD
+{
+    /**
+     * @return a dict of the arrays "type" (KICAD_T), "start_x", "start_y", "end_x", "end_y",
+     * "width", "layer" and "net" of the tracks and vias, in the order of Tracks()
+     */
+    PyObject* getTrackArrays()
+    {
+        size_t       count = self->Tracks().size();
+        BOARD_ARRAYS arrays = { { "type", {} }, { "start_x", {} }, { "start_y", {} },
+                                { "end_x", {} }, { "end_y", {} }, { "width", {} },
+                                { "layer", {} }, { "net", {} } };
+
+        for( auto& array : arrays )
+            array.second.reserve( count );
+
+        for( TRACK* track : self->Tracks() )
+        {
+            arrays[0].second.push_back( track->Type() );
+            arrays[1].second.push_back( track->GetStart().x );
+            arrays[2].second.push_back( track->GetStart().y );
+            arrays[3].second.push_back( track->GetEnd().x );
+            arrays[4].second.push_back( track->GetEnd().y );
+            arrays[5].second.push_back( track->GetWidth() );
+            arrays[6].second.push_back( track->GetLayer() );
+            arrays[7].second.push_back( track->GetNetCode() );
+        }
+
+        return boardArraysToPython( arrays );
+    }
+
+    /**
+     * @return a dict of the arrays "module" (the index of the footprint in Modules()), "x",
+     * "y", "size_x", "size_y", "orientation" (0.1 degrees) and "net" of the pads
+     */
+    PyObject* getPadArrays()
+    {
+        BOARD_ARRAYS arrays = { { "module", {} }, { "x", {} }, { "y", {} }, { "size_x", {} },
+                                { "size_y", {} }, { "orientation", {} }, { "net", {} } };
+        int          moduleIdx = 0;
+
+        for( MODULE* module : self->Modules() )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                arrays[0].second.push_back( moduleIdx );
+                arrays[1].second.push_back( pad->GetPosition().x );
+                arrays[2].second.push_back( pad->GetPosition().y );
+                arrays[3].second.push_back( pad->GetSize().x );
+                arrays[4].second.push_back( pad->GetSize().y );
+                arrays[5].second.push_back( KiROUND( pad->GetOrientation() ) );
+                arrays[6].second.push_back( pad->GetNetCode() );
+            }
+
+            moduleIdx++;
+        }
+
+        return boardArraysToPython( arrays );
+    }
+
+    /**
+     * @return a dict of the arrays "x", "y", "orientation" (0.1 degrees) and "layer" of the
+     * footprints, in the order of Modules()
+     */
+    PyObject* getModuleArrays()
+    {
+        BOARD_ARRAYS arrays = { { "x", {} }, { "y", {} }, { "orientation", {} },
+                                { "layer", {} } };
+
+        for( MODULE* module : self->Modules() )
+        {
+            arrays[0].second.push_back( module->GetPosition().x );
+            arrays[1].second.push_back( module->GetPosition().y );
+            arrays[2].second.push_back( KiROUND( module->GetOrientation() ) );
+            arrays[3].second.push_back( module->GetLayer() );
+        }
+
+        return boardArraysToPython( arrays );
+    }
+
+    /**
+     * Modifies the tracks from arrays in the layout of getTrackArrays(); the arrays missing
+     * from aArrays are left unchanged.  The layer of the vias is not modified.  In the board
+     * editor, outside of an action plugin, the changes are a single undoable commit.
+     * @return the number of modified tracks
+     */
+    PyObject* setTrackArrays( PyObject* aArrays )
+    {
+        if( !PyDict_Check( aArrays ) )
+        {
+            PyErr_SetString( PyExc_TypeError, "a dict of arrays is expected" );
+            return NULL;
+        }
+
+        std::vector<TRACK*> tracks( self->Tracks().begin(), self->Tracks().end() );
+        std::vector<int32_t> startX, startY, endX, endY, width, layer, net;
+
+        if( !boardArrayFromPython( aArrays, "start_x", tracks.size(), startX )
+                || !boardArrayFromPython( aArrays, "start_y", tracks.size(), startY )
+                || !boardArrayFromPython( aArrays, "end_x", tracks.size(), endX )
+                || !boardArrayFromPython( aArrays, "end_y", tracks.size(), endY )
+                || !boardArrayFromPython( aArrays, "width", tracks.size(), width )
+                || !boardArrayFromPython( aArrays, "layer", tracks.size(), layer )
+                || !boardArrayFromPython( aArrays, "net", tracks.size(), net ) )
+        {
+            return NULL;
+        }
+
+        for( int32_t layerId : layer )
+        {
+            if( layerId < 0 || layerId >= PCB_LAYER_ID_COUNT )
+            {
+                PyErr_Format( PyExc_ValueError, "invalid layer %d", (int) layerId );
+                return NULL;
+            }
+        }
+
+        // The action plugins make their own undo entry from the changes of the board
+        PCB_EDIT_FRAME*               frame = ScriptingGetPcbEditFrame();
+        std::unique_ptr<BOARD_COMMIT> commit;
+
+        if( frame && frame->GetBoard() == self && !IsActionRunning() )
+            commit = std::make_unique<BOARD_COMMIT>( frame );
+
+        long modified = 0;
+
+        for( size_t i = 0; i < tracks.size(); ++i )
+        {
+            TRACK*  track = tracks[i];
+            wxPoint start = track->GetStart();
+            wxPoint end = track->GetEnd();
+            int     newWidth = width.empty() ? track->GetWidth() : width[i];
+            int     newNet = net.empty() ? track->GetNetCode() : net[i];
+            bool    layerChanged = !layer.empty() && track->Type() != PCB_VIA_T
+                                   && layer[i] != track->GetLayer();
+
+            if( !startX.empty() )
+                start.x = startX[i];
+
+            if( !startY.empty() )
+                start.y = startY[i];
+
+            if( !endX.empty() )
+                end.x = endX[i];
+
+            if( !endY.empty() )
+                end.y = endY[i];
+
+            if( start == track->GetStart() && end == track->GetEnd()
+                    && newWidth == track->GetWidth() && newNet == track->GetNetCode()
+                    && !layerChanged )
+            {
+                continue;
+            }
+
+            if( commit )
+                commit->Modify( track );
+
+            track->SetStart( start );
+            track->SetEnd( end );
+            track->SetWidth( newWidth );
+            track->SetNetCode( newNet );
+
+            if( layerChanged )
+                track->SetLayer( ToLAYER_ID( layer[i] ) );
+
+            modified++;
+        }
+
+        if( commit )
+            commit->Push( _( "Edit Tracks From Script" ) );
+        else if( modified )
+            self->BuildConnectivity();
+
+        return PyLong_FromLong( modified );
+    }
+
+    %pythoncode
+    %{
+
+    @staticmethod
+    def _intArrays(arrays):
+        # Views of 32 bit ints of the bytes objects, without a copy where possible
+        try:
+            return {k: memoryview(v).cast('i') for k, v in arrays.items()}
+        except AttributeError:
+            import array
+            return {k: array.array('i', v) for k, v in arrays.items()}
+
+    def GetTrackArrays(self):
+        """
+        Return the data of all the tracks and vias, in the order of GetTracks(), as a dict of
+        arrays of ints: "type", "start_x", "start_y", "end_x", "end_y", "width", "layer" and
+        "net".  numpy.asarray() converts each one without a copy.
+        """
+        return self._intArrays(self.getTrackArrays())
+
+    def GetPadArrays(self):
+        """
+        Return the data of all the pads as a dict of arrays of ints: "module" (the index of
+        the footprint in GetModules()), "x", "y", "size_x", "size_y", "orientation" (0.1
+        degrees) and "net".
+        """
+        return self._intArrays(self.getPadArrays())
+
+    def GetModuleArrays(self):
+        """
+        Return the data of all the footprints, in the order of GetModules(), as a dict of
+        arrays of ints: "x", "y", "orientation" (0.1 degrees) and "layer".
+        """
+        return self._intArrays(self.getModuleArrays())
+
+    def SetTrackArrays(self, arrays):
+        """
+        Modify all the tracks at once from a dict of arrays laid out as GetTrackArrays()
+        (any object holding 32 bit ints, e.g. numpy int32 arrays).  The missing arrays are
+        left unchanged.  In the board editor, the changes are a single undoable edit.
+        Return the number of modified tracks.
+        """
+        return self.setTrackArrays(arrays)
+    %}
+}
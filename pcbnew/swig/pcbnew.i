@@ -50,6 +50,12 @@
 %}
 %include lib_id.h
 
+%{
+#include <lib_index.h>
+%}
+%ignore LIB_INDEX::FindLibrary;
+%include lib_index.h
+
 
 // ignore a couple of items that generate warnings from swig built code
 %ignore BOARD_ITEM::ZeroOffset;
@@ -71,6 +77,7 @@ class BASE_SET {};
 #include <plotcontroller.h>
 #include <pcb_plot_params.h>
 #include <exporters/export_d356.h>
+#include <exporters/fabrication_outputs.h>
 #include <exporters/gendrill_file_writer_base.h>
 #include <exporters/gendrill_Excellon_writer.h>
 #include <exporters/gendrill_gerber_writer.h>
@@ -112,6 +119,7 @@ HANDLE_EXCEPTIONS(PLUGIN::FootprintDelete)
 %include <pcb_plot_params.h>
 %include <plotter.h>
 %include <exporters/export_d356.h>
+%include <exporters/fabrication_outputs.h>
 %include <exporters/gendrill_file_writer_base.h>
 %include <exporters/gendrill_Excellon_writer.h>
 %include <exporters/gendrill_gerber_writer.h>
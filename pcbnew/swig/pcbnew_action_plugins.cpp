@@ -39,6 +39,7 @@
 #include <pcbnew_id.h>
 #include <pcbnew_settings.h>
 #include <python_scripting.h>
+#include <router/pns_tool_base.h>
 #include <tool/action_menu.h>
 #include <tool/action_toolbar.h>
 
@@ -355,6 +356,9 @@ void PCB_EDIT_FRAME::RunActionPlugin( ACTION_PLUGIN* aActionPlugin )
     {
         OnModify();
         GetScreen()->PushCommandToUndoList( oldBuffer );
+
+        // The script changed the board without a commit
+        PNS::TOOL_BASE::InvalidateWorlds( m_toolManager );
     }
     else
     {
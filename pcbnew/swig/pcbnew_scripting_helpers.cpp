@@ -30,16 +30,25 @@
 #include <Python.h>
 #undef HAVE_CLOCK_GETTIME  // macro is defined in Python.h and causes redefine warning
 
+#include <3d_canvas/offscreen_3d_render.h>
 #include <action_plugin.h>
 #include <build_version.h>
 #include <class_board.h>
 #include <cstdlib>
+#include <drc/drc.h>
+#include <drc/drc_report_writer.h>
+#include <fstream>
 #include <io_mgr.h>
 #include <kicad_string.h>
 #include <macros.h>
+#include <memory_usage.h>
 #include <pcb_draw_panel_gal.h>
 #include <pcbnew.h>
 #include <pcbnew_scripting_helpers.h>
+#include <pgm_base.h>
+#include <settings/settings_manager.h>
+#include <wx/filename.h>
+#include <wx/image.h>
 
 static PCB_EDIT_FRAME* s_PcbEditFrame = NULL;
 
@@ -58,6 +67,12 @@ void ScriptingSetPcbEditFrame( PCB_EDIT_FRAME* aPcbEditFrame )
 }
 
 
+PCB_EDIT_FRAME* ScriptingGetPcbEditFrame()
+{
+    return s_PcbEditFrame;
+}
+
+
 BOARD* LoadBoard( wxString& aFileName )
 {
     if( aFileName.EndsWith( wxT( ".kicad_pcb" ) ) )
@@ -119,6 +134,79 @@ bool ExportSpecctraDSN( wxString& aFullFilename )
 }
 
 
+bool WriteDRCReport( BOARD* aBoard, wxString& aFileName, bool aJson )
+{
+    if( !aBoard )
+        return false;
+
+    std::ofstream stream( TO_UTF8( aFileName ) );
+
+    if( !stream.is_open() )
+        return false;
+
+    std::unique_ptr<DRC_REPORT_WRITER> writer;
+
+    if( aJson )
+        writer = std::make_unique<DRC_JSON_REPORT_WRITER>( stream, EDA_UNITS::MILLIMETRES );
+    else
+        writer = std::make_unique<DRC_TEXT_REPORT_WRITER>( stream, EDA_UNITS::MILLIMETRES );
+
+    DRC drc;
+    drc.RunTestsHeadless( aBoard, *writer, EDA_UNITS::MILLIMETRES );
+
+    return stream.good();
+}
+
+
+/**
+ * The cache of the 3D models of Render3DImage() for the boards without a project, kept
+ * between the calls
+ */
+static S3D_CACHE* scripting3DCache( BOARD* aBoard )
+{
+    if( aBoard->GetProject() )
+        return aBoard->GetProject()->Get3DCacheManager();
+
+    static std::unique_ptr<S3D_CACHE> s_cache;
+
+    if( !s_cache )
+    {
+        wxFileName cfgpath;
+        cfgpath.AssignDir( SETTINGS_MANAGER::GetUserSettingsPath() );
+        cfgpath.AppendDir( wxT( "3d" ) );
+
+        s_cache = std::make_unique<S3D_CACHE>();
+        s_cache->SetProgramBase( PgmOrNull() );
+        s_cache->Set3DConfigDir( cfgpath.GetFullPath() );
+    }
+
+    // The ${KIPRJMOD} models are relative to the directory of the board; the cache is
+    // flushed when it changes
+    s_cache->SetProjectDir( wxFileName( aBoard->GetFileName() ).GetPath() );
+
+    return s_cache.get();
+}
+
+
+bool Render3DImage( BOARD* aBoard, wxString& aFileName, int aWidth, int aHeight, int aView,
+                    double aZoom )
+{
+    if( !aBoard || aView < 0 || aView > (int) OFFSCREEN_3D_VIEW::RIGHT )
+        return false;
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    OFFSCREEN_3D_RENDER render( aBoard, scripting3DCache( aBoard ) );
+    wxImage             image;
+
+    if( !render.Render( wxSize( aWidth, aHeight ), (OFFSCREEN_3D_VIEW) aView, aZoom, image ) )
+        return false;
+
+    return image.SaveFile( aFileName, wxBITMAP_TYPE_PNG );
+}
+
+
 bool ImportSpecctraSES( wxString& aFullFilename )
 {
     if( s_PcbEditFrame )
@@ -133,6 +221,12 @@ bool ImportSpecctraSES( wxString& aFullFilename )
 }
 
 
+wxString GetMemoryUsageReport()
+{
+    return wxString::FromUTF8( MEMORY_USAGE::Get().Format().c_str() );
+}
+
+
 bool ArchiveModulesOnBoard( bool aStoreInNewLib, const wxString& aLibName, wxString* aLibPath )
 {
     if( s_PcbEditFrame )
@@ -35,6 +35,9 @@
 #ifndef SWIG
 void    ScriptingSetPcbEditFrame( PCB_EDIT_FRAME* aPCBEdaFrame );
 
+/// @return the board editor, or nullptr if the scripts run without it
+PCB_EDIT_FRAME* ScriptingGetPcbEditFrame();
+
 #endif
 
 // For Python scripts: return the current board.
@@ -66,6 +69,32 @@ bool ExportSpecctraDSN( wxString& aFullFilename );
  */
 bool ImportSpecctraSES( wxString& aFullFilename );
 
+/**
+ * Runs the DRC on aBoard without the board editor, and writes the violations to a report
+ * file as they are found.  No marker is added to the board.
+ * @param aJson = true for a JSON report, false for the text report of the DRC dialog
+ * @return true if OK
+ */
+bool WriteDRCReport( BOARD* aBoard, wxString& aFileName, bool aJson = false );
+
+/**
+ * Renders the 3D view of aBoard with the raytracer into a PNG file, without the 3D viewer
+ * nor a gl context.  The 3D models are loaded from the cache of the board project, or from
+ * a cache kept between the calls for the boards without a project.
+ * @param aView = 0 top, 1 bottom, 2 front, 3 back, 4 left, 5 right
+ * @param aZoom = the zoom of the camera, 1.0 fits the board in the image
+ * @return true if OK
+ */
+bool Render3DImage( BOARD* aBoard, wxString& aFileName, int aWidth, int aHeight, int aView = 0,
+                    double aZoom = 1.0 );
+
+/**
+ * @return the memory used by the boards, the zone fills, the connectivity, the undo commands,
+ * the 3D models and the footprint caches of the process, a line per category (estimates, see
+ * MEMORY_USAGE)
+ */
+wxString GetMemoryUsageReport();
+
 /**
  * Function ArchiveModulesOnBoard
  * Save modules in a library:
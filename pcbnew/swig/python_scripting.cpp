@@ -151,7 +151,7 @@ PyThreadState* g_PythonMainTState;
  *
  * This initializes all the wxPython interface and returns the python thread control structure
  */
-bool pcbnewInitPythonScripting( const char * aUserScriptingPath )
+bool pcbnewInitPythonScripting()
 {
     int  retv;
     char cmd[1024];
@@ -206,14 +206,13 @@ bool pcbnewInitPythonScripting( const char * aUserScriptingPath )
 
 #endif  // ifdef KICAD_SCRIPTING_WXPYTHON
 
-    // Load pcbnew inside Python and load all the user plugins, TODO: add system wide plugins
+    // The pcbnew module and the user plugins are loaded on first use, by
+    // PythonPluginsLoadBase(), so that Pcbnew does not wait for them at startup
     {
         PyLOCK lock;
 
         snprintf( cmd, sizeof( cmd ), "import sys, traceback\n"
-                  "sys.path.append(\".\")\n"
-                  "import pcbnew\n"
-                  "pcbnew.LoadPlugins(\"%s\")", aUserScriptingPath );
+                  "sys.path.append(\".\")" );
         retv = PyRun_SimpleString( cmd );
 
         if( retv != 0 )
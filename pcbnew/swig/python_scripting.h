@@ -52,9 +52,10 @@
 
 
 /**
- * Initialize the Python engine inside pcbnew.
+ * Initialize the Python engine inside pcbnew.  The pcbnew module and the plugins are not
+ * loaded here, see PythonPluginsLoadBase().
  */
-bool        pcbnewInitPythonScripting( const char * aUserScriptingPath );
+bool        pcbnewInitPythonScripting();
 void        pcbnewFinishPythonScripting();
 
 /**
@@ -3,9 +3,11 @@
 %include class_zone.h
 %include zones.h
 %include zone_filler.h
+%include zone_fill_cache.h
 %{
 #include <class_zone.h>
 #include <zones.h>
 #include <zone_filler.h>
+#include <zone_fill_cache.h>
 %}
 
@@ -385,7 +385,7 @@ int EDIT_TOOL::Move( const TOOL_EVENT& aEvent )
                         if( item->GetParent() && item->GetParent()->IsSelected() )
                             continue;
 
-                        m_commit->Modify( item );
+                        m_commit->ModifyPlacement( static_cast<BOARD_ITEM*>( item ) );
                     }
                 }
 
@@ -634,7 +634,7 @@ int EDIT_TOOL::Rotate( const TOOL_EVENT& aEvent )
     for( auto item : selection )
     {
         if( !item->IsNew() && !EditingModules() )
-            m_commit->Modify( item );
+            m_commit->ModifyPlacement( static_cast<BOARD_ITEM*>( item ) );
 
         static_cast<BOARD_ITEM*>( item )->Rotate( refPt, rotateAngle );
     }
@@ -1006,7 +1006,7 @@ int EDIT_TOOL::MoveExact( const TOOL_EVENT& aEvent )
             BOARD_ITEM* item = static_cast<BOARD_ITEM*>( selItem );
 
             if( !item->IsNew() && !EditingModules() )
-                m_commit->Modify( item );
+                m_commit->ModifyPlacement( item );
 
             item->Move( translation );
 
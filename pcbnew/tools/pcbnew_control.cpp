@@ -571,16 +571,21 @@ int PCBNEW_CONTROL::DeleteItemCursor( const TOOL_EVENT& aEvent )
     picker->SetMotionHandler(
         [this] ( const VECTOR2D& aPos )
         {
-            BOARD* board = m_frame->GetBoard();
             SELECTION_TOOL* selectionTool = m_toolMgr->GetTool<SELECTION_TOOL>();
             GENERAL_COLLECTORS_GUIDE guide = m_frame->GetCollectorsGuide();
             GENERAL_COLLECTOR collector;
             collector.m_Threshold = KiROUND( getView()->ToWorld( HITTEST_THRESHOLD_PIXELS ) );
 
             if( m_editModules )
-                collector.Collect( board, GENERAL_COLLECTOR::ModuleItems, (wxPoint) aPos, guide );
+            {
+                collector.Collect( getView(), GENERAL_COLLECTOR::ModuleItems, (wxPoint) aPos,
+                                   guide );
+            }
             else
-                collector.Collect( board, GENERAL_COLLECTOR::BoardLevelItems, (wxPoint) aPos, guide );
+            {
+                collector.Collect( getView(), GENERAL_COLLECTOR::BoardLevelItems, (wxPoint) aPos,
+                                   guide );
+            }
 
             // Remove unselectable items
             for( int i = collector.GetCount() - 1; i >= 0; --i )
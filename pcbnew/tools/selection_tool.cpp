@@ -409,7 +409,7 @@ bool SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag,
 
     guide.SetIgnoreZoneFills( displayOpts.m_DisplayZonesMode != 0 );
 
-    collector.Collect( board(),
+    collector.Collect( view(),
         m_editModules ? GENERAL_COLLECTOR::ModuleItems : GENERAL_COLLECTOR::AllBoardItems,
         wxPoint( aWhere.x, aWhere.y ), guide );
 
@@ -572,6 +572,8 @@ bool SELECTION_TOOL::selectMultiple()
 
             selectionRect.Normalize();
 
+            std::vector<BOARD_ITEM*> itemsToSelect;
+
             for( it = selectedItems.begin(), it_end = selectedItems.end(); it != it_end; ++it )
             {
                 BOARD_ITEM* item = static_cast<BOARD_ITEM*>( it->first );
@@ -588,12 +590,14 @@ bool SELECTION_TOOL::selectMultiple()
                     }
                     else
                     {
-                        select( item );
+                        itemsToSelect.push_back( item );
                         anyAdded = true;
                     }
                 }
             }
 
+            selectItems( itemsToSelect );
+
             m_selection.SetIsHover( false );
 
             // Inform other potentially interested tools
@@ -941,9 +945,12 @@ void SELECTION_TOOL::selectAllItemsOnNet( int aNetCode )
 {
     constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_VIA_T, EOT };
     auto connectivity = board()->GetConnectivity();
+    std::vector<BOARD_ITEM*> items;
 
     for( BOARD_CONNECTED_ITEM* item : connectivity->GetNetItems( aNetCode, types ) )
-        select( item );
+        items.push_back( item );
+
+    selectItems( items );
 }
 
 
@@ -1322,6 +1329,8 @@ void SELECTION_TOOL::RebuildSelection()
 {
     m_selection.Clear();
 
+    std::vector<BOARD_ITEM*> selected;
+
     INSPECTOR_FUNC inspector = [&] ( EDA_ITEM* item, void* testData )
     {
         if( item->IsSelected() )
@@ -1332,7 +1341,7 @@ void SELECTION_TOOL::RebuildSelection()
             if( parent && parent->Type() == PCB_MODULE_T && parent->IsSelected() )
                 return SEARCH_RESULT::CONTINUE;
 
-            highlight( (BOARD_ITEM*) item, SELECTED, &m_selection );
+            selected.push_back( (BOARD_ITEM*) item );
         }
 
         return SEARCH_RESULT::CONTINUE;
@@ -1340,6 +1349,8 @@ void SELECTION_TOOL::RebuildSelection()
 
     board()->Visit( inspector, nullptr,  m_editModules ? GENERAL_COLLECTOR::ModuleItems
                                                        : GENERAL_COLLECTOR::AllBoardItems );
+
+    highlightSelected( selected );
 }
 
 
@@ -1729,6 +1740,37 @@ void SELECTION_TOOL::select( BOARD_ITEM* aItem )
 }
 
 
+void SELECTION_TOOL::selectItems( const std::vector<BOARD_ITEM*>& aItems )
+{
+    std::vector<BOARD_ITEM*> items;
+
+    // The footprints first, as select() skips the pads of the selected footprints.  The flags
+    // are set as the items are taken, to skip the duplicates of the view queries.
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( item->Type() == PCB_MODULE_T && !item->IsSelected() )
+        {
+            item->SetSelected();
+            items.push_back( item );
+        }
+    }
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( item->IsSelected() )
+            continue;
+
+        if( item->Type() == PCB_PAD_T && item->GetParent()->IsSelected() )
+            continue;
+
+        item->SetSelected();
+        items.push_back( item );
+    }
+
+    highlightSelected( items );
+}
+
+
 void SELECTION_TOOL::unselect( BOARD_ITEM* aItem )
 {
     unhighlight( aItem, SELECTED, &m_selection );
@@ -1783,6 +1825,30 @@ void SELECTION_TOOL::highlight( BOARD_ITEM* aItem, int aMode, PCBNEW_SELECTION*
 }
 
 
+void SELECTION_TOOL::highlightSelected( const std::vector<BOARD_ITEM*>& aItems )
+{
+    for( BOARD_ITEM* item : aItems )
+    {
+        // The same as highlight( item, SELECTED, &m_selection ), but for the insertion
+        item->SetSelected();
+        view()->Hide( item, true );
+
+        if( item->Type() == PCB_MODULE_T )
+        {
+            static_cast<MODULE*>( item )->RunOnChildren( [&] ( BOARD_ITEM* child )
+            {
+                child->SetSelected();
+                view()->Hide( child, true );
+            });
+        }
+
+        view()->Update( item );
+    }
+
+    m_selection.AddItems( std::vector<EDA_ITEM*>( aItems.begin(), aItems.end() ) );
+}
+
+
 void SELECTION_TOOL::unhighlight( BOARD_ITEM* aItem, int aMode, PCBNEW_SELECTION* aGroup )
 {
     if( aMode == SELECTED )
@@ -270,6 +270,12 @@ private:
      */
     void select( BOARD_ITEM* aItem );
 
+    /**
+     * Selects many items at once, as select() does each of them but inserting them in the
+     * selection in a single pass (the box selection of a whole board holds ~100k items).
+     */
+    void selectItems( const std::vector<BOARD_ITEM*>& aItems );
+
     /**
      * Function unselect()
      * Takes necessary action mark an item as unselected.
@@ -287,6 +293,12 @@ private:
      */
     void highlight( BOARD_ITEM* aItem, int aHighlightMode, PCBNEW_SELECTION* aGroup = nullptr );
 
+    /**
+     * Highlights the items as selected and adds them to the selection, as
+     * highlight( item, SELECTED, &m_selection ) does for each of them.
+     */
+    void highlightSelected( const std::vector<BOARD_ITEM*>& aItems );
+
     /**
      * Function unhighlight()
      * Unhighlights the item visually.
@@ -67,6 +67,7 @@ void ZONE_FILLER_TOOL::CheckAllZones( wxWindow* aCaller )
 
     ZONE_FILLER filler( frame()->GetBoard(), &commit );
     filler.InstallNewProgressReporter( aCaller, _( "Checking Zones" ), 4 );
+    filler.SetFillCache( getEditFrame<PCB_EDIT_FRAME>()->GetZoneFillCache() );
 
     if( filler.Fill( toFill, true ) )
     {
@@ -83,6 +84,13 @@ void ZONE_FILLER_TOOL::singleShotRefocus( wxIdleEvent& )
 }
 
 
+void ZONE_FILLER_TOOL::showZoneFill( ZONE_CONTAINER* aZone )
+{
+    view()->Update( aZone, KIGFX::REPAINT );
+    canvas()->Refresh();
+}
+
+
 void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
 {
     std::vector<ZONE_CONTAINER*> toFill;
@@ -94,6 +102,8 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
 
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( aCaller, _( "Fill All Zones" ),  4 );
+    filler.SetFillCache( getEditFrame<PCB_EDIT_FRAME>()->GetZoneFillCache() );
+    filler.SetZoneFilledHandler( [this]( ZONE_CONTAINER* aZone ) { showZoneFill( aZone ); } );
 
     if( filler.Fill( toFill ) )
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
@@ -128,6 +138,8 @@ int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( frame(), _( "Fill Zone" ), 4 );
+    filler.SetFillCache( getEditFrame<PCB_EDIT_FRAME>()->GetZoneFillCache() );
+    filler.SetZoneFilledHandler( [this]( ZONE_CONTAINER* aZone ) { showZoneFill( aZone ); } );
     filler.Fill( toFill );
 
     canvas()->Refresh();
@@ -29,6 +29,7 @@
 
 
 class PCB_EDIT_FRAME;
+class ZONE_CONTAINER;
 
 /**
  * ZONE_FILLER_TOOL
@@ -56,6 +57,9 @@ private:
     ///> Refocuses on an idle event (used after the Progress Reporter messes up the focus)
     void singleShotRefocus( wxIdleEvent& );
 
+    ///> Redraws a zone as soon as its fill is built, while the other zones are being filled
+    void showZoneFill( ZONE_CONTAINER* aZone );
+
     ///> Sets up handlers for various events.
     void setTransitions() override;
 };
@@ -38,6 +38,10 @@
 #include <tools/pcb_actions.h>
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 
 /* Install the cleanup dialog frame to know what should be cleaned
@@ -169,9 +173,16 @@ bool TRACKS_CLEANER::cleanupVias()
             vias.push_back( via );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // The vias at each position, in the order of the board, to find the superimposed vias
+    // without testing every pair of vias
+    std::unordered_map<wxPoint, std::vector<size_t>> viasAt;
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
+        viasAt[vias[ii]->GetPosition()].push_back( ii );
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
     {
-        auto via1 = *via1_it;
+        auto via1 = vias[ii];
 
         if( via1->IsLocked() )
             continue;
@@ -201,11 +212,11 @@ bool TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        for( size_t jj : viasAt[via1->GetPosition()] )
         {
-            auto via2 = *via2_it;
+            auto via2 = vias[jj];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( jj <= ii || via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -392,17 +403,62 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     std::set<BOARD_ITEM*> toRemove;
 
-    // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    // Remove duplicate segments (2 superimposed identical segments).
+    // The candidates are the tracks starting near an end of the reference track, found from
+    // an R-tree of the track starts instead of testing every pair of tracks.
+    typedef RTree<size_t, int, 2, double> START_TREE;
+
+    const TRACKS&                       tracks = m_brd->Tracks();
+    START_TREE                          startTree;
+    std::vector<START_TREE::BulkEntry>  entries;
+    std::vector<size_t>                 candidates;
+
+    entries.reserve( tracks.size() );
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
     {
-        auto track1 = *it;
+        const wxPoint& start = tracks[ii]->GetStart();
+
+        entries.push_back( { { { start.x, start.y }, { start.x, start.y } }, ii } );
+    }
+
+    startTree.BulkLoad( entries );
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        auto track1 = tracks[ii];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        // The distance used by IsPointOnEnds()
+        int radius = track1->GetWidth() / 2;
+
+        candidates.clear();
+
+        for( const wxPoint& end : { track1->GetStart(), track1->GetEnd() } )
+        {
+            const int mmin[2] = { end.x - radius, end.y - radius };
+            const int mmax[2] = { end.x + radius, end.y + radius };
+
+            startTree.Search( mmin, mmax,
+                    [&]( const size_t& aIndex )
+                    {
+                        if( aIndex > ii )
+                            candidates.push_back( aIndex );
+
+                        return true;
+                    } );
+        }
+
+        // Tested in the order of the board, as each track is marked deleted by the first
+        // reference track it duplicates
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+        for( size_t jj : candidates )
         {
-            auto track2 = *it2;
+            auto track2 = tracks[jj];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
@@ -38,6 +38,7 @@ using namespace std::placeholders;
 #include <class_pcb_text.h>
 #include <class_pcb_target.h>
 #include <class_module.h>
+#include <module_placement_undo_item.h>
 #include <class_dimension.h>
 #include <class_zone.h>
 #include <class_edge_mod.h>
@@ -49,6 +50,7 @@ using namespace std::placeholders;
 #include <tools/selection_tool.h>
 #include <tools/pcbnew_control.h>
 #include <tools/pcb_editor_control.h>
+#include <router/pns_tool_base.h>
 #include <view/view.h>
 #include <ws_proxy_undo_item.h>
 
@@ -298,6 +300,7 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         case UR_ROTATED:
         case UR_ROTATED_CLOCKWISE:
         case UR_FLIPPED:
+        case UR_PLACEMENT:      // the link is the saved placement
         case UR_NEW:
         case UR_DELETED:
         case UR_PAGESETTINGS:
@@ -528,6 +531,17 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         }
             break;
 
+        case UR_PLACEMENT:  /* Exchange old and new placement of the footprint */
+        {
+            MODULE* module = (MODULE*) eda_item;
+            auto    placement = (MODULE_PLACEMENT_UNDO_ITEM*) aList->GetPickedItemLink( ii );
+
+            placement->Swap( module );
+            view->Update( module );
+            connectivity->Update( module );
+        }
+            break;
+
         case UR_DRILLORIGIN:
         case UR_GRIDORIGIN:
         {
@@ -574,7 +588,11 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     SELECTION_TOOL* selTool = m_toolManager->GetTool<SELECTION_TOOL>();
     selTool->RebuildSelection();
 
+    // The router tools build their world again the next time they are used
+    PNS::TOOL_BASE::InvalidateWorlds( m_toolManager );
+
     GetBoard()->SanitizeNetcodes();
+    GetBoard()->InvalidateIndexes();
 }
 
 
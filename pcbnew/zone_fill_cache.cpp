@@ -0,0 +1,300 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <zone_fill_cache.h>
+
+#include <fstream>
+#include <set>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <macros.h>
+#include <wx/filename.h>
+
+#include <nlohmann/json.hpp>
+
+
+///> Version of the file format, a file of another version is ignored
+static const int ZONE_FILL_CACHE_VERSION = 2;
+
+
+wxString ZONE_FILL_CACHE::GetCacheFileName( const wxString& aBoardFileName )
+{
+    wxFileName fn( aBoardFileName );
+
+    fn.SetExt( wxT( "zone-fill-cache" ) );
+
+    return fn.GetFullPath();
+}
+
+
+/*
+ * A SHAPE_POLY_SET is written as a list of polygons, a polygon as a list of closed chains
+ * (the outline, then the holes), and a chain as the flat list of its point coordinates.
+ */
+static nlohmann::json polysToJson( const SHAPE_POLY_SET& aPolys )
+{
+    nlohmann::json polys = nlohmann::json::array();
+
+    for( int ii = 0; ii < aPolys.OutlineCount(); ++ii )
+    {
+        nlohmann::json polygon = nlohmann::json::array();
+
+        for( const SHAPE_LINE_CHAIN& chain : aPolys.CPolygon( ii ) )
+        {
+            nlohmann::json coords = nlohmann::json::array();
+
+            for( int jj = 0; jj < chain.PointCount(); ++jj )
+            {
+                coords.push_back( chain.CPoint( jj ).x );
+                coords.push_back( chain.CPoint( jj ).y );
+            }
+
+            polygon.push_back( std::move( coords ) );
+        }
+
+        polys.push_back( std::move( polygon ) );
+    }
+
+    return polys;
+}
+
+
+static void polysFromJson( const nlohmann::json& aJson, SHAPE_POLY_SET& aPolys )
+{
+    aPolys.RemoveAllContours();
+
+    for( const nlohmann::json& polygon : aJson )
+    {
+        bool outline = true;
+
+        for( const nlohmann::json& coords : polygon )
+        {
+            SHAPE_LINE_CHAIN chain;
+
+            for( size_t jj = 0; jj + 1 < coords.size(); jj += 2 )
+                chain.Append( coords[jj].get<int>(), coords[jj + 1].get<int>() );
+
+            chain.SetClosed( true );
+
+            if( outline )
+                aPolys.AddOutline( chain );
+            else
+                aPolys.AddHole( chain );
+
+            outline = false;
+        }
+    }
+}
+
+
+bool ZONE_FILL_CACHE::Load( const wxString& aFileName )
+{
+    m_entries.clear();
+
+    std::ifstream in( aFileName.ToStdString() );
+
+    if( !in.is_open() )
+        return false;
+
+    try
+    {
+        nlohmann::json doc;
+
+        in >> doc;
+
+        if( doc.at( "version" ).get<int>() != ZONE_FILL_CACHE_VERSION )
+            return false;
+
+        for( const nlohmann::json& zone : doc.at( "zones" ) )
+        {
+            std::string uuid = zone.at( "uuid" ).get<std::string>();
+            ENTRY&      entry = m_entries[ KIID( wxString::FromUTF8( uuid.c_str() ) ) ];
+
+            entry.m_fingerprint = zone.at( "fingerprint" ).get<size_t>();
+            polysFromJson( zone.at( "filled" ), entry.m_filledPolys );
+
+            for( const nlohmann::json& tri : zone.at( "triangulation" ) )
+            {
+                auto triPoly = std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>();
+                const nlohmann::json& vertices = tri.at( "vertices" );
+                const nlohmann::json& triangles = tri.at( "triangles" );
+
+                for( size_t jj = 0; jj + 1 < vertices.size(); jj += 2 )
+                    triPoly->AddVertex( VECTOR2I( vertices[jj].get<int>(),
+                                                  vertices[jj + 1].get<int>() ) );
+
+                for( size_t jj = 0; jj + 2 < triangles.size(); jj += 3 )
+                    triPoly->AddTriangle( triangles[jj].get<int>(), triangles[jj + 1].get<int>(),
+                                          triangles[jj + 2].get<int>() );
+
+                entry.m_triangulation.push_back( std::move( triPoly ) );
+            }
+        }
+    }
+    catch( const nlohmann::json::exception& )
+    {
+        // A damaged cache is not an error, the zones will just be refilled
+        m_entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool ZONE_FILL_CACHE::Save( const wxString& aFileName ) const
+{
+    std::ofstream out( aFileName.ToStdString() );
+
+    if( !out.is_open() )
+        return false;
+
+    nlohmann::json zones = nlohmann::json::array();
+
+    for( const std::pair<const KIID, ENTRY>& pair : m_entries )
+    {
+        const ENTRY&   entry = pair.second;
+        nlohmann::json triangulation = nlohmann::json::array();
+
+        for( const std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>& triPoly :
+                entry.m_triangulation )
+        {
+            nlohmann::json vertices = nlohmann::json::array();
+            nlohmann::json triangles = nlohmann::json::array();
+
+            for( size_t jj = 0; jj < triPoly->GetVertexCount(); ++jj )
+            {
+                vertices.push_back( triPoly->GetVertex( jj ).x );
+                vertices.push_back( triPoly->GetVertex( jj ).y );
+            }
+
+            for( size_t jj = 0; jj < triPoly->GetTriangleCount(); ++jj )
+            {
+                const SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI& tri =
+                        triPoly->GetTriangleIndices( jj );
+
+                triangles.push_back( tri.a );
+                triangles.push_back( tri.b );
+                triangles.push_back( tri.c );
+            }
+
+            triangulation.push_back( { { "vertices", std::move( vertices ) },
+                                       { "triangles", std::move( triangles ) } } );
+        }
+
+        zones.push_back( { { "uuid", TO_UTF8( pair.first.AsString() ) },
+                           { "fingerprint", entry.m_fingerprint },
+                           { "filled", polysToJson( entry.m_filledPolys ) },
+                           { "triangulation", std::move( triangulation ) } } );
+    }
+
+    nlohmann::json doc = { { "version", ZONE_FILL_CACHE_VERSION },
+                           { "zones", std::move( zones ) } };
+
+    out << doc;
+
+    return out.good();
+}
+
+
+void ZONE_FILL_CACHE::Update( BOARD* aBoard )
+{
+    std::set<KIID> zones;
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    {
+        zones.insert( zone->m_Uuid );
+        Store( zone );
+    }
+
+    for( auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if( zones.count( it->first ) )
+            ++it;
+        else
+            it = m_entries.erase( it );
+    }
+}
+
+
+void ZONE_FILL_CACHE::Store( ZONE_CONTAINER* aZone )
+{
+    // The fill of a zone loaded from the board file is not known to match its inputs
+    if( !aZone->IsFilled() || aZone->GetFillFingerprint() == 0 )
+        return;
+
+    ENTRY&                entry = m_entries[ aZone->m_Uuid ];
+    const SHAPE_POLY_SET& filled = aZone->GetFilledPolysList();
+
+    entry.m_fingerprint = aZone->GetFillFingerprint();
+    entry.m_filledPolys = filled;
+    entry.m_triangulation.clear();
+
+    if( filled.IsTriangulationUpToDate() )
+    {
+        for( unsigned ii = 0; ii < filled.TriangulatedPolyCount(); ++ii )
+        {
+            entry.m_triangulation.push_back(
+                    std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>(
+                            *filled.TriangulatedPolygon( ii ) ) );
+        }
+    }
+}
+
+
+bool ZONE_FILL_CACHE::Restore( ZONE_CONTAINER* aZone, size_t aFingerprint ) const
+{
+    auto it = m_entries.find( aZone->m_Uuid );
+
+    if( it == m_entries.end() || it->second.m_fingerprint != aFingerprint )
+        return false;
+
+    const ENTRY&   entry = it->second;
+    SHAPE_POLY_SET filledPolys = entry.m_filledPolys;
+
+    if( entry.m_triangulation.empty() )
+    {
+        aZone->SetFilledPolysList( filledPolys );
+        aZone->CacheTriangulation();
+    }
+    else
+    {
+        TRIANGULATION triangulation;
+
+        for( const std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>& triPoly :
+                entry.m_triangulation )
+        {
+            triangulation.push_back(
+                    std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>( *triPoly ) );
+        }
+
+        aZone->SetFilledPolysList( filledPolys, triangulation );
+    }
+
+    aZone->CalculateFilledArea();
+    aZone->SetFillFingerprint( aFingerprint );
+    aZone->SetIsFilled( true );
+
+    return true;
+}
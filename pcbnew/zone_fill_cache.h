@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef ZONE_FILL_CACHE_H
+#define ZONE_FILL_CACHE_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <common.h>
+#include <geometry/shape_poly_set.h>
+
+class BOARD;
+class ZONE_CONTAINER;
+
+
+/**
+ * ZONE_FILL_CACHE
+ * keeps the fills (filled polygons and their triangulation) of zones, keyed by the zone and
+ * by the fingerprint of its fill inputs computed by ZONE_FILLER.  A zone whose fingerprint
+ * matches the cached one gets its fill back from the cache instead of being refilled.
+ *
+ * The cache can be saved to, and loaded from, a file next to the board file, so that the
+ * fills survive from one session (or one script run) to the next.
+ */
+class ZONE_FILL_CACHE
+{
+public:
+    ZONE_FILL_CACHE()
+    {
+    }
+
+    /**
+     * @return the name of the cache file of the board aBoardFileName.
+     */
+    static wxString GetCacheFileName( const wxString& aBoardFileName );
+
+    /**
+     * Replaces the content of the cache by the one of the file aFileName.
+     * @return false if the file cannot be read or is not a zone fill cache of this version.
+     */
+    bool Load( const wxString& aFileName );
+
+    /**
+     * Writes the cache to the file aFileName.
+     * @return false if the file cannot be written.
+     */
+    bool Save( const wxString& aFileName ) const;
+
+    /**
+     * Stores the current fill of aZone, keyed by its fill fingerprint.  Nothing is done for
+     * unfilled zones, or zones without fingerprint (their cached fill may still be valid).
+     */
+    void Store( ZONE_CONTAINER* aZone );
+
+    /**
+     * Stores the current fills of the zones of aBoard, and removes the entries of the zones
+     * which are no longer on the board.
+     */
+    void Update( BOARD* aBoard );
+
+    /**
+     * Gives back its cached fill to aZone, if the cached fill was built for the fill
+     * fingerprint aFingerprint.
+     * @return true if the zone was filled from the cache.
+     */
+    bool Restore( ZONE_CONTAINER* aZone, size_t aFingerprint ) const;
+
+    void Clear()
+    {
+        m_entries.clear();
+    }
+
+    int GetCount() const
+    {
+        return (int) m_entries.size();
+    }
+
+private:
+    typedef std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> TRIANGULATION;
+
+    struct ENTRY
+    {
+        size_t         m_fingerprint;
+        SHAPE_POLY_SET m_filledPolys;
+        TRIANGULATION  m_triangulation;    // of m_filledPolys, may be empty
+    };
+
+    std::map<KIID, ENTRY> m_entries;
+};
+
+
+#endif  // ZONE_FILL_CACHE_H
@@ -25,7 +25,12 @@
 
 #include <thread>
 #include <algorithm>
+#include <array>
 #include <future>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <tuple>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -45,6 +50,11 @@
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <hash_eda.h>
+#include <advanced_config.h>
+#include <thread_pool.h>
+#include <trace_events.h>
+#include <zone_fill_cache.h>
 
 #include "zone_filler.h"
 
@@ -73,12 +83,20 @@ private:
 static const double s_RoundPadThermalSpokeAngle = 450;
 static const bool s_DumpZonesWhenFilling = false;
 
+// Zones with more knockouts than this have their knockouts subtracted tile by tile
+static const int s_TiledFillMinHoles = 2000;
+
+// Hatch fill holes are built and clamped to the fill by tiles of this many holes square
+static const int s_HatchTileCells = 32;
+
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
     m_board( aBoard ),
     m_brdOutlinesValid( false ),
     m_commit( aCommit ),
     m_progressReporter( nullptr ),
+    m_fillCache( nullptr ),
+    m_cancelled( false ),
     m_high_def( 9 ),
     m_low_def( 6 )
 {
@@ -100,6 +118,8 @@ void ZONE_FILLER::InstallNewProgressReporter( wxWindow* aParent, const wxString&
 
 bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck )
 {
+    SCOPED_TRACE_EVENT trace( "ZONE_FILLER::Fill" );
+
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
     auto connectivity = m_board->GetConnectivity();
     bool filledPolyWithOutline = not m_board->GetDesignSettings().m_ZoneUseNoOutlineInFill;
@@ -109,6 +129,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     if( !lock )
         return false;
 
+    m_cancelled = false;
+
     if( m_progressReporter )
     {
         m_progressReporter->Report( aCheck ? _( "Checking zone fills..." ) : _( "Building zone fills..." ) );
@@ -119,12 +141,66 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
 
-    for( auto zone : aZones )
+    // The board does not change while filling: index its items once for all the zones
+    buildItemIndex();
+
+    // Zones whose fill inputs did not change since their last fill can keep their fill.
+    // A zone is still refilled if it shares a net and a layer with an overlapping refilled
+    // zone, because their fills are connected when looking for insulated islands.
+    std::vector<ZONE_CONTAINER*> zones;
+    std::vector<size_t>          fingerprints;
+    std::vector<EDA_RECT>        bboxes;
+    std::vector<bool>            refill;
+
+    for( ZONE_CONTAINER* zone : aZones )
     {
         // Keepout zones are not filled
         if( zone->GetIsKeepout() )
             continue;
 
+        size_t fingerprint = computeFillFingerprint( zone );
+
+        zones.push_back( zone );
+        fingerprints.push_back( fingerprint );
+        bboxes.push_back( zone->GetBoundingBox() );
+        refill.push_back( aCheck || !zone->IsFilled()
+                          || zone->GetFillFingerprint() != fingerprint );
+    }
+
+    for( bool changed = true; changed; )
+    {
+        changed = false;
+
+        for( size_t ii = 0; ii < zones.size(); ++ii )
+        {
+            if( !refill[ii] || zones[ii]->GetNetCode() <= 0 )
+                continue;
+
+            for( size_t jj = 0; jj < zones.size(); ++jj )
+            {
+                if( refill[jj] || zones[jj]->GetNetCode() != zones[ii]->GetNetCode()
+                        || !zones[jj]->CommonLayerExists( zones[ii]->GetLayerSet() )
+                        || !bboxes[jj].Intersects( bboxes[ii] ) )
+                {
+                    continue;
+                }
+
+                refill[jj] = true;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<ZONE_CONTAINER*> restored;
+    std::atomic<bool>            outOfDate( false );
+
+    for( size_t ii = 0; ii < zones.size(); ++ii )
+    {
+        if( !refill[ii] )
+            continue;
+
+        ZONE_CONTAINER* zone = zones[ii];
+
         if( m_commit )
             m_commit->Modify( zone );
 
@@ -132,62 +208,150 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         // to know if the current filled areas are up to date
         zone->BuildHashValue();
 
+        // A fill built for the same inputs is as good as a new one
+        if( m_fillCache && m_fillCache->Restore( zone, fingerprints[ii] ) )
+        {
+            if( aCheck && zone->GetHashValue() != zone->GetFilledPolysList().GetHash() )
+                outOfDate = true;
+
+            restored.push_back( zone );
+            continue;
+        }
+
         // Add the zone to the list of zones to test or refill
         toFill.emplace_back( CN_ZONE_ISOLATED_ISLAND_LIST(zone) );
 
         // Remove existing fill first to prevent drawing invalid polygons
         // on some platforms
         zone->UnFill();
+        zone->SetFillFingerprint( fingerprints[ii] );
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
+    // The zones whose fill was built, waiting to be handed to m_zoneFilledHandler by the
+    // main thread
+    std::mutex                   filledMutex;
+    std::vector<ZONE_CONTAINER*> filledZones;
 
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
-    {
-        size_t num = 0;
+    auto publishFilledZones =
+            [&]()
+            {
+                std::vector<ZONE_CONTAINER*> zonesToPublish;
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            zone->SetFilledPolysUseThickness( filledPolyWithOutline );
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+                {
+                    std::lock_guard<std::mutex> guard( filledMutex );
+                    zonesToPublish.swap( filledZones );
+                }
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
+                for( ZONE_CONTAINER* zone : zonesToPublish )
+                    m_zoneFilledHandler( zone );
+            };
 
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+    // Runs aTask( 0 ) ... aTask( aCount - 1 ) on all the cores.  The tasks are handed out one
+    // at a time, so when they are sorted from the biggest to the smallest, a few big tasks
+    // do not leave the other cores idle at the end of the phase.
+    auto runTasks =
+            [&]( size_t aCount, const std::function<void( size_t )>& aTask )
+            {
+                std::atomic<size_t> nextTask( 0 );
+                size_t parallelThreadCount =
+                        std::min<size_t>( GetKiCadThreadPool().GetThreadCount(), aCount );
+
+                auto worker =
+                        [&]()
+                        {
+                            for( size_t i = nextTask++; i < aCount; i = nextTask++ )
+                                aTask( i );
+                        };
+
+                if( parallelThreadCount <= 1 )
+                {
+                    worker();
+                    publishFilledZones();
+                    return;
+                }
 
-            num++;
-        }
+                TASK_GROUP tasks;
 
-        return num;
-    };
+                tasks.RunParallel( worker, parallelThreadCount );
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+                // Refresh the UI while the zones are filled
+                tasks.Wait( m_progressReporter,
+                        [&]()
+                        {
+                            if( tasks.IsCancelled() )
+                                m_cancelled = true;
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
+                            publishFilledZones();
+                        } );
+
+                publishFilledZones();
+            };
+
+    // Start with the biggest zones: their fill is the longest one
+    auto fillCost =
+            []( const CN_ZONE_ISOLATED_ISLAND_LIST& aZone )
             {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+                EDA_RECT bbox = aZone.m_zone->GetBoundingBox();
+                return (double) bbox.GetWidth() * bbox.GetHeight();
+            };
+
+    std::stable_sort( toFill.begin(), toFill.end(),
+                      [&]( const CN_ZONE_ISOLATED_ISLAND_LIST& aA,
+                           const CN_ZONE_ISOLATED_ISLAND_LIST& aB )
+                      {
+                          return fillCost( aA ) > fillCost( aB );
+                      } );
+
+    if( m_progressReporter )
+        m_progressReporter->SetMaxProgress( toFill.size() );
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
+    runTasks( toFill.size(),
+              [&]( size_t i )
+              {
+                  if( m_cancelled )
+                      return;
+
+                  ZONE_CONTAINER* zone = toFill[i].m_zone;
+                  zone->SetFilledPolysUseThickness( filledPolyWithOutline );
+                  SHAPE_POLY_SET rawPolys, finalPolys;
+
+                  // A zone whose fill was cancelled half-way is left unfilled
+                  if( !fillSingleZone( zone, rawPolys, finalPolys ) && m_cancelled )
+                      return;
+
+                  zone->SetFilledPolysList( finalPolys );
+                  zone->SetIsFilled( true );
+
+                  // Build the connection test structures of the new fill here, on all the
+                  // cores, instead of in the serial search for insulated islands
+                  CONNECTIVITY_DATA::PrepareIslandSearch( toFill[i] );
+
+                  if( m_zoneFilledHandler )
+                  {
+                      std::lock_guard<std::mutex> guard( filledMutex );
+                      filledZones.push_back( zone );
+                  }
+
+                  if( m_progressReporter )
+                      m_progressReporter->AdvanceProgress();
+              } );
+
+    // Keep the zones completed before the fill was cancelled, and make sure the other ones
+    // are refilled next time
+    if( m_cancelled )
+    {
+        for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : toFill )
+        {
+            if( !zone.m_zone->IsFilled() )
+                zone.m_zone->SetFillFingerprint( 0 );
         }
+
+        toFill.erase( std::remove_if( toFill.begin(), toFill.end(),
+                                      []( const CN_ZONE_ISOLATED_ISLAND_LIST& aZone )
+                                      {
+                                          return !aZone.m_zone->IsFilled();
+                                      } ),
+                      toFill.end() );
     }
 
     // Now update the connectivity to check for copper islands
@@ -201,52 +365,54 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     connectivity->SetProgressReporter( m_progressReporter );
     connectivity->FindIsolatedCopperIslands( toFill );
 
-    // Now remove insulated copper islands and islands outside the board edge
-    bool outOfDate = false;
-
-    for( auto& zone : toFill )
-    {
-        std::sort( zone.m_islands.begin(), zone.m_islands.end(), std::greater<int>() );
-        SHAPE_POLY_SET poly = zone.m_zone->GetFilledPolysList();
-
-        // Remove solid areas outside the board cutouts and the insulated islands
-        // only zones with net code > 0 can have insulated islands by definition
-        if( zone.m_zone->GetNetCode() > 0 )
-        {
-            // solid areas outside the board cutouts are also removed, because they are usually
-            // insulated islands
-            for( auto idx : zone.m_islands )
-            {
-                poly.DeletePolygon( idx );
-            }
-        }
-        // Zones with no net can have areas outside the board cutouts.
-        // By definition, Zones with no net have no isolated island
-        // (in fact all filled areas are isolated islands)
-        // but they can have some areas outside the board cutouts.
-        // A filled area outside the board cutouts has all points outside cutouts,
-        // so we only need to check one point for each filled polygon.
-        // Note also non copper zones are already clipped
-        else if( m_brdOutlinesValid && zone.m_zone->IsOnCopperLayer() )
-        {
-            for( int idx = 0; idx < poly.OutlineCount(); )
-            {
-                if( poly.Polygon( idx ).empty() ||
-                    !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
-                {
-                    poly.DeletePolygon( idx );
-                }
-                else
-                     idx++;
-            }
-        }
-
-        zone.m_zone->SetFilledPolysList( poly );
-        zone.m_zone->CalculateFilledArea();
-
-        if( aCheck && zone.m_zone->GetHashValue() != poly.GetHash() )
-            outOfDate = true;
-    }
+    // Now remove insulated copper islands and islands outside the board edge.  The zones are
+    // independent, so they are processed on all the cores.
+    runTasks( toFill.size(),
+              [&]( size_t i )
+              {
+                  CN_ZONE_ISOLATED_ISLAND_LIST& zone = toFill[i];
+
+                  std::sort( zone.m_islands.begin(), zone.m_islands.end(), std::greater<int>() );
+                  SHAPE_POLY_SET poly = zone.m_zone->GetFilledPolysList();
+
+                  // Remove solid areas outside the board cutouts and the insulated islands
+                  // only zones with net code > 0 can have insulated islands by definition
+                  if( zone.m_zone->GetNetCode() > 0 )
+                  {
+                      // solid areas outside the board cutouts are also removed, because they
+                      // are usually insulated islands
+                      for( auto idx : zone.m_islands )
+                      {
+                          poly.DeletePolygon( idx );
+                      }
+                  }
+                  // Zones with no net can have areas outside the board cutouts.
+                  // By definition, Zones with no net have no isolated island
+                  // (in fact all filled areas are isolated islands)
+                  // but they can have some areas outside the board cutouts.
+                  // A filled area outside the board cutouts has all points outside cutouts,
+                  // so we only need to check one point for each filled polygon.
+                  // Note also non copper zones are already clipped
+                  else if( m_brdOutlinesValid && zone.m_zone->IsOnCopperLayer() )
+                  {
+                      for( int idx = 0; idx < poly.OutlineCount(); )
+                      {
+                          if( poly.Polygon( idx ).empty() ||
+                              !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
+                          {
+                              poly.DeletePolygon( idx );
+                          }
+                          else
+                               idx++;
+                      }
+                  }
+
+                  zone.m_zone->SetFilledPolysList( poly );
+                  zone.m_zone->CalculateFilledArea();
+
+                  if( aCheck && zone.m_zone->GetHashValue() != poly.GetHash() )
+                      outOfDate = true;
+              } );
 
     if( aCheck && outOfDate )
     {
@@ -267,50 +433,80 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         }
     }
 
+    // The triangulation is split in one task per filled polygon (the final polygons have no
+    // holes, so each one is triangulated on its own), so that a huge zone is spread across
+    // all the cores.  It cannot start before the insulated islands are removed, and these
+    // are only known once all the zones are filled.
+    struct TRI_TASK
+    {
+        size_t m_zone;      // index in toFill
+        int    m_outline;   // index of the polygon in the zone fill
+        int    m_points;    // cost estimate
+    };
+
+    typedef std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> TRIANGULATION;
+
+    std::vector<TRI_TASK>      triTasks;
+    std::vector<TRIANGULATION> triangulations( toFill.size() );
+    std::unique_ptr<std::atomic<bool>[]> triFailed( new std::atomic<bool>[ toFill.size() ] );
+
+    for( size_t ii = 0; ii < toFill.size(); ++ii )
+    {
+        const SHAPE_POLY_SET& fill = toFill[ii].m_zone->GetFilledPolysList();
+
+        triFailed[ii] = fill.HasHoles();
+
+        if( triFailed[ii] )
+            continue;
+
+        triangulations[ii].resize( fill.OutlineCount() );
+
+        for( int jj = 0; jj < fill.OutlineCount(); ++jj )
+            triTasks.push_back( { ii, jj, fill.COutline( jj ).PointCount() } );
+    }
+
+    std::stable_sort( triTasks.begin(), triTasks.end(),
+                      []( const TRI_TASK& aA, const TRI_TASK& aB )
+                      {
+                          return aA.m_points > aB.m_points;
+                      } );
+
     if( m_progressReporter )
     {
         m_progressReporter->AdvancePhase();
         m_progressReporter->Report( _( "Performing polygon fills..." ) );
-        m_progressReporter->SetMaxProgress( toFill.size() );
+        m_progressReporter->SetMaxProgress( triTasks.size() );
     }
 
+    runTasks( triTasks.size(),
+              [&]( size_t i )
+              {
+                  const TRI_TASK&       task = triTasks[i];
+                  const SHAPE_POLY_SET& fill = toFill[task.m_zone].m_zone->GetFilledPolysList();
+                  auto triPoly = std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>();
+
+                  if( fill.TriangulateOutline( task.m_outline, *triPoly ) )
+                      triangulations[task.m_zone][task.m_outline] = std::move( triPoly );
+                  else
+                      triFailed[task.m_zone] = true;
 
-    nextItem = 0;
+                  if( m_progressReporter )
+                      m_progressReporter->AdvanceProgress();
+              } );
 
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    for( size_t ii = 0; ii < toFill.size(); ++ii )
     {
-        size_t num = 0;
+        ZONE_CONTAINER* zone = toFill[ii].m_zone;
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
+        if( triFailed[ii] )
         {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+            // Let the polygon set fracture and simplify the polygons, and try again
+            zone->CacheTriangulation();
         }
-
-        return num;
-    };
-
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        else
         {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
+            SHAPE_POLY_SET fill = zone->GetFilledPolysList();
+            zone->SetFilledPolysList( fill, triangulations[ii] );
         }
     }
 
@@ -323,6 +519,12 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
 
     connectivity->SetProgressReporter( nullptr );
 
+    if( m_fillCache )
+    {
+        for( auto& i : toFill )
+            m_fillCache->Store( i.m_zone );
+    }
+
     if( m_commit )
     {
         m_commit->Push( _( "Fill Zone(s)" ), false );
@@ -332,10 +534,196 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         for( auto& i : toFill )
             connectivity->Update( i.m_zone );
 
+        for( ZONE_CONTAINER* zone : restored )
+            connectivity->Update( zone );
+
         connectivity->RecalculateRatsnest();
     }
 
-    return true;
+    return !m_cancelled;
+}
+
+
+static void hashCombine( size_t& aSeed, size_t aValue )
+{
+    aSeed ^= aValue + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+static void hashRect( size_t& aSeed, const EDA_RECT& aRect )
+{
+    hashCombine( aSeed, std::hash<int>{}( aRect.GetX() ) );
+    hashCombine( aSeed, std::hash<int>{}( aRect.GetY() ) );
+    hashCombine( aSeed, std::hash<int>{}( aRect.GetWidth() ) );
+    hashCombine( aSeed, std::hash<int>{}( aRect.GetHeight() ) );
+}
+
+
+size_t ZONE_FILLER::computeFillFingerprint( const ZONE_CONTAINER* aZone ) const
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    size_t                 ret = 0;
+
+    // The zone itself
+    hashCombine( ret, std::hash<std::string>{}( aZone->Outline()->GetHash().Format() ) );
+    hashCombine( ret, std::hash<unsigned long long>{}( aZone->GetLayerSet().to_ullong() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetNetCode() ) );
+    hashCombine( ret, std::hash<unsigned>{}( aZone->GetPriority() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetClearance() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetZoneClearance() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetMinThickness() ) );
+    hashCombine( ret, std::hash<int>{}( static_cast<int>( aZone->GetPadConnection() ) ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetThermalReliefGap() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetThermalReliefCopperBridge() ) );
+    hashCombine( ret, std::hash<int>{}( static_cast<int>( aZone->GetFillMode() ) ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetHatchFillTypeThickness() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetHatchFillTypeGap() ) );
+    hashCombine( ret, std::hash<double>{}( aZone->GetHatchFillTypeOrientation() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetHatchFillTypeSmoothingLevel() ) );
+    hashCombine( ret, std::hash<double>{}( aZone->GetHatchFillTypeSmoothingValue() ) );
+    hashCombine( ret, std::hash<int>{}( aZone->GetCornerSmoothingType() ) );
+    hashCombine( ret, std::hash<unsigned>{}( aZone->GetCornerRadius() ) );
+
+    // The board
+    hashCombine( ret, std::hash<bool>{}( m_brdOutlinesValid ) );
+    hashCombine( ret, std::hash<std::string>{}( m_boardOutline.GetHash().Format() ) );
+    hashCombine( ret, std::hash<bool>{}( bds.m_ZoneUseNoOutlineInFill ) );
+    hashCombine( ret, std::hash<int>{}( bds.m_MaxError ) );
+    hashCombine( ret, std::hash<int>{}( bds.m_CopperEdgeClearance ) );
+    hashCombine( ret, std::hash<int>{}( bds.GetBiggestClearanceValue() ) );
+
+    // The neighbourhood: the items which buildCopperItemClearances(), buildThermalSpokes()
+    // and the insulated islands removal can look at.  Items are hashed in board order, so
+    // an item entering or leaving the neighbourhood also changes the fingerprint.
+    int      edgeClearance = std::max( aZone->GetZoneClearance(), bds.m_CopperEdgeClearance );
+    int      margin = std::max( bds.GetBiggestClearanceValue(), aZone->GetClearance() );
+    EDA_RECT zone_boundingbox = aZone->GetBoundingBox();
+
+    margin = std::max( margin, edgeClearance ) + Millimeter2iu( 0.002 );
+    zone_boundingbox.Inflate( margin );
+
+    auto hashItem =
+            [&]( const BOARD_ITEM* aItem, const EDA_RECT& aItemBBox )
+            {
+                hashCombine( ret, hash_eda( aItem, HASH_FLAGS::ALL & ~HASH_FLAGS::REL_COORD ) );
+                hashRect( ret, aItemBBox );
+            };
+
+    auto hashGraphic =
+            [&]( BOARD_ITEM* aItem )
+            {
+                if( !aItem->IsOnLayer( aZone->GetLayer() ) && !aItem->IsOnLayer( Edge_Cuts ) )
+                    return;
+
+                EDA_RECT item_boundingbox = aItem->GetBoundingBox();
+
+                if( item_boundingbox.Intersects( zone_boundingbox ) )
+                {
+                    hashItem( aItem, item_boundingbox );
+
+                    if( aItem->Type() == PCB_MODULE_TEXT_T )
+                    {
+                        const TEXTE_MODULE* text = static_cast<const TEXTE_MODULE*>( aItem );
+                        hashCombine( ret, std::hash<bool>{}( text->IsVisible() ) );
+                    }
+                }
+            };
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            if( !pad->IsOnLayer( aZone->GetLayer() )
+                    && pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+            {
+                continue;
+            }
+
+            EDA_RECT item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( std::max( pad->GetClearance(),
+                                                aZone->GetThermalReliefGap( pad ) ) );
+
+            if( !item_boundingbox.Intersects( zone_boundingbox ) )
+                continue;
+
+            hashItem( pad, item_boundingbox );
+            hashCombine( ret, std::hash<int>{}( pad->GetDrillSize().x << 2 ) );
+            hashCombine( ret, std::hash<int>{}( pad->GetDrillSize().y << 3 ) );
+            hashCombine( ret, std::hash<int>{}( pad->GetAttribute() ) );
+            hashCombine( ret, std::hash<int>{}( pad->GetClearance() ) );
+            hashCombine( ret, std::hash<double>{}( pad->GetRoundRectRadiusRatio() ) );
+            hashCombine( ret, std::hash<double>{}( pad->GetChamferRectRatio() ) );
+            hashCombine( ret, std::hash<int>{}( pad->GetChamferPositions() ) );
+            hashCombine( ret, std::hash<int>{}(
+                    static_cast<int>( aZone->GetPadConnection( pad ) ) ) );
+            hashCombine( ret, std::hash<int>{}( aZone->GetThermalReliefGap( pad ) ) );
+            hashCombine( ret, std::hash<int>{}( aZone->GetThermalReliefCopperBridge( pad ) ) );
+        }
+
+        hashGraphic( &module->Reference() );
+        hashGraphic( &module->Value() );
+
+        for( BOARD_ITEM* item : module->GraphicalItems() )
+            hashGraphic( item );
+    }
+
+    for( TRACK* track : m_board->Tracks() )
+    {
+        if( !track->IsOnLayer( aZone->GetLayer() ) )
+            continue;
+
+        EDA_RECT item_boundingbox = track->GetBoundingBox();
+
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
+        {
+            hashItem( track, item_boundingbox );
+            hashCombine( ret, std::hash<int>{}( track->GetClearance() ) );
+        }
+    }
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aZone->GetLayer() ) && !item->IsOnLayer( Edge_Cuts ) )
+            continue;
+
+        EDA_RECT item_boundingbox = item->GetBoundingBox();
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        if( item->Type() == PCB_LINE_T || item->Type() == PCB_TEXT_T )
+        {
+            hashItem( item, item_boundingbox );
+        }
+        else
+        {
+            // Dimensions and targets: hash_eda() does not know them, use their extent
+            hashCombine( ret, std::hash<int>{}( item->Type() ) );
+            hashCombine( ret, std::hash<unsigned long long>{}( item->GetLayerSet().to_ullong() ) );
+            hashRect( ret, item_boundingbox );
+        }
+    }
+
+    for( ZONE_CONTAINER* zone : m_board->GetZoneList( true ) )
+    {
+        if( zone == aZone || !aZone->CommonLayerExists( zone->GetLayerSet() ) )
+            continue;
+
+        EDA_RECT item_boundingbox = zone->GetBoundingBox();
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        hashCombine( ret, std::hash<std::string>{}( zone->Outline()->GetHash().Format() ) );
+        hashCombine( ret, std::hash<int>{}( zone->GetNetCode() ) );
+        hashCombine( ret, std::hash<unsigned>{}( zone->GetPriority() ) );
+        hashCombine( ret, std::hash<int>{}( zone->GetClearance() ) );
+        hashCombine( ret, std::hash<bool>{}( zone->GetIsKeepout() ) );
+        hashCombine( ret, std::hash<bool>{}( zone->GetDoNotAllowCopperPour() ) );
+    }
+
+    // 0 means "unknown" for ZONE_CONTAINER::GetFillFingerprint()
+    return ret ? ret : 1;
 }
 
 
@@ -514,6 +902,48 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
  * Removes clearance from the shape for copper items which share the zone's layer but are
  * not connected to it.
  */
+void ZONE_FILLER::buildItemIndex()
+{
+    int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+
+    m_padIndex.RemoveAll();
+    m_trackIndex.RemoveAll();
+    m_graphicIndex.RemoveAll();
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            // Off the zone's layer, the pad is knocked out by a dummy pad of the size of its
+            // hole, with the clearance of its net: cover both
+            EDA_RECT bbox = pad->GetBoundingBox();
+            int      holeRadius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
+            EDA_RECT holeBBox( pad->GetPosition() - wxPoint( holeRadius, holeRadius ),
+                               wxSize( 2 * holeRadius, 2 * holeRadius ) );
+
+            bbox.Merge( holeBBox );
+            bbox.Inflate( std::max( pad->GetClearance(), biggest_clearance ) );
+            m_padIndex.Insert( pad, bbox );
+        }
+    }
+
+    for( TRACK* track : m_board->Tracks() )
+        m_trackIndex.Insert( track, track->GetBoundingBox() );
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        m_graphicIndex.Insert( &module->Reference(), module->Reference().GetBoundingBox() );
+        m_graphicIndex.Insert( &module->Value(), module->Value().GetBoundingBox() );
+
+        for( BOARD_ITEM* item : module->GraphicalItems() )
+            m_graphicIndex.Insert( item, item->GetBoundingBox() );
+    }
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+        m_graphicIndex.Insert( item, item->GetBoundingBox() );
+}
+
+
 void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles )
 {
     // a small extra clearance to be sure actual track clearance is not smaller
@@ -540,50 +970,57 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
     MODULE  dummymodule( m_board );
     D_PAD   dummypad( &dummymodule );
 
+    // Only the items indexed near the zone can knock out its fill.  They come in board
+    // order, so the knockouts are the same as when scanning the whole board.
+    std::vector<D_PAD*>      pads;
+    std::vector<TRACK*>      tracks;
+    std::vector<BOARD_ITEM*> graphics;
+
+    m_padIndex.Query( zone_boundingbox, pads );
+    m_trackIndex.Query( zone_boundingbox, tracks );
+    m_graphicIndex.Query( zone_boundingbox, graphics );
+
     // Add non-connected pad clearances
     //
-    for( auto module : m_board->Modules() )
+    for( D_PAD* pad : pads )
     {
-        for( auto pad : module->Pads() )
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
         {
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-                setupDummyPadForHole( pad, dummypad );
-                pad = &dummypad;
-            }
+            setupDummyPadForHole( pad, dummypad );
+            pad = &dummypad;
+        }
 
-            if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
-                    || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
+        if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
+                || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
+        {
+            // for pads having a netcode different from the zone, use the net clearance:
+            int gap = std::max( zone_clearance, pad->GetClearance() );
+
+            // for pads having the same netcode as the zone, the net clearance has no
+            // meaning (clearance between object of the same net is 0) and the
+            // zone_clearance can be set to 0 (In this case the netclass clearance is used)
+            // therefore use the antipad clearance (thermal clearance) or the
+            // zone_clearance if bigger.
+            if( pad->GetNetCode() > 0 && pad->GetNetCode() == aZone->GetNetCode() )
             {
-                // for pads having a netcode different from the zone, use the net clearance:
-                int gap = std::max( zone_clearance, pad->GetClearance() );
-
-                // for pads having the same netcode as the zone, the net clearance has no
-                // meaning (clearance between object of the same net is 0) and the
-                // zone_clearance can be set to 0 (In this case the netclass clearance is used)
-                // therefore use the antipad clearance (thermal clearance) or the
-                // zone_clearance if bigger.
-                if( pad->GetNetCode() > 0 && pad->GetNetCode() == aZone->GetNetCode() )
-                {
-                    int thermalGap = aZone->GetThermalReliefGap( pad );
-                    gap = std::max( zone_clearance, thermalGap );;
-                }
+                int thermalGap = aZone->GetThermalReliefGap( pad );
+                gap = std::max( zone_clearance, thermalGap );;
+            }
 
-                EDA_RECT item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( pad->GetClearance() );
+            EDA_RECT item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( pad->GetClearance() );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                    addKnockout( pad, gap, aHoles );
-            }
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+                addKnockout( pad, gap, aHoles );
         }
     }
 
     // Add non-connected track clearances
     //
-    for( auto track : m_board->Tracks() )
+    for( TRACK* track : tracks )
     {
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
@@ -624,16 +1061,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         addKnockout( aItem, gap, ignoreLineWidth, aHoles );
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
-
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
+    for( BOARD_ITEM* item : graphics )
         doGraphicItem( item );
 
     // Add zones outlines having an higher priority and keepout
@@ -675,8 +1103,111 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
         zone->TransformOutlinesShapeWithClearanceToPolygon( aHoles, minClearance, useNetClearance );
     }
+}
+
+
+/**
+ * Subtracts aHoles from aPolys.  The holes do not need to be simplified: overlapping holes
+ * are merged by the subtraction itself.
+ *
+ * For a large set of holes, the area is split in a grid of slightly overlapping tiles.  The
+ * polygons are clipped to each tile and the holes touching the tile are subtracted from them
+ * on all the cores, then the tiles are merged again.  The boolean operations are exact on the
+ * integer coordinates, so the result only differs from a plain BooleanSubtract() by vertices
+ * the union may leave along the tile edges.
+ */
+static void subtractHoles( SHAPE_POLY_SET& aPolys, const SHAPE_POLY_SET& aHoles )
+{
+    size_t threadCount = GetKiCadThreadPool().GetThreadCount();
+
+    if( !ADVANCED_CFG::GetCfg().m_tiledZoneFill || threadCount <= 1
+            || aHoles.OutlineCount() < s_TiledFillMinHoles || aPolys.OutlineCount() == 0 )
+    {
+        aPolys.BooleanSubtract( aHoles, SHAPE_POLY_SET::PM_FAST );
+        return;
+    }
+
+    BOX2I  bbox = aPolys.BBox();
+    int    overlap = Millimeter2iu( 0.01 );
+    double tiles = 4.0 * threadCount;
+    double aspect = std::max( 1.0, (double) bbox.GetWidth() )
+                            / std::max( 1.0, (double) bbox.GetHeight() );
+    int    tilesX = std::max( 1, KiROUND( std::sqrt( tiles * aspect ) ) );
+    int    tilesY = std::max( 1, KiROUND( tiles / tilesX ) );
+
+    std::vector<BOX2I> holeBBoxes;
+
+    holeBBoxes.reserve( aHoles.OutlineCount() );
+
+    for( int ii = 0; ii < aHoles.OutlineCount(); ++ii )
+        holeBBoxes.push_back( aHoles.COutline( ii ).BBox() );
+
+    std::vector<SHAPE_POLY_SET> pieces( tilesX * tilesY );
+    std::atomic<size_t>         nextTile( 0 );
+
+    // Coordinate of the edge aIndex of aCount tiles splitting [aStart, aStart + aSize]
+    auto tileEdge =
+            []( int aStart, int aSize, int aIndex, int aCount )
+            {
+                return aStart + (int) ( (double) aSize * aIndex / aCount );
+            };
+
+    auto tileWorker =
+            [&]()
+            {
+                for( size_t i = nextTile++; i < pieces.size(); i = nextTile++ )
+                {
+                    int   col = i % tilesX;
+                    int   row = i / tilesX;
+                    BOX2I tile;
+
+                    tile.SetOrigin( tileEdge( bbox.GetX(), bbox.GetWidth(), col, tilesX ),
+                                    tileEdge( bbox.GetY(), bbox.GetHeight(), row, tilesY ) );
+                    tile.SetEnd( tileEdge( bbox.GetX(), bbox.GetWidth(), col + 1, tilesX ),
+                                 tileEdge( bbox.GetY(), bbox.GetHeight(), row + 1, tilesY ) );
+                    tile.Inflate( overlap );
+
+                    SHAPE_LINE_CHAIN tileOutline;
+                    tileOutline.Append( tile.GetX(), tile.GetY() );
+                    tileOutline.Append( tile.GetRight(), tile.GetY() );
+                    tileOutline.Append( tile.GetRight(), tile.GetBottom() );
+                    tileOutline.Append( tile.GetX(), tile.GetBottom() );
+                    tileOutline.SetClosed( true );
+
+                    SHAPE_POLY_SET tileHoles;
+
+                    for( int jj = 0; jj < aHoles.OutlineCount(); ++jj )
+                    {
+                        if( !holeBBoxes[jj].Intersects( tile ) )
+                            continue;
+
+                        const SHAPE_POLY_SET::POLYGON& hole = aHoles.CPolygon( jj );
+
+                        tileHoles.AddOutline( hole[0] );
+
+                        for( size_t kk = 1; kk < hole.size(); ++kk )
+                            tileHoles.AddHole( hole[kk] );
+                    }
+
+                    SHAPE_POLY_SET& piece = pieces[i];
+
+                    piece.AddOutline( tileOutline );
+                    piece.BooleanIntersection( aPolys, SHAPE_POLY_SET::PM_FAST );
+                    piece.BooleanSubtract( tileHoles, SHAPE_POLY_SET::PM_FAST );
+                }
+            };
+
+    // The zones are filled on the threads of the pool: RunParallel() helps them instead of
+    // waiting for threads busy with the other zones
+    GetKiCadThreadPool().RunParallel( tileWorker, pieces.size() );
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    // Stitch the tiles together; the overlapping parts are merged by the union
+    aPolys.RemoveAllContours();
+
+    for( const SHAPE_POLY_SET& piece : pieces )
+        aPolys.Append( piece );
+
+    aPolys.Simplify( SHAPE_POLY_SET::PM_FAST );
 }
 
 
@@ -691,7 +1222,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
  * 5 - Removes unconnected copper islands, deleting any affected spokes
  * 6 - Adds in the remaining spokes
  */
-void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
+bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                         const SHAPE_POLY_SET& aSmoothedOutline,
                                         std::set<VECTOR2I>* aPreserveCorners,
                                         SHAPE_POLY_SET& aRawPolys,
@@ -739,6 +1270,17 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 
     buildCopperItemClearances( aZone, clearanceHoles );
 
+    if( m_cancelled )
+        return false;
+
+    // The union of the holes is only needed to subtract them, and is the longest part of the
+    // job for a zone with many knockouts; subtractHoles() does not need it.
+    if( clearanceHoles.OutlineCount() < s_TiledFillMinHoles
+            || !ADVANCED_CFG::GetCfg().m_tiledZoneFill )
+    {
+        clearanceHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "clearance holes" );
 
@@ -748,7 +1290,10 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     // because the "real" subtract-clearance-holes has to be done after the spokes are added.
     static const bool USE_BBOX_CACHES = true;
     SHAPE_POLY_SET testAreas = aRawPolys;
-    testAreas.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    subtractHoles( testAreas, clearanceHoles );
+
+    if( m_cancelled )
+        return false;
 
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
@@ -757,9 +1302,21 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
         testAreas.Inflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
     }
 
-    // Spoke-end-testing is hugely expensive so we generate cached bounding-boxes to speed
-    // things up a bit.
+    // Spoke-end-testing is hugely expensive so we generate cached bounding-boxes (and grids
+    // for the large contours) to speed things up a bit.
     testAreas.BuildBBoxCaches();
+    testAreas.EnableGridPartitions();
+
+    // The spokes are indexed too, for the hit-tests of spoke ends against the other spokes
+    DRC_RTREE<const SHAPE_LINE_CHAIN*> spokeIndex;
+    std::vector<const SHAPE_LINE_CHAIN*> otherSpokes;
+
+    for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
+    {
+        BOX2I bbox = spoke.BBox();
+        spokeIndex.Insert( &spoke, EDA_RECT( (wxPoint) bbox.GetPosition(),
+                                             wxSize( bbox.GetWidth(), bbox.GetHeight() ) ) );
+    }
 
     for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
     {
@@ -773,9 +1330,13 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
         }
 
         // Hit-test against other spokes
-        for( const SHAPE_LINE_CHAIN& other : thermalSpokes )
+        EDA_RECT testBox( (wxPoint) testPt, wxSize( 0, 0 ) );
+        testBox.Inflate( 1 );
+        spokeIndex.Query( testBox, otherSpokes );
+
+        for( const SHAPE_LINE_CHAIN* other : otherSpokes )
         {
-            if( &other != &spoke && other.PointInside( testPt, 1, USE_BBOX_CACHES  ) )
+            if( other != &spoke && other->PointInside( testPt, 1, USE_BBOX_CACHES  ) )
             {
                 aRawPolys.AddOutline( spoke );
                 break;
@@ -791,7 +1352,11 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "solid-areas-with-thermal-spokes" );
 
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    subtractHoles( aRawPolys, clearanceHoles );
+
+    if( m_cancelled )
+        return false;
+
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
         aRawPolys.Deflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
@@ -823,6 +1388,9 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
             aRawPolys.BooleanIntersection( aSmoothedOutline, SHAPE_POLY_SET::PM_FAST );
     }
 
+    if( m_cancelled )
+        return false;
+
     aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
 
     if( s_DumpZonesWhenFilling )
@@ -832,6 +1400,8 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 
     if( s_DumpZonesWhenFilling )
         dumper->EndGroup();
+
+    return true;
 }
 
 
@@ -857,7 +1427,11 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 
     if( aZone->IsOnCopperLayer() )
     {
-        computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, aRawPolys, aFinalPolys );
+        if( !computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, aRawPolys,
+                                   aFinalPolys ) )
+        {
+            return false;
+        }
     }
     else
     {
@@ -897,6 +1471,73 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 }
 
 
+/**
+ * Builds the 4 thermal spokes of aPad, relative to its shape position: segments from the pad
+ * center to points just outside its thermal relief (of size aReliefMargin around the pad).
+ * The pad itself is not modified.
+ */
+static void buildPadSpokes( const D_PAD* aPad, int aReliefMargin, int aSpokeHalfWidth,
+                            double aSpokeAngle, std::array<SHAPE_LINE_CHAIN, 4>& aSpokes )
+{
+    // We use the bounding-box to lay out the spokes, but for this to work the bounding box
+    // has to be built at the same rotation as the spokes.  A copy of the pad is used, as
+    // the pad may be read by the other threads filling zones.
+    D_PAD unrotatedPad( *aPad );
+    unrotatedPad.SetOrientation( 0.0 );
+    unrotatedPad.SetPosition( { 0, 0 } );
+    BOX2I reliefBB = unrotatedPad.GetBoundingBox();
+
+    reliefBB.Inflate( aReliefMargin );
+
+    int spoke_half_w = aSpokeHalfWidth;
+
+    for( int i = 0; i < 4; i++ )
+    {
+        SHAPE_LINE_CHAIN& spoke = aSpokes[i];
+
+        spoke.Clear();
+
+        switch( i )
+        {
+        case 0:       // lower stub
+            spoke.Append( +spoke_half_w,       -spoke_half_w );
+            spoke.Append( -spoke_half_w,       -spoke_half_w );
+            spoke.Append( -spoke_half_w,       reliefBB.GetBottom() );
+            spoke.Append( 0,                   reliefBB.GetBottom() );  // test pt
+            spoke.Append( +spoke_half_w,       reliefBB.GetBottom() );
+            break;
+
+        case 1:       // upper stub
+            spoke.Append( +spoke_half_w,       spoke_half_w );
+            spoke.Append( -spoke_half_w,       spoke_half_w );
+            spoke.Append( -spoke_half_w,       reliefBB.GetTop() );
+            spoke.Append( 0,                   reliefBB.GetTop() );     // test pt
+            spoke.Append( +spoke_half_w,       reliefBB.GetTop() );
+            break;
+
+        case 2:       // right stub
+            spoke.Append( -spoke_half_w,       spoke_half_w );
+            spoke.Append( -spoke_half_w,       -spoke_half_w );
+            spoke.Append( reliefBB.GetRight(), -spoke_half_w );
+            spoke.Append( reliefBB.GetRight(), 0 );                     // test pt
+            spoke.Append( reliefBB.GetRight(), spoke_half_w );
+            break;
+
+        case 3:       // left stub
+            spoke.Append( spoke_half_w,        spoke_half_w );
+            spoke.Append( spoke_half_w,        -spoke_half_w );
+            spoke.Append( reliefBB.GetLeft(),  -spoke_half_w );
+            spoke.Append( reliefBB.GetLeft(),  0 );                     // test pt
+            spoke.Append( reliefBB.GetLeft(),  spoke_half_w );
+            break;
+        }
+
+        spoke.Rotate( -DECIDEG2RAD( aSpokeAngle ) );
+        spoke.SetClosed( true );
+    }
+}
+
+
 /**
  * Function buildThermalSpokes
  */
@@ -913,6 +1554,16 @@ void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone,
     // us avoid the question.
     int epsilon = KiROUND( IU_PER_MM * 0.04 );  // about 1.5 mil
 
+    // The spokes of a pad, relative to its shape position, only depend on its shape, on the
+    // spoke orientation, on the thermal gap and on the spoke width.  So they are built once
+    // for all the pads sharing these (typically the pads of a connector), and just moved to
+    // each pad.  Custom pad shapes are not part of the key: these pads are not shared.
+    typedef std::tuple<int, int, int, int, int, int, int, double, double, int, int, int,
+                       double> SPOKES_KEY;
+
+    std::map<SPOKES_KEY, std::array<SHAPE_LINE_CHAIN, 4>> spokeTemplates;
+    std::array<SHAPE_LINE_CHAIN, 4>                       customPadSpokes;
+
     for( auto module : m_board->Modules() )
     {
         for( auto pad : module->Pads() )
@@ -947,69 +1598,45 @@ void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone,
             if( !( itemBB.Intersects( zoneBB ) ) )
                 continue;
 
-            // Thermal spokes consist of segments from the pad center to points just outside
-            // the thermal relief.
-            //
-            // We use the bounding-box to lay out the spokes, but for this to work the
-            // bounding box has to be built at the same rotation as the spokes.
-
-            wxPoint shapePos = pad->ShapePos();
-            wxPoint padPos = pad->GetPosition();
-            double padAngle = pad->GetOrientation();
-            pad->SetOrientation( 0.0 );
-            pad->SetPosition( { 0, 0 } );
-            BOX2I reliefBB = pad->GetBoundingBox();
-            pad->SetPosition( padPos );
-            pad->SetOrientation( padAngle );
-
-            reliefBB.Inflate( thermalReliefGap + epsilon );
-
             // For circle pads, the thermal spoke orientation is 45 deg
+            double spokeAngle = pad->GetOrientation();
+
             if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-                padAngle = s_RoundPadThermalSpokeAngle;
+                spokeAngle = s_RoundPadThermalSpokeAngle;
+
+            const std::array<SHAPE_LINE_CHAIN, 4>* spokes = &customPadSpokes;
 
-            for( int i = 0; i < 4; i++ )
+            if( pad->GetShape() == PAD_SHAPE_CUSTOM )
             {
-                SHAPE_LINE_CHAIN spoke;
-                switch( i )
+                buildPadSpokes( pad, thermalReliefGap + epsilon, spoke_half_w, spokeAngle,
+                                customPadSpokes );
+            }
+            else
+            {
+                SPOKES_KEY key( pad->GetShape(), pad->GetSize().x, pad->GetSize().y,
+                                pad->GetOffset().x, pad->GetOffset().y,
+                                pad->GetDelta().x, pad->GetDelta().y,
+                                pad->GetRoundRectRadiusRatio(), pad->GetChamferRectRatio(),
+                                pad->GetChamferPositions(), thermalReliefGap, spoke_w,
+                                spokeAngle );
+
+                auto it = spokeTemplates.find( key );
+
+                if( it == spokeTemplates.end() )
                 {
-                case 0:       // lower stub
-                    spoke.Append( +spoke_half_w,       -spoke_half_w );
-                    spoke.Append( -spoke_half_w,       -spoke_half_w );
-                    spoke.Append( -spoke_half_w,       reliefBB.GetBottom() );
-                    spoke.Append( 0,                   reliefBB.GetBottom() );  // test pt
-                    spoke.Append( +spoke_half_w,       reliefBB.GetBottom() );
-                    break;
-
-                case 1:       // upper stub
-                    spoke.Append( +spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       reliefBB.GetTop() );
-                    spoke.Append( 0,                   reliefBB.GetTop() );     // test pt
-                    spoke.Append( +spoke_half_w,       reliefBB.GetTop() );
-                    break;
-
-                case 2:       // right stub
-                    spoke.Append( -spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       -spoke_half_w );
-                    spoke.Append( reliefBB.GetRight(), -spoke_half_w );
-                    spoke.Append( reliefBB.GetRight(), 0 );                     // test pt
-                    spoke.Append( reliefBB.GetRight(), spoke_half_w );
-                    break;
-
-                case 3:       // left stub
-                    spoke.Append( spoke_half_w,        spoke_half_w );
-                    spoke.Append( spoke_half_w,        -spoke_half_w );
-                    spoke.Append( reliefBB.GetLeft(),  -spoke_half_w );
-                    spoke.Append( reliefBB.GetLeft(),  0 );                     // test pt
-                    spoke.Append( reliefBB.GetLeft(),  spoke_half_w );
-                    break;
+                    it = spokeTemplates.emplace( key, std::array<SHAPE_LINE_CHAIN, 4>() ).first;
+                    buildPadSpokes( pad, thermalReliefGap + epsilon, spoke_half_w, spokeAngle,
+                                    it->second );
                 }
 
-                spoke.Rotate( -DECIDEG2RAD( padAngle ) );
-                spoke.Move( shapePos );
+                spokes = &it->second;
+            }
 
-                spoke.SetClosed( true );
+            for( const SHAPE_LINE_CHAIN& padSpoke : *spokes )
+            {
+                SHAPE_LINE_CHAIN spoke( padSpoke );
+
+                spoke.Move( pad->ShapePos() );
                 spoke.GenerateBBoxCache();
                 aSpokesList.push_back( std::move( spoke ) );
             }
@@ -1116,37 +1743,70 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
         }
     }
 
-    // Build holes
+    // Clamp holes to the area of filled zones with a outline thickness
+    // > aZone->GetMinThickness() to be sure the thermal pads can be built
+    int outline_margin = std::max( (aZone->GetMinThickness()*10)/9, linethickness/2 );
+    filledPolys.Deflate( outline_margin, 16 );
+
+    // Build holes, one tile of the grid at a time.  Each tile is only clamped to the part of
+    // the filled area it covers: the tiles outside the filled area are skipped, and the holes
+    // of the tiles fully inside it are kept as they are.  So only the holes which end up in
+    // the zone are ever built and stored.
     SHAPE_POLY_SET holes;
+    int colCount = bbox.GetWidth() / gridsize + 1;
+    int rowCount = bbox.GetHeight() / gridsize + 1;
 
-    for( int xx = 0; ; xx++ )
+    for( int col0 = 0; col0 < colCount; col0 += s_HatchTileCells )
     {
-        int xpos = xx * gridsize;
+        for( int row0 = 0; row0 < rowCount; row0 += s_HatchTileCells )
+        {
+            int col1 = std::min( col0 + s_HatchTileCells, colCount );
+            int row1 = std::min( row0 + s_HatchTileCells, rowCount );
 
-        if( xpos > bbox.GetWidth() )
-            break;
+            // The tile is the bounding box of its holes
+            VECTOR2I tileStart = bbox.GetPosition() + VECTOR2I( col0 * gridsize, row0 * gridsize );
+            VECTOR2I tileEnd = bbox.GetPosition() + VECTOR2I( ( col1 - 1 ) * gridsize + hole_size,
+                                                              ( row1 - 1 ) * gridsize + hole_size );
+            SHAPE_LINE_CHAIN tileRect;
 
-        for( int yy = 0; ; yy++ )
-        {
-            int ypos = yy * gridsize;
+            tileRect.Append( tileStart );
+            tileRect.Append( tileEnd.x, tileStart.y );
+            tileRect.Append( tileEnd );
+            tileRect.Append( tileStart.x, tileEnd.y );
+            tileRect.SetClosed( true );
 
-            if( ypos > bbox.GetHeight() )
-                break;
+            SHAPE_POLY_SET tileFill;
 
-            // Generate hole
-            SHAPE_LINE_CHAIN hole( hole_base );
-            hole.Move( VECTOR2I( xpos, ypos ) );
-            holes.AddOutline( hole );
-        }
-    }
+            tileFill.AddOutline( tileRect );
+            tileFill.BooleanIntersection( filledPolys, SHAPE_POLY_SET::PM_FAST );
 
-    holes.Move( bbox.GetPosition() );
+            if( tileFill.OutlineCount() == 0 )
+                continue;
 
-    // Clamp holes to the area of filled zones with a outline thickness
-    // > aZone->GetMinThickness() to be sure the thermal pads can be built
-    int outline_margin = std::max( (aZone->GetMinThickness()*10)/9, linethickness/2 );
-    filledPolys.Deflate( outline_margin, 16 );
-    holes.BooleanIntersection( filledPolys, SHAPE_POLY_SET::PM_FAST );
+            // Coordinates are integers, so a missing part would be at least half a unit wide
+            bool tileInside = tileFill.OutlineCount() == 1 && tileFill.HoleCount( 0 ) == 0
+                              && std::abs( std::abs( tileFill.Outline( 0 ).Area() )
+                                           - std::abs( tileRect.Area() ) ) < 0.25;
+
+            SHAPE_POLY_SET tileHoles;
+
+            for( int xx = col0; xx < col1; xx++ )
+            {
+                for( int yy = row0; yy < row1; yy++ )
+                {
+                    // Generate hole
+                    SHAPE_LINE_CHAIN hole( hole_base );
+                    hole.Move( bbox.GetPosition() + VECTOR2I( xx * gridsize, yy * gridsize ) );
+                    tileHoles.AddOutline( hole );
+                }
+            }
+
+            if( !tileInside )
+                tileHoles.BooleanIntersection( tileFill, SHAPE_POLY_SET::PM_FAST );
+
+            holes.Append( tileHoles );
+        }
+    }
 
     if( orientation != 0.0 )
         holes.Rotate( -M_PI/180.0 * orientation, VECTOR2I( 0,0 ) );
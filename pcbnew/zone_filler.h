@@ -26,14 +26,19 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <class_zone.h>
+#include <drc/drc_rtree.h>
 
 class WX_PROGRESS_REPORTER;
 class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+class ZONE_FILL_CACHE;
+class TRACK;
 
 
 class ZONE_FILLER
@@ -43,16 +48,63 @@ public:
     ~ZONE_FILLER();
 
     void InstallNewProgressReporter( wxWindow* aParent, const wxString& aTitle, int aNumPhases );
+
+    /**
+     * Sets the cache used to get back the fills of zones whose fill inputs are unchanged, and
+     * to store the new fills.  No ownership is taken; nullptr disables the cache.
+     */
+    void SetFillCache( ZONE_FILL_CACHE* aCache ) { m_fillCache = aCache; }
+
+    /**
+     * Sets a function called on the main thread for each zone as soon as its fill is built,
+     * while the other zones are still being filled (to redraw it, for instance).
+     */
+    void SetZoneFilledHandler( const std::function<void( ZONE_CONTAINER* )>& aHandler )
+    {
+        m_zoneFilledHandler = aHandler;
+    }
+
+    /**
+     * Asks the fill in progress to stop as soon as possible.  Can be called from any thread;
+     * the Cancel button of the progress reporter does the same.  The zones whose fill was
+     * completed keep it, the other ones are left unfilled.
+     */
+    void Cancel() { m_cancelled = true; }
+
+    bool IsCancelled() const { return m_cancelled; }
+
+    /**
+     * Fills the given zones.  A zone which is already filled, and whose fill inputs (see
+     * computeFillFingerprint()) did not change since its last fill, is not refilled unless
+     * aCheck is set.
+     * @return false if the fill was aborted or cancelled.
+     */
     bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
 
 private:
 
+    /**
+     * Function computeFillFingerprint
+     * @return a hash of everything the fill of aZone depends on: its outline and settings,
+     * the board outline and design settings, and the copper items, graphic items and zones
+     * near enough to the zone to knock out (or connect to) its fill.  Never 0.
+     */
+    size_t computeFillFingerprint( const ZONE_CONTAINER* aZone ) const;
+
     void addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles );
 
     void addKnockout( BOARD_ITEM* aItem, int aGap, bool aIgnoreLineWidth, SHAPE_POLY_SET& aHoles );
 
     void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aFill );
 
+    /**
+     * Function buildItemIndex
+     * Indexes the pads, tracks and graphic items of the board by their bounding box (grown
+     * by their largest possible clearance), so that buildCopperItemClearances() only looks
+     * at the items near each zone.  Must be called again when the board changes.
+     */
+    void buildItemIndex();
+
     void buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles );
 
     /**
@@ -65,8 +117,9 @@ private:
      * BuildFilledSolidAreasPolygons() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @return false if the fill was cancelled before completion
      */
-    void computeRawFilledArea( const ZONE_CONTAINER* aZone,
+    bool computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                const SHAPE_POLY_SET& aSmoothedOutline,
                                std::set<VECTOR2I>* aPreserveCorners,
                                SHAPE_POLY_SET& aRawPolys, SHAPE_POLY_SET& aFinalPolys );
@@ -82,7 +135,8 @@ private:
      * The solid areas can be more than one on copper layers, and do not have holes
      *  ( holes are linked by overlapping segments to the main outline)
      * in order to have drawable (and plottable) filled polygons.
-     * @return true if OK, false if the solid polygons cannot be built
+     * @return true if OK, false if the solid polygons cannot be built or the fill was
+     * cancelled
      * @param aZone is the zone to fill
      * @param aRawPolys: A reference to a SHAPE_POLY_SET buffer to store
      * filled solid areas polygons (with holes)
@@ -110,6 +164,15 @@ private:
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
     std::unique_ptr<WX_PROGRESS_REPORTER> m_uniqueReporter;
+    ZONE_FILL_CACHE* m_fillCache;
+
+    std::atomic<bool>                      m_cancelled;
+    std::function<void( ZONE_CONTAINER* )> m_zoneFilledHandler;
+
+    // Board items indexed by buildItemIndex(), in board order
+    DRC_RTREE<D_PAD*>      m_padIndex;
+    DRC_RTREE<TRACK*>      m_trackIndex;
+    DRC_RTREE<BOARD_ITEM*> m_graphicIndex;
 
     // m_high_def can be used to define a high definition arc to polygon approximation
     int m_high_def;
@@ -0,0 +1,169 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/convex_hull.h>
+#include <geometry/delaunay_2d.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+
+BOOST_AUTO_TEST_SUITE( Delaunay2D )
+
+
+static int64_t cross( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC )
+{
+    return int64_t( aB.x - aA.x ) * ( aC.y - aA.y ) - int64_t( aB.y - aA.y ) * ( aC.x - aA.x );
+}
+
+
+/**
+ * Checks that aTriangles is a Delaunay triangulation of aPoints: the triangles have the same
+ * orientation, they cover the convex hull of the points and no point is strictly inside the
+ * circumcircle of a triangle.  The coordinates must be small enough for exact int64_t
+ * determinants.
+ */
+static void checkDelaunay( const std::vector<VECTOR2I>& aPoints, const std::vector<int>& aTriangles )
+{
+    int64_t       area = 0;
+    std::set<int> vertices;
+
+    for( size_t t = 0; t < aTriangles.size(); t += 3 )
+    {
+        const VECTOR2I& a = aPoints[aTriangles[t]];
+        const VECTOR2I& b = aPoints[aTriangles[t + 1]];
+        const VECTOR2I& c = aPoints[aTriangles[t + 2]];
+
+        int64_t triArea = cross( a, b, c );
+
+        BOOST_REQUIRE( triArea < 0 );
+        triArea = -triArea;
+        area += triArea;
+
+        vertices.insert( aTriangles.begin() + t, aTriangles.begin() + t + 3 );
+
+        for( const VECTOR2I& p : aPoints )
+        {
+            int64_t adx = a.x - p.x, ady = a.y - p.y;
+            int64_t bdx = b.x - p.x, bdy = b.y - p.y;
+            int64_t cdx = c.x - p.x, cdy = c.y - p.y;
+
+            int64_t det = ( adx * adx + ady * ady ) * ( bdx * cdy - cdx * bdy )
+                          - ( bdx * bdx + bdy * bdy ) * ( adx * cdy - cdx * ady )
+                          + ( cdx * cdx + cdy * cdy ) * ( adx * bdy - bdx * ady );
+
+            BOOST_CHECK_MESSAGE( det >= 0, "Point " << p << " is inside the circumcircle of "
+                                                    << a << " " << b << " " << c );
+        }
+    }
+
+    BOOST_CHECK_EQUAL( vertices.size(), aPoints.size() );
+
+    std::vector<wxPoint> pts, hull;
+
+    for( const VECTOR2I& p : aPoints )
+        pts.emplace_back( p.x, p.y );
+
+    BuildConvexHull( hull, pts );
+
+    int64_t hullArea = 0;
+
+    for( size_t ii = 0; ii < hull.size(); ii++ )
+    {
+        const wxPoint& p = hull[ii];
+        const wxPoint& q = hull[( ii + 1 ) % hull.size()];
+
+        hullArea += int64_t( p.x ) * q.y - int64_t( q.x ) * p.y;
+    }
+
+    BOOST_CHECK_EQUAL( area, std::abs( hullArea ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Degenerate )
+{
+    DELAUNAY_2D triangulation;
+
+    BOOST_CHECK( !triangulation.Triangulate( {} ) );
+    BOOST_CHECK( !triangulation.Triangulate( { { 0, 0 }, { 10, 10 } } ) );
+    BOOST_CHECK( !triangulation.Triangulate( { { 0, 0 }, { 10, 10 }, { 30, 30 }, { -5, -5 } } ) );
+    BOOST_CHECK_EQUAL( triangulation.TriangleCount(), 0 );
+
+    BOOST_CHECK( triangulation.Triangulate( { { 0, 0 }, { 10, 0 }, { 0, 10 } } ) );
+    BOOST_CHECK_EQUAL( triangulation.TriangleCount(), 1 );
+}
+
+
+/**
+ * Random points, and points on a grid, where many of them are on the same circles and lines
+ */
+BOOST_AUTO_TEST_CASE( RandomPoints )
+{
+    std::mt19937  rng( 7 );
+    DELAUNAY_2D   triangulation;
+
+    for( int range : { 20, 100, 10000 } )
+    {
+        for( int count : { 3, 4, 10, 100, 1000 } )
+        {
+            std::uniform_int_distribution<int> coord( -range, range );
+            std::set<std::pair<int, int>>      unique;
+            std::vector<VECTOR2I>              points;
+
+            while( (int) points.size() < count )
+            {
+                VECTOR2I p( coord( rng ), coord( rng ) );
+
+                if( unique.emplace( p.x, p.y ).second )
+                    points.push_back( p );
+            }
+
+            BOOST_TEST_CONTEXT( "Range " << range << " count " << count )
+            {
+                // Colinear sets of a few points
+                bool colinear = std::all_of( points.begin(), points.end(),
+                        [&]( const VECTOR2I& p ) { return cross( points[0], points[1], p ) == 0; } );
+
+                BOOST_REQUIRE_EQUAL( triangulation.Triangulate( points ), !colinear );
+
+                std::vector<int>                 triangles;
+                std::vector<std::pair<int, int>> edges;
+
+                triangulation.GetTriangles( triangles );
+                triangulation.GetEdges( edges );
+
+                checkDelaunay( points, triangles );
+
+                // Euler: V - E + F = 2, the outer face included
+                BOOST_CHECK_EQUAL( (int) points.size() - (int) edges.size()
+                                           + triangulation.TriangleCount() + 1, 2 );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
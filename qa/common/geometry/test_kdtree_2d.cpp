@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/kdtree_2d.h>
+
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( KdTree2D )
+
+
+static int bruteForceNearest( const std::vector<VECTOR2I>& aPoints, const VECTOR2I& aPoint )
+{
+    int                     best = -1;
+    VECTOR2I::extended_type bestDist = 0;
+
+    for( size_t ii = 0; ii < aPoints.size(); ii++ )
+    {
+        VECTOR2I::extended_type dist = ( aPoints[ii] - aPoint ).SquaredEuclideanNorm();
+
+        if( best < 0 || dist < bestDist )
+        {
+            best = ii;
+            bestDist = dist;
+        }
+    }
+
+    return best;
+}
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    KDTREE_2D tree;
+
+    BOOST_CHECK( tree.Empty() );
+    BOOST_CHECK_EQUAL( tree.Nearest( VECTOR2I( 0, 0 ) ), -1 );
+}
+
+
+/**
+ * The nearest point is the one found by a linear search, also with many duplicated
+ * coordinates (points on a grid) where the smallest index must win
+ */
+BOOST_AUTO_TEST_CASE( MatchesBruteForce )
+{
+    std::mt19937 rng( 42 );
+
+    for( int grid : { 1, 1000, 1000000 } )
+    {
+        std::uniform_int_distribution<int> coord( -50, 50 );
+        std::vector<VECTOR2I>              points;
+
+        for( int ii = 0; ii < 500; ii++ )
+            points.emplace_back( coord( rng ) * grid, coord( rng ) * grid );
+
+        KDTREE_2D tree( points );
+
+        BOOST_CHECK_EQUAL( tree.Size(), points.size() );
+
+        for( int ii = 0; ii < 1000; ii++ )
+        {
+            VECTOR2I p( coord( rng ) * grid + coord( rng ), coord( rng ) * grid - coord( rng ) );
+
+            KDTREE_2D::ecoord dist;
+            int               found = tree.Nearest( p, &dist );
+
+            BOOST_TEST_CONTEXT( "Grid " << grid << " point " << p )
+            {
+                BOOST_CHECK_EQUAL( found, bruteForceNearest( points, p ) );
+                BOOST_CHECK_EQUAL( dist, ( points[found] - p ).SquaredEuclideanNorm() );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
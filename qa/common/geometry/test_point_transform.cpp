@@ -0,0 +1,107 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/point_transform.h>
+#include <geometry/shape_line_chain.h>
+#include <trigo.h>
+
+
+BOOST_AUTO_TEST_SUITE( PointTransform )
+
+
+/**
+ * A rotation in 0.1 degrees gives the same points as RotatePoint()
+ */
+BOOST_AUTO_TEST_CASE( MatchesRotatePoint )
+{
+    const wxPoint centre( 1234, -5678 );
+    const double  angles[] = { 0, 1, 450, 900, 1800, 2700, -900, -1, 3599, 4500, 123.4 };
+
+    for( double angle : angles )
+    {
+        std::vector<wxPoint> points;
+
+        for( int ii = -10; ii <= 10; ii++ )
+            points.emplace_back( ii * 987654 + 3, ii * -45678 - 7 );
+
+        std::vector<wxPoint> expected( points );
+
+        for( wxPoint& pt : expected )
+            RotatePoint( &pt, centre, angle );
+
+        POINT_TRANSFORM::RotationDeciDeg( angle, VECTOR2I( centre ) )
+                .Apply( points.data(), points.size() );
+
+        BOOST_TEST_CONTEXT( "Angle " << angle )
+        {
+            BOOST_CHECK( points == expected );
+        }
+    }
+}
+
+
+/**
+ * Quarter turns are exact: four of them give back the original chain
+ */
+BOOST_AUTO_TEST_CASE( QuarterTurnsAreExact )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( 123456789, -98765431 ), VECTOR2I( -3, 7 ),
+                              VECTOR2I( 0, 100000001 ) } );
+    SHAPE_LINE_CHAIN rotated( chain );
+
+    for( int ii = 0; ii < 4; ii++ )
+        rotated.Rotate( M_PI / 2, VECTOR2I( 17, 5 ) );
+
+    BOOST_CHECK( rotated.CompareGeometry( chain ) );
+
+    rotated.Rotate( M_PI / 2 );
+    BOOST_CHECK_EQUAL( rotated.CPoint( 1 ), VECTOR2I( -7, -3 ) );
+}
+
+
+/**
+ * Mirrors and translations match the plain integer formulas
+ */
+BOOST_AUTO_TEST_CASE( MirrorAndTranslate )
+{
+    const VECTOR2I ref( 10, -20 );
+    const VECTOR2I pt( 12345, 678 );
+
+    POINT_TRANSFORM mirror = POINT_TRANSFORM::Mirror( true, false, ref );
+
+    BOOST_CHECK( mirror.IsReflection() );
+    BOOST_CHECK_EQUAL( mirror.Apply( pt ), VECTOR2I( 2 * ref.x - pt.x, pt.y ) );
+
+    mirror = POINT_TRANSFORM::Mirror( true, true, ref );
+
+    BOOST_CHECK( !mirror.IsReflection() );
+    BOOST_CHECK_EQUAL( mirror.Apply( pt ), VECTOR2I( 2 * ref.x - pt.x, 2 * ref.y - pt.y ) );
+
+    BOOST_CHECK_EQUAL( POINT_TRANSFORM::Translation( ref ).Apply( pt ), pt + ref );
+    BOOST_CHECK_EQUAL( mirror.Translate( ref ).Apply( pt ),
+                       VECTOR2I( 3 * ref.x - pt.x, 3 * ref.y - pt.y ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
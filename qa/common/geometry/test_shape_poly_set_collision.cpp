@@ -26,6 +26,7 @@
 
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
+#include <math/util.h>
 
 #include "fixtures_geometry.h"
 
@@ -193,4 +194,71 @@ BOOST_AUTO_TEST_CASE( CollideVertexWithClearance )
     }
 }
 
+/**
+ * This test checks that Contains() gives the same results with the grid partitions of the
+ * contours as without them, including after an edit of the set.
+ */
+BOOST_AUTO_TEST_CASE( pointInPolygonSetGrid )
+{
+    // A notched outline and a hole, with enough vertices to be partitioned
+    SHAPE_LINE_CHAIN outline, hole;
+
+    for( int i = 0; i < 128; i++ )
+    {
+        double angle = 2.0 * M_PI * i / 128;
+        double radius = ( i % 2 ) ? 1000.0 : 800.0;
+
+        outline.Append( KiROUND( radius * cos( angle ) ), KiROUND( radius * sin( angle ) ) );
+    }
+
+    for( int i = 0; i < 96; i++ )
+    {
+        double angle = 2.0 * M_PI * i / 96;
+
+        hole.Append( KiROUND( 300.0 * cos( angle ) ), KiROUND( 300.0 * sin( angle ) ) );
+    }
+
+    outline.SetClosed( true );
+    hole.SetClosed( true );
+
+    SHAPE_POLY_SET polySet;
+    polySet.AddOutline( outline );
+    polySet.AddHole( hole );
+
+    SHAPE_POLY_SET gridPolySet = polySet;
+    gridPolySet.EnableGridPartitions();
+
+    std::vector<VECTOR2I> points;
+
+    for( int x = -1100; x <= 1100; x += 37 )
+    {
+        for( int y = -1100; y <= 1100; y += 41 )
+            points.emplace_back( x, y );
+    }
+
+    // The vertices and their neighbours are the difficult cases
+    for( auto iterator = polySet.CIterateWithHoles(); iterator; iterator++ )
+    {
+        points.push_back( *iterator );
+        points.push_back( *iterator + VECTOR2I( 1, 0 ) );
+        points.push_back( *iterator + VECTOR2I( 0, -1 ) );
+    }
+
+    for( int accuracy : { 0, 1, 3 } )
+    {
+        for( const VECTOR2I& point : points )
+        {
+            BOOST_CHECK_EQUAL( polySet.Contains( point, -1, accuracy ),
+                               gridPolySet.Contains( point, -1, accuracy ) );
+        }
+    }
+
+    // The grids must follow the edits
+    polySet.Move( VECTOR2I( 250, 0 ) );
+    gridPolySet.Move( VECTOR2I( 250, 0 ) );
+
+    for( const VECTOR2I& point : points )
+        BOOST_CHECK_EQUAL( polySet.Contains( point ), gridPolySet.Contains( point ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
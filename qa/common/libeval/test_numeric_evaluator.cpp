@@ -232,4 +232,48 @@ BOOST_AUTO_TEST_CASE( ResultsInvalid )
     }
 }
 
+/**
+ * The compiled strings give the same results when evaluated again
+ */
+BOOST_AUTO_TEST_CASE( RepeatedResults )
+{
+    for( int pass = 0; pass < 2; ++pass )
+    {
+        BOOST_TEST_CONTEXT( "Pass " << pass )
+        {
+            for( const auto& c : eval_cases_valid )
+            {
+                m_eval.Process( c.input );
+                BOOST_CHECK_EQUAL( m_eval.IsValid(), true );
+                BOOST_CHECK_EQUAL( m_eval.Result(), c.exp_result );
+            }
+
+            for( const auto& c : eval_cases_invalid )
+            {
+                m_eval.Process( c.input );
+                BOOST_CHECK_EQUAL( m_eval.IsValid(), false );
+            }
+        }
+    }
+
+    // The variables are read at each evaluation
+    m_eval.SetVar( "width", 2 );
+    m_eval.Process( "width * 2" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "4" );
+
+    m_eval.SetVar( "width", 3 );
+    m_eval.Process( "width * 2" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "6" );
+
+    // More strings than the cache keeps
+    for( int pass = 0; pass < 2; ++pass )
+    {
+        for( int i = 0; i < 200; ++i )
+        {
+            m_eval.Process( wxString::Format( "%d + 1", i ) );
+            BOOST_CHECK_EQUAL( m_eval.Result(), wxString::Format( "%d", i + 1 ) );
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
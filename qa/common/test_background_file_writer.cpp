@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for BACKGROUND_FILE_WRITER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <background_file_writer.h>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <fstream>
+#include <sstream>
+
+
+/**
+ * Removes the temporary file of a test when done
+ */
+struct BACKGROUND_FILE_WRITER_FIXTURE
+{
+    BACKGROUND_FILE_WRITER_FIXTURE()
+    {
+        m_fileName = wxFileName::CreateTempFileName( wxT( "qa_background_writer" ) );
+    }
+
+    ~BACKGROUND_FILE_WRITER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    std::string content() const
+    {
+        std::ifstream     file( m_fileName.ToStdString(), std::ios::binary );
+        std::stringstream buffer;
+
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    wxString m_fileName;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BackgroundFileWriter, BACKGROUND_FILE_WRITER_FIXTURE )
+
+
+/**
+ * Check that the last content queued for a file is the one written, without temporary file
+ */
+BOOST_AUTO_TEST_CASE( WriteInOrder )
+{
+    BACKGROUND_FILE_WRITER writer;
+    std::string            large( 1000000, 'x' );
+
+    writer.Write( m_fileName, "first\n" );
+    writer.Write( m_fileName, large );
+    writer.Write( m_fileName, "last\n" );
+
+    BOOST_CHECK( writer.Wait() );
+    BOOST_CHECK( !writer.IsBusy() );
+    BOOST_CHECK_EQUAL( content(), "last\n" );
+    BOOST_CHECK( !wxFileExists( m_fileName + wxT( ".tmp" ) ) );
+
+    writer.Write( m_fileName, large );
+
+    BOOST_CHECK( writer.Wait() );
+    BOOST_CHECK( content() == large );
+}
+
+
+/**
+ * Check that a failed write is reported once, and leaves no file
+ */
+BOOST_AUTO_TEST_CASE( ReportFailure )
+{
+    wxFileName missing( m_fileName );
+
+    missing.AppendDir( wxT( "qa_missing_directory" ) );
+
+    BACKGROUND_FILE_WRITER writer;
+
+    writer.Write( missing.GetFullPath(), "content\n" );
+
+    BOOST_CHECK( !writer.Wait() );
+    BOOST_CHECK( writer.Wait() );
+    BOOST_CHECK( !wxFileExists( missing.GetFullPath() ) );
+
+    BOOST_CHECK( BACKGROUND_FILE_WRITER::WriteFile( m_fileName, "direct\n" ) );
+    BOOST_CHECK_EQUAL( content(), "direct\n" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
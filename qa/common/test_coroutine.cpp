@@ -174,4 +174,32 @@ BOOST_AUTO_TEST_CASE( Increment )
             received_events.begin(), received_events.end(), exp_events.begin(), exp_events.end() );
 }
 
+
+/**
+ * Check that the stacks given back to the pool are reused for the same size.
+ */
+BOOST_AUTO_TEST_CASE( StackPoolReuse )
+{
+    COROUTINE_STACK_POOL& pool = COROUTINE_STACK_POOL::Get();
+    const size_t          size = 64 * 1024;
+
+    COROUTINE_STACK_POOL::STACK stack = pool.Acquire( size );
+
+    BOOST_REQUIRE( stack.m_Base != nullptr );
+    BOOST_CHECK_GE( stack.m_Size, size );
+
+    // The whole stack is usable
+    stack.m_Base[0] = 1;
+    stack.m_Base[stack.m_Size - 1] = 1;
+
+    pool.Release( stack );
+
+    COROUTINE_STACK_POOL::STACK reused = pool.Acquire( size );
+
+    BOOST_CHECK( reused.m_Base == stack.m_Base );
+    BOOST_CHECK_EQUAL( reused.m_Size, stack.m_Size );
+
+    pool.Release( reused );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
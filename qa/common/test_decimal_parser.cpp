@@ -0,0 +1,106 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <decimal_parser.h>
+#include <math/util.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+
+BOOST_AUTO_TEST_SUITE( DecimalParser )
+
+
+/**
+ * Check that the numbers read are the ones strtod() reads
+ */
+BOOST_AUTO_TEST_CASE( SameAsStrtod )
+{
+    for( const char* text : { "0", "-0", "1", "-12.5", "0.1", "3.14159265358979", ".5", "5.",
+                              "+2.54", "1e3", "-1.5E-3", "123456789.123456", "0.000001" } )
+    {
+        DECIMAL decimal;
+        double  value;
+
+        BOOST_TEST_CONTEXT( text )
+        {
+            BOOST_REQUIRE( ParseDecimal( std::string( text ), decimal ) );
+            BOOST_REQUIRE( decimal.ToDouble( value ) );
+            BOOST_CHECK_EQUAL( value, strtod( text, nullptr ) );
+            BOOST_CHECK_EQUAL( std::signbit( value ), std::signbit( strtod( text, nullptr ) ) );
+        }
+    }
+}
+
+
+/**
+ * Check that the values with few enough decimals are scaled exactly, as KiROUND rounds them
+ */
+BOOST_AUTO_TEST_CASE( ScaledInt )
+{
+    for( const char* text : { "0", "1", "-1.27", "25.4", "0.000001", "-1234.567891", "1e-3" } )
+    {
+        DECIMAL   decimal;
+        long long value;
+
+        BOOST_TEST_CONTEXT( text )
+        {
+            BOOST_REQUIRE( ParseDecimal( std::string( text ), decimal ) );
+            BOOST_REQUIRE( decimal.ToScaledInt( 1e6, value ) );
+            BOOST_CHECK_EQUAL( value, KiROUND( strtod( text, nullptr ) * 1e6 ) );
+        }
+    }
+
+    DECIMAL   decimal;
+    long long value;
+
+    // Too many decimals, or a scale which is not a power of ten
+    BOOST_REQUIRE( ParseDecimal( std::string( "1.2345675" ), decimal ) );
+    BOOST_CHECK( !decimal.ToScaledInt( 1e6, value ) );
+    BOOST_CHECK( !decimal.ToScaledInt( 39.37, value ) );
+}
+
+
+/**
+ * Check that what is not a plain decimal number is left to strtod()
+ */
+BOOST_AUTO_TEST_CASE( NotDecimal )
+{
+    for( const char* text : { "", "-", ".", "e5", "1e", "1e+", "1mm", "1.2.3", "0x10", "inf",
+                              "nan", " 1", "12345678901234567890" } )
+    {
+        DECIMAL decimal;
+
+        BOOST_TEST_CONTEXT( text )
+        {
+            BOOST_CHECK( !ParseDecimal( std::string( text ), decimal ) );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <dsnlexer.h>
+
+#include <cstring>
+#include <string>
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+static const KEYWORD test_keywords[] = {
+    { "at", 0 },
+    { "layer", 1 },
+    { "layers", 2 },
+    { "net", 3 },
+    { "pad", 4 },
+    { "width", 5 },
+};
+
+static const unsigned test_keyword_count = sizeof( test_keywords ) / sizeof( test_keywords[0] );
+
+
+/**
+ * Check that every keyword is found, and that its prefixes and extensions are not
+ */
+BOOST_AUTO_TEST_CASE( KeywordIndexFind )
+{
+    const KEYWORD_INDEX* index = KEYWORD_INDEX::Get( test_keywords, test_keyword_count );
+
+    BOOST_CHECK_EQUAL( index, KEYWORD_INDEX::Get( test_keywords, test_keyword_count ) );
+
+    for( const KEYWORD& keyword : test_keywords )
+    {
+        std::string text = std::string( keyword.name ) + "s_";
+        size_t      length = strlen( keyword.name );
+
+        BOOST_CHECK_EQUAL( index->Find( text.c_str(), length ), keyword.token );
+        BOOST_CHECK_EQUAL( index->Find( text.c_str(), length - 1 ), -1 );
+        BOOST_CHECK_EQUAL( index->Find( text.c_str(), length + 2 ), -1 );
+    }
+
+    BOOST_CHECK_EQUAL( index->Find( "layers", 6 ), 2 );
+    BOOST_CHECK_EQUAL( KEYWORD_INDEX::Get( nullptr, 0 )->Find( "at", 2 ), -1 );
+}
+
+
+/**
+ * Check that the lexer tells the keywords from the symbols
+ */
+BOOST_AUTO_TEST_CASE( KeywordTokens )
+{
+    DSNLEXER lexer( test_keywords, test_keyword_count, "(pad 1 (at 0 0) (layers F.Cu) netx)" );
+
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), 4 );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_NUMBER );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), 0 );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_NUMBER );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_NUMBER );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), 2 );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_SYMBOL );
+    BOOST_CHECK_EQUAL( std::string( lexer.CurText() ), "F.Cu" );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_SYMBOL );
+    BOOST_CHECK_EQUAL( std::string( lexer.CurText() ), "netx" );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_EOF );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
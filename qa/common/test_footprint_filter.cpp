@@ -0,0 +1,162 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <footprint_filter.h>
+
+
+namespace
+{
+
+class TEST_FOOTPRINT_INFO : public FOOTPRINT_INFO
+{
+public:
+    TEST_FOOTPRINT_INFO( const wxString& aNickname, const wxString& aName, unsigned aPadCount )
+    {
+        m_owner = nullptr;
+        m_loaded = true;
+        m_nickname = aNickname;
+        m_fpname = aName;
+        m_num = 0;
+        m_pad_count = aPadCount;
+        m_unique_pad_count = aPadCount;
+    }
+};
+
+
+class TEST_FOOTPRINT_LIST : public FOOTPRINT_LIST
+{
+public:
+    void Add( const wxString& aNickname, const wxString& aName, unsigned aPadCount )
+    {
+        m_list.emplace_back( new TEST_FOOTPRINT_INFO( aNickname, aName, aPadCount ) );
+    }
+
+    ///> Reads the list again, as a library load does
+    void Clear()
+    {
+        m_list.clear();
+        clearFilterMatches();
+    }
+
+    bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
+                             PROGRESS_REPORTER* aProgressReporter ) override
+    {
+        return true;
+    }
+
+protected:
+    void StartWorkers( FP_LIB_TABLE* aTable, wxString const* aNickname,
+                       FOOTPRINT_ASYNC_LOADER* aLoader, unsigned aNThreads ) override
+    {
+    }
+
+    bool JoinWorkers() override { return true; }
+
+    void StopWorkers() override {}
+};
+
+
+struct FOOTPRINT_FILTER_FIXTURE
+{
+    FOOTPRINT_FILTER_FIXTURE()
+    {
+        m_list.Add( "Capacitor_SMD", "C_0603", 2 );
+        m_list.Add( "Capacitor_SMD", "C_0805", 2 );
+        m_list.Add( "Device", "R", 2 );
+        m_list.Add( "Resistor_SMD", "R_0402", 2 );
+        m_list.Add( "Resistor_SMD", "R_0603", 2 );
+        m_list.Add( "Package_SO", "SOIC-8", 8 );
+    }
+
+    ///> @return the "library:name" of the footprints shown by aFilter
+    std::vector<std::string> shown( FOOTPRINT_FILTER& aFilter )
+    {
+        std::vector<std::string> names;
+
+        for( FOOTPRINT_INFO& fpinfo : aFilter )
+        {
+            names.push_back( std::string( ( fpinfo.GetLibNickname() + ":"
+                                            + fpinfo.GetFootprintName() ).ToUTF8() ) );
+        }
+
+        return names;
+    }
+
+    TEST_FOOTPRINT_LIST m_list;
+};
+
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintFilter, FOOTPRINT_FILTER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( FilterMatches )
+{
+    const std::vector<unsigned> resistors = { 3, 4 };
+    const std::vector<unsigned> lib = { 2 };
+
+    // The matching ignores the case, and includes the library with a ':'
+    BOOST_CHECK( m_list.GetFilterMatches( "r_*" ) == resistors );
+    BOOST_CHECK( m_list.GetFilterMatches( "DEVICE:*" ) == lib );
+    BOOST_CHECK( m_list.GetFilterMatches( "X_*" ).empty() );
+
+    // The matches are kept until the list is read again
+    const std::vector<unsigned>* cached = &m_list.GetFilterMatches( "r_*" );
+
+    BOOST_CHECK_EQUAL( cached, &m_list.GetFilterMatches( "r_*" ) );
+
+    m_list.Clear();
+    m_list.Add( "Resistor_SMD", "R_0805", 2 );
+
+    BOOST_CHECK( m_list.GetFilterMatches( "r_*" ) == std::vector<unsigned>{ 0 } );
+}
+
+
+BOOST_AUTO_TEST_CASE( FootprintFilters )
+{
+    FOOTPRINT_FILTER filter( m_list );
+    wxArrayString    filters;
+
+    filters.Add( "R_*" );
+    filters.Add( "C_0603" );
+    filter.FilterByFootprintFilters( filters );
+
+    // A footprint matched by any filter is shown, in the order of the list
+    const std::vector<std::string> expected = { "Capacitor_SMD:C_0603", "Resistor_SMD:R_0402",
+                                                "Resistor_SMD:R_0603" };
+
+    BOOST_CHECK( shown( filter ) == expected );
+
+    filter.FilterByPinCount( 8 );
+    BOOST_CHECK( shown( filter ).empty() );
+
+    FOOTPRINT_FILTER unfiltered( m_list );
+
+    unfiltered.FilterByFootprintFilters( wxArrayString() );
+    BOOST_CHECK_EQUAL( shown( unfiltered ).size(), 6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -74,4 +74,36 @@ BOOST_AUTO_TEST_CASE( wxPointUnitFormat )
 }
 
 
+/**
+ * Check formatting the values below 0.0001 mm, which are not in exponent form
+ */
+BOOST_AUTO_TEST_CASE( SmallUnitFormat )
+{
+#ifdef EESCHEMA
+    BOOST_CHECK_EQUAL( FormatInternalUnits( 1 ), "0.0001" );
+    BOOST_CHECK_EQUAL( FormatInternalUnits( -12 ), "-0.0012" );
+#elif GERBVIEW
+    BOOST_CHECK_EQUAL( FormatInternalUnits( 1 ), "0.00001" );
+    BOOST_CHECK_EQUAL( FormatInternalUnits( -12 ), "-0.00012" );
+#elif PCBNEW
+    BOOST_CHECK_EQUAL( FormatInternalUnits( 1 ), "0.000001" );
+    BOOST_CHECK_EQUAL( FormatInternalUnits( -12 ), "-0.000012" );
+#endif
+}
+
+
+/**
+ * Check formatting angles, given in 0.1 degrees
+ */
+BOOST_AUTO_TEST_CASE( AngleFormat )
+{
+    BOOST_CHECK_EQUAL( FormatAngle( 0.0 ), "0" );
+    BOOST_CHECK_EQUAL( FormatAngle( -0.0 ), "-0" );
+    BOOST_CHECK_EQUAL( FormatAngle( 900.0 ), "90" );
+    BOOST_CHECK_EQUAL( FormatAngle( -1805.0 ), "-180.5" );
+    BOOST_CHECK_EQUAL( FormatAngle( 3.0 ), "0.3" );
+    BOOST_CHECK_EQUAL( FormatAngle( 12.5 ), "1.25" );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the gzip LINE_READER and OUTPUTFORMATTER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <richio.h>
+
+#include <wx/filename.h>
+
+
+/**
+ * Removes the temporary files of a test when done
+ */
+struct GZIP_IO_FIXTURE
+{
+    GZIP_IO_FIXTURE()
+    {
+        m_tempFile = wxFileName::CreateTempFileName( wxT( "qa_gzip" ) );
+        m_gzipFile = m_tempFile + wxT( ".gz" );
+    }
+
+    ~GZIP_IO_FIXTURE()
+    {
+        wxRemoveFile( m_tempFile );
+        wxRemoveFile( m_gzipFile );
+    }
+
+    wxString m_tempFile;
+    wxString m_gzipFile;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GzipIO, GZIP_IO_FIXTURE )
+
+
+/**
+ * Check the lines read back are the ones written, also across the inflated blocks
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    std::vector<std::string> lines;
+    std::string              longLine( 700000, 'x' );
+
+    BOOST_CHECK( GZIP_OUTPUTFORMATTER::IsGzipFileName( m_gzipFile ) );
+    BOOST_CHECK( !GZIP_OUTPUTFORMATTER::IsGzipFileName( m_tempFile ) );
+
+    {
+        GZIP_OUTPUTFORMATTER formatter( m_gzipFile );
+
+        for( int ii = 0; ii < 100000; ii++ )
+        {
+            lines.push_back( std::string( ii % 7, ' ' ) + "(xy " + std::to_string( ii ) + ")\n" );
+            formatter.Print( 0, "%s", lines.back().c_str() );
+        }
+
+        lines.push_back( longLine + "\n" );
+        formatter.Print( 0, "%s\n", longLine.c_str() );
+
+        lines.push_back( "(end)" );
+        formatter.Print( 0, "(end)" );
+    }
+
+    BOOST_CHECK( GZIP_LINE_READER::IsGzipFile( m_gzipFile ) );
+
+    GZIP_LINE_READER reader( m_gzipFile, 0, longLine.size() + 1 );
+
+    for( const std::string& line : lines )
+    {
+        BOOST_REQUIRE( reader.ReadLine() );
+        BOOST_CHECK_EQUAL( std::string( reader.Line(), reader.Length() ), line );
+    }
+
+    BOOST_CHECK( !reader.ReadLine() );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), lines.size() + 1 );
+}
+
+
+/**
+ * Check a plain text file is not taken for a gzip file
+ */
+BOOST_AUTO_TEST_CASE( NotGzip )
+{
+    {
+        FILE_OUTPUTFORMATTER formatter( m_tempFile );
+        formatter.Print( 0, "(kicad_pcb)\n" );
+    }
+
+    BOOST_CHECK( !GZIP_LINE_READER::IsGzipFile( m_tempFile ) );
+    BOOST_CHECK( !GZIP_LINE_READER::IsGzipFile( m_tempFile + wxT( ".missing" ) ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
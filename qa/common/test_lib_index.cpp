@@ -0,0 +1,129 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <lib_index.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+namespace
+{
+
+struct LIB_INDEX_FIXTURE
+{
+    LIB_INDEX_FIXTURE() :
+            m_fileName( wxFileName::CreateTempFileName( "lib_index" ) )
+    {
+        const char* items[][3] = { { "Resistor_SMD", "R_0603", "resistor" },
+                                   { "Device", "R", "resistor" },
+                                   { "Resistor_SMD", "R_0402", "resistor" },
+                                   { "Device", "C", "capacitor" },
+                                   { "Capacitor_SMD", "C_0603", "capacitor" } };
+
+        for( const auto& item : items )
+        {
+            LIB_INDEX_ENTRY entry;
+
+            entry.m_Nickname = item[0];
+            entry.m_Name = item[1];
+            entry.m_Keywords = item[2];
+            entry.m_PadCount = m_entries.size() + 1;
+            m_entries.push_back( entry );
+        }
+    }
+
+    ~LIB_INDEX_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    wxString                     m_fileName;
+    std::vector<LIB_INDEX_ENTRY> m_entries;
+};
+
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE( LibIndex, LIB_INDEX_FIXTURE )
+
+
+/**
+ * Check every entry is found back by name
+ */
+BOOST_AUTO_TEST_CASE( Find )
+{
+    BOOST_REQUIRE( LIB_INDEX::Write( m_fileName, m_entries, 42 ) );
+
+    LIB_INDEX index;
+
+    BOOST_REQUIRE( index.Open( m_fileName ) );
+    BOOST_CHECK_EQUAL( index.GetTimestamp(), 42 );
+    BOOST_CHECK_EQUAL( index.GetCount(), m_entries.size() );
+
+    for( const LIB_INDEX_ENTRY& entry : m_entries )
+    {
+        BOOST_TEST_CONTEXT( std::string( entry.m_Nickname ) << ":" << std::string( entry.m_Name ) )
+        {
+            int idx = index.Find( entry.m_Nickname, entry.m_Name );
+
+            BOOST_REQUIRE( idx >= 0 );
+            BOOST_CHECK_EQUAL( index.GetKeywords( idx ), std::string( entry.m_Keywords ) );
+            BOOST_CHECK_EQUAL( index.GetPadCount( idx ), entry.m_PadCount );
+        }
+    }
+
+    BOOST_CHECK_EQUAL( index.Find( "Device", "L" ), -1 );
+    BOOST_CHECK_EQUAL( index.Find( "Inductor_SMD", "R" ), -1 );
+
+    int first, last;
+
+    index.FindLibrary( "Resistor_SMD", first, last );
+    BOOST_CHECK_EQUAL( last - first, 2 );
+    BOOST_CHECK_EQUAL( index.GetName( first ), std::string( "R_0402" ) );
+}
+
+
+/**
+ * Check a file which is not an index is rejected
+ */
+BOOST_AUTO_TEST_CASE( Invalid )
+{
+    wxFFile file( m_fileName, "wb" );
+    std::string garbage( 256, 'x' );
+
+    file.Write( garbage.data(), garbage.size() );
+    file.Close();
+
+    LIB_INDEX index;
+
+    BOOST_CHECK( !index.Open( m_fileName ) );
+    BOOST_CHECK( !index.Open( m_fileName + ".missing" ) );
+    BOOST_CHECK( !index.IsOpen() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <lib_tree_model.h>
+#include <lib_tree_item.h>
+#include <eda_pattern_match.h>
+
+#include <wx/tokenzr.h>
+
+
+namespace
+{
+
+class TEST_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aSearch ) :
+            m_libId( aLib, aName ), m_search( aSearch )
+    {
+    }
+
+    LIB_ID   GetLibId() const override { return m_libId; }
+    wxString GetName() const override { return m_libId.GetLibItemName(); }
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+    wxString GetDescription() override { return m_search; }
+    wxString GetSearchText() override { return m_search; }
+
+private:
+    LIB_ID   m_libId;
+    wxString m_search;
+};
+
+
+struct LIB_TREE_FIXTURE
+{
+    LIB_TREE_FIXTURE()
+    {
+        const char* libs[][2] = { { "Device", "basic devices" }, { "Resistor_SMD", "" },
+                                  { "Connector", "generic connectors" } };
+
+        const char* items[][3] = {
+            { "Device", "R", "resistor res r 10k" },
+            { "Device", "R_Small", "resistor small" },
+            { "Device", "C", "capacitor cap 100n" },
+            { "Device", "L", "inductor coil" },
+            { "Device", "D_Zener", "zener diode" },
+            { "Resistor_SMD", "R_0603", "0603 1608 metric" },
+            { "Resistor_SMD", "R_0805", "0805 2012 metric" },
+            { "Connector", "Conn_01x02", "connector 2 pins" },
+            { "Connector", "USB_C", "usb type-c receptacle" },
+        };
+
+        for( auto& item : items )
+            m_items.emplace_back( item[0], item[1], item[2] );
+
+        for( LIB_TREE_NODE_ROOT* root : { &m_indexed, &m_reference } )
+        {
+            for( auto& lib : libs )
+            {
+                LIB_TREE_NODE_LIB& node = root->AddLib( lib[0], lib[1] );
+
+                for( TEST_TREE_ITEM& item : m_items )
+                {
+                    if( item.GetLibNickname() == lib[0] )
+                        node.AddItem( &item );
+                }
+            }
+
+            // A library without parts is scored as a leaf
+            root->AddLib( "Empty_Lib", "" );
+        }
+    }
+
+    /**
+     * Score both trees, the reference one by running the matchers on each node
+     */
+    void Search( const wxString& aSearch )
+    {
+        m_indexed.ResetScore();
+        m_indexed.UpdateScores( aSearch );
+
+        m_reference.ResetScore();
+
+        wxStringTokenizer tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            EDA_COMBINED_MATCHER matcher( tokenizer.GetNextToken().Lower() );
+            m_reference.UpdateScore( matcher );
+        }
+    }
+
+    void CheckSameScores( const LIB_TREE_NODE& aIndexed, const LIB_TREE_NODE& aReference )
+    {
+        BOOST_TEST_CONTEXT( aIndexed.m_Name )
+        {
+            BOOST_CHECK_EQUAL( aIndexed.m_Score, aReference.m_Score );
+        }
+
+        BOOST_REQUIRE_EQUAL( aIndexed.m_Children.size(), aReference.m_Children.size() );
+
+        for( size_t i = 0; i < aIndexed.m_Children.size(); ++i )
+            CheckSameScores( *aIndexed.m_Children[i], *aReference.m_Children[i] );
+    }
+
+    std::vector<TEST_TREE_ITEM> m_items;
+    LIB_TREE_NODE_ROOT          m_indexed;
+    LIB_TREE_NODE_ROOT          m_reference;
+};
+
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, LIB_TREE_FIXTURE )
+
+
+/**
+ * Check that the indexed search scores the nodes like the matchers do, including when
+ * the search string is typed one character at a time
+ */
+BOOST_AUTO_TEST_CASE( IndexedScores )
+{
+    const std::vector<wxString> searches = {
+        "", "r", "re", "res", "resi", "res ", "res 1", "res 10", "res 10k", "re", "",
+        "R_0", "r_08", "0603", "metric 08", "type-c", "usb", "conn", "resistor_smd",
+        "device", "devi diode", "empty", "c*", "r?0", "^r_", "cap 100n", "zz", "z",
+    };
+
+    for( const wxString& search : searches )
+    {
+        BOOST_TEST_CONTEXT( "Search '" << search << "'" )
+        {
+            Search( search );
+            CheckSameScores( m_indexed, m_reference );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory_usage.h>
+
+
+BOOST_AUTO_TEST_SUITE( MemoryUsage )
+
+
+///> @return the bytes reported for aCategory, or -1 if it is not in the report
+static long long reportedBytes( const std::string& aCategory )
+{
+    for( const MEMORY_USAGE::ENTRY& entry : MEMORY_USAGE::Get().Report() )
+    {
+        if( entry.first == aCategory )
+            return entry.second;
+    }
+
+    return -1;
+}
+
+
+/**
+ * Check that the providers of a category are summed, and dropped with their handles
+ */
+BOOST_AUTO_TEST_CASE( SumProviders )
+{
+    size_t held = 100;
+
+    {
+        MEMORY_USAGE_PROVIDER first( "qa category A",
+                [&]()
+                {
+                    return held;
+                } );
+        MEMORY_USAGE_PROVIDER second( "qa category A",
+                []()
+                {
+                    return (size_t) 20;
+                } );
+        MEMORY_USAGE_PROVIDER other( "qa category B",
+                []()
+                {
+                    return (size_t) 3;
+                } );
+
+        BOOST_CHECK_EQUAL( reportedBytes( "qa category A" ), 120 );
+        BOOST_CHECK_EQUAL( reportedBytes( "qa category B" ), 3 );
+
+        // The providers are called for each report
+        held = 1000;
+        BOOST_CHECK_EQUAL( reportedBytes( "qa category A" ), 1020 );
+
+        second.Reset();
+        BOOST_CHECK_EQUAL( reportedBytes( "qa category A" ), 1000 );
+    }
+
+    // The categories stay in the report, empty
+    BOOST_CHECK_EQUAL( reportedBytes( "qa category A" ), 0 );
+    BOOST_CHECK_EQUAL( reportedBytes( "qa category B" ), 0 );
+    BOOST_CHECK_EQUAL( reportedBytes( "qa category C" ), -1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( FormatBytes )
+{
+    BOOST_CHECK_EQUAL( MEMORY_USAGE::FormatBytes( 0 ), "0 B" );
+    BOOST_CHECK_EQUAL( MEMORY_USAGE::FormatBytes( 1023 ), "1023 B" );
+    BOOST_CHECK_EQUAL( MEMORY_USAGE::FormatBytes( 1536 ), "1.5 kB" );
+    BOOST_CHECK_EQUAL( MEMORY_USAGE::FormatBytes( 3 * 1024 * 1024 ), "3.0 MB" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
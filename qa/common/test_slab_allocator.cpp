@@ -0,0 +1,174 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <slab_allocator.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( SlabAllocator )
+
+
+/**
+ * A class allocated by SLAB_ALLOCATOR, and a derived class of another size
+ */
+struct BASE_OBJECT
+{
+    BASE_OBJECT( int aValue ) : m_value( aValue ) {}
+    virtual ~BASE_OBJECT() {}
+
+    static void* operator new( size_t aSize ) { return SLAB_ALLOCATOR::Allocate( aSize ); }
+
+    static void operator delete( void* aPtr, size_t aSize )
+    {
+        SLAB_ALLOCATOR::Free( aPtr, aSize );
+    }
+
+    int m_value;
+};
+
+
+struct DERIVED_OBJECT : public BASE_OBJECT
+{
+    DERIVED_OBJECT( int aValue ) : BASE_OBJECT( aValue )
+    {
+        memset( m_payload, aValue & 0xFF, sizeof( m_payload ) );
+    }
+
+    char m_payload[200];
+};
+
+
+/**
+ * Check that the objects of all the sizes get their own aligned memory
+ */
+BOOST_AUTO_TEST_CASE( DistinctAligned )
+{
+    std::vector<std::pair<char*, size_t>> blocks;
+
+    for( size_t size = 1; size <= SLAB_ALLOCATOR::MAX_SIZE + 100; size += 7 )
+    {
+        for( int ii = 0; ii < 40; ii++ )
+        {
+            char* block = static_cast<char*>( SLAB_ALLOCATOR::Allocate( size ) );
+
+            BOOST_CHECK_EQUAL( reinterpret_cast<uintptr_t>( block ) % alignof( double ), 0 );
+            memset( block, (int) ( blocks.size() & 0xFF ), size );
+            blocks.emplace_back( block, size );
+        }
+    }
+
+    // No block was overwritten by another one
+    for( size_t ii = 0; ii < blocks.size(); ii++ )
+    {
+        char expected = (char) ( ii & 0xFF );
+
+        BOOST_CHECK( blocks[ii].first[0] == expected );
+        BOOST_CHECK( blocks[ii].first[blocks[ii].second - 1] == expected );
+    }
+
+    for( const auto& block : blocks )
+        SLAB_ALLOCATOR::Free( block.first, block.second );
+}
+
+
+/**
+ * Check that the freed slots are reused by the objects of their size
+ */
+BOOST_AUTO_TEST_CASE( ReuseSlots )
+{
+    std::set<BASE_OBJECT*>    freed;
+    std::vector<BASE_OBJECT*> objects;
+
+    for( int ii = 0; ii < 1000; ii++ )
+        objects.push_back( ii % 2 ? new DERIVED_OBJECT( ii ) : new BASE_OBJECT( ii ) );
+
+    for( BASE_OBJECT* object : objects )
+    {
+        if( dynamic_cast<DERIVED_OBJECT*>( object ) )
+            freed.insert( object );
+
+        delete object;
+    }
+
+    int reused = 0;
+
+    objects.clear();
+
+    for( int ii = 0; ii < 500; ii++ )
+    {
+        objects.push_back( new DERIVED_OBJECT( ii ) );
+        reused += freed.count( objects.back() );
+    }
+
+    // Some of the slots freed by the previous tests may be taken first
+    BOOST_CHECK_GE( reused, 400 );
+
+    for( BASE_OBJECT* object : objects )
+        delete object;
+}
+
+
+/**
+ * Check the objects allocated by a thread and freed by another one
+ */
+BOOST_AUTO_TEST_CASE( CrossThreads )
+{
+    const int                                 count = 20000;
+    std::vector<std::unique_ptr<BASE_OBJECT>> objects( count );
+
+    std::thread producer(
+            [&]()
+            {
+                for( int ii = 0; ii < count; ii++ )
+                    objects[ii].reset( new DERIVED_OBJECT( ii ) );
+            } );
+
+    producer.join();
+
+    std::thread consumer(
+            [&]()
+            {
+                for( int ii = 0; ii < count; ii++ )
+                {
+                    BOOST_CHECK_EQUAL( objects[ii]->m_value, ii );
+                    objects[ii].reset();
+                }
+            } );
+
+    consumer.join();
+
+    // The slots freed by the consumer, which has ended, can be reused
+    size_t freeBytes = SLAB_ALLOCATOR::FreeBytes();
+
+    BOOST_CHECK_GE( freeBytes, count * sizeof( DERIVED_OBJECT ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
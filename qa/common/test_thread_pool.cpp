@@ -0,0 +1,186 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread_pool.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Check that the calls of a parallel run share all the work, whatever the parallelism
+ */
+BOOST_AUTO_TEST_CASE( RunParallel )
+{
+    THREAD_POOL pool( 3 );
+
+    for( unsigned parallelism : { 0, 1, 2, 4, 16 } )
+    {
+        std::atomic<int> next( 0 );
+        std::atomic<int> sum( 0 );
+
+        pool.RunParallel(
+                [&]()
+                {
+                    for( int i = next++; i < 1000; i = next++ )
+                        sum += i;
+                },
+                parallelism );
+
+        BOOST_CHECK_EQUAL( sum, 999 * 1000 / 2 );
+    }
+}
+
+
+/**
+ * Check that parallel runs started from the tasks of the pool complete
+ */
+BOOST_AUTO_TEST_CASE( NestedRunParallel )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> next( 0 );
+    std::atomic<int> count( 0 );
+
+    pool.RunParallel(
+            [&]()
+            {
+                for( int i = next++; i < 8; i = next++ )
+                {
+                    std::atomic<int> nextInner( 0 );
+
+                    pool.RunParallel(
+                            [&]()
+                            {
+                                for( int j = nextInner++; j < 100; j = nextInner++ )
+                                    count++;
+                            },
+                            4 );
+                }
+            },
+            4 );
+
+    BOOST_CHECK_EQUAL( count, 800 );
+}
+
+
+/**
+ * Check that the exception of a task is given to its future
+ */
+BOOST_AUTO_TEST_CASE( SubmitException )
+{
+    THREAD_POOL       pool( 1 );
+    std::future<void> result = pool.Submit( []() { throw std::runtime_error( "task" ); } );
+
+    BOOST_CHECK_THROW( result.get(), std::runtime_error );
+}
+
+
+/**
+ * Check that the queued interactive tasks run before the background ones
+ */
+BOOST_AUTO_TEST_CASE( Priorities )
+{
+    THREAD_POOL       pool( 1 );
+    std::mutex        orderLock;
+    std::vector<int>  order;
+    std::promise<void> started, release;
+
+    // Keep the worker busy while the other tasks are queued
+    std::future<void> blocker = pool.Submit(
+            [&]()
+            {
+                started.set_value();
+                release.get_future().wait();
+            } );
+
+    started.get_future().wait();
+
+    auto record =
+            [&]( int aId )
+            {
+                return [&, aId]()
+                       {
+                           std::lock_guard<std::mutex> lock( orderLock );
+                           order.push_back( aId );
+                       };
+            };
+
+    std::future<void> background = pool.Submit( record( 1 ), TASK_PRIORITY::BACKGROUND );
+    std::future<void> interactive = pool.Submit( record( 2 ), TASK_PRIORITY::INTERACTIVE );
+
+    release.set_value();
+    blocker.get();
+    background.get();
+    interactive.get();
+
+    BOOST_CHECK( order == std::vector<int>( { 2, 1 } ) );
+}
+
+
+/**
+ * Check that a task group runs all its tasks, and skips the queued ones once cancelled
+ */
+BOOST_AUTO_TEST_CASE( TaskGroup )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> count( 0 );
+
+    {
+        TASK_GROUP group( TASK_PRIORITY::BACKGROUND, pool );
+
+        for( int i = 0; i < 100; ++i )
+            group.Run( [&]() { count++; } );
+
+        group.Wait();
+        BOOST_CHECK_EQUAL( count, 100 );
+    }
+
+    {
+        TASK_GROUP group( TASK_PRIORITY::INTERACTIVE, pool );
+
+        group.Cancel();
+
+        for( int i = 0; i < 100; ++i )
+            group.Run( [&]() { count++; } );
+
+        group.Wait();
+        BOOST_CHECK_EQUAL( count, 100 );
+    }
+
+    {
+        TASK_GROUP group( TASK_PRIORITY::INTERACTIVE, pool );
+
+        group.Run( []() { throw std::runtime_error( "task" ); } );
+        BOOST_CHECK_THROW( group.Wait(), std::runtime_error );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
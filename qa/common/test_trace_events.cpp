@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <trace_events.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+
+BOOST_AUTO_TEST_SUITE( TraceEvents )
+
+
+static std::string readFile( const std::string& aFileName )
+{
+    std::ifstream     in( aFileName );
+    std::stringstream content;
+
+    content << in.rdbuf();
+    return content.str();
+}
+
+
+/**
+ * Check that the nested scopes of several threads are written, and nothing when disabled
+ */
+BOOST_AUTO_TEST_CASE( WriteScopes )
+{
+    TRACE_EVENTS& events = TRACE_EVENTS::Get();
+    std::string   fileName = "qa_trace_events.json";
+
+    events.Clear();
+    events.Enable( true );
+
+    {
+        SCOPED_TRACE_EVENT outer( "outer" );
+
+        std::thread worker(
+                []()
+                {
+                    SCOPED_TRACE_EVENT inWorker( "in_worker" );
+                } );
+
+        {
+            SCOPED_TRACE_EVENT inner( "inner" );
+        }
+
+        worker.join();
+    }
+
+    events.Enable( false );
+
+    {
+        SCOPED_TRACE_EVENT ignored( "ignored" );
+    }
+
+    BOOST_REQUIRE( events.Write( fileName ) );
+
+    std::string trace = readFile( fileName );
+    std::remove( fileName.c_str() );
+
+    BOOST_CHECK( trace.find( "\"traceEvents\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"outer\",\"ph\":\"X\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"in_worker\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"inner\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"depth\":1" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "ignored" ) == std::string::npos );
+
+    events.Clear();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,608 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file geometry_benchmark.cpp
+ * Micro-benchmarks of the kimath geometry hot paths: point in polygon, collisions,
+ * boolean operations, fracturing, inflating and triangulation.
+ *
+ * The synthetic datasets are built from a fixed seed, with the raw mt19937 output (which
+ * the standard specifies exactly), so they are the same on every platform and every run.
+ * Real board datasets are the polygon dumps of the polygon_generator tool of
+ * qa_pcbnew_tools.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/seg.h>
+#include <geometry/shape.h>
+#include <geometry/shape_poly_set.h>
+#include <math/util.h>
+
+#include <qa_utils/micro_benchmark.h>
+#include <qa_utils/utility_registry.h>
+
+
+using KI_TEST::BENCH_STATE;
+using KI_TEST::MICRO_BENCHMARK;
+
+
+/// Internal units per millimeter, as in Pcbnew
+static const int IU_PER_MM = 1000000;
+
+/// Number of query points in the PointInside benchmarks
+static const int QUERY_COUNT = 10000;
+
+/// Number of query points or segments in the Collide benchmarks, which are much slower
+/// (SHAPE_POLY_SET::Collide() inflates the whole set for each query)
+static const int COLLIDE_QUERY_COUNT = 20;
+
+
+struct GEOM_DATASET
+{
+    std::string    m_name;
+    SHAPE_POLY_SET m_polys;     ///< Outlines with holes, not fractured
+};
+
+
+/**
+ * A random number generator giving the same values on every platform:
+ * std::uniform_int_distribution and friends are implementation defined.
+ */
+class BENCH_RANDOM
+{
+public:
+    BENCH_RANDOM( unsigned aSeed ) : m_gen( aSeed )
+    {
+    }
+
+    ///> @return an integer in [aMin, aMax]
+    int Int( int aMin, int aMax )
+    {
+        return aMin + (int) ( m_gen() % (unsigned) ( aMax - aMin + 1 ) );
+    }
+
+    VECTOR2I Point( const BOX2I& aBox )
+    {
+        return VECTOR2I( Int( aBox.GetX(), aBox.GetRight() ), Int( aBox.GetY(), aBox.GetBottom() ) );
+    }
+
+private:
+    std::mt19937 m_gen;
+};
+
+
+/**
+ * A single non convex outline: a star with 2000 random spikes
+ */
+static GEOM_DATASET buildStar()
+{
+    GEOM_DATASET  data{ "star", SHAPE_POLY_SET() };
+    BENCH_RANDOM  rnd( 1 );
+    const int     count = 2000;
+    const int     radius = 20 * IU_PER_MM;
+
+    data.m_polys.NewOutline();
+
+    for( int ii = 0; ii < count; ii++ )
+    {
+        double angle = 2 * M_PI * ii / count;
+        int    r = rnd.Int( radius / 2, radius );
+
+        data.m_polys.Append( KiROUND( r * cos( angle ) ), KiROUND( r * sin( angle ) ) );
+    }
+
+    return data;
+}
+
+
+/**
+ * The union of 400 random tracks, 0.25 mm wide: many outlines, some with holes
+ */
+static GEOM_DATASET buildTracks()
+{
+    GEOM_DATASET data{ "tracks", SHAPE_POLY_SET() };
+    BENCH_RANDOM rnd( 2 );
+    BOX2I        area( VECTOR2I( 0, 0 ), VECTOR2I( 50 * IU_PER_MM, 50 * IU_PER_MM ) );
+
+    for( int ii = 0; ii < 400; ii++ )
+    {
+        VECTOR2I start = rnd.Point( area );
+        VECTOR2I end = start + VECTOR2I( rnd.Int( -5, 5 ), rnd.Int( -5, 5 ) ) * IU_PER_MM;
+
+        TransformSegmentToPolygon( data.m_polys, (wxPoint) start, (wxPoint) end, 5000,
+                                   IU_PER_MM / 4 );
+    }
+
+    data.m_polys.Simplify( SHAPE_POLY_SET::PM_FAST );
+    return data;
+}
+
+
+/**
+ * A zone like area: a 50 mm square with the clearance holes of 300 pads and 200 tracks
+ */
+static GEOM_DATASET buildZone()
+{
+    GEOM_DATASET   data{ "zone", SHAPE_POLY_SET() };
+    BENCH_RANDOM   rnd( 3 );
+    BOX2I          area( VECTOR2I( 0, 0 ), VECTOR2I( 50 * IU_PER_MM, 50 * IU_PER_MM ) );
+    SHAPE_POLY_SET holes;
+
+    data.m_polys.NewOutline();
+    data.m_polys.Append( area.GetX(), area.GetY() );
+    data.m_polys.Append( area.GetRight(), area.GetY() );
+    data.m_polys.Append( area.GetRight(), area.GetBottom() );
+    data.m_polys.Append( area.GetX(), area.GetBottom() );
+
+    for( int ii = 0; ii < 300; ii++ )
+    {
+        TransformCircleToPolygon( holes, (wxPoint) rnd.Point( area ),
+                                  rnd.Int( IU_PER_MM / 4, IU_PER_MM ), 5000 );
+    }
+
+    for( int ii = 0; ii < 200; ii++ )
+    {
+        VECTOR2I start = rnd.Point( area );
+        VECTOR2I end = start + VECTOR2I( rnd.Int( -8, 8 ), rnd.Int( -8, 8 ) ) * IU_PER_MM;
+
+        TransformSegmentToPolygon( holes, (wxPoint) start, (wxPoint) end, 5000, IU_PER_MM / 2 );
+    }
+
+    data.m_polys.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    return data;
+}
+
+
+/**
+ * Reads the zone fills of a .kicad_pcb file: each (filled_polygon (pts (xy x y) ...)) is
+ * an outline, already fractured.  Nothing else of the board is read, so that no Pcbnew
+ * code is needed.
+ */
+static void readZoneFills( const std::string& aContent, SHAPE_POLY_SET& aPolys )
+{
+    const std::string startToken = "(filled_polygon";
+    size_t            pos = 0;
+
+    while( ( pos = aContent.find( startToken, pos ) ) != std::string::npos )
+    {
+        // Find the end of the filled_polygon expression
+        size_t end = pos + 1;
+        int    depth = 1;
+
+        while( end < aContent.size() && depth > 0 )
+        {
+            if( aContent[end] == '(' )
+                depth++;
+            else if( aContent[end] == ')' )
+                depth--;
+
+            end++;
+        }
+
+        aPolys.NewOutline();
+
+        for( size_t xy = aContent.find( "(xy ", pos ); xy < end;
+             xy = aContent.find( "(xy ", xy + 1 ) )
+        {
+            std::stringstream coords( aContent.substr( xy + 4, 40 ) );
+            double            x, y;
+
+            if( coords >> x >> y )
+                aPolys.Append( KiROUND( x * IU_PER_MM ), KiROUND( y * IU_PER_MM ) );
+        }
+
+        pos = end;
+    }
+}
+
+
+/**
+ * Loads a real board dataset: the zone fills of a .kicad_pcb file, or the polygon sets of
+ * a polygon_generator dump (SHAPE_FILE_IO format).  In the dumps, the other lines (nets,
+ * groups) are skipped.  All the polygons are merged in a single set.
+ */
+static bool loadBoardDataset( const std::string& aFilename, GEOM_DATASET& aData )
+{
+    std::ifstream file( aFilename );
+
+    if( !file )
+        return false;
+
+    std::stringstream content;
+    content << file.rdbuf();
+
+    SHAPE_POLY_SET merged;
+    std::string    token;
+
+    if( aFilename.size() > 10 && aFilename.substr( aFilename.size() - 10 ) == ".kicad_pcb" )
+        readZoneFills( content.str(), merged );
+
+    while( content >> token )
+    {
+        if( token != "shape" )
+            continue;
+
+        int         type;
+        std::string name;
+
+        content >> type >> name;
+
+        if( type != SH_POLY_SET )
+            continue;
+
+        SHAPE_POLY_SET polys;
+
+        if( !polys.Parse( content ) )
+            return false;
+
+        merged.Append( polys );
+    }
+
+    merged.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    size_t slash = aFilename.find_last_of( "/\\" );
+
+    aData.m_name = "board:" + aFilename.substr( slash == std::string::npos ? 0 : slash + 1 );
+    aData.m_polys = merged;
+
+    return aData.m_polys.OutlineCount() > 0;
+}
+
+
+static std::vector<VECTOR2I> queryPoints( const SHAPE_POLY_SET& aPolys, int aCount )
+{
+    BENCH_RANDOM          rnd( 4 );
+    BOX2I                 bbox = aPolys.BBox();
+    std::vector<VECTOR2I> points;
+
+    for( int ii = 0; ii < aCount; ii++ )
+        points.push_back( rnd.Point( bbox ) );
+
+    return points;
+}
+
+
+static std::vector<SEG> querySegments( const SHAPE_POLY_SET& aPolys )
+{
+    BENCH_RANDOM     rnd( 5 );
+    BOX2I            bbox = aPolys.BBox();
+    std::vector<SEG> segs;
+
+    for( int ii = 0; ii < COLLIDE_QUERY_COUNT; ii++ )
+    {
+        VECTOR2I start = rnd.Point( bbox );
+        segs.emplace_back( start, start + VECTOR2I( rnd.Int( -1, 1 ), rnd.Int( -1, 1 ) )
+                                                  * IU_PER_MM );
+    }
+
+    return segs;
+}
+
+
+/**
+ * Runs aFunc on a fresh copy of aPolys in each iteration, the copy not being timed
+ */
+template <typename FUNC>
+static void benchOnCopy( BENCH_STATE& aState, const SHAPE_POLY_SET& aPolys, FUNC aFunc )
+{
+    while( aState.KeepRunning() )
+    {
+        aState.PauseTiming();
+        SHAPE_POLY_SET polys( aPolys );
+        aState.ResumeTiming();
+
+        aFunc( polys );
+    }
+
+    aState.SetItemsProcessed( aState.Iterations() * aPolys.TotalVertices() );
+}
+
+
+static void addDatasetBenchmarks( std::vector<MICRO_BENCHMARK>& aList, const GEOM_DATASET& aData )
+{
+    // The benchmark functions are run many times: share the dataset between them
+    auto polys = std::make_shared<SHAPE_POLY_SET>( aData.m_polys );
+    auto points = std::make_shared<std::vector<VECTOR2I>>(
+            queryPoints( aData.m_polys, QUERY_COUNT ) );
+    auto collidePoints = std::make_shared<std::vector<VECTOR2I>>(
+            queryPoints( aData.m_polys, COLLIDE_QUERY_COUNT ) );
+    auto segs = std::make_shared<std::vector<SEG>>( querySegments( aData.m_polys ) );
+
+    auto fractured = std::make_shared<SHAPE_POLY_SET>( aData.m_polys );
+    fractured->Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    auto gridded = std::make_shared<SHAPE_POLY_SET>( aData.m_polys );
+    gridded->EnableGridPartitions();
+
+    auto other = std::make_shared<SHAPE_POLY_SET>( aData.m_polys );
+    BOX2I bbox = other->BBox();
+    other->Move( VECTOR2I( bbox.GetWidth() / 7, bbox.GetHeight() / 5 ) );
+
+    const std::string& name = aData.m_name;
+    const int          clearance = IU_PER_MM / 5;
+
+    auto contains = [points]( BENCH_STATE& aState, const SHAPE_POLY_SET& aPolys )
+    {
+        int inside = 0;
+
+        while( aState.KeepRunning() )
+        {
+            for( const VECTOR2I& pt : *points )
+                inside += aPolys.Contains( pt );
+        }
+
+        aState.SetItemsProcessed( aState.Iterations() * points->size() );
+        aState.KeepResult( inside );
+    };
+
+    aList.push_back( { "PointInside/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                contains( aState, *polys );
+            } } );
+
+    aList.push_back( { "PointInsideGrid/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                // The grids are built by the first query, outside the timed loop
+                gridded->Contains( points->front() );
+                contains( aState, *gridded );
+            } } );
+
+    aList.push_back( { "CollidePoint/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                int hits = 0;
+
+                while( aState.KeepRunning() )
+                {
+                    for( const VECTOR2I& pt : *collidePoints )
+                        hits += polys->Collide( pt, clearance );
+                }
+
+                aState.SetItemsProcessed( aState.Iterations() * collidePoints->size() );
+                aState.KeepResult( hits );
+            } } );
+
+    aList.push_back( { "CollideSeg/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                int hits = 0;
+
+                while( aState.KeepRunning() )
+                {
+                    for( const SEG& seg : *segs )
+                        hits += polys->Collide( seg, clearance );
+                }
+
+                aState.SetItemsProcessed( aState.Iterations() * segs->size() );
+                aState.KeepResult( hits );
+            } } );
+
+    aList.push_back( { "BooleanAdd/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, [&]( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.BooleanAdd( *other, SHAPE_POLY_SET::PM_FAST );
+                        } );
+            } } );
+
+    aList.push_back( { "BooleanSubtract/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, [&]( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.BooleanSubtract( *other, SHAPE_POLY_SET::PM_FAST );
+                        } );
+            } } );
+
+    aList.push_back( { "BooleanIntersection/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, [&]( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.BooleanIntersection( *other, SHAPE_POLY_SET::PM_FAST );
+                        } );
+            } } );
+
+    aList.push_back( { "Fracture/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, []( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+                        } );
+            } } );
+
+    aList.push_back( { "Inflate/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, [&]( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.Inflate( clearance, 16 );
+                        } );
+            } } );
+
+    aList.push_back( { "Deflate/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *polys, [&]( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.Inflate( -clearance, 16 );
+                        } );
+            } } );
+
+    // The fractured copy is never triangulated, so each copy of it triangulates from scratch
+    aList.push_back( { "Triangulate/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *fractured, []( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.CacheTriangulation( false );
+                        } );
+            } } );
+
+    aList.push_back( { "TriangulateParallel/" + name,
+            [=]( BENCH_STATE& aState )
+            {
+                benchOnCopy( aState, *fractured, []( SHAPE_POLY_SET& aPolys )
+                        {
+                            aPolys.CacheTriangulation( true );
+                        } );
+            } } );
+}
+
+
+static void printUsage( const char* aName )
+{
+    std::cout << "Usage: " << aName << " [options] [polygon dump files...]\n\n"
+              << "Benchmarks the kimath geometry routines on synthetic datasets and on the\n"
+              << "real boards given on the command line: the zone fills of .kicad_pcb files\n"
+              << "(e.g. qa/data/complex_hierarchy.kicad_pcb), or polygon dumps made with\n"
+              << "'qa_pcbnew_tools polygon_generator board.kicad_pcb > dump.txt'.\n\n"
+              << "Options:\n"
+              << "  --filter=<text>    only run the benchmarks whose name contains text\n"
+              << "  --min-time=<s>     minimal duration of each timed run (default 0.5)\n"
+              << "  --repetitions=<n>  timed runs of each benchmark, the median is reported\n"
+              << "  --json=<file>      write the results in Google Benchmark JSON format\n"
+              << "  --list             list the benchmarks without running them\n";
+}
+
+
+int geometry_benchmark_main( int argc, char* argv[] )
+{
+    KI_TEST::BENCH_OPTIONS   options;
+    std::string              jsonFile;
+    std::vector<std::string> boardFiles;
+    bool                     listOnly = false;
+
+    for( int ii = 1; ii < argc; ii++ )
+    {
+        std::string arg = argv[ii];
+
+        auto value = [&]( const std::string& aOption, std::string& aValue )
+        {
+            if( arg.compare( 0, aOption.size(), aOption ) != 0 )
+                return false;
+
+            aValue = arg.substr( aOption.size() );
+            return true;
+        };
+
+        std::string val;
+
+        if( arg == "-h" || arg == "--help" )
+        {
+            printUsage( argv[0] );
+            return KI_TEST::RET_CODES::OK;
+        }
+        else if( arg == "--list" )
+            listOnly = true;
+        else if( value( "--filter=", val ) )
+            options.m_filter = val;
+        else if( value( "--min-time=", val ) )
+            options.m_minTime = atof( val.c_str() );
+        else if( value( "--repetitions=", val ) )
+            options.m_repetitions = atoi( val.c_str() );
+        else if( value( "--json=", val ) )
+            jsonFile = val;
+        else if( arg.compare( 0, 2, "--" ) == 0 )
+        {
+            printUsage( argv[0] );
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+        else
+            boardFiles.push_back( arg );
+    }
+
+    std::vector<GEOM_DATASET> datasets = { buildStar(), buildTracks(), buildZone() };
+
+    for( const std::string& filename : boardFiles )
+    {
+        GEOM_DATASET data;
+
+        if( !loadBoardDataset( filename, data ) )
+        {
+            std::cerr << "Could not read polygons from " << filename << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        datasets.push_back( data );
+    }
+
+    std::vector<MICRO_BENCHMARK> benchmarks;
+
+    for( const GEOM_DATASET& data : datasets )
+        addDatasetBenchmarks( benchmarks, data );
+
+    if( listOnly )
+    {
+        for( const MICRO_BENCHMARK& bench : benchmarks )
+            std::cout << bench.m_name << std::endl;
+
+        return KI_TEST::RET_CODES::OK;
+    }
+
+    for( const GEOM_DATASET& data : datasets )
+    {
+        std::cout << "Dataset " << data.m_name << ": " << data.m_polys.OutlineCount()
+                  << " outlines, " << data.m_polys.TotalVertices() << " vertices" << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    auto results = KI_TEST::RunMicroBenchmarks( benchmarks, options, std::cout );
+
+    if( !jsonFile.empty() )
+    {
+        std::ofstream json( jsonFile );
+
+        if( !json )
+        {
+            std::cerr << "Could not write " << jsonFile << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        KI_TEST::WriteBenchResultsJson( json, results, argv[0] );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "geometry_benchmark",
+        "Benchmark the kimath geometry routines",
+        geometry_benchmark_main,
+} );
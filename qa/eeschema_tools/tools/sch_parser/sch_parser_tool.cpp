@@ -0,0 +1,145 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <class_library.h>
+#include <sch_sexpr_parser.h>
+
+#include <qa_utils/parse_benchmark.h>
+
+
+/**
+ * Benchmark the parsing of a symbol library file: lexing and parsing
+ *
+ * @param aFileName the file to parse
+ * @param aIterations the number of times the file is parsed
+ * @return success
+ */
+static bool benchmark( const std::string& aFileName, int aIterations )
+{
+    LIB_PART_MAP               symbols;
+    KI_TEST::PARSE_BENCH_FUNCS funcs;
+
+    funcs.m_lex = []( LINE_READER& aReader ) -> int64_t
+    {
+        SCHEMATIC_LEXER lexer( &aReader );
+        int64_t         count = 0;
+
+        while( lexer.NextTok() != DSN_EOF )
+            count++;
+
+        return count;
+    };
+
+    funcs.m_parse = [&]( LINE_READER& aReader )
+    {
+        SCH_SEXPR_PARSER parser( &aReader );
+
+        parser.ParseLib( symbols );
+    };
+
+    funcs.m_release = [&]()
+    {
+        for( auto& symbol : symbols )
+            delete symbol.second;
+
+        symbols.clear();
+    };
+
+    try
+    {
+        KI_TEST::PrintParseBenchResult( std::cout,
+                                        KI_TEST::RunParseBenchmark( aFileName, funcs, aIterations ) );
+    }
+    catch( const IO_ERROR& parse_error )
+    {
+        funcs.m_release();
+
+        std::cerr << parse_error.Problem() << std::endl;
+        std::cerr << parse_error.Where() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "i", "iterations", _( "number of parses of each file" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum PARSER_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int sch_parser_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program times the parsing of symbol library files (.kicad_sym), "
+               "like the benchmark mode of pcb_parser." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long iterations = 5;
+    bool ok = true;
+
+    cl_parser.Found( "iterations", &iterations );
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+        ok = benchmark( cl_parser.GetParam( i ).ToStdString(), std::max( 1L, iterations ) ) && ok;
+
+    if( !ok )
+        return PARSER_RET_CODES::PARSE_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register(
+        { "sch_parser", "Benchmark the parsing of a KiCad symbol library file", sch_parser_main_func } );
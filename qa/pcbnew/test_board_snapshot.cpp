@@ -0,0 +1,166 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_board_snapshot.cpp
+ * Checks that a board read from its snapshot is the board read from its file, and that the
+ * snapshot is ignored once the board file is changed.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <fstream>
+#include <sstream>
+
+#include <board_snapshot.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <richio.h>
+
+#include <wx/filename.h>
+
+
+static const char* BOARD_TEXT =
+        "(kicad_pcb (version 20200119) (host pcbnew test)\n"
+        "  (net 0 \"\")\n"
+        "  (net 1 GND)\n"
+        "  (net 2 \"Net-(R1-Pad1)\")\n"
+        "  (gr_line (start 0 0) (end 20 0) (layer Edge.Cuts) (width 0.1))\n"
+        "  (segment (start 1 1) (end 5 1) (width 0.25) (layer F.Cu) (net 1))\n"
+        "  (segment (start 5 1) (end 5 6) (width 0.25) (layer B.Cu) (net 2) (status 40000))\n"
+        "  (arc (start 5 6) (mid 6 7) (end 7 6) (width 0.2) (layer B.Cu) (net 2))\n"
+        "  (via (at 5 1) (size 0.8) (drill 0.4) (layers F.Cu B.Cu) (net 1))\n"
+        "  (via micro (at 8 1) (size 0.6) (layers F.Cu B.Cu) (net 2))\n"
+        "  (zone (net 1) (net_name GND) (layer F.Cu) (hatch edge 0.508)\n"
+        "    (connect_pads (clearance 0.508))\n"
+        "    (min_thickness 0.254)\n"
+        "    (fill yes (thermal_gap 0.508) (thermal_bridge_width 0.508))\n"
+        "    (polygon (pts (xy 0 0) (xy 10 0) (xy 10 10) (xy 0 10)))\n"
+        "    (filled_polygon (pts (xy 1 1) (xy 9 1) (xy 9 9) (xy 1 9)))\n"
+        "    (filled_polygon (pts (xy 2 2) (xy 3 2) (xy 3 3)))\n"
+        "  )\n"
+        ")\n";
+
+
+static std::string readFile( const wxString& aFileName )
+{
+    std::ifstream     in( aFileName.ToStdString(), std::ios::binary );
+    std::stringstream ss;
+
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+
+/**
+ * Saves a board to a temporary file, and removes the file and its snapshot when done
+ */
+struct SNAPSHOT_FIXTURE
+{
+    SNAPSHOT_FIXTURE()
+    {
+        wxFileName fn( wxFileName::CreateTempFileName( wxT( "qa_snapshot" ) ) );
+
+        m_tempFile = fn.GetFullPath();
+        fn.SetExt( wxT( "kicad_pcb" ) );
+        m_boardFile = fn.GetFullPath();
+
+        STRING_LINE_READER reader( std::string( BOARD_TEXT ), "test" );
+        PCB_PARSER         parser( &reader );
+
+        m_board.reset( dynamic_cast<BOARD*>( parser.Parse() ) );
+        PCB_IO().Save( m_boardFile, m_board.get() );
+    }
+
+    ~SNAPSHOT_FIXTURE()
+    {
+        wxRemoveFile( m_tempFile );
+        wxRemoveFile( m_boardFile );
+        wxRemoveFile( BOARD_SNAPSHOT::GetSnapshotFileName( m_boardFile ) );
+    }
+
+    std::string saveToString( BOARD* aBoard )
+    {
+        wxString fileName = m_tempFile + wxT( ".out" );
+
+        PCB_IO().Save( fileName, aBoard );
+
+        std::string text = readFile( fileName );
+
+        wxRemoveFile( fileName );
+        return text;
+    }
+
+    wxString               m_tempFile;
+    wxString               m_boardFile;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BoardSnapshot, SNAPSHOT_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( SameBoard )
+{
+    BOOST_REQUIRE( m_board );
+    BOOST_REQUIRE( BOARD_SNAPSHOT::Save( m_board.get(), m_boardFile ) );
+
+    std::unique_ptr<BOARD> fromSnapshot( BOARD_SNAPSHOT::Load( m_boardFile ) );
+    std::unique_ptr<BOARD> fromFile( PCB_IO().Load( m_boardFile, nullptr ) );
+
+    BOOST_REQUIRE( fromSnapshot );
+    BOOST_REQUIRE( fromFile );
+
+    BOOST_CHECK_EQUAL( fromSnapshot->Tracks().size(), 5 );
+    BOOST_CHECK_EQUAL( fromSnapshot->GetArea( 0 )->GetFilledPolysList().OutlineCount(), 2 );
+    BOOST_CHECK( fromSnapshot->GetFileName() == m_boardFile );
+
+    // The tracks, with their uuids, the zone fills and the rest are the same
+    BOOST_CHECK_EQUAL( saveToString( fromSnapshot.get() ), saveToString( fromFile.get() ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( ChangedBoardFile )
+{
+    BOOST_REQUIRE( BOARD_SNAPSHOT::Save( m_board.get(), m_boardFile ) );
+
+    {
+        std::ofstream out( m_boardFile.ToStdString(), std::ios::app );
+        out << "\n";
+    }
+
+    BOOST_CHECK( BOARD_SNAPSHOT::Load( m_boardFile ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_CASE( NoSnapshot )
+{
+    BOOST_CHECK( BOARD_SNAPSHOT::Load( m_boardFile ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pcb_parser.cpp
+ * Checks that the parallel loading of the sections of a board gives the same board, and
+ * the same errors, as a parse in file order.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <sstream>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_track.h>
+#include <pcb_parser.h>
+#include <richio.h>
+
+
+static const int SEGMENT_COUNT = 500;
+
+
+/**
+ * @return a board with a net, SEGMENT_COUNT segments of increasing x and a line in the
+ * middle of them.  If aErrorSegment is not negative, the segment of this index is invalid.
+ */
+static std::string makeBoard( int aErrorSegment = -1 )
+{
+    std::ostringstream ss;
+
+    ss << "(kicad_pcb (version 20200119) (host pcbnew test)\n";
+    ss << "  (net 0 \"\")\n";
+    ss << "  (net 1 GND)\n";
+
+    for( int ii = 0; ii < SEGMENT_COUNT; ii++ )
+    {
+        if( ii == SEGMENT_COUNT / 2 )
+            ss << "  (gr_line (start 0 0) (end 10 0) (layer Edge.Cuts) (width 0.1))\n";
+
+        ss << "  (segment (start " << ii << " 0) (end " << ii << " 1)";
+        ss << ( ii == aErrorSegment ? " (width wide)" : " (width 0.25)" );
+        ss << " (layer F.Cu) (net 1))\n";
+    }
+
+    ss << ")\n";
+
+    return ss.str();
+}
+
+
+static std::unique_ptr<BOARD> parseBoard( const std::string& aText )
+{
+    STRING_LINE_READER reader( aText, "test" );
+    PCB_PARSER         parser( &reader );
+
+    return std::unique_ptr<BOARD>( dynamic_cast<BOARD*>( parser.Parse() ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE( PcbParser )
+
+
+BOOST_AUTO_TEST_CASE( SectionsInFileOrder )
+{
+    std::unique_ptr<BOARD> board = parseBoard( makeBoard() );
+
+    BOOST_REQUIRE( board );
+    BOOST_CHECK_EQUAL( board->Tracks().size(), SEGMENT_COUNT );
+    BOOST_CHECK_EQUAL( board->Drawings().size(), 1 );
+
+    // The tracks are inserted at the front, so they are in reverse file order
+    int x = SEGMENT_COUNT;
+
+    for( TRACK* track : board->Tracks() )
+    {
+        BOOST_CHECK_EQUAL( track->GetStart().x, Millimeter2iu( --x ) );
+        BOOST_CHECK_EQUAL( track->GetNetCode(), 1 );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ErrorLineNumber )
+{
+    const int errorSegment = SEGMENT_COUNT - 10;
+
+    // Header, 2 nets, the segments before and the line
+    const int errorLine = 1 + 2 + errorSegment + 1 + 1;
+
+    try
+    {
+        parseBoard( makeBoard( errorSegment ) );
+        BOOST_ERROR( "The invalid segment was not reported" );
+    }
+    catch( const PARSE_ERROR& error )
+    {
+        BOOST_CHECK_EQUAL( error.lineNumber, errorLine );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,519 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file connectivity_benchmark.cpp
+ * Measures the cost of the connectivity of a board: the full build of CN_CONNECTIVITY_ALGO and
+ * of the ratsnest, then the incremental updates after each operation of a sequence of item
+ * moves and deletions.  The latency percentiles of each kind of operation and the peak memory
+ * use are written as JSON, so that two versions can be compared.
+ *
+ * The operations are read from a script, one per line:
+ *     move footprint <reference> <dx_mm> <dy_mm>
+ *     move track <index> <dx_mm> <dy_mm>
+ *     delete footprint <reference>
+ *     delete track <index>
+ * where <index> is the position of the track (or via) in the board file.  Lines starting
+ * with '#' are comments.  Without a script, a random sequence is used, built from a fixed seed.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef __WINDOWS__
+#include <sys/resource.h>
+#endif
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <nlohmann/json.hpp>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+#include <convert_to_biu.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CONN_DURATION = std::chrono::microseconds;
+
+
+struct CONN_OPERATION
+{
+    enum TYPE
+    {
+        OP_MOVE,
+        OP_DELETE
+    };
+
+    TYPE        m_type;
+    BOARD_ITEM* m_item;
+    wxPoint     m_delta;
+    std::string m_name;     ///< kind of operation, the key of the report
+};
+
+
+/**
+ * Latencies of one kind of operation
+ */
+struct CONN_LATENCIES
+{
+    std::vector<double> m_us;
+
+    nlohmann::json Report() const
+    {
+        std::vector<double> sorted( m_us );
+        std::sort( sorted.begin(), sorted.end() );
+
+        double total = 0.0;
+
+        for( double us : sorted )
+            total += us;
+
+        // Nearest rank percentile
+        auto percentile = [&sorted]( double aRank ) -> double
+                          {
+                              if( sorted.empty() )
+                                  return 0.0;
+
+                              size_t idx = (size_t) std::ceil( aRank / 100.0 * sorted.size() );
+                              return sorted[std::max<size_t>( idx, 1 ) - 1];
+                          };
+
+        return {
+            { "count", sorted.size() },
+            { "mean_us", sorted.empty() ? 0.0 : total / sorted.size() },
+            { "p50_us", percentile( 50 ) },
+            { "p90_us", percentile( 90 ) },
+            { "p99_us", percentile( 99 ) },
+            { "max_us", sorted.empty() ? 0.0 : sorted.back() },
+        };
+    }
+};
+
+
+/**
+ * @return the peak resident memory of the process so far, in kilobytes, or 0 if unknown
+ */
+static long peakMemoryKb()
+{
+#ifndef __WINDOWS__
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;      // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+
+    return 0;
+}
+
+
+static BOARD_ITEM* findTarget( const std::string& aKind, const std::string& aId,
+                               const std::vector<BOARD_ITEM*>& aTracks,
+                               const std::map<std::string, BOARD_ITEM*>& aFootprints )
+{
+    if( aKind == "track" )
+    {
+        size_t idx = std::strtoul( aId.c_str(), nullptr, 10 );
+        return idx < aTracks.size() ? aTracks[idx] : nullptr;
+    }
+
+    if( aKind == "footprint" )
+    {
+        auto it = aFootprints.find( aId );
+        return it != aFootprints.end() ? it->second : nullptr;
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * Reads the operations of a script (see the file comment).
+ * @return false if a line is not understood
+ */
+static bool readScript( std::istream& aStream, const std::vector<BOARD_ITEM*>& aTracks,
+                        const std::map<std::string, BOARD_ITEM*>& aFootprints,
+                        std::vector<CONN_OPERATION>& aOps )
+{
+    std::string line;
+    int         lineNo = 0;
+
+    while( std::getline( aStream, line ) )
+    {
+        lineNo++;
+
+        std::istringstream ss( line );
+        std::string        verb, kind, id;
+
+        if( !( ss >> verb ) || verb[0] == '#' )
+            continue;
+
+        CONN_OPERATION op;
+        double         dx = 0.0, dy = 0.0;
+        bool           valid = true;
+
+        ss >> kind >> id;
+
+        if( verb == "move" )
+        {
+            op.m_type = CONN_OPERATION::OP_MOVE;
+            valid = !!( ss >> dx >> dy );
+        }
+        else if( verb == "delete" )
+        {
+            op.m_type = CONN_OPERATION::OP_DELETE;
+        }
+        else
+        {
+            valid = false;
+        }
+
+        op.m_item = valid ? findTarget( kind, id, aTracks, aFootprints ) : nullptr;
+
+        if( !op.m_item )
+        {
+            std::cerr << "Line " << lineNo << ": invalid operation '" << line << "'" << std::endl;
+            return false;
+        }
+
+        op.m_delta = wxPoint( Millimeter2iu( dx ), Millimeter2iu( dy ) );
+        op.m_name = verb + "_" + kind;
+        aOps.push_back( op );
+    }
+
+    return true;
+}
+
+
+/**
+ * Builds a random sequence of aCount operations: mostly track moves, then footprint moves
+ * and track deletions.  The sequence only depends on the board and the seed.
+ */
+static void randomScript( int aCount, std::vector<BOARD_ITEM*> aTracks,
+                          std::vector<BOARD_ITEM*> aFootprints, std::vector<CONN_OPERATION>& aOps )
+{
+    std::mt19937 gen( 1 );
+
+    // The raw mt19937 output is the same on every platform, unlike the distributions
+    auto rnd = [&gen]( uint32_t aMax ) -> uint32_t
+               {
+                   return gen() % aMax;
+               };
+
+    auto delta = [&rnd]()
+                 {
+                     return wxPoint( Millimeter2iu( ( (int) rnd( 201 ) - 100 ) / 20.0 ),
+                                     Millimeter2iu( ( (int) rnd( 201 ) - 100 ) / 20.0 ) );
+                 };
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        uint32_t       kind = rnd( 10 );
+        CONN_OPERATION op;
+
+        if( kind < 2 && !aFootprints.empty() )
+        {
+            op = { CONN_OPERATION::OP_MOVE, aFootprints[rnd( aFootprints.size() )], delta(),
+                   "move_footprint" };
+        }
+        else if( kind < 3 && !aTracks.empty() )
+        {
+            size_t idx = rnd( aTracks.size() );
+
+            op = { CONN_OPERATION::OP_DELETE, aTracks[idx], wxPoint(), "delete_track" };
+
+            aTracks[idx] = aTracks.back();
+            aTracks.pop_back();
+        }
+        else if( !aTracks.empty() )
+        {
+            op = { CONN_OPERATION::OP_MOVE, aTracks[rnd( aTracks.size() )], delta(), "move_track" };
+        }
+        else
+        {
+            break;
+        }
+
+        aOps.push_back( op );
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the progress on stderr" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "b",
+            "builds",
+            _( "number of timed full builds (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "script",
+            _( "file of the operations to replay" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "count",
+            _( "number of random operations, without a script (default 200)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "JSON report file (default stdout)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum CONN_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    BAD_SCRIPT,
+    WRITE_FAILED,
+};
+
+
+int connectivity_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program times the connectivity computation of a PCB file: the full "
+               "build and the incremental updates after a sequence of edits." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long builds = 5;
+    long count = 200;
+    cl_parser.Found( "builds", &builds );
+    cl_parser.Found( "count", &count );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return CONN_BENCH_RET_CODES::LOAD_FAILED;
+
+    const long loadedKb = peakMemoryKb();
+
+    std::vector<BOARD_ITEM*>            tracks( board->Tracks().begin(), board->Tracks().end() );
+    std::vector<BOARD_ITEM*>            footprints;
+    std::map<std::string, BOARD_ITEM*>  footprintsByRef;
+
+    for( MODULE* module : board->Modules() )
+    {
+        footprints.push_back( module );
+        footprintsByRef[module->GetReference().ToStdString()] = module;
+    }
+
+    std::vector<CONN_OPERATION> ops;
+    wxString                    script;
+
+    if( cl_parser.Found( "script", &script ) )
+    {
+        std::ifstream stream( script.ToStdString() );
+
+        if( !stream || !readScript( stream, tracks, footprintsByRef, ops ) )
+        {
+            std::cerr << "Could not read the script " << script << std::endl;
+            return CONN_BENCH_RET_CODES::BAD_SCRIPT;
+        }
+    }
+    else
+    {
+        randomScript( count, tracks, footprints, ops );
+    }
+
+    // The full build, from a new connectivity each time
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = board->GetConnectivity();
+    CONN_LATENCIES                     buildTimes;
+
+    for( long ii = 0; ii < builds; ii++ )
+    {
+        CONN_DURATION duration;
+        {
+            SCOPED_PROF_COUNTER<CONN_DURATION> timer( duration );
+            connectivity->Build( board.get() );
+        }
+
+        buildTimes.m_us.push_back( duration.count() );
+
+        if( verbose )
+            std::cerr << "Build " << ii << ": " << duration.count() << "us" << std::endl;
+    }
+
+    const long builtKb = peakMemoryKb();
+
+    // Replay the operations, updating the connectivity like BOARD_COMMIT::Push() does
+    std::map<std::string, CONN_LATENCIES>   latencies;
+    std::vector<std::unique_ptr<BOARD_ITEM>> deleted;
+
+    for( const CONN_OPERATION& op : ops )
+    {
+        // A scripted operation may target an item deleted before
+        if( std::find_if( deleted.begin(), deleted.end(),
+                          [&op]( const std::unique_ptr<BOARD_ITEM>& aItem )
+                          {
+                              return aItem.get() == op.m_item;
+                          } ) != deleted.end() )
+        {
+            continue;
+        }
+
+        CONN_DURATION duration;
+        {
+            SCOPED_PROF_COUNTER<CONN_DURATION> timer( duration );
+
+            if( op.m_type == CONN_OPERATION::OP_MOVE )
+            {
+                connectivity->MarkItemNetAsDirty( op.m_item );
+                op.m_item->Move( op.m_delta );
+                connectivity->Update( op.m_item );
+            }
+            else
+            {
+                board->Remove( op.m_item );     // handles connectivity
+            }
+
+            connectivity->RecalculateRatsnest();
+            connectivity->ClearDynamicRatsnest();
+        }
+
+        // The deleted items are kept until the end, so that their addresses are not reused
+        if( op.m_type == CONN_OPERATION::OP_DELETE )
+            deleted.emplace_back( op.m_item );
+
+        latencies[op.m_name].m_us.push_back( duration.count() );
+        latencies["update"].m_us.push_back( duration.count() );
+
+        if( verbose )
+            std::cerr << op.m_name << ": " << duration.count() << "us" << std::endl;
+    }
+
+    nlohmann::json report;
+
+    report["board"] = filename;
+    report["items"] = { { "tracks", tracks.size() }, { "footprints", footprints.size() },
+                        { "nets", connectivity->GetNetCount() } };
+    report["build"] = buildTimes.Report();
+
+    for( const auto& entry : latencies )
+        report["operations"][entry.first] = entry.second.Report();
+
+    report["unconnected"] = connectivity->GetUnconnectedCount();
+    report["peak_memory_kb"] = { { "loaded", loadedKb }, { "built", builtKb },
+                                 { "updated", peakMemoryKb() } };
+
+    wxString output;
+
+    if( cl_parser.Found( "output", &output ) )
+    {
+        std::ofstream stream( output.ToStdString() );
+
+        if( !( stream << report.dump( 2 ) << std::endl ) )
+        {
+            std::cerr << "Could not write " << output << std::endl;
+            return CONN_BENCH_RET_CODES::WRITE_FAILED;
+        }
+    }
+    else
+    {
+        std::cout << report.dump( 2 ) << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "connectivity_benchmark",
+        "Time the connectivity build and update of a PCB", connectivity_benchmark_main_func } );
@@ -32,6 +32,7 @@
 #include <widgets/ui_common.h>
 #include <pcbnew/drc/drc.h>
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_report_writer.h>
 
 #include <qa_utils/utility_registry.h>
 
@@ -54,6 +55,7 @@ public:
         bool m_verbose;
         bool m_print_times;
         bool m_print_markers;
+        bool m_print_stats;
     };
 
     DRC_RUNNER( const EXECUTION_CONTEXT& aExecCtx ) : m_exec_context( aExecCtx )
@@ -92,6 +94,9 @@ public:
 
         if( m_exec_context.m_print_markers )
             reportMarkers( markers );
+
+        if( m_exec_context.m_print_stats )
+            reportStats( drc_prov->GetStats(), duration );
     }
 
 private:
@@ -113,6 +118,17 @@ private:
         std::cout << "Took: " << aDuration.count() << "us" << std::endl;
     }
 
+    /**
+     * Print the counters of the run as a single tab-separated line, for scripts:
+     * STATS, runner name, time in us, items, pair checks, markers
+     */
+    void reportStats( const DRC_STAGE_STATS& aStats, const DRC_DURATION& aDuration ) const
+    {
+        std::cout << "STATS\t" << getRunnerIntro() << "\t" << aDuration.count() << "\t"
+                  << aStats.m_items << "\t" << aStats.m_pairChecks << "\t" << aStats.m_markers
+                  << std::endl;
+    }
+
     void reportMarkers( const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers ) const
     {
         std::cout << "DRC markers: " << aMarkers.size() << std::endl;
@@ -231,6 +247,12 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "print-markers",
             _( "print DRC marker information" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "s",
+            "stats",
+            _( "print DRC timings and counters in a machine-readable form" ).mb_str(),
+    },
     {
             wxCMD_LINE_SWITCH,
             "A",
@@ -249,6 +271,18 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "courtyard-missing",
             _( "perform courtyard-missing checking" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "r",
+            "report",
+            _( "run the full DRC and stream the violations to stdout" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "j",
+            "json",
+            _( "write the --report output as JSON" ).mb_str(),
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -305,6 +339,7 @@ int drc_main_func( int argc, char** argv )
         verbose,
         cl_parser.Found( "timings" ),
         cl_parser.Found( "print-markers" ),
+        cl_parser.Found( "stats" ),
     };
 
     const bool all = cl_parser.Found( "all-checks" );
@@ -322,6 +357,19 @@ int drc_main_func( int argc, char** argv )
         runner.Execute( *board );
     }
 
+    if( cl_parser.Found( "report" ) )
+    {
+        std::unique_ptr<DRC_REPORT_WRITER> writer;
+
+        if( cl_parser.Found( "json" ) )
+            writer = std::make_unique<DRC_JSON_REPORT_WRITER>( std::cout, EDA_UNITS::MILLIMETRES );
+        else
+            writer = std::make_unique<DRC_TEXT_REPORT_WRITER>( std::cout, EDA_UNITS::MILLIMETRES );
+
+        DRC drc;
+        drc.RunTestsHeadless( board.get(), *writer, EDA_UNITS::MILLIMETRES );
+    }
+
     return KI_TEST::RET_CODES::OK;
 }
 
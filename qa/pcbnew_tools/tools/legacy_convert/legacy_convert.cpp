@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+#include <thread_pool.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <kicad_plugin.h>
+#include <legacy_plugin.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+/**
+ * Converts a legacy board (.brd) to a .kicad_pcb file, or a legacy footprint library (.mod)
+ * to a .pretty library, named like the input file in aOutputDir.
+ * The plugins are created here, so each conversion has its own caches.
+ */
+static void convertFile( const wxString& aInput, const wxString& aOutputDir )
+{
+    wxFileName    fn( aInput );
+    LEGACY_PLUGIN legacy;
+    PCB_IO        kicad;
+
+    if( !aOutputDir.IsEmpty() )
+        fn.SetPath( aOutputDir );
+
+    if( fn.GetExt().IsSameAs( wxT( "mod" ), false ) )
+    {
+        wxArrayString names;
+
+        fn.SetExt( wxT( "pretty" ) );
+
+        legacy.FootprintEnumerate( names, aInput, false );
+        kicad.FootprintLibCreate( fn.GetFullPath() );
+
+        for( const wxString& name : names )
+        {
+            std::unique_ptr<MODULE> footprint( legacy.FootprintLoad( aInput, name ) );
+
+            if( footprint )
+                kicad.FootprintSave( fn.GetFullPath(), footprint.get() );
+        }
+    }
+    else
+    {
+        std::unique_ptr<BOARD> board( legacy.Load( aInput, nullptr ) );
+
+        fn.SetExt( wxT( "kicad_pcb" ) );
+        kicad.Save( fn.GetFullPath(), board.get() );
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print conversion information" ).mb_str() },
+    { wxCMD_LINE_OPTION, "j", "jobs", _( "number of files converted at once" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "o", "output", _( "output directory" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum CONVERT_RET_CODES
+{
+    CONVERT_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int legacy_convert_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program converts legacy boards (.brd) and footprint libraries (.mod) "
+               "to the current file formats, several files at once." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+    long       jobs = 0;
+    wxString   outputDir;
+
+    cl_parser.Found( "jobs", &jobs );
+    cl_parser.Found( "output", &outputDir );
+
+    if( !outputDir.IsEmpty() && !wxFileName::DirExists( outputDir ) )
+        wxFileName::Mkdir( outputDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    // The locale is global: switch it once for all the conversions, so the LOCALE_IO of the
+    // plugins in the worker threads do not change it while another thread is parsing
+    LOCALE_IO toggle;
+
+    THREAD_POOL       pool( jobs > 0 ? (unsigned) jobs : 0 );
+    std::mutex        outputLock;
+    std::atomic<int>  failures( 0 );
+    PROF_COUNTER      timer;
+
+    std::vector<std::future<void>> results;
+
+    for( size_t ii = 0; ii < cl_parser.GetParamCount(); ii++ )
+    {
+        const wxString input = cl_parser.GetParam( ii );
+
+        results.push_back( pool.Submit( [&, input]()
+                {
+                    try
+                    {
+                        convertFile( input, outputDir );
+
+                        if( verbose )
+                        {
+                            std::lock_guard<std::mutex> lock( outputLock );
+                            std::cout << "Converted: " << input.ToStdString() << std::endl;
+                        }
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        std::lock_guard<std::mutex> lock( outputLock );
+                        std::cerr << input.ToStdString() << ": " << ioe.What().ToStdString()
+                                  << std::endl;
+                        failures++;
+                    }
+                } ) );
+    }
+
+    for( std::future<void>& result : results )
+        result.wait();
+
+    if( verbose )
+    {
+        std::cout << "Converted " << results.size() - failures << " of " << results.size()
+                  << " files with " << pool.GetThreadCount() << " threads in "
+                  << timer.SinceStart<std::chrono::milliseconds>().count() << "ms" << std::endl;
+    }
+
+    if( failures )
+        return CONVERT_RET_CODES::CONVERT_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "legacy_convert",
+        "Convert legacy boards and footprint libraries in parallel", legacy_convert_main_func } );
@@ -23,7 +23,9 @@
 
 #include <qa_utils/utility_registry.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <memory>
 #include <string>
 
 #include <common.h>
@@ -31,6 +33,7 @@
 
 #include <wx/cmdline.h>
 
+#include <class_board.h>
 #include <class_board_item.h>
 #include <kicad_plugin.h>
 #include <pcb_parser.h>
@@ -38,6 +41,7 @@
 
 #include <wx/cmdline.h>
 
+#include <qa_utils/parse_benchmark.h>
 #include <qa_utils/stdstream_line_reader.h>
 #include <qa_utils/utility_registry.h>
 
@@ -87,10 +91,77 @@ bool parse( std::istream& aStream, bool aVerbose )
 }
 
 
+/**
+ * Benchmark the parsing of a PCB or footprint file: lexing, parsing and the work done on a
+ * board after it is loaded by Pcbnew
+ *
+ * @param aFileName the file to parse
+ * @param aIterations the number of times the file is parsed
+ * @return success
+ */
+bool benchmark( const std::string& aFileName, int aIterations )
+{
+    std::unique_ptr<BOARD_ITEM> item;
+    KI_TEST::PARSE_BENCH_FUNCS  funcs;
+
+    funcs.m_lex = []( LINE_READER& aReader ) -> int64_t
+    {
+        PCB_LEXER lexer( &aReader );
+        int64_t   count = 0;
+
+        while( lexer.NextTok() != DSN_EOF )
+            count++;
+
+        return count;
+    };
+
+    funcs.m_parse = [&]( LINE_READER& aReader )
+    {
+        PCB_PARSER parser;
+
+        parser.SetLineReader( &aReader );
+        item.reset( parser.Parse() );
+    };
+
+    // What PCB_EDIT_FRAME::OpenProjectFiles() does with a loaded board
+    funcs.m_finalize = [&]()
+    {
+        if( BOARD* board = dynamic_cast<BOARD*>( item.get() ) )
+        {
+            board->BuildListOfNets();
+            board->SynchronizeNetsAndNetClasses();
+            board->BuildConnectivity();
+        }
+    };
+
+    funcs.m_release = [&]()
+    {
+        item.reset();
+    };
+
+    try
+    {
+        KI_TEST::PrintParseBenchResult( std::cout,
+                                        KI_TEST::RunParseBenchmark( aFileName, funcs, aIterations ) );
+    }
+    catch( const IO_ERROR& parse_error )
+    {
+        std::cerr << parse_error.Problem() << std::endl;
+        std::cerr << parse_error.Where() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
             wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
     { wxCMD_LINE_SWITCH, "v", "verbose", _( "print parsing information" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "b", "benchmark", _( "time the parsing phases of the given files" ).mb_str() },
+    { wxCMD_LINE_OPTION, "i", "iterations", _( "number of parses of each file in benchmark mode" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
     { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
             wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
     { wxCMD_LINE_NONE }
@@ -125,12 +196,20 @@ int pcb_parser_main_func( int argc, char** argv )
     }
 
     const bool verbose = cl_parser.Found( "verbose" );
+    long       iterations = 5;
+
+    cl_parser.Found( "iterations", &iterations );
 
     bool ok = true;
 
     const auto file_count = cl_parser.GetParamCount();
 
-    if( file_count == 0 )
+    if( cl_parser.Found( "benchmark" ) )
+    {
+        for( unsigned i = 0; i < file_count; i++ )
+            ok = benchmark( cl_parser.GetParam( i ).ToStdString(), std::max( 1L, iterations ) ) && ok;
+    }
+    else if( file_count == 0 )
     {
         // Parse the file provided on stdin - used by AFL to drive the
         // program
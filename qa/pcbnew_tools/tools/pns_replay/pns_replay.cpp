@@ -0,0 +1,353 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_replay.cpp
+ * Replays the events of the interactive router recorded by PNS::LOGGER (see the RouterEventLog
+ * key of the advanced config) on the board they were recorded on, without the GUI.  The
+ * latency percentiles of ROUTER::Move(), with the shove iterations and the optimizer runs it
+ * needed, are written as JSON, so that two versions of the router can be compared on real
+ * traces.
+ *
+ * The items under the cursor are found back by the UUID of their board item.  The items
+ * created by an earlier replayed operation have no board item, so they are replayed as no
+ * item at all; a drag starting on such an item is skipped.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <nlohmann/json.hpp>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <pcbnew_settings.h>
+
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_sizes_settings.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using REPLAY_DURATION = std::chrono::microseconds;
+
+
+/**
+ * Samples of one measure, with their percentiles
+ */
+struct REPLAY_SAMPLES
+{
+    std::vector<double> m_values;
+
+    nlohmann::json Report( const std::string& aUnit ) const
+    {
+        std::vector<double> sorted( m_values );
+        std::sort( sorted.begin(), sorted.end() );
+
+        double total = 0.0;
+
+        for( double value : sorted )
+            total += value;
+
+        // Nearest rank percentile
+        auto percentile = [&sorted]( double aRank ) -> double
+                          {
+                              if( sorted.empty() )
+                                  return 0.0;
+
+                              size_t idx = (size_t) std::ceil( aRank / 100.0 * sorted.size() );
+                              return sorted[std::max<size_t>( idx, 1 ) - 1];
+                          };
+
+        return {
+            { "count", sorted.size() },
+            { "total_" + aUnit, total },
+            { "mean_" + aUnit, sorted.empty() ? 0.0 : total / sorted.size() },
+            { "p50_" + aUnit, percentile( 50 ) },
+            { "p90_" + aUnit, percentile( 90 ) },
+            { "p99_" + aUnit, percentile( 99 ) },
+            { "max_" + aUnit, sorted.empty() ? 0.0 : sorted.back() },
+        };
+    }
+};
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the progress on stderr" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "JSON report file (default stdout)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MANDATORY,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "event log" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MANDATORY,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    BAD_LOG,
+    WRITE_FAILED,
+};
+
+
+int pns_replay_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program replays the events of the interactive router recorded on a "
+               "PCB file and times them." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool        verbose = cl_parser.Found( "verbose" );
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+    const std::string logname = cl_parser.GetParam( 1 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    std::vector<PNS::LOGGER::EVENT_ENTRY> events;
+    std::ifstream                         logStream( logname );
+
+    if( !logStream || !PNS::LOGGER::ParseEvents( logStream, events ) )
+    {
+        std::cerr << "Could not read the event log " << logname << std::endl;
+        return PNS_REPLAY_RET_CODES::BAD_LOG;
+    }
+
+    std::map<std::string, BOARD_CONNECTED_ITEM*> itemsByUuid;
+
+    for( TRACK* track : board->Tracks() )
+        itemsByUuid[track->m_Uuid.AsString().ToStdString()] = track;
+
+    for( MODULE* module : board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            itemsByUuid[pad->m_Uuid.AsString().ToStdString()] = pad;
+    }
+
+    // The same setup as the router tool, with an interface which does not draw anything
+    PCBNEW_SETTINGS settings;
+    settings.m_PnsSettings = std::make_unique<PNS::ROUTING_SETTINGS>( &settings, "tools.pns" );
+
+    PNS_KICAD_IFACE_BASE iface;
+    PNS::ROUTER          router;
+
+    iface.SetBoard( board.get() );
+    router.SetInterface( &iface );
+    router.SetMode( PNS::PNS_MODE_ROUTE_SINGLE );
+    router.LoadSettings( settings.m_PnsSettings.get() );
+    router.SyncWorld();
+
+    auto findItem = [&]( const std::string& aUuid ) -> PNS::ITEM*
+                    {
+                        auto it = itemsByUuid.find( aUuid );
+
+                        if( it == itemsByUuid.end() )
+                            return nullptr;
+
+                        return router.GetWorld()->FindItemByParent( it->second );
+                    };
+
+    REPLAY_SAMPLES moveTimes, shoveIterations, optimizations;
+    int            operations = 0;
+    int            skipped = 0;
+
+    for( const PNS::LOGGER::EVENT_ENTRY& evt : events )
+    {
+        PNS::ITEM* item = evt.m_uuid.empty() ? nullptr : findItem( evt.m_uuid );
+
+        switch( evt.m_type )
+        {
+        case PNS::LOGGER::EVT_START_ROUTE:
+        case PNS::LOGGER::EVT_START_DRAG:
+        {
+            router.StopRouting();
+            router.Settings().SetMode( static_cast<PNS::PNS_MODE>( evt.m_mode ) );
+
+            bool started = false;
+
+            if( evt.m_type == PNS::LOGGER::EVT_START_ROUTE )
+            {
+                PNS::SIZES_SETTINGS sizes( router.Sizes() );
+
+                sizes.Init( board.get(), item );
+                sizes.SetTrackWidth( evt.m_trackWidth );
+                sizes.SetViaDiameter( evt.m_viaDiameter );
+                sizes.SetViaDrill( evt.m_viaDrill );
+                router.UpdateSizes( sizes );
+
+                started = router.StartRouting( evt.m_p, item, evt.m_layer );
+            }
+            else if( item )
+            {
+                started = router.StartDragging( evt.m_p, item, evt.m_layer );
+            }
+
+            if( started )
+                operations++;
+            else
+                skipped++;
+
+            if( verbose )
+            {
+                std::cerr << ( evt.m_type == PNS::LOGGER::EVT_START_ROUTE ? "route" : "drag" )
+                          << ( started ? "" : " (skipped)" ) << std::endl;
+            }
+
+            break;
+        }
+
+        case PNS::LOGGER::EVT_MOVE:
+        {
+            if( !router.RoutingInProgress() )
+                break;
+
+            PNS::ROUTER_STATS& stats = router.Stats();
+            const int64_t      shoves = stats.m_shoveIterations;
+            const int64_t      opts = stats.m_optimizations;
+
+            REPLAY_DURATION duration;
+            {
+                SCOPED_PROF_COUNTER<REPLAY_DURATION> timer( duration );
+                router.Move( evt.m_p, item );
+            }
+
+            moveTimes.m_values.push_back( duration.count() );
+            shoveIterations.m_values.push_back( stats.m_shoveIterations - shoves );
+            optimizations.m_values.push_back( stats.m_optimizations - opts );
+
+            if( verbose )
+                std::cerr << "move: " << duration.count() << "us" << std::endl;
+
+            break;
+        }
+
+        case PNS::LOGGER::EVT_FIX:
+            if( router.RoutingInProgress() && router.FixRoute( evt.m_p, item ) )
+                router.StopRouting();
+
+            break;
+
+        case PNS::LOGGER::EVT_ABORT:
+            router.StopRouting();
+            break;
+        }
+    }
+
+    router.StopRouting();
+
+    nlohmann::json report;
+
+    report["board"] = filename;
+    report["log"] = logname;
+    report["operations"] = { { "replayed", operations }, { "skipped", skipped } };
+    report["move"] = moveTimes.Report( "us" );
+    report["shove_iterations"] = shoveIterations.Report( "per_move" );
+    report["optimizations"] = optimizations.Report( "per_move" );
+
+    wxString output;
+
+    if( cl_parser.Found( "output", &output ) )
+    {
+        std::ofstream stream( output.ToStdString() );
+
+        if( !( stream << report.dump( 2 ) << std::endl ) )
+        {
+            std::cerr << "Could not write " << output << std::endl;
+            return PNS_REPLAY_RET_CODES::WRITE_FAILED;
+        }
+    }
+    else
+    {
+        std::cout << report.dump( 2 ) << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "pns_replay",
+        "Replay and time the interactive router events recorded on a PCB",
+        pns_replay_main_func } );
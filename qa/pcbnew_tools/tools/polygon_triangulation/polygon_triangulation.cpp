@@ -33,6 +33,8 @@
 #include <class_zone.h>
 #include <profile.h>
 
+#include <wx/cmdline.h>
+
 #include <atomic>
 #include <thread>
 #include <unordered_set>
@@ -202,24 +204,141 @@ aResult->clear();
 }
 
 
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "b",
+            "benchmark",
+            _( "compare the one-by-one and the parallel triangulation of each zone" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
 enum POLY_TRI_RET_CODES
 {
     LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULTS_DIFFER,
 };
 
 
+/**
+ * @return true if both sets have the same triangulation.
+ */
+static bool sameTriangulation( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.TriangulatedPolyCount() != aB.TriangulatedPolyCount() )
+        return false;
+
+    for( unsigned ii = 0; ii < aA.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triA = aA.TriangulatedPolygon( ii );
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triB = aB.TriangulatedPolygon( ii );
+
+        if( triA->GetTriangleCount() != triB->GetTriangleCount() )
+            return false;
+
+        for( size_t jj = 0; jj < triA->GetTriangleCount(); ++jj )
+        {
+            VECTOR2I a1, b1, c1, a2, b2, c2;
+
+            triA->GetTriangle( jj, a1, b1, c1 );
+            triB->GetTriangle( jj, a2, b2, c2 );
+
+            if( a1 != a2 || b1 != b2 || c1 != c2 )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Triangulates the zones one after the other, the outlines of each zone one by one then
+ * in parallel, and prints the timings of both.
+ */
+static int benchmarkTriangulation( BOARD& aBoard )
+{
+    double serialTotal = 0.0;
+    double parallelTotal = 0.0;
+    bool   differ = false;
+
+    for( int areaId = 0; areaId < aBoard.GetAreaCount(); ++areaId )
+    {
+        const SHAPE_POLY_SET& filled = aBoard.GetArea( areaId )->GetFilledPolysList();
+        SHAPE_POLY_SET        serial = filled;
+        SHAPE_POLY_SET        parallel = filled;
+
+        PROF_COUNTER serialCnt;
+        serial.CacheTriangulation( false );
+        serialCnt.Stop();
+
+        PROF_COUNTER parallelCnt;
+        parallel.CacheTriangulation( true );
+        parallelCnt.Stop();
+
+        bool same = sameTriangulation( serial, parallel );
+
+        printf( "zone %d/%d: %d outlines, %d vertices, serial %.2f ms, parallel %.2f ms%s\n",
+                areaId + 1, aBoard.GetAreaCount(), filled.OutlineCount(),
+                filled.TotalVertices(), serialCnt.msecs(), parallelCnt.msecs(),
+                same ? "" : ", RESULTS DIFFER" );
+
+        serialTotal += serialCnt.msecs();
+        parallelTotal += parallelCnt.msecs();
+        differ |= !same;
+    }
+
+    printf( "total: serial %.2f ms, parallel %.2f ms\n", serialTotal, parallelTotal );
+
+    return differ ? POLY_TRI_RET_CODES::RESULTS_DIFFER : KI_TEST::RET_CODES::OK;
+}
+
+
 int polygon_triangulation_main( int argc, char *argv[] )
 {
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program triangulates the zone fills of a PCB file." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
     std::string filename;
 
-    if( argc > 1 )
-        filename = argv[1];
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
 
     auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
 
     if( !brd )
         return POLY_TRI_RET_CODES::LOAD_FAILED;
 
+    if( cl_parser.Found( "benchmark" ) )
+        return benchmarkTriangulation( *brd );
 
     PROF_COUNTER cnt( "allBoard" );
 
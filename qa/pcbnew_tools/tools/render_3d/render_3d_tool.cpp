@@ -0,0 +1,249 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file render_3d_tool.cpp
+ * Renders the 3D view of boards into PNG files with the raytracer, without a window nor a
+ * gl context.  The boards are rendered at the same time and share one 3D model cache.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+#include <reporter.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <3d-viewer/3d_canvas/offscreen_3d_render.h>
+#include <3d-viewer/3d_cache/3d_cache.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <pgm_base.h>
+#include <settings/settings_manager.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the written files and the rendering time" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output-dir",
+            _( "directory of the images, the directory of each board by default" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "W",
+            "width",
+            _( "width of the images, 1600 by default" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "H",
+            "height",
+            _( "height of the images, 900 by default" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "V",
+            "view",
+            _( "top, bottom, front, back, left or right, top by default" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "zoom",
+            _( "zoom of the camera, 1.0 fits the board" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "jobs",
+            _( "number of boards rendered at the same time, all the threads by default" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum RENDER_3D_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RENDER_FAILED,
+};
+
+
+static bool parseView( const wxString& aName, OFFSCREEN_3D_VIEW& aView )
+{
+    static const std::pair<const char*, OFFSCREEN_3D_VIEW> views[] = {
+        { "top", OFFSCREEN_3D_VIEW::TOP },     { "bottom", OFFSCREEN_3D_VIEW::BOTTOM },
+        { "front", OFFSCREEN_3D_VIEW::FRONT }, { "back", OFFSCREEN_3D_VIEW::BACK },
+        { "left", OFFSCREEN_3D_VIEW::LEFT },   { "right", OFFSCREEN_3D_VIEW::RIGHT },
+    };
+
+    for( const auto& view : views )
+    {
+        if( aName.CmpNoCase( view.first ) == 0 )
+        {
+            aView = view.second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+int render_3d_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders the 3D view of PCB files into PNG images, "
+               "without a display." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long     width = 1600;
+    long     height = 900;
+    long     jobs = 0;
+    double   zoom = 1.0;
+    wxString viewName = "top";
+    wxString outputDir;
+
+    cl_parser.Found( "width", &width );
+    cl_parser.Found( "height", &height );
+    cl_parser.Found( "jobs", &jobs );
+    cl_parser.Found( "zoom", &zoom );
+    cl_parser.Found( "view", &viewName );
+    cl_parser.Found( "output-dir", &outputDir );
+
+    OFFSCREEN_3D_VIEW view;
+
+    if( width <= 0 || height <= 0 || jobs < 0 || !parseView( viewName, view ) )
+    {
+        cl_parser.Usage();
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::vector<std::unique_ptr<BOARD>>  boards;
+    std::vector<OFFSCREEN_3D_RENDER::JOB> renderJobs;
+
+    for( size_t i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        wxFileName fn( cl_parser.GetParam( i ) );
+        std::unique_ptr<BOARD> board =
+                KI_TEST::ReadBoardFromFileOrStream( fn.GetFullPath().ToStdString() );
+
+        if( !board )
+        {
+            std::cerr << "Cannot load " << fn.GetFullPath() << std::endl;
+            return RENDER_3D_RET_CODES::LOAD_FAILED;
+        }
+
+        fn.SetExt( "png" );
+
+        if( !outputDir.IsEmpty() )
+            fn.SetPath( outputDir );
+
+        renderJobs.push_back( { board.get(), fn.GetFullPath() } );
+        boards.push_back( std::move( board ) );
+    }
+
+    if( renderJobs.empty() )
+        return KI_TEST::RET_CODES::OK;
+
+    // One cache for all the boards.  The ${KIPRJMOD} models are found relatively to the
+    // directory of the first board.
+    wxFileName cfgpath;
+    cfgpath.AssignDir( SETTINGS_MANAGER::GetUserSettingsPath() );
+    cfgpath.AppendDir( wxT( "3d" ) );
+
+    S3D_CACHE cache;
+    cache.SetProgramBase( PgmOrNull() );
+    cache.Set3DConfigDir( cfgpath.GetFullPath() );
+    cache.SetProjectDir( wxFileName( cl_parser.GetParam( 0 ) ).GetPath() );
+
+    const bool   verbose = cl_parser.Found( "verbose" );
+    PROF_COUNTER timer( "Rendering" );
+
+    int written = OFFSCREEN_3D_RENDER::RenderBoards( renderJobs, &cache, wxSize( width, height ),
+                                                     view, zoom, jobs,
+                                                     verbose ? &STDOUT_REPORTER::GetInstance()
+                                                             : nullptr );
+
+    if( verbose )
+    {
+        std::cout << written << " images written" << std::endl;
+        timer.Show( std::cout );
+    }
+
+    return written == (int) renderJobs.size() ? KI_TEST::RET_CODES::OK
+                                               : RENDER_3D_RET_CODES::RENDER_FAILED;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register(
+        { "render_3d", "Render the 3D view of PCB files to PNG images", render_3d_main_func } );
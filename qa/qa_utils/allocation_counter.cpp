@@ -0,0 +1,130 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Counts the allocations of a program by replacing the global operator new.  This file is
+ * not part of the qa_utils library, but added to the sources of the programs which report
+ * allocation counts, so that the other programs keep the standard operator new.
+ */
+
+#include <qa_utils/parse_benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+#if !defined( _WIN32 )
+
+// The allocations are counted by replacing the global operator new.  This is not done on
+// Windows, where memory can be allocated by a DLL and freed by the program.
+
+static std::atomic<int64_t> s_allocationCount( 0 );
+
+
+static void* countedAlloc( size_t aSize ) noexcept
+{
+    s_allocationCount.fetch_add( 1, std::memory_order_relaxed );
+    return malloc( aSize ? aSize : 1 );
+}
+
+
+void* operator new( size_t aSize )
+{
+    if( void* ptr = countedAlloc( aSize ) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+
+void* operator new[]( size_t aSize )
+{
+    return operator new( aSize );
+}
+
+
+void* operator new( size_t aSize, const std::nothrow_t& ) noexcept
+{
+    return countedAlloc( aSize );
+}
+
+
+void* operator new[]( size_t aSize, const std::nothrow_t& ) noexcept
+{
+    return countedAlloc( aSize );
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr ) noexcept
+{
+    free( aPtr );
+}
+
+
+void operator delete( void* aPtr, size_t ) noexcept
+{
+    free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr, size_t ) noexcept
+{
+    free( aPtr );
+}
+
+
+void operator delete( void* aPtr, const std::nothrow_t& ) noexcept
+{
+    free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr, const std::nothrow_t& ) noexcept
+{
+    free( aPtr );
+}
+
+#endif
+
+
+namespace KI_TEST
+{
+
+int64_t GetAllocationCount()
+{
+#if !defined( _WIN32 )
+    return s_allocationCount.load();
+#else
+    return -1;
+#endif
+}
+
+} // namespace KI_TEST
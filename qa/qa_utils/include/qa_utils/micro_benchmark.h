@@ -0,0 +1,193 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * A small micro-benchmark harness, in the spirit of Google Benchmark: each benchmark is
+ * run with a growing iteration count until it lasts long enough to be timed reliably,
+ * and the results can be written in the Google Benchmark JSON format, so that the
+ * usual tools can compare two runs.
+ */
+
+#ifndef QA_UTILS_MICRO_BENCHMARK__H
+#define QA_UTILS_MICRO_BENCHMARK__H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace KI_TEST
+{
+
+/**
+ * The state of one run of a benchmark, passed to the benchmark function.
+ *
+ * The function does its setup, then loops on KeepRunning() around the code to time:
+ *
+ *     while( aState.KeepRunning() )
+ *     {
+ *         aState.PauseTiming();
+ *         // untimed per iteration setup
+ *         aState.ResumeTiming();
+ *         // timed code
+ *     }
+ */
+class BENCH_STATE
+{
+public:
+    BENCH_STATE( int64_t aIterations );
+
+    /**
+     * @return true while iterations remain.
+     * The timer is started by the first call and stopped by the last one.
+     */
+    bool KeepRunning()
+    {
+        if( m_remaining == m_iterations )
+            ResumeTiming();
+
+        if( m_remaining-- > 0 )
+            return true;
+
+        PauseTiming();
+        return false;
+    }
+
+    void PauseTiming();
+
+    void ResumeTiming();
+
+    ///> Sets the number of items (points, polygons, ...) handled by all the iterations
+    void SetItemsProcessed( int64_t aItems )
+    {
+        m_items = aItems;
+    }
+
+    ///> Records a result of the timed code, so that the compiler cannot optimize it away
+    void KeepResult( int64_t aValue )
+    {
+        m_result = aValue;
+    }
+
+    int64_t Iterations() const
+    {
+        return m_iterations;
+    }
+
+    int64_t ItemsProcessed() const
+    {
+        return m_items;
+    }
+
+    ///> @return the timed wall clock duration, in seconds
+    double RealTime() const
+    {
+        return m_realTime;
+    }
+
+    ///> @return the timed processor time of the process, in seconds
+    double CpuTime() const
+    {
+        return m_cpuTime;
+    }
+
+private:
+    using CLOCK = std::chrono::steady_clock;
+
+    int64_t           m_iterations;
+    int64_t           m_remaining;
+    int64_t           m_items;
+    bool              m_running;
+    CLOCK::time_point m_realStart;
+    std::clock_t      m_cpuStart;
+    double            m_realTime;
+    double            m_cpuTime;
+    volatile int64_t  m_result;
+};
+
+
+struct MICRO_BENCHMARK
+{
+    using FUNC = std::function<void( BENCH_STATE& aState )>;
+
+    std::string m_name;
+    FUNC        m_func;
+};
+
+
+struct BENCH_RESULT
+{
+    std::string m_name;
+    int64_t     m_iterations;
+    int         m_repetitions;
+
+    ///> Median over the repetitions of the time per iteration, in nanoseconds
+    double      m_realTimeNs;
+    double      m_cpuTimeNs;
+
+    ///> Items per second, or 0 if the benchmark does not report items
+    double      m_itemsPerSecond;
+};
+
+
+struct BENCH_OPTIONS
+{
+    ///> Minimal duration of a timed run, in seconds
+    double      m_minTime = 0.5;
+
+    ///> Number of timed runs of each benchmark; the median is reported
+    int         m_repetitions = 1;
+
+    ///> Only the benchmarks whose name contains this string are run
+    std::string m_filter;
+};
+
+
+/**
+ * Runs a benchmark: the iteration count grows until a run lasts at least
+ * aOptions.m_minTime, then aOptions.m_repetitions runs are timed with that count.
+ */
+BENCH_RESULT RunMicroBenchmark( const MICRO_BENCHMARK& aBenchmark, const BENCH_OPTIONS& aOptions );
+
+/**
+ * Runs the benchmarks selected by aOptions.m_filter, printing a line for each on aProgress
+ * once done, in the console format of Google Benchmark.
+ */
+std::vector<BENCH_RESULT> RunMicroBenchmarks( const std::vector<MICRO_BENCHMARK>& aBenchmarks,
+                                              const BENCH_OPTIONS& aOptions,
+                                              std::ostream& aProgress );
+
+/**
+ * Writes the results in the JSON format of Google Benchmark (--benchmark_format=json).
+ * @param aExecutable is the name of the program, recorded in the context
+ */
+void WriteBenchResultsJson( std::ostream& aStream, const std::vector<BENCH_RESULT>& aResults,
+                            const std::string& aExecutable );
+
+} // namespace KI_TEST
+
+#endif // QA_UTILS_MICRO_BENCHMARK__H
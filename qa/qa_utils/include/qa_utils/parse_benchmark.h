@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * A benchmark of the file parsers: the time of the lexing alone, of the whole parsing and of
+ * the work done on the parsed object after loading, the allocations and the memory used,
+ * over repeated parses of a file held in memory.
+ */
+
+#ifndef QA_UTILS_PARSE_BENCHMARK__H
+#define QA_UTILS_PARSE_BENCHMARK__H
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class LINE_READER;
+
+namespace KI_TEST
+{
+
+/**
+ * @return the number of calls to operator new since the start of the program, or -1 if the
+ *         allocations are not counted on this platform
+ */
+int64_t GetAllocationCount();
+
+/**
+ * @return the peak resident set size of the process in bytes, or 0 if it is not known on
+ *         this platform
+ */
+size_t GetPeakResidentSetSize();
+
+
+/**
+ * The phases of the parsing of a file, provided by the parser under test.
+ */
+struct PARSE_BENCH_FUNCS
+{
+    ///> Reads all the tokens of the file, without building anything.  @return the token count
+    std::function<int64_t( LINE_READER& aReader )> m_lex;
+
+    ///> Parses the file, keeping the parsed object for m_finalize
+    std::function<void( LINE_READER& aReader )>    m_parse;
+
+    ///> Does the work done after loading on the parsed object (may be empty)
+    std::function<void()>                          m_finalize;
+
+    ///> Frees the parsed object, not timed
+    std::function<void()>                          m_release;
+};
+
+
+struct PARSE_BENCH_RESULT
+{
+    std::string         m_name;
+    size_t              m_bytes = 0;
+    int64_t             m_tokens = 0;
+
+    ///> Durations of each iteration, in seconds
+    std::vector<double> m_lexTimes;
+    std::vector<double> m_parseTimes;
+    std::vector<double> m_finalizeTimes;
+
+    ///> Allocations of each iteration, by the parsing and the finalization
+    std::vector<int64_t> m_allocations;
+};
+
+
+/**
+ * Function RunParseBenchmark
+ * reads the file aFileName in memory, then lexes, parses and finalizes it aIterations times.
+ * @throw IO_ERROR if the file cannot be read or parsed
+ */
+PARSE_BENCH_RESULT RunParseBenchmark( const std::string& aFileName, const PARSE_BENCH_FUNCS& aFuncs,
+                                      int aIterations );
+
+/**
+ * Prints the medians of the phase durations over the iterations, the object construction
+ * being the parse time less the lex time, the token rate of the lexer, the allocations per
+ * iteration and the peak memory use of the process.
+ */
+void PrintParseBenchResult( std::ostream& aStream, const PARSE_BENCH_RESULT& aResult );
+
+} // namespace KI_TEST
+
+#endif // QA_UTILS_PARSE_BENCHMARK__H
@@ -0,0 +1,258 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/micro_benchmark.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+
+namespace KI_TEST
+{
+
+BENCH_STATE::BENCH_STATE( int64_t aIterations ) :
+        m_iterations( aIterations ),
+        m_remaining( aIterations ),
+        m_items( 0 ),
+        m_running( false ),
+        m_cpuStart( 0 ),
+        m_realTime( 0.0 ),
+        m_cpuTime( 0.0 ),
+        m_result( 0 )
+{
+}
+
+
+void BENCH_STATE::PauseTiming()
+{
+    if( !m_running )
+        return;
+
+    std::chrono::duration<double> elapsed = CLOCK::now() - m_realStart;
+
+    m_realTime += elapsed.count();
+    m_cpuTime += double( std::clock() - m_cpuStart ) / CLOCKS_PER_SEC;
+    m_running = false;
+}
+
+
+void BENCH_STATE::ResumeTiming()
+{
+    if( m_running )
+        return;
+
+    m_running = true;
+    m_cpuStart = std::clock();
+    m_realStart = CLOCK::now();
+}
+
+
+static double median( std::vector<double> aValues )
+{
+    std::sort( aValues.begin(), aValues.end() );
+
+    size_t mid = aValues.size() / 2;
+
+    if( aValues.size() % 2 )
+        return aValues[mid];
+
+    return ( aValues[mid - 1] + aValues[mid] ) / 2;
+}
+
+
+BENCH_RESULT RunMicroBenchmark( const MICRO_BENCHMARK& aBenchmark, const BENCH_OPTIONS& aOptions )
+{
+    const int64_t maxIterations = 1000000000;
+
+    int64_t iterations = 1;
+
+    // Grow the iteration count until a run is long enough, like Google Benchmark does
+    while( iterations < maxIterations )
+    {
+        BENCH_STATE state( iterations );
+        aBenchmark.m_func( state );
+
+        double time = state.RealTime();
+
+        if( time >= aOptions.m_minTime )
+            break;
+
+        double multiplier = time > 0.0 ? aOptions.m_minTime * 1.4 / time : 10.0;
+
+        // Do not trust the measure of a very short run too much
+        if( time < aOptions.m_minTime / 10 )
+            multiplier = std::min( multiplier, 10.0 );
+
+        iterations = std::max<int64_t>( iterations + 1, iterations * multiplier );
+        iterations = std::min( iterations, maxIterations );
+    }
+
+    std::vector<double> realTimes, cpuTimes, itemRates;
+    int repetitions = std::max( 1, aOptions.m_repetitions );
+
+    for( int ii = 0; ii < repetitions; ii++ )
+    {
+        BENCH_STATE state( iterations );
+        aBenchmark.m_func( state );
+
+        realTimes.push_back( state.RealTime() * 1e9 / iterations );
+        cpuTimes.push_back( state.CpuTime() * 1e9 / iterations );
+
+        if( state.ItemsProcessed() > 0 && state.RealTime() > 0.0 )
+            itemRates.push_back( state.ItemsProcessed() / state.RealTime() );
+    }
+
+    BENCH_RESULT result;
+
+    result.m_name = aBenchmark.m_name;
+    result.m_iterations = iterations;
+    result.m_repetitions = repetitions;
+    result.m_realTimeNs = median( realTimes );
+    result.m_cpuTimeNs = median( cpuTimes );
+    result.m_itemsPerSecond = itemRates.empty() ? 0.0 : median( itemRates );
+
+    return result;
+}
+
+
+static std::string formatRate( double aRate )
+{
+    const char* units[] = { "", "k", "M", "G" };
+    int         unit = 0;
+
+    while( aRate >= 1000.0 && unit < 3 )
+    {
+        aRate /= 1000.0;
+        unit++;
+    }
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision( 3 ) << aRate << units[unit] << "/s";
+    return ss.str();
+}
+
+
+std::vector<BENCH_RESULT> RunMicroBenchmarks( const std::vector<MICRO_BENCHMARK>& aBenchmarks,
+                                              const BENCH_OPTIONS& aOptions,
+                                              std::ostream& aProgress )
+{
+    std::vector<BENCH_RESULT> results;
+
+    aProgress << std::left << std::setw( 40 ) << "Benchmark" << std::right << std::setw( 16 )
+              << "Time (ns)" << std::setw( 16 ) << "CPU (ns)" << std::setw( 14 ) << "Iterations"
+              << "  Items" << std::endl;
+    aProgress << std::string( 96, '-' ) << std::endl;
+
+    for( const MICRO_BENCHMARK& bench : aBenchmarks )
+    {
+        if( !aOptions.m_filter.empty() && bench.m_name.find( aOptions.m_filter ) == std::string::npos )
+            continue;
+
+        BENCH_RESULT result = RunMicroBenchmark( bench, aOptions );
+
+        aProgress << std::left << std::setw( 40 ) << result.m_name << std::right << std::fixed
+                  << std::setprecision( 0 ) << std::setw( 16 ) << result.m_realTimeNs
+                  << std::setw( 16 ) << result.m_cpuTimeNs << std::setw( 14 )
+                  << result.m_iterations;
+
+        if( result.m_itemsPerSecond > 0.0 )
+            aProgress << "  " << formatRate( result.m_itemsPerSecond );
+
+        aProgress << std::endl;
+
+        results.push_back( result );
+    }
+
+    return results;
+}
+
+
+static std::string jsonString( const std::string& aStr )
+{
+    std::string quoted = "\"";
+
+    for( char c : aStr )
+    {
+        if( c == '"' || c == '\\' )
+            quoted += '\\';
+
+        if( (unsigned char) c < 0x20 )
+            continue;
+
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+
+void WriteBenchResultsJson( std::ostream& aStream, const std::vector<BENCH_RESULT>& aResults,
+                            const std::string& aExecutable )
+{
+    char        date[64] = "";
+    std::time_t now = std::time( nullptr );
+
+    std::strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%S", std::localtime( &now ) );
+
+    aStream << "{\n";
+    aStream << "  \"context\": {\n";
+    aStream << "    \"date\": " << jsonString( date ) << ",\n";
+    aStream << "    \"executable\": " << jsonString( aExecutable ) << ",\n";
+    aStream << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    aStream << "    \"library_build_type\": \"release\"\n";
+#else
+    aStream << "    \"library_build_type\": \"debug\"\n";
+#endif
+    aStream << "  },\n";
+    aStream << "  \"benchmarks\": [";
+
+    for( size_t ii = 0; ii < aResults.size(); ii++ )
+    {
+        const BENCH_RESULT& result = aResults[ii];
+
+        aStream << ( ii ? ",\n" : "\n" );
+        aStream << "    {\n";
+        aStream << "      \"name\": " << jsonString( result.m_name ) << ",\n";
+        aStream << "      \"run_name\": " << jsonString( result.m_name ) << ",\n";
+        aStream << "      \"run_type\": \"iteration\",\n";
+        aStream << "      \"repetitions\": " << result.m_repetitions << ",\n";
+        aStream << "      \"iterations\": " << result.m_iterations << ",\n";
+        aStream << std::setprecision( 10 );
+        aStream << "      \"real_time\": " << result.m_realTimeNs << ",\n";
+        aStream << "      \"cpu_time\": " << result.m_cpuTimeNs << ",\n";
+
+        if( result.m_itemsPerSecond > 0.0 )
+            aStream << "      \"items_per_second\": " << result.m_itemsPerSecond << ",\n";
+
+        aStream << "      \"time_unit\": \"ns\"\n";
+        aStream << "    }";
+    }
+
+    aStream << "\n  ]\n}\n";
+}
+
+} // namespace KI_TEST
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/parse_benchmark.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#include <profile.h>
+#include <richio.h>
+
+#if !defined( _WIN32 )
+#include <sys/resource.h>
+#endif
+
+
+namespace KI_TEST
+{
+
+size_t GetPeakResidentSetSize()
+{
+#if !defined( _WIN32 )
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+#if defined( __APPLE__ )
+    return usage.ru_maxrss;             // in bytes
+#else
+    return usage.ru_maxrss * 1024;      // in kilobytes
+#endif
+#else
+    return 0;
+#endif
+}
+
+
+PARSE_BENCH_RESULT RunParseBenchmark( const std::string& aFileName, const PARSE_BENCH_FUNCS& aFuncs,
+                                      int aIterations )
+{
+    PARSE_BENCH_RESULT result;
+    std::ifstream      in( aFileName, std::ios::binary );
+    std::ostringstream stream;
+
+    if( !in )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename \"%s\" for reading" ),
+                                          wxString::FromUTF8( aFileName.c_str() ) ) );
+
+    // Read the file once, so that the disk is not timed
+    stream << in.rdbuf();
+
+    const std::string text = stream.str();
+
+    result.m_name = aFileName;
+    result.m_bytes = text.size();
+
+    for( int ii = 0; ii < aIterations; ii++ )
+    {
+        {
+            STRING_LINE_READER reader( text, aFileName );
+            PROF_COUNTER       timer;
+
+            result.m_tokens = aFuncs.m_lex( reader );
+            result.m_lexTimes.push_back( timer.msecs() / 1000 );
+        }
+
+        int64_t allocations = GetAllocationCount();
+
+        {
+            STRING_LINE_READER reader( text, aFileName );
+            PROF_COUNTER       timer;
+
+            aFuncs.m_parse( reader );
+            result.m_parseTimes.push_back( timer.msecs() / 1000 );
+        }
+
+        if( aFuncs.m_finalize )
+        {
+            PROF_COUNTER timer;
+
+            aFuncs.m_finalize();
+            result.m_finalizeTimes.push_back( timer.msecs() / 1000 );
+        }
+
+        result.m_allocations.push_back( GetAllocationCount() - allocations );
+
+        if( aFuncs.m_release )
+            aFuncs.m_release();
+    }
+
+    return result;
+}
+
+
+template <typename T>
+static T median( std::vector<T> aValues )
+{
+    if( aValues.empty() )
+        return T( 0 );
+
+    std::sort( aValues.begin(), aValues.end() );
+    return aValues[aValues.size() / 2];
+}
+
+
+void PrintParseBenchResult( std::ostream& aStream, const PARSE_BENCH_RESULT& aResult )
+{
+    const double lex = median( aResult.m_lexTimes );
+    const double parse = median( aResult.m_parseTimes );
+    const double finalize = median( aResult.m_finalizeTimes );
+
+    aStream << aResult.m_name << ": " << aResult.m_bytes << " bytes, " << aResult.m_tokens
+            << " tokens, median of " << aResult.m_parseTimes.size() << " iterations"
+            << std::endl;
+
+    aStream << std::fixed << std::setprecision( 3 );
+    aStream << "  lexing:        " << lex * 1000 << "ms";
+
+    if( lex > 0.0 )
+        aStream << " (" << aResult.m_tokens / lex / 1e6 << "M tokens/s)";
+
+    aStream << std::endl;
+    aStream << "  construction:  " << std::max( 0.0, parse - lex ) * 1000 << "ms" << std::endl;
+    aStream << "  parsing:       " << parse * 1000 << "ms";
+
+    if( parse > 0.0 )
+        aStream << " (" << aResult.m_bytes / parse / 1e6 << "MB/s)";
+
+    aStream << std::endl;
+
+    if( !aResult.m_finalizeTimes.empty() )
+        aStream << "  finalization:  " << finalize * 1000 << "ms" << std::endl;
+
+    if( GetAllocationCount() >= 0 )
+        aStream << "  allocations:   " << median( aResult.m_allocations ) << std::endl;
+
+    if( size_t rss = GetPeakResidentSetSize() )
+        aStream << "  peak RSS:      " << rss / ( 1024 * 1024 ) << "MB" << std::endl;
+
+    aStream << std::defaultfloat;
+}
+
+} // namespace KI_TEST
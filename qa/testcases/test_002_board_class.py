@@ -125,6 +125,30 @@ class TestBoardClass(unittest.TestCase):
         # ensure we can get to the ID via the STD name too
         self.assertEqual(pcb.GetLayerID(B_CU), b_cu_id)
 
+    def test_pcb_track_arrays(self):
+        pcb = BOARD()
+
+        for i in range(3):
+            track = TRACK(pcb)
+            track.SetStart(wxPoint(i, 10 * i))
+            track.SetEnd(wxPoint(i + 1, 10 * i + 1))
+            track.SetWidth(100 + i)
+            pcb.Add(track)
+
+        arrays = pcb.GetTrackArrays()
+        self.assertEqual(list(arrays['start_y']), [0, 10, 20])
+        self.assertEqual(list(arrays['width']), [100, 101, 102])
+
+        # Only the tracks whose values change are modified
+        import array
+        widths = array.array('i', [100, 200, 300])
+        self.assertEqual(pcb.SetTrackArrays({'width': widths}), 2)
+        self.assertEqual([t.GetWidth() for t in pcb.GetTracks()], [100, 200, 300])
+        self.assertEqual(list(pcb.GetTrackArrays()['end_x']), [1, 2, 3])
+
+        with self.assertRaises(ValueError):
+            pcb.SetTrackArrays({'width': array.array('i', [1])})
+
     #def test_interactive(self):
     # 	code.interact(local=locals())
 
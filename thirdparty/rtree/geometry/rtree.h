@@ -15,6 +15,7 @@
 //    * 2004 Templated C++ port by Greg Douglas
 //    * 2013 CERN (www.cern.ch)
 //    * 2020 KiCad Developers - Add std::iterator support for searching
+//    * 2020 KiCad Developers - Add Sort-Tile-Recursive bulk loading
 //
 //LICENSE:
 //
@@ -35,6 +36,7 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <vector>
 
 #ifdef DEBUG
 #define ASSERT assert    // RTree uses ASSERT( condition )
@@ -110,6 +112,13 @@ public:
         int totalItems;
     };
 
+    /// Entry of a bulk load: the bounding rect and the data of one item
+    struct BulkEntry
+    {
+        Rect        m_rect;
+        DATATYPE    m_data;
+    };
+
 public:
 
     RTree();
@@ -123,6 +132,13 @@ public:
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Replace the tree contents by a set of entries, packed with the Sort-Tile-Recursive
+    /// algorithm (Leutenegger, Lopez and Edgington, 1997).  This is much faster than inserting
+    /// the entries one by one, and builds full nodes which overlap less, so queries are faster
+    /// too.  The tree can be updated with Insert() and Remove() afterwards.
+    /// \param a_entries Entries to load.  They are reordered.
+    void BulkLoad( std::vector<BulkEntry>& a_entries );
+
     /// Remove entry
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
@@ -189,6 +205,10 @@ public:
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
+    /// Append all the entries of the tree to a_entries, in no particular order, so that they can
+    /// be filtered and bulk loaded again.
+    void    GetEntries( std::vector<BulkEntry>& a_entries ) const;
+
     /// Load tree contents from file
     bool    Load( const char* a_fileName );
 
@@ -457,8 +477,8 @@ protected:
     /// Node for each branch level
     struct Node
     {
-        bool    IsInternalNode()                         { return m_level > 0;  }   // Not a leaf, but a internal node
-        bool    IsLeaf()                                 { return m_level == 0;  }  // A leaf, contains data
+        bool    IsInternalNode() const                   { return m_level > 0;  }   // Not a leaf, but a internal node
+        bool    IsLeaf() const                           { return m_level == 0;  }  // A leaf, contains data
 
         int     m_count;                            ///< Count
         int     m_level;                            ///< Leaf is zero, others positive
@@ -576,9 +596,11 @@ protected:
         return true; // Continue searching
     }
 
+    void    StrTile( Branch* a_branches, size_t a_count, int a_axis );
     void    RemoveAllRec( Node* a_node );
     void    Reset();
     void    CountRec( Node* a_node, int& a_count );
+    void    GetEntriesRec( const Node* a_node, std::vector<BulkEntry>& a_entries ) const;
 
     bool    SaveRec( Node* a_node, RTFileStream& a_stream );
     bool    LoadRec( Node* a_node, RTFileStream& a_stream );
@@ -729,6 +751,83 @@ void RTREE_QUAL::Insert( const ELEMTYPE     a_min[NUMDIMS],
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( std::vector<BulkEntry>& a_entries )
+{
+    RemoveAll();
+
+    // The branches of the current level, which are packed into the nodes of the next one
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( size_t index = 0; index < a_entries.size(); ++index )
+    {
+        branches[index].m_rect = a_entries[index].m_rect;
+        branches[index].m_data = a_entries[index].m_data;
+    }
+
+    int level = 0;
+
+    while( branches.size() > (size_t) MAXNODES )
+    {
+        StrTile( branches.data(), branches.size(), 0 );
+
+        std::vector<Branch> parents;
+        parents.reserve( ( branches.size() + MAXNODES - 1 ) / MAXNODES );
+
+        for( size_t first = 0; first < branches.size(); first += MAXNODES )
+        {
+            Node* node = AllocNode();
+            node->m_level = level;
+
+            for( size_t index = first; index < std::min( first + MAXNODES, branches.size() );
+                 ++index )
+            {
+                node->m_branch[node->m_count++] = branches[index];
+            }
+
+            Branch parent;
+            parent.m_rect = NodeCover( node );
+            parent.m_child = node;
+            parents.push_back( parent );
+        }
+
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root->m_level = level;
+
+    for( const Branch& branch : branches )
+        m_root->m_branch[m_root->m_count++] = branch;
+}
+
+
+// Orders a_branches so that each run of MAXNODES branches makes a compact node: the
+// branches are sorted by the center of their rects along a_axis, cut into slabs holding
+// whole nodes, and each slab is tiled the same way along the next axis.
+RTREE_TEMPLATE
+void RTREE_QUAL::StrTile( Branch* a_branches, size_t a_count, int a_axis )
+{
+    std::sort( a_branches, a_branches + a_count,
+               [a_axis]( const Branch& a_a, const Branch& a_b )
+               {
+                   return (ELEMTYPEREAL) a_a.m_rect.m_min[a_axis] + a_a.m_rect.m_max[a_axis]
+                          < (ELEMTYPEREAL) a_b.m_rect.m_min[a_axis] + a_b.m_rect.m_max[a_axis];
+               } );
+
+    if( a_axis == NUMDIMS - 1 )
+        return;
+
+    size_t nodeCount = ( a_count + MAXNODES - 1 ) / MAXNODES;
+    size_t slabCount = (size_t) std::ceil( std::pow( (double) nodeCount,
+                                                     1.0 / ( NUMDIMS - a_axis ) ) );
+    size_t slabSize = MAXNODES * ( ( nodeCount + slabCount - 1 ) / slabCount );
+
+    for( size_t first = 0; first < a_count; first += slabSize )
+        StrTile( a_branches + first, std::min( slabSize, a_count - first ), a_axis + 1 );
+}
+
+
 RTREE_TEMPLATE
 bool RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
                          const ELEMTYPE     a_max[NUMDIMS],
@@ -895,6 +994,34 @@ void RTREE_QUAL::CountRec( Node* a_node, int& a_count )
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::GetEntries( std::vector<BulkEntry>& a_entries ) const
+{
+    GetEntriesRec( m_root, a_entries );
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::GetEntriesRec( const Node* a_node, std::vector<BulkEntry>& a_entries ) const
+{
+    if( a_node->IsInternalNode() ) // not a leaf node
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+        {
+            GetEntriesRec( a_node->m_branch[index].m_child, a_entries );
+        }
+    }
+    else // A leaf node
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+        {
+            a_entries.push_back( { a_node->m_branch[index].m_rect,
+                                   a_node->m_branch[index].m_data } );
+        }
+    }
+}
+
+
 RTREE_TEMPLATE
 bool RTREE_QUAL::Load( const char* a_fileName )
 {
@@ -298,6 +298,20 @@ bool KICADMODULE::parsePad( SEXPR::SEXPR* data )
 }
 
 
+void KICADMODULE::GetModelFileNames( S3D_RESOLVER* resolver,
+    std::vector< std::string >& aFileNames, bool aComposeVirtual ) const
+{
+    if( m_virtual && !aComposeVirtual )
+        return;
+
+    for( auto i : m_models )
+    {
+        aFileNames.emplace_back( resolver->ResolvePath(
+            wxString::FromUTF8Unchecked( i->m_modelname.c_str() ) ).ToUTF8() );
+    }
+}
+
+
 bool KICADMODULE::ComposePCB( class PCBMODEL* aPCB, S3D_RESOLVER* resolver,
     DOUBLET aOrigin, bool aComposeVirtual )
 {
@@ -504,6 +504,14 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         m_pcb->AddOutlineSegment( &lcurve );
     }
 
+    // read the model files in the background while the footprints are composed
+    std::vector< std::string > modelFiles;
+
+    for( auto i : m_modules )
+        i->GetModelFileNames( &m_resolver, modelFiles, aComposeVirtual );
+
+    m_pcb->LoadModels( modelFiles );
+
     for( auto i : m_modules )
         i->ComposePCB( m_pcb, &m_resolver, origin, aComposeVirtual );
 
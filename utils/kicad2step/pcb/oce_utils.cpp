@@ -22,7 +22,10 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -42,6 +45,7 @@
 #include <Quantity_Color.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
+#include <STEPControl_Controller.hxx>
 #include <APIHeaderSection_MakeHeader.hxx>
 #include <Standard_Version.hxx>
 #include <TCollection_ExtendedString.hxx>
@@ -68,6 +72,7 @@
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Compound.hxx>
 #include <TopoDS_Builder.hxx>
+#include <TopTools_ListOfShape.hxx>
 
 #include <Standard_Failure.hxx>
 
@@ -216,6 +221,76 @@ FormatType fileType( const char* aFileName )
 }
 
 
+// retrieve the existing MCAD replacements of a .wrl model file, in order of preference
+static void getWrlAlternates( const std::string& aFileName, std::vector< std::string >& aAlts )
+{
+    wxFileName wrlName( aFileName );
+
+    wxString basePath = wrlName.GetPath();
+    wxString baseName = wrlName.GetName();
+
+    // List of alternate files to look for
+    // Given in order of preference
+    wxArrayString alts;
+
+    // Step files
+    alts.Add( "stp" );
+    alts.Add( "step" );
+    alts.Add( "STP" );
+    alts.Add( "STEP" );
+    alts.Add( "Stp" );
+    alts.Add( "Step" );
+
+    // IGES files
+    alts.Add( "iges" );
+    alts.Add( "IGES" );
+    alts.Add( "igs" );
+    alts.Add( "IGS" );
+
+    //TODO - Other alternative formats?
+
+    for( const auto& alt : alts )
+    {
+        wxFileName altFile( basePath, baseName + "." + alt );
+
+        if( altFile.IsOk() && altFile.FileExists() )
+            aAlts.push_back( altFile.GetFullPath().ToStdString() );
+    }
+}
+
+
+// set up the model readers; the translation settings are global, so they are set once
+// rather than by each (possibly concurrent) read
+static bool initReaders()
+{
+    static std::once_flag initialized;
+    static bool           ok = false;
+
+    std::call_once( initialized, []()
+            {
+                IGESControl_Controller::Init();
+                STEPControl_Controller::Init();
+
+                // Enable user-defined shape precision and set the shape conversion precision
+                // to USER_PREC (default 0.0001 has too many triangles)
+                ok = Interface_Static::SetIVal( "read.precision.mode", 1 )
+                     && Interface_Static::SetRVal( "read.precision.val", USER_PREC );
+            } );
+
+    return ok;
+}
+
+
+// a model file read by the threads of PCBMODEL::LoadModels()
+struct MODEL_READ_JOB
+{
+    std::string                 m_fileName;
+    FormatType                  m_format;
+    Handle( TDocStd_Document )  m_doc;
+    std::promise< bool >        m_result;
+};
+
+
 PCBMODEL::PCBMODEL()
 {
     m_app = XCAFApp_Application::GetApplication();
@@ -237,6 +312,7 @@ PCBMODEL::PCBMODEL()
 
 PCBMODEL::~PCBMODEL()
 {
+    joinReaders();
     m_doc->Close();
     return;
 }
@@ -577,6 +653,91 @@ bool PCBMODEL::AddPadHole( KICADPAD* aPad )
 }
 
 
+void PCBMODEL::LoadModels( const std::vector< std::string >& aFileNames )
+{
+    auto jobs = std::make_shared< std::vector< MODEL_READ_JOB > >();
+
+    for( const std::string& name : aFileNames )
+    {
+        // missing files are reported by getModelLabel()
+        if( !wxFileName::FileExists( wxString::FromUTF8Unchecked( name.c_str() ) ) )
+            continue;
+
+        std::string fileName = name;
+        FormatType  format = fileType( name.c_str() );
+
+        // getModelLabel() uses the preferred replacement of a .wrl model
+        if( FMT_WRL == format )
+        {
+            std::vector< std::string > alts;
+            getWrlAlternates( name, alts );
+
+            if( alts.empty() )
+                continue;
+
+            fileName = alts.front();
+            format = fileType( fileName.c_str() );
+        }
+
+        if( ( FMT_STEP != format && FMT_IGES != format ) || m_modelReads.count( fileName ) )
+            continue;
+
+        // the documents are created here since the application is not thread safe
+        jobs->emplace_back();
+        MODEL_READ_JOB& job = jobs->back();
+        job.m_fileName = fileName;
+        job.m_format = format;
+        m_app->NewDocument( "MDTV-XCAF", job.m_doc );
+
+        MODEL_READ& read = m_modelReads[fileName];
+        read.m_doc = job.m_doc;
+        read.m_result = job.m_result.get_future().share();
+    }
+
+    if( jobs->empty() )
+        return;
+
+    auto   next = std::make_shared< std::atomic< size_t > >( 0 );
+    size_t threads = std::min< size_t >( std::max( 1u, std::thread::hardware_concurrency() ),
+                                         jobs->size() );
+
+    for( size_t ii = 0; ii < threads; ++ii )
+    {
+        m_readers.emplace_back( [this, jobs, next]()
+                {
+                    for( size_t jj = ( *next )++; jj < jobs->size(); jj = ( *next )++ )
+                    {
+                        MODEL_READ_JOB& job = ( *jobs )[jj];
+                        bool            ok = false;
+
+                        try
+                        {
+                            if( FMT_IGES == job.m_format )
+                                ok = readIGES( job.m_doc, job.m_fileName.c_str() );
+                            else
+                                ok = readSTEP( job.m_doc, job.m_fileName.c_str() );
+                        }
+                        catch( ... )
+                        {
+                            ok = false;
+                        }
+
+                        job.m_result.set_value( ok );
+                    }
+                } );
+    }
+}
+
+
+void PCBMODEL::joinReaders()
+{
+    for( std::thread& reader : m_readers )
+        reader.join();
+
+    m_readers.clear();
+}
+
+
 // add a component at the given position and orientation
 bool PCBMODEL::AddComponent( const std::string& aFileName, const std::string& aRefDes,
     bool aBottom, DOUBLET aPosition, double aRotation,
@@ -806,9 +967,33 @@ bool PCBMODEL::CreatePCB()
         }
     }
 
-    // subtract cutouts (if any)
-    for( const auto& i : m_cutouts )
-        board = BRepAlgoAPI_Cut( board, i );
+    // subtract cutouts (if any), all in one boolean operation rather than one
+    // operation per hole, each of which would have to process the whole board again
+    if( !m_cutouts.empty() )
+    {
+        TopoDS_Compound holes;
+        TopoDS_Builder  builder;
+        builder.MakeCompound( holes );
+
+        for( const auto& i : m_cutouts )
+            builder.Add( holes, i );
+
+#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX >= 0x070200 )
+        TopTools_ListOfShape arguments;
+        TopTools_ListOfShape tools;
+        arguments.Append( board );
+        tools.Append( holes );
+
+        BRepAlgoAPI_Cut cut;
+        cut.SetArguments( arguments );
+        cut.SetTools( tools );
+        cut.SetRunParallel( Standard_True );
+        cut.Build();
+        board = cut.Shape();
+#else
+        board = BRepAlgoAPI_Cut( board, holes );
+#endif
+    }
 
     // push the board to the data structure
     m_pcb_label = m_assy->AddComponent( m_assy_label, board );
@@ -924,15 +1109,22 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
 
     aLabel.Nullify();
 
+    // use the document of a model read by LoadModels()
+    MODEL_READ_MAP::iterator    read = m_modelReads.find( aFileName );
+    bool                        preloaded = read != m_modelReads.end();
     Handle( TDocStd_Document )  doc;
-    m_app->NewDocument( "MDTV-XCAF", doc );
+
+    if( preloaded )
+        doc = read->second.m_doc;
+    else
+        m_app->NewDocument( "MDTV-XCAF", doc );
 
     FormatType modelFmt = fileType( aFileName.c_str() );
 
     switch( modelFmt )
     {
         case FMT_IGES:
-            if( !readIGES( doc, aFileName.c_str() ) )
+            if( !( preloaded ? read->second.m_result.get() : readIGES( doc, aFileName.c_str() ) ) )
             {
                 std::ostringstream ostr;
 #ifdef DEBUG
@@ -945,7 +1137,7 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
             break;
 
         case FMT_STEP:
-            if( !readSTEP( doc, aFileName.c_str() ) )
+            if( !( preloaded ? read->second.m_result.get() : readSTEP( doc, aFileName.c_str() ) ) )
             {
                 std::ostringstream ostr;
 #ifdef DEBUG
@@ -970,45 +1162,14 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
              *
              */
             {
-                wxFileName wrlName( aFileName );
-
-                wxString basePath = wrlName.GetPath();
-                wxString baseName = wrlName.GetName();
+                std::vector< std::string > alts;
+                getWrlAlternates( aFileName, alts );
 
-                // List of alternate files to look for
-                // Given in order of preference
                 // (Break if match is found)
-                wxArrayString alts;
-
-                // Step files
-                alts.Add( "stp" );
-                alts.Add( "step" );
-                alts.Add( "STP" );
-                alts.Add( "STEP" );
-                alts.Add( "Stp" );
-                alts.Add( "Step" );
-
-                // IGES files
-                alts.Add( "iges" );
-                alts.Add( "IGES" );
-                alts.Add( "igs" );
-                alts.Add( "IGS" );
-
-                //TODO - Other alternative formats?
-
-                for( const auto& alt : alts )
+                for( const std::string& altFileName : alts )
                 {
-                    wxFileName altFile( basePath, baseName + "." + alt );
-
-                    if( altFile.IsOk() && altFile.FileExists() )
-                    {
-                        std::string altFileName = altFile.GetFullPath().ToStdString();
-
-                        if( getModelLabel( altFileName, aScale, aLabel ) )
-                        {
-                            return true;
-                        }
-                    }
+                    if( getModelLabel( altFileName, aScale, aLabel ) )
+                        return true;
                 }
             }
 
@@ -1104,21 +1265,15 @@ bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotati
 
 bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 {
-    IGESControl_Controller::Init();
+    if( !initReaders() )
+        return false;
+
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
@@ -1143,20 +1298,15 @@ bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 
 bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
 {
+    if( !initReaders() )
+        return false;
+
     STEPCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
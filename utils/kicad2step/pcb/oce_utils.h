@@ -24,9 +24,11 @@
 #ifndef OCE_VIS_OCE_UTILS_H
 #define OCE_VIS_OCE_UTILS_H
 
+#include <future>
 #include <list>
 #include <map>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include "base.h"
@@ -44,6 +46,15 @@
 typedef std::pair< std::string, TDF_Label > MODEL_DATUM;
 typedef std::map< std::string, TDF_Label > MODEL_MAP;
 
+// a model file read in the background, see PCBMODEL::LoadModels()
+struct MODEL_READ
+{
+    Handle( TDocStd_Document )  m_doc;      // document receiving the model
+    std::shared_future< bool >  m_result;   // set true once the model was read successfully
+};
+
+typedef std::map< std::string, MODEL_READ > MODEL_READ_MAP;
+
 class KICADPAD;
 
 class OUTLINE
@@ -95,6 +106,8 @@ class PCBMODEL
     double                          m_minx;         // minimum X value in curves (leftmost curve feature)
     double                          m_minDistance2; // minimum squared distance between items (mm)
     std::list< KICADCURVE >::iterator m_mincurve;   // iterator to the leftmost curve
+    MODEL_READ_MAP                  m_modelReads;   // model files read in the background
+    std::vector< std::thread >      m_readers;      // threads reading the model files
 
     std::list< KICADCURVE >     m_curves;
     std::vector< TopoDS_Shape > m_cutouts;
@@ -107,6 +120,9 @@ class PCBMODEL
     bool readIGES( Handle( TDocStd_Document )& m_doc, const char* fname );
     bool readSTEP( Handle( TDocStd_Document )& m_doc, const char* fname );
 
+    // wait for the threads started by LoadModels()
+    void joinReaders();
+
     TDF_Label transferModel( Handle( TDocStd_Document )& source,
         Handle( TDocStd_Document )& dest, TRIPLET aScale );
 
@@ -120,6 +136,10 @@ public:
     // add a pad hole or slot (must be in final position)
     bool AddPadHole( KICADPAD* aPad );
 
+    // start reading the given model files in the background; AddComponent() then only
+    // waits for the model it needs.  Each file is read once, in its own document.
+    void LoadModels( const std::vector< std::string >& aFileNames );
+
     // add a component at the given position and orientation
     bool AddComponent( const std::string& aFileName, const std::string& aRefDes,
         bool aBottom, DOUBLET aPosition, double aRotation,